@@ -752,11 +752,25 @@ void * CreateGLTexture3D( size_t width, size_t height, size_t depth,
     return buffer;
 }
 
-void * ReadGLTexture( GLenum glTarget, GLuint glTexture, GLuint glBuf, GLint width,
-                        GLenum glFormat, GLenum glInternalFormat,
-                        GLenum glType, ExplicitType typeToReadAs,
-                        size_t outWidth, size_t outHeight )
+#ifdef GL_HELPERS_ASYNC_READBACK
+static bool UseReadbackPBO()
 {
+#if defined( __APPLE__ ) || defined( __ANDROID__ )
+    return true;
+#else
+    return ( GLEW_VERSION_3_2 || GLEW_ARB_sync )
+        && ( GLEW_VERSION_2_1 || GLEW_ARB_pixel_buffer_object );
+#endif
+}
+#endif
+
+int StartGLTextureReadback( GLTextureReadback *readback, GLenum glTarget,
+                            GLuint glTexture, GLuint glBuf, GLint width,
+                            GLenum glFormat, GLenum glInternalFormat,
+                            GLenum glType, ExplicitType typeToReadAs )
+{
+    memset( readback, 0, sizeof( *readback ) );
+
     // Read results from the GL texture
     glBindTexture(get_base_gl_target(glTarget), glTexture);
 
@@ -828,6 +842,52 @@ void * ReadGLTexture( GLenum glTarget, GLuint glTexture, GLuint glBuf, GLint wid
         outBytes *= ( GetGLTypeSize( GetGLTypeForExplicitType(typeToReadAs) ) );
     }
 
+    readback->bytes = outBytes;
+    readback->readBackType = readBackType;
+    readback->width = realWidth;
+    readback->height = realHeight;
+
+#ifdef DEBUG
+    log_info( "- glGetTexImage: %s : %s : %s \n",
+        GetGLTargetName( glTarget),
+        GetGLFormatName(readBackFormat),
+        GetGLTypeName(readBackType));
+#endif
+
+#ifdef GL_HELPERS_ASYNC_READBACK
+    if (get_base_gl_target(glTarget) != GL_TEXTURE_BUFFER && UseReadbackPBO())
+    {
+        glGenBuffers( 1, &readback->pbo );
+        glBindBuffer( GL_PIXEL_PACK_BUFFER, readback->pbo );
+        glBufferData( GL_PIXEL_PACK_BUFFER, outBytes, NULL, GL_STREAM_READ );
+
+        if (realInternalFormat == GL_DEPTH_COMPONENT16)
+          glPixelStorei(GL_PACK_ALIGNMENT, 2);
+
+        // With a pack buffer bound the pointer is an offset into it
+        glGetTexImage( glTarget, 0, readBackFormat, readBackType, NULL );
+
+        if (realInternalFormat == GL_DEPTH_COMPONENT16)
+          glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+        glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+        readback->fence = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+        glFlush();
+
+        if (readback->fence == 0)
+        {
+            log_error( "ERROR: Unable to start reading back %s into a pixel "
+                       "buffer object : Error %s\n",
+                       GetGLTargetName( glTarget ),
+                       gluErrorString( glGetError() ) );
+            glDeleteBuffers( 1, &readback->pbo );
+            readback->pbo = 0;
+            return -1;
+        }
+        return 0;
+    }
+#endif
+
     cl_char *outBuffer = (cl_char *)malloc( outBytes );
     memset(outBuffer, 0, outBytes);
 
@@ -846,18 +906,74 @@ void * ReadGLTexture( GLenum glTarget, GLuint glTexture, GLuint glBuf, GLint wid
         glGetBufferSubData(GL_ARRAY_BUFFER, 0, outBytes, outBuffer);
     }
 
-#ifdef DEBUG
-
-    log_info( "- glGetTexImage: %s : %s : %s \n",
-        GetGLTargetName( glTarget),
-        GetGLFormatName(readBackFormat),
-        GetGLTypeName(readBackType));
+    readback->data = outBuffer;
+    return 0;
+}
 
-    DumpGLBuffer(readBackType, realWidth, realHeight, (void*)outBuffer);
+void * FinishGLTextureReadback( GLTextureReadback *readback )
+{
+#ifdef GL_HELPERS_ASYNC_READBACK
+    if (readback->pbo)
+    {
+        GLenum status;
+        do
+        {
+            status = glClientWaitSync( readback->fence,
+                                       GL_SYNC_FLUSH_COMMANDS_BIT,
+                                       1000000000 );
+        } while (status == GL_TIMEOUT_EXPIRED);
+        glDeleteSync( readback->fence );
+        readback->fence = 0;
+
+        if (status == GL_WAIT_FAILED)
+        {
+            log_error( "ERROR: Waiting for the texture readback failed\n" );
+        }
+        else
+        {
+            glBindBuffer( GL_PIXEL_PACK_BUFFER, readback->pbo );
+            void *mapped = glMapBuffer( GL_PIXEL_PACK_BUFFER, GL_READ_ONLY );
+            if (mapped)
+            {
+                readback->data = malloc( readback->bytes );
+                memcpy( readback->data, mapped, readback->bytes );
+                glUnmapBuffer( GL_PIXEL_PACK_BUFFER );
+            }
+            else
+            {
+                log_error( "ERROR: Unable to map the texture readback : "
+                           "Error %s\n",
+                           gluErrorString( glGetError() ) );
+            }
+            glBindBuffer( GL_PIXEL_PACK_BUFFER, 0 );
+        }
+        glDeleteBuffers( 1, &readback->pbo );
+        readback->pbo = 0;
+    }
+#endif
 
+#ifdef DEBUG
+    if (readback->data)
+        DumpGLBuffer(readback->readBackType, readback->width,
+                     readback->height, readback->data);
 #endif
 
-    return (void *)outBuffer;
+    void *data = readback->data;
+    readback->data = NULL;
+    return data;
+}
+
+void * ReadGLTexture( GLenum glTarget, GLuint glTexture, GLuint glBuf, GLint width,
+                        GLenum glFormat, GLenum glInternalFormat,
+                        GLenum glType, ExplicitType typeToReadAs,
+                        size_t outWidth, size_t outHeight )
+{
+    GLTextureReadback readback;
+    if (StartGLTextureReadback( &readback, glTarget, glTexture, glBuf, width,
+                                glFormat, glInternalFormat, glType,
+                                typeToReadAs ))
+        return NULL;
+    return FinishGLTextureReadback( &readback );
 }
 
 int CreateGLRenderbufferRaw( GLsizei width, GLsizei height,
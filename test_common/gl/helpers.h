@@ -315,6 +315,35 @@ extern void * ReadGLTexture( GLenum glTarget, GLuint glTexture, GLuint glBuf, GL
                              GLenum glType, ExplicitType typeToReadAs,
                              size_t outWidth, size_t outHeight );
 
+#if defined(GL_PIXEL_PACK_BUFFER) && defined(GL_SYNC_GPU_COMMANDS_COMPLETE)
+#define GL_HELPERS_ASYNC_READBACK 1
+#endif
+
+// ReadGLTexture in two halves. StartGLTextureReadback copies the texture into
+// a pixel buffer object and sets a fence behind the copy, so that the caller
+// can go on with other CL and GL work, and FinishGLTextureReadback waits for
+// the fence and returns the data as ReadGLTexture does. Texture buffers, and
+// contexts without pixel buffer and sync objects, are read at once.
+struct GLTextureReadback
+{
+    void *data;
+    size_t bytes;
+    GLenum readBackType;
+    GLint width, height;
+#ifdef GL_HELPERS_ASYNC_READBACK
+    GLuint pbo;
+    GLsync fence;
+#endif
+};
+
+extern int StartGLTextureReadback( GLTextureReadback *readback,
+                                   GLenum glTarget, GLuint glTexture,
+                                   GLuint glBuf, GLint width, GLenum glFormat,
+                                   GLenum glInternalFormat, GLenum glType,
+                                   ExplicitType typeToReadAs );
+
+extern void * FinishGLTextureReadback( GLTextureReadback *readback );
+
 extern int CreateGLRenderbufferRaw( GLsizei width, GLsizei height,
                                    GLenum target, GLenum glFormat,
                                    GLenum internalFormat, GLenum glType,
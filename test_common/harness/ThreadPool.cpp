@@ -16,13 +16,114 @@
 #include "ThreadPool.h"
 #include "errorHelpers.h"
 #include "fpcontrol.h"
+#include "timelineTrace.h"
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+struct ThreadPoolTaskState
+{
+    std::function<cl_int()> func;
+
+    std::mutex lock;
+    std::condition_variable doneCond;
+    bool done = false;
+    cl_int result = CL_SUCCESS;
+
+    // Tasks queued by then() before this one was done
+    std::vector<std::shared_ptr<ThreadPoolTaskState>> continuations;
+};
+
+// Queues task for the worker threads, or runs it at once without them.
+static void EnqueueTask(std::shared_ptr<ThreadPoolTaskState> task);
+
+// Runs one queued task on the calling thread. Returns false if there is none.
+static bool RunQueuedTask(void);
+
+static void RunTask(const std::shared_ptr<ThreadPoolTaskState> &task)
+{
+    cl_int result;
+    {
+        TraceSpan traceSpan("task", "threadpool");
+#if defined(__APPLE__) && defined(__arm__)
+        // See the comment in ThreadPool_WorkerFunc
+        FPStateGuard ftzGuard(kDisableFTZ);
+#endif
+        result = task->func();
+    }
+    // Let go of whatever func holds on to
+    task->func = nullptr;
+
+    std::vector<std::shared_ptr<ThreadPoolTaskState>> continuations;
+    {
+        std::lock_guard<std::mutex> lock(task->lock);
+        task->result = result;
+        task->done = true;
+        continuations.swap(task->continuations);
+    }
+    task->doneCond.notify_all();
+
+    for (auto &continuation : continuations) EnqueueTask(continuation);
+}
+
+ThreadPoolTask ThreadPool_Submit(std::function<cl_int()> func)
+{
+    std::shared_ptr<ThreadPoolTaskState> task(new ThreadPoolTaskState);
+    task->func = std::move(func);
+    EnqueueTask(task);
+    return ThreadPoolTask(task);
+}
+
+bool ThreadPoolTask::done() const
+{
+    std::lock_guard<std::mutex> lock(state->lock);
+    return state->done;
+}
+
+cl_int ThreadPoolTask::wait() const
+{
+    // Helping with the queue means the task waited for is either done or
+    // running on another thread by the time we block, so nested waits can not
+    // deadlock.
+    while (!done())
+        if (!RunQueuedTask())
+        {
+            std::unique_lock<std::mutex> lock(state->lock);
+            state->doneCond.wait(lock, [this] { return state->done; });
+        }
+
+    std::lock_guard<std::mutex> lock(state->lock);
+    return state->result;
+}
+
+ThreadPoolTask ThreadPoolTask::then(std::function<cl_int(cl_int)> func) const
+{
+    std::shared_ptr<ThreadPoolTaskState> previous = state;
+    std::shared_ptr<ThreadPoolTaskState> task(new ThreadPoolTaskState);
+    task->func = [previous, func]() { return func(previous->result); };
+
+    {
+        std::lock_guard<std::mutex> lock(state->lock);
+        if (!state->done)
+        {
+            state->continuations.push_back(task);
+            return ThreadPoolTask(task);
+        }
+    }
+    EnqueueTask(task);
+    return ThreadPoolTask(task);
+}
+
 #if defined(__APPLE__) || defined(__linux__) || defined(_WIN32)
 // or any other POSIX system
 
 #include <atomic>
+#include <deque>
+#include <memory>
+#include <string>
 #include <vector>
 
 #if defined(_WIN32)
@@ -50,52 +151,34 @@ void *ThreadPool_WorkerFunc(void *p);
 void ThreadPool_Init(void);
 void ThreadPool_Exit(void);
 
-#if defined(__MINGW32__)
-// Mutex for implementing super heavy atomic operations if you don't have GCC or
-// MSVC
-CRITICAL_SECTION gAtomicLock;
-#elif defined(__GNUC__) || defined(_MSC_VER)
-#else
-pthread_mutex_t gAtomicLock;
-#endif
-
 #if !defined(_WIN32)
 // Keep track of pthread_t's created in ThreadPool_Init() so they can be joined
 // in ThreadPool_Exit() and avoid thread leaks.
 static std::vector<pthread_t> pthreads;
 #endif
 
+// The atomic operators below operate in place on plain cl_ints, which requires
+// std::atomic<cl_int> to be a lock-free cl_int with no extra state.
+static_assert(sizeof(std::atomic<cl_int>) == sizeof(cl_int),
+              "std::atomic<cl_int> must have the same layout as cl_int");
+
+static inline volatile std::atomic<cl_int> *AsAtomic(volatile cl_int *a)
+{
+    return reinterpret_cast<volatile std::atomic<cl_int> *>(a);
+}
+
 // Atomic add operator with mem barrier.  Mem barrier needed to protect state
 // modified by the worker functions.
 cl_int ThreadPool_AtomicAdd(volatile cl_int *a, cl_int b)
 {
-#if defined(__MINGW32__)
-    // No atomics on Mingw32
-    EnterCriticalSection(&gAtomicLock);
-    cl_int old = *a;
-    *a = old + b;
-    LeaveCriticalSection(&gAtomicLock);
-    return old;
-#elif defined(__GNUC__)
-    // GCC extension:
-    // http://gcc.gnu.org/onlinedocs/gcc/Atomic-Builtins.html#Atomic-Builtins
-    return __sync_fetch_and_add(a, b);
-    // do we need __sync_synchronize() here, too?  GCC docs are unclear whether
-    // __sync_fetch_and_add does a synchronize
-#elif defined(_MSC_VER)
-    return (cl_int)_InterlockedExchangeAdd((volatile LONG *)a, (LONG)b);
-#else
-#warning Please add a atomic add implementation here, with memory barrier.  Fallback code is slow.
-    if (pthread_mutex_lock(&gAtomicLock))
-        log_error("Atomic operation failed. pthread_mutex_lock(&gAtomicLock) "
-                  "returned an error\n");
-    cl_int old = *a;
-    *a = old + b;
-    if (pthread_mutex_unlock(&gAtomicLock))
-        log_error("Failed to release gAtomicLock. Further atomic operations "
-                  "may deadlock!\n");
-    return old;
-#endif
+    return AsAtomic(a)->fetch_add(b);
+}
+
+cl_int ThreadPool_AtomicCompareExchange(volatile cl_int *a, cl_int expected,
+                                        cl_int desired)
+{
+    AsAtomic(a)->compare_exchange_strong(expected, desired);
+    return expected;
 }
 
 #if defined(_WIN32)
@@ -247,18 +330,49 @@ pthread_mutex_t cond_lock;
 pthread_cond_t cond_var;
 #endif // !_WIN32
 
-// Condition variable state. How many iterations on the function left to run,
-// set to CL_INT_MAX to cause worker threads to exit. Note: this value might
-// go negative.
-std::atomic<cl_int> gRunCount{ 0 };
+// Per worker job queue. Each worker owns a contiguous range of job ids
+// [begin, end) packed into a single 64-bit word, so that the owner can claim
+// jobs from the front and idle workers can steal from the back with a single
+// compare and swap. Padded so that every queue sits on its own cache line.
+struct WorkerQueue
+{
+    std::atomic<cl_ulong> range;
+    char pad[64 - sizeof(std::atomic<cl_ulong>)];
+};
+
+static inline cl_ulong PackRange(cl_uint begin, cl_uint end)
+{
+    return ((cl_ulong)end << 32) | begin;
+}
+static inline cl_uint RangeBegin(cl_ulong range) { return (cl_uint)range; }
+
+static inline cl_uint RangeEnd(cl_ulong range)
+{
+    return (cl_uint)(range >> 32);
+}
+
+// One queue per launched worker thread, indexed by thread id. The queues are
+// only refilled by ThreadPool_Do while every worker is parked.
+static std::unique_ptr<WorkerQueue[]> gQueues;
+
+// Tasks from ThreadPool_Submit waiting for a thread, oldest first
+static std::mutex gTaskLock;
+static std::deque<std::shared_ptr<ThreadPoolTaskState>> gTasks;
+
+// Set by ThreadPool_Exit() to cause worker threads to exit.
+std::atomic<bool> gExit{ false };
+
+// Thread id of the worker running on this thread, or -1 on other threads
+static thread_local cl_int gWorkerThreadID = -1;
 
 // State that only changes when the threadpool is not working.
 volatile TPFuncPtr gFunc_ptr = NULL;
 volatile void *gUserInfo = NULL;
-volatile cl_int gJobCount = 0;
 
 // State that may change while the thread pool is working
-volatile cl_int jobError = CL_SUCCESS; // err code return for the job as a whole
+std::atomic<cl_int> jobError{
+    CL_SUCCESS
+}; // err code return for the job as a whole
 
 // Condition variable to park caller while waiting
 #if defined(_WIN32)
@@ -275,6 +389,180 @@ std::atomic<cl_int> gRunning{ 0 };
 // The total number of threads launched.
 std::atomic<cl_int> gThreadCount{ 0 };
 
+#if defined(__linux__) && !defined(__ANDROID__)
+// CPUs the worker threads are pinned to when CL_TEST_THREADPOOL_PIN is set in
+// the environment, grouped by NUMA node so that workers with neighbouring
+// thread ids (which steal from each other first) share a node.
+static std::vector<int> gPinCPUs;
+
+// Appends the CPUs of a sysfs cpulist (e.g. "0-7,16-23") that are also in
+// affinity to cpus, marking them as used.
+static void AppendCPUList(const char *list, cpu_set_t *affinity,
+                          std::vector<int> &cpus)
+{
+    while (*list)
+    {
+        char *next;
+        long first = strtol(list, &next, 10);
+        if (next == list) break;
+        long last = first;
+        if ('-' == *next) last = strtol(next + 1, &next, 10);
+        for (long cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++)
+        {
+            if (CPU_ISSET(cpu, affinity))
+            {
+                cpus.push_back((int)cpu);
+                CPU_CLR(cpu, affinity);
+            }
+        }
+        list = ',' == *next ? next + 1 : next;
+        if ('\n' == *list) break;
+    }
+}
+
+static void ThreadPool_InitPinning(void)
+{
+    cpu_set_t affinity;
+    if (0 != sched_getaffinity(0, sizeof(cpu_set_t), &affinity))
+    {
+        log_error("Warning: sched_getaffinity failed. ThreadPool worker "
+                  "threads will not be pinned.\n");
+        return;
+    }
+
+    for (int node = 0;; node++)
+    {
+        char path[64];
+        char list[4096];
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist",
+                 node);
+        FILE *fp = fopen(path, "r");
+        if (NULL == fp) break;
+        if (fgets(list, sizeof(list), fp))
+            AppendCPUList(list, &affinity, gPinCPUs);
+        fclose(fp);
+    }
+
+    // CPUs not described by any NUMA node, or all of them if the system does
+    // not expose NUMA topology.
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+        if (CPU_ISSET(cpu, &affinity)) gPinCPUs.push_back(cpu);
+}
+
+static void ThreadPool_PinThread(cl_uint threadID)
+{
+    if (gPinCPUs.empty()) return;
+
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(gPinCPUs[threadID % gPinCPUs.size()], &cpus);
+    if (int err = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus))
+        log_error("Warning: Error %d pinning ThreadPool worker %u to CPU %d\n",
+                  err, threadID, gPinCPUs[threadID % gPinCPUs.size()]);
+}
+#endif
+
+// Claims the next job from the front of queue, returns false if it is empty.
+static bool ClaimFromQueue(WorkerQueue &queue, cl_uint *job)
+{
+    cl_ulong range = queue.range.load();
+    while (RangeBegin(range) < RangeEnd(range))
+    {
+        if (queue.range.compare_exchange_weak(
+                range, PackRange(RangeBegin(range) + 1, RangeEnd(range))))
+        {
+            *job = RangeBegin(range);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Steals the back half of the jobs of another worker, starting with the
+// nearest thread ids. The first stolen job is returned in job and the rest
+// become the thief's own queue. The thief's queue must be empty.
+static bool StealJob(cl_uint thief, cl_uint *job)
+{
+    cl_uint count = gThreadCount;
+    for (cl_uint i = 1; i < count; i++)
+    {
+        WorkerQueue &victim = gQueues[(thief + i) % count];
+        cl_ulong range = victim.range.load();
+        while (RangeBegin(range) < RangeEnd(range))
+        {
+            cl_uint begin = RangeBegin(range);
+            cl_uint end = RangeEnd(range);
+            cl_uint split = end - (end - begin + 1) / 2;
+            if (victim.range.compare_exchange_weak(range,
+                                                   PackRange(begin, split)))
+            {
+                *job = split;
+                gQueues[thief].range = PackRange(split + 1, end);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Takes the oldest submitted task off the queue, if there is one.
+static std::shared_ptr<ThreadPoolTaskState> PopTask(void)
+{
+    std::lock_guard<std::mutex> lock(gTaskLock);
+    if (gTasks.empty()) return nullptr;
+    std::shared_ptr<ThreadPoolTaskState> task = std::move(gTasks.front());
+    gTasks.pop_front();
+    return task;
+}
+
+static bool RunQueuedTask(void)
+{
+    std::shared_ptr<ThreadPoolTaskState> task = PopTask();
+    if (!task) return false;
+    RunTask(task);
+    return true;
+}
+
+static void EnqueueTask(std::shared_ptr<ThreadPoolTaskState> task)
+{
+    // Lazily set up our threads, then run the task here if there are none
+    GetThreadCount();
+    if (threadPoolInitErr)
+    {
+        RunTask(task);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(gTaskLock);
+        gTasks.push_back(std::move(task));
+    }
+
+    // Wake a parked worker. Taking cond_lock orders this after the check of
+    // the queue by any worker about to park.
+#if defined(_WIN32)
+    EnterCriticalSection(cond_lock);
+    _WakeAllConditionVariable(cond_var);
+    LeaveCriticalSection(cond_lock);
+#else // !_WIN32
+    pthread_mutex_lock(&cond_lock);
+    if (int err = pthread_cond_broadcast(&cond_var))
+        log_error("Error %d from pthread_cond_broadcast. Unable to wake up "
+                  "work threads. ThreadPool_Submit failed.\n",
+                  err);
+    pthread_mutex_unlock(&cond_lock);
+#endif // !_WIN32
+}
+
+// Returns false once there is no work left for this ThreadPool_Do, or if a job
+// has failed.
+static bool ClaimJob(cl_uint threadID, cl_uint *job)
+{
+    if (CL_SUCCESS != jobError) return false;
+
+    return ClaimFromQueue(gQueues[threadID], job) || StealJob(threadID, job);
+}
+
 #ifdef _WIN32
 void ThreadPool_WorkerFunc(void *p)
 #else
@@ -283,112 +571,138 @@ void *ThreadPool_WorkerFunc(void *p)
 {
     auto &tid = *static_cast<std::atomic<cl_uint> *>(p);
     cl_uint threadID = tid++;
-    cl_int item = gRunCount--;
+    cl_uint job;
+    gWorkerThreadID = threadID;
+
+    std::string traceName = "ThreadPool worker " + std::to_string(threadID);
+    trace_thread_name(traceName.c_str());
 
-    while (MAX_COUNT > item)
+#if defined(__linux__) && !defined(__ANDROID__)
+    ThreadPool_PinThread(threadID);
+#endif
+
+    while (true)
     {
         cl_int err;
 
-        // check for more work to do
-        if (0 >= item)
+        // No work to do. Attempt to block waiting for work
+#if defined(_WIN32)
+        EnterCriticalSection(cond_lock);
+#else // !_WIN32
+        if ((err = pthread_mutex_lock(&cond_lock)))
         {
-            // No work to do. Attempt to block waiting for work
+            log_error("Error %d from pthread_mutex_lock. Worker %d unable to "
+                      "block waiting for work. ThreadPool_WorkerFunc failed.\n",
+                      err, threadID);
+            goto exit;
+        }
+#endif // !_WIN32
+
+        cl_int remaining = gRunning--;
+        if (1 == remaining)
+        { // last thread out signal the main thread to wake up
 #if defined(_WIN32)
-            EnterCriticalSection(cond_lock);
+            SetEvent(caller_event);
 #else // !_WIN32
-            if ((err = pthread_mutex_lock(&cond_lock)))
+            if ((err = pthread_mutex_lock(&caller_cond_lock)))
             {
-                log_error(
-                    "Error %d from pthread_mutex_lock. Worker %d unable to "
-                    "block waiting for work. ThreadPool_WorkerFunc failed.\n",
-                    err, threadID);
+                log_error("Error %d from pthread_mutex_lock. Unable to "
+                          "wake caller.\n",
+                          err);
+                goto exit;
+            }
+            if ((err = pthread_cond_broadcast(&caller_cond_var)))
+            {
+                log_error("Error %d from pthread_cond_broadcast. Unable to "
+                          "wake up main thread. ThreadPool_WorkerFunc "
+                          "failed.\n",
+                          err);
+                goto exit;
+            }
+            if ((err = pthread_mutex_unlock(&caller_cond_lock)))
+            {
+                log_error("Error %d from pthread_mutex_lock. Unable to "
+                          "wake caller.\n",
+                          err);
                 goto exit;
             }
 #endif // !_WIN32
+        }
 
-            cl_int remaining = gRunning--;
-            if (1 == remaining)
-            { // last thread out signal the main thread to wake up
+        // loop in case we are woken only to discover that some other thread
+        // already did all the work
+        while (!ClaimJob(threadID, &job))
+        {
+            if (gExit) // exit if we are done
+            {
 #if defined(_WIN32)
-                SetEvent(caller_event);
+                LeaveCriticalSection(cond_lock);
 #else // !_WIN32
-                if ((err = pthread_mutex_lock(&caller_cond_lock)))
-                {
-                    log_error("Error %d from pthread_mutex_lock. Unable to "
-                              "wake caller.\n",
-                              err);
-                    goto exit;
-                }
-                if ((err = pthread_cond_broadcast(&caller_cond_var)))
-                {
-                    log_error(
-                        "Error %d from pthread_cond_broadcast. Unable to wake "
-                        "up main thread. ThreadPool_WorkerFunc failed.\n",
-                        err);
-                    goto exit;
-                }
-                if ((err = pthread_mutex_unlock(&caller_cond_lock)))
-                {
-                    log_error("Error %d from pthread_mutex_lock. Unable to "
-                              "wake caller.\n",
-                              err);
-                    goto exit;
-                }
+                pthread_mutex_unlock(&cond_lock);
 #endif // !_WIN32
+                goto exit;
             }
 
-            // loop in case we are woken only to discover that some other thread
-            // already did all the work
-            while (0 >= item)
+            // Run submitted tasks while there are no jobs
+            std::shared_ptr<ThreadPoolTaskState> task = PopTask();
+            if (task)
             {
 #if defined(_WIN32)
-                _SleepConditionVariableCS(cond_var, cond_lock, INFINITE);
+                LeaveCriticalSection(cond_lock);
+                RunTask(task);
+                EnterCriticalSection(cond_lock);
 #else // !_WIN32
-                if ((err = pthread_cond_wait(&cond_var, &cond_lock)))
+                pthread_mutex_unlock(&cond_lock);
+                RunTask(task);
+                if ((err = pthread_mutex_lock(&cond_lock)))
                 {
-                    log_error(
-                        "Error %d from pthread_cond_wait. Unable to block for "
-                        "waiting for work. ThreadPool_WorkerFunc failed.\n",
-                        err);
-                    pthread_mutex_unlock(&cond_lock);
+                    log_error("Error %d from pthread_mutex_lock. Worker %d "
+                              "unable to block waiting for work. "
+                              "ThreadPool_WorkerFunc failed.\n",
+                              err, threadID);
                     goto exit;
                 }
 #endif // !_WIN32
-
-                // try again to get a valid item id
-                item = gRunCount--;
-                if (MAX_COUNT <= item) // exit if we are done
-                {
-#if defined(_WIN32)
-                    LeaveCriticalSection(cond_lock);
-#else // !_WIN32
-                    pthread_mutex_unlock(&cond_lock);
-#endif // !_WIN32
-                    goto exit;
-                }
+                continue;
             }
 
-            gRunning++;
-
 #if defined(_WIN32)
-            LeaveCriticalSection(cond_lock);
+            _SleepConditionVariableCS(cond_var, cond_lock, INFINITE);
 #else // !_WIN32
-            if ((err = pthread_mutex_unlock(&cond_lock)))
+            if ((err = pthread_cond_wait(&cond_var, &cond_lock)))
             {
-                log_error(
-                    "Error %d from pthread_mutex_unlock. Unable to block for "
-                    "waiting for work. ThreadPool_WorkerFunc failed.\n",
-                    err);
+                log_error("Error %d from pthread_cond_wait. Unable to block "
+                          "for waiting for work. ThreadPool_WorkerFunc "
+                          "failed.\n",
+                          err);
+                pthread_mutex_unlock(&cond_lock);
                 goto exit;
             }
 #endif // !_WIN32
         }
 
-        // we have a valid item, so do the work
-        // but only if we haven't already encountered an error
-        if (CL_SUCCESS == jobError)
+        gRunning++;
+
+#if defined(_WIN32)
+        LeaveCriticalSection(cond_lock);
+#else // !_WIN32
+        if ((err = pthread_mutex_unlock(&cond_lock)))
         {
-            // log_info("Thread %d doing job %d\n", threadID, item - 1);
+            log_error("Error %d from pthread_mutex_unlock. Unable to block for "
+                      "waiting for work. ThreadPool_WorkerFunc failed.\n",
+                      err);
+            goto exit;
+        }
+#endif // !_WIN32
+
+        // we have a valid job, so do the work until both our own queue and
+        // the queues we can steal from are drained
+        TraceSpan traceSpan("jobs", "threadpool");
+        size_t jobCount = 0;
+        do
+        {
+            jobCount++;
+            // log_info("Thread %d doing job %d\n", threadID, job);
 
 #if defined(__APPLE__) && defined(__arm__)
             // On most platforms which support denorm, default is FTZ off.
@@ -401,58 +715,23 @@ void *ThreadPool_WorkerFunc(void *p)
             // need to disable denorm flushing on host side where reference is
             // being computed to make sure we get non-flushed reference result.
             // If implementation returns flushed result, we correctly take care
-            // of that in verification code.
-            FPU_mode_type oldMode;
-            DisableFTZ(&oldMode);
+            // of that in verification code. Only the jobs that leave the mode
+            // changed cost a write.
+            FPStateGuard ftzGuard(kDisableFTZ);
 #endif
 
-            // Call the user's function with this item ID
-            err = gFunc_ptr(item - 1, threadID, (void *)gUserInfo);
-#if defined(__APPLE__) && defined(__arm__)
-            // Restore FP state
-            RestoreFPState(&oldMode);
-#endif
+            // Call the user's function with this job ID
+            err = gFunc_ptr(job, threadID, (void *)gUserInfo);
 
             if (err)
             {
-#if (__MINGW32__)
-                EnterCriticalSection(&gAtomicLock);
-                if (jobError == CL_SUCCESS) jobError = err;
-                gRunCount = 0;
-                LeaveCriticalSection(&gAtomicLock);
-#elif defined(__GNUC__)
-                // GCC extension:
-                // http://gcc.gnu.org/onlinedocs/gcc/Atomic-Builtins.html#Atomic-Builtins
-                // set the new error if we are the first one there.
-                __sync_val_compare_and_swap(&jobError, CL_SUCCESS, err);
-
-                // drop run count to 0
-                gRunCount = 0;
-                __sync_synchronize();
-#elif defined(_MSC_VER)
-                // set the new error if we are the first one there.
-                _InterlockedCompareExchange((volatile LONG *)&jobError, err,
-                                            CL_SUCCESS);
-
-                // drop run count to 0
-                gRunCount = 0;
-                _mm_mfence();
-#else
-                if (pthread_mutex_lock(&gAtomicLock))
-                    log_error(
-                        "Atomic operation failed. "
-                        "pthread_mutex_lock(&gAtomicLock) returned an error\n");
-                if (jobError == CL_SUCCESS) jobError = err;
-                gRunCount = 0;
-                if (pthread_mutex_unlock(&gAtomicLock))
-                    log_error("Failed to release gAtomicLock. Further atomic "
-                              "operations may deadlock\n");
-#endif
+                // set the new error if we are the first one there. This also
+                // stops every worker from claiming more jobs.
+                cl_int expected = CL_SUCCESS;
+                jobError.compare_exchange_strong(expected, err);
             }
-        }
-
-        // get the next item
-        item = gRunCount--;
+        } while (ClaimJob(threadID, &job));
+        traceSpan.set_count("jobs", jobCount);
     }
 
 exit:
@@ -610,11 +889,6 @@ void ThreadPool_Init(void)
     pthread_mutex_init(&gThreadPoolLock, NULL);
 #endif
 
-#if !(defined(__GNUC__) || defined(_MSC_VER) || defined(__MINGW32__))
-    pthread_mutex_initialize(gAtomicLock);
-#elif defined(__MINGW32__)
-    InitializeCriticalSection(&gAtomicLock);
-#endif
     // Make sure the last thread done in the work pool doesn't signal us to wake
     // before we get to the point where we are supposed to wait
     //  That would cause a deadlock.
@@ -629,6 +903,13 @@ void ThreadPool_Init(void)
     }
 #endif // !_WIN32
 
+#if defined(__linux__) && !defined(__ANDROID__)
+    if (getenv("CL_TEST_THREADPOOL_PIN")) ThreadPool_InitPinning();
+#endif
+
+    gQueues.reset(new WorkerQueue[gThreadCount]);
+    for (i = 0; i < gThreadCount; i++) gQueues[i].range = PackRange(0, 0);
+
     gRunning = gThreadCount.load();
     // init threads
     for (i = 0; i < gThreadCount; i++)
@@ -646,6 +927,7 @@ void ThreadPool_Init(void)
         {
             log_error("Error %d launching thread %d\n", err, i);
             threadPoolInitErr = err;
+            gRunning -= gThreadCount - i;
             gThreadCount = i;
             break;
         }
@@ -656,8 +938,8 @@ void ThreadPool_Init(void)
 
     atexit(ThreadPool_Exit);
 
-    // block until they are done launching.
-    do
+    // block until they are done launching and have all parked.
+    while (gRunning)
     {
 #if defined(_WIN32)
         WaitForSingleObject(caller_event, INFINITE);
@@ -671,7 +953,7 @@ void ThreadPool_Init(void)
             return;
         }
 #endif // !_WIN32
-    } while (gRunCount != -gThreadCount);
+    }
 #if !defined(_WIN32)
     if ((err = pthread_mutex_unlock(&caller_cond_lock)))
     {
@@ -696,17 +978,7 @@ static BOOL CALLBACK _ThreadPool_Init(_PINIT_ONCE InitOnce, PVOID Parameter,
 
 void ThreadPool_Exit(void)
 {
-    gRunCount = CL_INT_MAX;
-
-#if defined(__GNUC__)
-    // GCC extension:
-    // http://gcc.gnu.org/onlinedocs/gcc/Atomic-Builtins.html#Atomic-Builtins
-    __sync_synchronize();
-#elif defined(_MSC_VER)
-    _mm_mfence();
-#else
-#warning If this is a weakly ordered memory system, please add a memory barrier here to force this and everything else to memory before we proceed
-#endif
+    gExit = true;
 
     // spin waiting for threads to die
     for (int count = 0; 0 != gThreadCount && count < 1000; count++)
@@ -752,6 +1024,10 @@ void ThreadPool_Exit(void)
 // It may return with some work undone if func_ptr() returns a non-zero
 // result.
 //
+// Jobs are split into one contiguous range per worker thread. A worker that
+// runs out of jobs steals half of the remaining range of another worker, so
+// there is no shared job counter for the threads to contend on.
+//
 // This function obviously has its shortcommings. Only one call to ThreadPool_Do
 // can be running at a time. It is not intended for general purpose use.
 // If clEnqueueNativeKernelFn, out of order queues and a CL_DEVICE_TYPE_CPU were
@@ -762,6 +1038,8 @@ cl_int ThreadPool_Do(TPFuncPtr func_ptr, cl_uint count, void *userInfo)
     cl_int newErr;
 #endif
     cl_int err = 0;
+    TraceSpan traceSpan("ThreadPool_Do", "threadpool");
+    traceSpan.set_count("jobs", count);
     // Lazily set up our threads
 #if defined(_MSC_VER) && (_WIN32_WINNT >= 0x600)
     err = !_InitOnceExecuteOnce(&threadpool_init_control, _ThreadPool_Init,
@@ -783,6 +1061,18 @@ cl_int ThreadPool_Do(TPFuncPtr func_ptr, cl_uint count, void *userInfo)
         return err;
     }
 #endif
+    // Run the jobs one after the other on the calling worker, under its own
+    // thread id, as the pool is busy with the job that called us
+    if (ThreadPool_InWorker())
+    {
+        for (cl_uint currentJob = 0; currentJob < count; currentJob++)
+            if (cl_int result =
+                    func_ptr(currentJob, (cl_uint)gWorkerThreadID, userInfo))
+                return result;
+
+        return CL_SUCCESS;
+    }
+
     // Single threaded code to handle case where threadpool wasn't allocated or
     // was disabled by environment variable
     if (threadPoolInitErr)
@@ -801,27 +1091,17 @@ cl_int ThreadPool_Do(TPFuncPtr func_ptr, cl_uint count, void *userInfo)
         // side where reference is being computed to make sure we get
         // non-flushed reference result. If implementation returns flushed
         // result, we correctly take care of that in verification code.
-        FPU_mode_type oldMode;
-        DisableFTZ(&oldMode);
+        FPStateGuard ftzGuard(kDisableFTZ);
 #endif
         for (currentJob = 0; currentJob < count; currentJob++)
-            if ((result = func_ptr(currentJob, 0, userInfo)))
-            {
-#if defined(__APPLE__) && defined(__arm__)
-                // Restore FP state before leaving
-                RestoreFPState(&oldMode);
-#endif
-                return result;
-            }
-
-#if defined(__APPLE__) && defined(__arm__)
-        // Restore FP state before leaving
-        RestoreFPState(&oldMode);
-#endif
+            if ((result = func_ptr(currentJob, 0, userInfo))) return result;
 
         return CL_SUCCESS;
     }
 
+    // Nothing to wait for, and no worker would wake us up
+    if (0 == count) return CL_SUCCESS;
+
     if (count >= MAX_COUNT)
     {
         log_error(
@@ -879,11 +1159,18 @@ cl_int ThreadPool_Do(TPFuncPtr func_ptr, cl_uint count, void *userInfo)
     }
 #endif // !_WIN32
 
-    // Prime the worker threads to get going
+    // Prime the worker threads to get going. Each worker starts with an equal
+    // contiguous share of the jobs and steals from the others once its own
+    // share is done.
     jobError = CL_SUCCESS;
-    gRunCount = gJobCount = count;
     gFunc_ptr = func_ptr;
     gUserInfo = userInfo;
+    for (cl_int i = 0; i < gThreadCount; i++)
+    {
+        cl_uint begin = (cl_uint)((cl_ulong)count * i / gThreadCount);
+        cl_uint end = (cl_uint)((cl_ulong)count * (i + 1) / gThreadCount);
+        gQueues[i].range = PackRange(begin, end);
+    }
 
 #if defined(_WIN32)
     ResetEvent(caller_event);
@@ -955,6 +1242,8 @@ exit:
     return err;
 }
 
+bool ThreadPool_InWorker(void) { return gWorkerThreadID >= 0; }
+
 cl_uint GetThreadCount(void)
 {
     // Lazily set up our threads
@@ -1012,6 +1301,16 @@ cl_int ThreadPool_AtomicAdd(volatile cl_int *a, cl_int b)
     return r;
 }
 
+cl_int ThreadPool_AtomicCompareExchange(volatile cl_int *a, cl_int expected,
+                                        cl_int desired)
+{
+    cl_int r = *a;
+
+    if (r == expected) *a = desired;
+
+    return r;
+}
+
 // Blocking API that farms out count jobs to a thread pool.
 // It may return with some work undone if func_ptr() returns a non-zero
 // result.
@@ -1044,6 +1343,15 @@ cl_int ThreadPool_Do(TPFuncPtr func_ptr, cl_uint count, void *userInfo)
 
 cl_uint GetThreadCount(void) { return 1; }
 
+bool ThreadPool_InWorker(void) { return false; }
+
+static void EnqueueTask(std::shared_ptr<ThreadPoolTaskState> task)
+{
+    RunTask(task);
+}
+
+static bool RunQueuedTask(void) { return false; }
+
 void SetThreadCount(int count)
 {
     if (count > 1) log_info("WARNING: SetThreadCount(%d) ignored\n", count);
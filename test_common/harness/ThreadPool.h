@@ -22,28 +22,99 @@
 #include <CL/cl.h>
 #endif
 
+#include <atomic>
+#include <functional>
+#include <memory>
+
 //
 // An atomic add operator
 cl_int ThreadPool_AtomicAdd(volatile cl_int *a, cl_int b); // returns old value
 
+// An atomic compare and swap operator. Stores desired to *a if *a == expected.
+cl_int ThreadPool_AtomicCompareExchange(volatile cl_int *a, cl_int expected,
+                                        cl_int desired); // returns old value
+
+// A lock-free counter that may be shared between TPFuncPtrs or callbacks, e.g.
+// to count failures or to track the progress of a ThreadPool_Do.
+template <typename T> class AtomicCounter {
+public:
+    explicit AtomicCounter(T value = 0): mValue(value) {}
+
+    // returns old value
+    T add(T value) { return mValue.fetch_add(value); }
+    T increment() { return add(1); }
+    T load() const { return mValue.load(); }
+    void reset(T value = 0) { mValue.store(value); }
+
+private:
+    std::atomic<T> mValue;
+};
+
 // Your function prototype
 //
 // A function pointer to the function you want to execute in a multithreaded
 // context.  No synchronization primitives are provided, other than the atomic
-// add above. You may not call ThreadPool_Do from your function.
-// ThreadPool_AtomicAdd() and GetThreadCount() should work, however.
+// operators above. A ThreadPool_Do called from your function runs its jobs
+// serially on the calling thread. The atomic operators, GetThreadCount() and
+// ThreadPool_Submit() work as usual.
 //
 // job ids and thread ids are 0 based.  If number of jobs or threads was 8, they
 // will numbered be 0 through 7. Note that while every job will be run, it is
-// not guaranteed that every thread will wake up before the work is done.
+// not guaranteed that every thread will wake up before the work is done, nor
+// that jobs are run in any particular order.
 typedef cl_int (*TPFuncPtr)(cl_uint /*job_id*/, cl_uint /* thread_id */,
                             void *userInfo);
 
 // returns first non-zero result from func_ptr, or CL_SUCCESS if all are zero.
 // Some workitems may not run if a non-zero result is returned from func_ptr().
-// This function may not be called from a TPFuncPtr.
+// Called from a worker thread, e.g. from a TPFuncPtr or a task, it runs the
+// jobs one after the other on that thread and with its thread_id, as the other
+// workers may be busy with the jobs of the outer call.
 cl_int ThreadPool_Do(TPFuncPtr func_ptr, cl_uint count, void *userInfo);
 
+// True on the worker threads, where ThreadPool_Do runs serially. Helpers that
+// split their work across the pool may use this to take their serial path
+// directly.
+bool ThreadPool_InWorker(void);
+
+struct ThreadPoolTaskState;
+
+// Handle to a task queued with ThreadPool_Submit. Copies refer to the same
+// task.
+class ThreadPoolTask {
+public:
+    ThreadPoolTask() = default;
+
+    bool valid() const { return state != nullptr; }
+
+    // True once the task has run.
+    bool done() const;
+
+    // Blocks until the task has run and returns its result. The caller runs
+    // other queued tasks while it waits, so this may be called from a
+    // TPFuncPtr or from another task.
+    cl_int wait() const;
+
+    // Queues func to run once this task has, with this task's result.
+    ThreadPoolTask then(std::function<cl_int(cl_int)> func) const;
+
+private:
+    friend ThreadPoolTask ThreadPool_Submit(std::function<cl_int()> func);
+
+    explicit ThreadPoolTask(std::shared_ptr<ThreadPoolTaskState> state)
+        : state(std::move(state))
+    {}
+
+    std::shared_ptr<ThreadPoolTaskState> state;
+};
+
+// Queues func to run on the worker threads and returns without waiting for
+// it. The workers take tasks whenever they have no ThreadPool_Do jobs, in the
+// order they were queued. This may be called from a TPFuncPtr or from another
+// task.
+// Without worker threads func runs before ThreadPool_Submit returns.
+ThreadPoolTask ThreadPool_Submit(std::function<cl_int()> func);
+
 // Returns the number of worker threads that underlie the threadpool.  The value
 // passed as the TPFuncPtrs thread_id will be between 0 and this value less one,
 // inclusive. This is safe to call from a TPFuncPtr.
@@ -60,6 +131,10 @@ cl_uint GetThreadCount(void);
 // is suggested as a convention that test apps set the thread count to 1 in
 // response to the -m flag.
 //
+// On Linux, if the CL_TEST_THREADPOOL_PIN environment variable is set then
+// each worker thread is pinned to one CPU of the process affinity mask, with
+// CPUs grouped by NUMA node.
+//
 // SetThreadCount() must be called before the first call to GetThreadCount() or
 // ThreadPool_Do(), otherwise the behavior is indefined. It may not be called
 // from a TPFuncPtr.
@@ -29,6 +29,13 @@
 #include "mingw_compat.h"
 #endif
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
 inline void* align_malloc(size_t size, size_t alignment)
 {
 #if defined(_WIN32) && defined(_MSC_VER)
@@ -66,4 +73,161 @@ inline void align_free(void* ptr)
 #endif
 }
 
+// Scratch memory for the host side arrays of a test, carved out of large
+// aligned blocks kept per thread. Whatever is allocated after a mark is
+// given back at once by rewinding to it, and the blocks stay around for the
+// next sub-case, so that sweeps don't pay for malloc, free and first-touch
+// page faults on every iteration. Use ScratchScope and ScratchArray rather
+// than calling it directly.
+class ScratchArena {
+public:
+    struct Mark
+    {
+        size_t block;
+        size_t used;
+    };
+
+    static const size_t kDefaultAlignment = 64;
+
+    static ScratchArena &this_thread()
+    {
+        static thread_local ScratchArena arena;
+        return arena;
+    }
+
+    ScratchArena(): m_current(0), m_retained(0) {}
+    ~ScratchArena() { release(); }
+
+    // Gives NULL if a new block can't be allocated. alignment must be a
+    // power of two.
+    void *allocate(size_t size, size_t alignment = kDefaultAlignment)
+    {
+        for (; m_current < m_blocks.size(); m_current++)
+        {
+            void *p = carve(m_blocks[m_current], size, alignment);
+            if (p) return p;
+            // Blocks past the current one are free after a rewind
+            if (m_current + 1 < m_blocks.size())
+                m_blocks[m_current + 1].used = 0;
+        }
+
+        // Each new block is at least twice the last, so that a sweep that
+        // keeps growing settles on a few blocks
+        size_t blockSize = size + alignment;
+        if (blockSize < kMinBlockSize) blockSize = kMinBlockSize;
+        if (!m_blocks.empty() && blockSize < m_blocks.back().size * 2)
+            blockSize = m_blocks.back().size * 2;
+        Block block = { (char *)align_malloc(blockSize, kBlockAlignment),
+                        blockSize, 0 };
+        if (block.data == NULL) return NULL;
+        m_blocks.push_back(block);
+        m_retained += blockSize;
+        m_current = m_blocks.size() - 1;
+        return carve(m_blocks.back(), size, alignment);
+    }
+
+    Mark mark() const
+    {
+        Mark m = { m_current,
+                   m_current < m_blocks.size() ? m_blocks[m_current].used
+                                               : 0 };
+        return m;
+    }
+
+    // Give back everything allocated since m. Once nothing is allocated,
+    // the blocks are freed if they add up to more than kMaxRetained.
+    void rewind(const Mark &m)
+    {
+        m_current = m.block;
+        if (m_current < m_blocks.size()) m_blocks[m_current].used = m.used;
+        if (m.block == 0 && m.used == 0 && m_retained > kMaxRetained)
+            release();
+    }
+
+    void release()
+    {
+        for (Block &block : m_blocks) align_free(block.data);
+        m_blocks.clear();
+        m_current = 0;
+        m_retained = 0;
+    }
+
+private:
+    struct Block
+    {
+        char *data;
+        size_t size;
+        size_t used;
+    };
+
+    static const size_t kMinBlockSize = 4 << 20;
+    static const size_t kBlockAlignment = 4096;
+    static const size_t kMaxRetained = (size_t)1 << 30;
+
+    ScratchArena(const ScratchArena &) = delete;
+    ScratchArena &operator=(const ScratchArena &) = delete;
+
+    static void *carve(Block &block, size_t size, size_t alignment)
+    {
+        uintptr_t base = (uintptr_t)block.data;
+        uintptr_t start = (base + block.used + alignment - 1)
+            & ~(uintptr_t)(alignment - 1);
+        if (start - base > block.size || size > block.size - (start - base))
+            return NULL;
+        block.used = start - base + size;
+        return (void *)start;
+    }
+
+    std::vector<Block> m_blocks;
+    size_t m_current;
+    size_t m_retained;
+};
+
+// Gives back the scratch memory the calling thread allocates while in scope
+class ScratchScope {
+public:
+    ScratchScope()
+        : m_arena(ScratchArena::this_thread()), m_mark(m_arena.mark())
+    {}
+    ~ScratchScope() { m_arena.rewind(m_mark); }
+
+private:
+    ScratchScope(const ScratchScope &) = delete;
+    ScratchScope &operator=(const ScratchScope &) = delete;
+
+    ScratchArena &m_arena;
+    ScratchArena::Mark m_mark;
+};
+
+// An uninitialized array of count T in the scratch arena of the calling
+// thread, in place of a malloc or align_malloc that is freed at the end of
+// the scope. The arrays of a thread must go out of scope in the reverse
+// order that they were made in, as locals do. data() is NULL if the memory
+// couldn't be allocated.
+template <typename T> class ScratchArray {
+    static_assert(std::is_trivially_destructible<T>::value,
+                  "ScratchArray doesn't run destructors");
+
+public:
+    explicit ScratchArray(size_t count,
+                          size_t alignment = ScratchArena::kDefaultAlignment)
+        : m_count(count)
+    {
+        m_data = (T *)ScratchArena::this_thread().allocate(
+            count * sizeof(T), std::max(alignment, alignof(T)));
+    }
+
+    T *data() const { return m_data; }
+    size_t size() const { return m_count; }
+    operator T *() const { return m_data; }
+
+private:
+    ScratchArray(const ScratchArray &) = delete;
+    ScratchArray &operator=(const ScratchArray &) = delete;
+
+    ScratchScope m_scope;
+    T *m_data;
+    size_t m_count;
+};
+
 #endif // #ifndef HARNESS_ALLOC_H_
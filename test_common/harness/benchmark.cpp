@@ -0,0 +1,167 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "benchmark.h"
+
+#include "errorHelpers.h"
+#include "perfMetrics.h"
+#include "timelineTrace.h"
+#include "typeWrappers.h"
+
+#include <math.h>
+
+#include <algorithm>
+#include <string>
+
+double benchmark_percentile(const std::vector<double> &sorted, double p)
+{
+    if (sorted.empty()) return 0;
+    double rank = p / 100 * (sorted.size() - 1);
+    size_t below = (size_t)rank;
+    if (below + 1 >= sorted.size()) return sorted.back();
+    double fraction = rank - below;
+    return sorted[below] + fraction * (sorted[below + 1] - sorted[below]);
+}
+
+BenchmarkStats compute_benchmark_stats(std::vector<double> &samples)
+{
+    BenchmarkStats stats;
+    if (samples.empty()) return stats;
+
+    std::sort(samples.begin(), samples.end());
+    double q1 = benchmark_percentile(samples, 25);
+    double q3 = benchmark_percentile(samples, 75);
+    double low = q1 - 3 * (q3 - q1);
+    double high = q3 + 3 * (q3 - q1);
+    std::vector<double> kept;
+    for (double sample : samples)
+        if (sample >= low && sample <= high) kept.push_back(sample);
+
+    size_t n = kept.size();
+    stats.samples = n;
+    stats.outliers = samples.size() - n;
+    stats.min = kept.front();
+    stats.max = kept.back();
+    stats.median = benchmark_percentile(kept, 50);
+    stats.p90 = benchmark_percentile(kept, 90);
+    stats.p99 = benchmark_percentile(kept, 99);
+
+    double sum = 0;
+    for (double sample : kept) sum += sample;
+    stats.mean = sum / n;
+    double squares = 0;
+    for (double sample : kept)
+        squares += (sample - stats.mean) * (sample - stats.mean);
+    stats.stddev = n > 1 ? sqrt(squares / (n - 1)) : 0;
+
+    // The median lies between the order statistics of ranks
+    // (n -/+ 1.96 sqrt(n)) / 2 with 95% probability. Too few samples give no
+    // better interval than their range.
+    double spread = 1.96 * sqrt((double)n);
+    double lowRank = floor((n - spread) / 2);
+    double highRank = ceil(1 + (n + spread) / 2);
+    stats.ciLow = lowRank >= 1 ? kept[(size_t)lowRank - 1] : kept.front();
+    stats.ciHigh = highRank <= n ? kept[(size_t)highRank - 1] : kept.back();
+    stats.sorted.swap(kept);
+    return stats;
+}
+
+cl_int run_benchmark(const BenchmarkOptions &options,
+                     const BenchmarkSampleFn &sample, BenchmarkStats *stats)
+{
+    double value;
+    for (size_t i = 0; i < options.warmup; i++)
+        if (cl_int error = sample(&value)) return error;
+
+    std::vector<double> samples;
+    std::vector<double> sorted;
+    TelemetryRecording telemetry;
+    HostTimer timer;
+    while (samples.size() < options.maxSamples)
+    {
+        if (cl_int error = sample(&value)) return error;
+        samples.push_back(value);
+        if (samples.size() < options.minSamples) continue;
+
+        sorted = samples;
+        *stats = compute_benchmark_stats(sorted);
+        double width = stats->ciHigh - stats->ciLow;
+        if (width <= options.relativeCI * fabs(stats->median)) break;
+        if (timer.elapsed_ns() >= options.maxSeconds * 1e9) break;
+    }
+
+    *stats = compute_benchmark_stats(samples);
+    stats->telemetry = telemetry.stop();
+    return CL_SUCCESS;
+}
+
+cl_int get_event_duration_ns(cl_event event, double *ns, cl_profiling_info from,
+                             cl_profiling_info to)
+{
+    cl_ulong start, end;
+    cl_int error = clGetEventProfilingInfo(event, from, sizeof(start), &start,
+                                           NULL);
+    test_error(error, "clGetEventProfilingInfo failed");
+    error = clGetEventProfilingInfo(event, to, sizeof(end), &end, NULL);
+    test_error(error, "clGetEventProfilingInfo failed");
+    *ns = end > start ? (double)(end - start) : 0.0;
+    return CL_SUCCESS;
+}
+
+cl_int benchmark_1d_kernel(cl_command_queue queue, cl_kernel kernel,
+                           size_t global, size_t local,
+                           const BenchmarkOptions &options,
+                           BenchmarkStats *stats)
+{
+    return run_benchmark(
+        options,
+        [&](double *ns) {
+            clEventWrapper event;
+            cl_int error = clEnqueueNDRangeKernel(queue, kernel, 1, NULL,
+                                                  &global,
+                                                  local ? &local : NULL, 0,
+                                                  NULL, &event);
+            test_error(error, "clEnqueueNDRangeKernel failed");
+            trace_command(queue, event, "benchmark_1d_kernel", 0, 0);
+            error = clWaitForEvents(1, &event);
+            test_error(error, "clWaitForEvents failed");
+            return get_event_duration_ns(event, ns);
+        },
+        stats);
+}
+
+void log_benchmark_header(const char *benchmark, const char *labelName)
+{
+    log_info("BENCH\t%s\t%s\tunit\tsamples\toutliers\tmedian\tci_low\tci_high"
+             "\tmean\tstddev\tmin\tp90\tp99\tmax\n",
+             benchmark, labelName);
+}
+
+void log_benchmark_stats(const char *benchmark, const char *label,
+                         const char *unit, bool higherIsBetter,
+                         const BenchmarkStats &stats)
+{
+    log_info("BENCH\t%s\t%s\t%s\t%zu\t%zu\t%g\t%g\t%g\t%g\t%g\t%g\t%g\t%g\t%g"
+             "\n",
+             benchmark, label, unit, stats.samples, stats.outliers,
+             stats.median, stats.ciLow, stats.ciHigh, stats.mean, stats.stddev,
+             stats.min, stats.p90, stats.p99, stats.max);
+    for (const telemetry_summary &channel : stats.telemetry)
+        log_info("TELEMETRY\t%s\t%s\t%s\t%s\t%zu\tmin %g\tmean %g\tmax %g\n",
+                 benchmark, label, channel.name.c_str(), channel.unit.c_str(),
+                 channel.samples, channel.min, channel.mean, channel.max);
+    record_perf_metric(std::string(benchmark) + "." + label, stats.median, unit,
+                       higherIsBetter, stats.sorted, stats.telemetry);
+}
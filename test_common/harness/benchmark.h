@@ -0,0 +1,149 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef HARNESS_BENCHMARK_H_
+#define HARNESS_BENCHMARK_H_
+
+#include "compat.h"
+#include "telemetry.h"
+
+#include <CL/opencl.h>
+
+#include <stddef.h>
+
+#include <chrono>
+#include <functional>
+#include <vector>
+
+// Shared pieces of the benchmarks: taking samples until their median is
+// known well enough, summarising them and reporting the summary. A benchmark
+// is registered with ADD_BENCHMARK in the test list. It then only runs when it
+// is named on the command line, or matched by a wildcard, and never as part
+// of "all" or of a run without test names.
+//
+//     BenchmarkStats stats;
+//     cl_int error = run_benchmark(BenchmarkOptions(), [&](double *ns) {
+//         HostTimer timer;
+//         ...
+//         *ns = timer.elapsed_ns();
+//         return CL_SUCCESS;
+//     }, &stats);
+//     test_error(error, "...");
+//     log_benchmark_header("my_bench", "case");
+//     log_benchmark_stats("my_bench", "some_case", "ns", false, stats);
+
+struct BenchmarkOptions
+{
+    // Samples taken and thrown away first
+    size_t warmup = 3;
+    // Samples to take at least and at most
+    size_t minSamples = 10;
+    size_t maxSamples = 1000;
+    // Stop once the 95% confidence interval of the median is at most this
+    // fraction of the median
+    double relativeCI = 0.02;
+    // Stop after this many seconds of samples, once there are minSamples
+    double maxSeconds = 5.0;
+};
+
+struct BenchmarkStats
+{
+    // Samples kept, and those rejected as outliers by Tukey's fences at 3
+    // times the interquartile range
+    size_t samples = 0;
+    size_t outliers = 0;
+
+    double min = 0;
+    double median = 0;
+    double mean = 0;
+    double stddev = 0;
+    double p90 = 0;
+    double p99 = 0;
+    double max = 0;
+
+    // 95% confidence interval of the median, from the order statistics
+    double ciLow = 0;
+    double ciHigh = 0;
+
+    // The samples kept, in increasing order
+    std::vector<double> sorted;
+
+    // Telemetry read while run_benchmark took the samples, after the warmup
+    std::vector<telemetry_summary> telemetry;
+};
+
+// Summarise samples in any unit. Sorts them.
+BenchmarkStats compute_benchmark_stats(std::vector<double> &samples);
+
+// Value of the p-th percentile, 0 to 100, of sorted samples, interpolating
+// between neighbours
+double benchmark_percentile(const std::vector<double> &sorted, double p);
+
+// Returns one measurement in *value, or an error which ends the benchmark
+typedef std::function<cl_int(double *value)> BenchmarkSampleFn;
+
+// Take samples as options ask for, and summarise them in stats. Returns the
+// first error of sample.
+cl_int run_benchmark(const BenchmarkOptions &options,
+                     const BenchmarkSampleFn &sample, BenchmarkStats *stats);
+
+// Time on the host clock since construction or the last restart
+class HostTimer {
+public:
+    HostTimer(): m_start(std::chrono::steady_clock::now()) {}
+
+    void restart() { m_start = std::chrono::steady_clock::now(); }
+
+    double elapsed_ns() const
+    {
+        return std::chrono::duration<double, std::nano>(
+                   std::chrono::steady_clock::now() - m_start)
+            .count();
+    }
+
+    double elapsed_us() const { return elapsed_ns() / 1e3; }
+    double elapsed_ms() const { return elapsed_ns() / 1e6; }
+
+private:
+    std::chrono::steady_clock::time_point m_start;
+};
+
+// Time between two of the CL_PROFILING_COMMAND_* points of event, which must
+// be complete and come from a queue with profiling enabled
+cl_int get_event_duration_ns(cl_event event, double *ns,
+                             cl_profiling_info from =
+                                 CL_PROFILING_COMMAND_START,
+                             cl_profiling_info to = CL_PROFILING_COMMAND_END);
+
+// Sample the device time, in nanoseconds, of a 1D launch of kernel with its
+// arguments already set, on queue, which must have profiling enabled. A local
+// size of 0 leaves it to the implementation.
+cl_int benchmark_1d_kernel(cl_command_queue queue, cl_kernel kernel,
+                           size_t global, size_t local,
+                           const BenchmarkOptions &options,
+                           BenchmarkStats *stats);
+
+// Log the column names of the BENCH rows of log_benchmark_stats, with the
+// name of what label distinguishes
+void log_benchmark_header(const char *benchmark, const char *labelName);
+
+// Log stats as a BENCH row, followed by a TELEMETRY row for each channel
+// read, and record their median as the perf metric benchmark.label, with the
+// samples kept and the telemetry
+void log_benchmark_stats(const char *benchmark, const char *label,
+                         const char *unit, bool higherIsBetter,
+                         const BenchmarkStats &stats);
+
+#endif // HARNESS_BENCHMARK_H_
@@ -0,0 +1,207 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "bufferSizing.h"
+
+#include "errorHelpers.h"
+#include "parseParameters.h"
+#include "timelineTrace.h"
+#include "typeWrappers.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <chrono>
+#include <vector>
+
+#if defined(__APPLE__)
+#include <sys/sysctl.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+// A buffer should take this many times the enqueue overhead to transfer
+const double kLatencyMultiple = 32.0;
+
+size_t RoundDownToPowerOfTwo(cl_ulong x)
+{
+    size_t result = 1;
+    while (result <= x / 2) result *= 2;
+    return result;
+}
+
+size_t RoundUpToPowerOfTwo(double x)
+{
+    size_t result = 1;
+    while (result < x && result < kMaxTestBufferSize) result *= 2;
+    return result;
+}
+
+// Return the time in seconds of the fastest of repeat blocking writes of size
+// bytes to buffer.
+double TimeWrite(cl_command_queue queue, cl_mem buffer, size_t size,
+                 const void *data, int repeat)
+{
+    double best = -1.0;
+    for (int i = 0; i < repeat; i++)
+    {
+        clEventWrapper event;
+        auto start = std::chrono::steady_clock::now();
+        if (clEnqueueWriteBuffer(queue, buffer, CL_TRUE, 0, size, data, 0,
+                                 NULL, trace_enabled() ? &event : NULL))
+            return -1.0;
+        trace_command(queue, event, "buffer sizing write", size, 0);
+        std::chrono::duration<double> time =
+            std::chrono::steady_clock::now() - start;
+        if (best < 0.0 || time.count() < best) best = time.count();
+    }
+    return best;
+}
+
+} // anonymous namespace
+
+bool parse_memory_size(const char *text, uint64_t &bytes)
+{
+    if (!isdigit((unsigned char)*text)) return false;
+    char *end;
+    unsigned long long value = strtoull(text, &end, 10);
+    // Each suffix multiplies by another 1024
+    const char *units = "kmgt";
+    const char *unit = *end ? strchr(units, tolower((unsigned char)*end)) : NULL;
+    unsigned shift = 0;
+    if (unit)
+    {
+        shift = 10 * (unsigned)(unit - units + 1);
+        end++;
+    }
+    if (*end != '\0' || value == 0 || value > (UINT64_MAX >> shift))
+        return false;
+    bytes = (uint64_t)value << shift;
+    return true;
+}
+
+cl_ulong limit_to_host_mem_budget(cl_ulong size)
+{
+    return gHostMemBudget ? std::min(size, (cl_ulong)gHostMemBudget) : size;
+}
+
+cl_ulong limit_to_device_mem_budget(cl_ulong size)
+{
+    return gDeviceMemBudget ? std::min(size, (cl_ulong)gDeviceMemBudget)
+                            : size;
+}
+
+size_t get_host_cache_size()
+{
+#if defined(__APPLE__)
+    const char *names[] = { "hw.l3cachesize", "hw.l2cachesize" };
+    for (const char *name : names)
+    {
+        int64_t size = 0;
+        size_t length = sizeof(size);
+        if (0 == sysctlbyname(name, &size, &length, NULL, 0) && size > 0)
+            return (size_t)size;
+    }
+#elif defined(_WIN32)
+    DWORD length = 0;
+    GetLogicalProcessorInformation(NULL, &length);
+    std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> info(
+        length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+    size_t size = 0;
+    if (!info.empty() && GetLogicalProcessorInformation(info.data(), &length))
+        for (const auto &i : info)
+            if (RelationCache == i.Relationship)
+                size = std::max(size, (size_t)i.Cache.Size);
+    return size;
+#elif defined(_SC_LEVEL3_CACHE_SIZE) && defined(_SC_LEVEL2_CACHE_SIZE)
+    long size = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    if (size <= 0) size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    if (size > 0) return (size_t)size;
+#endif
+    return 0;
+}
+
+size_t ChooseBufferSize(cl_context context, cl_command_queue queue,
+                        cl_device_id device, size_t defaultSize,
+                        cl_uint deviceBufferCount,
+                        cl_uint hostWorkingSetBuffers)
+{
+    if (gBufferSizeOverride)
+    {
+        log_info("Using buffer size %zu set with --buffer-size\n",
+                 gBufferSizeOverride);
+        return gBufferSizeOverride;
+    }
+
+    // Leave most of the device memory to the implementation
+    cl_ulong globalMemSize = 0, maxAllocSize = 0;
+    if (clGetDeviceInfo(device, CL_DEVICE_GLOBAL_MEM_SIZE,
+                        sizeof(globalMemSize), &globalMemSize, NULL)
+        || clGetDeviceInfo(device, CL_DEVICE_MAX_MEM_ALLOC_SIZE,
+                           sizeof(maxAllocSize), &maxAllocSize, NULL))
+    {
+        log_info("Unable to query device memory, using buffer size %zu\n",
+                 defaultSize);
+        return defaultSize;
+    }
+    globalMemSize = limit_to_device_mem_budget(globalMemSize);
+    maxAllocSize = limit_to_device_mem_budget(maxAllocSize);
+    cl_ulong memoryLimit =
+        std::min(globalMemSize / (4 * (cl_ulong)deviceBufferCount),
+                 maxAllocSize);
+    // The host keeps a copy of each device buffer
+    if (gHostMemBudget)
+        memoryLimit = std::min(
+            memoryLimit, (cl_ulong)gHostMemBudget / (2 * deviceBufferCount));
+    size_t memorySize = std::max(kMinTestBufferSize,
+                                 std::min(kMaxTestBufferSize,
+                                          RoundDownToPowerOfTwo(memoryLimit)));
+
+    // Estimate the enqueue overhead from tiny writes and the bandwidth from a
+    // large one.
+    size_t latencySize = defaultSize;
+    size_t probeSize = std::min(memorySize, (size_t)16 * 1024 * 1024);
+    cl_int error;
+    cl_mem probe =
+        clCreateBuffer(context, CL_MEM_READ_WRITE, probeSize, NULL, &error);
+    if (probe)
+    {
+        std::vector<char> data(probeSize);
+        double latency = TimeWrite(queue, probe, 4, data.data(), 8);
+        double transfer = TimeWrite(queue, probe, probeSize, data.data(), 2);
+        if (latency > 0.0 && transfer > 0.0)
+            latencySize = RoundUpToPowerOfTwo(kLatencyMultiple * latency
+                                              * probeSize / transfer);
+        clReleaseMemObject(probe);
+    }
+
+    // Keep the verification working set in the host cache
+    size_t cacheSize = get_host_cache_size();
+    size_t cacheLimit = cacheSize
+        ? std::max(defaultSize,
+                   RoundDownToPowerOfTwo(cacheSize / hostWorkingSetBuffers))
+        : defaultSize;
+
+    size_t size = std::min(std::max(defaultSize, latencySize), cacheLimit);
+    size = std::min(size, memorySize);
+    log_info("Using buffer size %zu (enqueue overhead wants %zu, host cache "
+             "%zu, device memory %zu)\n",
+             size, latencySize, cacheLimit, memorySize);
+    return size;
+}
@@ -0,0 +1,56 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef HARNESS_BUFFER_SIZING_H_
+#define HARNESS_BUFFER_SIZING_H_
+
+#include "compat.h"
+
+#include <CL/opencl.h>
+
+// Smallest and largest buffer sizes ChooseBufferSize picks
+static const size_t kMinTestBufferSize = 64 * 1024;
+static const size_t kMaxTestBufferSize = 64 * 1024 * 1024;
+
+// Parse a size in bytes such as 65536, 64K, 512M or 4G, the suffixes being
+// powers of 1024
+bool parse_memory_size(const char *text, uint64_t &bytes);
+
+// size capped to the budget set with --host-mem-budget or
+// --device-mem-budget, if any. Tests use these on the memory sizes they
+// derive their working sets from, so that several suites can run on one
+// machine at once.
+cl_ulong limit_to_host_mem_budget(cl_ulong size);
+cl_ulong limit_to_device_mem_budget(cl_ulong size);
+
+// Cache size in bytes of the largest host CPU cache level, or 0 if unknown
+size_t get_host_cache_size();
+
+// Pick the size in bytes of the chunks that a brute force test streams its
+// input domain through, a power of two.
+//
+// Starting from defaultSize, the size grows until the time to transfer a
+// buffer clearly outweighs the measured cost of an enqueue, but not past
+// what keeps hostWorkingSetBuffers buffers in the host cache for
+// verification. It shrinks as needed so that deviceBufferCount buffers fit
+// comfortably in the device's global memory and each buffer in its maximum
+// allocation, and so that as many host buffers fit in the host memory
+// budget. --buffer-size overrides all of this.
+size_t ChooseBufferSize(cl_context context, cl_command_queue queue,
+                        cl_device_id device, size_t defaultSize,
+                        cl_uint deviceBufferCount,
+                        cl_uint hostWorkingSetBuffers);
+
+#endif // HARNESS_BUFFER_SIZING_H_
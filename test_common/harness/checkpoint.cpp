@@ -0,0 +1,183 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "checkpoint.h"
+
+#include "errorHelpers.h"
+#include "parseParameters.h"
+
+#include <stdio.h>
+#include <string.h>
+
+namespace {
+
+const char kCheckpointMagic[] = "CLCHECKPOINT";
+const unsigned kCheckpointVersion = 1;
+
+struct CheckpointJobs
+{
+    JobCheckpoint *checkpoint;
+    TPFuncPtr func;
+    void *userInfo;
+};
+
+cl_int CheckpointJob(cl_uint job_id, cl_uint thread_id, void *p)
+{
+    CheckpointJobs *jobs = (CheckpointJobs *)p;
+    if (jobs->checkpoint->IsDone(job_id)) return CL_SUCCESS;
+
+    cl_int error = jobs->func(job_id, thread_id, jobs->userInfo);
+    if (CL_SUCCESS == error) jobs->checkpoint->MarkDone(job_id);
+    return error;
+}
+
+} // anonymous namespace
+
+const int JobCheckpoint::kSaveIntervalSeconds;
+
+JobCheckpoint::JobCheckpoint(const std::string &path, cl_uint jobCount)
+    : path(path), done(jobCount, false), resumed(0), dirty(false),
+      lastSave(std::chrono::steady_clock::now())
+{}
+
+JobCheckpoint::~JobCheckpoint() { Save(); }
+
+std::unique_ptr<JobCheckpoint> JobCheckpoint::Open(const std::string &name,
+                                                   cl_uint jobCount)
+{
+    if (gCheckpointPath.empty()) return nullptr;
+
+    std::unique_ptr<JobCheckpoint> checkpoint(
+        new JobCheckpoint(gCheckpointPath + "/" + name + ".ckpt", jobCount));
+    if (!gResumeFromCheckpoint)
+        checkpoint->dirty = true; // replace any earlier checkpoint
+    else if (checkpoint->Load() && checkpoint->resumed)
+        log_info("Resuming %s with %u of %u jobs done\n", name.c_str(),
+                 checkpoint->resumed, jobCount);
+    return checkpoint;
+}
+
+bool JobCheckpoint::Load()
+{
+    FILE *file = fopen(path.c_str(), "r");
+    if (NULL == file) return false;
+
+    char magic[sizeof(kCheckpointMagic)] = { 0 };
+    unsigned version = 0;
+    unsigned jobCount = 0;
+    bool valid = 3 == fscanf(file, "%12s %u %u", magic, &version, &jobCount)
+        && 0 == strcmp(magic, kCheckpointMagic)
+        && kCheckpointVersion == version && jobCount == done.size();
+
+    unsigned first, last;
+    while (valid && 2 == fscanf(file, "%u %u", &first, &last))
+    {
+        if (first > last || last >= done.size())
+        {
+            valid = false;
+            break;
+        }
+        for (unsigned i = first; i <= last; i++) done[i] = true;
+    }
+    fclose(file);
+
+    if (!valid)
+    {
+        log_info("Ignoring checkpoint %s written for different jobs\n",
+                 path.c_str());
+        done.assign(done.size(), false);
+        return false;
+    }
+
+    for (bool d : done) resumed += d;
+    return true;
+}
+
+bool JobCheckpoint::IsDone(cl_uint job)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return done[job];
+}
+
+void JobCheckpoint::MarkDone(cl_uint job)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    done[job] = true;
+    dirty = true;
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastSave >= std::chrono::seconds(kSaveIntervalSeconds))
+    {
+        SaveLocked();
+        lastSave = now;
+    }
+}
+
+void JobCheckpoint::Save()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    SaveLocked();
+}
+
+void JobCheckpoint::SaveLocked()
+{
+    if (!dirty) return;
+
+    // Write a new file and move it over the old one, so an interruption
+    // while saving leaves the previous checkpoint intact.
+    std::string temp = path + ".tmp";
+    FILE *file = fopen(temp.c_str(), "w");
+    if (NULL == file)
+    {
+        log_error("Unable to write checkpoint %s\n", temp.c_str());
+        return;
+    }
+
+    fprintf(file, "%s %u %u\n", kCheckpointMagic, kCheckpointVersion,
+            (unsigned)done.size());
+    for (size_t i = 0; i < done.size(); i++)
+    {
+        if (!done[i]) continue;
+        size_t first = i;
+        while (i + 1 < done.size() && done[i + 1]) i++;
+        fprintf(file, "%u %u\n", (unsigned)first, (unsigned)i);
+    }
+
+    if (0 != fclose(file))
+    {
+        log_error("Unable to write checkpoint %s\n", temp.c_str());
+        return;
+    }
+#if defined(_WIN32)
+    remove(path.c_str());
+#endif
+    if (0 != rename(temp.c_str(), path.c_str()))
+    {
+        log_error("Unable to replace checkpoint %s\n", path.c_str());
+        return;
+    }
+    dirty = false;
+}
+
+cl_int ThreadPool_DoCheckpointed(JobCheckpoint *checkpoint, TPFuncPtr func_ptr,
+                                 cl_uint count, void *userInfo)
+{
+    if (NULL == checkpoint) return ThreadPool_Do(func_ptr, count, userInfo);
+
+    CheckpointJobs jobs = { checkpoint, func_ptr, userInfo };
+    cl_int error = ThreadPool_Do(CheckpointJob, count, &jobs);
+    checkpoint->Save();
+    return error;
+}
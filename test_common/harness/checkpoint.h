@@ -0,0 +1,79 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef HARNESS_CHECKPOINT_H_
+#define HARNESS_CHECKPOINT_H_
+
+#include "ThreadPool.h"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Record of which of the numbered jobs of a long test have completed
+// successfully, kept in a small state file under --checkpoint-path so that a
+// run interrupted by a driver reset or a preempted node can pick up where it
+// stopped with --resume.
+//
+// The file lists the completed job ranges and is rewritten at most every
+// kSaveIntervalSeconds while jobs complete, and once more when the checkpoint
+// is destroyed. Jobs must be numbered the same way on every run; a file
+// written for a different job count is ignored.
+class JobCheckpoint {
+public:
+    static const int kSaveIntervalSeconds = 30;
+
+    // Return the checkpoint for the work called name made of jobCount jobs,
+    // with the jobs finished by an earlier run marked done if resuming.
+    // Return nullptr if checkpointing is disabled. name is used as the file
+    // name and should be unique to the function, type and vector sizes tested.
+    static std::unique_ptr<JobCheckpoint> Open(const std::string &name,
+                                               cl_uint jobCount);
+
+    ~JobCheckpoint();
+
+    bool IsDone(cl_uint job);
+    void MarkDone(cl_uint job);
+
+    // Number of jobs that were already done when the checkpoint was opened
+    cl_uint ResumedCount() const { return resumed; }
+
+    void Save();
+
+private:
+    JobCheckpoint(const std::string &path, cl_uint jobCount);
+    JobCheckpoint(const JobCheckpoint &) = delete;
+    JobCheckpoint &operator=(const JobCheckpoint &) = delete;
+
+    bool Load();
+    void SaveLocked();
+
+    std::string path;
+    std::mutex lock;
+    std::vector<bool> done;
+    cl_uint resumed;
+    bool dirty;
+    std::chrono::steady_clock::time_point lastSave;
+};
+
+// Like ThreadPool_Do, but skip the jobs that checkpoint has recorded as done
+// and record those that return CL_SUCCESS. checkpoint may be NULL, in which
+// case this is plain ThreadPool_Do.
+cl_int ThreadPool_DoCheckpointed(JobCheckpoint *checkpoint, TPFuncPtr func_ptr,
+                                 cl_uint count, void *userInfo);
+
+#endif // HARNESS_CHECKPOINT_H_
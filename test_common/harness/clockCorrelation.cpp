@@ -0,0 +1,220 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "clockCorrelation.h"
+#include "errorHelpers.h"
+#include "testHarness.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+// Clock pairs the fit is over, the oldest are dropped first
+const size_t kMaxClockSamples = 64;
+// Below this span of device time a slope fit is mostly noise, so only the
+// offset is fitted
+const double kMinSlopeSpanNs = 50e6;
+
+struct ClockSample
+{
+    cl_ulong device;
+    cl_ulong host;
+};
+
+class DeviceClock {
+public:
+    DeviceClock(cl_device_id device, unsigned intervalMs)
+        : m_device(device), m_intervalMs(intervalMs), m_stop(false)
+    {}
+
+    ~DeviceClock() { Stop(); }
+
+    cl_int Sample()
+    {
+        ClockSample sample;
+        cl_int error =
+            clGetDeviceAndHostTimer(m_device, &sample.device, &sample.host);
+        if (error != CL_SUCCESS) return error;
+
+        std::lock_guard<std::mutex> lock(m_samplesLock);
+        m_samples.push_back(sample);
+        if (m_samples.size() > kMaxClockSamples) m_samples.pop_front();
+        return CL_SUCCESS;
+    }
+
+    void Start() { m_sampler = std::thread(&DeviceClock::Run, this); }
+
+    void Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_stopLock);
+            m_stop = true;
+        }
+        m_stopCondition.notify_all();
+        if (m_sampler.joinable()) m_sampler.join();
+    }
+
+    void Fit(ClockFit &fit)
+    {
+        std::lock_guard<std::mutex> lock(m_samplesLock);
+        // Relative to the first pair, so the sums keep their precision
+        const ClockSample &base = m_samples.front();
+        double n = (double)m_samples.size();
+        double meanX = 0, meanY = 0;
+        for (const ClockSample &sample : m_samples)
+        {
+            meanX += (double)(cl_long)(sample.device - base.device);
+            meanY += (double)(cl_long)(sample.host - base.host);
+        }
+        meanX /= n;
+        meanY /= n;
+
+        double covariance = 0, variance = 0;
+        for (const ClockSample &sample : m_samples)
+        {
+            double x = (double)(cl_long)(sample.device - base.device) - meanX;
+            double y = (double)(cl_long)(sample.host - base.host) - meanY;
+            covariance += x * y;
+            variance += x * x;
+        }
+        double span =
+            (double)(cl_long)(m_samples.back().device - base.device);
+
+        fit.slope = 1.0;
+        if (span >= kMinSlopeSpanNs && variance > 0)
+            fit.slope = covariance / variance;
+        fit.deviceBase = base.device;
+        fit.hostBase = (double)base.host + meanY - fit.slope * meanX;
+        fit.samples = m_samples.size();
+    }
+
+private:
+    void Run()
+    {
+        std::unique_lock<std::mutex> lock(m_stopLock);
+        while (!m_stop)
+        {
+            m_stopCondition.wait_for(lock,
+                                     std::chrono::milliseconds(m_intervalMs));
+            if (m_stop) break;
+            lock.unlock();
+            cl_int error = Sample();
+            if (error != CL_SUCCESS)
+                print_error(error, "clGetDeviceAndHostTimer failed");
+            lock.lock();
+        }
+    }
+
+    cl_device_id m_device;
+    unsigned m_intervalMs;
+    std::mutex m_samplesLock;
+    std::deque<ClockSample> m_samples;
+    std::mutex m_stopLock;
+    std::condition_variable m_stopCondition;
+    bool m_stop;
+    std::thread m_sampler;
+};
+
+std::mutex gClocksMutex;
+std::map<cl_device_id, std::unique_ptr<DeviceClock>> gClocks;
+
+bool has_host_timer(cl_device_id device)
+{
+    if (get_device_cl_version(device) < Version(2, 1)) return false;
+
+    cl_platform_id platform;
+    cl_ulong resolution = 0;
+    if (clGetDeviceInfo(device, CL_DEVICE_PLATFORM, sizeof(platform),
+                        &platform, NULL)
+            != CL_SUCCESS
+        || clGetPlatformInfo(platform, CL_PLATFORM_HOST_TIMER_RESOLUTION,
+                             sizeof(resolution), &resolution, NULL)
+            != CL_SUCCESS)
+        return false;
+    return resolution != 0;
+}
+
+} // anonymous namespace
+
+cl_ulong ClockFit::to_host(cl_ulong deviceTime) const
+{
+    double delta = (double)(cl_long)(deviceTime - deviceBase);
+    return (cl_ulong)(hostBase + slope * delta + 0.5);
+}
+
+cl_int start_clock_correlation(cl_device_id device, unsigned intervalMs)
+{
+    std::lock_guard<std::mutex> lock(gClocksMutex);
+    if (gClocks.count(device)) return CL_SUCCESS;
+
+    if (!has_host_timer(device))
+    {
+        log_info("The device has no host timer, device timestamps can't be "
+                 "converted to host time.\n");
+        return CL_INVALID_OPERATION;
+    }
+
+    std::unique_ptr<DeviceClock> clock(new DeviceClock(device, intervalMs));
+    cl_int error = clock->Sample();
+    if (error != CL_SUCCESS)
+    {
+        print_error(error, "clGetDeviceAndHostTimer failed");
+        return error;
+    }
+    clock->Start();
+    gClocks[device] = std::move(clock);
+    return CL_SUCCESS;
+}
+
+cl_int get_clock_fit(cl_device_id device, ClockFit *fit)
+{
+    std::lock_guard<std::mutex> lock(gClocksMutex);
+    auto it = gClocks.find(device);
+    if (it == gClocks.end()) return CL_INVALID_OPERATION;
+    it->second->Fit(*fit);
+    return CL_SUCCESS;
+}
+
+cl_int device_to_host_time(cl_device_id device, cl_ulong deviceTime,
+                           cl_ulong *hostTime)
+{
+    ClockFit fit;
+    cl_int error = get_clock_fit(device, &fit);
+    if (error != CL_SUCCESS) return error;
+    *hostTime = fit.to_host(deviceTime);
+    return CL_SUCCESS;
+}
+
+cl_int event_host_time(cl_device_id device, cl_event event,
+                       cl_profiling_info param, cl_ulong *hostTime)
+{
+    cl_ulong deviceTime;
+    cl_int error = clGetEventProfilingInfo(event, param, sizeof(deviceTime),
+                                           &deviceTime, NULL);
+    if (error != CL_SUCCESS) return error;
+    return device_to_host_time(device, deviceTime, hostTime);
+}
+
+void stop_clock_correlation()
+{
+    std::lock_guard<std::mutex> lock(gClocksMutex);
+    gClocks.clear();
+}
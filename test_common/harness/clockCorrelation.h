@@ -0,0 +1,73 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef HARNESS_CLOCK_CORRELATION_H_
+#define HARNESS_CLOCK_CORRELATION_H_
+
+#include "compat.h"
+
+#include <CL/opencl.h>
+
+#include <stddef.h>
+
+// Conversion of device timestamps, including the CL_PROFILING_COMMAND_*
+// values of events, to the host timer of clGetHostTimer, so that host and
+// device activity can be put on one timeline. Once started for a device, a
+// background thread pairs the two clocks with clGetDeviceAndHostTimer every
+// interval and the conversion uses a least squares fit of the most recent
+// pairs, which follows both the offset and the drift between them. Needs a
+// device with OpenCL 2.1 or later and a platform host timer; the harness
+// stops the sampling after the tests.
+
+// The fitted line host = hostBase + slope * (device - deviceBase)
+struct ClockFit
+{
+    cl_ulong deviceBase;
+    double hostBase;
+    double slope;
+    // Number of clock pairs the fit is over
+    size_t samples;
+
+    // How much faster the host clock runs than the device clock, in parts
+    // per million
+    double drift_ppm() const { return (slope - 1.0) * 1e6; }
+
+    cl_ulong to_host(cl_ulong deviceTime) const;
+};
+
+// Start pairing the clocks of device every intervalMs if that isn't already
+// happening, taking the first pair before returning. Gives
+// CL_INVALID_OPERATION if the device or platform has no host timer.
+cl_int start_clock_correlation(cl_device_id device,
+                               unsigned intervalMs = 100);
+
+// The current fit for device. Gives CL_INVALID_OPERATION if no correlation
+// was started for it.
+cl_int get_clock_fit(cl_device_id device, ClockFit *fit);
+
+// Host time of a device timestamp of device
+cl_int device_to_host_time(cl_device_id device, cl_ulong deviceTime,
+                           cl_ulong *hostTime);
+
+// Host time of the CL_PROFILING_COMMAND_* timestamp param of event, which
+// must have been enqueued on a profiling queue of device
+cl_int event_host_time(cl_device_id device, cl_event event,
+                       cl_profiling_info param, cl_ulong *hostTime);
+
+// Stop the sampling for every device and forget the fits, called by the
+// harness after the tests
+void stop_clock_correlation();
+
+#endif // HARNESS_CLOCK_CORRELATION_H_
@@ -0,0 +1,118 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "contextPool.h"
+#include "errorHelpers.h"
+#include "testHarness.h"
+
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace {
+
+struct PoolEntry
+{
+    clContextWrapper context;
+    clCommandQueueWrapper queue;
+};
+
+typedef std::pair<cl_device_id, cl_command_queue_properties> PoolKey;
+
+std::mutex gPoolMutex;
+std::multimap<PoolKey, PoolEntry> gPool;
+
+cl_int create_pool_entry(cl_device_id device,
+                         cl_command_queue_properties queueProps,
+                         PoolEntry &entry)
+{
+    cl_int error = CL_SUCCESS;
+    entry.context =
+        clCreateContext(NULL, 1, &device, notify_callback, NULL, &error);
+    if (!entry.context)
+    {
+        print_error(error, "Unable to create pooled context");
+        return error;
+    }
+
+    if (get_device_cl_version(device) < Version(2, 0))
+    {
+        entry.queue =
+            clCreateCommandQueue(entry.context, device, queueProps, &error);
+    }
+    else
+    {
+        const cl_command_queue_properties cmd_queueProps =
+            (queueProps) ? CL_QUEUE_PROPERTIES : 0;
+        cl_command_queue_properties queueCreateProps[] = { cmd_queueProps,
+                                                           queueProps, 0 };
+        entry.queue = clCreateCommandQueueWithProperties(
+            entry.context, device, &queueCreateProps[0], &error);
+    }
+    if (!entry.queue)
+    {
+        print_error(error, "Unable to create pooled command queue");
+        entry.context.reset();
+        return error;
+    }
+    return CL_SUCCESS;
+}
+
+} // anonymous namespace
+
+PooledContext::PooledContext(cl_device_id device,
+                             cl_command_queue_properties queueProps)
+    : m_device(device), m_queueProps(queueProps), m_status(CL_SUCCESS),
+      m_discard(false)
+{
+    PoolKey key(device, queueProps);
+    {
+        std::lock_guard<std::mutex> lock(gPoolMutex);
+        auto it = gPool.find(key);
+        if (it != gPool.end())
+        {
+            m_context = std::move(it->second.context);
+            m_queue = std::move(it->second.queue);
+            gPool.erase(it);
+            return;
+        }
+    }
+
+    PoolEntry entry;
+    m_status = create_pool_entry(device, queueProps, entry);
+    m_context = std::move(entry.context);
+    m_queue = std::move(entry.queue);
+}
+
+PooledContext::~PooledContext()
+{
+    if (m_discard || m_status != CL_SUCCESS) return;
+
+    // Anything the test left queued must not leak into the next borrower
+    if (clFinish(m_queue) != CL_SUCCESS) return;
+
+    PoolEntry entry;
+    entry.context = std::move(m_context);
+    entry.queue = std::move(m_queue);
+
+    std::lock_guard<std::mutex> lock(gPoolMutex);
+    gPool.emplace(PoolKey(m_device, m_queueProps), std::move(entry));
+}
+
+void release_context_pool()
+{
+    std::lock_guard<std::mutex> lock(gPoolMutex);
+    gPool.clear();
+}
@@ -0,0 +1,64 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef HARNESS_CONTEXT_POOL_H_
+#define HARNESS_CONTEXT_POOL_H_
+
+#include "compat.h"
+#include "typeWrappers.h"
+
+#include <CL/opencl.h>
+
+// A single device context and a command queue on it, borrowed from a pool
+// kept for the whole run so that tests which need their own context don't
+// pay for creating one every time.
+//
+// The first borrow for a device and set of queue properties creates the
+// context and queue; later ones reuse a pair returned by a previous test.
+// On return the queue is finished, and the pair is dropped if that fails or
+// if discard() was called, so a test that leaves them in a bad state doesn't
+// affect the next one. Objects the test created in the context must not be
+// relied on by later tests.
+class PooledContext {
+public:
+    explicit PooledContext(cl_device_id device,
+                           cl_command_queue_properties queueProps = 0);
+    ~PooledContext();
+
+    // CL_SUCCESS, or the error from creating the context or queue
+    cl_int status() const { return m_status; }
+
+    const clContextWrapper &context() const { return m_context; }
+    const clCommandQueueWrapper &queue() const { return m_queue; }
+
+    // Don't return the context to the pool, e.g. after a test failure
+    void discard() { m_discard = true; }
+
+private:
+    PooledContext(const PooledContext &) = delete;
+    PooledContext &operator=(const PooledContext &) = delete;
+
+    cl_device_id m_device;
+    cl_command_queue_properties m_queueProps;
+    clContextWrapper m_context;
+    clCommandQueueWrapper m_queue;
+    cl_int m_status;
+    bool m_discard;
+};
+
+// Release every context in the pool, called by the harness after the tests
+void release_context_pool();
+
+#endif // HARNESS_CONTEXT_POOL_H_
@@ -14,12 +14,14 @@
 // limitations under the License.
 //
 #include "conversions.h"
+#include <algorithm>
 #include <cinttypes>
 #include <limits.h>
 #include <time.h>
 #include <assert.h>
 #include "mt19937.h"
 #include "compat.h"
+#include "ThreadPool.h"
 
 #include <CL/cl_half.h>
 
@@ -208,825 +210,467 @@ static Long sLowerLimits[kNumExplicitTypes] = {
     0
 }; // Last two values aren't stored here
 
-#define BOOL_CASE(inType)                                                      \
-    case kBool:                                                                \
-        boolPtr = (bool *)outRaw;                                              \
-        *boolPtr = (*inType##Ptr) != 0 ? true : false;                         \
-        break;
-
-#define SIMPLE_CAST_CASE(inType, outEnum, outType)                             \
-    case outEnum:                                                              \
-        outType##Ptr = (outType *)outRaw;                                      \
-        *outType##Ptr = (outType)(*inType##Ptr);                               \
-        break;
-
-// Sadly, the ULong downcasting cases need a separate #define to get rid of
-// signed/unsigned comparison warnings
-#define DOWN_CAST_CASE(inType, outEnum, outType, sat)                          \
-    case outEnum:                                                              \
-        outType##Ptr = (outType *)outRaw;                                      \
-        if (sat)                                                               \
-        {                                                                      \
-            if ((sLowerLimits[outEnum] < 0                                     \
-                 && *inType##Ptr > (Long)sUpperLimits[outEnum])                \
-                || (sLowerLimits[outEnum] == 0                                 \
-                    && (ULong)*inType##Ptr > sUpperLimits[outEnum]))           \
-                *outType##Ptr = (outType)sUpperLimits[outEnum];                \
-            else if (*inType##Ptr < sLowerLimits[outEnum])                     \
-                *outType##Ptr = (outType)sLowerLimits[outEnum];                \
-            else                                                               \
-                *outType##Ptr = (outType)*inType##Ptr;                         \
-        }                                                                      \
-        else                                                                   \
-        {                                                                      \
-            *outType##Ptr = (outType)(                                         \
-                *inType##Ptr                                                   \
-                & (0xffffffffffffffffLL >> (64 - (sizeof(outType) * 8))));     \
-        }                                                                      \
-        break;
-
-#define U_DOWN_CAST_CASE(inType, outEnum, outType, sat)                        \
-    case outEnum:                                                              \
-        outType##Ptr = (outType *)outRaw;                                      \
-        if (sat)                                                               \
-        {                                                                      \
-            if ((ULong)*inType##Ptr > sUpperLimits[outEnum])                   \
-                *outType##Ptr = (outType)sUpperLimits[outEnum];                \
-            else                                                               \
-                *outType##Ptr = (outType)*inType##Ptr;                         \
-        }                                                                      \
-        else                                                                   \
-        {                                                                      \
-            *outType##Ptr = (outType)(                                         \
-                *inType##Ptr                                                   \
-                & (0xffffffffffffffffLL >> (64 - (sizeof(outType) * 8))));     \
-        }                                                                      \
-        break;
-
-#define TO_HALF_CASE(inType)                                                   \
-    case kHalf:                                                                \
-        halfPtr = (cl_half *)outRaw;                                           \
-        *halfPtr = cl_half_from_float((float)(*inType##Ptr), CL_HALF_RTE);     \
-        break;
-#define TO_FLOAT_CASE(inType)                                                  \
-    case kFloat:                                                               \
-        floatPtr = (float *)outRaw;                                            \
-        *floatPtr = (float)(*inType##Ptr);                                     \
-        break;
-#define TO_DOUBLE_CASE(inType)                                                 \
-    case kDouble:                                                              \
-        doublePtr = (double *)outRaw;                                          \
-        *doublePtr = (double)(*inType##Ptr);                                   \
-        break;
-
-
-/* Note: we use lrintf here to force the rounding instead of whatever the
- * processor's current rounding mode is */
-#define FLOAT_ROUND_TO_NEAREST_CASE(outEnum, outType)                          \
-    case outEnum:                                                              \
-        outType##Ptr = (outType *)outRaw;                                      \
-        *outType##Ptr = (outType)lrintf_clamped(*floatPtr);                    \
-        break;
-
-#define HALF_ROUND_CASE(outEnum, outType, rounding, sat)                       \
-    case outEnum: {                                                            \
-        outType##Ptr = (outType *)outRaw;                                      \
-        /* Get the tens digit */                                               \
-        float fltEq = (Long)cl_half_to_float(*halfPtr);                        \
-        Long wholeValue = (Long)fltEq;                                         \
-        float largeRemainder = (fltEq - (float)wholeValue) * 10.f;             \
-        /* What do we do based on that? */                                     \
-        if (rounding == kRoundToEven)                                          \
-        {                                                                      \
-            if (wholeValue & 1LL) /*between 1 and 1.99 */                      \
-                wholeValue += 1LL; /* round up to even */                      \
-        }                                                                      \
-        else if (rounding == kRoundToZero)                                     \
-        {                                                                      \
-            /* Nothing to do, round-to-zero is what C casting does */          \
-        }                                                                      \
-        else if (rounding == kRoundToPosInf)                                   \
-        {                                                                      \
-            /* Only positive numbers are wrong */                              \
-            if (largeRemainder != 0.f && wholeValue >= 0) wholeValue++;        \
-        }                                                                      \
-        else if (rounding == kRoundToNegInf)                                   \
-        {                                                                      \
-            /* Only negative numbers are off */                                \
-            if (largeRemainder != 0.f && wholeValue < 0) wholeValue--;         \
-        }                                                                      \
-        else                                                                   \
-        { /* Default is round-to-nearest */                                    \
-            wholeValue = (Long)lrintf_clamped(fltEq);                          \
-        }                                                                      \
-        /* Now apply saturation rules */                                       \
-        if (sat)                                                               \
-        {                                                                      \
-            if ((sLowerLimits[outEnum] < 0                                     \
-                 && wholeValue > (Long)sUpperLimits[outEnum])                  \
-                || (sLowerLimits[outEnum] == 0                                 \
-                    && (ULong)wholeValue > sUpperLimits[outEnum]))             \
-                *outType##Ptr = (outType)sUpperLimits[outEnum];                \
-            else if (wholeValue < sLowerLimits[outEnum])                       \
-                *outType##Ptr = (outType)sLowerLimits[outEnum];                \
-            else                                                               \
-                *outType##Ptr = (outType)wholeValue;                           \
-        }                                                                      \
-        else                                                                   \
-        {                                                                      \
-            *outType##Ptr = (outType)(                                         \
-                wholeValue                                                     \
-                & (0xffffffffffffffffLL >> (64 - (sizeof(outType) * 8))));     \
-        }                                                                      \
-    }                                                                          \
-    break;
-
-#define FLOAT_ROUND_CASE(outEnum, outType, rounding, sat)                      \
-    case outEnum: {                                                            \
-        outType##Ptr = (outType *)outRaw;                                      \
-        /* Get the tens digit */                                               \
-        Long wholeValue = (Long)*floatPtr;                                     \
-        float largeRemainder = (*floatPtr - (float)wholeValue) * 10.f;         \
-        /* What do we do based on that? */                                     \
-        if (rounding == kRoundToEven)                                          \
-        {                                                                      \
-            if (wholeValue & 1LL) /*between 1 and 1.99 */                      \
-                wholeValue += 1LL; /* round up to even */                      \
-        }                                                                      \
-        else if (rounding == kRoundToZero)                                     \
-        {                                                                      \
-            /* Nothing to do, round-to-zero is what C casting does */          \
-        }                                                                      \
-        else if (rounding == kRoundToPosInf)                                   \
-        {                                                                      \
-            /* Only positive numbers are wrong */                              \
-            if (largeRemainder != 0.f && wholeValue >= 0) wholeValue++;        \
-        }                                                                      \
-        else if (rounding == kRoundToNegInf)                                   \
-        {                                                                      \
-            /* Only negative numbers are off */                                \
-            if (largeRemainder != 0.f && wholeValue < 0) wholeValue--;         \
-        }                                                                      \
-        else                                                                   \
-        { /* Default is round-to-nearest */                                    \
-            wholeValue = (Long)lrintf_clamped(*floatPtr);                      \
-        }                                                                      \
-        /* Now apply saturation rules */                                       \
-        if (sat)                                                               \
-        {                                                                      \
-            if ((sLowerLimits[outEnum] < 0                                     \
-                 && wholeValue > (Long)sUpperLimits[outEnum])                  \
-                || (sLowerLimits[outEnum] == 0                                 \
-                    && (ULong)wholeValue > sUpperLimits[outEnum]))             \
-                *outType##Ptr = (outType)sUpperLimits[outEnum];                \
-            else if (wholeValue < sLowerLimits[outEnum])                       \
-                *outType##Ptr = (outType)sLowerLimits[outEnum];                \
-            else                                                               \
-                *outType##Ptr = (outType)wholeValue;                           \
-        }                                                                      \
-        else                                                                   \
-        {                                                                      \
-            *outType##Ptr = (outType)(                                         \
-                wholeValue                                                     \
-                & (0xffffffffffffffffLL >> (64 - (sizeof(outType) * 8))));     \
-        }                                                                      \
-    }                                                                          \
-    break;
-
-#define DOUBLE_ROUND_CASE(outEnum, outType, rounding, sat)                     \
-    case outEnum: {                                                            \
-        outType##Ptr = (outType *)outRaw;                                      \
-        /* Get the tens digit */                                               \
-        Long wholeValue = (Long)*doublePtr;                                    \
-        double largeRemainder = (*doublePtr - (double)wholeValue) * 10.0;      \
-        /* What do we do based on that? */                                     \
-        if (rounding == kRoundToEven)                                          \
-        {                                                                      \
-            if (wholeValue & 1LL) /*between 1 and 1.99 */                      \
-                wholeValue += 1LL; /* round up to even */                      \
-        }                                                                      \
-        else if (rounding == kRoundToZero)                                     \
-        {                                                                      \
-            /* Nothing to do, round-to-zero is what C casting does */          \
-        }                                                                      \
-        else if (rounding == kRoundToPosInf)                                   \
-        {                                                                      \
-            /* Only positive numbers are wrong */                              \
-            if (largeRemainder != 0.0 && wholeValue >= 0) wholeValue++;        \
-        }                                                                      \
-        else if (rounding == kRoundToNegInf)                                   \
-        {                                                                      \
-            /* Only negative numbers are off */                                \
-            if (largeRemainder != 0.0 && wholeValue < 0) wholeValue--;         \
-        }                                                                      \
-        else                                                                   \
-        { /* Default is round-to-nearest */                                    \
-            wholeValue = (Long)lrint_clamped(*doublePtr);                      \
-        }                                                                      \
-        /* Now apply saturation rules */                                       \
-        if (sat)                                                               \
-        {                                                                      \
-            if ((sLowerLimits[outEnum] < 0                                     \
-                 && wholeValue > (Long)sUpperLimits[outEnum])                  \
-                || (sLowerLimits[outEnum] == 0                                 \
-                    && (ULong)wholeValue > sUpperLimits[outEnum]))             \
-                *outType##Ptr = (outType)sUpperLimits[outEnum];                \
-            else if (wholeValue < sLowerLimits[outEnum])                       \
-                *outType##Ptr = (outType)sLowerLimits[outEnum];                \
-            else                                                               \
-                *outType##Ptr = (outType)wholeValue;                           \
-        }                                                                      \
-        else                                                                   \
-        {                                                                      \
-            *outType##Ptr = (outType)(                                         \
-                wholeValue                                                     \
-                & (0xffffffffffffffffLL >> (64 - (sizeof(outType) * 8))));     \
-        }                                                                      \
-    }                                                                          \
-    break;
-
 typedef unsigned char uchar;
 typedef signed char schar;
 typedef unsigned short ushort;
 typedef unsigned int uint;
 typedef unsigned long ulong;
 
-void convert_explicit_value(void *inRaw, void *outRaw, ExplicitType inType,
-                            bool saturate, RoundingType roundType,
-                            ExplicitType outType)
+namespace {
+
+// The C type of the elements of each ExplicitType. Arrays of kBool hold one
+// bool per element, as generate_random_data makes them.
+template <ExplicitType Type> struct ExplicitTypeInfo;
+
+#define EXPLICIT_TYPE_INFO(Type, T)                                            \
+    template <> struct ExplicitTypeInfo<Type>                                  \
+    {                                                                          \
+        typedef T type;                                                        \
+    };
+
+EXPLICIT_TYPE_INFO(kBool, bool)
+EXPLICIT_TYPE_INFO(kChar, schar)
+EXPLICIT_TYPE_INFO(kUChar, uchar)
+EXPLICIT_TYPE_INFO(kUnsignedChar, uchar)
+EXPLICIT_TYPE_INFO(kShort, short)
+EXPLICIT_TYPE_INFO(kUShort, ushort)
+EXPLICIT_TYPE_INFO(kUnsignedShort, ushort)
+EXPLICIT_TYPE_INFO(kInt, int)
+EXPLICIT_TYPE_INFO(kUInt, uint)
+EXPLICIT_TYPE_INFO(kUnsignedInt, uint)
+EXPLICIT_TYPE_INFO(kLong, Long)
+EXPLICIT_TYPE_INFO(kULong, ULong)
+EXPLICIT_TYPE_INFO(kUnsignedLong, ULong)
+EXPLICIT_TYPE_INFO(kFloat, float)
+EXPLICIT_TYPE_INFO(kHalf, cl_half)
+EXPLICIT_TYPE_INFO(kDouble, double)
+
+#undef EXPLICIT_TYPE_INFO
+
+enum ConversionKind
 {
-    bool *boolPtr;
-    schar *scharPtr;
-    uchar *ucharPtr;
-    short *shortPtr;
-    ushort *ushortPtr;
-    int *intPtr;
-    uint *uintPtr;
-    Long *LongPtr;
-    ULong *ULongPtr;
-    cl_half *halfPtr;
-    float *floatPtr;
-    double *doublePtr;
+    kCopyConversion,
+    kFromBoolConversion,
+    kToBoolConversion,
+    kCastConversion,
+    kToHalfConversion,
+    kFromHalfConversion,
+    kDownCastConversion,
+    kULongDownCastConversion,
+    kRoundConversion
+};
+
+constexpr ExplicitType unaliased_type(ExplicitType type)
+{
+    return type == kUnsignedChar ? kUChar
+        : type == kUnsignedShort ? kUShort
+        : type == kUnsignedInt   ? kUInt
+        : type == kUnsignedLong  ? kULong
+                                 : type;
+}
 
+constexpr bool is_floating_type(ExplicitType type)
+{
+    return type == kHalf || type == kFloat || type == kDouble;
+}
 
-    switch (inType)
+constexpr bool is_signed_type(ExplicitType type)
+{
+    return type == kChar || type == kShort || type == kInt || type == kLong;
+}
+
+// How a value of In becomes one of Out. Integers are cast when Out holds
+// every value of In and saturated or masked otherwise, except that char to
+// unsigned char has always been a cast (unlike char to uchar).
+template <ExplicitType In, ExplicitType Out> struct ConversionKindOf
+{
+    static const size_t inSize = sizeof(typename ExplicitTypeInfo<In>::type);
+    static const size_t outSize = sizeof(typename ExplicitTypeInfo<Out>::type);
+
+    static const ConversionKind value =
+        unaliased_type(In) == unaliased_type(Out) ? kCopyConversion
+        : In == kBool                             ? kFromBoolConversion
+        : Out == kBool                            ? kToBoolConversion
+        : is_floating_type(In) && !is_floating_type(Out) ? kRoundConversion
+        : Out == kHalf                                   ? kToHalfConversion
+        : In == kHalf                                    ? kFromHalfConversion
+        : is_floating_type(Out)                          ? kCastConversion
+        : unaliased_type(In) == kULong ? kULongDownCastConversion
+        : outSize < inSize
+            || (outSize == inSize && is_signed_type(In) != is_signed_type(Out)
+                && !(In == kChar && Out == kUnsignedChar))
+        ? kDownCastConversion
+        : kCastConversion;
+};
+
+// In to Out, saturated to the limits of Out or masked to its width
+template <ExplicitType Out, bool Saturate, typename InT>
+inline typename ExplicitTypeInfo<Out>::type down_cast(InT value)
+{
+    typedef typename ExplicitTypeInfo<Out>::type OutT;
+    if (Saturate)
     {
-        case kBool:
-            boolPtr = (bool *)inRaw;
-            switch (outType)
-            {
-                case kBool:
-                    memcpy(outRaw, inRaw, get_explicit_type_size(inType));
-                    break;
-
-                case kChar:
-                case kUChar:
-                case kUnsignedChar:
-                case kShort:
-                case kUShort:
-                case kUnsignedShort:
-                case kInt:
-                case kUInt:
-                case kUnsignedInt:
-                case kLong:
-                case kULong:
-                case kUnsignedLong:
-                    memset(outRaw, *boolPtr ? 0xff : 0,
-                           get_explicit_type_size(outType));
-                    break;
-
-                case kHalf:
-                    halfPtr = (cl_half *)outRaw;
-                    *halfPtr =
-                        (*boolPtr) ? cl_half_from_float(-1.f, CL_HALF_RTE) : 0;
-                    break;
-                case kFloat:
-                    floatPtr = (float *)outRaw;
-                    *floatPtr = (*boolPtr) ? -1.f : 0.f;
-                    break;
-                case kDouble:
-                    doublePtr = (double *)outRaw;
-                    *doublePtr = (*boolPtr) ? -1.0 : 0.0;
-                    break;
-                default:
-                    log_error("ERROR: Invalid type given to "
-                              "convert_explicit_value!!\n");
-                    break;
-            }
-            break;
+        if ((sLowerLimits[Out] < 0 && value > (Long)sUpperLimits[Out])
+            || (sLowerLimits[Out] == 0 && (ULong)value > sUpperLimits[Out]))
+            return (OutT)sUpperLimits[Out];
+        else if (value < sLowerLimits[Out])
+            return (OutT)sLowerLimits[Out];
+        return (OutT)value;
+    }
+    return (OutT)(value & (0xffffffffffffffffLL >> (64 - (sizeof(OutT) * 8))));
+}
 
-        case kChar:
-            scharPtr = (schar *)inRaw;
-            switch (outType)
-            {
-                BOOL_CASE(schar)
-
-                case kChar:
-                    memcpy(outRaw, inRaw, get_explicit_type_size(inType));
-                    break;
-
-                    DOWN_CAST_CASE(schar, kUChar, uchar, saturate)
-                    SIMPLE_CAST_CASE(schar, kUnsignedChar, uchar)
-                    SIMPLE_CAST_CASE(schar, kShort, short)
-                    SIMPLE_CAST_CASE(schar, kUShort, ushort)
-                    SIMPLE_CAST_CASE(schar, kUnsignedShort, ushort)
-                    SIMPLE_CAST_CASE(schar, kInt, int)
-                    SIMPLE_CAST_CASE(schar, kUInt, uint)
-                    SIMPLE_CAST_CASE(schar, kUnsignedInt, uint)
-                    SIMPLE_CAST_CASE(schar, kLong, Long)
-                    SIMPLE_CAST_CASE(schar, kULong, ULong)
-                    SIMPLE_CAST_CASE(schar, kUnsignedLong, ULong)
-
-                    TO_HALF_CASE(schar)
-                    TO_FLOAT_CASE(schar)
-                    TO_DOUBLE_CASE(schar)
-
-                default:
-                    log_error("ERROR: Invalid type given to "
-                              "convert_explicit_value!!\n");
-                    break;
-            }
-            break;
+// The same for ULong values, which are never below the limits
+template <ExplicitType Out, bool Saturate>
+inline typename ExplicitTypeInfo<Out>::type ulong_down_cast(ULong value)
+{
+    typedef typename ExplicitTypeInfo<Out>::type OutT;
+    if (Saturate)
+    {
+        if (value > sUpperLimits[Out]) return (OutT)sUpperLimits[Out];
+        return (OutT)value;
+    }
+    return (OutT)(value & (0xffffffffffffffffLL >> (64 - (sizeof(OutT) * 8))));
+}
 
-        case kUChar:
-            ucharPtr = (uchar *)inRaw;
-            switch (outType)
-            {
-                BOOL_CASE(uchar)
-
-                case kUChar:
-                case kUnsignedChar:
-                    memcpy(outRaw, inRaw, get_explicit_type_size(inType));
-                    break;
-
-                    DOWN_CAST_CASE(uchar, kChar, schar, saturate)
-                    SIMPLE_CAST_CASE(uchar, kShort, short)
-                    SIMPLE_CAST_CASE(uchar, kUShort, ushort)
-                    SIMPLE_CAST_CASE(uchar, kUnsignedShort, ushort)
-                    SIMPLE_CAST_CASE(uchar, kInt, int)
-                    SIMPLE_CAST_CASE(uchar, kUInt, uint)
-                    SIMPLE_CAST_CASE(uchar, kUnsignedInt, uint)
-                    SIMPLE_CAST_CASE(uchar, kLong, Long)
-                    SIMPLE_CAST_CASE(uchar, kULong, ULong)
-                    SIMPLE_CAST_CASE(uchar, kUnsignedLong, ULong)
-
-                    TO_HALF_CASE(uchar)
-                    TO_FLOAT_CASE(uchar)
-                    TO_DOUBLE_CASE(uchar)
-
-                default:
-                    log_error("ERROR: Invalid type given to "
-                              "convert_explicit_value!!\n");
-                    break;
-            }
-            break;
+/* Note: we use lrintf here to force the rounding instead of whatever the
+ * processor's current rounding mode is */
+inline long round_to_nearest(float f) { return lrintf_clamped(f); }
+inline long round_to_nearest(double f) { return lrint_clamped(f); }
 
-        case kUnsignedChar:
-            ucharPtr = (uchar *)inRaw;
-            switch (outType)
-            {
-                BOOL_CASE(uchar)
-
-                case kUChar:
-                case kUnsignedChar:
-                    memcpy(outRaw, inRaw, get_explicit_type_size(inType));
-                    break;
-
-                    DOWN_CAST_CASE(uchar, kChar, schar, saturate)
-                    SIMPLE_CAST_CASE(uchar, kShort, short)
-                    SIMPLE_CAST_CASE(uchar, kUShort, ushort)
-                    SIMPLE_CAST_CASE(uchar, kUnsignedShort, ushort)
-                    SIMPLE_CAST_CASE(uchar, kInt, int)
-                    SIMPLE_CAST_CASE(uchar, kUInt, uint)
-                    SIMPLE_CAST_CASE(uchar, kUnsignedInt, uint)
-                    SIMPLE_CAST_CASE(uchar, kLong, Long)
-                    SIMPLE_CAST_CASE(uchar, kULong, ULong)
-                    SIMPLE_CAST_CASE(uchar, kUnsignedLong, ULong)
-
-                    TO_HALF_CASE(uchar)
-                    TO_FLOAT_CASE(uchar)
-                    TO_DOUBLE_CASE(uchar)
-
-                default:
-                    log_error("ERROR: Invalid type given to "
-                              "convert_explicit_value!!\n");
-                    break;
-            }
+template <RoundingType Round, typename FloatT>
+inline Long round_to_whole(FloatT value)
+{
+    // Get the tens digit
+    Long wholeValue = (Long)value;
+    FloatT largeRemainder = (value - (FloatT)wholeValue) * (FloatT)10;
+    // What do we do based on that?
+    switch (Round)
+    {
+        case kRoundToEven:
+            if (wholeValue & 1LL) /*between 1 and 1.99 */
+                wholeValue += 1LL; /* round up to even */
             break;
-
-        case kShort:
-            shortPtr = (short *)inRaw;
-            switch (outType)
-            {
-                BOOL_CASE(short)
-
-                case kShort:
-                    memcpy(outRaw, inRaw, get_explicit_type_size(inType));
-                    break;
-
-                    DOWN_CAST_CASE(short, kChar, schar, saturate)
-                    DOWN_CAST_CASE(short, kUChar, uchar, saturate)
-                    DOWN_CAST_CASE(short, kUnsignedChar, uchar, saturate)
-                    DOWN_CAST_CASE(short, kUShort, ushort, saturate)
-                    DOWN_CAST_CASE(short, kUnsignedShort, ushort, saturate)
-                    SIMPLE_CAST_CASE(short, kInt, int)
-                    SIMPLE_CAST_CASE(short, kUInt, uint)
-                    SIMPLE_CAST_CASE(short, kUnsignedInt, uint)
-                    SIMPLE_CAST_CASE(short, kLong, Long)
-                    SIMPLE_CAST_CASE(short, kULong, ULong)
-                    SIMPLE_CAST_CASE(short, kUnsignedLong, ULong)
-
-                    TO_HALF_CASE(short)
-                    TO_FLOAT_CASE(short)
-                    TO_DOUBLE_CASE(short)
-
-                default:
-                    log_error("ERROR: Invalid type given to "
-                              "convert_explicit_value!!\n");
-                    break;
-            }
+        case kRoundToZero:
+            // Nothing to do, round-to-zero is what C casting does
             break;
-
-        case kUShort:
-            ushortPtr = (ushort *)inRaw;
-            switch (outType)
-            {
-                BOOL_CASE(ushort)
-
-                case kUShort:
-                case kUnsignedShort:
-                    memcpy(outRaw, inRaw, get_explicit_type_size(inType));
-                    break;
-
-                    DOWN_CAST_CASE(ushort, kChar, schar, saturate)
-                    DOWN_CAST_CASE(ushort, kUChar, uchar, saturate)
-                    DOWN_CAST_CASE(ushort, kUnsignedChar, uchar, saturate)
-                    DOWN_CAST_CASE(ushort, kShort, short, saturate)
-                    SIMPLE_CAST_CASE(ushort, kInt, int)
-                    SIMPLE_CAST_CASE(ushort, kUInt, uint)
-                    SIMPLE_CAST_CASE(ushort, kUnsignedInt, uint)
-                    SIMPLE_CAST_CASE(ushort, kLong, Long)
-                    SIMPLE_CAST_CASE(ushort, kULong, ULong)
-                    SIMPLE_CAST_CASE(ushort, kUnsignedLong, ULong)
-
-                    TO_HALF_CASE(ushort)
-                    TO_FLOAT_CASE(ushort)
-                    TO_DOUBLE_CASE(ushort)
-
-                default:
-                    log_error("ERROR: Invalid type given to "
-                              "convert_explicit_value!!\n");
-                    break;
-            }
+        case kRoundToPosInf:
+            // Only positive numbers are wrong
+            if (largeRemainder != 0 && wholeValue >= 0) wholeValue++;
             break;
-
-        case kUnsignedShort:
-            ushortPtr = (ushort *)inRaw;
-            switch (outType)
-            {
-                BOOL_CASE(ushort)
-
-                case kUShort:
-                case kUnsignedShort:
-                    memcpy(outRaw, inRaw, get_explicit_type_size(inType));
-                    break;
-
-                    DOWN_CAST_CASE(ushort, kChar, schar, saturate)
-                    DOWN_CAST_CASE(ushort, kUChar, uchar, saturate)
-                    DOWN_CAST_CASE(ushort, kUnsignedChar, uchar, saturate)
-                    DOWN_CAST_CASE(ushort, kShort, short, saturate)
-                    SIMPLE_CAST_CASE(ushort, kInt, int)
-                    SIMPLE_CAST_CASE(ushort, kUInt, uint)
-                    SIMPLE_CAST_CASE(ushort, kUnsignedInt, uint)
-                    SIMPLE_CAST_CASE(ushort, kLong, Long)
-                    SIMPLE_CAST_CASE(ushort, kULong, ULong)
-                    SIMPLE_CAST_CASE(ushort, kUnsignedLong, ULong)
-
-                    TO_HALF_CASE(ushort)
-                    TO_FLOAT_CASE(ushort)
-                    TO_DOUBLE_CASE(ushort)
-
-                default:
-                    log_error("ERROR: Invalid type given to "
-                              "convert_explicit_value!!\n");
-                    break;
-            }
+        case kRoundToNegInf:
+            // Only negative numbers are off
+            if (largeRemainder != 0 && wholeValue < 0) wholeValue--;
             break;
-
-        case kInt:
-            intPtr = (int *)inRaw;
-            switch (outType)
-            {
-                BOOL_CASE(int)
-
-                case kInt:
-                    memcpy(outRaw, inRaw, get_explicit_type_size(inType));
-                    break;
-
-                    DOWN_CAST_CASE(int, kChar, schar, saturate)
-                    DOWN_CAST_CASE(int, kUChar, uchar, saturate)
-                    DOWN_CAST_CASE(int, kUnsignedChar, uchar, saturate)
-                    DOWN_CAST_CASE(int, kShort, short, saturate)
-                    DOWN_CAST_CASE(int, kUShort, ushort, saturate)
-                    DOWN_CAST_CASE(int, kUnsignedShort, ushort, saturate)
-                    DOWN_CAST_CASE(int, kUInt, uint, saturate)
-                    DOWN_CAST_CASE(int, kUnsignedInt, uint, saturate)
-                    SIMPLE_CAST_CASE(int, kLong, Long)
-                    SIMPLE_CAST_CASE(int, kULong, ULong)
-                    SIMPLE_CAST_CASE(int, kUnsignedLong, ULong)
-
-                    TO_HALF_CASE(int)
-                    TO_FLOAT_CASE(int)
-                    TO_DOUBLE_CASE(int)
-
-                default:
-                    log_error("ERROR: Invalid type given to "
-                              "convert_explicit_value!!\n");
-                    break;
-            }
+        default:
+            // Default is round-to-nearest
+            wholeValue = (Long)round_to_nearest(value);
             break;
+    }
+    return wholeValue;
+}
 
-        case kUInt:
-            uintPtr = (uint *)inRaw;
-            switch (outType)
-            {
-                BOOL_CASE(uint)
-
-                case kUInt:
-                case kUnsignedInt:
-                    memcpy(outRaw, inRaw, get_explicit_type_size(inType));
-                    break;
-
-                    DOWN_CAST_CASE(uint, kChar, schar, saturate)
-                    DOWN_CAST_CASE(uint, kUChar, uchar, saturate)
-                    DOWN_CAST_CASE(uint, kUnsignedChar, uchar, saturate)
-                    DOWN_CAST_CASE(uint, kShort, short, saturate)
-                    DOWN_CAST_CASE(uint, kUShort, ushort, saturate)
-                    DOWN_CAST_CASE(uint, kUnsignedShort, ushort, saturate)
-                    DOWN_CAST_CASE(uint, kInt, int, saturate)
-                    SIMPLE_CAST_CASE(uint, kLong, Long)
-                    SIMPLE_CAST_CASE(uint, kULong, ULong)
-                    SIMPLE_CAST_CASE(uint, kUnsignedLong, ULong)
-
-                    TO_HALF_CASE(uint)
-                    TO_FLOAT_CASE(uint)
-                    TO_DOUBLE_CASE(uint)
-
-                default:
-                    log_error("ERROR: Invalid type given to "
-                              "convert_explicit_value!!\n");
-                    break;
-            }
-            break;
+// Halves are truncated to a whole float before rounding
+inline float round_input(cl_half value)
+{
+    return (float)(Long)cl_half_to_float(value);
+}
+inline float round_input(float value) { return value; }
+inline double round_input(double value) { return value; }
 
-        case kUnsignedInt:
-            uintPtr = (uint *)inRaw;
-            switch (outType)
-            {
-                BOOL_CASE(uint)
-
-                case kUInt:
-                case kUnsignedInt:
-                    memcpy(outRaw, inRaw, get_explicit_type_size(inType));
-                    break;
-
-                    DOWN_CAST_CASE(uint, kChar, schar, saturate)
-                    DOWN_CAST_CASE(uint, kUChar, uchar, saturate)
-                    DOWN_CAST_CASE(uint, kUnsignedChar, uchar, saturate)
-                    DOWN_CAST_CASE(uint, kShort, short, saturate)
-                    DOWN_CAST_CASE(uint, kUShort, ushort, saturate)
-                    DOWN_CAST_CASE(uint, kUnsignedShort, ushort, saturate)
-                    DOWN_CAST_CASE(uint, kInt, int, saturate)
-                    SIMPLE_CAST_CASE(uint, kLong, Long)
-                    SIMPLE_CAST_CASE(uint, kULong, ULong)
-                    SIMPLE_CAST_CASE(uint, kUnsignedLong, ULong)
-
-                    TO_HALF_CASE(uint)
-                    TO_FLOAT_CASE(uint)
-                    TO_DOUBLE_CASE(uint)
-
-                default:
-                    log_error("ERROR: Invalid type given to "
-                              "convert_explicit_value!!\n");
-                    break;
-            }
-            break;
+template <typename InT, typename OutT>
+void cast_array(const InT *in, OutT *out, size_t count)
+{
+    for (size_t i = 0; i < count; i++) out[i] = (OutT)in[i];
+}
 
-        case kLong:
-            LongPtr = (Long *)inRaw;
-            switch (outType)
-            {
-                BOOL_CASE(Long)
-
-                case kLong:
-                    memcpy(outRaw, inRaw, get_explicit_type_size(inType));
-                    break;
-
-                    DOWN_CAST_CASE(Long, kChar, schar, saturate)
-                    DOWN_CAST_CASE(Long, kUChar, uchar, saturate)
-                    DOWN_CAST_CASE(Long, kUnsignedChar, uchar, saturate)
-                    DOWN_CAST_CASE(Long, kShort, short, saturate)
-                    DOWN_CAST_CASE(Long, kUShort, ushort, saturate)
-                    DOWN_CAST_CASE(Long, kUnsignedShort, ushort, saturate)
-                    DOWN_CAST_CASE(Long, kInt, int, saturate)
-                    DOWN_CAST_CASE(Long, kUInt, uint, saturate)
-                    DOWN_CAST_CASE(Long, kUnsignedInt, uint, saturate)
-                    DOWN_CAST_CASE(Long, kULong, ULong, saturate)
-                    DOWN_CAST_CASE(Long, kUnsignedLong, ULong, saturate)
-
-                    TO_HALF_CASE(Long)
-                    TO_FLOAT_CASE(Long)
-                    TO_DOUBLE_CASE(Long)
-
-                default:
-                    log_error("ERROR: Invalid type given to "
-                              "convert_explicit_value!!\n");
-                    break;
-            }
-            break;
+#if defined(__SSE2__) || defined(_MSC_VER)
+// The SSE2 conversions round as the scalar casts do, by the current mode
+void cast_array(const int *in, float *out, size_t count)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_ps(out + i,
+                      _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *)(in + i))));
+    for (; i < count; i++) out[i] = (float)in[i];
+}
 
-        case kULong:
-            ULongPtr = (ULong *)inRaw;
-            switch (outType)
-            {
-                BOOL_CASE(ULong)
-
-                case kUnsignedLong:
-                case kULong:
-                    memcpy(outRaw, inRaw, get_explicit_type_size(inType));
-                    break;
-
-                    U_DOWN_CAST_CASE(ULong, kChar, schar, saturate)
-                    U_DOWN_CAST_CASE(ULong, kUChar, uchar, saturate)
-                    U_DOWN_CAST_CASE(ULong, kUnsignedChar, uchar, saturate)
-                    U_DOWN_CAST_CASE(ULong, kShort, short, saturate)
-                    U_DOWN_CAST_CASE(ULong, kUShort, ushort, saturate)
-                    U_DOWN_CAST_CASE(ULong, kUnsignedShort, ushort, saturate)
-                    U_DOWN_CAST_CASE(ULong, kInt, int, saturate)
-                    U_DOWN_CAST_CASE(ULong, kUInt, uint, saturate)
-                    U_DOWN_CAST_CASE(ULong, kUnsignedInt, uint, saturate)
-                    U_DOWN_CAST_CASE(ULong, kLong, Long, saturate)
-
-                    TO_HALF_CASE(ULong)
-                    TO_FLOAT_CASE(ULong)
-                    TO_DOUBLE_CASE(ULong)
-
-                default:
-                    log_error("ERROR: Invalid type given to "
-                              "convert_explicit_value!!\n");
-                    break;
-            }
-            break;
+void cast_array(const float *in, double *out, size_t count)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 v = _mm_loadu_ps(in + i);
+        _mm_storeu_pd(out + i, _mm_cvtps_pd(v));
+        _mm_storeu_pd(out + i + 2, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+    }
+    for (; i < count; i++) out[i] = (double)in[i];
+}
 
-        case kUnsignedLong:
-            ULongPtr = (ULong *)inRaw;
-            switch (outType)
-            {
-                BOOL_CASE(ULong)
-
-                case kULong:
-                case kUnsignedLong:
-                    memcpy(outRaw, inRaw, get_explicit_type_size(inType));
-                    break;
-
-                    U_DOWN_CAST_CASE(ULong, kChar, schar, saturate)
-                    U_DOWN_CAST_CASE(ULong, kUChar, uchar, saturate)
-                    U_DOWN_CAST_CASE(ULong, kUnsignedChar, uchar, saturate)
-                    U_DOWN_CAST_CASE(ULong, kShort, short, saturate)
-                    U_DOWN_CAST_CASE(ULong, kUShort, ushort, saturate)
-                    U_DOWN_CAST_CASE(ULong, kUnsignedShort, ushort, saturate)
-                    U_DOWN_CAST_CASE(ULong, kInt, int, saturate)
-                    U_DOWN_CAST_CASE(ULong, kUInt, uint, saturate)
-                    U_DOWN_CAST_CASE(ULong, kUnsignedInt, uint, saturate)
-                    U_DOWN_CAST_CASE(ULong, kLong, Long, saturate)
-
-                    TO_HALF_CASE(ULong)
-                    TO_FLOAT_CASE(ULong)
-                    TO_DOUBLE_CASE(ULong)
-
-                default:
-                    log_error("ERROR: Invalid type given to "
-                              "convert_explicit_value!!\n");
-                    break;
-            }
-            break;
+void cast_array(const double *in, float *out, size_t count)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_ps(out + i,
+                      _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(in + i)),
+                                    _mm_cvtpd_ps(_mm_loadu_pd(in + i + 2))));
+    for (; i < count; i++) out[i] = (float)in[i];
+}
+#endif
 
-        case kHalf:
-            halfPtr = (cl_half *)inRaw;
-            switch (outType)
-            {
-                BOOL_CASE(half)
-
-                HALF_ROUND_CASE(kChar, schar, roundType, saturate)
-                HALF_ROUND_CASE(kUChar, uchar, roundType, saturate)
-                HALF_ROUND_CASE(kUnsignedChar, uchar, roundType, saturate)
-                HALF_ROUND_CASE(kShort, short, roundType, saturate)
-                HALF_ROUND_CASE(kUShort, ushort, roundType, saturate)
-                HALF_ROUND_CASE(kUnsignedShort, ushort, roundType, saturate)
-                HALF_ROUND_CASE(kInt, int, roundType, saturate)
-                HALF_ROUND_CASE(kUInt, uint, roundType, saturate)
-                HALF_ROUND_CASE(kUnsignedInt, uint, roundType, saturate)
-                HALF_ROUND_CASE(kLong, Long, roundType, saturate)
-                HALF_ROUND_CASE(kULong, ULong, roundType, saturate)
-                HALF_ROUND_CASE(kUnsignedLong, ULong, roundType, saturate)
-
-                case kHalf:
-                    memcpy(outRaw, inRaw, get_explicit_type_size(inType));
-                    break;
-
-                case kFloat:
-                    floatPtr = (float *)outRaw;
-                    *floatPtr = cl_half_to_float(*halfPtr);
-                    break;
-                case kDouble:
-                    doublePtr = (double *)outRaw;
-                    *doublePtr = cl_half_to_float(*halfPtr);
-                    break;
-
-                default:
-                    log_error("ERROR: Invalid type given to "
-                              "convert_explicit_value!!\n");
-                    break;
-            }
-            break;
+// Converts count elements of In to Out, each instantiation picking what to do
+// with the values once for the whole array
+template <ExplicitType In, ExplicitType Out,
+          ConversionKind Kind = ConversionKindOf<In, Out>::value>
+struct Conversion;
+
+#define CONVERSION(kind)                                                       \
+    template <ExplicitType In, ExplicitType Out>                               \
+    struct Conversion<In, Out, kind>                                           \
+    {                                                                          \
+        typedef typename ExplicitTypeInfo<In>::type InT;                       \
+        typedef typename ExplicitTypeInfo<Out>::type OutT;                     \
+                                                                               \
+        static void run(const void *inRaw, void *outRaw, size_t count,         \
+                        bool saturate, RoundingType roundType);                \
+    };                                                                         \
+                                                                               \
+    template <ExplicitType In, ExplicitType Out>                               \
+    void Conversion<In, Out, kind>::run(const void *inRaw, void *outRaw,       \
+                                        size_t count, bool saturate,           \
+                                        RoundingType roundType)
+
+#define CONVERSION_ARRAYS                                                      \
+    const InT *in = (const InT *)inRaw;                                        \
+    OutT *out = (OutT *)outRaw;
+
+CONVERSION(kCopyConversion)
+{
+    memcpy(outRaw, inRaw, count * sizeof(InT));
+}
 
-        case kFloat:
-            floatPtr = (float *)inRaw;
-            switch (outType)
-            {
-                BOOL_CASE(float)
-
-                FLOAT_ROUND_CASE(kChar, schar, roundType, saturate)
-                FLOAT_ROUND_CASE(kUChar, uchar, roundType, saturate)
-                FLOAT_ROUND_CASE(kUnsignedChar, uchar, roundType, saturate)
-                FLOAT_ROUND_CASE(kShort, short, roundType, saturate)
-                FLOAT_ROUND_CASE(kUShort, ushort, roundType, saturate)
-                FLOAT_ROUND_CASE(kUnsignedShort, ushort, roundType, saturate)
-                FLOAT_ROUND_CASE(kInt, int, roundType, saturate)
-                FLOAT_ROUND_CASE(kUInt, uint, roundType, saturate)
-                FLOAT_ROUND_CASE(kUnsignedInt, uint, roundType, saturate)
-                FLOAT_ROUND_CASE(kLong, Long, roundType, saturate)
-                FLOAT_ROUND_CASE(kULong, ULong, roundType, saturate)
-                FLOAT_ROUND_CASE(kUnsignedLong, ULong, roundType, saturate)
-
-                TO_HALF_CASE(float)
-
-                case kFloat:
-                    memcpy(outRaw, inRaw, get_explicit_type_size(inType));
-                    break;
-
-                    TO_DOUBLE_CASE(float);
-
-                default:
-                    log_error("ERROR: Invalid type given to "
-                              "convert_explicit_value!!\n");
-                    break;
-            }
-            break;
+// True is all bits set for the integers, and -1 for the others
+CONVERSION(kFromBoolConversion)
+{
+    CONVERSION_ARRAYS
+    const OutT trueValue =
+        Out == kHalf ? cl_half_from_float(-1.f, CL_HALF_RTE) : (OutT)-1;
+    for (size_t i = 0; i < count; i++) out[i] = in[i] ? trueValue : 0;
+}
 
-        case kDouble:
-            doublePtr = (double *)inRaw;
-            switch (outType)
-            {
-                BOOL_CASE(double)
-
-                DOUBLE_ROUND_CASE(kChar, schar, roundType, saturate)
-                DOUBLE_ROUND_CASE(kUChar, uchar, roundType, saturate)
-                DOUBLE_ROUND_CASE(kUnsignedChar, uchar, roundType, saturate)
-                DOUBLE_ROUND_CASE(kShort, short, roundType, saturate)
-                DOUBLE_ROUND_CASE(kUShort, ushort, roundType, saturate)
-                DOUBLE_ROUND_CASE(kUnsignedShort, ushort, roundType, saturate)
-                DOUBLE_ROUND_CASE(kInt, int, roundType, saturate)
-                DOUBLE_ROUND_CASE(kUInt, uint, roundType, saturate)
-                DOUBLE_ROUND_CASE(kUnsignedInt, uint, roundType, saturate)
-                DOUBLE_ROUND_CASE(kLong, Long, roundType, saturate)
-                DOUBLE_ROUND_CASE(kULong, ULong, roundType, saturate)
-                DOUBLE_ROUND_CASE(kUnsignedLong, ULong, roundType, saturate)
-
-                TO_HALF_CASE(double)
-
-                TO_FLOAT_CASE(double);
-
-                case kDouble:
-                    memcpy(outRaw, inRaw, get_explicit_type_size(inType));
-                    break;
-
-                default:
-                    log_error("ERROR: Invalid type given to "
-                              "convert_explicit_value!!\n");
-                    break;
-            }
-            break;
+// Halves are true unless all their bits are clear
+CONVERSION(kToBoolConversion)
+{
+    CONVERSION_ARRAYS
+    for (size_t i = 0; i < count; i++) out[i] = in[i] != 0;
+}
 
+CONVERSION(kCastConversion)
+{
+    CONVERSION_ARRAYS
+    cast_array(in, out, count);
+}
+
+CONVERSION(kToHalfConversion)
+{
+    CONVERSION_ARRAYS
+    for (size_t i = 0; i < count; i++)
+        out[i] = cl_half_from_float((float)in[i], CL_HALF_RTE);
+}
+
+CONVERSION(kFromHalfConversion)
+{
+    CONVERSION_ARRAYS
+    for (size_t i = 0; i < count; i++) out[i] = cl_half_to_float(in[i]);
+}
+
+CONVERSION(kDownCastConversion)
+{
+    CONVERSION_ARRAYS
+    if (saturate)
+        for (size_t i = 0; i < count; i++) out[i] = down_cast<Out, true>(in[i]);
+    else
+        for (size_t i = 0; i < count; i++)
+            out[i] = down_cast<Out, false>(in[i]);
+}
+
+CONVERSION(kULongDownCastConversion)
+{
+    CONVERSION_ARRAYS
+    if (saturate)
+        for (size_t i = 0; i < count; i++)
+            out[i] = ulong_down_cast<Out, true>(in[i]);
+    else
+        for (size_t i = 0; i < count; i++)
+            out[i] = ulong_down_cast<Out, false>(in[i]);
+}
+
+#undef CONVERSION_ARRAYS
+#undef CONVERSION
+
+template <ExplicitType Out, bool Saturate, RoundingType Round, typename InT>
+void round_array(const InT *in, typename ExplicitTypeInfo<Out>::type *out,
+                 size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+        out[i] = down_cast<Out, Saturate>(
+            round_to_whole<Round>(round_input(in[i])));
+}
+
+template <ExplicitType Out, bool Saturate, typename InT>
+void round_array(const InT *in, typename ExplicitTypeInfo<Out>::type *out,
+                 size_t count, RoundingType roundType)
+{
+    switch (roundType)
+    {
+        case kRoundToEven:
+            round_array<Out, Saturate, kRoundToEven>(in, out, count);
+            break;
+        case kRoundToZero:
+            round_array<Out, Saturate, kRoundToZero>(in, out, count);
+            break;
+        case kRoundToPosInf:
+            round_array<Out, Saturate, kRoundToPosInf>(in, out, count);
+            break;
+        case kRoundToNegInf:
+            round_array<Out, Saturate, kRoundToNegInf>(in, out, count);
+            break;
         default:
-            log_error(
-                "ERROR: Invalid type given to convert_explicit_value!!\n");
+            round_array<Out, Saturate, kRoundToNearest>(in, out, count);
             break;
     }
 }
 
-void generate_random_data(ExplicitType type, size_t count, MTdata d,
-                          void *outData)
+template <ExplicitType In, ExplicitType Out>
+struct Conversion<In, Out, kRoundConversion>
+{
+    typedef typename ExplicitTypeInfo<In>::type InT;
+    typedef typename ExplicitTypeInfo<Out>::type OutT;
+
+    static void run(const void *inRaw, void *outRaw, size_t count,
+                    bool saturate, RoundingType roundType)
+    {
+        const InT *in = (const InT *)inRaw;
+        OutT *out = (OutT *)outRaw;
+        if (saturate)
+            round_array<Out, true>(in, out, count, roundType);
+        else
+            round_array<Out, false>(in, out, count, roundType);
+    }
+};
+
+typedef void (*ConvertArrayFn)(const void *inRaw, void *outRaw, size_t count,
+                               bool saturate, RoundingType roundType);
+
+#define CONVERSIONS_FROM(inType)                                               \
+    {                                                                          \
+        &Conversion<inType, kBool>::run, &Conversion<inType, kChar>::run,      \
+            &Conversion<inType, kUChar>::run,                                  \
+            &Conversion<inType, kUnsignedChar>::run,                           \
+            &Conversion<inType, kShort>::run,                                  \
+            &Conversion<inType, kUShort>::run,                                 \
+            &Conversion<inType, kUnsignedShort>::run,                          \
+            &Conversion<inType, kInt>::run, &Conversion<inType, kUInt>::run,   \
+            &Conversion<inType, kUnsignedInt>::run,                            \
+            &Conversion<inType, kLong>::run, &Conversion<inType, kULong>::run, \
+            &Conversion<inType, kUnsignedLong>::run,                           \
+            &Conversion<inType, kFloat>::run, &Conversion<inType, kHalf>::run, \
+            &Conversion<inType, kDouble>::run                                  \
+    }
+
+/* Note: this has to match the enum in size and order!! */
+const ConvertArrayFn sConversions[kNumExplicitTypes][kNumExplicitTypes] = {
+    CONVERSIONS_FROM(kBool),          CONVERSIONS_FROM(kChar),
+    CONVERSIONS_FROM(kUChar),         CONVERSIONS_FROM(kUnsignedChar),
+    CONVERSIONS_FROM(kShort),         CONVERSIONS_FROM(kUShort),
+    CONVERSIONS_FROM(kUnsignedShort), CONVERSIONS_FROM(kInt),
+    CONVERSIONS_FROM(kUInt),          CONVERSIONS_FROM(kUnsignedInt),
+    CONVERSIONS_FROM(kLong),          CONVERSIONS_FROM(kULong),
+    CONVERSIONS_FROM(kUnsignedLong),  CONVERSIONS_FROM(kFloat),
+    CONVERSIONS_FROM(kHalf),          CONVERSIONS_FROM(kDouble)
+};
+
+#undef CONVERSIONS_FROM
+
+} // anonymous namespace
+
+void convert_explicit_array(const void *inRaw, void *outRaw, size_t count,
+                            ExplicitType inType, bool saturate,
+                            RoundingType roundType, ExplicitType outType)
+{
+    if ((unsigned)inType >= kNumExplicitTypes
+        || (unsigned)outType >= kNumExplicitTypes)
+    {
+        log_error("ERROR: Invalid type given to convert_explicit_array!!\n");
+        return;
+    }
+    sConversions[inType][outType](inRaw, outRaw, count, saturate, roundType);
+}
+
+void convert_explicit_value(void *inRaw, void *outRaw, ExplicitType inType,
+                            bool saturate, RoundingType roundType,
+                            ExplicitType outType)
+{
+    convert_explicit_array(inRaw, outRaw, 1, inType, saturate, roundType,
+                           outType);
+}
+
+namespace {
+
+// Bits of the stream generate_random_data_serial uses for each element. The
+// narrower types are packed into 32-bit words, the others start with one
+// unused word.
+size_t random_data_bits(ExplicitType type)
+{
+    switch (type)
+    {
+        case kBool: return 1;
+        case kChar:
+        case kUChar:
+        case kUnsignedChar: return 8;
+        case kShort:
+        case kUShort:
+        case kUnsignedShort:
+        case kHalf: return 16;
+        case kLong:
+        case kULong:
+        case kUnsignedLong:
+        case kDouble: return 64;
+        default: return 32;
+    }
+}
+
+// Hands out the words of d in order, drawing them in chunks with
+// genrand_fill but never past the total asked for, so d ends up where one
+// genrand_int32 call per word would have left it.
+class RandomWords {
+public:
+    RandomWords(MTdata d, size_t total): d(d), total(total) {}
+
+    cl_uint next()
+    {
+        if (pos == filled)
+        {
+            filled = std::min(total, sizeof(words) / sizeof(words[0]));
+            genrand_fill(d, words, filled);
+            total -= filled;
+            pos = 0;
+        }
+        return words[pos++];
+    }
+
+private:
+    MTdata d;
+    size_t total;
+    size_t pos = 0;
+    size_t filled = 0;
+    cl_uint words[256];
+};
+
+} // anonymous namespace
+
+static void generate_random_data_serial(ExplicitType type, size_t count,
+                                        MTdata d, void *outData)
 {
     bool *boolPtr;
     cl_char *charPtr;
@@ -1044,6 +688,14 @@ void generate_random_data(ExplicitType type, size_t count, MTdata d,
     cl_uint bits = genrand_int32(d);
     cl_uint bitsLeft = 32;
 
+    // The words after bits, packed for the narrow types
+    size_t bitsPerElement = random_data_bits(type);
+    size_t wordCount = bitsPerElement < 32
+        ? (count * bitsPerElement + 31) / 32
+        : count * bitsPerElement / 32;
+    if (bitsPerElement < 32 && wordCount > 0) wordCount--;
+    RandomWords words(d, wordCount);
+
     switch (type)
     {
         case kBool:
@@ -1052,7 +704,7 @@ void generate_random_data(ExplicitType type, size_t count, MTdata d,
             {
                 if (0 == bitsLeft)
                 {
-                    bits = genrand_int32(d);
+                    bits = words.next();
                     bitsLeft = 32;
                 }
                 boolPtr[i] = (bits & 1) ? true : false;
@@ -1067,7 +719,7 @@ void generate_random_data(ExplicitType type, size_t count, MTdata d,
             {
                 if (0 == bitsLeft)
                 {
-                    bits = genrand_int32(d);
+                    bits = words.next();
                     bitsLeft = 32;
                 }
                 charPtr[i] = (cl_char)((cl_int)(bits & 255) - 127);
@@ -1083,7 +735,7 @@ void generate_random_data(ExplicitType type, size_t count, MTdata d,
             {
                 if (0 == bitsLeft)
                 {
-                    bits = genrand_int32(d);
+                    bits = words.next();
                     bitsLeft = 32;
                 }
                 ucharPtr[i] = (cl_uchar)(bits & 255);
@@ -1098,7 +750,7 @@ void generate_random_data(ExplicitType type, size_t count, MTdata d,
             {
                 if (0 == bitsLeft)
                 {
-                    bits = genrand_int32(d);
+                    bits = words.next();
                     bitsLeft = 32;
                 }
                 shortPtr[i] = (cl_short)((cl_int)(bits & 65535) - 32767);
@@ -1114,7 +766,7 @@ void generate_random_data(ExplicitType type, size_t count, MTdata d,
             {
                 if (0 == bitsLeft)
                 {
-                    bits = genrand_int32(d);
+                    bits = words.next();
                     bitsLeft = 32;
                 }
                 ushortPtr[i] = (cl_ushort)((cl_int)(bits & 65535));
@@ -1127,7 +779,7 @@ void generate_random_data(ExplicitType type, size_t count, MTdata d,
             intPtr = (cl_int *)outData;
             for (i = 0; i < count; i++)
             {
-                intPtr[i] = (cl_int)genrand_int32(d);
+                intPtr[i] = (cl_int)words.next();
             }
             break;
 
@@ -1136,7 +788,7 @@ void generate_random_data(ExplicitType type, size_t count, MTdata d,
             uintPtr = (cl_uint *)outData;
             for (i = 0; i < count; i++)
             {
-                uintPtr[i] = (unsigned int)genrand_int32(d);
+                uintPtr[i] = (unsigned int)words.next();
             }
             break;
 
@@ -1144,8 +796,8 @@ void generate_random_data(ExplicitType type, size_t count, MTdata d,
             longPtr = (cl_long *)outData;
             for (i = 0; i < count; i++)
             {
-                longPtr[i] = (cl_long)genrand_int32(d)
-                    | ((cl_long)genrand_int32(d) << 32);
+                cl_long low = words.next();
+                longPtr[i] = low | ((cl_long)words.next() << 32);
             }
             break;
 
@@ -1154,8 +806,8 @@ void generate_random_data(ExplicitType type, size_t count, MTdata d,
             ulongPtr = (cl_ulong *)outData;
             for (i = 0; i < count; i++)
             {
-                ulongPtr[i] = (cl_ulong)genrand_int32(d)
-                    | ((cl_ulong)genrand_int32(d) << 32);
+                cl_ulong low = words.next();
+                ulongPtr[i] = low | ((cl_ulong)words.next() << 32);
             }
             break;
 
@@ -1164,7 +816,7 @@ void generate_random_data(ExplicitType type, size_t count, MTdata d,
             for (i = 0; i < count; i++)
             {
                 // [ -(double) 0x7fffffff, (double) 0x7fffffff ]
-                double t = genrand_real1(d);
+                double t = words.next() * (1.0 / 4294967295.0);
                 floatPtr[i] = (float)((1.0 - t) * -(double)0x7fffffff
                                       + t * (double)0x7fffffff);
             }
@@ -1174,8 +826,8 @@ void generate_random_data(ExplicitType type, size_t count, MTdata d,
             doublePtr = (cl_double *)outData;
             for (i = 0; i < count; i++)
             {
-                cl_long u = (cl_long)genrand_int32(d)
-                    | ((cl_long)genrand_int32(d) << 32);
+                cl_long low = words.next();
+                cl_long u = low | ((cl_long)words.next() << 32);
                 double t = (double)u;
                 // scale [-2**63, 2**63] to [-2**31, 2**31]
                 t *= MAKE_HEX_DOUBLE(0x1.0p-32, 0x1, -32);
@@ -1189,7 +841,7 @@ void generate_random_data(ExplicitType type, size_t count, MTdata d,
             {
                 if (0 == bitsLeft)
                 {
-                    bits = genrand_int32(d);
+                    bits = words.next();
                     bitsLeft = 32;
                 }
                 halfPtr[i] =
@@ -1206,6 +858,62 @@ void generate_random_data(ExplicitType type, size_t count, MTdata d,
     }
 }
 
+namespace {
+
+struct RandomDataInfo
+{
+    ExplicitType type;
+    size_t count;
+    size_t chunkSize; // elements per job, a multiple of 32
+    MTdata d;
+    char *out;
+};
+
+cl_int generate_random_data_chunk(cl_uint job_id, cl_uint thread_id,
+                                  void *userInfo)
+{
+    RandomDataInfo *info = (RandomDataInfo *)userInfo;
+    size_t start = job_id * info->chunkSize;
+    size_t count = std::min(info->chunkSize, info->count - start);
+    size_t elementSize =
+        kBool == info->type ? sizeof(bool) : get_explicit_type_size(info->type);
+
+    // Start this chunk where the serial generator would have reached
+    MTdataHolder d(genrand_split(
+        info->d, (cl_ulong)start * random_data_bits(info->type) / 32));
+    generate_random_data_serial(info->type, count, d,
+                                info->out + start * elementSize);
+    return CL_SUCCESS;
+}
+
+} // anonymous namespace
+
+void generate_random_data(ExplicitType type, size_t count, MTdata d,
+                          void *outData)
+{
+    // Counter-based generators split the work across the thread pool, with
+    // the same results as generating serially, unless the caller is a pool
+    // job itself.
+    const size_t chunkSize = 65536;
+    if (genrand_is_counter_based(d) && count > chunkSize
+        && GetThreadCount() > 1 && !ThreadPool_InWorker())
+    {
+        RandomDataInfo info = { type, count, chunkSize, d, (char *)outData };
+        cl_uint jobs = (cl_uint)((count + chunkSize - 1) / chunkSize);
+        if (CL_SUCCESS
+            == ThreadPool_Do(generate_random_data_chunk, jobs, &info))
+        {
+            size_t bits = random_data_bits(type);
+            cl_ulong words = bits < 32 ? ((cl_ulong)count * bits + 31) / 32
+                                       : 1 + (cl_ulong)count * bits / 32;
+            genrand_skip(d, words);
+            return;
+        }
+    }
+
+    generate_random_data_serial(type, count, d, outData);
+}
+
 void *create_random_data(ExplicitType type, MTdata d, size_t count)
 {
     void *data = malloc(get_explicit_type_size(type) * count);
@@ -1213,71 +921,110 @@ void *create_random_data(ExplicitType type, MTdata d, size_t count)
     return data;
 }
 
-cl_long read_upscale_signed(void *inRaw, ExplicitType inType)
+namespace {
+
+template <typename InT, typename OutT>
+void read_array(const void *inRaw, OutT *out, size_t count)
+{
+    cast_array((const InT *)inRaw, out, count);
+}
+
+} // anonymous namespace
+
+void read_upscale_signed_array(const void *inRaw, cl_long *out, size_t count,
+                               ExplicitType inType)
 {
     switch (inType)
     {
-        case kChar: return (cl_long)(*((cl_char *)inRaw));
+        case kChar: read_array<cl_char>(inRaw, out, count); return;
         case kUChar:
-        case kUnsignedChar: return (cl_long)(*((cl_uchar *)inRaw));
-        case kShort: return (cl_long)(*((cl_short *)inRaw));
+        case kUnsignedChar: read_array<cl_uchar>(inRaw, out, count); return;
+        case kShort: read_array<cl_short>(inRaw, out, count); return;
         case kUShort:
-        case kUnsignedShort: return (cl_long)(*((cl_ushort *)inRaw));
-        case kInt: return (cl_long)(*((cl_int *)inRaw));
+        case kUnsignedShort: read_array<cl_ushort>(inRaw, out, count); return;
+        case kInt: read_array<cl_int>(inRaw, out, count); return;
         case kUInt:
-        case kUnsignedInt: return (cl_long)(*((cl_uint *)inRaw));
-        case kLong: return (cl_long)(*((cl_long *)inRaw));
+        case kUnsignedInt: read_array<cl_uint>(inRaw, out, count); return;
+        case kLong: read_array<cl_long>(inRaw, out, count); return;
         case kULong:
-        case kUnsignedLong: return (cl_long)(*((cl_ulong *)inRaw));
-        default: return 0;
+        case kUnsignedLong: read_array<cl_ulong>(inRaw, out, count); return;
+        default: std::fill(out, out + count, 0); return;
     }
 }
 
-cl_ulong read_upscale_unsigned(void *inRaw, ExplicitType inType)
+void read_upscale_unsigned_array(const void *inRaw, cl_ulong *out,
+                                 size_t count, ExplicitType inType)
 {
     switch (inType)
     {
-        case kChar: return (cl_ulong)(*((cl_char *)inRaw));
+        case kChar: read_array<cl_char>(inRaw, out, count); return;
         case kUChar:
-        case kUnsignedChar: return (cl_ulong)(*((cl_uchar *)inRaw));
-        case kShort: return (cl_ulong)(*((cl_short *)inRaw));
+        case kUnsignedChar: read_array<cl_uchar>(inRaw, out, count); return;
+        case kShort: read_array<cl_short>(inRaw, out, count); return;
         case kUShort:
-        case kUnsignedShort: return (cl_ulong)(*((cl_ushort *)inRaw));
-        case kInt: return (cl_ulong)(*((cl_int *)inRaw));
+        case kUnsignedShort: read_array<cl_ushort>(inRaw, out, count); return;
+        case kInt: read_array<cl_int>(inRaw, out, count); return;
         case kUInt:
-        case kUnsignedInt: return (cl_ulong)(*((cl_uint *)inRaw));
-        case kLong: return (cl_ulong)(*((cl_long *)inRaw));
+        case kUnsignedInt: read_array<cl_uint>(inRaw, out, count); return;
+        case kLong: read_array<cl_long>(inRaw, out, count); return;
         case kULong:
-        case kUnsignedLong: return (cl_ulong)(*((cl_ulong *)inRaw));
-        default: return 0;
+        case kUnsignedLong: read_array<cl_ulong>(inRaw, out, count); return;
+        default: std::fill(out, out + count, 0); return;
     }
 }
 
-float read_as_float(void *inRaw, ExplicitType inType)
+void read_as_float_array(const void *inRaw, float *out, size_t count,
+                         ExplicitType inType)
 {
     switch (inType)
     {
-        case kChar: return (float)(*((cl_char *)inRaw));
+        case kChar: read_array<cl_char>(inRaw, out, count); return;
         case kUChar:
-        case kUnsignedChar: return (float)(*((cl_char *)inRaw));
-        case kShort: return (float)(*((cl_short *)inRaw));
+        case kUnsignedChar: read_array<cl_char>(inRaw, out, count); return;
+        case kShort: read_array<cl_short>(inRaw, out, count); return;
         case kUShort:
-        case kUnsignedShort: return (float)(*((cl_ushort *)inRaw));
-        case kInt: return (float)(*((cl_int *)inRaw));
+        case kUnsignedShort: read_array<cl_ushort>(inRaw, out, count); return;
+        case kInt: read_array<cl_int>(inRaw, out, count); return;
         case kUInt:
-        case kUnsignedInt: return (float)(*((cl_uint *)inRaw));
-        case kLong: return (float)(*((cl_long *)inRaw));
+        case kUnsignedInt: read_array<cl_uint>(inRaw, out, count); return;
+        case kLong: read_array<cl_long>(inRaw, out, count); return;
         case kULong:
-        case kUnsignedLong: return (float)(*((cl_ulong *)inRaw));
-        case kFloat: return *((float *)inRaw);
-        case kDouble: return (float)*((double *)inRaw);
-        default: return 0;
+        case kUnsignedLong: read_array<cl_ulong>(inRaw, out, count); return;
+        case kFloat: memcpy(out, inRaw, count * sizeof(float)); return;
+        case kDouble: read_array<cl_double>(inRaw, out, count); return;
+        default: std::fill(out, out + count, 0.f); return;
     }
 }
 
+cl_long read_upscale_signed(void *inRaw, ExplicitType inType)
+{
+    cl_long value;
+    read_upscale_signed_array(inRaw, &value, 1, inType);
+    return value;
+}
+
+cl_ulong read_upscale_unsigned(void *inRaw, ExplicitType inType)
+{
+    cl_ulong value;
+    read_upscale_unsigned_array(inRaw, &value, 1, inType);
+    return value;
+}
+
+float read_as_float(void *inRaw, ExplicitType inType)
+{
+    float value;
+    read_as_float_array(inRaw, &value, 1, inType);
+    return value;
+}
+
 float get_random_float(float low, float high, MTdata d)
 {
-    float t = (float)((double)genrand_int32(d) / (double)0xFFFFFFFF);
+    return get_random_float_from_word(low, high, genrand_int32(d));
+}
+
+float get_random_float_from_word(float low, float high, cl_uint word)
+{
+    float t = (float)((double)word / (double)0xFFFFFFFF);
     return (1.0f - t) * low + t * high;
 }
 
@@ -1320,19 +1067,25 @@ int random_in_range(int minV, int maxV, MTdata d)
 
 size_t get_random_size_t(size_t low, size_t high, MTdata d)
 {
-    enum
+    cl_uint words[GET_RANDOM_SIZE_T_WORDS];
+    for (unsigned i = 0; i != GET_RANDOM_SIZE_T_WORDS; ++i)
     {
-        N = sizeof(size_t) / sizeof(int)
-    };
+        words[i] = genrand_int32(d);
+    }
+    return get_random_size_t_from_words(low, high, words);
+}
 
+size_t get_random_size_t_from_words(size_t low, size_t high,
+                                    const cl_uint *words)
+{
     union {
-        int word[N];
+        cl_uint word[GET_RANDOM_SIZE_T_WORDS];
         size_t size;
     } u;
 
-    for (unsigned i = 0; i != N; ++i)
+    for (unsigned i = 0; i != GET_RANDOM_SIZE_T_WORDS; ++i)
     {
-        u.word[i] = genrand_int32(d);
+        u.word[i] = words[i];
     }
 
     assert(low <= high && "Invalid random number range specified");
@@ -72,6 +72,12 @@ extern void convert_explicit_value(void *inRaw, void *outRaw,
                                    ExplicitType inType, bool saturate,
                                    RoundingType roundType,
                                    ExplicitType outType);
+// convert_explicit_value over count elements of inType, picking the
+// conversion once for the whole array. kBool elements are one bool each.
+extern void convert_explicit_array(const void *inRaw, void *outRaw,
+                                   size_t count, ExplicitType inType,
+                                   bool saturate, RoundingType roundType,
+                                   ExplicitType outType);
 
 extern void generate_random_data(ExplicitType type, size_t count, MTdata d,
                                  void *outData);
@@ -80,6 +86,13 @@ extern void *create_random_data(ExplicitType type, MTdata d, size_t count);
 extern cl_long read_upscale_signed(void *inRaw, ExplicitType inType);
 extern cl_ulong read_upscale_unsigned(void *inRaw, ExplicitType inType);
 extern float read_as_float(void *inRaw, ExplicitType inType);
+// The same over count elements of inType
+extern void read_upscale_signed_array(const void *inRaw, cl_long *out,
+                                      size_t count, ExplicitType inType);
+extern void read_upscale_unsigned_array(const void *inRaw, cl_ulong *out,
+                                        size_t count, ExplicitType inType);
+extern void read_as_float_array(const void *inRaw, float *out, size_t count,
+                                ExplicitType inType);
 
 extern float get_random_float(float low, float high, MTdata d);
 extern double get_random_double(double low, double high, MTdata d);
@@ -90,6 +103,14 @@ extern int random_in_range(int minV, int maxV, MTdata d);
 
 size_t get_random_size_t(size_t low, size_t high, MTdata d);
 
+// The values get_random_float and get_random_size_t make of the generator
+// words they draw, for callers that draw many at once with genrand_fill.
+// get_random_size_t draws GET_RANDOM_SIZE_T_WORDS words per value.
+#define GET_RANDOM_SIZE_T_WORDS (sizeof(size_t) / sizeof(cl_uint))
+float get_random_float_from_word(float low, float high, cl_uint word);
+size_t get_random_size_t_from_words(size_t low, size_t high,
+                                    const cl_uint *words);
+
 // Note: though this takes a double, this is for use with single precision tests
 static inline int IsFloatSubnormal(float x)
 {
@@ -41,6 +41,26 @@
  */
 
 #include "crc32.h"
+#include "ThreadPool.h"
+
+#include <string.h>
+
+#include <vector>
+
+#if defined(__ARM_FEATURE_CRC32) && !defined(__ARM_BIG_ENDIAN)
+#include <arm_acle.h>
+#define CRC32_USE_ARM_CRC32
+#elif (defined(__x86_64__) || defined(__i386__))                               \
+    && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define CRC32_USE_PCLMUL
+#define CRC32_PCLMUL_TARGET __attribute__((target("pclmul,sse4.1")))
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#define CRC32_USE_PCLMUL
+#define CRC32_PCLMUL_TARGET
+#endif
 
 static uint32_t crc32_tab[] = {
     0x00000000, 0x77073096, 0xee0e612c, 0x990951ba, 0x076dc419, 0x706af48f,
@@ -88,6 +108,103 @@ static uint32_t crc32_tab[] = {
     0xb40bbe37, 0xc30c8ea1, 0x5a05df1b, 0x2d02ef8d
 };
 
+#if defined(CRC32_USE_PCLMUL)
+// The SSE4.2 crc32 instruction uses another polynomial, so x86 folds the data
+// with carry-less multiplies instead, as in Intel's "Fast CRC Computation for
+// Generic Polynomials Using PCLMULQDQ Instruction". The constants are the
+// ones that paper gives for this polynomial in the bit-reflected domain.
+static bool has_pclmul()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    // PCLMULQDQ and SSE4.1
+    static const bool supported =
+        (info[2] & (1 << 1)) != 0 && (info[2] & (1 << 19)) != 0;
+#else
+    static const bool supported =
+        __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+#endif
+    return supported;
+}
+
+// Folds size bytes, at least 64 and a multiple of 16, into crc
+CRC32_PCLMUL_TARGET static uint32_t crc32_pclmul(uint32_t crc,
+                                                 const uint8_t *p, size_t size)
+{
+    const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+    const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+    const __m128i k5k0 = _mm_set_epi64x(0, 0x0163cd6124);
+    const __m128i poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+    const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+
+    __m128i x1 = _mm_loadu_si128((const __m128i *)(p + 0x00));
+    __m128i x2 = _mm_loadu_si128((const __m128i *)(p + 0x10));
+    __m128i x3 = _mm_loadu_si128((const __m128i *)(p + 0x20));
+    __m128i x4 = _mm_loadu_si128((const __m128i *)(p + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)crc));
+    p += 64;
+    size -= 64;
+
+    // Four lanes of 16 bytes, each folded over the next 64
+    while (size >= 64)
+    {
+        __m128i x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+        __m128i x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+        __m128i x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+        __m128i x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5),
+                           _mm_loadu_si128((const __m128i *)(p + 0x00)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6),
+                           _mm_loadu_si128((const __m128i *)(p + 0x10)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7),
+                           _mm_loadu_si128((const __m128i *)(p + 0x20)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8),
+                           _mm_loadu_si128((const __m128i *)(p + 0x30)));
+        p += 64;
+        size -= 64;
+    }
+
+    // Fold the lanes into one, then the rest of the data 16 bytes at a time
+    __m128i x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+    for (; size >= 16; p += 16, size -= 16)
+    {
+        x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5),
+                           _mm_loadu_si128((const __m128i *)p));
+    }
+
+    // 128 bits to 64
+    x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, mask32);
+    x1 = _mm_clmulepi64_si128(x1, k5k0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett reduction to 32 bits
+    x2 = _mm_and_si128(x1, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+    x2 = _mm_and_si128(x2, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+    return (uint32_t)_mm_extract_epi32(x1, 1);
+}
+#endif
+
 uint32_t crc32(const void *buf, size_t size)
 {
     const uint8_t *p;
@@ -95,7 +212,104 @@ uint32_t crc32(const void *buf, size_t size)
     p = (const uint8_t *)buf;
     uint32_t crc = ~0U;
 
+#if defined(CRC32_USE_ARM_CRC32)
+    // The ARMv8 CRC32 instructions use the same (reflected) polynomial as the
+    // table, so eight bytes at a time give the same result.
+    for (; size >= 8; size -= 8, p += 8)
+    {
+        uint64_t v;
+        memcpy(&v, p, sizeof(v));
+        crc = __crc32d(crc, v);
+    }
+#elif defined(CRC32_USE_PCLMUL)
+    if (size >= 64 && has_pclmul())
+    {
+        size_t folded = size & ~(size_t)15;
+        crc = crc32_pclmul(crc, p, folded);
+        p += folded;
+        size -= folded;
+    }
+#endif
+
     while (size--) crc = crc32_tab[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
 
     return crc ^ ~0U;
 }
+
+// a * b modulo the polynomial, with x^0 in the top bit as in the table
+static uint32_t multiply_mod_poly(uint32_t a, uint32_t b)
+{
+    uint32_t product = 0;
+    for (uint32_t m = 1U << 31; m != 0; m >>= 1)
+    {
+        if (a & m) product ^= b;
+        b = (b & 1) ? (b >> 1) ^ 0xedb88320 : b >> 1;
+    }
+    return product;
+}
+
+uint32_t crc32_combine(uint32_t crc1, uint32_t crc2, size_t size2)
+{
+    // Appending size2 bytes multiplies the CRC of the first part by
+    // x^(8 * size2), which is built up from repeated squares of x^8
+    uint32_t shift = 1U << 31;
+    for (uint32_t square = 1U << 23; size2 != 0; size2 >>= 1)
+    {
+        if (size2 & 1) shift = multiply_mod_poly(square, shift);
+        square = multiply_mod_poly(square, square);
+    }
+    return multiply_mod_poly(shift, crc1) ^ crc2;
+}
+
+namespace {
+
+// Below this a buffer is not worth handing to the thread pool
+const size_t kMinParallelSegment = 4 << 20;
+
+struct SegmentInfo
+{
+    const uint8_t *data;
+    size_t size;
+    size_t segmentSize;
+    std::vector<uint32_t> crcs;
+};
+
+cl_int crc32_segment_job(cl_uint job_id, cl_uint thread_id, void *userInfo)
+{
+    SegmentInfo *info = (SegmentInfo *)userInfo;
+    size_t start = job_id * info->segmentSize;
+    size_t size = info->size - start < info->segmentSize ? info->size - start
+                                                         : info->segmentSize;
+    info->crcs[job_id] = crc32(info->data + start, size);
+    return CL_SUCCESS;
+}
+
+} // anonymous namespace
+
+uint32_t crc32_parallel(const void *buf, size_t size)
+{
+    cl_uint threads = GetThreadCount();
+    if (threads < 2 || size < 2 * kMinParallelSegment) return crc32(buf, size);
+
+    SegmentInfo info;
+    info.data = (const uint8_t *)buf;
+    info.size = size;
+    info.segmentSize = (size + threads - 1) / threads;
+    if (info.segmentSize < kMinParallelSegment)
+        info.segmentSize = kMinParallelSegment;
+    size_t segments = (size + info.segmentSize - 1) / info.segmentSize;
+    info.crcs.resize(segments);
+    if (ThreadPool_Do(crc32_segment_job, (cl_uint)segments, &info)
+        != CL_SUCCESS)
+        return crc32(buf, size);
+
+    uint32_t crc = info.crcs[0];
+    for (size_t i = 1; i < segments; i++)
+    {
+        size_t segmentSize = i + 1 < segments
+            ? info.segmentSize
+            : size - i * info.segmentSize;
+        crc = crc32_combine(crc, info.crcs[i], segmentSize);
+    }
+    return crc;
+}
@@ -22,4 +22,12 @@
 
 uint32_t crc32(const void *buf, size_t size);
 
+// The CRC of two blocks one after the other, from crc1 of the first and crc2
+// of the second, which is size2 bytes long
+uint32_t crc32_combine(uint32_t crc1, uint32_t crc2, size_t size2);
+
+// crc32 of a large buffer, computed in segments on the thread pool and
+// combined. May not be called from a ThreadPool_Do job.
+uint32_t crc32_parallel(const void *buf, size_t size);
+
 #endif
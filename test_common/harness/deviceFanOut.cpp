@@ -0,0 +1,294 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "deviceFanOut.h"
+
+#include "errorHelpers.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <errno.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+const char *kPerDeviceFiles[] = {
+    "CL_CONFORMANCE_RESULTS_FILENAME",
+    "CL_CONFORMANCE_METRICS_FILENAME",
+    "CL_CONFORMANCE_TRACE_FILENAME",
+};
+
+struct DeviceChild
+{
+    pid_t pid;
+    int output;
+    std::string pending;
+};
+
+// fileName with _dev<index> inserted before its extension
+std::string device_file_name(const std::string &fileName, cl_uint index)
+{
+    size_t slash = fileName.find_last_of('/');
+    size_t dot = fileName.find_last_of('.');
+    if (dot == std::string::npos
+        || (slash != std::string::npos && dot < slash))
+        dot = fileName.size();
+    return fileName.substr(0, dot) + "_dev" + std::to_string(index)
+        + fileName.substr(dot);
+}
+
+bool write_all(int fd, const char *data, size_t size)
+{
+    while (size > 0)
+    {
+        ssize_t written = write(fd, data, size);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) return false;
+        data += written;
+        size -= written;
+    }
+    return true;
+}
+
+// The names of the devices, one per line, from a child process so that this
+// one doesn't load the OpenCL implementation before forking
+bool probe_devices(cl_uint platformIndex, cl_device_type type,
+                   std::vector<std::string> &names)
+{
+    int fds[2];
+    if (pipe(fds) != 0) return false;
+    fflush(stdout);
+    fflush(stderr);
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+
+    if (pid == 0)
+    {
+        close(fds[0]);
+        cl_uint count = 0;
+        if (clGetPlatformIDs(0, NULL, &count) || platformIndex >= count)
+            _exit(EXIT_FAILURE);
+        std::vector<cl_platform_id> platforms(count);
+        cl_uint devices = 0;
+        if (clGetPlatformIDs(count, platforms.data(), NULL)
+            || clGetDeviceIDs(platforms[platformIndex], type, 0, NULL,
+                              &devices))
+            _exit(EXIT_FAILURE);
+        std::vector<cl_device_id> ids(devices);
+        if (clGetDeviceIDs(platforms[platformIndex], type, devices, ids.data(),
+                           NULL))
+            _exit(EXIT_FAILURE);
+        for (cl_device_id id : ids)
+        {
+            char name[1024] = "";
+            clGetDeviceInfo(id, CL_DEVICE_NAME, sizeof(name), name, NULL);
+            std::string line = std::string(name) + "\n";
+            if (!write_all(fds[1], line.data(), line.size()))
+                _exit(EXIT_FAILURE);
+        }
+        _exit(EXIT_SUCCESS);
+    }
+
+    close(fds[1]);
+    std::string text;
+    char buffer[4096];
+    ssize_t size;
+    while ((size = read(fds[0], buffer, sizeof(buffer))) != 0)
+    {
+        if (size < 0 && errno == EINTR) continue;
+        if (size < 0) break;
+        text.append(buffer, size);
+    }
+    close(fds[0]);
+
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0 && errno == EINTR)
+    {
+    }
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) return false;
+
+    for (size_t start = 0; start < text.size();)
+    {
+        size_t end = text.find('\n', start);
+        names.push_back(text.substr(start, end - start));
+        start = end + 1;
+    }
+    return true;
+}
+
+// Print the complete lines of child, or all that's left at the end
+void print_lines(DeviceChild &child, cl_uint index, bool end)
+{
+    size_t start = 0;
+    for (;;)
+    {
+        size_t newline = child.pending.find('\n', start);
+        if (newline == std::string::npos) break;
+        printf("[device %u] %.*s\n", index, (int)(newline - start),
+               child.pending.c_str() + start);
+        start = newline + 1;
+    }
+    child.pending.erase(0, start);
+    if (end && !child.pending.empty())
+    {
+        printf("[device %u] %s\n", index, child.pending.c_str());
+        child.pending.clear();
+    }
+    fflush(stdout);
+}
+
+} // anonymous namespace
+
+bool fan_out_to_devices(cl_uint platformIndex, cl_device_type type,
+                        cl_uint *deviceIndex, int *status)
+{
+    std::vector<std::string> names;
+    if (!probe_devices(platformIndex, type, names))
+    {
+        log_error("ERROR: Failed to list the devices for --all-devices.\n");
+        *status = EXIT_FAILURE;
+        return false;
+    }
+    if (names.size() < 2)
+    {
+        *deviceIndex = 0;
+        return true;
+    }
+
+    log_info("Running on %zu devices at once:\n", names.size());
+    for (size_t i = 0; i < names.size(); i++)
+        log_info("\t%zu: %s\n", i, names[i].c_str());
+    fflush(stdout);
+    fflush(stderr);
+
+    std::vector<DeviceChild> children;
+    for (cl_uint i = 0; i < names.size(); i++)
+    {
+        int fds[2];
+        pid_t pid = -1;
+        if (pipe(fds) == 0)
+        {
+            pid = fork();
+            if (pid < 0)
+            {
+                close(fds[0]);
+                close(fds[1]);
+            }
+        }
+        if (pid < 0)
+        {
+            log_error("ERROR: Failed to start the run on device %u: %s\n", i,
+                      strerror(errno));
+            break;
+        }
+
+        if (pid == 0)
+        {
+            for (const DeviceChild &child : children) close(child.output);
+            close(fds[0]);
+            dup2(fds[1], STDOUT_FILENO);
+            dup2(fds[1], STDERR_FILENO);
+            close(fds[1]);
+            setvbuf(stdout, NULL, _IOLBF, 0);
+
+            for (const char *variable : kPerDeviceFiles)
+            {
+                const char *value = getenv(variable);
+                if (value != nullptr)
+                    setenv(variable, device_file_name(value, i).c_str(), 1);
+            }
+            *deviceIndex = i;
+            return true;
+        }
+
+        close(fds[1]);
+        DeviceChild child = { pid, fds[0], std::string() };
+        children.push_back(child);
+    }
+
+    // Relay the output of the children until they all close it
+    std::vector<pollfd> fds(children.size());
+    size_t open = children.size();
+    for (size_t i = 0; i < children.size(); i++)
+        fds[i] = { children[i].output, POLLIN, 0 };
+    while (open > 0)
+    {
+        if (poll(fds.data(), fds.size(), -1) < 0)
+        {
+            if (errno == EINTR) continue;
+            break;
+        }
+        for (size_t i = 0; i < fds.size(); i++)
+        {
+            if (fds[i].fd < 0 || !(fds[i].revents & (POLLIN | POLLHUP | POLLERR)))
+                continue;
+            char buffer[4096];
+            ssize_t size = read(fds[i].fd, buffer, sizeof(buffer));
+            if (size < 0 && errno == EINTR) continue;
+            if (size > 0)
+            {
+                children[i].pending.append(buffer, size);
+                print_lines(children[i], (cl_uint)i, false);
+                continue;
+            }
+            print_lines(children[i], (cl_uint)i, true);
+            close(fds[i].fd);
+            fds[i].fd = -1;
+            open--;
+        }
+    }
+
+    *status = children.size() == names.size() ? EXIT_SUCCESS : EXIT_FAILURE;
+    log_info("\nResults on %zu devices:\n", names.size());
+    for (size_t i = 0; i < children.size(); i++)
+    {
+        if (fds[i].fd >= 0) close(fds[i].fd);
+        int childStatus = 0;
+        while (waitpid(children[i].pid, &childStatus, 0) < 0 && errno == EINTR)
+        {
+        }
+        bool passed = WIFEXITED(childStatus)
+            && WEXITSTATUS(childStatus) == EXIT_SUCCESS;
+        if (!passed) *status = EXIT_FAILURE;
+        log_info("\t%zu: %s %s\n", i, names[i].c_str(),
+                 passed ? "PASSED" : "FAILED");
+    }
+    return false;
+}
+
+#else // _WIN32
+
+bool fan_out_to_devices(cl_uint platformIndex, cl_device_type type,
+                        cl_uint *deviceIndex, int *status)
+{
+    log_error("ERROR: --all-devices is not supported on Windows.\n");
+    *status = EXIT_FAILURE;
+    return false;
+}
+
+#endif
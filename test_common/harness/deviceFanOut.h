@@ -0,0 +1,37 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef HARNESS_DEVICE_FAN_OUT_H_
+#define HARNESS_DEVICE_FAN_OUT_H_
+
+#include "compat.h"
+
+#include <CL/opencl.h>
+
+// Runs the suite on every device of a type on a platform at once, for
+// --all-devices. Each device gets a child process of its own, forked before
+// the parent touches OpenCL, and the parent prints the output of the
+// children line by line with the index of their device in front. The
+// children write the results, metrics and traces named in the environment
+// to files with _dev<index> added before the extension, and share the host
+// side caches kept on disk, such as the math reference cache.
+//
+// Returns true in a child, or if there is a single device, with the index of
+// the device to run on in *deviceIndex. Returns false in the parent once the
+// children have finished, with EXIT_SUCCESS in *status if they all passed.
+bool fan_out_to_devices(cl_uint platformIndex, cl_device_type type,
+                        cl_uint *deviceIndex, int *status);
+
+#endif // HARNESS_DEVICE_FAN_OUT_H_
@@ -14,19 +14,308 @@
 // limitations under the License.
 //
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <mutex>
 #include <sstream>
 #include <stdexcept>
 #include <vector>
 
+#include "crc32.h"
 #include "deviceInfo.h"
 #include "errorHelpers.h"
 #include "typeWrappers.h"
 
+namespace {
+
+const cl_device_info kSnapshotStrings[] = {
+    CL_DEVICE_NAME,
+    CL_DEVICE_VENDOR,
+    CL_DRIVER_VERSION,
+    CL_DEVICE_PROFILE,
+    CL_DEVICE_VERSION,
+    CL_DEVICE_OPENCL_C_VERSION,
+    CL_DEVICE_EXTENSIONS,
+    CL_DEVICE_IL_VERSION,
+    CL_DEVICE_BUILT_IN_KERNELS,
+    CL_DEVICE_LATEST_CONFORMANCE_VERSION_PASSED,
+};
+
+const cl_device_info kSnapshotNameVersions[] = {
+    CL_DEVICE_EXTENSIONS_WITH_VERSION,
+    CL_DEVICE_ILS_WITH_VERSION,
+    CL_DEVICE_BUILT_IN_KERNELS_WITH_VERSION,
+    CL_DEVICE_OPENCL_C_ALL_VERSIONS,
+    CL_DEVICE_OPENCL_C_FEATURES,
+};
+
+const char kCacheHeader[] = "# OpenCL CTS device info cache 1";
+
+std::mutex gSnapshotMutex;
+std::map<cl_device_id, std::shared_ptr<const DeviceSnapshot>> gSnapshots;
+
+bool is_snapshot_string(cl_device_info param)
+{
+    for (cl_device_info snapshotParam : kSnapshotStrings)
+        if (param == snapshotParam) return true;
+    return false;
+}
+
+bool query_string(cl_device_id device, cl_device_info param,
+                  std::string &value)
+{
+    size_t size = 0;
+    if (clGetDeviceInfo(device, param, 0, NULL, &size) != CL_SUCCESS
+        || size == 0)
+        return false;
+    std::vector<char> info(size);
+    if (clGetDeviceInfo(device, param, size, info.data(), NULL) != CL_SUCCESS)
+        return false;
+    /* The returned string does not include the null terminator. */
+    value.assign(info.data(), size - 1);
+    return true;
+}
+
+bool query_name_versions(cl_device_id device, cl_device_info param,
+                         std::vector<cl_name_version> &value)
+{
+    size_t size = 0;
+    if (clGetDeviceInfo(device, param, 0, NULL, &size) != CL_SUCCESS)
+        return false;
+    value.resize(size / sizeof(cl_name_version));
+    return value.empty()
+        || clGetDeviceInfo(device, param, size, value.data(), NULL)
+        == CL_SUCCESS;
+}
+
+/* Tabs and newlines separate the fields of the cache file */
+std::string escape(const std::string &s)
+{
+    std::string out;
+    for (char c : s)
+    {
+        if (c == '\\')
+            out += "\\\\";
+        else if (c == '\t')
+            out += "\\t";
+        else if (c == '\n')
+            out += "\\n";
+        else
+            out += c;
+    }
+    return out;
+}
+
+std::string unescape(const std::string &s)
+{
+    std::string out;
+    for (size_t i = 0; i < s.size(); i++)
+    {
+        if (s[i] != '\\' || i + 1 == s.size())
+        {
+            out += s[i];
+            continue;
+        }
+        char c = s[++i];
+        out += c == 't' ? '\t' : c == 'n' ? '\n' : c;
+    }
+    return out;
+}
+
+std::vector<std::string> split(const std::string &line)
+{
+    std::vector<std::string> fields;
+    size_t begin = 0;
+    for (;;)
+    {
+        size_t end = line.find('\t', begin);
+        fields.push_back(line.substr(begin, end - begin));
+        if (end == std::string::npos) break;
+        begin = end + 1;
+    }
+    return fields;
+}
+
+} // anonymous namespace
+
+const std::string *DeviceSnapshot::String(cl_device_info param) const
+{
+    for (const auto &entry : m_strings)
+        if (entry.first == param) return &entry.second;
+    return NULL;
+}
+
+const std::vector<cl_name_version> *
+DeviceSnapshot::NameVersions(cl_device_info param) const
+{
+    for (const auto &entry : m_nameVersions)
+        if (entry.first == param) return &entry.second;
+    return NULL;
+}
+
+bool DeviceSnapshot::HasExtension(const char *extensionName) const
+{
+    return m_extensions.count(extensionName) != 0;
+}
+
+std::shared_ptr<const DeviceSnapshot> get_device_snapshot(cl_device_id device)
+{
+    std::lock_guard<std::mutex> lock(gSnapshotMutex);
+    auto cached = gSnapshots.find(device);
+    if (cached != gSnapshots.end()) return cached->second;
+
+    cl_device_id parent = NULL;
+    bool subDevice = clGetDeviceInfo(device, CL_DEVICE_PARENT_DEVICE,
+                                     sizeof(parent), &parent, NULL)
+            == CL_SUCCESS
+        && parent != NULL;
+
+    /* The cache file is only used if the device still has the name, vendor
+     * and driver it was saved for */
+    std::string cacheFile, key;
+    const char *cacheDirectory = getenv("CL_DEVICE_INFO_CACHE");
+    if (cacheDirectory && cacheDirectory[0] != '\0' && !subDevice)
+    {
+        std::string name, driver;
+        cl_uint vendorId = 0;
+        if (query_string(device, CL_DEVICE_NAME, name)
+            && query_string(device, CL_DRIVER_VERSION, driver)
+            && clGetDeviceInfo(device, CL_DEVICE_VENDOR_ID, sizeof(vendorId),
+                               &vendorId, NULL)
+                == CL_SUCCESS)
+        {
+            key = "key\t" + escape(name) + "\t" + escape(driver) + "\t"
+                + std::to_string(vendorId);
+            char fileName[64];
+            snprintf(fileName, sizeof(fileName), "/device_info_%08x.txt",
+                     (unsigned)crc32(key.data(), key.size()));
+            cacheFile = std::string(cacheDirectory) + fileName;
+        }
+    }
+
+    std::shared_ptr<DeviceSnapshot> snapshot(new DeviceSnapshot());
+    bool loaded = false;
+    if (!cacheFile.empty())
+    {
+        std::ifstream file(cacheFile);
+        std::string line;
+        if (std::getline(file, line) && line == kCacheHeader
+            && std::getline(file, line) && line == key)
+        {
+            loaded = true;
+            while (std::getline(file, line))
+            {
+                std::vector<std::string> fields = split(line);
+                cl_device_info param = fields.size() > 1
+                    ? (cl_device_info)strtoul(fields[1].c_str(), NULL, 16)
+                    : 0;
+                if (fields[0] == "s" && fields.size() == 3)
+                    snapshot->m_strings.push_back(
+                        { param, unescape(fields[2]) });
+                else if (fields[0] == "l" && fields.size() == 2)
+                    snapshot->m_nameVersions.push_back({ param, {} });
+                else if (fields[0] == "n" && fields.size() == 4
+                         && !snapshot->m_nameVersions.empty()
+                         && snapshot->m_nameVersions.back().first == param)
+                {
+                    cl_name_version entry = {};
+                    entry.version =
+                        (cl_version)strtoul(fields[2].c_str(), NULL, 10);
+                    strncpy(entry.name, unescape(fields[3]).c_str(),
+                            CL_NAME_VERSION_MAX_NAME_SIZE - 1);
+                    snapshot->m_nameVersions.back().second.push_back(entry);
+                }
+                else
+                {
+                    log_info("Ignoring the unreadable device info cache "
+                             "%s.\n",
+                             cacheFile.c_str());
+                    snapshot.reset(new DeviceSnapshot());
+                    loaded = false;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (!loaded)
+    {
+        for (cl_device_info param : kSnapshotStrings)
+        {
+            std::string value;
+            if (query_string(device, param, value))
+                snapshot->m_strings.push_back({ param, value });
+        }
+        for (cl_device_info param : kSnapshotNameVersions)
+        {
+            std::vector<cl_name_version> value;
+            if (query_name_versions(device, param, value))
+                snapshot->m_nameVersions.push_back({ param, value });
+        }
+    }
+
+    const std::string *extensions = snapshot->String(CL_DEVICE_EXTENSIONS);
+    if (extensions)
+    {
+        std::istringstream ss(*extensions);
+        std::string found;
+        while (ss >> found) snapshot->m_extensions.insert(found);
+    }
+
+    /* Write a temporary file and rename it, so that suites starting at the
+     * same time never read half a cache */
+    if (!loaded && !cacheFile.empty())
+    {
+        std::string temporary = cacheFile + ".tmp"
+            + std::to_string(std::chrono::steady_clock::now()
+                                 .time_since_epoch()
+                                 .count());
+        FILE *file = fopen(temporary.c_str(), "w");
+        if (file != NULL)
+        {
+            fprintf(file, "%s\n%s\n", kCacheHeader, key.c_str());
+            for (const auto &entry : snapshot->m_strings)
+                fprintf(file, "s\t%x\t%s\n", (unsigned)entry.first,
+                        escape(entry.second).c_str());
+            for (const auto &entry : snapshot->m_nameVersions)
+            {
+                fprintf(file, "l\t%x\n", (unsigned)entry.first);
+                for (const cl_name_version &value : entry.second)
+                    fprintf(file, "n\t%x\t%u\t%s\n", (unsigned)entry.first,
+                            (unsigned)value.version,
+                            escape(value.name).c_str());
+            }
+            bool written = fclose(file) == 0;
+            if (!written || rename(temporary.c_str(), cacheFile.c_str()) != 0)
+                remove(temporary.c_str());
+        }
+    }
+
+    if (!subDevice) gSnapshots[device] = snapshot;
+    return snapshot;
+}
+
 /* Helper to return a string containing device information for the specified
  * device info parameter. */
 std::string get_device_info_string(cl_device_id device,
                                    cl_device_info param_name)
 {
+    if (is_snapshot_string(param_name))
+    {
+        auto snapshot = get_device_snapshot(device);
+        const std::string *value = snapshot->String(param_name);
+        if (value == NULL)
+        {
+            throw std::runtime_error("clGetDeviceInfo failed\n");
+        }
+        return *value;
+    }
+
     size_t size = 0;
     int err;
 
@@ -52,40 +341,26 @@ std::string get_device_info_string(cl_device_id device,
 /* Determines if an extension is supported by a device. */
 int is_extension_available(cl_device_id device, const char *extensionName)
 {
-    std::string extString = get_device_extensions_string(device);
-    std::istringstream ss(extString);
-    while (ss)
+    auto snapshot = get_device_snapshot(device);
+    if (snapshot->String(CL_DEVICE_EXTENSIONS) == NULL)
     {
-        std::string found;
-        ss >> found;
-        if (found == extensionName) return true;
+        throw std::runtime_error("clGetDeviceInfo failed\n");
     }
-    return false;
+    return snapshot->HasExtension(extensionName);
 }
 
 cl_version get_extension_version(cl_device_id device, const char *extensionName)
 {
-    cl_int err;
-    size_t size;
-
-    err = clGetDeviceInfo(device, CL_DEVICE_EXTENSIONS_WITH_VERSION, 0, nullptr,
-                          &size);
-    if (err != CL_SUCCESS)
-    {
-        throw std::runtime_error("clGetDeviceInfo(CL_DEVICE_EXTENSIONS_WITH_"
-                                 "VERSION) failed to return size\n");
-    }
-
-    std::vector<cl_name_version> extensions(size / sizeof(cl_name_version));
-    err = clGetDeviceInfo(device, CL_DEVICE_EXTENSIONS_WITH_VERSION, size,
-                          extensions.data(), &size);
-    if (err != CL_SUCCESS)
+    auto snapshot = get_device_snapshot(device);
+    const std::vector<cl_name_version> *extensions =
+        snapshot->NameVersions(CL_DEVICE_EXTENSIONS_WITH_VERSION);
+    if (extensions == NULL)
     {
         throw std::runtime_error("clGetDeviceInfo(CL_DEVICE_EXTENSIONS_WITH_"
                                  "VERSION) failed to return value\n");
     }
 
-    for (auto &ext : extensions)
+    for (auto &ext : *extensions)
     {
         if (!strcmp(extensionName, ext.name))
         {
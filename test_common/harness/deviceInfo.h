@@ -19,10 +19,46 @@
 // Configuration
 #include "../config.hpp"
 
+#include <memory>
 #include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include <CL/opencl.h>
 
+/* The string and name-version device queries the harness and tests make
+ * over and over, made once per device and kept for the whole process, as
+ * each query is a round trip to remote and virtualized devices. If
+ * CL_DEVICE_INFO_CACHE names a directory, the answers are also saved there
+ * per device name, vendor and driver version, so that later runs only query
+ * those three. */
+class DeviceSnapshot {
+public:
+    /* The value of a string query, or NULL if the device doesn't report it
+     * or param isn't one of the snapshot queries. */
+    const std::string *String(cl_device_info param) const;
+
+    /* The value of a cl_name_version query, or NULL as for String. */
+    const std::vector<cl_name_version> *NameVersions(
+        cl_device_info param) const;
+
+    bool HasExtension(const char *extensionName) const;
+
+private:
+    friend std::shared_ptr<const DeviceSnapshot>
+    get_device_snapshot(cl_device_id device);
+
+    std::vector<std::pair<cl_device_info, std::string>> m_strings;
+    std::vector<std::pair<cl_device_info, std::vector<cl_name_version>>>
+        m_nameVersions;
+    std::unordered_set<std::string> m_extensions;
+};
+
+/* The snapshot of device, filled on first use. Sub-devices get a fresh
+ * snapshot on every call, as their handles may be reused once released. */
+std::shared_ptr<const DeviceSnapshot> get_device_snapshot(cl_device_id device);
+
 /* Helper to return a string containing device information for the specified
  * device info parameter. */
 std::string get_device_info_string(cl_device_id device,
@@ -0,0 +1,163 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "deviceRandom.h"
+
+#include "errorHelpers.h"
+#include "kernelHelpers.h"
+#include "stagingPool.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <map>
+#include <mutex>
+
+namespace {
+
+// philox_random_block, with each work-item writing the words of one block
+// that fall in [index, index + count)
+const char *kGeneratorSource =
+    "__kernel void philox_fill(__global uint *out, ulong offset, ulong seed,\n"
+    "                          ulong index, ulong count)\n"
+    "{\n"
+    "    ulong block = index / 4 + get_global_id(0);\n"
+    "    uint c0 = (uint)block, c1 = (uint)(block >> 32), c2 = 0, c3 = 0;\n"
+    "    uint k0 = (uint)seed, k1 = (uint)(seed >> 32);\n"
+    "    for (int round = 0; round < 10; round++)\n"
+    "    {\n"
+    "        uint hi0 = mul_hi(0xD2511F53u, c0), lo0 = 0xD2511F53u * c0;\n"
+    "        uint hi1 = mul_hi(0xCD9E8D57u, c2), lo1 = 0xCD9E8D57u * c2;\n"
+    "        c0 = hi1 ^ c1 ^ k0;\n"
+    "        c2 = hi0 ^ c3 ^ k1;\n"
+    "        c1 = lo1;\n"
+    "        c3 = lo0;\n"
+    "        k0 += 0x9E3779B9u;\n"
+    "        k1 += 0xBB67AE85u;\n"
+    "    }\n"
+    "    uint words[4] = { c0, c1, c2, c3 };\n"
+    "    for (int j = 0; j < 4; j++)\n"
+    "    {\n"
+    "        ulong word = 4 * block + j;\n"
+    "        if (word >= index && word - index < count)\n"
+    "            out[offset + word - index] = words[j];\n"
+    "    }\n"
+    "}\n";
+
+struct DeviceGenerator
+{
+    cl_program program = NULL;
+    cl_kernel kernel = NULL;
+};
+
+// Serialises setting the arguments of the kernels and enqueuing them
+std::mutex gGeneratorMutex;
+std::map<cl_context, DeviceGenerator> gGenerators;
+
+// The generator kernel of the context of queue, built the first time, or NULL
+// if the device cannot build it. Called with gGeneratorMutex held.
+cl_kernel generator_kernel(cl_command_queue queue)
+{
+    cl_context context;
+    if (clGetCommandQueueInfo(queue, CL_QUEUE_CONTEXT, sizeof(context),
+                              &context, NULL)
+        != CL_SUCCESS)
+        return NULL;
+
+    auto it = gGenerators.find(context);
+    if (it != gGenerators.end()) return it->second.kernel;
+
+    DeviceGenerator &generator = gGenerators[context];
+    if (create_single_kernel_helper(context, &generator.program,
+                                    &generator.kernel, 1, &kGeneratorSource,
+                                    "philox_fill"))
+    {
+        log_error("Warning: Could not build the random input generator, "
+                  "input will be written from the host\n");
+        if (generator.program) clReleaseProgram(generator.program);
+        generator.program = NULL;
+        generator.kernel = NULL;
+    }
+    return generator.kernel;
+}
+
+} // anonymous namespace
+
+bool device_random_enabled()
+{
+    static const bool enabled = [] {
+        const char *env = getenv("CL_TEST_DEVICE_RANDOM");
+        return env != NULL && strcmp(env, "1") == 0;
+    }();
+    return enabled;
+}
+
+cl_int enqueue_write_random_words(cl_command_queue queue, cl_mem buffer,
+                                  cl_bool blocking, size_t offset,
+                                  size_t count, cl_ulong seed, cl_ulong index,
+                                  const cl_uint *host,
+                                  cl_uint num_events_in_wait_list,
+                                  const cl_event *event_wait_list,
+                                  cl_event *event)
+{
+    if (device_random_enabled() && count > 0 && offset % sizeof(cl_uint) == 0)
+    {
+        std::unique_lock<std::mutex> lock(gGeneratorMutex);
+        if (cl_kernel kernel = generator_kernel(queue))
+        {
+            cl_ulong offsetWords = offset / sizeof(cl_uint);
+            cl_ulong countWords = count;
+            cl_int error = clSetKernelArg(kernel, 0, sizeof(buffer), &buffer);
+            error |= clSetKernelArg(kernel, 1, sizeof(offsetWords),
+                                    &offsetWords);
+            error |= clSetKernelArg(kernel, 2, sizeof(seed), &seed);
+            error |= clSetKernelArg(kernel, 3, sizeof(index), &index);
+            error |= clSetKernelArg(kernel, 4, sizeof(countWords), &countWords);
+            test_error(error, "Unable to set the random generator arguments");
+
+            size_t blocks = (size_t)((index + count + 3) / 4 - index / 4);
+            cl_event done = NULL;
+            error = clEnqueueNDRangeKernel(
+                queue, kernel, 1, NULL, &blocks, NULL, num_events_in_wait_list,
+                event_wait_list, (event || blocking) ? &done : NULL);
+            test_error(error, "Unable to enqueue the random generator");
+            lock.unlock();
+
+            if (blocking)
+            {
+                error = clWaitForEvents(1, &done);
+                if (!event) clReleaseEvent(done);
+                test_error(error, "Unable to wait for the random generator");
+            }
+            if (event) *event = done;
+            return CL_SUCCESS;
+        }
+    }
+
+    return enqueue_write_staged(queue, buffer, blocking, offset,
+                                count * sizeof(cl_uint), host,
+                                num_events_in_wait_list, event_wait_list,
+                                event);
+}
+
+void release_device_random(cl_context context)
+{
+    std::lock_guard<std::mutex> lock(gGeneratorMutex);
+    auto it = gGenerators.find(context);
+    if (it == gGenerators.end()) return;
+    if (it->second.kernel) clReleaseKernel(it->second.kernel);
+    if (it->second.program) clReleaseProgram(it->second.program);
+    gGenerators.erase(it);
+}
@@ -0,0 +1,54 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef HARNESS_DEVICE_RANDOM_H_
+#define HARNESS_DEVICE_RANDOM_H_
+
+#include <CL/opencl.h>
+
+#include <stddef.h>
+
+// Random input generated on the device rather than written to it. The words
+// of a counter-based stream (see philox.h) are the same wherever they are
+// made, so a kernel can fill an input buffer while the host makes the same
+// words for the reference with init_genrand_counter and genrand_fill, and
+// nothing goes over the bus.
+//
+// Off unless CL_TEST_DEVICE_RANDOM=1 is set in the environment, and on
+// devices that cannot build the generator, which then get the host's words
+// written as before.
+
+// Whether CL_TEST_DEVICE_RANDOM=1 asks for input generated on the device
+bool device_random_enabled();
+
+// Put the count words index, index + 1, ... of the counter-based stream of
+// seed at byte offset of buffer, as init_genrand_counter(seed, index) and
+// genrand_fill would make them. The stream's words are generated on the
+// device if device_random_enabled(), and host, which must already hold
+// them, is written otherwise, with the semantics of enqueue_write_staged.
+cl_int enqueue_write_random_words(cl_command_queue queue, cl_mem buffer,
+                                  cl_bool blocking, size_t offset,
+                                  size_t count, cl_ulong seed, cl_ulong index,
+                                  const cl_uint *host,
+                                  cl_uint num_events_in_wait_list,
+                                  const cl_event *event_wait_list,
+                                  cl_event *event);
+
+// Release the generator of context, which keeps it alive, once it's done
+// with. Suites that use the function above call this before releasing their
+// context.
+void release_device_random(cl_context context);
+
+#endif // HARNESS_DEVICE_RANDOM_H_
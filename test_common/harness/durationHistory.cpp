@@ -0,0 +1,239 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "durationHistory.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <fstream>
+#include <mutex>
+
+namespace {
+
+std::mutex gKeyMutex;
+std::string gSuite;
+std::string gMode;
+double gCoverage = 1.0;
+
+// Tabs and newlines would split a field
+std::string field(const std::string &s)
+{
+    std::string out = s;
+    for (char &c : out)
+        if (c == '\t' || c == '\n' || c == '\r') c = ' ';
+    return out;
+}
+
+std::string join(const std::string &device, const std::string &suite,
+                 const std::string &mode, const std::string &test)
+{
+    return device + "\t" + suite + "\t" + mode + "\t" + test;
+}
+
+bool split(const std::string &line, std::vector<std::string> &fields)
+{
+    fields.clear();
+    size_t begin = 0;
+    for (;;)
+    {
+        size_t end = line.find('\t', begin);
+        fields.push_back(line.substr(begin, end - begin));
+        if (end == std::string::npos) break;
+        begin = end + 1;
+    }
+    return fields.size() == 7;
+}
+
+} // anonymous namespace
+
+bool DurationHistory::Load(const std::string &fileName)
+{
+    std::ifstream file(fileName);
+    if (!file) return true;
+
+    std::string line;
+    std::vector<std::string> fields;
+    while (std::getline(file, line))
+    {
+        // A line cut short by a crash is skipped rather than misread
+        char *end;
+        double coverage, seconds;
+        if (!split(line, fields)
+            || (coverage = strtod(fields[5].c_str(), &end), *end != '\0')
+            || (seconds = strtod(fields[6].c_str(), &end), *end != '\0')
+            || coverage <= 0 || seconds < 0)
+            continue;
+
+        Sample sample = { seconds, m_lines++ };
+        m_tests[join(fields[1], fields[2], fields[4], fields[3])][coverage] =
+            sample;
+        m_suites[fields[2]][fields[3]] = sample;
+    }
+    return true;
+}
+
+bool DurationHistory::Append(const std::string &fileName,
+                             const std::vector<DurationRecord> &records)
+{
+    if (records.empty()) return true;
+
+    std::string lines;
+    char number[64];
+    long long now = (long long)time(NULL);
+    for (const DurationRecord &record : records)
+    {
+        snprintf(number, sizeof(number), "%lld", now);
+        lines += number;
+        lines += "\t" + field(record.device) + "\t" + field(record.suite) + "\t"
+            + field(record.test) + "\t" + field(record.mode) + "\t";
+        snprintf(number, sizeof(number), "%.9g\t%.3f\n", record.coverage,
+                 record.seconds);
+        lines += number;
+    }
+
+    FILE *file = fopen(fileName.c_str(), "ab");
+    if (file == NULL) return false;
+    setvbuf(file, NULL, _IOFBF, lines.size());
+    bool written = fwrite(lines.data(), 1, lines.size(), file) == lines.size();
+    return fclose(file) == 0 && written;
+}
+
+double DurationHistory::Predict(const std::string &device,
+                                const std::string &suite,
+                                const std::string &mode,
+                                const std::string &test, double coverage) const
+{
+    auto it = m_tests.find(join(device, suite, mode, test));
+    if (it == m_tests.end()) return -1;
+    const Samples &samples = it->second;
+
+    auto exact = samples.find(coverage);
+    if (exact != samples.end()) return exact->second.seconds;
+
+    double n = 0, sumC = 0, sumT = 0, sumCC = 0, sumCT = 0;
+    for (const auto &sample : samples)
+    {
+        double c = sample.first, t = sample.second.seconds;
+        n++;
+        sumC += c;
+        sumT += t;
+        sumCC += c * c;
+        sumCT += c * t;
+    }
+
+    // Proportional to the coverage through the only run there is, and
+    // through the runs there are if the fit has a negative setup time
+    double proportional = sumCT / sumCC * coverage;
+    if (samples.size() < 2) return proportional;
+
+    double denominator = n * sumCC - sumC * sumC;
+    if (denominator <= 0) return proportional;
+    double rate = (n * sumCT - sumC * sumT) / denominator;
+    double setup = (sumT - rate * sumC) / n;
+    // Noise can make a test look slower at lower coverage, in which case
+    // all that can be said is how long it usually takes
+    if (rate < 0) return sumT / n;
+    if (setup < 0) return proportional;
+    return setup + rate * coverage;
+}
+
+double DurationHistory::SuiteSeconds(const std::string &suite) const
+{
+    auto it = m_suites.find(suite);
+    if (it == m_suites.end()) return -1;
+    double seconds = 0;
+    for (const auto &test : it->second) seconds += test.second.seconds;
+    return seconds;
+}
+
+void set_duration_key(const std::string &suite, const std::string &mode,
+                      double coverage)
+{
+    std::lock_guard<std::mutex> lock(gKeyMutex);
+    gSuite = suite;
+    gMode = mode;
+    gCoverage = coverage;
+}
+
+void get_duration_key(std::string &suite, std::string &mode, double &coverage)
+{
+    std::lock_guard<std::mutex> lock(gKeyMutex);
+    suite = gSuite;
+    mode = gMode;
+    coverage = gCoverage;
+}
+
+bool parse_duration(const char *text, double &seconds)
+{
+    seconds = 0;
+    const char *p = text;
+    if (*p == '\0') return false;
+    while (*p != '\0')
+    {
+        char *end;
+        double value = strtod(p, &end);
+        if (end == p || value < 0) return false;
+        p = end;
+        switch (tolower(*p))
+        {
+            case 'h': value *= 3600; p++; break;
+            case 'm': value *= 60; p++; break;
+            case 's': p++; break;
+            case '\0': break;
+            default: return false;
+        }
+        seconds += value;
+    }
+    return seconds > 0;
+}
+
+bool choose_wimpy_for_budget(const DurationHistory &history,
+                             const std::string &device,
+                             const std::string &suite, const std::string &mode,
+                             const std::vector<std::string> &tests,
+                             double budgetSeconds,
+                             double (*coverage)(bool wimpyMode,
+                                                int reductionFactor),
+                             int maxReductionFactor, WimpyChoice &choice)
+{
+    // From the largest coverage down, the full tests then wimpy mode with
+    // ever larger reduction factors
+    std::vector<WimpyChoice> candidates;
+    candidates.push_back({ false, 1, 0, 0 });
+    for (int factor = 1; factor <= maxReductionFactor; factor *= 2)
+        candidates.push_back({ true, factor, 0, 0 });
+
+    bool known = false;
+    for (WimpyChoice &candidate : candidates)
+    {
+        double c = coverage(candidate.wimpyMode, candidate.reductionFactor);
+        for (const std::string &test : tests)
+        {
+            double seconds = history.Predict(device, suite, mode, test, c);
+            if (seconds < 0)
+                candidate.unknownTests++;
+            else
+                candidate.seconds += seconds;
+        }
+        known |= candidate.unknownTests < tests.size();
+        choice = candidate;
+        if (known && candidate.seconds <= budgetSeconds) return true;
+    }
+    return false;
+}
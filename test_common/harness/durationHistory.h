@@ -0,0 +1,115 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef HARNESS_DURATION_HISTORY_H_
+#define HARNESS_DURATION_HISTORY_H_
+
+#include <stddef.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+// Wall times of earlier test runs. If CL_CONFORMANCE_DURATION_DB is set, the
+// harness appends the time of every test it ran to that file as lines of
+// timestamp<TAB>device<TAB>suite<TAB>test<TAB>mode<TAB>coverage<TAB>seconds
+// and the last line of each device, suite, test, mode and coverage is the one
+// that counts. The mode is whatever the suite uses to tell runs that do
+// different work apart, and the coverage the fraction of the full test that
+// was run, 1 unless the suite says otherwise.
+//
+// This file doesn't depend on OpenCL so that run_conformance can read the
+// database too.
+struct DurationRecord
+{
+    std::string device;
+    std::string suite;
+    std::string test;
+    std::string mode;
+    double coverage;
+    double seconds;
+};
+
+class DurationHistory {
+public:
+    // A missing file is an empty history
+    bool Load(const std::string &fileName);
+
+    // Add records to the end of the file in one write, so that suites run
+    // at the same time don't mix their lines
+    static bool Append(const std::string &fileName,
+                       const std::vector<DurationRecord> &records);
+
+    // The seconds test is expected to take at coverage, from a fit of
+    // seconds = setup + rate * coverage through the recorded runs, or
+    // negative if it has never run on device in mode
+    double Predict(const std::string &device, const std::string &suite,
+                   const std::string &mode, const std::string &test,
+                   double coverage) const;
+
+    // The sum of the last time recorded for each test of suite, on any
+    // device and in any mode, or negative if none are
+    double SuiteSeconds(const std::string &suite) const;
+
+private:
+    struct Sample
+    {
+        double seconds;
+        size_t order;
+    };
+    typedef std::map<double, Sample> Samples;
+    // device, suite, mode and test, joined by tabs
+    std::map<std::string, Samples> m_tests;
+    std::map<std::string, std::map<std::string, Sample>> m_suites;
+    size_t m_lines = 0;
+};
+
+// The suite name, mode and coverage the harness records the tests of this
+// run under. The suite defaults to the name of the binary.
+void set_duration_key(const std::string &suite, const std::string &mode,
+                      double coverage);
+void get_duration_key(std::string &suite, std::string &mode,
+                      double &coverage);
+
+// Parse a duration such as 90, 90s, 30m, 2h or 1h30m into seconds
+bool parse_duration(const char *text, double &seconds);
+
+// How a suite with a wimpy mode should run to fit a time budget
+struct WimpyChoice
+{
+    bool wimpyMode;
+    int reductionFactor;
+    // Expected time of the tests with a history
+    double seconds;
+    // Tests without a history, which aren't counted in seconds
+    size_t unknownTests;
+};
+
+// Pick the largest coverage of tests that is expected to fit in
+// budgetSeconds: the full tests if they fit, or else wimpy mode with the
+// smallest power of two reduction factor up to maxReductionFactor that does.
+// coverage gives the fraction of the full tests run for a mode and factor.
+// Gives false, with the smallest coverage in choice, if nothing fits or no
+// test has a history.
+bool choose_wimpy_for_budget(const DurationHistory &history,
+                             const std::string &device,
+                             const std::string &suite, const std::string &mode,
+                             const std::vector<std::string> &tests,
+                             double budgetSeconds,
+                             double (*coverage)(bool wimpyMode,
+                                                int reductionFactor),
+                             int maxReductionFactor, WimpyChoice &choice);
+
+#endif // HARNESS_DURATION_HISTORY_H_
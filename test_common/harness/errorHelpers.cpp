@@ -14,11 +14,19 @@
 // limitations under the License.
 //
 #include "compat.h"
+#include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include "errorHelpers.h"
 
@@ -27,6 +35,204 @@
 
 #include <CL/cl_half.h>
 
+static thread_local std::string *gLogCapture = nullptr;
+
+LogLevel gLogLevel = kLogLevelVerbose;
+
+namespace {
+
+// Interval at which the background thread writes out the buffered output
+const int kLogFlushIntervalMs = 50;
+// A thread writes its own output once this much is pending, so a thread
+// logging faster than the flusher keeps up doesn't grow without bound
+const size_t kLogMaxPending = 1 << 20;
+
+struct LogBuffer
+{
+    std::mutex lock;
+    std::string text;
+};
+
+class BufferedLog {
+public:
+    static BufferedLog *instance;
+
+    BufferedLog()
+        : stop(false), stopped(false), flusher(&BufferedLog::Run, this)
+    {}
+
+    void Append(const char *text, size_t length)
+    {
+        static thread_local std::shared_ptr<LogBuffer> buffer;
+        if (!buffer)
+        {
+            buffer = std::make_shared<LogBuffer>();
+            std::lock_guard<std::mutex> lock(buffersLock);
+            buffers.push_back(buffer);
+        }
+
+        std::lock_guard<std::mutex> lock(buffer->lock);
+        buffer->text.append(text, length);
+        if (buffer->text.size() >= kLogMaxPending || stopped) Write(*buffer);
+    }
+
+    // Write the pending text of every thread, one thread at a time
+    void Flush()
+    {
+        std::lock_guard<std::mutex> lock(buffersLock);
+        for (auto it = buffers.begin(); it != buffers.end();)
+        {
+            {
+                std::lock_guard<std::mutex> bufferLock((*it)->lock);
+                Write(**it);
+            }
+            // Only the list holds the buffers of threads that have exited
+            if (it->use_count() == 1)
+                it = buffers.erase(it);
+            else
+                ++it;
+        }
+        fflush(stdout);
+    }
+
+    void Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(stopLock);
+            stop = true;
+        }
+        stopCondition.notify_one();
+        flusher.join();
+        stopped = true;
+        Flush();
+    }
+
+private:
+    // Called with the buffer's lock held
+    void Write(LogBuffer &buffer)
+    {
+        if (buffer.text.empty()) return;
+        std::lock_guard<std::mutex> lock(writeLock);
+        fwrite(buffer.text.data(), 1, buffer.text.size(), stdout);
+        buffer.text.clear();
+    }
+
+    void Run()
+    {
+        std::unique_lock<std::mutex> lock(stopLock);
+        while (!stop)
+        {
+            stopCondition.wait_for(
+                lock, std::chrono::milliseconds(kLogFlushIntervalMs));
+            lock.unlock();
+            Flush();
+            lock.lock();
+        }
+    }
+
+    std::mutex buffersLock;
+    std::vector<std::shared_ptr<LogBuffer>> buffers;
+    std::mutex writeLock;
+    std::mutex stopLock;
+    std::condition_variable stopCondition;
+    bool stop;
+    // Output logged at exit after the flusher has stopped is not buffered
+    std::atomic<bool> stopped;
+    std::thread flusher;
+};
+
+BufferedLog *BufferedLog::instance = nullptr;
+
+void stop_log_buffering() { BufferedLog::instance->Stop(); }
+
+int log_vprintf(const char *format, va_list args)
+{
+    int ret;
+    if (gLogCapture == nullptr && BufferedLog::instance == nullptr)
+    {
+        ret = vprintf(format, args);
+    }
+    else
+    {
+        va_list argsCopy;
+        va_copy(argsCopy, args);
+        ret = vsnprintf(NULL, 0, format, argsCopy);
+        va_end(argsCopy);
+        if (ret > 0)
+        {
+            std::vector<char> text(ret + 1);
+            vsnprintf(text.data(), text.size(), format, args);
+            if (gLogCapture != nullptr)
+                gLogCapture->append(text.data(), ret);
+            else
+                BufferedLog::instance->Append(text.data(), ret);
+        }
+    }
+    return ret;
+}
+
+} // anonymous namespace
+
+int log_printf(const char *format, ...)
+{
+    if (gLogLevel < kLogLevelInfo) return 0;
+
+    va_list args;
+    va_start(args, format);
+    int ret = log_vprintf(format, args);
+    va_end(args);
+    return ret;
+}
+
+int log_verbose_printf(const char *format, ...)
+{
+    if (gLogLevel < kLogLevelVerbose) return 0;
+
+    va_list args;
+    va_start(args, format);
+    int ret = log_vprintf(format, args);
+    va_end(args);
+    return ret;
+}
+
+int log_error_printf(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int ret;
+    if (gLogCapture == nullptr && BufferedLog::instance != nullptr)
+    {
+        BufferedLog::instance->Flush();
+        ret = vprintf(format, args);
+        fflush(stdout);
+    }
+    else
+    {
+        ret = log_vprintf(format, args);
+    }
+    va_end(args);
+    return ret;
+}
+
+void log_buffering_begin()
+{
+    if (BufferedLog::instance != nullptr) return;
+
+    // Never destroyed, the flusher is stopped and the rest of the output
+    // written at exit
+    BufferedLog::instance = new BufferedLog();
+    atexit(stop_log_buffering);
+}
+
+void log_flush()
+{
+    if (BufferedLog::instance != nullptr) BufferedLog::instance->Flush();
+}
+
+void log_capture_begin(std::string *buffer) { gLogCapture = buffer; }
+
+void log_capture_end() { gLogCapture = nullptr; }
+
 const char *IGetErrorString(int clErrorCode)
 {
     switch (clErrorCode)
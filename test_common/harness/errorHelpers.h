@@ -28,18 +28,23 @@
 #define HIGHER_IS_BETTER 1
 
 #include <stdio.h>
+#include <string>
 #define test_start()
-#define log_info printf
-#define log_error printf
-#define log_missing_feature printf
+#define log_info log_printf
+#define log_error log_error_printf
+#define log_missing_feature log_printf
+// Print "Performance Number <name> (in <numType>, ...): <number>" and record
+// the number as a metric of the running test, see perfMetrics.h. The name is
+// built from format and the arguments that follow.
+#if defined(__GNUC__)
+__attribute__((format(printf, 4, 5)))
+#endif
+void log_perf_metric(double number, bool higherBetter, const char *numType,
+                     const char *format, ...);
 #define log_perf(_number, _higherBetter, _numType, _format, ...)               \
-    printf("Performance Number " _format " (in %s, %s): %g\n", ##__VA_ARGS__,  \
-           _numType, _higherBetter ? "higher is better" : "lower is better",   \
-           _number)
-#define vlog_perf(_number, _higherBetter, _numType, _format, ...)              \
-    printf("Performance Number " _format " (in %s, %s): %g\n", ##__VA_ARGS__,  \
-           _numType, _higherBetter ? "higher is better" : "lower is better",   \
-           _number)
+    log_perf_metric((double)(_number), (_higherBetter) != 0, _numType,         \
+                    _format, ##__VA_ARGS__)
+#define vlog_perf log_perf
 #ifdef _WIN32
 #ifdef __MINGW32__
 // Use __mingw_printf since it supports "%a" format specifier
@@ -52,9 +57,58 @@ static int vlog_win32(const char *format, ...);
 #define vlog_error vlog_win32
 #endif
 #else
-#define vlog_error printf
-#define vlog printf
+#define vlog_error log_error_printf
+#define vlog log_verbose_printf
+#endif
+
+// How much of the log_info and vlog output gets printed, set with
+// --log-level. Errors are always printed.
+enum LogLevel
+{
+    kLogLevelError = 0,
+    kLogLevelInfo,
+    kLogLevelVerbose
+};
+extern LogLevel gLogLevel;
+
+// Same as printf, unless the calling thread is capturing its output with
+// log_capture_begin, in which case the text is appended to the capture buffer,
+// or the log is buffered (see log_buffering_begin). Prints nothing below the
+// info log level.
+#if defined(__GNUC__)
+__attribute__((format(printf, 1, 2)))
+#endif
+int log_printf(const char *format, ...);
+
+// log_printf for vlog, printing nothing below the verbose log level
+#if defined(__GNUC__)
+__attribute__((format(printf, 1, 2)))
+#endif
+int log_verbose_printf(const char *format, ...);
+
+// log_printf for log_error: when the log is buffered, everything logged
+// before is written out first and the error is written straight away, so an
+// error always appears after the output that led up to it.
+#if defined(__GNUC__)
+__attribute__((format(printf, 1, 2)))
 #endif
+int log_error_printf(const char *format, ...);
+
+// Buffer the output of log_printf and friends per thread instead of writing
+// it to stdout on every call, so that busy threads don't contend on the stdio
+// lock. A background thread writes each thread's pending text out in one
+// piece every few milliseconds, keeping the messages of a thread together
+// and in order. Output still pending when the process crashes is lost.
+void log_buffering_begin();
+
+// Write out all buffered output now
+void log_flush();
+
+// Capture the log_info and log_error output of the calling thread into buffer
+// until log_capture_end is called. Used to keep the output of tests running
+// in parallel apart.
+void log_capture_begin(std::string *buffer);
+void log_capture_end();
 
 #define test_fail(msg, ...)                                                    \
     {                                                                          \
@@ -0,0 +1,33 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef HARNESS_EVENT_HELPERS_H_
+#define HARNESS_EVENT_HELPERS_H_
+
+#include <CL/opencl.h>
+
+// Give one event for everything enqueued on queue so far, for a chain of
+// commands of which only the end is waited for. Asking every command of the
+// chain for an event costs an event allocation and release each, which
+// shows on the host in loops that enqueue many small commands.
+//
+// A marker without a wait list waits for all the commands before it, on an
+// out-of-order queue too.
+inline cl_int enqueue_chain_end(cl_command_queue queue, cl_event *event)
+{
+    return clEnqueueMarkerWithWaitList(queue, 0, NULL, event);
+}
+
+#endif // HARNESS_EVENT_HELPERS_H_
@@ -14,6 +14,7 @@
 // limitations under the License.
 //
 #include "featureHelpers.h"
+#include "deviceInfo.h"
 #include "errorHelpers.h"
 
 #include <assert.h>
@@ -33,16 +34,15 @@ int get_device_cl_c_features(cl_device_id device, OpenCLCFeatures& features)
         return TEST_PASS;
     }
 
-    cl_int error = CL_SUCCESS;
-
-    size_t sz = 0;
-    error = clGetDeviceInfo(device, CL_DEVICE_OPENCL_C_FEATURES, 0, NULL, &sz);
-    test_error(error, "Unable to query CL_DEVICE_OPENCL_C_FEATURES size");
-
-    std::vector<cl_name_version> clc_features(sz / sizeof(cl_name_version));
-    error = clGetDeviceInfo(device, CL_DEVICE_OPENCL_C_FEATURES, sz,
-                            clc_features.data(), NULL);
-    test_error(error, "Unable to query CL_DEVICE_OPENCL_C_FEATURES");
+    auto snapshot = get_device_snapshot(device);
+    const std::vector<cl_name_version>* feature_list =
+        snapshot->NameVersions(CL_DEVICE_OPENCL_C_FEATURES);
+    if (feature_list == nullptr)
+    {
+        log_error("ERROR: Unable to query CL_DEVICE_OPENCL_C_FEATURES\n");
+        return TEST_FAIL;
+    }
+    const std::vector<cl_name_version>& clc_features = *feature_list;
 
 #define CHECK_OPENCL_C_FEATURE(_feature)                                       \
     if (strcmp(clc_feature.name, #_feature) == 0)                              \
@@ -121,6 +121,65 @@ inline void RestoreFPState(FPU_mode_type *mode)
 #error RestoreFPState needs an implementation
 #endif
 }
+
+// Whether the reference hardware already is in FTZ mode if ftz is set, or out
+// of it if not. Reading the state is much cheaper than writing it.
+inline bool FTZModeIs(bool ftz)
+{
+#if defined(__i386__) || defined(__x86_64__) || defined(_MSC_VER)              \
+    || defined(__MINGW32__)
+    return (_mm_getcsr() & 0x8040) == (ftz ? 0x8040u : 0u);
+#elif defined(__PPC__)
+    return ((fpu_control & _FPU_MASK_NI) != 0) == ftz;
+#elif defined(__arm__)
+    unsigned fpscr;
+    __asm__ volatile("fmrx %0, fpscr" : "=r"(fpscr));
+    return ((fpscr & (1U << 24)) != 0) == ftz;
+#elif defined(__aarch64__)
+    uint64_t fpscr;
+    __asm__ volatile("mrs %0, fpcr" : "=r"(fpscr));
+    return ((fpscr & (1U << 24)) != 0) == ftz;
+#else
+    // No way to tell, so always set it
+    return false;
+#endif
+}
+
+enum FTZSetting
+{
+    kKeepFTZ,
+    kForceFTZ,
+    kDisableFTZ
+};
+
+// Puts the reference hardware in or out of FTZ mode for the life of the
+// object, and back as it was afterwards. Meant to be set once around a whole
+// job or reference loop: nothing is written when the thread already is in the
+// mode asked for, so a guard nested inside one that set the same mode only
+// costs a read.
+class FPStateGuard {
+public:
+    explicit FPStateGuard(FTZSetting setting): m_oldMode(0), m_changed(false)
+    {
+        if (setting == kKeepFTZ || FTZModeIs(setting == kForceFTZ)) return;
+        if (setting == kForceFTZ)
+            ForceFTZ(&m_oldMode);
+        else
+            DisableFTZ(&m_oldMode);
+        m_changed = true;
+    }
+    ~FPStateGuard()
+    {
+        if (m_changed) RestoreFPState(&m_oldMode);
+    }
+
+private:
+    FPStateGuard(const FPStateGuard &) = delete;
+    FPStateGuard &operator=(const FPStateGuard &) = delete;
+
+    FPU_mode_type m_oldMode;
+    bool m_changed;
+};
 #else
 #error ForceFTZ and RestoreFPState need implentations
 #endif
@@ -0,0 +1,216 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "hostAlloc.h"
+
+#include "alloc.h"
+#include "errorHelpers.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+
+#if defined(__linux__) && !defined(__ANDROID__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define HOST_ALLOC_LINUX 1
+#endif
+
+namespace {
+
+struct HostAllocPolicy
+{
+    bool thp = false;
+    bool hugetlb = false;
+    bool interleave = false;
+};
+
+const HostAllocPolicy &policy()
+{
+    static const HostAllocPolicy parsed = [] {
+        HostAllocPolicy p;
+        const char *env = getenv("CL_TEST_HOST_ALLOC");
+        if (env == NULL) return p;
+        std::string list = env;
+        size_t begin = 0;
+        while (begin <= list.size())
+        {
+            size_t end = list.find(',', begin);
+            if (end == std::string::npos) end = list.size();
+            std::string option = list.substr(begin, end - begin);
+            if (option == "thp")
+                p.thp = true;
+            else if (option == "hugetlb")
+                p.hugetlb = true;
+            else if (option == "interleave")
+                p.interleave = true;
+            else if (!option.empty())
+                log_error("Warning: Unknown CL_TEST_HOST_ALLOC option %s\n",
+                          option.c_str());
+            begin = end + 1;
+        }
+        return p;
+    }();
+    return parsed;
+}
+
+#if defined(HOST_ALLOC_LINUX)
+const size_t kHugePageSize = 2 << 20;
+
+// From linux/mempolicy.h, which libc doesn't wrap
+const int kMpolInterleave = 3;
+const size_t kMaxNodes = 1024;
+const size_t kBitsPerWord = sizeof(unsigned long) * 8;
+
+struct NodeMask
+{
+    unsigned long words[kMaxNodes / kBitsPerWord] = {};
+    int count = 0;
+};
+
+// The online NUMA nodes, from a sysfs list such as "0-3,8"
+const NodeMask &online_nodes()
+{
+    static const NodeMask nodes = [] {
+        NodeMask mask;
+        char list[4096];
+        FILE *fp = fopen("/sys/devices/system/node/online", "r");
+        if (fp == NULL) return mask;
+        const char *p = fgets(list, sizeof(list), fp);
+        fclose(fp);
+        while (p != NULL && *p)
+        {
+            char *next;
+            long first = strtol(p, &next, 10);
+            if (next == p) break;
+            long last = first;
+            if (*next == '-') last = strtol(next + 1, &next, 10);
+            for (long node = first; node <= last && node < (long)kMaxNodes;
+                 node++)
+            {
+                mask.words[node / kBitsPerWord] |= 1UL << (node % kBitsPerWord);
+                mask.count++;
+            }
+            p = *next == ',' ? next + 1 : NULL;
+        }
+        return mask;
+    }();
+    return nodes;
+}
+
+// Buffers from the hugetlbfs pool, which are freed with munmap
+std::mutex gMappedMutex;
+std::map<void *, size_t> gMapped;
+
+size_t round_up(size_t size, size_t multiple)
+{
+    return (size + multiple - 1) / multiple * multiple;
+}
+
+void *map_hugetlb(size_t size, size_t alignment)
+{
+    if (alignment > kHugePageSize) return NULL;
+    size = round_up(size, kHugePageSize);
+    void *ptr = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (ptr == MAP_FAILED) return NULL;
+    std::lock_guard<std::mutex> lock(gMappedMutex);
+    gMapped[ptr] = size;
+    return ptr;
+}
+
+void interleave(void *ptr, size_t size)
+{
+    const NodeMask &nodes = online_nodes();
+    if (nodes.count < 2) return;
+    // The pages aren't touched yet, so this decides where they will fault in
+    if (syscall(SYS_mbind, ptr, size, kMpolInterleave, nodes.words,
+                kMaxNodes + 1, 0)
+        != 0)
+    {
+        static std::once_flag warned;
+        std::call_once(warned, [] {
+            log_error("Warning: mbind failed, host buffers will not be "
+                      "interleaved\n");
+        });
+    }
+}
+#endif
+
+} // anonymous namespace
+
+void *host_buffer_alloc(size_t size, size_t alignment)
+{
+#if defined(HOST_ALLOC_LINUX)
+    const HostAllocPolicy &p = policy();
+    void *ptr = NULL;
+    size_t mapped = round_up(size, kHugePageSize);
+    if (p.hugetlb) ptr = map_hugetlb(size, alignment);
+    if (ptr == NULL && (p.thp || p.hugetlb || p.interleave))
+    {
+        // Whole huge pages, so that neither madvise nor mbind reaches into
+        // memory the allocation doesn't own
+        if (alignment < kHugePageSize) alignment = kHugePageSize;
+        if (posix_memalign(&ptr, alignment, mapped) != 0) return NULL;
+        if (p.thp || p.hugetlb) madvise(ptr, mapped, MADV_HUGEPAGE);
+    }
+    if (ptr != NULL)
+    {
+        if (p.interleave) interleave(ptr, mapped);
+        return ptr;
+    }
+#endif
+    return align_malloc(size, alignment);
+}
+
+void host_buffer_free(void *ptr)
+{
+    if (ptr == NULL) return;
+#if defined(HOST_ALLOC_LINUX)
+    {
+        std::lock_guard<std::mutex> lock(gMappedMutex);
+        auto it = gMapped.find(ptr);
+        if (it != gMapped.end())
+        {
+            munmap(ptr, it->second);
+            gMapped.erase(it);
+            return;
+        }
+    }
+#endif
+    align_free(ptr);
+}
+
+void host_buffer_log_policy()
+{
+    const HostAllocPolicy &p = policy();
+    if (!p.thp && !p.hugetlb && !p.interleave) return;
+#if defined(HOST_ALLOC_LINUX)
+    log_info("Host buffers:%s%s%s\n", p.hugetlb ? " hugetlb" : "",
+             p.thp ? " thp" : "",
+             p.interleave && online_nodes().count > 1
+                 ? " interleaved"
+                 : (p.interleave ? " (one NUMA node, not interleaved)" : ""));
+#else
+    log_info("Host buffers: CL_TEST_HOST_ALLOC is not supported on this "
+             "system\n");
+#endif
+}
@@ -0,0 +1,42 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef HARNESS_HOST_ALLOC_H_
+#define HARNESS_HOST_ALLOC_H_
+
+#include <stddef.h>
+
+// Allocation of the large, long lived host buffers of a suite, such as the
+// input and reference buffers of math_brute_force. By default these are
+// plain align_malloc allocations. CL_TEST_HOST_ALLOC in the environment
+// takes a comma separated list of
+//
+//   thp         back the buffers with transparent huge pages
+//   hugetlb     back the buffers with pages from the hugetlbfs pool, falling
+//               back to transparent huge pages when the pool is too small
+//   interleave  spread the pages of each buffer over the NUMA nodes
+//
+// to cut the TLB misses and remote memory traffic of the host reference
+// code. Options that aren't supported by the system are ignored with a
+// warning.
+void *host_buffer_alloc(size_t size, size_t alignment);
+
+// Free a buffer from host_buffer_alloc
+void host_buffer_free(void *ptr);
+
+// Log the options in effect, if any
+void host_buffer_log_policy();
+
+#endif // HARNESS_HOST_ALLOC_H_
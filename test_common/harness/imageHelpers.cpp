@@ -14,6 +14,9 @@
 // limitations under the License.
 //
 #include "imageHelpers.h"
+#include "ThreadPool.h"
+#include "bufferSizing.h"
+#include "crc32.h"
 #include <limits.h>
 #include <assert.h>
 #if defined(__APPLE__)
@@ -23,8 +26,12 @@
 #include <malloc.h>
 #endif
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cinttypes>
 #include <iterator>
+#include <list>
+#include <mutex>
 #if !defined(_WIN32)
 #include <cmath>
 #endif
@@ -68,6 +75,30 @@ double sRGBunmap(float fc)
     return result;
 }
 
+// The references decode every sRGB texel they sample, and pow dominates that,
+// so the 256 possible results are computed once
+static inline float sRGB_decode(cl_uchar value)
+{
+    static const std::array<float, 256> table = [] {
+        std::array<float, 256> t;
+        for (size_t i = 0; i < t.size(); i++)
+            t[i] = (float)sRGBunmap((float)i / 255.0f);
+        return t;
+    }();
+    return table[value];
+}
+
+const float *half_to_float_table()
+{
+    static const std::vector<float> table = [] {
+        std::vector<float> t(1 << 16);
+        for (size_t i = 0; i < t.size(); i++)
+            t[i] = cl_half_to_float((cl_half)i);
+        return t;
+    }();
+    return table.data();
+}
+
 
 uint32_t get_format_type_size(const cl_image_format *format)
 {
@@ -316,15 +347,16 @@ int get_8_bit_image_format(cl_context context, cl_mem_object_type objType,
                            cl_mem_flags flags, size_t channelCount,
                            cl_image_format *outFormat)
 {
-    cl_image_format formatList[128];
-    unsigned int outFormatCount, i;
+    std::vector<cl_image_format> formatList;
+    size_t outFormatCount, i;
     int error;
 
 
     /* Make sure each image format is supported */
-    if ((error = clGetSupportedImageFormats(context, flags, objType, 128,
-                                            formatList, &outFormatCount)))
+    if ((error = get_supported_image_formats(context, flags, objType,
+                                             formatList)))
         return error;
+    outFormatCount = formatList.size();
 
 
     /* Look for one that is an 8-bit format */
@@ -353,15 +385,16 @@ int get_32_bit_image_format(cl_context context, cl_mem_object_type objType,
                             cl_mem_flags flags, size_t channelCount,
                             cl_image_format *outFormat)
 {
-    cl_image_format formatList[128];
-    unsigned int outFormatCount, i;
+    std::vector<cl_image_format> formatList;
+    size_t outFormatCount, i;
     int error;
 
 
     /* Make sure each image format is supported */
-    if ((error = clGetSupportedImageFormats(context, flags, objType, 128,
-                                            formatList, &outFormatCount)))
+    if ((error = get_supported_image_formats(context, flags, objType,
+                                             formatList)))
         return error;
+    outFormatCount = formatList.size();
 
     /* Look for one that is an 8-bit format */
     for (i = 0; i < outFormatCount; i++)
@@ -497,6 +530,100 @@ size_t compare_scanlines(const image_descriptor *imageInfo, const char *aPtr,
     return column;
 }
 
+namespace {
+
+struct ScanlineCompareInfo
+{
+    const image_descriptor *imageInfo;
+    const char *aPtr;
+    size_t aRowPitch, aSlicePitch;
+    const char *bPtr;
+    size_t bRowPitch, bSlicePitch;
+    size_t scanlineSize;
+    size_t height;
+    size_t rowCount;
+    size_t rowsPerJob;
+    std::atomic<size_t> firstRow; // first differing row found so far
+};
+
+bool scanline_differs(const ScanlineCompareInfo &info, size_t row)
+{
+    size_t y = row % info.height, z = row / info.height;
+    const char *a = info.aPtr + z * info.aSlicePitch + y * info.aRowPitch;
+    const char *b = info.bPtr + z * info.bSlicePitch + y * info.bRowPitch;
+    return memcmp(a, b, info.scanlineSize) != 0
+        && compare_scanlines(info.imageInfo, a, b) < info.imageInfo->width;
+}
+
+cl_int compare_scanlines_job(cl_uint job_id, cl_uint thread_id, void *userInfo)
+{
+    ScanlineCompareInfo &info = *(ScanlineCompareInfo *)userInfo;
+    size_t start = (size_t)job_id * info.rowsPerJob;
+    size_t end = std::min(start + info.rowsPerJob, info.rowCount);
+
+    // Rows after a known difference can not change the result
+    for (size_t row = start; row < end && row < info.firstRow.load(); row++)
+    {
+        if (scanline_differs(info, row))
+        {
+            size_t first = info.firstRow.load();
+            while (row < first
+                   && !info.firstRow.compare_exchange_weak(first, row))
+            {
+            }
+            break;
+        }
+    }
+    return CL_SUCCESS;
+}
+
+} // anonymous namespace
+
+bool find_first_scanline_difference(const image_descriptor *imageInfo,
+                                    const char *aPtr, size_t aRowPitch,
+                                    size_t aSlicePitch, const char *bPtr,
+                                    size_t bRowPitch, size_t bSlicePitch,
+                                    size_t scanlineSize, size_t height,
+                                    size_t depth, size_t *outY, size_t *outZ,
+                                    size_t *outColumn)
+{
+    ScanlineCompareInfo info;
+    info.imageInfo = imageInfo;
+    info.aPtr = aPtr;
+    info.aRowPitch = aRowPitch;
+    info.aSlicePitch = aSlicePitch;
+    info.bPtr = bPtr;
+    info.bRowPitch = bRowPitch;
+    info.bSlicePitch = bSlicePitch;
+    info.scanlineSize = scanlineSize;
+    info.height = std::max(height, (size_t)1);
+    info.rowCount = info.height * std::max(depth, (size_t)1);
+    info.firstRow = info.rowCount;
+
+    // Give each job about 1MB to compare
+    info.rowsPerJob =
+        std::max((1 << 20) / std::max(scanlineSize, (size_t)1), (size_t)1);
+    size_t jobCount = (info.rowCount + info.rowsPerJob - 1) / info.rowsPerJob;
+    if (jobCount < 2 || ThreadPool_InWorker()
+        || ThreadPool_Do(compare_scanlines_job, (cl_uint)jobCount, &info)
+            != CL_SUCCESS)
+    {
+        info.rowsPerJob = info.rowCount;
+        info.firstRow = info.rowCount;
+        compare_scanlines_job(0, 0, &info);
+    }
+
+    size_t row = info.firstRow.load();
+    if (row == info.rowCount) return false;
+
+    *outY = row % info.height;
+    *outZ = row / info.height;
+    *outColumn = compare_scanlines(
+        imageInfo, aPtr + *outZ * aSlicePitch + *outY * aRowPitch,
+        bPtr + *outZ * bSlicePitch + *outY * bRowPitch);
+    return true;
+}
+
 int random_log_in_range(int minV, int maxV, MTdata d)
 {
     double v = log2(((double)genrand_int32(d) / (double)0xffffffff) + 1);
@@ -699,9 +826,13 @@ void get_max_sizes(
     }
 
     // Reduce the maximum because we are trying to test the max image
-    // dimensions, not the memory allocation
-    cl_ulong adjustedMaxTotalAllocSize = maxTotalAllocSize / 4;
-    cl_ulong adjustedMaxIndividualAllocSize = maxIndividualAllocSize / 4;
+    // dimensions, not the memory allocation. The host keeps copies of the
+    // images, so both memory budgets apply.
+    cl_ulong budget =
+        limit_to_host_mem_budget(limit_to_device_mem_budget(maxTotalAllocSize));
+    cl_ulong adjustedMaxTotalAllocSize = budget / 4;
+    cl_ulong adjustedMaxIndividualAllocSize =
+        std::min(maxIndividualAllocSize, budget) / 4;
     log_info("Note: max individual allocation adjusted down from %gMB to %gMB "
              "and max total allocation adjusted down from %gMB to %gMB.\n",
              maxIndividualAllocSize / (1024.0 * 1024.0),
@@ -1231,7 +1362,8 @@ char *generate_random_image_data(image_descriptor *imageInfo,
 
     // Otherwise, we should be able to just fill with random bits no matter what
     cl_uint *p = (cl_uint *)data;
-    for (i = 0; i + 4 <= allocSize; i += 4) p[i / 4] = genrand_int32(d);
+    genrand_fill(d, p, allocSize / 4);
+    i = allocSize & ~(size_t)3;
 
     for (; i < allocSize; i++) data[i] = genrand_int32(d);
 
@@ -1304,65 +1436,62 @@ char *generate_random_image_data(image_descriptor *imageInfo,
 
 #define CLAMP_FLOAT(v) (fmaxf(fminf(v, 1.f), -1.f))
 
+// Pixel decoding for read_image_pixel_float
+//
+// decode_pixel_float is written once against a description of the format.
+// PixelFormatStatic<Type, Order> makes the data type and channel order
+// compile time constants, which gives one straight-line decoder per format;
+// PixelFormatRuntime handles the formats without one.
 
-void read_image_pixel_float(void *imageData, image_descriptor *imageInfo, int x,
-                            int y, int z, float *outData, int lod)
+static constexpr uint32_t static_channel_count(cl_channel_order order)
 {
-    size_t width_lod = imageInfo->width, height_lod = imageInfo->height,
-           depth_lod = imageInfo->depth;
-    size_t slice_pitch_lod = 0, row_pitch_lod = 0;
+    return (order == CL_R || order == CL_A || order == CL_Rx
+            || order == CL_INTENSITY || order == CL_LUMINANCE
+            || order == CL_DEPTH)
+        ? 1
+        : (order == CL_RG || order == CL_RA || order == CL_RGx)
+            ? 2
+            : (order == CL_RGB || order == CL_RGBx || order == CL_sRGB
+               || order == CL_sRGBx)
+                ? 3
+                : 4;
+}
 
-    if (imageInfo->num_mip_levels > 1)
-    {
-        switch (imageInfo->type)
-        {
-            case CL_MEM_OBJECT_IMAGE3D:
-                depth_lod =
-                    (imageInfo->depth >> lod) ? (imageInfo->depth >> lod) : 1;
-            case CL_MEM_OBJECT_IMAGE2D:
-            case CL_MEM_OBJECT_IMAGE2D_ARRAY:
-                height_lod =
-                    (imageInfo->height >> lod) ? (imageInfo->height >> lod) : 1;
-            default:
-                width_lod =
-                    (imageInfo->width >> lod) ? (imageInfo->width >> lod) : 1;
-        }
-        row_pitch_lod = width_lod * get_pixel_size(imageInfo->format);
-        if (imageInfo->type == CL_MEM_OBJECT_IMAGE1D_ARRAY)
-            slice_pitch_lod = row_pitch_lod;
-        else if (imageInfo->type == CL_MEM_OBJECT_IMAGE3D
-                 || imageInfo->type == CL_MEM_OBJECT_IMAGE2D_ARRAY)
-            slice_pitch_lod = row_pitch_lod * height_lod;
-    }
-    else
-    {
-        row_pitch_lod = imageInfo->rowPitch;
-        slice_pitch_lod = imageInfo->slicePitch;
-    }
-    if (x < 0 || y < 0 || z < 0 || x >= (int)width_lod
-        || (height_lod != 0 && y >= (int)height_lod)
-        || (depth_lod != 0 && z >= (int)depth_lod)
-        || (imageInfo->arraySize != 0 && z >= (int)imageInfo->arraySize))
-    {
-        outData[0] = outData[1] = outData[2] = outData[3] = 0;
-        if (!has_alpha(imageInfo->format)) outData[3] = 1;
-        return;
-    }
+template <cl_channel_type Type, cl_channel_order Order>
+struct PixelFormatStatic
+{
+    static const cl_channel_type type = Type;
+    static const cl_channel_order order = Order;
+    static const size_t channelCount = static_channel_count(Order);
+    static const bool isSRGB = Order == CL_sRGB || Order == CL_sRGBx
+        || Order == CL_sRGBA || Order == CL_sBGRA;
+    const cl_image_format *format;
+};
 
-    const cl_image_format *format = imageInfo->format;
+struct PixelFormatRuntime
+{
+    explicit PixelFormatRuntime(const cl_image_format *format)
+        : type(format->image_channel_data_type),
+          order(format->image_channel_order),
+          channelCount(get_format_channel_count(format)),
+          isSRGB(is_sRGBA_order(format->image_channel_order)), format(format)
+    {}
+    cl_channel_type type;
+    cl_channel_order order;
+    size_t channelCount;
+    bool isSRGB;
+    const cl_image_format *format;
+};
 
+template <typename Format>
+static inline void decode_pixel_float(const Format &fmt, const char *ptr,
+                                      float *outData)
+{
+    // OpenCL only supports reading floats from certain formats
+    const size_t channelCount = fmt.channelCount;
     unsigned int i;
     float tempData[4];
-
-    // Advance to the right spot
-    char *ptr = (char *)imageData;
-    size_t pixelSize = get_pixel_size(format);
-
-    ptr += z * slice_pitch_lod + y * row_pitch_lod + x * pixelSize;
-
-    // OpenCL only supports reading floats from certain formats
-    size_t channelCount = get_format_channel_count(format);
-    switch (format->image_channel_data_type)
+    switch (fmt.type)
     {
         case CL_SNORM_INT8: {
             cl_char *dPtr = (cl_char *)ptr;
@@ -1375,9 +1504,9 @@ void read_image_pixel_float(void *imageData, image_descriptor *imageInfo, int x,
             unsigned char *dPtr = (unsigned char *)ptr;
             for (i = 0; i < channelCount; i++)
             {
-                if ((is_sRGBA_order(imageInfo->format->image_channel_order))
-                    && i < 3) // only RGB need to be converted for sRGBA
-                    tempData[i] = (float)sRGBunmap((float)dPtr[i] / 255.0f);
+                if (fmt.isSRGB && i < 3) // only RGB need to be converted for
+                                         // sRGBA
+                    tempData[i] = sRGB_decode(dPtr[i]);
                 else
                     tempData[i] = (float)dPtr[i] / 255.0f;
             }
@@ -1424,8 +1553,9 @@ void read_image_pixel_float(void *imageData, image_descriptor *imageInfo, int x,
 
         case CL_HALF_FLOAT: {
             cl_half *dPtr = (cl_half *)ptr;
+            const float *halfToFloat = half_to_float_table();
             for (i = 0; i < channelCount; i++)
-                tempData[i] = cl_half_to_float(dPtr[i]);
+                tempData[i] = halfToFloat[dPtr[i]];
             break;
         }
 
@@ -1484,7 +1614,7 @@ void read_image_pixel_float(void *imageData, image_descriptor *imageInfo, int x,
     outData[0] = outData[1] = outData[2] = 0;
     outData[3] = 1;
 
-    switch (format->image_channel_order)
+    switch (fmt.order)
     {
         case CL_A: outData[3] = tempData[0]; break;
         case CL_R:
@@ -1567,11 +1697,301 @@ void read_image_pixel_float(void *imageData, image_descriptor *imageInfo, int x,
         case CL_DEPTH: outData[0] = tempData[0]; break;
         default:
             log_error("Invalid format:");
-            print_header(format, true);
+            print_header(fmt.format, true);
             break;
     }
 }
 
+template <cl_channel_type Type, cl_channel_order Order>
+static void decode_pixel_float_static(const cl_image_format *format,
+                                      const char *ptr, float *outData)
+{
+    PixelFormatStatic<Type, Order> fmt = { format };
+    decode_pixel_float(fmt, ptr, outData);
+}
+
+static void decode_pixel_float_runtime(const cl_image_format *format,
+                                       const char *ptr, float *outData)
+{
+    decode_pixel_float(PixelFormatRuntime(format), ptr, outData);
+}
+
+typedef void (*PixelFloatDecoder)(const cl_image_format *format,
+                                  const char *ptr, float *outData);
+
+template <cl_channel_type Type>
+static PixelFloatDecoder get_pixel_float_decoder(cl_channel_order order)
+{
+    switch (order)
+    {
+#define DECODER_CASE(O)                                                        \
+    case O: return decode_pixel_float_static<Type, O>;
+        DECODER_CASE(CL_A)
+        DECODER_CASE(CL_R)
+        DECODER_CASE(CL_Rx)
+        DECODER_CASE(CL_RA)
+        DECODER_CASE(CL_RG)
+        DECODER_CASE(CL_RGx)
+        DECODER_CASE(CL_RGB)
+        DECODER_CASE(CL_RGBx)
+        DECODER_CASE(CL_sRGB)
+        DECODER_CASE(CL_sRGBx)
+        DECODER_CASE(CL_RGBA)
+        DECODER_CASE(CL_ARGB)
+        DECODER_CASE(CL_ABGR)
+        DECODER_CASE(CL_BGRA)
+        DECODER_CASE(CL_sBGRA)
+        DECODER_CASE(CL_INTENSITY)
+        DECODER_CASE(CL_LUMINANCE)
+        DECODER_CASE(CL_sRGBA)
+        DECODER_CASE(CL_DEPTH)
+#undef DECODER_CASE
+        default: return decode_pixel_float_runtime;
+    }
+}
+
+static PixelFloatDecoder get_pixel_float_decoder(const cl_image_format *format)
+{
+    cl_channel_order order = format->image_channel_order;
+    switch (format->image_channel_data_type)
+    {
+#define DECODER_CASE(T)                                                        \
+    case T: return get_pixel_float_decoder<T>(order);
+        DECODER_CASE(CL_SNORM_INT8)
+        DECODER_CASE(CL_UNORM_INT8)
+        DECODER_CASE(CL_SIGNED_INT8)
+        DECODER_CASE(CL_UNSIGNED_INT8)
+        DECODER_CASE(CL_SNORM_INT16)
+        DECODER_CASE(CL_UNORM_INT16)
+        DECODER_CASE(CL_SIGNED_INT16)
+        DECODER_CASE(CL_UNSIGNED_INT16)
+        DECODER_CASE(CL_HALF_FLOAT)
+        DECODER_CASE(CL_SIGNED_INT32)
+        DECODER_CASE(CL_UNSIGNED_INT32)
+        DECODER_CASE(CL_UNORM_SHORT_565)
+        DECODER_CASE(CL_UNORM_SHORT_555)
+        DECODER_CASE(CL_UNORM_INT_101010)
+        DECODER_CASE(CL_FLOAT)
+#undef DECODER_CASE
+        default: return decode_pixel_float_runtime;
+    }
+}
+
+struct PixelFloatCodec
+{
+    cl_channel_order order;
+    cl_channel_type type;
+    size_t pixelSize;
+    PixelFloatDecoder decode;
+};
+
+// Images are read pixel by pixel, so remember the codec of the last format
+// each thread used rather than looking it up for every pixel.
+static const PixelFloatCodec &
+get_pixel_float_codec(const cl_image_format *format)
+{
+    static thread_local PixelFloatCodec codec = { 0, 0, 0, NULL };
+    if (codec.decode == NULL || codec.order != format->image_channel_order
+        || codec.type != format->image_channel_data_type)
+    {
+        codec.order = format->image_channel_order;
+        codec.type = format->image_channel_data_type;
+        codec.pixelSize = get_pixel_size(format);
+        codec.decode = get_pixel_float_decoder(format);
+    }
+    return codec;
+}
+
+
+
+// Key of a decoded mip level: the level's layout and a checksum of its bytes,
+// with the bytes themselves kept to rule out collisions
+struct DecodedImageLevel
+{
+    cl_image_format format;
+    cl_mem_object_type type;
+    size_t width, height, depth, arraySize;
+    int lod;
+    uint32_t crc;
+    std::vector<char> bytes;
+    std::vector<float> texels;
+
+    size_t Footprint() const
+    {
+        return sizeof(*this) + bytes.size() + texels.size() * sizeof(float);
+    }
+};
+
+struct ActiveImageLevel
+{
+    const void *data;
+    int lod;
+    size_t pixelSize;
+    const DecodedImageLevel *level;
+    const ActiveImageLevel *previous;
+};
+
+size_t gImageLevelCacheSize = 256 * 1024 * 1024;
+
+namespace {
+
+std::mutex gImageLevelCacheMutex;
+// Most recently used first
+std::list<std::shared_ptr<const DecodedImageLevel>> gImageLevelCache;
+size_t gImageLevelCacheUsed = 0;
+// Per thread so that formats tested in parallel each see their own level
+thread_local const ActiveImageLevel *gActiveImageLevel = nullptr;
+
+bool same_level(const DecodedImageLevel &level, const DecodedImageLevel &key)
+{
+    return level.format.image_channel_order == key.format.image_channel_order
+        && level.format.image_channel_data_type
+        == key.format.image_channel_data_type
+        && level.type == key.type && level.width == key.width
+        && level.height == key.height && level.depth == key.depth
+        && level.arraySize == key.arraySize && level.lod == key.lod
+        && level.crc == key.crc && level.bytes == key.bytes;
+}
+
+} // anonymous namespace
+
+ImageLevelReference::ImageLevelReference(const void *levelData,
+                                         image_descriptor *imageInfo, int lod)
+{
+    // Only mipmapped images have levels without padding between rows
+    if (gImageLevelCacheSize == 0 || imageInfo->num_mip_levels <= 1) return;
+
+    size_t size = compute_mip_level_offset(imageInfo, lod + 1)
+        - compute_mip_level_offset(imageInfo, lod);
+    const char *data = (const char *)levelData;
+
+    std::shared_ptr<DecodedImageLevel> key =
+        std::make_shared<DecodedImageLevel>();
+    key->format = *imageInfo->format;
+    key->type = imageInfo->type;
+    key->width = imageInfo->width;
+    key->height = imageInfo->height;
+    key->depth = imageInfo->depth;
+    key->arraySize = imageInfo->arraySize;
+    key->lod = lod;
+    key->crc = crc32(data, size);
+    key->bytes.assign(data, data + size);
+
+    std::lock_guard<std::mutex> lock(gImageLevelCacheMutex);
+    for (auto it = gImageLevelCache.begin(); it != gImageLevelCache.end(); ++it)
+    {
+        if (same_level(**it, *key))
+        {
+            gImageLevelCache.splice(gImageLevelCache.begin(), gImageLevelCache,
+                                    it);
+            m_level = *it;
+            break;
+        }
+    }
+
+    if (!m_level)
+    {
+        const PixelFloatCodec &codec = get_pixel_float_codec(imageInfo->format);
+        size_t pixels = size / codec.pixelSize;
+        key->texels.resize(4 * pixels);
+        for (size_t i = 0; i < pixels; i++)
+            codec.decode(imageInfo->format, data + i * codec.pixelSize,
+                         &key->texels[4 * i]);
+        m_level = key;
+
+        // A level larger than the whole budget is only used for this scope
+        if (key->Footprint() <= gImageLevelCacheSize)
+        {
+            gImageLevelCache.push_front(m_level);
+            gImageLevelCacheUsed += key->Footprint();
+            while (gImageLevelCacheUsed > gImageLevelCacheSize)
+            {
+                gImageLevelCacheUsed -= gImageLevelCache.back()->Footprint();
+                gImageLevelCache.pop_back();
+            }
+        }
+    }
+
+    m_active.reset(new ActiveImageLevel);
+    m_active->data = levelData;
+    m_active->lod = lod;
+    m_active->pixelSize = get_pixel_size(imageInfo->format);
+    m_active->level = m_level.get();
+    m_active->previous = gActiveImageLevel;
+    gActiveImageLevel = m_active.get();
+}
+
+ImageLevelReference::~ImageLevelReference()
+{
+    if (m_active) gActiveImageLevel = m_active->previous;
+}
+
+void read_image_pixel_float(void *imageData, image_descriptor *imageInfo, int x,
+                            int y, int z, float *outData, int lod)
+{
+    size_t width_lod = imageInfo->width, height_lod = imageInfo->height,
+           depth_lod = imageInfo->depth;
+    size_t slice_pitch_lod = 0, row_pitch_lod = 0;
+
+    if (imageInfo->num_mip_levels > 1)
+    {
+        switch (imageInfo->type)
+        {
+            case CL_MEM_OBJECT_IMAGE3D:
+                depth_lod =
+                    (imageInfo->depth >> lod) ? (imageInfo->depth >> lod) : 1;
+            case CL_MEM_OBJECT_IMAGE2D:
+            case CL_MEM_OBJECT_IMAGE2D_ARRAY:
+                height_lod =
+                    (imageInfo->height >> lod) ? (imageInfo->height >> lod) : 1;
+            default:
+                width_lod =
+                    (imageInfo->width >> lod) ? (imageInfo->width >> lod) : 1;
+        }
+        row_pitch_lod = width_lod * get_pixel_size(imageInfo->format);
+        if (imageInfo->type == CL_MEM_OBJECT_IMAGE1D_ARRAY)
+            slice_pitch_lod = row_pitch_lod;
+        else if (imageInfo->type == CL_MEM_OBJECT_IMAGE3D
+                 || imageInfo->type == CL_MEM_OBJECT_IMAGE2D_ARRAY)
+            slice_pitch_lod = row_pitch_lod * height_lod;
+    }
+    else
+    {
+        row_pitch_lod = imageInfo->rowPitch;
+        slice_pitch_lod = imageInfo->slicePitch;
+    }
+    if (x < 0 || y < 0 || z < 0 || x >= (int)width_lod
+        || (height_lod != 0 && y >= (int)height_lod)
+        || (depth_lod != 0 && z >= (int)depth_lod)
+        || (imageInfo->arraySize != 0 && z >= (int)imageInfo->arraySize))
+    {
+        outData[0] = outData[1] = outData[2] = outData[3] = 0;
+        if (!has_alpha(imageInfo->format)) outData[3] = 1;
+        return;
+    }
+
+    size_t offset = z * slice_pitch_lod + y * row_pitch_lod;
+    const ActiveImageLevel *active = gActiveImageLevel;
+    if (active && active->data == imageData && active->lod == lod)
+    {
+        size_t index = offset / active->pixelSize + x;
+        if (4 * index < active->level->texels.size())
+        {
+            memcpy(outData, &active->level->texels[4 * index],
+                   4 * sizeof(float));
+            return;
+        }
+    }
+
+    // Advance to the right spot
+    char *ptr = (char *)imageData;
+    const PixelFloatCodec &codec = get_pixel_float_codec(imageInfo->format);
+
+    ptr += offset + x * codec.pixelSize;
+
+    codec.decode(imageInfo->format, ptr, outData);
+}
+
 void read_image_pixel_float(void *imageData, image_descriptor *imageInfo, int x,
                             int y, int z, float *outData)
 {
@@ -2315,6 +2735,72 @@ FloatPixel sample_image_pixel_float_offset(
         zAddressOffset, imageSampler, outData, verbose, containsDenorms, 0);
 }
 
+namespace {
+
+struct SampleBatchInfo
+{
+    void *imageData;
+    image_descriptor *imageInfo;
+    const float *x, *y, *z;
+    size_t count;
+    float xAddressOffset, yAddressOffset, zAddressOffset;
+    image_sampler_data *imageSampler;
+    float *outData;
+    FloatPixel *maxPixels;
+    int *containsDenorms;
+    int lod;
+};
+
+const size_t kSampleTileSize = 256;
+
+void sample_image_pixels_tile(const SampleBatchInfo &info, size_t start,
+                              size_t end)
+{
+    for (size_t i = start; i < end; i++)
+    {
+        info.maxPixels[i] = sample_image_pixel_float_offset(
+            info.imageData, info.imageInfo, info.x[i], info.y[i],
+            info.z ? info.z[i] : 0.0f, info.xAddressOffset,
+            info.yAddressOffset, info.zAddressOffset, info.imageSampler,
+            info.outData + 4 * i, 0, &info.containsDenorms[i], info.lod);
+    }
+}
+
+cl_int sample_image_pixels_job(cl_uint job_id, cl_uint thread_id,
+                               void *userInfo)
+{
+    const SampleBatchInfo &info = *(const SampleBatchInfo *)userInfo;
+    size_t start = (size_t)job_id * kSampleTileSize;
+    sample_image_pixels_tile(info, start,
+                             std::min(start + kSampleTileSize, info.count));
+    return CL_SUCCESS;
+}
+
+} // anonymous namespace
+
+void sample_image_pixels_float_offset(
+    void *imageData, image_descriptor *imageInfo, const float *x,
+    const float *y, const float *z, size_t count, float xAddressOffset,
+    float yAddressOffset, float zAddressOffset,
+    image_sampler_data *imageSampler, float *outData, FloatPixel *maxPixels,
+    int *containsDenorms, int lod)
+{
+    SampleBatchInfo info = { imageData,      imageInfo,      x,
+                             y,              z,              count,
+                             xAddressOffset, yAddressOffset, zAddressOffset,
+                             imageSampler,   outData,        maxPixels,
+                             containsDenorms, lod };
+
+    // Not worth waking up the thread pool for a single tile, and a caller
+    // that is already a pool job can only sample serially
+    size_t tileCount = (count + kSampleTileSize - 1) / kSampleTileSize;
+    if (tileCount > 1 && !ThreadPool_InWorker()
+        && ThreadPool_Do(sample_image_pixels_job, (cl_uint)tileCount, &info)
+            == CL_SUCCESS)
+        return;
+
+    sample_image_pixels_tile(info, 0, count);
+}
 
 int debug_find_vector_in_image(void *imagePtr, image_descriptor *imageInfo,
                                void *vectorToFind, size_t vectorSize, int *outX,
@@ -3302,7 +3788,7 @@ char *create_random_image_data(ExplicitType dataType,
                     inputValues[i++] = 0.0f;
                     inputValues[i++] = 0.0f;
                     cl_uint *p = (cl_uint *)data;
-                    for (; i < numPixels * 4; i++) p[i] = genrand_int32(d);
+                    genrand_fill(d, p + i, numPixels * 4 - i);
                 }
                 break;
 
@@ -3785,139 +4271,153 @@ bool find_format(cl_image_format *formatList, unsigned int numFormats,
     return false;
 }
 
-void build_required_image_formats(
-    cl_mem_flags flags, cl_mem_object_type image_type, cl_device_id device,
-    std::vector<cl_image_format> &formatsToSupport)
-{
-    formatsToSupport.clear();
+namespace {
+
+// Minimum list of supported image formats for reading or writing (embedded
+// profile)
+constexpr cl_image_format embeddedProfile_readOrWrite[] = {
+    // clang-format off
+    { CL_RGBA, CL_UNORM_INT8 },
+    { CL_RGBA, CL_UNORM_INT16 },
+    { CL_RGBA, CL_SIGNED_INT8 },
+    { CL_RGBA, CL_SIGNED_INT16 },
+    { CL_RGBA, CL_SIGNED_INT32 },
+    { CL_RGBA, CL_UNSIGNED_INT8 },
+    { CL_RGBA, CL_UNSIGNED_INT16 },
+    { CL_RGBA, CL_UNSIGNED_INT32 },
+    { CL_RGBA, CL_HALF_FLOAT },
+    { CL_RGBA, CL_FLOAT },
+    // clang-format on
+};
 
-    // Minimum list of supported image formats for reading or writing (embedded
-    // profile)
-    static std::vector<cl_image_format> embeddedProfile_readOrWrite{
-        // clang-format off
-        { CL_RGBA, CL_UNORM_INT8 },
-        { CL_RGBA, CL_UNORM_INT16 },
-        { CL_RGBA, CL_SIGNED_INT8 },
-        { CL_RGBA, CL_SIGNED_INT16 },
-        { CL_RGBA, CL_SIGNED_INT32 },
-        { CL_RGBA, CL_UNSIGNED_INT8 },
-        { CL_RGBA, CL_UNSIGNED_INT16 },
-        { CL_RGBA, CL_UNSIGNED_INT32 },
-        { CL_RGBA, CL_HALF_FLOAT },
-        { CL_RGBA, CL_FLOAT },
-        // clang-format on
-    };
+// Minimum list of required image formats for reading or writing
+// num_channels, for all image types.
+constexpr cl_image_format fullProfile_readOrWrite[] = {
+    // clang-format off
+    { CL_RGBA, CL_UNORM_INT8 },
+    { CL_RGBA, CL_UNORM_INT16 },
+    { CL_RGBA, CL_SIGNED_INT8 },
+    { CL_RGBA, CL_SIGNED_INT16 },
+    { CL_RGBA, CL_SIGNED_INT32 },
+    { CL_RGBA, CL_UNSIGNED_INT8 },
+    { CL_RGBA, CL_UNSIGNED_INT16 },
+    { CL_RGBA, CL_UNSIGNED_INT32 },
+    { CL_RGBA, CL_HALF_FLOAT },
+    { CL_RGBA, CL_FLOAT },
+    { CL_BGRA, CL_UNORM_INT8 },
+    // clang-format on
+};
 
-    // Minimum list of required image formats for reading or writing
-    // num_channels, for all image types.
-    static std::vector<cl_image_format> fullProfile_readOrWrite{
-        // clang-format off
-        { CL_RGBA, CL_UNORM_INT8 },
-        { CL_RGBA, CL_UNORM_INT16 },
-        { CL_RGBA, CL_SIGNED_INT8 },
-        { CL_RGBA, CL_SIGNED_INT16 },
-        { CL_RGBA, CL_SIGNED_INT32 },
-        { CL_RGBA, CL_UNSIGNED_INT8 },
-        { CL_RGBA, CL_UNSIGNED_INT16 },
-        { CL_RGBA, CL_UNSIGNED_INT32 },
-        { CL_RGBA, CL_HALF_FLOAT },
-        { CL_RGBA, CL_FLOAT },
-        { CL_BGRA, CL_UNORM_INT8 },
-        // clang-format on
-    };
+// Minimum list of supported image formats for reading or writing
+// (OpenCL 2.0, 2.1, or 2.2), for all image types.
+constexpr cl_image_format fullProfile_2x_readOrWrite[] = {
+    // clang-format off
+    { CL_R, CL_UNORM_INT8 },
+    { CL_R, CL_UNORM_INT16 },
+    { CL_R, CL_SNORM_INT8 },
+    { CL_R, CL_SNORM_INT16 },
+    { CL_R, CL_SIGNED_INT8 },
+    { CL_R, CL_SIGNED_INT16 },
+    { CL_R, CL_SIGNED_INT32 },
+    { CL_R, CL_UNSIGNED_INT8 },
+    { CL_R, CL_UNSIGNED_INT16 },
+    { CL_R, CL_UNSIGNED_INT32 },
+    { CL_R, CL_HALF_FLOAT },
+    { CL_R, CL_FLOAT },
+    { CL_RG, CL_UNORM_INT8 },
+    { CL_RG, CL_UNORM_INT16 },
+    { CL_RG, CL_SNORM_INT8 },
+    { CL_RG, CL_SNORM_INT16 },
+    { CL_RG, CL_SIGNED_INT8 },
+    { CL_RG, CL_SIGNED_INT16 },
+    { CL_RG, CL_SIGNED_INT32 },
+    { CL_RG, CL_UNSIGNED_INT8 },
+    { CL_RG, CL_UNSIGNED_INT16 },
+    { CL_RG, CL_UNSIGNED_INT32 },
+    { CL_RG, CL_HALF_FLOAT },
+    { CL_RG, CL_FLOAT },
+    { CL_RGBA, CL_UNORM_INT8 },
+    { CL_RGBA, CL_UNORM_INT16 },
+    { CL_RGBA, CL_SNORM_INT8 },
+    { CL_RGBA, CL_SNORM_INT16 },
+    { CL_RGBA, CL_SIGNED_INT8 },
+    { CL_RGBA, CL_SIGNED_INT16 },
+    { CL_RGBA, CL_SIGNED_INT32 },
+    { CL_RGBA, CL_UNSIGNED_INT8 },
+    { CL_RGBA, CL_UNSIGNED_INT16 },
+    { CL_RGBA, CL_UNSIGNED_INT32 },
+    { CL_RGBA, CL_HALF_FLOAT },
+    { CL_RGBA, CL_FLOAT },
+    { CL_BGRA, CL_UNORM_INT8 },
+    // clang-format on
+};
 
-    // Minimum list of supported image formats for reading or writing
-    // (OpenCL 2.0, 2.1, or 2.2), for all image types.
-    static std::vector<cl_image_format> fullProfile_2x_readOrWrite{
-        // clang-format off
-        { CL_R, CL_UNORM_INT8 },
-        { CL_R, CL_UNORM_INT16 },
-        { CL_R, CL_SNORM_INT8 },
-        { CL_R, CL_SNORM_INT16 },
-        { CL_R, CL_SIGNED_INT8 },
-        { CL_R, CL_SIGNED_INT16 },
-        { CL_R, CL_SIGNED_INT32 },
-        { CL_R, CL_UNSIGNED_INT8 },
-        { CL_R, CL_UNSIGNED_INT16 },
-        { CL_R, CL_UNSIGNED_INT32 },
-        { CL_R, CL_HALF_FLOAT },
-        { CL_R, CL_FLOAT },
-        { CL_RG, CL_UNORM_INT8 },
-        { CL_RG, CL_UNORM_INT16 },
-        { CL_RG, CL_SNORM_INT8 },
-        { CL_RG, CL_SNORM_INT16 },
-        { CL_RG, CL_SIGNED_INT8 },
-        { CL_RG, CL_SIGNED_INT16 },
-        { CL_RG, CL_SIGNED_INT32 },
-        { CL_RG, CL_UNSIGNED_INT8 },
-        { CL_RG, CL_UNSIGNED_INT16 },
-        { CL_RG, CL_UNSIGNED_INT32 },
-        { CL_RG, CL_HALF_FLOAT },
-        { CL_RG, CL_FLOAT },
-        { CL_RGBA, CL_UNORM_INT8 },
-        { CL_RGBA, CL_UNORM_INT16 },
-        { CL_RGBA, CL_SNORM_INT8 },
-        { CL_RGBA, CL_SNORM_INT16 },
-        { CL_RGBA, CL_SIGNED_INT8 },
-        { CL_RGBA, CL_SIGNED_INT16 },
-        { CL_RGBA, CL_SIGNED_INT32 },
-        { CL_RGBA, CL_UNSIGNED_INT8 },
-        { CL_RGBA, CL_UNSIGNED_INT16 },
-        { CL_RGBA, CL_UNSIGNED_INT32 },
-        { CL_RGBA, CL_HALF_FLOAT },
-        { CL_RGBA, CL_FLOAT },
-        { CL_BGRA, CL_UNORM_INT8 },
-        // clang-format on
-    };
+// Conditional addition to the 2x readOrWrite table:
+// Support for the CL_DEPTH image channel order is required only for 2D
+// images and 2D image arrays.
+constexpr cl_image_format fullProfile_2x_readOrWrite_Depth[] = {
+    // clang-format off
+    { CL_DEPTH, CL_UNORM_INT16 },
+    { CL_DEPTH, CL_FLOAT },
+    // clang-format on
+};
 
-    // Conditional addition to the 2x readOrWrite table:
-    // Support for the CL_DEPTH image channel order is required only for 2D
-    // images and 2D image arrays.
-    static std::vector<cl_image_format> fullProfile_2x_readOrWrite_Depth{
-        // clang-format off
-        { CL_DEPTH, CL_UNORM_INT16 },
-        { CL_DEPTH, CL_FLOAT },
-        // clang-format on
-    };
+// Conditional addition to the 2x readOrWrite table:
+// Support for reading from the CL_sRGBA image channel order is optional for
+// 1D image buffers. Support for writing to the CL_sRGBA image channel order
+// is optional for all image types.
+constexpr cl_image_format fullProfile_2x_readOrWrite_srgb[] = {
+    { CL_sRGBA, CL_UNORM_INT8 },
+};
 
-    // Conditional addition to the 2x readOrWrite table:
-    // Support for reading from the CL_sRGBA image channel order is optional for
-    // 1D image buffers. Support for writing to the CL_sRGBA image channel order
-    // is optional for all image types.
-    static std::vector<cl_image_format> fullProfile_2x_readOrWrite_srgb{
-        { CL_sRGBA, CL_UNORM_INT8 },
-    };
+// Minimum list of required image formats for reading and writing.
+constexpr cl_image_format fullProfile_readAndWrite[] = {
+    // clang-format off
+    { CL_R, CL_UNORM_INT8 },
+    { CL_R, CL_SIGNED_INT8 },
+    { CL_R, CL_SIGNED_INT16 },
+    { CL_R, CL_SIGNED_INT32 },
+    { CL_R, CL_UNSIGNED_INT8 },
+    { CL_R, CL_UNSIGNED_INT16 },
+    { CL_R, CL_UNSIGNED_INT32 },
+    { CL_R, CL_HALF_FLOAT },
+    { CL_R, CL_FLOAT },
+    { CL_RGBA, CL_UNORM_INT8 },
+    { CL_RGBA, CL_SIGNED_INT8 },
+    { CL_RGBA, CL_SIGNED_INT16 },
+    { CL_RGBA, CL_SIGNED_INT32 },
+    { CL_RGBA, CL_UNSIGNED_INT8 },
+    { CL_RGBA, CL_UNSIGNED_INT16 },
+    { CL_RGBA, CL_UNSIGNED_INT32 },
+    { CL_RGBA, CL_HALF_FLOAT },
+    { CL_RGBA, CL_FLOAT },
+    // clang-format on
+};
 
-    // Minimum list of required image formats for reading and writing.
-    static std::vector<cl_image_format> fullProfile_readAndWrite{
-        // clang-format off
-        { CL_R, CL_UNORM_INT8 },
-        { CL_R, CL_SIGNED_INT8 },
-        { CL_R, CL_SIGNED_INT16 },
-        { CL_R, CL_SIGNED_INT32 },
-        { CL_R, CL_UNSIGNED_INT8 },
-        { CL_R, CL_UNSIGNED_INT16 },
-        { CL_R, CL_UNSIGNED_INT32 },
-        { CL_R, CL_HALF_FLOAT },
-        { CL_R, CL_FLOAT },
-        { CL_RGBA, CL_UNORM_INT8 },
-        { CL_RGBA, CL_SIGNED_INT8 },
-        { CL_RGBA, CL_SIGNED_INT16 },
-        { CL_RGBA, CL_SIGNED_INT32 },
-        { CL_RGBA, CL_UNSIGNED_INT8 },
-        { CL_RGBA, CL_UNSIGNED_INT16 },
-        { CL_RGBA, CL_UNSIGNED_INT32 },
-        { CL_RGBA, CL_HALF_FLOAT },
-        { CL_RGBA, CL_FLOAT },
-        // clang-format on
-    };
+struct RequiredFormatTable
+{
+    const cl_image_format *begin;
+    const cl_image_format *end;
+};
 
+template <size_t N>
+RequiredFormatTable required_table(const cl_image_format (&table)[N])
+{
+    return { table, table + N };
+}
+
+// The tables whose formats are required for flags and image_type, at most
+// three of them
+size_t get_required_format_tables(cl_mem_flags flags,
+                                  cl_mem_object_type image_type,
+                                  cl_device_id device,
+                                  RequiredFormatTable tables[3])
+{
+    size_t count = 0;
     // Embedded profile
     if (gIsEmbedded)
     {
-        copy(embeddedProfile_readOrWrite.begin(),
-             embeddedProfile_readOrWrite.end(),
-             back_inserter(formatsToSupport));
+        tables[count++] = required_table(embeddedProfile_readOrWrite);
     }
     // Full profile
     else
@@ -3929,15 +4429,11 @@ void build_required_image_formats(
             if (flags & CL_MEM_KERNEL_READ_AND_WRITE)
             {
                 // Note: assumes that read-write images are supported!
-                copy(fullProfile_readAndWrite.begin(),
-                     fullProfile_readAndWrite.end(),
-                     back_inserter(formatsToSupport));
+                tables[count++] = required_table(fullProfile_readAndWrite);
             }
             else
             {
-                copy(fullProfile_readOrWrite.begin(),
-                     fullProfile_readOrWrite.end(),
-                     back_inserter(formatsToSupport));
+                tables[count++] = required_table(fullProfile_readOrWrite);
             }
         }
         else
@@ -3945,24 +4441,19 @@ void build_required_image_formats(
             // Full profile, OpenCL 2.0, 2.1, 2.2.
             if (flags & CL_MEM_KERNEL_READ_AND_WRITE)
             {
-                copy(fullProfile_readAndWrite.begin(),
-                     fullProfile_readAndWrite.end(),
-                     back_inserter(formatsToSupport));
+                tables[count++] = required_table(fullProfile_readAndWrite);
             }
             else
             {
-                copy(fullProfile_2x_readOrWrite.begin(),
-                     fullProfile_2x_readOrWrite.end(),
-                     back_inserter(formatsToSupport));
+                tables[count++] = required_table(fullProfile_2x_readOrWrite);
 
                 // Support for the CL_DEPTH image channel order is required only
                 // for 2D images and 2D image arrays.
                 if (image_type == CL_MEM_OBJECT_IMAGE2D
                     || image_type == CL_MEM_OBJECT_IMAGE2D_ARRAY)
                 {
-                    copy(fullProfile_2x_readOrWrite_Depth.begin(),
-                         fullProfile_2x_readOrWrite_Depth.end(),
-                         back_inserter(formatsToSupport));
+                    tables[count++] =
+                        required_table(fullProfile_2x_readOrWrite_Depth);
                 }
 
                 // Support for reading from the CL_sRGBA image channel order is
@@ -3971,29 +4462,50 @@ void build_required_image_formats(
                 if (image_type != CL_MEM_OBJECT_IMAGE1D_BUFFER
                     && flags == CL_MEM_READ_ONLY)
                 {
-                    copy(fullProfile_2x_readOrWrite_srgb.begin(),
-                         fullProfile_2x_readOrWrite_srgb.end(),
-                         back_inserter(formatsToSupport));
+                    tables[count++] =
+                        required_table(fullProfile_2x_readOrWrite_srgb);
                 }
             }
         }
     }
+    return count;
+}
+
+} // anonymous namespace
+
+void build_required_image_formats(
+    cl_mem_flags flags, cl_mem_object_type image_type, cl_device_id device,
+    std::vector<cl_image_format> &formatsToSupport)
+{
+    formatsToSupport.clear();
+
+    RequiredFormatTable tables[3];
+    size_t count =
+        get_required_format_tables(flags, image_type, device, tables);
+    for (size_t i = 0; i < count; i++)
+        formatsToSupport.insert(formatsToSupport.end(), tables[i].begin,
+                                tables[i].end);
 }
 
 bool is_image_format_required(cl_image_format format, cl_mem_flags flags,
                               cl_mem_object_type image_type,
                               cl_device_id device)
 {
-    std::vector<cl_image_format> formatsToSupport;
-    build_required_image_formats(flags, image_type, device, formatsToSupport);
+    RequiredFormatTable tables[3];
+    size_t count =
+        get_required_format_tables(flags, image_type, device, tables);
 
-    for (auto &formatItr : formatsToSupport)
+    for (size_t i = 0; i < count; i++)
     {
-        if (formatItr.image_channel_order == format.image_channel_order
-            && formatItr.image_channel_data_type
-                == format.image_channel_data_type)
+        for (const cl_image_format *formatItr = tables[i].begin;
+             formatItr != tables[i].end; formatItr++)
         {
-            return true;
+            if (formatItr->image_channel_order == format.image_channel_order
+                && formatItr->image_channel_data_type
+                    == format.image_channel_data_type)
+            {
+                return true;
+            }
         }
     }
 
@@ -4119,6 +4631,75 @@ size_t compute_mip_level_offset(image_descriptor *imageInfo, size_t lod)
     return retOffset;
 }
 
+// Each clump holds the high bits of its pixels in its first bytes and the low
+// bits of all of them, first pixel lowest, in its last byte
+void unpack_raw_row(cl_channel_type type, const void *src, cl_ushort *dst,
+                    size_t width)
+{
+    const cl_uchar *in = (const cl_uchar *)src;
+    if (type == CL_UNSIGNED_INT_RAW10_EXT)
+    {
+        for (size_t c = 0; c < width / RAW10_EXT_CLUMP_NUM_PIXELS; c++)
+        {
+            const cl_uchar *b = in + c * RAW10_EXT_CLUMP_SIZE;
+            cl_ushort *p = dst + c * RAW10_EXT_CLUMP_NUM_PIXELS;
+            p[0] = (cl_ushort)((b[0] << 2) | (b[4] & 0x3));
+            p[1] = (cl_ushort)((b[1] << 2) | ((b[4] >> 2) & 0x3));
+            p[2] = (cl_ushort)((b[2] << 2) | ((b[4] >> 4) & 0x3));
+            p[3] = (cl_ushort)((b[3] << 2) | (b[4] >> 6));
+        }
+    }
+    else if (type == CL_UNSIGNED_INT_RAW12_EXT)
+    {
+        for (size_t c = 0; c < width / RAW12_EXT_CLUMP_NUM_PIXELS; c++)
+        {
+            const cl_uchar *b = in + c * RAW12_EXT_CLUMP_SIZE;
+            cl_ushort *p = dst + c * RAW12_EXT_CLUMP_NUM_PIXELS;
+            p[0] = (cl_ushort)((b[0] << 4) | (b[2] & 0xF));
+            p[1] = (cl_ushort)((b[1] << 4) | (b[2] >> 4));
+        }
+    }
+    else
+    {
+        log_error("unpack_raw_row: unsupported channel type 0x%x\n", type);
+    }
+}
+
+void pack_raw_row(cl_channel_type type, const cl_ushort *src, void *dst,
+                  size_t width)
+{
+    cl_uchar *out = (cl_uchar *)dst;
+    if (type == CL_UNSIGNED_INT_RAW10_EXT)
+    {
+        for (size_t c = 0; c < width / RAW10_EXT_CLUMP_NUM_PIXELS; c++)
+        {
+            const cl_ushort *p = src + c * RAW10_EXT_CLUMP_NUM_PIXELS;
+            cl_uchar *b = out + c * RAW10_EXT_CLUMP_SIZE;
+            b[0] = (cl_uchar)(p[0] >> 2);
+            b[1] = (cl_uchar)(p[1] >> 2);
+            b[2] = (cl_uchar)(p[2] >> 2);
+            b[3] = (cl_uchar)(p[3] >> 2);
+            b[4] = (cl_uchar)((p[0] & 0x3) | ((p[1] & 0x3) << 2)
+                              | ((p[2] & 0x3) << 4) | ((p[3] & 0x3) << 6));
+        }
+    }
+    else if (type == CL_UNSIGNED_INT_RAW12_EXT)
+    {
+        for (size_t c = 0; c < width / RAW12_EXT_CLUMP_NUM_PIXELS; c++)
+        {
+            const cl_ushort *p = src + c * RAW12_EXT_CLUMP_NUM_PIXELS;
+            cl_uchar *b = out + c * RAW12_EXT_CLUMP_SIZE;
+            b[0] = (cl_uchar)(p[0] >> 4);
+            b[1] = (cl_uchar)(p[1] >> 4);
+            b[2] = (cl_uchar)((p[0] & 0xF) | ((p[1] & 0xF) << 4));
+        }
+    }
+    else
+    {
+        log_error("pack_raw_row: unsupported channel type 0x%x\n", type);
+    }
+}
+
 const char *convert_image_type_to_string(cl_mem_object_type image_type)
 {
     switch (image_type)
@@ -23,6 +23,7 @@
 #include <string.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <memory>
 #include <vector>
 
 #if !defined(_WIN32)
@@ -142,6 +143,22 @@ void print_first_pixel_difference_error(size_t where, const char *sourcePixel,
 size_t compare_scanlines(const image_descriptor *imageInfo, const char *aPtr,
                          const char *bPtr);
 
+// Find the first row, in z then y order, where two images differ as seen by
+// compare_scanlines. Row y of slice z starts at aPtr + z * aSlicePitch +
+// y * aRowPitch in the first image, and likewise in the second. Rows whose
+// first scanlineSize bytes are equal are not compared further. Returns false
+// if no row differs, otherwise sets outY, outZ and outColumn to the first
+// difference. Rows are compared in parallel on the thread pool, or serially
+// when called from a ThreadPool_Do job, and the result does not depend on
+// the number of threads.
+bool find_first_scanline_difference(const image_descriptor *imageInfo,
+                                    const char *aPtr, size_t aRowPitch,
+                                    size_t aSlicePitch, const char *bPtr,
+                                    size_t bRowPitch, size_t bSlicePitch,
+                                    size_t scanlineSize, size_t height,
+                                    size_t depth, size_t *outY, size_t *outZ,
+                                    size_t *outColumn);
+
 void get_max_sizes(size_t *numberOfSizes, const int maxNumberOfSizes,
                    size_t sizes[][3], size_t maxWidth, size_t maxHeight,
                    size_t maxDepth, size_t maxArraySize,
@@ -227,6 +244,21 @@ inline size_t calculate_row_pitch(image_descriptor imageInfo, size_t pixelSize)
     return imageInfo.width * pixelSize;
 }
 
+// Convert a row of width CL_UNSIGNED_INT_RAW10_EXT or
+// CL_UNSIGNED_INT_RAW12_EXT pixels between the packed layout and one
+// cl_ushort per pixel, holding its 10 or 12 bit value. width must be
+// compatible with the format (see is_width_compatible). These work a clump at
+// a time, which the compiler can vectorize, where read_image_pixel decodes a
+// single pixel. Bits above the pixel size are ignored when packing.
+void unpack_raw_row(cl_channel_type type, const void *src, cl_ushort *dst,
+                    size_t width);
+void pack_raw_row(cl_channel_type type, const cl_ushort *src, void *dst,
+                  size_t width);
+
+// cl_half_to_float of every cl_half, indexed by its bits, for the references
+// to decode half texels with
+const float *half_to_float_table();
+
 template <class T>
 void read_image_pixel(void *imageData, image_descriptor *imageInfo, int x,
                       int y, int z, T *outData, int lod)
@@ -370,8 +402,9 @@ void read_image_pixel(void *imageData, image_descriptor *imageInfo, int x,
 
         case CL_HALF_FLOAT: {
             cl_half *dPtr = (cl_half *)ptr;
+            const float *halfToFloat = half_to_float_table();
             for (i = 0; i < get_format_channel_count(format); i++)
-                tempData[i] = (T)cl_half_to_float(dPtr[i]);
+                tempData[i] = (T)halfToFloat[dPtr[i]];
             break;
         }
 
@@ -685,6 +718,52 @@ FloatPixel sample_image_pixel_float_offset(
     image_sampler_data *imageSampler, float *outData, int verbose,
     int *containsDenorms, int lod);
 
+// Same as calling sample_image_pixel_float_offset for each of the count
+// coordinates (x[i], y[i], z[i]), without flushing denorms. For element i,
+// the sampled value goes to outData[4 * i] and the max pixel value to
+// maxPixels[i], and containsDenorms[i] records whether any denorms were
+// sampled. z may be NULL for images without a third coordinate. The elements
+// are split into tiles sampled in parallel on the thread pool, so this is the
+// faster way to compute the reference of a whole scanline. Called from a
+// ThreadPool_Do job, where the pool is busy, the tiles are sampled serially
+// on the calling thread.
+void sample_image_pixels_float_offset(
+    void *imageData, image_descriptor *imageInfo, const float *x,
+    const float *y, const float *z, size_t count, float xAddressOffset,
+    float yAddressOffset, float zAddressOffset,
+    image_sampler_data *imageSampler, float *outData, FloatPixel *maxPixels,
+    int *containsDenorms, int lod);
+
+
+// Budget in bytes of the cache of decoded mip levels, 0 disables it
+extern size_t gImageLevelCacheSize;
+
+struct DecodedImageLevel;
+struct ActiveImageLevel;
+
+// While in scope, read_image_pixel_float takes the texels of level lod of a
+// mipmapped image, whose data starts at levelData, from a decoded float copy
+// of the level instead of decoding them for every sample. That covers every
+// sampler, coordinate mode and offset, since those only change which texels
+// are read. Decoded levels are kept in a least recently used cache of
+// gImageLevelCacheSize bytes and are looked up by their contents, so a level
+// that is generated again with the same data is not decoded again. Only one
+// level is active at a time on each thread; a nested scope hides the outer
+// one.
+class ImageLevelReference {
+public:
+    ImageLevelReference(const void *levelData, image_descriptor *imageInfo,
+                        int lod);
+    ~ImageLevelReference();
+
+private:
+    ImageLevelReference(const ImageLevelReference &) = delete;
+    ImageLevelReference &operator=(const ImageLevelReference &) = delete;
+
+    std::shared_ptr<const DecodedImageLevel> m_level;
+    std::unique_ptr<ActiveImageLevel> m_active;
+};
+
 
 extern void pack_image_pixel(unsigned int *srcVector,
                              const cl_image_format *imageFormat, void *outData);
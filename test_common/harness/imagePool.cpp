@@ -0,0 +1,205 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "imagePool.h"
+
+#include "clImageHelper.h"
+#include "conversions.h"
+#include "errorHelpers.h"
+#include "imageHelpers.h"
+#include "mt19937.h"
+
+#include <string.h>
+
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <utility>
+
+namespace {
+
+// What the content depends on
+typedef std::tuple<cl_channel_order, cl_channel_type, size_t, size_t, size_t,
+                   cl_uint, cl_uint>
+    DataKey;
+// And what the image depends on
+typedef std::tuple<DataKey, cl_mem_object_type, cl_mem_flags> ImageKey;
+
+typedef std::shared_ptr<const std::vector<char>> ImageData;
+
+struct PoolEntry
+{
+    clMemWrapper image;
+    ImageData data;
+    // The content must be written again before the image is handed out
+    bool written;
+};
+
+std::mutex gImagePoolMutex;
+std::map<DataKey, ImageData> gImageData;
+std::map<cl_context, std::multimap<ImageKey, PoolEntry>> gImages;
+
+DataKey data_key(const image_pool_desc &desc)
+{
+    return DataKey(desc.format.image_channel_order,
+                   desc.format.image_channel_data_type, desc.width,
+                   desc.height, desc.depth, desc.seed, desc.mask);
+}
+
+ImageKey image_key(const image_pool_desc &desc)
+{
+    return ImageKey(data_key(desc), desc.type, desc.flags);
+}
+
+template <typename T>
+void fill_masked(char *out, size_t count, cl_uint mask, MTdata d)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        T value = (T)(genrand_int32(d) & mask);
+        memcpy(out + i * sizeof(T), &value, sizeof(T));
+    }
+}
+
+// The content of desc, or NULL if its format is not one the pool can fill
+ImageData generate_image_data(const image_pool_desc &desc)
+{
+    size_t count = desc.width * desc.height * desc.depth
+        * get_format_channel_count(&desc.format);
+    size_t elementSize =
+        get_channel_data_type_size(desc.format.image_channel_data_type);
+    std::shared_ptr<std::vector<char>> data =
+        std::make_shared<std::vector<char>>(count * elementSize);
+    MTdataHolder d(desc.seed);
+
+    switch (desc.format.image_channel_data_type)
+    {
+        case CL_SNORM_INT8:
+        case CL_UNORM_INT8:
+        case CL_SIGNED_INT8:
+        case CL_UNSIGNED_INT8:
+            fill_masked<cl_uchar>(data->data(), count, desc.mask, d);
+            break;
+        case CL_SNORM_INT16:
+        case CL_UNORM_INT16:
+        case CL_SIGNED_INT16:
+        case CL_UNSIGNED_INT16:
+            fill_masked<cl_ushort>(data->data(), count, desc.mask, d);
+            break;
+        case CL_SIGNED_INT32:
+        case CL_UNSIGNED_INT32:
+            fill_masked<cl_uint>(data->data(), count, desc.mask, d);
+            break;
+        case CL_FLOAT:
+            for (size_t i = 0; i < count; i++)
+            {
+                float value = get_random_float(-0x40000000, 0x40000000, d);
+                memcpy(data->data() + i * sizeof(float), &value,
+                       sizeof(float));
+            }
+            break;
+        default: return ImageData();
+    }
+    return data;
+}
+
+} // anonymous namespace
+
+PooledImage::PooledImage(cl_context context, cl_command_queue queue,
+                         const image_pool_desc &desc)
+    : m_context(context), m_desc(desc), m_status(CL_SUCCESS), m_written(false)
+{
+    bool write = true;
+    {
+        std::lock_guard<std::mutex> lock(gImagePoolMutex);
+        std::multimap<ImageKey, PoolEntry> &images = gImages[context];
+        auto it = images.find(image_key(desc));
+        if (it != images.end())
+        {
+            m_image = std::move(it->second.image);
+            m_data = it->second.data;
+            write = it->second.written;
+            images.erase(it);
+        }
+        else
+        {
+            ImageData &data = gImageData[data_key(desc)];
+            if (!data) data = generate_image_data(desc);
+            m_data = data;
+        }
+    }
+
+    if (!m_data)
+    {
+        log_error(
+            "ERROR: The image pool cannot fill images of channel type %s\n",
+            GetChannelTypeName(desc.format.image_channel_data_type));
+        m_status = CL_INVALID_VALUE;
+        return;
+    }
+
+    if (!m_image)
+    {
+        if (desc.type == CL_MEM_OBJECT_IMAGE3D)
+            m_image = create_image_3d(context, desc.flags, &desc.format,
+                                      desc.width, desc.height, desc.depth, 0,
+                                      0, NULL, &m_status);
+        else
+            m_image = create_image_2d(context, desc.flags, &desc.format,
+                                      desc.width, desc.height, 0, NULL,
+                                      &m_status);
+        if (!m_image)
+        {
+            print_error(m_status, "Unable to create pooled image");
+            return;
+        }
+    }
+
+    if (write)
+    {
+        size_t origin[3] = { 0, 0, 0 };
+        size_t region[3] = { desc.width, desc.height, desc.depth };
+        m_status = clEnqueueWriteImage(queue, m_image, CL_TRUE, origin, region,
+                                       0, 0, m_data->data(), 0, NULL, NULL);
+        if (m_status != CL_SUCCESS)
+            print_error(m_status, "Unable to write pooled image");
+    }
+}
+
+PooledImage::~PooledImage()
+{
+    if (m_status != CL_SUCCESS) return;
+
+    PoolEntry entry;
+    entry.image = std::move(m_image);
+    entry.data = m_data;
+    entry.written = m_written;
+
+    std::lock_guard<std::mutex> lock(gImagePoolMutex);
+    gImages[m_context].emplace(image_key(m_desc), std::move(entry));
+}
+
+void release_pooled_images(cl_context context)
+{
+    std::lock_guard<std::mutex> lock(gImagePoolMutex);
+    gImages.erase(context);
+}
+
+void release_image_pool()
+{
+    std::lock_guard<std::mutex> lock(gImagePoolMutex);
+    gImages.clear();
+    gImageData.clear();
+}
@@ -0,0 +1,96 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef HARNESS_IMAGE_POOL_H_
+#define HARNESS_IMAGE_POOL_H_
+
+#include "compat.h"
+#include "typeWrappers.h"
+
+#include <CL/opencl.h>
+
+#include <memory>
+#include <vector>
+
+// What a pooled image holds: an image of the given format, type and size,
+// created with flags, filled from init_genrand(seed). Each element of a
+// channel is the next generator word masked with mask, or for CL_FLOAT
+// get_random_float(-0x40000000, 0x40000000), so that the same description
+// always gives the same content.
+struct image_pool_desc
+{
+    cl_image_format format;
+    // CL_MEM_OBJECT_IMAGE2D or CL_MEM_OBJECT_IMAGE3D
+    cl_mem_object_type type;
+    size_t width;
+    size_t height;
+    // 1 for 2D images
+    size_t depth;
+    cl_mem_flags flags;
+    cl_uint seed;
+    // For the integer and normalized formats, e.g. to keep values small
+    // enough to sum. Ignored for CL_FLOAT.
+    cl_uint mask;
+};
+
+// A filled image borrowed from a pool, with the host copy of its content for
+// the reference, so that tests reading the same images don't generate and
+// write the same data over and over.
+//
+// The content of each description is generated once for the run, and an
+// image of it created and written once for its context. On return the image
+// goes back to the pool of the context, and is written again before it is
+// handed out next only if written() was called. A test must call it if the
+// device or the host may have changed the image. The pool of a context is
+// released by the harness when the test that created the context is done.
+class PooledImage {
+public:
+    PooledImage(cl_context context, cl_command_queue queue,
+                const image_pool_desc &desc);
+    ~PooledImage();
+
+    // CL_SUCCESS, or the error from creating or writing the image
+    cl_int status() const { return m_status; }
+
+    const clMemWrapper &image() const { return m_image; }
+
+    // The content of the image, rows of width pixels without padding. Only
+    // valid if status() is CL_SUCCESS.
+    const void *data() const { return m_data->data(); }
+    size_t size() const { return m_data->size(); }
+
+    // The test changed the image, which must be written again before reuse
+    void written() { m_written = true; }
+
+private:
+    PooledImage(const PooledImage &) = delete;
+    PooledImage &operator=(const PooledImage &) = delete;
+
+    cl_context m_context;
+    image_pool_desc m_desc;
+    clMemWrapper m_image;
+    std::shared_ptr<const std::vector<char>> m_data;
+    cl_int m_status;
+    bool m_written;
+};
+
+// Release the pooled images of context, which keep it alive
+void release_pooled_images(cl_context context);
+
+// Release every pooled image and the content generated for them, called by
+// the harness after the tests
+void release_image_pool();
+
+#endif // HARNESS_IMAGE_POOL_H_
@@ -0,0 +1,225 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "kernelClock.h"
+
+#include "deviceInfo.h"
+#include "errorHelpers.h"
+#include "stringHelpers.h"
+
+#include <algorithm>
+
+namespace {
+
+// clang-format off
+// The hilo built-ins, so that the device doesn't need 64-bit integers
+const char *kClockMacros = R"(
+#define KERNEL_CLOCK_FIRST_ITEM() \
+    (get_local_id(0) == 0 && get_local_id(1) == 0 && get_local_id(2) == 0)
+#define KERNEL_CLOCK_GROUP() \
+    (get_group_id(0) + get_num_groups(0) * (get_group_id(1) + get_num_groups(1) * get_group_id(2)))
+#define KERNEL_CLOCK_BEGIN() \
+    barrier(CLK_LOCAL_MEM_FENCE | CLK_GLOBAL_MEM_FENCE); \
+    uint2 kernel_clock_start = clock_read_hilo_%s()
+#define KERNEL_CLOCK_END(clocks) \
+    barrier(CLK_LOCAL_MEM_FENCE | CLK_GLOBAL_MEM_FENCE); \
+    if (KERNEL_CLOCK_FIRST_ITEM()) \
+    { \
+        (clocks)[2 * KERNEL_CLOCK_GROUP()] = kernel_clock_start; \
+        (clocks)[2 * KERNEL_CLOCK_GROUP() + 1] = clock_read_hilo_%s(); \
+    }
+)";
+
+const char *kNoClockMacros = R"(
+#define KERNEL_CLOCK_BEGIN()
+#define KERNEL_CLOCK_END(clocks)
+)";
+// clang-format on
+
+cl_ulong clock_value(const cl_uint *hilo)
+{
+    return ((cl_ulong)hilo[1] << 32) | hilo[0];
+}
+
+size_t histogram_bucket(cl_ulong ticks)
+{
+    size_t bucket = 0;
+    while (ticks > 1)
+    {
+        ticks >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+// Sorts values
+void summarize(std::vector<cl_ulong> &values, cl_ulong &median, cl_ulong &max,
+               std::vector<size_t> &histogram)
+{
+    histogram.clear();
+    median = max = 0;
+    if (values.empty()) return;
+
+    std::sort(values.begin(), values.end());
+    median = values[values.size() / 2];
+    max = values.back();
+    histogram.resize(histogram_bucket(max) + 1, 0);
+    for (cl_ulong value : values) histogram[histogram_bucket(value)]++;
+}
+
+void log_histogram(const char *label, const char *name,
+                   const std::vector<size_t> &histogram)
+{
+    for (size_t i = 0; i < histogram.size(); i++)
+        if (histogram[i])
+            log_info("BENCH\tkernel_clock_histogram\t%s\t%s\t%llu\t%zu\n",
+                     label, name, i ? 1ull << i : 0ull, histogram[i]);
+}
+
+} // anonymous namespace
+
+KernelClockProbe::KernelClockProbe(cl_device_id device, cl_context context)
+    : m_context(context), m_scope(0), m_capacity(0), m_groups(0)
+{
+    cl_device_kernel_clock_capabilities_khr capabilities = 0;
+    if (is_extension_available(device, "cl_khr_kernel_clock"))
+    {
+        cl_int error =
+            clGetDeviceInfo(device, CL_DEVICE_KERNEL_CLOCK_CAPABILITIES_KHR,
+                            sizeof(capabilities), &capabilities, NULL);
+        if (error != CL_SUCCESS)
+        {
+            print_error(error,
+                        "Unable to query "
+                        "CL_DEVICE_KERNEL_CLOCK_CAPABILITIES_KHR");
+            capabilities = 0;
+        }
+    }
+
+    if (capabilities & CL_DEVICE_KERNEL_CLOCK_SCOPE_DEVICE_KHR)
+        m_scope = CL_DEVICE_KERNEL_CLOCK_SCOPE_DEVICE_KHR;
+    else if (capabilities & CL_DEVICE_KERNEL_CLOCK_SCOPE_WORK_GROUP_KHR)
+        m_scope = CL_DEVICE_KERNEL_CLOCK_SCOPE_WORK_GROUP_KHR;
+
+    if (m_scope)
+        m_source = str_sprintf(kClockMacros, scope_name(), scope_name());
+    else
+        m_source = kNoClockMacros;
+}
+
+const char *KernelClockProbe::scope_name() const
+{
+    switch (m_scope)
+    {
+        case CL_DEVICE_KERNEL_CLOCK_SCOPE_DEVICE_KHR: return "device";
+        case CL_DEVICE_KERNEL_CLOCK_SCOPE_WORK_GROUP_KHR: return "work_group";
+        default: return "none";
+    }
+}
+
+cl_int KernelClockProbe::prepare(cl_command_queue queue, size_t groups)
+{
+    cl_int error;
+    size_t bytes = std::max<size_t>(groups, 1) * 4 * sizeof(cl_uint);
+    if (bytes > m_capacity)
+    {
+        m_buffer = clCreateBuffer(m_context, CL_MEM_READ_WRITE, bytes, NULL,
+                                  &error);
+        test_error(error, "Unable to create the kernel clock buffer");
+        m_capacity = bytes;
+    }
+
+    const cl_uint zero = 0;
+    error = clEnqueueFillBuffer(queue, m_buffer, &zero, sizeof(zero), 0,
+                                bytes, 0, NULL, NULL);
+    test_error(error, "Unable to clear the kernel clock buffer");
+    m_groups = groups;
+    return CL_SUCCESS;
+}
+
+cl_int KernelClockProbe::collect(cl_command_queue queue,
+                                 KernelClockStats *stats)
+{
+    if (!supported()) return CL_INVALID_OPERATION;
+
+    std::vector<cl_uint> clocks(m_groups * 4);
+    cl_int error = clEnqueueReadBuffer(queue, m_buffer, CL_BLOCKING, 0,
+                                       clocks.size() * sizeof(cl_uint),
+                                       clocks.data(), 0, NULL, NULL);
+    test_error(error, "Unable to read the kernel clock buffer");
+
+    stats->groups = m_groups;
+    stats->missing = 0;
+    stats->backwards = 0;
+    stats->hasSkew = has_skew();
+
+    std::vector<cl_ulong> starts, durations;
+    for (size_t i = 0; i < m_groups; i++)
+    {
+        cl_ulong start = clock_value(&clocks[4 * i]);
+        cl_ulong end = clock_value(&clocks[4 * i + 2]);
+        if (start == 0 && end == 0)
+            stats->missing++;
+        else if (end < start)
+            stats->backwards++;
+        else
+        {
+            starts.push_back(start);
+            durations.push_back(end - start);
+        }
+    }
+
+    summarize(durations, stats->medianDuration, stats->maxDuration,
+              stats->durationHistogram);
+    stats->minDuration = durations.empty() ? 0 : durations.front();
+
+    stats->medianSkew = stats->maxSkew = 0;
+    stats->skewHistogram.clear();
+    if (stats->hasSkew && !starts.empty())
+    {
+        cl_ulong first = *std::min_element(starts.begin(), starts.end());
+        for (cl_ulong &start : starts) start -= first;
+        summarize(starts, stats->medianSkew, stats->maxSkew,
+                  stats->skewHistogram);
+    }
+    return CL_SUCCESS;
+}
+
+void log_kernel_clock_stats(const char *label, const KernelClockStats &stats)
+{
+    log_info("BENCH\tkernel_clock\tlabel\tgroups\tmissing\tbackwards"
+             "\tmin_ticks\tmedian_ticks\tmax_ticks\tmedian_skew\tmax_skew\n");
+    if (stats.hasSkew)
+        log_info("BENCH\tkernel_clock\t%s\t%zu\t%zu\t%zu\t%llu\t%llu\t%llu"
+                 "\t%llu\t%llu\n",
+                 label, stats.groups, stats.missing, stats.backwards,
+                 (unsigned long long)stats.minDuration,
+                 (unsigned long long)stats.medianDuration,
+                 (unsigned long long)stats.maxDuration,
+                 (unsigned long long)stats.medianSkew,
+                 (unsigned long long)stats.maxSkew);
+    else
+        log_info("BENCH\tkernel_clock\t%s\t%zu\t%zu\t%zu\t%llu\t%llu\t%llu"
+                 "\t-\t-\n",
+                 label, stats.groups, stats.missing, stats.backwards,
+                 (unsigned long long)stats.minDuration,
+                 (unsigned long long)stats.medianDuration,
+                 (unsigned long long)stats.maxDuration);
+
+    log_info(
+        "BENCH\tkernel_clock_histogram\tlabel\tkind\tfrom_ticks\tgroups\n");
+    log_histogram(label, "duration", stats.durationHistogram);
+    log_histogram(label, "skew", stats.skewHistogram);
+}
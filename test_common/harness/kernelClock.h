@@ -0,0 +1,111 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef HARNESS_KERNEL_CLOCK_H_
+#define HARNESS_KERNEL_CLOCK_H_
+
+#include "compat.h"
+#include "typeWrappers.h"
+
+#include <CL/opencl.h>
+
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+// In-kernel timing of work-groups with the cl_khr_kernel_clock built-ins,
+// finer than the queue profiling of the whole NDRange. A kernel is built
+// with KernelClockProbe::source() in front of its own source and brackets
+// the work it times with
+//
+//     KERNEL_CLOCK_BEGIN();
+//     ...
+//     KERNEL_CLOCK_END(clocks);
+//
+// where clocks is a __global uint2 * argument set to the probe's buffer.
+// Both macros contain a barrier, so every work-item of the group must reach
+// them. The first work-item of each group stores the clock when the whole
+// group has reached the start and the clock once it has reached the end.
+// The device scope clock is shared by the work-groups, so it also gives
+// how much later than the first each group started; with only the work
+// group scope clock, just the durations are measured.
+//
+// On devices without the extension the macros expand to nothing, so one
+// kernel source serves both.
+
+// Work-groups timed by one kernel run, in clock ticks, whose length the
+// extension leaves to the device
+struct KernelClockStats
+{
+    size_t groups;
+    // Groups that stored no clocks or whose end was before their start
+    size_t missing;
+    size_t backwards;
+
+    cl_ulong minDuration;
+    cl_ulong medianDuration;
+    cl_ulong maxDuration;
+    // Entry i counts the durations in [2^i, 2^(i+1)), with 0 in entry 0
+    std::vector<size_t> durationHistogram;
+
+    // Start of each group after the first to start, device scope only
+    bool hasSkew;
+    cl_ulong medianSkew;
+    cl_ulong maxSkew;
+    std::vector<size_t> skewHistogram;
+};
+
+class KernelClockProbe {
+public:
+    KernelClockProbe(cl_device_id device, cl_context context);
+
+    // Whether the device has a device or work group scope clock
+    bool supported() const { return m_scope != 0; }
+    // Whether the clock is shared by the work-groups, giving start skew
+    bool has_skew() const
+    {
+        return m_scope == CL_DEVICE_KERNEL_CLOCK_SCOPE_DEVICE_KHR;
+    }
+    const char *scope_name() const;
+
+    // Definitions of KERNEL_CLOCK_BEGIN and KERNEL_CLOCK_END to put in front
+    // of the kernel source
+    const char *source() const { return m_source.c_str(); }
+
+    // Make room for the clocks of groups work-groups and clear them. Call
+    // before each run to be collected.
+    cl_int prepare(cl_command_queue queue, size_t groups);
+    cl_mem buffer() const { return m_buffer; }
+
+    // Read back the clocks of the last run, which must have been enqueued
+    // on queue
+    cl_int collect(cl_command_queue queue, KernelClockStats *stats);
+
+private:
+    cl_context m_context;
+    cl_device_kernel_clock_capabilities_khr m_scope;
+    std::string m_source;
+    clMemWrapper m_buffer;
+    // Bytes of m_buffer and the groups of the run being timed
+    size_t m_capacity;
+    size_t m_groups;
+};
+
+// Log the stats as BENCH rows labelled with label: one summary row, then a
+// row per non-empty histogram bucket
+void log_kernel_clock_stats(const char *label, const KernelClockStats &stats);
+
+#endif // HARNESS_KERNEL_CLOCK_H_
@@ -22,7 +22,11 @@
 #include "testHarness.h"
 #include "parseParameters.h"
 
+#include <bitset>
 #include <cassert>
+#include <map>
+#include <set>
+#include <thread>
 #include <vector>
 #include <string>
 #include <fstream>
@@ -30,15 +34,44 @@
 #include <iomanip>
 #include <mutex>
 #include <algorithm>
+#include <atomic>
+#include <cstdio>
 
 #if defined(_WIN32)
+#include <process.h>
 std::string slash = "\\";
 #else
+#include <unistd.h>
 std::string slash = "/";
 #endif
 
 static std::mutex gCompilerMutex;
 
+// Batched offline compilation
+//
+// With --offline-compilation-batch the harness first runs the tests with
+// the offline compiles deferred: invoke_offline_compiler records each
+// command instead of running it and fails the build. The recorded commands
+// are then run by a bounded pool of threads, each running one compiler
+// process at a time, so that the real run finds the outputs in the
+// compilation cache. Kernels the collection pass did not reach are still
+// compiled when the tests ask for them. All of this state is guarded by
+// gCompilerMutex.
+namespace {
+struct DeferredCompile
+{
+    std::string command;
+    std::string outputFilename;
+    bool validate;
+};
+} // anonymous namespace
+
+static bool gDeferOfflineCompiles = false;
+static std::vector<DeferredCompile> gDeferredCompiles;
+static std::set<std::string> gDeferredOutputs;
+// SPIR-V files already checked by the validator during this run
+static std::set<std::string> gValidatedSpirv;
+
 static cl_int get_first_device_id(const cl_context context,
                                   cl_device_id &device);
 
@@ -447,6 +480,19 @@ static int invoke_offline_compiler(const cl_device_id device,
         device_address_space_size, compilationMode, bOptions, sourceFilename,
         outputFilename, clDeviceInfoFilename);
 
+    if (gDeferOfflineCompiles)
+    {
+        if (gDeferredOutputs.insert(outputFilename).second)
+        {
+            DeferredCompile compile = {
+                runString, outputFilename,
+                compilationMode == kSpir_v && !gDisableSPIRVValidation
+            };
+            gDeferredCompiles.push_back(compile);
+        }
+        return CL_COMPILE_PROGRAM_FAILURE;
+    }
+
     // execute script
     log_info("Executing command: %s\n", runString.c_str());
     fflush(stdout);
@@ -502,6 +548,25 @@ static cl_int get_device_address_bits(const cl_device_id device,
     return CL_SUCCESS;
 }
 
+static int run_spirv_validator(const std::string &filename)
+{
+    std::string runString = gSPIRVValidator + " " + filename;
+
+    int returnCode = system(runString.c_str());
+    if (returnCode == -1)
+    {
+        log_error("Error: failed to invoke SPIR-V validator\n");
+        return CL_COMPILE_PROGRAM_FAILURE;
+    }
+    else if (returnCode != 0)
+    {
+        log_error("Failed to validate SPIR-V file %s: system() returned 0x%x\n",
+                  filename.c_str(), returnCode);
+        return CL_COMPILE_PROGRAM_FAILURE;
+    }
+    return CL_SUCCESS;
+}
+
 static int get_offline_compiler_output(
     std::ifstream &ifs, const cl_device_id device, cl_uint deviceAddrSpaceSize,
     const CompilationMode compilationMode, const std::string &bOptions,
@@ -541,26 +606,80 @@ static int get_offline_compiler_output(
         }
     }
 
-    if (compilationMode == kSpir_v && !gDisableSPIRVValidation)
+    if (compilationMode == kSpir_v && !gDisableSPIRVValidation
+        && gValidatedSpirv.count(outputFilename) == 0)
     {
-        std::string runString = gSPIRVValidator + " " + outputFilename;
+        int error = run_spirv_validator(outputFilename);
+        if (error != CL_SUCCESS) return error;
+        gValidatedSpirv.insert(outputFilename);
+    }
 
-        int returnCode = system(runString.c_str());
-        if (returnCode == -1)
-        {
-            log_error("Error: failed to invoke SPIR-V validator\n");
-            return CL_COMPILE_PROGRAM_FAILURE;
-        }
-        else if (returnCode != 0)
+    return CL_SUCCESS;
+}
+
+void begin_offline_compile_collection()
+{
+    std::lock_guard<std::mutex> compiler_lock(gCompilerMutex);
+    gDeferOfflineCompiles = true;
+}
+
+int run_deferred_offline_compiles(unsigned processes)
+{
+    std::vector<DeferredCompile> compiles;
+    {
+        std::lock_guard<std::mutex> compiler_lock(gCompilerMutex);
+        gDeferOfflineCompiles = false;
+        compiles.swap(gDeferredCompiles);
+        gDeferredOutputs.clear();
+    }
+    if (compiles.empty()) return 0;
+
+    if (processes == 0)
+        processes = std::max(std::thread::hardware_concurrency(), 1u);
+    processes = (unsigned)std::min<size_t>(processes, compiles.size());
+    log_info("Compiling %zu kernels offline with up to %u processes\n",
+             compiles.size(), processes);
+
+    std::atomic<size_t> next{ 0 };
+    std::atomic<int> failures{ 0 };
+    std::vector<char> validated(compiles.size(), 0);
+    auto worker = [&]() {
+        for (size_t i = next++; i < compiles.size(); i = next++)
         {
-            log_error(
-                "Failed to validate SPIR-V file %s: system() returned 0x%x\n",
-                outputFilename.c_str(), returnCode);
-            return CL_COMPILE_PROGRAM_FAILURE;
+            const DeferredCompile &compile = compiles[i];
+            int returnCode = system(compile.command.c_str());
+            if (returnCode != 0)
+            {
+                // Leave no partial output behind, the test that needs the
+                // kernel compiles it again and reports the error
+                log_info("Command finished with error 0x%x: %s\n", returnCode,
+                         compile.command.c_str());
+                remove(compile.outputFilename.c_str());
+                failures++;
+                continue;
+            }
+            if (compile.validate)
+                validated[i] =
+                    run_spirv_validator(compile.outputFilename) == CL_SUCCESS;
         }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < processes; t++) threads.emplace_back(worker);
+    for (std::thread &thread : threads) thread.join();
+
+    {
+        std::lock_guard<std::mutex> compiler_lock(gCompilerMutex);
+        for (size_t i = 0; i < compiles.size(); i++)
+            if (validated[i])
+                gValidatedSpirv.insert(compiles[i].outputFilename);
     }
 
-    return CL_SUCCESS;
+    if (failures)
+        log_info("%d offline compiles failed, they will be retried by the "
+                 "tests\n",
+                 (int)failures);
+    return failures;
 }
 
 static int create_single_kernel_helper_create_program_offline(
@@ -744,6 +863,154 @@ int create_single_kernel_helper_create_program_for_device(
         buildOptions, gCompilationMode);
 }
 
+// Online binary cache
+//
+// With --online-binary-cache, programs built from source for a single device
+// are saved to gCompilationCachePath. The file name holds a hash of the
+// source, the build options and the device, driver and IL versions, and the
+// file starts with the full key so that a hash collision is detected rather
+// than loading the wrong binary. Files are written under a temporary name and
+// renamed into place, so concurrent test processes never see a partial file
+// and readers need no locking.
+
+static const char online_cache_magic[8] = { 'C', 'T', 'S', 'B',
+                                            'I', 'N', '0', '1' };
+
+static std::string get_device_info_or_empty(cl_device_id device,
+                                            cl_device_info param_name)
+{
+    try
+    {
+        return get_device_info_string(device, param_name);
+    } catch (const std::runtime_error &)
+    {
+        // e.g. CL_DEVICE_IL_VERSION on devices older than OpenCL 2.1
+        return "";
+    }
+}
+
+static std::string get_online_cache_key(cl_device_id device,
+                                        const std::string &source,
+                                        const char *buildOptions)
+{
+    cl_uint vendorID = 0;
+    clGetDeviceInfo(device, CL_DEVICE_VENDOR_ID, sizeof(vendorID), &vendorID,
+                    NULL);
+
+    std::ostringstream key;
+    key << std::hex << vendorID << '\n'
+        << get_device_info_or_empty(device, CL_DEVICE_NAME) << '\n'
+        << get_device_info_or_empty(device, CL_DRIVER_VERSION) << '\n'
+        << get_device_info_or_empty(device, CL_DEVICE_VERSION) << '\n'
+        << get_device_info_or_empty(device, CL_DEVICE_IL_VERSION) << '\n'
+        << (buildOptions ? buildOptions : "") << '\n'
+        << source;
+    return key.str();
+}
+
+static std::string get_online_cache_filename(const std::string &source,
+                                             const std::string &key)
+{
+    // 64-bit FNV-1a
+    cl_ulong hash = 0xcbf29ce484222325ULL;
+    for (unsigned char c : key)
+    {
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
+    }
+
+    // Keep file names short even for programs with many kernels
+    std::string kernelName = get_kernel_name(source).substr(0, 64);
+
+    std::ostringstream oss;
+    oss << gCompilationCachePath << slash << kernelName << std::hex
+        << std::setfill('0') << std::setw(16) << hash << ".clbin";
+    return oss.str();
+}
+
+// Returns a built program, or NULL if the cache has no usable entry.
+static cl_program load_online_cached_program(cl_context context,
+                                             cl_device_id device,
+                                             const std::string &filename,
+                                             const std::string &key,
+                                             const char *buildOptions)
+{
+    std::ifstream ifs(filename.c_str(), std::ios::binary);
+    if (!ifs.good()) return NULL;
+
+    char magic[sizeof(online_cache_magic)];
+    cl_ulong keySize = 0, binarySize = 0;
+    ifs.read(magic, sizeof(magic));
+    ifs.read((char *)&keySize, sizeof(keySize));
+    if (!ifs.good() || memcmp(magic, online_cache_magic, sizeof(magic))
+        || keySize != key.size())
+        return NULL;
+
+    std::string fileKey(key.size(), '\0');
+    ifs.read(&fileKey[0], fileKey.size());
+    ifs.read((char *)&binarySize, sizeof(binarySize));
+    if (!ifs.good() || fileKey != key || binarySize == 0) return NULL;
+
+    std::vector<unsigned char> binary((size_t)binarySize);
+    ifs.read((char *)binary.data(), binary.size());
+    if (!ifs.good()) return NULL;
+
+    size_t length = binary.size();
+    const unsigned char *binaries = binary.data();
+    cl_int error;
+    cl_program program = clCreateProgramWithBinary(context, 1, &device, &length,
+                                                   &binaries, NULL, &error);
+    if (program == NULL || error != CL_SUCCESS) return NULL;
+
+    // A binary the driver no longer accepts is rebuilt from source
+    error = clBuildProgram(program, 1, &device, buildOptions, NULL, NULL);
+    if (error != CL_SUCCESS)
+    {
+        clReleaseProgram(program);
+        return NULL;
+    }
+
+    return program;
+}
+
+static void save_online_cached_program(cl_program program,
+                                       const std::string &filename,
+                                       const std::string &key)
+{
+    size_t binarySize = 0;
+    cl_int error = clGetProgramInfo(program, CL_PROGRAM_BINARY_SIZES,
+                                    sizeof(binarySize), &binarySize, NULL);
+    if (error != CL_SUCCESS || binarySize == 0) return;
+
+    std::vector<unsigned char> binary(binarySize);
+    unsigned char *binaries = binary.data();
+    error = clGetProgramInfo(program, CL_PROGRAM_BINARIES, sizeof(binaries),
+                             &binaries, NULL);
+    if (error != CL_SUCCESS) return;
+
+    static std::atomic<unsigned> counter{ 0 };
+    std::ostringstream tmp;
+#if defined(_WIN32)
+    tmp << filename << ".tmp" << _getpid() << '.' << counter++;
+#else
+    tmp << filename << ".tmp" << getpid() << '.' << counter++;
+#endif
+    std::string tmpFilename = tmp.str();
+
+    std::ofstream ofs(tmpFilename.c_str(), std::ios::binary);
+    cl_ulong keySize = key.size(), binarySize64 = binarySize;
+    ofs.write(online_cache_magic, sizeof(online_cache_magic));
+    ofs.write((const char *)&keySize, sizeof(keySize));
+    ofs.write(key.data(), key.size());
+    ofs.write((const char *)&binarySize64, sizeof(binarySize64));
+    ofs.write((const char *)binary.data(), binary.size());
+    ofs.close();
+
+    // If another process got there first, keep its copy.
+    if (!ofs.good() || std::rename(tmpFilename.c_str(), filename.c_str()))
+        std::remove(tmpFilename.c_str());
+}
+
 int create_single_kernel_helper_with_build_options(
     cl_context context, cl_program *outProgram, cl_kernel *outKernel,
     unsigned int numKernelLines, const char **kernelProgram,
@@ -799,13 +1066,6 @@ int create_single_kernel_helper(cl_context context, cl_program *outProgram,
         build_options_internal += cl_std;
         buildOptions = build_options_internal.c_str();
     }
-    int error = create_single_kernel_helper_create_program(
-        context, outProgram, numKernelLines, kernelProgram, buildOptions);
-    if (error != CL_SUCCESS)
-    {
-        log_error("Create program failed: %d, line: %d\n", error, __LINE__);
-        return error;
-    }
 
     // Remove offline-compiler-only build options
     std::string newBuildOptions;
@@ -821,10 +1081,55 @@ int create_single_kernel_helper(cl_context context, cl_program *outProgram,
             if (i != std::string::npos) newBuildOptions.erase(i, s.length());
         }
     }
+
+    // The online binary cache only handles single device contexts
+    cl_device_id device = NULL;
+    cl_uint numDevices = 0;
+    std::string cacheKey, cacheFilename;
+    if (gOnlineBinaryCache && gCompilationMode == kOnline
+        && CL_SUCCESS
+            == clGetContextInfo(context, CL_CONTEXT_NUM_DEVICES,
+                                sizeof(numDevices), &numDevices, NULL)
+        && numDevices == 1
+        && CL_SUCCESS == get_first_device_id(context, device))
+    {
+        std::string source = get_kernel_content(numKernelLines, kernelProgram);
+        cacheKey =
+            get_online_cache_key(device, source, newBuildOptions.c_str());
+        cacheFilename = get_online_cache_filename(source, cacheKey);
+
+        *outProgram =
+            load_online_cached_program(context, device, cacheFilename, cacheKey,
+                                       newBuildOptions.c_str());
+        if (*outProgram != NULL)
+        {
+            if (kernelName == NULL) return CL_SUCCESS;
+
+            cl_int error;
+            *outKernel = clCreateKernel(*outProgram, kernelName, &error);
+            if (*outKernel != NULL && error == CL_SUCCESS) return CL_SUCCESS;
+
+            // Not the program we expected, rebuild it from source
+            clReleaseProgram(*outProgram);
+            *outProgram = NULL;
+        }
+    }
+
+    int error = create_single_kernel_helper_create_program(
+        context, outProgram, numKernelLines, kernelProgram, buildOptions);
+    if (error != CL_SUCCESS)
+    {
+        log_error("Create program failed: %d, line: %d\n", error, __LINE__);
+        return error;
+    }
+
     // Build program and create kernel
-    return build_program_create_kernel_helper(
+    error = build_program_create_kernel_helper(
         context, outProgram, outKernel, numKernelLines, kernelProgram,
         kernelName, newBuildOptions.c_str());
+    if (error == CL_SUCCESS && !cacheFilename.empty())
+        save_online_cached_program(*outProgram, cacheFilename, cacheKey);
+    return error;
 }
 
 // Builds OpenCL C/C++ program and creates
@@ -1000,73 +1305,91 @@ int build_program_create_kernel_helper(
     return 0;
 }
 
-int get_max_allowed_work_group_size(cl_context context, cl_kernel kernel,
-                                    size_t *outMaxSize, size_t *outLimits)
+int get_kernel_launch_info(cl_context context, cl_kernel kernel,
+                           KernelLaunchInfo *outInfo)
 {
-    cl_device_id *devices;
-    size_t size, maxCommonSize = 0;
-    int numDevices, i, j, error;
-    cl_uint numDims;
-    size_t outSize;
-    size_t sizeLimit[] = { 1, 1, 1 };
-
+    if (outInfo->filled) return 0;
 
-    /* Assume fewer than 16 devices will be returned */
-    error = clGetContextInfo(context, CL_CONTEXT_DEVICES, 0, NULL, &outSize);
+    size_t outSize;
+    int error = clGetContextInfo(context, CL_CONTEXT_DEVICES, 0, NULL, &outSize);
     test_error(error, "Unable to obtain list of devices size for context");
-    devices = (cl_device_id *)malloc(outSize);
-    BufferOwningPtr<cl_device_id> devicesBuf(devices);
-
-    error =
-        clGetContextInfo(context, CL_CONTEXT_DEVICES, outSize, devices, NULL);
+    std::vector<cl_device_id> devices(outSize / sizeof(cl_device_id));
+    error = clGetContextInfo(context, CL_CONTEXT_DEVICES, outSize,
+                             devices.data(), NULL);
     test_error(error, "Unable to obtain list of devices for context");
 
-    numDevices = (int)(outSize / sizeof(cl_device_id));
-
-    for (i = 0; i < numDevices; i++)
+    KernelLaunchInfo info;
+    for (size_t i = 0; i < devices.size(); i++)
     {
-        error = clGetDeviceInfo(devices[i], CL_DEVICE_MAX_WORK_GROUP_SIZE,
+        cl_device_id device = devices[i];
+        size_t size;
+        error = clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_GROUP_SIZE,
                                 sizeof(size), &size, NULL);
         test_error(error, "Unable to obtain max work group size for device");
-        if (size < maxCommonSize || maxCommonSize == 0) maxCommonSize = size;
+        if (size < info.workGroupSize || info.workGroupSize == 0)
+            info.workGroupSize = size;
 
-        error = clGetKernelWorkGroupInfo(kernel, devices[i],
+        error = clGetKernelWorkGroupInfo(kernel, device,
                                          CL_KERNEL_WORK_GROUP_SIZE,
                                          sizeof(size), &size, NULL);
         test_error(
             error,
             "Unable to obtain max work group size for device and kernel combo");
-        if (size < maxCommonSize || maxCommonSize == 0) maxCommonSize = size;
+        if (size < info.workGroupSize || info.workGroupSize == 0)
+            info.workGroupSize = size;
 
-        error = clGetDeviceInfo(devices[i], CL_DEVICE_MAX_WORK_ITEM_DIMENSIONS,
+        cl_uint numDims;
+        error = clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_ITEM_DIMENSIONS,
                                 sizeof(numDims), &numDims, NULL);
         test_error(
             error,
             "clGetDeviceInfo failed for CL_DEVICE_MAX_WORK_ITEM_DIMENSIONS");
-        sizeLimit[0] = 1;
-        error = clGetDeviceInfo(devices[i], CL_DEVICE_MAX_WORK_ITEM_SIZES,
-                                numDims * sizeof(size_t), sizeLimit, NULL);
+        std::vector<size_t> sizeLimit(std::max(numDims, 3u), 1);
+        error = clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_ITEM_SIZES,
+                                numDims * sizeof(size_t), sizeLimit.data(),
+                                NULL);
         test_error(error,
                    "clGetDeviceInfo failed for CL_DEVICE_MAX_WORK_ITEM_SIZES");
+        for (cl_uint j = 0; j < 3; j++)
+            if (i == 0 || (j < numDims && sizeLimit[j] < info.workItemSizes[j]))
+                info.workItemSizes[j] = sizeLimit[j];
+
+        // Neither this nor the private memory size is reported by OpenCL 1.0
+        // devices
+        if (clGetKernelWorkGroupInfo(
+                kernel, device, CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE,
+                sizeof(size), &size, NULL)
+                == CL_SUCCESS
+            && size != 0 && (i == 0 || size < info.preferredMultiple))
+            info.preferredMultiple = size;
+
+        cl_ulong memSize;
+        error = clGetKernelWorkGroupInfo(kernel, device,
+                                         CL_KERNEL_LOCAL_MEM_SIZE,
+                                         sizeof(memSize), &memSize, NULL);
+        test_error(error, "Unable to obtain local memory size of kernel");
+        info.localMemSize = std::max(info.localMemSize, memSize);
+        if (clGetKernelWorkGroupInfo(kernel, device, CL_KERNEL_PRIVATE_MEM_SIZE,
+                                     sizeof(memSize), &memSize, NULL)
+            == CL_SUCCESS)
+            info.privateMemSize = std::max(info.privateMemSize, memSize);
+    }
+
+    info.filled = true;
+    *outInfo = info;
+    return 0;
+}
 
-        if (outLimits != NULL)
-        {
-            if (i == 0)
-            {
-                for (j = 0; j < 3; j++) outLimits[j] = sizeLimit[j];
-            }
-            else
-            {
-                for (j = 0; j < (int)numDims; j++)
-                {
-                    if (sizeLimit[j] < outLimits[j])
-                        outLimits[j] = sizeLimit[j];
-                }
-            }
-        }
-    }
+int get_max_allowed_work_group_size(cl_context context, cl_kernel kernel,
+                                    size_t *outMaxSize, size_t *outLimits)
+{
+    KernelLaunchInfo info;
+    int error = get_kernel_launch_info(context, kernel, &info);
+    if (error != 0) return error;
 
-    *outMaxSize = (unsigned int)maxCommonSize;
+    *outMaxSize = (unsigned int)info.workGroupSize;
+    if (outLimits != NULL)
+        for (int j = 0; j < 3; j++) outLimits[j] = info.workItemSizes[j];
     return 0;
 }
 
@@ -1117,14 +1440,11 @@ extern int get_max_allowed_1d_work_group_size_on_device(cl_device_id device,
     return 0;
 }
 
-
-int get_max_common_work_group_size(cl_context context, cl_kernel kernel,
+int get_max_common_work_group_size(const KernelLaunchInfo &info,
                                    size_t globalThreadSize, size_t *outMaxSize)
 {
-    size_t sizeLimit[3];
-    int error =
-        get_max_allowed_work_group_size(context, kernel, outMaxSize, sizeLimit);
-    if (error != 0) return error;
+    const size_t *sizeLimit = info.workItemSizes;
+    *outMaxSize = (unsigned int)info.workGroupSize;
 
     /* Now find the largest factor of globalThreadSize that is <= maxCommonSize
      */
@@ -1138,15 +1458,12 @@ int get_max_common_work_group_size(cl_context context, cl_kernel kernel,
     return 0;
 }
 
-int get_max_common_2D_work_group_size(cl_context context, cl_kernel kernel,
+int get_max_common_2D_work_group_size(const KernelLaunchInfo &info,
                                       size_t *globalThreadSizes,
                                       size_t *outMaxSizes)
 {
-    size_t sizeLimit[3];
-    size_t maxSize;
-    int error =
-        get_max_allowed_work_group_size(context, kernel, &maxSize, sizeLimit);
-    if (error != 0) return error;
+    const size_t *sizeLimit = info.workItemSizes;
+    size_t maxSize = (unsigned int)info.workGroupSize;
 
     /* Now find a set of factors, multiplied together less than maxSize, but
        each a factor of the global sizes */
@@ -1184,15 +1501,12 @@ int get_max_common_2D_work_group_size(cl_context context, cl_kernel kernel,
     return 0;
 }
 
-int get_max_common_3D_work_group_size(cl_context context, cl_kernel kernel,
+int get_max_common_3D_work_group_size(const KernelLaunchInfo &info,
                                       size_t *globalThreadSizes,
                                       size_t *outMaxSizes)
 {
-    size_t sizeLimit[3];
-    size_t maxSize;
-    int error =
-        get_max_allowed_work_group_size(context, kernel, &maxSize, sizeLimit);
-    if (error != 0) return error;
+    const size_t *sizeLimit = info.workItemSizes;
+    size_t maxSize = (unsigned int)info.workGroupSize;
     /* Now find a set of factors, multiplied together less than maxSize, but
      each a factor of the global sizes */
 
@@ -1232,48 +1546,200 @@ int get_max_common_3D_work_group_size(cl_context context, cl_kernel kernel,
     return 0;
 }
 
-/* Helper to determine if a device supports an image format */
-int is_image_format_supported(cl_context context, cl_mem_flags flags,
-                              cl_mem_object_type image_type,
-                              const cl_image_format *fmt)
+int get_max_common_work_group_size(cl_context context, cl_kernel kernel,
+                                   size_t globalThreadSize, size_t *outMaxSize)
+{
+    KernelLaunchInfo info;
+    int error = get_kernel_launch_info(context, kernel, &info);
+    if (error != 0) return error;
+    return get_max_common_work_group_size(info, globalThreadSize, outMaxSize);
+}
+
+int get_max_common_2D_work_group_size(cl_context context, cl_kernel kernel,
+                                      size_t *globalThreadSizes,
+                                      size_t *outMaxSizes)
+{
+    KernelLaunchInfo info;
+    int error = get_kernel_launch_info(context, kernel, &info);
+    if (error != 0) return error;
+    return get_max_common_2D_work_group_size(info, globalThreadSizes,
+                                             outMaxSizes);
+}
+
+int get_max_common_3D_work_group_size(cl_context context, cl_kernel kernel,
+                                      size_t *globalThreadSizes,
+                                      size_t *outMaxSizes)
+{
+    KernelLaunchInfo info;
+    int error = get_kernel_launch_info(context, kernel, &info);
+    if (error != 0) return error;
+    return get_max_common_3D_work_group_size(info, globalThreadSizes,
+                                             outMaxSizes);
+}
+
+namespace {
+
+// Core channel orders start at CL_R and core channel data types at
+// CL_SNORM_INT8. Formats outside of these ranges, from extensions, are
+// looked up in the list instead.
+const cl_uint kCoreImageOrderCount = 32;
+const cl_uint kCoreImageTypeCount = 32;
+
+bool core_image_format_index(const cl_image_format &format, size_t &index)
+{
+    cl_uint order = format.image_channel_order - CL_R;
+    cl_uint type = format.image_channel_data_type - CL_SNORM_INT8;
+    if (order >= kCoreImageOrderCount || type >= kCoreImageTypeCount)
+        return false;
+    index = order * kCoreImageTypeCount + type;
+    return true;
+}
+
+struct ImageFormatTable
+{
+    std::vector<cl_image_format> formats;
+    std::bitset<kCoreImageOrderCount * kCoreImageTypeCount> core;
+
+    bool Contains(const cl_image_format &format) const
+    {
+        size_t index;
+        if (core_image_format_index(format, index)) return core[index];
+        for (const cl_image_format &supported : formats)
+            if (supported.image_channel_order == format.image_channel_order
+                && supported.image_channel_data_type
+                    == format.image_channel_data_type)
+                return true;
+        return false;
+    }
+};
+
+typedef std::map<std::pair<cl_mem_flags, cl_mem_object_type>,
+                 ImageFormatTable>
+    ContextImageFormats;
+
+// Only contexts that say when they are destroyed are cached, as a released
+// context handle may be reused for a new context
+std::mutex gImageFormatMutex;
+std::map<cl_context, ContextImageFormats> gImageFormats;
+
+void CL_CALLBACK forget_image_formats(cl_context context, void *)
+{
+    std::lock_guard<std::mutex> lock(gImageFormatMutex);
+    gImageFormats.erase(context);
+}
+
+cl_int query_image_format_table(cl_context context, cl_mem_flags flags,
+                                cl_mem_object_type image_type,
+                                ImageFormatTable &table)
 {
-    cl_image_format *list;
     cl_uint count = 0;
-    cl_int err = clGetSupportedImageFormats(context, flags, image_type, 128,
-                                            NULL, &count);
-    if (count == 0) return 0;
+    cl_int error =
+        clGetSupportedImageFormats(context, flags, image_type, 0, NULL, &count);
+    if (error != CL_SUCCESS) return error;
+    table.formats.resize(count);
+    if (count)
+    {
+        error = clGetSupportedImageFormats(context, flags, image_type, count,
+                                           table.formats.data(), NULL);
+        if (error != CL_SUCCESS) return error;
+    }
+    for (const cl_image_format &format : table.formats)
+    {
+        size_t index;
+        if (core_image_format_index(format, index)) table.core.set(index);
+    }
+    return CL_SUCCESS;
+}
+
+// clSetContextDestructorCallback is new in OpenCL 3.0
+bool can_track_context(cl_context context)
+{
+    cl_device_id devices[16];
+    size_t size = 0;
+    if (clGetContextInfo(context, CL_CONTEXT_DEVICES, sizeof(devices), devices,
+                         &size)
+            != CL_SUCCESS
+        || size < sizeof(cl_device_id))
+        return false;
+    for (size_t i = 0; i < size / sizeof(cl_device_id); i++)
+        if (get_device_cl_version(devices[i]) < Version(3, 0)) return false;
+    return true;
+}
 
-    list = (cl_image_format *)malloc(count * sizeof(cl_image_format));
-    if (NULL == list)
+// The cached table of context, flags and image_type, filled on first use,
+// or else table filled by a query
+cl_int find_image_format_table(cl_context context, cl_mem_flags flags,
+                               cl_mem_object_type image_type,
+                               ImageFormatTable &table,
+                               const ImageFormatTable *&found)
+{
+    auto key = std::make_pair(flags, image_type);
     {
-        log_error("Error: unable to allocate %zu byte buffer for image format "
-                  "list at %s:%d (err = %d)\n",
-                  count * sizeof(cl_image_format), __FILE__, __LINE__, err);
-        return 0;
+        std::lock_guard<std::mutex> lock(gImageFormatMutex);
+        auto cached = gImageFormats.find(context);
+        if (cached != gImageFormats.end())
+        {
+            auto it = cached->second.find(key);
+            if (it != cached->second.end())
+            {
+                found = &it->second;
+                return CL_SUCCESS;
+            }
+        }
     }
-    BufferOwningPtr<cl_image_format> listBuf(list);
 
+    cl_int error = query_image_format_table(context, flags, image_type, table);
+    if (error != CL_SUCCESS) return error;
+    found = &table;
 
-    cl_int error = clGetSupportedImageFormats(context, flags, image_type, count,
-                                              list, NULL);
+    std::lock_guard<std::mutex> lock(gImageFormatMutex);
+    auto cached = gImageFormats.find(context);
+    if (cached == gImageFormats.end())
+    {
+        if (!can_track_context(context)
+            || clSetContextDestructorCallback(context, forget_image_formats,
+                                              NULL)
+                != CL_SUCCESS)
+            return CL_SUCCESS;
+        cached = gImageFormats.insert({ context, {} }).first;
+    }
+    found = &cached->second.insert({ key, table }).first->second;
+    return CL_SUCCESS;
+}
+
+} // anonymous namespace
+
+cl_int get_supported_image_formats(cl_context context, cl_mem_flags flags,
+                                   cl_mem_object_type image_type,
+                                   std::vector<cl_image_format> &formats)
+{
+    ImageFormatTable table;
+    const ImageFormatTable *found = NULL;
+    cl_int error =
+        find_image_format_table(context, flags, image_type, table, found);
+    if (error != CL_SUCCESS) return error;
+    formats = found->formats;
+    return CL_SUCCESS;
+}
+
+/* Helper to determine if a device supports an image format */
+int is_image_format_supported(cl_context context, cl_mem_flags flags,
+                              cl_mem_object_type image_type,
+                              const cl_image_format *fmt)
+{
+    ImageFormatTable table;
+    const ImageFormatTable *found = NULL;
+    cl_int error =
+        find_image_format_table(context, flags, image_type, table, found);
     if (error)
     {
         log_error("Error: failed to obtain supported image type list at %s:%d "
                   "(err = %d)\n",
-                  __FILE__, __LINE__, err);
+                  __FILE__, __LINE__, error);
         return 0;
     }
 
-    // iterate looking for a match.
-    cl_uint i;
-    for (i = 0; i < count; i++)
-    {
-        if (fmt->image_channel_data_type == list[i].image_channel_data_type
-            && fmt->image_channel_order == list[i].image_channel_order)
-            break;
-    }
-
-    return (i < count) ? 1 : 0;
+    return found->Contains(*fmt) ? 1 : 0;
 }
 
 size_t get_pixel_bytes(const cl_image_format *fmt);
@@ -1621,21 +2087,16 @@ Version get_device_cl_c_version(cl_device_id device)
     // versions are backwards compatible, hence querying with the
     // CL_DEVICE_OPENCL_C_VERSION query must return the most recent supported
     // OpenCL C version.
-    size_t opencl_c_version_size_in_bytes{};
-    auto error = clGetDeviceInfo(device, CL_DEVICE_OPENCL_C_VERSION, 0, nullptr,
-                                 &opencl_c_version_size_in_bytes);
-    test_error_ret(error,
-                   "clGetDeviceInfo failed for CL_DEVICE_OPENCL_C_VERSION\n",
-                   (Version{ -1, 0 }));
-
-    std::string opencl_c_version(opencl_c_version_size_in_bytes, '\0');
-    error =
-        clGetDeviceInfo(device, CL_DEVICE_OPENCL_C_VERSION,
-                        opencl_c_version.size(), &opencl_c_version[0], nullptr);
-
-    test_error_ret(error,
-                   "clGetDeviceInfo failed for CL_DEVICE_OPENCL_C_VERSION\n",
-                   (Version{ -1, 0 }));
+    auto snapshot = get_device_snapshot(device);
+    const std::string *opencl_c_version_string =
+        snapshot->String(CL_DEVICE_OPENCL_C_VERSION);
+    if (opencl_c_version_string == nullptr)
+    {
+        log_error("ERROR: clGetDeviceInfo failed for "
+                  "CL_DEVICE_OPENCL_C_VERSION\n");
+        return Version{ -1, 0 };
+    }
+    const std::string &opencl_c_version = *opencl_c_version_string;
 
     // Scrape out the major, minor pair from the string.
     auto major = opencl_c_version[opencl_c_version.find('.') - 1];
@@ -1653,24 +2114,18 @@ Version get_device_latest_cl_c_version(cl_device_id device)
     // recent CL C version supported by the device.
     if (device_cl_version >= Version{ 3, 0 })
     {
-        size_t opencl_c_all_versions_size_in_bytes{};
-        auto error =
-            clGetDeviceInfo(device, CL_DEVICE_OPENCL_C_ALL_VERSIONS, 0, nullptr,
-                            &opencl_c_all_versions_size_in_bytes);
-        test_error_ret(
-            error, "clGetDeviceInfo failed for CL_DEVICE_OPENCL_C_ALL_VERSIONS",
-            (Version{ -1, 0 }));
-        std::vector<cl_name_version> name_versions(
-            opencl_c_all_versions_size_in_bytes / sizeof(cl_name_version));
-        error = clGetDeviceInfo(device, CL_DEVICE_OPENCL_C_ALL_VERSIONS,
-                                opencl_c_all_versions_size_in_bytes,
-                                name_versions.data(), nullptr);
-        test_error_ret(
-            error, "clGetDeviceInfo failed for CL_DEVICE_OPENCL_C_ALL_VERSIONS",
-            (Version{ -1, 0 }));
+        auto snapshot = get_device_snapshot(device);
+        const std::vector<cl_name_version> *name_versions =
+            snapshot->NameVersions(CL_DEVICE_OPENCL_C_ALL_VERSIONS);
+        if (name_versions == nullptr)
+        {
+            log_error("ERROR: clGetDeviceInfo failed for "
+                      "CL_DEVICE_OPENCL_C_ALL_VERSIONS\n");
+            return Version{ -1, 0 };
+        }
 
         Version max_supported_cl_c_version{};
-        for (const auto &name_version : name_versions)
+        for (const auto &name_version : *name_versions)
         {
             Version current_version{
                 static_cast<int>(CL_VERSION_MAJOR(name_version.version)),
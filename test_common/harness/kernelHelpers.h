@@ -41,6 +41,7 @@
 #include "harness/alloc.h"
 
 #include <functional>
+#include <vector>
 
 /*
  *  The below code is intended to be used at the top of kernels that appear
@@ -88,6 +89,15 @@ extern int create_single_kernel_helper_create_program_for_device(
     unsigned int numKernelLines, const char **kernelProgram,
     const char *buildOptions = NULL);
 
+/* Defers the offline compiles of the programs created from now on: their
+ * compiler commands are recorded and the program creation fails */
+extern void begin_offline_compile_collection();
+
+/* Stops deferring, and runs the recorded offline compiles with up to
+ * processes compiler processes at once, one per core if 0. Returns the
+ * number of compiles that failed */
+extern int run_deferred_offline_compiles(unsigned processes);
+
 /* Creates OpenCL C++ program. This one must be used for creating OpenCL C++
  * program. */
 extern int create_openclcpp_program(cl_context context, cl_program *outProgram,
@@ -101,6 +111,43 @@ int build_program_create_kernel_helper(
     unsigned int numKernelLines, const char **kernelProgram,
     const char *kernelName, const char *buildOptions = NULL);
 
+/* The work-group limits of a kernel on all the devices of a context and the
+ * memory it uses. Tests that size many launches of a kernel fill one with
+ * get_kernel_launch_info and pass it to the get_max_common_*work_group_size
+ * overloads below, rather than have every launch query the devices again. */
+struct KernelLaunchInfo
+{
+    bool filled = false;
+    /* The largest work-group, and the largest in each dimension, that all
+     * the devices allow */
+    size_t workGroupSize = 0;
+    size_t workItemSizes[3] = { 1, 1, 1 };
+    /* The smallest CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE of the
+     * devices */
+    size_t preferredMultiple = 1;
+    /* The largest CL_KERNEL_LOCAL_MEM_SIZE and CL_KERNEL_PRIVATE_MEM_SIZE of
+     * the devices */
+    cl_ulong localMemSize = 0;
+    cl_ulong privateMemSize = 0;
+};
+
+/* Fills outInfo for kernel on the devices of context, unless it is already
+ * filled */
+extern int get_kernel_launch_info(cl_context context, cl_kernel kernel,
+                                  KernelLaunchInfo *outInfo);
+
+/* The get_max_common_*work_group_size helpers for a kernel whose limits are
+ * already known */
+extern int get_max_common_work_group_size(const KernelLaunchInfo &info,
+                                          size_t globalThreadSize,
+                                          size_t *outSize);
+extern int get_max_common_2D_work_group_size(const KernelLaunchInfo &info,
+                                             size_t *globalThreadSize,
+                                             size_t *outSizes);
+extern int get_max_common_3D_work_group_size(const KernelLaunchInfo &info,
+                                             size_t *globalThreadSize,
+                                             size_t *outSizes);
+
 /* Helper to obtain the biggest fit work group size for all the devices in a
  * given group and for the given global thread size */
 extern int get_max_common_work_group_size(cl_context context, cl_kernel kernel,
@@ -131,6 +178,15 @@ extern int get_max_allowed_1d_work_group_size_on_device(cl_device_id device,
                                                         cl_kernel kernel,
                                                         size_t *outSize);
 
+/* Fills formats with the image formats context supports for flags and
+ * image_type, from a table kept per context and filled on first use. Only
+ * contexts whose devices all support clSetContextDestructorCallback are
+ * cached, the others are queried every time. */
+extern cl_int
+get_supported_image_formats(cl_context context, cl_mem_flags flags,
+                            cl_mem_object_type image_type,
+                            std::vector<cl_image_format> &formats);
+
 /* Helper to determine if a device supports an image format */
 extern int is_image_format_supported(cl_context context, cl_mem_flags flags,
                                      cl_mem_object_type image_type,
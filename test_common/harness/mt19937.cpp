@@ -46,9 +46,12 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <algorithm>
 #include "mt19937.h"
 #include "mingw_compat.h"
 #include "harness/alloc.h"
+#include "philox.h"
 
 #ifdef __SSE2__
 #include <mutex>
@@ -69,6 +72,14 @@ typedef struct _MTdata
     cl_uint cache[N];
 #endif
     cl_int mti;
+
+    // Counter-based generators ignore the state above and return word
+    // counterIndex of the Philox stream keyed by counterSeed.
+    cl_int counterBased;
+    cl_ulong counterSeed;
+    cl_ulong counterIndex;
+    cl_ulong counterBlock; // block held in counterCache, plus one
+    cl_uint counterCache[4];
 } _MTdata;
 
 /* initializes mt[N] with a seed */
@@ -92,157 +103,230 @@ MTdata init_genrand(cl_uint s)
             /* for >32 bit machines */
         }
         r->mti = mti;
+        r->counterBased = 0;
+    }
+
+    return r;
+}
+
+MTdata init_genrand_counter(cl_ulong seed, cl_ulong index)
+{
+    MTdata r = (MTdata)align_malloc(sizeof(_MTdata), 16);
+    if (NULL != r)
+    {
+        r->counterBased = 1;
+        r->counterSeed = seed;
+        r->counterIndex = index;
+        r->counterBlock = 0;
     }
 
     return r;
 }
 
+MTdata genrand_split(MTdata d, cl_ulong count)
+{
+    if (!d->counterBased) return NULL;
+    return init_genrand_counter(d->counterSeed, d->counterIndex + count);
+}
+
+void genrand_skip(MTdata d, cl_ulong count)
+{
+    if (d->counterBased)
+        d->counterIndex += count;
+    else
+        while (count--) genrand_int32(d);
+}
+
+bool genrand_is_counter_based(MTdata d) { return 0 != d->counterBased; }
+
 void free_mtdata(MTdata d)
 {
     if (d) align_free(d);
 }
 
-/* generates a random number on [0,0xffffffff]-interval */
-cl_uint genrand_int32(MTdata d)
-{
-    /* mag01[x] = x * MATRIX_A  for x=0,1 */
-    static const cl_uint mag01[2] = { 0x0UL, MATRIX_A };
+/* mag01[x] = x * MATRIX_A  for x=0,1 */
+static const cl_uint mag01[2] = { 0x0UL, MATRIX_A };
 #ifdef __SSE2__
-    static std::once_flag init_flag;
-    static union {
-        __m128i v;
-        cl_uint s[4];
-    } upper_mask, lower_mask, one, matrix_a, c0, c1;
+static std::once_flag init_flag;
+static union {
+    __m128i v;
+    cl_uint s[4];
+} upper_mask, lower_mask, one, matrix_a, c0, c1;
 #endif
 
-
+/* generate N words at one time */
+static void genrand_regenerate(MTdata d)
+{
     cl_uint *mt = d->mt;
     cl_uint y;
-
-    if (d->mti == N)
-    { /* generate N words at one time */
-        int kk;
+    int kk;
 
 #ifdef __SSE2__
-        auto init_fn = []() {
-            upper_mask.s[0] = upper_mask.s[1] = upper_mask.s[2] =
-                upper_mask.s[3] = UPPER_MASK;
-            lower_mask.s[0] = lower_mask.s[1] = lower_mask.s[2] =
-                lower_mask.s[3] = LOWER_MASK;
-            one.s[0] = one.s[1] = one.s[2] = one.s[3] = 1;
-            matrix_a.s[0] = matrix_a.s[1] = matrix_a.s[2] = matrix_a.s[3] =
-                MATRIX_A;
-            c0.s[0] = c0.s[1] = c0.s[2] = c0.s[3] = (cl_uint)0x9d2c5680UL;
-            c1.s[0] = c1.s[1] = c1.s[2] = c1.s[3] = (cl_uint)0xefc60000UL;
-        };
-        std::call_once(init_flag, init_fn);
+    auto init_fn = []() {
+        upper_mask.s[0] = upper_mask.s[1] = upper_mask.s[2] =
+            upper_mask.s[3] = UPPER_MASK;
+        lower_mask.s[0] = lower_mask.s[1] = lower_mask.s[2] =
+            lower_mask.s[3] = LOWER_MASK;
+        one.s[0] = one.s[1] = one.s[2] = one.s[3] = 1;
+        matrix_a.s[0] = matrix_a.s[1] = matrix_a.s[2] = matrix_a.s[3] =
+            MATRIX_A;
+        c0.s[0] = c0.s[1] = c0.s[2] = c0.s[3] = (cl_uint)0x9d2c5680UL;
+        c1.s[0] = c1.s[1] = c1.s[2] = c1.s[3] = (cl_uint)0xefc60000UL;
+    };
+    std::call_once(init_flag, init_fn);
 #endif
 
-        kk = 0;
+    kk = 0;
 #ifdef __SSE2__
-        // vector loop
-        for (; kk + 4 <= N - M; kk += 4)
-        {
-            // ((mt[kk]&UPPER_MASK)|(mt[kk+1]&LOWER_MASK))
-            __m128i vy = _mm_or_si128(
-                _mm_and_si128(_mm_load_si128((__m128i *)(mt + kk)),
-                              upper_mask.v),
-                _mm_and_si128(_mm_loadu_si128((__m128i *)(mt + kk + 1)),
-                              lower_mask.v));
-
-            // y & 1 ? -1 : 0
-            __m128i mask = _mm_cmpeq_epi32(_mm_and_si128(vy, one.v), one.v);
-            // y & 1 ? MATRIX_A, 0    =  mag01[y & (cl_uint) 0x1UL]
-            __m128i vmag01 = _mm_and_si128(mask, matrix_a.v);
-            // mt[kk+M] ^ (y >> 1)
-            __m128i vr =
-                _mm_xor_si128(_mm_loadu_si128((__m128i *)(mt + kk + M)),
-                              (__m128i)_mm_srli_epi32(vy, 1));
-            // mt[kk+M] ^ (y >> 1) ^ mag01[y & (cl_uint) 0x1UL]
-            vr = _mm_xor_si128(vr, vmag01);
-            _mm_store_si128((__m128i *)(mt + kk), vr);
-        }
+    // vector loop
+    for (; kk + 4 <= N - M; kk += 4)
+    {
+        // ((mt[kk]&UPPER_MASK)|(mt[kk+1]&LOWER_MASK))
+        __m128i vy = _mm_or_si128(
+            _mm_and_si128(_mm_load_si128((__m128i *)(mt + kk)), upper_mask.v),
+            _mm_and_si128(_mm_loadu_si128((__m128i *)(mt + kk + 1)),
+                          lower_mask.v));
+
+        // y & 1 ? -1 : 0
+        __m128i mask = _mm_cmpeq_epi32(_mm_and_si128(vy, one.v), one.v);
+        // y & 1 ? MATRIX_A, 0    =  mag01[y & (cl_uint) 0x1UL]
+        __m128i vmag01 = _mm_and_si128(mask, matrix_a.v);
+        // mt[kk+M] ^ (y >> 1)
+        __m128i vr = _mm_xor_si128(_mm_loadu_si128((__m128i *)(mt + kk + M)),
+                                   (__m128i)_mm_srli_epi32(vy, 1));
+        // mt[kk+M] ^ (y >> 1) ^ mag01[y & (cl_uint) 0x1UL]
+        vr = _mm_xor_si128(vr, vmag01);
+        _mm_store_si128((__m128i *)(mt + kk), vr);
+    }
 #endif
-        for (; kk < N - M; kk++)
-        {
-            y = (cl_uint)((mt[kk] & UPPER_MASK) | (mt[kk + 1] & LOWER_MASK));
-            mt[kk] = mt[kk + M] ^ (y >> 1) ^ mag01[y & (cl_uint)0x1UL];
-        }
+    for (; kk < N - M; kk++)
+    {
+        y = (cl_uint)((mt[kk] & UPPER_MASK) | (mt[kk + 1] & LOWER_MASK));
+        mt[kk] = mt[kk + M] ^ (y >> 1) ^ mag01[y & (cl_uint)0x1UL];
+    }
 
 #ifdef __SSE2__
-        // advance to next aligned location
-        for (; kk < N - 1 && (kk & 3); kk++)
-        {
-            y = (cl_uint)((mt[kk] & UPPER_MASK) | (mt[kk + 1] & LOWER_MASK));
-            mt[kk] = mt[kk + (M - N)] ^ (y >> 1) ^ mag01[y & (cl_uint)0x1UL];
-        }
+    // advance to next aligned location
+    for (; kk < N - 1 && (kk & 3); kk++)
+    {
+        y = (cl_uint)((mt[kk] & UPPER_MASK) | (mt[kk + 1] & LOWER_MASK));
+        mt[kk] = mt[kk + (M - N)] ^ (y >> 1) ^ mag01[y & (cl_uint)0x1UL];
+    }
 
-        // vector loop
-        for (; kk + 4 <= N - 1; kk += 4)
-        {
-            __m128i vy = _mm_or_si128(
-                _mm_and_si128(_mm_load_si128((__m128i *)(mt + kk)),
-                              upper_mask.v),
-                // ((mt[kk]&UPPER_MASK)|(mt[kk+1]&LOWER_MASK))
-                _mm_and_si128(_mm_loadu_si128((__m128i *)(mt + kk + 1)),
-                              lower_mask.v));
-
-            // y & 1 ? -1 : 0
-            __m128i mask = _mm_cmpeq_epi32(_mm_and_si128(vy, one.v), one.v);
-            // y & 1 ? MATRIX_A, 0    =  mag01[y & (cl_uint) 0x1UL]
-            __m128i vmag01 = _mm_and_si128(mask, matrix_a.v);
-            // mt[kk+M-N] ^ (y >> 1)
-            __m128i vr =
-                _mm_xor_si128(_mm_loadu_si128((__m128i *)(mt + kk + M - N)),
-                              _mm_srli_epi32(vy, 1));
-            // mt[kk+M] ^ (y >> 1) ^ mag01[y & (cl_uint) 0x1UL]
-            vr = _mm_xor_si128(vr, vmag01);
-            _mm_store_si128((__m128i *)(mt + kk), vr);
-        }
+    // vector loop
+    for (; kk + 4 <= N - 1; kk += 4)
+    {
+        __m128i vy = _mm_or_si128(
+            _mm_and_si128(_mm_load_si128((__m128i *)(mt + kk)), upper_mask.v),
+            // ((mt[kk]&UPPER_MASK)|(mt[kk+1]&LOWER_MASK))
+            _mm_and_si128(_mm_loadu_si128((__m128i *)(mt + kk + 1)),
+                          lower_mask.v));
+
+        // y & 1 ? -1 : 0
+        __m128i mask = _mm_cmpeq_epi32(_mm_and_si128(vy, one.v), one.v);
+        // y & 1 ? MATRIX_A, 0    =  mag01[y & (cl_uint) 0x1UL]
+        __m128i vmag01 = _mm_and_si128(mask, matrix_a.v);
+        // mt[kk+M-N] ^ (y >> 1)
+        __m128i vr =
+            _mm_xor_si128(_mm_loadu_si128((__m128i *)(mt + kk + M - N)),
+                          _mm_srli_epi32(vy, 1));
+        // mt[kk+M] ^ (y >> 1) ^ mag01[y & (cl_uint) 0x1UL]
+        vr = _mm_xor_si128(vr, vmag01);
+        _mm_store_si128((__m128i *)(mt + kk), vr);
+    }
 #endif
 
-        for (; kk < N - 1; kk++)
-        {
-            y = (cl_uint)((mt[kk] & UPPER_MASK) | (mt[kk + 1] & LOWER_MASK));
-            mt[kk] = mt[kk + (M - N)] ^ (y >> 1) ^ mag01[y & (cl_uint)0x1UL];
-        }
-        y = (cl_uint)((mt[N - 1] & UPPER_MASK) | (mt[0] & LOWER_MASK));
-        mt[N - 1] = mt[M - 1] ^ (y >> 1) ^ mag01[y & (cl_uint)0x1UL];
+    for (; kk < N - 1; kk++)
+    {
+        y = (cl_uint)((mt[kk] & UPPER_MASK) | (mt[kk + 1] & LOWER_MASK));
+        mt[kk] = mt[kk + (M - N)] ^ (y >> 1) ^ mag01[y & (cl_uint)0x1UL];
+    }
+    y = (cl_uint)((mt[N - 1] & UPPER_MASK) | (mt[0] & LOWER_MASK));
+    mt[N - 1] = mt[M - 1] ^ (y >> 1) ^ mag01[y & (cl_uint)0x1UL];
 
 #ifdef __SSE2__
-        // Do the tempering ahead of time in vector code
-        for (kk = 0; kk + 4 <= N; kk += 4)
-        {
-            // y = mt[k];
-            __m128i vy = _mm_load_si128((__m128i *)(mt + kk));
-            // y ^= (y >> 11);
-            vy = _mm_xor_si128(vy, _mm_srli_epi32(vy, 11));
-            // y ^= (y << 7) & (cl_uint) 0x9d2c5680UL;
-            vy = _mm_xor_si128(vy, _mm_and_si128(_mm_slli_epi32(vy, 7), c0.v));
-            // y ^= (y << 15) & (cl_uint) 0xefc60000UL;
-            vy = _mm_xor_si128(vy, _mm_and_si128(_mm_slli_epi32(vy, 15), c1.v));
-            // y ^= (y >> 18);
-            vy = _mm_xor_si128(vy, _mm_srli_epi32(vy, 18));
-            _mm_store_si128((__m128i *)(d->cache + kk), vy);
-        }
+    // Do the tempering ahead of time in vector code
+    for (kk = 0; kk + 4 <= N; kk += 4)
+    {
+        // y = mt[k];
+        __m128i vy = _mm_load_si128((__m128i *)(mt + kk));
+        // y ^= (y >> 11);
+        vy = _mm_xor_si128(vy, _mm_srli_epi32(vy, 11));
+        // y ^= (y << 7) & (cl_uint) 0x9d2c5680UL;
+        vy = _mm_xor_si128(vy, _mm_and_si128(_mm_slli_epi32(vy, 7), c0.v));
+        // y ^= (y << 15) & (cl_uint) 0xefc60000UL;
+        vy = _mm_xor_si128(vy, _mm_and_si128(_mm_slli_epi32(vy, 15), c1.v));
+        // y ^= (y >> 18);
+        vy = _mm_xor_si128(vy, _mm_srli_epi32(vy, 18));
+        _mm_store_si128((__m128i *)(d->cache + kk), vy);
+    }
 #endif
 
-        d->mti = 0;
-    }
-#ifdef __SSE2__
-    y = d->cache[d->mti++];
-#else
-    y = mt[d->mti++];
+    d->mti = 0;
+}
 
-    /* Tempering */
+/* Tempering */
+static inline cl_uint genrand_temper(cl_uint y)
+{
     y ^= (y >> 11);
     y ^= (y << 7) & (cl_uint)0x9d2c5680UL;
     y ^= (y << 15) & (cl_uint)0xefc60000UL;
     y ^= (y >> 18);
+    return y;
+}
+
+/* generates a random number on [0,0xffffffff]-interval */
+cl_uint genrand_int32(MTdata d)
+{
+    if (d->counterBased)
+    {
+        cl_ulong block = d->counterIndex / 4;
+        if (d->counterBlock != block + 1)
+        {
+            philox_random_block(d->counterSeed, block, d->counterCache);
+            d->counterBlock = block + 1;
+        }
+        return d->counterCache[d->counterIndex++ % 4];
+    }
+
+    if (d->mti == N) genrand_regenerate(d);
+#ifdef __SSE2__
+    return d->cache[d->mti++];
+#else
+    return genrand_temper(d->mt[d->mti++]);
 #endif
+}
 
+void genrand_fill(MTdata d, cl_uint *out, size_t count)
+{
+    if (d->counterBased)
+    {
+        // Whole blocks go straight to out, the ends through genrand_int32
+        for (; count && (d->counterIndex & 3); count--)
+            *out++ = genrand_int32(d);
+        for (; count >= 4; count -= 4, out += 4)
+        {
+            philox_random_block(d->counterSeed, d->counterIndex / 4, out);
+            d->counterIndex += 4;
+        }
+        for (; count; count--) *out++ = genrand_int32(d);
+        return;
+    }
 
-    return y;
+    while (count)
+    {
+        if (d->mti == N) genrand_regenerate(d);
+        size_t n = std::min(count, (size_t)(N - d->mti));
+#ifdef __SSE2__
+        memcpy(out, d->cache + d->mti, n * sizeof(cl_uint));
+#else
+        for (size_t i = 0; i < n; i++)
+            out[i] = genrand_temper(d->mt[d->mti + i]);
+#endif
+        d->mti += (cl_int)n;
+        out += n;
+        count -= n;
+    }
 }
 
 cl_ulong genrand_int64(MTdata d)
@@ -66,12 +66,28 @@ typedef struct _MTdata *MTdata;
 /* Create the random number generator with seed */
 MTdata init_genrand(cl_uint /*seed*/);
 
+/* Create a counter-based (Philox4x32-10) generator for the stream selected by
+   seed, starting index 32-bit words into it. Any position of the stream can
+   be reached in constant time, so work split across threads can draw from
+   one reproducible stream whatever the thread count. */
+MTdata init_genrand_counter(cl_ulong /*seed*/, cl_ulong /*index*/);
+
+/* Create a counter-based generator starting count words ahead of d on the
+   same stream, or return NULL if d is a Mersenne Twister */
+MTdata genrand_split(MTdata /*data*/, cl_ulong /*count*/);
+
+/* Advance the generator by count 32-bit words */
+void genrand_skip(MTdata /*data*/, cl_ulong /*count*/);
+
 /* release memory used by a MTdata private data */
 void free_mtdata(MTdata /*data*/);
 
 /* generates a random number on [0,0xffffffff]-interval */
 cl_uint genrand_int32(MTdata /*data*/);
 
+/* fills out with the next count numbers genrand_int32 would return */
+void genrand_fill(MTdata /*data*/, cl_uint * /*out*/, size_t /*count*/);
+
 /* generates a random number on [0,0xffffffffffffffffULL]-interval */
 cl_ulong genrand_int64(MTdata /*data*/);
 
@@ -93,6 +109,9 @@ double genrand_res53(MTdata /*data*/);
 /* generates a random boolean */
 bool genrand_bool(MTdata /*data*/);
 
+/* true for generators created with init_genrand_counter or genrand_split */
+bool genrand_is_counter_based(MTdata /*data*/);
+
 #include <cassert>
 #include <utility>
 
@@ -105,6 +124,12 @@ public:
         assert(m_mtdata != nullptr);
     }
 
+    // Take ownership of a generator, e.g. from init_genrand_counter.
+    explicit MTdataHolder(MTdata d): m_mtdata(d)
+    {
+        assert(m_mtdata != nullptr);
+    }
+
     // Forbid copy.
     MTdataHolder(const MTdataHolder&) = delete;
     MTdataHolder& operator=(const MTdataHolder&) = delete;
@@ -15,6 +15,8 @@
 //
 #include "parseParameters.h"
 
+#include "bufferSizing.h"
+#include "durationHistory.h"
 #include "errorHelpers.h"
 #include "testHarness.h"
 #include "ThreadPool.h"
@@ -33,9 +35,21 @@ using namespace std;
 CompilationMode gCompilationMode = kOnline;
 CompilationCacheMode gCompilationCacheMode = kCacheModeCompileIfAbsent;
 std::string gCompilationCachePath = ".";
+bool gOnlineBinaryCache = false;
 std::string gCompilationProgram = DEFAULT_COMPILATION_PROGRAM;
 bool gDisableSPIRVValidation = false;
 std::string gSPIRVValidator = DEFAULT_SPIRV_VALIDATOR;
+bool gOfflineCompilationBatch = false;
+unsigned gOfflineCompilationJobs = 0;
+std::string gCheckpointPath;
+bool gResumeFromCheckpoint = false;
+size_t gBufferSizeOverride = 0;
+double gTimeBudgetSeconds = 0;
+uint64_t gHostMemBudget = 0;
+uint64_t gDeviceMemBudget = 0;
+bool gAllDevices = false;
+double gSoakSeconds = 0;
+bool gBench = false;
 unsigned gNumWorkerThreads;
 
 void helpInfo()
@@ -49,8 +63,56 @@ void helpInfo()
             online     Use online compilation (default)
             binary     Use binary offline compilation
             spir-v     Use SPIR-V offline compilation
-    --num-worker-threads <num>
-        Select parallel execution with the specified number of worker threads.
+    --num-worker-threads <num>, --jobs <num>
+        Run up to <num> tests at once, each with its own context and queue.
+        The output of each test is printed when it completes. Tests marked
+        serial only run one at a time once the others are done.
+    --online-binary-cache
+        In online mode, save the binaries of programs built from source in
+        the compilation cache path and reuse them on later runs with the same
+        source, build options, device and driver
+    --checkpoint-path <path>
+        In tests that support it, periodically record the completed jobs of
+        long exhaustive runs in state files under <path>
+    --resume
+        Skip the jobs recorded as completed in the checkpoint path by an
+        earlier, interrupted run
+    --buffer-size <bytes>
+        In tests that support it, stream the input domain through buffers of
+        <bytes>, a power of two of at least 65536, instead of picking a size
+        for the device
+    --time-budget <duration>
+        In tests with a wimpy mode, pick the full run or the smallest wimpy
+        reduction factor expected to finish within <duration>, such as 30m,
+        90s or 1h30m, from the durations recorded in
+        CL_CONFORMANCE_DURATION_DB by earlier runs on the same device
+    --host-mem-budget <size>, --device-mem-budget <size>
+        In tests that size their buffers and images from the memory
+        available, such as math_brute_force, allocations and the max size
+        image tests, use at most <size> of host or device memory, such as
+        512M or 4G, so that several suites can share a machine
+    --all-devices
+        Run the tests on every device of the requested type on the platform
+        at once, each in a process of its own with its output prefixed by
+        the index of the device, and results files named in the environment
+        getting _dev<index> before their extension
+    --soak <duration>
+        Run the selected tests again and again for <duration>, such as 8h,
+        logging a SOAK row per iteration with its run time, the resident
+        memory and open handles of the process and the free device memory,
+        then warn about run times that drift and resources that leak
+    -bench
+        Also time the tests that can print BENCH rows once they pass, such
+        as the work-group, sub-group and printf tests, and the D3D11 sharing
+        benchmark. Other benchmarks run when named and do not need it
+    --log-level <level>
+        Print only errors (error), errors and progress (info), or everything
+        including the detailed output of the math and conversion tests
+        (verbose, the default)
+    --buffered-log
+        Buffer the output of each thread and write it from a background
+        thread, for verbose runs where printing slows the tests down. Errors
+        are still printed straight away.
 
 For offline compilation (binary and spir-v modes) only:
     --compilation-cache-mode <cache-mode>
@@ -65,10 +127,17 @@ For offline compilation (binary and spir-v modes) only:
             dump-cl-files
                 Dumps the .cl and build .options files used by the test suite
     --compilation-cache-path <path>
-        Path for offline compiler output and CL source
+        Path for offline compiler output and CL source, and for the online
+        binary cache
     --compilation-program <prog>
         Program to use for offline compilation, defaults to:
             )" DEFAULT_COMPILATION_PROGRAM R"(
+    --offline-compilation-batch
+        Before the run, collect the kernels of the selected tests and compile
+        them into the cache all at once, several compiler processes at a time
+    --offline-compilation-jobs <num>
+        Run up to <num> compiler processes for the batch, one per core by
+        default
 
 For spir-v mode only:
     --disable-spirv-validation
@@ -81,6 +150,7 @@ For spir-v mode only:
 int parseCustomParam(int argc, const char *argv[], const char *ignore)
 {
     int delArg = 0;
+    bool bufferedLog = false;
 
     for (int i = 1; i < argc; i++)
     {
@@ -140,7 +210,8 @@ int parseCustomParam(int argc, const char *argv[], const char *ignore)
                 return -1;
             }
         }
-        else if (!strcmp(argv[i], "--num-worker-threads"))
+        else if (!strcmp(argv[i], "--num-worker-threads")
+                 || !strcmp(argv[i], "--jobs"))
         {
             delArg++;
             if ((i + 1) < argc)
@@ -152,8 +223,7 @@ int parseCustomParam(int argc, const char *argv[], const char *ignore)
             }
             else
             {
-                log_error(
-                    "A parameter to --num-worker-threads must be provided!\n");
+                log_error("A parameter to %s must be provided!\n", argv[i]);
                 return -1;
             }
         }
@@ -213,6 +283,11 @@ int parseCustomParam(int argc, const char *argv[], const char *ignore)
                 return -1;
             }
         }
+        else if (!strcmp(argv[i], "--online-binary-cache"))
+        {
+            delArg++;
+            gOnlineBinaryCache = true;
+        }
         else if (!strcmp(argv[i], "--compilation-program"))
         {
             delArg++;
@@ -228,6 +303,141 @@ int parseCustomParam(int argc, const char *argv[], const char *ignore)
                 return -1;
             }
         }
+        else if (!strcmp(argv[i], "--offline-compilation-batch"))
+        {
+            delArg++;
+            gOfflineCompilationBatch = true;
+        }
+        else if (!strcmp(argv[i], "--offline-compilation-jobs"))
+        {
+            delArg++;
+            if ((i + 1) < argc)
+            {
+                delArg++;
+                gOfflineCompilationJobs = atoi(argv[i + 1]);
+            }
+            else
+            {
+                log_error("A parameter to %s must be provided!\n", argv[i]);
+                return -1;
+            }
+        }
+        else if (!strcmp(argv[i], "--checkpoint-path"))
+        {
+            delArg++;
+            if ((i + 1) < argc)
+            {
+                delArg++;
+                gCheckpointPath = argv[i + 1];
+            }
+            else
+            {
+                log_error("Path argument for --checkpoint-path was not "
+                          "specified.\n");
+                return -1;
+            }
+        }
+        else if (!strcmp(argv[i], "--resume"))
+        {
+            delArg++;
+            gResumeFromCheckpoint = true;
+        }
+        else if (!strcmp(argv[i], "--buffer-size"))
+        {
+            delArg++;
+            unsigned long long size = 0;
+            if ((i + 1) < argc)
+            {
+                delArg++;
+                size = strtoull(argv[i + 1], NULL, 0);
+            }
+            if (size < 65536 || (size & (size - 1)) || size > SIZE_MAX)
+            {
+                log_error("--buffer-size must be a power of two of at least "
+                          "65536.\n");
+                return -1;
+            }
+            gBufferSizeOverride = (size_t)size;
+        }
+        else if (!strcmp(argv[i], "--time-budget"))
+        {
+            delArg++;
+            const char *budget = (i + 1) < argc ? argv[i + 1] : "";
+            if ((i + 1) < argc) delArg++;
+            if (!parse_duration(budget, gTimeBudgetSeconds))
+            {
+                log_error("--time-budget must be a duration such as 90s, 30m "
+                          "or 1h30m.\n");
+                return -1;
+            }
+        }
+        else if (!strcmp(argv[i], "--soak"))
+        {
+            delArg++;
+            const char *duration = (i + 1) < argc ? argv[i + 1] : "";
+            if ((i + 1) < argc) delArg++;
+            if (!parse_duration(duration, gSoakSeconds))
+            {
+                log_error("--soak must be a duration such as 90s, 30m or "
+                          "8h.\n");
+                return -1;
+            }
+        }
+        else if (!strcmp(argv[i], "--host-mem-budget")
+                 || !strcmp(argv[i], "--device-mem-budget"))
+        {
+            delArg++;
+            const char *budget = (i + 1) < argc ? argv[i + 1] : "";
+            if ((i + 1) < argc) delArg++;
+            uint64_t &bytes = !strcmp(argv[i], "--host-mem-budget")
+                ? gHostMemBudget
+                : gDeviceMemBudget;
+            if (!parse_memory_size(budget, bytes))
+            {
+                log_error("%s must be a size such as 65536, 512M or 4G.\n",
+                          argv[i]);
+                return -1;
+            }
+        }
+        else if (!strcmp(argv[i], "--log-level"))
+        {
+            delArg++;
+            const char *level = (i + 1) < argc ? argv[i + 1] : "";
+            if ((i + 1) < argc) delArg++;
+            if (!strcmp(level, "error"))
+            {
+                gLogLevel = kLogLevelError;
+            }
+            else if (!strcmp(level, "info"))
+            {
+                gLogLevel = kLogLevelInfo;
+            }
+            else if (!strcmp(level, "verbose"))
+            {
+                gLogLevel = kLogLevelVerbose;
+            }
+            else
+            {
+                log_error("--log-level must be one of error, info or "
+                          "verbose.\n");
+                return -1;
+            }
+        }
+        else if (!strcmp(argv[i], "--buffered-log"))
+        {
+            delArg++;
+            bufferedLog = true;
+        }
+        else if (!strcmp(argv[i], "--all-devices"))
+        {
+            delArg++;
+            gAllDevices = true;
+        }
+        else if (!strcmp(argv[i], "-bench"))
+        {
+            delArg++;
+            gBench = true;
+        }
         else if (!strcmp(argv[i], "--disable-spirv-validation"))
         {
             delArg++;
@@ -264,6 +474,34 @@ int parseCustomParam(int argc, const char *argv[], const char *ignore)
         return -1;
     }
 
+    if (gOfflineCompilationBatch
+        && (gCompilationMode == kOnline
+            || gCompilationCacheMode == kCacheModeForceRead
+            || gCompilationCacheMode == kCacheModeDumpCl))
+    {
+        log_error("--offline-compilation-batch needs an offline compilation "
+                  "mode and a cache mode that compiles.\n");
+        return -1;
+    }
+
+    if (gResumeFromCheckpoint && gCheckpointPath.empty())
+    {
+        log_error("--resume requires a --checkpoint-path.\n");
+        return -1;
+    }
+
+    if (bufferedLog)
+    {
+        // Its flusher thread would not survive the forks
+        if (gAllDevices)
+        {
+            log_error("--buffered-log can not be combined with "
+                      "--all-devices.\n");
+            return -1;
+        }
+        log_buffering_begin();
+    }
+
     return argc;
 }
 
@@ -37,9 +37,28 @@ enum CompilationCacheMode
 extern CompilationMode gCompilationMode;
 extern CompilationCacheMode gCompilationCacheMode;
 extern std::string gCompilationCachePath;
+extern bool gOnlineBinaryCache;
 extern std::string gCompilationProgram;
 extern bool gDisableSPIRVValidation;
 extern std::string gSPIRVValidator;
+extern bool gOfflineCompilationBatch;
+// Compiler processes of the batch, 0 for one per core
+extern unsigned gOfflineCompilationJobs;
+extern std::string gCheckpointPath;
+extern bool gResumeFromCheckpoint;
+extern size_t gBufferSizeOverride;
+// Seconds the tests with a wimpy mode should fit in, 0 if there's no budget
+extern double gTimeBudgetSeconds;
+// Bytes of host and device memory the tests should fit in, 0 if there's no
+// budget
+extern uint64_t gHostMemBudget;
+extern uint64_t gDeviceMemBudget;
+// Run on every device of the requested type at once
+extern bool gAllDevices;
+// Seconds to run the tests in a loop for, 0 to run them once
+extern double gSoakSeconds;
+// Also time the tests that can print BENCH rows once they pass
+extern bool gBench;
 
 extern int parseCustomParam(int argc, const char *argv[],
                             const char *ignore = 0);
@@ -0,0 +1,334 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "perfBaseline.h"
+
+#include "benchmark.h"
+#include "errorHelpers.h"
+#include "perfMetrics.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Fewer samples than this on either side make the normal approximation of
+// the U statistic too rough to trust, so only the medians are compared
+const size_t kMinTestedSamples = 8;
+const double kSignificance = 0.01;
+
+typedef std::tuple<std::string, std::string, std::string> metric_key;
+
+struct pooled_metric
+{
+    std::string unit;
+    bool higherIsBetter;
+    std::vector<double> values;
+};
+
+struct metric_change
+{
+    const metric_key *key;
+    const pooled_metric *metric;
+    double before;
+    double after;
+    double change;
+    bool tested;
+    double p;
+};
+
+void pool_metric(std::map<metric_key, pooled_metric> &pool,
+                 const perf_metric &metric)
+{
+    pooled_metric &pooled =
+        pool[metric_key(metric.test, metric.device, metric.name)];
+    pooled.unit = metric.unit;
+    pooled.higherIsBetter = metric.higherIsBetter;
+    if (metric.samples.empty())
+        pooled.values.push_back(metric.value);
+    else
+        pooled.values.insert(pooled.values.end(), metric.samples.begin(),
+                             metric.samples.end());
+}
+
+// Rows of fields, unquoting as save_perf_metrics quotes
+bool read_csv(const char *fileName, std::vector<std::vector<std::string>> &rows)
+{
+    FILE *file = fopen(fileName, "rb");
+    if (NULL == file) return false;
+
+    std::vector<std::string> row;
+    std::string field;
+    bool quoted = false;
+    int c;
+    while ((c = fgetc(file)) != EOF)
+    {
+        if (quoted)
+        {
+            if (c != '"')
+            {
+                field += (char)c;
+                continue;
+            }
+            int next = fgetc(file);
+            if (next == '"')
+            {
+                field += '"';
+                continue;
+            }
+            quoted = false;
+            if (next == EOF) break;
+            c = next;
+        }
+        if (c == '"')
+            quoted = true;
+        else if (c == ',')
+        {
+            row.push_back(field);
+            field.clear();
+        }
+        else if (c == '\n')
+        {
+            row.push_back(field);
+            field.clear();
+            rows.push_back(row);
+            row.clear();
+        }
+        else if (c != '\r')
+            field += (char)c;
+    }
+    if (!field.empty() || !row.empty())
+    {
+        row.push_back(field);
+        rows.push_back(row);
+    }
+
+    bool error = ferror(file) != 0;
+    return fclose(file) == 0 && !error;
+}
+
+bool read_baseline(const char *fileName,
+                   std::map<metric_key, pooled_metric> &baseline)
+{
+    std::vector<std::vector<std::string>> rows;
+    if (!read_csv(fileName, rows) || rows.empty()) return false;
+
+    const char *names[] = { "test", "device", "name", "value",
+                            "unit", "better", "samples" };
+    const size_t count = sizeof(names) / sizeof(names[0]);
+    size_t columns[count];
+    for (size_t i = 0; i < count; i++)
+    {
+        const std::vector<std::string> &header = rows[0];
+        columns[i] = std::find(header.begin(), header.end(), names[i])
+            - header.begin();
+        // Only the samples column is optional
+        if (columns[i] == header.size() && i + 1 < count) return false;
+    }
+
+    for (size_t r = 1; r < rows.size(); r++)
+    {
+        const std::vector<std::string> &row = rows[r];
+        std::string fields[count];
+        for (size_t i = 0; i < count; i++)
+            if (columns[i] < row.size()) fields[i] = row[columns[i]];
+
+        perf_metric metric;
+        metric.test = fields[0];
+        metric.device = fields[1];
+        metric.name = fields[2];
+        metric.value = strtod(fields[3].c_str(), NULL);
+        metric.unit = fields[4];
+        metric.higherIsBetter = fields[5] == "higher";
+
+        const char *next = fields[6].c_str();
+        for (;;)
+        {
+            char *end;
+            double sample = strtod(next, &end);
+            if (end == next) break;
+            metric.samples.push_back(sample);
+            next = end;
+        }
+        pool_metric(baseline, metric);
+    }
+    return true;
+}
+
+// Two-sided p-value of the Mann-Whitney U test that a and b come from the same
+// distribution, from the normal approximation with continuity and tie
+// corrections
+double mann_whitney_p(const std::vector<double> &a,
+                      const std::vector<double> &b)
+{
+    std::vector<std::pair<double, bool>> all;
+    for (double value : a) all.push_back(std::make_pair(value, true));
+    for (double value : b) all.push_back(std::make_pair(value, false));
+    std::sort(all.begin(), all.end());
+
+    double n1 = a.size(), n2 = b.size(), n = all.size();
+    double rankSum = 0;
+    double ties = 0;
+    for (size_t i = 0; i < all.size();)
+    {
+        size_t j = i;
+        while (j < all.size() && all[j].first == all[i].first) j++;
+        // Ranks i + 1 to j share their average
+        double rank = (i + 1 + j) / 2.0;
+        for (size_t k = i; k < j; k++)
+            if (all[k].second) rankSum += rank;
+        double t = j - i;
+        ties += t * t * t - t;
+        i = j;
+    }
+
+    double u = rankSum - n1 * (n1 + 1) / 2;
+    double variance = n1 * n2 / 12 * ((n + 1) - ties / (n * (n - 1)));
+    if (variance <= 0) return 1;
+    double z = (fabs(u - n1 * n2 / 2) - 0.5) / sqrt(variance);
+    return z > 0 ? erfc(z / sqrt(2.0)) : 1;
+}
+
+// Percentage in the environment variable name, or fallback if it is not set
+bool get_percent(const char *name, double fallback, double *percent)
+{
+    *percent = fallback;
+    const char *value = getenv(name);
+    if (value == nullptr) return true;
+
+    char *end;
+    *percent = strtod(value, &end);
+    if (end == value || *end != '\0' || !(*percent >= 0))
+    {
+        log_error("ERROR: %s must be a percentage, not '%s'.\n", name, value);
+        return false;
+    }
+    return true;
+}
+
+double median(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    return benchmark_percentile(values, 50);
+}
+
+void log_change(const char *kind, const metric_change &change)
+{
+    char p[32] = "";
+    if (change.tested) snprintf(p, sizeof(p), ", p=%.2g", change.p);
+    const std::string &device = std::get<1>(*change.key);
+    log_info("\t%s %s/%s%s%s: %g -> %g %s (%+.1f%%%s)\n", kind,
+             std::get<0>(*change.key).c_str(),
+             std::get<2>(*change.key).c_str(), device.empty() ? "" : " on ",
+             device.c_str(), change.before, change.after,
+             change.metric->unit.c_str(), change.change * 100, p);
+}
+
+} // anonymous namespace
+
+int compare_perf_baseline()
+{
+    const char *fileName = getenv("CL_CONFORMANCE_PERF_BASELINE");
+    if (fileName == nullptr)
+    {
+        return EXIT_SUCCESS;
+    }
+
+    double threshold, failThreshold;
+    if (!get_percent("CL_CONFORMANCE_PERF_THRESHOLD", 5, &threshold)
+        || !get_percent("CL_CONFORMANCE_PERF_FAIL_THRESHOLD", -1,
+                        &failThreshold))
+        return EXIT_FAILURE;
+
+    std::map<metric_key, pooled_metric> baseline;
+    if (!read_baseline(fileName, baseline))
+    {
+        log_error("ERROR: Failed to read the performance baseline '%s'.\n",
+                  fileName);
+        return EXIT_FAILURE;
+    }
+
+    std::map<metric_key, pooled_metric> current;
+    for (const perf_metric &metric : get_perf_metrics())
+        pool_metric(current, metric);
+
+    std::vector<metric_change> regressions, improvements;
+    size_t unchanged = 0, added = 0, failed = 0;
+    for (const auto &entry : current)
+    {
+        auto found = baseline.find(entry.first);
+        if (found == baseline.end())
+        {
+            added++;
+            continue;
+        }
+
+        const pooled_metric &before = found->second;
+        const pooled_metric &after = entry.second;
+        metric_change change;
+        change.key = &entry.first;
+        change.metric = &after;
+        change.before = median(before.values);
+        change.after = median(after.values);
+        change.change = change.before != 0
+            ? (change.after - change.before) / fabs(change.before)
+            : 0;
+        change.tested = before.values.size() >= kMinTestedSamples
+            && after.values.size() >= kMinTestedSamples;
+        change.p = change.tested ? mann_whitney_p(before.values, after.values)
+                                 : 1;
+
+        double percent = fabs(change.change) * 100;
+        if (percent < threshold || (change.tested && change.p >= kSignificance))
+            unchanged++;
+        else if ((change.change < 0) == after.higherIsBetter)
+        {
+            regressions.push_back(change);
+            if (failThreshold >= 0 && percent >= failThreshold) failed++;
+        }
+        else
+            improvements.push_back(change);
+    }
+
+    size_t missing = 0;
+    for (const auto &entry : baseline)
+        if (current.find(entry.first) == current.end()) missing++;
+
+    log_info("Performance against %s: %zu regressed, %zu improved, %zu "
+             "unchanged, %zu new, %zu missing.\n",
+             fileName, regressions.size(), improvements.size(), unchanged,
+             added, missing);
+    for (const metric_change &change : regressions)
+        log_change("REGRESSED", change);
+    for (const metric_change &change : improvements)
+        log_change("IMPROVED", change);
+
+    if (failed)
+    {
+        log_error("ERROR: %zu performance metrics regressed by at least "
+                  "%g%%.\n",
+                  failed, failThreshold);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
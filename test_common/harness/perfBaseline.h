@@ -0,0 +1,36 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef HARNESS_PERF_BASELINE_H_
+#define HARNESS_PERF_BASELINE_H_
+
+// Compares the perf metrics of this run against a baseline, the metrics CSV
+// that CL_CONFORMANCE_METRICS_FILENAME made earlier, named by
+// CL_CONFORMANCE_PERF_BASELINE. Metrics match by test, device and name, and
+// those recorded several times pool their values.
+//
+// When both sides have at least a handful of samples, a change is only
+// reported if a two-sided Mann-Whitney U test finds it significant at the 1%
+// level. Either way the medians must differ by at least
+// CL_CONFORMANCE_PERF_THRESHOLD percent, 5 by default.
+//
+// If CL_CONFORMANCE_PERF_FAIL_THRESHOLD is set, regressions by at least that
+// many percent fail the run.
+
+// Log the regressions and improvements against the baseline. Returns
+// EXIT_FAILURE if the baseline cannot be read or a regression fails the run.
+int compare_perf_baseline();
+
+#endif // HARNESS_PERF_BASELINE_H_
@@ -0,0 +1,273 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "perfMetrics.h"
+
+#include "errorHelpers.h"
+#include "stringHelpers.h"
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <mutex>
+
+namespace {
+
+std::mutex gMetricsMutex;
+std::vector<perf_metric> gMetrics;
+std::string gLastTest;
+std::string gLastDevice;
+thread_local const PerfMetricScope *gThreadScope = nullptr;
+
+// Prometheus label values escape backslash, double quote and newline
+std::string label_escape(const std::string &s)
+{
+    std::string out;
+    for (char c : s)
+    {
+        if (c == '\n')
+            out += "\\n";
+        else if (c == '"' || c == '\\')
+            out += std::string("\\") + c;
+        else
+            out += c;
+    }
+    return out;
+}
+
+std::string csv_escape(const std::string &s)
+{
+    if (s.find_first_of(",\"\n") == std::string::npos) return s;
+    std::string out = "\"";
+    for (char c : s)
+    {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    return out + "\"";
+}
+
+// JSON has no inf or nan, such as a rate over a zero time gives
+std::string json_number(double value)
+{
+    if (!isfinite(value)) return "null";
+    char text[32];
+    snprintf(text, sizeof(text), "%.17g", value);
+    return text;
+}
+
+const char *direction(const perf_metric &metric)
+{
+    return metric.higherIsBetter ? "higher" : "lower";
+}
+
+} // anonymous namespace
+
+void record_perf_metric(const std::string &name, double value,
+                        const std::string &unit, bool higherIsBetter)
+{
+    record_perf_metric(name, value, unit, higherIsBetter,
+                       std::vector<double>());
+}
+
+void record_perf_metric(const std::string &name, double value,
+                        const std::string &unit, bool higherIsBetter,
+                        const std::vector<double> &samples)
+{
+    record_perf_metric(name, value, unit, higherIsBetter, samples,
+                       std::vector<telemetry_summary>());
+}
+
+void record_perf_metric(const std::string &name, double value,
+                        const std::string &unit, bool higherIsBetter,
+                        const std::vector<double> &samples,
+                        const std::vector<telemetry_summary> &telemetry)
+{
+    std::lock_guard<std::mutex> lock(gMetricsMutex);
+    perf_metric metric = { gThreadScope ? gThreadScope->m_test : gLastTest,
+                           gThreadScope ? gThreadScope->m_device : gLastDevice,
+                           name,
+                           unit,
+                           value,
+                           higherIsBetter,
+                           samples,
+                           telemetry };
+    gMetrics.push_back(metric);
+}
+
+std::string get_perf_metric_device()
+{
+    std::lock_guard<std::mutex> lock(gMetricsMutex);
+    return gThreadScope ? gThreadScope->m_device : gLastDevice;
+}
+
+std::vector<perf_metric> get_perf_metrics()
+{
+    std::lock_guard<std::mutex> lock(gMetricsMutex);
+    return gMetrics;
+}
+
+void clear_perf_metrics()
+{
+    std::lock_guard<std::mutex> lock(gMetricsMutex);
+    gMetrics.clear();
+}
+
+void log_perf_metric(double number, bool higherBetter, const char *numType,
+                     const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(NULL, 0, format, args);
+    va_end(args);
+
+    std::vector<char> name(length > 0 ? length + 1 : 1, '\0');
+    va_start(args, format);
+    vsnprintf(name.data(), name.size(), format, args);
+    va_end(args);
+
+    log_printf("Performance Number %s (in %s, %s): %g\n", name.data(),
+               numType, higherBetter ? "higher is better" : "lower is better",
+               number);
+    record_perf_metric(name.data(), number, numType, higherBetter);
+}
+
+PerfMetricScope::PerfMetricScope(const char *testName, cl_device_id device)
+    : m_test(testName), m_previous(gThreadScope)
+{
+    size_t size = 0;
+    if (CL_SUCCESS == clGetDeviceInfo(device, CL_DEVICE_NAME, 0, NULL, &size)
+        && size > 0)
+    {
+        std::vector<char> deviceName(size);
+        if (CL_SUCCESS
+            == clGetDeviceInfo(device, CL_DEVICE_NAME, size, deviceName.data(),
+                               NULL))
+            m_device = deviceName.data();
+    }
+
+    std::lock_guard<std::mutex> lock(gMetricsMutex);
+    gLastTest = m_test;
+    gLastDevice = m_device;
+    gThreadScope = this;
+}
+
+PerfMetricScope::~PerfMetricScope() { gThreadScope = m_previous; }
+
+void write_perf_metrics_json(FILE *file, const char *indent)
+{
+    std::lock_guard<std::mutex> lock(gMetricsMutex);
+    for (size_t i = 0; i < gMetrics.size(); i++)
+    {
+        const perf_metric &metric = gMetrics[i];
+        fprintf(file,
+                "%s%s{ \"test\": \"%s\", \"device\": \"%s\", \"name\": "
+                "\"%s\", \"value\": %s, \"unit\": \"%s\", \"better\": "
+                "\"%s\"",
+                i ? ",\n" : "", indent, json_escape(metric.test).c_str(),
+                json_escape(metric.device).c_str(),
+                json_escape(metric.name).c_str(),
+                json_number(metric.value).c_str(),
+                json_escape(metric.unit).c_str(), direction(metric));
+        if (!metric.telemetry.empty())
+        {
+            fprintf(file, ", \"telemetry\": [");
+            for (size_t j = 0; j < metric.telemetry.size(); j++)
+            {
+                const telemetry_summary &channel = metric.telemetry[j];
+                fprintf(file,
+                        "%s{ \"name\": \"%s\", \"unit\": \"%s\", "
+                        "\"samples\": %zu, \"min\": %s, \"mean\": %s, "
+                        "\"max\": %s }",
+                        j ? ", " : " ", json_escape(channel.name).c_str(),
+                        json_escape(channel.unit).c_str(), channel.samples,
+                        json_number(channel.min).c_str(),
+                        json_number(channel.mean).c_str(),
+                        json_number(channel.max).c_str());
+            }
+            fprintf(file, " ]");
+        }
+        fprintf(file, " }");
+    }
+    if (!gMetrics.empty()) fprintf(file, "\n");
+}
+
+int save_perf_metrics(const char *suiteName)
+{
+    const char *fileName = getenv("CL_CONFORMANCE_METRICS_FILENAME");
+    if (fileName == nullptr)
+    {
+        return EXIT_SUCCESS;
+    }
+
+    FILE *file = fopen(fileName, "w");
+    if (NULL == file)
+    {
+        log_error("ERROR: Failed to open '%s' for writing metrics.\n",
+                  fileName);
+        return EXIT_FAILURE;
+    }
+
+    size_t length = strlen(fileName);
+    bool prometheus = length >= 5 && !strcmp(fileName + length - 5, ".prom");
+
+    std::vector<perf_metric> metrics = get_perf_metrics();
+    if (prometheus)
+    {
+        fprintf(file,
+                "# HELP cl_cts_perf_metric Performance number recorded by "
+                "a conformance test.\n");
+        fprintf(file, "# TYPE cl_cts_perf_metric gauge\n");
+    }
+    else
+    {
+        fprintf(file, "suite,test,device,name,value,unit,better,samples\n");
+    }
+    for (const perf_metric &metric : metrics)
+    {
+        if (prometheus)
+            fprintf(file,
+                    "cl_cts_perf_metric{suite=\"%s\",test=\"%s\",device=\"%s\","
+                    "name=\"%s\",unit=\"%s\",better=\"%s\"} %.17g\n",
+                    label_escape(suiteName).c_str(),
+                    label_escape(metric.test).c_str(),
+                    label_escape(metric.device).c_str(),
+                    label_escape(metric.name).c_str(),
+                    label_escape(metric.unit).c_str(), direction(metric),
+                    metric.value);
+        else
+        {
+            fprintf(file, "%s,%s,%s,%s,%.17g,%s,%s,",
+                    csv_escape(suiteName).c_str(),
+                    csv_escape(metric.test).c_str(),
+                    csv_escape(metric.device).c_str(),
+                    csv_escape(metric.name).c_str(), metric.value,
+                    csv_escape(metric.unit).c_str(), direction(metric));
+            // Space separated, so the column needs no quoting
+            for (size_t i = 0; i < metric.samples.size(); i++)
+                fprintf(file, "%s%.17g", i ? " " : "", metric.samples[i]);
+            fprintf(file, "\n");
+        }
+    }
+
+    int ret = fclose(file) ? EXIT_FAILURE : EXIT_SUCCESS;
+
+    log_info("Saving %zu performance metrics to %s: %s!\n", metrics.size(),
+             fileName, ret == EXIT_SUCCESS ? "success" : "failure");
+
+    return ret;
+}
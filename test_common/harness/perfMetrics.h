@@ -0,0 +1,105 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef HARNESS_PERF_METRICS_H_
+#define HARNESS_PERF_METRICS_H_
+
+#include "compat.h"
+#include "telemetry.h"
+
+#include <CL/opencl.h>
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+// Performance numbers recorded by the tests, kept in memory for the whole
+// run. Every log_perf/vlog_perf call records one, and tests may record more
+// with record_perf_metric. The harness adds them to the results JSON written
+// to CL_CONFORMANCE_RESULTS_FILENAME, and writes them to
+// CL_CONFORMANCE_METRICS_FILENAME if set, in Prometheus text format if the
+// name ends in ".prom" and as CSV otherwise. A metric may keep the samples its
+// value summarises, which the CSV lists so that a later run can compare
+// against them (see perfBaseline.h), and the telemetry read while it was
+// measured (see telemetry.h), which the JSON lists.
+struct perf_metric
+{
+    std::string test;
+    std::string device;
+    std::string name;
+    std::string unit;
+    double value;
+    bool higherIsBetter;
+    std::vector<double> samples;
+    std::vector<telemetry_summary> telemetry;
+};
+
+// Record value as the metric name, in unit, of the test running on the
+// calling thread
+void record_perf_metric(const std::string &name, double value,
+                        const std::string &unit, bool higherIsBetter);
+
+// Record value along with the samples it summarises
+void record_perf_metric(const std::string &name, double value,
+                        const std::string &unit, bool higherIsBetter,
+                        const std::vector<double> &samples);
+
+// Record value along with its samples and the telemetry read while they were
+// taken
+void record_perf_metric(const std::string &name, double value,
+                        const std::string &unit, bool higherIsBetter,
+                        const std::vector<double> &samples,
+                        const std::vector<telemetry_summary> &telemetry);
+
+std::vector<perf_metric> get_perf_metrics();
+
+// Forget the metrics recorded so far
+void clear_perf_metrics();
+
+// Device of the test running on the calling thread, the one its metrics are
+// recorded against
+std::string get_perf_metric_device();
+
+// Attributes the metrics recorded on the calling thread to a test and device
+// while in scope. Metrics recorded on other threads, such as the thread pool
+// workers, go to the test that started last.
+class PerfMetricScope {
+public:
+    PerfMetricScope(const char *testName, cl_device_id device);
+    ~PerfMetricScope();
+
+private:
+    PerfMetricScope(const PerfMetricScope &) = delete;
+    PerfMetricScope &operator=(const PerfMetricScope &) = delete;
+
+    friend void record_perf_metric(const std::string &, double,
+                                   const std::string &, bool,
+                                   const std::vector<double> &,
+                                   const std::vector<telemetry_summary> &);
+    friend std::string get_perf_metric_device();
+
+    std::string m_test;
+    std::string m_device;
+    const PerfMetricScope *m_previous;
+};
+
+// Write the metrics as the members of a JSON array, each line starting with
+// indent. Writes nothing if there are none.
+void write_perf_metrics_json(FILE *file, const char *indent);
+
+// Write the metrics to CL_CONFORMANCE_METRICS_FILENAME if it is set
+int save_perf_metrics(const char *suiteName);
+
+#endif // HARNESS_PERF_METRICS_H_
@@ -0,0 +1,67 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef HARNESS_PHILOX_H_
+#define HARNESS_PHILOX_H_
+
+#if defined(__APPLE__)
+#include <OpenCL/cl_platform.h>
+#else
+#include <CL/cl_platform.h>
+#endif
+
+// Philox4x32-10 counter-based generator (Salmon et al., "Parallel random
+// numbers: as easy as 1, 2, 3", SC'11). Each 128-bit counter maps to four
+// random words with no state, so any part of a stream can be regenerated
+// independently, in any order and on any thread.
+inline void philox4x32_10(const cl_uint counter[4], const cl_uint key[2],
+                          cl_uint out[4])
+{
+    cl_uint c0 = counter[0], c1 = counter[1], c2 = counter[2],
+            c3 = counter[3];
+    cl_uint k0 = key[0], k1 = key[1];
+
+    for (int round = 0; round < 10; round++)
+    {
+        cl_ulong p0 = (cl_ulong)0xD2511F53u * c0;
+        cl_ulong p1 = (cl_ulong)0xCD9E8D57u * c2;
+        cl_uint n0 = (cl_uint)(p1 >> 32) ^ c1 ^ k0;
+        cl_uint n2 = (cl_uint)(p0 >> 32) ^ c3 ^ k1;
+        c1 = (cl_uint)p1;
+        c3 = (cl_uint)p0;
+        c0 = n0;
+        c2 = n2;
+        k0 += 0x9E3779B9u;
+        k1 += 0xBB67AE85u;
+    }
+
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+}
+
+// Fills out with the four words at positions [4 * block, 4 * block + 4) of
+// the stream selected by seed.
+inline void philox_random_block(cl_ulong seed, cl_ulong block, cl_uint out[4])
+{
+    const cl_uint counter[4] = { (cl_uint)block, (cl_uint)(block >> 32), 0,
+                                 0 };
+    const cl_uint key[2] = { (cl_uint)seed, (cl_uint)(seed >> 32) };
+    philox4x32_10(counter, key, out);
+}
+
+#endif // HARNESS_PHILOX_H_
@@ -0,0 +1,226 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "soak.h"
+
+#include "deviceInfo.h"
+#include "errorHelpers.h"
+#include "perfMetrics.h"
+
+#include <math.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <psapi.h>
+#else
+#include <dirent.h>
+#include <unistd.h>
+#endif
+
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#endif
+
+#ifndef CL_DEVICE_GLOBAL_FREE_MEMORY_AMD
+#define CL_DEVICE_GLOBAL_FREE_MEMORY_AMD 0x4039
+#endif
+
+namespace {
+
+// A leak is reported once the last quarter of the iterations uses this
+// fraction more than the first, and run times drift past this fraction too
+const double kGrowthThreshold = 0.10;
+
+struct SoakSample
+{
+    double seconds;
+    double rssKb; // < 0 if unknown
+    double handles; // < 0 if unknown
+    double deviceFreeKb; // < 0 if unknown
+    int failed;
+};
+
+// Current resident set size of the process in KiB, or -1
+double get_resident_kb()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters,
+                              sizeof(counters)))
+        return -1;
+    return counters.WorkingSetSize / 1024.0;
+#elif defined(__APPLE__)
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info,
+                  &count)
+        != KERN_SUCCESS)
+        return -1;
+    return info.resident_size / 1024.0;
+#else
+    FILE *file = fopen("/proc/self/statm", "r");
+    if (file == NULL) return -1;
+    unsigned long size, resident;
+    int fields = fscanf(file, "%lu %lu", &size, &resident);
+    fclose(file);
+    if (fields != 2) return -1;
+    return resident * (sysconf(_SC_PAGESIZE) / 1024.0);
+#endif
+}
+
+// Open handles or file descriptors of the process, or -1
+double get_open_handles()
+{
+#if defined(_WIN32)
+    DWORD count;
+    if (!GetProcessHandleCount(GetCurrentProcess(), &count)) return -1;
+    return count;
+#else
+#if defined(__APPLE__)
+    DIR *dir = opendir("/dev/fd");
+#else
+    DIR *dir = opendir("/proc/self/fd");
+#endif
+    if (dir == NULL) return -1;
+    double count = 0;
+    while (struct dirent *entry = readdir(dir))
+        if (entry->d_name[0] != '.') count++;
+    closedir(dir);
+    return count - 1; // the directory itself
+#endif
+}
+
+// Free global memory of the device in KiB, or -1 if it doesn't report it
+double get_device_free_kb(cl_device_id device)
+{
+    // The total free memory and the largest free block, in KiB
+    size_t free[2];
+    if (!is_extension_available(device, "cl_amd_device_attribute_query")
+        || clGetDeviceInfo(device, CL_DEVICE_GLOBAL_FREE_MEMORY_AMD,
+                           sizeof(free), free, NULL))
+        return -1;
+    return (double)free[0];
+}
+
+double median(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    size_t n = values.size();
+    return n % 2 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+}
+
+// Report how a quantity of the samples moved from the first to the last
+// quarter of the iterations, skipping the first iteration, which warms up
+// caches, when there are enough. Returns the relative growth, 0 if unknown.
+double log_trend(const std::vector<SoakSample> &samples,
+                 double SoakSample::*field, const char *name,
+                 const char *unit)
+{
+    std::vector<double> values;
+    for (size_t i = samples.size() > 4 ? 1 : 0; i < samples.size(); i++)
+        if (samples[i].*field >= 0) values.push_back(samples[i].*field);
+    if (values.size() < 4)
+    {
+        log_info("\t%s: not enough samples\n", name);
+        return 0;
+    }
+
+    size_t quarter = values.size() / 4;
+    double first = median(std::vector<double>(values.begin(),
+                                              values.begin() + quarter));
+    double last =
+        median(std::vector<double>(values.end() - quarter, values.end()));
+
+    // Least squares slope over the iterations
+    double n = values.size(), meanX = (n - 1) / 2, meanY = 0;
+    for (double value : values) meanY += value / n;
+    double covariance = 0, variance = 0;
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        covariance += (i - meanX) * (values[i] - meanY);
+        variance += (i - meanX) * (i - meanX);
+    }
+
+    double growth = first != 0 ? (last - first) / fabs(first) : 0;
+    log_info("\t%s: %g -> %g%s (%+.1f%%), %+g%s per iteration\n", name,
+             first, last, unit, growth * 100, covariance / variance, unit);
+    return growth;
+}
+
+} // anonymous namespace
+
+int run_soak(double seconds, cl_device_id device,
+             const SoakIterationFn &iteration)
+{
+    log_info("SOAK\titeration\tseconds\trss_kb\thandles\tdevice_free_kb"
+             "\tfailed\n");
+
+    std::vector<SoakSample> samples;
+    int failedIterations = 0;
+    auto soakStart = std::chrono::steady_clock::now();
+    do
+    {
+        auto start = std::chrono::steady_clock::now();
+        int failed = iteration();
+        std::chrono::duration<double> time =
+            std::chrono::steady_clock::now() - start;
+
+        SoakSample sample = { time.count(), get_resident_kb(),
+                              get_open_handles(), get_device_free_kb(device),
+                              failed };
+        samples.push_back(sample);
+        if (failed) failedIterations++;
+        log_info("SOAK\t%zu\t%.3f\t%.0f\t%.0f\t%.0f\t%d\n", samples.size(),
+                 sample.seconds, sample.rssKb, sample.handles,
+                 sample.deviceFreeKb, sample.failed);
+    } while (std::chrono::duration<double>(std::chrono::steady_clock::now()
+                                           - soakStart)
+                 .count()
+             < seconds);
+
+    log_info("Soak: %zu iterations, %d with failures, first to last quarter:\n",
+             samples.size(), failedIterations);
+    double timeGrowth =
+        log_trend(samples, &SoakSample::seconds, "run time", " s");
+    double rssGrowth =
+        log_trend(samples, &SoakSample::rssKb, "host resident memory", " KiB");
+    double handleGrowth =
+        log_trend(samples, &SoakSample::handles, "open handles", "");
+    double freeGrowth = log_trend(samples, &SoakSample::deviceFreeKb,
+                                  "free device memory", " KiB");
+
+    if (timeGrowth > kGrowthThreshold)
+        log_info("WARNING: Run time drifted up by %.1f%%.\n", timeGrowth * 100);
+    if (rssGrowth > kGrowthThreshold)
+        log_info("WARNING: Host memory grew by %.1f%%, a possible leak.\n",
+                 rssGrowth * 100);
+    if (handleGrowth > 0)
+        log_info("WARNING: Open handles grew by %.1f%%, a possible leak.\n",
+                 handleGrowth * 100);
+    if (freeGrowth < -kGrowthThreshold)
+        log_info("WARNING: Free device memory shrank by %.1f%%, a possible "
+                 "leak.\n",
+                 -freeGrowth * 100);
+
+    record_perf_metric("soak.run_time_growth", timeGrowth * 100, "%", false);
+    record_perf_metric("soak.rss_growth", rssGrowth * 100, "%", false);
+    record_perf_metric("soak.handle_growth", handleGrowth * 100, "%", false);
+    return failedIterations;
+}
@@ -0,0 +1,40 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef HARNESS_SOAK_H_
+#define HARNESS_SOAK_H_
+
+#include "compat.h"
+
+#include <CL/opencl.h>
+
+#include <functional>
+
+// Soak testing, for --soak: the selected tests run again and again for a
+// duration, and each iteration logs a SOAK row with its run time, the
+// resident memory and open handles of the process, and the free device
+// memory where the device reports it (cl_amd_device_attribute_query). At the
+// end the first and last quarters of the iterations are compared, to point
+// out run times that drift and resources that leak.
+
+// Returns the number of tests that failed in the iteration
+typedef std::function<int()> SoakIterationFn;
+
+// Run iteration until seconds have passed, at least once, and report the
+// trends. Returns the number of iterations in which tests failed.
+int run_soak(double seconds, cl_device_id device,
+             const SoakIterationFn &iteration);
+
+#endif // HARNESS_SOAK_H_
@@ -0,0 +1,281 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "stagingPool.h"
+
+#include "errorHelpers.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+// Large enough to keep the bus busy, small enough that copying one chunk on
+// the host overlaps well with the transfer of the other
+const size_t kSlotSize = 8 << 20;
+// Below this the extra copy costs more than the staging saves
+const size_t kMinStagedSize = 256 << 10;
+
+struct StagingSlot
+{
+    cl_mem buffer;
+    void *host;
+    // The queue it was mapped on, and will be unmapped on
+    cl_command_queue mapQueue;
+    // The last transfer through it, and for a read where in the caller's
+    // memory that chunk goes once it's done
+    cl_event pending;
+    char *copyTo;
+    size_t copySize;
+    bool inUse;
+};
+
+struct ContextPool
+{
+    std::vector<std::unique_ptr<StagingSlot>> slots;
+    // If a staging buffer couldn't be created or mapped
+    bool disabled = false;
+};
+
+std::mutex gPoolMutex;
+std::map<cl_context, ContextPool> gPools;
+std::map<cl_device_id, bool> gStagedDevices;
+
+// Whether to stage size bytes on queue, and its context if so
+bool should_stage(cl_command_queue queue, size_t size, cl_bool blocking,
+                  bool read, cl_event *event, cl_context &context)
+{
+    static const bool enabled = [] {
+        const char *env = getenv("CL_TEST_STAGING");
+        return env == NULL || strcmp(env, "0") != 0;
+    }();
+    if (!enabled || size < kMinStagedSize || event != NULL
+        || (read && !blocking))
+        return false;
+
+    cl_device_id device;
+    if (clGetCommandQueueInfo(queue, CL_QUEUE_DEVICE, sizeof(device), &device,
+                              NULL)
+            != CL_SUCCESS
+        || clGetCommandQueueInfo(queue, CL_QUEUE_CONTEXT, sizeof(context),
+                                 &context, NULL)
+            != CL_SUCCESS)
+        return false;
+
+    std::lock_guard<std::mutex> lock(gPoolMutex);
+    auto it = gStagedDevices.find(device);
+    if (it == gStagedDevices.end())
+    {
+        // Host memory already is device memory on a CPU device
+        cl_device_type type = 0;
+        clGetDeviceInfo(device, CL_DEVICE_TYPE, sizeof(type), &type, NULL);
+        it = gStagedDevices
+                 .insert(std::make_pair(
+                     device, (type & CL_DEVICE_TYPE_CPU) == 0 && type != 0))
+                 .first;
+    }
+    if (!it->second) return false;
+    auto pool = gPools.find(context);
+    return pool == gPools.end() || !pool->second.disabled;
+}
+
+// A free slot of context, or NULL if no more can be made
+StagingSlot *acquire_slot(cl_command_queue queue, cl_context context)
+{
+    {
+        std::lock_guard<std::mutex> lock(gPoolMutex);
+        ContextPool &pool = gPools[context];
+        if (pool.disabled) return NULL;
+        for (auto &slot : pool.slots)
+            if (!slot->inUse)
+            {
+                slot->inUse = true;
+                return slot.get();
+            }
+    }
+
+    std::unique_ptr<StagingSlot> slot(new StagingSlot());
+    cl_int error;
+    slot->buffer = clCreateBuffer(context,
+                                  CL_MEM_ALLOC_HOST_PTR | CL_MEM_READ_WRITE,
+                                  kSlotSize, NULL, &error);
+    if (slot->buffer != NULL)
+        slot->host = clEnqueueMapBuffer(queue, slot->buffer, CL_TRUE,
+                                        CL_MAP_READ | CL_MAP_WRITE, 0,
+                                        kSlotSize, 0, NULL, NULL, &error);
+
+    std::lock_guard<std::mutex> lock(gPoolMutex);
+    ContextPool &pool = gPools[context];
+    if (slot->buffer == NULL || slot->host == NULL)
+    {
+        if (!pool.disabled)
+            log_error("Warning: Could not create a staging buffer (%d), "
+                      "transfers will not be staged\n",
+                      error);
+        if (slot->buffer != NULL) clReleaseMemObject(slot->buffer);
+        pool.disabled = true;
+        return NULL;
+    }
+    clRetainCommandQueue(queue);
+    slot->mapQueue = queue;
+    slot->inUse = true;
+    pool.slots.push_back(std::move(slot));
+    return pool.slots.back().get();
+}
+
+// Wait for the last transfer through slot, and copy out what it read
+cl_int finish_slot(StagingSlot *slot)
+{
+    if (slot->pending == NULL) return CL_SUCCESS;
+    cl_int error = clWaitForEvents(1, &slot->pending);
+    clReleaseEvent(slot->pending);
+    slot->pending = NULL;
+    if (error == CL_SUCCESS && slot->copySize != 0)
+        memcpy(slot->copyTo, slot->host, slot->copySize);
+    slot->copySize = 0;
+    return error;
+}
+
+void release_slot(StagingSlot *slot)
+{
+    std::lock_guard<std::mutex> lock(gPoolMutex);
+    slot->inUse = false;
+}
+
+// Move size bytes between ptr and buffer through up to two slots in turn.
+// A write that doesn't block leaves its last transfers pending on the
+// slots, for whoever takes them next to wait for.
+cl_int transfer_staged(cl_command_queue queue, cl_context context,
+                       cl_mem buffer, bool read, cl_bool blocking,
+                       size_t offset, size_t size, char *ptr,
+                       cl_uint num_events_in_wait_list,
+                       const cl_event *event_wait_list, bool &staged)
+{
+    StagingSlot *slots[2] = { acquire_slot(queue, context), NULL };
+    staged = slots[0] != NULL;
+    if (!staged) return CL_SUCCESS;
+    if (size > kSlotSize) slots[1] = acquire_slot(queue, context);
+    size_t slotCount = slots[1] != NULL ? 2 : 1;
+
+    cl_int error = CL_SUCCESS;
+    for (size_t done = 0, chunk = 0; done < size && error == CL_SUCCESS;
+         done += kSlotSize, chunk++)
+    {
+        StagingSlot *slot = slots[chunk % slotCount];
+        size_t chunkSize = std::min(kSlotSize, size - done);
+        if ((error = finish_slot(slot)) != CL_SUCCESS) break;
+        if (read)
+        {
+            error = clEnqueueReadBuffer(queue, buffer, CL_FALSE, offset + done,
+                                        chunkSize, slot->host,
+                                        num_events_in_wait_list,
+                                        event_wait_list, &slot->pending);
+            slot->copyTo = ptr + done;
+            slot->copySize = error == CL_SUCCESS ? chunkSize : 0;
+        }
+        else
+        {
+            memcpy(slot->host, ptr + done, chunkSize);
+            error = clEnqueueWriteBuffer(queue, buffer, CL_FALSE,
+                                         offset + done, chunkSize, slot->host,
+                                         num_events_in_wait_list,
+                                         event_wait_list, &slot->pending);
+        }
+        if (error != CL_SUCCESS) slot->pending = NULL;
+    }
+
+    // Other threads may wait on what is left pending, so it has to be
+    // submitted
+    cl_int flushError = clFlush(queue);
+    if (error == CL_SUCCESS) error = flushError;
+    for (size_t i = 0; i < slotCount; i++)
+    {
+        if (read || blocking || error != CL_SUCCESS)
+        {
+            cl_int finishError = finish_slot(slots[i]);
+            if (error == CL_SUCCESS) error = finishError;
+        }
+        release_slot(slots[i]);
+    }
+    return error;
+}
+
+} // anonymous namespace
+
+cl_int enqueue_write_staged(cl_command_queue queue, cl_mem buffer,
+                            cl_bool blocking, size_t offset, size_t size,
+                            const void *ptr, cl_uint num_events_in_wait_list,
+                            const cl_event *event_wait_list, cl_event *event)
+{
+    cl_context context;
+    if (should_stage(queue, size, blocking, false, event, context))
+    {
+        bool staged;
+        cl_int error = transfer_staged(
+            queue, context, buffer, false, blocking, offset, size,
+            (char *)ptr, num_events_in_wait_list, event_wait_list, staged);
+        if (staged) return error;
+    }
+    return clEnqueueWriteBuffer(queue, buffer, blocking, offset, size, ptr,
+                                num_events_in_wait_list, event_wait_list,
+                                event);
+}
+
+cl_int enqueue_read_staged(cl_command_queue queue, cl_mem buffer,
+                           cl_bool blocking, size_t offset, size_t size,
+                           void *ptr, cl_uint num_events_in_wait_list,
+                           const cl_event *event_wait_list, cl_event *event)
+{
+    cl_context context;
+    if (should_stage(queue, size, blocking, true, event, context))
+    {
+        bool staged;
+        cl_int error = transfer_staged(
+            queue, context, buffer, true, blocking, offset, size, (char *)ptr,
+            num_events_in_wait_list, event_wait_list, staged);
+        if (staged) return error;
+    }
+    return clEnqueueReadBuffer(queue, buffer, blocking, offset, size, ptr,
+                               num_events_in_wait_list, event_wait_list,
+                               event);
+}
+
+void release_staging_buffers(cl_context context)
+{
+    ContextPool pool;
+    {
+        std::lock_guard<std::mutex> lock(gPoolMutex);
+        auto it = gPools.find(context);
+        if (it == gPools.end()) return;
+        pool = std::move(it->second);
+        gPools.erase(it);
+    }
+
+    for (auto &slot : pool.slots)
+    {
+        finish_slot(slot.get());
+        clEnqueueUnmapMemObject(slot->mapQueue, slot->buffer, slot->host, 0,
+                                NULL, NULL);
+        clFinish(slot->mapQueue);
+        clReleaseMemObject(slot->buffer);
+        clReleaseCommandQueue(slot->mapQueue);
+    }
+}
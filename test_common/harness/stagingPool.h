@@ -0,0 +1,48 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef HARNESS_STAGING_POOL_H_
+#define HARNESS_STAGING_POOL_H_
+
+#include <CL/opencl.h>
+
+#include <stddef.h>
+
+// Drop-in replacements for clEnqueueWriteBuffer and clEnqueueReadBuffer for
+// the bulk transfers of a suite, as opposed to the transfers a test is
+// about. Transfers from and to pageable memory are usually staged by the
+// driver through a bounce buffer of its own, so these copy through a pool of
+// CL_MEM_ALLOC_HOST_PTR buffers that stay mapped for the life of the
+// context instead, one chunk while the previous one is on the bus.
+//
+// Small transfers, transfers on CPU devices, reads that don't block and
+// calls that ask for an event go straight to the OpenCL call, as does
+// everything if CL_TEST_STAGING=0 is set in the environment. A write that
+// doesn't block is done with ptr when it returns.
+cl_int enqueue_write_staged(cl_command_queue queue, cl_mem buffer,
+                            cl_bool blocking, size_t offset, size_t size,
+                            const void *ptr, cl_uint num_events_in_wait_list,
+                            const cl_event *event_wait_list, cl_event *event);
+cl_int enqueue_read_staged(cl_command_queue queue, cl_mem buffer,
+                           cl_bool blocking, size_t offset, size_t size,
+                           void *ptr, cl_uint num_events_in_wait_list,
+                           const cl_event *event_wait_list, cl_event *event);
+
+// Unmap and free the staging buffers of context, which keep it alive, once
+// it's done with. Suites that use the functions above call this before
+// releasing their context.
+void release_staging_buffers(cl_context context);
+
+#endif // HARNESS_STAGING_POOL_H_
@@ -17,6 +17,7 @@
 #ifndef STRING_HELPERS_H
 #define STRING_HELPERS_H
 
+#include <cstdio>
 #include <memory>
 #include <stdexcept>
 #include <string>
@@ -39,4 +40,29 @@ inline std::string str_sprintf(const std::string &str, Args... args)
     return std::string(buffer.get(), buffer.get() + s - 1);
 }
 
+// s as the contents of a JSON string
+inline std::string json_escape(const std::string &s)
+{
+    std::string out;
+    for (char c : s)
+    {
+        if (c == '"' || c == '\\')
+        {
+            out += '\\';
+            out += c;
+        }
+        else if ((unsigned char)c < 0x20)
+        {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out += escaped;
+        }
+        else
+        {
+            out += c;
+        }
+    }
+    return out;
+}
+
 #endif // STRING_HELPERS_H
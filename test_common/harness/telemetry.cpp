@@ -0,0 +1,215 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "telemetry.h"
+
+#include "errorHelpers.h"
+#include "perfMetrics.h"
+#include "telemetryPlugin.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+#include <math.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+
+namespace {
+
+struct TelemetryPlugin
+{
+    const cl_cts_telemetry_plugin *api = nullptr;
+    std::chrono::milliseconds interval{ 50 };
+
+    // Serialises the calls into the plugin
+    std::mutex mutex;
+    // Plugin state of each device opened so far, NULL for those it cannot read
+    std::map<std::string, void *> states;
+    bool failed = false;
+};
+
+TelemetryPlugin gPlugin;
+std::once_flag gPluginOnce;
+
+void close_telemetry_plugin()
+{
+    std::lock_guard<std::mutex> lock(gPlugin.mutex);
+    for (auto &state : gPlugin.states)
+        if (state.second) gPlugin.api->close(state.second);
+    gPlugin.states.clear();
+}
+
+// The library stays loaded until exit, as plugin threads and the states may
+// depend on it until close
+void load_telemetry_plugin()
+{
+    const char *path = getenv("CL_CONFORMANCE_TELEMETRY_PLUGIN");
+    if (path == nullptr || !*path) return;
+
+#if defined(_WIN32)
+    HMODULE library = LoadLibraryA(path);
+    const char *reason = "LoadLibrary failed";
+#else
+    void *library = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    const char *reason = library ? "" : dlerror();
+#endif
+    if (!library)
+    {
+        log_error("ERROR: Unable to load telemetry plugin %s (%s), benchmarks "
+                  "run without telemetry\n",
+                  path, reason);
+        return;
+    }
+#if defined(_WIN32)
+    cl_cts_telemetry_plugin_entry_fn entry =
+        (cl_cts_telemetry_plugin_entry_fn)GetProcAddress(
+            library, CL_CTS_TELEMETRY_PLUGIN_ENTRY);
+#else
+    cl_cts_telemetry_plugin_entry_fn entry =
+        (cl_cts_telemetry_plugin_entry_fn)dlsym(library,
+                                                CL_CTS_TELEMETRY_PLUGIN_ENTRY);
+#endif
+    if (!entry)
+    {
+        log_error("ERROR: Telemetry plugin %s has no %s\n", path,
+                  CL_CTS_TELEMETRY_PLUGIN_ENTRY);
+        return;
+    }
+
+    const cl_cts_telemetry_plugin *api = entry();
+    if (!api || api->version != CL_CTS_TELEMETRY_PLUGIN_VERSION || !api->open
+        || !api->sample || !api->close
+        || (api->num_channels && !api->channels))
+    {
+        log_error("ERROR: Telemetry plugin %s does not implement version %d "
+                  "of the interface\n",
+                  path, CL_CTS_TELEMETRY_PLUGIN_VERSION);
+        return;
+    }
+
+    const char *interval = getenv("CL_CONFORMANCE_TELEMETRY_INTERVAL_MS");
+    if (interval && atoi(interval) > 0)
+        gPlugin.interval = std::chrono::milliseconds(atoi(interval));
+    gPlugin.api = api;
+    atexit(close_telemetry_plugin);
+    log_info("Reading telemetry from %s every %d ms during benchmarks\n",
+             api->name ? api->name : path, (int)gPlugin.interval.count());
+}
+
+// Plugin state for the device of the test running on the calling thread,
+// opening it the first time, or NULL if there is none to read
+void *telemetry_state()
+{
+    std::call_once(gPluginOnce, load_telemetry_plugin);
+    if (!gPlugin.api) return nullptr;
+
+    std::string device = get_perf_metric_device();
+    std::lock_guard<std::mutex> lock(gPlugin.mutex);
+    if (gPlugin.failed) return nullptr;
+    auto found = gPlugin.states.find(device);
+    if (found != gPlugin.states.end()) return found->second;
+
+    void *state = gPlugin.api->open(device.c_str());
+    if (!state)
+        log_info("Telemetry plugin cannot read device \"%s\"\n",
+                 device.c_str());
+    gPlugin.states[device] = state;
+    return state;
+}
+
+} // anonymous namespace
+
+bool telemetry_enabled() { return telemetry_state() != nullptr; }
+
+TelemetryRecording::TelemetryRecording(): m_stop(false)
+{
+    void *state = telemetry_state();
+    if (!state) return;
+    m_channels.resize(gPlugin.api->num_channels);
+    m_thread = std::thread(&TelemetryRecording::poll, this, state);
+}
+
+TelemetryRecording::~TelemetryRecording() { stop(); }
+
+void TelemetryRecording::poll(void *state)
+{
+    std::vector<double> values(m_channels.size());
+    std::unique_lock<std::mutex> lock(m_mutex);
+    do
+    {
+        int error;
+        {
+            std::lock_guard<std::mutex> pluginLock(gPlugin.mutex);
+            if (gPlugin.failed) return;
+            std::fill(values.begin(), values.end(), NAN);
+            error = gPlugin.api->sample(state, values.data());
+            if (error)
+            {
+                log_error("ERROR: Telemetry plugin failed with %d, "
+                          "benchmarks continue without telemetry\n",
+                          error);
+                gPlugin.failed = true;
+                return;
+            }
+        }
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            if (isnan(values[i])) continue;
+            Channel &channel = m_channels[i];
+            channel.min = channel.samples ? std::min(channel.min, values[i])
+                                          : values[i];
+            channel.max = channel.samples ? std::max(channel.max, values[i])
+                                          : values[i];
+            channel.sum += values[i];
+            channel.samples++;
+        }
+    } while (!m_wake.wait_for(lock, gPlugin.interval, [&] { return m_stop; }));
+}
+
+std::vector<telemetry_summary> TelemetryRecording::stop()
+{
+    if (m_thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_one();
+        m_thread.join();
+    }
+
+    std::vector<telemetry_summary> summaries;
+    for (size_t i = 0; i < m_channels.size(); i++)
+    {
+        const Channel &channel = m_channels[i];
+        if (!channel.samples) continue;
+        const cl_cts_telemetry_channel &info = gPlugin.api->channels[i];
+        telemetry_summary summary = { info.name ? info.name : "",
+                                      info.unit ? info.unit : "",
+                                      channel.samples,
+                                      channel.min,
+                                      channel.sum / channel.samples,
+                                      channel.max };
+        summaries.push_back(summary);
+    }
+    m_channels.clear();
+    return summaries;
+}
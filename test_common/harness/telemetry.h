@@ -0,0 +1,81 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef HARNESS_TELEMETRY_H_
+#define HARNESS_TELEMETRY_H_
+
+#include <stddef.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Telemetry taken while benchmarks run, so that their numbers can be read
+// against the power, clocks and temperatures of the time. The readings come
+// from the plugin named by CL_CONFORMANCE_TELEMETRY_PLUGIN (see
+// telemetryPlugin.h), every CL_CONFORMANCE_TELEMETRY_INTERVAL_MS
+// milliseconds, 50 by default. Without a plugin nothing is read.
+
+// What one channel read over a recording
+struct telemetry_summary
+{
+    std::string name;
+    std::string unit;
+    // Readings that had a value
+    size_t samples;
+    double min;
+    double mean;
+    double max;
+};
+
+// Whether a plugin is loaded and can read the device of the test running on
+// the calling thread
+bool telemetry_enabled();
+
+// Reads the plugin in a background thread while in scope, for the device of
+// the test running on the thread that constructs it
+class TelemetryRecording {
+public:
+    TelemetryRecording();
+    ~TelemetryRecording();
+
+    // Stop reading and summarise each channel that had a value. Empty without
+    // a plugin.
+    std::vector<telemetry_summary> stop();
+
+private:
+    TelemetryRecording(const TelemetryRecording &) = delete;
+    TelemetryRecording &operator=(const TelemetryRecording &) = delete;
+
+    void poll(void *state);
+
+    struct Channel
+    {
+        size_t samples = 0;
+        double min = 0;
+        double max = 0;
+        double sum = 0;
+    };
+
+    std::vector<Channel> m_channels;
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    bool m_stop;
+};
+
+#endif // HARNESS_TELEMETRY_H_
@@ -0,0 +1,99 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef HARNESS_TELEMETRY_PLUGIN_H_
+#define HARNESS_TELEMETRY_PLUGIN_H_
+
+// The interface of a telemetry plugin, a shared library reading power,
+// clocks, temperatures, utilisation or anything else worth knowing while a
+// benchmark runs. This header is plain C and stands alone, so that a plugin
+// can be built without the rest of the harness. The harness loads the
+// library named by CL_CONFORMANCE_TELEMETRY_PLUGIN and calls its
+// cl_cts_telemetry_plugin_entry, which returns the plugin's functions:
+//
+//     static const cl_cts_telemetry_channel channels[] = {
+//         { "gpu_power", "W" }, { "gpu_clock", "MHz" }, { "gpu_temp", "C" },
+//     };
+//
+//     static void *my_open(const char *device) { ... }
+//     static int my_sample(void *state, double *values) { ... }
+//     static void my_close(void *state) { ... }
+//
+//     static const cl_cts_telemetry_plugin plugin = {
+//         CL_CTS_TELEMETRY_PLUGIN_VERSION, "my_backend", channels, 3,
+//         my_open, my_sample, my_close,
+//     };
+//
+//     CL_CTS_TELEMETRY_EXPORT const cl_cts_telemetry_plugin *
+//     cl_cts_telemetry_plugin_entry(void)
+//     {
+//         return &plugin;
+//     }
+//
+// The harness calls open once before the first benchmark, then sample from
+// one background thread while benchmarks take their samples, and close at
+// exit. Calls never overlap.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CL_CTS_TELEMETRY_PLUGIN_VERSION 1
+
+#if defined(_WIN32)
+#define CL_CTS_TELEMETRY_EXPORT __declspec(dllexport)
+#else
+#define CL_CTS_TELEMETRY_EXPORT __attribute__((visibility("default")))
+#endif
+
+typedef struct cl_cts_telemetry_channel
+{
+    // Name in the results, such as "gpu_power", and the unit of its values
+    const char *name;
+    const char *unit;
+} cl_cts_telemetry_channel;
+
+typedef struct cl_cts_telemetry_plugin
+{
+    // CL_CTS_TELEMETRY_PLUGIN_VERSION the plugin was built against
+    unsigned version;
+    // Name of the backend, for the log
+    const char *name;
+
+    // What sample reads, in the order of its values
+    const cl_cts_telemetry_channel *channels;
+    unsigned num_channels;
+
+    // Start reading the device with the given CL_DEVICE_NAME. Returns the
+    // state passed to the other functions, or NULL if the plugin cannot read
+    // this device.
+    void *(*open)(const char *device);
+    // Read the current value of each channel into values, or NaN for one that
+    // cannot be read this time. Returns 0 on success; the harness stops
+    // sampling after a failure.
+    int (*sample)(void *state, double *values);
+    void (*close)(void *state);
+} cl_cts_telemetry_plugin;
+
+typedef const cl_cts_telemetry_plugin *(*cl_cts_telemetry_plugin_entry_fn)(
+    void);
+
+#define CL_CTS_TELEMETRY_PLUGIN_ENTRY "cl_cts_telemetry_plugin_entry"
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HARNESS_TELEMETRY_PLUGIN_H_
@@ -16,10 +16,12 @@
 #include "testHarness.h"
 #include "compat.h"
 #include <algorithm>
+#include <atomic>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <cassert>
+#include <chrono>
 #include <deque>
 #include <mutex>
 #include <stdexcept>
@@ -31,10 +33,23 @@
 #include "typeWrappers.h"
 #include "imageHelpers.h"
 #include "parseParameters.h"
+#include "contextPool.h"
+#include "imagePool.h"
+#include "clockCorrelation.h"
+#include "timelineTrace.h"
+#include "perfMetrics.h"
+#include "perfBaseline.h"
+#include "durationHistory.h"
+#include "deviceInfo.h"
+#include "deviceFanOut.h"
+#include "soak.h"
 
 #if !defined(_WIN32)
+#include <sys/resource.h>
 #include <sys/utsname.h>
 #include <unistd.h>
+#else
+#include <psapi.h>
 #endif
 
 #if defined(__APPLE__)
@@ -47,12 +62,13 @@
 #include <CL/cl.h>
 #endif
 
-int gTestsPassed = 0;
-int gTestsFailed = 0;
+std::atomic<int> gTestsPassed{ 0 };
+std::atomic<int> gTestsFailed{ 0 };
 int gFailCount;
 int gTestCount;
 cl_uint gRandomSeed = 0;
 cl_uint gReSeed = 0;
+bool gMultiSuiteRun = false;
 
 int gFlushDenormsToZero = 0;
 int gInfNanSupport = 1;
@@ -64,7 +80,8 @@ bool gCoreILProgram = true;
 
 static int saveResultsToJson(const char *suiteName, test_definition testList[],
                              unsigned char selectedTestList[],
-                             test_status resultTestList[], int testNum)
+                             test_status resultTestList[], int testNum,
+                             test_timing timingList[] = NULL)
 {
     char *fileName = getenv("CL_CONFORMANCE_RESULTS_FILENAME");
     if (fileName == nullptr)
@@ -100,8 +117,39 @@ static int saveResultsToJson(const char *suiteName, test_definition testList[],
     }
     fprintf(file, "\n");
 
-    fprintf(file, "\t}\n");
-    fprintf(file, "}\n");
+    if (timingList != NULL)
+    {
+        fprintf(file, "\t},\n");
+        fprintf(file, "\t\"timings\": {\n");
+        add_linebreak = 0;
+        for (int i = 0; i < testNum; ++i)
+        {
+            if (selectedTestList[i])
+            {
+                const test_timing &timing = timingList[i];
+                fprintf(file,
+                        "%s\t\t\"%s\": { \"wall_time\": %.6f, "
+                        "\"cpu_time\": %.6f, \"peak_rss_kb\": %zu",
+                        linebreak[add_linebreak], testList[i].name,
+                        timing.wallTime, timing.cpuTime, timing.peakRSS);
+                if (timing.deviceTime >= 0)
+                    fprintf(file, ", \"device_time\": %.6f",
+                            timing.deviceTime);
+                fprintf(file, " }");
+                add_linebreak = 1;
+            }
+        }
+        fprintf(file, "\n");
+    }
+
+    fprintf(file, "\t}");
+    if (!get_perf_metrics().empty())
+    {
+        fprintf(file, ",\n\t\"metrics\": [\n");
+        write_perf_metrics_json(file, "\t\t");
+        fprintf(file, "\t]");
+    }
+    fprintf(file, "\n}\n");
 
     int ret = fclose(file) ? EXIT_FAILURE : EXIT_SUCCESS;
 
@@ -110,6 +158,54 @@ static int saveResultsToJson(const char *suiteName, test_definition testList[],
     return ret;
 }
 
+// Append the wall time of each test that passed to
+// CL_CONFORMANCE_DURATION_DB, if set, under the key of set_duration_key
+static int saveDurations(const char *suiteName, cl_device_id device,
+                         test_definition testList[],
+                         unsigned char selectedTestList[],
+                         test_status resultTestList[], int testNum,
+                         test_timing timingList[])
+{
+    const char *fileName = getenv("CL_CONFORMANCE_DURATION_DB");
+    if (fileName == nullptr || fileName[0] == '\0')
+    {
+        return EXIT_SUCCESS;
+    }
+
+    DurationRecord record;
+    get_duration_key(record.suite, record.mode, record.coverage);
+    if (record.suite.empty())
+    {
+        const char *base = suiteName ? suiteName : "";
+        for (const char *p = base; *p; p++)
+            if (*p == '/' || *p == '\\') base = p + 1;
+        record.suite = base;
+    }
+    if (record.suite.empty())
+    {
+        return EXIT_SUCCESS;
+    }
+    record.device = get_device_name(device);
+
+    std::vector<DurationRecord> records;
+    for (int i = 0; i < testNum; ++i)
+    {
+        if (selectedTestList[i] && resultTestList[i] == TEST_PASS)
+        {
+            record.test = testList[i].name;
+            record.seconds = timingList[i].wallTime;
+            records.push_back(record);
+        }
+    }
+
+    if (!DurationHistory::Append(fileName, records))
+    {
+        log_error("ERROR: Failed to append durations to '%s'.\n", fileName);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
 int runTestHarness(int argc, const char *argv[], int testNum,
                    test_definition testList[], int forceNoContextCreation,
                    cl_command_queue_properties queueProps)
@@ -262,7 +358,8 @@ int runTestHarnessWithCheck(int argc, const char *argv[], int testNum,
         log_info("Test names:\n");
         for (int i = 0; i < testNum; i++)
         {
-            log_info("\t%s\n", testList[i].name);
+            log_info("\t%s%s\n", testList[i].name,
+                     testList[i].benchmark ? " (benchmark)" : "");
         }
         return EXIT_SUCCESS;
     }
@@ -408,6 +505,14 @@ int runTestHarnessWithCheck(int argc, const char *argv[], int testNum,
 #endif
 #endif
 
+    if (gAllDevices)
+    {
+        int status;
+        if (!fan_out_to_devices(choosen_platform_index, device_type,
+                                &choosen_device_index, &status))
+            return status;
+    }
+
     /* Get the platform */
     err = clGetPlatformIDs(0, NULL, &num_platforms);
     if (err)
@@ -660,6 +765,15 @@ static int find_matching_tests(test_definition testList[],
     return EXIT_SUCCESS;
 }
 
+void reset_suite_state()
+{
+    gFailCount = 0;
+    gTestCount = 0;
+    gTestsFailed = 0;
+    gTestsPassed = 0;
+    clear_perf_metrics();
+}
+
 static void print_results(int failed, int count, const char *name)
 {
     if (count < failed)
@@ -691,6 +805,31 @@ static void print_results(int failed, int count, const char *name)
     }
 }
 
+// Runs the selected tests once with the offline compiles deferred, throwing
+// away their results and output, then compiles all of the kernels they asked
+// for with a pool of compiler processes ahead of the real run
+static void batch_offline_compiles(test_definition testList[],
+                                   unsigned char selectedTestList[],
+                                   int testNum, cl_device_id device,
+                                   const test_harness_config &config)
+{
+    log_info("Collecting the kernels to compile offline...\n");
+    test_harness_config collectConfig = config;
+    collectConfig.numWorkerThreads = 0;
+    std::vector<test_status> results(testNum, TEST_PASS);
+    std::string output;
+
+    begin_offline_compile_collection();
+    log_capture_begin(&output);
+    callTestFunctions(testList, selectedTestList, results.data(), testNum,
+                      device, collectConfig, NULL);
+    log_capture_end();
+
+    reset_suite_state();
+
+    run_deferred_offline_compiles(gOfflineCompilationJobs);
+}
+
 int parseAndCallCommandLineTests(int argc, const char *argv[],
                                  cl_device_id device, int testNum,
                                  test_definition testList[],
@@ -700,10 +839,16 @@ int parseAndCallCommandLineTests(int argc, const char *argv[],
 
     unsigned char *selectedTestList = (unsigned char *)calloc(testNum, 1);
 
+    // Every test apart from the benchmarks, which must be asked for
+    auto select_all = [&]() {
+        for (int i = 0; i < testNum; i++)
+            selectedTestList[i] = !testList[i].benchmark;
+    };
+
     if (argc == 1)
     {
         /* No actual arguments, all tests will be run. */
-        memset(selectedTestList, 1, testNum);
+        select_all();
     }
     else
     {
@@ -718,7 +863,7 @@ int parseAndCallCommandLineTests(int argc, const char *argv[],
             {
                 if (strcmp(argv[i], "all") == 0)
                 {
-                    memset(selectedTestList, 1, testNum);
+                    select_all();
                     break;
                 }
                 else
@@ -738,15 +883,61 @@ int parseAndCallCommandLineTests(int argc, const char *argv[],
     if (ret == EXIT_SUCCESS)
     {
         std::vector<test_status> resultTestList(testNum, TEST_PASS);
+        std::vector<test_timing> timingList(testNum, test_timing());
 
-        callTestFunctions(testList, selectedTestList, resultTestList.data(),
-                          testNum, device, config);
+        if (gOfflineCompilationBatch)
+            batch_offline_compiles(testList, selectedTestList, testNum, device,
+                                   config);
+
+        start_trace(device);
+        if (gSoakSeconds > 0)
+        {
+            // A test fails if it fails in any iteration, and keeps the
+            // timings of its first
+            bool firstIteration = true;
+            run_soak(gSoakSeconds, device, [&]() {
+                std::vector<test_status> results(testNum, TEST_PASS);
+                std::vector<test_timing> timings(testNum, test_timing());
+                int failedBefore = gTestsFailed;
+                callTestFunctions(testList, selectedTestList, results.data(),
+                                  testNum, device, config, timings.data());
+                for (int i = 0; i < testNum; i++)
+                {
+                    if (firstIteration || results[i] == TEST_FAIL)
+                        resultTestList[i] = results[i];
+                    if (firstIteration) timingList[i] = timings[i];
+                }
+                firstIteration = false;
+                return gTestsFailed - failedBefore;
+            });
+        }
+        else
+        {
+            callTestFunctions(testList, selectedTestList, resultTestList.data(),
+                              testNum, device, config, timingList.data());
+        }
+        if (!gMultiSuiteRun)
+        {
+            release_context_pool();
+            release_image_pool();
+        }
+        flush_trace_commands();
+        stop_clock_correlation();
 
         print_results(gFailCount, gTestCount, "sub-test");
         print_results(gTestsFailed, gTestsFailed + gTestsPassed, "test");
+        int baselineRet = compare_perf_baseline();
 
         ret = saveResultsToJson(argv[0], testList, selectedTestList,
-                                resultTestList.data(), testNum);
+                                resultTestList.data(), testNum,
+                                timingList.data());
+        if (saveDurations(argv[0], device, testList, selectedTestList,
+                          resultTestList.data(), testNum, timingList.data())
+            != EXIT_SUCCESS)
+            ret = EXIT_FAILURE;
+        if (save_perf_metrics(argv[0]) != EXIT_SUCCESS) ret = EXIT_FAILURE;
+        if (baselineRet != EXIT_SUCCESS) ret = EXIT_FAILURE;
+        if (save_trace() != EXIT_SUCCESS) ret = EXIT_FAILURE;
 
         if (std::any_of(resultTestList.begin(), resultTestList.end(),
                         [](test_status result) {
@@ -772,6 +963,7 @@ struct test_harness_state
 {
     test_definition *tests;
     test_status *results;
+    test_timing *timings;
     cl_device_id device;
     test_harness_config config;
 };
@@ -801,14 +993,23 @@ void test_function_runner(test_harness_state *state)
             test = state->tests[testID];
         }
 
-        // Execute test
-        auto status =
-            callSingleTestFunction(test, state->device, state->config);
+        // Execute test, holding back its output so that it is not
+        // interleaved with the output of the other tests
+        std::string output;
+        log_capture_begin(&output);
+        test_timing timing;
+        auto status = callSingleTestFunction(test, state->device,
+                                             state->config, &timing);
+        log_capture_end();
 
         // Store result
         {
             std::lock_guard<std::mutex> lock(gTestStateMutex);
             state->results[testID] = status;
+            if (state->timings) state->timings[testID] = timing;
+            log_flush();
+            fputs(output.c_str(), stdout);
+            fflush(stdout);
         }
     }
 }
@@ -817,7 +1018,8 @@ void callTestFunctions(test_definition testList[],
                        unsigned char selectedTestList[],
                        test_status resultTestList[], int testNum,
                        cl_device_id deviceToUse,
-                       const test_harness_config &config)
+                       const test_harness_config &config,
+                       test_timing timingList[])
 {
     // Execute tests serially
     if (config.numWorkerThreads == 0)
@@ -826,39 +1028,51 @@ void callTestFunctions(test_definition testList[],
         {
             if (selectedTestList[i])
             {
-                resultTestList[i] =
-                    callSingleTestFunction(testList[i], deviceToUse, config);
+                resultTestList[i] = callSingleTestFunction(
+                    testList[i], deviceToUse, config,
+                    timingList ? &timingList[i] : NULL);
             }
         }
         // Execute tests in parallel with the specified number of worker threads
     }
     else
     {
-        // Queue all tests that need to run
+        // Queue all tests that can share the device
         for (int i = 0; i < testNum; ++i)
         {
-            if (selectedTestList[i])
+            if (selectedTestList[i] && !testList[i].serial_only)
             {
                 gTestQueue.push_back(i);
             }
         }
 
         // Spawn thread pool
-        std::vector<std::thread *> threads;
-        test_harness_state state = { testList, resultTestList, deviceToUse,
-                                     config };
+        std::vector<std::thread> threads;
+        test_harness_state state = { testList, resultTestList, timingList,
+                                     deviceToUse, config };
         for (unsigned i = 0; i < config.numWorkerThreads; i++)
         {
             log_info("Spawning worker thread %u\n", i);
-            threads.push_back(new std::thread(test_function_runner, &state));
+            threads.emplace_back(test_function_runner, &state);
         }
 
         // Wait for all threads to complete
-        for (auto th : threads)
+        for (auto &th : threads)
         {
-            th->join();
+            th.join();
         }
         assert(gTestQueue.size() == 0);
+
+        // Then run the tests that need the device to themselves
+        for (int i = 0; i < testNum; ++i)
+        {
+            if (selectedTestList[i] && testList[i].serial_only)
+            {
+                resultTestList[i] = callSingleTestFunction(
+                    testList[i], deviceToUse, config,
+                    timingList ? &timingList[i] : NULL);
+            }
+        }
     }
 }
 
@@ -868,19 +1082,89 @@ void CL_CALLBACK notify_callback(const char *errinfo, const void *private_info,
     log_info("%s\n", errinfo);
 }
 
+// Host CPU time used by all threads of the process, in seconds
+static double get_process_cpu_time()
+{
+#if defined(_WIN32)
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel,
+                         &user))
+        return 0.0;
+    ULARGE_INTEGER k, u;
+    k.LowPart = kernel.dwLowDateTime;
+    k.HighPart = kernel.dwHighDateTime;
+    u.LowPart = user.dwLowDateTime;
+    u.HighPart = user.dwHighDateTime;
+    return (k.QuadPart + u.QuadPart) * 1e-7;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage)) return 0.0;
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec
+        + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+#endif
+}
+
+// Peak resident set size of the process, in KiB
+static size_t get_process_peak_rss()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters,
+                              sizeof(counters)))
+        return 0;
+    return counters.PeakWorkingSetSize / 1024;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage)) return 0;
+#if defined(__APPLE__)
+    return usage.ru_maxrss / 1024; // bytes on macOS
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+
+// Seconds between the completion of two markers on a profiling queue, or -1
+static double get_marker_interval(cl_event start, cl_event end)
+{
+    cl_ulong startTime, endTime;
+    if (clGetEventProfilingInfo(start, CL_PROFILING_COMMAND_END,
+                                sizeof(startTime), &startTime, NULL)
+            != CL_SUCCESS
+        || clGetEventProfilingInfo(end, CL_PROFILING_COMMAND_END,
+                                   sizeof(endTime), &endTime, NULL)
+            != CL_SUCCESS
+        || endTime < startTime)
+        return -1.0;
+    return (endTime - startTime) * 1e-9;
+}
+
 // Actual function execution
 test_status callSingleTestFunction(test_definition test,
                                    cl_device_id deviceToUse,
-                                   const test_harness_config &config)
+                                   const test_harness_config &config,
+                                   test_timing *timing)
 {
     test_status status;
     cl_int error;
     cl_context context = NULL;
     cl_command_queue queue = NULL;
+    cl_event startMarker = NULL;
+
+    auto wallStart = std::chrono::steady_clock::now();
+    double cpuStart = get_process_cpu_time();
+    if (timing != NULL)
+    {
+        *timing = test_timing();
+        timing->deviceTime = -1.0;
+    }
 
     log_info("%s...\n", test.name);
     fflush(stdout);
 
+    PerfMetricScope metricScope(test.name, deviceToUse);
+    TraceSpan traceSpan(test.name, "test");
+
     const Version device_version = get_device_cl_version(deviceToUse);
     if (test.min_version > device_version)
     {
@@ -898,6 +1182,10 @@ test_status callSingleTestFunction(test_definition test,
         return TEST_SKIP;
     }
 
+    // The trace needs the device times of the test queue
+    cl_command_queue_properties queueProps = config.queueProps;
+    if (trace_enabled()) queueProps |= CL_QUEUE_PROFILING_ENABLE;
+
     /* Create a context to work with, unless we're told not to */
     if (!config.forceNoContextCreation)
     {
@@ -913,15 +1201,15 @@ test_status callSingleTestFunction(test_definition test,
 
         if (device_version < Version(2, 0))
         {
-            queue = clCreateCommandQueue(context, deviceToUse,
-                                         config.queueProps, &error);
+            queue = clCreateCommandQueue(context, deviceToUse, queueProps,
+                                         &error);
         }
         else
         {
             const cl_command_queue_properties cmd_queueProps =
-                (config.queueProps) ? CL_QUEUE_PROPERTIES : 0;
+                (queueProps) ? CL_QUEUE_PROPERTIES : 0;
             cl_command_queue_properties queueCreateProps[] = {
-                cmd_queueProps, config.queueProps, 0
+                cmd_queueProps, queueProps, 0
             };
             queue = clCreateCommandQueueWithProperties(
                 context, deviceToUse, &queueCreateProps[0], &error);
@@ -935,6 +1223,16 @@ test_status callSingleTestFunction(test_definition test,
             gTestsFailed++;
             return TEST_FAIL;
         }
+
+        // Markers on a profiling queue bracket the device work of the test
+        if ((timing != NULL || trace_enabled())
+            && (queueProps & CL_QUEUE_PROFILING_ENABLE)
+            && device_version >= Version(1, 2))
+        {
+            if (clEnqueueMarkerWithWaitList(queue, 0, NULL, &startMarker)
+                != CL_SUCCESS)
+                startMarker = NULL;
+        }
     }
 
     /* Run the test and print the result */
@@ -977,6 +1275,12 @@ test_status callSingleTestFunction(test_definition test,
     /* Release the context */
     if (!config.forceNoContextCreation)
     {
+        cl_event endMarker = NULL;
+        if (startMarker != NULL
+            && clEnqueueMarkerWithWaitList(queue, 0, NULL, &endMarker)
+                != CL_SUCCESS)
+            endMarker = NULL;
+
         int error = clFinish(queue);
         if (error)
         {
@@ -985,8 +1289,29 @@ test_status callSingleTestFunction(test_definition test,
             gTestsFailed++;
             status = TEST_FAIL;
         }
+        else if (endMarker != NULL)
+        {
+            if (timing != NULL)
+                timing->deviceTime =
+                    get_marker_interval(startMarker, endMarker);
+            trace_queue_span(queue, startMarker, endMarker, test.name);
+        }
+
+        if (startMarker != NULL) clReleaseEvent(startMarker);
+        if (endMarker != NULL) clReleaseEvent(endMarker);
+        release_pooled_images(context);
         clReleaseCommandQueue(queue);
         clReleaseContext(context);
+        flush_trace_commands();
+    }
+
+    if (timing != NULL)
+    {
+        std::chrono::duration<double> wallTime =
+            std::chrono::steady_clock::now() - wallStart;
+        timing->wallTime = wallTime.count();
+        timing->cpuTime = get_process_cpu_time() - cpuStart;
+        timing->peakRSS = get_process_peak_rss();
     }
 
     return status;
@@ -1091,32 +1416,26 @@ cl_device_id GetOpposingDevice(cl_device_id device)
 
 Version get_device_cl_version(cl_device_id device)
 {
-    size_t str_size;
-    cl_int err = clGetDeviceInfo(device, CL_DEVICE_VERSION, 0, NULL, &str_size);
-    ASSERT_SUCCESS(err, "clGetDeviceInfo");
+    auto snapshot = get_device_snapshot(device);
+    const std::string *str = snapshot->String(CL_DEVICE_VERSION);
+    ASSERT_SUCCESS(str ? CL_SUCCESS : CL_INVALID_VALUE, "clGetDeviceInfo");
 
-    std::vector<char> str(str_size);
-    err =
-        clGetDeviceInfo(device, CL_DEVICE_VERSION, str_size, str.data(), NULL);
-    ASSERT_SUCCESS(err, "clGetDeviceInfo");
-
-    if (strstr(str.data(), "OpenCL 1.0") != NULL)
+    if (strstr(str->c_str(), "OpenCL 1.0") != NULL)
         return Version(1, 0);
-    else if (strstr(str.data(), "OpenCL 1.1") != NULL)
+    else if (strstr(str->c_str(), "OpenCL 1.1") != NULL)
         return Version(1, 1);
-    else if (strstr(str.data(), "OpenCL 1.2") != NULL)
+    else if (strstr(str->c_str(), "OpenCL 1.2") != NULL)
         return Version(1, 2);
-    else if (strstr(str.data(), "OpenCL 2.0") != NULL)
+    else if (strstr(str->c_str(), "OpenCL 2.0") != NULL)
         return Version(2, 0);
-    else if (strstr(str.data(), "OpenCL 2.1") != NULL)
+    else if (strstr(str->c_str(), "OpenCL 2.1") != NULL)
         return Version(2, 1);
-    else if (strstr(str.data(), "OpenCL 2.2") != NULL)
+    else if (strstr(str->c_str(), "OpenCL 2.2") != NULL)
         return Version(2, 2);
-    else if (strstr(str.data(), "OpenCL 3.0") != NULL)
+    else if (strstr(str->c_str(), "OpenCL 3.0") != NULL)
         return Version(3, 0);
 
-    throw std::runtime_error(std::string("Unknown OpenCL version: ")
-                             + str.data());
+    throw std::runtime_error(std::string("Unknown OpenCL version: ") + *str);
 }
 
 bool check_device_spirv_version_reported(cl_device_id device)
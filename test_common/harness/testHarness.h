@@ -63,6 +63,19 @@ Version get_device_cl_version(cl_device_id device);
     {                                                                          \
         test_##fn, #fn, ver                                                    \
     }
+#define ADD_TEST_SERIAL(fn)                                                    \
+    {                                                                          \
+        test_##fn, #fn, Version(1, 0), true                                    \
+    }
+// A benchmark, see benchmark.h. Benchmarks always run serially.
+#define ADD_BENCHMARK(fn)                                                      \
+    {                                                                          \
+        test_##fn, #fn, Version(1, 0), true, true                              \
+    }
+#define ADD_BENCHMARK_VERSION(fn, ver)                                         \
+    {                                                                          \
+        test_##fn, #fn, ver, true, true                                        \
+    }
 
 #define ARRAY_SIZE(arr) (sizeof(arr) / sizeof((arr)[0]))
 
@@ -74,6 +87,11 @@ typedef struct test_definition
     test_function_pointer func;
     const char *name;
     Version min_version;
+    // With --jobs, tests marked serial_only run one at a time after all the
+    // other tests have completed.
+    bool serial_only;
+    // Benchmarks only run when selected by name or wildcard
+    bool benchmark;
 } test_definition;
 
 
@@ -85,6 +103,17 @@ typedef enum test_status
     TEST_SKIPPED_ITSELF = -100,
 } test_status;
 
+// Resources used by a single test, saved to the JSON results file
+struct test_timing
+{
+    double wallTime; // seconds
+    double cpuTime; // seconds of host CPU time, all threads of the process
+    size_t peakRSS; // peak resident set size of the process so far, in KiB
+    double deviceTime; // seconds between the first and last command on the
+                       // harness queue, negative if the queue does not have
+                       // CL_QUEUE_PROFILING_ENABLE
+};
+
 struct test_harness_config
 {
     int forceNoContextCreation;
@@ -98,6 +127,13 @@ extern int gTestCount;
 extern cl_uint gReSeed;
 extern cl_uint gRandomSeed;
 
+// Set by test_all, which runs several suites in one process: the context pool
+// then lasts from one suite to the next.
+extern bool gMultiSuiteRun;
+
+// Forget the test counts and perf metrics of the previous suite
+extern void reset_suite_state();
+
 // Supply a list of functions to test here. This will allocate a CL device,
 // create a context, all that setup work, and then call each function in turn as
 // dictatated by the passed arguments. Returns EXIT_SUCCESS iff all tests
@@ -139,17 +175,21 @@ extern int parseAndCallCommandLineTests(int argc, const char *argv[],
 //    and resultTestList contextProps are used to create a testing context for
 //    each test deviceToUse and config are all just passed to each
 //    test function
+//    timingList, if not NULL, receives the resources used by each selected
+//    test
 extern void callTestFunctions(test_definition testList[],
                               unsigned char selectedTestList[],
                               test_status resultTestList[], int testNum,
                               cl_device_id deviceToUse,
-                              const test_harness_config &config);
+                              const test_harness_config &config,
+                              test_timing timingList[] = NULL);
 
 // This function is called by callTestFunctions, once per function, to do setup,
 // call, logging and cleanup
 extern test_status callSingleTestFunction(test_definition test,
                                           cl_device_id deviceToUse,
-                                          const test_harness_config &config);
+                                          const test_harness_config &config,
+                                          test_timing *timing = NULL);
 
 ///// Miscellaneous steps
 
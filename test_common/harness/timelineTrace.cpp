@@ -0,0 +1,307 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "timelineTrace.h"
+
+#include "clockCorrelation.h"
+#include "errorHelpers.h"
+#include "stringHelpers.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int kHostPid = 1;
+const int kDevicePid = 2;
+
+struct TraceEvent
+{
+    std::string name;
+    const char *category;
+    int pid;
+    int tid;
+    cl_ulong start;
+    cl_ulong end;
+    // The members of the JSON object of arguments
+    std::string args;
+};
+
+// A command whose timestamps are read once it has completed
+struct PendingCommand
+{
+    int track;
+    cl_event start;
+    // Null if the span is the command of start, otherwise the span is
+    // between the ends of the two markers
+    cl_event end;
+    std::string name;
+    size_t bytes;
+    cl_uint waits;
+};
+
+bool gTraceEnabled = false;
+std::string gTraceFileName;
+cl_device_id gTraceDevice = nullptr;
+std::string gTraceDeviceName;
+// Host timestamps come from clGetHostTimer if the clocks are correlated,
+// so that device timestamps can be converted to them
+bool gTraceHostTimer = false;
+cl_ulong gTraceOrigin = 0;
+
+std::mutex gTraceMutex;
+std::vector<TraceEvent> gTraceEvents;
+std::vector<PendingCommand> gPendingCommands;
+std::map<int, std::string> gThreadNames;
+std::map<cl_command_queue, int> gQueueTracks;
+
+std::atomic<int> gNextThreadTrack(1);
+thread_local int tThreadTrack = 0;
+
+int thread_track()
+{
+    if (tThreadTrack == 0) tThreadTrack = gNextThreadTrack++;
+    return tThreadTrack;
+}
+
+cl_ulong host_now()
+{
+    cl_ulong now;
+    if (gTraceHostTimer && clGetHostTimer(gTraceDevice, &now) == CL_SUCCESS)
+        return now;
+    return (cl_ulong)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+int queue_track(cl_command_queue queue)
+{
+    auto it = gQueueTracks.find(queue);
+    if (it != gQueueTracks.end()) return it->second;
+    int track = (int)gQueueTracks.size() + 1;
+    gQueueTracks[queue] = track;
+    return track;
+}
+
+void record_event(const std::string &name, const char *category, int pid,
+                  int tid, cl_ulong start, cl_ulong end,
+                  const std::string &args)
+{
+    TraceEvent event = { name, category, pid, tid, start, end, args };
+    std::lock_guard<std::mutex> lock(gTraceMutex);
+    gTraceEvents.push_back(event);
+}
+
+void release_command(PendingCommand &command)
+{
+    clReleaseEvent(command.start);
+    if (command.end) clReleaseEvent(command.end);
+}
+
+// True once the command is done with, whether or not it was recorded
+bool resolve_command(PendingCommand &command)
+{
+    cl_event last = command.end ? command.end : command.start;
+    cl_int status;
+    if (clGetEventInfo(last, CL_EVENT_COMMAND_EXECUTION_STATUS,
+                       sizeof(status), &status, NULL)
+        != CL_SUCCESS)
+        return true;
+    if (status > CL_COMPLETE) return false;
+    if (status < 0) return true;
+
+    cl_ulong start, end;
+    cl_profiling_info startParam =
+        command.end ? CL_PROFILING_COMMAND_END : CL_PROFILING_COMMAND_START;
+    if (clGetEventProfilingInfo(command.start, startParam, sizeof(start),
+                                &start, NULL)
+            != CL_SUCCESS
+        || clGetEventProfilingInfo(last, CL_PROFILING_COMMAND_END,
+                                   sizeof(end), &end, NULL)
+            != CL_SUCCESS)
+        return true;
+
+    cl_ulong hostStart, hostEnd;
+    if (device_to_host_time(gTraceDevice, start, &hostStart) != CL_SUCCESS
+        || device_to_host_time(gTraceDevice, end, &hostEnd) != CL_SUCCESS)
+        return true;
+
+    std::string args;
+    if (!command.end)
+        args = str_sprintf("\"bytes\":%zu,\"waits\":%u", command.bytes,
+                           command.waits);
+    TraceEvent event = { command.name, "device", kDevicePid, command.track,
+                         hostStart, std::max(hostStart, hostEnd), args };
+    gTraceEvents.push_back(event);
+    return true;
+}
+
+double trace_us(cl_ulong time)
+{
+    return (double)(cl_long)(time - gTraceOrigin) / 1000.0;
+}
+
+} // anonymous namespace
+
+bool trace_enabled() { return gTraceEnabled; }
+
+void start_trace(cl_device_id device)
+{
+    const char *fileName = getenv("CL_CONFORMANCE_TRACE_FILENAME");
+    if (fileName == nullptr) return;
+
+    gTraceFileName = fileName;
+    gTraceDevice = device;
+    char name[256] = "device";
+    clGetDeviceInfo(device, CL_DEVICE_NAME, sizeof(name), name, NULL);
+    gTraceDeviceName = name;
+    gTraceHostTimer = start_clock_correlation(device) == CL_SUCCESS;
+    if (!gTraceHostTimer)
+        log_info("The trace will only have host tracks.\n");
+    gTraceOrigin = host_now();
+    gTraceEnabled = true;
+    trace_thread_name("main");
+}
+
+TraceSpan::TraceSpan(const char *name, const char *category)
+    : m_name(name), m_category(category), m_countName(nullptr), m_count(0),
+      m_start(gTraceEnabled ? host_now() : 0)
+{}
+
+TraceSpan::~TraceSpan()
+{
+    if (!gTraceEnabled) return;
+    std::string args;
+    if (m_countName) args = str_sprintf("\"%s\":%zu", m_countName, m_count);
+    record_event(m_name, m_category, kHostPid, thread_track(), m_start,
+                 host_now(), args);
+}
+
+void TraceSpan::set_count(const char *name, size_t value)
+{
+    m_countName = name;
+    m_count = value;
+}
+
+void trace_thread_name(const char *name)
+{
+    if (!gTraceEnabled) return;
+    int track = thread_track();
+    std::lock_guard<std::mutex> lock(gTraceMutex);
+    gThreadNames[track] = name;
+}
+
+void trace_command(cl_command_queue queue, cl_event event, const char *name,
+                   size_t bytes, cl_uint numEventsInWaitList)
+{
+    if (!gTraceEnabled || !gTraceHostTimer || event == nullptr) return;
+    clRetainEvent(event);
+    std::lock_guard<std::mutex> lock(gTraceMutex);
+    PendingCommand command = { queue_track(queue), event, nullptr, name,
+                               bytes, numEventsInWaitList };
+    gPendingCommands.push_back(command);
+}
+
+void trace_queue_span(cl_command_queue queue, cl_event startMarker,
+                      cl_event endMarker, const char *name)
+{
+    if (!gTraceEnabled || !gTraceHostTimer || startMarker == nullptr
+        || endMarker == nullptr)
+        return;
+    clRetainEvent(startMarker);
+    clRetainEvent(endMarker);
+    std::lock_guard<std::mutex> lock(gTraceMutex);
+    PendingCommand command = { queue_track(queue), startMarker, endMarker,
+                               name, 0, 0 };
+    gPendingCommands.push_back(command);
+}
+
+void flush_trace_commands()
+{
+    if (!gTraceEnabled) return;
+    std::lock_guard<std::mutex> lock(gTraceMutex);
+    std::vector<PendingCommand> pending;
+    for (PendingCommand &command : gPendingCommands)
+    {
+        if (resolve_command(command))
+            release_command(command);
+        else
+            pending.push_back(command);
+    }
+    gPendingCommands.swap(pending);
+}
+
+int save_trace()
+{
+    if (!gTraceEnabled) return EXIT_SUCCESS;
+
+    flush_trace_commands();
+    std::lock_guard<std::mutex> lock(gTraceMutex);
+    // Whatever is still running at exit can't be placed any more
+    for (PendingCommand &command : gPendingCommands) release_command(command);
+    gPendingCommands.clear();
+
+    FILE *file = fopen(gTraceFileName.c_str(), "w");
+    if (NULL == file)
+    {
+        log_error("ERROR: Failed to open '%s' for writing the trace.\n",
+                  gTraceFileName.c_str());
+        return EXIT_FAILURE;
+    }
+
+    fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    fprintf(file,
+            "{\"ph\":\"M\",\"pid\":%d,\"name\":\"process_name\","
+            "\"args\":{\"name\":\"host\"}},\n",
+            kHostPid);
+    fprintf(file,
+            "{\"ph\":\"M\",\"pid\":%d,\"name\":\"process_name\","
+            "\"args\":{\"name\":\"%s\"}}",
+            kDevicePid, json_escape(gTraceDeviceName).c_str());
+    for (const auto &thread : gThreadNames)
+        fprintf(file,
+                ",\n{\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"name\":"
+                "\"thread_name\",\"args\":{\"name\":\"%s\"}}",
+                kHostPid, thread.first, json_escape(thread.second).c_str());
+    for (const auto &queue : gQueueTracks)
+        fprintf(file,
+                ",\n{\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"name\":"
+                "\"thread_name\",\"args\":{\"name\":\"queue %d\"}}",
+                kDevicePid, queue.second, queue.second);
+    for (const TraceEvent &event : gTraceEvents)
+        fprintf(file,
+                ",\n{\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"name\":\"%s\","
+                "\"cat\":\"%s\",\"ts\":%.3f,\"dur\":%.3f,\"args\":{%s}}",
+                event.pid, event.tid, json_escape(event.name).c_str(),
+                event.category, trace_us(event.start),
+                (event.end - event.start) / 1000.0, event.args.c_str());
+    fprintf(file, "\n]}\n");
+
+    int ret = fclose(file) ? EXIT_FAILURE : EXIT_SUCCESS;
+
+    log_info("Saving a trace of %zu spans to %s: %s!\n", gTraceEvents.size(),
+             gTraceFileName.c_str(),
+             ret == EXIT_SUCCESS ? "success" : "failure");
+
+    return ret;
+}
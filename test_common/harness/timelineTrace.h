@@ -0,0 +1,89 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef HARNESS_TIMELINE_TRACE_H_
+#define HARNESS_TIMELINE_TRACE_H_
+
+#include "compat.h"
+
+#include <CL/opencl.h>
+
+#include <stddef.h>
+
+// Opt-in timeline of a run, written to CL_CONFORMANCE_TRACE_FILENAME if it
+// is set, as Chrome trace event JSON, which Perfetto also opens. Each host
+// thread, including the ThreadPool workers, is a track of the host process,
+// with a span for every test it runs and every ThreadPool_Do it takes part
+// in. Each command queue is a track of the device process, with the device
+// time of each test on the harness queue and the commands recorded with
+// trace_command. Device timestamps are put on the host timeline with the
+// clock correlation service, so device tracks need a device with a host
+// timer.
+//
+// While tracing, the harness creates the queue it passes to the tests with
+// CL_QUEUE_PROFILING_ENABLE.
+
+// Whether CL_CONFORMANCE_TRACE_FILENAME was set when the harness started
+bool trace_enabled();
+
+// Start tracing if CL_CONFORMANCE_TRACE_FILENAME is set, called by the
+// harness before the tests
+void start_trace(cl_device_id device);
+
+// A span on the track of the calling thread from construction to
+// destruction. Does nothing when not tracing.
+class TraceSpan {
+public:
+    // name and category must outlive the span
+    TraceSpan(const char *name, const char *category);
+    ~TraceSpan();
+
+    // Add a number to the arguments shown for the span
+    void set_count(const char *name, size_t value);
+
+private:
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+    const char *m_name;
+    const char *m_category;
+    const char *m_countName;
+    size_t m_count;
+    cl_ulong m_start;
+};
+
+// Name the track of the calling thread
+void trace_thread_name(const char *name);
+
+// Record the command of event, enqueued on queue, as a span from its
+// CL_PROFILING_COMMAND_START to its CL_PROFILING_COMMAND_END. bytes is the
+// size of the data it moved, 0 if none. The event is retained until the
+// command completes; commands on a queue without profiling are dropped.
+void trace_command(cl_command_queue queue, cl_event event, const char *name,
+                   size_t bytes, cl_uint numEventsInWaitList);
+
+// Record a span on the track of queue from the end of startMarker to the
+// end of endMarker
+void trace_queue_span(cl_command_queue queue, cl_event startMarker,
+                      cl_event endMarker, const char *name);
+
+// Resolve the timestamps of the recorded commands that have completed and
+// release their events, called by the harness after each test
+void flush_trace_commands();
+
+// Write the trace, called by the harness after the tests
+int save_trace();
+
+#endif // HARNESS_TIMELINE_TRACE_H_
@@ -121,6 +121,99 @@ public:
     T *operator&() { return &object; }
 };
 
+// Like Wrapper, for objects that have a single owner. It can be moved but
+// not copied, so that it never calls Retain and can't be shared by mistake.
+template <typename T, RetainReleaseType<T> Release> class UniqueWrapper {
+    static_assert(std::is_pointer<T>::value, "T should be a pointer type.");
+    T object = nullptr;
+
+public:
+    UniqueWrapper() = default;
+
+    // Take ownership of the object, which has a refcount of one.
+    explicit UniqueWrapper(T object): object(object) {}
+
+    UniqueWrapper(UniqueWrapper const &) = delete;
+    UniqueWrapper &operator=(UniqueWrapper const &) = delete;
+
+    UniqueWrapper(UniqueWrapper &&w): object(w.object) { w.object = nullptr; }
+    UniqueWrapper &operator=(UniqueWrapper &&w)
+    {
+        reset(w.object);
+        w.object = nullptr;
+        return *this;
+    }
+
+    ~UniqueWrapper() { reset(); }
+
+    void reset(T new_object = nullptr)
+    {
+        if (object)
+        {
+            auto err = Release(object);
+            if (err != CL_SUCCESS)
+            {
+                print_error(err, "clRelease*() failed");
+                std::abort();
+            }
+        }
+        object = new_object;
+    }
+
+    // Give up ownership without releasing the object.
+    T detach()
+    {
+        T detached = object;
+        object = nullptr;
+        return detached;
+    }
+
+    operator T() const { return object; }
+
+    // For use as an output parameter, when empty.
+    T *operator&() { return &object; }
+};
+
+// N objects in a plain array that are released together when it goes out
+// of scope, or on reset(). data() can be passed straight to the OpenCL
+// calls that take arrays, such as the wait list of clWaitForEvents, and
+// &array[i] is an output parameter for the i-th object. Assigning to an
+// element doesn't release what it held.
+template <typename T, RetainReleaseType<T> Release, size_t N>
+class HandleArray {
+    static_assert(std::is_pointer<T>::value, "T should be a pointer type.");
+    T objects[N] = {};
+
+public:
+    HandleArray() = default;
+    HandleArray(HandleArray const &) = delete;
+    HandleArray &operator=(HandleArray const &) = delete;
+
+    ~HandleArray() { reset(); }
+
+    void reset()
+    {
+        for (T &object : objects)
+        {
+            if (!object) continue;
+            auto err = Release(object);
+            if (err != CL_SUCCESS)
+            {
+                print_error(err, "clRelease*() failed");
+                std::abort();
+            }
+            object = nullptr;
+        }
+    }
+
+    T &operator[](size_t i) { return objects[i]; }
+    const T &operator[](size_t i) const { return objects[i]; }
+
+    T *data() { return objects; }
+    const T *data() const { return objects; }
+    static constexpr size_t size() { return N; }
+};
+
 } // namespace wrapper_details
 
 using clContextWrapper =
@@ -145,6 +238,37 @@ using clSamplerWrapper =
 using clEventWrapper =
     wrapper_details::Wrapper<cl_event, clRetainEvent, clReleaseEvent>;
 
+using clUniqueContextWrapper =
+    wrapper_details::UniqueWrapper<cl_context, clReleaseContext>;
+
+using clUniqueProgramWrapper =
+    wrapper_details::UniqueWrapper<cl_program, clReleaseProgram>;
+
+using clUniqueKernelWrapper =
+    wrapper_details::UniqueWrapper<cl_kernel, clReleaseKernel>;
+
+using clUniqueMemWrapper =
+    wrapper_details::UniqueWrapper<cl_mem, clReleaseMemObject>;
+
+using clUniqueCommandQueueWrapper =
+    wrapper_details::UniqueWrapper<cl_command_queue, clReleaseCommandQueue>;
+
+using clUniqueSamplerWrapper =
+    wrapper_details::UniqueWrapper<cl_sampler, clReleaseSampler>;
+
+using clUniqueEventWrapper =
+    wrapper_details::UniqueWrapper<cl_event, clReleaseEvent>;
+
+template <size_t N>
+using clMemArray = wrapper_details::HandleArray<cl_mem, clReleaseMemObject, N>;
+
+template <size_t N>
+using clKernelArray =
+    wrapper_details::HandleArray<cl_kernel, clReleaseKernel, N>;
+
+template <size_t N>
+using clEventArray = wrapper_details::HandleArray<cl_event, clReleaseEvent, N>;
+
 class clSVMWrapper {
     void *Ptr = nullptr;
     cl_context Ctx = nullptr;
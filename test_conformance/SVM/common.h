@@ -21,6 +21,7 @@
 #include "harness/errorHelpers.h"
 #include "harness/kernelHelpers.h"
 #include "harness/typeWrappers.h"
+#include "harness/parseParameters.h"
 #include <vector>
 #include <string>
 
@@ -38,6 +39,8 @@ typedef enum {
 
 cl_int AtomicLoadExplicit(volatile cl_int * pValue, cl_memory_order order);
 cl_int AtomicFetchAddExplicit(volatile cl_int *object, cl_int operand, cl_memory_order o);
+cl_int AtomicExchangeExplicit(volatile cl_int *object, cl_int desired,
+                              cl_memory_order mo);
 
 template <typename T>
 bool AtomicCompareExchangeStrongExplicit(volatile T *a, T *expected, T desired,
@@ -75,6 +78,8 @@ typedef struct Node{
 
 extern void   create_linked_lists(Node* pNodes, size_t num_lists, int list_length);
 extern cl_int verify_linked_lists(Node* pNodes, size_t num_lists, int list_length);
+extern cl_int count_linked_list_nodes(Node *pNodes, size_t num_lists,
+                                      int list_length, size_t *num_correct);
 
 extern cl_int        create_linked_lists_on_device(int qi, cl_command_queue q, cl_mem allocator,     cl_kernel k, size_t numLists  );
 extern cl_int        verify_linked_lists_on_device(int qi, cl_command_queue q, cl_mem num_correct,   cl_kernel k, cl_int ListLength, size_t numLists  );
@@ -99,6 +104,17 @@ extern int test_svm_allocate_shared_buffer_negative(cl_device_id deviceID,
 extern int    test_svm_shared_sub_buffers(cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements);
 extern int    test_svm_enqueue_api(cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements);
 extern int    test_svm_migrate(cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements);
+extern int test_svm_migrate_bandwidth(cl_device_id deviceID, cl_context context,
+                                      cl_command_queue queue,
+                                      int num_elements);
+extern int test_svm_linked_list_throughput(cl_device_id deviceID,
+                                           cl_context context,
+                                           cl_command_queue queue,
+                                           int num_elements);
+extern int test_svm_fine_grain_ping_pong(cl_device_id deviceID,
+                                         cl_context context,
+                                         cl_command_queue queue,
+                                         int num_elements);
 
 extern cl_int create_cl_objects(cl_device_id device_from_harness, const char** ppCodeString, cl_context* context, cl_program *program, cl_command_queue *queues, cl_uint *num_devices, cl_device_svm_capabilities required_svm_caps, std::vector<std::string> extensions_list = std::vector<std::string>());
 
@@ -16,10 +16,13 @@
 #include "harness/compat.h"
 
 #include <stdio.h>
+#include <algorithm>
+#include <atomic>
 #include <vector>
 #include <sstream>
 #include "harness/testHarness.h"
 #include "harness/kernelHelpers.h"
+#include "harness/ThreadPool.h"
 
 #include "common.h"
 
@@ -112,40 +115,72 @@ const char *linked_list_create_and_verify_kernels[] = {
 };
 
 
-// The first N nodes in pNodes will be the heads of the lists.
-void create_linked_lists(Node* pNodes, size_t num_lists, int list_length)
+// Lists are built and walked on the thread pool in chunks of this many
+// lists, each list only ever touched by the thread that owns its chunk.
+static const size_t kListsPerJob = 4096;
+
+struct LinkedListJob
+{
+  Node *pNodes;
+  size_t num_lists;
+  int list_length;
+  std::atomic<size_t> num_correct;
+};
+
+static void run_linked_list_jobs(TPFuncPtr fn, LinkedListJob *job)
+{
+  cl_uint jobs = (cl_uint)((job->num_lists + kListsPerJob - 1) / kListsPerJob);
+  if (jobs > 1 && GetThreadCount() > 1
+      && CL_SUCCESS == ThreadPool_Do(fn, jobs, job))
+    return;
+
+  // A failed pool run may have counted some chunks already
+  job->num_correct = 0;
+  for (cl_uint i = 0; i < jobs; i++) fn(i, 0, job);
+}
+
+// The nodes of list i after its head are at num_lists + i * (list_length - 1)
+// onwards, which is where allocating them one list at a time puts them.
+static cl_int create_linked_lists_job(cl_uint job_id, cl_uint thread_id,
+                                      void *userInfo)
 {
-  size_t allocation_index = num_lists;  // heads of lists are in first num_lists nodes.
+  LinkedListJob *job = (LinkedListJob *)userInfo;
+  size_t start = job_id * kListsPerJob;
+  size_t end = std::min(start + kListsPerJob, job->num_lists);
 
-  for(cl_uint i = 0; i < num_lists; i++)
+  for(size_t i = start; i < end; i++)
   {
-    Node *pNode = &pNodes[i];
+    size_t allocation_index = job->num_lists + i * (job->list_length - 1);
+    Node *pNode = &job->pNodes[i];
     pNode->global_id = i;
     pNode->position_in_list = 0;
     Node *pNew;
-    for(int j=1; j < list_length; j++)
+    for(int j=1; j < job->list_length; j++)
     {
-      pNew = &pNodes[ allocation_index++ ];// allocate a new node
+      pNew = &job->pNodes[ allocation_index++ ];// allocate a new node
       pNew->global_id = i;
       pNew->position_in_list = j;
       pNode->pNext = pNew;  // link new node onto end of list
       pNode = pNew;   // move to end of list
     }
   }
+  return CL_SUCCESS;
 }
 
-cl_int verify_linked_lists(Node* pNodes, size_t num_lists, int list_length)
+static cl_int verify_linked_lists_job(cl_uint job_id, cl_uint thread_id,
+                                      void *userInfo)
 {
-  cl_int error = CL_SUCCESS;
-  int numCorrect = 0;
+  LinkedListJob *job = (LinkedListJob *)userInfo;
+  size_t start = job_id * kListsPerJob;
+  size_t end = std::min(start + kListsPerJob, job->num_lists);
+  size_t numCorrect = 0;
 
-  log_info(" and verifying on host ");
-  for(cl_uint i=0; i < num_lists; i++)
+  for(size_t i = start; i < end; i++)
   {
-    Node *pNode = &pNodes[i];
-    for(int j=0; j < list_length; j++)
+    Node *pNode = &job->pNodes[i];
+    for(int j=0; j < job->list_length; j++)
     {
-      if( pNode->global_id == i && pNode->position_in_list == j)
+      if( pNode->global_id == (cl_int)i && pNode->position_in_list == j)
       {
         numCorrect++;
       }
@@ -155,7 +190,42 @@ cl_int verify_linked_lists(Node* pNodes, size_t num_lists, int list_length)
       pNode = pNode->pNext;
     }
   }
-  if(numCorrect != list_length * (cl_uint)num_lists)
+  job->num_correct += numCorrect;
+  return CL_SUCCESS;
+}
+
+// The first N nodes in pNodes will be the heads of the lists.
+void create_linked_lists(Node* pNodes, size_t num_lists, int list_length)
+{
+  LinkedListJob job;
+  job.pNodes = pNodes;
+  job.num_lists = num_lists;
+  job.list_length = list_length;
+  job.num_correct = 0;
+  run_linked_list_jobs(create_linked_lists_job, &job);
+}
+
+cl_int count_linked_list_nodes(Node* pNodes, size_t num_lists, int list_length,
+                               size_t *num_correct)
+{
+  LinkedListJob job;
+  job.pNodes = pNodes;
+  job.num_lists = num_lists;
+  job.list_length = list_length;
+  job.num_correct = 0;
+  run_linked_list_jobs(verify_linked_lists_job, &job);
+  *num_correct = job.num_correct;
+  return CL_SUCCESS;
+}
+
+cl_int verify_linked_lists(Node* pNodes, size_t num_lists, int list_length)
+{
+  cl_int error = CL_SUCCESS;
+  size_t numCorrect = 0;
+
+  log_info(" and verifying on host ");
+  count_linked_list_nodes(pNodes, num_lists, list_length, &numCorrect);
+  if(numCorrect != list_length * num_lists)
   {
     error = -1;
     log_info("Failed\n");
@@ -276,6 +346,9 @@ test_definition test_list[] = {
     ADD_TEST(svm_pointer_passing),
     ADD_TEST(svm_enqueue_api),
     ADD_TEST_VERSION(svm_migrate, Version(2, 1)),
+    ADD_BENCHMARK_VERSION(svm_migrate_bandwidth, Version(2, 1)),
+    ADD_BENCHMARK(svm_linked_list_throughput),
+    ADD_BENCHMARK(svm_fine_grain_ping_pong),
 };
 
 const int test_num = ARRAY_SIZE( test_list );
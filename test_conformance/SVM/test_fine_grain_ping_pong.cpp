@@ -0,0 +1,265 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "common.h"
+#include "harness/benchmark.h"
+#include "harness/perfMetrics.h"
+
+#include <string>
+#include <vector>
+
+// Round trips of flags between the host and a running kernel through
+// fine-grain SVM atomics, the least it takes the two to signal each other.
+// In round i the host adds one to each flag, making it 2i + 1, and the
+// kernel, a single work-item, answers by storing 2i + 2, each side spinning
+// until it sees the other's value. With one flag the time per round is the
+// round trip latency, with several flags in flight the signals overlap and
+// the time per flag is the inverse of the throughput. The device side of the
+// flags is tried with each memory order, the flags packed together or a cache
+// line apart, in a fine-grain buffer and, where the device supports it, in
+// memory from malloc.
+
+// Written by either side to make the other give up
+static const cl_int kAbortFlag = -1;
+// Rounds per sample, the first of which, including the kernel launch, is not
+// timed
+static const cl_int kRounds = 1000;
+static const int kMaxFlags = 8;
+// Bytes between flags that should not share a cache line
+static const size_t kSeparateStride = 128;
+// Seconds without an answer after which the device is taken not to make
+// progress alongside the host
+static const double kTimeoutSeconds = 10.0;
+
+static const char *ping_pong_kernels[] = {
+    "#define PING_PONG(name, load_order, store_order)\\\n"
+    "__kernel void name(volatile __global atomic_int *flags, int stride,\\\n"
+    "                   int num_flags, int rounds)\\\n"
+    "{\\\n"
+    "    for (int i = 0; i < rounds; i++)\\\n"
+    "    {\\\n"
+    "        for (int f = 0; f < num_flags; f++)\\\n"
+    "        {\\\n"
+    "            volatile __global atomic_int *flag = flags + f * stride;\\\n"
+    "            int value;\\\n"
+    "            while ((value = atomic_load_explicit(flag, load_order,\\\n"
+    "                        memory_scope_all_svm_devices)) != 2 * i + 1)\\\n"
+    "                if (value < 0) return;\\\n"
+    "            atomic_store_explicit(flag, 2 * i + 2, store_order,\\\n"
+    "                                  memory_scope_all_svm_devices);\\\n"
+    "        }\\\n"
+    "    }\\\n"
+    "}\n"
+    "PING_PONG(ping_pong_relaxed, memory_order_relaxed, memory_order_relaxed)\n"
+    "PING_PONG(ping_pong_acq_rel, memory_order_acquire, memory_order_release)\n"
+    "PING_PONG(ping_pong_seq_cst, memory_order_seq_cst, memory_order_seq_cst)\n"
+};
+
+namespace {
+
+struct PingPongOrder
+{
+    const char *name;
+    const char *kernel;
+    cl_memory_order host;
+};
+
+const PingPongOrder kOrders[] = {
+    { "relaxed", "ping_pong_relaxed", memory_order_relaxed },
+    { "acq_rel", "ping_pong_acq_rel", memory_order_acq_rel },
+    { "seq_cst", "ping_pong_seq_cst", memory_order_seq_cst },
+};
+
+struct PingPongLayout
+{
+    const char *name;
+    int numFlags;
+    size_t stride; // bytes
+};
+
+const PingPongLayout kLayouts[] = {
+    { "1_flag", 1, sizeof(cl_int) },
+    { "8_flags_packed", kMaxFlags, sizeof(cl_int) },
+    { "8_flags_separate", kMaxFlags, kSeparateStride },
+};
+
+// Spin until *flag is value. Gives up after kTimeoutSeconds, or if the device
+// gave up.
+cl_int wait_for_flag(volatile cl_int *flag, cl_int value,
+                     cl_memory_order order)
+{
+    HostTimer timer;
+    for (unsigned spins = 1;; spins++)
+    {
+        cl_int seen = AtomicLoadExplicit(flag, order);
+        if (seen == value) return CL_SUCCESS;
+        if (seen == kAbortFlag)
+        {
+            log_error("ERROR: The device gave up waiting for the host\n");
+            return -1;
+        }
+        if (spins % 1024 == 0 && timer.elapsed_ns() > kTimeoutSeconds * 1e9)
+        {
+            log_error("ERROR: No answer from the device after %g seconds, "
+                      "it seems not to run alongside the host\n",
+                      kTimeoutSeconds);
+            return -1;
+        }
+    }
+}
+
+// One sample: a kernel launch of kRounds rounds over the flags, returning the
+// nanoseconds per round trip of a flag in *ns
+cl_int ping_pong(cl_command_queue queue, cl_kernel kernel, cl_int *flags,
+                 const PingPongLayout &layout, const PingPongOrder &order,
+                 double *ns)
+{
+    size_t stride = layout.stride / sizeof(cl_int);
+    for (int f = 0; f < layout.numFlags; f++) flags[f * stride] = 0;
+
+    size_t one = 1;
+    cl_event done;
+    cl_int error = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &one, &one,
+                                          0, NULL, &done);
+    test_error(error, "clEnqueueNDRangeKernel failed");
+    clEventWrapper doneWrapper = done;
+    error = clFlush(queue);
+    test_error(error, "clFlush failed");
+
+    HostTimer timer;
+    cl_int result = CL_SUCCESS;
+    for (cl_int i = 0; i < kRounds && result == CL_SUCCESS; i++)
+    {
+        if (i == 1) timer.restart();
+        for (int f = 0; f < layout.numFlags; f++)
+            AtomicFetchAddExplicit(&flags[f * stride], 1, order.host);
+        for (int f = 0; f < layout.numFlags && result == CL_SUCCESS; f++)
+            result = wait_for_flag(&flags[f * stride], 2 * i + 2, order.host);
+    }
+    *ns = timer.elapsed_ns() / ((kRounds - 1) * layout.numFlags);
+
+    // Let a kernel still spinning return
+    if (result != CL_SUCCESS)
+        for (int f = 0; f < layout.numFlags; f++)
+            AtomicExchangeExplicit(&flags[f * stride], kAbortFlag, order.host);
+    error = clWaitForEvents(1, &done);
+    test_error(error, "clWaitForEvents failed");
+    return result;
+}
+
+} // anonymous namespace
+
+int test_svm_fine_grain_ping_pong(cl_device_id deviceID, cl_context c,
+                                  cl_command_queue queue, int num_elements)
+{
+    clContextWrapper context = NULL;
+    clProgramWrapper program = NULL;
+    cl_uint num_devices = 0;
+    clCommandQueueWrapper queues[MAXQ];
+
+    cl_int error = create_cl_objects(
+        deviceID, &ping_pong_kernels[0], &context, &program, &queues[0],
+        &num_devices, CL_DEVICE_SVM_FINE_GRAIN_BUFFER | CL_DEVICE_SVM_ATOMICS);
+    if (error == 1) return 0; // no capable devices, counts as passing
+    if (error < 0) return -1;
+
+    cl_device_id device;
+    error = clGetCommandQueueInfo(queues[0], CL_QUEUE_DEVICE, sizeof(device),
+                                  &device, NULL);
+    test_error(error, "clGetCommandQueueInfo failed");
+    cl_device_svm_capabilities caps;
+    error = clGetDeviceInfo(device, CL_DEVICE_SVM_CAPABILITIES, sizeof(caps),
+                            &caps, NULL);
+    test_error(error, "clGetDeviceInfo failed");
+
+    size_t bytes = kMaxFlags * kSeparateStride;
+    cl_int *pBufferFlags = (cl_int *)clSVMAlloc(
+        context,
+        CL_MEM_READ_WRITE | CL_MEM_SVM_FINE_GRAIN_BUFFER | CL_MEM_SVM_ATOMICS,
+        bytes, 0);
+    if (!pBufferFlags)
+    {
+        log_error("ERROR: clSVMAlloc failed\n");
+        return -1;
+    }
+    std::vector<cl_int> systemFlags(bytes / sizeof(cl_int));
+
+    struct
+    {
+        const char *name;
+        cl_int *flags;
+    } placements[] = {
+        { "buffer", pBufferFlags },
+        { "system", (caps & CL_DEVICE_SVM_FINE_GRAIN_SYSTEM)
+              ? systemFlags.data()
+              : NULL },
+    };
+
+    BenchmarkOptions options;
+    options.warmup = 1;
+    options.maxSeconds = 2.0;
+
+    log_benchmark_header("svm_ping_pong", "order/placement/flags");
+    int result = 0;
+    for (const PingPongOrder &order : kOrders)
+    {
+        clKernelWrapper kernel = clCreateKernel(program, order.kernel, &error);
+        test_error(error, "clCreateKernel failed");
+
+        for (const auto &placement : placements)
+        {
+            if (!placement.flags) continue;
+            for (const PingPongLayout &layout : kLayouts)
+            {
+                cl_int stride = (cl_int)(layout.stride / sizeof(cl_int));
+                error = clSetKernelArgSVMPointer(kernel, 0, placement.flags);
+                error |= clSetKernelArg(kernel, 1, sizeof(stride), &stride);
+                error |= clSetKernelArg(kernel, 2, sizeof(cl_int),
+                                        &layout.numFlags);
+                error |= clSetKernelArg(kernel, 3, sizeof(kRounds), &kRounds);
+                if (error != CL_SUCCESS)
+                {
+                    print_error(error, "clSetKernelArg failed");
+                    result = -1;
+                    break;
+                }
+
+                BenchmarkStats stats;
+                result = run_benchmark(
+                    options,
+                    [&](double *ns) {
+                        return ping_pong(queues[0], kernel, placement.flags,
+                                         layout, order, ns);
+                    },
+                    &stats);
+                if (result) break;
+
+                std::string label = std::string(order.name) + "/"
+                    + placement.name + "/" + layout.name;
+                log_benchmark_stats("svm_ping_pong", label.c_str(), "ns",
+                                    false, stats);
+                if (stats.median > 0)
+                    record_perf_metric("svm_ping_pong_rate." + label,
+                                       1e3 / stats.median, "Mround_trips/s",
+                                       true);
+            }
+            if (result) break;
+        }
+        if (result) break;
+    }
+
+    clSVMFree(context, pBufferFlags);
+    return result;
+}
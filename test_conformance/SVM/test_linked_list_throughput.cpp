@@ -0,0 +1,237 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "common.h"
+#include "harness/benchmark.h"
+
+#include <algorithm>
+#include <string>
+
+// Pointer-chase throughput over fine-grain SVM buffers on the host and on the
+// device. The number of lists grows until the nodes fill as much of the
+// device's memory as one allocation may. Each side walks lists that it built
+// itself and lists that the other side built, and the difference between the
+// two is the price of moving the data between them. A benchmark, so it only
+// runs when named.
+
+static const cl_int kListLength = 32;
+
+namespace {
+
+struct ChaseBench
+{
+    cl_context context;
+    cl_command_queue queue;
+    cl_kernel kernel_create;
+    cl_kernel kernel_verify;
+    size_t num_lists;
+    Node *pNodes;
+    size_t *pAllocator;
+    cl_int *pNumCorrect;
+
+    size_t num_nodes() const { return num_lists * kListLength; }
+
+    cl_int DeviceCreate()
+    {
+        *pAllocator = num_lists;
+        cl_int error = clEnqueueNDRangeKernel(queue, kernel_create, 1, NULL,
+                                              &num_lists, NULL, 0, NULL, NULL);
+        test_error(error, "clEnqueueNDRangeKernel failed");
+        error = clFinish(queue);
+        test_error(error, "clFinish failed");
+        return CL_SUCCESS;
+    }
+
+    cl_int DeviceVerify()
+    {
+        *pNumCorrect = 0;
+        cl_int error = clEnqueueNDRangeKernel(queue, kernel_verify, 1, NULL,
+                                              &num_lists, NULL, 0, NULL, NULL);
+        test_error(error, "clEnqueueNDRangeKernel failed");
+        error = clFinish(queue);
+        test_error(error, "clFinish failed");
+        return Check("device", (size_t)*pNumCorrect);
+    }
+
+    cl_int HostVerify()
+    {
+        size_t num_correct;
+        count_linked_list_nodes(pNodes, num_lists, kListLength, &num_correct);
+        return Check("host", num_correct);
+    }
+
+    cl_int Check(const char *side, size_t num_correct)
+    {
+        if (num_correct != num_nodes())
+        {
+            log_error("ERROR: %s found %zu of %zu nodes in the linked lists\n",
+                      side, num_correct, num_nodes());
+            return -1;
+        }
+        return CL_SUCCESS;
+    }
+};
+
+// Samples the rate of fn in millions of nodes per second and logs its BENCH
+// row. Every phase leaves the lists as the next one expects them, so running
+// it repeatedly is safe.
+template <typename Fn>
+cl_int time_chase(ChaseBench &bench, const char *phase, Fn fn)
+{
+    BenchmarkOptions options;
+    options.warmup = 1;
+    options.minSamples = 5;
+    options.maxSeconds = 1.0;
+    BenchmarkStats stats;
+    cl_int error = run_benchmark(
+        options,
+        [&](double *rate) {
+            HostTimer timer;
+            cl_int err = fn();
+            if (err != CL_SUCCESS) return err;
+
+            double s = timer.elapsed_ns() / 1e9;
+            *rate = s > 0 ? bench.num_nodes() / s / 1e6 : 0.0;
+            return (cl_int)CL_SUCCESS;
+        },
+        &stats);
+    if (error != CL_SUCCESS) return error;
+
+    std::string label = std::to_string(bench.num_lists) + "/" + phase;
+    log_benchmark_stats("linked_list", label.c_str(), "Mnodes/s", true, stats);
+    return CL_SUCCESS;
+}
+
+} // anonymous namespace
+
+int test_svm_linked_list_throughput(cl_device_id deviceID, cl_context context2,
+                                    cl_command_queue queue,
+                                    int num_elements)
+{
+    clContextWrapper context = NULL;
+    clProgramWrapper program = NULL;
+    cl_uint num_devices = 0;
+    clCommandQueueWrapper queues[MAXQ];
+
+    cl_int error = create_cl_objects(
+        deviceID, &linked_list_create_and_verify_kernels[0], &context,
+        &program, &queues[0], &num_devices, CL_DEVICE_SVM_FINE_GRAIN_BUFFER);
+    if (error == 1) return 0; // no capable devices, counts as passing
+    if (error < 0) return -1;
+
+    // The harness device comes first when it is capable, otherwise measure
+    // whichever device does have fine-grain buffers
+    cl_device_id device;
+    error = clGetCommandQueueInfo(queues[0], CL_QUEUE_DEVICE, sizeof(device),
+                                  &device, NULL);
+    test_error(error, "clGetCommandQueueInfo failed");
+    cl_ulong max_alloc, global_mem;
+    error = clGetDeviceInfo(device, CL_DEVICE_MAX_MEM_ALLOC_SIZE,
+                            sizeof(max_alloc), &max_alloc, NULL);
+    test_error(error, "clGetDeviceInfo failed");
+    error = clGetDeviceInfo(device, CL_DEVICE_GLOBAL_MEM_SIZE,
+                            sizeof(global_mem), &global_mem, NULL);
+    test_error(error, "clGetDeviceInfo failed");
+    cl_ulong max_bytes = std::min(max_alloc, global_mem / 2);
+
+    clKernelWrapper kernel_create =
+        clCreateKernel(program, "create_linked_lists", &error);
+    test_error(error, "clCreateKernel failed");
+    clKernelWrapper kernel_verify =
+        clCreateKernel(program, "verify_linked_lists", &error);
+    test_error(error, "clCreateKernel failed");
+
+    ChaseBench bench;
+    bench.context = context;
+    bench.queue = queues[0];
+    bench.kernel_create = kernel_create;
+    bench.kernel_verify = kernel_verify;
+    bench.pAllocator = (size_t *)clSVMAlloc(
+        context, CL_MEM_READ_WRITE | CL_MEM_SVM_FINE_GRAIN_BUFFER,
+        sizeof(size_t), 0);
+    bench.pNumCorrect = (cl_int *)clSVMAlloc(
+        context, CL_MEM_READ_WRITE | CL_MEM_SVM_FINE_GRAIN_BUFFER,
+        sizeof(cl_int), 0);
+    if (!bench.pAllocator || !bench.pNumCorrect)
+    {
+        log_error("ERROR: clSVMAlloc failed\n");
+        return -1;
+    }
+
+    log_benchmark_header("linked_list", "lists/phase");
+
+    int result = 0;
+    for (size_t num_lists = std::max(num_elements, 1);
+         (cl_ulong)num_lists * kListLength * sizeof(Node) <= max_bytes;
+         num_lists *= 4)
+    {
+        size_t bytes = num_lists * kListLength * sizeof(Node);
+        bench.num_lists = num_lists;
+        bench.pNodes = (Node *)clSVMAlloc(
+            context, CL_MEM_READ_WRITE | CL_MEM_SVM_FINE_GRAIN_BUFFER, bytes,
+            0);
+        if (!bench.pNodes)
+        {
+            log_info("Unable to allocate %zu bytes of SVM, stopping.\n",
+                     bytes);
+            break;
+        }
+
+        error = clSetKernelArgSVMPointer(kernel_create, 0, bench.pNodes);
+        error |= clSetKernelArgSVMPointer(kernel_create, 1, bench.pAllocator);
+        error |= clSetKernelArg(kernel_create, 2, sizeof(cl_int), &kListLength);
+        error |= clSetKernelArgSVMPointer(kernel_verify, 0, bench.pNodes);
+        error |= clSetKernelArgSVMPointer(kernel_verify, 1, bench.pNumCorrect);
+        error |= clSetKernelArg(kernel_verify, 2, sizeof(cl_int), &kListLength);
+        if (error != CL_SUCCESS)
+        {
+            print_error(error, "clSetKernelArg failed");
+            result = -1;
+        }
+
+        if (!result)
+        {
+            // Lists built by the host and walked by both sides
+            result = time_chase(bench, "host_build", [&]() {
+                create_linked_lists(bench.pNodes, num_lists, kListLength);
+                return CL_SUCCESS;
+            });
+        }
+        if (!result)
+            result = time_chase(bench, "host_chase",
+                                [&]() { return bench.HostVerify(); });
+        if (!result)
+            result = time_chase(bench, "device_chase_host_built",
+                                [&]() { return bench.DeviceVerify(); });
+
+        // Lists built by the device and walked by both sides
+        if (!result)
+            result = time_chase(bench, "device_build",
+                                [&]() { return bench.DeviceCreate(); });
+        if (!result)
+            result = time_chase(bench, "device_chase",
+                                [&]() { return bench.DeviceVerify(); });
+        if (!result)
+            result = time_chase(bench, "host_chase_device_built",
+                                [&]() { return bench.HostVerify(); });
+
+        clSVMFree(context, bench.pNodes);
+        if (result) break;
+    }
+
+    clSVMFree(context, bench.pAllocator);
+    clSVMFree(context, bench.pNumCorrect);
+    return result;
+}
@@ -15,7 +15,11 @@
 //
 #include "common.h"
 #include "harness/mt19937.h"
+#include "harness/benchmark.h"
+#include "harness/perfMetrics.h"
 
+#include <algorithm>
+#include <string>
 #include <vector>
 
 #define GLOBAL_SIZE 65536
@@ -336,3 +340,312 @@ int test_svm_migrate(cl_device_id deviceID, cl_context c, cl_command_queue queue
     return ok ? 0 : -1;
 }
 
+
+// Migration cost measurements, a benchmark so it only runs when named. For
+// each size this times clEnqueueSVMMigrateMem in both directions, then the
+// first kernel to touch the data with and without a migration ahead of it
+// against a kernel on data that is already resident. On devices with
+// fine-grain buffers the host writes those directly, so the unmigrated case
+// is left to implicit page faulting. Finally one large allocation is
+// migrated against the same number of bytes split into many small
+// allocations. Every sample puts the data where its phase expects it before
+// the timed command.
+
+static const char *bench_sources[] = {
+    "__kernel void touch_kernel(__global uint *p)\n"
+    "{\n"
+    "    p[get_global_id(0)] += 1;\n"
+    "}\n"
+};
+
+static double gbps(size_t bytes, double us)
+{
+    return us > 0 ? bytes / (us * 1e3) : 0.0;
+}
+
+namespace {
+
+struct MigrateBench
+{
+    cl_command_queue queue;
+    cl_kernel kernel;
+    bool fine_grain;
+
+    cl_int Wait(cl_event ev, double *us)
+    {
+        cl_int error = clWaitForEvents(1, &ev);
+        test_error(error, "clWaitForEvents failed");
+
+        cl_ulong start, end;
+        error = clGetEventProfilingInfo(ev, CL_PROFILING_COMMAND_START,
+                                        sizeof(start), &start, NULL);
+        test_error(error, "clGetEventProfilingInfo failed");
+        error = clGetEventProfilingInfo(ev, CL_PROFILING_COMMAND_END,
+                                        sizeof(end), &end, NULL);
+        test_error(error, "clGetEventProfilingInfo failed");
+        *us = (end - start) / 1e3;
+        return CL_SUCCESS;
+    }
+
+    cl_int Migrate(cl_uint count, const void **ptrs, const size_t *sizes,
+                   cl_mem_migration_flags flags, double *us)
+    {
+        clEventWrapper ev;
+        cl_int error = clEnqueueSVMMigrateMem(queue, count, ptrs, sizes, flags,
+                                              0, NULL, &ev);
+        test_error(error, "clEnqueueSVMMigrateMem failed");
+        return Wait(ev, us);
+    }
+
+    cl_int Touch(void *ptr, size_t bytes, double *us)
+    {
+        cl_int error = clSetKernelArgSVMPointer(kernel, 0, ptr);
+        test_error(error, "clSetKernelArgSVMPointer failed");
+
+        clEventWrapper ev;
+        size_t global_size = bytes / sizeof(cl_uint);
+        error = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &global_size,
+                                       NULL, 0, NULL, &ev);
+        test_error(error, "clEnqueueNDRangeKernel failed");
+        return Wait(ev, us);
+    }
+
+    // Writes every byte from the host so that the data starts on its side
+    cl_int HostWrite(void *ptr, size_t bytes)
+    {
+        if (fine_grain)
+        {
+            memset(ptr, 0, bytes);
+            return CL_SUCCESS;
+        }
+
+        cl_int error = clEnqueueSVMMap(queue, CL_TRUE, CL_MAP_WRITE, ptr,
+                                       bytes, 0, NULL, NULL);
+        test_error(error, "clEnqueueSVMMap failed");
+        memset(ptr, 0, bytes);
+        error = clEnqueueSVMUnmap(queue, ptr, 0, NULL, NULL);
+        test_error(error, "clEnqueueSVMUnmap failed");
+        error = clFinish(queue);
+        test_error(error, "clFinish failed");
+        return CL_SUCCESS;
+    }
+
+    // Samples the device time of sample in microseconds and logs its BENCH
+    // row, and the bandwidth of its median over bytes when it moves them
+    template <typename Sample>
+    cl_int Measure(const std::string &label, size_t bytes, bool moves,
+                   Sample sample)
+    {
+        BenchmarkOptions options;
+        options.warmup = 1;
+        options.minSamples = 5;
+        options.maxSeconds = 1.0;
+        BenchmarkStats stats;
+        cl_int error = run_benchmark(options, sample, &stats);
+        if (error != CL_SUCCESS) return error;
+
+        log_benchmark_stats("svm_migrate", label.c_str(), "us", false, stats);
+        if (moves)
+            record_perf_metric("svm_migrate_GBps." + label,
+                               gbps(bytes, stats.median), "GB/s", true);
+        return CL_SUCCESS;
+    }
+
+    cl_int Sweep(cl_context context, size_t max_bytes)
+    {
+        const char *kind = fine_grain ? "fine" : "coarse";
+        cl_svm_mem_flags flags = CL_MEM_READ_WRITE;
+        if (fine_grain) flags |= CL_MEM_SVM_FINE_GRAIN_BUFFER;
+
+        for (size_t bytes = 4096; bytes <= max_bytes; bytes *= 4)
+        {
+            clSVMWrapper svm(context, bytes, flags);
+            void *ptr = svm();
+            if (ptr == NULL)
+            {
+                log_info("Unable to allocate %zu bytes of %s-grain SVM, "
+                         "stopping.\n",
+                         bytes, kind);
+                break;
+            }
+            const void *ptrs[] = { ptr };
+            std::string label =
+                std::string(kind) + "/" + std::to_string(bytes) + "/";
+
+            cl_int error = Measure(label + "to_device", bytes, true,
+                                   [&](double *us) {
+                                       cl_int err = HostWrite(ptr, bytes);
+                                       if (err != CL_SUCCESS) return err;
+                                       return Migrate(1, ptrs, NULL, 0, us);
+                                   });
+            if (error != CL_SUCCESS) return error;
+
+            error = Measure(label + "first_touch_migrated", bytes, false,
+                            [&](double *us) {
+                                double migrate_us;
+                                cl_int err = HostWrite(ptr, bytes);
+                                if (err == CL_SUCCESS)
+                                    err = Migrate(1, ptrs, NULL, 0,
+                                                  &migrate_us);
+                                if (err != CL_SUCCESS) return err;
+                                return Touch(ptr, bytes, us);
+                            });
+            if (error != CL_SUCCESS) return error;
+
+            error = Measure(label + "resident", bytes, false, [&](double *us) {
+                double first_us;
+                cl_int err = Touch(ptr, bytes, &first_us);
+                if (err != CL_SUCCESS) return err;
+                return Touch(ptr, bytes, us);
+            });
+            if (error != CL_SUCCESS) return error;
+
+            error = Measure(label + "to_host", bytes, true, [&](double *us) {
+                double touch_us;
+                cl_int err = Touch(ptr, bytes, &touch_us);
+                if (err != CL_SUCCESS) return err;
+                return Migrate(1, ptrs, NULL, CL_MIGRATE_MEM_OBJECT_HOST, us);
+            });
+            if (error != CL_SUCCESS) return error;
+
+            error = Measure(label + "first_touch_unmigrated", bytes, false,
+                            [&](double *us) {
+                                double migrate_us;
+                                cl_int err =
+                                    Migrate(1, ptrs, NULL,
+                                            CL_MIGRATE_MEM_OBJECT_HOST,
+                                            &migrate_us);
+                                if (err == CL_SUCCESS)
+                                    err = HostWrite(ptr, bytes);
+                                if (err != CL_SUCCESS) return err;
+                                return Touch(ptr, bytes, us);
+                            });
+            if (error != CL_SUCCESS) return error;
+        }
+        return CL_SUCCESS;
+    }
+
+    // Migrates total bytes held in allocations of each bytes in one call
+    cl_int Scatter(cl_context context, size_t total, size_t each)
+    {
+        size_t count = total / each;
+        std::vector<clSVMWrapper> svms;
+        std::vector<const void *> ptrs;
+        for (size_t i = 0; i < count; i++)
+        {
+            svms.emplace_back(context, each);
+            ptrs.push_back(svms.back()());
+            if (ptrs.back() == NULL)
+            {
+                log_info("Unable to allocate %zu SVM allocations of %zu "
+                         "bytes, skipping.\n",
+                         count, each);
+                return CL_SUCCESS;
+            }
+
+            cl_uint pattern = 0;
+            cl_int error = clEnqueueSVMMemFill(queue, svms.back()(), &pattern,
+                                               sizeof(pattern), each, 0, NULL,
+                                               NULL);
+            test_error(error, "clEnqueueSVMMemFill failed");
+        }
+        cl_int error = clFinish(queue);
+        test_error(error, "clFinish failed");
+
+        std::string label = "scatter/" + std::to_string(count) + "/"
+            + std::to_string(each) + "/";
+        for (bool to_host : { false, true })
+        {
+            cl_mem_migration_flags from =
+                to_host ? 0 : CL_MIGRATE_MEM_OBJECT_HOST;
+            cl_mem_migration_flags to =
+                to_host ? CL_MIGRATE_MEM_OBJECT_HOST : 0;
+            error = Measure(label + (to_host ? "to_host" : "to_device"), total,
+                            true, [&](double *us) {
+                                double from_us;
+                                cl_int err = Migrate((cl_uint)count,
+                                                     ptrs.data(), NULL, from,
+                                                     &from_us);
+                                if (err != CL_SUCCESS) return err;
+                                return Migrate((cl_uint)count, ptrs.data(),
+                                               NULL, to, us);
+                            });
+            if (error != CL_SUCCESS) return error;
+        }
+        return CL_SUCCESS;
+    }
+};
+
+} // anonymous namespace
+
+int test_svm_migrate_bandwidth(cl_device_id deviceID, cl_context c,
+                               cl_command_queue queue, int num_elements)
+{
+    clContextWrapper context = NULL;
+    clCommandQueueWrapper queues[MAXQ];
+    cl_uint num_devices = 0;
+    clProgramWrapper program;
+
+    cl_int error =
+        create_cl_objects(deviceID, &bench_sources[0], &context, &program,
+                          &queues[0], &num_devices,
+                          CL_DEVICE_SVM_COARSE_GRAIN_BUFFER);
+    if (error == 1) return 0; // no capable devices, counts as passing
+    if (error < 0) return -1;
+
+    cl_device_id device;
+    error = clGetCommandQueueInfo(queues[0], CL_QUEUE_DEVICE, sizeof(device),
+                                  &device, NULL);
+    test_error(error, "clGetCommandQueueInfo failed");
+
+    cl_queue_properties props[] = { CL_QUEUE_PROPERTIES,
+                                    CL_QUEUE_PROFILING_ENABLE, 0 };
+    clCommandQueueWrapper bench_queue =
+        clCreateCommandQueueWithProperties(context, device, props, &error);
+    test_error(error, "clCreateCommandQueueWithProperties failed");
+
+    clKernelWrapper kernel = clCreateKernel(program, "touch_kernel", &error);
+    test_error(error, "clCreateKernel failed");
+
+    cl_device_svm_capabilities caps;
+    error = clGetDeviceInfo(device, CL_DEVICE_SVM_CAPABILITIES, sizeof(caps),
+                            &caps, NULL);
+    test_error(error, "clGetDeviceInfo failed for CL_DEVICE_SVM_CAPABILITIES");
+
+    cl_ulong max_alloc;
+    error = clGetDeviceInfo(device, CL_DEVICE_MAX_MEM_ALLOC_SIZE,
+                            sizeof(max_alloc), &max_alloc, NULL);
+    test_error(error, "clGetDeviceInfo failed");
+    size_t max_bytes = (size_t)std::min<cl_ulong>(max_alloc, 64 << 20);
+
+    MigrateBench bench;
+    bench.queue = bench_queue;
+    bench.kernel = kernel;
+
+    log_benchmark_header("svm_migrate", "kind/bytes/phase");
+    bench.fine_grain = false;
+    error = bench.Sweep(context, max_bytes);
+    if (error != CL_SUCCESS) return -1;
+
+    if (caps & CL_DEVICE_SVM_FINE_GRAIN_BUFFER)
+    {
+        bench.fine_grain = true;
+        error = bench.Sweep(context, max_bytes);
+        if (error != CL_SUCCESS) return -1;
+    }
+    else
+    {
+        log_info("Device doesn't support fine-grain SVM buffers, skipping "
+                 "the implicit migration comparison.\n");
+    }
+
+    size_t total = std::min<size_t>(max_bytes, 16 << 20);
+    log_benchmark_header("svm_migrate", "scatter/allocations/bytes_each/phase");
+    for (size_t each = total; each >= 4096; each /= 16)
+    {
+        error = bench.Scatter(context, total, each);
+        if (error != CL_SUCCESS) return -1;
+    }
+
+    return 0;
+}
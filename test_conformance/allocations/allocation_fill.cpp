@@ -17,167 +17,228 @@
 
 #define BUFFER_CHUNK_SIZE 8 * 1024 * 1024
 #define IMAGE_LINES 8
+#define FILL_JOB_ITEMS 64 * 1024
 
 #include "harness/compat.h"
+#include "harness/crc32.h"
+#include "harness/ThreadPool.h"
 
-int fill_buffer_with_data(cl_context context, cl_device_id device_id,
-                          cl_command_queue *queue, cl_mem mem, size_t size,
-                          MTdata d, cl_bool blocking_write)
-{
-    size_t i, j;
-    cl_uint *data;
-    int error, result;
-    cl_uint checksum_delta = 0;
-    cl_event event;
+#include <algorithm>
+#include <chrono>
+#include <vector>
 
-    size_t size_to_use = BUFFER_CHUNK_SIZE;
-    if (size_to_use > size) size_to_use = size;
+namespace {
 
-    data = (cl_uint *)malloc(size_to_use);
-    if (data == NULL)
+// Host data for one chunk of a memory object. Generating it and checking it
+// after a readback are split into jobs run on the thread pool. Each job is
+// seeded from the test's generator in order, so the data and checksum don't
+// depend on the number of threads.
+struct FillChunk
+{
+    cl_uint *data;
+    size_t count;
+    std::vector<cl_uint> seeds;
+    std::vector<cl_uint> sums;
+    std::vector<uint32_t> crcs;
+    const cl_uint *readback;
+    std::vector<cl_uint> mismatches;
+
+    cl_uint jobs() const
     {
-        log_error("Failed to malloc host buffer for writing into buffer.\n");
-        return FAILED_ABORT;
+        return (cl_uint)((count + FILL_JOB_ITEMS - 1) / FILL_JOB_ITEMS);
     }
-    for (i = 0; i < size - size_to_use; i += size_to_use)
-    {
-        // Put values in the data, and keep a checksum as we go along.
-        for (j = 0; j < size_to_use / sizeof(cl_uint); j++)
-        {
-            data[j] = genrand_int32(d);
-            checksum_delta += data[j];
-        }
-        if (blocking_write)
-        {
-            error = clEnqueueWriteBuffer(*queue, mem, CL_TRUE, i, size_to_use,
-                                         data, 0, NULL, NULL);
-            result = check_allocation_error(context, device_id, error, queue);
+};
 
-            if (result == FAILED_ABORT)
-            {
-                print_error(error, "clEnqueueWriteBuffer failed.");
-            }
+cl_int generate_job(cl_uint job_id, cl_uint thread_id, void *userInfo)
+{
+    FillChunk *chunk = (FillChunk *)userInfo;
+    size_t start = (size_t)job_id * FILL_JOB_ITEMS;
+    size_t count = std::min((size_t)FILL_JOB_ITEMS, chunk->count - start);
+    cl_uint *data = chunk->data + start;
+    MTdataHolder d(chunk->seeds[job_id]);
+
+    cl_uint sum = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        data[i] = genrand_int32(d);
+        sum += data[i];
+    }
+    chunk->sums[job_id] = sum;
+    chunk->crcs[job_id] = crc32(data, count * sizeof(cl_uint));
+    return CL_SUCCESS;
+}
 
-            if (result != SUCCEEDED)
-            {
-                clFinish(*queue);
-                free(data);
-                clReleaseMemObject(mem);
-                return result;
-            }
-        }
-        else
-        {
-            error = clEnqueueWriteBuffer(*queue, mem, CL_FALSE, i, size_to_use,
-                                         data, 0, NULL, &event);
-            result = check_allocation_error(context, device_id, error, queue);
+cl_int verify_job(cl_uint job_id, cl_uint thread_id, void *userInfo)
+{
+    FillChunk *chunk = (FillChunk *)userInfo;
+    size_t start = (size_t)job_id * FILL_JOB_ITEMS;
+    size_t count = std::min((size_t)FILL_JOB_ITEMS, chunk->count - start);
+
+    chunk->mismatches[job_id] =
+        crc32(chunk->readback + start, count * sizeof(cl_uint))
+        != chunk->crcs[job_id];
+    return CL_SUCCESS;
+}
 
-            if (result == FAILED_ABORT)
-            {
-                print_error(error, "clEnqueueWriteBuffer failed.");
-            }
+void run_jobs(TPFuncPtr func, FillChunk *chunk)
+{
+    cl_uint jobs = chunk->jobs();
+    if (jobs > 1 && GetThreadCount() > 1
+        && ThreadPool_Do(func, jobs, chunk) == CL_SUCCESS)
+        return;
 
-            if (result != SUCCEEDED)
-            {
-                clFinish(*queue);
-                free(data);
-                clReleaseMemObject(mem);
-                return result;
-            }
+    for (cl_uint i = 0; i < jobs; i++) func(i, 0, chunk);
+}
 
-            error = clWaitForEvents(1, &event);
-            result = check_allocation_error(context, device_id, error, queue,
-                                            &event);
+// Fills count values of data with random values and returns their sum
+cl_uint generate_data(FillChunk *chunk, cl_uint *data, size_t count,
+                      MTdata d)
+{
+    chunk->data = data;
+    chunk->count = count;
+    cl_uint jobs = chunk->jobs();
+    chunk->seeds.resize(jobs);
+    chunk->sums.resize(jobs);
+    chunk->crcs.resize(jobs);
+    for (cl_uint i = 0; i < jobs; i++) chunk->seeds[i] = genrand_int32(d);
+
+    run_jobs(generate_job, chunk);
+
+    cl_uint sum = 0;
+    for (cl_uint i = 0; i < jobs; i++) sum += chunk->sums[i];
+    return sum;
+}
 
-            if (result == FAILED_ABORT)
-            {
-                print_error(error, "clWaitForEvents failed.");
-            }
+// Returns the index of the first job whose data differs in readback, or -1
+long verify_data(FillChunk *chunk, const cl_uint *readback)
+{
+    chunk->readback = readback;
+    chunk->mismatches.assign(chunk->jobs(), 0);
 
-            if (result != SUCCEEDED)
-            {
-                clFinish(*queue);
-                clReleaseEvent(event);
-                free(data);
-                clReleaseMemObject(mem);
-                return result;
-            }
+    run_jobs(verify_job, chunk);
 
-            clReleaseEvent(event);
-        }
-    }
+    for (size_t i = 0; i < chunk->mismatches.size(); i++)
+        if (chunk->mismatches[i]) return (long)i;
+    return -1;
+}
 
-    // Deal with any leftover bits
-    if (i < size)
-    {
-        // Put values in the data, and keep a checksum as we go along.
-        for (j = 0; j < (size - i) / sizeof(cl_uint); j++)
-        {
-            data[j] = (cl_uint)genrand_int32(d);
-            checksum_delta += data[j];
-        }
+// Checks the result of an enqueued write or read and, for a non-blocking
+// one, waits for it to complete.
+int complete_transfer(cl_context context, cl_device_id device_id,
+                      cl_command_queue *queue, int error, cl_event *event,
+                      const char *name)
+{
+    int result = check_allocation_error(context, device_id, error, queue);
+    if (result == FAILED_ABORT) print_error(error, name);
+    if (result != SUCCEEDED || event == NULL) return result;
+
+    error = clWaitForEvents(1, event);
+    result = check_allocation_error(context, device_id, error, queue, event);
+    if (result == FAILED_ABORT) print_error(error, "clWaitForEvents failed.");
+    clReleaseEvent(*event);
+    return result;
+}
 
-        if (blocking_write)
-        {
-            error = clEnqueueWriteBuffer(*queue, mem, CL_TRUE, i, size - i,
-                                         data, 0, NULL, NULL);
-            result = check_allocation_error(context, device_id, error, queue);
+struct TransferTimes
+{
+    double write_seconds = 0.0;
+    double read_seconds = 0.0;
+};
 
-            if (result == FAILED_ABORT)
-            {
-                print_error(error, "clEnqueueWriteBuffer failed.");
-            }
+double elapsed(std::chrono::steady_clock::time_point start)
+{
+    std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+    return d.count();
+}
 
-            if (result != SUCCEEDED)
-            {
-                clFinish(*queue);
-                clReleaseMemObject(mem);
-                free(data);
-                return result;
-            }
-        }
-        else
-        {
-            error = clEnqueueWriteBuffer(*queue, mem, CL_FALSE, i, size - i,
-                                         data, 0, NULL, &event);
-            result = check_allocation_error(context, device_id, error, queue);
+void report_bandwidth(size_t size, const TransferTimes &times)
+{
+    log_info("\t\t\tFilled %gMB at %.1f MB/s", toMB(size),
+             times.write_seconds > 0.0 ? toMB(size) / times.write_seconds
+                                       : 0.0);
+    if (g_verify_readback)
+        log_info(", read back at %.1f MB/s",
+                 times.read_seconds > 0.0 ? toMB(size) / times.read_seconds
+                                          : 0.0);
+    log_info(".\n");
+}
 
-            if (result == FAILED_ABORT)
-            {
-                print_error(error, "clEnqueueWriteBuffer failed.");
-            }
+} // anonymous namespace
 
-            if (result != SUCCEEDED)
-            {
-                clFinish(*queue);
-                clReleaseMemObject(mem);
-                free(data);
-                return result;
-            }
+int fill_buffer_with_data(cl_context context, cl_device_id device_id,
+                          cl_command_queue *queue, cl_mem mem, size_t size,
+                          MTdata d, cl_bool blocking_write)
+{
+    size_t i;
+    cl_uint *data, *readback = NULL;
+    int error, result;
+    cl_uint checksum_delta = 0;
+    cl_event event;
+    FillChunk chunk;
+    TransferTimes times;
 
-            error = clWaitForEvents(1, &event);
-            result = check_allocation_error(context, device_id, error, queue,
-                                            &event);
+    size_t size_to_use = BUFFER_CHUNK_SIZE;
+    if (size_to_use > size) size_to_use = size;
 
-            if (result == FAILED_ABORT)
-            {
-                print_error(error, "clWaitForEvents failed.");
-            }
+    data = (cl_uint *)malloc(size_to_use);
+    if (g_verify_readback) readback = (cl_uint *)malloc(size_to_use);
+    if (data == NULL || (g_verify_readback && readback == NULL))
+    {
+        log_error("Failed to malloc host buffer for writing into buffer.\n");
+        free(data);
+        free(readback);
+        return FAILED_ABORT;
+    }
+    for (i = 0; i < size; i += size_to_use)
+    {
+        size_t chunk_size = std::min(size_to_use, size - i);
 
-            if (result != SUCCEEDED)
+        // Put values in the data, and keep a checksum as we go along.
+        checksum_delta += generate_data(&chunk, data,
+                                        chunk_size / sizeof(cl_uint), d);
+
+        auto start = std::chrono::steady_clock::now();
+        error = clEnqueueWriteBuffer(*queue, mem, blocking_write, i,
+                                     chunk_size, data, 0, NULL,
+                                     blocking_write ? NULL : &event);
+        result =
+            complete_transfer(context, device_id, queue, error,
+                              blocking_write ? NULL : &event,
+                              "clEnqueueWriteBuffer failed.");
+        times.write_seconds += elapsed(start);
+
+        if (result == SUCCEEDED && g_verify_readback)
+        {
+            start = std::chrono::steady_clock::now();
+            error = clEnqueueReadBuffer(*queue, mem, CL_TRUE, i, chunk_size,
+                                        readback, 0, NULL, NULL);
+            result = complete_transfer(context, device_id, queue, error, NULL,
+                                       "clEnqueueReadBuffer failed.");
+            times.read_seconds += elapsed(start);
+
+            long job = result == SUCCEEDED ? verify_data(&chunk, readback) : -1;
+            if (job >= 0)
             {
-                clFinish(*queue);
-                clReleaseEvent(event);
-                free(data);
-                clReleaseMemObject(mem);
-                return result;
+                log_error("Data read back from buffer differs near offset "
+                          "%zu.\n",
+                          i + (size_t)job * FILL_JOB_ITEMS * sizeof(cl_uint));
+                result = FAILED_ABORT;
             }
+        }
 
-            clReleaseEvent(event);
+        if (result != SUCCEEDED)
+        {
+            clFinish(*queue);
+            free(data);
+            free(readback);
+            clReleaseMemObject(mem);
+            return result;
         }
     }
 
     free(data);
+    free(readback);
+    report_bandwidth(size, times);
     // Only update the checksum if this succeeded.
     checksum += checksum_delta;
     return SUCCEEDED;
@@ -188,20 +249,26 @@ int fill_image_with_data(cl_context context, cl_device_id device_id,
                          cl_command_queue *queue, cl_mem mem, size_t width,
                          size_t height, MTdata d, cl_bool blocking_write)
 {
-    size_t origin[3], region[3], j;
+    size_t origin[3], region[3];
     int error, result;
-    cl_uint *data;
+    cl_uint *data, *readback = NULL;
     cl_uint checksum_delta = 0;
     cl_event event;
+    FillChunk chunk;
+    TransferTimes times;
 
     size_t image_lines_to_use;
     image_lines_to_use = IMAGE_LINES;
     if (image_lines_to_use > height) image_lines_to_use = height;
 
-    data = (cl_uint *)malloc(width * 4 * sizeof(cl_uint) * image_lines_to_use);
-    if (data == NULL)
+    size_t data_size = width * 4 * sizeof(cl_uint) * image_lines_to_use;
+    data = (cl_uint *)malloc(data_size);
+    if (g_verify_readback) readback = (cl_uint *)malloc(data_size);
+    if (data == NULL || (g_verify_readback && readback == NULL))
     {
         log_error("Failed to malloc host buffer for writing into image.\n");
+        free(data);
+        free(readback);
         return FAILED_ABORT;
     }
     origin[0] = 0;
@@ -210,156 +277,67 @@ int fill_image_with_data(cl_context context, cl_device_id device_id,
     region[0] = width;
     region[1] = image_lines_to_use;
     region[2] = 1;
-    for (origin[1] = 0; origin[1] < height - image_lines_to_use;
-         origin[1] += image_lines_to_use)
+    for (origin[1] = 0; origin[1] < height; origin[1] += image_lines_to_use)
     {
-        // Put values in the data, and keep a checksum as we go along.
-        for (j = 0; j < width * 4 * image_lines_to_use; j++)
-        {
-            data[j] = (cl_uint)genrand_int32(d);
-            checksum_delta += data[j];
-        }
+        region[1] = std::min(image_lines_to_use, height - origin[1]);
 
-        if (blocking_write)
+        // Put values in the data, and keep a checksum as we go along.
+        checksum_delta +=
+            generate_data(&chunk, data, width * 4 * region[1], d);
+
+        auto start = std::chrono::steady_clock::now();
+        error = clEnqueueWriteImage(*queue, mem, blocking_write, origin,
+                                    region, 0, 0, data, 0, NULL,
+                                    blocking_write ? NULL : &event);
+        result =
+            complete_transfer(context, device_id, queue, error,
+                              blocking_write ? NULL : &event,
+                              "clEnqueueWriteImage failed.");
+        if (result == SUCCEEDED && blocking_write)
         {
-            error = clEnqueueWriteImage(*queue, mem, CL_TRUE, origin, region, 0,
-                                        0, data, 0, NULL, NULL);
-            result = check_allocation_error(context, device_id, error, queue);
-
-            if (result == FAILED_ABORT)
-            {
-                print_error(error, "clEnqueueWriteImage failed.");
-            }
-
-            if (result != SUCCEEDED)
-            {
-                clFinish(*queue);
-                clReleaseMemObject(mem);
-                free(data);
-                return result;
-            }
-            result = clFinish(*queue);
-            if (result != SUCCEEDED)
+            error = clFinish(*queue);
+            if (error != CL_SUCCESS)
             {
-                print_error(
-                    error,
-                    "clFinish failed after successful enqueuing filling "
-                    "buffer with data.");
-                return result;
+                print_error(error,
+                            "clFinish failed after successful enqueuing "
+                            "filling image with data.");
+                result = FAILED_ABORT;
             }
         }
-        else
-        {
-            error = clEnqueueWriteImage(*queue, mem, CL_FALSE, origin, region,
-                                        0, 0, data, 0, NULL, &event);
-            result = check_allocation_error(context, device_id, error, queue);
+        times.write_seconds += elapsed(start);
 
-            if (result == FAILED_ABORT)
-            {
-                print_error(error, "clEnqueueWriteImage failed.");
-            }
-
-            if (result != SUCCEEDED)
-            {
-                clFinish(*queue);
-                clReleaseMemObject(mem);
-                free(data);
-                return result;
-            }
-
-            error = clWaitForEvents(1, &event);
-            result = check_allocation_error(context, device_id, error, queue,
-                                            &event);
-
-            if (result == FAILED_ABORT)
-            {
-                print_error(error, "clWaitForEvents failed.");
-            }
-
-            if (result != SUCCEEDED)
-            {
-                clReleaseEvent(event);
-                free(data);
-                clReleaseMemObject(mem);
-                return result;
-            }
-
-            clReleaseEvent(event);
-        }
-    }
-
-    // Deal with any leftover bits
-    if (origin[1] < height)
-    {
-        // Put values in the data, and keep a checksum as we go along.
-        for (j = 0; j < width * 4 * (height - origin[1]); j++)
+        if (result == SUCCEEDED && g_verify_readback)
         {
-            data[j] = (cl_uint)genrand_int32(d);
-            checksum_delta += data[j];
-        }
-
-        region[1] = height - origin[1];
-        if (blocking_write)
-        {
-            error = clEnqueueWriteImage(*queue, mem, CL_TRUE, origin, region, 0,
-                                        0, data, 0, NULL, NULL);
-            result = check_allocation_error(context, device_id, error, queue);
-
-            if (result == FAILED_ABORT)
+            start = std::chrono::steady_clock::now();
+            error = clEnqueueReadImage(*queue, mem, CL_TRUE, origin, region, 0,
+                                       0, readback, 0, NULL, NULL);
+            result = complete_transfer(context, device_id, queue, error, NULL,
+                                       "clEnqueueReadImage failed.");
+            times.read_seconds += elapsed(start);
+
+            long job = result == SUCCEEDED ? verify_data(&chunk, readback) : -1;
+            if (job >= 0)
             {
-                print_error(error, "clEnqueueWriteImage failed.");
-            }
-
-            if (result != SUCCEEDED)
-            {
-                clFinish(*queue);
-                clReleaseMemObject(mem);
-                free(data);
-                return result;
+                log_error("Data read back from image differs near row %zu.\n",
+                          origin[1]
+                              + (size_t)job * FILL_JOB_ITEMS / (width * 4));
+                result = FAILED_ABORT;
             }
         }
-        else
-        {
-            error = clEnqueueWriteImage(*queue, mem, CL_FALSE, origin, region,
-                                        0, 0, data, 0, NULL, &event);
-            result = check_allocation_error(context, device_id, error, queue);
-
-            if (result == FAILED_ABORT)
-            {
-                print_error(error, "clEnqueueWriteImage failed.");
-            }
-
-            if (result != SUCCEEDED)
-            {
-                clFinish(*queue);
-                clReleaseMemObject(mem);
-                free(data);
-                return result;
-            }
 
-            error = clWaitForEvents(1, &event);
-            result = check_allocation_error(context, device_id, error, queue,
-                                            &event);
-
-            if (result == FAILED_ABORT)
-            {
-                print_error(error, "clWaitForEvents failed.");
-            }
-
-            if (result != SUCCEEDED)
-            {
-                clFinish(*queue);
-                clReleaseEvent(event);
-                free(data);
-                clReleaseMemObject(mem);
-                return result;
-            }
-
-            clReleaseEvent(event);
+        if (result != SUCCEEDED)
+        {
+            clFinish(*queue);
+            free(data);
+            free(readback);
+            clReleaseMemObject(mem);
+            return result;
         }
     }
 
     free(data);
+    free(readback);
+    report_bandwidth(width * height * 4 * sizeof(cl_uint), times);
     // Only update the checksum if this succeeded.
     checksum += checksum_delta;
     return SUCCEEDED;
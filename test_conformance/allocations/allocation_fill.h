@@ -16,6 +16,8 @@
 #include "testBase.h"
 #include "allocation_utils.h"
 
+extern int g_verify_readback;
+
 int fill_mem_with_data(cl_context context, cl_device_id device_id,
                        cl_command_queue *queue, cl_mem mem, MTdata d,
                        cl_bool blocking_write);
@@ -16,6 +16,7 @@
 #include "allocation_functions.h"
 #include "allocation_fill.h"
 
+#include <algorithm>
 
 static cl_image_format image_format = { CL_RGBA, CL_UNSIGNED_INT32 };
 
@@ -170,6 +171,62 @@ int do_allocation(cl_context context, cl_command_queue *queue,
 }
 
 
+// Writes to the first and last element of a memory object so that memory
+// the implementation backs lazily is committed at both ends.
+static int touch_allocation(cl_context context, cl_device_id device_id,
+                            cl_command_queue *queue, cl_mem mem, int type)
+{
+    cl_uint data[4] = { 0, 0, 0, 0 };
+    int error;
+
+    if (type == BUFFER || type == BUFFER_NON_BLOCKING)
+    {
+        size_t size;
+        error = clGetMemObjectInfo(mem, CL_MEM_SIZE, sizeof(size), &size, NULL);
+        test_error_abort(error, "clGetMemObjectInfo failed for CL_MEM_SIZE.");
+        size_t touch = std::min(size, sizeof(data));
+        error = clEnqueueWriteBuffer(*queue, mem, CL_TRUE, 0, touch, data, 0,
+                                     NULL, NULL);
+        if (error == CL_SUCCESS)
+            error = clEnqueueWriteBuffer(*queue, mem, CL_TRUE, size - touch,
+                                         touch, data, 0, NULL, NULL);
+    }
+    else
+    {
+        size_t width, height;
+        error =
+            clGetImageInfo(mem, CL_IMAGE_WIDTH, sizeof(width), &width, NULL);
+        test_error_abort(error, "clGetImageInfo failed for CL_IMAGE_WIDTH.");
+        error =
+            clGetImageInfo(mem, CL_IMAGE_HEIGHT, sizeof(height), &height, NULL);
+        test_error_abort(error, "clGetImageInfo failed for CL_IMAGE_HEIGHT.");
+        size_t origin[3] = { 0, 0, 0 };
+        size_t region[3] = { 1, 1, 1 };
+        error = clEnqueueWriteImage(*queue, mem, CL_TRUE, origin, region, 0, 0,
+                                    data, 0, NULL, NULL);
+        origin[0] = width - 1;
+        origin[1] = height - 1;
+        if (error == CL_SUCCESS)
+            error = clEnqueueWriteImage(*queue, mem, CL_TRUE, origin, region,
+                                        0, 0, data, 0, NULL, NULL);
+    }
+
+    return check_allocation_error(context, device_id, error, queue);
+}
+
+// Checks whether an object of the given size can be allocated, touching it
+// rather than filling it, and releases it again.
+static int probe_allocation(cl_context context, cl_command_queue *queue,
+                            cl_device_id device_id, size_t size, int type)
+{
+    cl_mem mem = NULL;
+    int result = do_allocation(context, queue, device_id, size, type, &mem);
+    if (result == SUCCEEDED)
+        result = touch_allocation(context, device_id, queue, mem, type);
+    if (mem) clReleaseMemObject(mem);
+    return result;
+}
+
 int allocate_size(cl_context context, cl_command_queue *queue,
                   cl_device_id device_id, int multiple_allocations,
                   size_t size_to_allocate, int type, cl_mem mems[],
@@ -180,7 +237,6 @@ int allocate_size(cl_context context, cl_command_queue *queue,
     cl_ulong max_individual_allocation_size, global_mem_size;
     int error, result;
     size_t amount_allocated;
-    size_t reduction_amount;
     int current_allocation;
     size_t allocation_this_time, actual_allocation;
 
@@ -238,8 +294,6 @@ int allocate_size(cl_context context, cl_command_queue *queue,
             max_individual_allocation_size = max_size;
     }
 
-    reduction_amount = (size_t)max_individual_allocation_size / 16;
-
     if (type == BUFFER || type == BUFFER_NON_BLOCKING)
         log_info("\tAttempting to allocate a buffer of size %gMB.\n",
                  toMB(size_to_allocate));
@@ -296,7 +350,12 @@ int allocate_size(cl_context context, cl_command_queue *queue,
         if (allocation_this_time > max_individual_allocation_size)
             allocation_this_time = (size_t)max_individual_allocation_size;
 
-        // Allocate the largest object possible
+        // Allocate the largest object possible. After a failure, bisect with
+        // cheap probes between the largest size known to work and the
+        // smallest known to fail, to within 1/64th of the first attempt.
+        size_t probe_good = 0;
+        size_t probe_bad;
+        size_t tolerance = std::max(allocation_this_time / 64, (size_t)1);
         result = FAILED_TOO_BIG;
         // log_info("\t\tTrying sub-allocation %d at size %gMB.\n",
         // current_allocation, toMB(allocation_this_time));
@@ -350,16 +409,24 @@ int allocate_size(cl_context context, cl_command_queue *queue,
             {
                 // log_info("\t\t\tAllocation %d failed at size %gMB. Trying
                 // smaller.\n", current_allocation, toMB(allocation_this_time));
-                if (allocation_this_time > reduction_amount)
-                    allocation_this_time -= reduction_amount;
-                else if (reduction_amount > 1)
-                {
-                    reduction_amount /= 2;
-                }
-                else
+                probe_bad = allocation_this_time;
+                // A probe only touches the object, so a size it passed can
+                // still fail once filled; search below it again.
+                if (probe_good >= probe_bad) probe_good = 0;
+                while (probe_bad - probe_good > tolerance)
                 {
-                    allocation_this_time = 0;
+                    size_t probe_size =
+                        probe_good + (probe_bad - probe_good) / 2;
+                    int probe = probe_allocation(context, queue, device_id,
+                                                 probe_size, type);
+                    if (probe == SUCCEEDED)
+                        probe_good = probe_size;
+                    else if (probe == FAILED_TOO_BIG)
+                        probe_bad = probe_size;
+                    else
+                        return probe;
                 }
+                allocation_this_time = probe_good;
             }
         }
 
@@ -20,6 +20,7 @@
 #include "allocation_execute.h"
 #include "harness/testHarness.h"
 #include "harness/parseParameters.h"
+#include "harness/bufferSizing.h"
 #include <time.h>
 
 typedef long long unsigned llu;
@@ -29,6 +30,7 @@ int g_reduction_percentage = 100;
 int g_write_allocations = 1;
 int g_multiple_allocations = 0;
 int g_execute_kernel = 1;
+int g_verify_readback = 0;
 
 static size_t g_max_size;
 static RandomSeed g_seed(gRandomSeed);
@@ -113,6 +115,14 @@ test_status init_cl(cl_device_id device)
         // code on GPU.
         g_global_mem_size *= 0.60;
     }
+    cl_ulong budget = limit_to_device_mem_budget((cl_ulong)g_global_mem_size);
+    if (budget < (cl_ulong)g_global_mem_size)
+    {
+        g_global_mem_size = (cl_long)budget;
+        log_info("Backing off the maximum combined allocation size to %gMB "
+                 "to fit the device memory budget.\n",
+                 toMB(g_global_mem_size));
+    }
     /* Cap the allocation size as the global size was deduced */
     if (g_max_individual_allocation_size > g_global_mem_size)
     {
@@ -260,10 +270,24 @@ int doTest(cl_device_id device, cl_context context, cl_command_queue queue,
 
             if (error == FAILED_TOO_BIG)
             {
-                current_test_size -= g_max_size / 16;
-                log_info(
-                    "\tFailed at this size; trying a smaller size of %gMB.\n",
-                    toMB(current_test_size));
+                // Halve the distance to 3/16ths, the smallest size the 1/16th
+                // steps tried, while the halves are at least a step. That
+                // size is tried last.
+                size_t last_size = 3 * (g_max_size / 16);
+                if (current_test_size <= last_size)
+                {
+                    // Ends the loop
+                    current_test_size = g_max_size / 8;
+                }
+                else
+                {
+                    size_t gap = (current_test_size - last_size) / 2;
+                    current_test_size =
+                        gap >= g_max_size / 16 ? last_size + gap : last_size;
+                    log_info("\tFailed at this size; trying a smaller size of "
+                             "%gMB.\n",
+                             toMB(current_test_size));
+                }
             }
         }
 
@@ -316,13 +340,15 @@ int test_image2d_write_non_blocking(cl_device_id device, cl_context context,
     return doTest(device, context, queue, IMAGE_WRITE_NON_BLOCKING);
 }
 
+// Each test allocates as much of the device memory as it can, so none of them
+// can share the device with other tests
 test_definition test_list[] = {
-    ADD_TEST(buffer),
-    ADD_TEST(image2d_read),
-    ADD_TEST(image2d_write),
-    ADD_TEST(buffer_non_blocking),
-    ADD_TEST(image2d_read_non_blocking),
-    ADD_TEST(image2d_write_non_blocking),
+    ADD_TEST_SERIAL(buffer),
+    ADD_TEST_SERIAL(image2d_read),
+    ADD_TEST_SERIAL(image2d_write),
+    ADD_TEST_SERIAL(buffer_non_blocking),
+    ADD_TEST_SERIAL(image2d_read_non_blocking),
+    ADD_TEST_SERIAL(image2d_write_non_blocking),
 };
 
 const int test_num = ARRAY_SIZE(test_list);
@@ -381,6 +407,11 @@ int main(int argc, const char *argv[])
             g_execute_kernel = 0;
         }
 
+        else if (strcmp(argv[i], "verify_readback") == 0)
+        {
+            g_verify_readback = 1;
+        }
+
         else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0)
         {
             printUsage(argv[0]);
@@ -427,6 +458,9 @@ void printUsage(const char *execName)
              "verify its checksum.\n");
     log_info("\tdo_not_execute - Disable executing a kernel that accesses all "
              "of the memory objects.\n");
+    log_info("\tverify_readback - Read back all filled memory objects and "
+             "check them against\n");
+    log_info("\t                  a CRC of the written data.\n");
     log_info("\n");
     log_info("Test names (Allocation Types):\n");
     for (int i = 0; i < test_num; i++)
@@ -66,7 +66,7 @@ test_definition test_list[] = {
     ADD_TEST(min_max_work_group_size),
     ADD_TEST(min_max_read_image_args),
     ADD_TEST(min_max_write_image_args),
-    ADD_TEST(min_max_mem_alloc_size),
+    ADD_TEST_SERIAL(min_max_mem_alloc_size),
     ADD_TEST(min_max_image_2d_width),
     ADD_TEST(min_max_image_2d_height),
     ADD_TEST(min_max_image_3d_width),
@@ -91,10 +91,15 @@ test_definition test_list[] = {
 
     ADD_TEST(kernel_arg_changes),
     ADD_TEST(kernel_arg_multi_setup_random),
+    ADD_BENCHMARK(kernel_arg_bench),
 
     ADD_TEST(native_kernel),
+    ADD_BENCHMARK(native_kernel_bench),
 
     ADD_TEST(create_context_from_type),
+    ADD_BENCHMARK(context_creation_bench),
+    ADD_BENCHMARK(retain_release_bench),
+    ADD_BENCHMARK(mem_object_creation_bench),
 
     ADD_TEST(platform_extensions),
     ADD_TEST(get_platform_ids),
@@ -120,9 +125,11 @@ test_definition test_list[] = {
     ADD_TEST(get_image2d_array_info),
     ADD_TEST(queue_flush_on_release),
     ADD_TEST(queue_hint),
+    ADD_BENCHMARK(queue_hint_bench),
     ADD_TEST(queue_properties),
     ADD_TEST_VERSION(sub_group_dispatch, Version(2, 1)),
     ADD_TEST_VERSION(clone_kernel, Version(2, 1)),
+    ADD_BENCHMARK(clone_kernel_dispatch_bench),
     ADD_TEST_VERSION(zero_sized_enqueue, Version(2, 1)),
 
     ADD_TEST_VERSION(buffer_properties_queries, Version(3, 0)),
@@ -152,6 +159,7 @@ test_definition test_list[] = {
     ADD_TEST(work_group_suggested_local_size_1D),
     ADD_TEST(work_group_suggested_local_size_2D),
     ADD_TEST(work_group_suggested_local_size_3D),
+    ADD_BENCHMARK(work_group_suggested_local_size_quality),
 
     ADD_TEST(negative_create_command_queue),
     ADD_TEST_VERSION(negative_create_command_queue_with_properties,
@@ -18,6 +18,7 @@
 #include "harness/typeWrappers.h"
 #include "harness/clImageHelper.h"
 #include "harness/imageHelpers.h"
+#include "harness/parseParameters.h"
 extern float    calculate_ulperror(float a, float b);
 
 extern int        test_load_single_kernel(cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements);
@@ -217,6 +218,30 @@ extern int test_work_group_suggested_local_size_3D(cl_device_id device,
                                                    cl_context context,
                                                    cl_command_queue queue,
                                                    int n_elems);
+extern int test_work_group_suggested_local_size_quality(cl_device_id device,
+                                                        cl_context context,
+                                                        cl_command_queue queue,
+                                                        int n_elems);
+
+extern int test_kernel_arg_bench(cl_device_id device, cl_context context,
+                                 cl_command_queue queue, int num_elements);
+extern int test_clone_kernel_dispatch_bench(cl_device_id device,
+                                            cl_context context,
+                                            cl_command_queue queue,
+                                            int num_elements);
+extern int test_native_kernel_bench(cl_device_id device, cl_context context,
+                                    cl_command_queue queue, int num_elements);
+extern int test_queue_hint_bench(cl_device_id device, cl_context context,
+                                 cl_command_queue queue, int num_elements);
+extern int test_context_creation_bench(cl_device_id device, cl_context context,
+                                       cl_command_queue queue,
+                                       int num_elements);
+extern int test_retain_release_bench(cl_device_id device, cl_context context,
+                                     cl_command_queue queue, int num_elements);
+extern int test_mem_object_creation_bench(cl_device_id device,
+                                          cl_context context,
+                                          cl_command_queue queue,
+                                          int num_elements);
 
 extern int test_negative_create_command_queue(cl_device_id deviceID,
                                               cl_context context,
@@ -560,6 +560,18 @@ int test_min_max_write_image_args(cl_device_id deviceID, cl_context context,
     return 0;
 }
 
+// The next size to try after a resource failure at current: halfway to
+// floor, or floor itself once that is within step, or 0 once floor failed.
+// A failing attempt can be slow, stepping down by a fixed amount took up to
+// 16 attempts where this takes about 5.
+static cl_ulong next_smaller_size(cl_ulong current, cl_ulong floor,
+                                  cl_ulong step)
+{
+    if (current <= floor) return 0;
+    cl_ulong gap = (current - floor) / 2;
+    return gap >= step ? floor + gap : floor;
+}
+
 int test_min_max_mem_alloc_size(cl_device_id deviceID, cl_context context,
                                 cl_command_queue queue, int num_elements)
 {
@@ -645,7 +657,7 @@ int test_min_max_mem_alloc_size(cl_device_id deviceID, cl_context context,
         {
             log_info("\tAllocation failed at size of %lld bytes (%gMB).\n",
                      maxAllocSize, (double)maxAllocSize / (1024.0 * 1024.0));
-            maxAllocSize -= minSizeToTry;
+            maxAllocSize = next_smaller_size(maxAllocSize, 0, minSizeToTry);
             continue;
         }
         test_error(error, "clCreateBuffer failed for maximum sized buffer.");
@@ -1610,30 +1622,31 @@ int test_min_max_constant_buffer_size(cl_device_id deviceID, cl_context context,
         return -1;
     }
 
-    /* Try the returned max size and decrease it until we get one that works. */
+    /* Try the returned max size and decrease it until we get one that works.
+     * The data is generated once, smaller attempts use the start of it. */
     stepSize = maxSize / 16;
     currentSize = maxSize;
     int allocPassed = 0;
+    constantData = (cl_int *)malloc((size_t)maxSize);
+    if (constantData == NULL)
+    {
+        log_error("Failed to allocate memory for constantData!\n");
+        return EXIT_FAILURE;
+    }
     d = init_genrand(gRandomSeed);
+    for (i = 0; i < (int)(maxSize / sizeof(cl_int)); i++)
+        constantData[i] = (int)genrand_int32(d);
+    free_mtdata(d);
+    d = NULL;
     while (!allocPassed && currentSize >= maxSize / PASSING_FRACTION)
     {
         log_info("Attempting to allocate constant buffer of size %lld bytes\n",
-                 maxSize);
+                 currentSize);
 
         /* Create some I/O streams */
         size_t sizeToAllocate =
             ((size_t)currentSize / sizeof(cl_int)) * sizeof(cl_int);
         size_t numberOfInts = sizeToAllocate / sizeof(cl_int);
-        constantData = (cl_int *)malloc(sizeToAllocate);
-        if (constantData == NULL)
-        {
-            log_error("Failed to allocate memory for constantData!\n");
-            free_mtdata(d);
-            return EXIT_FAILURE;
-        }
-
-        for (i = 0; i < (int)(numberOfInts); i++)
-            constantData[i] = (int)genrand_int32(d);
 
         clMemWrapper streams[3];
         streams[0] = clCreateBuffer(context, CL_MEM_COPY_HOST_PTR,
@@ -1668,8 +1681,8 @@ int test_min_max_constant_buffer_size(cl_device_id deviceID, cl_context context,
             log_info("Kernel enqueue failed at size %lld, trying at a reduced "
                      "size.\n",
                      currentSize);
-            currentSize -= stepSize;
-            free(constantData);
+            currentSize = next_smaller_size(
+                currentSize, maxSize / PASSING_FRACTION, stepSize);
             continue;
         }
         test_error(
@@ -1694,8 +1707,8 @@ int test_min_max_constant_buffer_size(cl_device_id deviceID, cl_context context,
                 log_info("Kernel event indicates failure at size %lld, trying "
                          "at a reduced size.\n",
                          currentSize);
-                currentSize -= stepSize;
-                free(constantData);
+                currentSize = next_smaller_size(
+                    currentSize, maxSize / PASSING_FRACTION, stepSize);
                 continue;
             }
             else
@@ -1712,7 +1725,6 @@ int test_min_max_constant_buffer_size(cl_device_id deviceID, cl_context context,
         {
             log_error("Failed to allocate memory for resultData!\n");
             free(constantData);
-            free_mtdata(d);
             return EXIT_FAILURE;
         }
 
@@ -1728,16 +1740,12 @@ int test_min_max_constant_buffer_size(cl_device_id deviceID, cl_context context,
                           i, constantData[i], i, resultData[i]);
                 free(constantData);
                 free(resultData);
-                free_mtdata(d);
-                d = NULL;
                 return -1;
             }
 
-        free(constantData);
         free(resultData);
     }
-    free_mtdata(d);
-    d = NULL;
+    free(constantData);
 
     if (allocPassed)
     {
@@ -0,0 +1,201 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "testBase.h"
+#include "harness/ThreadPool.h"
+#include "harness/typeWrappers.h"
+#include "harness/benchmark.h"
+#include "harness/perfMetrics.h"
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Measures how the host enqueue path scales with the number of submitting
+// threads. Each of T thread pool jobs sets the arguments of a kernel and
+// enqueues it to its own queue, either all through one kernel under a lock
+// or each through its own clCloneKernel copy, and the aggregate enqueue rate
+// is reported against T. A benchmark, so it only runs when named.
+
+namespace {
+
+const cl_uint kLaunchesPerThread = 2000;
+
+const char *dispatch_kernel_source =
+    "__kernel void dispatch(__global uint *out, uint value)\n"
+    "{\n"
+    "    out[0] = value;\n"
+    "}\n";
+
+struct DispatchJobs
+{
+    std::vector<cl_command_queue> queues;
+    std::vector<cl_kernel> kernels;
+    std::vector<cl_mem> outs;
+    // Held around set-arguments-and-enqueue when the jobs share one kernel
+    std::mutex *lock;
+};
+
+cl_uint launch_value(cl_uint job, cl_uint launch) { return job << 16 | launch; }
+
+cl_int dispatch_job(cl_uint job, cl_uint thread_id, void *userInfo)
+{
+    DispatchJobs *jobs = (DispatchJobs *)userInfo;
+    cl_kernel kernel = jobs->kernels[job];
+    size_t global = 1;
+    for (cl_uint launch = 0; launch < kLaunchesPerThread; launch++)
+    {
+        std::unique_lock<std::mutex> guard;
+        if (jobs->lock) guard = std::unique_lock<std::mutex>(*jobs->lock);
+
+        cl_uint value = launch_value(job, launch);
+        cl_int error = clSetKernelArg(kernel, 0, sizeof(cl_mem),
+                                      &jobs->outs[job]);
+        error |= clSetKernelArg(kernel, 1, sizeof(value), &value);
+        test_error(error, "Unable to set kernel arguments");
+        error = clEnqueueNDRangeKernel(jobs->queues[job], kernel, 1, NULL,
+                                       &global, NULL, 0, NULL, NULL);
+        test_error(error, "Unable to enqueue kernel");
+    }
+    return CL_SUCCESS;
+}
+
+// Runs threadCount jobs at once and gives the aggregate enqueues per second,
+// after checking each job's last launch landed
+int sample_dispatch(DispatchJobs &jobs, cl_uint threadCount, const char *name,
+                  double *outEnqueuesPerSecond)
+{
+    HostTimer timer;
+    cl_int error = ThreadPool_Do(dispatch_job, threadCount, &jobs);
+    test_error(error, "Dispatch job failed");
+    for (cl_uint t = 0; t < threadCount; t++)
+    {
+        error = clFinish(jobs.queues[t]);
+        test_error(error, "clFinish failed");
+    }
+    double seconds = timer.elapsed_ns() / 1e9;
+
+    for (cl_uint t = 0; t < threadCount; t++)
+    {
+        cl_uint actual;
+        error = clEnqueueReadBuffer(jobs.queues[t], jobs.outs[t], CL_TRUE, 0,
+                                    sizeof(actual), &actual, 0, NULL, NULL);
+        test_error(error, "Unable to read result");
+        cl_uint expected = launch_value(t, kLaunchesPerThread - 1);
+        if (actual != expected)
+        {
+            log_error("%s: thread %u's last launch wrote 0x%x, expected "
+                      "0x%x\n",
+                      name, t, actual, expected);
+            return TEST_FAIL;
+        }
+    }
+
+    *outEnqueuesPerSecond = threadCount * (double)kLaunchesPerThread / seconds;
+    return TEST_PASS;
+}
+
+} // anonymous namespace
+
+int test_clone_kernel_dispatch_bench(cl_device_id device, cl_context context,
+                                     cl_command_queue queue, int num_elements)
+{
+    clProgramWrapper program;
+    clKernelWrapper kernel;
+    int error = create_single_kernel_helper(context, &program, &kernel, 1,
+                                            &dispatch_kernel_source,
+                                            "dispatch");
+    test_error(error, "Unable to create dispatch kernel");
+
+    bool canClone = get_device_cl_version(device) >= Version(2, 1);
+    cl_uint maxThreads = GetThreadCount();
+    std::vector<clCommandQueueWrapper> queues(maxThreads);
+    std::vector<clKernelWrapper> clones(maxThreads);
+    std::vector<clMemWrapper> outs(maxThreads);
+    for (cl_uint t = 0; t < maxThreads; t++)
+    {
+        queues[t] = clCreateCommandQueue(context, device, 0, &error);
+        test_error(error, "Unable to create command queue");
+        outs[t] = clCreateBuffer(context, CL_MEM_WRITE_ONLY, sizeof(cl_uint),
+                                 NULL, &error);
+        test_error(error, "Unable to create output buffer");
+        if (canClone)
+        {
+            clones[t] = clCloneKernel(kernel, &error);
+            test_error(error, "clCloneKernel failed");
+        }
+    }
+
+    BenchmarkOptions options;
+    options.warmup = 1;
+    options.maxSeconds = 2.0;
+
+    log_benchmark_header("clone_kernel_dispatch", "kernel/threads");
+    double clonedSingleRate = 0;
+    for (cl_uint threadCount = 1; threadCount <= maxThreads;
+         threadCount *= 2)
+    {
+        std::mutex lock;
+        DispatchJobs jobs;
+        jobs.lock = &lock;
+        for (cl_uint t = 0; t < threadCount; t++)
+        {
+            jobs.queues.push_back(queues[t]);
+            jobs.kernels.push_back(kernel);
+            jobs.outs.push_back(outs[t]);
+        }
+
+        std::string threads = std::to_string(threadCount);
+        BenchmarkStats stats;
+        error = run_benchmark(
+            options,
+            [&](double *rate) {
+                return sample_dispatch(jobs, threadCount, "shared", rate);
+            },
+            &stats);
+        if (error != CL_SUCCESS) return TEST_FAIL;
+        log_benchmark_stats("clone_kernel_dispatch",
+                            ("shared/" + threads).c_str(), "enqueues/s", true,
+                            stats);
+
+        if (canClone)
+        {
+            jobs.lock = NULL;
+            for (cl_uint t = 0; t < threadCount; t++)
+                jobs.kernels[t] = clones[t];
+            error = run_benchmark(
+                options,
+                [&](double *rate) {
+                    return sample_dispatch(jobs, threadCount, "cloned", rate);
+                },
+                &stats);
+            if (error != CL_SUCCESS) return TEST_FAIL;
+            log_benchmark_stats("clone_kernel_dispatch",
+                                ("cloned/" + threads).c_str(), "enqueues/s",
+                                true, stats);
+            if (threadCount == 1) clonedSingleRate = stats.median;
+            record_perf_metric("clone_kernel_dispatch_scaling." + threads,
+                               clonedSingleRate > 0
+                                   ? stats.median / clonedSingleRate
+                                   : 0.0,
+                               "ratio", true);
+        }
+    }
+    if (!canClone)
+        log_info("clCloneKernel needs OpenCL 2.1, cloned kernels were not "
+                 "measured\n");
+
+    return TEST_PASS;
+}
@@ -0,0 +1,273 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "testBase.h"
+#include "harness/contextPool.h"
+#include "harness/perfMetrics.h"
+#include "harness/typeWrappers.h"
+#include "harness/benchmark.h"
+
+#include <string>
+#include <vector>
+
+// Measures what it costs to get from nothing to a first finished command:
+// creating and releasing a context, from the device and from its type,
+// creating and releasing a queue for each set of queue properties the device
+// supports, and the first and second command on a new queue, which shows the
+// work a driver puts off until the queue is used. The first sample of each
+// measurement is reported as cold, and the samples run_benchmark takes after
+// it as warm. The harness has already created a context on the device by
+// then, so cold is the first time in the test rather than in the process.
+// Borrowing from the harness context pool is measured the same way, to show
+// whether the pool pays for itself on the driver. A benchmark, so it only
+// runs when named.
+
+namespace {
+
+struct QueueConfig
+{
+    const char *name;
+    cl_command_queue_properties properties;
+};
+
+const QueueConfig kQueueConfigs[] = {
+    { "default", 0 },
+    { "profiling", CL_QUEUE_PROFILING_ENABLE },
+    { "out_of_order", CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE },
+    { "out_of_order_profiling",
+      CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE | CL_QUEUE_PROFILING_ENABLE },
+};
+
+// Takes one sample of name as the cold one, recorded as the name_cold_us
+// metric, and then the warm ones
+int measure(const std::string &name, const BenchmarkSampleFn &sample)
+{
+    double cold;
+    cl_int error = sample(&cold);
+    if (error != CL_SUCCESS) return TEST_FAIL;
+    log_info("%s cold: %.1f us\n", name.c_str(), cold);
+    record_perf_metric(name + "_cold_us", cold, "us", false);
+
+    BenchmarkOptions options;
+    options.warmup = 0;
+    options.maxSeconds = 1.0;
+    BenchmarkStats stats;
+    error = run_benchmark(options, sample, &stats);
+    if (error != CL_SUCCESS) return TEST_FAIL;
+    log_benchmark_stats("context_creation", name.c_str(), "us", false, stats);
+    return TEST_PASS;
+}
+
+int time_contexts(cl_device_id device)
+{
+    cl_platform_id platform;
+    cl_device_type type;
+    cl_int error = clGetDeviceInfo(device, CL_DEVICE_PLATFORM,
+                                   sizeof(platform), &platform, NULL);
+    test_error(error, "Unable to get CL_DEVICE_PLATFORM");
+    error = clGetDeviceInfo(device, CL_DEVICE_TYPE, sizeof(type), &type, NULL);
+    test_error(error, "Unable to get CL_DEVICE_TYPE");
+    // Only the type bits, without CL_DEVICE_TYPE_DEFAULT
+    type &= CL_DEVICE_TYPE_CPU | CL_DEVICE_TYPE_GPU
+        | CL_DEVICE_TYPE_ACCELERATOR | CL_DEVICE_TYPE_CUSTOM;
+
+    cl_context_properties properties[] = {
+        CL_CONTEXT_PLATFORM, (cl_context_properties)platform, 0
+    };
+    auto create = [&](bool fromType, cl_int *errcode) {
+        return fromType
+            ? clCreateContextFromType(properties, type, notify_callback, NULL,
+                                      errcode)
+            : clCreateContext(properties, 1, &device, notify_callback, NULL,
+                              errcode);
+    };
+
+    for (bool fromType : { false, true })
+    {
+        std::string name = fromType ? "context_from_type" : "context";
+        int ret = measure(name + "_create", [&](double *us) {
+            cl_int error;
+            HostTimer timer;
+            clContextWrapper context = create(fromType, &error);
+            *us = timer.elapsed_us();
+            test_error(error, "Unable to create context");
+            return CL_SUCCESS;
+        });
+        if (ret != TEST_PASS) return ret;
+
+        ret = measure(name + "_release", [&](double *us) {
+            cl_int error;
+            clContextWrapper context = create(fromType, &error);
+            test_error(error, "Unable to create context");
+            HostTimer timer;
+            context.reset();
+            *us = timer.elapsed_us();
+            return CL_SUCCESS;
+        });
+        if (ret != TEST_PASS) return ret;
+    }
+    return TEST_PASS;
+}
+
+// A context of its own, with a buffer, for each queue sample, created
+// beforehand and not timed, so that the driver can't reuse the state of an
+// earlier queue
+struct QueueSample
+{
+    clContextWrapper context;
+    clMemWrapper out;
+    clCommandQueueWrapper queue;
+
+    cl_int Setup(cl_device_id device)
+    {
+        cl_int error;
+        context =
+            clCreateContext(NULL, 1, &device, notify_callback, NULL, &error);
+        test_error(error, "Unable to create context");
+        out = clCreateBuffer(context, CL_MEM_READ_WRITE, sizeof(cl_uint), NULL,
+                             &error);
+        test_error(error, "Unable to create buffer");
+        return CL_SUCCESS;
+    }
+
+    cl_int CreateQueue(cl_device_id device, const QueueConfig &config)
+    {
+        cl_int error;
+        queue =
+            clCreateCommandQueue(context, device, config.properties, &error);
+        test_error(error, "Unable to create command queue");
+        return CL_SUCCESS;
+    }
+
+    // One blocking write of value to out, in us
+    cl_int Write(cl_uint value, double *us)
+    {
+        HostTimer timer;
+        cl_int error = clEnqueueWriteBuffer(queue, out, CL_TRUE, 0,
+                                            sizeof(value), &value, 0, NULL,
+                                            NULL);
+        test_error(error, "Unable to write buffer");
+        *us = timer.elapsed_us();
+        return CL_SUCCESS;
+    }
+};
+
+int time_queues(cl_device_id device, const QueueConfig &config)
+{
+    std::string name = std::string("queue_") + config.name;
+    int ret = measure(name + "_create", [&](double *us) {
+        QueueSample sample;
+        cl_int error = sample.Setup(device);
+        if (error != CL_SUCCESS) return error;
+        HostTimer timer;
+        error = sample.CreateQueue(device, config);
+        *us = timer.elapsed_us();
+        return error;
+    });
+    if (ret != TEST_PASS) return ret;
+
+    ret = measure(name + "_first_command", [&](double *us) {
+        QueueSample sample;
+        cl_int error = sample.Setup(device);
+        if (error != CL_SUCCESS) return error;
+        error = sample.CreateQueue(device, config);
+        if (error != CL_SUCCESS) return error;
+        return sample.Write(1, us);
+    });
+    if (ret != TEST_PASS) return ret;
+
+    cl_uint value = 0;
+    ret = measure(name + "_second_command", [&](double *us) -> cl_int {
+        QueueSample sample;
+        cl_int error = sample.Setup(device);
+        if (error != CL_SUCCESS) return error;
+        error = sample.CreateQueue(device, config);
+        if (error != CL_SUCCESS) return error;
+        double first_us;
+        value += 2;
+        error = sample.Write(value, &first_us);
+        if (error != CL_SUCCESS) return error;
+        error = sample.Write(value + 1, us);
+        if (error != CL_SUCCESS) return error;
+
+        cl_uint result;
+        error = clEnqueueReadBuffer(sample.queue, sample.out, CL_TRUE, 0,
+                                    sizeof(result), &result, 0, NULL, NULL);
+        test_error(error, "Unable to read buffer");
+        if (result != value + 1)
+        {
+            log_error("Read %u from the buffer after writing %u on a %s "
+                      "queue\n",
+                      result, value + 1, config.name);
+            return TEST_FAIL;
+        }
+        return CL_SUCCESS;
+    });
+    if (ret != TEST_PASS) return ret;
+
+    return measure(name + "_release", [&](double *us) {
+        QueueSample sample;
+        cl_int error = sample.Setup(device);
+        if (error != CL_SUCCESS) return error;
+        error = sample.CreateQueue(device, config);
+        if (error != CL_SUCCESS) return error;
+        HostTimer timer;
+        sample.queue.reset();
+        *us = timer.elapsed_us();
+        return CL_SUCCESS;
+    });
+}
+
+// The first borrow creates the pooled context and queue, the others reuse
+// them, so cold and warm compare creating a context with borrowing one
+int time_pool(cl_device_id device)
+{
+    return measure("context_pool_borrow", [&](double *us) {
+        HostTimer timer;
+        PooledContext pooled(device);
+        *us = timer.elapsed_us();
+        test_error(pooled.status(), "Unable to borrow a pooled context");
+        return CL_SUCCESS;
+    });
+}
+
+} // anonymous namespace
+
+int test_context_creation_bench(cl_device_id device, cl_context context,
+                                cl_command_queue queue, int num_elements)
+{
+    cl_command_queue_properties supported;
+    cl_int error = clGetDeviceInfo(device, CL_DEVICE_QUEUE_PROPERTIES,
+                                   sizeof(supported), &supported, NULL);
+    test_error(error, "Unable to get CL_DEVICE_QUEUE_PROPERTIES");
+
+    log_benchmark_header("context_creation", "operation");
+    int ret = time_contexts(device);
+    if (ret != TEST_PASS) return ret;
+
+    for (const QueueConfig &config : kQueueConfigs)
+    {
+        if ((config.properties & supported) != config.properties)
+        {
+            log_info("%s queues are not supported, skipping them\n",
+                     config.name);
+            continue;
+        }
+        ret = time_queues(device, config);
+        if (ret != TEST_PASS) return ret;
+    }
+
+    return time_pool(device);
+}
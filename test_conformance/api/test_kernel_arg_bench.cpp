@@ -0,0 +1,486 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "testBase.h"
+#include "harness/typeWrappers.h"
+#include "harness/benchmark.h"
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Measures the host cost of clSetKernelArg plus a single work-item enqueue,
+// as the number, size and kind of arguments changes, and of sharing one
+// kernel between threads against giving each thread a clCloneKernel copy.
+// Every launch changes every argument, and the result of the last launch is
+// checked so a lost argument update shows up as a failure. A benchmark, so
+// it only runs when named.
+
+namespace {
+
+// Launches timed together for each sample
+const size_t kLaunchesPerSample = 200;
+const cl_uint kArgCounts[] = { 1, 4, 16, 32, 64 };
+const cl_uint kThreadedArgCount = 16;
+const unsigned kThreadCount = 4;
+
+// Launch index -> sets every argument of the kernel for that launch
+typedef std::function<cl_int(size_t)> ArgSetter;
+// Launch index -> what that launch writes to out, or empty when it writes
+// nothing to check
+typedef std::function<cl_uint(size_t)> ExpectedFn;
+
+BenchmarkOptions launch_options()
+{
+    BenchmarkOptions options;
+    options.warmup = 1;
+    options.maxSeconds = 1.0;
+    return options;
+}
+
+std::string case_label(const char *name, cl_uint argCount, size_t argBytes,
+                       unsigned threads)
+{
+    return std::string(name) + "/" + std::to_string(argCount) + "/"
+        + std::to_string(argBytes) + "/" + std::to_string(threads);
+}
+
+// Kernel with argCount pointer arguments after out, each pointing at one
+// uint. Buffer and SVM arguments are summed into out[0]; local ones are
+// only declared.
+std::string many_args_source(cl_uint argCount, bool local)
+{
+    std::string params = "__global uint *out";
+    std::string sum = "0";
+    for (cl_uint i = 0; i < argCount; i++)
+    {
+        std::string name = "a" + std::to_string(i);
+        params += local ? ", __local uint *" : ", __global uint *";
+        params += name;
+        if (!local) sum += " + " + name + "[0]";
+    }
+    return "__kernel void many_args(" + params + ")\n{\n    out[0] = " + sum
+        + ";\n}\n";
+}
+
+// Which of the two pool entries argument arg points at for launch; entry n
+// holds n + 1, and the kernels sum what their arguments point at
+cl_uint pool_index(size_t launch, cl_uint arg) { return (launch + arg) & 1; }
+
+cl_uint expected_sum(size_t launch, cl_uint argCount)
+{
+    cl_uint sum = 0;
+    for (cl_uint i = 0; i < argCount; i++) sum += pool_index(launch, i) + 1;
+    return sum;
+}
+
+// Runs launches single work-item launches of kernel with setArgs called
+// before each one, and gives the host time per launch in us
+int time_launches(cl_command_queue queue, cl_kernel kernel,
+                  const ArgSetter &setArgs, size_t firstLaunch,
+                  size_t launches, double *outUsPerLaunch)
+{
+    size_t global = 1;
+    HostTimer timer;
+    for (size_t launch = firstLaunch; launch < firstLaunch + launches;
+         launch++)
+    {
+        cl_int error = setArgs(launch);
+        test_error(error, "Unable to set kernel arguments");
+        error = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &global, NULL,
+                                       0, NULL, NULL);
+        test_error(error, "Unable to enqueue kernel");
+    }
+    cl_int error = clFinish(queue);
+    test_error(error, "clFinish failed");
+    *outUsPerLaunch = timer.elapsed_us() / launches;
+    return CL_SUCCESS;
+}
+
+int check_out(cl_command_queue queue, cl_mem out, cl_uint expected,
+              const char *what)
+{
+    cl_uint actual;
+    cl_int error = clEnqueueReadBuffer(queue, out, CL_TRUE, 0, sizeof(actual),
+                                       &actual, 0, NULL, NULL);
+    test_error(error, "Unable to read result");
+    if (actual != expected)
+    {
+        log_error("%s: last launch wrote %u, expected %u\n", what, actual,
+                  expected);
+        return TEST_FAIL;
+    }
+    return TEST_PASS;
+}
+
+// Times and checks one case, and prints its BENCH row. Each sample carries
+// on from the launches of the last, and out holds what the very last launch
+// wrote.
+int bench_case(cl_command_queue queue, cl_kernel kernel,
+               const ArgSetter &setArgs, cl_mem out,
+               const ExpectedFn &expected, const char *name,
+               cl_uint argCount, size_t argBytes)
+{
+    size_t nextLaunch = 0;
+    BenchmarkStats stats;
+    int error = run_benchmark(
+        launch_options(),
+        [&](double *usPerLaunch) {
+            cl_int err = time_launches(queue, kernel, setArgs, nextLaunch,
+                                       kLaunchesPerSample, usPerLaunch);
+            nextLaunch += kLaunchesPerSample;
+            return err;
+        },
+        &stats);
+    if (error != CL_SUCCESS) return TEST_FAIL;
+    if (expected
+        && check_out(queue, out, expected(nextLaunch - 1), name) != TEST_PASS)
+        return TEST_FAIL;
+
+    log_benchmark_stats("kernel_arg",
+                        case_label(name, argCount, argBytes, 1).c_str(), "us",
+                        false, stats);
+    return TEST_PASS;
+}
+
+int bench_arg_counts(cl_context context, cl_command_queue queue,
+                     cl_uint pointerSize, size_t maxParameterSize,
+                     bool svm)
+{
+    cl_int error;
+    clMemWrapper out = clCreateBuffer(context, CL_MEM_READ_WRITE,
+                                      sizeof(cl_uint), NULL, &error);
+    test_error(error, "Unable to create output buffer");
+
+    clMemWrapper pool[2];
+    void *svmPool[2] = { NULL, NULL };
+    for (cl_uint i = 0; i < 2; i++)
+    {
+        cl_uint value = i + 1;
+        pool[i] = clCreateBuffer(context, CL_MEM_COPY_HOST_PTR,
+                                 sizeof(value), &value, &error);
+        test_error(error, "Unable to create argument buffer");
+        if (svm)
+        {
+            svmPool[i] = clSVMAlloc(context, CL_MEM_READ_WRITE, sizeof(value),
+                                    0);
+            if (svmPool[i] == NULL)
+            {
+                log_error("clSVMAlloc failed\n");
+                clSVMFree(context, svmPool[0]);
+                return TEST_FAIL;
+            }
+            error = clEnqueueSVMMemcpy(queue, CL_TRUE, svmPool[i], &value,
+                                       sizeof(value), 0, NULL, NULL);
+            if (error != CL_SUCCESS) break;
+        }
+    }
+
+    int ret = error == CL_SUCCESS ? TEST_PASS : TEST_FAIL;
+    for (cl_uint argCount : kArgCounts)
+    {
+        if (ret != TEST_PASS) break;
+        if ((argCount + 1) * pointerSize > maxParameterSize) break;
+
+        for (int kind = 0; kind < (svm ? 3 : 2) && ret == TEST_PASS; kind++)
+        {
+            bool local = (kind == 1);
+            std::string source = many_args_source(argCount, local);
+            const char *sourcePtr = source.c_str();
+            clProgramWrapper program;
+            clKernelWrapper kernel;
+            if (create_single_kernel_helper(context, &program, &kernel, 1,
+                                            &sourcePtr, "many_args"))
+            {
+                ret = TEST_FAIL;
+                break;
+            }
+            error = clSetKernelArg(kernel, 0, sizeof(out), &out);
+            if (error != CL_SUCCESS)
+            {
+                print_error(error, "Unable to set output argument");
+                ret = TEST_FAIL;
+                break;
+            }
+
+            ArgSetter setArgs;
+            const char *name;
+            if (kind == 0)
+            {
+                name = "buffer_args";
+                setArgs = [&](size_t launch) {
+                    cl_int err = CL_SUCCESS;
+                    for (cl_uint i = 0; i < argCount; i++)
+                    {
+                        cl_mem arg = pool[pool_index(launch, i)];
+                        err |= clSetKernelArg(kernel, i + 1, sizeof(arg), &arg);
+                    }
+                    return err;
+                };
+            }
+            else if (kind == 1)
+            {
+                // Change the size so the local arguments really do change
+                name = "local_args";
+                setArgs = [&](size_t launch) {
+                    cl_int err = CL_SUCCESS;
+                    for (cl_uint i = 0; i < argCount; i++)
+                        err |= clSetKernelArg(
+                            kernel, i + 1,
+                            sizeof(cl_uint) * (1 + pool_index(launch, i)),
+                            NULL);
+                    return err;
+                };
+            }
+            else
+            {
+                name = "svm_args";
+                setArgs = [&](size_t launch) {
+                    cl_int err = CL_SUCCESS;
+                    for (cl_uint i = 0; i < argCount; i++)
+                        err |= clSetKernelArgSVMPointer(
+                            kernel, i + 1, svmPool[pool_index(launch, i)]);
+                    return err;
+                };
+            }
+
+            ExpectedFn expected;
+            if (!local)
+                expected = [&](size_t launch) {
+                    return expected_sum(launch, argCount);
+                };
+            ret = bench_case(queue, kernel, setArgs, out, expected, name,
+                             argCount, argCount * (size_t)pointerSize);
+        }
+    }
+
+    for (void *ptr : svmPool)
+        if (ptr) clSVMFree(context, ptr);
+    return ret;
+}
+
+// One argument of argBytes passed by value, changed on every launch
+int bench_arg_sizes(cl_context context, cl_command_queue queue,
+                    cl_uint pointerSize, size_t maxParameterSize)
+{
+    cl_int error;
+    clMemWrapper out = clCreateBuffer(context, CL_MEM_READ_WRITE,
+                                      sizeof(cl_uint), NULL, &error);
+    test_error(error, "Unable to create output buffer");
+
+    for (size_t argBytes = sizeof(cl_uint);
+         argBytes + pointerSize <= maxParameterSize; argBytes *= 4)
+    {
+        size_t words = argBytes / sizeof(cl_uint);
+        std::string source = "typedef struct { uint v["
+            + std::to_string(words)
+            + "]; } blob_t;\n"
+              "__kernel void by_value(__global uint *out, blob_t b)\n"
+              "{\n"
+              "    out[0] = b.v[0] + b.v["
+            + std::to_string(words - 1) + "];\n}\n";
+        const char *sourcePtr = source.c_str();
+        clProgramWrapper program;
+        clKernelWrapper kernel;
+        if (create_single_kernel_helper(context, &program, &kernel, 1,
+                                        &sourcePtr, "by_value"))
+            return TEST_FAIL;
+        error = clSetKernelArg(kernel, 0, sizeof(out), &out);
+        test_error(error, "Unable to set output argument");
+
+        std::vector<cl_uint> blob(words, 0);
+        ArgSetter setArgs = [&](size_t launch) {
+            blob.front() = (cl_uint)launch;
+            blob.back() = (cl_uint)launch;
+            return clSetKernelArg(kernel, 1, argBytes, blob.data());
+        };
+        int ret = bench_case(
+            queue, kernel, setArgs, out,
+            [](size_t launch) { return 2 * (cl_uint)launch; }, "by_value_arg",
+            1, argBytes);
+        if (ret != TEST_PASS) return ret;
+    }
+    return TEST_PASS;
+}
+
+// kThreadCount threads each set kThreadedArgCount buffer arguments and
+// enqueue, either all through one kernel under a lock or each through its
+// own clCloneKernel copy
+int bench_threads(cl_device_id device, cl_context context,
+                  cl_command_queue queue, cl_uint pointerSize,
+                  size_t maxParameterSize)
+{
+    if ((kThreadedArgCount + 1) * pointerSize > maxParameterSize)
+        return TEST_PASS;
+
+    std::string source = many_args_source(kThreadedArgCount, false);
+    const char *sourcePtr = source.c_str();
+    clProgramWrapper program;
+    clKernelWrapper kernel;
+    if (create_single_kernel_helper(context, &program, &kernel, 1, &sourcePtr,
+                                    "many_args"))
+        return TEST_FAIL;
+
+    cl_int error;
+    clMemWrapper pool[2];
+    clMemWrapper outs[kThreadCount];
+    for (cl_uint i = 0; i < 2; i++)
+    {
+        cl_uint value = i + 1;
+        pool[i] = clCreateBuffer(context, CL_MEM_COPY_HOST_PTR,
+                                 sizeof(value), &value, &error);
+        test_error(error, "Unable to create argument buffer");
+    }
+    for (unsigned t = 0; t < kThreadCount; t++)
+    {
+        outs[t] = clCreateBuffer(context, CL_MEM_READ_WRITE, sizeof(cl_uint),
+                                 NULL, &error);
+        test_error(error, "Unable to create output buffer");
+    }
+
+    bool canClone = get_device_cl_version(device) >= Version(2, 1);
+    size_t launchesPerThread = kLaunchesPerSample / kThreadCount;
+    for (int cloned = 0; cloned < (canClone ? 2 : 1); cloned++)
+    {
+        clKernelWrapper clones[kThreadCount];
+        if (cloned)
+        {
+            for (unsigned t = 0; t < kThreadCount; t++)
+            {
+                clones[t] = clCloneKernel(kernel, &error);
+                test_error(error, "clCloneKernel failed");
+            }
+        }
+
+        const char *name = cloned ? "cloned_kernels" : "shared_kernel";
+        std::mutex kernelLock;
+        BenchmarkStats stats;
+        error = run_benchmark(
+            launch_options(),
+            [&](double *usPerLaunch) {
+                std::vector<cl_int> errors(kThreadCount, CL_SUCCESS);
+                std::vector<std::thread> threads;
+                HostTimer timer;
+                for (unsigned t = 0; t < kThreadCount; t++)
+                {
+                    threads.emplace_back([&, t]() {
+                        cl_kernel k =
+                            cloned ? (cl_kernel)clones[t] : (cl_kernel)kernel;
+                        size_t global = 1;
+                        for (size_t launch = 0; launch < launchesPerThread;
+                             launch++)
+                        {
+                            std::unique_lock<std::mutex> lock(
+                                kernelLock, std::defer_lock);
+                            if (!cloned) lock.lock();
+                            cl_int err = clSetKernelArg(k, 0, sizeof(outs[t]),
+                                                        &outs[t]);
+                            for (cl_uint i = 0; i < kThreadedArgCount; i++)
+                            {
+                                cl_mem arg = pool[pool_index(launch, i)];
+                                err |= clSetKernelArg(k, i + 1, sizeof(arg),
+                                                      &arg);
+                            }
+                            err |= clEnqueueNDRangeKernel(queue, k, 1, NULL,
+                                                          &global, NULL, 0,
+                                                          NULL, NULL);
+                            if (err != CL_SUCCESS)
+                            {
+                                errors[t] = err;
+                                return;
+                            }
+                        }
+                    });
+                }
+                for (std::thread &thread : threads) thread.join();
+                cl_int err = clFinish(queue);
+                test_error(err, "clFinish failed");
+                *usPerLaunch =
+                    timer.elapsed_us() / (launchesPerThread * kThreadCount);
+
+                for (unsigned t = 0; t < kThreadCount; t++)
+                {
+                    if (errors[t] != CL_SUCCESS)
+                    {
+                        log_error("%s: thread %u failed with %d\n", name, t,
+                                  errors[t]);
+                        return errors[t];
+                    }
+                }
+                return CL_SUCCESS;
+            },
+            &stats);
+        if (error != CL_SUCCESS) return TEST_FAIL;
+
+        for (unsigned t = 0; t < kThreadCount; t++)
+        {
+            if (check_out(queue, outs[t],
+                          expected_sum(launchesPerThread - 1,
+                                       kThreadedArgCount),
+                          name)
+                != TEST_PASS)
+                return TEST_FAIL;
+        }
+
+        log_benchmark_stats("kernel_arg",
+                            case_label(name, kThreadedArgCount,
+                                       kThreadedArgCount * (size_t)pointerSize,
+                                       kThreadCount)
+                                .c_str(),
+                            "us", false, stats);
+    }
+    if (!canClone)
+        log_info("clCloneKernel needs OpenCL 2.1, skipping cloned_kernels\n");
+    return TEST_PASS;
+}
+
+} // anonymous namespace
+
+int test_kernel_arg_bench(cl_device_id device, cl_context context,
+                          cl_command_queue queue, int num_elements)
+{
+    cl_uint addressBits;
+    size_t maxParameterSize;
+    cl_int error = clGetDeviceInfo(device, CL_DEVICE_ADDRESS_BITS,
+                                   sizeof(addressBits), &addressBits, NULL);
+    test_error(error, "Unable to get CL_DEVICE_ADDRESS_BITS");
+    error = clGetDeviceInfo(device, CL_DEVICE_MAX_PARAMETER_SIZE,
+                            sizeof(maxParameterSize), &maxParameterSize, NULL);
+    test_error(error, "Unable to get CL_DEVICE_MAX_PARAMETER_SIZE");
+    cl_uint pointerSize = addressBits / 8;
+
+    cl_device_svm_capabilities svmCaps = 0;
+    if (get_device_cl_version(device) >= Version(2, 0))
+    {
+        error = clGetDeviceInfo(device, CL_DEVICE_SVM_CAPABILITIES,
+                                sizeof(svmCaps), &svmCaps, NULL);
+        test_error(error, "Unable to get CL_DEVICE_SVM_CAPABILITIES");
+    }
+    bool svm = (svmCaps & CL_DEVICE_SVM_COARSE_GRAIN_BUFFER) != 0;
+
+    log_benchmark_header("kernel_arg", "case/args/arg_bytes/threads");
+    int ret = bench_arg_counts(context, queue, pointerSize, maxParameterSize,
+                               svm);
+    if (ret != TEST_PASS) return ret;
+    if (!svm) log_info("Device has no SVM support, skipping svm_args\n");
+
+    ret = bench_arg_sizes(context, queue, pointerSize, maxParameterSize);
+    if (ret != TEST_PASS) return ret;
+
+    return bench_threads(device, context, queue, pointerSize,
+                         maxParameterSize);
+}
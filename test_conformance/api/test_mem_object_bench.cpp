@@ -0,0 +1,359 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "testBase.h"
+#include "harness/alloc.h"
+#include "harness/typeWrappers.h"
+#include "harness/benchmark.h"
+
+#include <inttypes.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+
+// Measures where memory objects get their storage. For buffers and 2D images
+// of growing size, created with each set of CL_MEM_* host pointer and access
+// flags, it times the creation call, a first kernel that writes one word per
+// page or one pixel per tile, the same kernel a second time and the release.
+// A first use much slower than the second means the driver allocated or moved
+// the storage lazily, on first touch. Each sample is a new object, used once.
+// A benchmark, so it only runs when named.
+
+namespace {
+
+// Words between the ones the buffer kernel writes, a 4 KB page
+const cl_uint kBufferStride = 1024;
+// Pixels between the ones the image kernel writes, in each direction
+const cl_uint kImageStride = 64;
+
+const size_t kBufferSizes[] = { 64 << 10, 1 << 20, 16 << 20, 256 << 20 };
+const size_t kImageSizes[] = { 256, 1024, 4096 };
+
+const char *touch_kernel_source =
+    "__kernel void touch(__global uint *out, uint stride, uint value)\n"
+    "{\n"
+    "    uint i = get_global_id(0);\n"
+    "    out[i * stride] = value + i;\n"
+    "}\n";
+
+const char *touch_image_kernel_source =
+    "__kernel void touch_image(write_only image2d_t out, uint stride,\n"
+    "                          uint value)\n"
+    "{\n"
+    "    int2 coord = (int2)(get_global_id(0) * stride,\n"
+    "                        get_global_id(1) * stride);\n"
+    "    write_imageui(out, coord, (uint4)(value & 0xff));\n"
+    "}\n";
+
+struct FlagsCase
+{
+    const char *name;
+    cl_mem_flags flags;
+    bool images;
+    Version minVersion;
+};
+
+const FlagsCase kFlagsCases[] = {
+    { "device", 0, true, Version(1, 0) },
+    { "alloc_host_ptr", CL_MEM_ALLOC_HOST_PTR, true, Version(1, 0) },
+    { "copy_host_ptr", CL_MEM_COPY_HOST_PTR, true, Version(1, 0) },
+    { "use_host_ptr", CL_MEM_USE_HOST_PTR, true, Version(1, 0) },
+    { "alloc_copy_host_ptr", CL_MEM_ALLOC_HOST_PTR | CL_MEM_COPY_HOST_PTR,
+      true, Version(1, 0) },
+    // Checked through a copy, as the host may not read the buffer itself
+    { "host_no_access", CL_MEM_HOST_NO_ACCESS, false, Version(1, 2) },
+};
+
+struct MemTimings
+{
+    double create, first, second, release;
+};
+
+// Sample number -> the timings of a new object
+typedef std::function<int(cl_uint, MemTimings *)> MemSampleFn;
+
+const struct
+{
+    const char *name;
+    double MemTimings::*us;
+} kPhases[] = {
+    { "create", &MemTimings::create },
+    { "first_use", &MemTimings::first },
+    { "second_use", &MemTimings::second },
+    { "release", &MemTimings::release },
+};
+
+// Takes samples of each phase of the life of an object in turn, and prints
+// their BENCH rows
+int report_phases(const char *kind, const char *flags, size_t size,
+                  const MemSampleFn &sample)
+{
+    BenchmarkOptions options;
+    options.warmup = 1;
+    options.minSamples = 5;
+    options.maxSeconds = 1.0;
+
+    cl_uint next = 0;
+    for (const auto &phase : kPhases)
+    {
+        BenchmarkStats stats;
+        cl_int error = run_benchmark(
+            options,
+            [&](double *us) {
+                MemTimings timings;
+                int ret = sample(next++, &timings);
+                *us = timings.*phase.us;
+                return ret;
+            },
+            &stats);
+        if (error != CL_SUCCESS) return TEST_FAIL;
+        std::string label = std::string(kind) + "/" + flags + "/"
+            + std::to_string(size) + "/" + phase.name;
+        log_benchmark_stats("mem_object", label.c_str(), "us", false, stats);
+    }
+    return TEST_PASS;
+}
+
+// Runs kernel over global and waits for it, in us
+int time_touch(cl_command_queue queue, cl_kernel kernel, cl_uint dims,
+               const size_t *global, cl_uint value, double *outUs)
+{
+    cl_int error = clSetKernelArg(kernel, 2, sizeof(value), &value);
+    test_error(error, "Unable to set kernel argument");
+    HostTimer timer;
+    error = clEnqueueNDRangeKernel(queue, kernel, dims, NULL, global, NULL, 0,
+                                   NULL, NULL);
+    test_error(error, "Unable to enqueue touch kernel");
+    error = clFinish(queue);
+    test_error(error, "clFinish failed");
+    *outUs = timer.elapsed_us();
+    return TEST_PASS;
+}
+
+// Copies the first and last words the kernel wrote into check and reads them
+int check_buffer(cl_command_queue queue, cl_mem buffer, cl_mem check,
+                 size_t words, cl_uint value, const char *name)
+{
+    size_t last = (words - 1) * kBufferStride * sizeof(cl_uint);
+    cl_int error = clEnqueueCopyBuffer(queue, buffer, check, 0, 0,
+                                       sizeof(cl_uint), 0, NULL, NULL);
+    error |= clEnqueueCopyBuffer(queue, buffer, check, last, sizeof(cl_uint),
+                                 sizeof(cl_uint), 0, NULL, NULL);
+    test_error(error, "Unable to copy buffer");
+    cl_uint results[2];
+    error = clEnqueueReadBuffer(queue, check, CL_TRUE, 0, sizeof(results),
+                                results, 0, NULL, NULL);
+    test_error(error, "Unable to read check buffer");
+    cl_uint expected[2] = { value, value + (cl_uint)words - 1 };
+    for (int i = 0; i < 2; i++)
+    {
+        if (results[i] != expected[i])
+        {
+            log_error("%s buffer holds %u, expected %u\n", name, results[i],
+                      expected[i]);
+            return TEST_FAIL;
+        }
+    }
+    return TEST_PASS;
+}
+
+int time_buffers(cl_context context, cl_command_queue queue, cl_kernel kernel,
+                 const FlagsCase &flagsCase, size_t size, void *host)
+{
+    cl_int error;
+    clMemWrapper check = clCreateBuffer(context, CL_MEM_READ_WRITE,
+                                        2 * sizeof(cl_uint), NULL, &error);
+    test_error(error, "Unable to create check buffer");
+
+    size_t words = size / (kBufferStride * sizeof(cl_uint));
+    cl_uint stride = kBufferStride;
+    error = clSetKernelArg(kernel, 1, sizeof(stride), &stride);
+    test_error(error, "Unable to set kernel argument");
+
+    bool hostPtr =
+        (flagsCase.flags & (CL_MEM_COPY_HOST_PTR | CL_MEM_USE_HOST_PTR)) != 0;
+    return report_phases(
+        "buffer", flagsCase.name, size,
+        [&](cl_uint i, MemTimings *timings) -> int {
+            cl_int error;
+            HostTimer timer;
+            clMemWrapper buffer =
+                clCreateBuffer(context, CL_MEM_READ_WRITE | flagsCase.flags,
+                               size, hostPtr ? host : NULL, &error);
+            timings->create = timer.elapsed_us();
+            test_error(error, "Unable to create buffer");
+
+            error = clSetKernelArg(kernel, 0, sizeof(cl_mem), &buffer);
+            test_error(error, "Unable to set kernel argument");
+            cl_uint value = i << 24;
+            int ret = time_touch(queue, kernel, 1, &words, value,
+                                 &timings->first);
+            if (ret != TEST_PASS) return ret;
+            ret = time_touch(queue, kernel, 1, &words, value + 1,
+                             &timings->second);
+            if (ret != TEST_PASS) return ret;
+            ret = check_buffer(queue, buffer, check, words, value + 1,
+                               flagsCase.name);
+            if (ret != TEST_PASS) return ret;
+
+            timer.restart();
+            buffer.reset();
+            timings->release = timer.elapsed_us();
+            return TEST_PASS;
+        });
+}
+
+int time_images(cl_context context, cl_command_queue queue, cl_kernel kernel,
+                const FlagsCase &flagsCase, size_t size, void *host)
+{
+    cl_image_format format = { CL_RGBA, CL_UNSIGNED_INT8 };
+    size_t tiles = size / kImageStride;
+    size_t global[2] = { tiles, tiles };
+    cl_uint stride = kImageStride;
+    cl_int error = clSetKernelArg(kernel, 1, sizeof(stride), &stride);
+    test_error(error, "Unable to set kernel argument");
+
+    return report_phases(
+        "image2d", flagsCase.name, size,
+        [&](cl_uint i, MemTimings *timings) -> int {
+            cl_int error;
+            HostTimer timer;
+            clMemWrapper image =
+                create_image_2d(context, CL_MEM_READ_WRITE | flagsCase.flags,
+                                &format, size, size, 0, host, &error);
+            timings->create = timer.elapsed_us();
+            test_error(error, "Unable to create image");
+
+            error = clSetKernelArg(kernel, 0, sizeof(cl_mem), &image);
+            test_error(error, "Unable to set kernel argument");
+            cl_uint value = 2 * i;
+            int ret = time_touch(queue, kernel, 2, global, value,
+                                 &timings->first);
+            if (ret != TEST_PASS) return ret;
+            ret = time_touch(queue, kernel, 2, global, value + 1,
+                             &timings->second);
+            if (ret != TEST_PASS) return ret;
+
+            // The last tile's pixel is what the second kernel left there
+            cl_uchar pixel[4];
+            size_t origin[3] = { (tiles - 1) * kImageStride,
+                                 (tiles - 1) * kImageStride, 0 };
+            size_t region[3] = { 1, 1, 1 };
+            error = clEnqueueReadImage(queue, image, CL_TRUE, origin, region,
+                                       0, 0, pixel, 0, NULL, NULL);
+            test_error(error, "Unable to read image");
+            cl_uchar expected = (cl_uchar)(value + 1);
+            if (pixel[0] != expected || pixel[3] != expected)
+            {
+                log_error("%s image pixel holds %u, expected %u\n",
+                          flagsCase.name, pixel[0], expected);
+                return TEST_FAIL;
+            }
+
+            timer.restart();
+            image.reset();
+            timings->release = timer.elapsed_us();
+            return TEST_PASS;
+        });
+}
+
+} // anonymous namespace
+
+int test_mem_object_creation_bench(cl_device_id device, cl_context context,
+                                   cl_command_queue queue, int num_elements)
+{
+    cl_ulong maxAlloc;
+    cl_int error = clGetDeviceInfo(device, CL_DEVICE_MAX_MEM_ALLOC_SIZE,
+                                   sizeof(maxAlloc), &maxAlloc, NULL);
+    test_error(error, "Unable to get CL_DEVICE_MAX_MEM_ALLOC_SIZE");
+    Version version = get_device_cl_version(device);
+
+    clProgramWrapper program;
+    clKernelWrapper kernel;
+    error = create_single_kernel_helper(context, &program, &kernel, 1,
+                                        &touch_kernel_source, "touch");
+    test_error(error, "Unable to create touch kernel");
+
+    log_benchmark_header("mem_object", "object/flags/size/phase");
+    for (size_t size : kBufferSizes)
+    {
+        if (size > maxAlloc / 2)
+        {
+            log_info("Skipping %zu byte buffers, the device allocates at "
+                     "most %" PRIu64 " bytes\n",
+                     size, (uint64_t)maxAlloc);
+            continue;
+        }
+        std::unique_ptr<void, void (*)(void *)> host(align_malloc(size, 4096),
+                                                     align_free);
+        if (!host) test_fail("Unable to allocate %zu bytes\n", size);
+        memset(host.get(), 0, size);
+
+        for (const FlagsCase &flagsCase : kFlagsCases)
+        {
+            if (version < flagsCase.minVersion) continue;
+            int ret = time_buffers(context, queue, kernel, flagsCase, size,
+                                   host.get());
+            if (ret != TEST_PASS) return ret;
+        }
+    }
+
+    if (checkForImageSupport(device))
+    {
+        log_info("Images are not supported, skipping image creation\n");
+        return TEST_PASS;
+    }
+
+    size_t maxWidth, maxHeight;
+    error = clGetDeviceInfo(device, CL_DEVICE_IMAGE2D_MAX_WIDTH,
+                            sizeof(maxWidth), &maxWidth, NULL);
+    error |= clGetDeviceInfo(device, CL_DEVICE_IMAGE2D_MAX_HEIGHT,
+                             sizeof(maxHeight), &maxHeight, NULL);
+    test_error(error, "Unable to get the maximum 2D image size");
+
+    clProgramWrapper imageProgram;
+    clKernelWrapper imageKernel;
+    error = create_single_kernel_helper(context, &imageProgram, &imageKernel,
+                                        1, &touch_image_kernel_source,
+                                        "touch_image");
+    test_error(error, "Unable to create touch_image kernel");
+
+    for (size_t size : kImageSizes)
+    {
+        size_t bytes = size * size * 4;
+        if (size > maxWidth || size > maxHeight || bytes > maxAlloc / 2)
+        {
+            log_info("Skipping %zux%zu images, larger than the device "
+                     "allows\n",
+                     size, size);
+            continue;
+        }
+        std::unique_ptr<void, void (*)(void *)> host(align_malloc(bytes, 4096),
+                                                     align_free);
+        if (!host) test_fail("Unable to allocate %zu bytes\n", bytes);
+        memset(host.get(), 0, bytes);
+
+        for (const FlagsCase &flagsCase : kFlagsCases)
+        {
+            if (!flagsCase.images || version < flagsCase.minVersion) continue;
+            int ret = time_images(context, queue, imageKernel, flagsCase, size,
+                                  host.get());
+            if (ret != TEST_PASS) return ret;
+        }
+    }
+
+    return TEST_PASS;
+}
@@ -0,0 +1,312 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "testBase.h"
+#include "harness/typeWrappers.h"
+#include "harness/benchmark.h"
+#include "harness/perfMetrics.h"
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <vector>
+
+// Measures the cost of running host tasks in a queue: clEnqueueNativeKernel
+// with and without memory objects to translate, the same task inserted with
+// a marker callback that completes a user event the rest of the queue waits
+// on, and how far a native kernel overlaps a device kernel on an
+// out-of-order queue. A benchmark, so it only runs when named.
+
+namespace {
+
+const cl_uint kTasks = 1000;
+const cl_uint kMemObjectCounts[] = { 0, 1, 4, 16 };
+const cl_uint kMaxMemObjects = 16;
+const double kSpinMs = 20.0;
+
+// The runtime copies this and replaces each of mems[0, memCount) with a
+// pointer to the memory object's storage
+struct NativeTaskArgs
+{
+    std::atomic<cl_uint> *counter;
+    cl_uint memCount;
+    void *mems[kMaxMemObjects];
+};
+
+void CL_CALLBACK native_task(void *userData)
+{
+    NativeTaskArgs *args = (NativeTaskArgs *)userData;
+    args->counter->fetch_add(1);
+    for (cl_uint i = 0; i < args->memCount; i++)
+        ((cl_uint *)args->mems[i])[0]++;
+}
+
+void CL_CALLBACK native_spin(void *userData)
+{
+    HostTimer timer;
+    while (timer.elapsed_us() < kSpinMs * 1000)
+        ;
+}
+
+struct CallbackTask
+{
+    std::atomic<cl_uint> *counter;
+    cl_event user;
+};
+
+void CL_CALLBACK callback_task(cl_event, cl_int, void *userData)
+{
+    CallbackTask *task = (CallbackTask *)userData;
+    task->counter->fetch_add(1);
+    clSetUserEventStatus(task->user, CL_COMPLETE);
+}
+
+// kTasks native kernels translating memCount buffers each; gives us per
+// task and checks every task ran and saw every buffer
+int time_native_tasks(cl_context context, cl_command_queue queue,
+                      cl_uint memCount, double *outUsPerTask)
+{
+    cl_int error;
+    std::vector<clMemWrapper> buffers(memCount);
+    std::vector<cl_mem> memList(memCount);
+    const cl_uint zero = 0;
+    for (cl_uint i = 0; i < memCount; i++)
+    {
+        buffers[i] = clCreateBuffer(context, CL_MEM_COPY_HOST_PTR,
+                                    sizeof(zero), (void *)&zero, &error);
+        test_error(error, "Unable to create buffer");
+        memList[i] = buffers[i];
+    }
+
+    std::atomic<cl_uint> counter(0);
+    NativeTaskArgs args = {};
+    args.counter = &counter;
+    args.memCount = memCount;
+    std::vector<const void *> memLocs(memCount);
+    for (cl_uint i = 0; i < memCount; i++)
+    {
+        args.mems[i] = memList[i];
+        memLocs[i] = &args.mems[i];
+    }
+
+    HostTimer timer;
+    for (cl_uint t = 0; t < kTasks; t++)
+    {
+        error = clEnqueueNativeKernel(
+            queue, native_task, &args, sizeof(args), memCount,
+            memCount ? memList.data() : NULL,
+            memCount ? memLocs.data() : NULL, 0, NULL, NULL);
+        test_error(error, "Unable to enqueue native kernel");
+    }
+    error = clFinish(queue);
+    test_error(error, "clFinish failed");
+    *outUsPerTask = timer.elapsed_us() / kTasks;
+
+    if (counter.load() != kTasks)
+    {
+        log_error("%u of %u native kernels ran\n", counter.load(), kTasks);
+        return TEST_FAIL;
+    }
+    for (cl_uint i = 0; i < memCount; i++)
+    {
+        cl_uint value;
+        error = clEnqueueReadBuffer(queue, buffers[i], CL_TRUE, 0,
+                                    sizeof(value), &value, 0, NULL, NULL);
+        test_error(error, "Unable to read buffer");
+        if (value != kTasks)
+        {
+            log_error("Buffer %u was seen by %u of %u native kernels\n", i,
+                      value, kTasks);
+            return TEST_FAIL;
+        }
+    }
+    return TEST_PASS;
+}
+
+// kTasks host tasks inserted as a marker whose completion callback runs the
+// task and completes a user event, followed by a barrier on that event
+int time_callback_tasks(cl_context context, cl_command_queue queue,
+                        double *outUsPerTask)
+{
+    cl_int error;
+    std::atomic<cl_uint> counter(0);
+    std::vector<CallbackTask> tasks(kTasks);
+    std::vector<clEventWrapper> userEvents(kTasks), markers(kTasks);
+
+    HostTimer timer;
+    for (cl_uint t = 0; t < kTasks; t++)
+    {
+        userEvents[t] = clCreateUserEvent(context, &error);
+        test_error(error, "Unable to create user event");
+        tasks[t].counter = &counter;
+        tasks[t].user = userEvents[t];
+
+        error = clEnqueueMarkerWithWaitList(queue, 0, NULL, &markers[t]);
+        test_error(error, "Unable to enqueue marker");
+        error = clSetEventCallback(markers[t], CL_COMPLETE, callback_task,
+                                   &tasks[t]);
+        test_error(error, "Unable to set event callback");
+        error = clEnqueueBarrierWithWaitList(queue, 1, &userEvents[t], NULL);
+        test_error(error, "Unable to enqueue barrier");
+    }
+    error = clFinish(queue);
+    test_error(error, "clFinish failed");
+    *outUsPerTask = timer.elapsed_us() / kTasks;
+
+    // Each callback counts its task before completing the user event the
+    // queue waits on, so all of them have been counted by now
+    if (counter.load() != kTasks)
+    {
+        log_error("%u of %u callback tasks ran\n", counter.load(), kTasks);
+        return TEST_FAIL;
+    }
+    return TEST_PASS;
+}
+
+const char *kOverlapModes[] = { "kernel", "native", "both" };
+
+// Wall time in us of the device kernel alone, mode 0, the spinning native
+// kernel alone, mode 1, or both together, mode 2
+int time_overlap(cl_command_queue queue, cl_kernel kernel, size_t global,
+                 int mode, double *outUs)
+{
+    HostTimer timer;
+    cl_int error = CL_SUCCESS;
+    if (mode != 1)
+        error = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &global, NULL,
+                                       0, NULL, NULL);
+    test_error(error, "Unable to enqueue kernel");
+    if (mode != 0)
+    {
+        char unused = 0;
+        error = clEnqueueNativeKernel(queue, native_spin, &unused,
+                                      sizeof(unused), 0, NULL, NULL, 0, NULL,
+                                      NULL);
+        test_error(error, "Unable to enqueue native kernel");
+    }
+    error = clFinish(queue);
+    test_error(error, "clFinish failed");
+    *outUs = timer.elapsed_us();
+    return TEST_PASS;
+}
+
+const char *spin_kernel_source =
+    "__kernel void spin(__global uint *out, uint iterations)\n"
+    "{\n"
+    "    uint x = get_global_id(0);\n"
+    "    for (uint i = 0; i < iterations; i++)\n"
+    "        x = x * 1664525u + 1013904223u;\n"
+    "    out[get_global_id(0)] = x;\n"
+    "}\n";
+
+} // anonymous namespace
+
+int test_native_kernel_bench(cl_device_id device, cl_context context,
+                             cl_command_queue queue, int num_elements)
+{
+    cl_device_exec_capabilities capabilities;
+    cl_int error =
+        clGetDeviceInfo(device, CL_DEVICE_EXECUTION_CAPABILITIES,
+                        sizeof(capabilities), &capabilities, NULL);
+    test_error(error, "Unable to get CL_DEVICE_EXECUTION_CAPABILITIES");
+    if (!(capabilities & CL_EXEC_NATIVE_KERNEL))
+    {
+        log_info("Device does not support CL_EXEC_NATIVE_KERNEL.\n");
+        return TEST_SKIPPED_ITSELF;
+    }
+
+    BenchmarkOptions options;
+    options.warmup = 1;
+    options.maxSeconds = 1.0;
+
+    log_benchmark_header("native_kernel", "case/mem_objects");
+    BenchmarkStats stats;
+    for (cl_uint memCount : kMemObjectCounts)
+    {
+        error = run_benchmark(
+            options,
+            [&](double *us) {
+                return time_native_tasks(context, queue, memCount, us);
+            },
+            &stats);
+        if (error != CL_SUCCESS) return TEST_FAIL;
+        std::string label = "native_kernel/" + std::to_string(memCount);
+        log_benchmark_stats("native_kernel", label.c_str(), "us", false,
+                            stats);
+    }
+
+    error = run_benchmark(
+        options,
+        [&](double *us) { return time_callback_tasks(context, queue, us); },
+        &stats);
+    if (error != CL_SUCCESS) return TEST_FAIL;
+    log_benchmark_stats("native_kernel", "user_event_callback/0", "us", false,
+                        stats);
+
+    cl_command_queue_properties queueProperties;
+    error = clGetDeviceInfo(device, CL_DEVICE_QUEUE_PROPERTIES,
+                            sizeof(queueProperties), &queueProperties, NULL);
+    test_error(error, "Unable to get CL_DEVICE_QUEUE_PROPERTIES");
+    if (!(queueProperties & CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE))
+    {
+        log_info("Device has no out-of-order queues, skipping the overlap "
+                 "measurement\n");
+        return TEST_PASS;
+    }
+
+    clCommandQueueWrapper oooQueue = clCreateCommandQueue(
+        context, device, CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE, &error);
+    test_error(error, "Unable to create out-of-order queue");
+
+    clProgramWrapper program;
+    clKernelWrapper kernel;
+    error = create_single_kernel_helper(context, &program, &kernel, 1,
+                                        &spin_kernel_source, "spin");
+    test_error(error, "Unable to create spin kernel");
+
+    size_t global = 4096;
+    cl_uint iterations = 1 << 16;
+    clMemWrapper out = clCreateBuffer(context, CL_MEM_WRITE_ONLY,
+                                      global * sizeof(cl_uint), NULL, &error);
+    test_error(error, "Unable to create output buffer");
+    error = clSetKernelArg(kernel, 0, sizeof(out), &out);
+    error |= clSetKernelArg(kernel, 1, sizeof(iterations), &iterations);
+    test_error(error, "Unable to set spin kernel arguments");
+
+    log_benchmark_header("native_kernel_overlap", "run");
+    double medianUs[ARRAY_SIZE(kOverlapModes)];
+    for (int mode = 0; mode < (int)ARRAY_SIZE(kOverlapModes); mode++)
+    {
+        error = run_benchmark(
+            options,
+            [&](double *us) {
+                return time_overlap(oooQueue, kernel, global, mode, us);
+            },
+            &stats);
+        if (error != CL_SUCCESS) return TEST_FAIL;
+        log_benchmark_stats("native_kernel_overlap", kOverlapModes[mode], "us",
+                            false, stats);
+        medianUs[mode] = stats.median;
+    }
+
+    // 1 when the shorter of the two is hidden entirely behind the other,
+    // 0 when they ran one after the other
+    double overlap = (medianUs[0] + medianUs[1] - medianUs[2])
+        / std::min(medianUs[0], medianUs[1]);
+    log_info("Native kernel overlap with a device kernel: %.2f\n", overlap);
+    record_perf_metric("native_kernel_overlap", overlap, "ratio", true);
+
+    return TEST_PASS;
+}
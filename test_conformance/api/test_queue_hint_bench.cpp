@@ -0,0 +1,319 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "testBase.h"
+#include "harness/typeWrappers.h"
+#include "harness/benchmark.h"
+#include "harness/perfMetrics.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// Measures whether cl_khr_priority_hints and cl_khr_throttle_hints change
+// anything when an interactive workload shares the device with a batch one.
+// A batch queue keeps the device busy with long kernels while an interactive
+// queue enqueues short kernels one at a time and waits for each. For each
+// pair of hints the interactive latency distribution is compared with the
+// same queue running alone, and the batch throughput with the batch queue
+// running alone. A pair of queues without hints gives the baseline. The
+// contended samples are those that fit in the time the batch takes. A
+// benchmark, so it only runs when named.
+
+namespace {
+
+const size_t kInteractiveItems = 256;
+const cl_uint kInteractiveIterations = 64;
+// Upper bound on the samples taken while the batch queue runs
+const size_t kMaxContendedSamples = 100000;
+const size_t kBatchItemsPerComputeUnit = 4096;
+const cl_uint kBatchKernels = 100;
+const double kBatchKernelMs = 5.0;
+const cl_uint kMaxBatchIterations = 1 << 24;
+const size_t kCheckedItems = 64;
+
+const char *hint_bench_kernel_source =
+    "__kernel void spin(__global uint *out, uint iterations)\n"
+    "{\n"
+    "    uint x = get_global_id(0);\n"
+    "    for (uint i = 0; i < iterations; i++)\n"
+    "        x = x * 1664525u + 1013904223u;\n"
+    "    out[get_global_id(0)] = x;\n"
+    "}\n";
+
+struct HintConfig
+{
+    const char *name;
+    const char *extension;
+    // Properties of the interactive and batch queues, NULL for none
+    const cl_queue_properties *interactive;
+    const cl_queue_properties *batch;
+};
+
+const cl_queue_properties kPriorityHigh[] = { CL_QUEUE_PRIORITY_KHR,
+                                              CL_QUEUE_PRIORITY_HIGH_KHR, 0 };
+const cl_queue_properties kPriorityLow[] = { CL_QUEUE_PRIORITY_KHR,
+                                             CL_QUEUE_PRIORITY_LOW_KHR, 0 };
+const cl_queue_properties kThrottleHigh[] = { CL_QUEUE_THROTTLE_KHR,
+                                              CL_QUEUE_THROTTLE_HIGH_KHR, 0 };
+const cl_queue_properties kThrottleLow[] = { CL_QUEUE_THROTTLE_KHR,
+                                             CL_QUEUE_THROTTLE_LOW_KHR, 0 };
+
+const HintConfig kHintConfigs[] = {
+    { "none", NULL, NULL, NULL },
+    { "priority", "cl_khr_priority_hints", kPriorityHigh, kPriorityLow },
+    { "throttle", "cl_khr_throttle_hints", kThrottleHigh, kThrottleLow },
+};
+
+struct SpinWork
+{
+    cl_command_queue queue;
+    cl_kernel kernel;
+    cl_mem out;
+    size_t global;
+    cl_uint iterations;
+
+    cl_int SetArgs()
+    {
+        cl_int error = clSetKernelArg(kernel, 0, sizeof(out), &out);
+        error |= clSetKernelArg(kernel, 1, sizeof(iterations), &iterations);
+        return error;
+    }
+
+    cl_int Enqueue(cl_event *event)
+    {
+        return clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &global, NULL,
+                                      0, NULL, event);
+    }
+
+    // Checks the first kCheckedItems outputs of the last launch
+    int Check(const char *name)
+    {
+        std::vector<cl_uint> results(std::min(global, kCheckedItems));
+        cl_int error = clEnqueueReadBuffer(
+            queue, out, CL_TRUE, 0, results.size() * sizeof(cl_uint),
+            results.data(), 0, NULL, NULL);
+        test_error(error, "Unable to read results");
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            cl_uint x = (cl_uint)i;
+            for (cl_uint n = 0; n < iterations; n++)
+                x = x * 1664525u + 1013904223u;
+            if (results[i] != x)
+            {
+                log_error("%s work-item %zu wrote 0x%x, expected 0x%x\n", name,
+                          i, results[i], x);
+                return TEST_FAIL;
+            }
+        }
+        return TEST_PASS;
+    }
+};
+
+// One interactive launch, enqueued and waited on, in us
+int time_interactive_launch(SpinWork &work, double *outUs)
+{
+    HostTimer timer;
+    cl_int error = work.Enqueue(NULL);
+    test_error(error, "Unable to enqueue interactive kernel");
+    error = clFinish(work.queue);
+    test_error(error, "clFinish failed");
+    *outUs = timer.elapsed_us();
+    return TEST_PASS;
+}
+
+int time_interactive_alone(SpinWork &work, BenchmarkStats *stats)
+{
+    BenchmarkOptions options;
+    options.maxSeconds = 1.0;
+    cl_int error = run_benchmark(
+        options,
+        [&](double *us) { return time_interactive_launch(work, us); }, stats);
+    if (error != CL_SUCCESS) return TEST_FAIL;
+    return work.Check("interactive");
+}
+
+// Enqueues the batch and, unless interactive is NULL, keeps taking
+// interactive samples until the batch finishes. Gives batch kernels per
+// second.
+int run_batch(SpinWork &batch, SpinWork *interactive,
+              std::vector<double> &samples, double *outKernelsPerSecond)
+{
+    samples.clear();
+    HostTimer timer;
+    clEventWrapper last;
+    for (cl_uint k = 0; k < kBatchKernels; k++)
+    {
+        cl_int error = batch.Enqueue(k + 1 == kBatchKernels ? &last : NULL);
+        test_error(error, "Unable to enqueue batch kernel");
+    }
+    cl_int error = clFlush(batch.queue);
+    test_error(error, "clFlush failed");
+
+    while (interactive && samples.size() < kMaxContendedSamples)
+    {
+        cl_int status;
+        error = clGetEventInfo(last, CL_EVENT_COMMAND_EXECUTION_STATUS,
+                               sizeof(status), &status, NULL);
+        test_error(error, "clGetEventInfo failed");
+        if (status < 0)
+        {
+            log_error("Batch kernel failed with status %d\n", status);
+            return TEST_FAIL;
+        }
+        if (status == CL_COMPLETE) break;
+
+        double us;
+        int ret = time_interactive_launch(*interactive, &us);
+        if (ret != TEST_PASS) return ret;
+        samples.push_back(us);
+    }
+
+    error = clFinish(batch.queue);
+    test_error(error, "clFinish failed");
+    *outKernelsPerSecond = kBatchKernels * 1e6 / timer.elapsed_us();
+
+    int ret = batch.Check("batch");
+    if (ret == TEST_PASS && interactive)
+        ret = interactive->Check("interactive");
+    return ret;
+}
+
+// Doubles the batch iterations until one batch kernel takes kBatchKernelMs
+// or kMaxBatchIterations is reached
+int calibrate_batch(SpinWork &batch)
+{
+    for (batch.iterations = 1024;; batch.iterations *= 2)
+    {
+        cl_int error = batch.SetArgs();
+        test_error(error, "Unable to set batch kernel arguments");
+        if (batch.iterations >= kMaxBatchIterations) break;
+
+        HostTimer timer;
+        error = batch.Enqueue(NULL);
+        test_error(error, "Unable to enqueue batch kernel");
+        error = clFinish(batch.queue);
+        test_error(error, "clFinish failed");
+        if (timer.elapsed_us() >= kBatchKernelMs * 1000)
+            break;
+    }
+    return TEST_PASS;
+}
+
+} // anonymous namespace
+
+int test_queue_hint_bench(cl_device_id device, cl_context context,
+                          cl_command_queue queue, int num_elements)
+{
+    if (!is_extension_available(device, "cl_khr_priority_hints")
+        && !is_extension_available(device, "cl_khr_throttle_hints"))
+    {
+        log_info("Neither cl_khr_priority_hints nor cl_khr_throttle_hints is "
+                 "supported.\n");
+        return TEST_SKIPPED_ITSELF;
+    }
+
+    cl_uint computeUnits;
+    cl_int error =
+        clGetDeviceInfo(device, CL_DEVICE_MAX_COMPUTE_UNITS,
+                        sizeof(computeUnits), &computeUnits, NULL);
+    test_error(error, "Unable to get CL_DEVICE_MAX_COMPUTE_UNITS");
+
+    // The queues run concurrently, so each gets its own kernel and buffer
+    clProgramWrapper program;
+    clKernelWrapper interactiveKernel, batchKernel;
+    error = create_single_kernel_helper(context, &program, &interactiveKernel,
+                                        1, &hint_bench_kernel_source, "spin");
+    test_error(error, "Unable to create spin kernel");
+    batchKernel = clCreateKernel(program, "spin", &error);
+    test_error(error, "Unable to create spin kernel");
+
+    size_t batchItems = computeUnits * kBatchItemsPerComputeUnit;
+    clMemWrapper interactiveOut =
+        clCreateBuffer(context, CL_MEM_WRITE_ONLY,
+                       kInteractiveItems * sizeof(cl_uint), NULL, &error);
+    test_error(error, "Unable to create interactive output buffer");
+    clMemWrapper batchOut = clCreateBuffer(
+        context, CL_MEM_WRITE_ONLY, batchItems * sizeof(cl_uint), NULL, &error);
+    test_error(error, "Unable to create batch output buffer");
+
+    log_benchmark_header("queue_hint", "hints/interactive");
+    for (const HintConfig &config : kHintConfigs)
+    {
+        if (config.extension
+            && !is_extension_available(device, config.extension))
+        {
+            log_info("%s is not supported, skipping %s hints\n",
+                     config.extension, config.name);
+            continue;
+        }
+
+        clCommandQueueWrapper interactiveQueue =
+            clCreateCommandQueueWithProperties(context, device,
+                                               config.interactive, &error);
+        test_error(error, "Unable to create interactive queue");
+        clCommandQueueWrapper batchQueue = clCreateCommandQueueWithProperties(
+            context, device, config.batch, &error);
+        test_error(error, "Unable to create batch queue");
+
+        SpinWork interactive = { interactiveQueue, interactiveKernel,
+                                 interactiveOut, kInteractiveItems,
+                                 kInteractiveIterations };
+        error = interactive.SetArgs();
+        test_error(error, "Unable to set interactive kernel arguments");
+        SpinWork batch = { batchQueue, batchKernel, batchOut, batchItems, 0 };
+        int ret = calibrate_batch(batch);
+        if (ret != TEST_PASS) return ret;
+
+        BenchmarkStats aloneStats;
+        ret = time_interactive_alone(interactive, &aloneStats);
+        if (ret != TEST_PASS) return ret;
+        std::string name = config.name;
+        log_benchmark_stats("queue_hint", (name + "/alone").c_str(), "us",
+                            false, aloneStats);
+
+        std::vector<double> contended;
+        double batchAlone, batchContended;
+        ret = run_batch(batch, NULL, contended, &batchAlone);
+        if (ret != TEST_PASS) return ret;
+        ret = run_batch(batch, &interactive, contended, &batchContended);
+        if (ret != TEST_PASS) return ret;
+        if (contended.empty())
+        {
+            log_info("The batch finished before any interactive kernel ran "
+                     "with %s hints\n",
+                     config.name);
+        }
+        else
+        {
+            BenchmarkStats contendedStats = compute_benchmark_stats(contended);
+            log_benchmark_stats("queue_hint", (name + "/contended").c_str(),
+                                "us", false, contendedStats);
+        }
+
+        double loss = 1.0 - batchContended / batchAlone;
+        log_info("%s hints: batch of %.1f kernels/s alone, %.1f kernels/s "
+                 "contended, %.3f throughput loss\n",
+                 config.name, batchAlone, batchContended, loss);
+        record_perf_metric("queue_hint_batch_alone." + name, batchAlone,
+                           "kernels/s", true);
+        record_perf_metric("queue_hint_batch_contended." + name,
+                           batchContended, "kernels/s", true);
+        record_perf_metric("queue_hint_batch_throughput_loss." + name, loss,
+                           "ratio", false);
+    }
+
+    return TEST_PASS;
+}
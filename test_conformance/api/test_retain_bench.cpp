@@ -0,0 +1,251 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "testBase.h"
+#include "harness/ThreadPool.h"
+#include "harness/perfMetrics.h"
+#include "harness/typeWrappers.h"
+#include "harness/benchmark.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+// Measures how object lifetime calls scale with the number of host threads
+// making them. Each of T thread pool jobs repeatedly creates a buffer, kernel
+// or user event, retains it kRetains times through wrapper copies, checks its
+// reference count and releases it again, which goes through the driver's
+// object tables on every call. A second mode has all the jobs retain,
+// query and release one object they share, which contends on that object's
+// reference count alone. The aggregate calls per second are reported against
+// T. A benchmark, so it only runs when named.
+
+namespace {
+
+const cl_uint kCyclesPerThread = 2000;
+const cl_uint kRetains = 4;
+// Calls per cycle: kRetains retains, a query and kRetains releases, plus a
+// create and a release when the job owns the object
+const cl_uint kSharedCallsPerCycle = 2 * kRetains + 1;
+const cl_uint kOwnedCallsPerCycle = kSharedCallsPerCycle + 2;
+
+const char *retain_kernel_source =
+    "__kernel void retain(__global uint *out)\n"
+    "{\n"
+    "    out[get_global_id(0)] = 0;\n"
+    "}\n";
+
+enum ObjectKind
+{
+    kObjectMem,
+    kObjectKernel,
+    kObjectEvent,
+};
+
+const char *kObjectNames[] = { "mem", "kernel", "event" };
+
+struct RetainJobs
+{
+    ObjectKind kind;
+    cl_context context;
+    cl_program program;
+    // The objects shared by all the jobs, or NULL for each job to create its
+    // own
+    const clMemWrapper *sharedMem;
+    const clKernelWrapper *sharedKernel;
+    const clEventWrapper *sharedEvent;
+};
+
+template <typename W, typename T, typename QueryFn, typename InfoT>
+int retain_cycle(const W &object, QueryFn query, InfoT param, bool exact)
+{
+    {
+        std::vector<W> copies(kRetains, object);
+        cl_uint count;
+        cl_int error = query((T)object, param, sizeof(count), &count, NULL);
+        test_error(error, "Unable to query the reference count");
+        if (exact ? count != kRetains + 1 : count < kRetains + 1)
+        {
+            log_error("Reference count is %u after %u retains\n", count,
+                      kRetains);
+            return TEST_FAIL;
+        }
+    }
+    return TEST_PASS;
+}
+
+int mem_cycle(RetainJobs *jobs)
+{
+    if (jobs->sharedMem)
+        return retain_cycle<clMemWrapper, cl_mem>(
+            *jobs->sharedMem, clGetMemObjectInfo,
+            CL_MEM_REFERENCE_COUNT, false);
+
+    cl_int error;
+    clMemWrapper mem = clCreateBuffer(jobs->context, CL_MEM_READ_WRITE,
+                                      sizeof(cl_uint), NULL, &error);
+    test_error(error, "Unable to create buffer");
+    return retain_cycle<clMemWrapper, cl_mem>(mem, clGetMemObjectInfo,
+                                              CL_MEM_REFERENCE_COUNT, true);
+}
+
+int kernel_cycle(RetainJobs *jobs)
+{
+    if (jobs->sharedKernel)
+        return retain_cycle<clKernelWrapper, cl_kernel>(
+            *jobs->sharedKernel, clGetKernelInfo,
+            CL_KERNEL_REFERENCE_COUNT, false);
+
+    cl_int error;
+    clKernelWrapper kernel = clCreateKernel(jobs->program, "retain", &error);
+    test_error(error, "Unable to create kernel");
+    return retain_cycle<clKernelWrapper, cl_kernel>(
+        kernel, clGetKernelInfo, CL_KERNEL_REFERENCE_COUNT, true);
+}
+
+int event_cycle(RetainJobs *jobs)
+{
+    if (jobs->sharedEvent)
+        return retain_cycle<clEventWrapper, cl_event>(
+            *jobs->sharedEvent, clGetEventInfo,
+            CL_EVENT_REFERENCE_COUNT, false);
+
+    cl_int error;
+    clEventWrapper event = clCreateUserEvent(jobs->context, &error);
+    test_error(error, "Unable to create user event");
+    int ret = retain_cycle<clEventWrapper, cl_event>(
+        event, clGetEventInfo, CL_EVENT_REFERENCE_COUNT, true);
+    error = clSetUserEventStatus(event, CL_COMPLETE);
+    test_error(error, "Unable to complete user event");
+    return ret;
+}
+
+cl_int retain_job(cl_uint job, cl_uint thread_id, void *userInfo)
+{
+    RetainJobs *jobs = (RetainJobs *)userInfo;
+    for (cl_uint cycle = 0; cycle < kCyclesPerThread; cycle++)
+    {
+        int ret;
+        switch (jobs->kind)
+        {
+            case kObjectMem: ret = mem_cycle(jobs); break;
+            case kObjectKernel: ret = kernel_cycle(jobs); break;
+            default: ret = event_cycle(jobs); break;
+        }
+        if (ret != TEST_PASS) return ret;
+    }
+    return CL_SUCCESS;
+}
+
+// Runs threadCount jobs at once and gives the aggregate lifetime calls per
+// second
+int sample_retains(RetainJobs &jobs, cl_uint threadCount, double *outCallsPerS)
+{
+    HostTimer timer;
+    cl_int error = ThreadPool_Do(retain_job, threadCount, &jobs);
+    test_error(error, "Retain job failed");
+    double seconds = timer.elapsed_ns() / 1e9;
+
+    cl_uint calls =
+        jobs.sharedMem ? kSharedCallsPerCycle : kOwnedCallsPerCycle;
+    *outCallsPerS = threadCount * (double)kCyclesPerThread * calls / seconds;
+    return TEST_PASS;
+}
+
+} // anonymous namespace
+
+int test_retain_release_bench(cl_device_id device, cl_context context,
+                              cl_command_queue queue, int num_elements)
+{
+    clProgramWrapper program;
+    clKernelWrapper kernel;
+    int error = create_single_kernel_helper(context, &program, &kernel, 1,
+                                            &retain_kernel_source, "retain");
+    test_error(error, "Unable to create retain kernel");
+    clMemWrapper mem = clCreateBuffer(context, CL_MEM_READ_WRITE,
+                                      sizeof(cl_uint), NULL, &error);
+    test_error(error, "Unable to create buffer");
+    clEventWrapper event = clCreateUserEvent(context, &error);
+    test_error(error, "Unable to create user event");
+
+    cl_uint maxThreads = GetThreadCount();
+    BenchmarkOptions options;
+    options.warmup = 1;
+    options.maxSeconds = 1.0;
+
+    log_benchmark_header("retain_release", "object/mode/threads");
+    for (int kind = kObjectMem; kind <= kObjectEvent; kind++)
+    {
+        for (int shared = 0; shared < 2; shared++)
+        {
+            const char *mode = shared ? "shared" : "owned";
+            RetainJobs jobs = { (ObjectKind)kind, context, program,
+                                NULL,           NULL,    NULL };
+            if (shared)
+            {
+                // The wrappers overload operator&
+                jobs.sharedMem = std::addressof(mem);
+                jobs.sharedKernel = std::addressof(kernel);
+                jobs.sharedEvent = std::addressof(event);
+            }
+
+            double singleRate = 0;
+            for (cl_uint threadCount = 1; threadCount <= maxThreads;
+                 threadCount *= 2)
+            {
+                BenchmarkStats stats;
+                error = run_benchmark(
+                    options,
+                    [&](double *rate) {
+                        return sample_retains(jobs, threadCount, rate);
+                    },
+                    &stats);
+                if (error != CL_SUCCESS) return TEST_FAIL;
+                if (threadCount == 1) singleRate = stats.median;
+
+                std::string label = std::string(kObjectNames[kind]) + "/"
+                    + mode + "/" + std::to_string(threadCount);
+                log_benchmark_stats("retain_release", label.c_str(), "calls/s",
+                                    true, stats);
+                record_perf_metric("retain_release_scaling." + label,
+                                   stats.median / singleRate, "ratio", true);
+            }
+        }
+    }
+
+    // The shared objects must be back to the reference the test holds
+    cl_uint counts[3];
+    error = clGetMemObjectInfo(mem, CL_MEM_REFERENCE_COUNT, sizeof(cl_uint),
+                               &counts[0], NULL);
+    error |= clGetKernelInfo(kernel, CL_KERNEL_REFERENCE_COUNT,
+                             sizeof(cl_uint), &counts[1], NULL);
+    error |= clGetEventInfo(event, CL_EVENT_REFERENCE_COUNT, sizeof(cl_uint),
+                            &counts[2], NULL);
+    test_error(error, "Unable to query the reference counts");
+    for (int kind = kObjectMem; kind <= kObjectEvent; kind++)
+    {
+        if (counts[kind] != 1)
+        {
+            log_error("Shared %s reference count is %u after the threads "
+                      "released it, expected 1\n",
+                      kObjectNames[kind], counts[kind]);
+            return TEST_FAIL;
+        }
+    }
+
+    error = clSetUserEventStatus(event, CL_COMPLETE);
+    test_error(error, "Unable to complete user event");
+    return TEST_PASS;
+}
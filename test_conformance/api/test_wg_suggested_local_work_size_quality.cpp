@@ -0,0 +1,400 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "harness/compat.h"
+#include "harness/benchmark.h"
+#include "harness/perfMetrics.h"
+#include "harness/typeWrappers.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "procs.h"
+#include <CL/cl_ext.h>
+
+// How good the local size from clGetKernelSuggestedLocalWorkSizeKHR is:
+// a memory-bound, a compute-bound and a local-memory heavy kernel are timed
+// at the suggested size, at a NULL local size and at every legal uniform
+// local size of a few 1D and 2D global sizes. Every legal size gets one
+// sample to find the best, and the suggested, NULL and best sizes then get
+// as many as run_benchmark takes. Their rows give the device times, with the
+// slowdown of the suggestion against the best size and how many legal sizes
+// beat it recorded as metrics. A benchmark, so it only runs when named.
+
+static const char *quality_kernels = R"(
+    size_t linear_gid()
+    {
+        return get_global_id(1) * get_global_size(0) + get_global_id(0);
+    }
+
+    __kernel void memory_bound(__global const uint *src, __global uint *dst,
+                               __local uint *tile)
+    {
+        size_t gid = linear_gid();
+        dst[gid] = src[gid] * 3u + 1u;
+    }
+
+    __kernel void compute_bound(__global const uint *src, __global uint *dst,
+                                __local uint *tile)
+    {
+        size_t gid = linear_gid();
+        uint x = src[gid];
+        for (uint i = 0; i < COMPUTE_ITERATIONS; i++)
+            x = x * 1664525u + 1013904223u;
+        dst[gid] = x;
+    }
+
+    __kernel void local_heavy(__global const uint *src, __global uint *dst,
+                              __local uint *tile)
+    {
+        size_t lid = get_local_id(1) * get_local_size(0) + get_local_id(0);
+        size_t lsize = get_local_size(0) * get_local_size(1);
+        tile[lid] = src[linear_gid()];
+        barrier(CLK_LOCAL_MEM_FENCE);
+        uint sum = 0;
+        for (uint i = 0; i < LOCAL_READS; i++)
+            sum += tile[(lid + i * 7) % lsize];
+        dst[linear_gid()] = sum;
+    })";
+
+enum QualityKernel
+{
+    kMemoryBound,
+    kComputeBound,
+    kLocalHeavy,
+    kQualityKernelCount
+};
+
+static const char *quality_kernel_names[] = { "memory_bound", "compute_bound",
+                                              "local_heavy" };
+
+static const cl_uint kComputeIterations = 256;
+static const cl_uint kLocalReads = 16;
+static const cl_uint kQualityRepeats = 8;
+
+struct QualityShape
+{
+    cl_uint dims;
+    size_t global[2];
+};
+
+// Powers of two, one with many small prime factors, and a 2D size that is
+// neither
+static const QualityShape quality_shapes[] = {
+    { 1, { 1 << 20, 1 } },
+    { 1, { 3 * 5 * 7 * (1 << 12), 1 } },
+    { 2, { 1024, 1024 } },
+    { 2, { 960, 540 } },
+};
+
+namespace {
+
+struct QualityBench
+{
+    cl_command_queue queue;
+    cl_kernel kernel;
+    QualityKernel kind;
+    size_t max_wg_size;
+    std::vector<cl_uint> input;
+    std::vector<cl_uint> output;
+    clMemWrapper src;
+    clMemWrapper dst;
+
+    // Device time of one launch, in us, from the start of the first to the
+    // end of the last of kQualityRepeats back-to-back launches
+    int Time(const QualityShape &shape, const size_t *local, double &us)
+    {
+        int error = clSetKernelArg(kernel, 0, sizeof(cl_mem), &src);
+        error |= clSetKernelArg(kernel, 1, sizeof(cl_mem), &dst);
+        error |= clSetKernelArg(kernel, 2, sizeof(cl_uint) * max_wg_size, NULL);
+        test_error(error, "Unable to set kernel arguments");
+
+        // The first launch of a local size can pay for setting it up
+        error = clEnqueueNDRangeKernel(queue, kernel, shape.dims, NULL,
+                                       shape.global, local, 0, NULL, NULL);
+        test_error(error, "Kernel execution failed");
+
+        clEventWrapper first, last;
+        for (cl_uint i = 0; i < kQualityRepeats; i++)
+        {
+            cl_event *event = i == 0 ? &first
+                                     : i == kQualityRepeats - 1 ? &last : NULL;
+            error = clEnqueueNDRangeKernel(queue, kernel, shape.dims, NULL,
+                                           shape.global, local, 0, NULL, event);
+            test_error(error, "Kernel execution failed");
+        }
+        error = clFinish(queue);
+        test_error(error, "clFinish failed");
+
+        cl_ulong start, end;
+        error = clGetEventProfilingInfo(first, CL_PROFILING_COMMAND_START,
+                                        sizeof(start), &start, NULL);
+        error |= clGetEventProfilingInfo(last, CL_PROFILING_COMMAND_END,
+                                         sizeof(end), &end, NULL);
+        test_error(error, "clGetEventProfilingInfo failed");
+        us = (end - start) / 1e3 / kQualityRepeats;
+        return 0;
+    }
+
+    // Samples Time as run_benchmark asks for them
+    int Measure(const QualityShape &shape, const size_t *local,
+                BenchmarkStats &stats)
+    {
+        BenchmarkOptions options;
+        options.warmup = 1;
+        options.maxSeconds = 1.0;
+        return run_benchmark(
+            options,
+            [&](double *us) { return (cl_int)Time(shape, local, *us); },
+            &stats);
+    }
+
+    // Checks the results of the last launch with the given local size
+    int Verify(const QualityShape &shape, const size_t *local)
+    {
+        size_t items = shape.global[0] * shape.global[1];
+        int error = clEnqueueReadBuffer(queue, dst, CL_TRUE, 0,
+                                        sizeof(cl_uint) * items, output.data(),
+                                        0, NULL, NULL);
+        test_error(error, "Unable to read results");
+
+        for (size_t i = 0; i < items; i++)
+        {
+            cl_uint expected = input[i];
+            if (kind == kMemoryBound)
+            {
+                expected = expected * 3u + 1u;
+            }
+            else if (kind == kComputeBound)
+            {
+                for (cl_uint n = 0; n < kComputeIterations; n++)
+                    expected = expected * 1664525u + 1013904223u;
+            }
+            else
+            {
+                size_t x = i % shape.global[0], y = i / shape.global[0];
+                size_t lx = local[0], ly = shape.dims > 1 ? local[1] : 1;
+                size_t x0 = x - x % lx, y0 = y - y % ly;
+                // The last work-group of a non-uniform launch is smaller
+                lx = std::min(lx, shape.global[0] - x0);
+                ly = std::min(ly, shape.global[1] - y0);
+                size_t lid = (y - y0) * lx + (x - x0);
+                expected = 0;
+                for (cl_uint n = 0; n < kLocalReads; n++)
+                {
+                    size_t other = (lid + n * 7) % (lx * ly);
+                    expected += input[(y0 + other / lx) * shape.global[0] + x0
+                                      + other % lx];
+                }
+            }
+            if (output[i] != expected)
+            {
+                log_error("ERROR: %s work-item %zu is 0x%x, expected 0x%x\n",
+                          quality_kernel_names[kind], i, output[i], expected);
+                return -1;
+            }
+        }
+        return 0;
+    }
+};
+
+std::string local_string(const size_t *local, cl_uint dims)
+{
+    if (!local) return "NULL";
+    std::string s = std::to_string(local[0]);
+    if (dims > 1) s += "x" + std::to_string(local[1]);
+    return s;
+}
+
+} // anonymous namespace
+
+int test_work_group_suggested_local_size_quality(cl_device_id device,
+                                                 cl_context context,
+                                                 cl_command_queue queue,
+                                                 int n_elems)
+{
+    if (!is_extension_available(device, "cl_khr_suggested_local_work_size"))
+    {
+        log_info("Device does not support 'cl_khr_suggested_local_work_size'. "
+                 "Skipping the test.\n");
+        return TEST_SKIPPED_ITSELF;
+    }
+
+    cl_platform_id platform;
+    int error = clGetDeviceInfo(device, CL_DEVICE_PLATFORM, sizeof(platform),
+                                &platform, NULL);
+    test_error(error, "clGetDeviceInfo failed");
+    clGetKernelSuggestedLocalWorkSizeKHR_fn
+        clGetKernelSuggestedLocalWorkSizeKHR =
+            (clGetKernelSuggestedLocalWorkSizeKHR_fn)
+                clGetExtensionFunctionAddressForPlatform(
+                    platform, "clGetKernelSuggestedLocalWorkSizeKHR");
+    if (clGetKernelSuggestedLocalWorkSizeKHR == NULL)
+    {
+        log_error("Extension 'cl_khr_suggested_local_work_size' could not be "
+                  "found.\n");
+        return TEST_FAIL;
+    }
+
+    size_t max_item_sizes[3];
+    cl_ulong local_mem_size;
+    error = clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_ITEM_SIZES,
+                            sizeof(max_item_sizes), max_item_sizes, NULL);
+    test_error(error, "clGetDeviceInfo failed");
+    error = clGetDeviceInfo(device, CL_DEVICE_LOCAL_MEM_SIZE,
+                            sizeof(local_mem_size), &local_mem_size, NULL);
+    test_error(error, "clGetDeviceInfo failed");
+
+    clCommandQueueWrapper profiling_queue = clCreateCommandQueue(
+        context, device, CL_QUEUE_PROFILING_ENABLE, &error);
+    test_error(error, "Unable to create a profiling command queue");
+
+    std::string options = "-DCOMPUTE_ITERATIONS="
+        + std::to_string(kComputeIterations)
+        + " -DLOCAL_READS=" + std::to_string(kLocalReads);
+    size_t items = 0;
+    for (size_t s = 0; s < ARRAY_SIZE(quality_shapes); s++)
+        items = std::max(items,
+                         quality_shapes[s].global[0]
+                             * quality_shapes[s].global[1]);
+
+    QualityBench bench;
+    bench.queue = profiling_queue;
+    RandomSeed seed(gRandomSeed);
+    bench.input.resize(items);
+    for (size_t i = 0; i < items; i++) bench.input[i] = genrand_int32(seed);
+    bench.output.resize(items);
+    bench.src = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+                               sizeof(cl_uint) * items, bench.input.data(),
+                               &error);
+    test_error(error, "Unable to create input buffer");
+    bench.dst = clCreateBuffer(context, CL_MEM_WRITE_ONLY,
+                               sizeof(cl_uint) * items, NULL, &error);
+    test_error(error, "Unable to create output buffer");
+
+    log_benchmark_header("suggested_local_size", "kernel/global/local");
+
+    for (int k = 0; k < kQualityKernelCount; k++)
+    {
+        clProgramWrapper program;
+        clKernelWrapper kernel;
+        error = create_single_kernel_helper_with_build_options(
+            context, &program, &kernel, 1, &quality_kernels,
+            quality_kernel_names[k], options.c_str());
+        test_error(error, "Unable to create kernel");
+        bench.kernel = kernel;
+        bench.kind = (QualityKernel)k;
+        error = clGetKernelWorkGroupInfo(kernel, device,
+                                         CL_KERNEL_WORK_GROUP_SIZE,
+                                         sizeof(bench.max_wg_size),
+                                         &bench.max_wg_size, NULL);
+        test_error(error, "clGetKernelWorkGroupInfo failed");
+
+        // The tile holds one value per work-item of the largest work-group
+        while (sizeof(cl_uint) * bench.max_wg_size > local_mem_size)
+            bench.max_wg_size /= 2;
+
+        for (size_t s = 0; s < ARRAY_SIZE(quality_shapes); s++)
+        {
+            const QualityShape &shape = quality_shapes[s];
+
+            // The suggestion has to see the kernel arguments it is for
+            error = clSetKernelArg(kernel, 0, sizeof(cl_mem), &bench.src);
+            error |= clSetKernelArg(kernel, 1, sizeof(cl_mem), &bench.dst);
+            error |= clSetKernelArg(kernel, 2,
+                                    sizeof(cl_uint) * bench.max_wg_size, NULL);
+            test_error(error, "Unable to set kernel arguments");
+            size_t suggested[3] = { 1, 1, 1 };
+            error = clGetKernelSuggestedLocalWorkSizeKHR(
+                profiling_queue, kernel, shape.dims, NULL, shape.global,
+                suggested);
+            test_error(error, "clGetKernelSuggestedLocalWorkSizeKHR failed");
+
+            std::string name = std::string(quality_kernel_names[k]) + "/"
+                + local_string(shape.global, shape.dims);
+            BenchmarkStats suggested_stats;
+            error = bench.Measure(shape, suggested, suggested_stats);
+            if (!error) error = bench.Verify(shape, suggested);
+            if (error) return error;
+            log_benchmark_stats(
+                "suggested_local_size",
+                (name + "/suggested_" + local_string(suggested, shape.dims))
+                    .c_str(),
+                "us", false, suggested_stats);
+            // Without a known local size the results of the local memory
+            // kernel can't be checked
+            if (k != kLocalHeavy)
+            {
+                BenchmarkStats null_stats;
+                error = bench.Measure(shape, NULL, null_stats);
+                if (error) return error;
+                log_benchmark_stats("suggested_local_size",
+                                    (name + "/NULL").c_str(), "us", false,
+                                    null_stats);
+            }
+
+            // Every uniform local size the device and kernel accept
+            size_t best[2] = { 0, 0 };
+            double best_us = 0;
+            size_t better = 0, candidates = 0;
+            size_t max_y = shape.dims > 1 ? max_item_sizes[1] : 1;
+            for (size_t ly = 1; ly <= std::min(shape.global[1], max_y); ly++)
+            {
+                if (shape.global[1] % ly) continue;
+                size_t max_x = std::min(max_item_sizes[0],
+                                        bench.max_wg_size / ly);
+                for (size_t lx = 1; lx <= std::min(shape.global[0], max_x);
+                     lx++)
+                {
+                    if (shape.global[0] % lx) continue;
+                    size_t local[2] = { lx, ly };
+                    double us;
+                    error = bench.Time(shape, local, us);
+                    if (error) return error;
+                    candidates++;
+                    if (us < suggested_stats.median) better++;
+                    if (best_us == 0 || us < best_us)
+                    {
+                        best[0] = lx;
+                        best[1] = ly;
+                        best_us = us;
+                    }
+                }
+            }
+            BenchmarkStats best_stats;
+            error = bench.Measure(shape, best, best_stats);
+            if (!error) error = bench.Verify(shape, best);
+            if (error) return error;
+            log_benchmark_stats(
+                "suggested_local_size",
+                (name + "/best_" + local_string(best, shape.dims)).c_str(),
+                "us", false, best_stats);
+
+            record_perf_metric("suggested_local_size_slowdown." + name,
+                               best_stats.median > 0
+                                   ? suggested_stats.median / best_stats.median
+                                   : 0.0,
+                               "ratio", false);
+            record_perf_metric("suggested_local_size_better." + name,
+                               (double)better, "sizes", false);
+            log_info("%s: %zu of %zu legal local sizes beat the suggested "
+                     "one\n",
+                     name.c_str(), better, candidates);
+        }
+    }
+
+    return 0;
+}
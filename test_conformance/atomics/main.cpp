@@ -40,6 +40,8 @@ test_definition test_list[] = {
 
     ADD_TEST( atomic_add_index ),
     ADD_TEST( atomic_add_index_bin ),
+
+    ADD_BENCHMARK( atomic_add_throughput ),
 };
 // clang-format on
 
@@ -13,9 +13,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //
+#include "harness/conversions.h"
 #include "harness/errorHelpers.h"
 #include "harness/kernelHelpers.h"
 #include "harness/typeWrappers.h"
+#include "harness/parseParameters.h"
 
 extern int create_program_and_kernel(const char *source,
                                      const char *kernel_name,
@@ -49,3 +51,10 @@ extern int test_atomic_add_index(cl_device_id deviceID, cl_context context,
                                  cl_command_queue queue, int num_elements);
 extern int test_atomic_add_index_bin(cl_device_id deviceID, cl_context context,
                                      cl_command_queue queue, int num_elements);
+
+extern bool check_atomic_support(cl_device_id device, bool extended,
+                                 bool isLocal, ExplicitType dataType);
+
+extern int test_atomic_add_throughput(cl_device_id deviceID, cl_context context,
+                                      cl_command_queue queue,
+                                      int num_elements);
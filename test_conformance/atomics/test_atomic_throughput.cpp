@@ -0,0 +1,318 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "testBase.h"
+#include "harness/conversions.h"
+#include "harness/benchmark.h"
+#include "harness/perfMetrics.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <string>
+#include <vector>
+
+// Histogram-style atomic add throughput against the number of bins the
+// work-items spread their adds over, from every add hitting one address to
+// each neighbouring work-item hitting a different one. Bins live in global
+// memory, or in local memory with one flush to global memory per work-group,
+// and are 32 or 64 bits wide. The legacy atomic_add and atom_add built-ins
+// are compared with atomic_fetch_add_explicit and memory_order_relaxed.
+// A benchmark, so it only runs when named.
+
+static const char *atomic_throughput_kernel = R"CLC(
+#if IS_64BIT
+#pragma OPENCL EXTENSION cl_khr_int64_base_atomics : enable
+#pragma OPENCL EXTENSION cl_khr_int64_extended_atomics : enable
+#endif
+
+#if USE_C11
+#define BIN_T ATOMIC_T
+#define GLOBAL_ADD(p, v)                                                       \
+    atomic_fetch_add_explicit(p, v, memory_order_relaxed, memory_scope_device)
+#define LOCAL_ADD(p, v)                                                        \
+    atomic_fetch_add_explicit(p, v, memory_order_relaxed,                     \
+                              memory_scope_work_group)
+#define LOCAL_STORE(p, v)                                                      \
+    atomic_store_explicit(p, v, memory_order_relaxed, memory_scope_work_group)
+#define LOCAL_LOAD(p)                                                          \
+    atomic_load_explicit(p, memory_order_relaxed, memory_scope_work_group)
+#else
+#define BIN_T volatile T
+#if IS_64BIT
+#define GLOBAL_ADD(p, v) atom_add(p, v)
+#else
+#define GLOBAL_ADD(p, v) atomic_add(p, v)
+#endif
+#define LOCAL_ADD(p, v) GLOBAL_ADD(p, v)
+#define LOCAL_STORE(p, v) (*(p) = (v))
+#define LOCAL_LOAD(p) (*(p))
+#endif
+
+// Every work-item adds 1 to iterations consecutive bins starting at its own
+__kernel void global_bins(__global BIN_T *bins, uint bin_mask, int iterations)
+{
+    uint gid = get_global_id(0);
+    for (int i = 0; i < iterations; i++)
+        GLOBAL_ADD(&bins[(gid + i) & bin_mask], (T)1);
+}
+
+__kernel void local_bins(__global BIN_T *bins, __local BIN_T *tile,
+                         uint bin_mask, int iterations)
+{
+    uint lid = get_local_id(0);
+    for (uint b = lid; b <= bin_mask; b += get_local_size(0))
+        LOCAL_STORE(&tile[b], (T)0);
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    for (int i = 0; i < iterations; i++)
+        LOCAL_ADD(&tile[(lid + i) & bin_mask], (T)1);
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    for (uint b = lid; b <= bin_mask; b += get_local_size(0))
+        GLOBAL_ADD(&bins[b], LOCAL_LOAD(&tile[b]));
+}
+)CLC";
+
+namespace {
+
+// Bin counts are powers of two up to kIterations, so every work-item hits
+// every bin equally often
+const cl_uint kBinCounts[] = { 1, 4, 16, 64, 256, 1024 };
+const cl_int kIterations = 1024;
+const size_t kLocalSize = 256;
+const size_t kGroupsPerUnit = 8;
+const size_t kMaxItems = 1 << 16;
+
+struct AtomicThroughputCase
+{
+    bool is64bit;
+    bool useC11;
+};
+
+const char *api_name(const AtomicThroughputCase &c)
+{
+    if (c.useC11) return "atomic_fetch_add_explicit";
+    return c.is64bit ? "atom_add" : "atomic_add";
+}
+
+struct AtomicThroughputBench
+{
+    cl_command_queue queue;
+    clMemWrapper bins;
+    size_t bin_size;
+    size_t global;
+    size_t local;
+
+    // Atomic adds per nanosecond, which is billions per second, checking
+    // the bins of every run
+    int Measure(cl_kernel kernel, bool isLocal, cl_uint bin_count,
+                BenchmarkStats &stats)
+    {
+        cl_uint bin_mask = bin_count - 1;
+        cl_uint arg = 0;
+        int error = clSetKernelArg(kernel, arg++, sizeof(cl_mem), &bins);
+        if (isLocal)
+            error |= clSetKernelArg(kernel, arg++, bin_count * bin_size, NULL);
+        error |= clSetKernelArg(kernel, arg++, sizeof(bin_mask), &bin_mask);
+        error |= clSetKernelArg(kernel, arg++, sizeof(kIterations),
+                                &kIterations);
+        test_error(error, "Unable to set kernel arguments");
+
+        BenchmarkOptions options;
+        options.warmup = 1;
+        options.maxSeconds = 1.0;
+        return run_benchmark(
+            options,
+            [&](double *rate) {
+                const cl_ulong zero = 0;
+                cl_int err =
+                    clEnqueueFillBuffer(queue, bins, &zero, bin_size, 0,
+                                        bin_count * bin_size, 0, NULL, NULL);
+                test_error(err, "Unable to clear the bins");
+
+                clEventWrapper event;
+                err = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &global,
+                                             &local, 0, NULL, &event);
+                test_error(err, "Unable to enqueue kernel");
+                err = clWaitForEvents(1, &event);
+                test_error(err, "clWaitForEvents failed");
+
+                double ns;
+                err = get_event_duration_ns(event, &ns);
+                if (err != CL_SUCCESS) return err;
+                *rate = ns > 0 ? (double)global * kIterations / ns : 0.0;
+                return (cl_int)Check(bin_count);
+            },
+            &stats);
+    }
+
+    int Check(cl_uint bin_count)
+    {
+        std::vector<cl_uchar> values(bin_count * bin_size);
+        int error = clEnqueueReadBuffer(queue, bins, CL_TRUE, 0, values.size(),
+                                        values.data(), 0, NULL, NULL);
+        test_error(error, "Unable to read the bins");
+
+        cl_ulong expected = (cl_ulong)global * kIterations / bin_count;
+        for (cl_uint b = 0; b < bin_count; b++)
+        {
+            cl_ulong value = bin_size == sizeof(cl_ulong)
+                ? ((cl_ulong *)values.data())[b]
+                : ((cl_uint *)values.data())[b];
+            if (value != expected)
+            {
+                log_error("ERROR: bin %u of %u counted %" PRIu64
+                          " adds, expected %" PRIu64 "\n",
+                          b, bin_count, value, expected);
+                return -1;
+            }
+        }
+        return CL_SUCCESS;
+    }
+};
+
+// C11 atomics need OpenCL C 2.0, and on 3.0 devices device scope atomics
+// are optional
+bool c11_atomics_supported(cl_device_id device)
+{
+    Version version = get_device_cl_version(device);
+    if (version < Version(2, 0)) return false;
+    if (version < Version(3, 0)) return true;
+
+    cl_device_atomic_capabilities caps = 0;
+    int error = clGetDeviceInfo(device, CL_DEVICE_ATOMIC_MEMORY_CAPABILITIES,
+                                sizeof(caps), &caps, NULL);
+    if (error != CL_SUCCESS)
+    {
+        print_error(error,
+                    "Unable to get CL_DEVICE_ATOMIC_MEMORY_CAPABILITIES");
+        return false;
+    }
+    return (caps & CL_DEVICE_ATOMIC_SCOPE_DEVICE) != 0;
+}
+
+} // anonymous namespace
+
+int test_atomic_add_throughput(cl_device_id deviceID, cl_context context,
+                               cl_command_queue queue, int num_elements)
+{
+    int error;
+    cl_uint units;
+    cl_ulong local_mem;
+    error = clGetDeviceInfo(deviceID, CL_DEVICE_MAX_COMPUTE_UNITS,
+                            sizeof(units), &units, NULL);
+    test_error(error, "Unable to get CL_DEVICE_MAX_COMPUTE_UNITS");
+    error = clGetDeviceInfo(deviceID, CL_DEVICE_LOCAL_MEM_SIZE,
+                            sizeof(local_mem), &local_mem, NULL);
+    test_error(error, "Unable to get CL_DEVICE_LOCAL_MEM_SIZE");
+
+    clCommandQueueWrapper profiling_queue = clCreateCommandQueue(
+        context, deviceID, CL_QUEUE_PROFILING_ENABLE, &error);
+    test_error(error, "Unable to create profiling queue");
+
+    AtomicThroughputBench bench;
+    bench.queue = profiling_queue;
+    cl_uint max_bins = kBinCounts[ARRAY_SIZE(kBinCounts) - 1];
+    bench.bins = clCreateBuffer(context, CL_MEM_READ_WRITE,
+                                max_bins * sizeof(cl_ulong), NULL, &error);
+    test_error(error, "Unable to create the bins");
+
+    bool c11 = c11_atomics_supported(deviceID);
+    if (!c11)
+        log_info("The device has no device scope C11 atomics, skipping "
+                 "atomic_fetch_add_explicit\n");
+
+    const AtomicThroughputCase cases[] = {
+        { false, false },
+        { false, true },
+        { true, false },
+        { true, true },
+    };
+
+    log_benchmark_header("atomic_add", "memory/type/built_in/bins");
+    for (const AtomicThroughputCase &c : cases)
+    {
+        if (c.useC11 && !c11) continue;
+        bench.bin_size = c.is64bit ? sizeof(cl_ulong) : sizeof(cl_uint);
+
+        std::string options = std::string("-DIS_64BIT=")
+            + (c.is64bit ? "1" : "0") + " -DUSE_C11=" + (c.useC11 ? "1" : "0")
+            + " -DT=" + (c.is64bit ? "long" : "int")
+            + " -DATOMIC_T=" + (c.is64bit ? "atomic_long" : "atomic_int");
+        clProgramWrapper program;
+        clKernelWrapper kernels[2];
+        bool built = false;
+
+        for (int isLocal = 0; isLocal < 2; isLocal++)
+        {
+            ExplicitType type = c.is64bit ? kLong : kInt;
+            if (!check_atomic_support(deviceID, false, isLocal, type)
+                || (c.useC11 && c.is64bit
+                    && !check_atomic_support(deviceID, true, isLocal, type)))
+            {
+                log_info("%s %s atomics are not supported, skipping them\n",
+                         isLocal ? "Local" : "Global",
+                         c.is64bit ? "64-bit" : "32-bit");
+                continue;
+            }
+
+            if (!built)
+            {
+                error = create_single_kernel_helper(
+                    context, &program, &kernels[0], 1,
+                    &atomic_throughput_kernel, "global_bins", options.c_str());
+                test_error(error, "Unable to create the atomic kernels");
+                kernels[1] = clCreateKernel(program, "local_bins", &error);
+                test_error(error, "Unable to create the local bins kernel");
+                built = true;
+            }
+
+            cl_kernel kernel = kernels[isLocal];
+            size_t max_local;
+            error = get_max_allowed_1d_work_group_size_on_device(
+                deviceID, kernel, &max_local);
+            test_error(error, "Unable to get the work-group size");
+            bench.local = 1;
+            while (bench.local * 2 <= std::min(max_local, kLocalSize))
+                bench.local *= 2;
+            bench.global = std::min(bench.local * units * kGroupsPerUnit,
+                                    kMaxItems);
+
+            double one_bin_rate = 0;
+            for (cl_uint bin_count : kBinCounts)
+            {
+                if (isLocal && bin_count * bench.bin_size > local_mem) break;
+
+                BenchmarkStats stats;
+                error = bench.Measure(kernel, isLocal, bin_count, stats);
+                if (error != CL_SUCCESS) return TEST_FAIL;
+                if (bin_count == 1) one_bin_rate = stats.median;
+
+                std::string label = std::string(isLocal ? "local" : "global")
+                    + "/" + (c.is64bit ? "long" : "int") + "/" + api_name(c)
+                    + "/" + std::to_string(bin_count);
+                log_benchmark_stats("atomic_add", label.c_str(),
+                                    "Gatomics/s", true, stats);
+                record_perf_metric("atomic_add_vs_1_bin." + label,
+                                   one_bin_rate > 0
+                                       ? stats.median / one_bin_rate
+                                       : 0.0,
+                                   "ratio", true);
+            }
+        }
+    }
+
+    return 0;
+}
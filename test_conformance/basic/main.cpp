@@ -154,6 +154,12 @@ test_definition test_list[] = {
 
     ADD_TEST_VERSION(get_linear_ids, Version(2, 0)),
     ADD_TEST_VERSION(rw_image_access_qualifier, Version(2, 0)),
+
+    ADD_BENCHMARK(bufferrect_bandwidth),
+    ADD_BENCHMARK(async_copy_bandwidth),
+    ADD_BENCHMARK(local_bandwidth),
+    ADD_BENCHMARK(global_access_bandwidth),
+    ADD_BENCHMARK(barrier_bench),
 };
 
 const int test_num = ARRAY_SIZE( test_list );
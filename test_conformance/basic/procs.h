@@ -20,6 +20,7 @@
 #include "harness/typeWrappers.h"
 #include "harness/conversions.h"
 #include "harness/rounding_mode.h"
+#include "harness/parseParameters.h"
 
 extern int      test_hostptr(cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements);
 extern int test_fpmath(cl_device_id deviceID, cl_context context,
@@ -189,3 +190,16 @@ extern int test_queue_priority(cl_device_id device, cl_context context, cl_comma
 extern int test_get_linear_ids(cl_device_id device, cl_context cl_context_, cl_command_queue q, int num_elements);
 extern int test_rw_image_access_qualifier(cl_device_id device_id, cl_context context, cl_command_queue commands, int num_elements);
 
+extern int test_bufferrect_bandwidth(cl_device_id device, cl_context context,
+                                     cl_command_queue queue, int num_elements);
+extern int test_async_copy_bandwidth(cl_device_id device, cl_context context,
+                                     cl_command_queue queue, int num_elements);
+extern int test_local_bandwidth(cl_device_id device, cl_context context,
+                                cl_command_queue queue, int num_elements);
+extern int test_global_access_bandwidth(cl_device_id device,
+                                        cl_context context,
+                                        cl_command_queue queue,
+                                        int num_elements);
+extern int test_barrier_bench(cl_device_id device, cl_context context,
+                              cl_command_queue queue, int num_elements);
+
@@ -0,0 +1,303 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "harness/compat.h"
+#include "harness/benchmark.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+
+#include "procs.h"
+
+// Global to local and local to global bandwidth of the async work-group
+// copies against the same copies done by the work-items of the group in a
+// loop, over element types, strides and work-group sizes, so kernels can
+// tell whether the async path pays off on a device. A benchmark, so it only
+// runs when named.
+
+static const char *kElementTypes[] = { "uchar", "ushort", "uint",  "uint2",
+                                       "uint4", "uint8",  "uint16" };
+static const size_t kElementSizes[] = { 1, 2, 4, 8, 16, 32, 64 };
+static const int kStrides[] = { 1, 2, 4, 16 };
+static const size_t kWorkGroupSizes[] = { 64, 128, 256 };
+static const int kCopiesPerItem = 16;
+// Each kernel moves about this many bytes between global and local memory
+static const size_t kBytesPerKernel = (size_t)64 << 20;
+
+static const char *async_copy_bandwidth_kernels = R"(
+    __kernel void global_to_local_async(const __global T *src,
+                                        __global T *dst, __local T *local_data,
+                                        int copies_per_item, int stride)
+    {
+        int per_group = copies_per_item * get_local_size(0);
+        const __global T *group_src =
+            src + (size_t)get_group_id(0) * per_group * stride;
+        event_t event = async_work_group_strided_copy(
+            local_data, group_src, (size_t)per_group, (size_t)stride, 0);
+        wait_group_events(1, &event);
+
+        T acc = (T)0;
+        for (int i = 0; i < copies_per_item; i++)
+            acc += local_data[get_local_id(0) * copies_per_item + i];
+        dst[get_global_id(0)] = acc;
+    }
+
+    __kernel void global_to_local_manual(const __global T *src,
+                                         __global T *dst,
+                                         __local T *local_data,
+                                         int copies_per_item, int stride)
+    {
+        int per_group = copies_per_item * get_local_size(0);
+        const __global T *group_src =
+            src + (size_t)get_group_id(0) * per_group * stride;
+        for (int i = get_local_id(0); i < per_group; i += get_local_size(0))
+            local_data[i] = group_src[(size_t)i * stride];
+        barrier(CLK_LOCAL_MEM_FENCE);
+
+        T acc = (T)0;
+        for (int i = 0; i < copies_per_item; i++)
+            acc += local_data[get_local_id(0) * copies_per_item + i];
+        dst[get_global_id(0)] = acc;
+    }
+
+    __kernel void local_to_global_async(const __global T *src,
+                                        __global T *dst, __local T *local_data,
+                                        int copies_per_item, int stride)
+    {
+        int per_group = copies_per_item * get_local_size(0);
+        for (int i = 0; i < copies_per_item; i++)
+            local_data[get_local_id(0) * copies_per_item + i] =
+                (T)(get_local_id(0) + i);
+        barrier(CLK_LOCAL_MEM_FENCE);
+
+        __global T *group_dst =
+            dst + (size_t)get_group_id(0) * per_group * stride;
+        event_t event = async_work_group_strided_copy(
+            group_dst, local_data, (size_t)per_group, (size_t)stride, 0);
+        wait_group_events(1, &event);
+    }
+
+    __kernel void local_to_global_manual(const __global T *src,
+                                         __global T *dst,
+                                         __local T *local_data,
+                                         int copies_per_item, int stride)
+    {
+        int per_group = copies_per_item * get_local_size(0);
+        for (int i = 0; i < copies_per_item; i++)
+            local_data[get_local_id(0) * copies_per_item + i] =
+                (T)(get_local_id(0) + i);
+        barrier(CLK_LOCAL_MEM_FENCE);
+
+        __global T *group_dst =
+            dst + (size_t)get_group_id(0) * per_group * stride;
+        for (int i = get_local_id(0); i < per_group; i += get_local_size(0))
+            group_dst[(size_t)i * stride] = local_data[i];
+    }
+)";
+
+namespace {
+
+struct CopyKernels
+{
+    clProgramWrapper program;
+    // Async and manual for each direction
+    clKernelWrapper kernels[2][2];
+};
+
+struct AsyncCopyBench
+{
+    cl_command_queue queue;
+    cl_ulong local_mem;
+    size_t max_bytes;
+    clMemWrapper src;
+    clMemWrapper dst;
+
+    int SetArgs(cl_kernel kernel, size_t element_size, size_t wg_size,
+                int copies_per_item, int stride)
+    {
+        int error = clSetKernelArg(kernel, 0, sizeof(cl_mem), &src);
+        error |= clSetKernelArg(kernel, 1, sizeof(cl_mem), &dst);
+        error |= clSetKernelArg(kernel, 2,
+                                element_size * wg_size * copies_per_item,
+                                NULL);
+        error |= clSetKernelArg(kernel, 3, sizeof(int), &copies_per_item);
+        error |= clSetKernelArg(kernel, 4, sizeof(int), &stride);
+        test_error(error, "clSetKernelArg failed");
+        return CL_SUCCESS;
+    }
+
+    // Device time of one run of the kernel, in GB/s of the bytes moved
+    // between global and local memory
+    int Sample(cl_kernel kernel, size_t groups, size_t wg_size, double bytes,
+               double *gbps)
+    {
+        size_t global = groups * wg_size;
+        clEventWrapper event;
+        int error = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &global,
+                                           &wg_size, 0, NULL, &event);
+        test_error(error, "clEnqueueNDRangeKernel failed");
+        error = clWaitForEvents(1, &event);
+        test_error(error, "clWaitForEvents failed");
+
+        double ns;
+        error = get_event_duration_ns(event, &ns);
+        if (error != CL_SUCCESS) return error;
+        // Bytes per nanosecond is GB/s
+        *gbps = ns > 0 ? bytes / ns : 0.0;
+        return CL_SUCCESS;
+    }
+};
+
+} // anonymous namespace
+
+static const char *kKernelNames[2][2] = {
+    { "global_to_local_async", "global_to_local_manual" },
+    { "local_to_global_async", "local_to_global_manual" }
+};
+
+int test_async_copy_bandwidth(cl_device_id device, cl_context context,
+                              cl_command_queue queue, int num_elements)
+{
+    int error;
+    clCommandQueueWrapper profiling_queue = clCreateCommandQueue(
+        context, device, CL_QUEUE_PROFILING_ENABLE, &error);
+    test_error(error, "Unable to create profiling queue");
+
+    cl_ulong max_alloc;
+    AsyncCopyBench bench;
+    error = clGetDeviceInfo(device, CL_DEVICE_MAX_MEM_ALLOC_SIZE,
+                            sizeof(max_alloc), &max_alloc, NULL);
+    test_error(error, "Unable to get CL_DEVICE_MAX_MEM_ALLOC_SIZE");
+    error = clGetDeviceInfo(device, CL_DEVICE_LOCAL_MEM_SIZE,
+                            sizeof(bench.local_mem), &bench.local_mem, NULL);
+    test_error(error, "Unable to get CL_DEVICE_LOCAL_MEM_SIZE");
+
+    bench.queue = profiling_queue;
+    // The strided side spans up to the largest stride times the bytes moved
+    bench.max_bytes = (size_t)std::min(
+        (cl_ulong)kBytesPerKernel * kStrides[ARRAY_SIZE(kStrides) - 1],
+        max_alloc / 2);
+    bench.src = clCreateBuffer(context, CL_MEM_READ_WRITE, bench.max_bytes,
+                               NULL, &error);
+    test_error(error, "clCreateBuffer failed");
+    bench.dst = clCreateBuffer(context, CL_MEM_READ_WRITE, bench.max_bytes,
+                               NULL, &error);
+    test_error(error, "clCreateBuffer failed");
+    cl_uint zero = 0;
+    error = clEnqueueFillBuffer(queue, bench.src, &zero, sizeof(zero), 0,
+                                bench.max_bytes, 0, NULL, NULL);
+    test_error(error, "clEnqueueFillBuffer failed");
+    error = clFinish(queue);
+    test_error(error, "clFinish failed");
+
+    BenchmarkOptions bench_options;
+    bench_options.warmup = 1;
+    bench_options.maxSeconds = 1.0;
+
+    log_benchmark_header("async_copy", "kernel/type/stride/wg_size");
+
+    for (size_t t = 0; t < ARRAY_SIZE(kElementTypes); t++)
+    {
+        CopyKernels copy;
+        std::string options = std::string("-DT=") + kElementTypes[t];
+        error = create_single_kernel_helper(
+            context, &copy.program, &copy.kernels[0][0], 1,
+            &async_copy_bandwidth_kernels, kKernelNames[0][0],
+            options.c_str());
+        test_error(error, "Unable to create the async copy kernels");
+        for (int d = 0; d < 2; d++)
+        {
+            for (int m = 0; m < 2; m++)
+            {
+                if (d == 0 && m == 0) continue;
+                copy.kernels[d][m] =
+                    clCreateKernel(copy.program, kKernelNames[d][m], &error);
+                test_error(error, "clCreateKernel failed");
+            }
+        }
+
+        size_t max_wg_size = SIZE_MAX;
+        for (int d = 0; d < 2; d++)
+        {
+            for (int m = 0; m < 2; m++)
+            {
+                size_t kernel_wg_size;
+                error = clGetKernelWorkGroupInfo(
+                    copy.kernels[d][m], device, CL_KERNEL_WORK_GROUP_SIZE,
+                    sizeof(kernel_wg_size), &kernel_wg_size, NULL);
+                test_error(error, "clGetKernelWorkGroupInfo failed");
+                max_wg_size = std::min(max_wg_size, kernel_wg_size);
+            }
+        }
+
+        size_t element_size = kElementSizes[t];
+        for (size_t wg_size : kWorkGroupSizes)
+        {
+            if (wg_size > max_wg_size) break;
+
+            // Leave room in local memory for whatever the compiler needs
+            int copies_per_item = (int)std::min(
+                (cl_ulong)kCopiesPerItem,
+                bench.local_mem / 2 / (wg_size * element_size));
+            if (copies_per_item == 0) break;
+            size_t group_bytes = wg_size * copies_per_item * element_size;
+
+            for (int stride : kStrides)
+            {
+                size_t groups =
+                    std::min(kBytesPerKernel, bench.max_bytes / stride)
+                    / group_bytes;
+                if (groups == 0) continue;
+
+                for (int d = 0; d < 2; d++)
+                {
+                    for (int m = 0; m < 2; m++)
+                    {
+                        cl_kernel kernel = copy.kernels[d][m];
+                        BenchmarkStats stats;
+                        error = bench.SetArgs(kernel, element_size, wg_size,
+                                              copies_per_item, stride);
+                        if (error == CL_SUCCESS)
+                            error = run_benchmark(
+                                bench_options,
+                                [&](double *gbps) {
+                                    return bench.Sample(
+                                        kernel, groups, wg_size,
+                                        (double)groups * group_bytes, gbps);
+                                },
+                                &stats);
+                        if (error != CL_SUCCESS)
+                        {
+                            log_error("ERROR: Unable to measure %s\n",
+                                      kKernelNames[d][m]);
+                            return TEST_FAIL;
+                        }
+                        std::string label = std::string(kKernelNames[d][m])
+                            + "/" + kElementTypes[t] + "/"
+                            + std::to_string(stride) + "/"
+                            + std::to_string(wg_size);
+                        log_benchmark_stats("async_copy", label.c_str(),
+                                            "GB/s", true, stats);
+                    }
+                }
+            }
+        }
+    }
+
+    return 0;
+}
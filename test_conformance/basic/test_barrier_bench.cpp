@@ -0,0 +1,314 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "harness/compat.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "harness/kernelClock.h"
+#include "harness/benchmark.h"
+#include "harness/perfMetrics.h"
+#include "procs.h"
+
+// Cost of a barrier or fence per call, at every power-of-two work-group
+// size: work-group barriers with local, global and both fences, mem_fence on
+// its own, and sub-group barriers where the device has sub-groups. Each
+// kernel runs the same loop of local memory reads with one barrier or fence
+// per step, and the cost is its time over the loop without one. The
+// NDRange time from queue profiling gives the cost per step of the whole
+// launch; the kernel clock, where the device has one, gives the cost per
+// barrier inside a single work-group in clock ticks. A benchmark, so it only
+// runs when named.
+
+static const char *barrier_bench_kernel = R"(
+    #ifdef KHR_SUBGROUPS
+    #pragma OPENCL EXTENSION cl_khr_subgroups : enable
+    #endif
+
+    __kernel void barrier_cost(__global uint *dst, __local uint *tile,
+                               int iterations, __global uint2 *clocks)
+    {
+        KERNEL_CLOCK_BEGIN();
+        uint lid = get_local_id(0);
+        uint mask = get_local_size(0) - 1;
+        tile[lid] = lid;
+        barrier(CLK_LOCAL_MEM_FENCE);
+
+        uint acc = lid;
+        for (int i = 0; i < iterations; i++)
+        {
+    #if VARIANT == 1
+            barrier(CLK_LOCAL_MEM_FENCE);
+    #elif VARIANT == 2
+            barrier(CLK_GLOBAL_MEM_FENCE);
+    #elif VARIANT == 3
+            barrier(CLK_LOCAL_MEM_FENCE | CLK_GLOBAL_MEM_FENCE);
+    #elif VARIANT == 4
+            mem_fence(CLK_LOCAL_MEM_FENCE);
+    #elif VARIANT == 5
+            mem_fence(CLK_GLOBAL_MEM_FENCE);
+    #elif VARIANT == 6
+            sub_group_barrier(CLK_LOCAL_MEM_FENCE);
+    #endif
+            acc += tile[(lid + i) & mask];
+        }
+        dst[get_global_id(0)] = acc;
+        KERNEL_CLOCK_END(clocks);
+    }
+)";
+
+namespace {
+
+// Indexed by the VARIANT the kernel is built with
+const char *kBarrierVariants[] = {
+    "none",
+    "barrier_local",
+    "barrier_global",
+    "barrier_local_global",
+    "mem_fence_local",
+    "mem_fence_global",
+    "sub_group_barrier_local",
+};
+const int kSubGroupVariant = 6;
+
+const size_t kMaxLocalSize = 1024;
+const size_t kGroupsPerUnit = 8;
+const int kIterations = 1024;
+
+struct BarrierKernel
+{
+    clProgramWrapper program;
+    clKernelWrapper kernel;
+    size_t max_local;
+};
+
+int build_barrier_kernel(cl_device_id device, cl_context context,
+                         const KernelClockProbe &probe, int variant,
+                         bool khr_subgroups, BarrierKernel &out)
+{
+    std::string options = "-DVARIANT=" + std::to_string(variant);
+    if (khr_subgroups) options += " -DKHR_SUBGROUPS";
+    const char *sources[] = { probe.source(), barrier_bench_kernel };
+    int error = create_single_kernel_helper(
+        context, &out.program, &out.kernel, ARRAY_SIZE(sources), sources,
+        "barrier_cost", options.c_str());
+    test_error(error, "Unable to create the barrier kernel");
+
+    error = clGetKernelWorkGroupInfo(out.kernel, device,
+                                     CL_KERNEL_WORK_GROUP_SIZE,
+                                     sizeof(out.max_local), &out.max_local,
+                                     NULL);
+    test_error(error, "clGetKernelWorkGroupInfo failed");
+    out.max_local = std::min(out.max_local, kMaxLocalSize);
+    return CL_SUCCESS;
+}
+
+struct BarrierBench
+{
+    cl_command_queue queue;
+    clMemWrapper dst;
+    KernelClockProbe *probe;
+    std::vector<cl_uint> results;
+    BenchmarkOptions options;
+
+    // Device time of the runs in microseconds, and the median work-group
+    // duration of the last run in kernel clock ticks, 0 without a kernel
+    // clock
+    int Time(const BarrierKernel &kernel, const char *name, size_t global,
+             size_t local, BenchmarkStats &stats, double &ticks)
+    {
+        size_t groups = global / local;
+        cl_mem clocks = NULL;
+        if (probe->supported())
+        {
+            int error = probe->prepare(queue, groups);
+            if (error != CL_SUCCESS) return TEST_FAIL;
+            clocks = probe->buffer();
+        }
+
+        int error = clSetKernelArg(kernel.kernel, 0, sizeof(cl_mem), &dst);
+        error |= clSetKernelArg(kernel.kernel, 1, local * sizeof(cl_uint),
+                                NULL);
+        error |= clSetKernelArg(kernel.kernel, 2, sizeof(kIterations),
+                                &kIterations);
+        error |= clSetKernelArg(kernel.kernel, 3, sizeof(clocks), &clocks);
+        test_error(error, "clSetKernelArg failed");
+
+        error = run_benchmark(
+            options,
+            [&](double *us) {
+                clEventWrapper event;
+                cl_int err = clEnqueueNDRangeKernel(queue, kernel.kernel, 1,
+                                                    NULL, &global, &local, 0,
+                                                    NULL, &event);
+                test_error(err, "clEnqueueNDRangeKernel failed");
+                err = clWaitForEvents(1, &event);
+                test_error(err, "clWaitForEvents failed");
+                double ns;
+                err = get_event_duration_ns(event, &ns);
+                *us = ns / 1e3;
+                return err;
+            },
+            &stats);
+        if (error != CL_SUCCESS) return TEST_FAIL;
+
+        ticks = 0;
+        if (probe->supported())
+        {
+            KernelClockStats clock_stats;
+            error = probe->collect(queue, &clock_stats);
+            if (error != CL_SUCCESS) return TEST_FAIL;
+            ticks = (double)clock_stats.medianDuration;
+        }
+
+        return Check(name, global, local);
+    }
+
+    // Each work-item adds kIterations consecutive tile entries, starting
+    // at its own, to its local id
+    int Check(const char *name, size_t global, size_t local)
+    {
+        int error = clEnqueueReadBuffer(queue, dst, CL_TRUE, 0,
+                                        global * sizeof(cl_uint),
+                                        results.data(), 0, NULL, NULL);
+        test_error(error, "clEnqueueReadBuffer failed");
+
+        std::vector<cl_uint> expected(local);
+        for (size_t lid = 0; lid < local; lid++)
+        {
+            expected[lid] = (cl_uint)lid;
+            for (int n = 0; n < kIterations; n++)
+                expected[lid] += (cl_uint)((lid + n) & (local - 1));
+        }
+        for (size_t i = 0; i < global; i++)
+        {
+            if (results[i] != expected[i % local])
+            {
+                log_error("ERROR: %s work-item %zu of a %zu work-item group "
+                          "computed %u, expected %u\n",
+                          name, i, local, results[i], expected[i % local]);
+                return TEST_FAIL;
+            }
+        }
+        return CL_SUCCESS;
+    }
+};
+
+} // anonymous namespace
+
+int test_barrier_bench(cl_device_id device, cl_context context,
+                       cl_command_queue queue, int num_elements)
+{
+    int error;
+    cl_uint units;
+    error = clGetDeviceInfo(device, CL_DEVICE_MAX_COMPUTE_UNITS, sizeof(units),
+                            &units, NULL);
+    test_error(error, "Unable to get CL_DEVICE_MAX_COMPUTE_UNITS");
+
+    // Sub-groups come from cl_khr_subgroups, or are core from 2.1 on and
+    // optional again from 3.0 on
+    bool khr_subgroups = is_extension_available(device, "cl_khr_subgroups");
+    bool sub_groups = khr_subgroups;
+    if (!sub_groups && get_device_cl_version(device) >= Version(2, 1))
+    {
+        cl_uint max_sub_groups = 0;
+        error = clGetDeviceInfo(device, CL_DEVICE_MAX_NUM_SUB_GROUPS,
+                                sizeof(max_sub_groups), &max_sub_groups, NULL);
+        test_error(error, "Unable to get CL_DEVICE_MAX_NUM_SUB_GROUPS");
+        sub_groups = max_sub_groups > 0;
+    }
+
+    KernelClockProbe probe(device, context);
+    if (probe.supported())
+        log_info("Timing work-groups with the %s scope clock.\n",
+                 probe.scope_name());
+
+    int variants = (int)ARRAY_SIZE(kBarrierVariants);
+    if (!sub_groups)
+    {
+        log_info("The device has no sub-groups, skipping "
+                 "sub_group_barrier\n");
+        variants = kSubGroupVariant;
+    }
+    std::vector<BarrierKernel> kernels(variants);
+    for (int v = 0; v < variants; v++)
+    {
+        error = build_barrier_kernel(device, context, probe, v, khr_subgroups,
+                                     kernels[v]);
+        if (error != CL_SUCCESS) return TEST_FAIL;
+    }
+
+    BarrierBench bench;
+    clCommandQueueWrapper profiling_queue = clCreateCommandQueue(
+        context, device, CL_QUEUE_PROFILING_ENABLE, &error);
+    test_error(error, "Unable to create profiling queue");
+    bench.queue = profiling_queue;
+    bench.probe = &probe;
+    bench.options.warmup = 1;
+    bench.options.maxSeconds = 1.0;
+
+    size_t groups = units * kGroupsPerUnit;
+    bench.results.resize(groups * kernels[0].max_local);
+    bench.dst = clCreateBuffer(context, CL_MEM_WRITE_ONLY,
+                               bench.results.size() * sizeof(cl_uint), NULL,
+                               &error);
+    test_error(error, "clCreateBuffer failed");
+
+    // The cost of each barrier or fence is its kernel's time over the one
+    // without, per step of the loop
+    log_benchmark_header("barrier", "wg_size/variant");
+    for (size_t local = 1; local <= kernels[0].max_local; local *= 2)
+    {
+        size_t global = local * groups;
+        BenchmarkStats none_stats;
+        double none_ticks;
+        error = bench.Time(kernels[0], kBarrierVariants[0], global, local,
+                           none_stats, none_ticks);
+        if (error != CL_SUCCESS) return TEST_FAIL;
+        std::string none_label =
+            std::to_string(local) + "/" + kBarrierVariants[0];
+        log_benchmark_stats("barrier", none_label.c_str(), "us", false,
+                            none_stats);
+
+        for (int v = 1; v < variants; v++)
+        {
+            if (local > kernels[v].max_local) continue;
+
+            BenchmarkStats stats;
+            double ticks;
+            error = bench.Time(kernels[v], kBarrierVariants[v], global, local,
+                               stats, ticks);
+            if (error != CL_SUCCESS) return TEST_FAIL;
+            std::string label =
+                std::to_string(local) + "/" + kBarrierVariants[v];
+            log_benchmark_stats("barrier", label.c_str(), "us", false, stats);
+            record_perf_metric("barrier_ns_per_step." + label,
+                               (stats.median - none_stats.median) * 1e3
+                                   / kIterations,
+                               "ns", false);
+            if (probe.supported())
+                record_perf_metric("barrier_ticks_per_call." + label,
+                                   (ticks - none_ticks) / kIterations, "ticks",
+                                   false);
+        }
+    }
+
+    return 0;
+}
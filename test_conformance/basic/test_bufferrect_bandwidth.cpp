@@ -0,0 +1,352 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "harness/compat.h"
+#include "harness/benchmark.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "procs.h"
+
+// Bandwidth of rectangular copies over the row widths, pitches, origin
+// alignments and slice counts that 2D tiling code uses. Slow driver paths
+// tend to be specific to a pitch, so the results are also printed as a
+// width by pitch grid for each copy. A benchmark, so it only runs when named.
+
+static const size_t kRowWidths[] = { 60, 64, 256, 1020, 1024, 4096 };
+static const size_t kOriginOffsets[] = { 0, 1, 4, 16 };
+static const size_t kSliceCounts[] = { 1, 4 };
+// Each copy moves about this many bytes, so launch overhead doesn't hide
+// the copy rate
+static const size_t kBytesPerCopy = 16 << 20;
+
+// The pitches are the row width plus padding of one of these kinds
+enum PitchKind
+{
+    kPitchPacked,
+    kPitchPlus4,
+    kPitchAlign64,
+    kPitchAlign256,
+    kPitchAlign4096,
+    kNumPitchKinds
+};
+
+static const char *kPitchNames[kNumPitchKinds] = { "packed", "plus4", "align64",
+                                                   "align256", "align4096" };
+
+static size_t get_pitch(size_t width, int kind)
+{
+    switch (kind)
+    {
+        case kPitchPlus4: return width + 4;
+        case kPitchAlign64: return (width + 63) & ~(size_t)63;
+        case kPitchAlign256: return (width + 255) & ~(size_t)255;
+        case kPitchAlign4096: return (width + 4095) & ~(size_t)4095;
+        default: return width;
+    }
+}
+
+enum RectCommand
+{
+    kCopyBufferRect,
+    kReadBufferRect,
+    kCopyImageToBuffer,
+    kNumRectCommands
+};
+
+static const char *kRectCommandNames[kNumRectCommands] = {
+    "copy_buffer_rect", "read_buffer_rect", "copy_image_to_buffer"
+};
+
+namespace {
+
+struct RectShape
+{
+    size_t width; // bytes per row
+    size_t pitch; // bytes between rows of the strided side
+    size_t offset; // bytes before the first row of the strided side
+    size_t rows;
+    size_t slices;
+
+    size_t packed_size() const { return width * rows * slices; }
+    size_t strided_size() const { return offset + pitch * rows * slices; }
+};
+
+struct RectBench
+{
+    cl_context context;
+    cl_device_id device;
+    cl_command_queue queue;
+    size_t max_bytes;
+    bool images;
+    std::vector<char> host;
+    BenchmarkOptions options;
+
+    // Medians of the device time of one copy, in GB/s
+    double gbps[kNumRectCommands][ARRAY_SIZE(kSliceCounts)]
+               [ARRAY_SIZE(kOriginOffsets)][ARRAY_SIZE(kRowWidths)]
+               [kNumPitchKinds];
+
+    int EnqueueCommand(RectCommand command, const RectShape &shape,
+                       cl_mem strided, cl_mem packed, cl_mem image,
+                       cl_event *event)
+    {
+        switch (command)
+        {
+            case kCopyBufferRect: {
+                // Gather the strided rows into a packed buffer
+                size_t src_origin[3] = { shape.offset, 0, 0 };
+                size_t dst_origin[3] = { 0, 0, 0 };
+                size_t region[3] = { shape.width, shape.rows, shape.slices };
+                return clEnqueueCopyBufferRect(
+                    queue, strided, packed, src_origin, dst_origin, region,
+                    shape.pitch, shape.pitch * shape.rows, shape.width,
+                    shape.width * shape.rows, 0, NULL, event);
+            }
+            case kReadBufferRect: {
+                size_t buffer_origin[3] = { shape.offset, 0, 0 };
+                size_t host_origin[3] = { 0, 0, 0 };
+                size_t region[3] = { shape.width, shape.rows, shape.slices };
+                return clEnqueueReadBufferRect(
+                    queue, strided, CL_TRUE, buffer_origin, host_origin,
+                    region, shape.pitch, shape.pitch * shape.rows,
+                    shape.width, shape.width * shape.rows, host.data(), 0,
+                    NULL, event);
+            }
+            case kCopyImageToBuffer: {
+                // The image rows are laid out by the driver, so the pitch
+                // only applies to the buffer side, which the offset
+                // misaligns
+                size_t origin[3] = { 0, 0, 0 };
+                size_t region[3] = { shape.width / 4, shape.rows,
+                                     shape.slices };
+                return clEnqueueCopyImageToBuffer(queue, image, strided,
+                                                  origin, region, shape.offset,
+                                                  0, NULL, event);
+            }
+            default: return CL_INVALID_VALUE;
+        }
+    }
+
+    int CreateImage(const RectShape &shape, clMemWrapper &image)
+    {
+        cl_image_format format = { CL_RGBA, CL_UNSIGNED_INT8 };
+        cl_image_desc desc = { 0 };
+        desc.image_type = shape.slices > 1 ? CL_MEM_OBJECT_IMAGE3D
+                                           : CL_MEM_OBJECT_IMAGE2D;
+        desc.image_width = shape.width / 4;
+        desc.image_height = shape.rows;
+        desc.image_depth = shape.slices > 1 ? shape.slices : 0;
+
+        cl_int error;
+        image = clCreateImage(context, CL_MEM_READ_WRITE, &format, &desc, NULL,
+                              &error);
+        test_error(error, "clCreateImage failed");
+        return CL_SUCCESS;
+    }
+
+    int Measure(RectCommand command, const RectShape &shape,
+                BenchmarkStats &stats)
+    {
+        cl_int error;
+        clMemWrapper strided = clCreateBuffer(
+            context, CL_MEM_READ_WRITE, shape.strided_size(), NULL, &error);
+        test_error(error, "clCreateBuffer failed");
+        clMemWrapper packed = clCreateBuffer(
+            context, CL_MEM_READ_WRITE, shape.packed_size(), NULL, &error);
+        test_error(error, "clCreateBuffer failed");
+
+        clMemWrapper image;
+        if (command == kCopyImageToBuffer)
+        {
+            error = CreateImage(shape, image);
+            if (error != CL_SUCCESS) return error;
+        }
+
+        return run_benchmark(
+            options,
+            [&](double *gbps) {
+                clEventWrapper event;
+                cl_int error = EnqueueCommand(command, shape, strided, packed,
+                                              image, &event);
+                test_error(error, "Unable to enqueue rectangular copy");
+                error = clWaitForEvents(1, &event);
+                test_error(error, "clWaitForEvents failed");
+
+                double ns;
+                error = get_event_duration_ns(event, &ns);
+                if (error != CL_SUCCESS) return error;
+                // Bytes per nanosecond is GB/s
+                *gbps = ns > 0 ? shape.packed_size() / ns : 0.0;
+                return CL_SUCCESS;
+            },
+            &stats);
+    }
+
+    void PrintGrid(RectCommand command, size_t slice, size_t offset)
+    {
+        log_info("%s GB/s, %zu slice(s), origin offset %zu:\n",
+                 kRectCommandNames[command], kSliceCounts[slice],
+                 kOriginOffsets[offset]);
+
+        int pitches = command == kCopyImageToBuffer ? 1 : kNumPitchKinds;
+        std::string line = "  width";
+        for (int p = 0; p < pitches; p++)
+        {
+            char cell[16];
+            snprintf(cell, sizeof(cell), "%10s", kPitchNames[p]);
+            line += cell;
+        }
+        log_info("%s\n", line.c_str());
+
+        for (size_t w = 0; w < ARRAY_SIZE(kRowWidths); w++)
+        {
+            char cell[16];
+            snprintf(cell, sizeof(cell), "%7zu", kRowWidths[w]);
+            line = cell;
+            for (int p = 0; p < pitches; p++)
+            {
+                snprintf(cell, sizeof(cell), "%10.2f",
+                         gbps[command][slice][offset][w][p]);
+                line += cell;
+            }
+            log_info("%s\n", line.c_str());
+        }
+    }
+};
+
+} // anonymous namespace
+
+int test_bufferrect_bandwidth(cl_device_id device, cl_context context,
+                              cl_command_queue queue, int num_elements)
+{
+    int error;
+    clCommandQueueWrapper profiling_queue = clCreateCommandQueue(
+        context, device, CL_QUEUE_PROFILING_ENABLE, &error);
+    test_error(error, "Unable to create profiling queue");
+
+    cl_ulong max_alloc;
+    error = clGetDeviceInfo(device, CL_DEVICE_MAX_MEM_ALLOC_SIZE,
+                            sizeof(max_alloc), &max_alloc, NULL);
+    test_error(error, "Unable to get CL_DEVICE_MAX_MEM_ALLOC_SIZE");
+
+    RectBench bench;
+    bench.context = context;
+    bench.device = device;
+    bench.queue = profiling_queue;
+    bench.max_bytes = (size_t)std::min((cl_ulong)kBytesPerCopy, max_alloc / 4);
+    bench.images = checkForImageSupport(device) == 0;
+    bench.host.resize(bench.max_bytes);
+    bench.options.warmup = 1;
+    bench.options.maxSeconds = 1.0;
+    if (!bench.images)
+        log_info("Device doesn't support images, skipping image to buffer "
+                 "copies.\n");
+
+    // Image copies are limited to the image sizes the device supports
+    size_t max_2d[2] = { 0, 0 }, max_3d[3] = { 0, 0, 0 };
+    if (bench.images)
+    {
+        const cl_device_info params[5] = {
+            CL_DEVICE_IMAGE2D_MAX_WIDTH, CL_DEVICE_IMAGE2D_MAX_HEIGHT,
+            CL_DEVICE_IMAGE3D_MAX_WIDTH, CL_DEVICE_IMAGE3D_MAX_HEIGHT,
+            CL_DEVICE_IMAGE3D_MAX_DEPTH
+        };
+        size_t *values[5] = { &max_2d[0], &max_2d[1], &max_3d[0], &max_3d[1],
+                              &max_3d[2] };
+        for (int i = 0; i < 5; i++)
+        {
+            error = clGetDeviceInfo(device, params[i], sizeof(size_t),
+                                    values[i], NULL);
+            test_error(error, "Unable to get the maximum image sizes");
+        }
+    }
+
+    log_benchmark_header("bufferrect", "command/width/pitch/offset/slices");
+    for (int c = 0; c < kNumRectCommands; c++)
+    {
+        RectCommand command = (RectCommand)c;
+        if (command == kCopyImageToBuffer && !bench.images) continue;
+
+        for (size_t s = 0; s < ARRAY_SIZE(kSliceCounts); s++)
+        {
+            for (size_t o = 0; o < ARRAY_SIZE(kOriginOffsets); o++)
+            {
+                for (size_t w = 0; w < ARRAY_SIZE(kRowWidths); w++)
+                {
+                    for (int p = 0; p < kNumPitchKinds; p++)
+                    {
+                        double &result = bench.gbps[c][s][o][w][p];
+                        result = 0.0;
+
+                        RectShape shape;
+                        shape.width = kRowWidths[w];
+                        shape.pitch = get_pitch(shape.width, p);
+                        shape.offset = kOriginOffsets[o];
+                        shape.slices = kSliceCounts[s];
+                        shape.rows = std::max(
+                            (size_t)1,
+                            bench.max_bytes / (shape.pitch * shape.slices));
+
+                        // Images take their width in RGBA8 pixels, and
+                        // have no pitch to vary
+                        if (command == kCopyImageToBuffer)
+                        {
+                            if (p != kPitchPacked || shape.width % 4) continue;
+                            const size_t *max_size =
+                                shape.slices > 1 ? max_3d : max_2d;
+                            if (shape.width / 4 > max_size[0]) continue;
+                            if (shape.slices > 1 && shape.slices > max_3d[2])
+                                continue;
+                            shape.rows = std::min(shape.rows, max_size[1]);
+                        }
+
+                        BenchmarkStats stats;
+                        error = bench.Measure(command, shape, stats);
+                        if (error != CL_SUCCESS)
+                        {
+                            log_error("ERROR: Unable to measure %s\n",
+                                      kRectCommandNames[c]);
+                            return TEST_FAIL;
+                        }
+                        result = stats.median;
+                        std::string label = std::string(kRectCommandNames[c])
+                            + "/" + std::to_string(shape.width) + "/"
+                            + std::to_string(shape.pitch) + "/"
+                            + std::to_string(shape.offset) + "/"
+                            + std::to_string(shape.slices);
+                        log_benchmark_stats("bufferrect", label.c_str(),
+                                            "GB/s", true, stats);
+                    }
+                }
+            }
+        }
+    }
+
+    for (int c = 0; c < kNumRectCommands; c++)
+    {
+        if (c == kCopyImageToBuffer && !bench.images) continue;
+        for (size_t s = 0; s < ARRAY_SIZE(kSliceCounts); s++)
+            for (size_t o = 0; o < ARRAY_SIZE(kOriginOffsets); o++)
+                bench.PrintGrid((RectCommand)c, s, o);
+    }
+
+    return 0;
+}
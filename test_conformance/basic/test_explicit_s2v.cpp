@@ -118,7 +118,6 @@ int test_explicit_s2v_function(cl_context context, cl_command_queue queue,
     int error;
     clMemWrapper streams[2];
     size_t threadSize[3], groupSize[3];
-    unsigned char convertedData[8]; /* Max type size is 8 bytes */
     unsigned int i, s;
     unsigned char *inPtr, *outPtr;
     size_t paramSize, destTypeSize;
@@ -128,6 +127,7 @@ int test_explicit_s2v_function(cl_context context, cl_command_queue queue,
 
     size_t destStride = destTypeSize * vecSize;
     std::vector<char> outData(destStride * count);
+    std::vector<unsigned char> convertedData(destTypeSize * count);
 
     streams[0] = clCreateBuffer(context, CL_MEM_COPY_HOST_PTR,
                                 paramSize * count, inputData, &error);
@@ -158,18 +158,21 @@ int test_explicit_s2v_function(cl_context context, cl_command_queue queue,
                             outData.data(), 0, NULL, NULL);
     test_error( error, "Unable to read output values!" );
 
+    /* Convert the input data to our output data type to compare against */
+    convert_explicit_array(inputData, convertedData.data(), count, srcType,
+                           false, kDefaultRoundingType, destType);
+
     inPtr = (unsigned char *)inputData;
     outPtr = (unsigned char *)outData.data();
 
     for( i = 0; i < count; i++ )
     {
-        /* Convert the input data element to our output data type to compare against */
-        convert_explicit_value( (void *)inPtr, (void *)convertedData, srcType, false, kDefaultRoundingType, destType );
+        const unsigned char *expected = convertedData.data() + destTypeSize * i;
 
         /* Now compare every element of the vector */
         for( s = 0; s < vecSize; s++ )
         {
-            if( memcmp( convertedData, outPtr + destTypeSize * s, destTypeSize ) != 0 )
+            if( memcmp( expected, outPtr + destTypeSize * s, destTypeSize ) != 0 )
             {
                 bool isSrcNaN =
                     (((srcType == kHalf)
@@ -68,6 +68,10 @@ test_get_linear_ids(cl_device_id device, cl_context context, cl_command_queue qu
     outbuf = clCreateBuffer(context, CL_MEM_READ_WRITE, sizeof(outmem), NULL, &error);
     test_error(error, "failed to create result buffer\n");
 
+    KernelLaunchInfo launchInfo;
+    error = get_kernel_launch_info(context, kernel, &launchInfo);
+    test_error(error, "Unable to get kernel work group limits");
+
     // This will leak if there is an error, but this is what is done everywhere else
     MTdata seed = init_genrand(gRandomSeed);
 
@@ -79,14 +83,14 @@ test_get_linear_ids(cl_device_id device, cl_context context, cl_command_queue qu
         case 1:
             gwo[0] = random_in_range(0, MAX_OFFSET, seed);
             gws[0] = random_in_range(MAX_1D/8, MAX_1D/4, seed)*4;
-            error = get_max_common_work_group_size(context, kernel, gws[0], lws);
+            error = get_max_common_work_group_size(launchInfo, gws[0], lws);
             break;
         case 2:
             gwo[0] = random_in_range(0, MAX_OFFSET, seed);
             gwo[1] = random_in_range(0, MAX_OFFSET, seed);
             gws[0] = random_in_range(MAX_2D/8, MAX_2D/4, seed)*4;
             gws[1] = random_in_range(MAX_2D/8, MAX_2D/4, seed)*4;
-            error = get_max_common_2D_work_group_size(context, kernel, gws, lws);
+            error = get_max_common_2D_work_group_size(launchInfo, gws, lws);
             break;
         case 3:
             gwo[0] = random_in_range(0, MAX_OFFSET, seed);
@@ -95,7 +99,7 @@ test_get_linear_ids(cl_device_id device, cl_context context, cl_command_queue qu
             gws[0] = random_in_range(MAX_3D/4, MAX_3D/2, seed)*2;
             gws[1] = random_in_range(MAX_3D/4, MAX_3D/2, seed)*2;
             gws[2] = random_in_range(MAX_3D/4, MAX_3D/2, seed)*2;
-            error = get_max_common_3D_work_group_size(context, kernel, gws, lws);
+            error = get_max_common_3D_work_group_size(launchInfo, gws, lws);
             break;
         }
 
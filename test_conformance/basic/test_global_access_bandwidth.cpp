@@ -0,0 +1,249 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "harness/compat.h"
+#include "harness/stringHelpers.h"
+#include "harness/benchmark.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "procs.h"
+
+// Global memory read and write bandwidth of vloadn/vstoren over vector
+// widths, misaligning the base pointer by a few elements and spacing the
+// vectors of neighbouring work-items further apart, so that the best width
+// for a device and the cost of uncoalesced or misaligned access can be read
+// off one table. The kernels are generated the way the vload and vstore
+// tests generate theirs. A benchmark, so it only runs when named.
+
+static const int kVectorWidths[] = { 1, 2, 3, 4, 8, 16 };
+// In uints from a vector-aligned base
+static const cl_uint kAlignmentOffsets[] = { 0, 1, 4 };
+// In vectors between neighbouring work-items
+static const cl_uint kStrides[] = { 1, 2, 4, 8, 32 };
+static const int kAccessesPerItem = 16;
+// Bytes each kernel reads or writes at stride 1
+static const size_t kBytesPerKernel = (size_t)64 << 20;
+static const size_t kMaxBufferBytes = (size_t)512 << 20;
+
+// clang-format off
+static const char *read_pattern[] = {
+"__kernel void global_read( __global uint *src, __global %s *dst, uint alignmentOffset, uint stride )\n"
+"{\n"
+"    size_t tid = get_global_id( 0 );\n"
+"    size_t count = get_global_size( 0 );\n"
+"    __global uint *base = src + alignmentOffset;\n"
+"    %s acc = 0;\n"
+"    for( int i = 0; i < %d; i++ )\n"
+"    {\n"
+"        size_t index = ( i * count + tid ) * stride;\n"
+"        acc += %s;\n"
+"    }\n"
+"    dst[ tid ] = acc;\n"
+"}\n" };
+
+static const char *write_pattern[] = {
+"__kernel void global_write( __global uint *dst, uint alignmentOffset, uint stride )\n"
+"{\n"
+"    size_t tid = get_global_id( 0 );\n"
+"    size_t count = get_global_size( 0 );\n"
+"    __global uint *base = dst + alignmentOffset;\n"
+"    for( int i = 0; i < %d; i++ )\n"
+"    {\n"
+"        size_t index = ( i * count + tid ) * stride;\n"
+"        %s;\n"
+"    }\n"
+"}\n" };
+// clang-format on
+
+static void create_global_access_code(std::string &readSource,
+                                      std::string &writeSource, int width)
+{
+    std::string typeName = "uint";
+    std::string load = "base[ index ]";
+    std::string store = "base[ index ] = (uint)( tid + i )";
+    if (width > 1)
+    {
+        typeName = str_sprintf("uint%d", width);
+        load = str_sprintf("vload%d( index, base )", width);
+        store = str_sprintf("vstore%d( (uint%d)( tid + i ), index, base )",
+                            width, width);
+    }
+
+    std::string src = concat_kernel(
+        read_pattern, sizeof(read_pattern) / sizeof(read_pattern[0]));
+    readSource = str_sprintf(src, typeName.c_str(), typeName.c_str(),
+                             kAccessesPerItem, load.c_str());
+    src = concat_kernel(write_pattern,
+                        sizeof(write_pattern) / sizeof(write_pattern[0]));
+    writeSource = str_sprintf(src, kAccessesPerItem, store.c_str());
+}
+
+// Device time of one run of the kernel, in GB/s of bytes moved
+static int sample_kernel(cl_command_queue queue, cl_kernel kernel,
+                         size_t global, double bytes, double *gbps)
+{
+    clEventWrapper event;
+    int error = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &global, NULL,
+                                       0, NULL, &event);
+    test_error(error, "clEnqueueNDRangeKernel failed");
+    error = clWaitForEvents(1, &event);
+    test_error(error, "clWaitForEvents failed");
+
+    double ns;
+    error = get_event_duration_ns(event, &ns);
+    if (error != CL_SUCCESS) return error;
+    // Bytes per nanosecond is GB/s
+    *gbps = ns > 0 ? bytes / ns : 0.0;
+    return CL_SUCCESS;
+}
+
+int test_global_access_bandwidth(cl_device_id device, cl_context context,
+                                 cl_command_queue queue, int num_elements)
+{
+    int error;
+    cl_ulong max_alloc;
+    error = clGetDeviceInfo(device, CL_DEVICE_MAX_MEM_ALLOC_SIZE,
+                            sizeof(max_alloc), &max_alloc, NULL);
+    test_error(error, "Unable to get CL_DEVICE_MAX_MEM_ALLOC_SIZE");
+    size_t buffer_bytes =
+        (size_t)std::min((cl_ulong)kMaxBufferBytes, max_alloc / 2);
+
+    clCommandQueueWrapper profiling_queue = clCreateCommandQueue(
+        context, device, CL_QUEUE_PROFILING_ENABLE, &error);
+    test_error(error, "Unable to create profiling queue");
+
+    clMemWrapper src = clCreateBuffer(context, CL_MEM_READ_WRITE, buffer_bytes,
+                                      NULL, &error);
+    test_error(error, "clCreateBuffer failed");
+    // One vector per work-item, with room for uint3 taking up a uint4
+    clMemWrapper dst = clCreateBuffer(context, CL_MEM_READ_WRITE,
+                                      2 * kBytesPerKernel / kAccessesPerItem,
+                                      NULL, &error);
+    test_error(error, "clCreateBuffer failed");
+    cl_uint zero = 0;
+    error = clEnqueueFillBuffer(queue, src, &zero, sizeof(zero), 0,
+                                buffer_bytes, 0, NULL, NULL);
+    test_error(error, "clEnqueueFillBuffer failed");
+    error = clFinish(queue);
+    test_error(error, "clFinish failed");
+
+    BenchmarkOptions options;
+    options.warmup = 1;
+    options.maxSeconds = 1.0;
+
+    log_benchmark_header("global_access", "access/width/alignment/stride");
+    std::vector<double> best_read(ARRAY_SIZE(kVectorWidths));
+    std::vector<double> best_write(ARRAY_SIZE(kVectorWidths));
+    for (size_t w = 0; w < ARRAY_SIZE(kVectorWidths); w++)
+    {
+        int width = kVectorWidths[w];
+        std::string read_source, write_source;
+        create_global_access_code(read_source, write_source, width);
+
+        clProgramWrapper read_program, write_program;
+        clKernelWrapper read_kernel, write_kernel;
+        const char *source = read_source.c_str();
+        error = create_single_kernel_helper(context, &read_program,
+                                            &read_kernel, 1, &source,
+                                            "global_read");
+        test_error(error, "Unable to create the global read kernel");
+        source = write_source.c_str();
+        error = create_single_kernel_helper(context, &write_program,
+                                            &write_kernel, 1, &source,
+                                            "global_write");
+        test_error(error, "Unable to create the global write kernel");
+
+        size_t vector_bytes = width * sizeof(cl_uint);
+        for (cl_uint alignment : kAlignmentOffsets)
+        {
+            for (cl_uint stride : kStrides)
+            {
+                // Each access moves one vector, and the furthest one is
+                // stride vectors past the previous one
+                size_t span = buffer_bytes - alignment * sizeof(cl_uint);
+                size_t global = std::min(
+                    kBytesPerKernel / (kAccessesPerItem * vector_bytes),
+                    span / (kAccessesPerItem * stride * vector_bytes));
+                if (global == 0) continue;
+
+                error = clSetKernelArg(read_kernel, 0, sizeof(cl_mem), &src);
+                error |= clSetKernelArg(read_kernel, 1, sizeof(cl_mem), &dst);
+                error |= clSetKernelArg(read_kernel, 2, sizeof(alignment),
+                                        &alignment);
+                error |=
+                    clSetKernelArg(read_kernel, 3, sizeof(stride), &stride);
+                error |= clSetKernelArg(write_kernel, 0, sizeof(cl_mem), &src);
+                error |= clSetKernelArg(write_kernel, 1, sizeof(alignment),
+                                        &alignment);
+                error |=
+                    clSetKernelArg(write_kernel, 2, sizeof(stride), &stride);
+                test_error(error, "clSetKernelArg failed");
+
+                double bytes = (double)global * kAccessesPerItem * vector_bytes;
+                std::string label = std::to_string(width) + "/"
+                    + std::to_string(alignment) + "/" + std::to_string(stride);
+                BenchmarkStats read_stats, write_stats;
+                error = run_benchmark(
+                    options,
+                    [&](double *gbps) {
+                        return sample_kernel(profiling_queue, read_kernel,
+                                             global, bytes, gbps);
+                    },
+                    &read_stats);
+                if (error != CL_SUCCESS) return TEST_FAIL;
+                log_benchmark_stats("global_access", ("read/" + label).c_str(),
+                                    "GB/s", true, read_stats);
+                error = run_benchmark(
+                    options,
+                    [&](double *gbps) {
+                        return sample_kernel(profiling_queue, write_kernel,
+                                             global, bytes, gbps);
+                    },
+                    &write_stats);
+                if (error != CL_SUCCESS) return TEST_FAIL;
+                log_benchmark_stats("global_access",
+                                    ("write/" + label).c_str(), "GB/s", true,
+                                    write_stats);
+                if (alignment == 0 && stride == 1)
+                {
+                    best_read[w] = read_stats.median;
+                    best_write[w] = write_stats.median;
+                }
+            }
+        }
+    }
+
+    // The aligned, coalesced case for each width against the best of them
+    double peak_read = *std::max_element(best_read.begin(), best_read.end());
+    double peak_write =
+        *std::max_element(best_write.begin(), best_write.end());
+    log_info("BENCH\troofline\twidth\tread_GBps\tread_vs_peak\twrite_GBps"
+             "\twrite_vs_peak\n");
+    for (size_t w = 0; w < ARRAY_SIZE(kVectorWidths); w++)
+    {
+        log_info("BENCH\troofline\t%d\t%.2f\t%.2f\t%.2f\t%.2f\n",
+                 kVectorWidths[w], best_read[w],
+                 peak_read > 0 ? best_read[w] / peak_read : 0.0, best_write[w],
+                 peak_write > 0 ? best_write[w] / peak_write : 0.0);
+    }
+
+    return 0;
+}
@@ -144,6 +144,10 @@ int test_global_work_offsets(cl_device_id deviceID, cl_context context, cl_comma
         test_error( error, "Unable to create output array" );
     }
 
+    KernelLaunchInfo launchInfo;
+    error = get_kernel_launch_info(context, kernel, &launchInfo);
+    test_error(error, "Unable to get kernel work group limits");
+
     // Run a few different times
     MTdata seed = init_genrand( gRandomSeed );
     for( int test = 0; test < NUM_TESTS; test++ )
@@ -154,7 +158,7 @@ int test_global_work_offsets(cl_device_id deviceID, cl_context context, cl_comma
         threads[ 2 ] = random_in_range( 1, MAX_TEST_ITEMS / (int)( threads[ 0 ] * threads[ 1 ] ), seed );
 
         // Make sure we get the local thread count right
-        error = get_max_common_3D_work_group_size( context, kernel, threads, localThreads );
+        error = get_max_common_3D_work_group_size( launchInfo, threads, localThreads );
         test_error( error, "Unable to determine local work group sizes" );
 
         // Randomize some offsets
@@ -235,6 +239,10 @@ int test_get_global_offset(cl_device_id deviceID, cl_context context, cl_command
                        sizeof(outOffsets), outOffsets, &error);
     test_error( error, "Unable to create control ID buffer" );
 
+    KernelLaunchInfo launchInfo;
+    error = get_kernel_launch_info(context, kernel, &launchInfo);
+    test_error(error, "Unable to get kernel work group limits");
+
     // Run a few different times
     MTdata seed = init_genrand( gRandomSeed );
     for( int test = 0; test < NUM_TESTS; test++ )
@@ -245,7 +253,7 @@ int test_get_global_offset(cl_device_id deviceID, cl_context context, cl_command
         threads[ 2 ] = random_in_range( 1, MAX_TEST_ITEMS / (int)( threads[ 0 ] * threads[ 1 ] ), seed );
 
         // Make sure we get the local thread count right
-        error = get_max_common_3D_work_group_size( context, kernel, threads, localThreads );
+        error = get_max_common_3D_work_group_size( launchInfo, threads, localThreads );
         test_error( error, "Unable to determine local work group sizes" );
 
         // Randomize some offsets
@@ -21,8 +21,12 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 
+#include <memory>
+#include <vector>
+
 
 #include "procs.h"
+#include "harness/imagePool.h"
 
 static const char *image_to_image_kernel_integer_coord_code =
 "\n"
@@ -96,7 +100,7 @@ generate_initial_byte_image(int w, int h, int num_elements, unsigned char value)
 }
 
 static unsigned char *
-generate_expected_byte_image(unsigned char **input_data, int num_inputs, int w, int h, int num_elements)
+generate_expected_byte_image(const unsigned char **input_data, int num_inputs, int w, int h, int num_elements)
 {
     unsigned char   *ptr = (unsigned char*)malloc(w * h * num_elements);
     int             i;
@@ -107,7 +111,7 @@ generate_expected_byte_image(unsigned char **input_data, int num_inputs, int w,
         ptr[i] = 0;
         for (j = 0; j < num_inputs; j++)
         {
-            unsigned char *input = *(input_data + j);
+            const unsigned char *input = *(input_data + j);
             ptr[i] += input[i];
         }
     }
@@ -116,18 +120,6 @@ generate_expected_byte_image(unsigned char **input_data, int num_inputs, int w,
 }
 
 
-static unsigned char *
-generate_byte_image(int w, int h, int num_elements, MTdata d)
-{
-    unsigned char   *ptr = (unsigned char*)malloc(w * h * num_elements);
-    int             i;
-
-    for (i = 0; i < w*h*num_elements; i++)
-        ptr[i] = (unsigned char)genrand_int32(d) & 31;
-
-    return ptr;
-}
-
 static int
 verify_byte_image(unsigned char *image, unsigned char *outptr, int w, int h, int num_elements)
 {
@@ -152,6 +144,7 @@ test_image_multipass_integer_coord(cl_device_id device, cl_context context, cl_c
 
     int                 num_input_streams = 8;
     cl_mem              *input_streams;
+    std::vector<std::unique_ptr<PooledImage>> inputs;
     cl_mem                accum_streams[2];
     unsigned char       *expected_output;
     unsigned char       *output_ptr;
@@ -217,53 +210,34 @@ test_image_multipass_integer_coord(cl_device_id device, cl_context context, cl_c
         free(initial_data);
     }
 
-    // Set up the input data.
+    // Set up the input data. The kernels only read the inputs, so they come
+    // filled from the pool, and sum to at most 8 * 31 without wrapping.
     {
-        cl_mem_flags        flags;
-        unsigned char       **input_data = (unsigned char **)malloc(sizeof(unsigned char*) * num_input_streams);
-        MTdata              d;
+        const unsigned char **input_data = (const unsigned char **)malloc(sizeof(unsigned char*) * num_input_streams);
 
         input_streams = (cl_mem*)malloc(sizeof(cl_mem) * num_input_streams);
-        flags = CL_MEM_READ_WRITE;
 
         int i;
-        d = init_genrand( gRandomSeed );
         for ( i = 0; i < num_input_streams; i++)
         {
-            input_data[i] = generate_byte_image(img_width, img_height, 4, d);
-            input_streams[i] = create_image_2d(context, flags, &img_format, img_width, img_height, 0, NULL, NULL);
-            if (!input_streams[i])
+            image_pool_desc desc = { img_format, CL_MEM_OBJECT_IMAGE2D,
+                                     (size_t)img_width, (size_t)img_height, 1,
+                                     CL_MEM_READ_WRITE, gRandomSeed + i, 31 };
+            inputs.emplace_back(new PooledImage(context, queue, desc));
+            if (inputs[i]->status() != CL_SUCCESS)
             {
-                log_error("create_image_2d failed\n");
-                free_mtdata(d);
-                free(expected_output);
-                free(output_ptr);
-                return -1;
-            }
-
-            size_t origin[3] = {0, 0, 0}, region[3] = {img_width, img_height, 1};
-            err = clEnqueueWriteImage(queue, input_streams[i], CL_TRUE,
-                                      origin, region, 0, 0,
-                                      input_data[i], 0, NULL, NULL);
-            if (err)
-            {
-                log_error("clWriteImage failed: %d\n", err);
-                free_mtdata(d);
+                log_error("Unable to get pooled image\n");
+                free(input_data);
                 free(expected_output);
                 free(output_ptr);
                 free(input_streams);
                 return -1;
             }
-
-
+            input_streams[i] = inputs[i]->image();
+            input_data[i] = (const unsigned char *)inputs[i]->data();
         }
-        free_mtdata(d); d = NULL;
         expected_output = generate_expected_byte_image(input_data, num_input_streams, img_width, img_height, 4);
-        for ( i = 0; i < num_input_streams; i++)
-        {
-            free(input_data[i]);
-        }
-        free( input_data );
+        free(input_data);
     }
 
     // Set up the kernels.
@@ -381,13 +355,6 @@ test_image_multipass_integer_coord(cl_device_id device, cl_context context, cl_c
     // cleanup
     clReleaseMemObject(accum_streams[0]);
     clReleaseMemObject(accum_streams[1]);
-    {
-        int i;
-        for (i = 0; i < num_input_streams; i++)
-        {
-            clReleaseMemObject(input_streams[i]);
-        }
-    }
     free(input_streams);
     clReleaseKernel(kernel[0]);
     clReleaseKernel(kernel[1]);
@@ -406,6 +373,7 @@ test_image_multipass_float_coord(cl_device_id device, cl_context context, cl_com
 
     int                 num_input_streams = 8;
     cl_mem              *input_streams;
+    std::vector<std::unique_ptr<PooledImage>> inputs;
     cl_mem                accum_streams[2];
     unsigned char       *expected_output;
     unsigned char       *output_ptr;
@@ -462,47 +430,31 @@ test_image_multipass_float_coord(cl_device_id device, cl_context context, cl_com
         free(initial_data);
     }
 
-    // Set up the input data.
+    // Set up the input data. The kernels only read the inputs, so they come
+    // filled from the pool, and sum to at most 8 * 31 without wrapping.
     {
-        cl_mem_flags        flags;
-        unsigned char       **input_data = (unsigned char **)malloc(sizeof(unsigned char*) * num_input_streams);
-        MTdata              d;
+        const unsigned char **input_data = (const unsigned char **)malloc(sizeof(unsigned char*) * num_input_streams);
 
         input_streams = (cl_mem*)malloc(sizeof(cl_mem) * num_input_streams);
-        flags = CL_MEM_READ_WRITE;
 
         int i;
-        d = init_genrand( gRandomSeed );
         for ( i = 0; i < num_input_streams; i++)
         {
-            input_data[i] = generate_byte_image(img_width, img_height, 4, d);
-            input_streams[i] = create_image_2d(context, flags, &img_format, img_width, img_height, 0, NULL, NULL);
-            if (!input_streams[i])
+            image_pool_desc desc = { img_format, CL_MEM_OBJECT_IMAGE2D,
+                                     (size_t)img_width, (size_t)img_height, 1,
+                                     CL_MEM_READ_WRITE, gRandomSeed + i, 31 };
+            inputs.emplace_back(new PooledImage(context, queue, desc));
+            if (inputs[i]->status() != CL_SUCCESS)
             {
-                log_error("create_image_2d failed\n");
-                free(input_data);
-                free(input_streams);
-                return -1;
-            }
-
-            size_t origin[3] = {0, 0, 0}, region[3] = {img_width, img_height, 1};
-            err = clEnqueueWriteImage(queue, input_streams[i], CL_TRUE,
-                                      origin, region, 0, 0,
-                                      input_data[i], 0, NULL, NULL);
-            if (err)
-            {
-                log_error("clWriteImage failed: %d\n", err);
+                log_error("Unable to get pooled image\n");
                 free(input_data);
                 free(input_streams);
                 return -1;
             }
+            input_streams[i] = inputs[i]->image();
+            input_data[i] = (const unsigned char *)inputs[i]->data();
         }
-        free_mtdata(d); d = NULL;
         expected_output = generate_expected_byte_image(input_data, num_input_streams, img_width, img_height, 4);
-        for ( i = 0; i < num_input_streams; i++)
-        {
-            free(input_data[i]);
-        }
         free(input_data);
     }
 
@@ -622,13 +574,6 @@ test_image_multipass_float_coord(cl_device_id device, cl_context context, cl_com
     clReleaseSampler(sampler);
     clReleaseMemObject(accum_streams[0]);
     clReleaseMemObject(accum_streams[1]);
-    {
-        int i;
-        for (i = 0; i < num_input_streams; i++)
-        {
-            clReleaseMemObject(input_streams[i]);
-        }
-    }
     clReleaseKernel(kernel[0]);
     clReleaseKernel(kernel[1]);
     free(expected_output);
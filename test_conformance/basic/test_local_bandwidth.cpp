@@ -0,0 +1,400 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "harness/compat.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "harness/kernelClock.h"
+#include "harness/benchmark.h"
+#include "harness/perfMetrics.h"
+#include "procs.h"
+
+// Local memory bandwidth and latency as the stride between neighbouring
+// work-items grows, with a kernel built for each stride and element type, so
+// bank conflicts show up as a drop against stride 1. Stride 33 is the usual
+// padded layout and should get back to full speed. Then the bandwidth as the
+// local memory a work-group allocates grows, which gives the largest
+// allocation that still runs as many work-groups at once as a small one,
+// with the work-group durations and start skew from the kernel clock where
+// the device has one. A benchmark, so it only runs when named.
+
+static const char *kElementTypes[] = { "uint", "uint2", "uint4" };
+static const size_t kElementSizes[] = { 4, 8, 16 };
+static const int kStrides[] = { 1, 2, 4, 8, 16, 32, 33 };
+// Elements in the tile each work-group reads, a power of two
+static const cl_uint kTileElements = 4096;
+static const size_t kLocalSize = 256;
+static const size_t kGroupsPerUnit = 8;
+static const int kIterations = 1024;
+static const int kChaseSteps = 1 << 16;
+// An allocation still counts as full occupancy within this of the best
+static const double kOccupancyTolerance = 0.9;
+
+static const char *local_bandwidth_kernels = R"(
+    __kernel void local_read(__global T *dst, __local T *tile, uint tile_len,
+                             int iterations)
+    {
+        uint mask = tile_len - 1;
+        for (uint i = get_local_id(0); i < tile_len; i += get_local_size(0))
+            tile[i] = (T)i;
+        barrier(CLK_LOCAL_MEM_FENCE);
+
+        uint index = (get_local_id(0) * STRIDE) & mask;
+        T acc = (T)0;
+        for (int i = 0; i < iterations; i++)
+            acc += tile[(index + i) & mask];
+        dst[get_global_id(0)] = acc;
+    }
+
+    __kernel void local_write(__global T *dst, __local T *tile, uint tile_len,
+                              int iterations)
+    {
+        uint mask = tile_len - 1;
+        uint index = (get_local_id(0) * STRIDE) & mask;
+        for (int i = 0; i < iterations; i++)
+            tile[(index + i) & mask] = (T)i;
+        barrier(CLK_LOCAL_MEM_FENCE);
+        dst[get_global_id(0)] = tile[get_local_id(0) & mask];
+    }
+
+    // Each step depends on the last, and consecutive steps are STRIDE
+    // elements apart
+    __kernel void local_chase(__global uint *dst, __local uint *tile,
+                              uint tile_len, int steps)
+    {
+        uint mask = tile_len - 1;
+        for (uint i = get_local_id(0); i < tile_len; i += get_local_size(0))
+            tile[i] = (i + STRIDE) & mask;
+        barrier(CLK_LOCAL_MEM_FENCE);
+
+        if (get_local_id(0) == 0)
+        {
+            uint j = 0;
+            for (int i = 0; i < steps; i++) j = tile[j];
+            dst[get_group_id(0)] = j;
+        }
+    }
+)";
+
+// local_read for uints and stride 1, timing each work-group
+static const char *local_read_timed_kernel = R"(
+    __kernel void local_read_timed(__global uint *dst, __local uint *tile,
+                                   uint tile_len, int iterations,
+                                   __global uint2 *clocks)
+    {
+        KERNEL_CLOCK_BEGIN();
+        uint mask = tile_len - 1;
+        for (uint i = get_local_id(0); i < tile_len; i += get_local_size(0))
+            tile[i] = i;
+        barrier(CLK_LOCAL_MEM_FENCE);
+
+        uint index = get_local_id(0) & mask;
+        uint acc = 0;
+        for (int i = 0; i < iterations; i++)
+            acc += tile[(index + i) & mask];
+        dst[get_global_id(0)] = acc;
+        KERNEL_CLOCK_END(clocks);
+    }
+)";
+
+namespace {
+
+struct LocalBench
+{
+    cl_command_queue queue;
+    clMemWrapper dst;
+    BenchmarkOptions options;
+
+    int SetArgs(cl_kernel kernel, size_t local_bytes, cl_uint tile_len,
+                int iterations)
+    {
+        int error = clSetKernelArg(kernel, 0, sizeof(cl_mem), &dst);
+        error |= clSetKernelArg(kernel, 1, local_bytes, NULL);
+        error |= clSetKernelArg(kernel, 2, sizeof(tile_len), &tile_len);
+        error |= clSetKernelArg(kernel, 3, sizeof(iterations), &iterations);
+        test_error(error, "clSetKernelArg failed");
+        return CL_SUCCESS;
+    }
+
+    // Device time of one run of the kernel, in nanoseconds
+    int Run(cl_kernel kernel, size_t global, size_t local, double *ns)
+    {
+        clEventWrapper event;
+        int error = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &global,
+                                           &local, 0, NULL, &event);
+        test_error(error, "clEnqueueNDRangeKernel failed");
+        error = clWaitForEvents(1, &event);
+        test_error(error, "clWaitForEvents failed");
+        return get_event_duration_ns(event, ns);
+    }
+
+    // Bandwidth of the kernel moving bytes in each run, in GB/s
+    int Bandwidth(cl_kernel kernel, size_t global, size_t local, double bytes,
+                  BenchmarkStats &stats)
+    {
+        return run_benchmark(
+            options,
+            [&](double *gbps) {
+                double ns;
+                int error = Run(kernel, global, local, &ns);
+                // Bytes per nanosecond is GB/s
+                *gbps = ns > 0 ? bytes / ns : 0.0;
+                return error;
+            },
+            &stats);
+    }
+
+    // Time of each of the steps a run of the kernel takes, in nanoseconds
+    int Latency(cl_kernel kernel, size_t global, size_t local, int steps,
+                BenchmarkStats &stats)
+    {
+        return run_benchmark(
+            options,
+            [&](double *step_ns) {
+                double ns;
+                int error = Run(kernel, global, local, &ns);
+                *step_ns = ns / steps;
+                return error;
+            },
+            &stats);
+    }
+};
+
+struct LocalKernels
+{
+    clProgramWrapper program;
+    clKernelWrapper read;
+    clKernelWrapper write;
+    clKernelWrapper chase;
+};
+
+int build_local_kernels(cl_context context, const char *type, int stride,
+                        LocalKernels &kernels)
+{
+    std::string options = std::string("-DT=") + type
+        + " -DSTRIDE=" + std::to_string(stride);
+    int error = create_single_kernel_helper(
+        context, &kernels.program, &kernels.read, 1, &local_bandwidth_kernels,
+        "local_read", options.c_str());
+    test_error(error, "Unable to create the local bandwidth kernels");
+    kernels.write = clCreateKernel(kernels.program, "local_write", &error);
+    test_error(error, "clCreateKernel failed");
+    kernels.chase = clCreateKernel(kernels.program, "local_chase", &error);
+    test_error(error, "clCreateKernel failed");
+    return CL_SUCCESS;
+}
+
+size_t kernel_work_group_size(cl_device_id device, cl_kernel kernel)
+{
+    size_t size = 0;
+    int error =
+        clGetKernelWorkGroupInfo(kernel, device, CL_KERNEL_WORK_GROUP_SIZE,
+                                 sizeof(size), &size, NULL);
+    if (error != CL_SUCCESS)
+    {
+        print_error(error, "clGetKernelWorkGroupInfo failed");
+        return 0;
+    }
+    return size;
+}
+
+} // anonymous namespace
+
+int test_local_bandwidth(cl_device_id device, cl_context context,
+                         cl_command_queue queue, int num_elements)
+{
+    int error;
+    cl_ulong local_mem;
+    cl_uint units;
+    error = clGetDeviceInfo(device, CL_DEVICE_LOCAL_MEM_SIZE,
+                            sizeof(local_mem), &local_mem, NULL);
+    test_error(error, "Unable to get CL_DEVICE_LOCAL_MEM_SIZE");
+    error = clGetDeviceInfo(device, CL_DEVICE_MAX_COMPUTE_UNITS, sizeof(units),
+                            &units, NULL);
+    test_error(error, "Unable to get CL_DEVICE_MAX_COMPUTE_UNITS");
+
+    LocalBench bench;
+    clCommandQueueWrapper profiling_queue = clCreateCommandQueue(
+        context, device, CL_QUEUE_PROFILING_ENABLE, &error);
+    test_error(error, "Unable to create profiling queue");
+    bench.queue = profiling_queue;
+    bench.options.warmup = 1;
+    bench.options.maxSeconds = 1.0;
+
+    size_t max_groups = units * kGroupsPerUnit;
+    size_t max_element = kElementSizes[ARRAY_SIZE(kElementSizes) - 1];
+    bench.dst = clCreateBuffer(context, CL_MEM_WRITE_ONLY,
+                               max_groups * kLocalSize * max_element, NULL,
+                               &error);
+    test_error(error, "clCreateBuffer failed");
+
+    log_benchmark_header("local_stride", "kernel/type/stride/wg_size");
+    for (size_t t = 0; t < ARRAY_SIZE(kElementTypes); t++)
+    {
+        size_t element_size = kElementSizes[t];
+        // Keep the tile to half of local memory
+        cl_uint tile_len = kTileElements;
+        while (tile_len > 1 && tile_len * element_size > local_mem / 2)
+            tile_len /= 2;
+        size_t tile_bytes = tile_len * element_size;
+
+        double stride_1_gbps = 0;
+        for (int stride : kStrides)
+        {
+            LocalKernels kernels;
+            error = build_local_kernels(context, kElementTypes[t], stride,
+                                        kernels);
+            if (error != CL_SUCCESS) return TEST_FAIL;
+
+            size_t local = std::min(
+                { kLocalSize, kernel_work_group_size(device, kernels.read),
+                  kernel_work_group_size(device, kernels.write),
+                  kernel_work_group_size(device, kernels.chase) });
+            if (local == 0) return TEST_FAIL;
+            size_t global = local * max_groups;
+            std::string label = std::string(kElementTypes[t]) + "/"
+                + std::to_string(stride) + "/" + std::to_string(local);
+
+            double bytes = (double)global * kIterations * element_size;
+            BenchmarkStats read_stats, write_stats;
+            error = bench.SetArgs(kernels.read, tile_bytes, tile_len,
+                                  kIterations);
+            if (error != CL_SUCCESS) return TEST_FAIL;
+            error = bench.Bandwidth(kernels.read, global, local, bytes,
+                                    read_stats);
+            if (error != CL_SUCCESS) return TEST_FAIL;
+            log_benchmark_stats("local_stride", ("read/" + label).c_str(),
+                                "GB/s", true, read_stats);
+            error = bench.SetArgs(kernels.write, tile_bytes, tile_len,
+                                  kIterations);
+            if (error != CL_SUCCESS) return TEST_FAIL;
+            error = bench.Bandwidth(kernels.write, global, local, bytes,
+                                    write_stats);
+            if (error != CL_SUCCESS) return TEST_FAIL;
+            log_benchmark_stats("local_stride", ("write/" + label).c_str(),
+                                "GB/s", true, write_stats);
+
+            if (stride == 1) stride_1_gbps = read_stats.median;
+            record_perf_metric("local_stride_read_vs_stride_1." + label,
+                               stride_1_gbps > 0
+                                   ? read_stats.median / stride_1_gbps
+                                   : 0.0,
+                               "ratio", true);
+
+            // The chase only follows uints, time it once per stride
+            if (t == 0)
+            {
+                BenchmarkStats chase_stats;
+                error = bench.SetArgs(kernels.chase,
+                                      tile_len * sizeof(cl_uint), tile_len,
+                                      kChaseSteps);
+                if (error != CL_SUCCESS) return TEST_FAIL;
+                error = bench.Latency(kernels.chase, units * local, local,
+                                      kChaseSteps, chase_stats);
+                if (error != CL_SUCCESS) return TEST_FAIL;
+                log_benchmark_stats("local_stride", ("chase/" + label).c_str(),
+                                    "ns", false, chase_stats);
+            }
+        }
+    }
+
+    // Stride 1 uint reads, with each work-group holding more local memory
+    // than the tile it reads until the device runs fewer of them at once
+    LocalKernels kernels;
+    error = build_local_kernels(context, "uint", 1, kernels);
+    if (error != CL_SUCCESS) return TEST_FAIL;
+    size_t local =
+        std::min(kLocalSize, kernel_work_group_size(device, kernels.read));
+    if (local == 0) return TEST_FAIL;
+    size_t global = local * max_groups;
+    cl_uint tile_len = 256;
+
+    log_benchmark_header("local_occupancy", "local_bytes");
+    std::vector<std::pair<size_t, double>> results;
+    double best = 0;
+    for (size_t bytes = tile_len * sizeof(cl_uint); bytes <= local_mem;
+         bytes *= 2)
+    {
+        BenchmarkStats stats;
+        error = bench.SetArgs(kernels.read, bytes, tile_len, kIterations);
+        if (error != CL_SUCCESS) return TEST_FAIL;
+        error = bench.Bandwidth(kernels.read, global, local,
+                                (double)global * kIterations * sizeof(cl_uint),
+                                stats);
+        if (error != CL_SUCCESS) return TEST_FAIL;
+        log_benchmark_stats("local_occupancy", std::to_string(bytes).c_str(),
+                            "GB/s", true, stats);
+        results.push_back(std::make_pair(bytes, stats.median));
+        best = std::max(best, stats.median);
+    }
+
+    size_t full_occupancy = 0;
+    bool dropped = false;
+    for (const auto &result : results)
+    {
+        double ratio = best > 0 ? result.second / best : 0.0;
+        if (ratio < kOccupancyTolerance) dropped = true;
+        if (!dropped) full_occupancy = result.first;
+    }
+    log_info("Largest local allocation per work-group within %.0f%% of the "
+             "best bandwidth: %zu bytes\n",
+             kOccupancyTolerance * 100, full_occupancy);
+
+    // Once fewer work-groups fit at once they start in waves, which the
+    // start skew of the largest allocation shows against the smallest
+    KernelClockProbe probe(device, context);
+    if (!probe.supported() || results.empty()) return 0;
+
+    clProgramWrapper timed_program;
+    clKernelWrapper timed;
+    const char *sources[] = { probe.source(), local_read_timed_kernel };
+    error = create_single_kernel_helper(context, &timed_program, &timed,
+                                        ARRAY_SIZE(sources), sources,
+                                        "local_read_timed");
+    test_error(error, "Unable to create the timed local read kernel");
+    size_t timed_local = std::min(local, kernel_work_group_size(device, timed));
+    if (timed_local == 0) return TEST_FAIL;
+
+    for (size_t bytes : { results.front().first, results.back().first })
+    {
+        error = probe.prepare(bench.queue, max_groups);
+        if (error != CL_SUCCESS) return TEST_FAIL;
+        cl_mem clocks = probe.buffer();
+        error = clSetKernelArg(timed, 4, sizeof(clocks), &clocks);
+        test_error(error, "clSetKernelArg failed");
+
+        // One run, the probe holds the clocks of the last run only
+        double ns;
+        error = bench.SetArgs(timed, bytes, tile_len, kIterations);
+        if (error != CL_SUCCESS) return TEST_FAIL;
+        error = bench.Run(timed, timed_local * max_groups, timed_local, &ns);
+        if (error != CL_SUCCESS) return TEST_FAIL;
+
+        KernelClockStats stats;
+        error = probe.collect(bench.queue, &stats);
+        if (error != CL_SUCCESS) return TEST_FAIL;
+        std::string label = "occupancy_" + std::to_string(bytes);
+        log_kernel_clock_stats(label.c_str(), stats);
+    }
+
+    return 0;
+}
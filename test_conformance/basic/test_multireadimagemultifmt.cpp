@@ -21,8 +21,11 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 
+#include <memory>
+
 
 #include "procs.h"
+#include "harness/imagePool.h"
 
 static const char *multireadimage_kernel_code =
 "__kernel void test_multireadimage(read_only image2d_t img0, read_only image2d_t img1, \n"
@@ -43,45 +46,8 @@ static const char *multireadimage_kernel_code =
 
 #define MAX_ERR    1e-7f
 
-static unsigned char *
-generate_8888_image(int w, int h, MTdata d)
-{
-    unsigned char   *ptr = (unsigned char*)malloc(w * h * 4);
-    int             i;
-
-    for (i=0; i<w*h*4; i++)
-        ptr[i] = (unsigned char)genrand_int32(d);
-
-    return ptr;
-}
-
-static unsigned short *
-generate_16bit_image(int w, int h, MTdata d)
-{
-    unsigned short    *ptr = (unsigned short*)malloc(w * h * 4 * sizeof(unsigned short));
-    int             i;
-
-    for (i=0; i<w*h*4; i++)
-        ptr[i] = (unsigned short)genrand_int32(d);
-
-    return ptr;
-}
-
-static float *
-generate_float_image(int w, int h, MTdata d)
-{
-    float   *ptr = (float*)malloc(w * h * 4 * (int)sizeof(float));
-    int     i;
-
-    for (i=0; i<w*h*4; i++)
-        ptr[i] = get_random_float(-0x40000000, 0x40000000, d);
-
-    return ptr;
-}
-
-
 static int
-verify_multireadimage(void *image[], float *outptr, int w, int h)
+verify_multireadimage(const void *image[], float *outptr, int w, int h)
 {
   int     i;
   float   sum;
@@ -92,9 +58,9 @@ verify_multireadimage(void *image[], float *outptr, int w, int h)
 
   for (i=0; i<w*h*4; i++)
   {
-    sum = (float)((unsigned char *)image[0])[i] / 255.0f;
-    sum += (float)((unsigned short *)image[1])[i] / 65535.0f;
-    sum += (float)((float *)image[2])[i];
+    sum = (float)((const unsigned char *)image[0])[i] / 255.0f;
+    sum += (float)((const unsigned short *)image[1])[i] / 65535.0f;
+    sum += (float)((const float *)image[2])[i];
     ulp = Ulp_Error(outptr[i], sum);
     if (ulp > max_ulp)
       max_ulp = ulp;
@@ -113,53 +79,34 @@ verify_multireadimage(void *image[], float *outptr, int w, int h)
 int
 test_mri_multiple(cl_device_id device, cl_context context, cl_command_queue queue, int num_elements)
 {
+    static const cl_channel_type channel_types[] = { CL_UNORM_INT8, CL_UNORM_INT16, CL_FLOAT };
     cl_mem            streams[4];
-    cl_image_format    img_format;
-    void            *input_ptr[3], *output_ptr;
+    std::unique_ptr<PooledImage> inputs[3];
+    const void        *input_ptr[3];
+    void              *output_ptr;
     cl_program        program;
     cl_kernel        kernel;
     size_t    threads[2];
     int                img_width = 512;
     int                img_height = 512;
     int                i, err;
-    MTdata          d;
 
     PASSIVE_REQUIRE_IMAGE_SUPPORT( device )
 
-    d = init_genrand( gRandomSeed );
-    input_ptr[0] = (void *)generate_8888_image(img_width, img_height, d);
-    input_ptr[1] = (void *)generate_16bit_image(img_width, img_height, d);
-    input_ptr[2] = (void *)generate_float_image(img_width, img_height, d);
-    free_mtdata(d); d = NULL;
-
-    output_ptr = (void *)malloc(sizeof(float) * 4 * img_width * img_height);
-
-    img_format.image_channel_order = CL_RGBA;
-    img_format.image_channel_data_type = CL_UNORM_INT8;
-    streams[0] = create_image_2d(context, CL_MEM_READ_WRITE, &img_format,
-                                 img_width, img_height, 0, NULL, NULL);
-    if (!streams[0])
-    {
-        log_error("create_image_2d failed\n");
-        return -1;
-    }
-    img_format.image_channel_order = CL_RGBA;
-    img_format.image_channel_data_type = CL_UNORM_INT16;
-    streams[1] = create_image_2d(context, CL_MEM_READ_WRITE, &img_format,
-                                 img_width, img_height, 0, NULL, NULL);
-    if (!streams[1])
-    {
-        log_error("create_image_2d failed\n");
-        return -1;
-    }
-    img_format.image_channel_order = CL_RGBA;
-    img_format.image_channel_data_type = CL_FLOAT;
-    streams[2] = create_image_2d(context, CL_MEM_READ_WRITE, &img_format,
-                                 img_width, img_height, 0, NULL, NULL);
-    if (!streams[2])
+    // The kernel only reads the images, so they come filled from the pool
+    for (i=0; i<3; i++)
     {
-        log_error("create_image_2d failed\n");
-        return -1;
+        image_pool_desc desc = { { CL_RGBA, channel_types[i] }, CL_MEM_OBJECT_IMAGE2D,
+                                 (size_t)img_width, (size_t)img_height, 1,
+                                 CL_MEM_READ_WRITE, gRandomSeed, 0xFFFFFFFF };
+        inputs[i].reset(new PooledImage(context, queue, desc));
+        if (inputs[i]->status() != CL_SUCCESS)
+        {
+            log_error("Unable to get pooled image\n");
+            return -1;
+        }
+        streams[i] = inputs[i]->image();
+        input_ptr[i] = inputs[i]->data();
     }
 
     streams[3] =
@@ -171,16 +118,7 @@ test_mri_multiple(cl_device_id device, cl_context context, cl_command_queue queu
         return -1;
     }
 
-    for (i=0; i<3; i++)
-    {
-      size_t origin[3] = {0,0,0}, region[3]={img_width, img_height,1};
-      err = clEnqueueWriteImage(queue, streams[i], CL_TRUE, origin, region, 0, 0, input_ptr[i], 0, NULL, NULL);
-        if (err != CL_SUCCESS)
-        {
-            log_error("clWriteImage failed\n");
-            return -1;
-        }
-    }
+    output_ptr = (void *)malloc(sizeof(float) * 4 * img_width * img_height);
 
     err = create_single_kernel_helper( context, &program, &kernel, 1, &multireadimage_kernel_code, "test_multireadimage");
     if (err)
@@ -219,12 +157,9 @@ test_mri_multiple(cl_device_id device, cl_context context, cl_command_queue queu
 
     // cleanup
     clReleaseSampler(sampler);
-    for (i=0; i<4; i++)
-        clReleaseMemObject(streams[i]);
+    clReleaseMemObject(streams[3]);
     clReleaseKernel(kernel);
     clReleaseProgram(program);
-    for (i=0; i<3; i++)
-        free(input_ptr[i]);
     free(output_ptr);
 
     return err;
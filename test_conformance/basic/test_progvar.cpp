@@ -34,6 +34,10 @@
 // This is a shared property of the writer and reader kernels.
 #define NUM_TESTED_VALUES 5
 
+// How many types share a program in the write-read tests. Nearly all of
+// their time goes into building, the kernels run a single work-item.
+#define TYPES_PER_PROGRAM 16
+
 // TODO: pointer-to-half (and its vectors)
 // TODO: union of...
 
@@ -422,16 +426,26 @@ static std::string global_check_function(const TypeInfo& ti);
 static std::string writer_function(const TypeInfo& ti);
 static std::string reader_function(const TypeInfo& ti);
 
+static std::string variant_prefix(int itype);
+static std::string prefixed_variant(const std::string& prefix,
+                                    const std::string& src);
+static int l_build_variants(cl_device_id device, cl_context context,
+                            int first_type, int end_type, bool with_init,
+                            clProgramWrapper& program);
+
 static int l_write_read(cl_device_id device, cl_context context,
                         cl_command_queue queue);
 static int l_write_read_for_type(cl_device_id device, cl_context context,
-                                 cl_command_queue queue, const TypeInfo& ti,
+                                 cl_command_queue queue, cl_program program,
+                                 const std::string& prefix, const TypeInfo& ti,
                                  RandomSeed& rand_state);
 
 static int l_init_write_read(cl_device_id device, cl_context context,
                              cl_command_queue queue);
 static int l_init_write_read_for_type(cl_device_id device, cl_context context,
                                       cl_command_queue queue,
+                                      cl_program program,
+                                      const std::string& prefix,
                                       const TypeInfo& ti,
                                       RandomSeed& rand_state);
 
@@ -1064,7 +1078,8 @@ static std::string reader_function(const TypeInfo& ti)
 
 // Check that all globals where appropriately default-initialized.
 static int check_global_initialization(cl_context context, cl_program program,
-                                       cl_command_queue queue)
+                                       cl_command_queue queue,
+                                       const std::string& prefix)
 {
     int status = CL_SUCCESS;
 
@@ -1077,7 +1092,7 @@ static int check_global_initialization(cl_context context, cl_program program,
 
     // Create, setup and invoke kernel.
     clKernelWrapper global_check(
-        clCreateKernel(program, "global_check", &status));
+        clCreateKernel(program, (prefix + "global_check").c_str(), &status));
     test_error_ret(status, "Failed to create global_check kernel", status);
     status = clSetKernelArg(global_check, 0, sizeof(cl_mem), &buffer);
     test_error_ret(status,
@@ -1107,6 +1122,89 @@ static int check_global_initialization(cl_context context, cl_program program,
     return CL_SUCCESS;
 }
 
+// What the names a variant declares start with in a program shared by
+// several types.
+static std::string variant_prefix(int itype)
+{
+    return "t" + std::to_string(itype) + "_";
+}
+
+// Wrap the source of the variant for one type so that its variables,
+// functions and kernels get names of their own, and its INIT_VAR doesn't
+// clash with the next one.
+static std::string prefixed_variant(const std::string& prefix,
+                                    const std::string& src)
+{
+    static const char* names[] = { "var",    "g_var",  "a_var",
+                                   "p_var",  "from_buf", "to_buf",
+                                   "writer", "reader",   "global_check" };
+    std::string result;
+    for (const char* name : names)
+        result += std::string("#define ") + name + " " + prefix + name + "\n";
+    result += src;
+    for (const char* name : names)
+        result += std::string("#undef ") + name + "\n";
+    result += "#undef INIT_VAR\n\n";
+    return result;
+}
+
+// Build one program holding the variants of the write-read tests for the
+// types in [first_type, end_type).
+static int l_build_variants(cl_device_id device, cl_context context,
+                            int first_type, int end_type, bool with_init,
+                            clProgramWrapper& program)
+{
+    StringTable ksrc;
+    ksrc.add(l_get_fp64_pragma());
+    ksrc.add(l_get_cles_int64_pragma());
+    for (int itype = first_type; itype < end_type; itype++)
+        if (type_info[itype].is_atomic_64bit())
+        {
+            ksrc.add(l_get_int64_atomic_pragma());
+            break;
+        }
+
+    size_t expected_used_bytes = 0;
+    for (int itype = first_type; itype < end_type; itype++)
+    {
+        const TypeInfo& ti = type_info[itype];
+        std::string src = conversion_functions(ti);
+        src += global_decls(ti, with_init);
+        if (!with_init) src += global_check_function(ti);
+        src += writer_function(ti);
+        src += reader_function(ti);
+        ksrc.add(prefixed_variant(variant_prefix(itype), src));
+
+        // Two regular variables and an array of 2 elements, and the pointer.
+        expected_used_bytes += (NUM_TESTED_VALUES - 1) * ti.get_size()
+            + (l_64bit_device ? 8 : 4);
+    }
+
+    clKernelWrapper writer;
+    int status = create_single_kernel_helper(
+        context, &program, &writer, ksrc.num_str(), ksrc.strs(),
+        (variant_prefix(first_type) + "writer").c_str());
+    test_error_ret(status, "Failed to create program for write-read tests",
+                   status);
+
+    // Check size query.
+    size_t used_bytes = 0;
+    status = clGetProgramBuildInfo(program, device,
+                                   CL_PROGRAM_BUILD_GLOBAL_VARIABLE_TOTAL_SIZE,
+                                   sizeof(used_bytes), &used_bytes, 0);
+    test_error_ret(status, "Failed to query global variable total size",
+                   status);
+    if (used_bytes < expected_used_bytes)
+    {
+        log_error("Error: program query for global variable total size query "
+                  "failed: Expected at least %llu but got %llu\n",
+                  (unsigned long long)expected_used_bytes,
+                  (unsigned long long)used_bytes);
+        return 1;
+    }
+    return CL_SUCCESS;
+}
+
 // Check write-then-read.
 static int l_write_read(cl_device_id device, cl_context context,
                         cl_command_queue queue)
@@ -1116,19 +1214,30 @@ static int l_write_read(cl_device_id device, cl_context context,
 
     RandomSeed rand_state(gRandomSeed);
 
-    for (itype = 0; itype < num_type_info; itype++)
+    for (int first = 0; first < num_type_info; first += TYPES_PER_PROGRAM)
     {
-        status = status
-            | l_write_read_for_type(device, context, queue, type_info[itype],
-                                    rand_state);
-        FLUSH;
+        int end = std::min(first + TYPES_PER_PROGRAM, num_type_info);
+        clProgramWrapper program;
+        status |= l_build_variants(device, context, first, end, false,
+                                   program);
+        if (program == NULL) continue;
+
+        for (itype = first; itype < end; itype++)
+        {
+            status = status
+                | l_write_read_for_type(device, context, queue, program,
+                                        variant_prefix(itype),
+                                        type_info[itype], rand_state);
+            FLUSH;
+        }
     }
 
     return status;
 }
 
 static int l_write_read_for_type(cl_device_id device, cl_context context,
-                                 cl_command_queue queue, const TypeInfo& ti,
+                                 cl_command_queue queue, cl_program program,
+                                 const std::string& prefix, const TypeInfo& ti,
                                  RandomSeed& rand_state)
 {
     int err = CL_SUCCESS;
@@ -1136,50 +1245,20 @@ static int l_write_read_for_type(cl_device_id device, cl_context context,
     const char* tn = type_name.c_str();
     log_info("  %s ", tn);
 
-    StringTable ksrc;
-    ksrc.add(l_get_fp64_pragma());
-    ksrc.add(l_get_cles_int64_pragma());
-    if (ti.is_atomic_64bit()) ksrc.add(l_get_int64_atomic_pragma());
-    ksrc.add(conversion_functions(ti));
-    ksrc.add(global_decls(ti, false));
-    ksrc.add(global_check_function(ti));
-    ksrc.add(writer_function(ti));
-    ksrc.add(reader_function(ti));
-
     int status = CL_SUCCESS;
-    clProgramWrapper program;
-    clKernelWrapper writer;
-
-    status = create_single_kernel_helper(context, &program, &writer,
-                                         ksrc.num_str(), ksrc.strs(), "writer");
-    test_error_ret(status, "Failed to create program for read-after-write test",
+    clKernelWrapper writer(
+        clCreateKernel(program, (prefix + "writer").c_str(), &status));
+    test_error_ret(status,
+                   "Failed to create writer kernel for read-after-write test",
                    status);
 
-    clKernelWrapper reader(clCreateKernel(program, "reader", &status));
+    clKernelWrapper reader(
+        clCreateKernel(program, (prefix + "reader").c_str(), &status));
     test_error_ret(status,
                    "Failed to create reader kernel for read-after-write test",
                    status);
 
-    // Check size query.
-    size_t used_bytes = 0;
-    status = clGetProgramBuildInfo(program, device,
-                                   CL_PROGRAM_BUILD_GLOBAL_VARIABLE_TOTAL_SIZE,
-                                   sizeof(used_bytes), &used_bytes, 0);
-    test_error_ret(status, "Failed to query global variable total size",
-                   status);
-    size_t expected_used_bytes = (NUM_TESTED_VALUES - 1)
-            * ti.get_size() // Two regular variables and an array of 2 elements.
-        + (l_64bit_device ? 8 : 4); // The pointer
-    if (used_bytes < expected_used_bytes)
-    {
-        log_error("Error program query for global variable total size query "
-                  "failed: Expected at least %llu but got %llu\n",
-                  (unsigned long long)expected_used_bytes,
-                  (unsigned long long)used_bytes);
-        err |= 1;
-    }
-
-    err |= check_global_initialization(context, program, queue);
+    err |= check_global_initialization(context, program, queue, prefix);
 
     // We need to create 5 random values of the given type,
     // and read 4 of them back.
@@ -1328,16 +1407,27 @@ static int l_init_write_read(cl_device_id device, cl_context context,
 
     RandomSeed rand_state(gRandomSeed);
 
-    for (itype = 0; itype < num_type_info; itype++)
+    for (int first = 0; first < num_type_info; first += TYPES_PER_PROGRAM)
     {
-        status = status
-            | l_init_write_read_for_type(device, context, queue,
-                                         type_info[itype], rand_state);
+        int end = std::min(first + TYPES_PER_PROGRAM, num_type_info);
+        clProgramWrapper program;
+        status |= l_build_variants(device, context, first, end, true, program);
+        if (program == NULL) continue;
+
+        for (itype = first; itype < end; itype++)
+        {
+            status = status
+                | l_init_write_read_for_type(device, context, queue, program,
+                                             variant_prefix(itype),
+                                             type_info[itype], rand_state);
+        }
     }
     return status;
 }
 static int l_init_write_read_for_type(cl_device_id device, cl_context context,
                                       cl_command_queue queue,
+                                      cl_program program,
+                                      const std::string& prefix,
                                       const TypeInfo& ti,
                                       RandomSeed& rand_state)
 {
@@ -1346,49 +1436,19 @@ static int l_init_write_read_for_type(cl_device_id device, cl_context context,
     const char* tn = type_name.c_str();
     log_info("  %s ", tn);
 
-    StringTable ksrc;
-    ksrc.add(l_get_fp64_pragma());
-    ksrc.add(l_get_cles_int64_pragma());
-    if (ti.is_atomic_64bit()) ksrc.add(l_get_int64_atomic_pragma());
-    ksrc.add(conversion_functions(ti));
-    ksrc.add(global_decls(ti, true));
-    ksrc.add(writer_function(ti));
-    ksrc.add(reader_function(ti));
-
     int status = CL_SUCCESS;
-    clProgramWrapper program;
-    clKernelWrapper writer;
-
-    status = create_single_kernel_helper(context, &program, &writer,
-                                         ksrc.num_str(), ksrc.strs(), "writer");
-    test_error_ret(status,
-                   "Failed to create program for init-read-after-write test",
-                   status);
+    clKernelWrapper writer(
+        clCreateKernel(program, (prefix + "writer").c_str(), &status));
+    test_error_ret(
+        status, "Failed to create writer kernel for init-read-after-write test",
+        status);
 
-    clKernelWrapper reader(clCreateKernel(program, "reader", &status));
+    clKernelWrapper reader(
+        clCreateKernel(program, (prefix + "reader").c_str(), &status));
     test_error_ret(
         status, "Failed to create reader kernel for init-read-after-write test",
         status);
 
-    // Check size query.
-    size_t used_bytes = 0;
-    status = clGetProgramBuildInfo(program, device,
-                                   CL_PROGRAM_BUILD_GLOBAL_VARIABLE_TOTAL_SIZE,
-                                   sizeof(used_bytes), &used_bytes, 0);
-    test_error_ret(status, "Failed to query global variable total size",
-                   status);
-    size_t expected_used_bytes = (NUM_TESTED_VALUES - 1)
-            * ti.get_size() // Two regular variables and an array of 2 elements.
-        + (l_64bit_device ? 8 : 4); // The pointer
-    if (used_bytes < expected_used_bytes)
-    {
-        log_error("Error: program query for global variable total size query "
-                  "failed: Expected at least %llu but got %llu\n",
-                  (unsigned long long)expected_used_bytes,
-                  (unsigned long long)used_bytes);
-        err |= 1;
-    }
-
     // We need to create 5 random values of the given type,
     // and read 4 of them back.
     const size_t write_data_size = NUM_TESTED_VALUES * sizeof(cl_ulong16);
@@ -314,14 +314,11 @@ int test_vector_creation(cl_device_id deviceID, cl_context context,
         }
         else
         {
-            for (int j = 0; j < 16; j++)
-            {
-                convert_explicit_value(
-                    &j,
-                    ((char *)input_data_converted.data())
-                        + get_explicit_type_size(vecType[type_index]) * j,
-                    kInt, 0, kRoundToEven, vecType[type_index]);
-            }
+            cl_int input_data_int[16];
+            for (int j = 0; j < 16; j++) input_data_int[j] = j;
+            convert_explicit_array(input_data_int, input_data_converted.data(),
+                                   16, kInt, false, kRoundToEven,
+                                   vecType[type_index]);
         }
 
         clMemWrapper input =
@@ -18,6 +18,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <vector>
 #include "procs.h"
 #include "harness/testHarness.h"
 
@@ -120,6 +121,10 @@ test_definition test_list[] = {
 
     ADD_TEST(buffer_migrate),
     ADD_TEST(image_migrate),
+
+    ADD_BENCHMARK(buffer_transfer_bandwidth),
+    ADD_BENCHMARK(buffer_fill_bandwidth),
+    ADD_BENCHMARK(sub_buffer_overhead),
 };
 
 const int test_num = ARRAY_SIZE( test_list );
@@ -139,7 +144,40 @@ const char* flag_set_names[] = {
     "0"
 };
 
+bool gDeviceVerify = false;
+
+int create_vector_width_kernels(cl_context context, cl_program *program,
+                                clKernelWrapper kernels[], int count,
+                                const char *kernelCode[],
+                                const char *kernelName[])
+{
+    // One build for all the widths, which the online binary cache keeps for
+    // the other tests of the same type
+    int error = create_single_kernel_helper(context, program, &kernels[0],
+                                            count, kernelCode, kernelName[0]);
+    if (error) return error;
+
+    for (int i = 1; i < count; i++)
+    {
+        kernels[i] = clCreateKernel(*program, kernelName[i], &error);
+        test_error(error, "Unable to create kernel");
+    }
+    return CL_SUCCESS;
+}
+
 int main( int argc, const char *argv[] )
 {
-    return runTestHarness(argc, argv, test_num, test_list, false, 0);
+    std::vector<const char *> argList;
+    for (int i = 0; i < argc; i++)
+    {
+        if (i > 0 && strcmp(argv[i], "-device_verify") == 0)
+        {
+            gDeviceVerify = true;
+            continue;
+        }
+        argList.push_back(argv[i]);
+    }
+
+    return runTestHarness((int)argList.size(), argList.data(), test_num,
+                          test_list, false, 0);
 }
@@ -22,6 +22,7 @@
 #include "harness/typeWrappers.h"
 #include "harness/mt19937.h"
 #include "harness/conversions.h"
+#include "harness/parseParameters.h"
 
 #ifndef __APPLE__
 #include <CL/cl.h>
@@ -31,6 +32,17 @@ extern const cl_mem_flags flag_set[];
 extern const char* flag_set_names[];
 #define NUM_FLAGS 5
 
+// Set by the -device_verify option; the copy tests then compare the results
+// on the device and only read them back to report a mismatch
+extern bool gDeviceVerify;
+
+// Builds the kernels of count vector widths as one program, kernel i named
+// kernelName[i] from kernelCode[i]
+int create_vector_width_kernels(cl_context context, cl_program *program,
+                                clKernelWrapper kernels[], int count,
+                                const char *kernelCode[],
+                                const char *kernelName[]);
+
 extern int      test_buffer_read_int( cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements );
 extern int      test_buffer_read_uint( cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements );
 extern int      test_buffer_read_long( cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements );
@@ -128,5 +140,15 @@ extern int      test_buffer_fill_ulong( cl_device_id deviceID, cl_context contex
 extern int      test_buffer_fill_float( cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements );
 extern int      test_buffer_fill_struct( cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements );
 
+extern int test_buffer_transfer_bandwidth(cl_device_id deviceID,
+                                          cl_context context,
+                                          cl_command_queue queue,
+                                          int num_elements);
+extern int test_buffer_fill_bandwidth(cl_device_id deviceID, cl_context context,
+                                      cl_command_queue queue,
+                                      int num_elements);
+extern int test_sub_buffer_overhead(cl_device_id deviceID, cl_context context,
+                                    cl_command_queue queue, int num_elements);
+
 #endif    // #ifndef __PROCS_H__
 
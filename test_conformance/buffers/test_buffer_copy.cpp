@@ -38,7 +38,60 @@ static int verify_copy_buffer(int *inptr, int *outptr, int n)
 }
 
 
-static int test_copy( cl_command_queue queue, cl_context context, int num_elements, MTdata d )
+static const char *verify_copy_kernel_code = R"(
+__kernel void verify_copy(__global const int *src, __global const int *dst,
+                          uint srcStart, uint dstStart,
+                          volatile __global uint *mismatch)
+{
+    uint i = get_global_id(0);
+    if (src[srcStart + i] != dst[dstStart + i])
+    {
+        atomic_inc(&mismatch[0]);
+        atomic_min(&mismatch[1], i);
+    }
+}
+)";
+
+// Compares size ints of src from srcStart with those of dst from dstStart on
+// the device, so that only the number of mismatches is read back
+static int verify_copy_on_device(cl_command_queue queue, cl_context context,
+                                 cl_kernel kernel, cl_mem src, cl_mem dst,
+                                 cl_uint srcStart, cl_uint dstStart, int size,
+                                 cl_uint *mismatches)
+{
+    cl_uint result[2] = { 0, CL_UINT_MAX };
+    cl_int err;
+    clMemWrapper resultBuffer =
+        clCreateBuffer(context, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR,
+                       sizeof(result), result, &err);
+    test_error(err, "clCreateBuffer failed");
+
+    err = clSetKernelArg(kernel, 0, sizeof(src), &src);
+    err |= clSetKernelArg(kernel, 1, sizeof(dst), &dst);
+    err |= clSetKernelArg(kernel, 2, sizeof(srcStart), &srcStart);
+    err |= clSetKernelArg(kernel, 3, sizeof(dstStart), &dstStart);
+    err |= clSetKernelArg(kernel, 4, sizeof(resultBuffer), &resultBuffer);
+    test_error(err, "clSetKernelArg failed");
+
+    size_t global = size;
+    err = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &global, NULL, 0,
+                                 NULL, NULL);
+    test_error(err, "clEnqueueNDRangeKernel failed");
+
+    err = clEnqueueReadBuffer(queue, resultBuffer, CL_TRUE, 0, sizeof(result),
+                              result, 0, NULL, NULL);
+    test_error(err, "clEnqueueReadBuffer failed");
+
+    *mismatches = result[0];
+    if (result[0])
+        log_info(" %u ints differ on the device, the first at %u, reading the "
+                 "result back:",
+                 result[0], result[1]);
+    return CL_SUCCESS;
+}
+
+
+static int test_copy( cl_command_queue queue, cl_context context, int num_elements, cl_kernel verify, MTdata d )
 {
     cl_mem  buffers[2];
     cl_int  *int_input_ptr, *int_output_ptr;
@@ -106,6 +159,28 @@ static int test_copy( cl_command_queue queue, cl_context context, int num_elemen
                 return -1;
             }
 
+            if (verify != NULL)
+            {
+                cl_uint mismatches;
+                if (verify_copy_on_device(queue, context, verify, buffers[0],
+                                          buffers[1], 0, 0, num_elements,
+                                          &mismatches))
+                {
+                    clReleaseMemObject( buffers[0] );
+                    clReleaseMemObject( buffers[1] );
+                    align_free( (void *)int_output_ptr );
+                    align_free( (void *)int_input_ptr );
+                    return -1;
+                }
+                if (mismatches == 0)
+                {
+                    log_info( " test passed\n" );
+                    clReleaseMemObject( buffers[0] );
+                    clReleaseMemObject( buffers[1] );
+                    continue;
+                }
+            }
+
             err = clEnqueueReadBuffer( queue, buffers[1], true, 0, sizeof(int)*num_elements, (void *)int_output_ptr, 0, NULL, NULL );
             if ( err != CL_SUCCESS ){
                 print_error( err, "clEnqueueReadBuffer failed" );
@@ -137,7 +212,7 @@ static int test_copy( cl_command_queue queue, cl_context context, int num_elemen
 }   // end test_copy()
 
 
-static int testPartialCopy( cl_command_queue queue, cl_context context, int num_elements, cl_uint srcStart, cl_uint dstStart, int size, MTdata d )
+static int testPartialCopy( cl_command_queue queue, cl_context context, int num_elements, cl_uint srcStart, cl_uint dstStart, int size, cl_kernel verify, MTdata d )
 {
     cl_mem  buffers[2];
     int     *inptr, *outptr;
@@ -214,6 +289,28 @@ static int testPartialCopy( cl_command_queue queue, cl_context context, int num_
                 return -1;
             }
 
+            if (verify != NULL)
+            {
+                cl_uint mismatches;
+                if (verify_copy_on_device(queue, context, verify, buffers[0],
+                                          buffers[1], srcStart, dstStart, size,
+                                          &mismatches))
+                {
+                    clReleaseMemObject( buffers[1] );
+                    clReleaseMemObject( buffers[0] );
+                    align_free( (void *)outptr );
+                    align_free( (void *)inptr );
+                    return -1;
+                }
+                if (mismatches == 0)
+                {
+                    log_info("buffer_COPY test passed\n");
+                    clReleaseMemObject( buffers[1] );
+                    clReleaseMemObject( buffers[0] );
+                    continue;
+                }
+            }
+
             err = clEnqueueReadBuffer( queue, buffers[1], true, 0, sizeof(int)*num_elements, (void *)outptr, 0, NULL, NULL );
             if ( err != CL_SUCCESS){
                 print_error( err, "clEnqueueReadBuffer failed" );
@@ -249,18 +346,29 @@ int test_buffer_copy( cl_device_id deviceID, cl_context context, cl_command_queu
 {
     int     i, err = 0;
     int     size;
+    clProgramWrapper program;
+    clKernelWrapper verify;
+
+    if (gDeviceVerify)
+    {
+        int error = create_single_kernel_helper(
+            context, &program, &verify, 1, &verify_copy_kernel_code,
+            "verify_copy");
+        test_error(error, "Unable to create the verify_copy kernel");
+    }
+
     MTdata  d = init_genrand( gRandomSeed );
 
     // test the preset size
     log_info( "set size: %d: ", num_elements );
-    if (test_copy( queue, context, num_elements, d ))
+    if (test_copy( queue, context, num_elements, verify, d ))
         err++;
 
     // now test random sizes
     for ( i = 0; i < 8; i++ ){
         size = (int)get_random_float(2.f,131072.f, d);
         log_info( "random size: %d: ", size );
-        if (test_copy( queue, context, size, d ))
+        if (test_copy( queue, context, size, verify, d ))
             err++;
     }
 
@@ -276,6 +384,17 @@ int test_buffer_partial_copy( cl_device_id deviceID, cl_context context, cl_comm
     int     i, err = 0;
     int     size;
     cl_uint srcStart, dstStart;
+    clProgramWrapper program;
+    clKernelWrapper verify;
+
+    if (gDeviceVerify)
+    {
+        int error = create_single_kernel_helper(
+            context, &program, &verify, 1, &verify_copy_kernel_code,
+            "verify_copy");
+        test_error(error, "Unable to create the verify_copy kernel");
+    }
+
     MTdata  d = init_genrand( gRandomSeed );
 
     // now test copy of partial sizes
@@ -284,7 +403,7 @@ int test_buffer_partial_copy( cl_device_id deviceID, cl_context context, cl_comm
         size = (int)get_random_float( 8.f, (float)(num_elements - srcStart), d );
         dstStart = (cl_uint)get_random_float( 0.f, (float)(num_elements - size), d );
         log_info( "random partial copy from %d to %d, size: %d: ", (int)srcStart, (int)dstStart, size );
-        if (testPartialCopy( queue, context, num_elements, srcStart, dstStart, size, d ))
+        if (testPartialCopy( queue, context, num_elements, srcStart, dstStart, size, verify, d ))
             err++;
     }
 
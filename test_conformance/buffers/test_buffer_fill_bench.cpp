@@ -0,0 +1,343 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include <stdio.h>
+#include <string.h>
+
+#include "procs.h"
+#include "harness/clImageHelper.h"
+#include "harness/benchmark.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// Fill rates of clEnqueueFillBuffer for every pattern size at an aligned
+// and an unaligned offset, and of clEnqueueFillImage for a few formats, each
+// against a kernel that writes the same values. The crossovers logged are the
+// buffer sizes from which the other way of filling is faster. A benchmark, so
+// it only runs when named.
+
+static const size_t kMinFillBytes = 64 * 1024;
+static const size_t kMaxFillBytes = (size_t)1 << 30;
+// Each sample repeats the fill until about this many bytes have been filled
+static const size_t kBytesPerSample = (size_t)1 << 28;
+static const int kMaxReps = 100;
+static const size_t kMaxPatternSize = 128;
+
+// Types of 1, 2, 4, ... 128 bytes for the fill kernel
+static const char *pattern_types[] = { "uchar",  "ushort", "uint",
+                                       "ulong",  "ulong2", "ulong4",
+                                       "ulong8", "ulong16" };
+
+static const char *fill_buffer_kernel_template = R"(
+    __kernel void fill_buffer(__global %s *dst, %s pattern)
+    {
+        dst[get_global_id(0)] = pattern;
+    }
+)";
+
+static const char *fill_image_kernel_code = R"(
+    __kernel void fill_image_f(__write_only image2d_t image, float4 color)
+    {
+        write_imagef(image, (int2)(get_global_id(0), get_global_id(1)), color);
+    }
+
+    __kernel void fill_image_ui(__write_only image2d_t image, uint4 color)
+    {
+        write_imageui(image, (int2)(get_global_id(0), get_global_id(1)),
+                      color);
+    }
+)";
+
+// Rate of back to back calls of fn, which each fill bytes bytes
+template <typename Fn>
+static cl_int time_fill(cl_command_queue queue, size_t bytes, Fn fn,
+                        BenchmarkStats &stats)
+{
+    int reps = (int)std::max((size_t)1,
+                             std::min((size_t)kMaxReps,
+                                      kBytesPerSample / bytes));
+
+    // The warmup pays for setting the fill up
+    BenchmarkOptions options;
+    options.warmup = 1;
+    options.maxSeconds = 1.0;
+    return run_benchmark(
+        options,
+        [&](double *gbps) {
+            HostTimer timer;
+            for (int i = 0; i < reps; i++)
+            {
+                cl_int error = fn();
+                if (error != CL_SUCCESS) return error;
+            }
+            cl_int error = clFinish(queue);
+            test_error(error, "clFinish failed");
+            double us = timer.elapsed_us();
+
+            *gbps = us > 0 ? (double)bytes * reps / (us * 1e3) : 0.0;
+            return CL_SUCCESS;
+        },
+        &stats);
+}
+
+// Checks the first and last pattern written from offset to the end
+static cl_int check_fill(cl_command_queue queue, cl_mem buffer, size_t size,
+                         size_t offset, const cl_uchar *pattern,
+                         size_t patternSize, const char *method)
+{
+    cl_uchar first[kMaxPatternSize], last[kMaxPatternSize];
+    cl_int error = clEnqueueReadBuffer(queue, buffer, CL_FALSE, offset,
+                                       patternSize, first, 0, NULL, NULL);
+    test_error(error, "clEnqueueReadBuffer failed");
+    error = clEnqueueReadBuffer(queue, buffer, CL_TRUE, size - patternSize,
+                                patternSize, last, 0, NULL, NULL);
+    test_error(error, "clEnqueueReadBuffer failed");
+
+    if (memcmp(first, pattern, patternSize)
+        || memcmp(last, pattern, patternSize))
+    {
+        log_error("ERROR: %s did not write the %zu byte pattern to a %zu "
+                  "byte buffer from offset %zu\n",
+                  method, patternSize, size, offset);
+        return TEST_FAIL;
+    }
+    return CL_SUCCESS;
+}
+
+static int bench_buffer_fill(cl_context context, cl_command_queue queue,
+                             size_t maxSize)
+{
+    log_benchmark_header("fill_buffer", "method/pattern/offset/bytes");
+
+    cl_uchar pattern[kMaxPatternSize];
+    for (size_t i = 0; i < kMaxPatternSize; i++)
+        pattern[i] = (cl_uchar)(0x5a + 37 * i);
+
+    clMemWrapper buffer;
+    size_t bufferSize = 0;
+
+    for (size_t p = 0; p < ARRAY_SIZE(pattern_types); p++)
+    {
+        size_t patternSize = (size_t)1 << p;
+        std::vector<char> source(strlen(fill_buffer_kernel_template) + 32);
+        snprintf(source.data(), source.size(), fill_buffer_kernel_template,
+                 pattern_types[p], pattern_types[p]);
+        const char *text = source.data();
+
+        clProgramWrapper program;
+        clKernelWrapper kernel;
+        int error = create_single_kernel_helper(context, &program, &kernel, 1,
+                                                &text, "fill_buffer");
+        test_error(error, "Unable to create the fill_buffer kernel");
+
+        // Aligned to the buffer, and one pattern into it
+        size_t offsets[] = { 0, patternSize };
+        for (size_t offset : offsets)
+        {
+            const char *faster = NULL;
+            for (size_t size = kMinFillBytes; size <= maxSize; size *= 4)
+            {
+                if (size > bufferSize)
+                {
+                    buffer.reset();
+                    buffer = clCreateBuffer(context, CL_MEM_READ_WRITE, size,
+                                            NULL, &error);
+                    test_error(error, "clCreateBuffer failed");
+                    bufferSize = size;
+                }
+
+                size_t bytes = size - offset;
+                std::string label = std::to_string(patternSize) + "/"
+                    + std::to_string(offset) + "/" + std::to_string(bytes);
+                BenchmarkStats fillStats, kernelStats;
+                error = time_fill(
+                    queue, bytes,
+                    [&]() {
+                        return clEnqueueFillBuffer(queue, buffer, pattern,
+                                                   patternSize, offset, bytes,
+                                                   0, NULL, NULL);
+                    },
+                    fillStats);
+                test_error(error, "clEnqueueFillBuffer failed");
+                error = check_fill(queue, buffer, size, offset, pattern,
+                                   patternSize, "clEnqueueFillBuffer");
+                if (error != CL_SUCCESS) return error;
+                log_benchmark_stats("fill_buffer", ("fill/" + label).c_str(),
+                                    "GB/s", true, fillStats);
+
+                error = clSetKernelArg(kernel, 0, sizeof(cl_mem), &buffer);
+                error |= clSetKernelArg(kernel, 1, patternSize, pattern);
+                test_error(error, "clSetKernelArg failed");
+
+                size_t globalOffset = offset / patternSize;
+                size_t global = bytes / patternSize;
+                error = time_fill(
+                    queue, bytes,
+                    [&]() {
+                        return clEnqueueNDRangeKernel(queue, kernel, 1,
+                                                      &globalOffset, &global,
+                                                      NULL, 0, NULL, NULL);
+                    },
+                    kernelStats);
+                test_error(error, "clEnqueueNDRangeKernel failed");
+                error = check_fill(queue, buffer, size, offset, pattern,
+                                   patternSize, "The fill kernel");
+                if (error != CL_SUCCESS) return error;
+                log_benchmark_stats("fill_buffer",
+                                    ("kernel/" + label).c_str(), "GB/s", true,
+                                    kernelStats);
+
+                const char *now = kernelStats.median > fillStats.median
+                    ? "kernel"
+                    : "fill";
+                if (faster == NULL || strcmp(now, faster))
+                    log_info("%zu byte pattern at offset %zu: the %s is "
+                             "faster from %zu bytes\n",
+                             patternSize, offset, now, bytes);
+                faster = now;
+            }
+        }
+    }
+    return CL_SUCCESS;
+}
+
+namespace {
+
+struct ImageFillFormat
+{
+    cl_image_format format;
+    bool integer;
+};
+
+} // anonymous namespace
+
+static int bench_image_fill(cl_device_id deviceID, cl_context context,
+                            cl_command_queue queue, size_t maxSize)
+{
+    static const ImageFillFormat formats[] = {
+        { { CL_R, CL_UNSIGNED_INT8 }, true },
+        { { CL_RGBA, CL_UNORM_INT8 }, false },
+        { { CL_RGBA, CL_HALF_FLOAT }, false },
+        { { CL_RGBA, CL_UNSIGNED_INT32 }, true },
+        { { CL_RGBA, CL_FLOAT }, false },
+    };
+
+    size_t maxWidth, maxHeight;
+    int error = clGetDeviceInfo(deviceID, CL_DEVICE_IMAGE2D_MAX_WIDTH,
+                                sizeof(maxWidth), &maxWidth, NULL);
+    error |= clGetDeviceInfo(deviceID, CL_DEVICE_IMAGE2D_MAX_HEIGHT,
+                             sizeof(maxHeight), &maxHeight, NULL);
+    test_error(error, "Unable to get the maximum 2D image size");
+
+    clProgramWrapper program;
+    clKernelWrapper kernels[2];
+    error = create_single_kernel_helper(context, &program, &kernels[0], 1,
+                                        &fill_image_kernel_code,
+                                        "fill_image_f");
+    test_error(error, "Unable to create the fill_image_f kernel");
+    kernels[1] = clCreateKernel(program, "fill_image_ui", &error);
+    test_error(error, "Unable to create the fill_image_ui kernel");
+
+    log_benchmark_header("fill_image", "method/order/type/side");
+
+    const float floatColor[4] = { 0.25f, 0.5f, 0.75f, 1.0f };
+    const cl_uint uintColor[4] = { 17, 34, 51, 68 };
+
+    for (const ImageFillFormat &fill : formats)
+    {
+        if (!is_image_format_supported(context, CL_MEM_WRITE_ONLY,
+                                       CL_MEM_OBJECT_IMAGE2D, &fill.format))
+            continue;
+
+        size_t pixelSize = get_pixel_bytes(&fill.format);
+        for (size_t side = 256; side <= std::min(maxWidth, maxHeight);
+             side *= 4)
+        {
+            size_t bytes = side * side * pixelSize;
+            if (bytes > maxSize) break;
+
+            clMemWrapper image = create_image_2d(
+                context, CL_MEM_WRITE_ONLY, &fill.format, side, side, 0, NULL,
+                &error);
+            test_error(error, "Unable to create image");
+
+            size_t origin[3] = { 0, 0, 0 };
+            size_t region[3] = { side, side, 1 };
+            const void *color =
+                fill.integer ? (const void *)uintColor : floatColor;
+            const cl_image_format &format = fill.format;
+            std::string label =
+                std::string(GetChannelOrderName(format.image_channel_order))
+                + "/" + GetChannelTypeName(format.image_channel_data_type) + "/"
+                + std::to_string(side);
+            BenchmarkStats stats;
+            error = time_fill(
+                queue, bytes,
+                [&]() {
+                    return clEnqueueFillImage(queue, image, color, origin,
+                                              region, 0, NULL, NULL);
+                },
+                stats);
+            test_error(error, "clEnqueueFillImage failed");
+            log_benchmark_stats("fill_image", ("fill/" + label).c_str(),
+                                "GB/s", true, stats);
+
+            cl_kernel kernel = kernels[fill.integer ? 1 : 0];
+            error = clSetKernelArg(kernel, 0, sizeof(cl_mem), &image);
+            error |= clSetKernelArg(kernel, 1, 4 * sizeof(cl_uint), color);
+            test_error(error, "clSetKernelArg failed");
+            error = time_fill(
+                queue, bytes,
+                [&]() {
+                    return clEnqueueNDRangeKernel(queue, kernel, 2, NULL,
+                                                  region, NULL, 0, NULL, NULL);
+                },
+                stats);
+            test_error(error, "clEnqueueNDRangeKernel failed");
+            log_benchmark_stats("fill_image", ("kernel/" + label).c_str(),
+                                "GB/s", true, stats);
+        }
+    }
+    return CL_SUCCESS;
+}
+
+int test_buffer_fill_bandwidth(cl_device_id deviceID, cl_context context,
+                               cl_command_queue queue, int num_elements)
+{
+    cl_ulong maxAlloc, globalMem;
+    cl_int error = clGetDeviceInfo(deviceID, CL_DEVICE_MAX_MEM_ALLOC_SIZE,
+                                   sizeof(maxAlloc), &maxAlloc, NULL);
+    test_error(error, "Unable to get CL_DEVICE_MAX_MEM_ALLOC_SIZE");
+    error = clGetDeviceInfo(deviceID, CL_DEVICE_GLOBAL_MEM_SIZE,
+                            sizeof(globalMem), &globalMem, NULL);
+    test_error(error, "Unable to get CL_DEVICE_GLOBAL_MEM_SIZE");
+    size_t maxSize = (size_t)std::min((cl_ulong)kMaxFillBytes,
+                                      std::min(maxAlloc, globalMem / 4));
+
+    error = bench_buffer_fill(context, queue, maxSize);
+    if (error != CL_SUCCESS) return TEST_FAIL;
+
+    if (checkForImageSupport(deviceID))
+    {
+        log_info("Device has no image support, skipping the image fills.\n");
+        return 0;
+    }
+    error = bench_image_fill(deviceID, context, queue, maxSize);
+    if (error != CL_SUCCESS) return TEST_FAIL;
+
+    return 0;
+}
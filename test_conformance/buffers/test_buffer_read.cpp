@@ -623,7 +623,7 @@ int test_buffer_read( cl_device_id deviceID, cl_context context, cl_command_queu
 {
     void        *outptr[5];
     void        *inptr[5];
-    clProgramWrapper program[5];
+    clProgramWrapper program;
     clKernelWrapper kernel[5];
     size_t      global_work_size[3];
     cl_int      err;
@@ -649,18 +649,17 @@ int test_buffer_read( cl_device_id deviceID, cl_context context, cl_command_queu
         return CL_SUCCESS;
     }
 
-    for (i = 0; i < loops; i++)
+    err = create_vector_width_kernels(context, &program, kernel, loops,
+                                      kernelCode, kernelName);
+    if (err)
     {
+        log_error("Creating program for %s\n", type);
+        print_error(err, " Error creating program ");
+        return -1;
+    }
 
-        err = create_single_kernel_helper(context, &program[i], &kernel[i], 1,
-                                          &kernelCode[i], kernelName[i]);
-        if (err)
-        {
-            log_error("Creating program for %s\n", type);
-            print_error(err, " Error creating program ");
-            return -1;
-        }
-
+    for (i = 0; i < loops; i++)
+    {
         for (src_flag_id = 0; src_flag_id < NUM_FLAGS; src_flag_id++)
         {
             clMemWrapper buffer;
@@ -761,7 +760,7 @@ int test_buffer_read( cl_device_id deviceID, cl_context context, cl_command_queu
 int test_buffer_read_async( cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements, size_t size, char *type, int loops,
                             const char *kernelCode[], const char *kernelName[], int (*fn)(void *,int) )
 {
-    clProgramWrapper program[5];
+    clProgramWrapper program;
     clKernelWrapper kernel[5];
     void        *outptr[5];
     void        *inptr[5];
@@ -789,68 +788,81 @@ int test_buffer_read_async( cl_device_id deviceID, cl_context context, cl_comman
         return CL_SUCCESS;
     }
 
-    for (i = 0; i < loops; i++)
+    err = create_vector_width_kernels(context, &program, kernel, loops,
+                                      kernelCode, kernelName);
+    if (err)
     {
+        log_error(" Error creating program for %s\n", type);
+        return -1;
+    }
 
-        err = create_single_kernel_helper(context, &program[i], &kernel[i], 1,
-                                          &kernelCode[i], kernelName[i]);
-        if (err)
+    auto free_ptrs = [&]() {
+        for (int j = 0; j < loops; j++)
         {
-            log_error(" Error creating program for %s\n", type);
-            return -1;
+            align_free(outptr[j]);
+            align_free(inptr[j]);
+            outptr[j] = inptr[j] = NULL;
         }
+    };
 
-        for (src_flag_id = 0; src_flag_id < NUM_FLAGS; src_flag_id++)
+    // The reads of all the widths are in flight together and checked once
+    // they are all done
+    for (src_flag_id = 0; src_flag_id < NUM_FLAGS; src_flag_id++)
+    {
+        clMemWrapper buffer[5];
+        clEventWrapper event[5];
+        for (i = 0; i < loops; i++) outptr[i] = inptr[i] = NULL;
+
+        for (i = 0; i < loops; i++)
         {
-            clMemWrapper buffer;
-            clEventWrapper event;
             outptr[i] = align_malloc(ptrSizes[i] * num_elements, min_alignment);
             if ( ! outptr[i] ){
                 log_error( " unable to allocate %d bytes for outptr\n", (int)(ptrSizes[i] * num_elements) );
+                free_ptrs();
                 return -1;
             }
             memset( outptr[i], 0, ptrSizes[i] * num_elements ); // initialize to zero to tell difference
             inptr[i] = align_malloc(ptrSizes[i] * num_elements, min_alignment);
             if ( ! inptr[i] ){
                 log_error( " unable to allocate %d bytes for inptr\n", (int)(ptrSizes[i] * num_elements) );
+                free_ptrs();
                 return -1;
             }
             memset( inptr[i], 0, ptrSizes[i] * num_elements );  // initialize to zero to tell difference
 
 
             if ((flag_set[src_flag_id] & CL_MEM_USE_HOST_PTR) || (flag_set[src_flag_id] & CL_MEM_COPY_HOST_PTR))
-                buffer =
+                buffer[i] =
                     clCreateBuffer(context, flag_set[src_flag_id],
                                    ptrSizes[i] * num_elements, inptr[i], &err);
             else
-                buffer = clCreateBuffer(context, flag_set[src_flag_id],
-                                        ptrSizes[i] * num_elements, NULL, &err);
+                buffer[i] = clCreateBuffer(context, flag_set[src_flag_id],
+                                           ptrSizes[i] * num_elements, NULL,
+                                           &err);
             if ( err != CL_SUCCESS ){
                 print_error(err, " clCreateBuffer failed\n" );
-                align_free( outptr[i] );
-                align_free( inptr[i] );
+                free_ptrs();
                 return -1;
             }
 
-            err = clSetKernelArg(kernel[i], 0, sizeof(cl_mem), (void *)&buffer);
+            err = clSetKernelArg(kernel[i], 0, sizeof(cl_mem),
+                                 (void *)&buffer[i]);
             if ( err != CL_SUCCESS ){
                 print_error( err, "clSetKernelArg failed" );
-                align_free( outptr[i] );
-                align_free( inptr[i] );
+                free_ptrs();
                 return -1;
             }
 
             err = clEnqueueNDRangeKernel( queue, kernel[i], 1, NULL, global_work_size, NULL, 0, NULL, NULL );
             if ( err != CL_SUCCESS ){
                 print_error( err, "clEnqueueNDRangeKernel failed" );
-                align_free( outptr[i] );
-                align_free( inptr[i] );
+                free_ptrs();
                 return -1;
             }
 
-            err = clEnqueueReadBuffer(queue, buffer, false, 0,
+            err = clEnqueueReadBuffer(queue, buffer[i], false, 0,
                                       ptrSizes[i] * num_elements, outptr[i], 0,
-                                      NULL, &event);
+                                      NULL, &event[i]);
 #ifdef CHECK_FOR_NON_WAIT
             size_t lastIndex = (num_elements * (1 << i) - 1) * ptrSizes[0];
             if ( ((uchar *)outptr[i])[lastIndex] ){
@@ -860,15 +872,19 @@ int test_buffer_read_async( cl_device_id deviceID, cl_context context, cl_comman
 #endif
             if ( err != CL_SUCCESS ){
                 print_error( err, "clEnqueueReadBuffer failed" );
-                align_free( outptr[i] );
-                align_free( inptr[i] );
+                clFinish(queue);
+                free_ptrs();
                 return -1;
             }
-            err = clWaitForEvents(1, &event );
+        }
+
+        for (i = 0; i < loops; i++)
+        {
+            err = clWaitForEvents(1, &event[i]);
             if ( err != CL_SUCCESS ){
                 print_error( err, "clWaitForEvents() failed" );
-                align_free( outptr[i] );
-                align_free( inptr[i] );
+                clFinish(queue);
+                free_ptrs();
                 return -1;
             }
 
@@ -881,11 +897,10 @@ int test_buffer_read_async( cl_device_id deviceID, cl_context context, cl_comman
                 log_info(" %s%d test passed. cl_mem_flags src: %s\n", type,
                          1 << i, flag_set_names[src_flag_id]);
             }
-
-            // cleanup
-            align_free( outptr[i] );
-            align_free( inptr[i] );
         }
+
+        // cleanup
+        free_ptrs();
     } // mem flags
 
 
@@ -897,7 +912,7 @@ int test_buffer_read_async( cl_device_id deviceID, cl_context context, cl_comman
 int test_buffer_read_array_barrier( cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements, size_t size, char *type, int loops,
                                     const char *kernelCode[], const char *kernelName[], int (*fn)(void *,int) )
 {
-    clProgramWrapper program[5];
+    clProgramWrapper program;
     clKernelWrapper kernel[5];
     void        *outptr[5], *inptr[5];
     size_t      global_work_size[3];
@@ -924,17 +939,16 @@ int test_buffer_read_array_barrier( cl_device_id deviceID, cl_context context, c
         return CL_SUCCESS;
     }
 
-    for (i = 0; i < loops; i++)
+    err = create_vector_width_kernels(context, &program, kernel, loops,
+                                      kernelCode, kernelName);
+    if (err)
     {
+        log_error(" Error creating program for %s\n", type);
+        return -1;
+    }
 
-        err = create_single_kernel_helper(context, &program[i], &kernel[i], 1,
-                                          &kernelCode[i], kernelName[i]);
-        if (err)
-        {
-            log_error(" Error creating program for %s\n", type);
-            return -1;
-        }
-
+    for (i = 0; i < loops; i++)
+    {
         for (src_flag_id = 0; src_flag_id < NUM_FLAGS; src_flag_id++)
         {
             clMemWrapper buffer;
@@ -1177,12 +1191,11 @@ int test_buffer_read_struct(cl_device_id deviceID, cl_context context, cl_comman
 }
 
 
-static int testRandomReadSize( cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements, cl_uint startOfRead, size_t sizeOfRead )
+static int testRandomReadSize( cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements, cl_uint startOfRead, size_t sizeOfRead,
+                               clKernelWrapper kernel[3] )
 {
     cl_mem      buffers[3];
     int         *outptr[3];
-    cl_program  program[3];
-    cl_kernel   kernel[3];
     size_t      global_work_size[3];
     cl_int      err;
     int         i, j;
@@ -1218,49 +1231,11 @@ static int testRandomReadSize( cl_device_id deviceID, cl_context context, cl_com
         }
     }
 
-    err = create_single_kernel_helper(  context, &program[0], &kernel[0], 1, &buffer_read_int_kernel_code[0], "test_buffer_read_int" );
-    if ( err ){
-        log_error( " Error creating program for int\n" );
-        for ( i = 0; i < 3; i++ ){
-            clReleaseMemObject( buffers[i] );
-            align_free( outptr[i] );
-        }
-        return -1;
-    }
-
-    err = create_single_kernel_helper(  context, &program[1], &kernel[1], 1, &buffer_read_int_kernel_code[1], "test_buffer_read_int2" );
-    if ( err ){
-        log_error( " Error creating program for int2\n" );
-        clReleaseKernel( kernel[0] );
-        clReleaseProgram( program[0] );
-        for ( i = 0; i < 3; i++ ){
-            clReleaseMemObject( buffers[i] );
-            align_free( outptr[i] );
-        }
-        return -1;
-    }
-
-    err = create_single_kernel_helper(  context, &program[2], &kernel[2], 1, &buffer_read_int_kernel_code[2], "test_buffer_read_int4" );
-    if ( err ){
-        log_error( " Error creating program for int4\n" );
-        clReleaseKernel( kernel[0] );
-        clReleaseProgram( program[0] );
-        clReleaseKernel( kernel[1] );
-        clReleaseProgram( program[1] );
-        for ( i = 0; i < 3; i++ ){
-            clReleaseMemObject( buffers[i] );
-            align_free( outptr[i] );
-        }
-        return -1;
-    }
-
     for (i=0; i<3; i++){
         err = clSetKernelArg( kernel[i], 0, sizeof( cl_mem ), (void *)&buffers[i] );
         if ( err != CL_SUCCESS ){
             print_error( err, "clSetKernelArgs failed" );
             clReleaseMemObject( buffers[i] );
-            clReleaseKernel( kernel[i] );
-            clReleaseProgram( program[i] );
             align_free( outptr[i] );
             return -1;
         }
@@ -1269,8 +1244,6 @@ static int testRandomReadSize( cl_device_id deviceID, cl_context context, cl_com
         if ( err != CL_SUCCESS ){
             print_error( err, "clEnqueueNDRangeKernel failed" );
             clReleaseMemObject( buffers[i] );
-            clReleaseKernel( kernel[i] );
-            clReleaseProgram( program[i] );
             align_free( outptr[i] );
             return -1;
         }
@@ -1279,8 +1252,6 @@ static int testRandomReadSize( cl_device_id deviceID, cl_context context, cl_com
         if ( err != CL_SUCCESS ){
             print_error( err, "clEnqueueReadBuffer failed" );
             clReleaseMemObject( buffers[i] );
-            clReleaseKernel( kernel[i] );
-            clReleaseProgram( program[i] );
             align_free( outptr[i] );
             return -1;
         }
@@ -1295,8 +1266,6 @@ static int testRandomReadSize( cl_device_id deviceID, cl_context context, cl_com
 
         // cleanup
         clReleaseMemObject( buffers[i] );
-        clReleaseKernel( kernel[i] );
-        clReleaseProgram( program[i] );
         align_free( outptr[i] );
     }
 
@@ -1311,13 +1280,26 @@ int test_buffer_read_random_size(cl_device_id deviceID, cl_context context, cl_c
     int     i;
     cl_uint start;
     size_t  size;
+    clProgramWrapper program;
+    clKernelWrapper kernel[3];
+
+    // int, int2 and int4
+    err = create_vector_width_kernels(context, &program, kernel, 3,
+                                      buffer_read_int_kernel_code,
+                                      int_kernel_name);
+    if (err)
+    {
+        log_error(" Error creating program for int\n");
+        return -1;
+    }
+
     MTdata  d = init_genrand( gRandomSeed );
 
     // now test for random sizes of array being read
     for ( i = 0; i < 8; i++ ){
         start = (cl_uint)get_random_float( 0.f, (float)(num_elements - 8), d );
         size = (size_t)get_random_float( 8.f, (float)(num_elements - start), d );
-        if (testRandomReadSize( deviceID, context, queue, num_elements, start, size ))
+        if (testRandomReadSize( deviceID, context, queue, num_elements, start, size, kernel ))
             err++;
     }
 
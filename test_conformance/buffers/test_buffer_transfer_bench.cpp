@@ -0,0 +1,417 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include <stdio.h>
+#include <string.h>
+
+#include "procs.h"
+#include "harness/alloc.h"
+#include "harness/benchmark.h"
+#include "harness/perfMetrics.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Host to device and device to host transfer rates of the host-visible
+// memory paths, so applications can choose between them. A benchmark, so it
+// only runs when named.
+
+static const size_t kMinTransferBytes = 4 * 1024;
+static const size_t kMaxTransferBytes = (size_t)1 << 30;
+static const size_t kPageSize = 4096;
+// A map that costs less than this fraction of copying the data can't have
+// copied it
+static const double kZeroCopyRatio = 0.1;
+
+namespace {
+
+// One way of getting data between host memory and the device. Write and
+// Read move size bytes and return once the data is visible on the other
+// side.
+struct TransferPath
+{
+    TransferPath(cl_context context, cl_command_queue queue)
+        : context(context), queue(queue)
+    {}
+    virtual ~TransferPath() {}
+
+    virtual const char *Name() const = 0;
+    virtual cl_int Allocate(size_t size) = 0;
+    virtual void Free() = 0;
+    virtual cl_int Write(const char *src, size_t size) = 0;
+    virtual cl_int Read(char *dst, size_t size) = 0;
+
+    // Paths that are accessed through a mapping report the cost of mapping
+    // and unmapping alone, and whether the mapping is the memory they were
+    // given, to tell whether the driver copied anything
+    virtual bool Mapped() const { return false; }
+    virtual cl_int MapUnmap(size_t size) { return CL_INVALID_OPERATION; }
+    virtual bool SamePointer() const { return false; }
+
+    cl_context context;
+    cl_command_queue queue;
+};
+
+struct ReadWritePath : public TransferPath
+{
+    using TransferPath::TransferPath;
+
+    const char *Name() const override { return "read_write"; }
+
+    cl_int Allocate(size_t size) override
+    {
+        cl_int error;
+        buffer = clCreateBuffer(context, CL_MEM_READ_WRITE, size, NULL, &error);
+        test_error(error, "clCreateBuffer failed");
+        return CL_SUCCESS;
+    }
+
+    void Free() override { buffer.reset(); }
+
+    cl_int Write(const char *src, size_t size) override
+    {
+        cl_int error = clEnqueueWriteBuffer(queue, buffer, CL_TRUE, 0, size,
+                                            src, 0, NULL, NULL);
+        test_error(error, "clEnqueueWriteBuffer failed");
+        return CL_SUCCESS;
+    }
+
+    cl_int Read(char *dst, size_t size) override
+    {
+        cl_int error = clEnqueueReadBuffer(queue, buffer, CL_TRUE, 0, size,
+                                           dst, 0, NULL, NULL);
+        test_error(error, "clEnqueueReadBuffer failed");
+        return CL_SUCCESS;
+    }
+
+    clMemWrapper buffer;
+};
+
+// Paths that write through a CL_MAP_WRITE_INVALIDATE_REGION mapping and
+// read through a CL_MAP_READ one
+struct MappedPath : public TransferPath
+{
+    using TransferPath::TransferPath;
+
+    virtual void *Map(cl_map_flags flags, size_t size, cl_int &error) = 0;
+    virtual cl_int Unmap(void *ptr) = 0;
+    // The memory the mapping would be if nothing was copied, if known
+    virtual void *Backing() { return NULL; }
+
+    bool Mapped() const override { return true; }
+    bool SamePointer() const override { return same_pointer; }
+
+    cl_int Access(cl_map_flags flags, char *dst, const char *src, size_t size)
+    {
+        cl_int error;
+        char *ptr = (char *)Map(flags, size, error);
+        test_error(error, "Unable to map memory");
+
+        same_pointer = Backing() != NULL && ptr == Backing();
+        if (dst) memcpy(dst, ptr, size);
+        if (src) memcpy(ptr, src, size);
+
+        error = Unmap(ptr);
+        test_error(error, "Unable to unmap memory");
+        error = clFinish(queue);
+        test_error(error, "clFinish failed");
+        return CL_SUCCESS;
+    }
+
+    cl_int Write(const char *src, size_t size) override
+    {
+        return Access(CL_MAP_WRITE_INVALIDATE_REGION, NULL, src, size);
+    }
+
+    cl_int Read(char *dst, size_t size) override
+    {
+        return Access(CL_MAP_READ, dst, NULL, size);
+    }
+
+    cl_int MapUnmap(size_t size) override
+    {
+        return Access(CL_MAP_READ, NULL, NULL, size);
+    }
+
+    bool same_pointer = false;
+};
+
+struct BufferMapPath : public MappedPath
+{
+    BufferMapPath(cl_context context, cl_command_queue queue,
+                  cl_mem_flags flags, const char *name)
+        : MappedPath(context, queue), flags(flags), name(name)
+    {}
+
+    const char *Name() const override { return name; }
+
+    cl_int Allocate(size_t size) override
+    {
+        cl_int error;
+        buffer = clCreateBuffer(context, CL_MEM_READ_WRITE | flags, size, NULL,
+                                &error);
+        test_error(error, "clCreateBuffer failed");
+        return CL_SUCCESS;
+    }
+
+    void Free() override { buffer.reset(); }
+
+    void *Map(cl_map_flags map_flags, size_t size, cl_int &error) override
+    {
+        return clEnqueueMapBuffer(queue, buffer, CL_TRUE, map_flags, 0, size, 0,
+                                  NULL, NULL, &error);
+    }
+
+    cl_int Unmap(void *ptr) override
+    {
+        return clEnqueueUnmapMemObject(queue, buffer, ptr, 0, NULL, NULL);
+    }
+
+    cl_mem_flags flags;
+    const char *name;
+    clMemWrapper buffer;
+};
+
+// CL_MEM_USE_HOST_PTR over page-aligned memory, which is what drivers need
+// to use the memory in place
+struct UseHostPtrPath : public BufferMapPath
+{
+    UseHostPtrPath(cl_context context, cl_command_queue queue)
+        : BufferMapPath(context, queue, CL_MEM_USE_HOST_PTR, "use_host_ptr")
+    {}
+
+    cl_int Allocate(size_t size) override
+    {
+        host.reset(align_malloc(size, kPageSize), NULL, 0, size, true);
+        if (!host)
+        {
+            log_error("ERROR: Unable to allocate %zu bytes of host memory\n",
+                      size);
+            return CL_OUT_OF_HOST_MEMORY;
+        }
+
+        cl_int error;
+        buffer = clCreateBuffer(context, CL_MEM_READ_WRITE | flags, size,
+                                (char *)host, &error);
+        test_error(error, "clCreateBuffer failed");
+        return CL_SUCCESS;
+    }
+
+    void Free() override
+    {
+        buffer.reset();
+        host.reset(NULL);
+    }
+
+    void *Backing() override { return host; }
+
+    BufferOwningPtr<char> host;
+};
+
+struct SVMPath : public MappedPath
+{
+    SVMPath(cl_context context, cl_command_queue queue, cl_svm_mem_flags flags,
+            const char *name)
+        : MappedPath(context, queue), flags(flags), name(name)
+    {}
+    ~SVMPath() { Free(); }
+
+    const char *Name() const override { return name; }
+
+    cl_int Allocate(size_t size) override
+    {
+        ptr = clSVMAlloc(context, CL_MEM_READ_WRITE | flags, size, 0);
+        if (!ptr)
+        {
+            log_error("ERROR: clSVMAlloc of %zu bytes failed\n", size);
+            return CL_OUT_OF_RESOURCES;
+        }
+        return CL_SUCCESS;
+    }
+
+    void Free() override
+    {
+        if (ptr) clSVMFree(context, ptr);
+        ptr = NULL;
+    }
+
+    // Mapping is a no-op for fine-grain SVM, but it is what portable code
+    // does, so it is part of the measurement for both
+    void *Map(cl_map_flags map_flags, size_t size, cl_int &error) override
+    {
+        error = clEnqueueSVMMap(queue, CL_TRUE, map_flags, ptr, size, 0, NULL,
+                                NULL);
+        return ptr;
+    }
+
+    cl_int Unmap(void *mapped) override
+    {
+        return clEnqueueSVMUnmap(queue, mapped, 0, NULL, NULL);
+    }
+
+    void *Backing() override { return ptr; }
+
+    cl_svm_mem_flags flags;
+    const char *name;
+    void *ptr = NULL;
+};
+
+} // anonymous namespace
+
+// Time of one call of fn, in us
+template <typename Fn>
+static cl_int time_transfer(Fn fn, BenchmarkStats &stats)
+{
+    BenchmarkOptions options;
+    options.warmup = 1;
+    options.maxSeconds = 1.0;
+    return run_benchmark(
+        options,
+        [&](double *us) {
+            HostTimer timer;
+            cl_int error = fn();
+            *us = timer.elapsed_us();
+            return error;
+        },
+        &stats);
+}
+
+static void report_transfer(const char *path, const char *direction,
+                            size_t size, const BenchmarkStats &stats)
+{
+    std::string label =
+        std::string(path) + "/" + direction + "/" + std::to_string(size);
+    log_benchmark_stats("buffer_transfer", label.c_str(), "us", false, stats);
+    record_perf_metric("buffer_transfer_GBps." + label,
+                       stats.median > 0 ? size / (stats.median * 1e3) : 0.0,
+                       "GB/s", true);
+}
+
+// copyUs holds the read_write read times for each size, the cost of
+// actually copying the data
+static int bench_path(TransferPath &path, const std::vector<size_t> &sizes,
+                      char *src, char *dst, std::vector<double> &copyUs)
+{
+    bool baseline = copyUs.empty();
+    for (size_t i = 0; i < sizes.size(); i++)
+    {
+        size_t size = sizes[i];
+        cl_int error = path.Allocate(size);
+        if (error != CL_SUCCESS) return error;
+
+        BenchmarkStats stats;
+        error = time_transfer([&]() { return path.Write(src, size); }, stats);
+        if (error != CL_SUCCESS) return error;
+        report_transfer(path.Name(), "write", size, stats);
+
+        error = time_transfer([&]() { return path.Read(dst, size); }, stats);
+        if (error != CL_SUCCESS) return error;
+        report_transfer(path.Name(), "read", size, stats);
+        if (baseline) copyUs.push_back(stats.median);
+
+        if (memcmp(src, dst, size))
+        {
+            log_error("ERROR: Data read back through %s differs from the "
+                      "data written for %zu bytes\n",
+                      path.Name(), size);
+            return TEST_FAIL;
+        }
+
+        if (path.Mapped())
+        {
+            error =
+                time_transfer([&]() { return path.MapUnmap(size); }, stats);
+            if (error != CL_SUCCESS) return error;
+            report_transfer(path.Name(), "map_unmap", size, stats);
+
+            bool zeroCopy = stats.median < kZeroCopyRatio * copyUs[i];
+            log_info("%s, %zu bytes: mapping and unmapping takes %.2f us "
+                     "against %.2f us to copy, %s pointer, %s\n",
+                     path.Name(), size, stats.median, copyUs[i],
+                     path.SamePointer() ? "same" : "different",
+                     zeroCopy ? "zero copy" : "copied");
+        }
+
+        path.Free();
+    }
+    return CL_SUCCESS;
+}
+
+int test_buffer_transfer_bandwidth(cl_device_id deviceID, cl_context context,
+                                   cl_command_queue queue, int num_elements)
+{
+    cl_ulong maxAlloc, globalMem;
+    cl_int error = clGetDeviceInfo(deviceID, CL_DEVICE_MAX_MEM_ALLOC_SIZE,
+                                   sizeof(maxAlloc), &maxAlloc, NULL);
+    test_error(error, "Unable to get CL_DEVICE_MAX_MEM_ALLOC_SIZE");
+    error = clGetDeviceInfo(deviceID, CL_DEVICE_GLOBAL_MEM_SIZE,
+                            sizeof(globalMem), &globalMem, NULL);
+    test_error(error, "Unable to get CL_DEVICE_GLOBAL_MEM_SIZE");
+
+    size_t maxSize = (size_t)std::min(
+        (cl_ulong)kMaxTransferBytes, std::min(maxAlloc, globalMem / 4));
+    std::vector<size_t> sizes;
+    for (size_t size = kMinTransferBytes; size <= maxSize; size *= 4)
+        sizes.push_back(size);
+
+    BufferOwningPtr<char> src, dst;
+    src.reset(align_malloc(maxSize, kPageSize), NULL, 0, maxSize, true);
+    dst.reset(align_malloc(maxSize, kPageSize), NULL, 0, maxSize, true);
+    if (!src || !dst)
+    {
+        log_error("ERROR: Unable to allocate %zu bytes of host memory\n",
+                  maxSize);
+        return TEST_FAIL;
+    }
+    for (size_t i = 0; i < maxSize; i++) src[i] = (char)(i * 7 + (i >> 12));
+
+    std::vector<std::unique_ptr<TransferPath>> paths;
+    paths.emplace_back(new ReadWritePath(context, queue));
+    paths.emplace_back(new BufferMapPath(context, queue, 0, "map"));
+    paths.emplace_back(new BufferMapPath(context, queue, CL_MEM_ALLOC_HOST_PTR,
+                                         "map_alloc_host_ptr"));
+    paths.emplace_back(new UseHostPtrPath(context, queue));
+
+    cl_device_svm_capabilities svmCaps = 0;
+    if (get_device_cl_version(deviceID) >= Version(2, 0))
+    {
+        error = clGetDeviceInfo(deviceID, CL_DEVICE_SVM_CAPABILITIES,
+                                sizeof(svmCaps), &svmCaps, NULL);
+        test_error(error, "Unable to get CL_DEVICE_SVM_CAPABILITIES");
+    }
+    if (svmCaps & CL_DEVICE_SVM_COARSE_GRAIN_BUFFER)
+        paths.emplace_back(new SVMPath(context, queue, 0, "svm_coarse"));
+    if (svmCaps & CL_DEVICE_SVM_FINE_GRAIN_BUFFER)
+        paths.emplace_back(new SVMPath(context, queue,
+                                       CL_MEM_SVM_FINE_GRAIN_BUFFER,
+                                       "svm_fine"));
+
+    log_benchmark_header("buffer_transfer", "path/direction/bytes");
+
+    std::vector<double> copyUs;
+    for (auto &path : paths)
+    {
+        error = bench_path(*path, sizes, src, dst, copyUs);
+        if (error != CL_SUCCESS)
+        {
+            log_error("ERROR: Unable to measure the %s path\n", path->Name());
+            return TEST_FAIL;
+        }
+    }
+
+    return 0;
+}
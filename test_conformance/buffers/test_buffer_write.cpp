@@ -625,7 +625,7 @@ int test_buffer_write( cl_device_id deviceID, cl_context context, cl_command_que
                        void *inptr[5], const char *kernelCode[], const char *kernelName[], int (*fn)(void *,void *,int), MTdata d )
 {
     void        *outptr[5];
-    clProgramWrapper program[5];
+    clProgramWrapper program;
     clKernelWrapper kernel[5];
     size_t      ptrSizes[5];
     size_t      global_work_size[3];
@@ -645,16 +645,16 @@ int test_buffer_write( cl_device_id deviceID, cl_context context, cl_command_que
     ptrSizes[4] = ptrSizes[3] << 1;
 
     loops = (loops < 5 ? loops : 5);
-    for (i = 0; i < loops; i++)
+    err = create_vector_width_kernels(context, &program, kernel, loops,
+                                      kernelCode, kernelName);
+    if (err)
     {
-        err = create_single_kernel_helper(context, &program[i], &kernel[i], 1,
-                                          &kernelCode[i], kernelName[i]);
-        if (err)
-        {
-            log_error(" Error creating program for %s\n", type);
-            return -1;
-        }
+        log_error(" Error creating program for %s\n", type);
+        return -1;
+    }
 
+    for (i = 0; i < loops; i++)
+    {
         for (src_flag_id = 0; src_flag_id < NUM_FLAGS; src_flag_id++)
         {
             for (dst_flag_id = 0; dst_flag_id < NUM_FLAGS; dst_flag_id++)
@@ -971,8 +971,8 @@ int test_buffer_write_array_async( cl_device_id deviceID, cl_context context, cl
 {
     cl_mem      buffers[10];
     void        *outptr[5];
-    cl_program  program[5];
-    cl_kernel   kernel[5];
+    clProgramWrapper program;
+    clKernelWrapper kernel[5];
     cl_event    event[2];
     size_t      ptrSizes[5];
     size_t      global_work_size[3];
@@ -991,11 +991,19 @@ int test_buffer_write_array_async( cl_device_id deviceID, cl_context context, cl
     ptrSizes[3] = ptrSizes[2] << 1;
     ptrSizes[4] = ptrSizes[3] << 1;
 
+    loops = ( loops < 5 ? loops : 5 );
+    err = create_vector_width_kernels(context, &program, kernel, loops,
+                                      kernelCode, kernelName);
+    if (err)
+    {
+        log_error(" Error creating program for %s\n", type);
+        return -1;
+    }
+
     for (src_flag_id=0; src_flag_id < NUM_FLAGS; src_flag_id++) {
         for (dst_flag_id=0; dst_flag_id < NUM_FLAGS; dst_flag_id++) {
             log_info("Testing with cl_mem_flags src: %s dst: %s\n", flag_set_names[src_flag_id], flag_set_names[dst_flag_id]);
 
-            loops = ( loops < 5 ? loops : 5 );
             for ( i = 0; i < loops; i++ ){
                 ii = i << 1;
                 if ((flag_set[src_flag_id] & CL_MEM_USE_HOST_PTR) || (flag_set[src_flag_id] & CL_MEM_COPY_HOST_PTR))
@@ -1023,21 +1031,10 @@ int test_buffer_write_array_async( cl_device_id deviceID, cl_context context, cl
                     return -1;
                 }
 
-                err = create_single_kernel_helper( context, &program[i], &kernel[i], 1, &kernelCode[i], kernelName[i] );
-                if ( err ){
-                    log_error( " Error creating program for %s\n", type );
-                    clReleaseMemObject( buffers[ii] );
-                    clReleaseMemObject( buffers[ii+1] );
-                    align_free( outptr[i] );
-                    return -1;
-                }
-
                 err = clSetKernelArg( kernel[i], 0, sizeof( cl_mem ), (void *)&buffers[ii] );
                 err |= clSetKernelArg( kernel[i], 1, sizeof( cl_mem ), (void *)&buffers[ii+1] );
                 if ( err != CL_SUCCESS ){
                     print_error( err, "clSetKernelArg failed" );
-                    clReleaseKernel( kernel[i] );
-                    clReleaseProgram( program[i] );
                     clReleaseMemObject( buffers[ii] );
                     clReleaseMemObject( buffers[ii+1] );
                     align_free( outptr[i] );
@@ -1047,8 +1044,6 @@ int test_buffer_write_array_async( cl_device_id deviceID, cl_context context, cl
                 err = clWaitForEvents(  1, &(event[0]) );
                 if ( err != CL_SUCCESS ){
                     print_error( err, "clWaitForEvents() failed" );
-                    clReleaseKernel( kernel[i] );
-                    clReleaseProgram( program[i] );
                     clReleaseMemObject( buffers[ii] );
                     clReleaseMemObject( buffers[ii+1] );
                     align_free( outptr[i] );
@@ -1086,8 +1081,6 @@ int test_buffer_write_array_async( cl_device_id deviceID, cl_context context, cl
                 clReleaseEvent( event[1] );
                 clReleaseMemObject( buffers[ii] );
                 clReleaseMemObject( buffers[ii+1] );
-                clReleaseKernel( kernel[i] );
-                clReleaseProgram( program[i] );
                 align_free( outptr[i] );
             }
         } // dst cl_mem_flag
@@ -0,0 +1,306 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include <stdio.h>
+#include <string.h>
+
+#include "procs.h"
+#include "harness/benchmark.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// The overheads of carving a large pool into sub-buffers: the cost of
+// creating and releasing thousands of them, of kernels on disjoint and on
+// overlapping sub-buffers of the pool against the same kernels on the pool
+// itself, and the latency of migrating a buffer to the host and back with
+// and without CL_MIGRATE_MEM_OBJECT_CONTENT_UNDEFINED. A benchmark, so it only
+// runs when named.
+
+static const size_t kPoolBytes = (size_t)256 << 20;
+static const size_t kSubBufferCounts[] = { 1024, 4096, 16384 };
+// Work-items per kernel, small enough for the launch overhead to show
+static const size_t kTouchItems = 1024;
+static const size_t kMigrateBytes[] = { (size_t)1 << 20, (size_t)16 << 20,
+                                        (size_t)256 << 20 };
+
+static const char *touch_kernel_code = R"(
+    __kernel void touch(__global uint *data, uint offset)
+    {
+        data[offset + get_global_id(0)] += 1;
+    }
+)";
+
+static BenchmarkOptions sub_buffer_options()
+{
+    BenchmarkOptions options;
+    options.warmup = 1;
+    options.maxSeconds = 1.0;
+    return options;
+}
+
+// Creates count sub-buffers of size bytes, step bytes apart, and releases
+// them, giving the average time of each creation, or of each release
+static int sample_create_release(cl_mem pool, size_t count, size_t step,
+                                 size_t size, bool release, double *us)
+{
+    std::vector<cl_mem> subBuffers(count);
+
+    HostTimer timer;
+    for (size_t i = 0; i < count; i++)
+    {
+        cl_buffer_region region = { i * step, size };
+        cl_int error;
+        subBuffers[i] =
+            clCreateSubBuffer(pool, CL_MEM_READ_WRITE,
+                              CL_BUFFER_CREATE_TYPE_REGION, &region, &error);
+        if (error != CL_SUCCESS)
+        {
+            print_error(error, "clCreateSubBuffer failed");
+            for (size_t j = 0; j < i; j++) clReleaseMemObject(subBuffers[j]);
+            return error;
+        }
+    }
+    double createdUs = timer.elapsed_us();
+    for (cl_mem subBuffer : subBuffers) clReleaseMemObject(subBuffer);
+    double releasedUs = timer.elapsed_us();
+
+    *us = (release ? releasedUs - createdUs : createdUs) / count;
+    return CL_SUCCESS;
+}
+
+static int bench_create_release(cl_mem pool, size_t count, size_t step,
+                                size_t size)
+{
+    for (bool release : { false, true })
+    {
+        BenchmarkStats stats;
+        cl_int error = run_benchmark(
+            sub_buffer_options(),
+            [&](double *us) {
+                return sample_create_release(pool, count, step, size, release,
+                                             us);
+            },
+            &stats);
+        if (error != CL_SUCCESS) return error;
+        std::string label = std::string(release ? "release" : "create") + "/"
+            + std::to_string(count) + "/" + std::to_string(size);
+        log_benchmark_stats("sub_buffer_create_release", label.c_str(), "us",
+                            false, stats);
+    }
+    return CL_SUCCESS;
+}
+
+// Runs the touch kernel once on each of count sub-buffers, size bytes long
+// and step bytes apart, or on the pool at the same offsets if step is 0,
+// and gives the average time of each kernel
+static int bench_touch(cl_context context, cl_command_queue queue,
+                       cl_kernel kernel, cl_mem pool, size_t count,
+                       size_t step, size_t size, const char *layout)
+{
+    std::vector<clMemWrapper> subBuffers;
+    bool onPool = !strcmp(layout, "pool");
+    cl_int error;
+    if (!onPool)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            cl_buffer_region region = { i * step, size };
+            subBuffers.push_back(clCreateSubBuffer(
+                pool, CL_MEM_READ_WRITE, CL_BUFFER_CREATE_TYPE_REGION, &region,
+                &error));
+            test_error(error, "clCreateSubBuffer failed");
+        }
+    }
+
+    size_t global = std::min(kTouchItems, size / sizeof(cl_uint));
+    auto enqueue = [&](size_t i) {
+        cl_mem buffer = onPool ? pool : (cl_mem)subBuffers[i];
+        cl_uint offset = onPool ? (cl_uint)(i * step / sizeof(cl_uint)) : 0;
+        cl_int err = clSetKernelArg(kernel, 0, sizeof(buffer), &buffer);
+        err |= clSetKernelArg(kernel, 1, sizeof(offset), &offset);
+        test_error(err, "clSetKernelArg failed");
+        err = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &global, NULL, 0,
+                                     NULL, NULL);
+        test_error(err, "clEnqueueNDRangeKernel failed");
+        return CL_SUCCESS;
+    };
+
+    // The warmup pays for the first use of each sub-buffer
+    BenchmarkStats stats;
+    error = run_benchmark(
+        sub_buffer_options(),
+        [&](double *us) {
+            HostTimer timer;
+            for (size_t i = 0; i < count; i++)
+            {
+                cl_int err = enqueue(i);
+                if (err != CL_SUCCESS) return err;
+            }
+            cl_int err = clFinish(queue);
+            test_error(err, "clFinish failed");
+            *us = timer.elapsed_us() / count;
+            return CL_SUCCESS;
+        },
+        &stats);
+    if (error != CL_SUCCESS) return error;
+
+    std::string label = std::string(layout) + "/" + std::to_string(count) + "/"
+        + std::to_string(size);
+    log_benchmark_stats("sub_buffer_touch", label.c_str(), "us", false, stats);
+    return CL_SUCCESS;
+}
+
+// Latency of migrating buffer, which a kernel has just written, to the host
+// with extraFlags, or of migrating it back to the device after that
+static int sample_migrate(cl_command_queue queue, cl_kernel kernel,
+                          cl_mem buffer, size_t global,
+                          cl_mem_migration_flags extraFlags, bool toDevice,
+                          double *us)
+{
+    // Give the buffer contents on the device that a full migration has to
+    // move
+    cl_int error = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &global,
+                                          NULL, 0, NULL, NULL);
+    test_error(error, "clEnqueueNDRangeKernel failed");
+    error = clFinish(queue);
+    test_error(error, "clFinish failed");
+
+    HostTimer timer;
+    error = clEnqueueMigrateMemObjects(queue, 1, &buffer,
+                                       CL_MIGRATE_MEM_OBJECT_HOST | extraFlags,
+                                       0, NULL, NULL);
+    test_error(error, "clEnqueueMigrateMemObjects failed");
+    error = clFinish(queue);
+    test_error(error, "clFinish failed");
+    double onHostUs = timer.elapsed_us();
+    error = clEnqueueMigrateMemObjects(queue, 1, &buffer, extraFlags, 0, NULL,
+                                       NULL);
+    test_error(error, "clEnqueueMigrateMemObjects failed");
+    error = clFinish(queue);
+    test_error(error, "clFinish failed");
+    double onDeviceUs = timer.elapsed_us();
+
+    *us = toDevice ? onDeviceUs - onHostUs : onHostUs;
+    return CL_SUCCESS;
+}
+
+static int bench_migrate(cl_context context, cl_command_queue queue,
+                         cl_kernel kernel, size_t size,
+                         cl_mem_migration_flags extraFlags, const char *name)
+{
+    cl_int error;
+    clMemWrapper buffer =
+        clCreateBuffer(context, CL_MEM_READ_WRITE, size, NULL, &error);
+    test_error(error, "clCreateBuffer failed");
+
+    cl_uint offset = 0;
+    error = clSetKernelArg(kernel, 0, sizeof(cl_mem), &buffer);
+    error |= clSetKernelArg(kernel, 1, sizeof(offset), &offset);
+    test_error(error, "clSetKernelArg failed");
+    size_t global = size / sizeof(cl_uint);
+
+    // The warmup pays for setting the buffer up
+    for (bool toDevice : { false, true })
+    {
+        BenchmarkStats stats;
+        error = run_benchmark(
+            sub_buffer_options(),
+            [&](double *us) {
+                return sample_migrate(queue, kernel, buffer, global,
+                                      extraFlags, toDevice, us);
+            },
+            &stats);
+        if (error != CL_SUCCESS) return error;
+        std::string label = std::string(toDevice ? "to_device" : "to_host")
+            + "/" + name + "/" + std::to_string(size);
+        log_benchmark_stats("sub_buffer_migrate", label.c_str(), "us", false,
+                            stats);
+    }
+    return CL_SUCCESS;
+}
+
+int test_sub_buffer_overhead(cl_device_id deviceID, cl_context context,
+                             cl_command_queue queue, int num_elements)
+{
+    cl_uint alignBits;
+    cl_ulong maxAlloc;
+    cl_int error = clGetDeviceInfo(deviceID, CL_DEVICE_MEM_BASE_ADDR_ALIGN,
+                                   sizeof(alignBits), &alignBits, NULL);
+    test_error(error, "Unable to get CL_DEVICE_MEM_BASE_ADDR_ALIGN");
+    error = clGetDeviceInfo(deviceID, CL_DEVICE_MAX_MEM_ALLOC_SIZE,
+                            sizeof(maxAlloc), &maxAlloc, NULL);
+    test_error(error, "Unable to get CL_DEVICE_MAX_MEM_ALLOC_SIZE");
+    size_t align = alignBits / 8;
+    size_t poolBytes = (size_t)std::min((cl_ulong)kPoolBytes, maxAlloc);
+
+    clMemWrapper pool =
+        clCreateBuffer(context, CL_MEM_READ_WRITE, poolBytes, NULL, &error);
+    test_error(error, "Unable to create the pool buffer");
+    cl_uint zero = 0;
+    error = clEnqueueFillBuffer(queue, pool, &zero, sizeof(zero), 0, poolBytes,
+                                0, NULL, NULL);
+    test_error(error, "clEnqueueFillBuffer failed");
+
+    clProgramWrapper program;
+    clKernelWrapper kernel;
+    error = create_single_kernel_helper(context, &program, &kernel, 1,
+                                        &touch_kernel_code, "touch");
+    test_error(error, "Unable to create the touch kernel");
+
+    log_benchmark_header("sub_buffer_create_release", "phase/count/bytes");
+    log_benchmark_header("sub_buffer_touch", "layout/count/bytes");
+    for (size_t count : kSubBufferCounts)
+    {
+        // Sub-buffer origins have to be aligned to the base address
+        // alignment, and the overlapping ones span two steps
+        size_t step = poolBytes / (count + 1) / align * align;
+        if (step < align)
+        {
+            log_info("Pool of %zu bytes too small for %zu sub-buffers, "
+                     "skipping.\n",
+                     poolBytes, count);
+            continue;
+        }
+
+        error = bench_create_release(pool, count, step, step);
+        if (error != CL_SUCCESS) return TEST_FAIL;
+
+        error = bench_touch(context, queue, kernel, pool, count, step, step,
+                            "pool");
+        if (error != CL_SUCCESS) return TEST_FAIL;
+        error = bench_touch(context, queue, kernel, pool, count, step, step,
+                            "disjoint");
+        if (error != CL_SUCCESS) return TEST_FAIL;
+        error = bench_touch(context, queue, kernel, pool, count, step,
+                            2 * step, "overlapping");
+        if (error != CL_SUCCESS) return TEST_FAIL;
+    }
+
+    log_benchmark_header("sub_buffer_migrate", "direction/flags/bytes");
+    for (size_t size : kMigrateBytes)
+    {
+        if (size > maxAlloc) break;
+        error = bench_migrate(context, queue, kernel, size, 0, "full");
+        if (error != CL_SUCCESS) return TEST_FAIL;
+        error =
+            bench_migrate(context, queue, kernel, size,
+                          CL_MIGRATE_MEM_OBJECT_CONTENT_UNDEFINED, "undefined");
+        if (error != CL_SUCCESS) return TEST_FAIL;
+    }
+
+    return 0;
+}
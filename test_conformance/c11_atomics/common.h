@@ -22,6 +22,9 @@
 
 #include "host_atomics.h"
 
+#include <algorithm>
+#include <chrono>
+#include <map>
 #include <vector>
 #include <sstream>
 
@@ -69,6 +72,7 @@ extern int gInternalIterations; // internal test iterations for atomic
                                 // operation, sufficient to verify atomicity
 extern int
     gMaxDeviceThreads; // maximum number of threads executed on OCL device
+extern bool gContention; // report throughput of the contended atomic phase
 extern cl_device_atomic_capabilities gAtomicMemCap,
     gAtomicFenceCap; // atomic memory and fence capabilities for this device
 
@@ -116,6 +120,57 @@ public:
     }
 };
 
+// Number of per-thread values reduced by one thread pool job. Small enough
+// that a tile of 64-bit values stays in the L2 cache of the worker.
+const cl_uint REDUCE_TILE_SIZE = 16384;
+
+template <typename HostDataType, typename Term, typename Combine>
+class CReduceOverThreads {
+public:
+    CReduceOverThreads(cl_uint count, Term term, Combine combine)
+        : _count(count), _term(term), _combine(combine),
+          _partials((count + REDUCE_TILE_SIZE - 1) / REDUCE_TILE_SIZE)
+    {}
+    static cl_int ReduceTile(cl_uint job_id, cl_uint thread_id, void *userInfo)
+    {
+        CReduceOverThreads *reduce = (CReduceOverThreads *)userInfo;
+        cl_uint first = job_id * REDUCE_TILE_SIZE;
+        cl_uint last = std::min(reduce->_count, first + REDUCE_TILE_SIZE);
+        HostDataType partial = reduce->_term(first);
+        for (cl_uint i = first + 1; i < last; i++)
+            partial = reduce->_combine(partial, reduce->_term(i));
+        reduce->_partials[job_id] = partial;
+        return 0;
+    }
+    HostDataType Reduce(HostDataType init)
+    {
+        cl_uint tiles = (cl_uint)_partials.size();
+        if (!(tiles > 1 && GetThreadCount() > 1
+              && CL_SUCCESS == ThreadPool_Do(ReduceTile, tiles, this)))
+            for (cl_uint t = 0; t < tiles; t++) ReduceTile(t, 0, this);
+        for (cl_uint t = 0; t < tiles; t++) init = _combine(init, _partials[t]);
+        return init;
+    }
+
+private:
+    cl_uint _count;
+    Term _term;
+    Combine _combine;
+    std::vector<HostDataType> _partials;
+};
+
+// Folds term(0) ... term(count - 1) into init with combine, which must be
+// commutative and associative. Tiles of the range are reduced in parallel on
+// the thread pool, which makes verifying tests with millions of threads much
+// faster than a single host loop.
+template <typename HostDataType, typename Term, typename Combine>
+HostDataType ReduceOverThreads(HostDataType init, cl_uint count, Term term,
+                               Combine combine)
+{
+    return CReduceOverThreads<HostDataType, Term, Combine>(count, term, combine)
+        .Reduce(init);
+}
+
 class CTest {
 public:
     virtual int Execute(cl_device_id deviceID, cl_context context,
@@ -149,7 +204,7 @@ public:
           _declaredInProgram(false), _usedInFunction(false),
           _genericAddrSpace(false), _oldValueCheck(true),
           _localRefValues(false), _maxGroupSize(0), _passCount(0),
-          _iterations(gInternalIterations)
+          _iterations(gInternalIterations), _collectKernelSources(false)
     {}
     virtual ~CBasicTest()
     {
@@ -162,6 +217,9 @@ public:
         return 1;
     }
     virtual cl_uint NumNonAtomicVariablesPerThread() { return 1; }
+    // Number of atomic operations each thread performs, used to report
+    // throughput in contention mode
+    virtual cl_ulong AtomicOpsPerThread() { return 1; }
     virtual bool ExpectedValue(HostDataType &expected, cl_uint threadCount,
                                HostDataType *startRefValues,
                                cl_uint whichDestValue)
@@ -204,6 +262,7 @@ public:
     }
     virtual int ExecuteSingleTest(cl_device_id deviceID, cl_context context,
                                   cl_command_queue queue);
+    void BuildKernelBatches(cl_context context);
     int ExecuteForEachPointerType(cl_device_id deviceID, cl_context context,
                                   cl_command_queue queue)
     {
@@ -294,6 +353,16 @@ public:
             _maxDeviceThreads = 0;
         }
         if (_maxDeviceThreads + MaxHostThreads() == 0) return 0;
+        if (_maxDeviceThreads > 0 && !gOldAPI)
+        {
+            // Walk all parameter sets once without running them to collect
+            // the source of every kernel, so that the variants sharing a
+            // program header are built together as one program
+            _collectKernelSources = true;
+            ExecuteForEachParameterSet(deviceID, context, queue);
+            _collectKernelSources = false;
+            BuildKernelBatches(context);
+        }
         return ExecuteForEachParameterSet(deviceID, context, queue);
     }
     virtual void HostFunction(cl_uint tid, cl_uint threadCount,
@@ -438,6 +507,7 @@ public:
         if (LocalMemory()) return 1;
         return threadCount / CurrentGroupSize();
     }
+    bool CollectKernelSources() { return _collectKernelSources; }
     cl_int Iterations() { return _iterations; }
     std::string IterationsStr()
     {
@@ -460,6 +530,16 @@ private:
     cl_uint _currentGroupSize;
     cl_uint _passCount;
     const cl_int _iterations;
+    typedef struct
+    {
+        clProgramWrapper program;
+        std::string kernelName;
+    } TBatchedKernel;
+    bool _collectKernelSources;
+    // kernel sources collected for each program header
+    std::map<std::string, std::vector<std::string>> _kernelSources;
+    // batched kernels by the source of their single kernel program
+    std::map<std::string, TBatchedKernel> _batchedKernels;
 };
 
 template <typename HostAtomicType, typename HostDataType>
@@ -1089,6 +1169,61 @@ CBasicTest<HostAtomicType, HostDataType>::KernelCode(cl_uint maxNumDestItems)
     return code;
 }
 
+template <typename HostAtomicType, typename HostDataType>
+void CBasicTest<HostAtomicType, HostDataType>::BuildKernelBatches(
+    cl_context context)
+{
+    typename std::map<std::string, std::vector<std::string>>::iterator it;
+    for (it = _kernelSources.begin(); it != _kernelSources.end(); ++it)
+    {
+        const std::string &header = it->first;
+        const std::vector<std::string> &sources = it->second;
+        if (sources.size() < 2) continue;
+
+        // Give each variant its own kernel and function name
+        std::string programSource = header;
+        std::vector<std::string> kernelNames;
+        for (size_t i = 0; i < sources.size(); i++)
+        {
+            std::stringstream suffix;
+            suffix << "_" << i;
+            std::string source = sources[i];
+            const char *symbols[] = { "test_atomic_kernel",
+                                      "test_atomic_function" };
+            for (size_t s = 0; s < sizeof(symbols) / sizeof(symbols[0]); s++)
+            {
+                std::string symbol = symbols[s];
+                for (size_t pos = source.find(symbol);
+                     pos != std::string::npos;
+                     pos = source.find(symbol, pos + symbol.size()))
+                    source.insert(pos + symbol.size(), suffix.str());
+            }
+            programSource += source;
+            kernelNames.push_back("test_atomic_kernel" + suffix.str());
+        }
+
+        clProgramWrapper program;
+        clKernelWrapper kernel;
+        const char *programLine = programSource.c_str();
+        if (create_single_kernel_helper_with_build_options(
+                context, &program, &kernel, 1, &programLine,
+                kernelNames[0].c_str(), nullptr))
+        {
+            log_info("\tBatched build failed, building %zu kernels "
+                     "separately\n",
+                     sources.size());
+            continue;
+        }
+        for (size_t i = 0; i < sources.size(); i++)
+        {
+            TBatchedKernel &batched = _batchedKernels[header + sources[i]];
+            batched.program = program;
+            batched.kernelName = kernelNames[i];
+        }
+    }
+    _kernelSources.clear();
+}
+
 template <typename HostAtomicType, typename HostDataType>
 int CBasicTest<HostAtomicType, HostDataType>::ExecuteSingleTest(
     cl_device_id deviceID, cl_context context, cl_command_queue queue)
@@ -1115,17 +1250,18 @@ int CBasicTest<HostAtomicType, HostDataType>::ExecuteSingleTest(
 
     // log_info("\t%s %s%s...\n", local ? "local" : "global",
     // DataType().AtomicTypeName(), memoryOrderScope.c_str());
-    log_info("\t%s...\n", SingleTestName().c_str());
+    if (!_collectKernelSources)
+        log_info("\t%s...\n", SingleTestName().c_str());
 
     if (!LocalMemory() && DeclaredInProgram()
         && gNoGlobalVariables) // no support for program scope global variables
     {
-        log_info("\t\tTest disabled\n");
+        if (!_collectKernelSources) log_info("\t\tTest disabled\n");
         return 0;
     }
     if (UsedInFunction() && GenericAddrSpace() && gNoGenericAddressSpace)
     {
-        log_info("\t\tTest disabled\n");
+        if (!_collectKernelSources) log_info("\t\tTest disabled\n");
         return 0;
     }
     if (!LocalMemory() && DeclaredInProgram())
@@ -1133,7 +1269,7 @@ int CBasicTest<HostAtomicType, HostDataType>::ExecuteSingleTest(
         if (((gAtomicMemCap & CL_DEVICE_ATOMIC_SCOPE_DEVICE) == 0)
             || ((gAtomicMemCap & CL_DEVICE_ATOMIC_ORDER_ACQ_REL) == 0))
         {
-            log_info("\t\tTest disabled\n");
+            if (!_collectKernelSources) log_info("\t\tTest disabled\n");
             return 0;
         }
     }
@@ -1157,30 +1293,51 @@ int CBasicTest<HostAtomicType, HostDataType>::ExecuteSingleTest(
     // in program)
     cl_uint numDestItems = NumResults(threadCount, deviceID);
 
+    if (_collectKernelSources)
+    {
+        // Atomics declared in program scope keep their state between kernel
+        // launches, so those kernels always get a program of their own
+        if (deviceThreadCount > 0 && (LocalMemory() || !DeclaredInProgram()))
+        {
+            std::vector<std::string> &sources = _kernelSources[PragmaHeader(
+                deviceID) + ProgramHeader(numDestItems)];
+            std::string source = FunctionCode() + KernelCode(numDestItems);
+            if (std::find(sources.begin(), sources.end(), source)
+                == sources.end())
+                sources.push_back(source);
+        }
+        return 0;
+    }
+
     if (deviceThreadCount > 0)
     {
-        // This loop iteratively reduces the workgroup size by 2 and then
-        // re-generates the kernel with the reduced
-        // workgroup size until we find a size which is admissible for the
-        // kernel being run or reduce the wg size to the trivial case of 1
-        // (which was separately verified to be accurate for the kernel being
-        // run)
+        // The kernel source doesn't depend on the group size, so build it once
+        // or pick it from the batch built for this data type
+        programSource = PragmaHeader(deviceID) + ProgramHeader(numDestItems)
+            + FunctionCode() + KernelCode(numDestItems);
+        programLine = programSource.c_str();
+        typename std::map<std::string, TBatchedKernel>::iterator batched =
+            _batchedKernels.find(programSource);
+        if (batched != _batchedKernels.end())
+        {
+            kernel = clCreateKernel(batched->second.program,
+                                    batched->second.kernelName.c_str(), &error);
+            test_error(error, "Unable to create kernel from batched program");
+        }
+        else if (create_single_kernel_helper_with_build_options(
+                     context, &program, &kernel, 1, &programLine,
+                     "test_atomic_kernel", gOldAPI ? "" : nullptr))
+        {
+            return -1;
+        }
 
+        // This loop iteratively reduces the workgroup size by 2 until we find
+        // a size which is admissible for the kernel being run or reduce the wg
+        // size to the trivial case of 1 (which was separately verified to be
+        // accurate for the kernel being run)
         while ((CurrentGroupSize() > 1))
         {
-            // Re-generate the kernel code with the current group size
-            if (kernel) clReleaseKernel(kernel);
-            if (program) clReleaseProgram(program);
-            programSource = PragmaHeader(deviceID) + ProgramHeader(numDestItems)
-                + FunctionCode() + KernelCode(numDestItems);
-            programLine = programSource.c_str();
-            if (create_single_kernel_helper_with_build_options(
-                    context, &program, &kernel, 1, &programLine,
-                    "test_atomic_kernel", gOldAPI ? "" : nullptr))
-            {
-                return -1;
-            }
-            // Get work group size for the new kernel
+            // Get work group size for the kernel
             error = clGetKernelWorkGroupInfo(
                 kernel, deviceID, CL_KERNEL_WORK_GROUP_SIZE, sizeof(groupSize),
                 &groupSize, NULL);
@@ -1381,6 +1538,8 @@ int CBasicTest<HostAtomicType, HostDataType>::ExecuteSingleTest(
             UseSVM() ? svmDataBuffer : &refValues[0];
     }
 
+    std::chrono::steady_clock::time_point contendedStart =
+        std::chrono::steady_clock::now();
     if (deviceThreadCount > 0)
     {
         /* Run the kernel */
@@ -1399,6 +1558,21 @@ int CBasicTest<HostAtomicType, HostDataType>::ExecuteSingleTest(
         ThreadPool_Do(HostThreadFunction, hostThreadCount,
                       &hostThreadContexts[0]);
 
+    double contendedSeconds = 0.0;
+    if (gContention)
+    {
+        /* Wait for the device threads too, so that the time covers all
+         * threads contending on the atomics and none of the result reads */
+        if (deviceThreadCount > 0)
+        {
+            error = clFinish(queue);
+            test_error(error, "clFinish failed");
+        }
+        std::chrono::duration<double> contended =
+            std::chrono::steady_clock::now() - contendedStart;
+        contendedSeconds = contended.count();
+    }
+
     if (UseSVM())
     {
         error = clFinish(queue);
@@ -1499,6 +1673,12 @@ int CBasicTest<HostAtomicType, HostDataType>::ExecuteSingleTest(
         return -1;
     }
 
+    if (gContention && contendedSeconds > 0.0)
+        log_info("\t\tpassed, %.2f Mops/s contended (%u device, %u host "
+                 "threads)\n",
+                 threadCount * AtomicOpsPerThread() / contendedSeconds * 1e-6,
+                 deviceThreadCount, hostThreadCount);
+
     if (OldValueCheck()
         && !(DeclaredInProgram()
              && !LocalMemory())) // don't test for programs scope global atomics
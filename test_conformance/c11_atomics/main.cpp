@@ -26,6 +26,7 @@ bool gUseHostPtr = false; // use malloc/free with CL_MEM_USE_HOST_PTR instead of
 bool gDebug = false; // always print OpenCL kernel code
 int gInternalIterations = 10000; // internal test iterations for atomic operation, sufficient to verify atomicity
 int gMaxDeviceThreads = 1024; // maximum number of threads executed on OCL device
+bool gContention = false; // report throughput of the contended atomic phase
 cl_device_atomic_capabilities gAtomicMemCap,
     gAtomicFenceCap; // atomic memory and fence capabilities for this device
 
@@ -220,7 +221,9 @@ int main(int argc, const char *argv[])
       log_info("  '-useHostPtr'              use malloc/free with CL_MEM_USE_HOST_PTR instead of clSVMAlloc/clSVMFree\n");
       log_info("  '-debug'                   always print OpenCL kernel code\n");
       log_info("  '-internalIterations <X>'  internal test iterations for atomic operation, sufficient to verify atomicity\n");
-      log_info("  '-maxDeviceThreads <X>'    maximum number of threads executed on OCL device");
+      log_info("  '-maxDeviceThreads <X>'    maximum number of threads executed on OCL device\n");
+      log_info("  '-contention'              report atomic operations per second of each passing case\n");
+      log_info("                             (set CL_TEST_THREADPOOL_PIN to pin host threads to CPUs)");
 
       break;
     }
@@ -256,6 +259,8 @@ int main(int argc, const char *argv[])
     }
     else if(std::string(argv[argc-1]) == "-debug") // print OpenCL kernel code
       gDebug = true;
+    else if(std::string(argv[argc-1]) == "-contention") // report throughput of the contended atomic phase
+      gContention = true;
     else if(argc > 2 && std::string(argv[argc-2]) == "-internalIterations") // internal test iterations for atomic operation, sufficient to verify atomicity
     {
       gInternalIterations = atoi(argv[argc-1]);
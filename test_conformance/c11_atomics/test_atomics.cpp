@@ -498,6 +498,7 @@ public:
             + ");\n";
     }
 
+    virtual cl_ulong AtomicOpsPerThread() { return Iterations() + 1; }
     virtual void HostFunction(cl_uint tid, cl_uint threadCount,
                               volatile HostAtomicType *destMemory,
                               HostDataType *oldValues)
@@ -747,6 +748,7 @@ public:
               "    }\n"
               "  }\n";
     }
+    virtual cl_ulong AtomicOpsPerThread() { return Iterations(); }
     virtual void HostFunction(cl_uint tid, cl_uint threadCount,
                               volatile HostAtomicType *destMemory,
                               HostDataType *oldValues)
@@ -1103,10 +1105,13 @@ public:
                                HostDataType *startRefValues,
                                cl_uint whichDestValue)
     {
-        expected = StartValue();
-        for (cl_uint i = 0; i < threadCount; i++)
-            expected += ((HostDataType)i + 3) * 3
-                + (((HostDataType)i + 3) << (sizeof(HostDataType) - 1) * 8);
+        expected = ReduceOverThreads(
+            StartValue(), threadCount,
+            [](cl_uint i) {
+                return ((HostDataType)i + 3) * 3
+                    + (((HostDataType)i + 3) << (sizeof(HostDataType) - 1) * 8);
+            },
+            [](HostDataType a, HostDataType b) { return a + b; });
         return true;
     }
 };
@@ -1230,10 +1235,14 @@ public:
                                HostDataType *startRefValues,
                                cl_uint whichDestValue)
     {
-        expected = StartValue();
-        for (cl_uint i = 0; i < threadCount; i++)
-            expected -= (HostDataType)i + 3
-                + (((HostDataType)i + 3) << (sizeof(HostDataType) - 1) * 8);
+        HostDataType subtracted = ReduceOverThreads(
+            (HostDataType)0, threadCount,
+            [](cl_uint i) {
+                return (HostDataType)i + 3
+                    + (((HostDataType)i + 3) << (sizeof(HostDataType) - 1) * 8);
+            },
+            [](HostDataType a, HostDataType b) { return a + b; });
+        expected = StartValue() - subtracted;
         return true;
     }
 };
@@ -1514,12 +1523,13 @@ public:
                                cl_uint whichDestValue)
     {
         int numBits = sizeof(HostDataType) * 8;
-        expected = StartValue();
-        for (cl_uint i = 0; i < threadCount; i++)
-        {
-            int bitIndex = (numBits - 1) * (i + 1) / threadCount;
-            expected ^= ((HostDataType)1 << bitIndex);
-        }
+        expected = ReduceOverThreads(
+            StartValue(), threadCount,
+            [=](cl_uint i) {
+                int bitIndex = (numBits - 1) * (i + 1) / threadCount;
+                return (HostDataType)1 << bitIndex;
+            },
+            [](HostDataType a, HostDataType b) { return a ^ b; });
         return true;
     }
 };
@@ -1810,6 +1820,7 @@ public:
               "      oldValues[tid]++;\n"
               "  }\n";
     }
+    virtual cl_ulong AtomicOpsPerThread() { return 2 * Iterations(); }
     virtual void HostFunction(cl_uint tid, cl_uint threadCount,
                               volatile HostAtomicType *destMemory,
                               HostDataType *oldValues)
@@ -1990,6 +2001,7 @@ public:
               "      oldValues[tid]++;\n"
               "  }\n";
     }
+    virtual cl_ulong AtomicOpsPerThread() { return 2 * Iterations(); }
     virtual void HostFunction(cl_uint tid, cl_uint threadCount,
                               volatile HostAtomicType *destMemory,
                               HostDataType *oldValues)
@@ -2161,11 +2173,10 @@ public:
                                HostDataType *startRefValues,
                                cl_uint whichDestValue)
     {
-        expected = StartValue();
-        for (cl_uint i = 0; i < threadCount; i++)
-        {
-            if (startRefValues[i] < expected) expected = startRefValues[i];
-        }
+        expected = ReduceOverThreads(
+            StartValue(), threadCount,
+            [=](cl_uint i) { return startRefValues[i]; },
+            [](HostDataType a, HostDataType b) { return b < a ? b : a; });
         return true;
     }
 };
@@ -2296,11 +2307,10 @@ public:
                                HostDataType *startRefValues,
                                cl_uint whichDestValue)
     {
-        expected = StartValue();
-        for (cl_uint i = 0; i < threadCount; i++)
-        {
-            if (startRefValues[i] > expected) expected = startRefValues[i];
-        }
+        expected = ReduceOverThreads(
+            StartValue(), threadCount,
+            [=](cl_uint i) { return startRefValues[i]; },
+            [](HostDataType a, HostDataType b) { return b > a ? b : a; });
         return true;
     }
 };
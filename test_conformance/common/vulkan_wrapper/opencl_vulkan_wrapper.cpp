@@ -118,6 +118,21 @@ void init_cl_vk_ext(cl_platform_id opencl_platform, cl_uint num_devices,
     }
 }
 
+uint64_t getCLSubBufferAlignment(cl_device_id deviceID)
+{
+    cl_uint alignBits = 0;
+    cl_int result =
+        clGetDeviceInfo(deviceID, CL_DEVICE_MEM_BASE_ADDR_ALIGN,
+                        sizeof(alignBits), &alignBits, NULL);
+    if (result != CL_SUCCESS || alignBits < 8)
+    {
+        // The smallest alignment a full profile device may report, 128
+        // bytes for long16
+        return 128;
+    }
+    return alignBits / 8;
+}
+
 cl_int setMaxImageDimensions(cl_device_id deviceID, size_t &max_width,
                              size_t &max_height)
 {
@@ -769,6 +784,55 @@ cl_mem clExternalMemoryImage::getExternalMemoryImage()
     return m_externalMemory;
 }
 
+clExternalMemoryPool::clExternalMemoryPool(
+    const clExternalMemoryPool &externalMemoryPool)
+    : m_pool(externalMemoryPool.m_pool),
+      m_context(externalMemoryPool.m_context),
+      m_deviceId(externalMemoryPool.m_deviceId)
+{}
+
+clExternalMemoryPool::clExternalMemoryPool(const VulkanDeviceMemoryPool &pool,
+                                           cl_context context,
+                                           cl_device_id deviceId)
+    : m_pool(pool), m_context(context), m_deviceId(deviceId)
+{
+    update();
+}
+
+clExternalMemoryPool::~clExternalMemoryPool() {}
+
+void clExternalMemoryPool::update()
+{
+    for (size_t i = m_blocks.size(); i < m_pool.getNumBlocks(); i++)
+    {
+        const VulkanDeviceMemory &block = m_pool.getBlock(i);
+        m_blocks.emplace_back(new clExternalMemory(
+            &block, m_pool.getExternalMemoryHandleType(), block.getSize(),
+            m_context, m_deviceId));
+    }
+}
+
+cl_mem clExternalMemoryPool::createSubBuffer(
+    const VulkanSubAllocation &allocation, cl_mem_flags flags,
+    cl_int *errcode_ret)
+{
+    update();
+    cl_buffer_region region = { (size_t)allocation.offset,
+                                (size_t)allocation.size };
+    return clCreateSubBuffer(
+        m_blocks[allocation.blockIndex]->getExternalMemoryBuffer(), flags,
+        CL_BUFFER_CREATE_TYPE_REGION, &region, errcode_ret);
+}
+
+std::vector<cl_mem> clExternalMemoryPool::getBlockBuffers()
+{
+    update();
+    std::vector<cl_mem> buffers;
+    for (auto &block : m_blocks)
+        buffers.push_back(block->getExternalMemoryBuffer());
+    return buffers;
+}
+
 clExternalMemoryImage::~clExternalMemoryImage()
 {
     clReleaseMemObject(m_externalMemory);
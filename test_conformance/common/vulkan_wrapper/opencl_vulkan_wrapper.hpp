@@ -98,6 +98,9 @@ cl_int check_external_semaphore_handle_type(
         CL_DEVICE_SEMAPHORE_IMPORT_HANDLE_TYPES_KHR);
 cl_int setMaxImageDimensions(cl_device_id deviceID, size_t &width,
                              size_t &height);
+// Alignment in bytes OpenCL needs for the origin of sub-buffers, to pass as
+// the minimum alignment of a VulkanDeviceMemoryPool
+uint64_t getCLSubBufferAlignment(cl_device_id deviceID);
 
 class clExternalMemory {
 protected:
@@ -115,6 +118,28 @@ public:
     virtual ~clExternalMemory();
     cl_mem getExternalMemoryBuffer();
 };
+// The blocks of a VulkanDeviceMemoryPool imported into OpenCL, each once,
+// with the ranges the pool hands out as sub-buffers of them. OpenCL acquires
+// and releases the blocks around its use of the sub-buffers.
+class clExternalMemoryPool {
+protected:
+    const VulkanDeviceMemoryPool &m_pool;
+    cl_context m_context;
+    cl_device_id m_deviceId;
+    std::vector<std::unique_ptr<clExternalMemory>> m_blocks;
+    clExternalMemoryPool(const clExternalMemoryPool &externalMemoryPool);
+
+public:
+    clExternalMemoryPool(const VulkanDeviceMemoryPool &pool,
+                         cl_context context, cl_device_id deviceId);
+    virtual ~clExternalMemoryPool();
+    // Import the blocks the pool gained since the last call
+    void update();
+    // A new sub-buffer for allocation, which the caller releases
+    cl_mem createSubBuffer(const VulkanSubAllocation &allocation,
+                           cl_mem_flags flags, cl_int *errcode_ret);
+    std::vector<cl_mem> getBlockBuffers();
+};
 class clExternalMemoryImage {
 protected:
     cl_mem m_externalMemory;
@@ -2283,6 +2283,104 @@ void VulkanDeviceMemory::bindImage(const VulkanImage &image, uint64_t offset)
 
 VulkanDeviceMemory::operator VkDeviceMemory() const { return m_vkDeviceMemory; }
 
+///////////////////////////////////////////
+// VulkanDeviceMemoryPool implementation //
+///////////////////////////////////////////
+
+VulkanDeviceMemoryPool::VulkanDeviceMemoryPool(
+    const VulkanDeviceMemoryPool &pool)
+    : m_device(pool.m_device), m_memoryType(pool.m_memoryType),
+      m_externalMemoryHandleType(pool.m_externalMemoryHandleType),
+      m_blockSize(pool.m_blockSize), m_minAlignment(pool.m_minAlignment)
+{}
+
+VulkanDeviceMemoryPool::VulkanDeviceMemoryPool(
+    const VulkanDevice &device, const VulkanMemoryType &memoryType,
+    VulkanExternalMemoryHandleType externalMemoryHandleType,
+    uint64_t blockSize, uint64_t minAlignment)
+    : m_device(device), m_memoryType(memoryType),
+      m_externalMemoryHandleType(externalMemoryHandleType),
+      m_blockSize(blockSize), m_minAlignment(std::max<uint64_t>(minAlignment, 1))
+{}
+
+VulkanDeviceMemoryPool::~VulkanDeviceMemoryPool() {}
+
+VulkanSubAllocation VulkanDeviceMemoryPool::allocate(uint64_t size,
+                                                     uint64_t alignment)
+{
+    alignment = std::max(alignment, m_minAlignment);
+    VulkanSubAllocation allocation = {};
+    allocation.size = size;
+    for (size_t i = 0; i < m_blocks.size(); i++)
+    {
+        uint64_t offset = (m_used[i] + alignment - 1) / alignment * alignment;
+        if (offset + size <= m_blocks[i]->getSize())
+        {
+            m_used[i] = offset + size;
+            allocation.memory = m_blocks[i].get();
+            allocation.blockIndex = i;
+            allocation.offset = offset;
+            return allocation;
+        }
+    }
+
+    // Larger requests get a block of their own
+    m_blocks.emplace_back(
+        new VulkanDeviceMemory(m_device, std::max(size, m_blockSize),
+                               m_memoryType, m_externalMemoryHandleType));
+    m_used.push_back(size);
+    allocation.memory = m_blocks.back().get();
+    allocation.blockIndex = m_blocks.size() - 1;
+    allocation.offset = 0;
+    return allocation;
+}
+
+VulkanSubAllocation VulkanDeviceMemoryPool::bindBuffer(
+    const VulkanBuffer &buffer)
+{
+    if (buffer.isDedicated())
+    {
+        throw std::runtime_error(
+            "Buffer requires dedicated memory.  Cannot be pooled");
+    }
+    VulkanSubAllocation allocation =
+        allocate(buffer.getSize(), buffer.getAlignment());
+    allocation.memory->bindBuffer(buffer, allocation.offset);
+    return allocation;
+}
+
+VulkanSubAllocation VulkanDeviceMemoryPool::bindImage(const VulkanImage &image)
+{
+    if (image.isDedicated())
+    {
+        throw std::runtime_error(
+            "Image requires dedicated memory.  Cannot be pooled");
+    }
+    VulkanSubAllocation allocation =
+        allocate(image.getSize(), image.getAlignment());
+    allocation.memory->bindImage(image, allocation.offset);
+    return allocation;
+}
+
+void VulkanDeviceMemoryPool::reset()
+{
+    std::fill(m_used.begin(), m_used.end(), 0);
+}
+
+size_t VulkanDeviceMemoryPool::getNumBlocks() const { return m_blocks.size(); }
+
+const VulkanDeviceMemory &
+VulkanDeviceMemoryPool::getBlock(size_t blockIndex) const
+{
+    return *m_blocks[blockIndex];
+}
+
+VulkanExternalMemoryHandleType
+VulkanDeviceMemoryPool::getExternalMemoryHandleType() const
+{
+    return m_externalMemoryHandleType;
+}
+
 ////////////////////////////////////
 // VulkanSemaphore implementation //
 ////////////////////////////////////
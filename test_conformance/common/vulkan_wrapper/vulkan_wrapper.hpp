@@ -22,6 +22,7 @@
 #include "vulkan_list_map.hpp"
 #include "vulkan_api_list.hpp"
 #include <memory>
+#include <vector>
 
 class VulkanInstance {
     friend const VulkanInstance &getVulkanInstance();
@@ -617,6 +618,55 @@ public:
     operator VkDeviceMemory() const;
 };
 
+// A range of one of the blocks of a VulkanDeviceMemoryPool
+struct VulkanSubAllocation
+{
+    VulkanDeviceMemory *memory;
+    size_t blockIndex;
+    uint64_t offset;
+    uint64_t size;
+};
+
+// Places buffers and images in a few large blocks of one memory type, which
+// are exportable with the handle type given, instead of allocating and
+// exporting memory for each of them. That keeps sweeps over many sizes and
+// formats clear of the cost of vkAllocateMemory and of
+// maxMemoryAllocationCount. Ranges are handed out in order, and all of them
+// are given back at once by reset(), which keeps the blocks for the next
+// round. Resources that need dedicated memory cannot be pooled.
+class VulkanDeviceMemoryPool {
+protected:
+    const VulkanDevice &m_device;
+    const VulkanMemoryType &m_memoryType;
+    VulkanExternalMemoryHandleType m_externalMemoryHandleType;
+    uint64_t m_blockSize;
+    uint64_t m_minAlignment;
+    std::vector<std::unique_ptr<VulkanDeviceMemory>> m_blocks;
+    // Bytes handed out of each block
+    std::vector<uint64_t> m_used;
+
+    VulkanDeviceMemoryPool(const VulkanDeviceMemoryPool &pool);
+
+public:
+    // Ranges are aligned to at least minAlignment, such as what OpenCL needs
+    // for sub-buffers of the imported blocks
+    VulkanDeviceMemoryPool(const VulkanDevice &device,
+                           const VulkanMemoryType &memoryType,
+                           VulkanExternalMemoryHandleType
+                               externalMemoryHandleType =
+                                   VULKAN_EXTERNAL_MEMORY_HANDLE_TYPE_NONE,
+                           uint64_t blockSize = 64 * 1024 * 1024,
+                           uint64_t minAlignment = 1);
+    virtual ~VulkanDeviceMemoryPool();
+    VulkanSubAllocation allocate(uint64_t size, uint64_t alignment);
+    VulkanSubAllocation bindBuffer(const VulkanBuffer &buffer);
+    VulkanSubAllocation bindImage(const VulkanImage &image);
+    void reset();
+    size_t getNumBlocks() const;
+    const VulkanDeviceMemory &getBlock(size_t blockIndex) const;
+    VulkanExternalMemoryHandleType getExternalMemoryHandleType() const;
+};
+
 class VulkanSemaphore {
     friend class VulkanQueue;
 
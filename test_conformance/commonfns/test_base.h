@@ -217,6 +217,91 @@ template <typename T> bool isfinite_fp(const T &v)
     }
 }
 
+// Runs the kernels of every vector size of an elementwise builtin test and
+// verifies them. kernels[i] takes the numInputs input buffers followed by its
+// output buffer and is run over n_elems work-items. Each kernel writes its
+// own output buffer and the results are read without blocking, so the device
+// works on the later vector sizes while the earlier ones are verified.
+// verify(i, out) gets the num_elements results of kernels[i] and returns
+// non-zero on failure, which stops the test as before.
+template <typename T, typename VerifyFn>
+cl_int RunElementwiseKernels(cl_context context, cl_command_queue queue,
+                             std::vector<clKernelWrapper> &kernels,
+                             const cl_mem *inputs, int numInputs,
+                             size_t n_elems, size_t num_elements,
+                             VerifyFn verify)
+{
+    size_t count = kernels.size();
+    std::vector<clMemWrapper> outBuffers(count);
+    std::vector<clEventWrapper> readEvents(count);
+    std::vector<std::vector<T>> outputs(count, std::vector<T>(num_elements));
+    cl_int err = CL_SUCCESS;
+
+    for (size_t i = 0; i < count && err == CL_SUCCESS; i++)
+    {
+        outBuffers[i] = clCreateBuffer(context, CL_MEM_READ_WRITE,
+                                       sizeof(T) * num_elements, NULL, &err);
+        if (err != CL_SUCCESS)
+        {
+            print_error(err, "clCreateBuffer failed");
+            break;
+        }
+
+        for (int j = 0; j < numInputs && err == CL_SUCCESS; j++)
+            err = clSetKernelArg(kernels[i], j, sizeof(cl_mem), &inputs[j]);
+        if (err == CL_SUCCESS)
+            err = clSetKernelArg(kernels[i], numInputs, sizeof(cl_mem),
+                                 &outBuffers[i]);
+        if (err != CL_SUCCESS)
+        {
+            print_error(err, "Unable to set kernel argument");
+            break;
+        }
+
+        err = clEnqueueNDRangeKernel(queue, kernels[i], 1, NULL, &n_elems,
+                                     NULL, 0, NULL, NULL);
+        if (err != CL_SUCCESS)
+        {
+            print_error(err, "Unable to execute kernel");
+            break;
+        }
+
+        err = clEnqueueReadBuffer(queue, outBuffers[i], CL_FALSE, 0,
+                                  sizeof(T) * num_elements, outputs[i].data(),
+                                  0, NULL, &readEvents[i]);
+        if (err != CL_SUCCESS)
+        {
+            print_error(err, "Unable to read results");
+        }
+    }
+
+    if (err == CL_SUCCESS)
+    {
+        err = clFlush(queue);
+        if (err != CL_SUCCESS)
+        {
+            print_error(err, "clFlush failed");
+        }
+    }
+
+    for (size_t i = 0; i < count && err == CL_SUCCESS; i++)
+    {
+        err = clWaitForEvents(1, &readEvents[i]);
+        if (err != CL_SUCCESS)
+        {
+            print_error(err, "Unable to read results");
+        }
+        else if (verify((int)i, outputs[i].data()))
+        {
+            err = -1;
+        }
+    }
+
+    // Don't leave reads into the output vectors outstanding
+    clFinish(queue);
+    return err;
+}
+
 template <class T>
 int MakeAndRunTest(cl_device_id device, cl_context context,
                    cl_command_queue queue, int num_elements,
@@ -144,8 +144,8 @@ int test_smoothstep_fn(cl_device_id device, cl_context context,
                        cl_command_queue queue, const int n_elems,
                        const bool vecParam)
 {
-    clMemWrapper streams[4];
-    std::vector<T> input_ptr[3], output_ptr;
+    clMemWrapper streams[3];
+    std::vector<T> input_ptr[3];
 
     std::vector<clProgramWrapper> programs;
     std::vector<clKernelWrapper> kernels;
@@ -163,9 +163,8 @@ int test_smoothstep_fn(cl_device_id device, cl_context context,
     int num_elements = n_elems * (1 << (kTotalVecCount - 1));
 
     for (i = 0; i < 3; i++) input_ptr[i].resize(num_elements);
-    output_ptr.resize(num_elements);
 
-    for (i = 0; i < 4; i++)
+    for (i = 0; i < 3; i++)
     {
         streams[i] = clCreateBuffer(context, CL_MEM_READ_WRITE,
                                     sizeof(T) * num_elements, NULL, &err);
@@ -251,46 +250,26 @@ int test_smoothstep_fn(cl_device_id device, cl_context context,
                                         (const char **)&programPtr, "test_fn");
         test_error(err, "Unable to create kernel");
 
-        for (int j = 0; j < 4; j++)
-        {
-            err =
-                clSetKernelArg(kernels[i], j, sizeof(streams[j]), &streams[j]);
-            test_error(err, "Unable to set kernel argument");
-        }
-
-        size_t threads = (size_t)n_elems;
-
-        err = clEnqueueNDRangeKernel(queue, kernels[i], 1, NULL, &threads, NULL,
-                                     0, NULL, NULL);
-        test_error(err, "Unable to execute kernel");
-
-        err = clEnqueueReadBuffer(queue, streams[3], true, 0,
-                                  sizeof(T) * num_elements, &output_ptr[0], 0,
-                                  NULL, NULL);
-        test_error(err, "Unable to read results");
+    }
 
-        if (verify_smoothstep((T *)&input_ptr[0].front(),
-                              (T *)&input_ptr[1].front(),
-                              (T *)&input_ptr[2].front(), &output_ptr[0],
-                              n_elems, g_arrVecSizes[i], vecParam))
-        {
-            log_error("smoothstep %s%d%s test failed\n", tname.c_str(),
-                      ((g_arrVecSizes[i])),
-                      vecParam ? "" : std::string(", " + tname).c_str());
-            err = -1;
-        }
-        else
-        {
+    cl_mem inputs[3] = { streams[0], streams[1], streams[2] };
+    return RunElementwiseKernels<T>(
+        context, queue, kernels, inputs, 3, n_elems, num_elements,
+        [&](int idx, const T *output) {
+            if (verify_smoothstep(&input_ptr[0].front(), &input_ptr[1].front(),
+                                  &input_ptr[2].front(), output, n_elems,
+                                  g_arrVecSizes[idx], vecParam))
+            {
+                log_error("smoothstep %s%d%s test failed\n", tname.c_str(),
+                          ((g_arrVecSizes[idx])),
+                          vecParam ? "" : std::string(", " + tname).c_str());
+                return -1;
+            }
             log_info("smoothstep %s%d%s test passed\n", tname.c_str(),
-                     ((g_arrVecSizes[i])),
+                     ((g_arrVecSizes[idx])),
                      vecParam ? "" : std::string(", " + tname).c_str());
-            err = 0;
-        }
-
-        if (err) break;
-    }
-
-    return err;
+            return 0;
+        });
 }
 
 cl_int SmoothstepTest::Run()
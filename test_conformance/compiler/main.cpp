@@ -100,6 +100,7 @@ test_definition test_list[] = {
     ADD_TEST(unload_build_threaded),
     ADD_TEST(unload_build_info),
     ADD_TEST(unload_program_binaries),
+    ADD_BENCHMARK(compile_throughput),
 
 };
 
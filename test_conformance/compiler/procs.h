@@ -18,6 +18,7 @@
 #include "harness/kernelHelpers.h"
 #include "harness/mt19937.h"
 #include "harness/typeWrappers.h"
+#include "harness/parseParameters.h"
 
 // This is a macro rather than a function to be able to use and act like the
 // existing test_error macro.
@@ -259,3 +260,5 @@ extern int test_unload_program_binaries(cl_device_id deviceID,
                                         cl_context context,
                                         cl_command_queue queue,
                                         int num_elements);
+extern int test_compile_throughput(cl_device_id deviceID, cl_context context,
+                                   cl_command_queue queue, int num_elements);
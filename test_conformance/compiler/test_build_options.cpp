@@ -14,8 +14,16 @@
 // limitations under the License.
 //
 #include "testBase.h"
+#include "harness/contextPool.h"
 #include "harness/os_helpers.h"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
 const char *preprocessor_test_kernel[] = {
 "__kernel void sample_test(__global int *dst)\n"
 "{\n"
@@ -88,37 +96,79 @@ cl_int get_result_from_program( cl_context context, cl_command_queue queue, cl_p
     return CL_SUCCESS;
 }
 
-int test_options_build_optimizations(cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements)
+// Builds the options test kernel with one optimization option, returning
+// the reason in failure if it doesn't build
+static int build_with_optimization_option(cl_context context, cl_device_id deviceID, const char *option, std::string &failure)
 {
-    int error;
-    cl_build_status status;
+    clProgramWrapper program;
+    int error = create_single_kernel_helper_create_program(context, &program, 1, options_test_kernel, option);
+    if( program == NULL || error != CL_SUCCESS )
+    {
+        failure = "Unable to create reference program";
+        return -1;
+    }
 
-    for(size_t i = 0; i < sizeof(optimization_options) / (sizeof(char*)); i++) {
+    error = clBuildProgram( program, 1, &deviceID, option, NULL, NULL );
+    if( error != CL_SUCCESS )
+    {
+        failure = std::string("Test program did not properly build: ") + IGetErrorString(error);
+        return -1;
+    }
 
-        clProgramWrapper program;
-        error = create_single_kernel_helper_create_program(context, &program, 1, options_test_kernel, optimization_options[i]);
-        if( program == NULL || error != CL_SUCCESS )
-        {
-            log_error( "ERROR: Unable to create reference program!\n" );
-            return -1;
-        }
+    cl_build_status status;
+    error = clGetProgramBuildInfo( program, deviceID, CL_PROGRAM_BUILD_STATUS, sizeof( status ), &status, NULL );
+    if( error != CL_SUCCESS )
+    {
+        failure = std::string("Unable to get program build status: ") + IGetErrorString(error);
+        return -1;
+    }
+    if( (int)status != CL_BUILD_SUCCESS )
+    {
+        failure = "Failed to build with optimization defined";
+        return -1;
+    }
+    return CL_SUCCESS;
+}
 
-        /* Build with the macro defined */
-        log_info("Testing optimization option '%s'\n", optimization_options[i]);
-        error = clBuildProgram( program, 1, &deviceID, optimization_options[i], NULL, NULL );
-        test_error( error, "Test program did not properly build" );
+int test_options_build_optimizations(cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements)
+{
+    // The builds don't depend on each other, so they run on several threads
+    // at once, the first in the test's context and the others in contexts
+    // borrowed from the pool. Results are logged in option order afterwards.
+    const size_t numOptions = ARRAY_SIZE(optimization_options);
+    std::vector<int> results(numOptions, CL_SUCCESS);
+    std::vector<std::string> failures(numOptions);
+    std::atomic<size_t> next{ 0 };
+
+    auto worker = [&](cl_context workerContext) {
+        for (size_t i = next++; i < numOptions; i = next++)
+            results[i] = build_with_optimization_option(workerContext, deviceID, optimization_options[i], failures[i]);
+    };
 
-        error = clGetProgramBuildInfo( program, deviceID, CL_PROGRAM_BUILD_STATUS, sizeof( status ), &status, NULL );
-        test_error( error, "Unable to get program build status" );
+    size_t numThreads = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), numOptions);
+    std::vector<std::unique_ptr<PooledContext>> pooled;
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < numThreads; t++)
+    {
+        pooled.emplace_back(new PooledContext(deviceID));
+        // Without another context the remaining builds stay on this thread
+        if (pooled.back()->status() != CL_SUCCESS) break;
+        threads.emplace_back(worker, (cl_context)pooled.back()->context());
+    }
+    worker(context);
+    for (std::thread &thread : threads) thread.join();
 
-        if( (int)status != CL_BUILD_SUCCESS )
+    int result = 0;
+    for (size_t i = 0; i < numOptions; i++)
+    {
+        log_info("Testing optimization option '%s'\n", optimization_options[i]);
+        if (results[i] != CL_SUCCESS)
         {
-            log_info("Building with optimization option '%s' failed to compile!\n", optimization_options[i]);
-            print_error( error, "Failed to build with optimization defined")
-            return -1;
+            log_error("ERROR: Building with optimization option '%s' failed: %s\n", optimization_options[i], failures[i].c_str());
+            result = -1;
         }
     }
-    return 0;
+    return result;
 }
 
 int test_options_build_macro(cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements)
@@ -0,0 +1,287 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "testBase.h"
+#include "harness/typeWrappers.h"
+#include "harness/benchmark.h"
+#include "harness/perfMetrics.h"
+
+#include <algorithm>
+#include <atomic>
+#include <ctime>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Online compilation throughput: kThroughputPrograms distinct programs are
+// compiled and linked by 1, 2, 4, ... host threads at once, sharing one
+// context or with a context per thread. Each row gives programs per second,
+// followed by the speed-up and efficiency against a single thread and the
+// average compile and link times. The cost of reloading the compiler after
+// clUnloadPlatformCompiler closes the output. A benchmark, so it only runs
+// when named.
+
+static const int kThroughputPrograms = 64;
+static const int kMaxThroughputThreads = 16;
+
+// Every program gets a unique salt so that no compiler cache can serve it
+static const char *throughput_source_template = R"(
+    #define SALT %uu
+
+    uint mix_%u(uint x)
+    {
+        for (uint i = 0; i < 16; i++)
+            x = (x ^ (x >> 13)) * 0x5bd1e995u + SALT;
+        return x;
+    }
+
+    float shape_%u(float x)
+    {
+        float acc = 0.0f;
+        for (int i = 1; i <= 8; i++) acc += sin(x * i) / i;
+        return acc;
+    }
+
+    __kernel void throughput_%u(__global uint *dst, __global float *fdst)
+    {
+        size_t gid = get_global_id(0);
+        dst[gid] = mix_%u((uint)gid);
+        fdst[gid] = shape_%u((float)gid);
+    }
+)";
+
+namespace {
+
+struct CompileTimes
+{
+    double compile_ms;
+    double link_ms;
+};
+
+struct ThroughputRun
+{
+    cl_device_id device;
+    std::vector<cl_context> contexts;
+    cl_uint salt_base;
+    std::atomic<int> next;
+    std::atomic<cl_int> error;
+    std::vector<CompileTimes> times;
+
+    // Compiles and links program number index in context
+    cl_int Build(cl_context context, int index)
+    {
+        cl_uint salt = salt_base + index;
+        std::vector<char> text(strlen(throughput_source_template) + 128);
+        snprintf(text.data(), text.size(), throughput_source_template, salt,
+                 salt, salt, salt, salt, salt);
+        const char *source = text.data();
+
+        cl_int err;
+        clProgramWrapper program =
+            clCreateProgramWithSource(context, 1, &source, NULL, &err);
+        test_error(err, "clCreateProgramWithSource failed");
+
+        HostTimer timer;
+        err = clCompileProgram(program, 1, &device, NULL, 0, NULL, NULL, NULL,
+                               NULL);
+        test_error(err, "clCompileProgram failed");
+        double compiledMs = timer.elapsed_ms();
+        clProgramWrapper executable = clLinkProgram(
+            context, 1, &device, NULL, 1, &program, NULL, NULL, &err);
+        test_error(err, "clLinkProgram failed");
+        double linkedMs = timer.elapsed_ms();
+
+        std::string name = "throughput_" + std::to_string(salt);
+        clKernelWrapper kernel = clCreateKernel(executable, name.c_str(), &err);
+        test_error(err, "clCreateKernel failed");
+
+        times[index].compile_ms = compiledMs;
+        times[index].link_ms = linkedMs - compiledMs;
+        return CL_SUCCESS;
+    }
+
+    void Worker(cl_context context)
+    {
+        for (int index = next++; index < kThroughputPrograms; index = next++)
+        {
+            if (error != CL_SUCCESS) return;
+            cl_int err = Build(context, index);
+            if (err != CL_SUCCESS) error = err;
+        }
+    }
+
+    // Builds all of the programs with thread_count threads and returns the
+    // wall time
+    cl_int Run(int thread_count, double &ms)
+    {
+        next = 0;
+        error = CL_SUCCESS;
+        times.assign(kThroughputPrograms, CompileTimes());
+
+        HostTimer timer;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < thread_count; t++)
+            threads.emplace_back(&ThroughputRun::Worker, this,
+                                 contexts[t % contexts.size()]);
+        for (std::thread &thread : threads) thread.join();
+        ms = timer.elapsed_ms();
+
+        salt_base += kThroughputPrograms;
+        return error;
+    }
+};
+
+} // anonymous namespace
+
+int test_compile_throughput(cl_device_id deviceID, cl_context context,
+                            cl_command_queue queue, int num_elements)
+{
+    cl_bool compiler_available;
+    int error = clGetDeviceInfo(deviceID, CL_DEVICE_COMPILER_AVAILABLE,
+                                sizeof(compiler_available),
+                                &compiler_available, NULL);
+    test_error(error, "clGetDeviceInfo failed");
+    if (!compiler_available)
+    {
+        log_info("Device has no online compiler, skipping.\n");
+        return TEST_SKIPPED_ITSELF;
+    }
+
+    int max_threads = (int)std::min<unsigned>(
+        std::max(std::thread::hardware_concurrency(), 1u),
+        kMaxThroughputThreads);
+
+    std::vector<clContextWrapper> ownContexts;
+    for (int t = 0; t < max_threads; t++)
+    {
+        ownContexts.push_back(clCreateContext(NULL, 1, &deviceID,
+                                              notify_callback, NULL, &error));
+        test_error(error, "Unable to create context");
+    }
+
+    ThroughputRun run;
+    run.device = deviceID;
+    run.salt_base = (cl_uint)time(NULL) * kThroughputPrograms;
+
+    // Every sample builds kThroughputPrograms programs, so take few of them
+    BenchmarkOptions options;
+    options.warmup = 0;
+    options.minSamples = 3;
+    options.maxSeconds = 5.0;
+
+    log_benchmark_header("compile", "contexts/threads");
+    for (int shared = 1; shared >= 0; shared--)
+    {
+        run.contexts.clear();
+        if (shared)
+            run.contexts.push_back(context);
+        else
+            for (int t = 0; t < max_threads; t++)
+                run.contexts.push_back(ownContexts[t]);
+
+        // The first build in a context can pay for setting the compiler up
+        run.times.assign(1, CompileTimes());
+        for (cl_context warm_up : run.contexts)
+        {
+            error = run.Build(warm_up, 0);
+            if (error) return error;
+            run.salt_base++;
+        }
+
+        double single_rate = 0;
+        for (int threads = 1; threads <= max_threads; threads *= 2)
+        {
+            double compile_ms = 0, link_ms = 0;
+            int programs = 0;
+            BenchmarkStats stats;
+            error = run_benchmark(
+                options,
+                [&](double *rate) {
+                    double ms;
+                    cl_int err = run.Run(threads, ms);
+                    if (err != CL_SUCCESS) return err;
+
+                    for (const CompileTimes &t : run.times)
+                    {
+                        compile_ms += t.compile_ms;
+                        link_ms += t.link_ms;
+                    }
+                    programs += kThroughputPrograms;
+                    *rate = ms > 0 ? 1e3 * kThroughputPrograms / ms : 0.0;
+                    return (cl_int)CL_SUCCESS;
+                },
+                &stats);
+            if (error != CL_SUCCESS) return error;
+
+            std::string label = std::string(shared ? "shared" : "per-thread")
+                + "/" + std::to_string(threads);
+            log_benchmark_stats("compile", label.c_str(), "programs/s", true,
+                                stats);
+
+            if (threads == 1) single_rate = stats.median;
+            double speedup = single_rate > 0 ? stats.median / single_rate : 0.0;
+            compile_ms /= programs;
+            link_ms /= programs;
+            log_info("%s: speed-up %.2f, efficiency %.0f%%, compile %.2f ms, "
+                     "link %.2f ms, link/compile %.2f\n",
+                     label.c_str(), speedup, 100.0 * speedup / threads,
+                     compile_ms, link_ms,
+                     compile_ms > 0 ? link_ms / compile_ms : 0.0);
+            record_perf_metric("compile_speedup." + label, speedup, "ratio",
+                               true);
+        }
+    }
+
+    // A build straight after unloading the compiler against a warm one
+    cl_platform_id platform;
+    error = clGetDeviceInfo(deviceID, CL_DEVICE_PLATFORM, sizeof(platform),
+                            &platform, NULL);
+    test_error(error, "clGetDeviceInfo failed");
+    run.contexts.assign(1, context);
+    run.times.assign(1, CompileTimes());
+
+    BenchmarkOptions unload_options;
+    unload_options.warmup = 1;
+    unload_options.minSamples = 4;
+    unload_options.maxSeconds = 2.0;
+    BenchmarkStats cold, warm;
+    for (bool unload : { true, false })
+    {
+        error = run_benchmark(
+            unload_options,
+            [&](double *ms) {
+                if (unload)
+                {
+                    cl_int err = clUnloadPlatformCompiler(platform);
+                    test_error(err, "clUnloadPlatformCompiler failed");
+                }
+
+                HostTimer timer;
+                cl_int err = run.Build(context, 0);
+                if (err != CL_SUCCESS) return err;
+                *ms = timer.elapsed_ms();
+                run.salt_base++;
+                return (cl_int)CL_SUCCESS;
+            },
+            unload ? &cold : &warm);
+        if (error != CL_SUCCESS) return error;
+    }
+    log_benchmark_stats("compile", "unload/after_unload", "ms", false, cold);
+    log_benchmark_stats("compile", "unload/warm", "ms", false, warm);
+    record_perf_metric("compile_reload_cost", cold.median - warm.median, "ms",
+                       false);
+
+    return 0;
+}
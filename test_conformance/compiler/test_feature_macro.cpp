@@ -16,24 +16,90 @@
 #include "testBase.h"
 #include <vector>
 #include <algorithm>
+#include <iterator>
+#include <set>
+#include <sstream>
+#include <string>
 #include "errorHelpers.h"
 
-const char* macro_supported_source = R"(kernel void enabled(global int * buf) {
-        int n = get_global_id(0);
-        buf[n] = 0;
-        #ifndef %s
-            #error Feature macro was not defined
-        #endif
-})";
-
-const char* macro_not_supported_source =
-    R"(kernel void not_enabled(global int * buf) {
-        int n = get_global_id(0);
-        buf[n] = 0;
-        #ifdef %s
-            #error Feature macro was defined
-        #endif
-})";
+// Every feature macro the test checks. One kernel probes them all, setting
+// bit i of its output when feature_macro_names[i] is defined.
+static const char* feature_macro_names[] = {
+    "__opencl_c_program_scope_global_variables",
+    "__opencl_c_3d_image_writes",
+    "__opencl_c_atomic_order_acq_rel",
+    "__opencl_c_atomic_order_seq_cst",
+    "__opencl_c_atomic_scope_device",
+    "__opencl_c_atomic_scope_all_devices",
+    "__opencl_c_device_enqueue",
+    "__opencl_c_generic_address_space",
+    "__opencl_c_pipes",
+    "__opencl_c_read_write_images",
+    "__opencl_c_subgroups",
+    "__opencl_c_work_group_collective_functions",
+    "__opencl_c_images",
+    "__opencl_c_fp64",
+    "__opencl_c_int64",
+    "__opencl_c_integer_dot_product_input_4x8bit",
+    "__opencl_c_integer_dot_product_input_4x8bit_packed",
+};
+
+// The feature macros the compiler defines, filled in by
+// probe_compiler_feature_macros before the per-feature checks run
+static std::set<std::string> compiler_feature_macros;
+
+static cl_int probe_compiler_feature_macros(cl_device_id deviceID,
+                                            cl_context context,
+                                            cl_command_queue queue)
+{
+    const size_t count = ARRAY_SIZE(feature_macro_names);
+    std::vector<cl_uint> bits((count + 31) / 32, 0);
+
+    std::ostringstream source;
+    source << "kernel void feature_macros(global uint* bits) {\n";
+    for (size_t i = 0; i < count; i++)
+    {
+        source << "#ifdef " << feature_macro_names[i] << "\n"
+               << "    bits[" << i / 32 << "] |= 1u << " << i % 32 << ";\n"
+               << "#endif\n";
+    }
+    source << "}\n";
+    std::string source_str = source.str();
+    const char* ptr = source_str.c_str();
+
+    cl_int error;
+    clProgramWrapper program;
+    clKernelWrapper kernel;
+    error = create_single_kernel_helper(context, &program, &kernel, 1, &ptr,
+                                        "feature_macros", "-cl-std=CL3.0");
+    test_error(error, "Unable to build the feature macro probe kernel");
+
+    clMemWrapper buffer =
+        clCreateBuffer(context, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR,
+                       bits.size() * sizeof(cl_uint), bits.data(), &error);
+    test_error(error, "clCreateBuffer failed");
+    error = clSetKernelArg(kernel, 0, sizeof(buffer), &buffer);
+    test_error(error, "clSetKernelArg failed");
+
+    size_t global_size = 1;
+    error = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &global_size, NULL,
+                                   0, NULL, NULL);
+    test_error(error, "clEnqueueNDRangeKernel failed");
+    error = clEnqueueReadBuffer(queue, buffer, CL_TRUE, 0,
+                                bits.size() * sizeof(cl_uint), bits.data(), 0,
+                                NULL, NULL);
+    test_error(error, "clEnqueueReadBuffer failed");
+
+    compiler_feature_macros.clear();
+    for (size_t i = 0; i < count; i++)
+    {
+        if (bits[i / 32] & (1u << (i % 32)))
+        {
+            compiler_feature_macros.insert(feature_macro_names[i]);
+        }
+    }
+    return CL_SUCCESS;
+}
 
 template <typename T>
 cl_int check_api_feature_info_capabilities(cl_device_id deviceID,
@@ -128,58 +194,16 @@ cl_int check_api_feature_info_supported_image_formats(cl_device_id deviceID,
 cl_int check_compiler_feature_info(cl_device_id deviceID, cl_context context,
                                    std::string feature_macro, cl_bool& status)
 {
-    cl_int error = CL_SUCCESS;
-    clProgramWrapper program_supported;
-    clProgramWrapper program_not_supported;
-    char kernel_supported_src[1024];
-    char kernel_not_supported_src[1024];
-    sprintf(kernel_supported_src, macro_supported_source,
-            feature_macro.c_str());
-    const char* ptr_supported = kernel_supported_src;
-    const char* build_options = "-cl-std=CL3.0";
-
-    error = create_single_kernel_helper_create_program(
-        context, &program_supported, 1, &ptr_supported, build_options);
-    test_error(error, "create_single_kernel_helper_create_program failed.\n");
-
-    sprintf(kernel_not_supported_src, macro_not_supported_source,
-            feature_macro.c_str());
-    const char* ptr_not_supported = kernel_not_supported_src;
-    error = create_single_kernel_helper_create_program(
-        context, &program_not_supported, 1, &ptr_not_supported,
-        "-cl-std=CL3.0");
-    test_error(error, "create_single_kernel_helper_create_program failed.\n");
-
-    cl_int status_supported = CL_SUCCESS;
-    cl_int status_not_supported = CL_SUCCESS;
-    status_supported = clBuildProgram(program_supported, 1, &deviceID,
-                                      build_options, NULL, NULL);
-    status_not_supported = clBuildProgram(program_not_supported, 1, &deviceID,
-                                          build_options, NULL, NULL);
-    if (status_supported != status_not_supported)
-    {
-        if (status_not_supported == CL_SUCCESS)
-        {
-            // kernel which verifies not supporting return passed
-            status = CL_FALSE;
-        }
-        else
-        {
-            // kernel which verifies supporting return passed
-            status = CL_TRUE;
-        }
-    }
-    else
+    const char** names_end = std::end(feature_macro_names);
+    if (std::find(std::begin(feature_macro_names), names_end, feature_macro)
+        == names_end)
     {
-        log_error("Error: The feature macro is defined and undefined "
-                  "at the same time\n");
-        error = OutputBuildLogs(program_supported, 1, &deviceID);
-        test_error(error, "OutputBuildLogs failed.\n");
-        error = OutputBuildLogs(program_not_supported, 1, &deviceID);
-        test_error(error, "OutputBuildLogs failed.\n");
+        log_error("Error: %s is missing from the feature macro probe\n",
+                  feature_macro.c_str());
         return TEST_FAIL;
     }
-    return error;
+    status = compiler_feature_macros.count(feature_macro) ? CL_TRUE : CL_FALSE;
+    return CL_SUCCESS;
 }
 
 int feature_macro_verify_results(std::string test_macro_name,
@@ -807,7 +831,12 @@ int test_features_macro(cl_device_id deviceID, cl_context context,
     // also "may not".
     check_compiler_available(deviceID);
 
-    int error = TEST_PASS;
+    int error = probe_compiler_feature_macros(deviceID, context, queue);
+    if (error != CL_SUCCESS)
+    {
+        return error;
+    }
+
     cl_bool supported = CL_FALSE;
     std::string test_macro_name = "";
     std::vector<std::string> supported_features_vec;
@@ -19,12 +19,19 @@
 #include <stdio.h>
 #include <string.h>
 #include <errno.h>
+#include <string>
+#include <vector>
 #include "harness/testHarness.h"
+#include "harness/deviceInfo.h"
 #include "harness/errorHelpers.h"
 #include "harness/kernelHelpers.h"
+#include "harness/ThreadPool.h"
 
 static int dump_supported_formats;
 
+// Set by --snapshot to the file the device capability snapshot is written to
+static const char* snapshot_file;
+
 typedef struct
 {
     cl_device_type device_type;
@@ -309,7 +316,54 @@ static const struct supported_flags_entry supported_flags[] = {
     ENTRY(1, 0, CL_MEM_READ_WRITE), ENTRY(2, 0, CL_MEM_KERNEL_READ_AND_WRITE)
 };
 
-int getImageInfo(cl_device_id device, const version_t& version)
+// Appends "key": to the members of a JSON object
+static void appendJsonKey(std::string& json, const char* key)
+{
+    if (!json.empty()) json += ",";
+    json += "\n      \"";
+    json += key;
+    json += "\": ";
+}
+
+static void appendJsonString(std::string& json, const char* str)
+{
+    json += '"';
+    for (; *str; str++)
+    {
+        unsigned char c = (unsigned char)*str;
+        if (c == '"' || c == '\\')
+        {
+            json += '\\';
+            json += (char)c;
+        }
+        else if (c < 0x20)
+        {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            json += escaped;
+        }
+        else
+        {
+            json += (char)c;
+        }
+    }
+    json += '"';
+}
+
+static void appendJsonUnsigned(std::string& json, cl_ulong value)
+{
+    json += std::to_string(value);
+}
+
+static void appendJsonVersion(std::string& json, cl_version version)
+{
+    json += "\"" + std::to_string(CL_VERSION_MAJOR_KHR(version)) + "."
+        + std::to_string(CL_VERSION_MINOR_KHR(version)) + "."
+        + std::to_string(CL_VERSION_PATCH_KHR(version)) + "\"";
+}
+
+int getImageInfo(cl_device_id device, const version_t& version,
+                 std::string* json)
 {
     cl_context ctx;
     cl_int err;
@@ -354,6 +408,13 @@ int getImageInfo(cl_device_id device, const version_t& version)
 
             log_info("\t\t%s: %u supported formats\n", supported_flags[fi].str,
                      num_supported);
+            if (json)
+            {
+                std::string key = std::string(image_types[ii].str) + " "
+                    + supported_flags[fi].str + " formats";
+                appendJsonKey(*json, key.c_str());
+                appendJsonUnsigned(*json, num_supported);
+            }
 
             if (num_supported == 0 || dump_supported_formats == 0) continue;
 
@@ -928,6 +989,92 @@ void dumpConfigInfo(config_info* info)
     }
 }
 
+// Appends info to the members of the JSON object of a snapshot. Bitfields
+// and enums are written as their numeric values, so that bits a vendor adds
+// beyond the specification are kept.
+void appendConfigInfoJson(std::string& json, const config_info* info)
+{
+    switch (info->config_type)
+    {
+        case type_cl_device_id:
+            // Handles don't identify anything beyond this process
+            return;
+        default: break;
+    }
+
+    appendJsonKey(json, info->opcode_name);
+    switch (info->config_type)
+    {
+        case type_cl_device_type:
+            appendJsonUnsigned(json, info->config.type);
+            break;
+        case type_cl_device_fp_config:
+            appendJsonUnsigned(json, info->config.fp_config);
+            break;
+        case type_cl_device_mem_cache_type:
+            appendJsonUnsigned(json, info->config.mem_cache_type);
+            break;
+        case type_cl_local_mem_type:
+            appendJsonUnsigned(json, info->config.local_mem_type);
+            break;
+        case type_cl_device_exec_capabilities:
+            appendJsonUnsigned(json, info->config.exec_capabilities);
+            break;
+        case type_cl_command_queue_properties:
+            appendJsonUnsigned(json, info->config.queue_properties);
+            break;
+        case type_cl_device_affinity_domain:
+            appendJsonUnsigned(json, info->config.affinity_domain);
+            break;
+        case type_cl_uint:
+            appendJsonUnsigned(json, (cl_uint)info->config.uint);
+            break;
+        case type_size_t_arr:
+            json += "[";
+            for (int i = 0; i < 3; i++)
+            {
+                if (i) json += ", ";
+                appendJsonUnsigned(json, info->config.sizet_arr[i]);
+            }
+            json += "]";
+            break;
+        case type_size_t: appendJsonUnsigned(json, info->config.sizet); break;
+        case type_cl_ulong: appendJsonUnsigned(json, info->config.ull); break;
+        case type_string: appendJsonString(json, info->config.string); break;
+        case type_cl_device_svm_capabilities:
+            appendJsonUnsigned(json, info->config.svmCapabilities);
+            break;
+        case type_cl_device_atomic_capabilities:
+            appendJsonUnsigned(json, info->config.atomicCapabilities);
+            break;
+        case type_cl_device_device_enqueue_capabilities:
+            appendJsonUnsigned(json, info->config.deviceEnqueueCapabilities);
+            break;
+        case type_cl_name_version_array: {
+            size_t count = info->opcode_ret_size
+                / sizeof(*info->config.cl_name_version_array);
+            json += "[";
+            for (size_t f = 0; f < count; f++)
+            {
+                const cl_name_version& item =
+                    info->config.cl_name_version_array[f];
+                json += f ? ", { \"name\": " : "{ \"name\": ";
+                appendJsonString(json, item.name);
+                json += ", \"version\": ";
+                appendJsonVersion(json, item.version);
+                json += " }";
+            }
+            json += "]";
+            break;
+        }
+        case type_cl_name_version:
+            appendJsonVersion(json,
+                              info->config.cl_name_version_single.version);
+            break;
+        default: json += "null"; break;
+    }
+}
+
 void print_platform_string_selector(cl_platform_id platform,
                                     const char* selector_name,
                                     cl_platform_info selector)
@@ -1079,7 +1226,9 @@ int parseExtensions(char const* str, extensions_t* extensions)
     return 0;
 }
 
-int getConfigInfos(cl_device_id device)
+// Prints the configuration of device, and appends it to json unless that is
+// NULL
+int getConfigInfos(cl_device_id device, std::string* json)
 {
     int total_errors = 0;
     unsigned onConfigInfo;
@@ -1120,6 +1269,7 @@ int getConfigInfos(cl_device_id device)
             if (!err)
             {
                 dumpConfigInfo(&info);
+                if (json) appendConfigInfoJson(*json, &info);
                 if (info.opcode == CL_DEVICE_VERSION)
                 {
                     err = parseVersion(info.config.string, &version);
@@ -1174,6 +1324,7 @@ int getConfigInfos(cl_device_id device)
                 if (!err)
                 {
                     dumpConfigInfo(&info);
+                    if (json) appendConfigInfoJson(*json, &info);
                 }
                 else
                 {
@@ -1183,7 +1334,7 @@ int getConfigInfos(cl_device_id device)
         }
     }
 
-    total_errors += getImageInfo(device, version);
+    total_errors += getImageInfo(device, version, json);
 
     return total_errors;
 }
@@ -1200,7 +1351,7 @@ config_info config_platform_infos[] = {
     CONFIG_INFO(3, 0, CL_PLATFORM_NUMERIC_VERSION, cl_name_version)
 };
 
-int getPlatformCapabilities(cl_platform_id platform)
+int getPlatformCapabilities(cl_platform_id platform, std::string* json)
 {
     int total_errors = 0;
     version_t version = { 0, 0 }; // Version of the device. Will get real value
@@ -1218,6 +1369,7 @@ int getPlatformCapabilities(cl_platform_id platform)
             if (!err)
             {
                 dumpConfigInfo(&info);
+                if (json) appendConfigInfoJson(*json, &info);
                 if (info.opcode == CL_PLATFORM_VERSION)
                 {
                     err = parseVersion(info.config.string, &version);
@@ -1250,21 +1402,38 @@ int getPlatformCapabilities(cl_platform_id platform)
     return total_errors;
 }
 
-int test_computeinfo(cl_device_id deviceID, cl_context context,
-                     cl_command_queue ignoreQueue, int num_elements)
+struct DeviceInfoJob
 {
-    int err;
-    int total_errors = 0;
-    cl_platform_id platform;
+    cl_device_id device;
+    const char* device_type_name;
+    std::string header; // What was printed before the device's info
+    std::string log;
+    std::string json;
+    int errors;
+};
 
-    err = clGetPlatformIDs(1, &platform, NULL);
-    test_error(err, "clGetPlatformIDs failed");
+// Queues device up to be queried, with everything printed since the last
+// device as its header
+static void addDeviceInfoJob(std::vector<DeviceInfoJob>& jobs,
+                             std::string& pending, cl_device_id device,
+                             const char* device_type_name)
+{
+    DeviceInfoJob job;
+    job.device = device;
+    job.device_type_name = device_type_name;
+    job.header.swap(pending);
+    job.errors = 0;
+    jobs.push_back(job);
+}
 
-    // print platform info
-    log_info("\nclGetPlatformInfo:\n------------------\n");
-    err = getPlatformCapabilities(platform);
-    test_error(err, "getPlatformCapabilities failed");
-    log_info("\n");
+// Finds the devices to print the info of. The caller captures the log, so
+// that the messages printed along the way are kept until the devices before
+// them have been printed.
+static int collectDeviceInfoJobs(cl_platform_id platform,
+                                 std::vector<DeviceInfoJob>& jobs,
+                                 std::string& pending)
+{
+    int err;
 
     // Check to see if this test is being run on a specific device
     char* device_type_env = getenv("CL_DEVICE_TYPE");
@@ -1354,8 +1523,8 @@ int test_computeinfo(cl_device_id deviceID, cl_context context,
         log_info("%s Device %d of %d Info:\n",
                  device_infos[device_type_idx].device_type_name,
                  (unsigned)device_index + 1, num_devices);
-        total_errors += getConfigInfos(device);
-        log_info("\n");
+        addDeviceInfoJob(jobs, pending, device,
+                         device_infos[device_type_idx].device_type_name);
     }
 
     // Otherwise iterate over all of the devices in the platform
@@ -1395,9 +1564,9 @@ int test_computeinfo(cl_device_id deviceID, cl_context context,
                 log_info("%s Device %zu of %d Info:\n",
                          device_infos[onInfo].device_type_name, onDevice + 1,
                          device_infos[onInfo].num_devices);
-                total_errors +=
-                    getConfigInfos(device_infos[onInfo].devices[onDevice]);
-                log_info("\n");
+                addDeviceInfoJob(jobs, pending,
+                                 device_infos[onInfo].devices[onDevice],
+                                 device_infos[onInfo].device_type_name);
             }
 
             if (device_infos[onInfo].num_devices)
@@ -1407,6 +1576,135 @@ int test_computeinfo(cl_device_id deviceID, cl_context context,
         }
     }
 
+    return CL_SUCCESS;
+}
+
+// Queries one device on a pool thread, holding back its output
+static cl_int getDeviceInfoJob(DeviceInfoJob& job)
+{
+    log_capture_begin(&job.log);
+    job.errors = getConfigInfos(job.device, snapshot_file ? &job.json : NULL);
+    log_info("\n");
+    log_capture_end();
+
+    // Also fill the on-disk snapshot cache the other suites read from, see
+    // deviceInfo.h, while the device is being queried anyway
+    if (getenv("CL_DEVICE_INFO_CACHE")) get_device_snapshot(job.device);
+
+    // Failures are reported through the job, so that every device is queried
+    return CL_SUCCESS;
+}
+
+// FNV-1a, the fingerprint of a device's capabilities in the snapshot
+static cl_ulong hashCapabilities(const std::string& json)
+{
+    cl_ulong hash = 0xcbf29ce484222325ULL;
+    for (unsigned char c : json)
+    {
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+// Writes the platform and device info as JSON, one entry per device however
+// many device types list it
+static int writeSnapshot(const char* path, const std::string& platformJson,
+                         const std::vector<DeviceInfoJob>& jobs)
+{
+    std::string out = "{\n  \"platform\": {" + platformJson + "\n  },\n";
+    out += "  \"devices\": [";
+    std::vector<cl_device_id> written;
+    for (const DeviceInfoJob& job : jobs)
+    {
+        bool seen = false;
+        for (cl_device_id device : written) seen |= device == job.device;
+        if (seen) continue;
+
+        char fingerprint[32];
+        snprintf(fingerprint, sizeof(fingerprint), "%016" PRIx64,
+                 (uint64_t)hashCapabilities(job.json));
+        out += written.empty() ? "\n    {" : ",\n    {";
+        out += "\n      \"type\": \"" + std::string(job.device_type_name)
+            + "\",";
+        out += "\n      \"fingerprint\": \"" + std::string(fingerprint)
+            + "\",";
+        out += "\n      \"info\": {" + job.json + "\n      }\n    }";
+        written.push_back(job.device);
+    }
+    out += "\n  ]\n}\n";
+
+    FILE* file = fopen(path, "w");
+    if (file == NULL)
+    {
+        log_error("Unable to open %s to write the snapshot to: %s\n", path,
+                  strerror(errno));
+        return 1;
+    }
+    size_t written_size = fwrite(out.data(), 1, out.size(), file);
+    if (fclose(file) != 0 || written_size != out.size())
+    {
+        log_error("Unable to write the snapshot to %s\n", path);
+        return 1;
+    }
+    log_info("Wrote the snapshot of %zu devices to %s\n", written.size(),
+             path);
+    return 0;
+}
+
+int test_computeinfo(cl_device_id deviceID, cl_context context,
+                     cl_command_queue ignoreQueue, int num_elements)
+{
+    int err;
+    int total_errors = 0;
+    cl_platform_id platform;
+    std::string platformJson;
+
+    err = clGetPlatformIDs(1, &platform, NULL);
+    test_error(err, "clGetPlatformIDs failed");
+
+    // print platform info
+    log_info("\nclGetPlatformInfo:\n------------------\n");
+    err = getPlatformCapabilities(platform,
+                                  snapshot_file ? &platformJson : NULL);
+    test_error(err, "getPlatformCapabilities failed");
+    log_info("\n");
+
+    // The devices are queried in parallel, as each query may be a round trip
+    // to a remote or virtualized device, and each device's info is printed as
+    // soon as it and the devices before it are done
+    std::vector<DeviceInfoJob> jobs;
+    std::string pending;
+    log_capture_begin(&pending);
+    err = collectDeviceInfoJobs(platform, jobs, pending);
+    log_capture_end();
+
+    std::vector<ThreadPoolTask> tasks;
+    for (DeviceInfoJob& job : jobs)
+        tasks.push_back(
+            ThreadPool_Submit([&job]() { return getDeviceInfoJob(job); }));
+
+    for (size_t i = 0; i < jobs.size(); i++)
+    {
+        const DeviceInfoJob& job = jobs[i];
+        tasks[i].wait();
+        log_info("%s", job.header.c_str());
+        if (job.errors)
+            log_error("%s", job.log.c_str());
+        else
+            log_info("%s", job.log.c_str());
+        total_errors += job.errors;
+    }
+    if (err)
+    {
+        log_error("%s", pending.c_str());
+        return err;
+    }
+    log_info("%s", pending.c_str());
+
+    if (snapshot_file)
+        total_errors += writeSnapshot(snapshot_file, platformJson, jobs);
+
     return total_errors;
 }
 
@@ -1445,6 +1743,10 @@ int main(int argc, const char** argv)
         {
             dump_supported_formats = 1;
         }
+        else if (strcmp(argv[i], "--snapshot") == 0 && i + 1 < argc)
+        {
+            snapshot_file = argv[++i];
+        }
         else
         {
             argList[argCount] = argv[i];
@@ -65,6 +65,13 @@ __thread fpu_control_t fpu_control = 0;
 #define MAXPATHLEN  2048
 #endif
 
+// Where the references are plain float arithmetic, and can be computed with a
+// loop the compiler vectorizes
+#if !(defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64)))            \
+    && !defined(__PPC__)
+#define CONTRACTIONS_VECTOR_REFERENCE 1
+#endif
+
 char                appName[ MAXPATHLEN ] = "";
 cl_context          gContext = NULL;
 cl_command_queue    gQueue = NULL;
@@ -88,6 +95,9 @@ cl_mem              bufD_double = NULL;
 float               *buf1, *buf2, *buf3, *buf4, *buf5, *buf6;
 float               *correct[8];
 int                     *skipTest[8];
+int                 *bufSkip = NULL;
+int                 gRoundTowardZero = 0;
+int                 gRounds = 1;
 
 double              *buf3_double, *buf4_double, *buf5_double, *buf6_double;
 double              *correct_double[8];
@@ -102,8 +112,11 @@ static int ParseArgs( int argc, const char **argv );
 static void PrintUsage( void );
 test_status InitCL( cl_device_id device );
 static void ReleaseCL( void );
+static int GenerateData( void );
 static int RunTest( int testNumber );
 static int RunTest_Double( int testNumber );
+static int RunTestRound( int testNumber );
+static int RunTestRound_Double( int testNumber );
 
 #if defined(__ANDROID__)
 #define nanf( X ) strtof( "NAN", ( char ** ) NULL )
@@ -421,6 +434,17 @@ static int ParseArgs( int argc, const char **argv )
                         gForceFTZ ^= 1;
                         break;
 
+                    case 'r':
+                        gRounds = atoi(arg + 1);
+                        while (arg[1] >= '0' && arg[1] <= '9') arg++;
+                        if (gRounds < 1)
+                        {
+                            vlog_error("-r needs a number of rounds\n");
+                            PrintUsage();
+                            return -1;
+                        }
+                        break;
+
                     default:
                         vlog( " <-- unknown flag: %c (0x%2.2x)\n)", *arg, *arg );
                         PrintUsage();
@@ -446,6 +470,8 @@ static void PrintUsage( void )
     vlog( "\tOptions:\n" );
     vlog( "\t\t-z\tToggle FTZ mode (Section 6.5.3) for all functions. (Set by device capabilities by default.)\n" );
     vlog( "\t\t-sNUMBER set random seed.\n");
+    vlog("\t\t-rNUMBER run each test on NUMBER sets of random inputs, a sweep\n"
+         "\t\t\tof NUMBER times as many operands. (1 by default.)\n");
     vlog( "\n" );
     vlog( "\tTest names:\n" );
     for( int i = 0; i < test_num; i++ )
@@ -461,9 +487,6 @@ test_status InitCL( cl_device_id device )
 {
     int error;
     uint32_t i, j;
-    int *bufSkip = NULL;
-    int isRTZ = 0;
-    RoundingMode oldRoundMode = kDefaultRoundingMode;
 
     cl_device_fp_config floatCapabilities = 0;
     if( (error = clGetDeviceInfo(device, CL_DEVICE_SINGLE_FP_CONFIG, sizeof(floatCapabilities), &floatCapabilities, NULL)))
@@ -650,157 +673,8 @@ test_status InitCL( cl_device_id device )
             }
         }
 
-        for( i = 0; i < BUFFER_SIZE / sizeof(float); i++ )
-            ((uint32_t*) buf1)[i] = genrand_int32( gMTdata );
-
-        if( (error = clEnqueueWriteBuffer(gQueue, bufA, CL_FALSE, 0, BUFFER_SIZE, buf1, 0, NULL, NULL) ))
-        {
-            vlog_error( "Failure %d at clEnqueueWriteBuffer1\n", error );
-            return TEST_FAIL;
-        }
-
-        for( i = 0; i < BUFFER_SIZE / sizeof(float); i++ )
-            ((uint32_t*) buf2)[i] = genrand_int32( gMTdata );
-
-        if( (error = clEnqueueWriteBuffer(gQueue, bufB, CL_FALSE, 0, BUFFER_SIZE, buf2, 0, NULL, NULL) ))
-        {
-            vlog_error( "Failure %d at clEnqueueWriteBuffer2\n", error );
-            return TEST_FAIL;
-        }
-
-        void *ftzInfo = NULL;
-        if( gForceFTZ )
-            ftzInfo = FlushToZero();
-        if ((CL_FP_ROUND_TO_ZERO == get_default_rounding_mode(device)) && gIsEmbedded) {
-            oldRoundMode = set_round(kRoundTowardZero, kfloat);
-            isRTZ = 1;
-        }
-        float *f = (float*) buf1;
-        float *f2 = (float*) buf2;
-        float *f3 = (float*) buf3;
-        float *f4 = (float*) buf4;
-        for( i = 0; i < BUFFER_SIZE / sizeof(float); i++ )
-        {
-            float q = f[i];
-            float q2 = f2[i];
-
-            feclearexcept(FE_OVERFLOW);
-#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
-            // VS2005 might use x87 for straight multiplies, and we can't
-            // turn that off
-            f3[i] = sse_mul(q, q2);
-            f4[i] = sse_mul(-q, q2);
-#elif defined(__PPC__)
-            // None of the current generation PPC processors support HW
-            // FTZ, emulate it in sw.
-            f3[i] = ppc_mul(q, q2);
-            f4[i] = ppc_mul(-q, q2);
-#else
-            f3[i] = q * q2;
-            f4[i] = -q * q2;
-#endif
-            // Skip test if the device doesn't support infinities and NaN AND the result overflows
-            // or either input is an infinity of NaN
-            bufSkip[i] = (gSkipNanInf && ((FE_OVERFLOW == (FE_OVERFLOW & fetestexcept(FE_OVERFLOW))) ||
-                                          (fabsf(q)  == FLT_MAX) || (q  != q)  ||
-                                          (fabsf(q2) == FLT_MAX) || (q2 != q2)));
-        }
-
-        if( gForceFTZ )
-            UnFlushToZero(ftzInfo);
-
-    if (isRTZ)
-      (void)set_round(oldRoundMode, kfloat);
-
-
-        if( (error = clEnqueueWriteBuffer(gQueue, bufC, CL_FALSE, 0, BUFFER_SIZE, buf3, 0, NULL, NULL) ))
-        {
-            vlog_error( "Failure %d at clEnqueueWriteBuffer3\n", error );
-            return TEST_FAIL;
-        }
-        if( (error = clEnqueueWriteBuffer(gQueue, bufD, CL_FALSE, 0, BUFFER_SIZE, buf4, 0, NULL, NULL) ))
-        {
-            vlog_error( "Failure %d at clEnqueueWriteBuffer4\n", error );
-            return TEST_FAIL;
-        }
-
-        // Fill the buffers with NaN
-        float *f5 = (float*) buf5;
-        float nan_val = nanf("");
-        for( i = 0; i < BUFFER_SIZE / sizeof( float ); i++ )
-            f5[i] = nan_val;
-
-        // calculate reference results
-        for( i = 0; i < BUFFER_SIZE / sizeof( float ); i++ )
-        {
-            for ( j=0; j<8; j++)
-            {
-                feclearexcept(FE_OVERFLOW);
-                switch (j)
-                {
-#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
-                        // VS2005 might use x87 for straight add/sub, and we can't
-                        // turn that off
-                    case 0:
-                        correct[0][i] = sse_add(buf3[i],buf4[i]); break;
-                    case 1:
-                        correct[1][i] = sse_sub(buf3[i],buf3[i]); break;
-                    case 2:
-                        correct[2][i] = sse_add(buf4[i],buf3[i]); break;
-                    case 3:
-                        correct[3][i] = sse_sub(buf3[i],buf3[i]); break;
-                    case 4:
-                        correct[4][i] = -sse_add(buf3[i],buf4[i]); break;
-                    case 5:
-                        correct[5][i] = -sse_sub(buf3[i],buf3[i]); break;
-                    case 6:
-                        correct[6][i] = -sse_add(buf4[i],buf3[i]); break;
-                    case 7:
-                        correct[7][i] = -sse_sub(buf3[i],buf3[i]); break;
-#else
-                    case 0:
-                        correct[0][i] = buf3[i] + buf4[i]; break;
-                    case 1:
-                        correct[1][i] = buf3[i] - buf3[i]; break;
-                    case 2:
-                        correct[2][i] = buf4[i] + buf3[i]; break;
-                    case 3:
-                        correct[3][i] = buf3[i] - buf3[i]; break;
-                    case 4:
-                        correct[4][i] = -(buf3[i] + buf4[i]); break;
-                    case 5:
-                        correct[5][i] = -(buf3[i] - buf3[i]); break;
-                    case 6:
-                        correct[6][i] = -(buf4[i] + buf3[i]); break;
-                    case 7:
-                        correct[7][i] = -(buf3[i] - buf3[i]); break;
-#endif
-                }
-                // Further skip test inputs if the device doesn support infinities AND NaNs
-                // resulting sum overflows
-                skipTest[j][i] = (bufSkip[i] ||
-                                  (gSkipNanInf && (FE_OVERFLOW == (FE_OVERFLOW & fetestexcept(FE_OVERFLOW)))));
-
-#if defined(__PPC__)
-                // Since the current Power processors don't emulate flush to zero in HW,
-                // it must be emulated in SW instead.
-                if (gForceFTZ)
-                {
-                    if ((fabsf(correct[j][i]) < FLT_MIN) && (correct[j][i] != 0.0f))
-                        correct[j][i] = copysignf(0.0f, correct[j][i]);
-                }
-#endif
-            }
-        }
         if( gHasDouble )
         {
-            // Spec requires correct non-flushed results
-            // for doubles. We disable FTZ if this is default on
-            // the platform (like ARM) for reference result computation
-            // It is no-op if platform default is not FTZ (e.g. x86)
-            FPU_mode_type oldMode;
-            DisableFTZ( &oldMode );
-
             buf3_double = (double *)malloc( BUFFER_SIZE );
             buf4_double = (double *)malloc( BUFFER_SIZE );
             buf5_double = (double *)malloc( BUFFER_SIZE );
@@ -819,74 +693,22 @@ test_status InitCL( cl_device_id device )
                     return TEST_FAIL;
                 }
             }
+        }
 
-
-            double *f  = (double*) buf1;
-            double *f2 = (double*) buf2;
-            double *f3 = (double*) buf3_double;
-            double *f4 = (double*) buf4_double;
-            for( i = 0; i < BUFFER_SIZE / sizeof(double); i++ )
-            {
-                double q = f[i];
-                double q2 = f2[i];
-#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
-                // VS2005 might use x87 for straight multiplies, and we can't
-                // turn that off
-                f3[i] = sse_mul_sd(q, q2);
-                f4[i] = sse_mul_sd(-q, q2);
-#else
-                f3[i] = q * q2;
-                f4[i] = -q * q2;
-#endif
-            }
-
-            if( (error = clEnqueueWriteBuffer(gQueue, bufC_double, CL_FALSE, 0, BUFFER_SIZE, buf3_double, 0, NULL, NULL) ))
-            {
-                vlog_error( "Failure %d at clEnqueueWriteBuffer3\n", error );
-                return TEST_FAIL;
-            }
-            if( (error = clEnqueueWriteBuffer(gQueue, bufD_double, CL_FALSE, 0, BUFFER_SIZE, buf4_double, 0, NULL, NULL) ))
-            {
-                vlog_error( "Failure %d at clEnqueueWriteBuffer4\n", error );
-                return TEST_FAIL;
-            }
-
-            // Fill the buffers with NaN
-            double *f5 = (double*) buf5_double;
-            double nan_val = nanf("");
-            for( i = 0; i < BUFFER_SIZE / sizeof( double ); i++ )
-                f5[i] = nan_val;
-
-            // calculate reference results
+        // Fill the result buffers with NaN
+        float *f5 = (float*) buf5;
+        float nan_val = nanf("");
+        for( i = 0; i < BUFFER_SIZE / sizeof( float ); i++ )
+            f5[i] = nan_val;
+        if( gHasDouble )
+        {
+            double *d5 = (double*) buf5_double;
             for( i = 0; i < BUFFER_SIZE / sizeof( double ); i++ )
-            {
-#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
-                // VS2005 might use x87 for straight add/sub, and we can't
-                // turn that off
-                correct_double[0][i] = sse_add_sd(buf3_double[i],buf4_double[i]);
-                correct_double[1][i] = sse_sub_sd(buf3_double[i],buf3_double[i]);
-                correct_double[2][i] = sse_add_sd(buf4_double[i],buf3_double[i]);
-                correct_double[3][i] = sse_sub_sd(buf3_double[i],buf3_double[i]);
-                correct_double[4][i] = -sse_add_sd(buf3_double[i],buf4_double[i]);
-                correct_double[5][i] = -sse_sub_sd(buf3_double[i],buf3_double[i]);
-                correct_double[6][i] = -sse_add_sd(buf4_double[i],buf3_double[i]);
-                correct_double[7][i] = -sse_sub_sd(buf3_double[i],buf3_double[i]);
-#else
-                correct_double[0][i] = buf3_double[i] + buf4_double[i];
-                correct_double[1][i] = buf3_double[i] - buf3_double[i];
-                correct_double[2][i] = buf4_double[i] + buf3_double[i];
-                correct_double[3][i] = buf3_double[i] - buf3_double[i];
-                correct_double[4][i] = -(buf3_double[i] + buf4_double[i]);
-                correct_double[5][i] = -(buf3_double[i] - buf3_double[i]);
-                correct_double[6][i] = -(buf4_double[i] + buf3_double[i]);
-                correct_double[7][i] = -(buf3_double[i] - buf3_double[i]);
-#endif
-            }
-
-            // Restore previous FP state since we modified it for
-            // reference result computation (see DisableFTZ call above)
-            RestoreFPState(&oldMode);
+                d5[i] = nan_val;
         }
+
+        gRoundTowardZero = (CL_FP_ROUND_TO_ZERO == get_default_rounding_mode(device)) && gIsEmbedded;
+        if (GenerateData()) return TEST_FAIL;
     }
 
     char c[1000];
@@ -906,11 +728,255 @@ test_status InitCL( cl_device_id device )
     vlog( "\tTesting with FTZ mode ON? %s\n", no_yes[0 != gForceFTZ] );
     vlog( "\tTesting Doubles? %s\n", no_yes[0 != gHasDouble] );
     vlog( "\tRandom Number seed: 0x%8.8x\n", gSeed );
+    vlog("\tRounds of random inputs: %d\n", gRounds);
     vlog( "\n\n" );
 
     return TEST_PASS;
 }
 
+// Fill the input buffers with the next random operands and compute what each
+// test expects for them. Called once from InitCL and again before each further
+// round of -r.
+static int GenerateData( void )
+{
+    int error;
+    uint32_t i, j;
+    RoundingMode oldRoundMode = kDefaultRoundingMode;
+
+    for( i = 0; i < BUFFER_SIZE / sizeof(float); i++ )
+        ((uint32_t*) buf1)[i] = genrand_int32( gMTdata );
+
+    if( (error = clEnqueueWriteBuffer(gQueue, bufA, CL_FALSE, 0, BUFFER_SIZE, buf1, 0, NULL, NULL) ))
+    {
+        vlog_error( "Failure %d at clEnqueueWriteBuffer1\n", error );
+        return -1;
+    }
+
+    for( i = 0; i < BUFFER_SIZE / sizeof(float); i++ )
+        ((uint32_t*) buf2)[i] = genrand_int32( gMTdata );
+
+    if( (error = clEnqueueWriteBuffer(gQueue, bufB, CL_FALSE, 0, BUFFER_SIZE, buf2, 0, NULL, NULL) ))
+    {
+        vlog_error( "Failure %d at clEnqueueWriteBuffer2\n", error );
+        return -1;
+    }
+
+    void *ftzInfo = NULL;
+    if( gForceFTZ )
+        ftzInfo = FlushToZero();
+    if (gRoundTowardZero)
+        oldRoundMode = set_round(kRoundTowardZero, kfloat);
+    float *f = (float*) buf1;
+    float *f2 = (float*) buf2;
+    float *f3 = (float*) buf3;
+    float *f4 = (float*) buf4;
+#if defined(CONTRACTIONS_VECTOR_REFERENCE)
+    if (!gSkipNanInf)
+    {
+        // Nothing is skipped, so there is no overflow to sample and the
+        // loop can be vectorized
+        for (i = 0; i < BUFFER_SIZE / sizeof(float); i++)
+        {
+            f3[i] = f[i] * f2[i];
+            f4[i] = -f[i] * f2[i];
+        }
+        memset(bufSkip, 0, BUFFER_SIZE);
+    }
+    else
+#endif
+    for( i = 0; i < BUFFER_SIZE / sizeof(float); i++ )
+    {
+        float q = f[i];
+        float q2 = f2[i];
+
+        feclearexcept(FE_OVERFLOW);
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+        // VS2005 might use x87 for straight multiplies, and we can't
+        // turn that off
+        f3[i] = sse_mul(q, q2);
+        f4[i] = sse_mul(-q, q2);
+#elif defined(__PPC__)
+        // None of the current generation PPC processors support HW
+        // FTZ, emulate it in sw.
+        f3[i] = ppc_mul(q, q2);
+        f4[i] = ppc_mul(-q, q2);
+#else
+        f3[i] = q * q2;
+        f4[i] = -q * q2;
+#endif
+        // Skip test if the device doesn't support infinities and NaN AND the result overflows
+        // or either input is an infinity of NaN
+        bufSkip[i] = (gSkipNanInf && ((FE_OVERFLOW == (FE_OVERFLOW & fetestexcept(FE_OVERFLOW))) ||
+                                      (fabsf(q)  == FLT_MAX) || (q  != q)  ||
+                                      (fabsf(q2) == FLT_MAX) || (q2 != q2)));
+    }
+
+    if( gForceFTZ )
+        UnFlushToZero(ftzInfo);
+
+    if (gRoundTowardZero)
+        (void)set_round(oldRoundMode, kfloat);
+
+
+    if( (error = clEnqueueWriteBuffer(gQueue, bufC, CL_FALSE, 0, BUFFER_SIZE, buf3, 0, NULL, NULL) ))
+    {
+        vlog_error( "Failure %d at clEnqueueWriteBuffer3\n", error );
+        return -1;
+    }
+    if( (error = clEnqueueWriteBuffer(gQueue, bufD, CL_FALSE, 0, BUFFER_SIZE, buf4, 0, NULL, NULL) ))
+    {
+        vlog_error( "Failure %d at clEnqueueWriteBuffer4\n", error );
+        return -1;
+    }
+
+    // calculate reference results
+#if defined(CONTRACTIONS_VECTOR_REFERENCE)
+    if (!gSkipNanInf)
+    {
+        // A loop per expression, which the compiler vectorizes, as the
+        // sums don't need their overflow sampled either
+        const size_t count = BUFFER_SIZE / sizeof(float);
+        for (i = 0; i < count; i++) correct[0][i] = buf3[i] + buf4[i];
+        for (i = 0; i < count; i++) correct[1][i] = buf3[i] - buf3[i];
+        for (i = 0; i < count; i++) correct[2][i] = buf4[i] + buf3[i];
+        for (i = 0; i < count; i++) correct[3][i] = buf3[i] - buf3[i];
+        for (i = 0; i < count; i++) correct[4][i] = -(buf3[i] + buf4[i]);
+        for (i = 0; i < count; i++) correct[5][i] = -(buf3[i] - buf3[i]);
+        for (i = 0; i < count; i++) correct[6][i] = -(buf4[i] + buf3[i]);
+        for (i = 0; i < count; i++) correct[7][i] = -(buf3[i] - buf3[i]);
+        for (j = 0; j < 8; j++) memset(skipTest[j], 0, BUFFER_SIZE);
+    }
+    else
+#endif
+    for( i = 0; i < BUFFER_SIZE / sizeof( float ); i++ )
+    {
+        for ( j=0; j<8; j++)
+        {
+            feclearexcept(FE_OVERFLOW);
+            switch (j)
+            {
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+                    // VS2005 might use x87 for straight add/sub, and we can't
+                    // turn that off
+                case 0:
+                    correct[0][i] = sse_add(buf3[i],buf4[i]); break;
+                case 1:
+                    correct[1][i] = sse_sub(buf3[i],buf3[i]); break;
+                case 2:
+                    correct[2][i] = sse_add(buf4[i],buf3[i]); break;
+                case 3:
+                    correct[3][i] = sse_sub(buf3[i],buf3[i]); break;
+                case 4:
+                    correct[4][i] = -sse_add(buf3[i],buf4[i]); break;
+                case 5:
+                    correct[5][i] = -sse_sub(buf3[i],buf3[i]); break;
+                case 6:
+                    correct[6][i] = -sse_add(buf4[i],buf3[i]); break;
+                case 7:
+                    correct[7][i] = -sse_sub(buf3[i],buf3[i]); break;
+#else
+                case 0:
+                    correct[0][i] = buf3[i] + buf4[i]; break;
+                case 1:
+                    correct[1][i] = buf3[i] - buf3[i]; break;
+                case 2:
+                    correct[2][i] = buf4[i] + buf3[i]; break;
+                case 3:
+                    correct[3][i] = buf3[i] - buf3[i]; break;
+                case 4:
+                    correct[4][i] = -(buf3[i] + buf4[i]); break;
+                case 5:
+                    correct[5][i] = -(buf3[i] - buf3[i]); break;
+                case 6:
+                    correct[6][i] = -(buf4[i] + buf3[i]); break;
+                case 7:
+                    correct[7][i] = -(buf3[i] - buf3[i]); break;
+#endif
+            }
+            // Further skip test inputs if the device doesn support infinities AND NaNs
+            // resulting sum overflows
+            skipTest[j][i] = (bufSkip[i] ||
+                              (gSkipNanInf && (FE_OVERFLOW == (FE_OVERFLOW & fetestexcept(FE_OVERFLOW)))));
+
+#if defined(__PPC__)
+            // Since the current Power processors don't emulate flush to zero in HW,
+            // it must be emulated in SW instead.
+            if (gForceFTZ)
+            {
+                if ((fabsf(correct[j][i]) < FLT_MIN) && (correct[j][i] != 0.0f))
+                    correct[j][i] = copysignf(0.0f, correct[j][i]);
+            }
+#endif
+        }
+    }
+    if( gHasDouble )
+    {
+        // Spec requires correct non-flushed results
+        // for doubles. We disable FTZ if this is default on
+        // the platform (like ARM) for reference result computation
+        // It is no-op if platform default is not FTZ (e.g. x86)
+        FPStateGuard ftzGuard(kDisableFTZ);
+
+        double *f  = (double*) buf1;
+        double *f2 = (double*) buf2;
+        double *f3 = (double*) buf3_double;
+        double *f4 = (double*) buf4_double;
+        for( i = 0; i < BUFFER_SIZE / sizeof(double); i++ )
+        {
+            double q = f[i];
+            double q2 = f2[i];
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+            // VS2005 might use x87 for straight multiplies, and we can't
+            // turn that off
+            f3[i] = sse_mul_sd(q, q2);
+            f4[i] = sse_mul_sd(-q, q2);
+#else
+            f3[i] = q * q2;
+            f4[i] = -q * q2;
+#endif
+        }
+
+        if( (error = clEnqueueWriteBuffer(gQueue, bufC_double, CL_FALSE, 0, BUFFER_SIZE, buf3_double, 0, NULL, NULL) ))
+        {
+            vlog_error( "Failure %d at clEnqueueWriteBuffer3\n", error );
+            return -1;
+        }
+        if( (error = clEnqueueWriteBuffer(gQueue, bufD_double, CL_FALSE, 0, BUFFER_SIZE, buf4_double, 0, NULL, NULL) ))
+        {
+            vlog_error( "Failure %d at clEnqueueWriteBuffer4\n", error );
+            return -1;
+        }
+
+        // calculate reference results
+        for( i = 0; i < BUFFER_SIZE / sizeof( double ); i++ )
+        {
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+            // VS2005 might use x87 for straight add/sub, and we can't
+            // turn that off
+            correct_double[0][i] = sse_add_sd(buf3_double[i],buf4_double[i]);
+            correct_double[1][i] = sse_sub_sd(buf3_double[i],buf3_double[i]);
+            correct_double[2][i] = sse_add_sd(buf4_double[i],buf3_double[i]);
+            correct_double[3][i] = sse_sub_sd(buf3_double[i],buf3_double[i]);
+            correct_double[4][i] = -sse_add_sd(buf3_double[i],buf4_double[i]);
+            correct_double[5][i] = -sse_sub_sd(buf3_double[i],buf3_double[i]);
+            correct_double[6][i] = -sse_add_sd(buf4_double[i],buf3_double[i]);
+            correct_double[7][i] = -sse_sub_sd(buf3_double[i],buf3_double[i]);
+#else
+            correct_double[0][i] = buf3_double[i] + buf4_double[i];
+            correct_double[1][i] = buf3_double[i] - buf3_double[i];
+            correct_double[2][i] = buf4_double[i] + buf3_double[i];
+            correct_double[3][i] = buf3_double[i] - buf3_double[i];
+            correct_double[4][i] = -(buf3_double[i] + buf4_double[i]);
+            correct_double[5][i] = -(buf3_double[i] - buf3_double[i]);
+            correct_double[6][i] = -(buf4_double[i] + buf3_double[i]);
+            correct_double[7][i] = -(buf3_double[i] - buf3_double[i]);
+#endif
+        }
+    }
+
+    return 0;
+}
+
 static void ReleaseCL( void )
 {
     clReleaseMemObject(bufA);
@@ -938,7 +1004,37 @@ static void ReleaseCL( void )
 }
 
 
+// Run testNumber on gRounds sets of inputs, each after the first generated
+// afresh
 static int RunTest( int testNumber )
+{
+    for (int round = 0; round < gRounds; round++)
+    {
+        int error;
+        if (round > 0 && GenerateData()) return -1;
+        if ((error = RunTestRound(testNumber))) return error;
+    }
+    return 0;
+}
+
+static int RunTest_Double( int testNumber )
+{
+    if( !gHasDouble )
+    {
+        vlog("Double is not supported, test not run.\n");
+        return 0;
+    }
+
+    for (int round = 0; round < gRounds; round++)
+    {
+        int error;
+        if (round > 0 && GenerateData()) return -1;
+        if ((error = RunTestRound_Double(testNumber))) return error;
+    }
+    return 0;
+}
+
+static int RunTestRound( int testNumber )
 {
     size_t i;
     int error = 0;
@@ -1053,14 +1149,8 @@ static int RunTest( int testNumber )
     return error;
 }
 
-static int RunTest_Double( int testNumber )
+static int RunTestRound_Double( int testNumber )
 {
-    if( !gHasDouble )
-    {
-        vlog("Double is not supported, test not run.\n");
-        return 0;
-    }
-
     size_t i;
     int error = 0;
     cl_mem args[4];
@@ -16,6 +16,8 @@
 #include "harness/testHarness.h"
 #include "harness/compat.h"
 #include "harness/ThreadPool.h"
+#include "harness/checkpoint.h"
+#include "harness/stagingPool.h"
 
 #if defined(__APPLE__)
 #include <sys/sysctl.h>
@@ -45,6 +47,7 @@
 #include <time.h>
 
 #include <algorithm>
+#include <atomic>
 
 #include <vector>
 #include <type_traits>
@@ -313,6 +316,7 @@ static inline void Force64BitFPUPrecision(void)
 
 template <typename InType, typename OutType, bool InFP, bool OutFP>
 int CalcRefValsPat<InType, OutType, InFP, OutFP>::check_result(void *test,
+                                                               uint32_t start,
                                                                uint32_t count,
                                                                int vectorSize)
 {
@@ -323,7 +327,7 @@ int CalcRefValsPat<InType, OutType, InFP, OutFP>::check_result(void *test,
         const cl_half *t = (const cl_half *)test;
         const cl_half *c = (const cl_half *)gRef;
 
-        for (uint32_t i = 0; i < count; i++)
+        for (uint32_t i = start; i < count; i++)
             if (t[i] != c[i] &&
                 // Allow nan's to be binary different
                 !((t[i] & 0x7fff) > 0x7C00 && (c[i] & 0x7fff) > 0x7C00)
@@ -339,7 +343,7 @@ int CalcRefValsPat<InType, OutType, InFP, OutFP>::check_result(void *test,
     { // char/uchar/short/ushort/half/int/uint/long/ulong
         const OutType *t = (const OutType *)test;
         const OutType *c = (const OutType *)gRef;
-        for (uint32_t i = 0; i < count; i++)
+        for (uint32_t i = start; i < count; i++)
             if (t[i] != c[i] && !(a[i] != (cl_uchar)0 && t[i] == (OutType)0))
             {
                 size_t s = sizeof(OutType) * 2;
@@ -356,7 +360,7 @@ int CalcRefValsPat<InType, OutType, InFP, OutFP>::check_result(void *test,
         const cl_uint *t = (const cl_uint *)test;
         const cl_uint *c = (const cl_uint *)gRef;
 
-        for (uint32_t i = 0; i < count; i++)
+        for (uint32_t i = start; i < count; i++)
             if (t[i] != c[i] &&
                 // Allow nan's to be binary different
                 !((t[i] & 0x7fffffffU) > 0x7f800000U
@@ -374,7 +378,7 @@ int CalcRefValsPat<InType, OutType, InFP, OutFP>::check_result(void *test,
         const cl_ulong *t = (const cl_ulong *)test;
         const cl_ulong *c = (const cl_ulong *)gRef;
 
-        for (uint32_t i = 0; i < count; i++)
+        for (uint32_t i = start; i < count; i++)
             if (t[i] != c[i] &&
                 // Allow nan's to be binary different
                 !((t[i] & 0x7fffffffffffffffULL) > 0x7ff0000000000000ULL
@@ -534,9 +538,10 @@ void ConversionsTest::TestTypesConversion(const Type &inType,
                                           const Type &outType, int &testNumber,
                                           int startMinVectorSize)
 {
+    typedef DataInfoSpec<InType, OutType, InFP, OutFP> Spec;
     SaturationMode sat;
     RoundingMode round;
-    int error;
+    bool lastTest = false;
 
     // skip longs on embedded
     if (!gHasLong
@@ -546,7 +551,7 @@ void ConversionsTest::TestTypesConversion(const Type &inType,
         return;
     }
 
-    for (sat = (SaturationMode)0; sat < kSaturationModeCount;
+    for (sat = (SaturationMode)0; sat < kSaturationModeCount && !lastTest;
          sat = (SaturationMode)(sat + 1))
     {
         // skip illegal saturated conversions to float type
@@ -556,6 +561,7 @@ void ConversionsTest::TestTypesConversion(const Type &inType,
             continue;
         }
 
+        std::vector<ConversionMode> modes;
         for (round = (RoundingMode)0; round < kRoundingModeCount;
              round = (RoundingMode)(round + 1))
         {
@@ -565,7 +571,11 @@ void ConversionsTest::TestTypesConversion(const Type &inType,
             }
             else
             {
-                if (gEndTestNumber > 0 && testNumber >= gEndTestNumber) return;
+                if (gEndTestNumber > 0 && testNumber >= gEndTestNumber)
+                {
+                    lastTest = true;
+                    break;
+                }
             }
 
             vlog("%d) Testing convert_%sn%s%s( %sn ):\n", testNumber,
@@ -602,25 +612,46 @@ void ConversionsTest::TestTypesConversion(const Type &inType,
                 continue;
             }
 
+            ConversionMode mode;
+            mode.sat = sat;
+            mode.round = round;
+            mode.testNumber = testNumber;
             // Skip the implicit converts if the rounding mode is
             // not default or test is saturated
             if (0 == startMinVectorSize)
+                mode.minVectorSize =
+                    (sat || round != kDefaultRoundingMode) ? 1 : 0;
+            else
+                mode.minVectorSize = gMinVectorSize;
+            mode.error = 0;
+            modes.push_back(mode);
+        }
+
+        // The rounding modes of a saturation mode go over the same input
+        // blocks together, unless the input is clamped to the range of the
+        // rounding mode
+        if (Spec::input_depends_on_round(sat))
+        {
+            for (ConversionMode &mode : modes)
             {
-                if (sat || round != kDefaultRoundingMode)
-                    gMinVectorSize = 1;
-                else
-                    gMinVectorSize = 0;
+                std::vector<ConversionMode> single(1, mode);
+                DoTests<InType, OutType, InFP, OutFP>(outType, inType, single);
+                mode.error = single[0].error;
             }
+        }
+        else if (!modes.empty())
+        {
+            DoTests<InType, OutType, InFP, OutFP>(outType, inType, modes);
+        }
 
-            if ((error = DoTest<InType, OutType, InFP, OutFP>(outType, inType,
-                                                              sat, round)))
-            {
+        for (const ConversionMode &mode : modes)
+        {
+            if (mode.error)
                 vlog_error("\t *** %d) convert_%sn%s%s( %sn ) "
                            "FAILED ** \n",
-                           testNumber, gTypeNames[outType],
-                           gSaturationNames[sat], gRoundingModeNames[round],
-                           gTypeNames[inType]);
-            }
+                           mode.testNumber, gTypeNames[outType],
+                           gSaturationNames[mode.sat],
+                           gRoundingModeNames[mode.round], gTypeNames[inType]);
         }
     }
 }
@@ -629,74 +660,158 @@ template <typename InType, typename OutType, bool InFP, bool OutFP>
 int ConversionsTest::DoTest(Type outType, Type inType, SaturationMode sat,
                             RoundingMode round)
 {
+    std::vector<ConversionMode> modes(1);
+    modes[0].sat = sat;
+    modes[0].round = round;
+    modes[0].testNumber = -1;
+    modes[0].minVectorSize = gMinVectorSize;
+    modes[0].error = 0;
+    DoTests<InType, OutType, InFP, OutFP>(outType, inType, modes);
+    return modes[0].error;
+}
+
+namespace {
+
+// The state of one mode of DoTests
+template <typename InType, typename OutType, bool InFP, bool OutFP>
+struct ConversionModeRun
+{
+    ConversionModeRun(ConversionMode &mode, const DataInitInfo &info)
+        : mode(mode), round(mode.round), init_info(info)
+    {}
+
+    ConversionMode &mode;
+    // The rounding mode of the reference, which may differ from the mode's
+    // when the default is round toward zero
+    RoundingMode round;
+    DataInfoSpec<InType, OutType, InFP, OutFP> init_info;
+    WriteInputBufferInfo writeInputBufferInfo;
+    std::unique_ptr<JobCheckpoint> checkpoint;
+};
+
+void log_failing_input(Type inType, int index)
+{
+    switch (inType)
+    {
+        case kuchar:
+        case kchar:
+            vlog("Input value: 0x%2.2x ", ((unsigned char *)gIn)[index]);
+            break;
+        case kushort:
+        case kshort:
+            vlog("Input value: 0x%4.4x ", ((unsigned short *)gIn)[index]);
+            break;
+        case kuint:
+        case kint:
+            vlog("Input value: 0x%8.8x ", ((unsigned int *)gIn)[index]);
+            break;
+        case khalf:
+            vlog("Input value: %a ", HTF(((cl_half *)gIn)[index]));
+            break;
+        case kfloat: vlog("Input value: %a ", ((float *)gIn)[index]); break;
+        case kulong:
+        case klong:
+            vlog("Input value: 0x%16.16llx ",
+                 ((unsigned long long *)gIn)[index]);
+            break;
+        case kdouble: vlog("Input value: %a ", ((double *)gIn)[index]); break;
+        default:
+            vlog_error("Internal error at %s: %d\n", __FILE__, __LINE__);
+            abort();
+            break;
+    }
+}
+
+} // anonymous namespace
+
+template <typename InType, typename OutType, bool InFP, bool OutFP>
+void ConversionsTest::DoTests(Type outType, Type inType,
+                              std::vector<ConversionMode> &modes)
+{
+    typedef ConversionModeRun<InType, OutType, InFP, OutFP> Run;
 #ifdef __APPLE__
     cl_ulong wall_start = mach_absolute_time();
 #endif
 
     cl_uint threads = GetThreadCount();
 
-    DataInitInfo info = { 0, 0, outType, inType, sat, round, threads };
-    DataInfoSpec<InType, OutType, InFP, OutFP> init_info(info);
-    WriteInputBufferInfo writeInputBufferInfo;
     int vectorSize;
     int error = 0;
     uint64_t i;
 
-    gTestCount++;
     size_t blockCount =
         BUFFER_SIZE / std::max(gTypeSizes[inType], gTypeSizes[outType]);
     size_t step = blockCount;
 
-    for (i = 0; i < threads; i++)
+    // Fail the modes still being tested, as when an error leaves the queue in
+    // no state to go on
+    auto fail_all = [&](std::vector<std::unique_ptr<Run>> &runs, int error) {
+        for (auto &run : runs)
+            if (!run->mode.error) run->mode.error = error;
+        gFailCount++;
+    };
+
+    std::vector<std::unique_ptr<Run>> runs;
+    for (ConversionMode &mode : modes)
     {
-        init_info.mdv.emplace_back(MTdataHolder(gRandomSeed));
-    }
+        gTestCount++;
+        gMinVectorSize = mode.minVectorSize;
 
-    writeInputBufferInfo.outType = outType;
-    writeInputBufferInfo.inType = inType;
+        DataInitInfo info = { 0, 0, outType, inType, mode.sat, mode.round,
+                              threads };
+        std::unique_ptr<Run> run(new Run(mode, info));
+        WriteInputBufferInfo &writeInputBufferInfo = run->writeInputBufferInfo;
+        writeInputBufferInfo.outType = outType;
+        writeInputBufferInfo.inType = inType;
 
-    writeInputBufferInfo.calcInfo.resize(gMaxVectorSize);
-    for (vectorSize = gMinVectorSize; vectorSize < gMaxVectorSize; vectorSize++)
-    {
-        writeInputBufferInfo.calcInfo[vectorSize].reset(
-            new CalcRefValsPat<InType, OutType, InFP, OutFP>());
-        writeInputBufferInfo.calcInfo[vectorSize]->program =
-            conv_test::MakeProgram(
-                outType, inType, sat, round, vectorSize,
-                &writeInputBufferInfo.calcInfo[vectorSize]->kernel);
-        if (NULL == writeInputBufferInfo.calcInfo[vectorSize]->program)
+        writeInputBufferInfo.calcInfo.resize(gMaxVectorSize);
+        for (vectorSize = gMinVectorSize; vectorSize < gMaxVectorSize;
+             vectorSize++)
         {
-            gFailCount++;
-            return -1;
+            writeInputBufferInfo.calcInfo[vectorSize].reset(
+                new CalcRefValsPat<InType, OutType, InFP, OutFP>());
+            writeInputBufferInfo.calcInfo[vectorSize]->program =
+                conv_test::MakeProgram(
+                    outType, inType, mode.sat, mode.round, vectorSize,
+                    &writeInputBufferInfo.calcInfo[vectorSize]->kernel);
+            if (NULL == writeInputBufferInfo.calcInfo[vectorSize]->program)
+            {
+                gFailCount++;
+                mode.error = -1;
+                break;
+            }
+            if (NULL == writeInputBufferInfo.calcInfo[vectorSize]->kernel)
+            {
+                gFailCount++;
+                vlog_error("\t\tFAILED -- Failed to create kernel.\n");
+                mode.error = -2;
+                break;
+            }
+
+            writeInputBufferInfo.calcInfo[vectorSize]->parent =
+                &writeInputBufferInfo;
+            writeInputBufferInfo.calcInfo[vectorSize]->vectorSize = vectorSize;
+            writeInputBufferInfo.calcInfo[vectorSize]->result = -1;
         }
-        if (NULL == writeInputBufferInfo.calcInfo[vectorSize]->kernel)
+        if (mode.error) continue;
+
+        // Patch up rounding mode if default is RTZ
+        // We leave the part above in default rounding mode so that the right
+        // kernel is compiled.
+        if (std::is_same<OutType, cl_float>::value)
         {
-            gFailCount++;
-            vlog_error("\t\tFAILED -- Failed to create kernel.\n");
-            return -2;
+            if (run->round == kDefaultRoundingMode && gIsRTZ)
+                run->init_info.round = run->round = kRoundTowardZero;
         }
-
-        writeInputBufferInfo.calcInfo[vectorSize]->parent =
-            &writeInputBufferInfo;
-        writeInputBufferInfo.calcInfo[vectorSize]->vectorSize = vectorSize;
-        writeInputBufferInfo.calcInfo[vectorSize]->result = -1;
+        else if (std::is_same<OutType, cl_half>::value && OutFP)
+        {
+            if (run->round == kDefaultRoundingMode && gIsHalfRTZ)
+                run->init_info.round = run->round = kRoundTowardZero;
+        }
+        runs.push_back(std::move(run));
     }
 
-    if (gSkipTesting) return error;
-
-    // Patch up rounding mode if default is RTZ
-    // We leave the part above in default rounding mode so that the right kernel
-    // is compiled.
-    if (std::is_same<OutType, cl_float>::value)
-    {
-        if (round == kDefaultRoundingMode && gIsRTZ)
-            init_info.round = round = kRoundTowardZero;
-    }
-    else if (std::is_same<OutType, cl_half>::value && OutFP)
-    {
-        if (round == kDefaultRoundingMode && gIsHalfRTZ)
-            init_info.round = round = kRoundTowardZero;
-    }
+    if (gSkipTesting || runs.empty()) return;
 
     // Figure out how many elements are in a work block
     // we handle 64-bit types a bit differently.
@@ -708,6 +823,19 @@ int ConversionsTest::DoTest(Type outType, Type inType, SaturationMode sat,
         step = blockCount * EMBEDDED_REDUCTION_FACTOR;
 
     if (gWimpyMode) step = (size_t)blockCount * (size_t)gWimpyReductionFactor;
+
+    // Each block is a checkpoint job of each mode
+    for (auto &run : runs)
+    {
+        std::string checkpointName = std::string("conversions_")
+            + gTypeNames[outType] + "_" + gTypeNames[inType]
+            + gSaturationNames[run->mode.sat] + gRoundingModeNames[run->round]
+            + "_v" + std::to_string(run->mode.minVectorSize) + "-"
+            + std::to_string(gMaxVectorSize);
+        run->checkpoint = JobCheckpoint::Open(
+            checkpointName, (cl_uint)((lastCase + step - 1) / step));
+    }
+
     vlog("Testing... ");
     fflush(stdout);
     for (i = 0; i < (uint64_t)lastCase; i += step)
@@ -719,250 +847,276 @@ int ConversionsTest::DoTest(Type outType, Type inType, SaturationMode sat,
             fflush(stdout);
         }
 
-        cl_uint count = (uint32_t)std::min((uint64_t)blockCount, lastCase - i);
-        writeInputBufferInfo.count = count;
-
-        // Crate a user event to represent the status of the reference value
-        // computation completion
-        writeInputBufferInfo.calcReferenceValues =
-            clCreateUserEvent(gContext, &error);
-        if (error || NULL == writeInputBufferInfo.calcReferenceValues)
-        {
-            vlog_error("ERROR: Unable to create user event. (%d)\n", error);
-            gFailCount++;
-            return error;
-        }
-
-        // retain for consumption by MapOutputBufferComplete
-        for (vectorSize = gMinVectorSize; vectorSize < gMaxVectorSize;
-             vectorSize++)
-        {
-            if ((error =
-                     clRetainEvent(writeInputBufferInfo.calcReferenceValues)))
-            {
-                vlog_error("ERROR: Unable to retain user event. (%d)\n", error);
-                gFailCount++;
-                return error;
-            }
-        }
-
-        // Crate a user event to represent when the callbacks are done verifying
-        // correctness
-        writeInputBufferInfo.doneBarrier = clCreateUserEvent(gContext, &error);
-        if (error || NULL == writeInputBufferInfo.doneBarrier)
-        {
-            vlog_error("ERROR: Unable to create user event for barrier. (%d)\n",
-                       error);
-            gFailCount++;
-            return error;
-        }
+        cl_uint block = (cl_uint)(i / step);
+        std::vector<Run *> active;
+        for (auto &run : runs)
+            if (!run->mode.error
+                && !(run->checkpoint && run->checkpoint->IsDone(block)))
+                active.push_back(run.get());
+        if (active.empty()) continue;
 
-        // retain for use by the callback that calls this
-        if ((error = clRetainEvent(writeInputBufferInfo.doneBarrier)))
-        {
-            vlog_error("ERROR: Unable to retain user event doneBarrier. (%d)\n",
-                       error);
-            gFailCount++;
-            return error;
-        }
+        cl_uint count = (uint32_t)std::min((uint64_t)blockCount, lastCase - i);
 
         //      Call this in a multithreaded manner
         cl_uint chunks = RoundUpToNextPowerOfTwo(threads) * 2;
-        init_info.start = i;
-        init_info.size = count / chunks;
-        if (init_info.size < 16384)
+        cl_uint chunkSize = count / chunks;
+        if (chunkSize < 16384)
         {
             chunks = RoundUpToNextPowerOfTwo(threads);
-            init_info.size = count / chunks;
-            if (init_info.size < 16384)
+            chunkSize = count / chunks;
+            if (chunkSize < 16384)
             {
-                init_info.size = count;
+                chunkSize = count;
                 chunks = 1;
             }
         }
+        for (Run *run : active)
+        {
+            run->init_info.start = i;
+            run->init_info.size = chunkSize;
+        }
 
-        ThreadPool_Do(conv_test::InitData, chunks, &init_info);
+        // The modes share the input, written to the device once per block
+        ThreadPool_Do(conv_test::InitData, chunks, &active[0]->init_info);
 
         // Copy the results to the device
-        if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer, CL_TRUE, 0,
+        if ((error = enqueue_write_staged(gQueue, gInBuffer, CL_TRUE, 0,
                                           count * gTypeSizes[inType], gIn, 0,
                                           NULL, NULL)))
         {
             vlog_error("ERROR: clEnqueueWriteBuffer failed. (%d)\n", error);
-            gFailCount++;
-            return error;
+            fail_all(runs, error);
+            return;
         }
 
-        // Call completion callback for the write, which will enqueue the rest
-        // of the work.
-        conv_test::WriteInputBufferComplete((void *)&writeInputBufferInfo);
-
-        // Make sure the work is actually running, so we don't deadlock
-        if ((error = clFlush(gQueue)))
+        // The reference of the last mode is still in gRef while the cache is
+        // hot, and the next mode can check against it if it would compute the
+        // same
+        bool haveReference = false;
+        RoundingMode referenceRound = kDefaultRoundingMode;
+        for (Run *run : active)
         {
-            vlog_error("clFlush failed with error %d\n", error);
-            gFailCount++;
-            return error;
-        }
+            WriteInputBufferInfo &writeInputBufferInfo =
+                run->writeInputBufferInfo;
+            gMinVectorSize = run->mode.minVectorSize;
+            writeInputBufferInfo.count = count;
+
+            // Crate a user event to represent the status of the reference
+            // value computation completion
+            writeInputBufferInfo.calcReferenceValues =
+                clCreateUserEvent(gContext, &error);
+            if (error || NULL == writeInputBufferInfo.calcReferenceValues)
+            {
+                vlog_error("ERROR: Unable to create user event. (%d)\n", error);
+                fail_all(runs, error);
+                return;
+            }
 
-        ThreadPool_Do(conv_test::PrepareReference, chunks, &init_info);
+            // retain for consumption by MapOutputBufferComplete
+            for (vectorSize = gMinVectorSize; vectorSize < gMaxVectorSize;
+                 vectorSize++)
+            {
+                if ((error = clRetainEvent(
+                         writeInputBufferInfo.calcReferenceValues)))
+                {
+                    vlog_error("ERROR: Unable to retain user event. (%d)\n",
+                               error);
+                    fail_all(runs, error);
+                    return;
+                }
+            }
 
-        // signal we are done calculating the reference results
-        if ((error = clSetUserEventStatus(
-                 writeInputBufferInfo.calcReferenceValues, CL_COMPLETE)))
-        {
-            vlog_error(
-                "Error:  Failed to set user event status to CL_COMPLETE:  %d\n",
-                error);
-            gFailCount++;
-            return error;
-        }
+            // Crate a user event to represent when the callbacks are done
+            // verifying correctness
+            writeInputBufferInfo.doneBarrier =
+                clCreateUserEvent(gContext, &error);
+            if (error || NULL == writeInputBufferInfo.doneBarrier)
+            {
+                vlog_error(
+                    "ERROR: Unable to create user event for barrier. (%d)\n",
+                    error);
+                fail_all(runs, error);
+                return;
+            }
 
-        // Wait for the event callbacks to finish verifying correctness.
-        if ((error = clWaitForEvents(
-                 1, (cl_event *)&writeInputBufferInfo.doneBarrier)))
-        {
-            vlog_error("Error:  Failed to wait for barrier:  %d\n", error);
-            gFailCount++;
-            return error;
-        }
+            // retain for use by the callback that calls this
+            if ((error = clRetainEvent(writeInputBufferInfo.doneBarrier)))
+            {
+                vlog_error(
+                    "ERROR: Unable to retain user event doneBarrier. (%d)\n",
+                    error);
+                fail_all(runs, error);
+                return;
+            }
 
-        if ((error = clReleaseEvent(writeInputBufferInfo.calcReferenceValues)))
-        {
-            vlog_error("Error:  Failed to release calcReferenceValues:  %d\n",
-                       error);
-            gFailCount++;
-            return error;
-        }
+            // Call completion callback for the write, which will enqueue the
+            // rest of the work.
+            conv_test::WriteInputBufferComplete((void *)&writeInputBufferInfo);
 
-        if ((error = clReleaseEvent(writeInputBufferInfo.doneBarrier)))
-        {
-            vlog_error("Error:  Failed to release done barrier:  %d\n", error);
-            gFailCount++;
-            return error;
-        }
+            // Make sure the work is actually running, so we don't deadlock
+            if ((error = clFlush(gQueue)))
+            {
+                vlog_error("clFlush failed with error %d\n", error);
+                fail_all(runs, error);
+                return;
+            }
 
-        for (vectorSize = gMinVectorSize; vectorSize < gMaxVectorSize;
-             vectorSize++)
-        {
-            if ((error = writeInputBufferInfo.calcInfo[vectorSize]->result))
+            if (!haveReference
+                || (DataInfoSpec<InType, OutType, InFP,
+                                 OutFP>::reference_depends_on_round()
+                    && run->round != referenceRound))
             {
-                switch (inType)
-                {
-                    case kuchar:
-                    case kchar:
-                        vlog("Input value: 0x%2.2x ",
-                             ((unsigned char *)gIn)[error - 1]);
-                        break;
-                    case kushort:
-                    case kshort:
-                        vlog("Input value: 0x%4.4x ",
-                             ((unsigned short *)gIn)[error - 1]);
-                        break;
-                    case kuint:
-                    case kint:
-                        vlog("Input value: 0x%8.8x ",
-                             ((unsigned int *)gIn)[error - 1]);
-                        break;
-                    case khalf:
-                        vlog("Input value: %a ",
-                             HTF(((cl_half *)gIn)[error - 1]));
-                        break;
-                    case kfloat:
-                        vlog("Input value: %a ", ((float *)gIn)[error - 1]);
-                        break;
-                    case kulong:
-                    case klong:
-                        vlog("Input value: 0x%16.16llx ",
-                             ((unsigned long long *)gIn)[error - 1]);
-                        break;
-                    case kdouble:
-                        vlog("Input value: %a ", ((double *)gIn)[error - 1]);
-                        break;
-                    default:
-                        vlog_error("Internal error at %s: %d\n", __FILE__,
-                                   __LINE__);
-                        abort();
-                        break;
-                }
+                ThreadPool_Do(conv_test::PrepareReference, chunks,
+                              &run->init_info);
+                haveReference = true;
+                referenceRound = run->round;
+            }
 
-                // tell the user which conversion it was.
-                if (0 == vectorSize)
-                    vlog(" (implicit scalar conversion from %s to %s)\n",
-                         gTypeNames[inType], gTypeNames[outType]);
-                else
-                    vlog(" (convert_%s%s%s%s( %s%s ))\n", gTypeNames[outType],
-                         sizeNames[vectorSize], gSaturationNames[sat],
-                         gRoundingModeNames[round], gTypeNames[inType],
-                         sizeNames[vectorSize]);
+            // signal we are done calculating the reference results
+            if ((error = clSetUserEventStatus(
+                     writeInputBufferInfo.calcReferenceValues, CL_COMPLETE)))
+            {
+                vlog_error("Error:  Failed to set user event status to "
+                           "CL_COMPLETE:  %d\n",
+                           error);
+                fail_all(runs, error);
+                return;
+            }
 
-                gFailCount++;
-                return error;
+            // Wait for the event callbacks to finish verifying correctness.
+            if ((error = clWaitForEvents(
+                     1, (cl_event *)&writeInputBufferInfo.doneBarrier)))
+            {
+                vlog_error("Error:  Failed to wait for barrier:  %d\n", error);
+                fail_all(runs, error);
+                return;
+            }
+
+            if ((error =
+                     clReleaseEvent(writeInputBufferInfo.calcReferenceValues)))
+            {
+                vlog_error(
+                    "Error:  Failed to release calcReferenceValues:  %d\n",
+                    error);
+                fail_all(runs, error);
+                return;
+            }
+
+            if ((error = clReleaseEvent(writeInputBufferInfo.doneBarrier)))
+            {
+                vlog_error("Error:  Failed to release done barrier:  %d\n",
+                           error);
+                fail_all(runs, error);
+                return;
+            }
+
+            for (vectorSize = gMinVectorSize; vectorSize < gMaxVectorSize;
+                 vectorSize++)
+            {
+                if ((error = writeInputBufferInfo.calcInfo[vectorSize]->result))
+                {
+                    log_failing_input(inType, error - 1);
+
+                    // tell the user which conversion it was.
+                    if (0 == vectorSize)
+                        vlog(" (implicit scalar conversion from %s to %s)\n",
+                             gTypeNames[inType], gTypeNames[outType]);
+                    else
+                        vlog(" (convert_%s%s%s%s( %s%s ))\n",
+                             gTypeNames[outType], sizeNames[vectorSize],
+                             gSaturationNames[run->mode.sat],
+                             gRoundingModeNames[run->round],
+                             gTypeNames[inType], sizeNames[vectorSize]);
+
+                    gFailCount++;
+                    run->mode.error = error;
+                    break;
+                }
             }
+
+            if (!run->mode.error && run->checkpoint)
+                run->checkpoint->MarkDone(block);
         }
     }
 
     log_info("done.\n");
 
-    if (gTimeResults)
+    for (auto &run : runs)
     {
-        // Kick off tests for the various vector lengths
-        for (vectorSize = gMinVectorSize; vectorSize < gMaxVectorSize;
-             vectorSize++)
+        if (run->mode.error) continue;
+        gMinVectorSize = run->mode.minVectorSize;
+
+        if (gTimeResults)
         {
-            size_t workItemCount = blockCount / vectorSizes[vectorSize];
-            if (vectorSizes[vectorSize] * gTypeSizes[outType] < 4)
-                workItemCount /=
-                    4 / (vectorSizes[vectorSize] * gTypeSizes[outType]);
-
-            double sum = 0.0;
-            double bestTime = INFINITY;
-            cl_uint k;
-            for (k = 0; k < PERF_LOOP_COUNT; k++)
+            // Kick off tests for the various vector lengths
+            for (vectorSize = gMinVectorSize; vectorSize < gMaxVectorSize;
+                 vectorSize++)
             {
-                uint64_t startTime = conv_test::GetTime();
-                if ((error = conv_test::RunKernel(
-                         writeInputBufferInfo.calcInfo[vectorSize]->kernel,
-                         gInBuffer, gOutBuffers[vectorSize], workItemCount)))
+                size_t workItemCount = blockCount / vectorSizes[vectorSize];
+                if (vectorSizes[vectorSize] * gTypeSizes[outType] < 4)
+                    workItemCount /=
+                        4 / (vectorSizes[vectorSize] * gTypeSizes[outType]);
+
+                double sum = 0.0;
+                double bestTime = INFINITY;
+                cl_uint k;
+                for (k = 0; k < PERF_LOOP_COUNT; k++)
                 {
-                    gFailCount++;
-                    return error;
-                }
+                    uint64_t startTime = conv_test::GetTime();
+                    if ((error = conv_test::RunKernel(
+                             run->writeInputBufferInfo.calcInfo[vectorSize]
+                                 ->kernel,
+                             gInBuffer, gOutBuffers[vectorSize],
+                             workItemCount)))
+                    {
+                        gFailCount++;
+                        run->mode.error = error;
+                        break;
+                    }
 
-                // Make sure OpenCL is done
-                if ((error = clFinish(gQueue)))
-                {
-                    vlog_error("Error %d at clFinish\n", error);
-                    return error;
+                    // Make sure OpenCL is done
+                    if ((error = clFinish(gQueue)))
+                    {
+                        vlog_error("Error %d at clFinish\n", error);
+                        run->mode.error = error;
+                        break;
+                    }
+
+                    uint64_t endTime = conv_test::GetTime();
+                    double time = SubtractTime(endTime, startTime);
+                    sum += time;
+                    if (time < bestTime) bestTime = time;
                 }
+                if (run->mode.error) break;
 
-                uint64_t endTime = conv_test::GetTime();
-                double time = SubtractTime(endTime, startTime);
-                sum += time;
-                if (time < bestTime) bestTime = time;
+                if (gReportAverageTimes) bestTime = sum / PERF_LOOP_COUNT;
+                double clocksPerOp = bestTime * (double)gDeviceFrequency
+                    * gComputeDevices * gSimdSize * 1e6
+                    / (workItemCount * vectorSizes[vectorSize]);
+                if (0 == vectorSize)
+                    vlog_perf(clocksPerOp, LOWER_IS_BETTER, "clocks / element",
+                              "implicit convert %s -> %s", gTypeNames[inType],
+                              gTypeNames[outType]);
+                else
+                    vlog_perf(clocksPerOp, LOWER_IS_BETTER, "clocks / element",
+                              "convert_%s%s%s%s( %s%s )", gTypeNames[outType],
+                              sizeNames[vectorSize],
+                              gSaturationNames[run->mode.sat],
+                              gRoundingModeNames[run->round],
+                              gTypeNames[inType], sizeNames[vectorSize]);
             }
-
-            if (gReportAverageTimes) bestTime = sum / PERF_LOOP_COUNT;
-            double clocksPerOp = bestTime * (double)gDeviceFrequency
-                * gComputeDevices * gSimdSize * 1e6
-                / (workItemCount * vectorSizes[vectorSize]);
-            if (0 == vectorSize)
-                vlog_perf(clocksPerOp, LOWER_IS_BETTER, "clocks / element",
-                          "implicit convert %s -> %s", gTypeNames[inType],
-                          gTypeNames[outType]);
-            else
-                vlog_perf(clocksPerOp, LOWER_IS_BETTER, "clocks / element",
-                          "convert_%s%s%s%s( %s%s )", gTypeNames[outType],
-                          sizeNames[vectorSize], gSaturationNames[sat],
-                          gRoundingModeNames[round], gTypeNames[inType],
-                          sizeNames[vectorSize]);
+            if (run->mode.error) continue;
         }
-    }
 
-    if (gWimpyMode)
-        vlog("\tWimp pass");
-    else
-        vlog("\tpassed");
+        if (gWimpyMode)
+            vlog("\tconvert_%sn%s%s( %sn ) Wimp pass\n", gTypeNames[outType],
+                 gSaturationNames[run->mode.sat],
+                 gRoundingModeNames[run->round], gTypeNames[inType]);
+        else
+            vlog("\tconvert_%sn%s%s( %sn ) passed\n", gTypeNames[outType],
+                 gSaturationNames[run->mode.sat],
+                 gRoundingModeNames[run->round], gTypeNames[inType]);
+    }
 
 #ifdef __APPLE__
     // record the run time
@@ -970,8 +1124,6 @@ int ConversionsTest::DoTest(Type outType, Type inType, SaturationMode sat,
 #endif
     vlog("\n\n");
     fflush(stdout);
-
-    return error;
 }
 
 #if !defined(__APPLE__)
@@ -1005,23 +1157,30 @@ double SubtractTime(uint64_t endTime, uint64_t startTime)
 }
 #endif
 
-void MapResultValuesComplete(const std::unique_ptr<CalcRefValsBase> &ptr);
+void CL_CALLBACK MapResultValuesComplete(cl_event e, cl_int status,
+                                         void *data);
 
 void CL_CALLBACK CalcReferenceValuesComplete(cl_event e, cl_int status,
                                              void *data);
 
 // Note: May be called reentrantly
-void MapResultValuesComplete(const std::unique_ptr<CalcRefValsBase> &info)
+void CL_CALLBACK MapResultValuesComplete(cl_event e, cl_int status, void *data)
 {
-    cl_int status;
-    // CalcRefValsBase *info = (CalcRefValsBase *)data;
+    std::unique_ptr<CalcRefValsBase> &info =
+        *(std::unique_ptr<CalcRefValsBase> *)data;
     cl_event calcReferenceValues = info->parent->calcReferenceValues;
 
+    if (CL_SUCCESS != status)
+    {
+        vlog_error("ERROR: Mapping the results did not succeed! (%d)\n",
+                   status);
+        gFailCount++; // not thread safe -- being lazy here
+    }
+
     // we know that the map is done, wait for the main thread to finish
     // calculating the reference values
-    if ((status =
-             clSetEventCallback(calcReferenceValues, CL_COMPLETE,
-                                CalcReferenceValuesComplete, (void *)&info)))
+    if ((status = clSetEventCallback(calcReferenceValues, CL_COMPLETE,
+                                     CalcReferenceValuesComplete, data)))
     {
         vlog_error("ERROR: clSetEventCallback failed in "
                    "MapResultValuesComplete with status: %d\n",
@@ -1064,9 +1223,10 @@ template <typename T> static bool isnan_fp(const T &v)
 }
 
 template <typename InType>
-void ZeroNanToIntCases(cl_uint count, void *mapped, Type outType)
+void ZeroNanToIntCases(cl_uint count, const void *in, void *mapped,
+                       Type outType)
 {
-    InType *inp = (InType *)gIn;
+    const InType *inp = (const InType *)in;
     for (auto j = 0; j < count; j++)
     {
         if (isnan_fp<InType>(inp[j]))
@@ -1076,7 +1236,7 @@ void ZeroNanToIntCases(cl_uint count, void *mapped, Type outType)
 }
 
 template <typename InType, typename OutType>
-void FixNanToFltConversions(InType *inp, OutType *outp, cl_uint count)
+void FixNanToFltConversions(const InType *inp, OutType *outp, cl_uint count)
 {
     if (std::is_same<OutType, cl_half>::value)
     {
@@ -1091,16 +1251,17 @@ void FixNanToFltConversions(InType *inp, OutType *outp, cl_uint count)
     }
 }
 
-void FixNanConversions(Type outType, Type inType, void *d, cl_uint count)
+void FixNanConversions(Type outType, Type inType, const void *s, void *d,
+                       cl_uint count)
 {
     if (outType != kfloat && outType != kdouble && outType != khalf)
     {
         if (inType == kfloat)
-            ZeroNanToIntCases<float>(count, d, outType);
+            ZeroNanToIntCases<float>(count, s, d, outType);
         else if (inType == kdouble)
-            ZeroNanToIntCases<double>(count, d, outType);
+            ZeroNanToIntCases<double>(count, s, d, outType);
         else if (inType == khalf)
-            ZeroNanToIntCases<cl_half>(count, d, outType);
+            ZeroNanToIntCases<cl_half>(count, s, d, outType);
     }
     else if (inType == kfloat || inType == kdouble || inType == khalf)
     {
@@ -1108,7 +1269,7 @@ void FixNanConversions(Type outType, Type inType, void *d, cl_uint count)
         // float/double/half could be any NaN
         if (inType == kfloat)
         {
-            float *inp = (float *)gIn;
+            const float *inp = (const float *)s;
             if (outType == kdouble)
             {
                 double *outp = (double *)d;
@@ -1122,7 +1283,7 @@ void FixNanConversions(Type outType, Type inType, void *d, cl_uint count)
         }
         else if (inType == kdouble)
         {
-            double *inp = (double *)gIn;
+            const double *inp = (const double *)s;
             if (outType == kfloat)
             {
                 float *outp = (float *)d;
@@ -1136,7 +1297,7 @@ void FixNanConversions(Type outType, Type inType, void *d, cl_uint count)
         }
         else if (inType == khalf)
         {
-            cl_half *inp = (cl_half *)gIn;
+            const cl_half *inp = (const cl_half *)s;
             if (outType == kfloat)
             {
                 float *outp = (float *)d;
@@ -1152,6 +1313,48 @@ void FixNanConversions(Type outType, Type inType, void *d, cl_uint count)
 }
 
 
+namespace {
+
+const cl_uint kCheckResultsChunk = 65536;
+
+struct CheckResultsInfo
+{
+    Type outType;
+    Type inType;
+    void *mapped;
+    cl_uint count;
+    cl_uint chunkSize;
+    std::atomic<cl_uint> firstMismatch; // start of first differing chunk
+};
+
+cl_int CheckResultsChunk(cl_uint job_id, cl_uint thread_id, void *p)
+{
+    CheckResultsInfo *info = (CheckResultsInfo *)p;
+    cl_uint start = job_id * info->chunkSize;
+    cl_uint count = std::min(info->chunkSize, info->count - start);
+    size_t inSize = gTypeSizes[info->inType];
+    size_t outSize = gTypeSizes[info->outType];
+    char *mapped = (char *)info->mapped + start * outSize;
+
+    // Patch up NaNs conversions to integer to zero -- these can be converted to
+    // any integer
+    FixNanConversions(info->outType, info->inType,
+                      (const char *)gIn + start * inSize, mapped, count);
+
+    if (memcmp(mapped, (const char *)gRef + start * outSize, count * outSize))
+    {
+        cl_uint first = info->firstMismatch.load();
+        while (start < first
+               && !info->firstMismatch.compare_exchange_weak(first, start))
+        {
+        }
+    }
+
+    return CL_SUCCESS;
+}
+
+} // anonymous namespace
+
 void CL_CALLBACK CalcReferenceValuesComplete(cl_event e, cl_int status,
                                              void *data)
 {
@@ -1182,13 +1385,27 @@ void CL_CALLBACK CalcReferenceValuesComplete(cl_event e, cl_int status,
     // verify results
     void *mapped = info->p;
 
-    // Patch up NaNs conversions to integer to zero -- these can be converted to
-    // any integer
-    FixNanConversions(outType, inType, mapped, count);
+    // Patch up NaNs and compare against the reference on the thread pool,
+    // then look for the first real error serially from the first chunk that
+    // differs, so the same error is reported as by a serial check.
+    CheckResultsInfo check;
+    check.outType = outType;
+    check.inType = inType;
+    check.mapped = mapped;
+    check.count = count;
+    check.chunkSize = kCheckResultsChunk;
+    check.firstMismatch = count;
+    cl_uint jobs = (count + kCheckResultsChunk - 1) / kCheckResultsChunk;
+    if (jobs < 2 || GetThreadCount() < 2
+        || CL_SUCCESS != ThreadPool_Do(CheckResultsChunk, jobs, &check))
+    {
+        for (cl_uint job = 0; job < jobs; job++)
+            CheckResultsChunk(job, 0, &check);
+    }
 
-    if (memcmp(mapped, gRef, count * gTypeSizes[outType]))
-        info->result =
-            info->check_result(mapped, count, vectorSizes[vectorSize]);
+    if (check.firstMismatch < count)
+        info->result = info->check_result(mapped, check.firstMismatch, count,
+                                          vectorSizes[vectorSize]);
     else
         info->result = 0;
 
@@ -1206,7 +1423,7 @@ void CL_CALLBACK CalcReferenceValuesComplete(cl_event e, cl_int status,
         }
     }
 
-    if (1 == ThreadPool_AtomicAdd(&info->parent->barrierCount, -1))
+    if (1 == info->parent->barrierCount.add(-1))
     {
         if ((status = clSetUserEventStatus(doneBarrier, CL_COMPLETE)))
         {
@@ -1346,7 +1563,7 @@ cl_int PrepareReference(cl_uint job_id, cl_uint thread_id, void *p)
 
     // Patch up NaNs conversions to integer to zero -- these can be converted to
     // any integer
-    FixNanConversions(outType, inType, d, count);
+    FixNanConversions(outType, inType, s, d, count);
 
     return CL_SUCCESS;
 }
@@ -1373,10 +1590,10 @@ void WriteInputBufferComplete(void *data)
     cl_uint count = info->count;
     int vectorSize;
 
-    info->barrierCount = gMaxVectorSize - gMinVectorSize;
+    info->barrierCount.reset(gMaxVectorSize - gMinVectorSize);
 
-    // now that we know that the write buffer is complete, enqueue callbacks to
-    // wait for the main thread to finish calculating the reference results.
+    // Queue the kernels for every vector size back to back so the device
+    // doesn't wait on the host between them.
     for (vectorSize = gMinVectorSize; vectorSize < gMaxVectorSize; vectorSize++)
     {
         size_t workItemCount =
@@ -1389,26 +1606,39 @@ void WriteInputBufferComplete(void *data)
             gFailCount++;
             return;
         }
+    }
 
+    // Then map the results without blocking. As each map completes, its
+    // callback waits for the main thread to finish calculating the reference
+    // results and checks that vector size.
+    for (vectorSize = gMinVectorSize; vectorSize < gMaxVectorSize; vectorSize++)
+    {
+        cl_event mapEvent = NULL;
         info->calcInfo[vectorSize]->p = clEnqueueMapBuffer(
-            gQueue, gOutBuffers[vectorSize], CL_TRUE,
+            gQueue, gOutBuffers[vectorSize], CL_FALSE,
             CL_MAP_READ | CL_MAP_WRITE, 0, count * gTypeSizes[info->outType], 0,
-            NULL, NULL, &status);
+            NULL, &mapEvent, &status);
+        if (status)
         {
-            if (status)
-            {
-                vlog_error("ERROR: WriteInputBufferComplete calback failed "
-                           "with status: %d\n",
-                           status);
-                gFailCount++;
-                return;
-            }
+            vlog_error("ERROR: WriteInputBufferComplete calback failed "
+                       "with status: %d\n",
+                       status);
+            gFailCount++;
+            return;
         }
-    }
 
-    for (vectorSize = gMinVectorSize; vectorSize < gMaxVectorSize; vectorSize++)
-    {
-        MapResultValuesComplete(info->calcInfo[vectorSize]);
+        status = clSetEventCallback(mapEvent, CL_COMPLETE,
+                                    MapResultValuesComplete,
+                                    &info->calcInfo[vectorSize]);
+        clReleaseEvent(mapEvent);
+        if (status)
+        {
+            vlog_error("ERROR: clSetEventCallback failed in "
+                       "WriteInputBufferComplete with status: %d\n",
+                       status);
+            gFailCount++;
+            return;
+        }
     }
 
     // Make sure the work starts moving -- otherwise we may deadlock
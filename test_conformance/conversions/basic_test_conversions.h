@@ -22,6 +22,7 @@
 
 #include "harness/errorHelpers.h"
 #include "harness/rounding_mode.h"
+#include "harness/ThreadPool.h"
 
 #include <stdio.h>
 #if defined( __APPLE__ )
@@ -130,7 +131,8 @@ void UnFlushToZero(void *);
 struct CalcRefValsBase
 {
     virtual ~CalcRefValsBase() = default;
-    virtual int check_result(void *, uint32_t, int) { return 0; }
+    // Returns one plus the index of the first error at or after start
+    virtual int check_result(void *, uint32_t, uint32_t, int) { return 0; }
 
     // pointer back to the parent WriteInputBufferInfo struct
     struct WriteInputBufferInfo *parent;
@@ -144,7 +146,7 @@ struct CalcRefValsBase
 template <typename InType, typename OutType, bool InFP, bool OutFP>
 struct CalcRefValsPat : CalcRefValsBase
 {
-    int check_result(void *, uint32_t, int) override;
+    int check_result(void *, uint32_t, uint32_t, int) override;
 };
 
 struct WriteInputBufferInfo
@@ -162,7 +164,7 @@ struct WriteInputBufferInfo
     cl_uint count; // the number of elements in the array
     Type outType; // the data type of the conversion result
     Type inType; // the data type of the conversion input
-    volatile int barrierCount;
+    AtomicCounter<int> barrierCount;
 
     std::vector<std::unique_ptr<CalcRefValsBase>> calcInfo;
 };
@@ -175,6 +177,17 @@ using TypeIter =
 // hardcoded solution needed due to typeid confusing cl_ushort/cl_half
 constexpr bool isTypeFp[] = { 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0 };
 
+// One (SaturationMode, RoundingMode) variant of a conversion, and how its
+// testing went
+struct ConversionMode
+{
+    SaturationMode sat;
+    RoundingMode round;
+    int testNumber;
+    int minVectorSize;
+    int error;
+};
+
 // Helper test fixture for constructing OpenCL objects used in testing
 // a variety of simple command-buffer enqueue scenarios.
 struct ConversionsTest
@@ -193,6 +206,15 @@ struct ConversionsTest
     int DoTest(Type outType, Type inType, SaturationMode sat,
                RoundingMode round);
 
+    // Test several modes of one saturation mode over the same input blocks,
+    // each block generated and written to the device once for all of them,
+    // sharing the reference where the rounding mode makes no difference to
+    // it. The modes must agree on the input data (see
+    // DataInfoSpec::input_depends_on_round). Sets the error of each mode.
+    template <typename InType, typename OutType, bool InFP, bool OutFP>
+    void DoTests(Type outType, Type inType,
+                 std::vector<ConversionMode> &modes);
+
     template <typename InType, typename OutType, bool InFP, bool OutFP>
     void TestTypesConversion(const Type &inType, const Type &outType, int &tn,
                              int startMinVectorSize);
@@ -112,8 +112,6 @@ struct DataInfoSpec : public DataInitBase
     // matrix of clamping ranges for each rounding type
     std::vector<std::pair<InType, InType>> clamp_ranges;
 
-    std::vector<MTdataHolder> mdv;
-
     constexpr bool is_in_half() const
     {
         return (std::is_same<InType, cl_half>::value && InFP);
@@ -124,16 +122,74 @@ struct DataInfoSpec : public DataInitBase
         return (std::is_same<OutType, cl_half>::value && OutFP);
     }
 
+    // Conversions between integer types and between float and double are
+    // plain casts or clamps, so they get loops over local copies of the
+    // range that the compiler can vectorize.
+    static constexpr bool is_int_to_int()
+    {
+        return std::is_integral<InType>::value && !InFP
+            && std::is_integral<OutType>::value && !OutFP;
+    }
+
+    static constexpr bool is_fp_to_fp()
+    {
+        return std::is_floating_point<InType>::value
+            && std::is_floating_point<OutType>::value;
+    }
+
+    // Whether the input data of the saturation mode differs between the
+    // rounding modes, which it does where it is clamped to the range that
+    // converts without overflow
+    static constexpr bool input_depends_on_round(SaturationMode sat)
+    {
+        return sat == kUnsaturated
+            && (std::is_floating_point<InType>::value
+                || (std::is_same<InType, cl_half>::value && InFP))
+            && std::is_integral<OutType>::value && !OutFP;
+    }
+
+    // Whether the reference differs between the rounding modes. Conversions
+    // between integer types and from float to double are exact.
+    static constexpr bool reference_depends_on_round()
+    {
+        return !is_int_to_int()
+            && !(std::is_same<InType, cl_float>::value
+                 && std::is_same<OutType, cl_double>::value);
+    }
+
+    static OutType sat_int(const InType &in, const OutType &lo,
+                           const OutType &hi);
+
     void conv_array(void *out, void *in, size_t n) override
     {
-        for (size_t i = 0; i < n; i++)
-            conv(&((OutType *)out)[i], &((InType *)in)[i]);
+        OutType *o = (OutType *)out;
+        InType *i = (InType *)in;
+        if (is_int_to_int() || is_fp_to_fp())
+        {
+            for (size_t k = 0; k < n; k++) o[k] = (OutType)i[k];
+            return;
+        }
+
+        for (size_t k = 0; k < n; k++) conv(&o[k], &i[k]);
     }
 
     void conv_array_sat(void *out, void *in, size_t n) override
     {
-        for (size_t i = 0; i < n; i++)
-            conv_sat(&((OutType *)out)[i], &((InType *)in)[i]);
+        OutType *o = (OutType *)out;
+        InType *i = (InType *)in;
+        if (is_int_to_int())
+        {
+            const OutType lo = ranges.first, hi = ranges.second;
+            for (size_t k = 0; k < n; k++) o[k] = sat_int(i[k], lo, hi);
+            return;
+        }
+        if (is_fp_to_fp())
+        {
+            for (size_t k = 0; k < n; k++) o[k] = (OutType)i[k];
+            return;
+        }
+
+        for (size_t k = 0; k < n; k++) conv_sat(&o[k], &i[k]);
     }
 
     void init(const cl_uint &, const cl_uint &) override;
@@ -160,7 +216,7 @@ struct DataInfoSpec : public DataInitBase
 template <typename InType, typename OutType, bool InFP, bool OutFP>
 DataInfoSpec<InType, OutType, InFP, OutFP>::DataInfoSpec(
     const DataInitInfo &agg)
-    : DataInitBase(agg), mdv(0)
+    : DataInitBase(agg)
 {
     if (std::is_same<cl_float, OutType>::value)
         ranges = std::make_pair(CL_FLT_MIN, CL_FLT_MAX);
@@ -595,6 +651,31 @@ void DataInfoSpec<InType, OutType, InFP, OutFP>::conv(OutType *out, InType *in)
 #define CLAMP(_lo, _x, _hi)                                                    \
     ((_x) < (_lo) ? (_lo) : ((_x) > (_hi) ? (_hi) : (_x)))
 
+template <typename InType, typename OutType, bool InFP, bool OutFP>
+OutType DataInfoSpec<InType, OutType, InFP, OutFP>::sat_int(const InType &in,
+                                                            const OutType &lo,
+                                                            const OutType &hi)
+{
+    if ((std::is_signed<InType>::value && std::is_signed<OutType>::value)
+        || (!std::is_signed<InType>::value && !std::is_signed<OutType>::value))
+    {
+        if (sizeof(InType) <= sizeof(OutType))
+            return (OutType)in;
+        else
+            return CLAMP(lo, in, hi);
+    }
+    else
+    { // mixed signed/unsigned types
+        if (sizeof(InType) < sizeof(OutType))
+            return (!std::is_signed<InType>::value)
+                ? (OutType)in
+                : CLAMP(0, in, hi); // in < 0 ? 0 : in
+        else
+            // bigger/equal mixed signed/unsigned types - always clamp
+            return CLAMP(0, in, hi);
+    }
+}
+
 template <typename InType, typename OutType, bool InFP, bool OutFP>
 void DataInfoSpec<InType, OutType, InFP, OutFP>::conv_sat(OutType *out,
                                                           InType *in)
@@ -694,33 +775,7 @@ void DataInfoSpec<InType, OutType, InFP, OutFP>::conv_sat(OutType *out,
         }
         else
         {
-            if ((std::is_signed<InType>::value
-                 && std::is_signed<OutType>::value)
-                || (!std::is_signed<InType>::value
-                    && !std::is_signed<OutType>::value))
-            {
-                if (sizeof(InType) <= sizeof(OutType))
-                {
-                    *out = (OutType)*in;
-                }
-                else
-                {
-                    *out = CLAMP(ranges.first, *in, ranges.second);
-                }
-            }
-            else
-            { // mixed signed/unsigned types
-                if (sizeof(InType) < sizeof(OutType))
-                {
-                    *out = (!std::is_signed<InType>::value)
-                        ? (OutType)*in
-                        : CLAMP(0, *in, ranges.second); // *in < 0 ? 0 : *in
-                }
-                else
-                { // bigger/equal mixed signed/unsigned types - always clamp
-                    *out = CLAMP(0, *in, ranges.second);
-                }
-            }
+            *out = sat_int(*in, ranges.first, ranges.second);
         }
     }
     else
@@ -761,6 +816,12 @@ void DataInfoSpec<InType, OutType, InFP, OutFP>::init(const cl_uint &job_id,
     uint64_t ulStart = start;
     void *pIn = (char *)gIn + job_id * size * gTypeSizes[inType];
 
+    // Each job reads its own part of one stream, at most two words per value,
+    // so the data doesn't depend on the thread count or on which thread runs
+    // which job.
+    MTdataHolder md(init_genrand_counter(
+        gRandomSeed, 2 * (ulStart + (uint64_t)job_id * size)));
+
     if (is_in_half())
     {
         cl_half *o = (cl_half *)pIn;
@@ -768,7 +829,7 @@ void DataInfoSpec<InType, OutType, InFP, OutFP>::init(const cl_uint &job_id,
 
         if (gIsEmbedded)
             for (i = 0; i < size; i++)
-                o[i] = (cl_half)genrand_int32(mdv[thread_id]);
+                o[i] = (cl_half)genrand_int32(md);
         else
             for (i = 0; i < size; i++) o[i] = (cl_half)((i + ulStart) % 0xffff);
 
@@ -799,7 +860,7 @@ void DataInfoSpec<InType, OutType, InFP, OutFP>::init(const cl_uint &job_id,
             int i = 0;
             if (gIsEmbedded)
                 for (i = 0; i < size; i++)
-                    o[i] = (InType)genrand_int32(mdv[thread_id]);
+                    o[i] = (InType)genrand_int32(md);
             else
                 for (i = 0; i < size; i++) o[i] = (InType)i + ulStart;
 
@@ -870,7 +931,6 @@ void DataInfoSpec<InType, OutType, InFP, OutFP>::init(const cl_uint &job_id,
                     }
             }
 
-            auto &md = mdv[thread_id];
             for (; i < (cl_ulong)size; i++)
                 o[i] = (cl_ulong)genrand_int32(md)
                     | ((cl_ulong)genrand_int32(md) << 32);
@@ -883,7 +943,7 @@ void DataInfoSpec<InType, OutType, InFP, OutFP>::init(const cl_uint &job_id,
 
         if (gIsEmbedded)
             for (i = 0; i < size; i++)
-                o[i] = (cl_uint)genrand_int32(mdv[thread_id]);
+                o[i] = (cl_uint)genrand_int32(md);
         else
             for (i = 0; i < size; i++) o[i] = (cl_uint)i + ulStart;
 
@@ -17,6 +17,9 @@
 #include "harness/testHarness.h"
 #include "harness/parseParameters.h"
 #include "harness/mt19937.h"
+#include "harness/deviceInfo.h"
+#include "harness/durationHistory.h"
+#include "harness/stagingPool.h"
 
 #if defined(__APPLE__)
 #include <sys/sysctl.h>
@@ -70,6 +73,7 @@ roundingMode qcom_rm;
 
 static int ParseArgs(int argc, const char **argv);
 static void PrintUsage(void);
+static void ApplyTimeBudget(cl_device_id device);
 test_status InitCL(cl_device_id device);
 
 
@@ -164,6 +168,7 @@ int main(int argc, const char **argv)
     {
         clReleaseMemObject(gOutBuffers[i]);
     }
+    release_staging_buffers(gContext);
     clReleaseCommandQueue(gQueue);
     clReleaseContext(gContext);
 
@@ -552,5 +557,75 @@ test_status InitCL(cl_device_id device)
     for (i = gMinVectorSize; i < gMaxVectorSize; i++)
         vlog("\t%d", vectorSizes[i]);
     vlog("\n");
+
+    ApplyTimeBudget(device);
+
     return TEST_PASS;
 }
+
+// The fraction of each conversion's input tested, going by the step of
+// DoTest
+static double ConversionsCoverage(bool wimpyMode, int reductionFactor)
+{
+    if (wimpyMode) return 1.0 / reductionFactor;
+    if (gIsEmbedded) return 1.0 / EMBEDDED_REDUCTION_FACTOR;
+    return 1.0;
+}
+
+// Record the duration of this run under the options that change how many
+// conversions are tested, and with --time-budget pick the largest coverage
+// that earlier runs say will fit
+static void ApplyTimeBudget(cl_device_id device)
+{
+    std::string mode;
+    if (gTestDouble) mode += "double ";
+    if (gTestHalfs) mode += "half ";
+    if (gSkipTesting) mode += "link ";
+    mode += "vec" + std::to_string(vectorSizes[gMinVectorSize]) + "-"
+        + std::to_string(vectorSizes[gMaxVectorSize - 1]);
+    for (int i = 0; i < argCount; i++) mode += std::string(" ") + argList[i];
+    if (gStartTestNumber != -1)
+        mode += " from " + std::to_string(gStartTestNumber) + " to "
+            + std::to_string(gEndTestNumber);
+
+    if (gTimeBudgetSeconds > 0)
+    {
+        const char *fileName = getenv("CL_CONFORMANCE_DURATION_DB");
+        std::vector<std::string> tests;
+        for (int i = 0; i < test_num; i++) tests.push_back(test_list[i].name);
+
+        DurationHistory history;
+        WimpyChoice choice;
+        std::string deviceName = get_device_name(device);
+        if (fileName == NULL || !history.Load(fileName))
+        {
+            vlog("\nIgnoring --time-budget as CL_CONFORMANCE_DURATION_DB "
+                 "isn't set.\n");
+        }
+        else if (!choose_wimpy_for_budget(history, deviceName, appName, mode,
+                                          tests, gTimeBudgetSeconds,
+                                          ConversionsCoverage, 4096, choice)
+                 && choice.unknownTests == tests.size())
+        {
+            vlog("\nIgnoring --time-budget as the conversions haven't run on "
+                 "this device in this mode before.\n");
+        }
+        else
+        {
+            gWimpyMode = choice.wimpyMode;
+            gWimpyReductionFactor = choice.reductionFactor;
+            vlog("\nTime budget of %.0f s: %s, expected to take %.0f s",
+                 gTimeBudgetSeconds,
+                 gWimpyMode ? "wimpy mode" : "full testing", choice.seconds);
+            if (gWimpyMode)
+                vlog(" with a reduction factor of %d", gWimpyReductionFactor);
+            vlog(".\n");
+            if (choice.seconds > gTimeBudgetSeconds)
+                vlog("*** WARNING: Even the smallest coverage takes longer "
+                     "than the time budget! ***\n");
+        }
+    }
+
+    set_duration_key(appName, mode,
+                     ConversionsCoverage(gWimpyMode, gWimpyReductionFactor));
+}
@@ -15,6 +15,7 @@
 //
 #define INITGUID
 #include "harness.h"
+#include "perfMetrics.h"
 #include <vector>
 
 #include <tchar.h>
@@ -216,8 +217,129 @@ cl_int HarnessD3D10_CreateDevice(IDXGIAdapter* pAdapter, ID3D10Device **ppDevice
     return CL_SUCCESS;
 }
 
+/*
+ * Staging textures
+ */
+
+static std::vector<ID3D10Texture2D*> HarnessD3D10_pStaging2D;
+static std::vector<ID3D10Texture3D*> HarnessD3D10_pStaging3D;
+
+ID3D10Texture2D* HarnessD3D10_GetStagingTexture2D(ID3D10Device* pDevice, const TextureFormat* format)
+{
+    UINT index = (UINT)(format - formats);
+    HarnessD3D10_pStaging2D.resize(formatCount, NULL);
+    if (!HarnessD3D10_pStaging2D[index])
+    {
+        D3D10_TEXTURE2D_DESC desc = {0};
+        desc.Width      = 2;
+        desc.Height     = 2;
+        desc.MipLevels  = 1;
+        desc.ArraySize  = 1;
+        desc.Format     = format->format;
+        desc.SampleDesc.Count = 1;
+        desc.SampleDesc.Quality = 0;
+        desc.Usage = D3D10_USAGE_STAGING;
+        desc.BindFlags = 0;
+        desc.CPUAccessFlags = D3D10_CPU_ACCESS_READ | D3D10_CPU_ACCESS_WRITE;
+        desc.MiscFlags = 0;
+        HRESULT hr = pDevice->CreateTexture2D(&desc, NULL, &HarnessD3D10_pStaging2D[index]);
+        if (FAILED(hr))
+        {
+            HarnessD3D10_pStaging2D[index] = NULL;
+        }
+    }
+    return HarnessD3D10_pStaging2D[index];
+}
+
+ID3D10Texture3D* HarnessD3D10_GetStagingTexture3D(ID3D10Device* pDevice, const TextureFormat* format)
+{
+    UINT index = (UINT)(format - formats);
+    HarnessD3D10_pStaging3D.resize(formatCount, NULL);
+    if (!HarnessD3D10_pStaging3D[index])
+    {
+        D3D10_TEXTURE3D_DESC desc = {0};
+        desc.Width      = 2;
+        desc.Height     = 2;
+        desc.Depth      = 2;
+        desc.MipLevels  = 1;
+        desc.Format     = format->format;
+        desc.Usage = D3D10_USAGE_STAGING;
+        desc.BindFlags = 0;
+        desc.CPUAccessFlags = D3D10_CPU_ACCESS_READ | D3D10_CPU_ACCESS_WRITE;
+        desc.MiscFlags = 0;
+        HRESULT hr = pDevice->CreateTexture3D(&desc, NULL, &HarnessD3D10_pStaging3D[index]);
+        if (FAILED(hr))
+        {
+            HarnessD3D10_pStaging3D[index] = NULL;
+        }
+    }
+    return HarnessD3D10_pStaging3D[index];
+}
+
+static void HarnessD3D10_ReleaseStagingTextures()
+{
+    for (size_t i = 0; i < HarnessD3D10_pStaging2D.size(); ++i)
+    {
+        if (HarnessD3D10_pStaging2D[i]) HarnessD3D10_pStaging2D[i]->Release();
+    }
+    for (size_t i = 0; i < HarnessD3D10_pStaging3D.size(); ++i)
+    {
+        if (HarnessD3D10_pStaging3D[i]) HarnessD3D10_pStaging3D[i]->Release();
+    }
+    HarnessD3D10_pStaging2D.clear();
+    HarnessD3D10_pStaging3D.clear();
+}
+
+int HarnessD3D10_CompareTile(
+    const void* pData,
+    UINT rowPitch,
+    UINT depthPitch,
+    UINT width,
+    UINT height,
+    UINT depth,
+    UINT bytesPerPixel,
+    const void* expected)
+{
+    const char* tile = (const char*)pData;
+    const char* ref = (const char*)expected;
+    UINT rowSize = width * bytesPerPixel;
+
+    // whole rows at a time, texel by texel only to find the one that differs
+    for (UINT z = 0; z < depth; ++z)
+    for (UINT y = 0; y < height; ++y)
+    {
+        const char* row = tile + z * depthPitch + y * rowPitch;
+        const char* refRow = ref + (z * height + y) * rowSize;
+        if (!memcmp(row, refRow, rowSize))
+        {
+            continue;
+        }
+        for (UINT x = 0; x < width; ++x)
+        {
+            if (memcmp(row + x * bytesPerPixel, refRow + x * bytesPerPixel, bytesPerPixel))
+            {
+                return (int)((z * height + y) * width + x);
+            }
+        }
+    }
+    return -1;
+}
+
+double HarnessD3D10_TimeUs()
+{
+    static LARGE_INTEGER frequency = {0};
+    if (!frequency.QuadPart)
+    {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart * 1e6 / (double)frequency.QuadPart;
+}
+
 void HarnessD3D10_DestroyDevice()
 {
+    HarnessD3D10_ReleaseStagingTextures();
     HarnessD3D10_pSwapChain->Release();
     HarnessD3D10_pDevice->Release();
 
@@ -332,6 +454,8 @@ void HarnessD3D10_TestEnd()
 
 void HarnessD3D10_TestStats()
 {
+    save_perf_metrics("d3d10");
+
     TestPrint("PASSED %d of %d tests.\n", HarnessD3D10_testStats.passCount, HarnessD3D10_testStats.testCount);
     if (HarnessD3D10_testStats.testCount > HarnessD3D10_testStats.passCount)
     {
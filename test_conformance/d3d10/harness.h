@@ -145,6 +145,32 @@ void HarnessD3D10_Initialize(cl_platform_id platform);
 cl_int HarnessD3D10_CreateDevice(IDXGIAdapter* pAdapter, ID3D10Device **ppDevice);
 void HarnessD3D10_DestroyDevice();
 
+// Staging textures that move the test patterns in and out of the shared
+// textures, one per format and kept until HarnessD3D10_DestroyDevice. Each is
+// a tile with a texel for every corner of the texture under test: 2x2 for
+// 2D textures and 2x2x2 for 3D textures, the corner at (x, y, z) held in
+// texel (x, y, z).
+ID3D10Texture2D* HarnessD3D10_GetStagingTexture2D(ID3D10Device* pDevice, const TextureFormat* format);
+ID3D10Texture3D* HarnessD3D10_GetStagingTexture3D(ID3D10Device* pDevice, const TextureFormat* format);
+
+// Compares a mapped tile of width by height by depth texels with expected,
+// which holds the same texels packed in x, then y, then z order. Returns the
+// index into expected of the first texel that differs, or -1 if they all
+// match.
+int HarnessD3D10_CompareTile(
+    const void* pData,
+    UINT rowPitch,
+    UINT depthPitch,
+    UINT width,
+    UINT height,
+    UINT depth,
+    UINT bytesPerPixel,
+    const void* expected);
+
+// Host time in microseconds, for the acquire and release timings the texture
+// tests report through log_perf
+double HarnessD3D10_TimeUs();
+
 void HarnessD3D10_TestBegin(const char* fmt, ...);
 void HarnessD3D10_TestFail();
 void HarnessD3D10_TestEnd();
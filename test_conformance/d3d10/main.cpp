@@ -19,6 +19,7 @@
 #include "harness.h"
 #include "harness/testHarness.h"
 #include "harness/parseParameters.h"
+#include "harness/perfMetrics.h"
 
 int main(int argc, const char* argv[])
 {
@@ -263,6 +264,9 @@ void TestDevice(cl_device_id device, ID3D10Device* pDevice)
     TestPrint("Name=%s\n", device_name);
     TestPrint("--------------------\n");
 
+    // the texture tests' acquire and release timings go to this device
+    PerfMetricScope metricScope("d3d10", device);
+
     if (!TestDeviceContextCreate(device, pDevice, &context, &command_queue) )
     {
         return;
@@ -164,7 +164,11 @@ void SubTestTexture2D(
     const Texture2DSize* size)
 {
     ID3D10Texture2D* pTexture = NULL;
+    ID3D10Texture2D* pStagingBuffer = NULL;
     HRESULT hr = S_OK;
+    char expectedTile[4 * 16];
+    double acquireUs = 0.0;
+    double releaseUs = 0.0;
 
     cl_int result = CL_SUCCESS;
 
@@ -222,61 +226,52 @@ void SubTestTexture2D(
         }
     }
 
-    // copy a pattern into the corners of the image, coordinates
+    // write the patterns into the staging tile, the pattern for corner
+    // (x,y) into texel (x,y)
+    pStagingBuffer = HarnessD3D10_GetStagingTexture2D(pDevice, format);
+    TestRequire(pStagingBuffer, "ID3D10Device::CreateTexture2D failed (non-OpenCL D3D error, but test is invalid).");
+    {
+        D3D10_MAPPED_TEXTURE2D mappedTexture;
+        hr = pStagingBuffer->Map(
+            0,
+            D3D10_MAP_READ_WRITE,
+            0,
+            &mappedTexture);
+        TestRequire(SUCCEEDED(hr), "Failed to map staging buffer");
+        for (UINT x = 0; x < 2; ++x)
+        for (UINT y = 0; y < 2; ++y)
+        {
+            memcpy(
+                (char *)mappedTexture.pData + y * mappedTexture.RowPitch + x * format->bytesPerPixel,
+                texture2DPatterns[x][y],
+                format->bytesPerPixel);
+            memcpy(
+                expectedTile + (y * 2 + x) * format->bytesPerPixel,
+                texture2DPatterns[x][y],
+                format->bytesPerPixel);
+        }
+        pStagingBuffer->Unmap(0);
+    }
+
+    // copy the patterns into the corners of the image, coordinates
     // (0,0), (w,0-1), (0,h-1), (w-1,h-1)
     for (UINT i = 0; i < size->SubResourceCount; ++i)
     for (UINT x = 0; x < 2; ++x)
     for (UINT y = 0; y < 2; ++y)
     {
-        // create the staging buffer
-        ID3D10Texture2D* pStagingBuffer = NULL;
-        {
-            D3D10_TEXTURE2D_DESC desc = {0};
-            desc.Width      = 1;
-            desc.Height     = 1;
-            desc.MipLevels  = 1;
-            desc.ArraySize  = 1;
-            desc.Format     = format->format;
-            desc.SampleDesc.Count = 1;
-            desc.SampleDesc.Quality = 0;
-            desc.Usage = D3D10_USAGE_STAGING;
-            desc.BindFlags = 0;
-            desc.CPUAccessFlags = D3D10_CPU_ACCESS_READ | D3D10_CPU_ACCESS_WRITE;
-            desc.MiscFlags = 0;
-            hr = pDevice->CreateTexture2D(&desc, NULL, &pStagingBuffer);
-            TestRequire(SUCCEEDED(hr), "ID3D10Device::CreateTexture2D failed (non-OpenCL D3D error, but test is invalid).");
-        }
-
-        // write the data to the staging buffer
-        {
-            D3D10_MAPPED_TEXTURE2D mappedTexture;
-            hr = pStagingBuffer->Map(
-                0,
-                D3D10_MAP_READ_WRITE,
-                0,
-                &mappedTexture);
-            memcpy(mappedTexture.pData, texture2DPatterns[x][y], format->bytesPerPixel);
-            pStagingBuffer->Unmap(0);
-        }
-
-        // copy the data to to the texture
-        {
-            D3D10_BOX box = {0};
-            box.front   = 0; box.back    = 1;
-            box.top     = 0; box.bottom  = 1;
-            box.left    = 0; box.right   = 1;
-            pDevice->CopySubresourceRegion(
-                pTexture,
-                subResourceInfo[i].subResource,
-                x ? subResourceInfo[i].width  - 1 : 0,
-                y ? subResourceInfo[i].height - 1 : 0,
-                0,
-                pStagingBuffer,
-                0,
-                &box);
-        }
-
-        pStagingBuffer->Release();
+        D3D10_BOX box = {0};
+        box.front   = 0; box.back    = 1;
+        box.top     = y; box.bottom  = y + 1;
+        box.left    = x; box.right   = x + 1;
+        pDevice->CopySubresourceRegion(
+            pTexture,
+            subResourceInfo[i].subResource,
+            x ? subResourceInfo[i].width  - 1 : 0,
+            y ? subResourceInfo[i].height - 1 : 0,
+            0,
+            pStagingBuffer,
+            0,
+            &box);
     }
 
     // create the cl_mem objects for the resources and verify its sanity
@@ -373,6 +368,7 @@ void SubTestTexture2D(
         if (!memCount) continue;
 
         // do the acquire
+        double start = HarnessD3D10_TimeUs();
         result = clEnqueueAcquireD3D10ObjectsKHR(
             command_queue,
             memCount,
@@ -382,6 +378,9 @@ void SubTestTexture2D(
             &events[0+i]);
         TestRequire(result == CL_SUCCESS, "clEnqueueAcquireD3D10ObjectsKHR failed.");
         TestRequire(events[0+i], "clEnqueueAcquireD3D10ObjectsKHR did not return an event.");
+        result = clWaitForEvents(1, &events[0+i]);
+        TestRequire(result == CL_SUCCESS, "clWaitForEvents for the acquire failed.");
+        acquireUs += HarnessD3D10_TimeUs() - start;
 
         // make sure the event type is correct
         cl_uint eventType = 0;
@@ -468,6 +467,10 @@ void SubTestTexture2D(
         }
     }
 
+    // let the kernel and copies finish so the release is timed on its own
+    result = clFinish(command_queue);
+    TestRequire(result == CL_SUCCESS, "clFinish failed.");
+
     // release the resource from OpenCL
     for (UINT i = 0; i < 2; ++i)
     {
@@ -492,6 +495,7 @@ void SubTestTexture2D(
         if (!memCount) continue;
 
         // do the release
+        double start = HarnessD3D10_TimeUs();
         result = clEnqueueReleaseD3D10ObjectsKHR(
             command_queue,
             memCount,
@@ -501,6 +505,9 @@ void SubTestTexture2D(
             &events[2+i]);
         TestRequire(result == CL_SUCCESS, "clEnqueueReleaseD3D10ObjectsKHR failed.");
         TestRequire(events[2+i], "clEnqueueReleaseD3D10ObjectsKHR did not return an event.");
+        result = clWaitForEvents(1, &events[2+i]);
+        TestRequire(result == CL_SUCCESS, "clWaitForEvents for the release failed.");
+        releaseUs += HarnessD3D10_TimeUs() - start;
 
         // make sure the event type is correct
         cl_uint eventType = 0;
@@ -514,30 +521,12 @@ void SubTestTexture2D(
         TestRequire(eventType == CL_COMMAND_RELEASE_D3D10_OBJECTS_KHR, "clGetEventInfo for CL_EVENT_COMMAND_TYPE was not CL_COMMAND_RELEASE_D3D10_OBJECTS_KHR.");
     }
 
+    log_perf(acquireUs, LOWER_IS_BETTER, "us", "texture2d %s acquire", format->name_format);
+    log_perf(releaseUs, LOWER_IS_BETTER, "us", "texture2d %s release", format->name_format);
+
     for (UINT i = 0; i < size->SubResourceCount; ++i)
-    for (UINT x = 0; x < 2; ++x)
-    for (UINT y = 0; y < 2; ++y)
     {
-        // create the staging buffer
-        ID3D10Texture2D* pStagingBuffer = NULL;
-        {
-            D3D10_TEXTURE2D_DESC desc = {0};
-            desc.Width      = 1;
-            desc.Height     = 1;
-            desc.MipLevels  = 1;
-            desc.ArraySize  = 1;
-            desc.Format     = format->format;
-            desc.SampleDesc.Count = 1;
-            desc.SampleDesc.Quality = 0;
-            desc.Usage = D3D10_USAGE_STAGING;
-            desc.BindFlags = 0;
-            desc.CPUAccessFlags = D3D10_CPU_ACCESS_READ | D3D10_CPU_ACCESS_WRITE;
-            desc.MiscFlags = 0;
-            hr = pDevice->CreateTexture2D(&desc, NULL, &pStagingBuffer);
-            TestRequire(SUCCEEDED(hr), "Failed to create staging buffer.");
-        }
-
-        // wipe out the staging buffer to make sure we don't get stale values
+        // wipe out the staging tile to make sure we don't get stale values
         {
             D3D10_MAPPED_TEXTURE2D mappedTexture;
             hr = pStagingBuffer->Map(
@@ -546,11 +535,16 @@ void SubTestTexture2D(
                 0,
                 &mappedTexture);
             TestRequire(SUCCEEDED(hr), "Failed to map staging buffer");
-            memset(mappedTexture.pData, 0, format->bytesPerPixel);
+            for (UINT y = 0; y < 2; ++y)
+            {
+                memset((char *)mappedTexture.pData + y * mappedTexture.RowPitch, 0, 2 * format->bytesPerPixel);
+            }
             pStagingBuffer->Unmap(0);
         }
 
-        // copy the pixel to the staging buffer
+        // copy the pixels written next to each corner into the tile
+        for (UINT x = 0; x < 2; ++x)
+        for (UINT y = 0; y < 2; ++y)
         {
             D3D10_BOX box = {0};
             box.left    = x ? subResourceInfo[i].width  - 2 : 1; box.right  = box.left + 1;
@@ -559,15 +553,16 @@ void SubTestTexture2D(
             pDevice->CopySubresourceRegion(
                 pStagingBuffer,
                 0,
-                0,
-                0,
+                x,
+                y,
                 0,
                 pTexture,
                 subResourceInfo[i].subResource,
                 &box);
         }
 
-        // make sure we read back what was written next door
+        // make sure we read back what was written next door, for all the
+        // corners at once
         {
             D3D10_MAPPED_TEXTURE2D mappedTexture;
             hr = pStagingBuffer->Map(
@@ -577,25 +572,23 @@ void SubTestTexture2D(
                 &mappedTexture);
             TestRequire(SUCCEEDED(hr), "Failed to map staging buffer");
 
-            /*
-            // This can be helpful in debugging...
-            printf("\n");
-            for (UINT k = 0; k < format->bytesPerPixel; ++k)
-            {
-                printf("[%c %c]\n",
-                    texture2DPatterns[x][y][k],
-                    ( (char *)mappedTexture.pData )[k]);
-            }
-            */
-
-            TestRequire(
-                !memcmp(mappedTexture.pData, texture2DPatterns[x][y], format->bytesPerPixel),
-                "Failed to map staging buffer");
+            int mismatch = HarnessD3D10_CompareTile(
+                mappedTexture.pData,
+                mappedTexture.RowPitch,
+                0,
+                2,
+                2,
+                1,
+                format->bytesPerPixel,
+                expectedTile);
 
             pStagingBuffer->Unmap(0);
-        }
 
-        pStagingBuffer->Release();
+            TestRequire(
+                mismatch < 0,
+                "Subresource %u corner (%d,%d) read back the wrong value",
+                i, mismatch % 2, mismatch / 2);
+        }
     }
 
 
@@ -98,7 +98,11 @@ void SubTestTexture3D(
     const Texture3DSize* size)
 {
     ID3D10Texture3D* pTexture = NULL;
+    ID3D10Texture3D* pStagingBuffer = NULL;
     HRESULT hr = S_OK;
+    char expectedTile[8 * 16];
+    double acquireUs = 0.0;
+    double releaseUs = 0.0;
 
     cl_int result = CL_SUCCESS;
 
@@ -152,59 +156,53 @@ void SubTestTexture3D(
         }
     }
 
-    // copy a pattern into the corners of the image, coordinates
+    // write the patterns into the staging tile, the pattern for corner
+    // (x,y,z) into texel (x,y,z)
+    pStagingBuffer = HarnessD3D10_GetStagingTexture3D(pDevice, format);
+    TestRequire(pStagingBuffer, "CreateTexture3D failed.");
+    {
+        D3D10_MAPPED_TEXTURE3D mappedTexture;
+        hr = pStagingBuffer->Map(
+            0,
+            D3D10_MAP_READ_WRITE,
+            0,
+            &mappedTexture);
+        TestRequire(SUCCEEDED(hr), "Failed to map staging buffer");
+        for (UINT x = 0; x < 2; ++x)
+        for (UINT y = 0; y < 2; ++y)
+        for (UINT z = 0; z < 2; ++z)
+        {
+            memcpy(
+                (char *)mappedTexture.pData + z * mappedTexture.DepthPitch + y * mappedTexture.RowPitch + x * format->bytesPerPixel,
+                texture3DPatterns[x][y][z],
+                format->bytesPerPixel);
+            memcpy(
+                expectedTile + ((z * 2 + y) * 2 + x) * format->bytesPerPixel,
+                texture3DPatterns[x][y][z],
+                format->bytesPerPixel);
+        }
+        pStagingBuffer->Unmap(0);
+    }
+
+    // copy the patterns into the corners of the image
     for (UINT i = 0; i < size->SubResourceCount; ++i)
     for (UINT x = 0; x < 2; ++x)
     for (UINT y = 0; y < 2; ++y)
     for (UINT z = 0; z < 2; ++z)
     {
-        // create the staging buffer
-        ID3D10Texture3D* pStagingBuffer = NULL;
-        {
-            D3D10_TEXTURE3D_DESC desc = {0};
-            desc.Width      = 1;
-            desc.Height     = 1;
-            desc.Depth      = 1;
-            desc.MipLevels  = 1;
-            desc.Format     = format->format;
-            desc.Usage = D3D10_USAGE_STAGING;
-            desc.BindFlags = 0;
-            desc.CPUAccessFlags = D3D10_CPU_ACCESS_READ | D3D10_CPU_ACCESS_WRITE;
-            desc.MiscFlags = 0;
-            hr = pDevice->CreateTexture3D(&desc, NULL, &pStagingBuffer);
-            TestRequire(SUCCEEDED(hr), "CreateTexture3D failed.");
-        }
-
-        // write the data to the staging buffer
-        {
-            D3D10_MAPPED_TEXTURE3D mappedTexture;
-            hr = pStagingBuffer->Map(
-                0,
-                D3D10_MAP_READ_WRITE,
-                0,
-                &mappedTexture);
-            memcpy(mappedTexture.pData, texture3DPatterns[x][y][z], format->bytesPerPixel);
-            pStagingBuffer->Unmap(0);
-        }
-
-        // copy the data to to the texture
-        {
-            D3D10_BOX box = {0};
-            box.front   = 0; box.back    = 1;
-            box.top     = 0; box.bottom  = 1;
-            box.left    = 0; box.right   = 1;
-            pDevice->CopySubresourceRegion(
-                pTexture,
-                subResourceInfo[i].subResource,
-                x ? subResourceInfo[i].width  - 1 : 0,
-                y ? subResourceInfo[i].height - 1 : 0,
-                z ? subResourceInfo[i].depth  - 1 : 0,
-                pStagingBuffer,
-                0,
-                &box);
-        }
-
-        pStagingBuffer->Release();
+        D3D10_BOX box = {0};
+        box.front   = z; box.back    = z + 1;
+        box.top     = y; box.bottom  = y + 1;
+        box.left    = x; box.right   = x + 1;
+        pDevice->CopySubresourceRegion(
+            pTexture,
+            subResourceInfo[i].subResource,
+            x ? subResourceInfo[i].width  - 1 : 0,
+            y ? subResourceInfo[i].height - 1 : 0,
+            z ? subResourceInfo[i].depth  - 1 : 0,
+            pStagingBuffer,
+            0,
+            &box);
     }
 
     // create the cl_mem objects for the resources and verify its sanity
@@ -299,6 +297,7 @@ void SubTestTexture3D(
         }
 
         // do the acquire
+        double start = HarnessD3D10_TimeUs();
         result = clEnqueueAcquireD3D10ObjectsKHR(
             command_queue,
             size->SubResourceCount,
@@ -307,6 +306,9 @@ void SubTestTexture3D(
             NULL,
             NULL);
         TestRequire(result == CL_SUCCESS, "clEnqueueAcquireD3D10ObjectsKHR failed.");
+        result = clFinish(command_queue);
+        TestRequire(result == CL_SUCCESS, "clFinish failed.");
+        acquireUs = HarnessD3D10_TimeUs() - start;
     }
 
     // download the data using OpenCL & compare with the expected results
@@ -351,6 +353,10 @@ void SubTestTexture3D(
         TestRequire(result == CL_SUCCESS, "clEnqueueCopyImage failed.");
     }
 
+    // let the copies finish so the release is timed on its own
+    result = clFinish(command_queue);
+    TestRequire(result == CL_SUCCESS, "clFinish failed.");
+
     // release the resource from OpenCL
     {
         cl_mem memToAcquire[MAX_REGISTERED_SUBRESOURCES];
@@ -360,6 +366,7 @@ void SubTestTexture3D(
         }
 
         // do the release
+        double start = HarnessD3D10_TimeUs();
         result = clEnqueueReleaseD3D10ObjectsKHR(
             command_queue,
             size->SubResourceCount,
@@ -368,31 +375,17 @@ void SubTestTexture3D(
             NULL,
             NULL);
         TestRequire(result == CL_SUCCESS, "clEnqueueReleaseD3D10ObjectsKHR failed.");
+        result = clFinish(command_queue);
+        TestRequire(result == CL_SUCCESS, "clFinish failed.");
+        releaseUs = HarnessD3D10_TimeUs() - start;
     }
 
+    log_perf(acquireUs, LOWER_IS_BETTER, "us", "texture3d %s acquire", format->name_format);
+    log_perf(releaseUs, LOWER_IS_BETTER, "us", "texture3d %s release", format->name_format);
+
     for (UINT i = 0; i < size->SubResourceCount; ++i)
-    for (UINT x = 0; x < 2; ++x)
-    for (UINT y = 0; y < 2; ++y)
-    for (UINT z = 0; z < 2; ++z)
     {
-        // create the staging buffer
-        ID3D10Texture3D* pStagingBuffer = NULL;
-        {
-            D3D10_TEXTURE3D_DESC desc = {0};
-            desc.Width      = 1;
-            desc.Height     = 1;
-            desc.Depth      = 1;
-            desc.MipLevels  = 1;
-            desc.Format     = format->format;
-            desc.Usage = D3D10_USAGE_STAGING;
-            desc.BindFlags = 0;
-            desc.CPUAccessFlags = D3D10_CPU_ACCESS_READ | D3D10_CPU_ACCESS_WRITE;
-            desc.MiscFlags = 0;
-            hr = pDevice->CreateTexture3D(&desc, NULL, &pStagingBuffer);
-            TestRequire(SUCCEEDED(hr), "Failed to create staging buffer.");
-        }
-
-        // wipe out the staging buffer to make sure we don't get stale values
+        // wipe out the staging tile to make sure we don't get stale values
         {
             D3D10_MAPPED_TEXTURE3D mappedTexture;
             hr = pStagingBuffer->Map(
@@ -401,11 +394,18 @@ void SubTestTexture3D(
                 0,
                 &mappedTexture);
             TestRequire(SUCCEEDED(hr), "Failed to map staging buffer");
-            memset(mappedTexture.pData, 0, format->bytesPerPixel);
+            for (UINT z = 0; z < 2; ++z)
+            for (UINT y = 0; y < 2; ++y)
+            {
+                memset((char *)mappedTexture.pData + z * mappedTexture.DepthPitch + y * mappedTexture.RowPitch, 0, 2 * format->bytesPerPixel);
+            }
             pStagingBuffer->Unmap(0);
         }
 
-        // copy the pixel to the staging buffer
+        // copy the pixels written next to each corner into the tile
+        for (UINT x = 0; x < 2; ++x)
+        for (UINT y = 0; y < 2; ++y)
+        for (UINT z = 0; z < 2; ++z)
         {
             D3D10_BOX box = {0};
             box.left    = x ? subResourceInfo[i].width  - 2 : 1; box.right  = box.left  + 1;
@@ -414,15 +414,16 @@ void SubTestTexture3D(
             pDevice->CopySubresourceRegion(
                 pStagingBuffer,
                 0,
-                0,
-                0,
-                0,
+                x,
+                y,
+                z,
                 pTexture,
                 subResourceInfo[i].subResource,
                 &box);
         }
 
-        // make sure we read back what was written next door
+        // make sure we read back what was written next door, for all the
+        // corners at once
         {
             D3D10_MAPPED_TEXTURE3D mappedTexture;
             hr = pStagingBuffer->Map(
@@ -432,25 +433,23 @@ void SubTestTexture3D(
                 &mappedTexture);
             TestRequire(SUCCEEDED(hr), "Failed to map staging buffer");
 
-            /*
-            // This can be helpful in debugging...
-            printf("\n");
-            for (UINT k = 0; k < format->bytesPerPixel; ++k)
-            {
-                printf("[%c %c]\n",
-                    texture2DPatterns[x][y][k],
-                    ( (char *)mappedTexture.pData )[k]);
-            }
-            */
-
-            TestRequire(
-                !memcmp(mappedTexture.pData, texture3DPatterns[x][y][z], format->bytesPerPixel),
-                "Failed to map staging buffer");
+            int mismatch = HarnessD3D10_CompareTile(
+                mappedTexture.pData,
+                mappedTexture.RowPitch,
+                mappedTexture.DepthPitch,
+                2,
+                2,
+                2,
+                format->bytesPerPixel,
+                expectedTile);
 
             pStagingBuffer->Unmap(0);
-        }
 
-        pStagingBuffer->Release();
+            TestRequire(
+                mismatch < 0,
+                "Subresource %u corner (%d,%d,%d) read back the wrong value",
+                i, mismatch % 2, (mismatch / 2) % 2, mismatch / 4);
+        }
     }
 
 
@@ -0,0 +1,316 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#define _CRT_SECURE_NO_WARNINGS
+#include "harness.h"
+#include "harness/benchmark.h"
+#include "harness/perfMetrics.h"
+#include <string>
+#include <vector>
+
+// Acquire/release latency and sustained update throughput of the buffers and
+// 2D textures the tests share, one row per phase of a frame for every
+// resource or format and size. Every frame acquires all registered
+// (sub)resources, fills them from OpenCL and releases them again. This
+// harness has no test list to name benchmarks in, so it only runs with
+// -bench.
+
+struct BenchTimes
+{
+    double acquire;
+    double fill;
+    double release;
+    double frame;
+};
+
+// Times one round of acquire, fill and release over mems. fill enqueues the
+// OpenCL update for one resource.
+template <typename Fill>
+static cl_int TimeSharedFrame(
+    cl_command_queue command_queue,
+    cl_uint memCount,
+    const cl_mem* mems,
+    Fill fill,
+    BenchTimes* times)
+{
+    HostTimer timer;
+    cl_int result = clEnqueueAcquireD3D11ObjectsKHR(
+        command_queue, memCount, mems, 0, NULL, NULL);
+    if (result == CL_SUCCESS) result = clFinish(command_queue);
+    if (result != CL_SUCCESS) return result;
+
+    double acquiredUs = timer.elapsed_us();
+    for (cl_uint i = 0; i < memCount && result == CL_SUCCESS; ++i)
+    {
+        result = fill(mems[i], i);
+    }
+    if (result == CL_SUCCESS) result = clFinish(command_queue);
+    if (result != CL_SUCCESS) return result;
+
+    double filledUs = timer.elapsed_us();
+    result = clEnqueueReleaseD3D11ObjectsKHR(
+        command_queue, memCount, mems, 0, NULL, NULL);
+    if (result == CL_SUCCESS) result = clFinish(command_queue);
+    if (result != CL_SUCCESS) return result;
+
+    double releasedUs = timer.elapsed_us();
+    times->acquire = acquiredUs;
+    times->fill = filledUs - acquiredUs;
+    times->release = releasedUs - filledUs;
+    times->frame = releasedUs;
+    return CL_SUCCESS;
+}
+
+// Takes each phase of the frames over mems as a BENCH row of its own, and
+// the update throughput of bytes per frame
+template <typename Fill>
+static cl_int MeasureSharedFrames(
+    const std::string& label,
+    double bytes,
+    cl_command_queue command_queue,
+    cl_uint memCount,
+    const cl_mem* mems,
+    Fill fill)
+{
+    static const struct
+    {
+        const char* name;
+        double BenchTimes::*us;
+    } phases[] = {
+        { "acquire", &BenchTimes::acquire },
+        { "release", &BenchTimes::release },
+        { "fill", &BenchTimes::fill },
+        { "frame", &BenchTimes::frame },
+    };
+
+    BenchmarkOptions options;
+    options.warmup = 1;
+    options.maxSeconds = 1.0;
+    for (const auto& phase : phases)
+    {
+        BenchmarkStats stats;
+        cl_int result = run_benchmark(
+            options,
+            [&](double* us) {
+                BenchTimes times;
+                cl_int err = TimeSharedFrame(
+                    command_queue, memCount, mems, fill, &times);
+                *us = times.*phase.us;
+                return err;
+            },
+            &stats);
+        if (result != CL_SUCCESS) return result;
+
+        std::string row = label + "/" + phase.name;
+        log_benchmark_stats("d3d11_sharing", row.c_str(), "us", false, stats);
+        if (phase.us == &BenchTimes::frame && stats.median > 0)
+        {
+            record_perf_metric("d3d11_sharing_MBps." + label,
+                bytes / stats.median, "MB/s", true);
+        }
+    }
+    return CL_SUCCESS;
+}
+
+void SubTestBenchmarkBuffer(
+    cl_context context,
+    cl_command_queue command_queue,
+    ID3D11Device* pDevice,
+    const BufferProperties* props)
+{
+    ID3D11Buffer* pBuffer = NULL;
+    cl_mem mem = NULL;
+    cl_int result = CL_SUCCESS;
+    HRESULT hr = S_OK;
+    const cl_uchar pattern = 0xA5;
+
+    HarnessD3D11_TestBegin("Benchmark Buffer: Size=%d, BindFlags=%s, Usage=%s",
+        props->ByteWidth,
+        props->name_BindFlags,
+        props->name_Usage);
+
+    hr = CreateSharedBuffer(pDevice, props, &pBuffer);
+    TestRequire(SUCCEEDED(hr), "Creating vertex buffer failed!");
+
+    mem = clCreateFromD3D11BufferKHR(context, 0, pBuffer, &result);
+    TestRequire(result == CL_SUCCESS, "clCreateFromD3D11BufferKHR failed");
+
+    TestPrint("\n");
+    result = MeasureSharedFrames(
+        std::string("buffer/") + props->name_BindFlags + "/"
+            + std::to_string(props->ByteWidth),
+        props->ByteWidth,
+        command_queue, 1, &mem,
+        [&](cl_mem buffer, cl_uint) {
+            return clEnqueueFillBuffer(command_queue, buffer, &pattern,
+                                       sizeof(pattern), 0, props->ByteWidth,
+                                       0, NULL, NULL);
+        });
+    TestRequire(result == CL_SUCCESS, "Timing shared buffer updates failed");
+
+Cleanup:
+
+    if (mem)
+    {
+        clReleaseMemObject(mem);
+    }
+    if (pBuffer)
+    {
+        pBuffer->Release();
+    }
+
+    HarnessD3D11_TestEnd();
+}
+
+void SubTestBenchmarkTexture2D(
+    cl_context context,
+    cl_command_queue command_queue,
+    ID3D11Device* pDevice,
+    const TextureFormat* format,
+    const Texture2DSize* size)
+{
+    ID3D11Texture2D* pTexture = NULL;
+    cl_mem mems[MAX_REGISTERED_SUBRESOURCES] = {NULL, NULL, NULL, NULL};
+    size_t regions[MAX_REGISTERED_SUBRESOURCES][3];
+    cl_int result = CL_SUCCESS;
+    HRESULT hr = S_OK;
+    double bytes = 0;
+
+    // one value of the format's generic type in every channel
+    cl_float floatColor[4] = {0.5f, 0.5f, 0.5f, 0.5f};
+    cl_uint uintColor[4] = {1, 1, 1, 1};
+    const void* fillColor = format->generic == TextureFormat::GENERIC_FLOAT
+        ? (const void*)floatColor
+        : (const void*)uintColor;
+
+    HarnessD3D11_TestBegin("Benchmark 2D Texture: Format=%s, Width=%d, Height=%d, MipLevels=%d, ArraySize=%d",
+        format->name_format,
+        size->Width,
+        size->Height,
+        size->MipLevels,
+        size->ArraySize);
+
+    hr = CreateSharedTexture2D(pDevice, format, size, &pTexture);
+    TestRequire(SUCCEEDED(hr), "ID3D11Device::CreateTexture2D failed (non-OpenCL D3D error, but test is invalid).");
+
+    for (UINT i = 0; i < size->SubResourceCount; ++i)
+    {
+        UINT subResource = D3D11CalcSubresource(
+            size->subResources[i].MipLevel,
+            size->subResources[i].ArraySlice,
+            size->MipLevels);
+        size_t width = size->Width;
+        size_t height = size->Height;
+        for (UINT j = 0; j < size->subResources[i].MipLevel; ++j)
+        {
+            width /= 2;
+            height /= 2;
+        }
+        regions[i][0] = width;
+        regions[i][1] = height;
+        regions[i][2] = 1;
+        bytes += (double)width * height * format->bytesPerPixel;
+
+        mems[i] = clCreateFromD3D11Texture2DKHR(
+            context,
+            0,
+            pTexture,
+            subResource,
+            &result);
+        if (CL_IMAGE_FORMAT_NOT_SUPPORTED == result)
+        {
+            goto Cleanup;
+        }
+        TestRequire(result == CL_SUCCESS, "clCreateFromD3D11Texture2DKHR failed");
+    }
+
+    TestPrint("\n");
+    result = MeasureSharedFrames(
+        std::string("texture2d/") + format->name_format + "/"
+            + std::to_string(size->Width) + "x"
+            + std::to_string(size->Height) + "/"
+            + std::to_string(size->SubResourceCount),
+        bytes,
+        command_queue, size->SubResourceCount, mems,
+        [&](cl_mem image, cl_uint i) {
+            size_t origin[3] = {0, 0, 0};
+            return clEnqueueFillImage(command_queue, image, fillColor, origin,
+                                      regions[i], 0, NULL, NULL);
+        });
+    TestRequire(result == CL_SUCCESS, "Timing shared texture updates failed");
+
+Cleanup:
+
+    for (UINT i = 0; i < size->SubResourceCount; ++i)
+    {
+        if (mems[i])
+        {
+            clReleaseMemObject(mems[i]);
+        }
+    }
+    if (pTexture)
+    {
+        pTexture->Release();
+    }
+
+    HarnessD3D11_TestEnd();
+}
+
+void TestDeviceBenchmark(
+    cl_device_id device,
+    cl_context context,
+    cl_command_queue command_queue,
+    ID3D11Device* pDevice,
+    ID3D11DeviceContext* pDC)
+{
+    cl_int result = CL_SUCCESS;
+    cl_uint supported_formats_count = 0;
+    std::vector<cl_image_format> supported_image_formats;
+
+    log_benchmark_header("d3d11_sharing", "resource/format/size/phase");
+
+    for (UINT i = 0; i < bufferPropertyCount; ++i)
+    {
+        SubTestBenchmarkBuffer(
+            context,
+            command_queue,
+            pDevice,
+            &bufferProperties[i]);
+    }
+
+    result = clGetSupportedImageFormats(context, CL_MEM_WRITE_ONLY, CL_MEM_OBJECT_IMAGE2D, 0, NULL, &supported_formats_count);
+    NonTestRequire(CL_SUCCESS == result, "clGetSupportedImageFormats failed.");
+    supported_image_formats.resize(supported_formats_count);
+    result = clGetSupportedImageFormats(context, CL_MEM_WRITE_ONLY, CL_MEM_OBJECT_IMAGE2D, supported_formats_count, &supported_image_formats[0], NULL);
+    NonTestRequire(CL_SUCCESS == result, "clGetSupportedImageFormats failed.");
+
+    for (UINT format = 0; format < formatCount; ++format)
+    {
+        if (!is_format_supported(formats[format].channel_order, formats[format].channel_type, supported_image_formats))
+        {
+            continue;
+        }
+
+        for (UINT size = 0; size < texture2DSizeCount; ++size)
+        {
+            SubTestBenchmarkTexture2D(
+                context,
+                command_queue,
+                pDevice,
+                &formats[format],
+                &texture2DSizes[size]);
+        }
+    }
+}
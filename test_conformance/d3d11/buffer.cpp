@@ -47,6 +47,20 @@ BufferProperties bufferProperties[] =
 };
 UINT bufferPropertyCount = sizeof(bufferProperties)/sizeof(bufferProperties[0]);
 
+HRESULT CreateSharedBuffer(
+    ID3D11Device* pDevice,
+    const BufferProperties* props,
+    ID3D11Buffer** ppBuffer)
+{
+    D3D11_BUFFER_DESC desc = {0};
+    desc.ByteWidth = props->ByteWidth;
+    desc.Usage = props->Usage;
+    desc.CPUAccessFlags = props->CPUAccess;
+    desc.BindFlags = props->BindFlags;
+    desc.MiscFlags = 0;
+    return pDevice->CreateBuffer(&desc, NULL, ppBuffer);
+}
+
 void SubTestBuffer(
     cl_context context,
     cl_command_queue command_queue,
@@ -66,16 +80,8 @@ void SubTestBuffer(
         props->name_CPUAccess);
 
     // create the D3D11 resource
-    {
-        D3D11_BUFFER_DESC desc = {0};
-        desc.ByteWidth = props->ByteWidth;
-        desc.Usage = props->Usage;
-        desc.CPUAccessFlags = props->CPUAccess;
-        desc.BindFlags = props->BindFlags;
-        desc.MiscFlags = 0;
-        hr = pDevice->CreateBuffer(&desc, NULL, &pBuffer);
-        TestRequire(SUCCEEDED(hr), "Creating vertex buffer failed!");
-    }
+    hr = CreateSharedBuffer(pDevice, props, &pBuffer);
+    TestRequire(SUCCEEDED(hr), "Creating vertex buffer failed!");
 
     // populate the D3D11 resource with data
     {
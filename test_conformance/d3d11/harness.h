@@ -40,6 +40,7 @@ typedef unsigned char UINT8;
 #include <CL/cl_platform.h>
 #include <CL/cl_d3d11.h>
 #include <stdio.h>
+#include <vector>
 #include "errorHelpers.h"
 #include "kernelHelpers.h"
 
@@ -204,6 +205,35 @@ void TestDeviceMisc(
     cl_command_queue command_queue,
     ID3D11Device* pDevice);
 
+void TestDeviceBenchmark(
+    cl_device_id device,
+    cl_context context,
+    cl_command_queue command_queue,
+    ID3D11Device* pDevice,
+    ID3D11DeviceContext* pDC);
+
+// Resource tables and creation shared by the tests and the benchmark
+extern BufferProperties bufferProperties[];
+extern UINT bufferPropertyCount;
+extern Texture2DSize texture2DSizes[];
+extern UINT texture2DSizeCount;
+
+HRESULT CreateSharedBuffer(
+    ID3D11Device* pDevice,
+    const BufferProperties* props,
+    ID3D11Buffer** ppBuffer);
+
+HRESULT CreateSharedTexture2D(
+    ID3D11Device* pDevice,
+    const TextureFormat* format,
+    const Texture2DSize* size,
+    ID3D11Texture2D** ppTexture);
+
+bool is_format_supported(
+    cl_channel_order channel_order,
+    cl_channel_type channel_type,
+    const std::vector<cl_image_format> &supported_image_formats);
+
 cl_int HarnessD3D11_CreateKernelFromSource(
     cl_kernel *outKernel,
     cl_device_id device,
@@ -302,6 +302,17 @@ void TestDevice(
         command_queue,
         pDevice);
 
+    // time the sharing paths exercised above
+    if (gBench)
+    {
+        TestDeviceBenchmark(
+            device,
+            context,
+            command_queue,
+            pDevice,
+            pDC);
+    }
+
     clReleaseContext(context);
     clReleaseCommandQueue(command_queue);
 }
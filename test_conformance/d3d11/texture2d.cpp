@@ -156,6 +156,29 @@ texture2DPatterns[2][2] =
     {"zZyYxXwWvVuUtTsSrRqQ", "ZzYyXxWwVvUuTtSsRrQq"},
 };
 
+HRESULT CreateSharedTexture2D(
+    ID3D11Device* pDevice,
+    const TextureFormat* format,
+    const Texture2DSize* size,
+    ID3D11Texture2D** ppTexture)
+{
+    D3D11_TEXTURE2D_DESC desc;
+    memset(&desc, 0, sizeof(desc) );
+    desc.Width      = size->Width;
+    desc.Height     = size->Height;
+    desc.MipLevels  = size->MipLevels;
+    desc.ArraySize  = size->ArraySize;
+    desc.Format     = format->format;
+    desc.SampleDesc.Count = 1;
+    desc.SampleDesc.Quality = 0;
+    desc.Usage = D3D11_USAGE_DEFAULT;
+    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;
+    desc.CPUAccessFlags = 0;
+    desc.MiscFlags = 0;
+
+    return pDevice->CreateTexture2D(&desc, NULL, ppTexture);
+}
+
 void SubTestTexture2D(
     cl_context context,
     cl_command_queue command_queue,
@@ -189,24 +212,8 @@ void SubTestTexture2D(
     cl_event events[4] = {NULL, NULL, NULL, NULL};
 
     // create the D3D11 resources
-    {
-        D3D11_TEXTURE2D_DESC desc;
-        memset(&desc, 0, sizeof(desc) );
-        desc.Width      = size->Width;
-        desc.Height     = size->Height;
-        desc.MipLevels  = size->MipLevels;
-        desc.ArraySize  = size->ArraySize;
-        desc.Format     = format->format;
-        desc.SampleDesc.Count = 1;
-        desc.SampleDesc.Quality = 0;
-        desc.Usage = D3D11_USAGE_DEFAULT;
-        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;
-        desc.CPUAccessFlags = 0;
-        desc.MiscFlags = 0;
-
-        hr = pDevice->CreateTexture2D(&desc, NULL, &pTexture);
-        TestRequire(SUCCEEDED(hr), "ID3D11Device::CreateTexture2D failed (non-OpenCL D3D error, but test is invalid).");
-    }
+    hr = CreateSharedTexture2D(pDevice, format, size, &pTexture);
+    TestRequire(SUCCEEDED(hr), "ID3D11Device::CreateTexture2D failed (non-OpenCL D3D error, but test is invalid).");
 
     // initialize some useful variables
     for (UINT i = 0; i < size->SubResourceCount; ++i)
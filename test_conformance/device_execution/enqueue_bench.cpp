@@ -0,0 +1,388 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include <stdio.h>
+#include <string.h>
+#include "harness/testHarness.h"
+#include "harness/typeWrappers.h"
+#include "harness/benchmark.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "procs.h"
+#include "utils.h"
+
+// Cost of device-side enqueue against the host doing the same. A chain of
+// single work-item children, each enqueued by the one before, gives the
+// latency of one nesting level; one parent enqueueing many children gives
+// the throughput. Both are taken for each of the CLK_ENQUEUE_FLAGS_* flags,
+// and the fan-out for blocks capturing 0 to 256 bytes besides the result
+// pointer. The host runs the same single work-item kernels enqueued one at
+// a time and waited on, and enqueued back to back. Device times come from
+// the parent's CL_PROFILING_COMMAND_COMPLETE, less the median of a run
+// without children. A benchmark, so it only runs when named.
+
+static const char* device_enqueue_bench = R"(
+    #if CAPTURE_INT4S > 0
+    typedef struct { int4 v[CAPTURE_INT4S]; } payload_t;
+    #endif
+
+    // res[0] counts failed enqueues, res[1] levels run, res[2 + i] is
+    // written by child i
+    void chain_enqueue(__global int* res, int remaining)
+    {
+      if (remaining <= 0) return;
+      void (^child)(void) = ^{
+        atomic_inc(&res[1]);
+        chain_enqueue(res, remaining - 1);
+      };
+      if (enqueue_kernel(get_default_queue(), FLAGS, ndrange_1D(1), child)
+          != CLK_SUCCESS)
+        atomic_inc(&res[0]);
+    }
+
+    kernel void device_chain(__global int* res, int depth)
+    {
+      chain_enqueue(res, depth);
+    }
+
+    kernel void device_fan_out(__global int* res, int children)
+    {
+    #if CAPTURE_INT4S > 0
+      payload_t p;
+      for (int k = 0; k < CAPTURE_INT4S; k++) p.v[k] = (int4)(k);
+    #endif
+      for (int i = 0; i < children; i++)
+      {
+        void (^child)(void) = ^{
+    #if CAPTURE_INT4S > 0
+          res[2 + i] = i + p.v[CAPTURE_INT4S - 1].x;
+    #else
+          res[2 + i] = i;
+    #endif
+        };
+        if (enqueue_kernel(get_default_queue(), FLAGS, ndrange_1D(1), child)
+            != CLK_SUCCESS)
+        {
+          atomic_inc(&res[0]);
+          return;
+        }
+      }
+    }
+
+    kernel void host_child(__global int* res, int i)
+    {
+      res[2 + i] = i;
+    })";
+
+static const char* kEnqueueFlags[] = { "CLK_ENQUEUE_FLAGS_NO_WAIT",
+                                       "CLK_ENQUEUE_FLAGS_WAIT_KERNEL",
+                                       "CLK_ENQUEUE_FLAGS_WAIT_WORK_GROUP" };
+static const int kCaptureInt4s[] = { 0, 1, 4, 16 };
+static const int kChainDepths[] = { 1, 4, 16, 64 };
+static const int kFanOuts[] = { 16, 64, 256 };
+// Launches per host sample
+static const int kHostLaunches = 256;
+
+namespace {
+
+struct EnqueueBench
+{
+    cl_command_queue host_queue;
+    clMemWrapper res_mem;
+    std::vector<cl_int> results;
+    BenchmarkOptions options;
+
+    cl_int Clear()
+    {
+        const cl_int zero = 0;
+        cl_int err_ret = clEnqueueFillBuffer(
+            host_queue, res_mem, &zero, sizeof(zero), 0,
+            results.size() * sizeof(cl_int), 0, NULL, NULL);
+        test_error(err_ret, "clEnqueueFillBuffer() failed");
+        return CL_SUCCESS;
+    }
+
+    cl_int Read()
+    {
+        cl_int err_ret = clEnqueueReadBuffer(
+            host_queue, res_mem, CL_TRUE, 0, results.size() * sizeof(cl_int),
+            results.data(), 0, NULL, NULL);
+        test_error(err_ret, "clEnqueueReadBuffer() failed");
+        return CL_SUCCESS;
+    }
+
+    // Time of the parent's start to the completion of all its children, in
+    // us per child less base_us, or in us when there are no children. Sets
+    // queue_full when the device queue refused a child, and checks the
+    // results otherwise.
+    cl_int TimeDevice(cl_kernel kernel, int count, bool chain, int capture,
+                      double base_us, BenchmarkStats& stats, bool& queue_full)
+    {
+        cl_int err_ret = clSetKernelArg(kernel, 0, sizeof(res_mem), &res_mem);
+        err_ret |= clSetKernelArg(kernel, 1, sizeof(count), &count);
+        test_error(err_ret, "clSetKernelArg() failed");
+
+        queue_full = false;
+        size_t one = 1;
+        err_ret = run_benchmark(
+            options,
+            [&](double* us) -> cl_int {
+                cl_int err = Clear();
+                if (err != CL_SUCCESS) return err;
+
+                clEventWrapper event;
+                err = clEnqueueNDRangeKernel(host_queue, kernel, 1, NULL, &one,
+                                             &one, 0, NULL, &event);
+                test_error(err, "clEnqueueNDRangeKernel() failed");
+                err = clWaitForEvents(1, &event);
+                test_error(err, "clWaitForEvents() failed");
+
+                double ns;
+                err = get_event_duration_ns(event, &ns,
+                                            CL_PROFILING_COMMAND_START,
+                                            CL_PROFILING_COMMAND_COMPLETE);
+                if (err != CL_SUCCESS) return err;
+                *us = count ? (ns / 1e3 - base_us) / count : ns / 1e3;
+
+                err = Read();
+                if (err != CL_SUCCESS) return err;
+                if (results[0] != 0)
+                {
+                    // Ends the run, the caller reports the full queue
+                    queue_full = true;
+                    return -1;
+                }
+                if (chain ? !CheckChain(count) : !CheckChildren(count, capture))
+                    return -1;
+                return CL_SUCCESS;
+            },
+            &stats);
+        return queue_full ? CL_SUCCESS : err_ret;
+    }
+
+    bool CheckChain(int depth)
+    {
+        if (results[1] == depth) return true;
+        log_error("ERROR: %d of %d chained children ran\n", results[1], depth);
+        return false;
+    }
+
+    bool CheckChildren(int children, int capture)
+    {
+        int offset = capture > 0 ? capture - 1 : 0;
+        for (int i = 0; i < children; i++)
+        {
+            if (results[2 + i] != i + offset)
+            {
+                log_error("ERROR: child %d of %d wrote %d, expected %d\n", i,
+                          children, results[2 + i], i + offset);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Wall time per launch of kHostLaunches single work-item kernels,
+    // waited on one at a time or enqueued back to back
+    cl_int TimeHost(cl_kernel kernel, bool round_trip, BenchmarkStats& stats)
+    {
+        cl_int err_ret = Clear();
+        if (err_ret != CL_SUCCESS) return err_ret;
+        err_ret = clFinish(host_queue);
+        test_error(err_ret, "clFinish() failed");
+        err_ret = clSetKernelArg(kernel, 0, sizeof(res_mem), &res_mem);
+        test_error(err_ret, "clSetKernelArg() failed");
+
+        size_t one = 1;
+        err_ret = run_benchmark(
+            options,
+            [&](double* us) -> cl_int {
+                HostTimer timer;
+                for (int i = 0; i < kHostLaunches; i++)
+                {
+                    cl_int err = clSetKernelArg(kernel, 1, sizeof(i), &i);
+                    test_error(err, "clSetKernelArg() failed");
+                    err = clEnqueueNDRangeKernel(host_queue, kernel, 1, NULL,
+                                                 &one, &one, 0, NULL, NULL);
+                    test_error(err, "clEnqueueNDRangeKernel() failed");
+                    if (round_trip)
+                    {
+                        err = clFinish(host_queue);
+                        test_error(err, "clFinish() failed");
+                    }
+                }
+                cl_int err = clFinish(host_queue);
+                test_error(err, "clFinish() failed");
+                *us = timer.elapsed_us() / kHostLaunches;
+                return CL_SUCCESS;
+            },
+            &stats);
+        if (err_ret != CL_SUCCESS) return err_ret;
+
+        err_ret = Read();
+        if (err_ret != CL_SUCCESS) return err_ret;
+        return CheckChildren(kHostLaunches, 0) ? CL_SUCCESS : -1;
+    }
+};
+
+std::string flag_name(const char* flag)
+{
+    return std::string(flag + strlen("CLK_ENQUEUE_FLAGS_"));
+}
+
+} // anonymous namespace
+
+int test_enqueue_bench(cl_device_id device, cl_context context,
+                       cl_command_queue queue, int num_elements)
+{
+    cl_int err_ret;
+    cl_uint maxQueueSize = 0;
+    err_ret = clGetDeviceInfo(device, CL_DEVICE_QUEUE_ON_DEVICE_MAX_SIZE,
+                              sizeof(maxQueueSize), &maxQueueSize, 0);
+    test_error(err_ret,
+               "clGetDeviceInfo(CL_DEVICE_QUEUE_ON_DEVICE_MAX_SIZE) failed");
+
+    cl_queue_properties dev_queue_prop_def[] = {
+        CL_QUEUE_PROPERTIES,
+        CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE | CL_QUEUE_ON_DEVICE
+            | CL_QUEUE_ON_DEVICE_DEFAULT,
+        CL_QUEUE_SIZE, maxQueueSize, 0
+    };
+    clCommandQueueWrapper dev_queue = clCreateCommandQueueWithProperties(
+        context, device, dev_queue_prop_def, &err_ret);
+    test_error(err_ret,
+               "clCreateCommandQueueWithProperties(CL_QUEUE_ON_DEVICE | "
+               "CL_QUEUE_ON_DEVICE_DEFAULT) failed");
+
+    cl_queue_properties host_queue_prop_def[] = { CL_QUEUE_PROPERTIES,
+                                                  CL_QUEUE_PROFILING_ENABLE,
+                                                  0 };
+    clCommandQueueWrapper host_queue = clCreateCommandQueueWithProperties(
+        context, device, host_queue_prop_def, &err_ret);
+    test_error(
+        err_ret,
+        "clCreateCommandQueueWithProperties(CL_QUEUE_PROFILING_ENABLE) failed");
+
+    EnqueueBench bench;
+    bench.host_queue = host_queue;
+    bench.options.warmup = 1;
+    bench.options.maxSeconds = 0.5;
+    int max_children = std::max(kFanOuts[arr_size(kFanOuts) - 1],
+                                kHostLaunches);
+    bench.results.resize(2 + max_children);
+    bench.res_mem =
+        clCreateBuffer(context, CL_MEM_READ_WRITE,
+                       bench.results.size() * sizeof(cl_int), NULL, &err_ret);
+    test_error(err_ret, "clCreateBuffer() failed");
+
+    log_benchmark_header("device_enqueue", "mode/flags/capture_bytes/count");
+    for (size_t f = 0; f < arr_size(kEnqueueFlags); f++)
+    {
+        std::string flags = flag_name(kEnqueueFlags[f]);
+        for (size_t c = 0; c < arr_size(kCaptureInt4s); c++)
+        {
+            int capture = kCaptureInt4s[c];
+            std::string options = std::string("-DFLAGS=") + kEnqueueFlags[f]
+                + " -DCAPTURE_INT4S=" + std::to_string(capture);
+            clProgramWrapper program;
+            clKernelWrapper chain, fan_out;
+            err_ret = create_single_kernel_helper(
+                context, &program, &chain, 1, &device_enqueue_bench,
+                "device_chain", options.c_str());
+            if (check_error(err_ret, "Create single kernel failed"))
+                return -1;
+            fan_out = clCreateKernel(program, "device_fan_out", &err_ret);
+            test_error(err_ret, "clCreateKernel() failed");
+
+            auto label = [&](const char* mode, size_t bytes, int count) {
+                return std::string(mode) + "/" + flags + "/"
+                    + std::to_string(bytes) + "/" + std::to_string(count);
+            };
+            BenchmarkStats base, stats;
+            bool queue_full;
+
+            // The chain captures nothing but the result pointer and the
+            // remaining depth, so only time it once per flag
+            if (c == 0)
+            {
+                err_ret = bench.TimeDevice(chain, 0, true, 0, 0, base,
+                                           queue_full);
+                if (err_ret != CL_SUCCESS) return -1;
+                for (int depth : kChainDepths)
+                {
+                    err_ret = bench.TimeDevice(chain, depth, true, 0,
+                                               base.median, stats, queue_full);
+                    if (err_ret != CL_SUCCESS) return -1;
+                    if (queue_full)
+                    {
+                        log_info("The device queue is full at nesting depth "
+                                 "%d with %s\n",
+                                 depth, flags.c_str());
+                        break;
+                    }
+                    log_benchmark_stats("device_enqueue",
+                                        label("device_chain", 0, depth).c_str(),
+                                        "us", false, stats);
+                }
+            }
+
+            size_t bytes = capture * 4 * sizeof(cl_int);
+            err_ret = bench.TimeDevice(fan_out, 0, false, capture, 0, base,
+                                       queue_full);
+            if (err_ret != CL_SUCCESS) return -1;
+            for (int children : kFanOuts)
+            {
+                err_ret = bench.TimeDevice(fan_out, children, false, capture,
+                                           base.median, stats, queue_full);
+                if (err_ret != CL_SUCCESS) return -1;
+                if (queue_full)
+                {
+                    log_info("The device queue is full at %d children with "
+                             "%s and %zu captured bytes\n",
+                             children, flags.c_str(), bytes);
+                    break;
+                }
+                log_benchmark_stats(
+                    "device_enqueue",
+                    label("device_fan_out", bytes, children).c_str(), "us",
+                    false, stats);
+            }
+
+            if (f == 0 && c == 0)
+            {
+                clKernelWrapper host_child =
+                    clCreateKernel(program, "host_child", &err_ret);
+                test_error(err_ret, "clCreateKernel() failed");
+                err_ret = bench.TimeHost(host_child, true, stats);
+                if (err_ret != CL_SUCCESS) return -1;
+                std::string host_label =
+                    "host_round_trip/-/0/" + std::to_string(kHostLaunches);
+                log_benchmark_stats("device_enqueue", host_label.c_str(), "us",
+                                    false, stats);
+                err_ret = bench.TimeHost(host_child, false, stats);
+                if (err_ret != CL_SUCCESS) return -1;
+                host_label =
+                    "host_pipelined/-/0/" + std::to_string(kHostLaunches);
+                log_benchmark_stats("device_enqueue", host_label.c_str(), "us",
+                                    false, stats);
+            }
+        }
+    }
+
+    return 0;
+}
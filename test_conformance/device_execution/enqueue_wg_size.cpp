@@ -18,6 +18,8 @@
 #include "harness/testHarness.h"
 #include "harness/typeWrappers.h"
 
+#include <algorithm>
+#include <string>
 #include <vector>
 
 #include "procs.h"
@@ -1637,6 +1639,71 @@ static const kernel_src_check sources_enqueue_wg_size[] =
     { KERNEL(enqueue_mix_wg_size_all_diff), check_all_diff_mix }
 };
 
+// The configurations are built in groups of this many per program, and each
+// group is launched from one parent kernel so that the whole group costs a
+// single host enqueue and read back
+static const size_t kConfigsPerProgram = 5;
+
+static void replace_all(std::string& str, const std::string& from,
+                        const std::string& to)
+{
+    for (size_t pos = str.find(from); pos != std::string::npos;
+         pos = str.find(from, pos + to.size()))
+        str.replace(pos, from.size(), to);
+}
+
+// Every configuration's source with its kernel turned into a plain function
+// and its block_fn renamed, so that they can share a program, followed by a
+// parent kernel that runs them one after the other. Each configuration gets
+// the top-level NDRange the host used to launch it with, and its own slice
+// of the results and random numbers.
+static std::string
+batch_program_source(const std::vector<const kernel_src_check*>& configs)
+{
+    std::string source;
+    for (size_t j = 0; j < configs.size(); ++j)
+    {
+        std::string config;
+        for (unsigned int i = 0; i < configs[j]->src.num_lines; ++i)
+            config += configs[j]->src.lines[i];
+        replace_all(config, "kernel void ", "void ");
+        replace_all(config, "block_fn", "block_fn_" + std::to_string(j));
+        source += config;
+    }
+
+    source += NL "kernel void enqueue_wg_size_batch(__global int* res, "
+              "int level, int maxGlobalWorkSize, __global int* rnd, "
+              "__global int* status, int localSize)"
+              NL "{"
+              NL "  queue_t def_q = get_default_queue();"
+              NL "  clk_event_t prev_evt;";
+    for (size_t j = 0; j < configs.size(); ++j)
+    {
+        std::string index = std::to_string(j);
+        std::string wait = j ? "1, &prev_evt" : "0, NULL";
+        source += NL "  {"
+                  NL "    void (^configBlock)(void) = ^{ "
+            + std::string(configs[j]->src.kernel_name) + "(res + " + index
+            + " * maxGlobalWorkSize, level, maxGlobalWorkSize, rnd + " + index
+            + " * maxGlobalWorkSize); };"
+              NL "    size_t ls = min((size_t)localSize, "
+              "(size_t)get_kernel_work_group_size(configBlock));"
+              NL "    clk_event_t evt;"
+              NL "    int enq_res = enqueue_kernel(def_q, "
+              "CLK_ENQUEUE_FLAGS_NO_WAIT, ndrange_1D(maxGlobalWorkSize, ls), "
+            + wait + ", &evt, configBlock);"
+              NL "    status[" + index + "] = enq_res;"
+            + (j ? NL "    release_event(prev_evt);" : "")
+            + NL "    if(enq_res != CLK_SUCCESS) return;"
+              NL "    prev_evt = evt;"
+              NL "  }";
+    }
+    source += NL "  release_event(prev_evt);"
+              NL "}"
+              NL;
+    return source;
+}
+
 int test_enqueue_wg_size(cl_device_id device, cl_context context, cl_command_queue queue, int num_elements)
 {
     MTdata d;
@@ -1644,8 +1711,6 @@ int test_enqueue_wg_size(cl_device_id device, cl_context context, cl_command_que
     cl_int err_ret, res = 0;
     clCommandQueueWrapper dev_queue;
     const cl_int MAX_GLOBAL_WORK_SIZE = MAX_GWS / 4;
-    cl_int kernel_results[MAX_GLOBAL_WORK_SIZE] = { 0 };
-    cl_uint vrnd[MAX_GLOBAL_WORK_SIZE] = { 0 };
 
     size_t ret_len;
     cl_uint max_queues = 1;
@@ -1681,61 +1746,116 @@ int test_enqueue_wg_size(cl_device_id device, cl_context context, cl_command_que
                "clCreateCommandQueueWithProperties(CL_QUEUE_ON_DEVICE | "
                "CL_QUEUE_ON_DEVICE_DEFAULT) failed");
 
-
-    size_t failCnt = 0;
+    std::vector<const kernel_src_check*> selected;
     for(k = 0; k < arr_size(sources_enqueue_wg_size); ++k)
     {
         if (!gKernelName.empty() && gKernelName != sources_enqueue_wg_size[k].src.kernel_name)
             continue;
+        selected.push_back(&sources_enqueue_wg_size[k]);
+    }
 
-        log_info("Running '%s' kernel (%d of %zu) ...\n",
-                 sources_enqueue_wg_size[k].src.kernel_name, k + 1,
-                 arr_size(sources_enqueue_wg_size));
-        for(i = 0; i < MAX_GLOBAL_WORK_SIZE; ++i)
+    cl_int global_size = MAX_GLOBAL_WORK_SIZE;
+    cl_int local_size = (max_local_size > (size_t)global_size) ? global_size : (cl_int)max_local_size;
+
+    size_t failCnt = 0;
+    for (size_t first = 0; first < selected.size(); first += kConfigsPerProgram)
+    {
+        std::vector<const kernel_src_check*> configs(
+            selected.begin() + first,
+            selected.begin() + std::min(first + kConfigsPerProgram, selected.size()));
+
+        log_info("Running kernels %zu to %zu of %zu (%s to %s) ...\n",
+                 first + 1, first + configs.size(), selected.size(),
+                 configs.front()->src.kernel_name,
+                 configs.back()->src.kernel_name);
+
+        // Fill some elements of each configuration's numbers with primes
+        std::vector<cl_uint> vrnd(configs.size() * MAX_GLOBAL_WORK_SIZE);
+        for (size_t j = 0; j < configs.size(); ++j)
         {
-            kernel_results[i] = 0;
-            vrnd[i] = genrand_int32(d);
-        }
+            cl_uint* config_rnd = &vrnd[j * MAX_GLOBAL_WORK_SIZE];
+            for(i = 0; i < MAX_GLOBAL_WORK_SIZE; ++i)
+            {
+                config_rnd[i] = genrand_int32(d);
+            }
 
-        // Fill some elements with prime numbers
-        cl_uint prime[] = { 3,   5,   7,  11,  13,  17,  19,  23,
-            29,  31,  37,  41,  43,  47,  53,  59,
-            61,  67,  71,  73,  79,  83,  89,  97,
-            101, 103, 107, 109, 113, 127 };
+            cl_uint prime[] = { 3,   5,   7,  11,  13,  17,  19,  23,
+                29,  31,  37,  41,  43,  47,  53,  59,
+                61,  67,  71,  73,  79,  83,  89,  97,
+                101, 103, 107, 109, 113, 127 };
+
+            for(i = 0; i < arr_size(prime); ++i)
+            {
+                config_rnd[genrand_int32(d) % MAX_GLOBAL_WORK_SIZE] = prime[i];
+            }
+        }
 
-        for(i = 0; i < arr_size(prime); ++i)
+        std::string source = batch_program_source(configs);
+        const char* source_ptr = source.c_str();
+        clProgramWrapper program;
+        clKernelWrapper kernel;
+        err_ret = create_single_kernel_helper(context, &program, &kernel, 1,
+                                              &source_ptr,
+                                              "enqueue_wg_size_batch");
+        if (check_error(err_ret, "Create batch kernel failed"))
         {
-            vrnd[genrand_int32(d) % MAX_GLOBAL_WORK_SIZE] = prime[i];
+            failCnt += configs.size();
+            res = -1;
+            continue;
         }
 
-        clMemWrapper mem;
-        mem = clCreateBuffer(context, CL_MEM_READ_ONLY|CL_MEM_COPY_HOST_PTR, sizeof(vrnd), vrnd, &err_ret);
+        std::vector<cl_int> kernel_results(vrnd.size(), 0);
+        std::vector<cl_int> status(configs.size(), CL_SUCCESS);
+        clMemWrapper res_mem, rnd_mem, status_mem;
+        res_mem = clCreateBuffer(context, CL_MEM_READ_WRITE|CL_MEM_COPY_HOST_PTR, kernel_results.size() * sizeof(cl_int), kernel_results.data(), &err_ret);
+        test_error(err_ret, "clCreateBuffer() failed");
+        rnd_mem = clCreateBuffer(context, CL_MEM_READ_ONLY|CL_MEM_COPY_HOST_PTR, vrnd.size() * sizeof(cl_uint), vrnd.data(), &err_ret);
+        test_error(err_ret, "clCreateBuffer() failed");
+        status_mem = clCreateBuffer(context, CL_MEM_READ_WRITE|CL_MEM_COPY_HOST_PTR, status.size() * sizeof(cl_int), status.data(), &err_ret);
         test_error(err_ret, "clCreateBuffer() failed");
 
-        kernel_arg args[] =
+        err_ret = clSetKernelArg(kernel, 0, sizeof(res_mem), &res_mem);
+        err_ret |= clSetKernelArg(kernel, 1, sizeof(nestingLevel), &nestingLevel);
+        err_ret |= clSetKernelArg(kernel, 2, sizeof(global_size), &global_size);
+        err_ret |= clSetKernelArg(kernel, 3, sizeof(rnd_mem), &rnd_mem);
+        err_ret |= clSetKernelArg(kernel, 4, sizeof(status_mem), &status_mem);
+        err_ret |= clSetKernelArg(kernel, 5, sizeof(local_size), &local_size);
+        test_error(err_ret, "clSetKernelArg() failed");
+
+        size_t one = 1;
+        clEventWrapper event;
+        err_ret = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &one, &one, 0, NULL, &event);
+        if (!check_error(err_ret, "clEnqueueNDRangeKernel('enqueue_wg_size_batch') failed"))
         {
-            { sizeof(cl_uint), &nestingLevel },
-            { sizeof(cl_uint), &MAX_GLOBAL_WORK_SIZE },
-            { sizeof(cl_mem),  &mem }
-        };
-
-        size_t global_size = MAX_GLOBAL_WORK_SIZE;
-        size_t local_size = (max_local_size > global_size) ? global_size : max_local_size;
-
-        err_ret = run_n_kernel_args(context, queue, sources_enqueue_wg_size[k].src.lines, sources_enqueue_wg_size[k].src.num_lines, sources_enqueue_wg_size[k].src.kernel_name, local_size, global_size, kernel_results, sizeof(kernel_results), arr_size(args), args);
+            err_ret = clEnqueueReadBuffer(queue, res_mem, CL_FALSE, 0, kernel_results.size() * sizeof(cl_int), kernel_results.data(), 0, NULL, NULL);
+            test_error(err_ret, "clEnqueueReadBuffer() failed");
+            err_ret = clEnqueueReadBuffer(queue, status_mem, CL_TRUE, 0, status.size() * sizeof(cl_int), status.data(), 0, NULL, NULL);
+            test_error(err_ret, "clEnqueueReadBuffer() failed");
+
+            cl_int exec_status;
+            err_ret = clGetEventInfo(event, CL_EVENT_COMMAND_EXECUTION_STATUS, sizeof(exec_status), &exec_status, &ret_len);
+            test_error(err_ret, "clGetEventInfo() failed");
+            // CL_COMPLETE and CL_SUCCESS are both 0x0
+            err_ret = exec_status;
+        }
 
-        //check results
-        int fail = sources_enqueue_wg_size[k].check(kernel_results, global_size, nestingLevel);
+        //check results of every configuration in the batch together
+        for (size_t j = 0; j < configs.size(); ++j)
+        {
+            const char* name = configs[j]->src.kernel_name;
+            int fail = configs[j]->check(&kernel_results[j * MAX_GLOBAL_WORK_SIZE], global_size, nestingLevel);
 
-        if(check_error(err_ret, "'%s' kernel execution failed", sources_enqueue_wg_size[k].src.kernel_name)) { ++failCnt; res = -1; continue; }
-        else if(fail >= 0 && check_error(-1, "'%s' kernel results validation failed: [%d]", sources_enqueue_wg_size[k].src.kernel_name, fail)) { ++failCnt; res = -1; continue; }
-        else log_info("'%s' kernel is OK.\n", sources_enqueue_wg_size[k].src.kernel_name);
+            if(check_error(err_ret, "'%s' kernel execution failed", name)) { ++failCnt; res = -1; continue; }
+            else if(status[j] != CL_SUCCESS && check_error(-1, "'%s' kernel could not be enqueued by the batch: %d", name, status[j])) { ++failCnt; res = -1; continue; }
+            else if(fail >= 0 && check_error(-1, "'%s' kernel results validation failed: [%d]", name, fail)) { ++failCnt; res = -1; continue; }
+            else log_info("'%s' kernel is OK.\n", name);
+        }
     }
 
     if (failCnt > 0)
     {
         log_error("ERROR: %zu of %zu kernels failed.\n", failCnt,
-                  arr_size(sources_enqueue_wg_size));
+                  selected.size());
     }
 
     free_mtdata(d);
@@ -0,0 +1,424 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include <stdio.h>
+#include <string.h>
+#include "harness/testHarness.h"
+#include "harness/typeWrappers.h"
+#include "harness/benchmark.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "procs.h"
+#include "utils.h"
+
+// Probe of how much work submitted to separate host queues really runs at
+// the same time. Kernels of a known duration are launched on K queues and
+// the profiling intervals give the achieved overlap, which for kernels that
+// are too small to fill the device is the number of them the device runs
+// concurrently. A benchmark, so it only runs when named.
+
+static const char* queue_overlap_spin = R"(
+    kernel void queue_overlap_spin(__global uint* res, uint iterations)
+    {
+      uint x = get_global_id(0);
+      for (uint i = 0; i < iterations; i++) x = x * 1664525u + 1013904223u;
+      res[get_global_id(0)] = x;
+    })";
+
+static const cl_uint kQueueCounts[] = { 1, 2, 4, 8 };
+static const cl_uint kKernelsPerQueue = 2;
+// Launches are a single work-group long enough for the launch overhead not
+// to matter, and transfers are sized to take about as long.
+static const double kTargetKernelMs = 20.0;
+static const size_t kTransferBytes = 32 * 1024 * 1024;
+
+namespace {
+
+struct Interval
+{
+    cl_ulong start;
+    cl_ulong end;
+};
+
+cl_int get_interval(cl_event event, Interval& interval)
+{
+    cl_int err_ret =
+        clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START,
+                                sizeof(interval.start), &interval.start, NULL);
+    test_error(err_ret, "clGetEventProfilingInfo() failed");
+    err_ret =
+        clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END,
+                                sizeof(interval.end), &interval.end, NULL);
+    test_error(err_ret, "clGetEventProfilingInfo() failed");
+    if (interval.end < interval.start) interval.end = interval.start;
+    return CL_SUCCESS;
+}
+
+// Summed busy time over the time the commands span: 1 when they ran one
+// after another, K when K of them ran entirely side by side.
+double overlap_factor(const std::vector<Interval>& intervals)
+{
+    cl_ulong first = intervals[0].start, last = intervals[0].end, busy = 0;
+    for (const Interval& interval : intervals)
+    {
+        first = std::min(first, interval.start);
+        last = std::max(last, interval.end);
+        busy += interval.end - interval.start;
+    }
+    return last > first ? (double)busy / (double)(last - first) : 1.0;
+}
+
+// Fraction of the shorter of two commands that ran alongside the other
+double pair_overlap(const Interval& a, const Interval& b)
+{
+    cl_ulong start = std::max(a.start, b.start);
+    cl_ulong end = std::min(a.end, b.end);
+    cl_ulong shorter = std::min(a.end - a.start, b.end - b.start);
+    if (end <= start || shorter == 0) return 0.0;
+    return (double)(end - start) / (double)shorter;
+}
+
+enum OverlapCommand
+{
+    kCommandKernel,
+    kCommandWrite,
+    kCommandRead,
+    kCommandCopy,
+    kNumOverlapCommands
+};
+
+const char* kCommandNames[kNumOverlapCommands] = { "kernel", "write", "read",
+                                                   "copy" };
+
+struct OverlapProbe
+{
+    cl_context context;
+    cl_device_id device;
+    clProgramWrapper program;
+    clKernelWrapper kernel;
+    clMemWrapper res_mem;
+    size_t local_size;
+    cl_uint iterations;
+
+    // One set of transfer buffers per queue of a pair, so two transfers of
+    // the same kind don't touch the same memory
+    size_t transfer_size;
+    clMemWrapper src_mem[2], dst_mem[2];
+    std::vector<char> host_data[2];
+
+    cl_int Setup(cl_device_id dev, cl_context ctx)
+    {
+        cl_int err_ret;
+        device = dev;
+        context = ctx;
+
+        err_ret = create_single_kernel_helper(context, &program, &kernel, 1,
+                                              &queue_overlap_spin,
+                                              "queue_overlap_spin");
+        test_error(err_ret, "Create single kernel failed");
+
+        err_ret = get_max_allowed_1d_work_group_size_on_device(device, kernel,
+                                                               &local_size);
+        test_error(err_ret, "Unable to get work-group size");
+        local_size = std::min(local_size, (size_t)64);
+
+        // Each queue's launches write their own part of the results
+        size_t res_size = sizeof(cl_uint) * local_size * kKernelsPerQueue
+            * kQueueCounts[arr_size(kQueueCounts) - 1];
+        res_mem = clCreateBuffer(context, CL_MEM_READ_WRITE, res_size, NULL,
+                                 &err_ret);
+        test_error(err_ret, "clCreateBuffer() failed");
+
+        err_ret = clSetKernelArg(kernel, 0, sizeof(res_mem), &res_mem);
+        test_error(err_ret, "clSetKernelArg(0) failed");
+
+        cl_ulong max_alloc;
+        err_ret = clGetDeviceInfo(device, CL_DEVICE_MAX_MEM_ALLOC_SIZE,
+                                  sizeof(max_alloc), &max_alloc, NULL);
+        test_error(err_ret, "clGetDeviceInfo(CL_DEVICE_MAX_MEM_ALLOC_SIZE) "
+                            "failed");
+        transfer_size = (size_t)std::min((cl_ulong)kTransferBytes, max_alloc);
+
+        for (int i = 0; i < 2; i++)
+        {
+            src_mem[i] = clCreateBuffer(context, CL_MEM_READ_WRITE,
+                                        transfer_size, NULL, &err_ret);
+            test_error(err_ret, "clCreateBuffer() failed");
+            dst_mem[i] = clCreateBuffer(context, CL_MEM_READ_WRITE,
+                                        transfer_size, NULL, &err_ret);
+            test_error(err_ret, "clCreateBuffer() failed");
+            host_data[i].assign(transfer_size, (char)i);
+        }
+
+        return CL_SUCCESS;
+    }
+
+    cl_int EnqueueSpin(cl_command_queue queue, size_t slot, cl_event* event)
+    {
+        cl_int err_ret =
+            clSetKernelArg(kernel, 1, sizeof(iterations), &iterations);
+        test_error(err_ret, "clSetKernelArg(1) failed");
+
+        size_t offset = slot * local_size;
+        err_ret = clEnqueueNDRangeKernel(queue, kernel, 1, &offset,
+                                         &local_size, &local_size, 0, NULL,
+                                         event);
+        test_error(err_ret, "clEnqueueNDRangeKernel() failed");
+        return CL_SUCCESS;
+    }
+
+    cl_int EnqueueCommand(cl_command_queue queue, OverlapCommand command,
+                          int side, cl_event* event)
+    {
+        cl_int err_ret = CL_SUCCESS;
+        switch (command)
+        {
+            case kCommandKernel: return EnqueueSpin(queue, side, event);
+            case kCommandWrite:
+                err_ret = clEnqueueWriteBuffer(
+                    queue, src_mem[side], CL_FALSE, 0, transfer_size,
+                    host_data[side].data(), 0, NULL, event);
+                break;
+            case kCommandRead:
+                err_ret = clEnqueueReadBuffer(queue, dst_mem[side], CL_FALSE,
+                                              0, transfer_size,
+                                              host_data[side].data(), 0, NULL,
+                                              event);
+                break;
+            case kCommandCopy:
+                err_ret = clEnqueueCopyBuffer(queue, src_mem[side],
+                                              dst_mem[side], 0, 0,
+                                              transfer_size, 0, NULL, event);
+                break;
+            default: break;
+        }
+        test_error(err_ret, "Unable to enqueue command");
+        return CL_SUCCESS;
+    }
+
+    // Scale the loop until one launch takes about kTargetKernelMs
+    cl_int Calibrate(cl_command_queue queue)
+    {
+        iterations = 1024;
+        for (;;)
+        {
+            clEventWrapper event;
+            cl_int err_ret = EnqueueSpin(queue, 0, &event);
+            if (err_ret != CL_SUCCESS) return err_ret;
+            err_ret = clWaitForEvents(1, &event);
+            test_error(err_ret, "clWaitForEvents() failed");
+
+            Interval interval;
+            err_ret = get_interval(event, interval);
+            if (err_ret != CL_SUCCESS) return err_ret;
+
+            double ms = (interval.end - interval.start) / 1e6;
+            if (ms >= kTargetKernelMs / 4 || iterations >= (1u << 30))
+            {
+                double scale = ms > 0 ? kTargetKernelMs / ms : 1.0;
+                iterations = (cl_uint)std::min(
+                    (double)(1u << 31), std::max(1.0, iterations * scale));
+                log_info("Spin kernel calibrated to %u iterations.\n",
+                         iterations);
+                return CL_SUCCESS;
+            }
+            iterations *= 4;
+        }
+    }
+};
+
+cl_int create_profiling_queues(cl_context context, cl_device_id device,
+                               cl_command_queue_properties props, cl_uint n,
+                               std::vector<clCommandQueueWrapper>& queues)
+{
+    cl_queue_properties queue_prop_def[] = {
+        CL_QUEUE_PROPERTIES, props | CL_QUEUE_PROFILING_ENABLE, 0
+    };
+
+    queues.resize(n);
+    for (cl_uint i = 0; i < n; i++)
+    {
+        cl_int err_ret;
+        queues[i] = clCreateCommandQueueWithProperties(
+            context, device, queue_prop_def, &err_ret);
+        test_error(err_ret, "clCreateCommandQueueWithProperties() failed");
+    }
+    return CL_SUCCESS;
+}
+
+// Every sample launches seconds of kernels, so take few of them
+BenchmarkOptions overlap_options()
+{
+    BenchmarkOptions options;
+    options.warmup = 1;
+    options.minSamples = 3;
+    options.maxSeconds = 1.0;
+    return options;
+}
+
+// Overlap factor of kKernelsPerQueue launches on each of n queues.
+// Interference can only lower what is achieved, so the best sample is
+// closest to what the device can do.
+cl_int measure_kernel_overlap(OverlapProbe& probe, cl_uint n,
+                              cl_command_queue_properties props,
+                              BenchmarkStats& stats)
+{
+    std::vector<clCommandQueueWrapper> queues;
+    cl_int err_ret =
+        create_profiling_queues(probe.context, probe.device, props, n, queues);
+    if (err_ret != CL_SUCCESS) return err_ret;
+
+    auto sample = [&](double* factor) -> cl_int {
+        std::vector<clEventWrapper> events(n * kKernelsPerQueue);
+        for (cl_uint k = 0; k < kKernelsPerQueue; k++)
+        {
+            for (cl_uint q = 0; q < n; q++)
+            {
+                size_t slot = k * n + q;
+                err_ret = probe.EnqueueSpin(queues[q], slot, &events[slot]);
+                if (err_ret != CL_SUCCESS) return err_ret;
+            }
+        }
+        for (cl_uint q = 0; q < n; q++)
+        {
+            err_ret = clFlush(queues[q]);
+            test_error(err_ret, "clFlush() failed");
+        }
+
+        std::vector<Interval> intervals(events.size());
+        for (size_t i = 0; i < events.size(); i++)
+        {
+            err_ret = clWaitForEvents(1, &events[i]);
+            test_error(err_ret, "clWaitForEvents() failed");
+            err_ret = get_interval(events[i], intervals[i]);
+            if (err_ret != CL_SUCCESS) return err_ret;
+        }
+        *factor = overlap_factor(intervals);
+        return CL_SUCCESS;
+    };
+    return run_benchmark(overlap_options(), sample, &stats);
+}
+
+cl_int measure_pair_overlap(OverlapProbe& probe, OverlapCommand a,
+                            OverlapCommand b, BenchmarkStats& stats)
+{
+    std::vector<clCommandQueueWrapper> queues;
+    cl_int err_ret =
+        create_profiling_queues(probe.context, probe.device, 0, 2, queues);
+    if (err_ret != CL_SUCCESS) return err_ret;
+
+    auto sample = [&](double* overlap) -> cl_int {
+        clEventWrapper events[2];
+        err_ret = probe.EnqueueCommand(queues[0], a, 0, &events[0]);
+        if (err_ret != CL_SUCCESS) return err_ret;
+        err_ret = probe.EnqueueCommand(queues[1], b, 1, &events[1]);
+        if (err_ret != CL_SUCCESS) return err_ret;
+        for (int i = 0; i < 2; i++)
+        {
+            err_ret = clFlush(queues[i]);
+            test_error(err_ret, "clFlush() failed");
+        }
+
+        Interval intervals[2];
+        for (int i = 0; i < 2; i++)
+        {
+            err_ret = clWaitForEvents(1, &events[i]);
+            test_error(err_ret, "clWaitForEvents() failed");
+            err_ret = get_interval(events[i], intervals[i]);
+            if (err_ret != CL_SUCCESS) return err_ret;
+        }
+        *overlap = pair_overlap(intervals[0], intervals[1]);
+        return CL_SUCCESS;
+    };
+    return run_benchmark(overlap_options(), sample, &stats);
+}
+
+} // anonymous namespace
+
+int test_host_queue_overlap(cl_device_id device, cl_context context,
+                            cl_command_queue queue, int num_elements)
+{
+    OverlapProbe probe;
+    cl_int err_ret = probe.Setup(device, context);
+    if (err_ret != CL_SUCCESS) return -1;
+
+    {
+        std::vector<clCommandQueueWrapper> queues;
+        err_ret = create_profiling_queues(context, device, 0, 1, queues);
+        if (err_ret != CL_SUCCESS) return -1;
+        err_ret = probe.Calibrate(queues[0]);
+        if (err_ret != CL_SUCCESS) return -1;
+    }
+
+    cl_command_queue_properties host_props = 0;
+    err_ret = clGetDeviceInfo(device, CL_DEVICE_QUEUE_ON_HOST_PROPERTIES,
+                              sizeof(host_props), &host_props, NULL);
+    test_error(err_ret,
+               "clGetDeviceInfo(CL_DEVICE_QUEUE_ON_HOST_PROPERTIES) failed");
+
+    log_benchmark_header("kernel_overlap", "queue/queues");
+    double best = 1.0;
+    for (int ooo = 0; ooo < 2; ooo++)
+    {
+        cl_command_queue_properties props =
+            ooo ? CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE : 0;
+        if ((host_props & props) != props)
+        {
+            log_info("Device doesn't support out-of-order queues, skipping "
+                     "them.\n");
+            continue;
+        }
+
+        for (cl_uint n : kQueueCounts)
+        {
+            BenchmarkStats stats;
+            err_ret = measure_kernel_overlap(probe, n, props, stats);
+            if (err_ret != CL_SUCCESS) return -1;
+
+            std::string label = std::string(ooo ? "out_of_order" : "in_order")
+                + "/" + std::to_string(n);
+            log_benchmark_stats("kernel_overlap", label.c_str(), "x", true,
+                                stats);
+            best = std::max(best, stats.max);
+        }
+    }
+
+    log_benchmark_header("pair_overlap", "first/second");
+    for (int a = 0; a < kNumOverlapCommands; a++)
+    {
+        for (int b = a; b < kNumOverlapCommands; b++)
+        {
+            BenchmarkStats stats;
+            err_ret = measure_pair_overlap(probe, (OverlapCommand)a,
+                                           (OverlapCommand)b, stats);
+            if (err_ret != CL_SUCCESS) return -1;
+
+            std::string label =
+                std::string(kCommandNames[a]) + "/" + kCommandNames[b];
+            log_benchmark_stats("pair_overlap", label.c_str(), "fraction",
+                                true, stats);
+        }
+    }
+
+    // Launches on the same in-order queue never overlap, so anything past
+    // one came from separate queues or out-of-order execution
+    log_info("Device ran up to %.1f single work-group kernels at once, about "
+             "%u hardware queue(s).\n",
+             best, (cl_uint)(best + 0.5));
+    return 0;
+}
@@ -64,6 +64,8 @@ test_definition test_list[] = {
     ADD_TEST(enqueue_flags),         ADD_TEST(enqueue_multi_queue),
     ADD_TEST(host_multi_queue),      ADD_TEST(enqueue_ndrange),
     ADD_TEST(host_queue_order),      ADD_TEST(enqueue_profiling),
+    ADD_BENCHMARK(host_queue_overlap),
+    ADD_BENCHMARK(enqueue_bench),
 };
 
 const int test_num = ARRAY_SIZE( test_list );
@@ -14,6 +14,7 @@
 // limitations under the License.
 //
 #include "harness/testHarness.h"
+#include "harness/parseParameters.h"
 
 extern int test_device_info(cl_device_id device, cl_context context, cl_command_queue queue, int num_elements);
 extern int test_device_queue(cl_device_id device, cl_context context, cl_command_queue queue, int num_elements);
@@ -28,6 +29,10 @@ extern int test_enqueue_ndrange(cl_device_id device, cl_context context, cl_comm
 extern int test_host_queue_order(cl_device_id device, cl_context context, cl_command_queue queue, int num_elements);
 extern int test_enqueue_profiling(cl_device_id device, cl_context context,
                                   cl_command_queue queue, int num_elements);
+extern int test_host_queue_overlap(cl_device_id device, cl_context context,
+                                   cl_command_queue queue, int num_elements);
+extern int test_enqueue_bench(cl_device_id device, cl_context context,
+                              cl_command_queue queue, int num_elements);
 
 extern int test_execution_stress(cl_device_id device, cl_context context, cl_command_queue queue, int num_elements);
 
@@ -35,6 +35,7 @@ test_definition test_list[] = {
     ADD_TEST( partition_by_affinity_domain_l1_cache ),
     ADD_TEST( partition_by_affinity_domain_next_partitionable ),
     ADD_TEST( partition_all ),
+    ADD_BENCHMARK( partition_concurrent ),
 };
 
 const int test_num = ARRAY_SIZE( test_list );
@@ -27,3 +27,9 @@ extern int      test_partition_by_affinity_domain_l3_cache(cl_device_id deviceID
 extern int      test_partition_by_affinity_domain_l2_cache(cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements);
 extern int      test_partition_by_affinity_domain_l1_cache(cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements);
 extern int      test_partition_by_affinity_domain_next_partitionable(cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements);
+extern int      test_partition_concurrent(cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements);
+
+extern const char *printPartition(cl_device_partition_property partition);
+extern const char *printAffinity(cl_device_affinity_domain affinity);
+extern int      init_device_partition_test(cl_device_id parentDevice, cl_uint &maxComputeUnits, cl_uint &maxSubDevices);
+extern int      test_device_partition_type_support(cl_device_id parentDevice, const cl_device_partition_property partitionType, const cl_device_affinity_domain affinityDomain);
@@ -0,0 +1,275 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "testBase.h"
+#include "harness/typeWrappers.h"
+#include "harness/benchmark.h"
+
+#include <algorithm>
+#include <vector>
+
+// Runs the same compute-bound workload on every sub-device of a partition at
+// once, then on the sub-devices one after another, then all of it on the
+// root device, spot-checking every sub-device's results. The timings give the
+// aggregate throughput, how much of the ideal speed-up over the serial run
+// the concurrent run reaches, and how the concurrent run compares with the
+// unpartitioned root device. A driver that serializes sub-devices internally
+// shows a concurrent time no better than the serial one. Registered as a
+// benchmark, so it only runs when asked for by name.
+
+static const char *concurrent_kernel[] = {
+    "__kernel void spin(__global uint *dst, uint iterations)\n"
+    "{\n"
+    "    uint x = (uint)get_global_id(0);\n"
+    "    for (uint i = 0; i < iterations; i++)\n"
+    "        x = x * 1664525u + 1013904223u;\n"
+    "    dst[get_global_id(0) - get_global_offset(0)] = x;\n"
+    "}\n"
+};
+
+static const cl_uint kSpinIterations = 4096;
+static const size_t kMinChunk = 1 << 16;
+static const size_t kVerifyStride = 61;
+
+namespace {
+
+// One context and program over a set of devices, with a queue and an output
+// buffer per chunk of the workload
+struct ChunkRunner
+{
+    clContextWrapper context;
+    clProgramWrapper program;
+    clKernelWrapper kernel;
+    std::vector<clCommandQueueWrapper> queues;
+    std::vector<clMemWrapper> buffers;
+    size_t chunk;
+
+    int Init(const std::vector<cl_device_id> &devices, size_t chunk_size)
+    {
+        int error;
+        chunk = chunk_size;
+        context = clCreateContext(NULL, (cl_uint)devices.size(),
+                                  devices.data(), notify_callback, NULL,
+                                  &error);
+        test_error(error, "Unable to create testing context");
+        error = create_single_kernel_helper(context, &program, &kernel, 1,
+                                            concurrent_kernel, "spin");
+        test_error(error, "Unable to create the spin kernel");
+        error = clSetKernelArg(kernel, 1, sizeof(kSpinIterations),
+                               &kSpinIterations);
+        test_error(error, "Unable to set kernel arguments");
+
+        queues.resize(devices.size());
+        buffers.resize(devices.size());
+        for (size_t i = 0; i < devices.size(); i++)
+        {
+            queues[i] = clCreateCommandQueueWithProperties(context, devices[i],
+                                                           0, &error);
+            test_error(error, "Unable to create command queue");
+            buffers[i] = clCreateBuffer(context, CL_MEM_READ_WRITE,
+                                        sizeof(cl_uint) * chunk, NULL, &error);
+            test_error(error, "Unable to create output buffer");
+        }
+        return 0;
+    }
+
+    // Enqueues chunks [first, first + count) of the workload on queue q, as
+    // a single NDRange, writing into buffer q
+    int Enqueue(size_t q, size_t first, size_t count)
+    {
+        int error = clSetKernelArg(kernel, 0, sizeof(cl_mem), &buffers[q]);
+        test_error(error, "Unable to set kernel arguments");
+        size_t offset = first * chunk;
+        size_t global = count * chunk;
+        error = clEnqueueNDRangeKernel(queues[q], kernel, 1, &offset, &global,
+                                       NULL, 0, NULL, NULL);
+        test_error(error, "Kernel execution failed");
+        error = clFlush(queues[q]);
+        test_error(error, "clFlush failed");
+        return 0;
+    }
+
+    int Finish()
+    {
+        for (size_t q = 0; q < queues.size(); q++)
+        {
+            int error = clFinish(queues[q]);
+            test_error(error, "clFinish failed");
+        }
+        return 0;
+    }
+
+    // Runs chunk q on queue q for every queue, either all at once or waiting
+    // for each before starting the next, and returns the wall time
+    int Run(bool concurrent, double &ms)
+    {
+        HostTimer timer;
+        for (size_t q = 0; q < queues.size(); q++)
+        {
+            int error = Enqueue(q, q, 1);
+            if (error) return error;
+            if (!concurrent)
+            {
+                error = clFinish(queues[q]);
+                test_error(error, "clFinish failed");
+            }
+        }
+        int error = Finish();
+        if (error) return error;
+        ms = timer.elapsed_ms();
+        return 0;
+    }
+
+    // Spot-checks that buffer q holds chunk first_chunk + q. Checking every
+    // work-item would cost the host as much as the whole device run.
+    int Verify(size_t q, size_t first_chunk)
+    {
+        std::vector<cl_uint> results(chunk);
+        int error = clEnqueueReadBuffer(queues[q], buffers[q], CL_TRUE, 0,
+                                        sizeof(cl_uint) * chunk,
+                                        results.data(), 0, NULL, NULL);
+        test_error(error, "Unable to read results");
+        size_t base = (first_chunk + q) * chunk;
+        for (size_t i = 0; i < chunk; i += kVerifyStride)
+        {
+            cl_uint x = (cl_uint)(base + i);
+            for (cl_uint n = 0; n < kSpinIterations; n++)
+                x = x * 1664525u + 1013904223u;
+            if (results[i] != x)
+            {
+                log_error("ERROR: work-item %zu of chunk %zu is 0x%x, "
+                          "expected 0x%x\n",
+                          i, first_chunk + q, results[i], x);
+                return -1;
+            }
+        }
+        return 0;
+    }
+};
+
+} // anonymous namespace
+
+static int run_partition_concurrently(cl_device_id deviceID,
+                                      const cl_device_partition_property *props,
+                                      int num_elements)
+{
+    cl_uint deviceCount = 0;
+    int err = clCreateSubDevices(deviceID, props, 0, NULL, &deviceCount);
+    if (err == CL_DEVICE_PARTITION_FAILED)
+    {
+        log_info("The device %p could not be partitioned.\n", deviceID);
+        return 0;
+    }
+    test_error(err, "Failed to get number of sub-devices");
+
+    std::vector<cl_device_id> subDevices(deviceCount);
+    err = clCreateSubDevices(deviceID, props, deviceCount, subDevices.data(),
+                             &deviceCount);
+    test_error(err, "Actual creation of sub-devices failed");
+
+    size_t chunk = std::max((size_t)num_elements, kMinChunk);
+    double concurrent_ms = 0, serial_ms = 0, root_ms = 0;
+    {
+        ChunkRunner sub;
+        err = sub.Init(subDevices, chunk);
+
+        // The first run also pays for compilation and first launch
+        if (!err) err = sub.Run(true, concurrent_ms);
+        if (!err) err = sub.Run(true, concurrent_ms);
+        for (size_t q = 0; !err && q < subDevices.size(); q++)
+            err = sub.Verify(q, 0);
+        if (!err) err = sub.Run(false, serial_ms);
+        for (size_t q = 0; !err && q < subDevices.size(); q++)
+            err = sub.Verify(q, 0);
+    }
+
+    if (!err)
+    {
+        // The unpartitioned device covers all of the chunks in one NDRange
+        ChunkRunner root;
+        std::vector<cl_device_id> rootDevice(1, deviceID);
+        err = root.Init(rootDevice, chunk * deviceCount);
+        for (int pass = 0; !err && pass < 2; pass++)
+        {
+            HostTimer timer;
+            err = root.Enqueue(0, 0, 1);
+            if (!err) err = root.Finish();
+            root_ms = timer.elapsed_ms();
+        }
+        if (!err) err = root.Verify(0, 0);
+    }
+
+    for (cl_uint j = 0; j < deviceCount; j++)
+    {
+        int release = clReleaseDevice(subDevices[j]);
+        test_error(release, "Releasing sub-device failed");
+    }
+    if (err) return err;
+
+    double items = (double)chunk * deviceCount;
+    double speedup = concurrent_ms > 0 ? serial_ms / concurrent_ms : 0.0;
+    log_info("Sub-devices: %u, work-items: %.0f, concurrent %.2f ms, serial "
+             "%.2f ms, root %.2f ms\n",
+             deviceCount, items, concurrent_ms, serial_ms, root_ms);
+    log_info("Aggregate throughput %.1f Mitems/s, speed-up over serial %.2fx "
+             "(%.0f%% of ideal), %.0f%% of root device throughput\n",
+             concurrent_ms > 0 ? items / concurrent_ms / 1e3 : 0.0, speedup,
+             100.0 * speedup / deviceCount,
+             concurrent_ms > 0 ? 100.0 * root_ms / concurrent_ms : 0.0);
+    if (deviceCount > 1 && speedup < 1.1)
+        log_info("NOTE: the sub-devices appear to run one after another.\n");
+    return 0;
+}
+
+int test_partition_concurrent(cl_device_id deviceID, cl_context context,
+                              cl_command_queue queue, int num_elements)
+{
+    cl_uint maxComputeUnits;
+    cl_uint maxSubDevices;
+    if (init_device_partition_test(deviceID, maxComputeUnits, maxSubDevices)
+        != 0)
+        return -1;
+    if (maxComputeUnits <= 1) return 0;
+
+    // One compute unit per sub-device gives the widest spread, two halves
+    // the simplest split, and the affinity domains the hardware's own split
+    cl_device_partition_property partitionProp[][3] = {
+        { CL_DEVICE_PARTITION_EQUALLY, 1, 0 },
+        { CL_DEVICE_PARTITION_EQUALLY, maxComputeUnits / 2, 0 },
+        { CL_DEVICE_PARTITION_BY_AFFINITY_DOMAIN,
+          CL_DEVICE_AFFINITY_DOMAIN_NUMA, 0 },
+        { CL_DEVICE_PARTITION_BY_AFFINITY_DOMAIN,
+          CL_DEVICE_AFFINITY_DOMAIN_NEXT_PARTITIONABLE, 0 },
+    };
+
+    for (size_t i = 0; i < ARRAY_SIZE(partitionProp); i++)
+    {
+        const cl_device_partition_property *props = partitionProp[i];
+        if (test_device_partition_type_support(deviceID, props[0], props[1])
+            != 0)
+            continue;
+
+        if (props[0] == CL_DEVICE_PARTITION_BY_AFFINITY_DOMAIN)
+            log_info("Running concurrently on partition type \"%s\" \"%s\"\n",
+                     printPartition(props[0]), printAffinity(props[1]));
+        else
+            log_info("Running concurrently on partition type \"%s\" (%d)\n",
+                     printPartition(props[0]), (int)props[1]);
+
+        int err = run_partition_concurrently(deviceID, props, num_elements);
+        if (err != 0) return err;
+    }
+    return 0;
+}
@@ -25,9 +25,12 @@
 
 #include "procs.h"
 
+// The timer tests compare host and device timestamps against tolerances, so
+// they run without other tests loading the device
 test_definition test_list[] = {
     ADD_TEST( timer_resolution_queries ),
-    ADD_TEST( device_and_host_timers ),
+    ADD_TEST_SERIAL( device_and_host_timers ),
+    ADD_TEST_SERIAL( device_host_clock_correlation ),
 };
 
 test_status InitCL(cl_device_id device)
@@ -21,4 +21,9 @@ extern int test_device_and_host_timers(cl_device_id deviceID, cl_context context
 
 extern int test_timer_resolution_queries(cl_device_id deviceID, cl_context context,
                              cl_command_queue queue, int num_elements);
+
+extern int test_device_host_clock_correlation(cl_device_id deviceID,
+                                              cl_context context,
+                                              cl_command_queue queue,
+                                              int num_elements);
 #endif // #ifndef __PROCS_H__
@@ -17,6 +17,11 @@
 #include <CL/cl.h>
 #include "harness/errorHelpers.h"
 #include "harness/compat.h"
+#include "harness/clockCorrelation.h"
+#include "harness/typeWrappers.h"
+
+#include <chrono>
+#include <thread>
 
 #if !defined(_WIN32)
     #include "unistd.h" // For "sleep"
@@ -163,3 +168,80 @@ int test_timer_resolution_queries(cl_device_id deviceID, cl_context context, cl_
 
     return errors;
 }
+
+int test_device_host_clock_correlation(cl_device_id deviceID,
+                                       cl_context context,
+                                       cl_command_queue queue,
+                                       int num_elements)
+{
+    // Let the sampler pair the clocks for long enough to fit the drift
+    const int kSamplingMs = 250;
+    const int kCommands = 8;
+    // Allowed error of a converted timestamp on top of the host timer
+    // resolution
+    const cl_ulong kSlackNs = 1000000;
+
+    cl_int error = start_clock_correlation(deviceID, 10);
+    test_error(error, "start_clock_correlation failed");
+    std::this_thread::sleep_for(std::chrono::milliseconds(kSamplingMs));
+
+    ClockFit fit;
+    error = get_clock_fit(deviceID, &fit);
+    test_error(error, "get_clock_fit failed");
+    log_info("Fitted %zu clock pairs, host clock drift %.3f ppm\n",
+             fit.samples, fit.drift_ppm());
+
+    cl_platform_id platform;
+    cl_ulong resolution;
+    error = clGetDeviceInfo(deviceID, CL_DEVICE_PLATFORM, sizeof(platform),
+                            &platform, NULL);
+    test_error(error, "clGetDeviceInfo failed");
+    error = clGetPlatformInfo(platform, CL_PLATFORM_HOST_TIMER_RESOLUTION,
+                              sizeof(resolution), &resolution, NULL);
+    test_error(error, "clGetPlatformInfo failed");
+    cl_ulong slack = kSlackNs + resolution;
+
+    cl_queue_properties props[] = { CL_QUEUE_PROPERTIES,
+                                    CL_QUEUE_PROFILING_ENABLE, 0 };
+    clCommandQueueWrapper profilingQueue =
+        clCreateCommandQueueWithProperties(context, deviceID, props, &error);
+    test_error(error, "Unable to create profiling queue");
+
+    cl_uint data[256] = { 0 };
+    clMemWrapper buffer =
+        clCreateBuffer(context, CL_MEM_READ_WRITE, sizeof(data), NULL, &error);
+    test_error(error, "clCreateBuffer failed");
+
+    // Every command has to have run between the host times taken around it
+    int errors = 0;
+    for (int i = 0; i < kCommands; i++)
+    {
+        cl_ulong before, after, start, end;
+        error = clGetHostTimer(deviceID, &before);
+        test_error(error, "clGetHostTimer failed");
+        clEventWrapper event;
+        error = clEnqueueWriteBuffer(profilingQueue, buffer, CL_TRUE, 0,
+                                     sizeof(data), data, 0, NULL, &event);
+        test_error(error, "clEnqueueWriteBuffer failed");
+        error = clGetHostTimer(deviceID, &after);
+        test_error(error, "clGetHostTimer failed");
+
+        error = event_host_time(deviceID, event, CL_PROFILING_COMMAND_START,
+                                &start);
+        test_error(error, "event_host_time failed");
+        error = event_host_time(deviceID, event, CL_PROFILING_COMMAND_END,
+                                &end);
+        test_error(error, "event_host_time failed");
+
+        if (start + slack < before || end > after + slack || end < start)
+        {
+            log_error("Command %d ran from %llu to %llu in host time, outside "
+                      "of the host times %llu and %llu around it\n",
+                      i, (unsigned long long)start, (unsigned long long)end,
+                      (unsigned long long)before, (unsigned long long)after);
+            errors++;
+        }
+    }
+
+    return errors;
+}
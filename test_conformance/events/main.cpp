@@ -57,6 +57,8 @@ test_definition test_list[] = {
     ADD_TEST(callbacks),
     ADD_TEST(callbacks_simultaneous),
     ADD_TEST(userevents_multithreaded),
+    ADD_BENCHMARK_VERSION(event_latency, Version(1, 2)),
+    ADD_BENCHMARK(userevents_signal_scaling),
 };
 
 const int test_num = ARRAY_SIZE(test_list);
@@ -17,6 +17,7 @@
 #include "harness/kernelHelpers.h"
 #include "harness/typeWrappers.h"
 #include "harness/clImageHelper.h"
+#include "harness/parseParameters.h"
 
 extern float random_float(float low, float high);
 extern float calculate_ulperror(float a, float b);
@@ -116,3 +117,9 @@ extern int test_userevents_multithreaded(cl_device_id deviceID,
                                          cl_context context,
                                          cl_command_queue queue,
                                          int num_elements);
+extern int test_event_latency(cl_device_id deviceID, cl_context context,
+                              cl_command_queue queue, int num_elements);
+extern int test_userevents_signal_scaling(cl_device_id deviceID,
+                                          cl_context context,
+                                          cl_command_queue queue,
+                                          int num_elements);
@@ -208,7 +208,7 @@ int test_callbacks(cl_device_id deviceID, cl_context context,
 
 #define SIMUTANEOUS_ACTION_TOTAL 18
 static bool sSimultaneousFlags[54]; // for 18 actions with 3 callback status
-static volatile int sSimultaneousCount;
+static AtomicCounter<int> sSimultaneousCount;
 
 Action *actions[19] = { 0 };
 
@@ -223,7 +223,7 @@ void CL_CALLBACK simultaneous_event_callback_function(cl_event event,
     log_info("\tEvent callback triggered for action %s callback type %s \n",
              actions[actionIndex]->GetName(), IGetStatusString(statusIndex));
     sSimultaneousFlags[actionIndex] = true;
-    ThreadPool_AtomicAdd(&sSimultaneousCount, 1);
+    sSimultaneousCount.increment();
 }
 
 int test_callbacks_simultaneous(cl_device_id deviceID, cl_context context,
@@ -275,7 +275,7 @@ int test_callbacks_simultaneous(cl_device_id deviceID, cl_context context,
         test_error(error, "Unable to set up test action");
         sSimultaneousFlags[index] = false;
     }
-    sSimultaneousCount = 0;
+    sSimultaneousCount.reset();
 
     // Set up the user event to start them all
     clEventWrapper gateEvent = clCreateUserEvent(context, &error);
@@ -329,10 +329,10 @@ int test_callbacks_simultaneous(cl_device_id deviceID, cl_context context,
     // Note: we can check our callback now, and it MIGHT have been triggered,
     // but that's not guaranteed
     int last_count = 0;
-    if (((last_count = sSimultaneousCount)) == total_callbacks)
+    if (((last_count = sSimultaneousCount.load())) == total_callbacks)
     {
         // We're all good, so return success
-        log_info("\t%d of %d callbacks received\n", sSimultaneousCount,
+        log_info("\t%d of %d callbacks received\n", last_count,
                  total_callbacks);
 
         if (actionEvents) delete[] actionEvents;
@@ -349,7 +349,7 @@ int test_callbacks_simultaneous(cl_device_id deviceID, cl_context context,
     for (int i = 0; i < 10 * 10; i++)
     {
         usleep(100000); // 1/10th second
-        if (((last_count = sSimultaneousCount)) == total_callbacks)
+        if (((last_count = sSimultaneousCount.load())) == total_callbacks)
         {
             // All of the callbacks were executed
             if (actionEvents) delete[] actionEvents;
@@ -15,6 +15,9 @@
 //
 #include "testBase.h"
 #include "harness/testHarness.h"
+#include "harness/contextPool.h"
+
+#include <memory>
 
 const char *write_kernels[] = {
     "__kernel void write_up(__global int *dst, int length)\n"
@@ -62,6 +65,7 @@ int test_event_enqueue_wait_for_events_run_test(
     clCommandQueueWrapper queueWrappers[2]; // If they are different, we use the
                                             // wrapper so it will auto release
     clContextWrapper context_to_use;
+    std::unique_ptr<PooledContext> pooled;
     clMemWrapper data;
     clProgramWrapper program;
     clKernelWrapper kernel1[TEST_COUNT], kernel2[TEST_COUNT];
@@ -126,17 +130,19 @@ int test_event_enqueue_wait_for_events_run_test(
 
         log_info("\tTesting with two devices.\n");
     }
-    else
+
+    // If we are using two queues then create them
+    cl_command_queue_properties props = CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE;
+    if (!two_devices)
     {
-        context_to_use =
-            clCreateContext(NULL, 1, &deviceID, NULL, NULL, &error);
-        test_error(error, "clCreateContext failed for one device.");
+        // The single device context and its first queue come from the pool
+        // shared by all the variants of this test.
+        pooled.reset(new PooledContext(deviceID, props));
+        test_error(pooled->status(), "Unable to get a context for one device.");
+        context_to_use = pooled->context();
 
         log_info("\tTesting with one device.\n");
     }
-
-    // If we are using two queues then create them
-    cl_command_queue_properties props = CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE;
     if (two_queues)
     {
         // Get a second queue
@@ -166,9 +172,7 @@ int test_event_enqueue_wait_for_events_run_test(
         {
             // Single device has already been checked for out-of-order exec
             // support
-            queueWrappers[0] =
-                clCreateCommandQueue(context_to_use, deviceID, props, &error);
-            test_error(error, "clCreateCommandQueue for first queue failed.");
+            queueWrappers[0] = pooled->queue();
             queueWrappers[1] =
                 clCreateCommandQueue(context_to_use, deviceID, props, &error);
             test_error(error, "clCreateCommandQueue for second queue failed.");
@@ -184,9 +188,7 @@ int test_event_enqueue_wait_for_events_run_test(
         // (Note: single device has already been checked for out-of-order exec
         // support) Otherwise create one queue and have the second one be the
         // same
-        queueWrappers[0] =
-            clCreateCommandQueue(context_to_use, deviceID, props, &error);
-        test_error(error, "clCreateCommandQueue for first queue failed.");
+        queueWrappers[0] = pooled->queue();
         queues[0] = queueWrappers[0];
         queues[1] = (cl_command_queue)queues[0];
         log_info("\tTesting with one queue.\n");
@@ -334,10 +334,10 @@ int test_event_wait_for_execute(cl_device_id deviceID, cl_context context,
 int test_event_wait_for_array(cl_device_id deviceID, cl_context context,
                               cl_command_queue queue, int num_elements)
 {
-    cl_mem streams[2];
+    clMemWrapper streams[2];
     cl_float readArray[1024 * 32];
     cl_float writeArray[1024 * 32];
-    cl_event events[2];
+    clEventArray<2> events;
     int error;
     cl_int status;
 
@@ -385,7 +385,7 @@ int test_event_wait_for_array(cl_device_id deviceID, cl_context context,
     }
 
     /* Now try waiting for both */
-    error = clWaitForEvents(2, events);
+    error = clWaitForEvents(events.size(), events.data());
     test_error(error, "Unable to wait for array events");
 
     /* Double check status on both */
@@ -411,11 +411,6 @@ int test_event_wait_for_array(cl_device_id deviceID, cl_context context,
         return -1;
     }
 
-    clReleaseMemObject(streams[0]);
-    clReleaseMemObject(streams[1]);
-    clReleaseEvent(events[0]);
-    clReleaseEvent(events[1]);
-
     return 0;
 }
 
@@ -501,10 +496,10 @@ int test_event_finish_execute(cl_device_id deviceID, cl_context context,
 int test_event_finish_array(cl_device_id deviceID, cl_context context,
                             cl_command_queue queue, int num_elements)
 {
-    cl_mem streams[2];
+    clMemWrapper streams[2];
     cl_float readArray[1024 * 32];
     cl_float writeArray[1024 * 32];
-    cl_event events[2];
+    clEventArray<2> events;
     int error;
     cl_int status;
 
@@ -578,11 +573,6 @@ int test_event_finish_array(cl_device_id deviceID, cl_context context,
         return -1;
     }
 
-    clReleaseMemObject(streams[0]);
-    clReleaseMemObject(streams[1]);
-    clReleaseEvent(events[0]);
-    clReleaseEvent(events[1]);
-
     return 0;
 }
 
@@ -0,0 +1,308 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "testBase.h"
+#include "action_classes.h"
+#include "harness/benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Latencies of commands and events on in-order and out-of-order queues. A
+// benchmark, so it only runs when named.
+
+static const cl_uint kFanInDepths[] = { 1, 4, 16, 64, 256 };
+// How long the CL_COMPLETE callback may take after the wait returns
+static const std::chrono::seconds kCallbackTimeout(10);
+
+// Takes one timing of a sample at a time, in microseconds, and logs its BENCH
+// row
+template <typename Sample>
+static int measure_latency(const char *metric, const std::string &command,
+                           const char *queueName, Sample sample)
+{
+    BenchmarkOptions options;
+    options.warmup = 1;
+    options.maxSeconds = 1.0;
+    BenchmarkStats stats;
+    cl_int error = run_benchmark(options, sample, &stats);
+    if (error != CL_SUCCESS) return error;
+
+    std::string label = command + "_" + queueName;
+    log_benchmark_stats(metric, label.c_str(), "us", false, stats);
+    return CL_SUCCESS;
+}
+
+namespace {
+
+struct CallbackTime
+{
+    std::mutex lock;
+    std::condition_variable calledCond;
+    bool called = false;
+    // Started just before the enqueue, and read by the callback
+    HostTimer timer;
+    double elapsedUs = 0;
+};
+
+// userData is a heap copy of the shared_ptr, so that the callback keeps its
+// CallbackTime alive however the benchmark got out of the loop
+void CL_CALLBACK record_callback_time(cl_event, cl_int, void *userData)
+{
+    std::unique_ptr<std::shared_ptr<CallbackTime>> holder(
+        static_cast<std::shared_ptr<CallbackTime> *>(userData));
+    std::shared_ptr<CallbackTime> data = *holder;
+    double elapsedUs = data->timer.elapsed_us();
+    {
+        std::lock_guard<std::mutex> lock(data->lock);
+        data->elapsedUs = elapsedUs;
+        data->called = true;
+    }
+    data->calledCond.notify_all();
+}
+
+} // anonymous namespace
+
+struct ActionTimes
+{
+    double enqueueUs;
+    double startUs;
+    double callbackUs;
+};
+
+// Enqueue cost on the host, submit-to-start on the device and the delay
+// from completion to the CL_COMPLETE callback, for one run of an action.
+// The callback delay is the host time from enqueue to callback less the
+// device's queued-to-end time, so both clocks only measure intervals. When
+// gated, the command waits on a user event that is completed right after
+// the enqueue, which is how the scheduler sees host-side dependencies.
+static int sample_action(cl_context context, cl_command_queue queue,
+                         Action *action, bool gated, ActionTimes *times)
+{
+    cl_int error;
+    clEventWrapper gate;
+    if (gated)
+    {
+        gate = clCreateUserEvent(context, &error);
+        test_error(error, "Unable to create user event");
+    }
+
+    clEventWrapper event;
+    std::shared_ptr<CallbackTime> callback = std::make_shared<CallbackTime>();
+    error =
+        action->Execute(queue, gated ? 1 : 0, gated ? &gate : NULL, &event);
+    double enqueuedUs = callback->timer.elapsed_us();
+    test_error(error, "Unable to execute action");
+
+    std::shared_ptr<CallbackTime> *holder =
+        new std::shared_ptr<CallbackTime>(callback);
+    error = clSetEventCallback(event, CL_COMPLETE, record_callback_time,
+                               holder);
+    if (error != CL_SUCCESS) delete holder;
+    test_error(error, "Unable to set event callback");
+
+    if (gated)
+    {
+        error = clSetUserEventStatus(gate, CL_COMPLETE);
+        test_error(error, "Unable to complete user event");
+    }
+
+    error = clWaitForEvents(1, &event);
+    test_error(error, "Unable to wait for action");
+
+    // The callback may run on another thread after the wait returns
+    double callbackTimeUs;
+    {
+        std::unique_lock<std::mutex> lock(callback->lock);
+        if (!callback->calledCond.wait_for(
+                lock, kCallbackTimeout,
+                [&callback] { return callback->called; }))
+        {
+            log_error("ERROR: The CL_COMPLETE callback of %s did not run "
+                      "within %d s of the wait\n",
+                      action->GetName(), (int)kCallbackTimeout.count());
+            return -1;
+        }
+        callbackTimeUs = callback->elapsedUs;
+    }
+
+    double queuedToStartNs, queuedToEndNs;
+    error = get_event_duration_ns(event, &queuedToStartNs,
+                                  CL_PROFILING_COMMAND_QUEUED,
+                                  CL_PROFILING_COMMAND_START);
+    if (error) return error;
+    error = get_event_duration_ns(event, &queuedToEndNs,
+                                  CL_PROFILING_COMMAND_QUEUED,
+                                  CL_PROFILING_COMMAND_END);
+    if (error) return error;
+
+    times->enqueueUs = enqueuedUs;
+    times->startUs = queuedToStartNs / 1000;
+    times->callbackUs = std::max(0.0, callbackTimeUs - queuedToEndNs / 1000);
+    return CL_SUCCESS;
+}
+
+// Each of the latencies of an action on one queue
+static int bench_action(cl_device_id device, cl_context context,
+                        cl_command_queue queue, const char *queueName,
+                        Action *action, bool gated)
+{
+    cl_int error = action->Setup(device, context, queue);
+    test_error(error, "Unable to set up action");
+
+    static const struct
+    {
+        const char *metric;
+        double ActionTimes::*us;
+    } latencies[] = {
+        { "enqueue", &ActionTimes::enqueueUs },
+        { "queued_to_start", &ActionTimes::startUs },
+        { "callback", &ActionTimes::callbackUs },
+    };
+
+    const char *suffix = gated ? "_gated" : "";
+    std::string name = std::string(action->GetName()) + suffix;
+    for (const auto &latency : latencies)
+    {
+        error = measure_latency(latency.metric, name, queueName,
+                                [&](double *us) {
+                                    ActionTimes times;
+                                    int err = sample_action(
+                                        context, queue, action, gated, &times);
+                                    *us = times.*latency.us;
+                                    return (cl_int)err;
+                                });
+        if (error != CL_SUCCESS) return error;
+    }
+    return CL_SUCCESS;
+}
+
+// Cost of a marker that waits on depth user events: the host enqueue time,
+// or the host time from completing the last user event to the marker
+// completing.
+static int sample_fan_in(cl_context context, cl_command_queue queue,
+                         cl_uint depth, bool resolve, double *us)
+{
+    cl_int error;
+    std::vector<clEventWrapper> gates(depth);
+    std::vector<cl_event> waits(depth);
+    for (cl_uint j = 0; j < depth; j++)
+    {
+        gates[j] = clCreateUserEvent(context, &error);
+        test_error(error, "Unable to create user event");
+        waits[j] = gates[j];
+    }
+
+    clEventWrapper marker;
+    HostTimer timer;
+    error = clEnqueueMarkerWithWaitList(queue, depth, waits.data(), &marker);
+    double enqueuedUs = timer.elapsed_us();
+    test_error(error, "Unable to enqueue marker");
+
+    error = clFlush(queue);
+    test_error(error, "Unable to flush queue");
+
+    for (cl_uint j = 0; j + 1 < depth; j++)
+    {
+        error = clSetUserEventStatus(gates[j], CL_COMPLETE);
+        test_error(error, "Unable to complete user event");
+    }
+    double releasedUs = timer.elapsed_us();
+    error = clSetUserEventStatus(gates[depth - 1], CL_COMPLETE);
+    test_error(error, "Unable to complete user event");
+    error = clWaitForEvents(1, &marker);
+    test_error(error, "Unable to wait for marker");
+    double doneUs = timer.elapsed_us();
+
+    *us = resolve ? doneUs - releasedUs : enqueuedUs;
+    return CL_SUCCESS;
+}
+
+static int bench_fan_in(cl_context context, cl_command_queue queue,
+                        const char *queueName, cl_uint depth)
+{
+    std::string name = "Marker_fan_in_" + std::to_string(depth);
+    for (bool resolve : { false, true })
+    {
+        int error = measure_latency(
+            resolve ? "resolve" : "enqueue", name, queueName,
+            [&](double *us) {
+                return sample_fan_in(context, queue, depth, resolve, us);
+            });
+        if (error != CL_SUCCESS) return error;
+    }
+    return CL_SUCCESS;
+}
+
+static int bench_queue(cl_device_id device, cl_context context,
+                       cl_command_queue_properties props,
+                       const char *queueName)
+{
+    cl_int error;
+    clCommandQueueWrapper queue = clCreateCommandQueue(
+        context, device, props | CL_QUEUE_PROFILING_ENABLE, &error);
+    test_error(error, "Unable to create profiling queue");
+
+    for (int gated = 0; gated < 2; gated++)
+    {
+        std::unique_ptr<Action> actions[] = {
+            std::unique_ptr<Action>(new NDRangeKernelAction()),
+            std::unique_ptr<Action>(new ReadBufferAction()),
+            std::unique_ptr<Action>(new WriteBufferAction()),
+        };
+        for (auto &action : actions)
+        {
+            error = bench_action(device, context, queue, queueName,
+                                 action.get(), gated != 0);
+            if (error)
+            {
+                log_error("ERROR: Unable to measure %s on the %s queue\n",
+                          action->GetName(), queueName);
+                return error;
+            }
+        }
+    }
+
+    for (cl_uint depth : kFanInDepths)
+    {
+        error = bench_fan_in(context, queue, queueName, depth);
+        if (error) return error;
+    }
+
+    return clFinish(queue);
+}
+
+int test_event_latency(cl_device_id deviceID, cl_context context,
+                       cl_command_queue queue, int num_elements)
+{
+    log_benchmark_header("metric", "command_queue");
+
+    int error = bench_queue(deviceID, context, 0, "in_order");
+    if (error) return error;
+
+    cl_command_queue_properties props = CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE;
+    if (!checkDeviceForQueueSupport(deviceID, props))
+    {
+        log_info("Device doesn't support out-of-order queues, skipping "
+                 "them.\n");
+        return 0;
+    }
+    return bench_queue(deviceID, context, props, "out_of_order");
+}
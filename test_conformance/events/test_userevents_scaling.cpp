@@ -0,0 +1,240 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "testBase.h"
+#include "harness/benchmark.h"
+#include "harness/perfMetrics.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+// How user events scale as futures completed from many host threads. Each
+// of T threads completes its own user events, each of which gates a marker,
+// on one queue shared by all the threads or on a queue per thread. The rate
+// is the events completed per second from the moment the threads start to
+// the last marker's CL_COMPLETE callback, and the latency the time from a
+// clSetUserEventStatus call to the callback of the marker it gates.
+// Serialisation in the runtime's event handling shows as a rate that stops
+// growing, or a latency that grows, with T.
+
+static const int kEventsPerThread = 256;
+static const int kThreadCounts[] = { 1, 2, 4, 8, 16 };
+
+typedef std::chrono::steady_clock SignalClock;
+
+namespace {
+
+struct SignalSample
+{
+    std::vector<SignalClock::time_point> signalled;
+    std::vector<SignalClock::time_point> resolved;
+    std::atomic<int> pending;
+};
+
+struct MarkerCallback
+{
+    SignalSample *sample;
+    size_t index;
+};
+
+void CL_CALLBACK record_marker_time(cl_event, cl_int, void *userData)
+{
+    MarkerCallback *callback = static_cast<MarkerCallback *>(userData);
+    callback->sample->resolved[callback->index] = SignalClock::now();
+    callback->sample->pending--;
+}
+
+// One sample with threads threads, returning the events resolved per second
+// in *rate and appending the latency of each event in microseconds to
+// latencies
+cl_int signal_sample(cl_context context,
+                     const std::vector<cl_command_queue> &queues, int threads,
+                     double *rate, std::vector<double> &latencies)
+{
+    size_t count = (size_t)threads * kEventsPerThread;
+    SignalSample sample;
+    sample.signalled.resize(count);
+    sample.resolved.resize(count);
+    sample.pending = 0;
+
+    std::vector<clEventWrapper> gates(count), markers(count);
+    std::vector<MarkerCallback> callbacks(count);
+    // Gates that could not be completed, whose markers never run
+    std::vector<char> stuck(count, 0);
+
+    // The callbacks refer to sample, so no marker may be left to complete
+    // after the return
+    auto drain = [&](size_t enqueued) {
+        for (size_t i = 0; i < enqueued; i++)
+            if (!stuck[i] && sample.signalled[i] == SignalClock::time_point())
+                clSetUserEventStatus(gates[i], CL_COMPLETE);
+        while (sample.pending > 0) std::this_thread::yield();
+    };
+
+    cl_int error = CL_SUCCESS;
+    size_t enqueued = 0;
+    for (; enqueued < count && error == CL_SUCCESS; enqueued++)
+    {
+        size_t i = enqueued;
+        gates[i] = clCreateUserEvent(context, &error);
+        if (error != CL_SUCCESS)
+        {
+            print_error(error, "Unable to create user event");
+            break;
+        }
+        cl_event gate = gates[i];
+        cl_command_queue queue = queues[(i / kEventsPerThread) % queues.size()];
+        error = clEnqueueMarkerWithWaitList(queue, 1, &gate, &markers[i]);
+        if (error != CL_SUCCESS)
+        {
+            print_error(error, "Unable to enqueue marker");
+            break;
+        }
+        callbacks[i].sample = &sample;
+        callbacks[i].index = i;
+        sample.pending++;
+        error = clSetEventCallback(markers[i], CL_COMPLETE, record_marker_time,
+                                   &callbacks[i]);
+        if (error != CL_SUCCESS)
+        {
+            print_error(error, "Unable to set event callback");
+            sample.pending--;
+        }
+    }
+    for (cl_command_queue queue : queues)
+        if (error == CL_SUCCESS) error = clFlush(queue);
+    if (error != CL_SUCCESS)
+    {
+        print_error(error, "Unable to set up user event sample");
+        drain(enqueued);
+        return error;
+    }
+
+    // Start all the threads at once
+    std::atomic<int> ready(0);
+    std::atomic<bool> go(false);
+    std::atomic<cl_int> threadError(CL_SUCCESS);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++)
+        workers.emplace_back([&, t]() {
+            ready++;
+            while (!go) std::this_thread::yield();
+            for (int e = 0; e < kEventsPerThread; e++)
+            {
+                size_t i = (size_t)t * kEventsPerThread + e;
+                sample.signalled[i] = SignalClock::now();
+                cl_int status = clSetUserEventStatus(gates[i], CL_COMPLETE);
+                if (status != CL_SUCCESS)
+                {
+                    stuck[i] = 1;
+                    threadError = status;
+                }
+            }
+        });
+    while (ready < threads) std::this_thread::yield();
+    SignalClock::time_point start = SignalClock::now();
+    go = true;
+    for (std::thread &worker : workers) worker.join();
+    if (threadError != CL_SUCCESS)
+    {
+        print_error(threadError, "Unable to complete user event");
+        // Markers behind the stuck gates keep their callbacks from running
+        for (size_t i = 0; i < count; i++)
+            if (stuck[i]) sample.pending--;
+        drain(count);
+        return threadError;
+    }
+
+    std::vector<cl_event> waits(markers.begin(), markers.end());
+    error = clWaitForEvents((cl_uint)count, waits.data());
+    // The callbacks may still be running on another thread
+    while (sample.pending > 0) std::this_thread::yield();
+    test_error(error, "Unable to wait for markers");
+
+    SignalClock::time_point last =
+        *std::max_element(sample.resolved.begin(), sample.resolved.end());
+    double seconds = std::chrono::duration<double>(last - start).count();
+    *rate = seconds > 0 ? count / seconds : 0;
+    for (size_t i = 0; i < count; i++)
+        latencies.push_back(std::max(
+            0.0,
+            std::chrono::duration<double, std::micro>(sample.resolved[i]
+                                                      - sample.signalled[i])
+                .count()));
+    return CL_SUCCESS;
+}
+
+} // anonymous namespace
+
+int test_userevents_signal_scaling(cl_device_id deviceID, cl_context context,
+                                   cl_command_queue queue, int num_elements)
+{
+    if (get_device_cl_version(deviceID) < Version(1, 2))
+    {
+        log_info("Skipping user event scaling, it needs "
+                 "clEnqueueMarkerWithWaitList from OpenCL 1.2.\n");
+        return TEST_SKIPPED_ITSELF;
+    }
+
+    int maxThreads = std::max(2u, std::thread::hardware_concurrency());
+
+    BenchmarkOptions options;
+    options.warmup = 1;
+    options.maxSeconds = 2.0;
+
+    log_benchmark_header("userevent_signal", "queues/threads");
+    for (int separate = 0; separate < 2; separate++)
+    {
+        for (int threads : kThreadCounts)
+        {
+            if (threads > maxThreads) break;
+
+            std::vector<clCommandQueueWrapper> ownQueues(separate ? threads
+                                                                  : 1);
+            std::vector<cl_command_queue> queues;
+            cl_int error;
+            for (clCommandQueueWrapper &q : ownQueues)
+            {
+                q = clCreateCommandQueue(context, deviceID, 0, &error);
+                test_error(error, "Unable to create command queue");
+                queues.push_back(q);
+            }
+
+            std::vector<double> latencies;
+            BenchmarkStats rateStats;
+            error = run_benchmark(
+                options,
+                [&](double *rate) {
+                    return signal_sample(context, queues, threads, rate,
+                                         latencies);
+                },
+                &rateStats);
+            test_error(error, "Unable to measure user event signalling");
+
+            std::string label = std::string(separate ? "separate" : "shared")
+                + "/" + std::to_string(threads);
+            log_benchmark_stats("userevent_signal_rate", label.c_str(),
+                                "events/s", true, rateStats);
+            BenchmarkStats latencyStats = compute_benchmark_stats(latencies);
+            log_benchmark_stats("userevent_signal_latency", label.c_str(),
+                                "us", false, latencyStats);
+        }
+    }
+    return 0;
+}
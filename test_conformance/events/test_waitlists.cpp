@@ -25,7 +25,7 @@ int test_waitlist(cl_device_id device, cl_context context,
                   cl_command_queue queue, Action *actionToTest, bool multiple)
 {
     NDRangeKernelAction actions[2];
-    clEventWrapper events[3];
+    clEventArray<3> events;
     cl_int status[3];
     cl_int error;
 
@@ -60,7 +60,7 @@ int test_waitlist(cl_device_id device, cl_context context,
     if (multiple)
     {
         if (PRINT_OPS) log_info("\tExecuting action 1...\n");
-        error = actions[1].Execute(queue, 1, &events[0], &events[1]);
+        error = actions[1].Execute(queue, 1, events.data(), &events[1]);
         test_error(error, "Unable to execute second event");
     }
 
@@ -91,7 +91,7 @@ int test_waitlist(cl_device_id device, cl_context context,
     }
 
     if (PRINT_OPS) log_info("\tExecuting action to test...\n");
-    error = actionToTest->Execute(queue, (multiple) ? 2 : 1, &events[0],
+    error = actionToTest->Execute(queue, (multiple) ? 2 : 1, events.data(),
                                   &events[2]);
     test_error(error, "Unable to execute test event");
 
@@ -0,0 +1,585 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "procs.h"
+#include "harness/perfMetrics.h"
+#include "harness/benchmark.h"
+
+#include <algorithm>
+#include <ctime>
+#include <string>
+#include <vector>
+
+// Compile time and kernel time of template heavy C++ for OpenCL kernels
+// against the same computation written the usual OpenCL C way, with macros,
+// loops and builtins. Every kernel in the corpus maps one uint to another,
+// so both programs are checked against a host reference and each other.
+// The rows give the build time and the kernel time of each language,
+// followed by the C++ over OpenCL C ratios of their medians and the binary
+// sizes. The recursive_unroll kernel is built at several template recursion
+// depths to show how the compile time grows with instantiations. A
+// benchmark, so it only runs when named.
+
+static const size_t kBenchItems = 1 << 20;
+
+namespace {
+
+struct CorpusKernel
+{
+    const char *name;
+    const char *cxx_source;
+    const char *c_source;
+    int depth;
+    cl_uint (*reference)(cl_uint x, int depth);
+};
+
+// Function templates with a non-type parameter against rotate()
+const char *rotate_mix_cxx = R"(
+    template <typename T> T rotl(T x, uint r)
+    {
+        return (x << r) | (x >> (sizeof(T) * 8 - r));
+    }
+
+    template <typename T, uint R> T mix(T x)
+    {
+        return rotl<T>(x * (T)0x9e3779b1u, R) ^ (x >> 7);
+    }
+
+    __kernel void bench(__global const uint *src, __global uint *dst)
+    {
+        size_t gid = get_global_id(0);
+        uint x = src[gid];
+        x = mix<uint, 5>(x);
+        x = mix<uint, 11>(x);
+        x = mix<uint, 17>(x);
+        x = mix<uint, 23>(x);
+        dst[gid] = x;
+    })";
+
+const char *rotate_mix_c = R"(
+    uint mix(uint x, uint r) { return rotate(x * 0x9e3779b1u, r) ^ (x >> 7); }
+
+    __kernel void bench(__global const uint *src, __global uint *dst)
+    {
+        size_t gid = get_global_id(0);
+        uint x = src[gid];
+        x = mix(x, 5);
+        x = mix(x, 11);
+        x = mix(x, 17);
+        x = mix(x, 23);
+        dst[gid] = x;
+    })";
+
+cl_uint rotate_mix_reference(cl_uint x, int)
+{
+    const cl_uint rotations[] = { 5, 11, 17, 23 };
+    for (cl_uint r : rotations)
+    {
+        cl_uint m = x * 0x9e3779b1u;
+        x = ((m << r) | (m >> (32 - r))) ^ (x >> 7);
+    }
+    return x;
+}
+
+// Recursive class template unrolling against an unrolled loop, DEPTH rounds
+const char *recursive_unroll_cxx = R"(
+    template <uint N> struct Round
+    {
+        static uint apply(uint x)
+        {
+            return Round<N - 1>::apply((x ^ (x >> 15)) * 0x2c1b3c6du + N);
+        }
+    };
+
+    template <> struct Round<0>
+    {
+        static uint apply(uint x) { return x; }
+    };
+
+    __kernel void bench(__global const uint *src, __global uint *dst)
+    {
+        size_t gid = get_global_id(0);
+        dst[gid] = Round<DEPTH>::apply(src[gid]);
+    })";
+
+const char *recursive_unroll_c = R"(
+    __kernel void bench(__global const uint *src, __global uint *dst)
+    {
+        size_t gid = get_global_id(0);
+        uint x = src[gid];
+        #pragma unroll
+        for (uint n = DEPTH; n > 0; n--) x = (x ^ (x >> 15)) * 0x2c1b3c6du + n;
+        dst[gid] = x;
+    })";
+
+cl_uint recursive_unroll_reference(cl_uint x, int depth)
+{
+    for (cl_uint n = depth; n > 0; n--) x = (x ^ (x >> 15)) * 0x2c1b3c6du + n;
+    return x;
+}
+
+// A class template matrix with an overloaded product against nested loops
+const char *fixed_matrix_cxx = R"(
+    template <typename T, int N> struct Mat
+    {
+        T m[N][N];
+    };
+
+    template <typename T, int N>
+    Mat<T, N> operator*(Mat<T, N> a, Mat<T, N> b)
+    {
+        Mat<T, N> r;
+        for (int i = 0; i < N; i++)
+            for (int j = 0; j < N; j++)
+            {
+                T acc = 0;
+                for (int k = 0; k < N; k++) acc += a.m[i][k] * b.m[k][j];
+                r.m[i][j] = acc;
+            }
+        return r;
+    }
+
+    template <typename T, int N> T trace(Mat<T, N> a)
+    {
+        T acc = 0;
+        for (int i = 0; i < N; i++) acc += a.m[i][i];
+        return acc;
+    }
+
+    __kernel void bench(__global const uint *src, __global uint *dst)
+    {
+        size_t gid = get_global_id(0);
+        uint x = src[gid];
+        Mat<uint, 4> a;
+        for (int i = 0; i < 4; i++)
+            for (int j = 0; j < 4; j++)
+                a.m[i][j] = x ^ ((uint)(i * 4 + j) * 0x01000193u);
+        Mat<uint, 4> b = a * a;
+        dst[gid] = trace(b * a);
+    })";
+
+const char *fixed_matrix_c = R"(
+    #define N 4
+
+    void mat_mul(const uint *a, const uint *b, uint *r)
+    {
+        for (int i = 0; i < N; i++)
+            for (int j = 0; j < N; j++)
+            {
+                uint acc = 0;
+                for (int k = 0; k < N; k++) acc += a[i * N + k] * b[k * N + j];
+                r[i * N + j] = acc;
+            }
+    }
+
+    __kernel void bench(__global const uint *src, __global uint *dst)
+    {
+        size_t gid = get_global_id(0);
+        uint x = src[gid];
+        uint a[N * N], b[N * N], c[N * N];
+        for (int i = 0; i < N * N; i++) a[i] = x ^ ((uint)i * 0x01000193u);
+        mat_mul(a, a, b);
+        mat_mul(b, a, c);
+        uint acc = 0;
+        for (int i = 0; i < N; i++) acc += c[i * N + i];
+        dst[gid] = acc;
+    })";
+
+cl_uint fixed_matrix_reference(cl_uint x, int)
+{
+    cl_uint a[16], b[16], c[16];
+    for (int i = 0; i < 16; i++) a[i] = x ^ ((cl_uint)i * 0x01000193u);
+    for (int pass = 0; pass < 2; pass++)
+    {
+        const cl_uint *lhs = pass ? b : a;
+        cl_uint *r = pass ? c : b;
+        for (int i = 0; i < 4; i++)
+            for (int j = 0; j < 4; j++)
+            {
+                cl_uint acc = 0;
+                for (int k = 0; k < 4; k++)
+                    acc += lhs[i * 4 + k] * a[k * 4 + j];
+                r[i * 4 + j] = acc;
+            }
+    }
+    return c[0] + c[5] + c[10] + c[15];
+}
+
+// A variadic template pipeline of stage types against straight line code
+const char *variadic_pipeline_cxx = R"(
+    template <uint K> struct ShiftLeftXor
+    {
+        static uint apply(uint x) { return x ^ (x << K); }
+    };
+
+    template <uint K> struct ShiftRightXor
+    {
+        static uint apply(uint x) { return x ^ (x >> K); }
+    };
+
+    template <uint K> struct Multiply
+    {
+        static uint apply(uint x) { return x * K; }
+    };
+
+    template <typename... Stages> struct Pipeline;
+
+    template <> struct Pipeline<>
+    {
+        static uint apply(uint x) { return x; }
+    };
+
+    template <typename Stage, typename... Rest>
+    struct Pipeline<Stage, Rest...>
+    {
+        static uint apply(uint x)
+        {
+            return Pipeline<Rest...>::apply(Stage::apply(x));
+        }
+    };
+
+    using Hash = Pipeline<ShiftLeftXor<13>, ShiftRightXor<17>, ShiftLeftXor<5>,
+                          Multiply<0x27d4eb2du>, ShiftRightXor<15>,
+                          Multiply<0x165667b1u>, ShiftRightXor<16>>;
+
+    __kernel void bench(__global const uint *src, __global uint *dst)
+    {
+        size_t gid = get_global_id(0);
+        dst[gid] = Hash::apply(Hash::apply(src[gid]));
+    })";
+
+const char *variadic_pipeline_c = R"(
+    uint hash(uint x)
+    {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        x *= 0x27d4eb2du;
+        x ^= x >> 15;
+        x *= 0x165667b1u;
+        x ^= x >> 16;
+        return x;
+    }
+
+    __kernel void bench(__global const uint *src, __global uint *dst)
+    {
+        size_t gid = get_global_id(0);
+        dst[gid] = hash(hash(src[gid]));
+    })";
+
+cl_uint variadic_pipeline_reference(cl_uint x, int)
+{
+    for (int pass = 0; pass < 2; pass++)
+    {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        x *= 0x27d4eb2du;
+        x ^= x >> 15;
+        x *= 0x165667b1u;
+        x ^= x >> 16;
+    }
+    return x;
+}
+
+// One function template instantiated for four types against a macro that
+// stamps out a function per type
+const char *type_generic_cxx = R"(
+    template <typename T> uint fold(uint x)
+    {
+        T v = (T)x;
+        T acc = 0;
+        for (int i = 0; i < 8; i++) acc = (T)(acc * (T)31 + (T)(v >> i));
+        return (uint)acc;
+    }
+
+    __kernel void bench(__global const uint *src, __global uint *dst)
+    {
+        size_t gid = get_global_id(0);
+        uint x = src[gid];
+        dst[gid] = fold<uchar>(x) + fold<ushort>(x) + fold<uint>(x)
+            + fold<ulong>(x);
+    })";
+
+const char *type_generic_c = R"(
+    #define DEFINE_FOLD(T)                                                     \
+        uint fold_##T(uint x)                                                  \
+        {                                                                      \
+            T v = (T)x;                                                        \
+            T acc = 0;                                                         \
+            for (int i = 0; i < 8; i++) acc = (T)(acc * (T)31 + (T)(v >> i));  \
+            return (uint)acc;                                                  \
+        }
+
+    DEFINE_FOLD(uchar)
+    DEFINE_FOLD(ushort)
+    DEFINE_FOLD(uint)
+    DEFINE_FOLD(ulong)
+
+    __kernel void bench(__global const uint *src, __global uint *dst)
+    {
+        size_t gid = get_global_id(0);
+        uint x = src[gid];
+        dst[gid] = fold_uchar(x) + fold_ushort(x) + fold_uint(x)
+            + fold_ulong(x);
+    })";
+
+template <typename T> cl_uint type_generic_fold(cl_uint x)
+{
+    T v = (T)x;
+    T acc = 0;
+    for (int i = 0; i < 8; i++) acc = (T)(acc * (T)31 + (T)(v >> i));
+    return (cl_uint)acc;
+}
+
+cl_uint type_generic_reference(cl_uint x, int)
+{
+    return type_generic_fold<cl_uchar>(x) + type_generic_fold<cl_ushort>(x)
+        + type_generic_fold<cl_uint>(x) + type_generic_fold<cl_ulong>(x);
+}
+
+const CorpusKernel corpus[] = {
+    { "rotate_mix", rotate_mix_cxx, rotate_mix_c, 0, rotate_mix_reference },
+    { "recursive_unroll", recursive_unroll_cxx, recursive_unroll_c, 16,
+      recursive_unroll_reference },
+    { "recursive_unroll", recursive_unroll_cxx, recursive_unroll_c, 64,
+      recursive_unroll_reference },
+    { "recursive_unroll", recursive_unroll_cxx, recursive_unroll_c, 256,
+      recursive_unroll_reference },
+    { "fixed_matrix", fixed_matrix_cxx, fixed_matrix_c, 0,
+      fixed_matrix_reference },
+    { "variadic_pipeline", variadic_pipeline_cxx, variadic_pipeline_c, 0,
+      variadic_pipeline_reference },
+    { "type_generic", type_generic_cxx, type_generic_c, 0,
+      type_generic_reference },
+};
+
+struct LanguageResult
+{
+    BenchmarkStats build_ms;
+    BenchmarkStats kernel_us;
+    size_t binary_size;
+};
+
+struct CxxBench
+{
+    cl_device_id device;
+    cl_context context;
+    cl_command_queue queue;
+    cl_mem src;
+    cl_mem dst;
+    cl_uint salt;
+    std::vector<cl_uint> input;
+    std::vector<cl_uint> output;
+
+    // Builds source with options, the salt keeping compiler caches out of
+    // the measurement, and returns the build time
+    cl_int Build(const CorpusKernel &entry, bool cxx,
+                 clProgramWrapper &program, double &ms)
+    {
+        std::string text = "#define BENCH_SALT " + std::to_string(salt++)
+            + "u\n" + (cxx ? entry.cxx_source : entry.c_source);
+        std::string options = "-DDEPTH=" + std::to_string(entry.depth);
+        if (cxx) options += " -cl-std=CLC++";
+        const char *source = text.c_str();
+
+        cl_int error;
+        program =
+            clCreateProgramWithSource(context, 1, &source, nullptr, &error);
+        test_error(error, "clCreateProgramWithSource failed");
+
+        HostTimer timer;
+        error = clBuildProgram(program, 1, &device, options.c_str(), nullptr,
+                               nullptr);
+        ms = timer.elapsed_ms();
+        if (error != CL_SUCCESS)
+        {
+            print_error(error, "clBuildProgram failed");
+            size_t log_size = 0;
+            clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, 0,
+                                  nullptr, &log_size);
+            std::string log(log_size, '\0');
+            clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG,
+                                  log_size, &log[0], nullptr);
+            log_error("%s (%s) build log:\n%s\n", entry.name,
+                      cxx ? "C++ for OpenCL" : "OpenCL C", log.c_str());
+        }
+        return error;
+    }
+
+    // Samples the build time, then the kernel time of the last build, and
+    // checks its results
+    int Measure(const CorpusKernel &entry, bool cxx, LanguageResult &result)
+    {
+        const char *language = cxx ? "C++ for OpenCL" : "OpenCL C";
+
+        // Every build is salted, so none of them is warm
+        BenchmarkOptions build_options;
+        build_options.warmup = 0;
+        build_options.minSamples = 5;
+        build_options.maxSeconds = 2.0;
+        clProgramWrapper program;
+        cl_int error = run_benchmark(
+            build_options,
+            [&](double *ms) { return Build(entry, cxx, program, *ms); },
+            &result.build_ms);
+        if (error != CL_SUCCESS) return TEST_FAIL;
+
+        error = clGetProgramInfo(program, CL_PROGRAM_BINARY_SIZES,
+                                 sizeof(result.binary_size),
+                                 &result.binary_size, nullptr);
+        test_error(error, "clGetProgramInfo failed");
+
+        clKernelWrapper kernel = clCreateKernel(program, "bench", &error);
+        test_error(error, "clCreateKernel failed");
+        error = clSetKernelArg(kernel, 0, sizeof(src), &src);
+        test_error(error, "clSetKernelArg failed");
+        error = clSetKernelArg(kernel, 1, sizeof(dst), &dst);
+        test_error(error, "clSetKernelArg failed");
+
+        BenchmarkOptions kernel_options;
+        kernel_options.warmup = 1;
+        kernel_options.maxSeconds = 1.0;
+        error = run_benchmark(
+            kernel_options,
+            [&](double *us) {
+                clEventWrapper event;
+                cl_int err = clEnqueueNDRangeKernel(queue, kernel, 1, nullptr,
+                                                    &kBenchItems, nullptr, 0,
+                                                    nullptr, &event);
+                test_error(err, "clEnqueueNDRangeKernel failed");
+                err = clWaitForEvents(1, &event);
+                test_error(err, "clWaitForEvents failed");
+                double ns;
+                err = get_event_duration_ns(event, &ns);
+                *us = ns / 1e3;
+                return err;
+            },
+            &result.kernel_us);
+        if (error != CL_SUCCESS) return TEST_FAIL;
+
+        error = clEnqueueReadBuffer(queue, dst, CL_BLOCKING, 0,
+                                    output.size() * sizeof(cl_uint),
+                                    output.data(), 0, nullptr, nullptr);
+        test_error(error, "clEnqueueReadBuffer failed");
+        for (size_t i = 0; i < output.size(); i++)
+        {
+            cl_uint expected = entry.reference(input[i], entry.depth);
+            if (output[i] != expected)
+            {
+                log_error("%s (%s): item %zu is 0x%08x, expected 0x%08x\n",
+                          entry.name, language, i, output[i], expected);
+                return TEST_FAIL;
+            }
+        }
+        return TEST_PASS;
+    }
+};
+
+} // anonymous namespace
+
+int test_cxx_for_opencl_bench(cl_device_id device, cl_context context,
+                              cl_command_queue, int)
+{
+    if (!is_extension_available(device, "cl_ext_cxx_for_opencl"))
+    {
+        log_info("Device does not support 'cl_ext_cxx_for_opencl'. Skipping "
+                 "the test.\n");
+        return TEST_SKIPPED_ITSELF;
+    }
+
+    cl_int error;
+    clCommandQueueWrapper profiling_queue = clCreateCommandQueue(
+        context, device, CL_QUEUE_PROFILING_ENABLE, &error);
+    test_error(error, "Unable to create profiling queue");
+
+    CxxBench bench;
+    bench.device = device;
+    bench.context = context;
+    bench.queue = profiling_queue;
+    bench.salt = (cl_uint)time(nullptr);
+    bench.input.resize(kBenchItems);
+    bench.output.resize(kBenchItems);
+    for (size_t i = 0; i < kBenchItems; i++)
+        bench.input[i] = (cl_uint)i * 0x9e3779b9u ^ 0x5bd1e995u;
+
+    clMemWrapper src = clCreateBuffer(
+        context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+        kBenchItems * sizeof(cl_uint), bench.input.data(), &error);
+    test_error(error, "clCreateBuffer failed");
+    clMemWrapper dst = clCreateBuffer(context, CL_MEM_WRITE_ONLY,
+                                      kBenchItems * sizeof(cl_uint), nullptr,
+                                      &error);
+    test_error(error, "clCreateBuffer failed");
+    bench.src = src;
+    bench.dst = dst;
+
+    // The first build of each language can pay for loading its front end
+    for (int cxx = 0; cxx <= 1; cxx++)
+    {
+        clProgramWrapper program;
+        double ms;
+        if (bench.Build(corpus[0], cxx != 0, program, ms) != CL_SUCCESS)
+            return TEST_FAIL;
+    }
+
+    log_benchmark_header("metric", "kernel/language");
+
+    double c_total_ms = 0, cxx_total_ms = 0;
+    for (const CorpusKernel &entry : corpus)
+    {
+        LanguageResult c, cxx;
+        if (bench.Measure(entry, false, c) != TEST_PASS
+            || bench.Measure(entry, true, cxx) != TEST_PASS)
+            return TEST_FAIL;
+        c_total_ms += c.build_ms.median;
+        cxx_total_ms += cxx.build_ms.median;
+
+        std::string label = entry.name;
+        if (entry.depth) label += "_d" + std::to_string(entry.depth);
+        log_benchmark_stats("build", (label + "/c").c_str(), "ms", false,
+                            c.build_ms);
+        log_benchmark_stats("build", (label + "/cxx").c_str(), "ms", false,
+                            cxx.build_ms);
+        log_benchmark_stats("kernel", (label + "/c").c_str(), "us", false,
+                            c.kernel_us);
+        log_benchmark_stats("kernel", (label + "/cxx").c_str(), "us", false,
+                            cxx.kernel_us);
+
+        double build_ratio = c.build_ms.median > 0
+            ? cxx.build_ms.median / c.build_ms.median
+            : 0.0;
+        double kernel_ratio = c.kernel_us.median > 0
+            ? cxx.kernel_us.median / c.kernel_us.median
+            : 0.0;
+        log_info("%s: build ratio %.2f, kernel ratio %.2f, binaries of %zu "
+                 "and %zu bytes\n",
+                 label.c_str(), build_ratio, kernel_ratio, c.binary_size,
+                 cxx.binary_size);
+
+        std::string metric = "cxx_for_opencl_" + label;
+        record_perf_metric(metric + "_build_ratio", build_ratio, "ratio",
+                           false);
+        record_perf_metric(metric + "_kernel_ratio", kernel_ratio, "ratio",
+                           false);
+    }
+
+    log_info("Total build time %.2f ms in OpenCL C and %.2f ms in C++ for "
+             "OpenCL, ratio %.2f\n",
+             c_total_ms, cxx_total_ms,
+             c_total_ms > 0 ? cxx_total_ms / c_total_ms : 0.0);
+
+    return TEST_PASS;
+}
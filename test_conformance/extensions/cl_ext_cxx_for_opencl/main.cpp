@@ -18,7 +18,8 @@
 
 test_definition test_list[] = {
     ADD_TEST_VERSION(cxx_for_opencl_ext, Version(2, 0)),
-    ADD_TEST_VERSION(cxx_for_opencl_ver, Version(2, 0))
+    ADD_TEST_VERSION(cxx_for_opencl_ver, Version(2, 0)),
+    ADD_BENCHMARK_VERSION(cxx_for_opencl_bench, Version(2, 0))
 };
 
 int main(int argc, const char *argv[])
@@ -17,10 +17,13 @@
 #define _procs_h
 
 #include "harness/typeWrappers.h"
+#include "harness/parseParameters.h"
 
 extern int test_cxx_for_opencl_ext(cl_device_id device, cl_context context,
                                    cl_command_queue queue, int);
 extern int test_cxx_for_opencl_ver(cl_device_id device, cl_context context,
                                    cl_command_queue queue, int);
+extern int test_cxx_for_opencl_bench(cl_device_id device, cl_context context,
+                                     cl_command_queue queue, int);
 
 #endif /*_procs_h*/
@@ -44,6 +44,7 @@ test_definition test_list[] = {
     ADD_TEST(mutable_dispatch_global_arguments),
     ADD_TEST(mutable_dispatch_pod_arguments),
     ADD_TEST(mutable_dispatch_null_arguments),
+    ADD_BENCHMARK(mutable_dispatch_benchmark),
 };
 
 int main(int argc, const char *argv[])
@@ -0,0 +1,469 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <extensionHelpers.h>
+#include "mutable_command_basic.h"
+#include "../command_buffer_bench.h"
+
+#include <CL/cl.h>
+#include <CL/cl_ext.h>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+// 200 dispatches is the size of an iterative solver's command-buffer that
+// mutates one argument of every dispatch per iteration
+const size_t kCommandCounts[] = { 1, 8, 64, 200 };
+// Replays per sample of back to back replays
+const int kReplays = 64;
+// Small dispatches, so the timings are dominated by host overhead
+const int kMaxBenchElements = 4096;
+// Global offset the offset updates move the dispatches to and back from
+const size_t kOffset = 16;
+// Arguments of the fill kernel, the last one being its destination buffer
+const cl_uint kFillArgs = 4;
+
+////////////////////////////////////////////////////////////////////////////////
+// Mutable-dispatch benchmark: the cost of changing N recorded dispatches with
+// clUpdateMutableCommandsKHR(), by number of arguments changed, and by global
+// size or global offset where the device can mutate them, against recording
+// and finalizing a new command-buffer with the argument changed. Each is
+// measured on the host alone, per whole update and per mutated command, and
+// including one enqueue of the result, as an implementation may defer work
+// to the next enqueue. Also measures replaying a command-buffer back to back
+// with simultaneous use, against waiting for each replay before the next.
+// A benchmark, so it only runs when named. The last values written are
+// checked after each measurement.
+
+struct MutableDispatchBenchmark : BasicMutableCommandBufferTest
+{
+    MutableDispatchBenchmark(cl_device_id device, cl_context context,
+                             cl_command_queue queue)
+        : BasicMutableCommandBufferTest(device, context, queue)
+    {}
+
+    bool Skip() override
+    {
+        if (BasicMutableCommandBufferTest::Skip()) return true;
+        bool mutable_support =
+            !clGetDeviceInfo(
+                device, CL_DEVICE_MUTABLE_DISPATCH_CAPABILITIES_KHR,
+                sizeof(mutable_capabilities), &mutable_capabilities, nullptr)
+            && mutable_capabilities & CL_MUTABLE_DISPATCH_ARGUMENTS_KHR;
+
+        // require mutable arguments capabillity
+        return !mutable_support;
+    }
+
+    cl_int SetUp(int elements) override
+    {
+        return BasicMutableCommandBufferTest::SetUp(
+            std::min(elements, kMaxBenchElements));
+    }
+
+    // setup kernel program
+    cl_int SetUpKernel() override
+    {
+        const char *kernel_fill_str =
+            R"(
+            __kernel void fill(int a, int b, int c, __global int *dst)
+            {
+                size_t gid = get_global_id(0);
+                dst[gid] = a + b * 3 + c * 7;
+            })";
+
+        cl_int error = create_single_kernel_helper_create_program(
+            context, &program, 1, &kernel_fill_str);
+        test_error(error, "Failed to create program with source");
+
+        error = clBuildProgram(program, 1, &device, nullptr, nullptr, nullptr);
+        test_error(error, "Failed to build program");
+
+        kernel = clCreateKernel(program, "fill", &error);
+        test_error(error, "Failed to create fill kernel");
+
+        return CL_SUCCESS;
+    }
+
+    // setup kernel arguments, the destinations leave room for kOffset
+    cl_int SetUpKernelArgs() override
+    {
+        cl_int error = CL_SUCCESS;
+        for (clMemWrapper &buffer : dst)
+        {
+            buffer = clCreateBuffer(context, CL_MEM_WRITE_ONLY,
+                                    (num_elements + kOffset) * sizeof(cl_int),
+                                    nullptr, &error);
+            test_error(error, "clCreateBuffer failed");
+        }
+
+        cl_int zero = 0;
+        for (cl_uint i = 0; i + 1 < kFillArgs; i++)
+        {
+            error = clSetKernelArg(kernel, i, sizeof(cl_int), &zero);
+            test_error(error, "clSetKernelArg failed");
+        }
+        error = clSetKernelArg(kernel, kFillArgs - 1, sizeof(cl_mem), &dst[0]);
+        test_error(error, "clSetKernelArg failed");
+
+        return CL_SUCCESS;
+    }
+
+    cl_int Run() override
+    {
+        report_bench_header();
+
+        for (size_t count : kCommandCounts)
+        {
+            for (cl_uint args = 1; args <= kFillArgs; args++)
+            {
+                cl_int error = RunUpdate(count, kArgs, args);
+                test_error(error, "RunUpdate failed");
+            }
+
+            cl_int error;
+            if (mutable_capabilities & CL_MUTABLE_DISPATCH_GLOBAL_SIZE_KHR)
+            {
+                error = RunUpdate(count, kGlobalSize, 0);
+                test_error(error, "RunUpdate failed");
+            }
+            if (mutable_capabilities & CL_MUTABLE_DISPATCH_GLOBAL_OFFSET_KHR)
+            {
+                error = RunUpdate(count, kGlobalOffset, 0);
+                test_error(error, "RunUpdate failed");
+            }
+
+            error = RunRebuild(count);
+            test_error(error, "RunRebuild failed");
+
+            error = RunReplay(count);
+            test_error(error, "RunReplay failed");
+        }
+
+        return CL_SUCCESS;
+    }
+
+    enum UpdateKind
+    {
+        kArgs,
+        kGlobalSize,
+        kGlobalOffset,
+    };
+
+    // The values the fill kernel is run with, and what it writes
+    struct Fill
+    {
+        cl_int args[kFillArgs - 1];
+        int dst;
+        size_t offset;
+        size_t size;
+
+        cl_int Value() const { return args[0] + args[1] * 3 + args[2] * 7; }
+    };
+
+    // Host time of one update or rebuild, and until its result has run
+    struct UpdateTimes
+    {
+        double hostUs;
+        double runUs;
+    };
+
+    // Takes the update, its cost per command and the update and run as
+    // BENCH rows of their own
+    template <typename Update>
+    cl_int MeasureUpdates(const std::string &mode, size_t count, Update update)
+    {
+        std::string label = bench_label(mode.c_str(), count);
+        UpdateTimes times;
+        cl_int error = measure_bench("update", label, [&](double *us) {
+            cl_int err = update(times);
+            *us = times.hostUs;
+            return err;
+        });
+        if (error != CL_SUCCESS) return error;
+
+        error = measure_bench("update_per_command", label, [&](double *us) {
+            cl_int err = update(times);
+            *us = times.hostUs / count;
+            return err;
+        });
+        if (error != CL_SUCCESS) return error;
+
+        return measure_bench("update_and_run", label, [&](double *us) {
+            cl_int err = update(times);
+            *us = times.runUs;
+            return err;
+        });
+    }
+
+    cl_int RecordDispatches(cl_command_buffer_khr combuf, size_t count,
+                            cl_mutable_command_khr *commands)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            cl_int error = clCommandNDRangeKernelKHR(
+                combuf, nullptr, nullptr, kernel, 1, nullptr, &num_elements,
+                nullptr, 0, nullptr, nullptr,
+                commands ? &commands[i] : nullptr);
+            test_error(error, "clCommandNDRangeKernelKHR failed");
+        }
+
+        cl_int error = clFinalizeCommandBufferKHR(combuf);
+        test_error(error, "clFinalizeCommandBufferKHR failed");
+        return CL_SUCCESS;
+    }
+
+    cl_int EnqueueAndWait(cl_command_buffer_khr combuf)
+    {
+        cl_int error =
+            clEnqueueCommandBufferKHR(0, nullptr, combuf, 0, nullptr, nullptr);
+        test_error(error, "clEnqueueCommandBufferKHR failed");
+
+        error = clFinish(queue);
+        test_error(error, "clFinish failed");
+        return CL_SUCCESS;
+    }
+
+    // Checks that the last run of the dispatches wrote the fill's value over
+    // its range of its destination
+    cl_int Check(const char *name, const Fill &fill)
+    {
+        std::vector<cl_int> results(fill.size);
+        cl_int error = clEnqueueReadBuffer(
+            queue, dst[fill.dst], CL_TRUE, fill.offset * sizeof(cl_int),
+            fill.size * sizeof(cl_int), results.data(), 0, nullptr, nullptr);
+        test_error(error, "clEnqueueReadBuffer failed");
+
+        for (size_t i = 0; i < fill.size; i++)
+        {
+            if (results[i] != fill.Value())
+            {
+                log_error("ERROR: %s wrote %d at %zu of buffer %d, expected "
+                          "%d\n",
+                          name, results[i], fill.offset + i, fill.dst,
+                          fill.Value());
+                return TEST_FAIL;
+            }
+        }
+        return CL_SUCCESS;
+    }
+
+    cl_int RunUpdate(size_t count, UpdateKind kind, cl_uint args)
+    {
+        // A new mutable command-buffer for each measurement, so the handles
+        // of the previous one don't need to be tracked
+        cl_command_buffer_properties_khr props[] = {
+            CL_COMMAND_BUFFER_FLAGS_KHR, CL_COMMAND_BUFFER_MUTABLE_KHR, 0
+        };
+        cl_int error;
+        command_buffer = clCreateCommandBufferKHR(1, &queue, props, &error);
+        test_error(error, "clCreateCommandBufferKHR failed");
+
+        cl_int zero = 0;
+        for (cl_uint i = 0; i + 1 < kFillArgs; i++)
+        {
+            error = clSetKernelArg(kernel, i, sizeof(cl_int), &zero);
+            test_error(error, "clSetKernelArg failed");
+        }
+        error = clSetKernelArg(kernel, kFillArgs - 1, sizeof(cl_mem), &dst[0]);
+        test_error(error, "clSetKernelArg failed");
+
+        std::vector<cl_mutable_command_khr> commands(count);
+        error = RecordDispatches(command_buffer, count, commands.data());
+        if (error != CL_SUCCESS) return error;
+
+        // Updates point into fill, which each sample changes
+        Fill fill = { { 0, 0, 0 }, 0, 0, num_elements };
+        cl_mutable_dispatch_arg_khr arg_list[kFillArgs];
+        for (cl_uint i = 0; i + 1 < kFillArgs; i++)
+            arg_list[i] = { i, sizeof(cl_int), &fill.args[i] };
+        cl_mem dst_arg = dst[0];
+        arg_list[kFillArgs - 1] = { kFillArgs - 1, sizeof(cl_mem), &dst_arg };
+
+        std::vector<cl_mutable_dispatch_config_khr> dispatch_configs(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            dispatch_configs[i] = {
+                CL_STRUCTURE_TYPE_MUTABLE_DISPATCH_CONFIG_KHR,
+                nullptr,
+                commands[i],
+                kind == kArgs ? args : 0 /* num_args */,
+                0 /* num_svm_arg */,
+                0 /* num_exec_infos */,
+                0 /* work_dim - 0 means no change to dimensions */,
+                kind == kArgs ? arg_list : nullptr /* arg_list */,
+                nullptr /* arg_svm_list - nullptr means no change*/,
+                nullptr /* exec_info_list */,
+                kind == kGlobalOffset ? &fill.offset
+                                      : nullptr /* global_work_offset */,
+                kind == kGlobalSize ? &fill.size
+                                    : nullptr /* global_work_size */,
+                nullptr /* local_work_size */
+            };
+        }
+
+        cl_mutable_base_config_khr mutable_config{
+            CL_STRUCTURE_TYPE_MUTABLE_BASE_CONFIG_KHR, nullptr,
+            static_cast<cl_uint>(count), dispatch_configs.data()
+        };
+
+        std::string mode = kind == kArgs ? "args_" + std::to_string(args)
+            : kind == kGlobalSize        ? "global_size"
+                                         : "global_offset";
+
+        int i = 0;
+        error = MeasureUpdates(mode, count, [&](UpdateTimes &times) {
+            // Change the fields being updated, and only those
+            if (kind == kArgs)
+            {
+                for (cl_uint a = 0; a < args && a + 1 < kFillArgs; a++)
+                    fill.args[a] = i + 1 + (cl_int)a;
+                if (args == kFillArgs)
+                {
+                    fill.dst = (i + 1) % 2;
+                    dst_arg = dst[fill.dst];
+                }
+            }
+            else if (kind == kGlobalSize)
+                fill.size = (i % 2) ? num_elements : num_elements / 2;
+            else
+                fill.offset = (i % 2) ? 0 : kOffset;
+            i++;
+
+            HostTimer timer;
+            cl_int err =
+                clUpdateMutableCommandsKHR(command_buffer, &mutable_config);
+            times.hostUs = timer.elapsed_us();
+            test_error(err, "clUpdateMutableCommandsKHR failed");
+
+            err = EnqueueAndWait(command_buffer);
+            if (err != CL_SUCCESS) return err;
+            times.runUs = timer.elapsed_us();
+            return CL_SUCCESS;
+        });
+        if (error != CL_SUCCESS) return error;
+
+        // Without changed arguments the dispatches keep writing zeros to the
+        // first destination
+        return Check(mode.c_str(), fill);
+    }
+
+    cl_int RunRebuild(size_t count)
+    {
+        Fill fill = { { 0, 0, 0 }, 0, 0, num_elements };
+        cl_int error =
+            MeasureUpdates("rebuild", count, [&](UpdateTimes &times) {
+                fill.args[0]++;
+                HostTimer timer;
+                cl_int err =
+                    clSetKernelArg(kernel, 0, sizeof(cl_int), &fill.args[0]);
+                test_error(err, "clSetKernelArg failed");
+
+                clCommandBufferWrapper combuf(this);
+                combuf = clCreateCommandBufferKHR(1, &queue, nullptr, &err);
+                test_error(err, "clCreateCommandBufferKHR failed");
+
+                err = RecordDispatches(combuf, count, nullptr);
+                if (err != CL_SUCCESS) return err;
+                times.hostUs = timer.elapsed_us();
+
+                err = EnqueueAndWait(combuf);
+                if (err != CL_SUCCESS) return err;
+                times.runUs = timer.elapsed_us();
+                return CL_SUCCESS;
+            });
+        if (error != CL_SUCCESS) return error;
+
+        return Check("rebuild", fill);
+    }
+
+    // Time per replay of the command-buffer, enqueued kReplays times back to
+    // back per sample where it allows simultaneous use, and waited on after
+    // every enqueue in any case
+    cl_int RunReplay(size_t count)
+    {
+        Fill fill = { { 5, 0, 0 }, 0, 0, num_elements };
+        cl_int error =
+            clSetKernelArg(kernel, 0, sizeof(cl_int), &fill.args[0]);
+        test_error(error, "clSetKernelArg failed");
+
+        {
+            clCommandBufferWrapper combuf(this);
+            combuf = clCreateCommandBufferKHR(1, &queue, nullptr, &error);
+            test_error(error, "clCreateCommandBufferKHR failed");
+            error = RecordDispatches(combuf, count, nullptr);
+            if (error != CL_SUCCESS) return error;
+
+            error = measure_bench("replay", bench_label("serial", count),
+                                  [&](double *us) {
+                                      HostTimer timer;
+                                      cl_int err = EnqueueAndWait(combuf);
+                                      *us = timer.elapsed_us();
+                                      return err;
+                                  });
+            if (error != CL_SUCCESS) return error;
+        }
+        error = Check("serial replay", fill);
+        if (error != CL_SUCCESS) return error;
+
+        if (!simultaneous_use_support) return CL_SUCCESS;
+
+        cl_command_buffer_properties_khr props[] = {
+            CL_COMMAND_BUFFER_FLAGS_KHR, CL_COMMAND_BUFFER_SIMULTANEOUS_USE_KHR,
+            0
+        };
+        fill.args[0] = 6;
+        error = clSetKernelArg(kernel, 0, sizeof(cl_int), &fill.args[0]);
+        test_error(error, "clSetKernelArg failed");
+
+        clCommandBufferWrapper combuf(this);
+        combuf = clCreateCommandBufferKHR(1, &queue, props, &error);
+        test_error(error, "clCreateCommandBufferKHR failed");
+        error = RecordDispatches(combuf, count, nullptr);
+        if (error != CL_SUCCESS) return error;
+
+        error = measure_bench(
+            "replay", bench_label("simultaneous", count), [&](double *us) {
+                HostTimer timer;
+                for (int r = 0; r < kReplays; r++)
+                {
+                    cl_int err = clEnqueueCommandBufferKHR(0, nullptr, combuf,
+                                                           0, nullptr, nullptr);
+                    test_error(err, "clEnqueueCommandBufferKHR failed");
+                }
+                cl_int err = clFinish(queue);
+                test_error(err, "clFinish failed");
+                *us = timer.elapsed_us() / kReplays;
+                return CL_SUCCESS;
+            });
+        if (error != CL_SUCCESS) return error;
+        return Check("simultaneous replay", fill);
+    }
+
+    cl_mutable_dispatch_fields_khr mutable_capabilities = 0;
+    clMemWrapper dst[2];
+};
+
+}
+
+int test_mutable_dispatch_benchmark(cl_device_id device, cl_context context,
+                                    cl_command_queue queue, int num_elements)
+{
+    return MakeAndRunTest<MutableDispatchBenchmark>(device, context, queue,
+                                                    num_elements);
+}
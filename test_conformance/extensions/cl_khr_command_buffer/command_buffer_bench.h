@@ -0,0 +1,52 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef CL_KHR_COMMAND_BUFFER_BENCH_H
+#define CL_KHR_COMMAND_BUFFER_BENCH_H
+
+#include "harness/benchmark.h"
+#include "harness/errorHelpers.h"
+
+#include <string>
+
+inline void report_bench_header()
+{
+    log_benchmark_header("metric", "mode_commands");
+}
+
+inline std::string bench_label(const char *mode, size_t commands)
+{
+    return std::string(mode) + "_" + std::to_string(commands);
+}
+
+// Takes samples of sample in microseconds and logs them as one BENCH row
+template <typename Sample>
+inline cl_int measure_bench(const char *metric, const std::string &label,
+                            Sample sample, BenchmarkStats *stats = nullptr)
+{
+    BenchmarkOptions options;
+    options.warmup = 1;
+    options.maxSeconds = 1.0;
+    BenchmarkStats sampled;
+    cl_int error = run_benchmark(options, sample, &sampled);
+    if (error != CL_SUCCESS) return error;
+
+    log_benchmark_stats(metric, label.c_str(), "us", false, sampled);
+    if (stats) *stats = sampled;
+    return CL_SUCCESS;
+}
+
+#endif // CL_KHR_COMMAND_BUFFER_BENCH_H
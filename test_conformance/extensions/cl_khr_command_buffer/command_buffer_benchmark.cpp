@@ -0,0 +1,301 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "basic_command_buffer.h"
+#include "command_buffer_bench.h"
+#include "procs.h"
+
+namespace {
+
+// Each group is an NDRange, a copy and a fill, the mix an application
+// would record; the sweep shows how the cost of both paths scales with the
+// number of commands.
+const size_t kCommandsPerGroup = 3;
+const size_t kGroupCounts[] = { 1, 8, 64 };
+// Small commands, so the timings are dominated by submission overhead
+const int kMaxBenchElements = 4096;
+
+cl_int get_profile_ns(cl_event event, cl_profiling_info param, cl_ulong &ns)
+{
+    cl_int error =
+        clGetEventProfilingInfo(event, param, sizeof(ns), &ns, nullptr);
+    test_error(error, "clGetEventProfilingInfo failed");
+    return CL_SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Command-buffer throughput benchmark:
+// -records N commands into a command-buffer and replays it, measuring the
+//  host cost of each submit and the device time of each replay
+// -issues the same N commands directly to the queue, measuring the same
+// -is a benchmark, so it only runs when named, and reports BENCH rows rather
+//  than checking values
+
+struct CommandBufferReplayBenchmark : public BasicCommandBufferTest
+{
+    CommandBufferReplayBenchmark(cl_device_id device, cl_context context,
+                                 cl_command_queue queue)
+        : BasicCommandBufferTest(device, context, queue)
+    {
+        // Every replay is waited for, so there is no need for simultaneous use
+        simultaneous_use_requested = false;
+    }
+
+    //--------------------------------------------------------------------------
+    bool Skip() override
+    {
+        if (BasicCommandBufferTest::Skip()) return true;
+
+        Version version = get_device_cl_version(device);
+        const cl_device_info host_queue_query = version >= Version(2, 0)
+            ? CL_DEVICE_QUEUE_ON_HOST_PROPERTIES
+            : CL_DEVICE_QUEUE_PROPERTIES;
+
+        cl_command_queue_properties host_queue_props = 0;
+        int error =
+            clGetDeviceInfo(device, host_queue_query, sizeof(host_queue_props),
+                            &host_queue_props, NULL);
+        if (error != CL_SUCCESS)
+        {
+            print_error(
+                error, "clGetDeviceInfo for CL_DEVICE_QUEUE_PROPERTIES failed");
+            return true;
+        }
+
+        if ((host_queue_props & CL_QUEUE_PROFILING_ENABLE) == 0)
+        {
+            log_info(
+                "Queue property CL_QUEUE_PROFILING_ENABLE not supported \n");
+            return true;
+        }
+        return false;
+    }
+
+    //--------------------------------------------------------------------------
+    cl_int SetUp(int elements) override
+    {
+        cl_int error = CL_SUCCESS;
+        queue = clCreateCommandQueue(context, device, CL_QUEUE_PROFILING_ENABLE,
+                                     &error);
+        test_error(error, "clCreateCommandQueue failed");
+
+        error = BasicCommandBufferTest::SetUp(
+            std::min(elements, kMaxBenchElements));
+        test_error(error, "BasicCommandBufferTest::SetUp failed");
+
+        scratch_mem = clCreateBuffer(context, CL_MEM_READ_WRITE, data_size(),
+                                     nullptr, &error);
+        test_error(error, "clCreateBuffer failed");
+
+        return CL_SUCCESS;
+    }
+
+    //--------------------------------------------------------------------------
+    cl_int Run() override
+    {
+        report_bench_header();
+
+        for (size_t groups : kGroupCounts)
+        {
+            cl_int error = RunCommandBuffer(groups);
+            test_error(error, "RunCommandBuffer failed");
+
+            error = RunImmediate(groups);
+            test_error(error, "RunImmediate failed");
+        }
+
+        return CL_SUCCESS;
+    }
+
+    //--------------------------------------------------------------------------
+    cl_int RecordGroups(cl_command_buffer_khr combuf, size_t groups)
+    {
+        for (size_t i = 0; i < groups; i++)
+        {
+            cl_int error = clCommandNDRangeKernelKHR(
+                combuf, nullptr, nullptr, kernel, 1, nullptr, &num_elements,
+                nullptr, 0, nullptr, nullptr, nullptr);
+            test_error(error, "clCommandNDRangeKernelKHR failed");
+
+            error = clCommandCopyBufferKHR(combuf, nullptr, out_mem,
+                                           scratch_mem, 0, 0, data_size(), 0,
+                                           nullptr, nullptr, nullptr);
+            test_error(error, "clCommandCopyBufferKHR failed");
+
+            error = clCommandFillBufferKHR(combuf, nullptr, scratch_mem,
+                                           &pattern, sizeof(pattern), 0,
+                                           data_size(), 0, nullptr, nullptr,
+                                           nullptr);
+            test_error(error, "clCommandFillBufferKHR failed");
+        }
+
+        cl_int error = clFinalizeCommandBufferKHR(combuf);
+        test_error(error, "clFinalizeCommandBufferKHR failed");
+        return CL_SUCCESS;
+    }
+
+    //--------------------------------------------------------------------------
+    // Enqueues the same commands as RecordGroups, returning events for the
+    // first and last of them
+    cl_int EnqueueGroups(size_t groups, clEventWrapper &first,
+                         clEventWrapper &last)
+    {
+        for (size_t i = 0; i < groups; i++)
+        {
+            cl_int error = clEnqueueNDRangeKernel(
+                queue, kernel, 1, nullptr, &num_elements, nullptr, 0, nullptr,
+                i == 0 ? &first : nullptr);
+            test_error(error, "clEnqueueNDRangeKernel failed");
+
+            error = clEnqueueCopyBuffer(queue, out_mem, scratch_mem, 0, 0,
+                                        data_size(), 0, nullptr, nullptr);
+            test_error(error, "clEnqueueCopyBuffer failed");
+
+            error = clEnqueueFillBuffer(queue, scratch_mem, &pattern,
+                                        sizeof(pattern), 0, data_size(), 0,
+                                        nullptr,
+                                        i + 1 == groups ? &last : nullptr);
+            test_error(error, "clEnqueueFillBuffer failed");
+        }
+        return CL_SUCCESS;
+    }
+
+    //--------------------------------------------------------------------------
+    // Host time to submit the commands, device time from the start of the
+    // first to the end of the last, and host time until they are done
+    struct ReplayTimes
+    {
+        double submitUs;
+        double deviceUs;
+        double wallUs;
+    };
+
+    //--------------------------------------------------------------------------
+    // Takes each of the replay times of replay as its own BENCH row
+    template <typename Replay>
+    cl_int MeasureReplays(const char *mode, size_t commands, Replay replay)
+    {
+        static const struct
+        {
+            const char *metric;
+            double ReplayTimes::*us;
+        } metrics[] = {
+            { "submit", &ReplayTimes::submitUs },
+            { "device", &ReplayTimes::deviceUs },
+            { "wall", &ReplayTimes::wallUs },
+        };
+
+        for (const auto &metric : metrics)
+        {
+            cl_int error = measure_bench(metric.metric,
+                                         bench_label(mode, commands),
+                                         [&](double *us) {
+                                             ReplayTimes times;
+                                             cl_int err = replay(times);
+                                             *us = times.*metric.us;
+                                             return err;
+                                         });
+            if (error != CL_SUCCESS) return error;
+        }
+        return CL_SUCCESS;
+    }
+
+    //--------------------------------------------------------------------------
+    cl_int RunCommandBuffer(size_t groups)
+    {
+        const size_t commands = groups * kCommandsPerGroup;
+
+        // The cost of recording is paid once per command-buffer, so it is
+        // reported on its own rather than spread over the replays
+        clCommandBufferWrapper combuf(this);
+        cl_int error = measure_bench(
+            "record", bench_label("command_buffer", commands),
+            [&](double *us) -> cl_int {
+                HostTimer timer;
+                cl_int err;
+                combuf = clCreateCommandBufferKHR(1, &queue, nullptr, &err);
+                test_error(err, "clCreateCommandBufferKHR failed");
+
+                err = RecordGroups(combuf, groups);
+                if (err != CL_SUCCESS) return err;
+                *us = timer.elapsed_us();
+                return CL_SUCCESS;
+            });
+        if (error != CL_SUCCESS) return error;
+
+        return MeasureReplays(
+            "command_buffer", commands, [&](ReplayTimes &times) -> cl_int {
+                clEventWrapper event;
+                HostTimer timer;
+                cl_int err = clEnqueueCommandBufferKHR(0, nullptr, combuf, 0,
+                                                       nullptr, &event);
+                times.submitUs = timer.elapsed_us();
+                test_error(err, "clEnqueueCommandBufferKHR failed");
+
+                err = clWaitForEvents(1, &event);
+                test_error(err, "clWaitForEvents failed");
+                times.wallUs = timer.elapsed_us();
+
+                cl_ulong start, end;
+                err = get_profile_ns(event, CL_PROFILING_COMMAND_START, start);
+                if (err != CL_SUCCESS) return err;
+                err = get_profile_ns(event, CL_PROFILING_COMMAND_END, end);
+                if (err != CL_SUCCESS) return err;
+                times.deviceUs = (end > start) ? (end - start) / 1000.0 : 0.0;
+                return CL_SUCCESS;
+            });
+    }
+
+    //--------------------------------------------------------------------------
+    cl_int RunImmediate(size_t groups)
+    {
+        const size_t commands = groups * kCommandsPerGroup;
+        return MeasureReplays(
+            "immediate", commands, [&](ReplayTimes &times) -> cl_int {
+                clEventWrapper first, last;
+                HostTimer timer;
+                cl_int err = EnqueueGroups(groups, first, last);
+                times.submitUs = timer.elapsed_us();
+                if (err != CL_SUCCESS) return err;
+
+                err = clFlush(queue);
+                test_error(err, "clFlush failed");
+                err = clWaitForEvents(1, &last);
+                test_error(err, "clWaitForEvents failed");
+                times.wallUs = timer.elapsed_us();
+
+                cl_ulong start, end;
+                err = get_profile_ns(first, CL_PROFILING_COMMAND_START, start);
+                if (err != CL_SUCCESS) return err;
+                err = get_profile_ns(last, CL_PROFILING_COMMAND_END, end);
+                if (err != CL_SUCCESS) return err;
+                times.deviceUs = (end > start) ? (end - start) / 1000.0 : 0.0;
+                return CL_SUCCESS;
+            });
+    }
+
+    clMemWrapper scratch_mem;
+    const cl_int pattern = 0x1234;
+};
+
+} // anonymous namespace
+
+int test_command_buffer_throughput(cl_device_id device, cl_context context,
+                                   cl_command_queue queue, int num_elements)
+{
+    return MakeAndRunTest<CommandBufferReplayBenchmark>(device, context, queue,
+                                                        num_elements);
+}
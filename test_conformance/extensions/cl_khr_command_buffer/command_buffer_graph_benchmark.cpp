@@ -0,0 +1,432 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "basic_command_buffer.h"
+#include "command_buffer_bench.h"
+#include "harness/perfMetrics.h"
+#include "procs.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace {
+
+// One work-group per node, so independent nodes leave the device room to
+// run side by side
+const size_t kNodeItems = 64;
+// How long a node runs on its own, long enough that overlapping nodes is
+// worth more than what the overlap costs to set up
+const double kTargetNodeUs = 500.0;
+const cl_int kMaxIterations = 1 << 24;
+
+// Each node adds up its predecessors' values and its own index plus one,
+// then spins for a while on a value the compiler can't drop
+const char *kGraphNodeKernel = R"(
+    __kernel void graph_node(__global uint *values, __global uint *scratch,
+                             __global const int *preds, int node,
+                             int first_pred, int num_preds, int iterations)
+    {
+        size_t gid = get_global_id(0);
+        size_t n = get_global_size(0);
+        uint acc = (uint)node + 1u;
+        for (int p = 0; p < num_preds; p++)
+            acc += values[preds[first_pred + p] * n + gid];
+        values[node * n + gid] = acc;
+
+        uint x = acc;
+        for (int i = 0; i < iterations; i++) x = x * 1103515245u + 12345u;
+        scratch[node * n + gid] = x;
+    })";
+
+// A DAG whose nodes are listed in an order where every node comes after its
+// predecessors
+struct Graph
+{
+    const char *name;
+    std::vector<std::vector<int>> preds;
+
+    int AddNode(std::vector<int> node_preds)
+    {
+        preds.push_back(node_preds);
+        return (int)preds.size() - 1;
+    }
+
+    // Number of nodes on the longest path
+    int CriticalPath() const
+    {
+        std::vector<int> depth(preds.size(), 1);
+        for (size_t node = 0; node < preds.size(); node++)
+            for (int pred : preds[node])
+                depth[node] = std::max(depth[node], depth[pred] + 1);
+        return *std::max_element(depth.begin(), depth.end());
+    }
+
+    // The value each node's kernel writes
+    std::vector<cl_uint> Expected() const
+    {
+        std::vector<cl_uint> values(preds.size());
+        for (size_t node = 0; node < preds.size(); node++)
+        {
+            values[node] = (cl_uint)node + 1u;
+            for (int pred : preds[node]) values[node] += values[pred];
+        }
+        return values;
+    }
+};
+
+std::vector<Graph> make_graphs()
+{
+    std::vector<Graph> graphs;
+
+    // No parallelism at all, for reference
+    Graph chain = { "chain", {} };
+    int last = chain.AddNode({});
+    for (int i = 1; i < 8; i++) last = chain.AddNode({ last });
+    graphs.push_back(chain);
+
+    Graph fork_join = { "fork_join", {} };
+    int root = fork_join.AddNode({});
+    std::vector<int> branches;
+    for (int i = 0; i < 8; i++) branches.push_back(fork_join.AddNode({ root }));
+    fork_join.AddNode(branches);
+    graphs.push_back(fork_join);
+
+    // Four diamonds one after the other
+    Graph diamond = { "diamond", {} };
+    last = diamond.AddNode({});
+    for (int i = 0; i < 4; i++)
+    {
+        int left = diamond.AddNode({ last });
+        int right = diamond.AddNode({ last });
+        last = diamond.AddNode({ left, right });
+    }
+    graphs.push_back(diamond);
+
+    Graph fan_out = { "wide_fan_out", {} };
+    root = fan_out.AddNode({});
+    for (int i = 0; i < 32; i++) fan_out.AddNode({ root });
+    graphs.push_back(fan_out);
+
+    return graphs;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Command-buffer graph benchmark: records DAG-shaped workloads, a chain,
+// fork/join, stacked diamonds and a wide fan-out, with sync points carrying
+// the dependencies, and replays them. The makespan of each replay is set
+// against the critical path of the graph times the time of a node on its
+// own, the shortest the graph can take, and against all its nodes one after
+// the other. Graphs are recorded and replayed on an in-order queue and, where
+// the device supports out-of-order command-buffers, an out-of-order queue,
+// and each is also replayed on a substitute queue with the same properties.
+// A benchmark, so it only runs when named. The values of every node are
+// checked after the replays.
+
+struct CommandBufferGraphBenchmark : public BasicCommandBufferTest
+{
+    CommandBufferGraphBenchmark(cl_device_id device, cl_context context,
+                                cl_command_queue queue)
+        : BasicCommandBufferTest(device, context, queue)
+    {
+        // Every replay is waited for, so there is no need for simultaneous use
+        simultaneous_use_requested = false;
+    }
+
+    //--------------------------------------------------------------------------
+    bool Skip() override
+    {
+        if (BasicCommandBufferTest::Skip()) return true;
+
+        cl_command_queue_properties queue_properties;
+        cl_int error = clGetDeviceInfo(
+            device, CL_DEVICE_QUEUE_PROPERTIES, sizeof(queue_properties),
+            &queue_properties, nullptr);
+        test_error_ret(error, "Unable to query CL_DEVICE_QUEUE_PROPERTIES",
+                       true);
+        out_of_order_queues = out_of_order_support
+            && (queue_properties & CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE);
+        return false;
+    }
+
+    //--------------------------------------------------------------------------
+    cl_int SetUpKernel() override
+    {
+        cl_int error = create_single_kernel_helper(
+            context, &program, &kernel, 1, &kGraphNodeKernel, "graph_node");
+        test_error(error, "Failed to create graph_node kernel");
+        return CL_SUCCESS;
+    }
+
+    //--------------------------------------------------------------------------
+    cl_int SetUpKernelArgs() override { return CL_SUCCESS; }
+
+    //--------------------------------------------------------------------------
+    cl_int Run() override
+    {
+        std::vector<Graph> graphs = make_graphs();
+        size_t max_nodes = 0, max_edges = 0;
+        for (const Graph &graph : graphs)
+        {
+            max_nodes = std::max(max_nodes, graph.preds.size());
+            size_t edges = 0;
+            for (const std::vector<int> &node_preds : graph.preds)
+                edges += node_preds.size();
+            max_edges = std::max(max_edges, edges);
+        }
+
+        cl_int error;
+        values = clCreateBuffer(context, CL_MEM_READ_WRITE,
+                                max_nodes * kNodeItems * sizeof(cl_uint),
+                                nullptr, &error);
+        test_error(error, "clCreateBuffer failed");
+        scratch = clCreateBuffer(context, CL_MEM_READ_WRITE,
+                                 max_nodes * kNodeItems * sizeof(cl_uint),
+                                 nullptr, &error);
+        test_error(error, "clCreateBuffer failed");
+        preds = clCreateBuffer(context, CL_MEM_READ_ONLY,
+                               std::max<size_t>(max_edges, 1) * sizeof(cl_int),
+                               nullptr, &error);
+        test_error(error, "clCreateBuffer failed");
+
+        double node_us;
+        error = Calibrate(node_us);
+        if (error != CL_SUCCESS) return error;
+        log_info("Nodes run for %d iterations, %.1f us on their own\n",
+                 iterations, node_us);
+
+        struct QueueMode
+        {
+            const char *name;
+            cl_command_queue_properties properties;
+        };
+        std::vector<QueueMode> modes = { { "in_order", 0 } };
+        if (out_of_order_queues)
+            modes.push_back(
+                { "out_of_order", CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE });
+        else
+            log_info("The device has no out-of-order command-buffers, only "
+                     "measuring in-order queues\n");
+
+        log_benchmark_header("metric", "graph_queue");
+        for (const Graph &graph : graphs)
+        {
+            for (const QueueMode &mode : modes)
+            {
+                clCommandQueueWrapper record_queue =
+                    clCreateCommandQueue(context, device, mode.properties,
+                                         &error);
+                test_error(error, "clCreateCommandQueue failed");
+                clCommandQueueWrapper substitute_queue =
+                    clCreateCommandQueue(context, device, mode.properties,
+                                         &error);
+                test_error(error, "clCreateCommandQueue failed");
+
+                error = RunGraph(graph, mode.name, record_queue, nullptr,
+                                 node_us);
+                if (error != CL_SUCCESS) return error;
+
+                std::string substituted =
+                    std::string(mode.name) + "_substituted";
+                error = RunGraph(graph, substituted.c_str(), record_queue,
+                                 substitute_queue, node_us);
+                if (error != CL_SUCCESS) return error;
+            }
+        }
+
+        return CL_SUCCESS;
+    }
+
+    //--------------------------------------------------------------------------
+    cl_int SetNodeArgs(int node, int first_pred, int num_preds)
+    {
+        cl_int error = clSetKernelArg(kernel, 0, sizeof(values), &values);
+        error |= clSetKernelArg(kernel, 1, sizeof(scratch), &scratch);
+        error |= clSetKernelArg(kernel, 2, sizeof(preds), &preds);
+        error |= clSetKernelArg(kernel, 3, sizeof(node), &node);
+        error |= clSetKernelArg(kernel, 4, sizeof(first_pred), &first_pred);
+        error |= clSetKernelArg(kernel, 5, sizeof(num_preds), &num_preds);
+        error |= clSetKernelArg(kernel, 6, sizeof(iterations), &iterations);
+        test_error(error, "clSetKernelArg failed");
+        return CL_SUCCESS;
+    }
+
+    //--------------------------------------------------------------------------
+    // Median time of one node enqueued and waited on by itself
+    cl_int TimeNode(double &node_us)
+    {
+        cl_int error = SetNodeArgs(0, 0, 0);
+        if (error != CL_SUCCESS) return error;
+
+        BenchmarkOptions options;
+        options.warmup = 1;
+        options.maxSeconds = 0.25;
+        BenchmarkStats stats;
+        error = run_benchmark(
+            options,
+            [&](double *us) {
+                HostTimer timer;
+                cl_int err = clEnqueueNDRangeKernel(queue, kernel, 1, nullptr,
+                                                    &kNodeItems, nullptr, 0,
+                                                    nullptr, nullptr);
+                test_error(err, "clEnqueueNDRangeKernel failed");
+                err = clFinish(queue);
+                test_error(err, "clFinish failed");
+                *us = timer.elapsed_us();
+                return CL_SUCCESS;
+            },
+            &stats);
+        if (error != CL_SUCCESS) return error;
+        node_us = stats.median;
+        return CL_SUCCESS;
+    }
+
+    //--------------------------------------------------------------------------
+    // Scales the iterations until a node takes about kTargetNodeUs
+    cl_int Calibrate(double &node_us)
+    {
+        iterations = 1024;
+        for (;;)
+        {
+            cl_int error = TimeNode(node_us);
+            if (error != CL_SUCCESS) return error;
+            if (node_us >= kTargetNodeUs / 2 || iterations >= kMaxIterations)
+                return CL_SUCCESS;
+
+            double scale = node_us > 0 ? kTargetNodeUs / node_us : 16.0;
+            iterations = (cl_int)std::min<double>(
+                kMaxIterations, iterations * std::min(scale, 16.0));
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    // Records the graph on the record queue and replays it there, or on the
+    // substitute queue when there is one
+    cl_int RunGraph(const Graph &graph, const char *mode,
+                    cl_command_queue record_queue,
+                    cl_command_queue substitute_queue, double node_us)
+    {
+        std::vector<cl_int> edges;
+        for (const std::vector<int> &node_preds : graph.preds)
+            edges.insert(edges.end(), node_preds.begin(), node_preds.end());
+        cl_int error = CL_SUCCESS;
+        if (!edges.empty())
+        {
+            error = clEnqueueWriteBuffer(record_queue, preds, CL_TRUE, 0,
+                                         edges.size() * sizeof(cl_int),
+                                         edges.data(), 0, nullptr, nullptr);
+            test_error(error, "clEnqueueWriteBuffer failed");
+        }
+
+        clCommandBufferWrapper combuf(this);
+        combuf = clCreateCommandBufferKHR(1, &record_queue, nullptr, &error);
+        test_error(error, "clCreateCommandBufferKHR failed");
+
+        std::vector<cl_sync_point_khr> sync_points(graph.preds.size());
+        int first_pred = 0;
+        for (size_t node = 0; node < graph.preds.size(); node++)
+        {
+            const std::vector<int> &node_preds = graph.preds[node];
+            std::vector<cl_sync_point_khr> wait_list;
+            for (int pred : node_preds) wait_list.push_back(sync_points[pred]);
+
+            error = SetNodeArgs((int)node, first_pred, (int)node_preds.size());
+            if (error != CL_SUCCESS) return error;
+            error = clCommandNDRangeKernelKHR(
+                combuf, nullptr, nullptr, kernel, 1, nullptr, &kNodeItems,
+                nullptr, (cl_uint)wait_list.size(),
+                wait_list.empty() ? nullptr : wait_list.data(),
+                &sync_points[node], nullptr);
+            test_error(error, "clCommandNDRangeKernelKHR failed");
+            first_pred += (int)node_preds.size();
+        }
+        error = clFinalizeCommandBufferKHR(combuf);
+        test_error(error, "clFinalizeCommandBufferKHR failed");
+
+        cl_command_queue replay_queue =
+            substitute_queue ? substitute_queue : record_queue;
+        std::string label = std::string(graph.name) + "_" + mode;
+        BenchmarkStats makespan;
+        error = measure_bench(
+            "makespan", label,
+            [&](double *us) {
+                HostTimer timer;
+                cl_int err = clEnqueueCommandBufferKHR(
+                    substitute_queue ? 1 : 0,
+                    substitute_queue ? &replay_queue : nullptr, combuf, 0,
+                    nullptr, nullptr);
+                test_error(err, "clEnqueueCommandBufferKHR failed");
+                err = clFinish(replay_queue);
+                test_error(err, "clFinish failed");
+                *us = timer.elapsed_us();
+                return CL_SUCCESS;
+            },
+            &makespan);
+        if (error != CL_SUCCESS) return error;
+
+        error = Check(graph, replay_queue);
+        if (error != CL_SUCCESS) return error;
+
+        int critical_path = graph.CriticalPath();
+        double serial_us = graph.preds.size() * node_us;
+        log_info("%s: %zu nodes, critical path of %d, %.1f us against %.1f us "
+                 "on the critical path and %.1f us serially\n",
+                 label.c_str(), graph.preds.size(), critical_path,
+                 makespan.median, critical_path * node_us, serial_us);
+        if (makespan.median > 0)
+            record_perf_metric("command_buffer_graph_parallelism." + label,
+                               serial_us / makespan.median, "ratio", true);
+        return CL_SUCCESS;
+    }
+
+    //--------------------------------------------------------------------------
+    cl_int Check(const Graph &graph, cl_command_queue read_queue)
+    {
+        std::vector<cl_uint> results(graph.preds.size() * kNodeItems);
+        cl_int error = clEnqueueReadBuffer(
+            read_queue, values, CL_TRUE, 0, results.size() * sizeof(cl_uint),
+            results.data(), 0, nullptr, nullptr);
+        test_error(error, "clEnqueueReadBuffer failed");
+
+        std::vector<cl_uint> expected = graph.Expected();
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            if (results[i] != expected[i / kNodeItems])
+            {
+                log_error("ERROR: %s node %zu work-item %zu wrote %u, "
+                          "expected %u\n",
+                          graph.name, i / kNodeItems, i % kNodeItems,
+                          results[i], expected[i / kNodeItems]);
+                return TEST_FAIL;
+            }
+        }
+        return CL_SUCCESS;
+    }
+
+    clMemWrapper values;
+    clMemWrapper scratch;
+    clMemWrapper preds;
+    cl_int iterations = 0;
+    bool out_of_order_queues = false;
+};
+
+} // anonymous namespace
+
+int test_command_buffer_graph(cl_device_id device, cl_context context,
+                              cl_command_queue queue, int num_elements)
+{
+    return MakeAndRunTest<CommandBufferGraphBenchmark>(device, context, queue,
+                                                       num_elements);
+}
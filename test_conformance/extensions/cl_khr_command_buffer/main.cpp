@@ -158,6 +158,8 @@ test_definition test_list[] = {
     ADD_TEST(negative_enqueue_queue_with_different_context),
     ADD_TEST(negative_enqueue_command_buffer_different_context_than_event),
     ADD_TEST(negative_enqueue_event_wait_list_null_or_events_null),
+    ADD_BENCHMARK(command_buffer_throughput),
+    ADD_BENCHMARK(command_buffer_graph),
 };
 
 int main(int argc, const char *argv[])
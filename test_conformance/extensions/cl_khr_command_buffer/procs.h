@@ -395,5 +395,14 @@ extern int test_negative_enqueue_event_wait_list_null_or_events_null(
     cl_device_id device, cl_context context, cl_command_queue queue,
     int num_elements);
 
+// Command-buffer benchmarks, only run when named
+extern int test_command_buffer_throughput(cl_device_id device,
+                                          cl_context context,
+                                          cl_command_queue queue,
+                                          int num_elements);
+extern int test_command_buffer_graph(cl_device_id device, cl_context context,
+                                     cl_command_queue queue,
+                                     int num_elements);
+
 
 #endif // CL_KHR_COMMAND_BUFFER_PROCS_H
@@ -27,7 +27,8 @@ test_definition test_list[] = { ADD_TEST(context_create),
                                 ADD_TEST(kernel),
                                 ADD_TEST(other_data_types),
                                 ADD_TEST(memory_access),
-                                ADD_TEST(interop_user_sync) };
+                                ADD_TEST(interop_user_sync),
+                                ADD_BENCHMARK(frame_throughput) };
 
 const int test_num = ARRAY_SIZE(test_list);
 
@@ -18,6 +18,8 @@
 #ifndef __MEDIA_SHARING_PROCS_H__
 #define __MEDIA_SHARING_PROCS_H__
 
+#include "harness/parseParameters.h"
+
 
 extern int test_context_create(cl_device_id deviceID, cl_context context,
                                cl_command_queue queue, int num_elements);
@@ -33,6 +35,8 @@ extern int test_memory_access(cl_device_id deviceID, cl_context context,
                               cl_command_queue queue, int num_elements);
 extern int test_interop_user_sync(cl_device_id deviceID, cl_context context,
                                   cl_command_queue queue, int num_elements);
+extern int test_frame_throughput(cl_device_id deviceID, cl_context context,
+                                 cl_command_queue queue, int num_elements);
 
 
 #endif // #ifndef __MEDIA_SHARING_PROCS_H__
\ No newline at end of file
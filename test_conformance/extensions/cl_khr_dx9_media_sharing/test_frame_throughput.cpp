@@ -0,0 +1,486 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+
+#include "harness/errorHelpers.h"
+#include "harness/kernelHelpers.h"
+#include "harness/benchmark.h"
+#include "harness/perfMetrics.h"
+
+#include "utils.h"
+#include "procs.h"
+
+// How many video frames a second go through the media surface sharing path:
+// acquire the planes of a DX9 surface, run a kernel over every plane and
+// release them again, for NV12 and YV12 surfaces at common video
+// resolutions. The kernel writes each plane XORed with a per-frame key into a
+// buffer, which is checked against the surface contents after the last
+// frame. A benchmark, so it only runs when named.
+
+namespace {
+
+struct VideoResolution
+{
+    const char *name;
+    unsigned int width;
+    unsigned int height;
+};
+
+const VideoResolution RESOLUTIONS[] = {
+    { "480p", 720, 480 },
+    { "720p", 1280, 720 },
+    { "1080p", 1920, 1080 },
+    { "2160p", 3840, 2160 },
+};
+
+const char *PROGRAM_STR =
+    "__kernel void ProcessPlane(read_only image2d_t plane, "
+    "__global uchar *out," NL "                           uint channels, "
+    "uint key)" NL "{" NL "  int x = get_global_id(0);" NL
+    "  int y = get_global_id(1);" NL
+    "  float4 texel = read_imagef(plane, (int2)(x, y));" NL
+    "  size_t idx = (y * get_global_size(0) + x) * channels;" NL
+    "  out[idx] = convert_uchar_sat_rte(texel.x * 255.0f) ^ key;" NL
+    "  if (channels == 2)" NL
+    "    out[idx + 1] = convert_uchar_sat_rte(texel.y * 255.0f) ^ key;" NL
+    "}" NL;
+
+// The NV12 UV plane holds two channels per texel, every other plane one
+unsigned int PlaneChannels(TSurfaceFormat surfaceFormat, unsigned int planeIdx)
+{
+    return (surfaceFormat == SURFACE_FORMAT_NV12 && planeIdx == 1) ? 2 : 1;
+}
+
+// Byte-wise XOR of the whole frame, kept to a flat loop over contiguous
+// memory so the compiler vectorises it
+void FrameXor(const std::vector<cl_uchar> &in, cl_uchar key,
+              std::vector<cl_uchar> &out)
+{
+    out.resize(in.size());
+    const cl_uchar *src = in.data();
+    cl_uchar *dst = out.data();
+    for (size_t i = 0, n = in.size(); i < n; ++i) dst[i] = src[i] ^ key;
+}
+
+// memcmp for the common case, and a search for the first difference only
+// to report it
+bool FrameCompare(const std::vector<cl_uchar> &test,
+                  const std::vector<cl_uchar> &ref)
+{
+    if (test.size() == ref.size()
+        && memcmp(test.data(), ref.data(), ref.size()) == 0)
+        return true;
+
+    for (size_t i = 0; i < ref.size(); ++i)
+    {
+        if (test[i] != ref[i])
+        {
+            log_error("Frame byte %zu is %u, expected %u\n", i, test[i],
+                      ref[i]);
+            break;
+        }
+    }
+    return false;
+}
+
+// Host times of one frame, in microseconds
+struct FrameTimes
+{
+    double acquire;
+    double kernel;
+    double release;
+    double frame;
+};
+
+// Acquire the planes, run the kernel over each with key and release them
+// again
+cl_int ProcessFrame(cl_command_queue cmdQueue, cl_kernel kernel,
+                    std::vector<cl_mem> &memObjList,
+                    std::vector<clMemWrapper> &outList, unsigned int width,
+                    unsigned int height, TSurfaceFormat surfaceFormat,
+                    cl_uint key, FrameTimes *times)
+{
+    HostTimer timer;
+    cl_int error = clEnqueueAcquireDX9MediaSurfacesKHR(
+        cmdQueue, static_cast<cl_uint>(memObjList.size()), &memObjList.at(0),
+        0, NULL, NULL);
+    if (error == CL_SUCCESS) error = clFinish(cmdQueue);
+    if (error != CL_SUCCESS)
+    {
+        log_error("clEnqueueAcquireDX9MediaSurfacesKHR failed: %s\n",
+                  IGetErrorString(error));
+        return error;
+    }
+    double acquiredUs = timer.elapsed_us();
+
+    for (unsigned int planeIdx = 0; planeIdx < memObjList.size(); ++planeIdx)
+    {
+        size_t threads[2] = { (planeIdx == 0) ? width : width / 2,
+                              (planeIdx == 0) ? height : height / 2 };
+        cl_uint channels = PlaneChannels(surfaceFormat, planeIdx);
+        error = clSetKernelArg(kernel, 0, sizeof(cl_mem),
+                               &memObjList[planeIdx]);
+        error |= clSetKernelArg(kernel, 1, sizeof(cl_mem), &outList[planeIdx]);
+        error |= clSetKernelArg(kernel, 2, sizeof(channels), &channels);
+        error |= clSetKernelArg(kernel, 3, sizeof(key), &key);
+        if (error != CL_SUCCESS)
+        {
+            log_error("Unable to set kernel arguments\n");
+            return error;
+        }
+
+        error = clEnqueueNDRangeKernel(cmdQueue, kernel, 2, NULL, threads,
+                                       NULL, 0, NULL, NULL);
+        if (error != CL_SUCCESS)
+        {
+            log_error("clEnqueueNDRangeKernel failed: %s\n",
+                      IGetErrorString(error));
+            return error;
+        }
+    }
+    error = clFinish(cmdQueue);
+    if (error != CL_SUCCESS)
+    {
+        log_error("clFinish failed: %s\n", IGetErrorString(error));
+        return error;
+    }
+    double ranUs = timer.elapsed_us();
+
+    error = clEnqueueReleaseDX9MediaSurfacesKHR(
+        cmdQueue, static_cast<cl_uint>(memObjList.size()), &memObjList.at(0),
+        0, NULL, NULL);
+    if (error == CL_SUCCESS) error = clFinish(cmdQueue);
+    if (error != CL_SUCCESS)
+    {
+        log_error("clEnqueueReleaseDX9MediaSurfacesKHR failed: %s\n",
+                  IGetErrorString(error));
+        return error;
+    }
+    double releasedUs = timer.elapsed_us();
+
+    times->acquire = acquiredUs;
+    times->kernel = ranUs - acquiredUs;
+    times->release = releasedUs - ranUs;
+    times->frame = releasedUs;
+    return CL_SUCCESS;
+}
+
+} // anonymous namespace
+
+int frame_throughput(unsigned int width, unsigned int height,
+                     const char *resolutionName,
+                     cl_dx9_media_adapter_type_khr adapterType,
+                     TSurfaceFormat surfaceFormat)
+{
+    CResult result;
+
+    std::auto_ptr<CDeviceWrapper> deviceWrapper;
+    if (!DeviceCreate(adapterType, deviceWrapper))
+    {
+        result.ResultSub(CResult::TEST_ERROR);
+        return result.Result();
+    }
+
+    std::vector<cl_uchar> bufferIn(width * height * 3 / 2, 0);
+    if (!YUVGenerate(surfaceFormat, bufferIn, width, height, 0, 255))
+    {
+        result.ResultSub(CResult::TEST_ERROR);
+        return result.Result();
+    }
+
+    std::string adapterStr;
+    std::string formatStr;
+    AdapterToString(adapterType, adapterStr);
+    SurfaceFormatToString(surfaceFormat, formatStr);
+
+    while (deviceWrapper->AdapterNext())
+    {
+        cl_int error;
+        if (CL_SUCCESS
+            != (error = deviceExistForCLTest(gPlatformIDdetected, adapterType,
+                                             deviceWrapper->Device(), result)))
+        {
+            return result.Result();
+        }
+
+        if (surfaceFormat != SURFACE_FORMAT_NV12
+            && !SurfaceFormatCheck(adapterType, *deviceWrapper, surfaceFormat))
+        {
+            log_info("Skipping %s, image format is not supported by a device "
+                     "(adapter type: %s)\n",
+                     formatStr.c_str(), adapterStr.c_str());
+            return result.Result();
+        }
+
+        void *objectSharedHandle = 0;
+        std::auto_ptr<CSurfaceWrapper> surface;
+        if (!MediaSurfaceCreate(adapterType, width, height, surfaceFormat,
+                                *deviceWrapper, surface, false,
+                                &objectSharedHandle))
+        {
+            log_error("Media surface creation failed for %i adapter\n",
+                      deviceWrapper->AdapterIdx());
+            result.ResultSub(CResult::TEST_ERROR);
+            return result.Result();
+        }
+
+        if (!YUVSurfaceSet(surfaceFormat, surface, bufferIn, width, height))
+        {
+            result.ResultSub(CResult::TEST_ERROR);
+            return result.Result();
+        }
+
+        cl_context_properties contextProperties[] = {
+            CL_CONTEXT_PLATFORM,
+            (cl_context_properties)gPlatformIDdetected,
+            AdapterTypeToContextInfo(adapterType),
+            (cl_context_properties)deviceWrapper->Device(),
+            0,
+        };
+
+        clContextWrapper ctx = clCreateContext(
+            &contextProperties[0], 1, &gDeviceIDdetected, NULL, NULL, &error);
+        if (error != CL_SUCCESS)
+        {
+            log_error("clCreateContext failed: %s\n", IGetErrorString(error));
+            result.ResultSub(CResult::TEST_FAIL);
+            return result.Result();
+        }
+
+#if defined(_WIN32)
+        cl_dx9_surface_info_khr surfaceInfo;
+        surfaceInfo.resource =
+            *(static_cast<CD3D9SurfaceWrapper *>(surface.get()));
+        surfaceInfo.shared_handle = objectSharedHandle;
+#else
+        void *surfaceInfo = 0;
+        return TEST_NOT_IMPLEMENTED;
+#endif
+
+        std::vector<cl_mem> memObjList;
+        unsigned int planesNum = PlanesNum(surfaceFormat);
+        std::vector<clMemWrapper> planesList(planesNum);
+        for (unsigned int planeIdx = 0; planeIdx < planesNum; ++planeIdx)
+        {
+            planesList[planeIdx] = clCreateFromDX9MediaSurfaceKHR(
+                ctx, CL_MEM_READ_ONLY, adapterType, &surfaceInfo, planeIdx,
+                &error);
+            if (error != CL_SUCCESS)
+            {
+                log_error(
+                    "clCreateFromDX9MediaSurfaceKHR failed for plane %i: %s\n",
+                    planeIdx, IGetErrorString(error));
+                result.ResultSub(CResult::TEST_FAIL);
+                return result.Result();
+            }
+            memObjList.push_back(planesList[planeIdx]);
+        }
+
+        clCommandQueueWrapper cmdQueue = clCreateCommandQueueWithProperties(
+            ctx, gDeviceIDdetected, 0, &error);
+        if (error != CL_SUCCESS)
+        {
+            log_error("Unable to create command queue: %s\n",
+                      IGetErrorString(error));
+            result.ResultSub(CResult::TEST_FAIL);
+            return result.Result();
+        }
+
+        clProgramWrapper program;
+        clKernelWrapper kernel;
+        if (create_single_kernel_helper(ctx, &program, &kernel, 1,
+                                        &PROGRAM_STR, "ProcessPlane"))
+        {
+            result.ResultSub(CResult::TEST_FAIL);
+            return result.Result();
+        }
+
+        size_t frameSize = bufferIn.size();
+        std::vector<clMemWrapper> outList(planesNum);
+        std::vector<size_t> planeOffsets(planesNum);
+        size_t offset = 0;
+        for (unsigned int planeIdx = 0; planeIdx < planesNum; ++planeIdx)
+        {
+            size_t planeWidth = (planeIdx == 0) ? width : width / 2;
+            size_t planeHeight = (planeIdx == 0) ? height : height / 2;
+            size_t planeSize = planeWidth * planeHeight
+                * PlaneChannels(surfaceFormat, planeIdx);
+            outList[planeIdx] = clCreateBuffer(ctx, CL_MEM_WRITE_ONLY,
+                                               planeSize, NULL, &error);
+            if (error != CL_SUCCESS)
+            {
+                log_error("clCreateBuffer failed: %s\n",
+                          IGetErrorString(error));
+                result.ResultSub(CResult::TEST_FAIL);
+                return result.Result();
+            }
+            planeOffsets[planeIdx] = offset;
+            offset += planeSize;
+        }
+
+        static const struct
+        {
+            const char *name;
+            double FrameTimes::*us;
+        } phases[] = {
+            { "acquire", &FrameTimes::acquire },
+            { "kernel", &FrameTimes::kernel },
+            { "release", &FrameTimes::release },
+            { "frame", &FrameTimes::frame },
+        };
+
+        std::string label = adapterStr + "/"
+            + std::to_string(deviceWrapper->AdapterIdx()) + "/" + formatStr
+            + "/" + resolutionName;
+        BenchmarkOptions options;
+        options.warmup = 1;
+        options.maxSeconds = 1.0;
+        // Every frame has its own key, so the output is of the last one
+        cl_uint frameIdx = 0;
+        for (const auto &phase : phases)
+        {
+            BenchmarkStats stats;
+            error = run_benchmark(
+                options,
+                [&](double *us) {
+                    FrameTimes times;
+                    cl_int err = ProcessFrame(
+                        cmdQueue, kernel, memObjList, outList, width, height,
+                        surfaceFormat, frameIdx++ & 0xff, &times);
+                    *us = times.*phase.us;
+                    return err;
+                },
+                &stats);
+            if (error != CL_SUCCESS)
+            {
+                result.ResultSub(CResult::TEST_FAIL);
+                return result.Result();
+            }
+
+            std::string row = label + "/" + phase.name;
+            log_benchmark_stats("dx9_frame", row.c_str(), "us", false, stats);
+            if (phase.us == &FrameTimes::frame && stats.median > 0)
+            {
+                record_perf_metric("dx9_frame_fps." + label,
+                                   1e6 / stats.median, "fps", true);
+                record_perf_metric("dx9_frame_MBps." + label,
+                                   frameSize / stats.median, "MB/s", true);
+            }
+        }
+
+        // The last frame's output is the surface XORed with its key
+        std::vector<cl_uchar> out(frameSize, 0);
+        for (unsigned int planeIdx = 0; planeIdx < planesNum; ++planeIdx)
+        {
+            size_t planeSize = (planeIdx + 1 < planesNum
+                                    ? planeOffsets[planeIdx + 1]
+                                    : frameSize)
+                - planeOffsets[planeIdx];
+            error = clEnqueueReadBuffer(cmdQueue, outList[planeIdx], CL_TRUE,
+                                        0, planeSize,
+                                        &out.at(planeOffsets[planeIdx]), 0,
+                                        NULL, NULL);
+            if (error != CL_SUCCESS)
+            {
+                log_error("clEnqueueReadBuffer failed: %s\n",
+                          IGetErrorString(error));
+                result.ResultSub(CResult::TEST_FAIL);
+                return result.Result();
+            }
+        }
+
+        std::vector<cl_uchar> expected;
+        FrameXor(bufferIn, (cl_uchar)((frameIdx - 1) & 0xff), expected);
+        if (!FrameCompare(out, expected))
+        {
+            log_error("Processed frame is different than expected (%s, %s, "
+                      "%s)\n",
+                      adapterStr.c_str(), formatStr.c_str(), resolutionName);
+            result.ResultSub(CResult::TEST_FAIL);
+            return result.Result();
+        }
+    }
+
+    if (deviceWrapper->Status() != DEVICE_PASS)
+    {
+        if (deviceWrapper->Status() == DEVICE_FAIL)
+        {
+            log_error("%s init failed\n", adapterStr.c_str());
+            result.ResultSub(CResult::TEST_FAIL);
+        }
+        else
+        {
+            log_error("%s init incomplete due to unsupported device\n",
+                      adapterStr.c_str());
+            result.ResultSub(CResult::TEST_NOTSUPPORTED);
+        }
+    }
+
+    return result.Result();
+}
+
+int test_frame_throughput(cl_device_id deviceID, cl_context context,
+                          cl_command_queue queue, int num_elements)
+{
+    std::vector<cl_dx9_media_adapter_type_khr> adapters;
+#if defined(_WIN32)
+    adapters.push_back(CL_ADAPTER_D3D9_KHR);
+    adapters.push_back(CL_ADAPTER_D3D9EX_KHR);
+    adapters.push_back(CL_ADAPTER_DXVA_KHR);
+#else
+    return TEST_NOT_IMPLEMENTED;
+#endif
+
+    std::vector<TSurfaceFormat> formats;
+    formats.push_back(SURFACE_FORMAT_NV12);
+    formats.push_back(SURFACE_FORMAT_YV12);
+
+    log_benchmark_header("dx9_frame", "adapter/index/format/resolution/phase");
+
+    CResult result;
+    for (size_t adapterIdx = 0; adapterIdx < adapters.size(); ++adapterIdx)
+    {
+        for (size_t formatIdx = 0; formatIdx < formats.size(); ++formatIdx)
+        {
+            for (size_t resIdx = 0; resIdx < ARRAY_SIZE(RESOLUTIONS); ++resIdx)
+            {
+                const VideoResolution &resolution = RESOLUTIONS[resIdx];
+                if (frame_throughput(resolution.width, resolution.height,
+                                     resolution.name, adapters[adapterIdx],
+                                     formats[formatIdx])
+                    != 0)
+                {
+                    std::string adapterStr;
+                    std::string formatStr;
+                    SurfaceFormatToString(formats[formatIdx], formatStr);
+                    AdapterToString(adapters[adapterIdx], adapterStr);
+
+                    log_error("\nTest case - frame throughput (%s, %s, %s) "
+                              "failed\n\n",
+                              adapterStr.c_str(), formatStr.c_str(),
+                              resolution.name);
+                    result.ResultSub(CResult::TEST_FAIL);
+                }
+            }
+        }
+    }
+
+    return result.Result();
+}
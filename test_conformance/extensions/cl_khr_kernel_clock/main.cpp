@@ -19,6 +19,7 @@ test_definition test_list[] = {
     ADD_TEST(device_scope),
     ADD_TEST(workgroup_scope),
     ADD_TEST(subgroup_scope),
+    ADD_TEST(work_group_timing),
 };
 
 
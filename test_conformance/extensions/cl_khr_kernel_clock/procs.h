@@ -23,5 +23,7 @@ int test_workgroup_scope(cl_device_id device, cl_context context,
                          cl_command_queue queue, int num_elements);
 int test_subgroup_scope(cl_device_id device, cl_context context,
                         cl_command_queue queue, int num_elements);
+int test_work_group_timing(cl_device_id device, cl_context context,
+                           cl_command_queue queue, int num_elements);
 
 #endif /*CL_KHR_KERNEL_CLOCK_PROCS_H*/
@@ -0,0 +1,121 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "procs.h"
+#include "harness/kernelClock.h"
+#include "harness/typeWrappers.h"
+
+#include <algorithm>
+
+// The harness kernel clock probe on a 1D and a 2D NDRange: every work-group
+// must store its clocks, and no group may end before it starts.
+
+namespace {
+
+const char *kTimedKernel = R"(
+    __kernel void timed_work(__global uint *dst, int iterations,
+                             __global uint2 *clocks)
+    {
+        KERNEL_CLOCK_BEGIN();
+        size_t id = get_global_id(0) + get_global_size(0) * get_global_id(1);
+        uint acc = (uint)id;
+        for (int i = 0; i < iterations; i++) acc = acc * 1664525u + 1013904223u;
+        dst[id] = acc;
+        KERNEL_CLOCK_END(clocks);
+    }
+)";
+
+const size_t kGroups = 64;
+const cl_int kIterations = 4096;
+
+int check_timing(KernelClockProbe &probe, cl_command_queue queue,
+                 cl_kernel kernel, cl_uint dims, const size_t *global,
+                 const size_t *local, const char *label)
+{
+    size_t groups = 1;
+    for (cl_uint i = 0; i < dims; i++) groups *= global[i] / local[i];
+
+    cl_int error = probe.prepare(queue, groups);
+    if (error != CL_SUCCESS) return TEST_FAIL;
+    cl_mem clocks = probe.buffer();
+    error = clSetKernelArg(kernel, 2, sizeof(clocks), &clocks);
+    test_error(error, "clSetKernelArg failed");
+
+    error = clEnqueueNDRangeKernel(queue, kernel, dims, NULL, global, local, 0,
+                                   NULL, NULL);
+    test_error(error, "clEnqueueNDRangeKernel failed");
+
+    KernelClockStats stats;
+    error = probe.collect(queue, &stats);
+    if (error != CL_SUCCESS) return TEST_FAIL;
+    log_kernel_clock_stats(label, stats);
+
+    if (stats.missing || stats.backwards)
+    {
+        log_error("ERROR: %zu of %zu work-groups stored no clocks and %zu "
+                  "ended before they started.\n",
+                  stats.missing, stats.groups, stats.backwards);
+        return TEST_FAIL;
+    }
+    return TEST_PASS;
+}
+
+} // anonymous namespace
+
+int test_work_group_timing(cl_device_id device, cl_context context,
+                           cl_command_queue queue, int num_elements)
+{
+    KernelClockProbe probe(device, context);
+    if (!probe.supported())
+    {
+        log_info("The device has no device or work group scope kernel "
+                 "clock.\n");
+        return TEST_SKIPPED_ITSELF;
+    }
+    log_info("Timing work-groups with the %s scope clock.\n",
+             probe.scope_name());
+
+    clProgramWrapper program;
+    clKernelWrapper kernel;
+    const char *sources[] = { probe.source(), kTimedKernel };
+    cl_int error = create_single_kernel_helper(
+        context, &program, &kernel, ARRAY_SIZE(sources), sources, "timed_work");
+    test_error(error, "Unable to create the timed kernel");
+
+    size_t wg_size;
+    error = clGetKernelWorkGroupInfo(kernel, device, CL_KERNEL_WORK_GROUP_SIZE,
+                                     sizeof(wg_size), &wg_size, NULL);
+    test_error(error, "clGetKernelWorkGroupInfo failed");
+    size_t local_1d = std::min<size_t>(wg_size, 64);
+
+    clMemWrapper dst =
+        clCreateBuffer(context, CL_MEM_WRITE_ONLY,
+                       kGroups * local_1d * sizeof(cl_uint), NULL, &error);
+    test_error(error, "clCreateBuffer failed");
+    error = clSetKernelArg(kernel, 0, sizeof(dst), &dst);
+    error |= clSetKernelArg(kernel, 1, sizeof(kIterations), &kIterations);
+    test_error(error, "clSetKernelArg failed");
+
+    size_t global_1d = kGroups * local_1d;
+    if (check_timing(probe, queue, kernel, 1, &global_1d, &local_1d, "1d")
+        != TEST_PASS)
+        return TEST_FAIL;
+
+    // 8 by 8 groups of the same size, so the groups are numbered in two
+    // dimensions
+    size_t local_2d[] = { local_1d, 1 };
+    size_t global_2d[] = { local_1d * 8, 8 };
+    return check_timing(probe, queue, kernel, 2, global_2d, local_2d, "2d");
+}
@@ -35,6 +35,7 @@ test_definition test_list[] = {
     ADD_TEST_VERSION(semaphores_multi_wait, Version(1, 2)),
     ADD_TEST_VERSION(semaphores_queries, Version(1, 2)),
     ADD_TEST_VERSION(semaphores_import_export_fd, Version(1, 2)),
+    ADD_BENCHMARK_VERSION(semaphores_latency, Version(1, 2)),
 };
 
 const int test_num = ARRAY_SIZE(test_list);
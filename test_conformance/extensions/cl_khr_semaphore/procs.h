@@ -18,6 +18,7 @@
 #include "harness/typeWrappers.h"
 #include "harness/clImageHelper.h"
 #include "harness/imageHelpers.h"
+#include "harness/parseParameters.h"
 
 extern int test_semaphores_simple_1(cl_device_id deviceID, cl_context context,
                                     cl_command_queue queue, int num_elements);
@@ -45,3 +46,5 @@ extern int test_semaphores_import_export_fd(cl_device_id deviceID,
                                             cl_context context,
                                             cl_command_queue queue,
                                             int num_elements);
+extern int test_semaphores_latency(cl_device_id deviceID, cl_context context,
+                                   cl_command_queue queue, int num_elements);
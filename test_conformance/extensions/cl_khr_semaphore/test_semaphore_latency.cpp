@@ -0,0 +1,367 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "harness/compat.h"
+#include "harness/extensionHelpers.h"
+#include "harness/benchmark.h"
+#include "harness/perfMetrics.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "procs.h"
+
+// Latency from the end of a kernel on one queue to the start of a kernel on
+// another queue that depends on it, with the dependency carried by a binary
+// semaphore, by a semaphore exported and imported as a sync fd or an opaque
+// fd, by an event wait list, or by clEnqueueBarrierWithWaitList. The
+// dependency is also passed back and forth between the two queues through
+// a chain of hops, which gives the cost of each extra hop. A benchmark, so it
+// only runs when named.
+
+namespace {
+
+enum Link
+{
+    LINK_EVENT,
+    LINK_BARRIER,
+    LINK_BINARY,
+    LINK_SYNC_FD,
+    LINK_OPAQUE_FD,
+    LINK_COUNT
+};
+
+const char *kLinkNames[] = { "event", "barrier", "binary", "sync_fd",
+                             "opaque_fd" };
+const int kHops[] = { 1, 2, 4, 8, 16 };
+const int kMaxHops = 16;
+
+const char *kEmptyKernel = "__kernel void empty() {}";
+
+struct SemaphoreApi
+{
+    clCreateSemaphoreWithPropertiesKHR_fn create;
+    clEnqueueSignalSemaphoresKHR_fn signal;
+    clEnqueueWaitSemaphoresKHR_fn wait;
+    clGetSemaphoreHandleForTypeKHR_fn getHandle;
+    clReleaseSemaphoreKHR_fn release;
+};
+
+struct LatencyBench
+{
+    cl_device_id device;
+    cl_context context;
+    cl_command_queue queues[2];
+    cl_kernel kernel;
+    SemaphoreApi api;
+    // Hop h signals signals[h - 1] and waits on waits[h - 1], the same
+    // semaphore unless it is passed through a handle
+    std::vector<cl_semaphore_khr> signals;
+    std::vector<cl_semaphore_khr> waits;
+    std::vector<cl_semaphore_khr> owned;
+
+    ~LatencyBench() { ReleaseSemaphores(); }
+
+    void ReleaseSemaphores()
+    {
+        for (cl_semaphore_khr sema : owned) api.release(sema);
+        owned.clear();
+        signals.clear();
+        waits.clear();
+    }
+
+    cl_semaphore_khr Create(const cl_semaphore_properties_khr *props)
+    {
+        cl_int error;
+        cl_semaphore_khr sema = api.create(context, props, &error);
+        if (error != CL_SUCCESS) return nullptr;
+        owned.push_back(sema);
+        return sema;
+    }
+
+    // A binary semaphore that can be exported as handle_type, or a plain
+    // one for 0
+    cl_semaphore_khr CreateExportable(cl_semaphore_properties_khr handle_type)
+    {
+        std::vector<cl_semaphore_properties_khr> props = {
+            CL_SEMAPHORE_TYPE_KHR, CL_SEMAPHORE_TYPE_BINARY_KHR
+        };
+        if (handle_type)
+        {
+            props.push_back(CL_SEMAPHORE_EXPORT_HANDLE_TYPES_KHR);
+            props.push_back(handle_type);
+            props.push_back(CL_SEMAPHORE_EXPORT_HANDLE_TYPES_LIST_END_KHR);
+        }
+        props.push_back(0);
+        return Create(props.data());
+    }
+
+    // A new semaphore sharing the payload of sema through a handle
+    cl_semaphore_khr Import(cl_semaphore_khr sema,
+                            cl_semaphore_properties_khr handle_type)
+    {
+        int handle = -1;
+        cl_int error = api.getHandle(sema, device,
+                                     (cl_external_semaphore_handle_type_khr)
+                                         handle_type,
+                                     sizeof(handle), &handle, NULL);
+        if (error != CL_SUCCESS || handle < 0) return nullptr;
+        cl_semaphore_properties_khr props[] = {
+            CL_SEMAPHORE_TYPE_KHR, CL_SEMAPHORE_TYPE_BINARY_KHR, handle_type,
+            (cl_semaphore_properties_khr)handle, 0
+        };
+        return Create(props);
+    }
+
+    // False if the device can't make the semaphores of link
+    bool CreateSemaphores(Link link)
+    {
+        ReleaseSemaphores();
+        for (int i = 0; i < kMaxHops; i++)
+        {
+            cl_semaphore_khr signal = nullptr, wait = nullptr;
+            switch (link)
+            {
+                case LINK_BINARY:
+                    signal = wait = CreateExportable(0);
+                    break;
+                case LINK_SYNC_FD:
+                    // A sync fd carries one signal, so it is exported and
+                    // imported again on every hop
+                    signal = CreateExportable(CL_SEMAPHORE_HANDLE_SYNC_FD_KHR);
+                    wait = signal;
+                    break;
+                case LINK_OPAQUE_FD:
+                    signal =
+                        CreateExportable(CL_SEMAPHORE_HANDLE_OPAQUE_FD_KHR);
+                    if (signal)
+                        wait =
+                            Import(signal, CL_SEMAPHORE_HANDLE_OPAQUE_FD_KHR);
+                    break;
+                default: return true;
+            }
+            if (!signal || !wait) return false;
+            signals.push_back(signal);
+            waits.push_back(wait);
+        }
+        return true;
+    }
+
+    // One run of a kernel, the hops and a second kernel, giving the device
+    // time from the end of the first kernel to the start of the second, and
+    // the host time from the first enqueue to both queues finishing
+    int Run(Link link, int hops, double &device_ns, double &host_us)
+    {
+        size_t one = 1;
+        clEventWrapper first, last;
+        std::vector<clEventWrapper> markers(hops);
+        std::vector<cl_semaphore_khr> imported;
+
+        HostTimer timer;
+        int error = clEnqueueNDRangeKernel(queues[0], kernel, 1, NULL, &one,
+                                           NULL, 0, NULL, &first);
+        test_error(error, "clEnqueueNDRangeKernel failed");
+
+        // Hop h carries the dependency from queues[(h - 1) % 2] to
+        // queues[h % 2]
+        cl_event previous = first;
+        for (int h = 1; h <= hops; h++)
+        {
+            cl_command_queue from = queues[(h - 1) % 2];
+            cl_command_queue to = queues[h % 2];
+            switch (link)
+            {
+                case LINK_EVENT:
+                    // The last hop is the wait list of the second kernel
+                    if (h == hops) break;
+                    error = clEnqueueMarkerWithWaitList(to, 1, &previous,
+                                                        &markers[h - 1]);
+                    test_error(error, "clEnqueueMarkerWithWaitList failed");
+                    previous = markers[h - 1];
+                    break;
+                case LINK_BARRIER:
+                    error = clEnqueueBarrierWithWaitList(to, 1, &previous,
+                                                         &markers[h - 1]);
+                    test_error(error, "clEnqueueBarrierWithWaitList failed");
+                    previous = markers[h - 1];
+                    break;
+                default: {
+                    cl_semaphore_khr signal = signals[h - 1];
+                    error = api.signal(from, 1, &signal, NULL, 0, NULL, NULL);
+                    test_error(error, "Could not signal semaphore");
+                    cl_semaphore_khr wait = waits[h - 1];
+                    if (link == LINK_SYNC_FD)
+                    {
+                        error = clFlush(from);
+                        test_error(error, "clFlush failed");
+                        wait = Import(signal, CL_SEMAPHORE_HANDLE_SYNC_FD_KHR);
+                        if (!wait)
+                        {
+                            log_error("ERROR: Could not pass the semaphore "
+                                      "through a sync fd\n");
+                            return TEST_FAIL;
+                        }
+                        imported.push_back(wait);
+                    }
+                    error = api.wait(to, 1, &wait, NULL, 0, NULL, NULL);
+                    test_error(error, "Could not wait semaphore");
+                    break;
+                }
+            }
+        }
+
+        cl_uint num_waits = link == LINK_EVENT ? 1 : 0;
+        error = clEnqueueNDRangeKernel(queues[hops % 2], kernel, 1, NULL, &one,
+                                       NULL, num_waits,
+                                       num_waits ? &previous : NULL, &last);
+        test_error(error, "clEnqueueNDRangeKernel failed");
+        error = clFlush(queues[0]);
+        error |= clFlush(queues[1]);
+        test_error(error, "clFlush failed");
+        error = clFinish(queues[0]);
+        error |= clFinish(queues[1]);
+        test_error(error, "clFinish failed");
+        double hostUs = timer.elapsed_us();
+
+        // The imported sync fd semaphores are used up
+        for (cl_semaphore_khr sema : imported)
+        {
+            owned.erase(std::find(owned.begin(), owned.end(), sema));
+            api.release(sema);
+        }
+
+        cl_ulong end, start;
+        error = clGetEventProfilingInfo(first, CL_PROFILING_COMMAND_END,
+                                        sizeof(end), &end, NULL);
+        test_error(error, "clGetEventProfilingInfo failed");
+        error = clGetEventProfilingInfo(last, CL_PROFILING_COMMAND_START,
+                                        sizeof(start), &start, NULL);
+        test_error(error, "clGetEventProfilingInfo failed");
+        device_ns = start > end ? (double)(start - end) : 0.0;
+        host_us = hostUs;
+        return CL_SUCCESS;
+    }
+};
+
+} // anonymous namespace
+
+int test_semaphores_latency(cl_device_id deviceID, cl_context context,
+                            cl_command_queue defaultQueue, int num_elements)
+{
+    if (!is_extension_available(deviceID, "cl_khr_semaphore"))
+    {
+        log_info("cl_khr_semaphore is not supported on this platform. "
+                 "Skipping test.\n");
+        return TEST_SKIPPED_ITSELF;
+    }
+
+    // Obtain pointers to semaphore's API
+    GET_PFN(deviceID, clCreateSemaphoreWithPropertiesKHR);
+    GET_PFN(deviceID, clEnqueueSignalSemaphoresKHR);
+    GET_PFN(deviceID, clEnqueueWaitSemaphoresKHR);
+    GET_PFN(deviceID, clReleaseSemaphoreKHR);
+
+    LatencyBench bench;
+    bench.device = deviceID;
+    bench.context = context;
+    bench.api.create = clCreateSemaphoreWithPropertiesKHR;
+    bench.api.signal = clEnqueueSignalSemaphoresKHR;
+    bench.api.wait = clEnqueueWaitSemaphoresKHR;
+    bench.api.release = clReleaseSemaphoreKHR;
+    bench.api.getHandle = nullptr;
+
+    bool has_sync_fd =
+        is_extension_available(deviceID, "cl_khr_external_semaphore_sync_fd");
+    bool has_opaque_fd = is_extension_available(
+        deviceID, "cl_khr_external_semaphore_opaque_fd");
+    if (has_sync_fd || has_opaque_fd)
+    {
+        GET_PFN(deviceID, clGetSemaphoreHandleForTypeKHR);
+        bench.api.getHandle = clGetSemaphoreHandleForTypeKHR;
+    }
+
+    cl_int err;
+    clCommandQueueWrapper queue_1 = clCreateCommandQueue(
+        context, deviceID, CL_QUEUE_PROFILING_ENABLE, &err);
+    test_error(err, "Could not create command queue");
+    clCommandQueueWrapper queue_2 = clCreateCommandQueue(
+        context, deviceID, CL_QUEUE_PROFILING_ENABLE, &err);
+    test_error(err, "Could not create command queue");
+    bench.queues[0] = queue_1;
+    bench.queues[1] = queue_2;
+
+    clProgramWrapper program;
+    clKernelWrapper kernel;
+    err = create_single_kernel_helper(context, &program, &kernel, 1,
+                                      &kEmptyKernel, "empty");
+    test_error(err, "Could not create kernel");
+    bench.kernel = kernel;
+
+    BenchmarkOptions options;
+    options.warmup = 1;
+    options.maxSeconds = 1.0;
+
+    log_benchmark_header("semaphore_latency", "clock/link/hops");
+    for (int l = 0; l < LINK_COUNT; l++)
+    {
+        Link link = (Link)l;
+        if ((link == LINK_SYNC_FD && !has_sync_fd)
+            || (link == LINK_OPAQUE_FD && !has_opaque_fd))
+            continue;
+        if (!bench.CreateSemaphores(link))
+        {
+            log_info("Could not create %s semaphores, skipping them.\n",
+                     kLinkNames[l]);
+            continue;
+        }
+
+        for (int hops : kHops)
+        {
+            std::string label =
+                std::string(kLinkNames[l]) + "/" + std::to_string(hops);
+
+            // Each run gives both clocks, so each is sampled on its own
+            BenchmarkStats device, host;
+            err = run_benchmark(
+                options,
+                [&](double *ns) {
+                    double host_us;
+                    return bench.Run(link, hops, *ns, host_us);
+                },
+                &device);
+            if (err != CL_SUCCESS) return TEST_FAIL;
+            err = run_benchmark(
+                options,
+                [&](double *us) {
+                    double device_ns;
+                    return bench.Run(link, hops, device_ns, *us);
+                },
+                &host);
+            if (err != CL_SUCCESS) return TEST_FAIL;
+
+            log_benchmark_stats("semaphore_latency",
+                                ("device/" + label).c_str(), "ns", false,
+                                device);
+            log_benchmark_stats("semaphore_latency", ("host/" + label).c_str(),
+                                "us", false, host);
+            record_perf_metric("semaphore_latency_per_hop_ns." + label,
+                               device.median / hops, "ns", false);
+        }
+    }
+    bench.ReleaseSemaphores();
+
+    return TEST_PASS;
+}
@@ -0,0 +1,261 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "harness/testHarness.h"
+#include "harness/typeWrappers.h"
+#include "harness/mt19937.h"
+#include "harness/benchmark.h"
+#include "harness/perfMetrics.h"
+#include "base.h"
+
+#include <string>
+#include <vector>
+
+// Time of loads through a helper function that takes its pointer in a
+// named address space, against the same helper taking a generic pointer,
+// for global, local and private memory and sequential, strided and random
+// access. In the "generic" kernels the compiler can still tell where the
+// pointer points after inlining; in the "dynamic" kernels the pointer is
+// chosen at run time between two address spaces, so the loads have to go
+// through the generic path. Every variant is checked against the named one.
+// A benchmark, so it only runs when named.
+
+namespace {
+
+const size_t kDataElements = 1 << 22;
+const size_t kGlobalItems = 1 << 18;
+const size_t kMaxLocalSize = 256;
+const cl_uint kLoadsPerItem = 64;
+const int kPrivateElements = 16;
+
+enum AddressSpace
+{
+    kGlobal,
+    kLocal,
+    kPrivate,
+    kSpaceCount
+};
+
+enum PointerKind
+{
+    kNamed,
+    kGeneric,
+    kDynamic,
+    kKindCount
+};
+
+enum AccessPattern
+{
+    kSequential,
+    kStrided,
+    kRandom,
+    kPatternCount
+};
+
+const char *kSpaceNames[kSpaceCount] = { "global", "local", "private" };
+const char *kQualifiers[kSpaceCount] = { "__global", "__local", "__private" };
+const char *kKindNames[kKindCount] = { "named", "generic", "dynamic" };
+const char *kPatternNames[kPatternCount] = { "sequential", "strided",
+                                             "random" };
+// An odd stride and a full period LCG both visit every element under a
+// power of two mask
+const char *kNextIndex[kPatternCount] = {
+    "(idx + 1)", "(idx + 33)", "(idx * 1664525u + 1013904223u)"
+};
+
+// The pointer each space passes to the helper, what it sets up first, and
+// where the helper starts and wraps
+struct SpaceSource
+{
+    const char *setup;
+    const char *named;
+    const char *other;
+    const char *start;
+    const char *mask;
+};
+
+const SpaceSource kSpaceSources[kSpaceCount] = {
+    { "", "data", "tile", "tid", "mask" },
+    { NL "    tile[lid] = data[tid & mask];"
+      NL "    barrier(CLK_LOCAL_MEM_FENCE);",
+      "tile", "data", "lid", "(uint)get_local_size(0) - 1" },
+    { NL "    uint priv[PRIVATE_ELEMENTS];"
+      NL "    for (uint i = 0; i < PRIVATE_ELEMENTS; i++)"
+      NL "        priv[i] = data[(tid + i) & mask];",
+      "priv", "data", "lid", "PRIVATE_ELEMENTS - 1" },
+};
+
+std::string bench_source(AddressSpace space, PointerKind kind,
+                         AccessPattern pattern)
+{
+    const SpaceSource &s = kSpaceSources[space];
+    std::string qualifier = kind == kNamed ? kQualifiers[space] : "";
+    std::string pointer = s.named;
+    if (kind == kDynamic)
+        pointer = std::string("flag ? (const uint *)") + s.named
+            + " : (const uint *)" + s.other;
+
+    return std::string()
+        + NL "#define PRIVATE_ELEMENTS " + std::to_string(kPrivateElements)
+        + NL "#define NEXT_INDEX(idx) " + kNextIndex[pattern]
+        + NL
+        + NL "uint load_sum(" + qualifier + " const uint *ptr, uint idx,"
+        + NL "              uint mask, uint loads) {"
+        + NL "    uint sum = 0;"
+        + NL "    for (uint i = 0; i < loads; i++) {"
+        + NL "        sum += ptr[idx & mask];"
+        + NL "        idx = NEXT_INDEX(idx);"
+        + NL "    }"
+        + NL "    return sum;"
+        + NL "}"
+        + NL
+        + NL "__kernel void testKernel(__global uint *results,"
+        + NL "                         __global const uint *data,"
+        + NL "                         __local uint *tile, uint mask,"
+        + NL "                         uint loads, int flag) {"
+        + NL "    uint tid = get_global_id(0);"
+        + NL "    uint lid = get_local_id(0);"
+        + s.setup
+        + NL "    results[tid] = load_sum(" + pointer + ", " + s.start + ","
+        + NL "                            " + s.mask + ", loads);"
+        + NL "}"
+        + NL;
+}
+
+} // anonymous namespace
+
+int test_generic_pointer_bench(cl_device_id deviceID, cl_context context,
+                               cl_command_queue queue, int num_elements)
+{
+    cl_int error;
+    clCommandQueueWrapper profilingQueue = clCreateCommandQueue(
+        context, deviceID, CL_QUEUE_PROFILING_ENABLE, &error);
+    test_error(error, "Unable to create profiling queue");
+
+    std::vector<cl_uint> data(kDataElements);
+    MTdataHolder d(gRandomSeed);
+    for (cl_uint &value : data) value = genrand_int32(d);
+
+    clMemWrapper dataBuffer =
+        clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+                       kDataElements * sizeof(cl_uint), data.data(), &error);
+    test_error(error, "clCreateBuffer failed");
+    clMemWrapper results[kKindCount];
+    for (int k = 0; k < kKindCount; k++)
+    {
+        results[k] = clCreateBuffer(context, CL_MEM_WRITE_ONLY,
+                                    kGlobalItems * sizeof(cl_uint), NULL,
+                                    &error);
+        test_error(error, "clCreateBuffer failed");
+    }
+
+    cl_uint mask = kDataElements - 1;
+    cl_uint loads = kLoadsPerItem;
+    cl_int flag = 1;
+    int result = CL_SUCCESS;
+
+    BenchmarkOptions options;
+    options.warmup = 1;
+    options.maxSeconds = 1.0;
+
+    log_info("Each of the %zu work-items makes %u loads\n", kGlobalItems,
+             loads);
+    log_benchmark_header("generic_pointer", "space/pattern/pointer/local");
+
+    for (int space = 0; space < kSpaceCount; space++)
+        for (int pattern = 0; pattern < kPatternCount; pattern++)
+        {
+            clProgramWrapper programs[kKindCount];
+            clKernelWrapper kernels[kKindCount];
+            size_t local = kMaxLocalSize;
+            for (int k = 0; k < kKindCount; k++)
+            {
+                std::string src =
+                    bench_source((AddressSpace)space, (PointerKind)k,
+                                 (AccessPattern)pattern);
+                const char *srcPtr = src.c_str();
+                if (create_single_kernel_helper(context, &programs[k],
+                                                &kernels[k], 1, &srcPtr,
+                                                "testKernel"))
+                {
+                    log_error("create_single_kernel_helper failed\n");
+                    return -1;
+                }
+
+                size_t maxSize;
+                error = get_max_allowed_1d_work_group_size_on_device(
+                    deviceID, kernels[k], &maxSize);
+                test_error(error, "Unable to get the work-group size");
+                while (local > maxSize) local /= 2;
+            }
+
+            // The same launch for every variant, and a power of two so
+            // that the local helper can wrap with a mask
+            BenchmarkStats stats[kKindCount];
+            for (int k = 0; k < kKindCount; k++)
+            {
+                error = clSetKernelArg(kernels[k], 0, sizeof(results[k]),
+                                       &results[k]);
+                error |= clSetKernelArg(kernels[k], 1, sizeof(dataBuffer),
+                                        &dataBuffer);
+                error |= clSetKernelArg(kernels[k], 2,
+                                        local * sizeof(cl_uint), NULL);
+                error |= clSetKernelArg(kernels[k], 3, sizeof(mask), &mask);
+                error |= clSetKernelArg(kernels[k], 4, sizeof(loads), &loads);
+                error |= clSetKernelArg(kernels[k], 5, sizeof(flag), &flag);
+                test_error(error, "clSetKernelArg failed");
+
+                error = benchmark_1d_kernel(profilingQueue, kernels[k],
+                                            kGlobalItems, local, options,
+                                            &stats[k]);
+                test_error(error, "Unable to time kernel");
+
+                std::string label = std::string(kSpaceNames[space]) + "/"
+                    + kPatternNames[pattern] + "/" + kKindNames[k] + "/"
+                    + std::to_string(local);
+                log_benchmark_stats("generic_pointer", label.c_str(), "ns",
+                                    false, stats[k]);
+                if (stats[k].median > 0)
+                    record_perf_metric("generic_pointer_relative_to_named."
+                                           + label,
+                                       stats[kNamed].median / stats[k].median,
+                                       "ratio", true);
+            }
+
+            std::vector<cl_uint> expected(kGlobalItems);
+            std::vector<cl_uint> actual(kGlobalItems);
+            error = clEnqueueReadBuffer(queue, results[kNamed], CL_TRUE, 0,
+                                        kGlobalItems * sizeof(cl_uint),
+                                        expected.data(), 0, NULL, NULL);
+            test_error(error, "clEnqueueReadBuffer failed");
+            for (int k = kGeneric; k < kKindCount; k++)
+            {
+                error = clEnqueueReadBuffer(queue, results[k], CL_TRUE, 0,
+                                            kGlobalItems * sizeof(cl_uint),
+                                            actual.data(), 0, NULL, NULL);
+                test_error(error, "clEnqueueReadBuffer failed");
+                if (actual != expected)
+                {
+                    log_error("The %s %s %s kernel gives different results "
+                              "from the named one\n",
+                              kKindNames[k], kSpaceNames[space],
+                              kPatternNames[pattern]);
+                    result = -1;
+                }
+            }
+        }
+
+    return result;
+}
@@ -45,6 +45,9 @@ int test_generic_atomics_invariant(cl_device_id deviceID, cl_context context,
                                    cl_command_queue queue, int num_elements);
 int test_generic_atomics_variant(cl_device_id deviceID, cl_context context,
                                  cl_command_queue queue, int num_elements);
+// benchmarks
+int test_generic_pointer_bench(cl_device_id deviceID, cl_context context,
+                               cl_command_queue queue, int num_elements);
 
 test_definition test_list[] = {
     // basic tests
@@ -73,6 +76,8 @@ test_definition test_list[] = {
     // atomic tests
     ADD_TEST(generic_atomics_invariant),
     ADD_TEST(generic_atomics_variant),
+    // benchmarks
+    ADD_BENCHMARK(generic_pointer_bench),
 };
 
 const int test_num = ARRAY_SIZE( test_list );
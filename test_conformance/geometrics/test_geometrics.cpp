@@ -17,6 +17,7 @@
 
 #include "testBase.h"
 #include "harness/testHarness.h"
+#include "harness/alloc.h"
 #include "harness/typeWrappers.h"
 #include "harness/conversions.h"
 #include "harness/errorHelpers.h"
@@ -166,9 +167,9 @@ int test_geom_cross(cl_device_id deviceID, cl_context context, cl_command_queue
         clProgramWrapper program;
         clKernelWrapper kernel;
         clMemWrapper streams[3];
-        BufferOwningPtr<cl_float> A(malloc(sizeof(cl_float) * TEST_SIZE * vecsize));
-        BufferOwningPtr<cl_float> B(malloc(sizeof(cl_float) * TEST_SIZE * vecsize));
-        BufferOwningPtr<cl_float> C(malloc(sizeof(cl_float) * TEST_SIZE * vecsize));
+        ScratchArray<cl_float> A(TEST_SIZE * vecsize);
+        ScratchArray<cl_float> B(TEST_SIZE * vecsize);
+        ScratchArray<cl_float> C(TEST_SIZE * vecsize);
         cl_float testVector[4];
         int error, i;
         cl_float *inDataA = A;
@@ -321,9 +322,9 @@ int test_twoToFloat_kernel(cl_command_queue queue, cl_context context, const cha
             hasInfNan = 0;
     }
 
-    BufferOwningPtr<cl_float> A(malloc(sizeof(cl_float) * TEST_SIZE * 4));
-    BufferOwningPtr<cl_float> B(malloc(sizeof(cl_float) * TEST_SIZE * 4));
-    BufferOwningPtr<cl_float> C(malloc(sizeof(cl_float) * TEST_SIZE));
+    ScratchArray<cl_float> A(TEST_SIZE * 4);
+    ScratchArray<cl_float> B(TEST_SIZE * 4);
+    ScratchArray<cl_float> C(TEST_SIZE);
 
     cl_float *inDataA = A;
     cl_float *inDataB = B;
@@ -634,8 +635,8 @@ int test_oneToFloat_kernel(cl_command_queue queue, cl_context context, const cha
     clProgramWrapper program;
     clKernelWrapper kernel;
     clMemWrapper streams[2];
-    BufferOwningPtr<cl_float> A(malloc(sizeof(cl_float) * TEST_SIZE * 4));
-    BufferOwningPtr<cl_float> B(malloc(sizeof(cl_float) * TEST_SIZE));
+    ScratchArray<cl_float> A(TEST_SIZE * 4);
+    ScratchArray<cl_float> B(TEST_SIZE);
     int error;
     size_t i, threads[1], localThreads[1];
     char kernelSource[10240];
@@ -845,10 +846,8 @@ int test_oneToOne_kernel(cl_command_queue queue, cl_context context, const char
     clProgramWrapper program;
     clKernelWrapper kernel;
     clMemWrapper streams[2];
-    BufferOwningPtr<cl_float> A(malloc(sizeof(cl_float) * TEST_SIZE
-                                       * vecSize));
-    BufferOwningPtr<cl_float> B(malloc(sizeof(cl_float) * TEST_SIZE
-                                       * vecSize));
+    ScratchArray<cl_float> A(TEST_SIZE * vecSize);
+    ScratchArray<cl_float> B(TEST_SIZE * vecSize);
     int error;
     size_t i, j, threads[1], localThreads[1];
     char kernelSource[10240];
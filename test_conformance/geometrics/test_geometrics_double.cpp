@@ -14,6 +14,7 @@
 // limitations under the License.
 //
 #include "testBase.h"
+#include "harness/alloc.h"
 #include "harness/typeWrappers.h"
 #include "harness/conversions.h"
 #include "harness/errorHelpers.h"
@@ -191,9 +192,9 @@ int test_geom_cross_double(cl_device_id deviceID, cl_context context, cl_command
         cl_double testVector[4];
         int error;
         size_t threads[1], localThreads[1];
-        BufferOwningPtr<cl_double> A(malloc(bufSize));
-        BufferOwningPtr<cl_double> B(malloc(bufSize));
-        BufferOwningPtr<cl_double> C(malloc(bufSize));
+        ScratchArray<cl_double> A(bufSize / sizeof(cl_double));
+        ScratchArray<cl_double> B(bufSize / sizeof(cl_double));
+        ScratchArray<cl_double> C(bufSize / sizeof(cl_double));
         cl_double *inDataA = A;
         cl_double *inDataB = B;
         cl_double *outData = C;
@@ -305,9 +306,9 @@ int test_twoToFloat_kernel_double(cl_command_queue queue, cl_context context, co
     char kernelSource[10240];
     char *programPtr;
     char sizeNames[][4] = { "", "2", "3", "4", "", "", "", "8", "", "", "", "", "", "", "", "16" };
-    BufferOwningPtr<cl_double> A(malloc(sizeof(cl_double) * TEST_SIZE * vecSize));
-    BufferOwningPtr<cl_double> B(malloc(sizeof(cl_double) * TEST_SIZE * vecSize));
-    BufferOwningPtr<cl_double> C(malloc(sizeof(cl_double) * TEST_SIZE));
+    ScratchArray<cl_double> A(TEST_SIZE * vecSize);
+    ScratchArray<cl_double> B(TEST_SIZE * vecSize);
+    ScratchArray<cl_double> C(TEST_SIZE);
 
     cl_double *inDataA = A;
     cl_double *inDataB = B;
@@ -542,8 +543,8 @@ int test_oneToFloat_kernel_double(cl_command_queue queue, cl_context context, co
     clProgramWrapper program;
     clKernelWrapper kernel;
     clMemWrapper streams[2];
-    BufferOwningPtr<cl_double> A(malloc(sizeof(cl_double) * TEST_SIZE * vecSize));
-    BufferOwningPtr<cl_double> B(malloc(sizeof(cl_double) * TEST_SIZE));
+    ScratchArray<cl_double> A(TEST_SIZE * vecSize);
+    ScratchArray<cl_double> B(TEST_SIZE);
     int error;
     size_t i, threads[1], localThreads[1];
     char kernelSource[10240];
@@ -749,8 +750,8 @@ int test_oneToOne_kernel_double(cl_command_queue queue, cl_context context, cons
     clProgramWrapper program;
     clKernelWrapper kernel;
     clMemWrapper streams[2];
-    BufferOwningPtr<cl_double> A(malloc(sizeof(cl_double) * TEST_SIZE * vecSize));
-    BufferOwningPtr<cl_double> B(malloc(sizeof(cl_double) * TEST_SIZE * vecSize));
+    ScratchArray<cl_double> A(TEST_SIZE * vecSize);
+    ScratchArray<cl_double> B(TEST_SIZE * vecSize);
     int error;
     size_t i, j, threads[1], localThreads[1];
     char kernelSource[10240];
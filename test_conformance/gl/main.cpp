@@ -35,6 +35,7 @@ static cl_context sCurrentContext = NULL;
 
 
 #define TEST_FN_REDIRECT(fn) ADD_TEST(redirect_##fn)
+#define BENCHMARK_FN_REDIRECT(fn) ADD_BENCHMARK(redirect_##fn)
 #define TEST_FN_REDIRECTOR(fn)                                                 \
     int test_redirect_##fn(cl_device_id device, cl_context context,            \
                            cl_command_queue queue, int numElements)            \
@@ -103,6 +104,8 @@ TEST_FN_REDIRECTOR(renderbuffer_getinfo)
 
 TEST_FN_REDIRECTOR(fence_sync)
 
+TEST_FN_REDIRECTOR(sharing_bench)
+
 test_definition test_list[] = { TEST_FN_REDIRECT(buffers),
                                 TEST_FN_REDIRECT(buffers_getinfo),
 
@@ -132,7 +135,9 @@ test_definition test_list[] = { TEST_FN_REDIRECT(buffers),
 
                                 TEST_FN_REDIRECT(renderbuffer_read),
                                 TEST_FN_REDIRECT(renderbuffer_write),
-                                TEST_FN_REDIRECT(renderbuffer_getinfo) };
+                                TEST_FN_REDIRECT(renderbuffer_getinfo),
+
+                                BENCHMARK_FN_REDIRECT(sharing_bench) };
 
 test_definition test_list32[] = {
     TEST_FN_REDIRECT(images_read_texturebuffer),
@@ -209,6 +214,7 @@ int main(int argc, const char *argv[])
         log_info("Note: Any 3.2 test names must follow 2.1 test names on the "
                  "command line.\n");
         log_info("Use environment variables to specify desired device.\n");
+        log_info("sharing_bench is a benchmark and only runs when named.\n");
 
         return 0;
     }
@@ -15,6 +15,7 @@
 //
 #include "testBase.h"
 #include "harness/mt19937.h"
+#include "harness/parseParameters.h"
 
 
 #pragma mark -
@@ -26,6 +27,9 @@ extern int test_buffers(cl_device_id device, cl_context context,
 extern int test_fence_sync(cl_device_id device, cl_context context,
                            cl_command_queue queue, int numElements);
 
+extern int test_sharing_bench(cl_device_id device, cl_context context,
+                              cl_command_queue queue, int numElements);
+
 
 #pragma mark -
 #pragma mark Tead tests
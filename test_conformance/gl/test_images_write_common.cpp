@@ -516,11 +516,35 @@ int supportsDepth(cl_context context, bool *supports_depth)
     return error;
 }
 
+// A write test whose readback of the GL texture may still be in flight. The
+// sizes of a format are pipelined: the readback of one is finished and
+// validated once the CL write of the next has been run.
+struct PendingImageWrite
+{
+    bool active;
+    GLTextureReadback readback;
+    BufferOwningPtr<char> validationSource;
+    cl_image_format clFormat;
+    ExplicitType sourceType;
+    ExplicitType validationType;
+    ExplicitType readType;
+    GLenum glType;
+    size_t width, height, depth;
+    size_t sizeIndex;
+
+    PendingImageWrite(): active(false) {}
+    ~PendingImageWrite()
+    {
+        if (active) free(FinishGLTextureReadback(&readback));
+    }
+};
+
 static int test_image_format_write(cl_context context, cl_command_queue queue,
                                    size_t width, size_t height, size_t depth,
                                    GLenum target, GLenum format,
                                    GLenum internalFormat, GLenum glType,
-                                   ExplicitType type, MTdata d)
+                                   ExplicitType type, MTdata d,
+                                   PendingImageWrite *pending)
 {
     int error;
     // If we're testing a half float format, then we need to determine the
@@ -639,7 +663,7 @@ static int test_image_format_write(cl_context context, cl_command_queue queue,
     else
         validationType = sourceType;
 
-    BufferOwningPtr<char> validationSource;
+    BufferOwningPtr<char> &validationSource = pending->validationSource;
 
     if (clFormat.image_channel_data_type == CL_UNORM_INT_101010)
     {
@@ -661,14 +685,39 @@ static int test_image_format_write(cl_context context, cl_command_queue queue,
         GetChannelOrderName(clFormat.image_channel_order),
         GetChannelTypeName(clFormat.image_channel_data_type));
 
-    // Read the results from the GL texture.
+    // Start reading the results from the GL texture, to be validated by
+    // finish_image_format_write.
 
     ExplicitType readType = type;
-    BufferOwningPtr<char> glResults(
-        ReadGLTexture(target, glTexture, glBuf, width, format, internalFormat,
-                      glType, readType, /* unused */ 1, 1));
+    if (StartGLTextureReadback(&pending->readback, target, glTexture, glBuf,
+                               width, format, internalFormat, glType,
+                               readType))
+        return -1;
+
+    pending->active = true;
+    pending->clFormat = clFormat;
+    pending->sourceType = sourceType;
+    pending->validationType = validationType;
+    pending->readType = readType;
+    pending->glType = glType;
+    pending->width = width;
+    pending->height = height;
+    pending->depth = depth;
+    return 0;
+}
+
+static int finish_image_format_write(PendingImageWrite &pending)
+{
+    pending.active = false;
+    BufferOwningPtr<char> glResults(FinishGLTextureReadback(&pending.readback));
     if (glResults == NULL) return -1;
 
+    size_t width = pending.width, height = pending.height,
+           depth = pending.depth;
+    const cl_image_format &clFormat = pending.clFormat;
+    ExplicitType readType = pending.readType;
+    ExplicitType validationType = pending.validationType;
+
     // We have to convert our input buffer to the returned type, so we can
     // validate.
     BufferOwningPtr<char> convertedGLResults;
@@ -677,7 +726,7 @@ static int test_image_format_write(cl_context context, cl_command_queue queue,
         convertedGLResults.reset(convert_to_expected(
             glResults, width * height * depth, readType, validationType,
             get_channel_order_channel_count(clFormat.image_channel_order),
-            glType));
+            pending.glType));
     }
 
     // Validate.
@@ -685,27 +734,28 @@ static int test_image_format_write(cl_context context, cl_command_queue queue,
     int valid = 0;
     if (convertedGLResults)
     {
-        if (sourceType == kFloat || sourceType == kHalf)
+        if (pending.sourceType == kFloat || pending.sourceType == kHalf)
         {
             if (clFormat.image_channel_data_type == CL_UNORM_INT_101010)
             {
                 valid = validate_float_results_rgb_101010(
-                    validationSource, glResults, width, height, depth, 1);
+                    pending.validationSource, glResults, width, height, depth,
+                    1);
             }
             else
             {
-                valid =
-                    validate_float_results(validationSource, convertedGLResults,
-                                           width, height, depth, 1,
-                                           get_channel_order_channel_count(
-                                               clFormat.image_channel_order));
+                valid = validate_float_results(
+                    pending.validationSource, convertedGLResults, width,
+                    height, depth, 1,
+                    get_channel_order_channel_count(
+                        clFormat.image_channel_order));
             }
         }
         else
         {
             valid = validate_integer_results(
-                validationSource, convertedGLResults, width, height, depth, 1,
-                get_explicit_type_size(readType));
+                pending.validationSource, convertedGLResults, width, height,
+                depth, 1, get_explicit_type_size(readType));
         }
     }
 
@@ -816,6 +866,12 @@ int test_images_write_common(cl_device_id device, cl_context context,
                          GetGLFormatName(formats[fidx].internal));
 
 
+            // The readback of each size is finished while the next is in
+            // flight
+            PendingImageWrite pending[2];
+            size_t current = 0;
+            bool failed = false;
+
             for (sidx = 0; sidx < nsizes; sidx++)
             {
 
@@ -864,11 +920,23 @@ int test_images_write_common(cl_device_id device, cl_context context,
                 }
 #endif
 
-                if (test_image_format_write(
-                        context, queue, sizes[sidx].width, sizes[sidx].height,
-                        sizes[sidx].depth, targets[tidx],
-                        formats[fidx].formattype, formats[fidx].internal,
-                        formats[fidx].datatype, formats[fidx].type, seed))
+                size_t failedSize = sidx;
+                pending[current].sizeIndex = sidx;
+                failed = test_image_format_write(
+                    context, queue, sizes[sidx].width, sizes[sidx].height,
+                    sizes[sidx].depth, targets[tidx], formats[fidx].formattype,
+                    formats[fidx].internal, formats[fidx].datatype,
+                    formats[fidx].type, seed, &pending[current]);
+
+                PendingImageWrite &previous = pending[current ^ 1];
+                if (!failed && previous.active)
+                {
+                    failedSize = previous.sizeIndex;
+                    failed = finish_image_format_write(previous);
+                }
+                current ^= 1;
+
+                if (failed)
                 {
                     log_error(
                         "ERROR: Image write test failed for %s : %s : %s : %s "
@@ -877,17 +945,39 @@ int test_images_write_common(cl_device_id device, cl_context context,
                         GetGLFormatName(formats[fidx].internal),
                         GetGLBaseFormatName(formats[fidx].formattype),
                         GetGLTypeName(formats[fidx].datatype),
-                        sizes[sidx].width, sizes[sidx].height,
-                        sizes[sidx].depth);
+                        sizes[failedSize].width, sizes[failedSize].height,
+                        sizes[failedSize].depth);
 
                     error++;
                     break; // Skip other sizes for this combination
                 }
             }
 
+            // Validate the last size, which no other followed
+            for (PendingImageWrite &last : pending)
+            {
+                if (sidx != nsizes || !last.active) continue;
+                if (finish_image_format_write(last))
+                {
+                    log_error(
+                        "ERROR: Image write test failed for %s : %s : %s : %s "
+                        " and size (%ld, %ld, %ld)\n\n",
+                        GetGLTargetName(targets[tidx]),
+                        GetGLFormatName(formats[fidx].internal),
+                        GetGLBaseFormatName(formats[fidx].formattype),
+                        GetGLTypeName(formats[fidx].datatype),
+                        sizes[last.sizeIndex].width,
+                        sizes[last.sizeIndex].height,
+                        sizes[last.sizeIndex].depth);
+
+                    error++;
+                    failed = true;
+                }
+            }
+
             // If we passed all sizes (check versus size loop count):
 
-            if (sidx == nsizes)
+            if (sidx == nsizes && !failed)
             {
                 log_info(
                     "passed: Image write for GL format  %s : %s : %s : %s\n\n",
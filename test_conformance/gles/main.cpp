@@ -39,6 +39,7 @@ static cl_context        sCurrentContext = NULL;
 
 
 #define TEST_FN_REDIRECT( fn ) ADD_TEST( redirect_##fn )
+#define BENCHMARK_FN_REDIRECT( fn ) ADD_BENCHMARK( redirect_##fn )
 #define TEST_FN_REDIRECTOR( fn ) \
 int test_redirect_##fn(cl_device_id device, cl_context context, cl_command_queue queue, int numElements )    \
 { \
@@ -61,6 +62,7 @@ TEST_FN_REDIRECTOR( images_write_cube )
 TEST_FN_REDIRECTOR( renderbuffer_read )
 TEST_FN_REDIRECTOR( renderbuffer_write )
 TEST_FN_REDIRECTOR( renderbuffer_getinfo )
+TEST_FN_REDIRECTOR( sharing_bench )
 
 #ifdef GL_ES_VERSION_3_0
 TEST_FN_REDIRECTOR(fence_sync)
@@ -79,7 +81,8 @@ test_definition test_list[] = {
     TEST_FN_REDIRECT( images_write_cube ),
     TEST_FN_REDIRECT( renderbuffer_read ),
     TEST_FN_REDIRECT( renderbuffer_write ),
-    TEST_FN_REDIRECT( renderbuffer_getinfo )
+    TEST_FN_REDIRECT( renderbuffer_getinfo ),
+    BENCHMARK_FN_REDIRECT( sharing_bench )
 };
 
 #ifdef GL_ES_VERSION_3_0
@@ -106,6 +109,12 @@ int main(int argc, const char *argv[])
 
     test_start();
 
+    argc = parseCustomParam(argc, argv);
+    if (argc == -1)
+    {
+        return -1;
+    }
+
   cl_device_type requestedDeviceType = CL_DEVICE_TYPE_DEFAULT;
 
     for(int z = 1; z < argc; ++z)
@@ -125,6 +134,7 @@ int main(int argc, const char *argv[])
         log_info("Note: Any 3.2 test names must follow 2.1 test names on the "
                  "command line.");
         log_info("Use environment variables to specify desired device.");
+        log_info("sharing_bench is a benchmark and only runs when named.\n");
 
         return 0;
     }
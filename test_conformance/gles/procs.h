@@ -15,6 +15,7 @@
 //
 #include "testBase.h"
 #include "harness/mt19937.h"
+#include "harness/parseParameters.h"
 
 
 extern int test_buffers( cl_device_id device, cl_context context, cl_command_queue queue, int num_elements );
@@ -32,4 +33,5 @@ extern int test_renderbuffer_read( cl_device_id device, cl_context context, cl_c
 extern int test_renderbuffer_write( cl_device_id device, cl_context context, cl_command_queue queue, int num_elements );
 extern int test_renderbuffer_getinfo( cl_device_id device, cl_context context, cl_command_queue queue, int numElements );
 extern int test_fence_sync( cl_device_id device, cl_context context, cl_command_queue queue, int numElements );
-
+extern int test_sharing_bench(cl_device_id device, cl_context context,
+                              cl_command_queue queue, int numElements);
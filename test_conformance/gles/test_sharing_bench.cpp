@@ -0,0 +1,375 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "testBase.h"
+#include "procs.h"
+#include "harness/perfMetrics.h"
+#include "harness/benchmark.h"
+
+#include <EGL/eglext.h>
+
+#include <string>
+#include <vector>
+
+// Cost of sharing a GLES texture with CL once per frame at camera pipeline
+// resolutions: how long acquire and release take, how long CL needs to
+// refill the texture, and how many such frames fit in a second. When the
+// device has cl_khr_egl_event and the display EGL_KHR_fence_sync, the acquire
+// is also timed behind an EGL fence turned into a CL event, and with implicit
+// synchronisation, against the glFinish the spec asks for otherwise. Every
+// number is also recorded as a perf metric. A benchmark, so it only runs
+// when named.
+
+struct CameraResolution
+{
+    const char *name;
+    size_t width;
+    size_t height;
+};
+
+static const CameraResolution kResolutions[] = {
+    { "vga", 640, 480 },
+    { "720p", 1280, 720 },
+    { "1080p", 1920, 1080 },
+    { "1440p", 2560, 1440 },
+    { "2160p", 3840, 2160 },
+};
+
+static const char *fillFrameKernel =
+    "__kernel void fill_frame(write_only image2d_t dst, float value)\n"
+    "{\n"
+    "    int2 coord = (int2)(get_global_id(0), get_global_id(1));\n"
+    "    write_imagef(dst, coord, (float4)(value, 0.5f, 0.25f, 1.0f));\n"
+    "}\n";
+
+typedef cl_event(CL_API_CALL *CreateEventFromEGLSyncFn)(cl_context context,
+                                                        EGLSyncKHR sync,
+                                                        EGLDisplay display,
+                                                        cl_int *errcode_ret);
+
+namespace {
+
+struct SharedTexture
+{
+    cl_command_queue queue;
+    cl_kernel kernel;
+    cl_mem image;
+    size_t width;
+    size_t height;
+
+    cl_int Acquire(cl_uint num_events, const cl_event *events)
+    {
+        cl_int error = (*clEnqueueAcquireGLObjects_ptr)(queue, 1, &image,
+                                                        num_events, events,
+                                                        NULL);
+        test_error(error, "clEnqueueAcquireGLObjects failed");
+        error = clFinish(queue);
+        test_error(error, "clFinish failed");
+        return CL_SUCCESS;
+    }
+
+    cl_int Release()
+    {
+        cl_int error =
+            (*clEnqueueReleaseGLObjects_ptr)(queue, 1, &image, 0, NULL, NULL);
+        test_error(error, "clEnqueueReleaseGLObjects failed");
+        error = clFinish(queue);
+        test_error(error, "clFinish failed");
+        return CL_SUCCESS;
+    }
+
+    cl_int Fill(int frame)
+    {
+        cl_float value = (frame % 256) / 255.0f;
+        cl_int error = clSetKernelArg(kernel, 1, sizeof(value), &value);
+        test_error(error, "clSetKernelArg failed");
+        size_t global[2] = { width, height };
+        error = clEnqueueNDRangeKernel(queue, kernel, 2, NULL, global, NULL, 0,
+                                       NULL, NULL);
+        test_error(error, "clEnqueueNDRangeKernel failed");
+        error = clFinish(queue);
+        test_error(error, "clFinish failed");
+        return CL_SUCCESS;
+    }
+
+    // Checks that the red channel of every texel holds the last frame's value
+    cl_int Verify(int frame)
+    {
+        std::vector<cl_uchar> texels(width * height * 4);
+        size_t origin[3] = { 0, 0, 0 };
+        size_t region[3] = { width, height, 1 };
+        cl_int error = Acquire(0, NULL);
+        if (error != CL_SUCCESS) return error;
+        error = clEnqueueReadImage(queue, image, CL_TRUE, origin, region, 0, 0,
+                                   texels.data(), 0, NULL, NULL);
+        test_error(error, "clEnqueueReadImage failed");
+        error = Release();
+        if (error != CL_SUCCESS) return error;
+
+        cl_uchar expected = (cl_uchar)(frame % 256);
+        for (size_t i = 0; i < width * height; i++)
+        {
+            if (texels[i * 4] != expected)
+            {
+                log_error("ERROR: texel %zu of the %zux%zu texture is %u, "
+                          "expected %u\n",
+                          i, width, height, texels[i * 4], expected);
+                return -1;
+            }
+        }
+        return CL_SUCCESS;
+    }
+};
+
+// Host times of one shared update, in microseconds
+struct FrameTimes
+{
+    double acquire;
+    double update;
+    double release;
+    double frame;
+};
+
+// One shared update of the frame, synchronised with glFinish
+cl_int TimeFrame(SharedTexture &shared, int frame, FrameTimes *times)
+{
+    glFinish();
+    HostTimer timer;
+    cl_int error = shared.Acquire(0, NULL);
+    if (error != CL_SUCCESS) return error;
+    double acquiredUs = timer.elapsed_us();
+    error = shared.Fill(frame);
+    if (error != CL_SUCCESS) return error;
+    double updatedUs = timer.elapsed_us();
+    error = shared.Release();
+    if (error != CL_SUCCESS) return error;
+    double releasedUs = timer.elapsed_us();
+
+    times->acquire = acquiredUs;
+    times->update = updatedUs - acquiredUs;
+    times->release = releasedUs - updatedUs;
+    times->frame = releasedUs;
+    return CL_SUCCESS;
+}
+
+void record_sharing_metric(const CameraResolution &resolution,
+                           const char *name, double value, const char *unit,
+                           bool higherIsBetter)
+{
+    record_perf_metric(std::string("gles_sharing_") + resolution.name + "_"
+                           + name,
+                       value, unit, higherIsBetter);
+}
+
+} // anonymous namespace
+
+int test_sharing_bench(cl_device_id device, cl_context context,
+                       cl_command_queue queue, int numElements)
+{
+    cl_int error;
+    clProgramWrapper program;
+    clKernelWrapper kernel;
+    error = create_single_kernel_helper(context, &program, &kernel, 1,
+                                        &fillFrameKernel, "fill_frame");
+    test_error(error, "Unable to create the fill kernel");
+
+    size_t max_width, max_height;
+    error = clGetDeviceInfo(device, CL_DEVICE_IMAGE2D_MAX_WIDTH,
+                            sizeof(max_width), &max_width, NULL);
+    test_error(error, "clGetDeviceInfo failed");
+    error = clGetDeviceInfo(device, CL_DEVICE_IMAGE2D_MAX_HEIGHT,
+                            sizeof(max_height), &max_height, NULL);
+    test_error(error, "clGetDeviceInfo failed");
+    GLint max_texture = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_texture);
+
+    // EGL fences need cl_khr_egl_event on the CL side and EGL_KHR_fence_sync
+    // on the display
+    EGLDisplay display = eglGetCurrentDisplay();
+    PFNEGLCREATESYNCKHRPROC createSync = NULL;
+    PFNEGLDESTROYSYNCKHRPROC destroySync = NULL;
+    CreateEventFromEGLSyncFn createEventFromEGLSync = NULL;
+    if (is_extension_available(device, "cl_khr_egl_event")
+        && display != EGL_NO_DISPLAY)
+    {
+        const char *egl_extensions = eglQueryString(display, EGL_EXTENSIONS);
+        cl_platform_id platform;
+        error = clGetDeviceInfo(device, CL_DEVICE_PLATFORM, sizeof(platform),
+                                &platform, NULL);
+        test_error(error, "clGetDeviceInfo failed");
+        createEventFromEGLSync = (CreateEventFromEGLSyncFn)
+            clGetExtensionFunctionAddressForPlatform(
+                platform, "clCreateEventFromEGLSyncKHR");
+        if (egl_extensions && strstr(egl_extensions, "EGL_KHR_fence_sync"))
+        {
+            createSync =
+                (PFNEGLCREATESYNCKHRPROC)eglGetProcAddress("eglCreateSyncKHR");
+            destroySync = (PFNEGLDESTROYSYNCKHRPROC)eglGetProcAddress(
+                "eglDestroySyncKHR");
+        }
+    }
+    bool useFence = createSync && destroySync && createEventFromEGLSync;
+    if (!useFence)
+        log_info("cl_khr_egl_event or EGL_KHR_fence_sync is not available, "
+                 "only timing acquire after glFinish.\n");
+
+    static const struct
+    {
+        const char *name;
+        double FrameTimes::*us;
+    } phases[] = {
+        { "acquire", &FrameTimes::acquire },
+        { "update", &FrameTimes::update },
+        { "release", &FrameTimes::release },
+        { "frame", &FrameTimes::frame },
+    };
+
+    BenchmarkOptions options;
+    options.warmup = 1;
+    options.maxSeconds = 1.0;
+
+    log_benchmark_header("gles_sharing", "resolution/phase");
+
+    for (size_t r = 0; r < ARRAY_SIZE(kResolutions); r++)
+    {
+        const CameraResolution &resolution = kResolutions[r];
+        size_t width = resolution.width;
+        size_t height = resolution.height;
+        if (width > max_width || height > max_height
+            || width > (size_t)max_texture || height > (size_t)max_texture)
+        {
+            log_info("%s is larger than the device or GLES allows, "
+                     "stopping.\n",
+                     resolution.name);
+            break;
+        }
+        size_t bytes = width * height * 4;
+
+        glTextureWrapper texture;
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, (GLsizei)width,
+                     (GLsizei)height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        GLenum glError = glGetError();
+        if (glError != GL_NO_ERROR)
+        {
+            log_info("Unable to create a %zux%zu texture (GL error 0x%x), "
+                     "stopping.\n",
+                     width, height, glError);
+            break;
+        }
+
+        clMemWrapper image = (*clCreateFromGLTexture_ptr)(
+            context, CL_MEM_READ_WRITE, GL_TEXTURE_2D, 0, texture, &error);
+        test_error(error, "Unable to create CL image from GL texture");
+        error = clSetKernelArg(kernel, 0, sizeof(cl_mem), &image);
+        test_error(error, "clSetKernelArg failed");
+
+        SharedTexture shared;
+        shared.queue = queue;
+        shared.kernel = kernel;
+        shared.image = image;
+        shared.width = width;
+        shared.height = height;
+
+        // Each frame fills the texture with its own value
+        int frame = 0;
+        for (const auto &phase : phases)
+        {
+            BenchmarkStats stats;
+            error = run_benchmark(
+                options,
+                [&](double *us) {
+                    FrameTimes times;
+                    cl_int err = TimeFrame(shared, frame++, &times);
+                    *us = times.*phase.us;
+                    return err;
+                },
+                &stats);
+            if (error != CL_SUCCESS) return error;
+
+            std::string row = std::string(resolution.name) + "/" + phase.name;
+            log_benchmark_stats("gles_sharing", row.c_str(), "us", false,
+                                stats);
+            if (phase.us == &FrameTimes::frame && stats.median > 0)
+            {
+                record_sharing_metric(resolution, "fps", 1e6 / stats.median,
+                                      "fps", true);
+                record_sharing_metric(resolution, "throughput",
+                                      bytes / stats.median, "MB/s", true);
+            }
+        }
+
+        error = shared.Verify(frame - 1);
+        if (error != CL_SUCCESS) return error;
+
+        // The same acquire, waiting on an EGL fence instead of glFinish, and
+        // with no synchronisation from the application at all
+        if (useFence)
+        {
+            BenchmarkStats fence;
+            error = run_benchmark(
+                options,
+                [&](double *us) -> cl_int {
+                    cl_int err;
+                    HostTimer timer;
+                    EGLSyncKHR sync =
+                        createSync(display, EGL_SYNC_FENCE_KHR, NULL);
+                    if (sync == EGL_NO_SYNC_KHR)
+                    {
+                        log_error("ERROR: eglCreateSyncKHR failed (0x%x)\n",
+                                  eglGetError());
+                        return -1;
+                    }
+                    clEventWrapper fenceEvent =
+                        createEventFromEGLSync(context, sync, display, &err);
+                    test_error(err, "clCreateEventFromEGLSyncKHR failed");
+                    err = shared.Acquire(1, &fenceEvent);
+                    if (err != CL_SUCCESS) return err;
+                    *us = timer.elapsed_us();
+                    destroySync(display, sync);
+                    return shared.Release();
+                },
+                &fence);
+            if (error != CL_SUCCESS) return error;
+            log_benchmark_stats(
+                "gles_sharing",
+                (std::string(resolution.name) + "/acquire_egl_fence").c_str(),
+                "us", false, fence);
+
+            BenchmarkStats implicit;
+            error = run_benchmark(
+                options,
+                [&](double *us) -> cl_int {
+                    HostTimer timer;
+                    cl_int err = shared.Acquire(0, NULL);
+                    if (err != CL_SUCCESS) return err;
+                    *us = timer.elapsed_us();
+                    return shared.Release();
+                },
+                &implicit);
+            if (error != CL_SUCCESS) return error;
+            log_benchmark_stats(
+                "gles_sharing",
+                (std::string(resolution.name) + "/acquire_implicit").c_str(),
+                "us", false, implicit);
+        }
+    }
+
+    return 0;
+}
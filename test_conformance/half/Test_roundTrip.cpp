@@ -179,7 +179,7 @@ int test_roundTrip( cl_device_id device, cl_context context, cl_command_queue qu
         for( j = 0; j < count; j++ )
             p[j] = j + i;
 
-        if( (error = clEnqueueWriteBuffer(gQueue, gInBuffer_half, CL_TRUE, 0, count * sizeof( cl_half ), gIn_half, 0, NULL, NULL)) )
+        if( (error = enqueue_write_staged(gQueue, gInBuffer_half, CL_TRUE, 0, count * sizeof( cl_half ), gIn_half, 0, NULL, NULL)) )
         {
             vlog_error( "Failure in clWriteArray\n" );
             gFailCount++;
@@ -192,7 +192,7 @@ int test_roundTrip( cl_device_id device, cl_context context, cl_command_queue qu
             uint32_t pattern = 0xdeaddead;
             memset_pattern4( gOut_half, &pattern, (size_t)getBufferSize(device)/2);
 
-            if( (error = clEnqueueWriteBuffer(gQueue, gOutBuffer_half, CL_TRUE, 0, count * sizeof(cl_half), gOut_half, 0, NULL, NULL)) )
+            if( (error = enqueue_write_staged(gQueue, gOutBuffer_half, CL_TRUE, 0, count * sizeof(cl_half), gOut_half, 0, NULL, NULL)) )
             {
                 vlog_error( "Failure in clWriteArray\n" );
                 gFailCount++;
@@ -209,7 +209,7 @@ int test_roundTrip( cl_device_id device, cl_context context, cl_command_queue qu
                 goto exit;
             }
 
-            if( (error = clEnqueueReadBuffer(gQueue, gOutBuffer_half, CL_TRUE, 0, count * sizeof(cl_half), gOut_half, 0, NULL, NULL)) )
+            if( (error = enqueue_read_staged(gQueue, gOutBuffer_half, CL_TRUE, 0, count * sizeof(cl_half), gOut_half, 0, NULL, NULL)) )
             {
                 vlog_error( "Failure in clReadArray\n" );
                 gFailCount++;
@@ -247,7 +247,7 @@ int test_roundTrip( cl_device_id device, cl_context context, cl_command_queue qu
             if( gTestDouble )
             {
                 memset_pattern4( gOut_half, &pattern, (size_t)getBufferSize(device)/2);
-                if( (error = clEnqueueWriteBuffer(gQueue, gOutBuffer_half, CL_TRUE, 0, count * sizeof(cl_half), gOut_half, 0, NULL, NULL)) )
+                if( (error = enqueue_write_staged(gQueue, gOutBuffer_half, CL_TRUE, 0, count * sizeof(cl_half), gOut_half, 0, NULL, NULL)) )
                 {
                     vlog_error( "Failure in clWriteArray\n" );
                     gFailCount++;
@@ -262,7 +262,7 @@ int test_roundTrip( cl_device_id device, cl_context context, cl_command_queue qu
                     goto exit;
                 }
 
-                if( (error = clEnqueueReadBuffer(gQueue, gOutBuffer_half, CL_TRUE, 0, count * sizeof(cl_half), gOut_half, 0, NULL, NULL)) )
+                if( (error = enqueue_read_staged(gQueue, gOutBuffer_half, CL_TRUE, 0, count * sizeof(cl_half), gOut_half, 0, NULL, NULL)) )
                 {
                     vlog_error( "Failure in clReadArray\n" );
                     gFailCount++;
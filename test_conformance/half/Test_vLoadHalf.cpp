@@ -22,6 +22,7 @@
 #include <cinttypes>
 
 #include "cl_utils.h"
+#include "half_convert.h"
 #include "tests.h"
 
 #include <CL/cl_half.h>
@@ -459,7 +460,7 @@ int Test_vLoadHalf_private( cl_device_id device, bool aligned )
         for( j = 0; j < count; j++ )
             p[j] = j + i;
 
-        if( (error = clEnqueueWriteBuffer(gQueue, gInBuffer_half, CL_TRUE, 0, count * sizeof( cl_half ), gIn_half, 0, NULL, NULL)))
+        if( (error = enqueue_write_staged(gQueue, gInBuffer_half, CL_TRUE, 0, count * sizeof( cl_half ), gIn_half, 0, NULL, NULL)))
         {
             vlog_error( "Failure in clWriteArray\n" );
             gFailCount++;
@@ -467,9 +468,8 @@ int Test_vLoadHalf_private( cl_device_id device, bool aligned )
         }
 
         //create the reference result
-        const unsigned short *s = (const unsigned short *)gIn_half;
-        float *d = (float *)gOut_single_reference;
-        for (j = 0; j < count; j++) d[j] = cl_half_to_float(s[j]);
+        half2float_array((float *)gOut_single_reference,
+                         (const cl_half *)gIn_half, count);
 
         //Check the vector lengths
         for( vectorSize = minVectorSize; vectorSize < kLastVectorSizeToTest; vectorSize++)
@@ -485,7 +485,7 @@ int Test_vLoadHalf_private( cl_device_id device, bool aligned )
                  }
                  */
                 memset_pattern4( gOut_single, &pattern, getBufferSize(device));
-                if( (error = clEnqueueWriteBuffer(gQueue, gOutBuffer_single, CL_TRUE, 0, count * sizeof( float ), gOut_single, 0, NULL, NULL)) )
+                if( (error = enqueue_write_staged(gQueue, gOutBuffer_single, CL_TRUE, 0, count * sizeof( float ), gOut_single, 0, NULL, NULL)) )
                 {
                     vlog_error( "Failure in clWriteArray\n" );
                     gFailCount++;
@@ -505,7 +505,7 @@ int Test_vLoadHalf_private( cl_device_id device, bool aligned )
                     goto exit;
                 }
 
-                if( (error = clEnqueueReadBuffer(gQueue, gOutBuffer_single, CL_TRUE, 0, count * sizeof( float ), gOut_single, 0, NULL, NULL)) )
+                if( (error = enqueue_read_staged(gQueue, gOutBuffer_single, CL_TRUE, 0, count * sizeof( float ), gOut_single, 0, NULL, NULL)) )
                 {
                     vlog_error( "Failure in clReadArray\n" );
                     gFailCount++;
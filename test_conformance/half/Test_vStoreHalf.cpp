@@ -13,15 +13,19 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 //
+#include "harness/checkpoint.h"
 #include "harness/compat.h"
 #include "harness/kernelHelpers.h"
 #include "harness/testHarness.h"
+#include "harness/typeWrappers.h"
 
 #include <string.h>
 
 #include <algorithm>
+#include <vector>
 
 #include "cl_utils.h"
+#include "half_convert.h"
 #include "tests.h"
 
 #include <CL/cl_half.h>
@@ -31,6 +35,9 @@ typedef struct ComputeReferenceInfoF_
     float *x;
     cl_ushort *r;
     f2h f;
+    // Set when f is cl_half_from_float in mode, to use float2half_array
+    bool batch;
+    cl_half_rounding_mode mode;
     cl_ulong i;
     cl_uint lim;
     cl_uint count;
@@ -84,11 +91,12 @@ static cl_int ReferenceF(cl_uint jid, cl_uint tid, void *userInfo)
 
     if (off + count > lim) count = lim - off;
 
-    for (j = 0; j < count; ++j)
-    {
-        x[j] = as_float((cl_uint)(i + j));
-        r[j] = f(x[j]);
-    }
+    for (j = 0; j < count; ++j) x[j] = as_float((cl_uint)(i + j));
+
+    if (cri->batch)
+        float2half_array(r, x, count, cri->mode);
+    else
+        for (j = 0; j < count; ++j) r[j] = f(x[j]);
 
     return 0;
 }
@@ -207,6 +215,134 @@ static cl_int CheckD(cl_uint jid, cl_uint tid, void *userInfo)
     return ret;
 }
 
+// Number of store runs whose results can be in flight at once. The runs of
+// a block, one per vector size, address space and input type, write these
+// output buffers in turn and are read back without blocking, so the device
+// works on the later runs while the host checks the earlier ones.
+static const size_t kStoreRunsInFlight = 4;
+
+typedef struct StoreRun_
+{
+    cl_kernel kernel;
+    cl_mem input;
+    bool isDouble;
+    int vectorSize;
+    int addressSpace;
+} StoreRun;
+
+typedef struct StoreSlot_
+{
+    clMemWrapper buffer;
+    std::vector<cl_half> results;
+    clEventWrapper read;
+} StoreSlot;
+
+static int CreateStoreSlots(std::vector<StoreSlot> &slots)
+{
+    int error = CL_SUCCESS;
+    slots.resize(kStoreRunsInFlight);
+    for (StoreSlot &slot : slots)
+    {
+        slot.buffer = clCreateBuffer(gContext, CL_MEM_WRITE_ONLY,
+                                     gBufferSize / 2, NULL, &error);
+        if (error)
+        {
+            vlog_error("clCreateArray failed for output (%d)\n", error);
+            return error;
+        }
+        slot.results.resize(gBufferSize / 2 / sizeof(cl_half));
+    }
+
+    // The host reset copies this pattern to the output buffers
+    cl_uint pattern = 0xdeaddead;
+    memset_pattern4(gOut_half, &pattern, gBufferSize / 2);
+    return CL_SUCCESS;
+}
+
+static int EnqueueStoreRun(cl_device_id device, StoreSlot &slot,
+                           const StoreRun &run, cl_uint count, bool aligned,
+                           cl_kernel resetKernel)
+{
+    int error;
+    if (!gHostReset)
+    {
+        error = RunKernel(device, resetKernel, gInBuffer_single, slot.buffer,
+                          count, 0);
+    }
+    else
+    {
+        error = enqueue_write_staged(gQueue, slot.buffer, CL_FALSE, 0,
+                                     count * sizeof(cl_half), gOut_half, 0,
+                                     NULL, NULL);
+    }
+    if (error)
+    {
+        vlog_error("Failure in clWriteArray\n");
+        return error;
+    }
+
+    error = RunKernel(device, run.kernel, run.input, slot.buffer,
+                      numVecs(count, run.vectorSize, aligned),
+                      runsOverBy(count, run.vectorSize, aligned));
+    if (error) return error;
+
+    slot.read.reset();
+    error = enqueue_read_staged(gQueue, slot.buffer, CL_FALSE, 0,
+                                count * sizeof(cl_half), slot.results.data(),
+                                0, NULL, &slot.read);
+    if (error) vlog_error("Failure in clReadArray\n");
+    return error;
+}
+
+// Runs all of runs over the count inputs of the current block and checks
+// them in order, stopping at the first failure
+static int RunStoreBlock(cl_device_id device, std::vector<StoreSlot> &slots,
+                         const std::vector<StoreRun> &runs, cl_uint count,
+                         bool aligned, cl_kernel resetKernel,
+                         CheckResultInfoF fchk, CheckResultInfoD dchk,
+                         cl_uint threadCount)
+{
+    int error = 0;
+    size_t next = 0;
+    for (size_t done = 0; done < runs.size() && !error; done++)
+    {
+        for (; !error && next < runs.size() && next < done + slots.size();
+             next++)
+            error = EnqueueStoreRun(device, slots[next % slots.size()],
+                                    runs[next], count, aligned, resetKernel);
+        if (!error) error = clFlush(gQueue);
+        if (error) break;
+
+        StoreSlot &slot = slots[done % slots.size()];
+        const StoreRun &run = runs[done];
+        error = clWaitForEvents(1, &slot.read);
+        if (error)
+        {
+            vlog_error("Failure in clReadArray\n");
+            break;
+        }
+
+        if (run.isDouble)
+        {
+            dchk.s = slot.results.data();
+            dchk.vsz = g_arrVecSizes[run.vectorSize];
+            dchk.aspace = addressSpaceNames[run.addressSpace];
+            error = ThreadPool_Do(CheckD, threadCount, &dchk);
+        }
+        else
+        {
+            fchk.s = slot.results.data();
+            fchk.vsz = g_arrVecSizes[run.vectorSize];
+            fchk.aspace = addressSpaceNames[run.addressSpace];
+            error = ThreadPool_Do(CheckF, threadCount, &fchk);
+        }
+    }
+
+    // Don't leave reads into the slots outstanding
+    clFinish(gQueue);
+    return error;
+}
+
 static cl_half float2half_rte(float f)
 {
     return cl_half_from_float(f, CL_HALF_RTE);
@@ -227,6 +363,22 @@ static cl_half float2half_rtn(float f)
     return cl_half_from_float(f, CL_HALF_RTN);
 }
 
+// Finds the rounding mode of one of the float references above
+static bool float2half_mode(f2h f, cl_half_rounding_mode *mode)
+{
+    if (f == float2half_rte)
+        *mode = CL_HALF_RTE;
+    else if (f == float2half_rtz)
+        *mode = CL_HALF_RTZ;
+    else if (f == float2half_rtp)
+        *mode = CL_HALF_RTP;
+    else if (f == float2half_rtn)
+        *mode = CL_HALF_RTN;
+    else
+        return false;
+    return true;
+}
+
 static cl_half double2half_rte(double f)
 {
     return cl_half_from_double(f, CL_HALF_RTE);
@@ -852,7 +1004,7 @@ int Test_vStoreHalf_private(cl_device_id device, f2h referenceFunc,
 
     // Figure out how many elements are in a work block
     size_t elementSize = std::max(sizeof(cl_ushort), sizeof(float));
-    size_t blockCount = BUFFER_SIZE / elementSize; // elementSize is power of 2
+    size_t blockCount = gBufferSize / elementSize; // elementSize is power of 2
     uint64_t lastCase = 1ULL << (8 * sizeof(float)); // number of floats.
     size_t stride = blockCount;
 
@@ -874,6 +1026,7 @@ int Test_vStoreHalf_private(cl_device_id device, f2h referenceFunc,
     fref.x = (float *)gIn_single;
     fref.r = (cl_half *)gOut_half_reference;
     fref.f = referenceFunc;
+    fref.batch = float2half_mode(referenceFunc, &fref.mode);
     fref.lim = blockCount;
     fref.count = (blockCount + threadCount - 1) / threadCount;
 
@@ -900,16 +1053,51 @@ int Test_vStoreHalf_private(cl_device_id device, f2h referenceFunc,
     dchk.lim = blockCount;
     dchk.count = (blockCount + threadCount - 1) / threadCount;
 
+    // Each block is a checkpoint job
+    std::unique_ptr<JobCheckpoint> checkpoint =
+        JobCheckpoint::Open(std::string("vstore_half") + roundName,
+                            (cl_uint)((lastCase + stride - 1) / stride));
+
+    // Every block runs the same stores
+    std::vector<StoreRun> runs;
+    for (vectorSize = kMinVectorSize; vectorSize < kLastVectorSizeToTest;
+         vectorSize++)
+    {
+        for (addressSpace = 0; addressSpace < 3; addressSpace++)
+        {
+            StoreRun run = { kernels[vectorSize][addressSpace],
+                             gInBuffer_single, false, vectorSize,
+                             addressSpace };
+            runs.push_back(run);
+            if (gTestDouble)
+            {
+                StoreRun doubleRun = { doubleKernels[vectorSize][addressSpace],
+                                       gInBuffer_double, true, vectorSize,
+                                       addressSpace };
+                runs.push_back(doubleRun);
+            }
+        }
+    }
+
+    std::vector<StoreSlot> slots;
+    error = CreateStoreSlots(slots);
+    if (error)
+    {
+        gFailCount++;
+        goto exit;
+    }
+
     for (i = 0; i < lastCase; i += stride)
     {
         count = (cl_uint)std::min((uint64_t)blockCount, lastCase - i);
+        if (checkpoint && checkpoint->IsDone((cl_uint)(i / stride))) continue;
         fref.i = i;
         dref.i = i;
 
         // Compute the input and reference
         ThreadPool_Do(ReferenceF, threadCount, &fref);
 
-        error = clEnqueueWriteBuffer(gQueue, gInBuffer_single, CL_FALSE, 0,
+        error = enqueue_write_staged(gQueue, gInBuffer_single, CL_FALSE, 0,
                                      count * sizeof(float), gIn_single, 0, NULL,
                                      NULL);
         if (error)
@@ -923,7 +1111,7 @@ int Test_vStoreHalf_private(cl_device_id device, f2h referenceFunc,
         {
             ThreadPool_Do(ReferenceD, threadCount, &dref);
 
-            error = clEnqueueWriteBuffer(gQueue, gInBuffer_double, CL_FALSE, 0,
+            error = enqueue_write_staged(gQueue, gInBuffer_double, CL_FALSE, 0,
                                          count * sizeof(double), gIn_double, 0,
                                          NULL, NULL);
             if (error)
@@ -934,123 +1122,16 @@ int Test_vStoreHalf_private(cl_device_id device, f2h referenceFunc,
             }
         }
 
-        for (vectorSize = kMinVectorSize; vectorSize < kLastVectorSizeToTest;
-             vectorSize++)
+        error = RunStoreBlock(device, slots, runs, count, aligned,
+                              resetKernel, fchk, dchk, threadCount);
+        if (error)
         {
-            // Loop through vector sizes
-            fchk.vsz = g_arrVecSizes[vectorSize];
-            dchk.vsz = g_arrVecSizes[vectorSize];
-
-            for (addressSpace = 0; addressSpace < 3; addressSpace++)
-            {
-                // Loop over address spaces
-                fchk.aspace = addressSpaceNames[addressSpace];
-                dchk.aspace = addressSpaceNames[addressSpace];
-
-                if (!gHostReset)
-                {
-                    error = RunKernel(device, resetKernel, gInBuffer_single,
-                                      gOutBuffer_half, count, 0);
-                }
-                else
-                {
-                    cl_uint pattern = 0xdeaddead;
-                    memset_pattern4(gOut_half, &pattern, BUFFER_SIZE / 2);
-
-                    error = clEnqueueWriteBuffer(
-                        gQueue, gOutBuffer_half, CL_FALSE, 0,
-                        count * sizeof(cl_half), gOut_half, 0, NULL, NULL);
-                }
-                if (error)
-                {
-                    vlog_error("Failure in clWriteArray\n");
-                    gFailCount++;
-                    goto exit;
-                }
-
-                error = RunKernel(device, kernels[vectorSize][addressSpace],
-                                  gInBuffer_single, gOutBuffer_half,
-                                  numVecs(count, vectorSize, aligned),
-                                  runsOverBy(count, vectorSize, aligned));
-                if (error)
-                {
-                    gFailCount++;
-                    goto exit;
-                }
-
-                error = clEnqueueReadBuffer(gQueue, gOutBuffer_half, CL_TRUE, 0,
-                                            count * sizeof(cl_half), gOut_half,
-                                            0, NULL, NULL);
-                if (error)
-                {
-                    vlog_error("Failure in clReadArray\n");
-                    gFailCount++;
-                    goto exit;
-                }
-
-                error = ThreadPool_Do(CheckF, threadCount, &fchk);
-                if (error)
-                {
-                    gFailCount++;
-                    goto exit;
-                }
-
-                if (gTestDouble)
-                {
-
-                    if (!gHostReset)
-                    {
-                        error = RunKernel(device, resetKernel, gInBuffer_double,
-                                          gOutBuffer_half, count, 0);
-                    }
-                    else
-                    {
-                        cl_uint pattern = 0xdeaddead;
-                        memset_pattern4(gOut_half, &pattern, BUFFER_SIZE / 2);
-
-                        error = clEnqueueWriteBuffer(
-                            gQueue, gOutBuffer_half, CL_FALSE, 0,
-                            count * sizeof(cl_half), gOut_half, 0, NULL, NULL);
-                    }
-                    if (error)
-                    {
-                        vlog_error("Failure in clWriteArray\n");
-                        gFailCount++;
-                        goto exit;
-                    }
-
-                    error = RunKernel(device,
-                                      doubleKernels[vectorSize][addressSpace],
-                                      gInBuffer_double, gOutBuffer_half,
-                                      numVecs(count, vectorSize, aligned),
-                                      runsOverBy(count, vectorSize, aligned));
-                    if (error)
-                    {
-                        gFailCount++;
-                        goto exit;
-                    }
-
-                    error = clEnqueueReadBuffer(
-                        gQueue, gOutBuffer_half, CL_TRUE, 0,
-                        count * sizeof(cl_half), gOut_half, 0, NULL, NULL);
-                    if (error)
-                    {
-                        vlog_error("Failure in clReadArray\n");
-                        gFailCount++;
-                        goto exit;
-                    }
-
-
-                    error = ThreadPool_Do(CheckD, threadCount, &dchk);
-                    if (error)
-                    {
-                        gFailCount++;
-                        goto exit;
-                    }
-                }
-            }
+            gFailCount++;
+            goto exit;
         }
 
+        if (checkpoint) checkpoint->MarkDone((cl_uint)(i / stride));
+
         if (((i + blockCount) & ~printMask) == (i + blockCount))
         {
             vlog(".");
@@ -1066,7 +1147,7 @@ int Test_vStoreHalf_private(cl_device_id device, f2h referenceFunc,
         for (j = 0; j < count; j++)
             p[j] = (float)((double)(rand() - RAND_MAX / 2) / (RAND_MAX / 2));
 
-        if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer_single, CL_TRUE, 0,
+        if ((error = enqueue_write_staged(gQueue, gInBuffer_single, CL_TRUE, 0,
                                           count * sizeof(float), gIn_single, 0,
                                           NULL, NULL)))
         {
@@ -1082,7 +1163,7 @@ int Test_vStoreHalf_private(cl_device_id device, f2h referenceFunc,
             for (j = 0; j < count; j++)
                 q[j] = ((double)(rand() - RAND_MAX / 2) / (RAND_MAX / 2));
 
-            if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer_double, CL_TRUE,
+            if ((error = enqueue_write_staged(gQueue, gInBuffer_double, CL_TRUE,
                                               0, count * sizeof(double),
                                               gIn_double, 0, NULL, NULL)))
             {
@@ -1699,7 +1780,7 @@ int Test_vStoreaHalf_private(cl_device_id device, f2h referenceFunc,
 
     // Figure out how many elements are in a work block
     size_t elementSize = std::max(sizeof(cl_ushort), sizeof(float));
-    size_t blockCount = BUFFER_SIZE / elementSize;
+    size_t blockCount = gBufferSize / elementSize;
     uint64_t lastCase = 1ULL << (8 * sizeof(float));
     size_t stride = blockCount;
 
@@ -1720,6 +1801,7 @@ int Test_vStoreaHalf_private(cl_device_id device, f2h referenceFunc,
     fref.x = (float *)gIn_single;
     fref.r = (cl_half *)gOut_half_reference;
     fref.f = referenceFunc;
+    fref.batch = float2half_mode(referenceFunc, &fref.mode);
     fref.lim = blockCount;
     fref.count = (blockCount + threadCount - 1) / threadCount;
 
@@ -1746,16 +1828,51 @@ int Test_vStoreaHalf_private(cl_device_id device, f2h referenceFunc,
     dchk.lim = blockCount;
     dchk.count = (blockCount + threadCount - 1) / threadCount;
 
+    // Each block is a checkpoint job
+    std::unique_ptr<JobCheckpoint> checkpoint =
+        JobCheckpoint::Open(std::string("vstorea_half") + roundName,
+                            (cl_uint)((lastCase + stride - 1) / stride));
+
+    // Every block runs the same stores
+    std::vector<StoreRun> runs;
+    for (vectorSize = minVectorSize; vectorSize < kLastVectorSizeToTest;
+         vectorSize++)
+    {
+        for (addressSpace = 0; addressSpace < 3; addressSpace++)
+        {
+            StoreRun run = { kernels[vectorSize][addressSpace],
+                             gInBuffer_single, false, vectorSize,
+                             addressSpace };
+            runs.push_back(run);
+            if (gTestDouble)
+            {
+                StoreRun doubleRun = { doubleKernels[vectorSize][addressSpace],
+                                       gInBuffer_double, true, vectorSize,
+                                       addressSpace };
+                runs.push_back(doubleRun);
+            }
+        }
+    }
+
+    std::vector<StoreSlot> slots;
+    error = CreateStoreSlots(slots);
+    if (error)
+    {
+        gFailCount++;
+        goto exit;
+    }
+
     for (i = 0; i < (uint64_t)lastCase; i += stride)
     {
         count = (cl_uint)std::min((uint64_t)blockCount, lastCase - i);
+        if (checkpoint && checkpoint->IsDone((cl_uint)(i / stride))) continue;
         fref.i = i;
         dref.i = i;
 
         // Create the input and reference
         ThreadPool_Do(ReferenceF, threadCount, &fref);
 
-        error = clEnqueueWriteBuffer(gQueue, gInBuffer_single, CL_FALSE, 0,
+        error = enqueue_write_staged(gQueue, gInBuffer_single, CL_FALSE, 0,
                                      count * sizeof(float), gIn_single, 0, NULL,
                                      NULL);
         if (error)
@@ -1769,7 +1886,7 @@ int Test_vStoreaHalf_private(cl_device_id device, f2h referenceFunc,
         {
             ThreadPool_Do(ReferenceD, threadCount, &dref);
 
-            error = clEnqueueWriteBuffer(gQueue, gInBuffer_double, CL_FALSE, 0,
+            error = enqueue_write_staged(gQueue, gInBuffer_double, CL_FALSE, 0,
                                          count * sizeof(double), gIn_double, 0,
                                          NULL, NULL);
             if (error)
@@ -1780,121 +1897,15 @@ int Test_vStoreaHalf_private(cl_device_id device, f2h referenceFunc,
             }
         }
 
-        for (vectorSize = minVectorSize; vectorSize < kLastVectorSizeToTest;
-             vectorSize++)
+        error = RunStoreBlock(device, slots, runs, count, aligned,
+                              resetKernel, fchk, dchk, threadCount);
+        if (error)
         {
-            // Loop over vector legths
-            fchk.vsz = g_arrVecSizes[vectorSize];
-            dchk.vsz = g_arrVecSizes[vectorSize];
-
-            for (addressSpace = 0; addressSpace < 3; addressSpace++)
-            {
-                // Loop over address spaces
-                fchk.aspace = addressSpaceNames[addressSpace];
-                dchk.aspace = addressSpaceNames[addressSpace];
-
-                if (!gHostReset)
-                {
-                    error = RunKernel(device, resetKernel, gInBuffer_single,
-                                      gOutBuffer_half, count, 0);
-                }
-                else
-                {
-                    cl_uint pattern = 0xdeaddead;
-                    memset_pattern4(gOut_half, &pattern, BUFFER_SIZE / 2);
-
-                    error = clEnqueueWriteBuffer(
-                        gQueue, gOutBuffer_half, CL_FALSE, 0,
-                        count * sizeof(cl_half), gOut_half, 0, NULL, NULL);
-                }
-                if (error)
-                {
-                    vlog_error("Failure in clWriteArray\n");
-                    gFailCount++;
-                    goto exit;
-                }
-
-                error = RunKernel(device, kernels[vectorSize][addressSpace],
-                                  gInBuffer_single, gOutBuffer_half,
-                                  numVecs(count, vectorSize, aligned),
-                                  runsOverBy(count, vectorSize, aligned));
-                if (error)
-                {
-                    gFailCount++;
-                    goto exit;
-                }
-
-                error = clEnqueueReadBuffer(gQueue, gOutBuffer_half, CL_TRUE, 0,
-                                            count * sizeof(cl_half), gOut_half,
-                                            0, NULL, NULL);
-                if (error)
-                {
-                    vlog_error("Failure in clReadArray\n");
-                    gFailCount++;
-                    goto exit;
-                }
-
-                error = ThreadPool_Do(CheckF, threadCount, &fchk);
-                if (error)
-                {
-                    gFailCount++;
-                    goto exit;
-                }
-
-                if (gTestDouble)
-                {
-
-                    if (!gHostReset)
-                    {
-                        error = RunKernel(device, resetKernel, gInBuffer_single,
-                                          gOutBuffer_half, count, 0);
-                    }
-                    else
-                    {
-                        cl_uint pattern = 0xdeaddead;
-                        memset_pattern4(gOut_half, &pattern, BUFFER_SIZE / 2);
-
-                        error = clEnqueueWriteBuffer(
-                            gQueue, gOutBuffer_half, CL_FALSE, 0,
-                            count * sizeof(cl_half), gOut_half, 0, NULL, NULL);
-                    }
-                    if (error)
-                    {
-                        vlog_error("Failure in clWriteArray\n");
-                        gFailCount++;
-                        goto exit;
-                    }
-
-                    error = RunKernel(device,
-                                      doubleKernels[vectorSize][addressSpace],
-                                      gInBuffer_double, gOutBuffer_half,
-                                      numVecs(count, vectorSize, aligned),
-                                      runsOverBy(count, vectorSize, aligned));
-                    if (error)
-                    {
-                        gFailCount++;
-                        goto exit;
-                    }
-
-                    error = clEnqueueReadBuffer(
-                        gQueue, gOutBuffer_half, CL_TRUE, 0,
-                        count * sizeof(cl_half), gOut_half, 0, NULL, NULL);
-                    if (error)
-                    {
-                        vlog_error("Failure in clReadArray\n");
-                        gFailCount++;
-                        goto exit;
-                    }
+            gFailCount++;
+            goto exit;
+        }
 
-                    error = ThreadPool_Do(CheckD, threadCount, &dchk);
-                    if (error)
-                    {
-                        gFailCount++;
-                        goto exit;
-                    }
-                }
-            }
-        } // end for vector size
+        if (checkpoint) checkpoint->MarkDone((cl_uint)(i / stride));
 
         if (((i + blockCount) & ~printMask) == (i + blockCount))
         {
@@ -1911,7 +1922,7 @@ int Test_vStoreaHalf_private(cl_device_id device, f2h referenceFunc,
         for (j = 0; j < count; j++)
             p[j] = (float)((double)(rand() - RAND_MAX / 2) / (RAND_MAX / 2));
 
-        if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer_single, CL_TRUE, 0,
+        if ((error = enqueue_write_staged(gQueue, gInBuffer_single, CL_TRUE, 0,
                                           count * sizeof(float), gIn_single, 0,
                                           NULL, NULL)))
         {
@@ -1927,7 +1938,7 @@ int Test_vStoreaHalf_private(cl_device_id device, f2h referenceFunc,
             for (j = 0; j < count; j++)
                 q[j] = ((double)(rand() - RAND_MAX / 2) / (RAND_MAX / 2));
 
-            if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer_double, CL_TRUE,
+            if ((error = enqueue_write_staged(gQueue, gInBuffer_double, CL_TRUE,
                                               0, count * sizeof(double),
                                               gIn_double, 0, NULL, NULL)))
             {
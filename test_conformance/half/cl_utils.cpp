@@ -22,6 +22,7 @@
 
 #include "test_config.h"
 #include "string.h"
+#include "harness/bufferSizing.h"
 #include "harness/kernelHelpers.h"
 
 #include "harness/testHarness.h"
@@ -60,6 +61,7 @@ size_t gMaxThreadGroupSize = 0;
 size_t gWorkGroupSize = 0;
 bool gWimpyMode = false;
 int gWimpyReductionFactor = 512;
+size_t gBufferSize = DEFAULT_BUFFER_SIZE;
 int gTestDouble = 0;
 bool gHostReset = false;
 
@@ -116,18 +118,24 @@ test_status InitCL( cl_device_id device )
         return TEST_FAIL;
     }
 
+    // Up to nine buffers of gBufferSize live on the device, counting the
+    // output buffers the vstore tests keep in flight, and verification
+    // streams through about five of them at a time.
+    gBufferSize = ChooseBufferSize(gContext, gQueue, device,
+                                   DEFAULT_BUFFER_SIZE, 9, 5);
+
 #if defined( __APPLE__ )
     // FIXME: use clProtectedArray
 #endif
     //Allocate buffers
     gIn_half   = malloc( getBufferSize(device)/2  );
-    gOut_half = malloc( BUFFER_SIZE/2  );
-    gOut_half_reference = malloc( BUFFER_SIZE/2  );
-    gOut_half_reference_double = malloc( BUFFER_SIZE/2  );
-    gIn_single   = malloc( BUFFER_SIZE );
+    gOut_half = malloc( gBufferSize/2  );
+    gOut_half_reference = malloc( gBufferSize/2  );
+    gOut_half_reference_double = malloc( gBufferSize/2  );
+    gIn_single   = malloc( gBufferSize );
     gOut_single = malloc( getBufferSize(device)  );
     gOut_single_reference = malloc( getBufferSize(device)  );
-    gIn_double   = malloc( 2*BUFFER_SIZE  );
+    gIn_double   = malloc( 2*gBufferSize  );
     // gOut_double = malloc( (2*getBufferSize(device))  );
     // gOut_double_reference = malloc( (2*getBufferSize(device))  );
 
@@ -149,21 +157,21 @@ test_status InitCL( cl_device_id device )
         return TEST_FAIL;
     }
 
-    gInBuffer_single = clCreateBuffer(gContext, CL_MEM_READ_ONLY, BUFFER_SIZE, NULL, &error );
+    gInBuffer_single = clCreateBuffer(gContext, CL_MEM_READ_ONLY, gBufferSize, NULL, &error );
     if( gInBuffer_single == NULL )
     {
         vlog_error( "clCreateArray failed for input (%d)\n", error );
         return TEST_FAIL;
     }
 
-    gInBuffer_double = clCreateBuffer(gContext, CL_MEM_READ_ONLY, BUFFER_SIZE*2, NULL, &error );
+    gInBuffer_double = clCreateBuffer(gContext, CL_MEM_READ_ONLY, gBufferSize*2, NULL, &error );
     if( gInBuffer_double == NULL )
     {
         vlog_error( "clCreateArray failed for input (%d)\n", error );
         return TEST_FAIL;
     }
 
-    gOutBuffer_half = clCreateBuffer(gContext, CL_MEM_WRITE_ONLY, BUFFER_SIZE/2, NULL, &error );
+    gOutBuffer_half = clCreateBuffer(gContext, CL_MEM_WRITE_ONLY, gBufferSize/2, NULL, &error );
     if( gOutBuffer_half == NULL )
     {
         vlog_error( "clCreateArray failed for output (%d)\n", error );
@@ -250,6 +258,7 @@ void ReleaseCL(void)
     clReleaseMemObject(gOutBuffer_single);
     clReleaseMemObject(gInBuffer_double);
     // clReleaseMemObject(gOutBuffer_double);
+    release_staging_buffers(gContext);
     clReleaseCommandQueue(gQueue);
     clReleaseContext(gContext);
 
@@ -389,8 +398,8 @@ size_t getBufferSize(cl_device_id device_id)
             s_result = 64*1024;
             goto exit;
         }
-        if (result > BUFFER_SIZE)
-            result = BUFFER_SIZE;
+        if (result > gBufferSize)
+            result = gBufferSize;
         log_info("Using const buffer size 0x%lx (%lu)\n", (unsigned long)result, (unsigned long)result);
         err = clGetDeviceInfo (device_id,
                                CL_DEVICE_GLOBAL_MEM_SIZE,
@@ -19,6 +19,7 @@
 #include "harness/testHarness.h"
 #include "harness/compat.h"
 #include "harness/conversions.h"
+#include "harness/stagingPool.h"
 
 #include <stdio.h>
 
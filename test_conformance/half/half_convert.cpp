@@ -0,0 +1,226 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "half_convert.h"
+
+#include <string.h>
+
+#if (defined(__GNUC__) || defined(__clang__))                                 \
+    && (defined(__x86_64__) || defined(__aarch64__))
+#define HALF_CONVERT_SIMD 1
+#if defined(__x86_64__)
+#include <immintrin.h>
+#else
+#include <arm_neon.h>
+#include <fenv.h>
+#endif
+#endif
+
+// The hardware conversions round exactly as cl_half_from_float does,
+// including overflow to the largest finite value in the directed modes, and
+// produce half denormals whatever MXCSR.FTZ or FPCR.FZ16 say. Float and half
+// denormal inputs would be flushed with DAZ or FPCR.FZ set and NaN payloads
+// may be propagated differently, so a block holding any of those is
+// converted with the scalar functions, as is the tail of the array.
+
+static void float2half_scalar(cl_half *r, const float *x, size_t count,
+                              cl_half_rounding_mode mode)
+{
+    for (size_t i = 0; i < count; i++) r[i] = cl_half_from_float(x[i], mode);
+}
+
+static void half2float_scalar(float *r, const cl_half *x, size_t count)
+{
+    for (size_t i = 0; i < count; i++) r[i] = cl_half_to_float(x[i]);
+}
+
+#if defined(HALF_CONVERT_SIMD)
+
+static inline bool float_needs_scalar(const float *x, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        cl_uint bits;
+        memcpy(&bits, x + i, sizeof(bits));
+        bits &= 0x7fffffffU;
+        if (bits > 0x7f800000U || (bits != 0 && bits < 0x00800000U))
+            return true;
+    }
+    return false;
+}
+
+static inline bool half_needs_scalar(const cl_half *x, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        cl_half bits = x[i] & 0x7fff;
+        if (bits > 0x7c00 || (bits != 0 && bits < 0x0400)) return true;
+    }
+    return false;
+}
+
+#endif
+
+#if defined(HALF_CONVERT_SIMD) && defined(__x86_64__)
+
+static const size_t kBlock = 8;
+
+static bool have_f16c()
+{
+    static const bool f16c = __builtin_cpu_supports("f16c");
+    return f16c;
+}
+
+template <int Rounding>
+__attribute__((target("avx,f16c"))) static void
+float2half_f16c(cl_half *r, const float *x, size_t count,
+                cl_half_rounding_mode mode)
+{
+    size_t i = 0;
+    for (; i + kBlock <= count; i += kBlock)
+    {
+        if (float_needs_scalar(x + i, kBlock))
+        {
+            float2half_scalar(r + i, x + i, kBlock, mode);
+            continue;
+        }
+        __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(x + i),
+                                    Rounding | _MM_FROUND_NO_EXC);
+        _mm_storeu_si128((__m128i *)(r + i), h);
+    }
+    float2half_scalar(r + i, x + i, count - i, mode);
+}
+
+__attribute__((target("avx,f16c"))) static void
+half2float_f16c(float *r, const cl_half *x, size_t count)
+{
+    size_t i = 0;
+    for (; i + kBlock <= count; i += kBlock)
+    {
+        if (half_needs_scalar(x + i, kBlock))
+        {
+            half2float_scalar(r + i, x + i, kBlock);
+            continue;
+        }
+        __m128i h = _mm_loadu_si128((const __m128i *)(x + i));
+        _mm256_storeu_ps(r + i, _mm256_cvtph_ps(h));
+    }
+    half2float_scalar(r + i, x + i, count - i);
+}
+
+void float2half_array(cl_half *r, const float *x, size_t count,
+                      cl_half_rounding_mode mode)
+{
+    if (have_f16c())
+    {
+        switch (mode)
+        {
+            case CL_HALF_RTE:
+                return float2half_f16c<_MM_FROUND_TO_NEAREST_INT>(r, x, count,
+                                                                  mode);
+            case CL_HALF_RTZ:
+                return float2half_f16c<_MM_FROUND_TO_ZERO>(r, x, count, mode);
+            case CL_HALF_RTP:
+                return float2half_f16c<_MM_FROUND_TO_POS_INF>(r, x, count,
+                                                              mode);
+            case CL_HALF_RTN:
+                return float2half_f16c<_MM_FROUND_TO_NEG_INF>(r, x, count,
+                                                              mode);
+            default: break;
+        }
+    }
+    float2half_scalar(r, x, count, mode);
+}
+
+void half2float_array(float *r, const cl_half *x, size_t count)
+{
+    if (have_f16c()) return half2float_f16c(r, x, count);
+    half2float_scalar(r, x, count);
+}
+
+#elif defined(HALF_CONVERT_SIMD)
+
+static const size_t kBlock = 4;
+
+// The NEON conversions round in the mode held in FPCR
+static int fenv_rounding(cl_half_rounding_mode mode)
+{
+    switch (mode)
+    {
+        case CL_HALF_RTE: return FE_TONEAREST;
+        case CL_HALF_RTZ: return FE_TOWARDZERO;
+        case CL_HALF_RTP: return FE_UPWARD;
+        case CL_HALF_RTN: return FE_DOWNWARD;
+        default: return -1;
+    }
+}
+
+void float2half_array(cl_half *r, const float *x, size_t count,
+                      cl_half_rounding_mode mode)
+{
+    int rounding = fenv_rounding(mode);
+    int previous = fegetround();
+    if (rounding < 0 || fesetround(rounding))
+    {
+        float2half_scalar(r, x, count, mode);
+        return;
+    }
+
+    size_t i = 0;
+    for (; i + kBlock <= count; i += kBlock)
+    {
+        if (float_needs_scalar(x + i, kBlock))
+        {
+            float2half_scalar(r + i, x + i, kBlock, mode);
+            continue;
+        }
+        float16x4_t h = vcvt_f16_f32(vld1q_f32(x + i));
+        vst1_u16(r + i, vreinterpret_u16_f16(h));
+    }
+    float2half_scalar(r + i, x + i, count - i, mode);
+
+    fesetround(previous);
+}
+
+void half2float_array(float *r, const cl_half *x, size_t count)
+{
+    size_t i = 0;
+    for (; i + kBlock <= count; i += kBlock)
+    {
+        if (half_needs_scalar(x + i, kBlock))
+        {
+            half2float_scalar(r + i, x + i, kBlock);
+            continue;
+        }
+        float16x4_t h = vreinterpret_f16_u16(vld1_u16(x + i));
+        vst1q_f32(r + i, vcvt_f32_f16(h));
+    }
+    half2float_scalar(r + i, x + i, count - i);
+}
+
+#else
+
+void float2half_array(cl_half *r, const float *x, size_t count,
+                      cl_half_rounding_mode mode)
+{
+    float2half_scalar(r, x, count, mode);
+}
+
+void half2float_array(float *r, const cl_half *x, size_t count)
+{
+    half2float_scalar(r, x, count);
+}
+
+#endif
@@ -0,0 +1,37 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef HALF_CONVERT_H
+#define HALF_CONVERT_H
+
+#include <stddef.h>
+
+#include <CL/cl_half.h>
+
+// Batch reference conversions for the half tests. These give the same bits
+// as cl_half_from_float and cl_half_to_float, which the images tests also
+// use through convert_float_to_half, for every input and rounding mode. They
+// use F16C on x86-64 hosts that have it and NEON on aarch64; NaN and
+// denormal inputs, other hosts and other compilers go through the scalar
+// conversions.
+
+// r[i] = cl_half_from_float(x[i], mode) for i < count
+void float2half_array(cl_half *r, const float *x, size_t count,
+                      cl_half_rounding_mode mode);
+
+// r[i] = cl_half_to_float(x[i]) for i < count
+void half2float_array(float *r, const cl_half *x, size_t count);
+
+#endif /* HALF_CONVERT_H */
@@ -27,8 +27,11 @@
 
 #define kLastVectorSizeToTest (kVectorSizeCount + kStrangeVectorSizeCount)
 
-#define BUFFER_SIZE ((size_t)2 * 1024 * 1024)
+#define DEFAULT_BUFFER_SIZE ((size_t)2 * 1024 * 1024)
 
+// Size in bytes of the single precision buffers, picked for the device at
+// startup
+extern size_t gBufferSize;
 extern size_t getBufferSize(cl_device_id device_id);
 extern cl_ulong getBufferCount(cl_device_id device_id, size_t vecSize, size_t typeSize);
 // could call
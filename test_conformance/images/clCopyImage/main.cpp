@@ -17,6 +17,7 @@
 #include <stdio.h>
 #include <string.h>
 #include "../testBase.h"
+#include "../common.h"
 #include "../harness/compat.h"
 #include "../harness/testHarness.h"
 
@@ -25,6 +26,8 @@ bool gTestSmallImages;
 bool gTestMaxImages;
 bool gEnablePitch;
 bool gTestMipmaps;
+bool gDeviceVerify;
+size_t gVerifySlabSize;
 int gTypesToTest;
 cl_channel_type gChannelTypeToUse = (cl_channel_type)-1;
 cl_channel_order gChannelOrderToUse = (cl_channel_order)-1;
@@ -138,6 +141,10 @@ int main(int argc, const char *argv[])
 
         else if( strcmp( argv[i], "use_pitches" ) == 0 )
             gEnablePitch = true;
+        else if (strcmp(argv[i], "device_verify") == 0)
+            gDeviceVerify = true;
+        else if (strcmp(argv[i], "slab_size") == 0 && i + 1 < argc)
+            gVerifySlabSize = (size_t)atoi(argv[++i]) * 1024 * 1024;
 
         else if( strcmp( argv[i], "--help" ) == 0 || strcmp( argv[i], "-h" ) == 0 )
         {
@@ -181,6 +188,10 @@ static void printUsage( const char *execName )
     log_info( "\tmax_images - Runs every format through a set of size combinations with the max values, max values - 1, and max values / 128\n" );
     log_info( "\trandomize - Use random seed\n" );
     log_info( "\tuse_pitches - Enables row and slice pitches\n" );
+    log_info("\tdevice_verify - Compares the results on the device and only "
+             "reads them back on a mismatch\n");
+    log_info("\tslab_size <MB> - Maps 3D images and 2D image arrays to verify "
+             "them at most this many megabytes at a time\n");
     log_info( "\n" );
     log_info( "Test names:\n" );
     for( int i = 0; i < test_num; i++ )
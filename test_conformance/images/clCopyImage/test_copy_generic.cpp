@@ -14,6 +14,7 @@
 // limitations under the License.
 //
 #include "../testBase.h"
+#include "../common.h"
 #include <CL/cl.h>
 
 static void CL_CALLBACK free_pitch_buffer( cl_mem image, void *buf )
@@ -563,6 +564,21 @@ int test_copy_image_generic( cl_context context, cl_command_queue queue, image_d
         }
     }
 
+    // For verification on the device, keep the destination level as it was
+    // and the region of the source that is copied
+    size_t pixelSize = get_pixel_size(dstImageInfo->format);
+    clMemWrapper dstBefore, srcRegion;
+    if (gDeviceVerify)
+    {
+        error = copy_image_region_to_buffer(context, queue, dstImage, origin,
+                                            region, pixelSize, dstBefore);
+        if (error != CL_SUCCESS) return error;
+        error = copy_image_region_to_buffer(context, queue, srcImage,
+                                            sourcePos, regionSize, pixelSize,
+                                            srcRegion);
+        if (error != CL_SUCCESS) return error;
+    }
+
     error = clEnqueueCopyImage( queue, srcImage, dstImage, sourcePos, destPos, regionSize, 0, NULL, NULL );
     if( error != CL_SUCCESS )
     {
@@ -572,6 +588,37 @@ int test_copy_image_generic( cl_context context, cl_command_queue queue, image_d
         return error;
     }
 
+    if (gDeviceVerify)
+    {
+        if (gDebugTrace) log_info(" - Device verification...\n");
+
+        clMemWrapper dstAfter;
+        error = copy_image_region_to_buffer(context, queue, dstImage, origin,
+                                            region, pixelSize, dstAfter);
+        if (error != CL_SUCCESS) return error;
+
+        // destPos without the mip level
+        size_t regionOrigin[3] = { destPos[0], 0, 0 };
+        switch (dstImageInfo->type)
+        {
+            case CL_MEM_OBJECT_IMAGE2D_ARRAY:
+            case CL_MEM_OBJECT_IMAGE3D: regionOrigin[2] = destPos[2];
+            /* Fallthrough */
+            case CL_MEM_OBJECT_IMAGE1D_ARRAY:
+            case CL_MEM_OBJECT_IMAGE2D: regionOrigin[1] = destPos[1]; break;
+            default: break;
+        }
+
+        cl_uint mismatches;
+        error = verify_region_on_device(context, queue, dstAfter, dstBefore,
+                                        srcRegion, false, pixelSize, region,
+                                        regionOrigin, regionSize, &mismatches);
+        if (error != CL_SUCCESS) return error;
+
+        // Only read the result back to find and print the first difference
+        if (mismatches == 0) return 0;
+    }
+
     // Construct the final dest image values to test against
     if( gDebugTrace )
         log_info( " - Host verification copy...\n" );
@@ -583,18 +630,9 @@ int test_copy_image_generic( cl_context context, cl_command_queue queue, image_d
     if( gDebugTrace )
         log_info( " - Mapping results...\n" );
 
-    size_t mappedRow, mappedSlice;
-    void* mapped = (char*)clEnqueueMapImage(queue, dstImage, CL_TRUE, CL_MAP_READ, origin, region, &mappedRow, &mappedSlice, 0, NULL, NULL, &error);
-    if (error != CL_SUCCESS)
-    {
-        log_error( "ERROR: Unable to map image for verification: %s\n", IGetErrorString( error ) );
-        return error;
-    }
-
     // Verify scanline by scanline, since the pitches are different
     char *sourcePtr = dstHost;
     size_t cur_lod_offset = 0;
-    char *destPtr = (char*)mapped;
 
     if( gTestMipmaps )
     {
@@ -666,38 +704,68 @@ int test_copy_image_generic( cl_context context, cl_command_queue queue, image_d
                 break;
         }
     }
-    for( size_t z = 0; z < thirdDim; z++ )
+
+    // Large 3D images and arrays can be mapped a few slices at a time
+    if (gVerifySlabSize
+        && (dstImageInfo->type == CL_MEM_OBJECT_IMAGE3D
+            || dstImageInfo->type == CL_MEM_OBJECT_IMAGE2D_ARRAY))
     {
-        for( size_t y = 0; y < secondDim; y++ )
-        {
-            if( memcmp( sourcePtr, destPtr, scanlineSize ) != 0 )
-            {
-                // Find the first differing pixel
-                size_t pixel_size = get_pixel_size( dstImageInfo->format );
-                size_t where =
-                    compare_scanlines(dstImageInfo, sourcePtr, destPtr);
+        if (gDebugTrace) log_info(" - Verifying in slabs...\n");
+
+        size_t pixel_size = get_pixel_size(dstImageInfo->format);
+        return for_each_image_slab(
+            queue, dstImage, origin, region, pixel_size, gVerifySlabSize, true,
+            [&](const char *data, size_t mappedRow, size_t mappedSlice,
+                size_t firstSlice, size_t sliceCount) {
+                const char *expected = sourcePtr + firstSlice * slicePitch;
+                size_t y, z, where;
+                if (!find_first_scanline_difference(
+                        dstImageInfo, expected, rowPitch, slicePitch, data,
+                        mappedRow, mappedSlice, scanlineSize, secondDim,
+                        sliceCount, &y, &z, &where))
+                    return 0;
+                print_first_pixel_difference_error(
+                    where,
+                    expected + z * slicePitch + y * rowPitch
+                        + pixel_size * where,
+                    data + z * mappedSlice + y * mappedRow
+                        + pixel_size * where,
+                    dstImageInfo, y, dstImageInfo->depth);
+                return -1;
+            });
+    }
 
-                if (where < dstImageInfo->width)
-                {
-                    print_first_pixel_difference_error(
-                        where, sourcePtr + pixel_size * where,
-                        destPtr + pixel_size * where, dstImageInfo, y,
-                        dstImageInfo->depth);
-                    return -1;
-                }
-            }
-            sourcePtr += rowPitch;
-            if((dstImageInfo->type == CL_MEM_OBJECT_IMAGE1D_ARRAY || dstImageInfo->type == CL_MEM_OBJECT_IMAGE1D))
-            destPtr += mappedSlice;
-            else
-            destPtr += mappedRow;
-        }
-        sourcePtr += slicePitch - rowPitch * dst_height_lod;
-        destPtr += mappedSlice - mappedRow * dst_height_lod;
+    size_t mappedRow, mappedSlice;
+    char *destPtr = (char *)clEnqueueMapImage(
+        queue, dstImage, CL_TRUE, CL_MAP_READ, origin, region, &mappedRow,
+        &mappedSlice, 0, NULL, NULL, &error);
+    if (error != CL_SUCCESS)
+    {
+        log_error( "ERROR: Unable to map image for verification: %s\n", IGetErrorString( error ) );
+        return error;
+    }
+
+    size_t destRowPitch = mappedRow;
+    if ((dstImageInfo->type == CL_MEM_OBJECT_IMAGE1D_ARRAY || dstImageInfo->type == CL_MEM_OBJECT_IMAGE1D))
+        destRowPitch = mappedSlice;
+
+    size_t y, z, where;
+    if (find_first_scanline_difference(dstImageInfo, sourcePtr, rowPitch,
+                                       slicePitch, destPtr, destRowPitch,
+                                       mappedSlice, scanlineSize, secondDim,
+                                       thirdDim, &y, &z, &where))
+    {
+        size_t pixel_size = get_pixel_size( dstImageInfo->format );
+        print_first_pixel_difference_error(
+            where,
+            sourcePtr + z * slicePitch + y * rowPitch + pixel_size * where,
+            destPtr + z * mappedSlice + y * destRowPitch + pixel_size * where,
+            dstImageInfo, y, dstImageInfo->depth);
+        return -1;
     }
 
     // Unmap the image.
-    error = clEnqueueUnmapMemObject(queue, dstImage, mapped, 0, NULL, NULL);
+    error = clEnqueueUnmapMemObject(queue, dstImage, destPtr, 0, NULL, NULL);
     if (error != CL_SUCCESS)
     {
         log_error( "ERROR: Unable to unmap image after verify: %s\n", IGetErrorString( error ) );
@@ -17,6 +17,7 @@
 #include <stdio.h>
 #include <string.h>
 #include "../testBase.h"
+#include "../common.h"
 #include "../harness/compat.h"
 #include "../harness/testHarness.h"
 
@@ -24,6 +25,7 @@ bool gDebugTrace;
 bool gTestSmallImages;
 bool gTestMaxImages;
 bool gEnablePitch;
+bool gDeviceVerify;
 int  gTypesToTest;
 cl_channel_type  gChannelTypeToUse = (cl_channel_type)-1;
 cl_channel_order gChannelOrderToUse = (cl_channel_order)-1;
@@ -94,6 +96,8 @@ int main(int argc, const char *argv[])
 
         else if ( strcmp( argv[i], "use_pitches" ) == 0 )
             gEnablePitch = true;
+        else if (strcmp(argv[i], "device_verify") == 0)
+            gDeviceVerify = true;
 
         else if( strcmp( argv[i], "int" ) == 0 )
             gTypesToTest |= kTestInt;
@@ -151,6 +155,8 @@ static void printUsage( const char *execName )
     log_info( "\tsmall_images - Runs every format through a loop of widths 1-13 and heights 1-9, instead of random sizes\n" );
     log_info( "\tmax_images - Runs every format through a set of size combinations with the max values, max values - 1, and max values / 128\n" );
     log_info( "\tuse_pitches - Enables row and slice pitches\n" );
+    log_info("\tdevice_verify - Compares the results on the device and only "
+             "reads them back on a mismatch\n");
     log_info( "\n" );
     log_info( "Test names:\n" );
     for( int i = 0; i < test_num; i++ )
@@ -14,6 +14,7 @@
 // limitations under the License.
 //
 #include "../testBase.h"
+#include "../common.h"
 
 extern void read_image_pixel_float( void *imageData, image_descriptor *imageInfo, int x, int y, int z, float *outData );
 
@@ -443,6 +444,40 @@ int test_fill_image_generic( cl_context context, cl_command_queue queue, image_d
     if ( image == NULL )
         return error;
 
+    size_t imageOrigin[ 3 ] = { 0, 0, 0 };
+    size_t imageRegion[ 3 ] = { imageInfo->width, 1, 1 };
+    switch (imageInfo->type)
+    {
+        case CL_MEM_OBJECT_IMAGE1D_BUFFER:
+        case CL_MEM_OBJECT_IMAGE1D:
+            break;
+        case CL_MEM_OBJECT_IMAGE2D:
+            imageRegion[ 1 ] = imageInfo->height;
+            break;
+        case CL_MEM_OBJECT_IMAGE3D:
+            imageRegion[ 1 ] = imageInfo->height;
+            imageRegion[ 2 ] = imageInfo->depth;
+            break;
+        case CL_MEM_OBJECT_IMAGE1D_ARRAY:
+            imageRegion[ 1 ] = imageInfo->arraySize;
+            break;
+        case CL_MEM_OBJECT_IMAGE2D_ARRAY:
+            imageRegion[ 1 ] = imageInfo->height;
+            imageRegion[ 2 ] = imageInfo->arraySize;
+            break;
+    }
+
+    // For verification on the device, keep the image as it was
+    size_t pixelSize = get_pixel_size(imageInfo->format);
+    clMemWrapper imageBefore;
+    if (gDeviceVerify)
+    {
+        error = copy_image_region_to_buffer(context, queue, image, imageOrigin,
+                                            imageRegion, pixelSize,
+                                            imageBefore);
+        if (error != CL_SUCCESS) return error;
+    }
+
     // Now fill the region defined by origin, region with the pixel value found at origin.
     if ( gDebugTrace )
         log_info( " - Filling at %d,%d,%d size %d,%d,%d\n", (int)origin[ 0 ], (int)origin[ 1 ], (int)origin[ 2 ],
@@ -517,34 +552,39 @@ int test_fill_image_generic( cl_context context, cl_command_queue queue, image_d
         free(verificationValue);
     }
 
+    if (gDeviceVerify)
+    {
+        if (gDebugTrace) log_info(" - Device verification...\n");
+
+        // The verification value, which the host copy now holds at origin
+        char *fillValue = (char *)imgHost + origin[2] * imageInfo->slicePitch
+            + origin[1] * imageInfo->rowPitch + origin[0] * pixelSize;
+        clMemWrapper pattern =
+            clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
+                           pixelSize, fillValue, &error);
+        test_error(error, "Unable to create fill value buffer");
+
+        clMemWrapper imageAfter;
+        error = copy_image_region_to_buffer(context, queue, image, imageOrigin,
+                                            imageRegion, pixelSize, imageAfter);
+        if (error != CL_SUCCESS) return error;
+
+        cl_uint mismatches;
+        error = verify_region_on_device(context, queue, imageAfter,
+                                        imageBefore, pattern, true, pixelSize,
+                                        imageRegion, origin, region,
+                                        &mismatches);
+        if (error != CL_SUCCESS) return error;
+
+        // Only map the result to find and print the first difference
+        if (mismatches == 0) return 0;
+    }
+
     // Map the destination image to verify the results with the host
     // copy. The contents of the entire buffer are compared.
     if ( gDebugTrace )
         log_info( " - Mapping results...\n" );
 
-    size_t imageOrigin[ 3 ] = { 0, 0, 0 };
-    size_t imageRegion[ 3 ] = { imageInfo->width, 1, 1 };
-    switch (imageInfo->type)
-    {
-        case CL_MEM_OBJECT_IMAGE1D_BUFFER:
-        case CL_MEM_OBJECT_IMAGE1D:
-            break;
-        case CL_MEM_OBJECT_IMAGE2D:
-            imageRegion[ 1 ] = imageInfo->height;
-            break;
-        case CL_MEM_OBJECT_IMAGE3D:
-            imageRegion[ 1 ] = imageInfo->height;
-            imageRegion[ 2 ] = imageInfo->depth;
-            break;
-        case CL_MEM_OBJECT_IMAGE1D_ARRAY:
-            imageRegion[ 1 ] = imageInfo->arraySize;
-            break;
-        case CL_MEM_OBJECT_IMAGE2D_ARRAY:
-            imageRegion[ 1 ] = imageInfo->height;
-            imageRegion[ 2 ] = imageInfo->arraySize;
-            break;
-    }
-
     size_t mappedRow, mappedSlice;
     void* mapped = (char*)clEnqueueMapImage(queue, image, CL_TRUE, CL_MAP_READ, imageOrigin, imageRegion, &mappedRow, &mappedSlice, 0, NULL, NULL, &error);
     if (error != CL_SUCCESS)
@@ -592,42 +632,31 @@ int test_fill_image_generic( cl_context context, cl_command_queue queue, image_d
                       __LINE__);
     };
 
-    // Count the number of bytes successfully matched
-    size_t total_matched = 0;
-
-    for ( size_t z = 0; z < thirdDim; z++ )
+    size_t destRowPitch = mappedRow;
+    if ((imageInfo->type == CL_MEM_OBJECT_IMAGE1D_ARRAY
+         || imageInfo->type == CL_MEM_OBJECT_IMAGE1D
+         || imageInfo->type == CL_MEM_OBJECT_IMAGE1D_BUFFER))
+        destRowPitch = mappedSlice;
+
+    size_t y, z, where;
+    if (find_first_scanline_difference(
+            imageInfo, sourcePtr, imageInfo->rowPitch, imageInfo->slicePitch,
+            destPtr, destRowPitch, mappedSlice, scanlineSize, secondDim,
+            thirdDim, &y, &z, &where))
     {
-        for ( size_t y = 0; y < secondDim; y++ )
-        {
-            if (memcmp( sourcePtr, destPtr, scanlineSize ) != 0)
-            {
-                // Find the first differing pixel
-                size_t pixel_size = get_pixel_size( imageInfo->format );
-                size_t where = compare_scanlines(imageInfo, sourcePtr, destPtr);
-
-                if (where < imageInfo->width)
-                {
-                    print_first_pixel_difference_error(
-                        where, sourcePtr + pixel_size * where,
-                        destPtr + pixel_size * where, imageInfo, y, thirdDim);
-                    return -1;
-                }
-            }
-
-            total_matched += scanlineSize;
-            sourcePtr += imageInfo->rowPitch;
-            if ((imageInfo->type == CL_MEM_OBJECT_IMAGE1D_ARRAY
-                 || imageInfo->type == CL_MEM_OBJECT_IMAGE1D
-                 || imageInfo->type == CL_MEM_OBJECT_IMAGE1D_BUFFER))
-                destPtr += mappedSlice;
-            else
-            destPtr += mappedRow;
-        }
-
-        sourcePtr += imageInfo->slicePitch - ( imageInfo->rowPitch * (imageInfo->height > 0 ? imageInfo->height : 1) );
-        destPtr += mappedSlice - ( mappedRow * (imageInfo->height > 0 ? imageInfo->height : 1) );
+        size_t pixel_size = get_pixel_size( imageInfo->format );
+        print_first_pixel_difference_error(
+            where,
+            sourcePtr + z * imageInfo->slicePitch + y * imageInfo->rowPitch
+                + pixel_size * where,
+            destPtr + z * mappedSlice + y * destRowPitch + pixel_size * where,
+            imageInfo, y, thirdDim);
+        return -1;
     }
 
+    // Every scanline matched
+    size_t total_matched = scanlineSize * secondDim * thirdDim;
+
     // Unmap the image.
     error = clEnqueueUnmapMemObject(queue, image, mapped, 0, NULL, NULL);
     if (error != CL_SUCCESS)
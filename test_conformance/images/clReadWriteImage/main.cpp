@@ -17,6 +17,7 @@
 #include <stdio.h>
 #include <string.h>
 #include "../testBase.h"
+#include "../common.h"
 #include "../harness/compat.h"
 
 bool gDebugTrace;
@@ -26,6 +27,7 @@ bool gTestMipmaps;
 cl_channel_type gChannelTypeToUse = (cl_channel_type)-1;
 cl_channel_order gChannelOrderToUse = (cl_channel_order)-1;
 bool            gEnablePitch = false;
+size_t gVerifySlabSize;
 
 static void printUsage( const char *execName );
 
@@ -96,6 +98,8 @@ int main(int argc, const char *argv[])
             // Don't test pitches with mipmaps right now.
             gEnablePitch = false;
         }
+        else if (strcmp(argv[i], "slab_size") == 0 && i + 1 < argc)
+            gVerifySlabSize = (size_t)atoi(argv[++i]) * 1024 * 1024;
 
         else if( strcmp( argv[i], "--help" ) == 0 || strcmp( argv[i], "-h" ) == 0 )
         {
@@ -135,6 +139,8 @@ static void printUsage( const char *execName )
     log_info( "\tuse_pitches - Enables row and slice pitches\n" );
     log_info( "\ttest_mipmaps - Test mipmapped images\n" );
     log_info( "\trandomize - Uses random seed\n" );
+    log_info("\tslab_size <MB> - Reads 3D images back to verify them at most "
+             "this many megabytes at a time\n");
     log_info( "\n" );
     log_info( "Test names:\n" );
     for( int i = 0; i < test_num; i++ )
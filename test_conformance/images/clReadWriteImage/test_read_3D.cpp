@@ -14,6 +14,7 @@
 // limitations under the License.
 //
 #include "../testBase.h"
+#include "../common.h"
 
 int test_read_image_3D(cl_context context, cl_command_queue queue,
                        image_descriptor *imageInfo, MTdata d,
@@ -78,7 +79,9 @@ int test_read_image_3D(cl_context context, cl_command_queue queue,
         fullImageSize = imageInfo->depth * imageInfo->slicePitch;
     }
 
-    BufferOwningPtr<char> resultValues(malloc(fullImageSize));
+    // Reading back in slabs needs no room for the whole image
+    BufferOwningPtr<char> resultValues(gVerifySlabSize ? NULL
+                                                       : malloc(fullImageSize));
     size_t imgValMipLevelOffset = 0;
 
     for(size_t lod = 0; (gTestMipmaps && lod < imageInfo->num_mip_levels) || (!gTestMipmaps && lod < 1); lod++)
@@ -115,6 +118,49 @@ int test_read_image_3D(cl_context context, cl_command_queue queue,
         size_t scanlineSize = width_lod * get_pixel_size( imageInfo->format );
         size_t pageSize = scanlineSize * height_lod;
         size_t imageSize = pageSize * depth_lod;
+
+        if (gVerifySlabSize)
+        {
+            if (gDebugTrace) log_info(" - Reading results in slabs...\n");
+
+            const char *levelValues = (char *)imageValues + imgValMipLevelOffset;
+            error = for_each_image_slab(
+                queue, image, origin, region,
+                get_pixel_size(imageInfo->format), gVerifySlabSize, false,
+                [&](const char *data, size_t rowPitch, size_t slicePitch,
+                    size_t firstSlice, size_t sliceCount) {
+                    for (size_t z = firstSlice; z < firstSlice + sliceCount;
+                         z++)
+                        for (size_t y = 0; y < height_lod; y++)
+                        {
+                            const char *sourcePtr = levelValues
+                                + z * slice_pitch_lod + y * row_pitch_lod;
+                            const char *destPtr = data
+                                + (z - firstSlice) * slicePitch
+                                + y * rowPitch;
+                            if (memcmp(sourcePtr, destPtr, scanlineSize) != 0)
+                            {
+                                if (gTestMipmaps)
+                                    log_error("At mip level %llu\n",
+                                              (unsigned long long)lod);
+                                log_error("ERROR: Scanline %d,%d did not "
+                                          "verify for image size %d,%d,%d "
+                                          "pitch %d,%d\n",
+                                          (int)y, (int)z, (int)width_lod,
+                                          (int)height_lod, (int)depth_lod,
+                                          (int)row_pitch_lod,
+                                          (int)slice_pitch_lod);
+                                return -1;
+                            }
+                        }
+                    return 0;
+                });
+            if (error) return -1;
+
+            imgValMipLevelOffset += imageSize;
+            continue;
+        }
+
         memset( resultValues, 0xff, imageSize );
 
         if( gDebugTrace )
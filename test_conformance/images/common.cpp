@@ -15,6 +15,9 @@
 //
 #include "common.h"
 
+#include <algorithm>
+#include <mutex>
+
 cl_channel_type floatFormats[] = {
     CL_UNORM_SHORT_565, CL_UNORM_SHORT_555, CL_UNORM_INT_101010,
 #ifdef CL_SFIXED14_APPLE
@@ -118,15 +121,8 @@ int get_format_list(cl_context context, cl_mem_object_type imageType,
                     std::vector<cl_image_format> &outFormatList,
                     cl_mem_flags flags)
 {
-    cl_uint formatCount;
-    int error = clGetSupportedImageFormats(context, flags, imageType, 0, NULL,
-                                           &formatCount);
-    test_error(error, "Unable to get count of supported image formats");
-
-    outFormatList.resize(formatCount);
-
-    error = clGetSupportedImageFormats(context, flags, imageType, formatCount,
-                                       outFormatList.data(), NULL);
+    int error = get_supported_image_formats(context, flags, imageType,
+                                            outFormatList);
     test_error(error, "Unable to get list of supported image formats");
     return 0;
 }
@@ -137,3 +133,262 @@ size_t random_in_ranges(size_t minimum, size_t rangeA, size_t rangeB, MTdata d)
     if (rangeA < minimum) return rangeA;
     return (size_t)random_in_range((int)minimum, (int)rangeA - 1, d);
 }
+
+namespace {
+
+const char *verify_region_kernel_code = R"(
+__kernel void verify_region(__global const uchar *result,
+                            __global const uchar *before,
+                            __global const uchar *inside, uint insideIsPattern,
+                            uint pixelSize, uint4 regionOrigin,
+                            uint4 regionSize, volatile __global uint *mismatch)
+{
+    size_t x = get_global_id(0), y = get_global_id(1), z = get_global_id(2);
+    size_t pixel = (z * get_global_size(1) + y) * get_global_size(0) + x;
+
+    __global const uchar *expected = before + pixel * pixelSize;
+    if (x >= regionOrigin.x && x - regionOrigin.x < regionSize.x
+        && y >= regionOrigin.y && y - regionOrigin.y < regionSize.y
+        && z >= regionOrigin.z && z - regionOrigin.z < regionSize.z)
+    {
+        size_t offset = ((z - regionOrigin.z) * regionSize.y
+                         + (y - regionOrigin.y)) * regionSize.x
+            + (x - regionOrigin.x);
+        expected = inside + (insideIsPattern ? 0 : offset * pixelSize);
+    }
+
+    __global const uchar *actual = result + pixel * pixelSize;
+    for (uint i = 0; i < pixelSize; i++)
+    {
+        if (actual[i] != expected[i])
+        {
+            atomic_inc(&mismatch[0]);
+            atomic_min(&mismatch[1], pixel < UINT_MAX ? (uint)pixel : UINT_MAX);
+            return;
+        }
+    }
+}
+)";
+
+// The kernel is built once for each context it is used in
+std::mutex gVerifyRegionMutex;
+cl_context gVerifyRegionContext = nullptr;
+clProgramWrapper gVerifyRegionProgram;
+clKernelWrapper gVerifyRegionKernel;
+
+} // anonymous namespace
+
+int copy_image_region_to_buffer(cl_context context, cl_command_queue queue,
+                                cl_mem image, const size_t origin[],
+                                const size_t region[], size_t pixelSize,
+                                clMemWrapper &buffer)
+{
+    int error;
+    buffer = clCreateBuffer(context, CL_MEM_READ_WRITE,
+                            region[0] * region[1] * region[2] * pixelSize,
+                            NULL, &error);
+    test_error(error, "Unable to create buffer for image region");
+
+    error = clEnqueueCopyImageToBuffer(queue, image, buffer, origin, region, 0,
+                                       0, NULL, NULL);
+    test_error(error, "Unable to copy image region to buffer");
+    return CL_SUCCESS;
+}
+
+int verify_region_on_device(cl_context context, cl_command_queue queue,
+                            cl_mem result, cl_mem before, cl_mem inside,
+                            bool insideIsPattern, size_t pixelSize,
+                            const size_t levelSize[3],
+                            const size_t regionOrigin[3],
+                            const size_t regionSize[3], cl_uint *mismatches)
+{
+    std::lock_guard<std::mutex> lock(gVerifyRegionMutex);
+
+    int error;
+    if (gVerifyRegionContext != context)
+    {
+        gVerifyRegionContext = nullptr;
+        gVerifyRegionKernel.reset();
+        gVerifyRegionProgram.reset();
+        error = create_single_kernel_helper(
+            context, &gVerifyRegionProgram, &gVerifyRegionKernel, 1,
+            &verify_region_kernel_code, "verify_region");
+        test_error(error, "Unable to create the verify_region kernel");
+        gVerifyRegionContext = context;
+    }
+
+    cl_uint counts[2] = { 0, CL_UINT_MAX };
+    clMemWrapper countsBuffer =
+        clCreateBuffer(context, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR,
+                       sizeof(counts), counts, &error);
+    test_error(error, "Unable to create mismatch count buffer");
+
+    cl_uint pattern = insideIsPattern;
+    cl_uint size = (cl_uint)pixelSize;
+    cl_uint4 origin = { { (cl_uint)regionOrigin[0], (cl_uint)regionOrigin[1],
+                          (cl_uint)regionOrigin[2], 0 } };
+    cl_uint4 extent = { { (cl_uint)regionSize[0], (cl_uint)regionSize[1],
+                          (cl_uint)regionSize[2], 0 } };
+    cl_kernel kernel = gVerifyRegionKernel;
+    error = clSetKernelArg(kernel, 0, sizeof(result), &result);
+    error |= clSetKernelArg(kernel, 1, sizeof(before), &before);
+    error |= clSetKernelArg(kernel, 2, sizeof(inside), &inside);
+    error |= clSetKernelArg(kernel, 3, sizeof(pattern), &pattern);
+    error |= clSetKernelArg(kernel, 4, sizeof(size), &size);
+    error |= clSetKernelArg(kernel, 5, sizeof(origin), &origin);
+    error |= clSetKernelArg(kernel, 6, sizeof(extent), &extent);
+    error |= clSetKernelArg(kernel, 7, sizeof(countsBuffer), &countsBuffer);
+    test_error(error, "Unable to set verify_region arguments");
+
+    size_t global[3] = { levelSize[0], levelSize[1], levelSize[2] };
+    error = clEnqueueNDRangeKernel(queue, kernel, 3, NULL, global, NULL, 0,
+                                   NULL, NULL);
+    test_error(error, "Unable to run the verify_region kernel");
+
+    error = clEnqueueReadBuffer(queue, countsBuffer, CL_TRUE, 0,
+                                sizeof(counts), counts, 0, NULL, NULL);
+    test_error(error, "Unable to read mismatch counts");
+
+    *mismatches = counts[0];
+    if (counts[0])
+    {
+        size_t first = counts[1];
+        log_info(" - %u pixels differ on the device, the first at %zu,%zu,%zu; "
+                 "mapping the result...\n",
+                 counts[0], first % levelSize[0],
+                 first / levelSize[0] % levelSize[1],
+                 first / levelSize[0] / levelSize[1]);
+    }
+    return CL_SUCCESS;
+}
+
+namespace {
+
+struct ImageSlab
+{
+    size_t firstSlice = 0;
+    size_t sliceCount = 0;
+    char *data = nullptr;
+    size_t rowPitch = 0;
+    size_t slicePitch = 0;
+    std::vector<char> storage; // unless mapped
+    clEventWrapper done;
+};
+
+int enqueue_image_slab(cl_command_queue queue, cl_mem image,
+                       const size_t origin[4], const size_t region[3],
+                       size_t pixelSize, bool map, ImageSlab &slab)
+{
+    size_t slabOrigin[4] = { origin[0], origin[1], origin[2] + slab.firstSlice,
+                             origin[3] };
+    size_t slabRegion[3] = { region[0], region[1], slab.sliceCount };
+    cl_event done;
+    int error;
+    if (map)
+    {
+        slab.data = (char *)clEnqueueMapImage(
+            queue, image, CL_FALSE, CL_MAP_READ, slabOrigin, slabRegion,
+            &slab.rowPitch, &slab.slicePitch, 0, NULL, &done, &error);
+        test_error(error, "Unable to map image slab");
+    }
+    else
+    {
+        slab.rowPitch = region[0] * pixelSize;
+        slab.slicePitch = slab.rowPitch * region[1];
+        slab.storage.resize(slab.slicePitch * slab.sliceCount);
+        error = clEnqueueReadImage(queue, image, CL_FALSE, slabOrigin,
+                                   slabRegion, 0, 0, slab.storage.data(), 0,
+                                   NULL, &done);
+        test_error(error, "Unable to read image slab");
+        slab.data = slab.storage.data();
+    }
+    slab.done = done;
+    return CL_SUCCESS;
+}
+
+int wait_for_image_slab(ImageSlab &slab)
+{
+    cl_event done = slab.done;
+    int error = clWaitForEvents(1, &done);
+    test_error(error, "Unable to wait for image slab");
+    return CL_SUCCESS;
+}
+
+// Unmaps slab if it is mapped, once it is read
+int release_image_slab(cl_command_queue queue, cl_mem image, bool map,
+                       ImageSlab &slab)
+{
+    char *data = slab.data;
+    slab.data = nullptr;
+    slab.done.reset();
+    if (map)
+    {
+        int error =
+            clEnqueueUnmapMemObject(queue, image, data, 0, NULL, NULL);
+        test_error(error, "Unable to unmap image slab");
+    }
+    return CL_SUCCESS;
+}
+
+} // anonymous namespace
+
+int for_each_image_slab(cl_command_queue queue, cl_mem image,
+                        const size_t origin[4], const size_t region[3],
+                        size_t pixelSize, size_t slabSize, bool map,
+                        const ImageSlabFn &fn)
+{
+    size_t sliceSize = region[0] * region[1] * pixelSize;
+    size_t slicesPerSlab = std::max(slabSize / sliceSize, (size_t)1);
+
+    ImageSlab slabs[2];
+    slabs[0].sliceCount = std::min(slicesPerSlab, region[2]);
+    int error =
+        enqueue_image_slab(queue, image, origin, region, pixelSize, map,
+                           slabs[0]);
+    if (error != CL_SUCCESS) return error;
+
+    int result = 0;
+    for (size_t i = 0; result == 0; i++)
+    {
+        ImageSlab &slab = slabs[i % 2];
+        ImageSlab &next = slabs[(i + 1) % 2];
+        next.firstSlice = slab.firstSlice + slab.sliceCount;
+        next.sliceCount = std::min(slicesPerSlab, region[2] - next.firstSlice);
+        if (next.sliceCount)
+        {
+            error = enqueue_image_slab(queue, image, origin, region, pixelSize,
+                                       map, next);
+            if (error != CL_SUCCESS) result = error;
+            error = clFlush(queue);
+            if (error != CL_SUCCESS && result == 0)
+            {
+                print_error(error, "clFlush failed");
+                result = error;
+            }
+        }
+
+        error = wait_for_image_slab(slab);
+        if (error != CL_SUCCESS && result == 0) result = error;
+        if (result == 0)
+            result = fn(slab.data, slab.rowPitch, slab.slicePitch,
+                        slab.firstSlice, slab.sliceCount);
+
+        error = release_image_slab(queue, image, map, slab);
+        if (error != CL_SUCCESS && result == 0) result = error;
+        if (!next.sliceCount) break;
+    }
+
+    // A slab may still be in flight after fn stopped early
+    for (ImageSlab &slab : slabs)
+        if (slab.data)
+        {
+            error = wait_for_image_slab(slab);
+            if (error == CL_SUCCESS)
+                error = release_image_slab(queue, image, map, slab);
+            if (error != CL_SUCCESS && result == 0) result = error;
+        }
+
+    error = clFinish(queue);
+    test_error(error, "clFinish failed");
+    return result;
+}
@@ -20,8 +20,10 @@
 #include "harness/kernelHelpers.h"
 #include "harness/errorHelpers.h"
 #include "harness/conversions.h"
+#include "harness/typeWrappers.h"
 
 #include <array>
+#include <functional>
 #include <vector>
 
 extern cl_channel_type gChannelTypeToUse;
@@ -50,4 +52,52 @@ int get_format_list(cl_context context, cl_mem_object_type imageType,
                     cl_mem_flags flags);
 size_t random_in_ranges(size_t minimum, size_t rangeA, size_t rangeB, MTdata d);
 
+// Set by the device_verify option of the copy and fill tests, which then
+// compare their results on the device and only map them to report a mismatch
+extern bool gDeviceVerify;
+
+// Copies region of image at origin, which holds the mip level as the image
+// copy functions take it, into a new buffer with no padding between rows
+int copy_image_region_to_buffer(cl_context context, cl_command_queue queue,
+                                cl_mem image, const size_t origin[],
+                                const size_t region[], size_t pixelSize,
+                                clMemWrapper &buffer);
+
+// Compares an image level of levelSize pixels, copied to the result buffer
+// with copy_image_region_to_buffer, on the device. The pixels in the region
+// of regionSize at regionOrigin must match those of inside, which holds the
+// region with no padding or, if insideIsPattern, a single pixel. The rest
+// must match those of before, a copy of the level taken in the same way.
+// Sets mismatches to the number of pixels that differ.
+int verify_region_on_device(cl_context context, cl_command_queue queue,
+                            cl_mem result, cl_mem before, cl_mem inside,
+                            bool insideIsPattern, size_t pixelSize,
+                            const size_t levelSize[3],
+                            const size_t regionOrigin[3],
+                            const size_t regionSize[3], cl_uint *mismatches);
+
+// Set by the slab_size option of the read/write and copy tests, which then
+// read 3D images back to verify them at most this many bytes at a time. 0
+// reads them back whole.
+extern size_t gVerifySlabSize;
+
+// Called by for_each_image_slab with sliceCount slices of a region from
+// firstSlice on, whose rows and slices are rowPitch and slicePitch apart in
+// data. Returns non-zero to stop.
+typedef std::function<int(const char *data, size_t rowPitch,
+                          size_t slicePitch, size_t firstSlice,
+                          size_t sliceCount)>
+    ImageSlabFn;
+
+// Reads region of a 3D image or 2D image array at origin, which holds the mip
+// level as for clEnqueueReadImage, back in slabs of whole slices of at most
+// slabSize bytes and passes each to fn. The slabs are mapped if map is set and
+// read with clEnqueueReadImage with no pitch otherwise. The next slab is read
+// while fn looks at the last, so at most two are held at a time. Returns the
+// first error or non-zero result of fn.
+int for_each_image_slab(cl_command_queue queue, cl_mem image,
+                        const size_t origin[4], const size_t region[3],
+                        size_t pixelSize, size_t slabSize, bool map,
+                        const ImageSlabFn &fn);
+
 #endif // IMAGES_COMMON_H
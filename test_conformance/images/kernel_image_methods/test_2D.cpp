@@ -15,6 +15,9 @@
 //
 #include "../testBase.h"
 
+extern int get_method_test_kernel(cl_context context, const char *programSrc,
+                                  cl_kernel *outKernel);
+
 
 struct image_kernel_data
 {
@@ -70,8 +73,7 @@ int test_get_image_info_single(cl_context context, cl_command_queue queue,
 {
     int error = 0;
 
-    clProgramWrapper program;
-    clKernelWrapper kernel;
+    cl_kernel kernel;
     clMemWrapper image, outDataBuffer;
     char programSrc[ 10240 ];
 
@@ -131,9 +133,7 @@ int test_get_image_info_single(cl_context context, cl_command_queue queue,
     error = clFinish(queue);
     if (error)
         print_error(error, "clFinish failed.\n");
-    const char *ptr = programSrc;
-    error = create_single_kernel_helper(context, &program, &kernel, 1, &ptr,
-                                        "sample_kernel");
+    error = get_method_test_kernel(context, programSrc, &kernel);
     test_error( error, "Unable to create kernel to test against" );
 
     // Create an output buffer
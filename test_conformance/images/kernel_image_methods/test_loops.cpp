@@ -16,6 +16,8 @@
 #include "../testBase.h"
 #include "../common.h"
 
+#include <string>
+
 
 extern int test_get_image_info_1D(cl_device_id device, cl_context context,
                                   cl_command_queue queue,
@@ -40,6 +42,34 @@ extern int test_get_image_info_1D_buffer(cl_device_id device,
                                          cl_image_format *format,
                                          cl_mem_flags flags);
 
+// The kernel source of a method test only depends on the image type, format
+// and access, not on the size, so every size of a format reuses the kernel
+// built for the first one.
+static cl_context gMethodKernelContext = NULL;
+static std::string gMethodKernelSource;
+static clProgramWrapper gMethodProgram;
+static clKernelWrapper gMethodKernel;
+
+int get_method_test_kernel(cl_context context, const char *programSrc,
+                           cl_kernel *outKernel)
+{
+    if (gMethodKernel == NULL || context != gMethodKernelContext
+        || gMethodKernelSource != programSrc)
+    {
+        gMethodKernel = NULL;
+        gMethodProgram = NULL;
+        gMethodKernelSource.clear();
+        int error = create_single_kernel_helper(context, &gMethodProgram,
+                                                &gMethodKernel, 1, &programSrc,
+                                                "sample_kernel");
+        if (error) return error;
+        gMethodKernelContext = context;
+        gMethodKernelSource = programSrc;
+    }
+    *outKernel = gMethodKernel;
+    return CL_SUCCESS;
+}
+
 int test_image_type( cl_device_id device, cl_context context, cl_command_queue queue, cl_mem_object_type imageType, cl_mem_flags flags )
 {
     log_info( "Running %s %s-only tests...\n", convert_image_type_to_string(imageType), flags == CL_MEM_READ_ONLY ? "read" : "write" );
@@ -105,6 +135,11 @@ int test_image_type( cl_device_id device, cl_context context, cl_command_queue q
         ret += test_return;
     }
 
+    // The context goes away after the test
+    gMethodKernel = NULL;
+    gMethodProgram = NULL;
+    gMethodKernelContext = NULL;
+
     return ret;
 }
 
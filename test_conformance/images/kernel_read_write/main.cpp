@@ -47,6 +47,7 @@ cl_channel_order gChannelOrderToUse = (cl_channel_order)-1;
 bool            gEnablePitch = false;
 
 int             gtestTypesToRun = 0;
+int gFormatThreads = 1;
 static int testTypesToRun;
 
 static void printUsage( const char *execName );
@@ -91,6 +92,11 @@ extern int image_from_buffer_read_positive(cl_device_id device,
                                            cl_command_queue queue);
 extern int ext_image_raw10_raw12(cl_device_id device, cl_context context,
                                  cl_command_queue queue);
+extern int ext_image_raw10_raw12_bench(cl_device_id device,
+                                       cl_context context,
+                                       cl_command_queue queue);
+extern int image_read_write_bench(cl_device_id device, cl_context context,
+                                  cl_command_queue queue);
 
 /** read_write images only support sampler-less read buildt-ins which require special settings
   * for some global parameters. This pair of functions temporarily overwrite those global parameters
@@ -375,6 +381,20 @@ int test_cl_ext_image_raw10_raw12(cl_device_id device, cl_context context,
     return ext_image_raw10_raw12(device, context, queue);
 }
 
+int test_cl_ext_image_raw10_raw12_bench(cl_device_id device,
+                                        cl_context context,
+                                        cl_command_queue queue,
+                                        int num_elements)
+{
+    return ext_image_raw10_raw12_bench(device, context, queue);
+}
+
+int test_image_read_write_bench(cl_device_id device, cl_context context,
+                                cl_command_queue queue, int num_elements)
+{
+    return image_read_write_bench(device, context, queue);
+}
+
 test_definition test_list[] = {
     ADD_TEST(1D),
     ADD_TEST(2D),
@@ -394,6 +414,8 @@ test_definition test_list[] = {
     ADD_TEST_VERSION(image_from_buffer_fill_positive, Version(3, 0)),
     ADD_TEST_VERSION(image_from_buffer_read_positive, Version(3, 0)),
     ADD_TEST_VERSION(cl_ext_image_raw10_raw12, Version(1, 2)),
+    ADD_BENCHMARK_VERSION(cl_ext_image_raw10_raw12_bench, Version(1, 2)),
+    ADD_BENCHMARK_VERSION(image_read_write_bench, Version(1, 2)),
 };
 
 const int test_num = ARRAY_SIZE( test_list );
@@ -478,6 +500,10 @@ int main(int argc, const char *argv[])
 
         else if( strcmp( argv[i], "local_samplers" ) == 0 )
             gUseKernelSamplers = true;
+        else if (strcmp(argv[i], "reference_cache_mb") == 0 && i + 1 < argc)
+            gImageLevelCacheSize = (size_t)atoi(argv[++i]) * 1024 * 1024;
+        else if (strcmp(argv[i], "format_threads") == 0 && i + 1 < argc)
+            gFormatThreads = atoi(argv[++i]);
 
         else if( strcmp( argv[i], "int" ) == 0 )
             gTypesToTest |= kTestInt;
@@ -575,6 +601,13 @@ static void printUsage( const char *execName )
     log_info( "\n" );
     log_info( "\tlocal_samplers - Use samplers declared in the kernel functions instead of passed in as arguments\n" );
     log_info( "\n" );
+    log_info("\treference_cache_mb <n> - Memory budget of the cache of decoded "
+             "mip levels used to compute the test_mipmaps references "
+             "(default 256, 0 disables it)\n");
+    log_info("\tformat_threads <n> - Test up to n image formats at once, each "
+             "on its own queue with its reference computed on a thread pool "
+             "thread (read tests only, default 1)\n");
+    log_info("\n");
     log_info( "\tThe following specify to use the specific flag to allocate images to use in the tests:\n" );
     log_info( "\t\tCL_MEM_COPY_HOST_PTR\n" );
     log_info( "\t\tCL_MEM_USE_HOST_PTR (default)\n" );
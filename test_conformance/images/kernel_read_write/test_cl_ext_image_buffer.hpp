@@ -123,4 +123,36 @@ static inline void image_desc_init(cl_image_desc* desc,
     }
 }
 
+/* One buffer for the images of a format sweep to be created from in turn,
+   instead of a new buffer per format. It is only reallocated when a format
+   needs more than the current one holds, so an image made from it must be
+   released before the next call to get. */
+class BackingBuffer {
+public:
+    BackingBuffer(cl_context context, cl_mem_flags flags)
+        : m_context(context), m_flags(flags), m_size(0)
+    {}
+
+    cl_mem get(size_t size, cl_int* error)
+    {
+        *error = CL_SUCCESS;
+        if (size > m_size)
+        {
+            m_buffer = nullptr;
+            m_size = 0;
+            m_buffer =
+                clCreateBuffer(m_context, m_flags, size, nullptr, error);
+            if (*error != CL_SUCCESS) return nullptr;
+            m_size = size;
+        }
+        return m_buffer;
+    }
+
+private:
+    cl_context m_context;
+    cl_mem_flags m_flags;
+    clMemWrapper m_buffer;
+    size_t m_size;
+};
+
 #endif // TEST_CL_EXT_IMAGE_BUFFER
@@ -185,6 +185,11 @@ int memInfo_image_from_buffer_positive(cl_device_id device, cl_context context,
 
     for (auto flagType : flagTypes)
     {
+        const cl_mem_flags backing_flag =
+            (flagType == CL_MEM_KERNEL_READ_AND_WRITE) ? CL_MEM_READ_WRITE
+                                                       : flagType;
+        BackingBuffer backing(context, backing_flag);
+
         for (auto imageType : imageTypes)
         {
             /* Get the list of supported image formats */
@@ -227,8 +232,7 @@ int memInfo_image_from_buffer_positive(cl_device_id device, cl_context context,
                 const size_t buffer_size = slice_pitch * TEST_IMAGE_SIZE;
 
                 cl_int err = CL_SUCCESS;
-                cl_mem buffer =
-                    clCreateBuffer(context, flag, buffer_size, nullptr, &err);
+                cl_mem buffer = backing.get(buffer_size, &err);
                 test_error(err, "Unable to create buffer");
 
                 image_desc.buffer = buffer;
@@ -249,9 +253,6 @@ int memInfo_image_from_buffer_positive(cl_device_id device, cl_context context,
                         "Unexpected CL_MEM_ASSOCIATED_MEMOBJECT buffer\n");
                 }
 
-                err = clReleaseMemObject(buffer);
-                test_error(err, "Unable to release buffer");
-
                 err = clReleaseMemObject(image_buffer);
                 test_error(err, "Unable to release image");
             }
@@ -294,6 +295,11 @@ int imageInfo_image_from_buffer_positive(cl_device_id device,
 
     for (auto flagType : flagTypes)
     {
+        const cl_mem_flags backing_flag =
+            (flagType == CL_MEM_KERNEL_READ_AND_WRITE) ? CL_MEM_READ_WRITE
+                                                       : flagType;
+        BackingBuffer backing(context, backing_flag);
+
         for (auto imageType : imageTypes)
         {
             /* Get the list of supported image formats */
@@ -336,8 +342,7 @@ int imageInfo_image_from_buffer_positive(cl_device_id device,
                 const size_t buffer_size = slice_pitch * TEST_IMAGE_SIZE;
 
                 cl_int err = CL_SUCCESS;
-                cl_mem buffer =
-                    clCreateBuffer(context, flag, buffer_size, nullptr, &err);
+                cl_mem buffer = backing.get(buffer_size, &err);
                 test_error(err, "Unable to create buffer");
 
                 image_desc.buffer = buffer;
@@ -394,9 +399,6 @@ int imageInfo_image_from_buffer_positive(cl_device_id device,
                     }
                 }
 
-                err = clReleaseMemObject(buffer);
-                test_error(err, "Unable to release buffer");
-
                 err = clReleaseMemObject(image_buffer);
                 test_error(err, "Unable to release image");
             }
@@ -707,6 +709,12 @@ int image_from_buffer_fill_positive(cl_device_id device, cl_context context,
 
     for (auto flagType : flagTypes)
     {
+        const cl_mem_flags backing_flag =
+            (flagType == CL_MEM_KERNEL_READ_AND_WRITE) ? CL_MEM_READ_WRITE
+                                                       : flagType;
+        BackingBuffer backing(context, backing_flag);
+        BackingBuffer image1d_backing(context, backing_flag);
+
         for (auto imageType : imageTypes)
         {
             /* Get the list of supported image formats */
@@ -755,8 +763,7 @@ int image_from_buffer_fill_positive(cl_device_id device, cl_context context,
                 const size_t buffer_size = slice_pitch * TEST_IMAGE_SIZE;
 
                 cl_int err = CL_SUCCESS;
-                cl_mem buffer =
-                    clCreateBuffer(context, flag, buffer_size, nullptr, &err);
+                cl_mem buffer = backing.get(buffer_size, &err);
                 test_error(err, "Unable to create buffer");
 
                 /* fill the buffer with a pattern */
@@ -772,8 +779,7 @@ int image_from_buffer_fill_positive(cl_device_id device, cl_context context,
                 cl_mem image1d_buffer;
                 if (imageType == CL_MEM_OBJECT_IMAGE1D_BUFFER)
                 {
-                    image1d_buffer = clCreateBuffer(context, flag, buffer_size,
-                                                    nullptr, &err);
+                    image1d_buffer = image1d_backing.get(buffer_size, &err);
                     test_error(err, "Unable to create buffer");
 
                     image_desc.buffer = image1d_buffer;
@@ -840,20 +846,11 @@ int image_from_buffer_fill_positive(cl_device_id device, cl_context context,
                     return fill_error;
                 }
 
-                err = clReleaseMemObject(buffer);
-                test_error(err, "Unable to release buffer");
-
                 err = clReleaseMemObject(image);
                 test_error(err, "Unable to release image");
 
                 err = clReleaseMemObject(image_from_buffer);
                 test_error(err, "Unable to release image");
-
-                if (imageType == CL_MEM_OBJECT_IMAGE1D_BUFFER)
-                {
-                    err = clReleaseMemObject(image1d_buffer);
-                    test_error(err, "Unable to release image");
-                }
             }
         }
     }
@@ -921,6 +918,8 @@ int image_from_buffer_read_positive(cl_device_id device, cl_context context,
         CL_MEM_OBJECT_IMAGE1D_ARRAY, CL_MEM_OBJECT_IMAGE2D_ARRAY
     };
 
+    BackingBuffer backing(context, CL_MEM_READ_WRITE);
+
     for (auto imageType : imageTypes)
     {
         cl_image_desc image_desc = { 0 };
@@ -956,8 +955,7 @@ int image_from_buffer_read_positive(cl_device_id device, cl_context context,
         const size_t buffer_size = slice_pitch * TEST_IMAGE_SIZE;
 
         cl_int err = CL_SUCCESS;
-        cl_mem buffer = clCreateBuffer(context, CL_MEM_READ_WRITE, buffer_size,
-                                       nullptr, &err);
+        cl_mem buffer = backing.get(buffer_size, &err);
         test_error(err, "Unable to create buffer");
 
         /* Check the image from buffer */
@@ -1013,9 +1011,6 @@ int image_from_buffer_read_positive(cl_device_id device, cl_context context,
             return read_error;
         }
 
-        err = clReleaseMemObject(buffer);
-        test_error(err, "Unable to release buffer");
-
         err = clReleaseMemObject(image);
         test_error(err, "Unable to release image");
     }
@@ -17,6 +17,12 @@
 #include "../testBase.h"
 #include "../common.h"
 #include "test_cl_ext_image_buffer.hpp"
+#include "harness/benchmark.h"
+#include "harness/perfMetrics.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
 
 extern int gTypesToTest;
 extern int gtestTypesToRun;
@@ -76,3 +82,191 @@ int ext_image_raw10_raw12(cl_device_id device, cl_context context,
 
     return ret;
 }
+
+// Pixels per second read by a kernel from RAW10 and RAW12 images against a
+// CL_UNSIGNED_INT16 image holding the same values, which takes 1.6 and 1.33
+// times the memory. Each work-item sums a short horizontal run, and the sums
+// of every format are checked against the host copy. A benchmark, so it only
+// runs when named.
+
+namespace {
+
+const size_t kBenchWidth = 4096;
+const size_t kBenchHeight = 2048;
+const size_t kPixelsPerItem = 8;
+const size_t kMaxLocalSize = 256;
+
+const char *kRawBenchSource = R"(
+__kernel void sum_runs(read_only image2d_t img, __global uint *sums,
+                       uint items_per_row)
+{
+    uint gid = get_global_id(0);
+    int x = (int)((gid % items_per_row) * PIXELS_PER_ITEM);
+    int y = (int)(gid / items_per_row);
+    uint sum = 0;
+    for (int i = 0; i < PIXELS_PER_ITEM; i++)
+        sum += read_imageui(img, (int2)(x + i, y)).x;
+    sums[gid] = sum;
+}
+)";
+
+struct RawBenchFormat
+{
+    const char *name;
+    cl_channel_type type;
+    cl_ushort mask;
+};
+
+const RawBenchFormat kRawBenchFormats[] = {
+    { "RAW10", CL_UNSIGNED_INT_RAW10_EXT, 0x3FF },
+    { "RAW12", CL_UNSIGNED_INT_RAW12_EXT, 0xFFF },
+};
+
+// Time kernel on an image of format made from the rows in values, on queue,
+// which has profiling enabled, and check the sums it gives
+int time_raw_format(cl_device_id device, cl_context context,
+                    cl_command_queue queue, cl_kernel kernel,
+                    cl_channel_type type, const std::vector<cl_ushort> &values,
+                    size_t width, size_t height, BenchmarkStats *stats)
+{
+    const cl_image_format format = { CL_R, type };
+    image_descriptor imageInfo = { 0 };
+    imageInfo.format = &format;
+    imageInfo.width = width;
+    size_t rowPitch = calculate_row_pitch(imageInfo, sizeof(cl_ushort));
+
+    std::vector<cl_uchar> data(rowPitch * height);
+    if (type == CL_UNSIGNED_INT16)
+        memcpy(data.data(), values.data(), data.size());
+    else
+        for (size_t y = 0; y < height; y++)
+            pack_raw_row(type, &values[y * width], &data[y * rowPitch], width);
+
+    cl_int error;
+    clMemWrapper image = create_image_2d(
+        context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, &format, width,
+        height, rowPitch, data.data(), &error);
+    test_error(error, "Unable to create image");
+
+    size_t global = width * height / kPixelsPerItem;
+    clMemWrapper sums = clCreateBuffer(context, CL_MEM_WRITE_ONLY,
+                                       global * sizeof(cl_uint), NULL, &error);
+    test_error(error, "Unable to create buffer");
+
+    cl_uint itemsPerRow = (cl_uint)(width / kPixelsPerItem);
+    error = clSetKernelArg(kernel, 0, sizeof(image), &image);
+    error |= clSetKernelArg(kernel, 1, sizeof(sums), &sums);
+    error |= clSetKernelArg(kernel, 2, sizeof(itemsPerRow), &itemsPerRow);
+    test_error(error, "Unable to set kernel arguments");
+
+    size_t local;
+    error = get_max_allowed_1d_work_group_size_on_device(device, kernel,
+                                                         &local);
+    test_error(error, "Unable to get the work-group size");
+    local = std::min(local, kMaxLocalSize);
+    while (global % local) local--;
+
+    BenchmarkOptions options;
+    options.warmup = 1;
+    options.maxSeconds = 1.0;
+    error = benchmark_1d_kernel(queue, kernel, global, local, options, stats);
+    test_error(error, "Unable to time kernel");
+
+    std::vector<cl_uint> actual(global);
+    error = clEnqueueReadBuffer(queue, sums, CL_TRUE, 0,
+                                global * sizeof(cl_uint), actual.data(), 0,
+                                NULL, NULL);
+    test_error(error, "Unable to read sums");
+    for (size_t i = 0; i < global; i++)
+    {
+        cl_uint expected = 0;
+        for (size_t p = 0; p < kPixelsPerItem; p++)
+            expected += values[i * kPixelsPerItem + p];
+        if (actual[i] != expected)
+        {
+            log_error("Sum %zu of the %s image is %u, expected %u\n", i,
+                      GetChannelTypeName(type), actual[i], expected);
+            return TEST_FAIL;
+        }
+    }
+    return TEST_PASS;
+}
+
+} // anonymous namespace
+
+int ext_image_raw10_raw12_bench(cl_device_id device, cl_context context,
+                                cl_command_queue queue)
+{
+    if (!is_extension_available(device, "cl_ext_image_raw10_raw12"))
+    {
+        log_info("Extension cl_ext_image_raw10_raw12 not available\n");
+        return TEST_SKIPPED_ITSELF;
+    }
+
+    size_t maxWidth, maxHeight;
+    cl_int error = clGetDeviceInfo(device, CL_DEVICE_IMAGE2D_MAX_WIDTH,
+                                   sizeof(maxWidth), &maxWidth, NULL);
+    error |= clGetDeviceInfo(device, CL_DEVICE_IMAGE2D_MAX_HEIGHT,
+                             sizeof(maxHeight), &maxHeight, NULL);
+    test_error(error, "Unable to get the maximum image size");
+    size_t width = std::min(kBenchWidth, maxWidth) & ~(kPixelsPerItem - 1);
+    size_t height = std::min(kBenchHeight, maxHeight);
+
+    std::string options =
+        "-DPIXELS_PER_ITEM=" + std::to_string(kPixelsPerItem);
+    clProgramWrapper program;
+    clKernelWrapper kernel;
+    if (create_single_kernel_helper(context, &program, &kernel, 1,
+                                    &kRawBenchSource, "sum_runs",
+                                    options.c_str()))
+    {
+        log_error("create_single_kernel_helper failed\n");
+        return TEST_FAIL;
+    }
+
+    clCommandQueueWrapper profilingQueue = clCreateCommandQueue(
+        context, device, CL_QUEUE_PROFILING_ENABLE, &error);
+    test_error(error, "Unable to create profiling queue");
+
+    MTdataHolder d(gRandomSeed);
+    std::vector<cl_ushort> values(width * height);
+
+    log_info("Reading %zux%zu images, %zu pixels per work-item\n", width,
+             height, kPixelsPerItem);
+    log_benchmark_header("raw_image_read", "format/values");
+    for (const RawBenchFormat &raw : kRawBenchFormats)
+    {
+        const cl_image_format format = { CL_R, raw.type };
+        if (!is_image_format_supported(context, CL_MEM_READ_ONLY,
+                                       CL_MEM_OBJECT_IMAGE2D, &format))
+        {
+            log_info("%s images are not supported, skipping\n", raw.name);
+            continue;
+        }
+
+        for (cl_ushort &value : values)
+            value = (cl_ushort)(genrand_int32(d) & raw.mask);
+
+        BenchmarkStats unpacked, packed;
+        int ret = time_raw_format(device, context, profilingQueue, kernel,
+                                  CL_UNSIGNED_INT16, values, width, height,
+                                  &unpacked);
+        if (ret != TEST_PASS) return ret;
+        ret = time_raw_format(device, context, profilingQueue, kernel,
+                              raw.type, values, width, height, &packed);
+        if (ret != TEST_PASS) return ret;
+
+        log_benchmark_stats("raw_image_read",
+                            (std::string("UINT16/") + raw.name).c_str(), "ns",
+                            false, unpacked);
+        log_benchmark_stats("raw_image_read",
+                            (std::string(raw.name) + "/" + raw.name).c_str(),
+                            "ns", false, packed);
+        if (packed.median > 0)
+            record_perf_metric(std::string("raw_image_read_relative_to_uint16.")
+                                   + raw.name,
+                               unpacked.median / packed.median, "ratio", true);
+    }
+
+    return TEST_PASS;
+}
@@ -17,6 +17,7 @@
 #include "test_common.h"
 
 #include <algorithm>
+#include <mutex>
 
 cl_sampler create_sampler(cl_context context, image_sampler_data *sdata, bool test_mipmaps, cl_int *error) {
     cl_sampler sampler = nullptr;
@@ -34,6 +35,19 @@ cl_sampler create_sampler(cl_context context, image_sampler_data *sdata, bool te
     return sampler;
 }
 
+void detect_half_rounding_mode(cl_command_queue queue)
+{
+    static std::mutex detectMutex;
+    static bool detected = false;
+
+    std::lock_guard<std::mutex> lock(detectMutex);
+    if (!detected)
+    {
+        detected = CL_SUCCESS == DetectFloatToHalfRoundingMode(queue);
+        if (detected) log_info("Half rounding mode successfully detected.\n");
+    }
+}
+
 bool get_image_dimensions(image_descriptor *imageInfo, size_t &width,
                           size_t &height, size_t &depth)
 {
@@ -247,7 +261,6 @@ int test_read_image(cl_context context, cl_command_queue queue,
 {
     int error;
     size_t threads[3];
-    static int initHalf = 0;
 
     size_t image_size =
         get_image_num_pixels(imageInfo, imageInfo->width, imageInfo->height,
@@ -525,15 +538,8 @@ int test_read_image(cl_context context, cl_command_queue queue,
     if (gDebugTrace)
         log_info("\tformatAbsoluteError is %e\n", formatAbsoluteError);
 
-    if (0 == initHalf
-        && imageInfo->format->image_channel_data_type == CL_HALF_FLOAT)
-    {
-        initHalf = CL_SUCCESS == DetectFloatToHalfRoundingMode(queue);
-        if (initHalf)
-        {
-            log_info("Half rounding mode successfully detected.\n");
-        }
-    }
+    if (imageInfo->format->image_channel_data_type == CL_HALF_FLOAT)
+        detect_half_rounding_mode(queue);
 
     int nextLevelOffset = 0;
     size_t width_lod = width_size, height_lod = height_size,
@@ -551,6 +557,9 @@ int test_read_image(cl_context context, cl_command_queue queue,
             image_lod_size * get_explicit_type_size(outputType) * 4;
         BufferOwningPtr<char> resultValues(malloc(resultValuesSize));
         float lod_float = (float)lod;
+        // Decode the level once for all of its offsets and retries
+        ImageLevelReference levelReference(
+            (char *)imageValues + nextLevelOffset, imageInfo, (int)lod);
         if (gTestMipmaps)
         {
             // Set the lod kernel arg
@@ -45,6 +45,10 @@ extern int test_read_image(cl_context context, cl_command_queue queue,
 extern bool get_image_dimensions(image_descriptor *imageInfo, size_t &width,
                                  size_t &height, size_t &depth);
 
+// Detects how the device rounds floats to half the first time it is called,
+// from any thread, and sets gFloatToHalfRoundingMode
+extern void detect_half_rounding_mode(cl_command_queue queue);
+
 template <class T>
 int determine_validation_error_offset(
     void *imagePtr, image_descriptor *imageInfo,
@@ -0,0 +1,544 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "../testBase.h"
+#include "../common.h"
+#include "harness/benchmark.h"
+#include "harness/perfMetrics.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// Time to read with read_imagef and write with write_imagef kBenchTexels, for
+// the float-read formats in R, RG and RGBA order, from and to a 1D image
+// buffer, a 2D image and a 3D image of the same number of texels, against a
+// plain buffer holding the same data. Reads sweep the filter and addressing
+// modes usable with unnormalized coordinates, declaring the sampler in the
+// kernel with get_sampler_kernel_code. Every read is sampled at texel
+// centers, so each one returns a texel unchanged and the sums of every
+// variant are checked against the buffer ones. A benchmark, so it only runs
+// when named.
+
+namespace {
+
+const size_t kBenchTexels = 1 << 20;
+const size_t kWidth2D = 1024;
+const size_t kWidth3D = 256;
+const size_t kDepth3D = 16;
+const size_t kTexelsPerItem = 4;
+const size_t kMaxLocalSize = 256;
+
+enum Layout
+{
+    kBuffer,
+    kImage1DBuffer,
+    kImage2D,
+    kImage3D,
+    kLayoutCount
+};
+
+const char *kLayoutNames[kLayoutCount] = { "buffer", "image1d_buffer",
+                                           "image2d", "image3d" };
+const char *kImageTypes[kLayoutCount] = { "", "image1d_buffer_t", "image2d_t",
+                                          "image3d_t" };
+
+struct BenchType
+{
+    cl_channel_type type;
+    const char *element;
+    size_t size;
+    // For normalized types, the value of 1.0f
+    const char *scale;
+    bool snorm;
+};
+
+const BenchType kBenchTypes[] = {
+    { CL_UNORM_INT8, "uchar", 1, "255.0f", false },
+    { CL_UNORM_INT16, "ushort", 2, "65535.0f", false },
+    { CL_SNORM_INT8, "char", 1, "127.0f", true },
+    { CL_SNORM_INT16, "short", 2, "32767.0f", true },
+    { CL_HALF_FLOAT, "half", 2, NULL, false },
+    { CL_FLOAT, "float", 4, NULL, false },
+};
+
+const cl_channel_order kBenchOrders[] = { CL_R, CL_RG, CL_RGBA };
+
+const cl_addressing_mode kAddressModes[] = { CL_ADDRESS_NONE, CL_ADDRESS_CLAMP,
+                                             CL_ADDRESS_CLAMP_TO_EDGE };
+const cl_filter_mode kFilterModes[] = { CL_FILTER_NEAREST, CL_FILTER_LINEAR };
+
+std::string vector_suffix(size_t channels)
+{
+    return channels == 1 ? "" : std::to_string(channels);
+}
+
+// LOAD(idx) and STORE(idx, v) between a buffer of the format's elements and
+// the float4 read_imagef returns and write_imagef takes
+std::string buffer_macros(const BenchType &t, size_t channels)
+{
+    std::string n = vector_suffix(channels);
+    std::string vec = std::string(t.element) + n;
+    const char *widen = channels == 1
+        ? "(float4)(%s, 0.0f, 0.0f, 1.0f)"
+        : channels == 2 ? "(float4)(%s, 0.0f, 1.0f)" : "%s";
+    std::string swizzle = channels == 1 ? ".x" : channels == 2 ? ".xy" : "";
+
+    std::string load, store;
+    if (t.scale)
+    {
+        load = "convert_float" + n + "(buf[idx]) * (1.0f / " + t.scale + ")";
+        if (t.snorm) load = "max(" + load + ", -1.0f)";
+        store = "buf[idx] = convert_" + vec + "_sat_rte((v)" + swizzle + " * "
+            + t.scale + ")";
+    }
+    else if (t.type == CL_HALF_FLOAT)
+    {
+        load = "vload_half" + n + "(idx, buf)";
+        store = "vstore_half" + n + "_rte((v)" + swizzle + ", idx, buf)";
+    }
+    else
+    {
+        load = "buf[idx]";
+        store = "buf[idx] = (v)" + swizzle;
+    }
+
+    char loadLine[256];
+    snprintf(loadLine, sizeof(loadLine), widen, load.c_str());
+    // vload_half and vstore_half take pointers to half, not halfn
+    std::string pointee = t.type == CL_HALF_FLOAT ? "half" : vec;
+    return "#define ELEM_T " + pointee + "\n#define LOAD(idx) " + loadLine
+        + "\n#define STORE(idx, v) " + store + "\n";
+}
+
+// Each work-item covers kTexelsPerItem texels along x from the start of its
+// run, at x, y and z for the images and at index for the buffers
+const char *kRunPrologue = R"(
+    uint gid = get_global_id(0);
+    uint row = gid / items_per_row;
+    int x = (int)((gid % items_per_row) * TEXELS_PER_ITEM);
+    int y = (int)(row % rows);
+    int z = (int)(row / rows);
+    uint index = gid * TEXELS_PER_ITEM;
+)";
+
+std::string read_source(Layout layout, const BenchType &t, size_t channels,
+                        const image_sampler_data *sampler)
+{
+    std::string src = "#define TEXELS_PER_ITEM "
+        + std::to_string(kTexelsPerItem) + "\n";
+    std::string read;
+    if (layout == kBuffer)
+    {
+        src += buffer_macros(t, channels);
+        src += "__kernel void read_texels(__global const ELEM_T *buf,";
+        read = "LOAD(index + i)";
+    }
+    else
+    {
+        src += std::string("__kernel void read_texels(read_only ")
+            + kImageTypes[layout] + " img,";
+        if (layout == kImage1DBuffer)
+            read = "read_imagef(img, (int)index + i)";
+        else if (layout == kImage2D)
+            read = "read_imagef(img, imageSampler, "
+                   "(float2)(x + i + 0.5f, y + 0.5f))";
+        else
+            read = "read_imagef(img, imageSampler, "
+                   "(float4)(x + i + 0.5f, y + 0.5f, z + 0.5f, 0.0f))";
+    }
+    src += R"(
+                          __global float *sums, uint items_per_row,
+                          uint rows)
+{)";
+    if (sampler)
+    {
+        char samplerLine[1024];
+        get_sampler_kernel_code((image_sampler_data *)sampler, samplerLine);
+        src += samplerLine;
+    }
+    src += kRunPrologue;
+    src += R"(
+    float4 sum = 0.0f;
+    for (int i = 0; i < TEXELS_PER_ITEM; i++)
+        sum += )"
+        + read + R"(;
+    sums[gid] = sum.x + sum.y + sum.z + sum.w;
+}
+)";
+    return src;
+}
+
+std::string write_source(Layout layout, const BenchType &t, size_t channels,
+                         bool writes3D)
+{
+    std::string src = "#define TEXELS_PER_ITEM "
+        + std::to_string(kTexelsPerItem) + "\n";
+    std::string write;
+    if (layout == kBuffer)
+    {
+        src += buffer_macros(t, channels);
+        src += "__kernel void write_texels(__global ELEM_T *buf,";
+        write = "STORE(index + i, value)";
+    }
+    else
+    {
+        if (layout == kImage3D && writes3D)
+            src += "#pragma OPENCL EXTENSION cl_khr_3d_image_writes : enable\n";
+        src += std::string("__kernel void write_texels(write_only ")
+            + kImageTypes[layout] + " img,";
+        if (layout == kImage1DBuffer)
+            write = "write_imagef(img, (int)index + i, value)";
+        else if (layout == kImage2D)
+            write = "write_imagef(img, (int2)(x + i, y), value)";
+        else
+            write = "write_imagef(img, (int4)(x + i, y, z, 0), value)";
+    }
+    src += R"(
+                           __global float *unused, uint items_per_row,
+                           uint rows)
+{)";
+    src += kRunPrologue;
+    src += R"(
+    float4 value = (float4)((gid & 255) * (1.0f / 255.0f));
+    for (int i = 0; i < TEXELS_PER_ITEM; i++)
+        )"
+        + write + R"(;
+}
+)";
+    return src;
+}
+
+// The host data of an image or buffer of format, in range for its type
+std::vector<char> bench_data(const BenchType &t, size_t channels, MTdata d)
+{
+    size_t count = kBenchTexels * channels;
+    std::vector<char> data(count * t.size);
+    for (size_t i = 0; i < count; i++)
+    {
+        float f = (float)genrand_real1(d);
+        if (t.type == CL_FLOAT)
+            ((cl_float *)data.data())[i] = f;
+        else if (t.type == CL_HALF_FLOAT)
+            ((cl_half *)data.data())[i] = cl_half_from_float(f, CL_HALF_RTE);
+        else if (t.size == 1)
+            ((cl_uchar *)data.data())[i] = (cl_uchar)genrand_int32(d);
+        else
+            ((cl_ushort *)data.data())[i] = (cl_ushort)genrand_int32(d);
+    }
+    return data;
+}
+
+// A buffer, or an image of layout and format, flags CL_MEM_READ_ONLY or
+// CL_MEM_WRITE_ONLY, holding data if given. A 1D image buffer keeps its
+// buffer in backing.
+cl_mem create_bench_object(cl_context context, Layout layout,
+                           cl_mem_flags flags, const cl_image_format *format,
+                           size_t pixelSize, void *data, clMemWrapper &backing,
+                           cl_int *error)
+{
+    size_t size = kBenchTexels * pixelSize;
+    cl_mem_flags hostFlags = data ? CL_MEM_COPY_HOST_PTR : 0;
+    switch (layout)
+    {
+        case kBuffer:
+            return clCreateBuffer(context, flags | hostFlags, size, data,
+                                  error);
+        case kImage1DBuffer: {
+            backing = clCreateBuffer(context, flags | hostFlags, size, data,
+                                     error);
+            if (*error != CL_SUCCESS) return NULL;
+            cl_image_desc desc = { 0 };
+            desc.image_type = CL_MEM_OBJECT_IMAGE1D_BUFFER;
+            desc.image_width = kBenchTexels;
+            desc.buffer = backing;
+            return clCreateImage(context, flags, format, &desc, NULL, error);
+        }
+        case kImage2D:
+            return create_image_2d(context, flags | hostFlags, format,
+                                   kWidth2D, kBenchTexels / kWidth2D, 0, data,
+                                   error);
+        default:
+            return create_image_3d(context, flags | hostFlags, format,
+                                   kWidth3D, kBenchTexels / kWidth3D / kDepth3D,
+                                   kDepth3D, 0, 0, data, error);
+    }
+}
+
+// The row length and row count per layer the kernels of layout index with
+void layout_shape(Layout layout, cl_uint *itemsPerRow, cl_uint *rows)
+{
+    switch (layout)
+    {
+        case kImage2D:
+            *itemsPerRow = (cl_uint)(kWidth2D / kTexelsPerItem);
+            *rows = (cl_uint)(kBenchTexels / kWidth2D);
+            break;
+        case kImage3D:
+            *itemsPerRow = (cl_uint)(kWidth3D / kTexelsPerItem);
+            *rows = (cl_uint)(kBenchTexels / kWidth3D / kDepth3D);
+            break;
+        default:
+            *itemsPerRow = (cl_uint)(kBenchTexels / kTexelsPerItem);
+            *rows = 1;
+            break;
+    }
+}
+
+// Build source and sample its runs on object, on queue, which has profiling
+// enabled
+int time_bench_kernel(cl_device_id device, cl_context context,
+                      cl_command_queue queue, const std::string &source,
+                      const char *name, cl_mem object, cl_mem sums,
+                      Layout layout, BenchmarkStats *stats)
+{
+    clProgramWrapper program;
+    clKernelWrapper kernel;
+    const char *src = source.c_str();
+    if (create_single_kernel_helper(context, &program, &kernel, 1, &src,
+                                    name))
+    {
+        log_error("create_single_kernel_helper failed\n");
+        return TEST_FAIL;
+    }
+
+    cl_uint itemsPerRow, rows;
+    layout_shape(layout, &itemsPerRow, &rows);
+    cl_int error = clSetKernelArg(kernel, 0, sizeof(object), &object);
+    error |= clSetKernelArg(kernel, 1, sizeof(sums), &sums);
+    error |= clSetKernelArg(kernel, 2, sizeof(itemsPerRow), &itemsPerRow);
+    error |= clSetKernelArg(kernel, 3, sizeof(rows), &rows);
+    test_error(error, "Unable to set kernel arguments");
+
+    size_t global = kBenchTexels / kTexelsPerItem;
+    size_t local;
+    error = get_max_allowed_1d_work_group_size_on_device(device, kernel,
+                                                         &local);
+    test_error(error, "Unable to get the work-group size");
+    local = std::min(local, kMaxLocalSize);
+    while (global % local) local--;
+
+    BenchmarkOptions options;
+    options.warmup = 1;
+    options.maxSeconds = 1.0;
+    error = benchmark_1d_kernel(queue, kernel, global, local, options, stats);
+    test_error(error, "Unable to time kernel");
+    return TEST_PASS;
+}
+
+int check_sums(cl_command_queue queue, cl_mem sums,
+               const std::vector<cl_float> &expected, const char *what)
+{
+    std::vector<cl_float> actual(expected.size());
+    cl_int error = clEnqueueReadBuffer(queue, sums, CL_TRUE, 0,
+                                       actual.size() * sizeof(cl_float),
+                                       actual.data(), 0, NULL, NULL);
+    test_error(error, "Unable to read sums");
+    for (size_t i = 0; i < actual.size(); i++)
+    {
+        float tolerance = 1e-3f * std::max(1.0f, fabsf(expected[i]));
+        if (!(fabsf(actual[i] - expected[i]) <= tolerance))
+        {
+            log_error("Sum %zu read from the %s is %a, the buffer gives %a\n",
+                      i, what, actual[i], expected[i]);
+            return TEST_FAIL;
+        }
+    }
+    return TEST_PASS;
+}
+
+// Logs stats and records how much faster than the buffer they are
+void log_bench_stats(const cl_image_format &format, const char *op,
+                     Layout layout, const char *sampler,
+                     const BenchmarkStats &stats, double bufferNs)
+{
+    std::string label =
+        std::string(GetChannelOrderName(format.image_channel_order)) + "/"
+        + GetChannelTypeName(format.image_channel_data_type) + "/" + op + "/"
+        + kLayoutNames[layout] + "/" + sampler;
+    log_benchmark_stats("image_read_write", label.c_str(), "ns", false,
+                        stats);
+    if (stats.median > 0)
+        record_perf_metric("image_read_write_relative_to_buffer." + label,
+                           bufferNs / stats.median, "ratio", true);
+}
+
+int bench_format(cl_device_id device, cl_context context,
+                 cl_command_queue queue, const BenchType &t, size_t channels,
+                 const cl_image_format &format, bool layouts[kLayoutCount],
+                 bool writes3D, MTdata d)
+{
+    size_t pixelSize = t.size * channels;
+    std::vector<char> data = bench_data(t, channels, d);
+    size_t items = kBenchTexels / kTexelsPerItem;
+    cl_int error;
+    clMemWrapper sums = clCreateBuffer(context, CL_MEM_READ_WRITE,
+                                       items * sizeof(cl_float), NULL, &error);
+    test_error(error, "Unable to create buffer");
+
+    // Reads, first from the buffer that gives the expected sums
+    std::vector<cl_float> expected(items);
+    double bufferNs = 0.0;
+    for (int l = 0; l < kLayoutCount; l++)
+    {
+        Layout layout = (Layout)l;
+        if (!layouts[layout]
+            || (layout != kBuffer
+                && !is_image_format_supported(
+                    context, CL_MEM_READ_ONLY,
+                    layout == kImage1DBuffer ? CL_MEM_OBJECT_IMAGE1D_BUFFER
+                        : layout == kImage2D ? CL_MEM_OBJECT_IMAGE2D
+                                             : CL_MEM_OBJECT_IMAGE3D,
+                    &format)))
+            continue;
+
+        clMemWrapper backing;
+        clMemWrapper object =
+            create_bench_object(context, layout, CL_MEM_READ_ONLY, &format,
+                                pixelSize, data.data(), backing, &error);
+        test_error(error, "Unable to create the data to read");
+
+        // The buffer and the 1D image buffer are read without a sampler
+        bool sampled = layout == kImage2D || layout == kImage3D;
+        for (cl_filter_mode filter : kFilterModes)
+            for (cl_addressing_mode address : kAddressModes)
+            {
+                if (!sampled
+                    && (filter != CL_FILTER_NEAREST
+                        || address != CL_ADDRESS_NONE))
+                    continue;
+                // The embedded profile only filters floats at nearest
+                if (gIsEmbedded && filter == CL_FILTER_LINEAR
+                    && (t.type == CL_FLOAT || t.type == CL_HALF_FLOAT))
+                    continue;
+
+                image_sampler_data sampler = { address, filter, false };
+                BenchmarkStats stats;
+                int ret = time_bench_kernel(
+                    device, context, queue,
+                    read_source(layout, t, channels,
+                                sampled ? &sampler : NULL),
+                    "read_texels", object, sums, layout, &stats);
+                if (ret != TEST_PASS) return ret;
+
+                char samplerName[64] = "-";
+                if (sampled)
+                    snprintf(samplerName, sizeof(samplerName), "%s_%s",
+                             filter == CL_FILTER_LINEAR ? "linear" : "nearest",
+                             GetAddressModeName(address));
+                if (layout == kBuffer)
+                {
+                    bufferNs = stats.median;
+                    error = clEnqueueReadBuffer(
+                        queue, sums, CL_TRUE, 0, items * sizeof(cl_float),
+                        expected.data(), 0, NULL, NULL);
+                    test_error(error, "Unable to read sums");
+                }
+                else
+                {
+                    ret = check_sums(queue, sums, expected,
+                                     kLayoutNames[layout]);
+                    if (ret != TEST_PASS) return ret;
+                }
+                log_bench_stats(format, "read", layout, samplerName, stats,
+                                bufferNs);
+            }
+    }
+
+    // Writes, which don't depend on addressing or filtering
+    bufferNs = 0.0;
+    for (int l = 0; l < kLayoutCount; l++)
+    {
+        Layout layout = (Layout)l;
+        if (!layouts[layout] || (layout == kImage3D && !writes3D)
+            || (layout != kBuffer
+                && !is_image_format_supported(
+                    context, CL_MEM_WRITE_ONLY,
+                    layout == kImage1DBuffer ? CL_MEM_OBJECT_IMAGE1D_BUFFER
+                        : layout == kImage2D ? CL_MEM_OBJECT_IMAGE2D
+                                             : CL_MEM_OBJECT_IMAGE3D,
+                    &format)))
+            continue;
+
+        clMemWrapper backing;
+        clMemWrapper object =
+            create_bench_object(context, layout, CL_MEM_WRITE_ONLY, &format,
+                                pixelSize, NULL, backing, &error);
+        test_error(error, "Unable to create the data to write");
+
+        BenchmarkStats stats;
+        int ret = time_bench_kernel(
+            device, context, queue,
+            write_source(layout, t, channels, writes3D), "write_texels",
+            object, sums, layout, &stats);
+        if (ret != TEST_PASS) return ret;
+        if (layout == kBuffer) bufferNs = stats.median;
+        log_bench_stats(format, "write", layout, "-", stats, bufferNs);
+    }
+    return TEST_PASS;
+}
+
+} // anonymous namespace
+
+int image_read_write_bench(cl_device_id device, cl_context context,
+                           cl_command_queue queue)
+{
+    // Layouts the device can hold kBenchTexels texels in
+    size_t maxBufferTexels, max2D[2], max3D[3];
+    cl_int error = clGetDeviceInfo(device, CL_DEVICE_IMAGE_MAX_BUFFER_SIZE,
+                                   sizeof(maxBufferTexels), &maxBufferTexels,
+                                   NULL);
+    error |= clGetDeviceInfo(device, CL_DEVICE_IMAGE2D_MAX_WIDTH,
+                             sizeof(max2D[0]), &max2D[0], NULL);
+    error |= clGetDeviceInfo(device, CL_DEVICE_IMAGE2D_MAX_HEIGHT,
+                             sizeof(max2D[1]), &max2D[1], NULL);
+    error |= clGetDeviceInfo(device, CL_DEVICE_IMAGE3D_MAX_WIDTH,
+                             sizeof(max3D[0]), &max3D[0], NULL);
+    error |= clGetDeviceInfo(device, CL_DEVICE_IMAGE3D_MAX_HEIGHT,
+                             sizeof(max3D[1]), &max3D[1], NULL);
+    error |= clGetDeviceInfo(device, CL_DEVICE_IMAGE3D_MAX_DEPTH,
+                             sizeof(max3D[2]), &max3D[2], NULL);
+    test_error(error, "Unable to get the maximum image sizes");
+
+    bool layouts[kLayoutCount];
+    layouts[kBuffer] = true;
+    layouts[kImage1DBuffer] = maxBufferTexels >= kBenchTexels;
+    layouts[kImage2D] =
+        max2D[0] >= kWidth2D && max2D[1] >= kBenchTexels / kWidth2D;
+    layouts[kImage3D] = max3D[0] >= kWidth3D
+        && max3D[1] >= kBenchTexels / kWidth3D / kDepth3D
+        && max3D[2] >= kDepth3D;
+    bool writes3D =
+        is_extension_available(device, "cl_khr_3d_image_writes");
+
+    // The sums are read back on the same queue the kernels are timed on
+    clCommandQueueWrapper profilingQueue = clCreateCommandQueue(
+        context, device, CL_QUEUE_PROFILING_ENABLE, &error);
+    test_error(error, "Unable to create profiling queue");
+
+    MTdataHolder d(gRandomSeed);
+    log_benchmark_header("image_read_write", "order/type/op/layout/sampler");
+    for (const BenchType &t : kBenchTypes)
+        for (cl_channel_order order : kBenchOrders)
+        {
+            const cl_image_format format = { order, t.type };
+            size_t channels = get_format_channel_count(&format);
+            int ret = bench_format(device, context, profilingQueue, t,
+                                   channels, format, layouts, writes3D, d);
+            if (ret != TEST_PASS) return ret;
+        }
+
+    return TEST_PASS;
+}
@@ -516,8 +516,34 @@ int validate_image_2D_results(void *imageValues, void *resultValues, double form
         float *resultPtr = (float *)(char *)resultValues;
         float expected[4], error=0.0f;
         float maxErr = get_max_relative_error( imageInfo->format, imageSampler, 0 /*not 3D*/, CL_FILTER_LINEAR == imageSampler->filter_mode );
+
+        // When only the exact coordinates are tried below, compute the
+        // reference for a whole row at once
+        bool batchRows = !imageSampler->normalized_coords
+            || imageSampler->filter_mode != CL_FILTER_NEAREST
+            || NORM_OFFSET == 0
+#if defined( __APPLE__ )
+            || !(gDeviceType & CL_DEVICE_TYPE_GPU)
+#endif
+            ;
+        std::vector<float> rowExpected;
+        std::vector<FloatPixel> rowMaxPixels;
+        std::vector<int> rowDenorms;
+        if( batchRows )
+        {
+            rowExpected.resize( 4 * width_lod );
+            rowMaxPixels.resize( width_lod );
+            rowDenorms.resize( width_lod );
+        }
+
         for( size_t y = 0, j = 0; y < height_lod; y++ )
         {
+            if( batchRows )
+                sample_image_pixels_float_offset( gTestMipmaps ? imagePtr : imageValues, imageInfo,
+                                                  xOffsetValues + j, yOffsetValues + j, NULL, width_lod, 0.0f, 0.0f, 0.0f,
+                                                  imageSampler, rowExpected.data(), rowMaxPixels.data(), rowDenorms.data(),
+                                                  gTestMipmaps ? (int)lod : 0 );
+
             for( size_t x = 0; x < width_lod; x++, j++ )
             {
                 // Step 1: go through and see if the results verify for the pixel
@@ -544,7 +570,13 @@ int validate_image_2D_results(void *imageValues, void *resultValues, double form
                         // Try sampling the pixel, without flushing denormals.
                         int containsDenormals = 0;
                         FloatPixel maxPixel;
-                        if ( gTestMipmaps )
+                        if ( batchRows )
+                        {
+                            memcpy( expected, &rowExpected[ 4 * x ], sizeof( expected ) );
+                            maxPixel = rowMaxPixels[ x ];
+                            containsDenormals = rowDenorms[ x ];
+                        }
+                        else if ( gTestMipmaps )
                             maxPixel = sample_image_pixel_float_offset( imagePtr, imageInfo,
                                                                         xOffsetValues[ j ], yOffsetValues[ j ], 0.0f, norm_offset_x, norm_offset_y, 0.0f,
                                                                         imageSampler, expected, 0, &containsDenormals, lod );
@@ -1184,7 +1216,6 @@ int test_read_image_2D( cl_context context, cl_command_queue queue, cl_kernel ke
                        bool useFloatCoords, ExplicitType outputType, MTdata d )
 {
     int error;
-    static int initHalf = 0;
     cl_mem imageBuffer;
     cl_mem_flags    image_read_write_flags = CL_MEM_READ_ONLY;
     size_t threads[2];
@@ -1464,12 +1495,8 @@ int test_read_image_2D( cl_context context, cl_command_queue queue, cl_kernel ke
     double formatAbsoluteError = get_max_absolute_error(imageInfo->format, imageSampler);
     if (gDebugTrace) log_info("\tformatAbsoluteError is %e\n", formatAbsoluteError);
 
-    if (0 == initHalf && imageInfo->format->image_channel_data_type == CL_HALF_FLOAT ) {
-        initHalf = CL_SUCCESS == DetectFloatToHalfRoundingMode( queue );
-        if (initHalf) {
-            log_info("Half rounding mode successfully detected.\n");
-        }
-    }
+    if (imageInfo->format->image_channel_data_type == CL_HALF_FLOAT)
+        detect_half_rounding_mode(queue);
 
     size_t nextLevelOffset = 0;
     size_t width_lod = imageInfo->width, height_lod = imageInfo->height;
@@ -1478,6 +1505,9 @@ int test_read_image_2D( cl_context context, cl_command_queue queue, cl_kernel ke
         size_t resultValuesSize = width_lod * height_lod * get_explicit_type_size( outputType ) * 4;
         BufferOwningPtr<char> resultValues(malloc(resultValuesSize));
         float lod_float = (float)lod;
+        // Decode the level once for all of its offsets and retries
+        ImageLevelReference levelReference(
+            (char *)imageValues + nextLevelOffset, imageInfo, (int)lod);
         char *imagePtr = (char *)imageValues + nextLevelOffset;
         if( gTestMipmaps )
         {
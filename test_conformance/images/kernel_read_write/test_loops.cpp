@@ -15,12 +15,19 @@
 //
 #include "../testBase.h"
 #include "../common.h"
+#include "test_common.h"
+#include "harness/ThreadPool.h"
+#include "harness/typeWrappers.h"
+
+#include <algorithm>
+#include <string>
 
 extern cl_filter_mode gFilterModeToUse;
 extern cl_addressing_mode gAddressModeToUse;
 extern int gNormalizedModeToUse;
 extern int gTypesToTest;
 extern int gtestTypesToRun;
+extern int gFormatThreads;
 
 extern int test_read_image_set_1D(cl_device_id device, cl_context context,
                                   cl_command_queue queue,
@@ -50,10 +57,15 @@ extern int test_read_image_set_2D_array(cl_device_id device, cl_context context,
                                         bool floatCoords,
                                         ExplicitType outputType);
 
-int test_read_image_type(cl_device_id device, cl_context context,
-                         cl_command_queue queue, const cl_image_format *format,
-                         bool floatCoords, image_sampler_data *imageSampler,
-                         ExplicitType outputType, cl_mem_object_type imageType)
+// Counts the runs and failures in testCount and failCount, which are
+// gTestCount and gFailCount unless the format is tested on a worker thread
+static int test_read_image_type(cl_device_id device, cl_context context,
+                                cl_command_queue queue,
+                                const cl_image_format *format, bool floatCoords,
+                                image_sampler_data *imageSampler,
+                                ExplicitType outputType,
+                                cl_mem_object_type imageType, int &testCount,
+                                int &failCount)
 {
     int ret = 0;
     cl_addressing_mode *addressModes = NULL;
@@ -119,7 +131,7 @@ int test_read_image_type(cl_device_id device, cl_context context,
          */
         print_read_header(format, imageSampler, false);
 
-        gTestCount++;
+        testCount++;
 
         int retCode = 0;
         switch (imageType)
@@ -152,7 +164,7 @@ int test_read_image_type(cl_device_id device, cl_context context,
         }
         if (retCode != 0)
         {
-            gFailCount++;
+            failCount++;
             log_error("FAILED: ");
             print_read_header(format, imageSampler, true);
             log_info("\n");
@@ -163,6 +175,146 @@ int test_read_image_type(cl_device_id device, cl_context context,
     return ret;
 }
 
+int test_read_image_type(cl_device_id device, cl_context context,
+                         cl_command_queue queue, const cl_image_format *format,
+                         bool floatCoords, image_sampler_data *imageSampler,
+                         ExplicitType outputType, cl_mem_object_type imageType)
+{
+    return test_read_image_type(device, context, queue, format, floatCoords,
+                                imageSampler, outputType, imageType,
+                                gTestCount, gFailCount);
+}
+
+namespace {
+
+struct FormatJob
+{
+    const cl_image_format *format;
+    // Each format changes the addressing mode of its own copy
+    image_sampler_data sampler;
+    std::string log;
+    int result;
+    int testCount;
+    int failCount;
+};
+
+struct FormatBatch
+{
+    cl_device_id device;
+    cl_context context;
+    bool floatCoords;
+    ExplicitType outputType;
+    cl_mem_object_type imageType;
+    std::vector<FormatJob> jobs;
+};
+
+// Tests one format of the batch on its own queue, holding back its output
+cl_int test_read_format_job(cl_uint job_id, cl_uint thread_id, void *userInfo)
+{
+    FormatBatch *batch = (FormatBatch *)userInfo;
+    FormatJob &job = batch->jobs[job_id];
+
+    log_capture_begin(&job.log);
+    cl_int error;
+    clCommandQueueWrapper queue =
+        clCreateCommandQueue(batch->context, batch->device, 0, &error);
+    if (error != CL_SUCCESS)
+    {
+        print_error(error, "Unable to create command queue");
+        job.result = error;
+    }
+    else
+    {
+        job.result = test_read_image_type(
+            batch->device, batch->context, queue, job.format,
+            batch->floatCoords, &job.sampler, batch->outputType,
+            batch->imageType, job.testCount, job.failCount);
+    }
+    queue.reset();
+    log_capture_end();
+
+    // Failures are reported through the job, so that every job runs
+    return CL_SUCCESS;
+}
+
+// Tests gFormatThreads formats at a time, then prints their output in the
+// order of formatList, so that the log reads as it does when they are tested
+// one after the other
+int test_read_image_formats_parallel(
+    cl_device_id device, cl_context context, cl_command_queue queue,
+    const std::vector<cl_image_format> &formatList,
+    const std::vector<bool> &filterFlags, bool floatCoords,
+    image_sampler_data *imageSampler, ExplicitType outputType,
+    cl_mem_object_type imageType)
+{
+    std::vector<const cl_image_format *> formats;
+    bool haveHalf = false;
+    for (unsigned int i = 0; i < formatList.size(); i++)
+    {
+        if (filterFlags[i]) continue;
+        formats.push_back(&formatList[i]);
+        haveHalf |= formatList[i].image_channel_data_type == CL_HALF_FLOAT;
+    }
+
+    // Detected up front so that the message does not land in the output of
+    // whichever half format gets there first
+    if (haveHalf) detect_half_rounding_mode(queue);
+
+    // The formats of a batch all start from the same seed and it moves on
+    // once per batch, rather than each format updating it as it finishes
+    cl_uint reSeed = gReSeed;
+    gReSeed = 0;
+
+    int ret = 0;
+    for (size_t first = 0; first < formats.size(); first += gFormatThreads)
+    {
+        FormatBatch batch = { device,     context,   floatCoords,
+                              outputType, imageType, {} };
+        size_t count =
+            std::min(formats.size() - first, (size_t)gFormatThreads);
+        batch.jobs.resize(count);
+        for (size_t j = 0; j < count; j++)
+        {
+            batch.jobs[j].format = formats[first + j];
+            batch.jobs[j].sampler = *imageSampler;
+            batch.jobs[j].result = 0;
+            batch.jobs[j].testCount = 0;
+            batch.jobs[j].failCount = 0;
+        }
+
+        cl_int error =
+            ThreadPool_Do(test_read_format_job, (cl_uint)count, &batch);
+        if (error != CL_SUCCESS)
+        {
+            print_error(error, "ThreadPool_Do failed");
+            ret |= error;
+            break;
+        }
+
+        for (const FormatJob &job : batch.jobs)
+        {
+            if (job.result != 0)
+                log_error("%s", job.log.c_str());
+            else
+                log_info("%s", job.log.c_str());
+            gTestCount += job.testCount;
+            gFailCount += job.failCount;
+            ret |= job.result;
+        }
+
+        if (reSeed)
+        {
+            MTdataHolder d(gRandomSeed);
+            gRandomSeed = genrand_int32(d);
+        }
+    }
+
+    gReSeed = reSeed;
+    return ret;
+}
+
+} // anonymous namespace
+
 int test_read_image_formats(cl_device_id device, cl_context context,
                             cl_command_queue queue,
                             const std::vector<cl_image_format> &formatList,
@@ -213,6 +365,15 @@ int test_read_image_formats(cl_device_id device, cl_context context,
                                              : "integer",
                      get_explicit_type_name(outputType));
 
+            if (gFormatThreads > 1)
+            {
+                ret |= test_read_image_formats_parallel(
+                    device, context, queue, formatList, filterFlags,
+                    flipFlop[floatCoordIdx], imageSampler, outputType,
+                    imageType);
+                continue;
+            }
+
             for (unsigned int i = 0; i < formatList.size(); i++)
             {
                 if (filterFlags[i]) continue;
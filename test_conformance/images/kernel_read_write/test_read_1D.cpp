@@ -220,7 +220,6 @@ int test_read_image_1D( cl_context context, cl_command_queue queue, cl_kernel ke
                        bool useFloatCoords, ExplicitType outputType, MTdata d )
 {
     int error;
-    static int initHalf = 0;
 
     size_t threads[2];
     cl_mem_flags    image_read_write_flags = CL_MEM_READ_ONLY;
@@ -420,18 +419,17 @@ int test_read_image_1D( cl_context context, cl_command_queue queue, cl_kernel ke
       double formatAbsoluteError = get_max_absolute_error(imageInfo->format, imageSampler);
       if (gDebugTrace) log_info("\tformatAbsoluteError is %e\n", formatAbsoluteError);
 
-    if (0 == initHalf && imageInfo->format->image_channel_data_type == CL_HALF_FLOAT ) {
-        initHalf = CL_SUCCESS == DetectFloatToHalfRoundingMode( queue );
-        if (initHalf) {
-            log_info("Half rounding mode successfully detected.\n");
-        }
-    }
+    if (imageInfo->format->image_channel_data_type == CL_HALF_FLOAT)
+        detect_half_rounding_mode(queue);
 
     size_t width_lod = imageInfo->width;
     size_t nextLevelOffset = 0;
     for(int lod = 0; (gTestMipmaps && lod < imageInfo->num_mip_levels) || (!gTestMipmaps && lod < 1); lod++)
     {
         float lod_float = (float)lod;
+        // Decode the level once for all of its offsets and retries
+        ImageLevelReference levelReference(
+            (char *)imageValues + nextLevelOffset, imageInfo, (int)lod);
         size_t resultValuesSize = width_lod * get_explicit_type_size( outputType ) * 4;
         BufferOwningPtr<char> resultValues(malloc(resultValuesSize));
         if (gTestMipmaps) {
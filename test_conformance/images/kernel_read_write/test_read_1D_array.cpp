@@ -265,7 +265,6 @@ int test_read_image_1D_array( cl_context context, cl_command_queue queue, cl_ker
                              bool useFloatCoords, ExplicitType outputType, MTdata d )
 {
     int error;
-    static int initHalf = 0;
 
     size_t threads[2];
     cl_mem_flags    image_read_write_flags = CL_MEM_READ_ONLY;
@@ -506,12 +505,8 @@ int test_read_image_1D_array( cl_context context, cl_command_queue queue, cl_ker
     double formatAbsoluteError = get_max_absolute_error(imageInfo->format, imageSampler);
     if (gDebugTrace) log_info("\tformatAbsoluteError is %e\n", formatAbsoluteError);
 
-    if (0 == initHalf && imageInfo->format->image_channel_data_type == CL_HALF_FLOAT ) {
-        initHalf = CL_SUCCESS == DetectFloatToHalfRoundingMode( queue );
-        if (initHalf) {
-            log_info("Half rounding mode successfully detected.\n");
-        }
-    }
+    if (imageInfo->format->image_channel_data_type == CL_HALF_FLOAT)
+        detect_half_rounding_mode(queue);
 
     size_t width_lod = imageInfo->width;
     size_t nextLevelOffset = 0;
@@ -521,6 +516,9 @@ int test_read_image_1D_array( cl_context context, cl_command_queue queue, cl_ker
         size_t resultValuesSize = width_lod * imageInfo->arraySize * get_explicit_type_size( outputType ) * 4;
         BufferOwningPtr<char> resultValues(malloc(resultValuesSize));
         float lod_float = (float)lod;
+        // Decode the level once for all of its offsets and retries
+        ImageLevelReference levelReference(
+            (char *)imageValues + nextLevelOffset, imageInfo, (int)lod);
         if (gTestMipmaps) {
             //Set the lod kernel arg
             if(gDebugTrace)
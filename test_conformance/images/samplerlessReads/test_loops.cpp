@@ -51,6 +51,16 @@ extern int test_read_image_set_2D_array(cl_device_id device, cl_context context,
                                         image_sampler_data *imageSampler,
                                         ExplicitType outputType);
 
+// Fills the results buffer with -1, so that a result no work-item wrote fails.
+// Filling it on the device saves writing a host copy of the whole buffer.
+cl_int fill_unwritten_results(cl_command_queue queue, cl_mem results,
+                              size_t size)
+{
+    cl_int unwritten = -1;
+    return clEnqueueFillBuffer(queue, results, &unwritten, sizeof(unwritten),
+                               0, size, 0, NULL, NULL);
+}
+
 int test_read_image_type(cl_device_id device, cl_context context,
                          cl_command_queue queue, const cl_image_format *format,
                          image_sampler_data *imageSampler,
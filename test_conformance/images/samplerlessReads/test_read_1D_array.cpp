@@ -23,6 +23,8 @@
 #endif
 
 extern bool gTestReadWrite;
+extern cl_int fill_unwritten_results(cl_command_queue queue, cl_mem results,
+                                     size_t size);
 
 const char *read1DArrayKernelSourcePattern =
 "__kernel void sample_kernel( read_only image1d_array_t input, sampler_t sampler, __global int *results )\n"
@@ -116,8 +118,8 @@ int test_read_image_1D_array( cl_context context, cl_command_queue queue, cl_ker
 
     size_t resultValuesSize = imageInfo->width * imageInfo->arraySize * sizeof(cl_int);
     BufferOwningPtr<int> resultValues(malloc( resultValuesSize ));
-    memset( resultValues, 0xff, resultValuesSize );
-    clEnqueueWriteBuffer( queue, results, CL_TRUE, 0, resultValuesSize, resultValues, 0, NULL, NULL );
+    error = fill_unwritten_results( queue, results, resultValuesSize );
+    test_error( error, "Unable to fill results buffer" );
 
     // Set arguments
     int idx = 0;
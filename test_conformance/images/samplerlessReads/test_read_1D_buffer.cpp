@@ -22,6 +22,8 @@
     #include <setjmp.h>
 #endif
 
+extern cl_int fill_unwritten_results(cl_command_queue queue, cl_mem results,
+                                     size_t size);
 
 const char *read1DBufferKernelSourcePattern =
 "__kernel void sample_kernel( read_only image1d_buffer_t inputA, read_only image1d_t inputB, sampler_t sampler, __global int *results )\n"
@@ -111,8 +113,8 @@ int test_read_image_1D_buffer( cl_context context, cl_command_queue queue, cl_ke
 
     size_t resultValuesSize = imageInfo->width * sizeof(cl_int);
     BufferOwningPtr<int> resultValues(malloc( resultValuesSize ));
-    memset( resultValues, 0xff, resultValuesSize );
-    clEnqueueWriteBuffer( queue, results, CL_TRUE, 0, resultValuesSize, resultValues, 0, NULL, NULL );
+    error = fill_unwritten_results( queue, results, resultValuesSize );
+    test_error( error, "Unable to fill results buffer" );
 
     // Set arguments
     int idx = 0;
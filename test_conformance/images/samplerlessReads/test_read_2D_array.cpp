@@ -17,6 +17,8 @@
 #include <float.h>
 
 extern bool gTestReadWrite;
+extern cl_int fill_unwritten_results(cl_command_queue queue, cl_mem results,
+                                     size_t size);
 
 const char *read2DArrayKernelSourcePattern =
 "__kernel void sample_kernel( read_only %s input, sampler_t sampler, __global int *results )\n"
@@ -103,8 +105,8 @@ int test_read_image_2D_array( cl_context context, cl_command_queue queue, cl_ker
 
     size_t resultValuesSize = imageInfo->width * imageInfo->height * imageInfo->arraySize * sizeof(cl_int);
     BufferOwningPtr<int> resultValues(malloc( resultValuesSize ));
-    memset( resultValues, 0xff, resultValuesSize );
-    clEnqueueWriteBuffer( queue, results, CL_TRUE, 0, resultValuesSize, resultValues, 0, NULL, NULL );
+    error = fill_unwritten_results( queue, results, resultValuesSize );
+    test_error( error, "Unable to fill results buffer" );
 
     // Set arguments
     int idx = 0;
@@ -20,10 +20,14 @@
 #include "procs.h"
 #include "harness/testHarness.h"
 
+#include <vector>
+
 #if !defined(_WIN32)
 #include <unistd.h>
 #endif
 
+bool gExhaustiveBitOps = false;
+
 test_definition test_list[] = {
     ADD_TEST(integer_clz),
     ADD_TEST_VERSION(integer_ctz, Version(2, 0)),
@@ -58,6 +62,7 @@ test_definition test_list[] = {
 
     ADD_TEST(integer_mul24),
     ADD_TEST(integer_mad24),
+    ADD_BENCHMARK(integer_mul24_popcount_bench),
 
     ADD_TEST(extended_bit_ops_extract),
     ADD_TEST(extended_bit_ops_insert),
@@ -149,6 +154,7 @@ test_definition test_list[] = {
     ADD_TEST(vector_scalar),
 
     ADD_TEST(integer_dot_product),
+    ADD_BENCHMARK(integer_dot_product_bench),
 };
 
 const int test_num = ARRAY_SIZE(test_list);
@@ -218,6 +224,18 @@ void fill_test_values( cl_long *outBufferA, cl_long *outBufferB, size_t numEleme
 
 int main(int argc, const char *argv[])
 {
-    return runTestHarness(argc, argv, test_num, test_list, false, 0);
+    std::vector<const char *> argList;
+    for (int i = 0; i < argc; i++)
+    {
+        if (i > 0 && strcmp(argv[i], "-exhaustive") == 0)
+        {
+            gExhaustiveBitOps = true;
+            continue;
+        }
+        argList.push_back(argv[i]);
+    }
+
+    return runTestHarness((int)argList.size(), argList.data(), test_num,
+                          test_list, false, 0);
 }
 
@@ -18,6 +18,7 @@
 #include "harness/typeWrappers.h"
 #include "harness/testHarness.h"
 #include "harness/mt19937.h"
+#include "harness/parseParameters.h"
 
 
 // The number of errors to print out for each test
@@ -59,6 +60,10 @@ extern int test_integer_sub_sat(cl_device_id deviceID, cl_context context, cl_co
 
 extern int test_integer_mul24(cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements);
 extern int test_integer_mad24(cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements);
+extern int test_integer_mul24_popcount_bench(cl_device_id deviceID,
+                                             cl_context context,
+                                             cl_command_queue queue,
+                                             int num_elements);
 
 extern int test_extended_bit_ops_extract(cl_device_id device_id,
                                          cl_context context,
@@ -154,3 +159,19 @@ extern int test_vector_scalar(cl_device_id deviceID, cl_context context, cl_comm
 
 extern int test_integer_dot_product(cl_device_id deviceID, cl_context context,
                                     cl_command_queue queue, int num_elements);
+extern int test_integer_dot_product_bench(cl_device_id deviceID,
+                                          cl_context context,
+                                          cl_command_queue queue,
+                                          int num_elements);
+
+// Set by -exhaustive: the extended bit ops tests try every 8-bit value, or
+// hundreds of random values, for each offset and count, not just one
+extern bool gExhaustiveBitOps;
+
+// Work-items the extended bit ops tests give each offset and count of vectors
+// of n components, so that those of all the work-items together hold about
+// 256 values in total
+inline size_t bit_ops_work_items_per_field(size_t n)
+{
+    return gExhaustiveBitOps ? (256 + n - 1) / n : 1;
+}
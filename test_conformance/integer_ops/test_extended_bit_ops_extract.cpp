@@ -98,12 +98,14 @@ calculate_reference(std::vector<typename std::make_unsigned<T>::type>& sref,
                     std::vector<typename std::make_unsigned<T>::type>& uref,
                     const std::vector<T>& base)
 {
+    const size_t workItemsPerField = bit_ops_work_items_per_field(N);
     sref.resize(base.size());
     uref.resize(base.size());
     for (size_t i = 0; i < base.size(); i++)
     {
-        cl_uint offset = (i / N) / (sizeof(T) * 8 + 1);
-        cl_uint count = (i / N) % (sizeof(T) * 8 + 1);
+        cl_uint field = (cl_uint)(i / N / workItemsPerField);
+        cl_uint offset = field / (sizeof(T) * 8 + 1);
+        cl_uint count = field % (sizeof(T) * 8 + 1);
         if (offset + count > sizeof(T) * 8)
         {
             count = (sizeof(T) * 8) - offset;
@@ -117,8 +119,9 @@ static constexpr const char* kernel_source = R"CLC(
 __kernel void test_bitfield_extract(__global SIGNED_TYPE* sdst, __global UNSIGNED_TYPE* udst, __global TYPE* base)
 {
     int index = get_global_id(0);
-    uint offset = index / (sizeof(BASETYPE) * 8 + 1);
-    uint count = index % (sizeof(BASETYPE) * 8 + 1);
+    uint field = index / WORK_ITEMS_PER_FIELD;
+    uint offset = field / (sizeof(BASETYPE) * 8 + 1);
+    uint count = field % (sizeof(BASETYPE) * 8 + 1);
     if (offset + count > sizeof(BASETYPE) * 8) {
         count = (sizeof(BASETYPE) * 8) - offset;
     }
@@ -131,8 +134,9 @@ static constexpr const char* kernel_source_vec3 = R"CLC(
 __kernel void test_bitfield_extract(__global SIGNED_BASETYPE* sdst, __global UNSIGNED_BASETYPE* udst, __global BASETYPE* base)
 {
     int index = get_global_id(0);
-    uint offset = index / (sizeof(BASETYPE) * 8 + 1);
-    uint count = index % (sizeof(BASETYPE) * 8 + 1);
+    uint field = index / WORK_ITEMS_PER_FIELD;
+    uint offset = field / (sizeof(BASETYPE) * 8 + 1);
+    uint count = field % (sizeof(BASETYPE) * 8 + 1);
     if (offset + count > sizeof(BASETYPE) * 8) {
         count = (sizeof(BASETYPE) * 8) - offset;
     }
@@ -175,10 +179,19 @@ static int test_vectype(cl_device_id device, cl_context context,
     buildOptions += " -DUNSIGNED_BASETYPE=";
     buildOptions += TestInfo<T>::deviceTypeNameUnsigned;
 
-    const size_t ELEMENTS_TO_TEST = (sizeof(T) * 8 + 1) * (sizeof(T) * 8 + 1);
+    const size_t workItemsPerField = bit_ops_work_items_per_field(N);
+    buildOptions += " -DWORK_ITEMS_PER_FIELD=";
+    buildOptions += std::to_string(workItemsPerField);
+
+    const size_t ELEMENTS_TO_TEST =
+        (sizeof(T) * 8 + 1) * (sizeof(T) * 8 + 1) * workItemsPerField;
 
     std::vector<T> base(ELEMENTS_TO_TEST * N);
     fill_vector_with_random_data(base);
+    // Every 8-bit value for each offset and count
+    if (gExhaustiveBitOps && sizeof(T) == 1)
+        for (size_t i = 0; i < base.size(); i++)
+            base[i] = static_cast<T>(i % (workItemsPerField * N));
 
     std::vector<unsigned_t> sreference;
     std::vector<unsigned_t> ureference;
@@ -46,11 +46,13 @@ static void
 calculate_reference(std::vector<typename std::make_unsigned<T>::type>& ref,
                     const std::vector<T>& base, const std::vector<T>& insert)
 {
+    const size_t workItemsPerField = bit_ops_work_items_per_field(N);
     ref.resize(base.size());
     for (size_t i = 0; i < base.size(); i++)
     {
-        cl_uint offset = (i / N) / (sizeof(T) * 8 + 1);
-        cl_uint count = (i / N) % (sizeof(T) * 8 + 1);
+        cl_uint field = (cl_uint)(i / N / workItemsPerField);
+        cl_uint offset = field / (sizeof(T) * 8 + 1);
+        cl_uint count = field % (sizeof(T) * 8 + 1);
         if (offset + count > sizeof(T) * 8)
         {
             count = (sizeof(T) * 8) - offset;
@@ -63,8 +65,9 @@ static constexpr const char* kernel_source = R"CLC(
 __kernel void test_bitfield_insert(__global TYPE* dst, __global TYPE* base, __global TYPE* insert)
 {
     int index = get_global_id(0);
-    uint offset = index / (sizeof(BASETYPE) * 8 + 1);
-    uint count = index % (sizeof(BASETYPE) * 8 + 1);
+    uint field = index / WORK_ITEMS_PER_FIELD;
+    uint offset = field / (sizeof(BASETYPE) * 8 + 1);
+    uint count = field % (sizeof(BASETYPE) * 8 + 1);
     if (offset + count > sizeof(BASETYPE) * 8) {
         count = (sizeof(BASETYPE) * 8) - offset;
     }
@@ -76,8 +79,9 @@ static constexpr const char* kernel_source_vec3 = R"CLC(
 __kernel void test_bitfield_insert(__global BASETYPE* dst, __global BASETYPE* base, __global BASETYPE* insert)
 {
     int index = get_global_id(0);
-    uint offset = index / (sizeof(BASETYPE) * 8 + 1);
-    uint count = index % (sizeof(BASETYPE) * 8 + 1);
+    uint field = index / WORK_ITEMS_PER_FIELD;
+    uint offset = field / (sizeof(BASETYPE) * 8 + 1);
+    uint count = field % (sizeof(BASETYPE) * 8 + 1);
     if (offset + count > sizeof(BASETYPE) * 8) {
         count = (sizeof(BASETYPE) * 8) - offset;
     }
@@ -111,13 +115,26 @@ static int test_vectype(cl_device_id device, cl_context context,
     buildOptions += " -DBASETYPE=";
     buildOptions += TestInfo<T>::deviceTypeName;
 
-    const size_t ELEMENTS_TO_TEST = (sizeof(T) * 8 + 1) * (sizeof(T) * 8 + 1);
+    const size_t workItemsPerField = bit_ops_work_items_per_field(N);
+    buildOptions += " -DWORK_ITEMS_PER_FIELD=";
+    buildOptions += std::to_string(workItemsPerField);
+
+    const size_t ELEMENTS_TO_TEST =
+        (sizeof(T) * 8 + 1) * (sizeof(T) * 8 + 1) * workItemsPerField;
 
     std::vector<T> base(ELEMENTS_TO_TEST * N);
-    std::fill(base.begin(), base.end(), static_cast<T>(0xA5A5A5A5A5A5A5A5ULL));
+    if (gExhaustiveBitOps)
+        fill_vector_with_random_data(base);
+    else
+        std::fill(base.begin(), base.end(),
+                  static_cast<T>(0xA5A5A5A5A5A5A5A5ULL));
 
     std::vector<T> insert(ELEMENTS_TO_TEST * N);
     fill_vector_with_random_data(insert);
+    // Every 8-bit value for each offset and count
+    if (gExhaustiveBitOps && sizeof(T) == 1)
+        for (size_t i = 0; i < insert.size(); i++)
+            insert[i] = static_cast<T>(i % (workItemsPerField * N));
 
     std::vector<unsigned_t> reference;
     calculate_reference<T, N>(reference, base, insert);
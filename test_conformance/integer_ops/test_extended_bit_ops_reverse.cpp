@@ -17,25 +17,42 @@
 #include <algorithm>
 #include <numeric>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include "procs.h"
 #include "harness/integer_ops_test_info.h"
 #include "harness/testHarness.h"
 
-template <typename T> static T cpu_bit_reverse(T base)
+// Bytes with their bits in reverse order
+static cl_uchar reverse_byte(cl_uchar b)
 {
-    T result = 0;
-
-    const size_t count = sizeof(T) * 8;
-    for (size_t i = 0; i < count; i++)
+    static const struct ReverseTable
     {
-        if (base & ((T)1 << i))
+        cl_uchar bytes[256];
+        ReverseTable()
         {
-            result |= ((T)1 << (count - i - 1));
+            for (int i = 0; i < 256; i++)
+            {
+                bytes[i] = 0;
+                for (int bit = 0; bit < 8; bit++)
+                    if (i & (1 << bit)) bytes[i] |= 1 << (7 - bit);
+            }
         }
-    }
-    return result;
+    } table;
+    return table.bytes[b];
+}
+
+template <typename T> static T cpu_bit_reverse(T base)
+{
+    typedef typename std::make_unsigned<T>::type unsigned_t;
+
+    // Reverse the order of the bytes and the bits of each
+    unsigned_t x = static_cast<unsigned_t>(base);
+    cl_ulong result = 0;
+    for (size_t i = 0; i < sizeof(T); i++, x >>= 8)
+        result = (result << 8) | reverse_byte(static_cast<cl_uchar>(x));
+    return static_cast<T>(result);
 }
 
 template <typename T>
@@ -87,6 +104,10 @@ static int test_vectype(cl_device_id device, cl_context context,
     const size_t ELEMENTS_TO_TEST = 65536;
     std::vector<T> base(ELEMENTS_TO_TEST * N);
     fill_vector_with_random_data(base);
+    // Every value of the 8- and 16-bit types
+    if (gExhaustiveBitOps && sizeof(T) <= 2)
+        for (size_t i = 0; i < base.size(); i++)
+            base[i] = static_cast<T>(i);
 
     std::vector<T> reference;
     calculate_reference(reference, base);
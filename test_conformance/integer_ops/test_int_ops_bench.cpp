@@ -0,0 +1,225 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "procs.h"
+#include "harness/benchmark.h"
+#include "harness/perfMetrics.h"
+
+// Each work item runs a chain of OPS_PER_ITEM steps on a uintN, each step
+// feeding the next so the compiler can't hoist or fold them. The
+// multiplies are masked back to 24 bits after every step so that mul24 and
+// mad24 always see in-range operands and give the same results as the full
+// multiply; the popcount chains add the count back into x. A benchmark, so it
+// only runs when named.
+static const char *int_ops_bench_kernel_code = R"CLC(
+TYPE bench_step(TYPE x, TYPE y, TYPE z)
+{
+#if VARIANT == 0
+    return mul24(x, y) & 0xffffffU;
+#elif VARIANT == 1
+    return (x * y) & 0xffffffU;
+#elif VARIANT == 2
+    return mad24(x, y, z) & 0xffffffU;
+#elif VARIANT == 3
+    return (x * y + z) & 0xffffffU;
+#elif VARIANT == 4
+    return x + popcount(x ^ y);
+#else
+    TYPE v = x ^ y;
+    v = v - ((v >> 1) & 0x55555555U);
+    v = (v & 0x33333333U) + ((v >> 2) & 0x33333333U);
+    v = (((v + (v >> 4)) & 0x0f0f0f0fU) * 0x01010101U) >> 24;
+    return x + v;
+#endif
+}
+
+__kernel void bench_int_op(__global TYPE *dst, __global const TYPE *srcA,
+                           __global const TYPE *srcB)
+{
+    size_t tid = get_global_id(0);
+    TYPE x = srcA[tid];
+    TYPE y = srcB[tid];
+    TYPE z = y >> 1;
+    for (int i = 0; i < OPS_PER_ITEM; i++) x = bench_step(x, y, z);
+    dst[tid] = x;
+}
+)CLC";
+
+namespace {
+
+const size_t kBenchElements = 256 * 1024;
+const int kOpsPerItem = 128;
+const size_t kMaxLocalSize = 256;
+const int kBenchVectorSizes[] = { 1, 2, 4, 8, 16 };
+
+struct IntOpBenchVariant
+{
+    const char *name;
+    // The variant this one is reported relative to
+    int baseline;
+};
+
+// Indexed by the VARIANT the kernel is built with
+const IntOpBenchVariant kIntOpBenchVariants[] = {
+    { "mul24", 1 },    { "mul", 1 },
+    { "mad24", 3 },    { "mad", 3 },
+    { "popcount", 5 }, { "popcount_bit_trick", 5 },
+};
+
+std::string type_name(int vectorSize)
+{
+    return vectorSize > 1 ? "uint" + std::to_string(vectorSize) : "uint";
+}
+
+cl_uint reference_step(int variant, cl_uint x, cl_uint y, cl_uint z)
+{
+    switch (variant)
+    {
+        case 0:
+        case 1: return (x * y) & 0xffffffU;
+        case 2:
+        case 3: return (x * y + z) & 0xffffffU;
+        default: {
+            cl_uint v = x ^ y, count = 0;
+            for (; v; v &= v - 1) count++;
+            return x + count;
+        }
+    }
+}
+
+// Sample the kernel of variant on queue, which has profiling enabled, and
+// check the results it gives
+int time_int_op(cl_device_id device, cl_context context,
+                cl_command_queue queue, int variant, int vectorSize,
+                const std::vector<cl_uint> &a, const std::vector<cl_uint> &b,
+                BenchmarkStats *stats)
+{
+    std::string options = "-DTYPE=" + type_name(vectorSize)
+        + " -DVARIANT=" + std::to_string(variant)
+        + " -DOPS_PER_ITEM=" + std::to_string(kOpsPerItem);
+
+    clProgramWrapper program;
+    clKernelWrapper kernel;
+    int err = create_single_kernel_helper(context, &program, &kernel, 1,
+                                          &int_ops_bench_kernel_code,
+                                          "bench_int_op", options.c_str());
+    test_error(err, "Unable to create bench kernel");
+
+    size_t bytes = a.size() * sizeof(cl_uint);
+    clMemWrapper dst =
+        clCreateBuffer(context, CL_MEM_WRITE_ONLY, bytes, NULL, &err);
+    test_error(err, "Unable to create output buffer");
+    clMemWrapper srcA = clCreateBuffer(context, CL_MEM_COPY_HOST_PTR, bytes,
+                                       (void *)a.data(), &err);
+    test_error(err, "Unable to create srcA buffer");
+    clMemWrapper srcB = clCreateBuffer(context, CL_MEM_COPY_HOST_PTR, bytes,
+                                       (void *)b.data(), &err);
+    test_error(err, "Unable to create srcB buffer");
+
+    err = clSetKernelArg(kernel, 0, sizeof(dst), &dst);
+    err |= clSetKernelArg(kernel, 1, sizeof(srcA), &srcA);
+    err |= clSetKernelArg(kernel, 2, sizeof(srcB), &srcB);
+    test_error(err, "Unable to set bench kernel args");
+
+    size_t global = a.size() / vectorSize;
+    size_t local;
+    err = get_max_allowed_1d_work_group_size_on_device(device, kernel, &local);
+    test_error(err, "Unable to get the work-group size");
+    local = std::min(local, kMaxLocalSize);
+    while (global % local) local--;
+
+    BenchmarkOptions benchOptions;
+    benchOptions.warmup = 1;
+    benchOptions.maxSeconds = 1.0;
+    err = benchmark_1d_kernel(queue, kernel, global, local, benchOptions,
+                              stats);
+    test_error(err, "Unable to time bench kernel");
+
+    std::vector<cl_uint> results(a.size());
+    err = clEnqueueReadBuffer(queue, dst, CL_TRUE, 0, bytes, results.data(),
+                              0, NULL, NULL);
+    test_error(err, "Unable to read bench results");
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        cl_uint x = a[i];
+        for (int n = 0; n < kOpsPerItem; n++)
+            x = reference_step(variant, x, b[i], b[i] >> 1);
+        if (results[i] != x)
+        {
+            log_error("%s %s element %zu is 0x%08x, expected 0x%08x\n",
+                      kIntOpBenchVariants[variant].name,
+                      type_name(vectorSize).c_str(), i, results[i], x);
+            return TEST_FAIL;
+        }
+    }
+    return TEST_PASS;
+}
+
+} // anonymous namespace
+
+int test_integer_mul24_popcount_bench(cl_device_id device, cl_context context,
+                                      cl_command_queue queue, int n_elems)
+{
+    int err;
+    clCommandQueueWrapper profilingQueue = clCreateCommandQueue(
+        context, device, CL_QUEUE_PROFILING_ENABLE, &err);
+    test_error(err, "Unable to create profiling queue");
+
+    // Operands stay within 24 bits so that mul24 and mad24 are defined
+    MTdataHolder d(gRandomSeed);
+    std::vector<cl_uint> a(kBenchElements), b(kBenchElements);
+    for (size_t i = 0; i < kBenchElements; i++)
+    {
+        a[i] = genrand_int32(d) & 0xffffffU;
+        b[i] = genrand_int32(d) & 0xffffffU;
+    }
+
+    const int variantCount = (int)ARRAY_SIZE(kIntOpBenchVariants);
+    log_info("Each of the %zu elements goes through %d steps\n",
+             kBenchElements, kOpsPerItem);
+    log_benchmark_header("int_ops", "function/type");
+    for (int vectorSize : kBenchVectorSizes)
+    {
+        std::vector<BenchmarkStats> stats(variantCount);
+        for (int variant = 0; variant < variantCount; variant++)
+        {
+            int ret = time_int_op(device, context, profilingQueue, variant,
+                                  vectorSize, a, b, &stats[variant]);
+            if (ret != TEST_PASS) return ret;
+        }
+
+        for (int variant = 0; variant < variantCount; variant++)
+        {
+            std::string label =
+                std::string(kIntOpBenchVariants[variant].name) + "/"
+                + type_name(vectorSize);
+            log_benchmark_stats("int_ops", label.c_str(), "ns", false,
+                                stats[variant]);
+            const BenchmarkStats &baseline =
+                stats[kIntOpBenchVariants[variant].baseline];
+            if (stats[variant].median > 0)
+                record_perf_metric("int_ops_relative_to_baseline." + label,
+                                   baseline.median / stats[variant].median,
+                                   "ratio", true);
+        }
+    }
+
+    return TEST_PASS;
+}
@@ -23,6 +23,8 @@
 #include "procs.h"
 #include "harness/integer_ops_test_info.h"
 #include "harness/testHarness.h"
+#include "harness/benchmark.h"
+#include "harness/perfMetrics.h"
 
 template <size_t N, typename DstType, typename SrcTypeA, typename SrcTypeB>
 static void
@@ -440,3 +442,222 @@ int test_integer_dot_product(cl_device_id deviceID, cl_context context,
 
     return result;
 }
+
+// Each work item chains kDotsPerItem dot products of 4x8-bit values, feeding
+// every result back into the next input so the compiler can't hoist or fold
+// them. The same chain is written with the packed built-in, the vector
+// built-in and a plain widening multiply-add, so the times are comparable. A
+// benchmark, so it only runs when named.
+static constexpr const char* kernel_source_dot_bench = R"CLC(
+#if SIGNED
+#define DOT_PACKED dot_4x8packed_ss_int
+#define AS_VEC as_char4
+#define CONVERT_WIDE convert_int4
+typedef int4 wide_t;
+#else
+#define DOT_PACKED dot_4x8packed_uu_uint
+#define AS_VEC as_uchar4
+#define CONVERT_WIDE convert_uint4
+typedef uint4 wide_t;
+#endif
+
+uint dot_step(uint x, uint y)
+{
+#if VARIANT == 0
+    return (uint)DOT_PACKED(x, y);
+#elif VARIANT == 1
+    return (uint)dot(AS_VEC(x), AS_VEC(y));
+#else
+    wide_t p = CONVERT_WIDE(AS_VEC(x)) * CONVERT_WIDE(AS_VEC(y));
+    return (uint)(p.x + p.y + p.z + p.w);
+#endif
+}
+
+__kernel void bench_dot(__global uint* dst, __global const uint* a,
+                        __global const uint* b)
+{
+    size_t gid = get_global_id(0);
+    uint x = a[gid];
+    uint y = b[gid];
+    uint acc = 0;
+    for (int i = 0; i < DOTS_PER_ITEM; i++)
+    {
+        acc += dot_step(x, y);
+        x += acc;
+    }
+    dst[gid] = acc;
+}
+)CLC";
+
+namespace {
+
+const size_t kBenchItems = 256 * 1024;
+const int kDotsPerItem = 256;
+const size_t kMaxLocalSize = 256;
+
+struct DotBenchVariant
+{
+    const char* name;
+    int variant;
+    cl_device_integer_dot_product_capabilities_khr requiredCap;
+};
+
+const DotBenchVariant kDotBenchVariants[] = {
+    { "mul_add", 2, 0 },
+    { "dot_4x8packed", 0,
+      CL_DEVICE_INTEGER_DOT_PRODUCT_INPUT_4x8BIT_PACKED_KHR },
+    { "dot", 1, CL_DEVICE_INTEGER_DOT_PRODUCT_INPUT_4x8BIT_KHR },
+};
+
+// The chain bench_dot computes for one work item
+cl_uint reference_dot_chain(cl_uint x, cl_uint y, bool isSigned)
+{
+    cl_uint acc = 0;
+    for (int i = 0; i < kDotsPerItem; i++)
+    {
+        cl_int sum = 0;
+        for (int c = 0; c < 4; c++)
+        {
+            cl_int xc = (x >> (8 * c)) & 0xFF;
+            cl_int yc = (y >> (8 * c)) & 0xFF;
+            if (isSigned)
+            {
+                xc = (cl_char)xc;
+                yc = (cl_char)yc;
+            }
+            sum += xc * yc;
+        }
+        acc += (cl_uint)sum;
+        x += acc;
+    }
+    return acc;
+}
+
+// Sample the kernel of variant on queue, which has profiling enabled, and
+// check the results it gives
+int time_dot_variant(cl_device_id deviceID, cl_context context,
+                     cl_command_queue queue, const DotBenchVariant& variant,
+                     bool isSigned, const std::vector<cl_uint>& a,
+                     const std::vector<cl_uint>& b, BenchmarkStats* stats)
+{
+    std::string buildOptions = " -DVARIANT=" + std::to_string(variant.variant)
+        + " -DSIGNED=" + (isSigned ? "1" : "0")
+        + " -DDOTS_PER_ITEM=" + std::to_string(kDotsPerItem);
+
+    clProgramWrapper program;
+    clKernelWrapper kernel;
+    const char* source = kernel_source_dot_bench;
+    cl_int error =
+        create_single_kernel_helper(context, &program, &kernel, 1, &source,
+                                    "bench_dot", buildOptions.c_str());
+    test_error(error, "Unable to create bench kernel");
+
+    clMemWrapper dst = clCreateBuffer(context, CL_MEM_WRITE_ONLY,
+                                      a.size() * sizeof(cl_uint), NULL, &error);
+    test_error(error, "Unable to create output buffer");
+    clMemWrapper srcA =
+        clCreateBuffer(context, CL_MEM_COPY_HOST_PTR,
+                       a.size() * sizeof(cl_uint), (void*)a.data(), &error);
+    test_error(error, "Unable to create srcA buffer");
+    clMemWrapper srcB =
+        clCreateBuffer(context, CL_MEM_COPY_HOST_PTR,
+                       b.size() * sizeof(cl_uint), (void*)b.data(), &error);
+    test_error(error, "Unable to create srcB buffer");
+
+    error = clSetKernelArg(kernel, 0, sizeof(dst), &dst);
+    error |= clSetKernelArg(kernel, 1, sizeof(srcA), &srcA);
+    error |= clSetKernelArg(kernel, 2, sizeof(srcB), &srcB);
+    test_error(error, "Unable to set bench kernel args");
+
+    size_t local;
+    error = get_max_allowed_1d_work_group_size_on_device(deviceID, kernel,
+                                                         &local);
+    test_error(error, "Unable to get the work-group size");
+    local = std::min(local, kMaxLocalSize);
+    while (a.size() % local) local--;
+
+    BenchmarkOptions options;
+    options.warmup = 1;
+    options.maxSeconds = 1.0;
+    error = benchmark_1d_kernel(queue, kernel, a.size(), local, options, stats);
+    test_error(error, "Unable to time bench kernel");
+
+    std::vector<cl_uint> results(a.size());
+    error = clEnqueueReadBuffer(queue, dst, CL_TRUE, 0,
+                                results.size() * sizeof(cl_uint),
+                                results.data(), 0, NULL, NULL);
+    test_error(error, "Unable to read bench results");
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        cl_uint expected = reference_dot_chain(a[i], b[i], isSigned);
+        if (results[i] != expected)
+        {
+            log_error("%s (%s) item %zu is 0x%08x, expected 0x%08x\n",
+                      variant.name, isSigned ? "signed" : "unsigned", i,
+                      results[i], expected);
+            return TEST_FAIL;
+        }
+    }
+    return TEST_PASS;
+}
+
+} // anonymous namespace
+
+int test_integer_dot_product_bench(cl_device_id deviceID, cl_context context,
+                                   cl_command_queue queue, int num_elements)
+{
+    if (!is_extension_available(deviceID, "cl_khr_integer_dot_product"))
+    {
+        log_info("cl_khr_integer_dot_product is not supported\n");
+        return TEST_SKIPPED_ITSELF;
+    }
+
+    cl_device_integer_dot_product_capabilities_khr dotCaps = 0;
+    cl_int error = clGetDeviceInfo(
+        deviceID, CL_DEVICE_INTEGER_DOT_PRODUCT_CAPABILITIES_KHR,
+        sizeof(dotCaps), &dotCaps, NULL);
+    test_error(
+        error,
+        "Unable to query CL_DEVICE_INTEGER_DOT_PRODUCT_CAPABILITIES_KHR");
+
+    std::vector<cl_uint> a(kBenchItems), b(kBenchItems);
+    fill_vector_with_random_data(a);
+    fill_vector_with_random_data(b);
+
+    clCommandQueueWrapper profilingQueue = clCreateCommandQueue(
+        context, deviceID, CL_QUEUE_PROFILING_ENABLE, &error);
+    test_error(error, "Unable to create profiling queue");
+
+    log_info("Each of the %zu work-items makes %d dot products\n",
+             kBenchItems, kDotsPerItem);
+    log_benchmark_header("integer_dot_product", "function/inputs");
+    for (bool isSigned : { false, true })
+    {
+        double mulAddNs = 0;
+        for (const DotBenchVariant& variant : kDotBenchVariants)
+        {
+            if ((dotCaps & variant.requiredCap) != variant.requiredCap)
+            {
+                log_info("%s is not supported, skipping\n", variant.name);
+                continue;
+            }
+
+            BenchmarkStats stats;
+            int ret = time_dot_variant(deviceID, context, profilingQueue,
+                                       variant, isSigned, a, b, &stats);
+            if (ret != TEST_PASS) return ret;
+            if (variant.requiredCap == 0) mulAddNs = stats.median;
+
+            std::string label = std::string(variant.name) + "/"
+                + (isSigned ? "signed" : "unsigned");
+            log_benchmark_stats("integer_dot_product", label.c_str(), "ns",
+                                false, stats);
+            if (stats.median > 0)
+                record_perf_metric("integer_dot_product_relative_to_mul_add."
+                                       + label,
+                                   mulAddNs / stats.median, "ratio", true);
+        }
+    }
+
+    return TEST_PASS;
+}
@@ -18,9 +18,67 @@
 
 #include <algorithm>
 #include <cinttypes>
+#include <vector>
 
 #define TEST_SIZE 512
 
+// 8 and 16 bit types are small enough to test every input value, and for 8
+// bit binary functions every pair of inputs, in a single dispatch instead of
+// random samples. Returns the number of inputs to test, or 0 if the domain
+// is too large.
+static size_t exhaustive_domain_size(ExplicitType typeA, ExplicitType typeB)
+{
+    size_t sizeA = get_explicit_type_size(typeA);
+    if (typeB == kNumExplicitTypes)
+    {
+        if (sizeA == 1) return 1 << 8;
+        if (sizeA == 2) return 1 << 16;
+        return 0;
+    }
+    if (sizeA == 1 && get_explicit_type_size(typeB) == 1) return 1 << 16;
+    return 0;
+}
+
+// Stores bits into element i of an 8 or 16 bit array
+static void store_domain_value(ExplicitType type, void *data, size_t i,
+                               cl_uint bits)
+{
+    if (get_explicit_type_size(type) == 1)
+        ((cl_uchar *)data)[i] = (cl_uchar)bits;
+    else
+        ((cl_ushort *)data)[i] = (cl_ushort)bits;
+}
+
+// Fills count elements with the whole input domain, repeating it if count
+// isn't a multiple of the domain size. For a pair of 8 bit inputs the low
+// byte of the element index goes to A and the high byte to B.
+static void generate_exhaustive_data(ExplicitType typeA, void *dataA,
+                                     ExplicitType typeB, void *dataB,
+                                     size_t domain, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        cl_uint value = (cl_uint)(i % domain);
+        if (typeB == kNumExplicitTypes)
+        {
+            store_domain_value(typeA, dataA, i, value);
+        }
+        else
+        {
+            store_domain_value(typeA, dataA, i, value & 0xff);
+            store_domain_value(typeB, dataB, i, value >> 8);
+        }
+    }
+}
+
+// Number of elements to test with vectors of vecSize: TEST_SIZE vectors, or
+// the exhaustive domain rounded up to whole vectors.
+static size_t get_test_element_count(size_t domain, size_t vecSize)
+{
+    if (domain == 0) return TEST_SIZE * vecSize;
+    return (domain + vecSize - 1) / vecSize * vecSize;
+}
+
 const char *singleParamIntegerKernelSourcePattern =
 "__kernel void sample_test(__global %s *sourceA, __global %s *destValues)\n"
 "{\n"
@@ -50,7 +108,7 @@ int test_single_param_integer_kernel(cl_command_queue queue, cl_context context,
     clProgramWrapper program;
     clKernelWrapper kernel;
     clMemWrapper streams[2];
-    cl_long inDataA[TEST_SIZE * 16], outData[TEST_SIZE * 16], inDataB[TEST_SIZE * 16], expected;
+    cl_long expected;
     int error, i;
     size_t threads[1], localThreads[1];
     char kernelSource[10240];
@@ -63,6 +121,11 @@ int test_single_param_integer_kernel(cl_command_queue queue, cl_context context,
        return CL_SUCCESS;
     }
 
+    size_t domain = exhaustive_domain_size(vecType, kNumExplicitTypes);
+    size_t count = get_test_element_count(domain, vecSize);
+    size_t bufferSize = get_explicit_type_size(vecType) * count;
+    std::vector<cl_long> inDataA(count), outData(count), inDataB(count);
+
     /* Create the source */
     if( vecSize == 1 )
         sizeName[ 0 ] = 0;
@@ -90,11 +153,14 @@ int test_single_param_integer_kernel(cl_command_queue queue, cl_context context,
     }
 
     /* Generate some streams */
-    generate_random_data( vecType, vecSize * TEST_SIZE, d, inDataA );
+    if (domain)
+        generate_exhaustive_data(vecType, inDataA.data(), kNumExplicitTypes,
+                                 NULL, domain, count);
+    else
+        generate_random_data(vecType, count, d, inDataA.data());
 
-    streams[0] = clCreateBuffer(
-        context, CL_MEM_COPY_HOST_PTR,
-        get_explicit_type_size(vecType) * vecSize * TEST_SIZE, inDataA, NULL);
+    streams[0] = clCreateBuffer(context, CL_MEM_COPY_HOST_PTR, bufferSize,
+                                inDataA.data(), NULL);
     if( streams[0] == NULL )
     {
         log_error("ERROR: Creating input array A failed!\n");
@@ -104,12 +170,11 @@ int test_single_param_integer_kernel(cl_command_queue queue, cl_context context,
     if( useOpKernel )
     {
         // Op kernels use an r/w buffer for the second param, so we need to init it with data
-        generate_random_data( vecType, vecSize * TEST_SIZE, d, inDataB );
+        generate_random_data(vecType, count, d, inDataB.data());
     }
     streams[1] = clCreateBuffer(
         context, (CL_MEM_READ_WRITE | (useOpKernel ? CL_MEM_COPY_HOST_PTR : 0)),
-        get_explicit_type_size(vecType) * vecSize * TEST_SIZE,
-        (useOpKernel) ? &inDataB : NULL, NULL);
+        bufferSize, (useOpKernel) ? inDataB.data() : NULL, NULL);
     if( streams[1] == NULL )
     {
         log_error("ERROR: Creating output array failed!\n");
@@ -123,7 +188,7 @@ int test_single_param_integer_kernel(cl_command_queue queue, cl_context context,
     test_error( error, "Unable to set indexed kernel arguments" );
 
     /* Run the kernel */
-    threads[0] = TEST_SIZE;
+    threads[0] = count / vecSize;
 
     error = get_max_common_work_group_size( context, kernel, threads[0], &localThreads[0] );
     test_error( error, "Unable to get work group size to use" );
@@ -131,23 +196,23 @@ int test_single_param_integer_kernel(cl_command_queue queue, cl_context context,
     error = clEnqueueNDRangeKernel( queue, kernel, 1, NULL, threads, localThreads, 0, NULL, NULL );
     test_error( error, "Unable to execute test kernel" );
 
-    memset(outData, 0xFF, get_explicit_type_size( vecType ) * TEST_SIZE * vecSize );
+    memset(outData.data(), 0xFF, bufferSize);
 
     /* Now get the results */
-    error = clEnqueueReadBuffer( queue, streams[1], CL_TRUE, 0,
-                                 get_explicit_type_size( vecType ) * TEST_SIZE * vecSize,
-                                 outData, 0, NULL, NULL );
+    error = clEnqueueReadBuffer(queue, streams[1], CL_TRUE, 0, bufferSize,
+                                outData.data(), 0, NULL, NULL);
     test_error( error, "Unable to read output array!" );
 
     // deal with division by 0 -- any answer is allowed here
     if( verifyFn == verify_integer_divideAssign || verifyFn == verify_integer_moduloAssign )
-        patchup_divide_results( outData, inDataA, inDataB, TEST_SIZE * vecSize, vecType );
+        patchup_divide_results(outData.data(), inDataA.data(), inDataB.data(),
+                               count, vecType);
 
     /* And verify! */
-    char *p = (char *)outData;
-    char *in = (char *)inDataA;
-    char *in2 = (char *)inDataB;
-    for( i = 0; i < (int)TEST_SIZE; i++ )
+    char *p = (char *)outData.data();
+    char *in = (char *)inDataA.data();
+    char *in2 = (char *)inDataB.data();
+    for (i = 0; i < (int)(count / vecSize); i++)
     {
         for( size_t j = 0; j < vecSize; j++ )
         {
@@ -625,7 +690,7 @@ int test_two_param_integer_kernel(cl_command_queue queue, cl_context context, co
     clProgramWrapper program;
     clKernelWrapper kernel;
     clMemWrapper streams[3];
-    cl_long inDataA[TEST_SIZE * 16], inDataB[TEST_SIZE * 16], outData[TEST_SIZE * 16], expected;
+    cl_long expected;
     int error, i;
     size_t threads[1], localThreads[1];
     char kernelSource[10240];
@@ -639,6 +704,12 @@ int test_two_param_integer_kernel(cl_command_queue queue, cl_context context, co
        return CL_SUCCESS;
     }
 
+    size_t domain = exhaustive_domain_size(vecAType, vecBType);
+    size_t count = get_test_element_count(domain, vecSize);
+    size_t bufferASize = get_explicit_type_size(vecAType) * count;
+    size_t bufferBSize = get_explicit_type_size(vecBType) * count;
+    std::vector<cl_long> inDataA(count), inDataB(count), outData(count);
+
     /* Create the source */
     if( vecSize == 1 )
         sizeName[ 0 ] = 0;
@@ -671,28 +742,33 @@ int test_two_param_integer_kernel(cl_command_queue queue, cl_context context, co
     }
 
     /* Generate some streams */
-    generate_random_data( vecAType, vecSize * TEST_SIZE, d, inDataA );
-    generate_random_data( vecBType, vecSize * TEST_SIZE, d, inDataB );
+    if (domain)
+    {
+        generate_exhaustive_data(vecAType, inDataA.data(), vecBType,
+                                 inDataB.data(), domain, count);
+    }
+    else
+    {
+        generate_random_data(vecAType, count, d, inDataA.data());
+        generate_random_data(vecBType, count, d, inDataB.data());
+    }
 
-    streams[0] = clCreateBuffer(
-        context, CL_MEM_COPY_HOST_PTR,
-        get_explicit_type_size(vecAType) * vecSize * TEST_SIZE, &inDataA, NULL);
+    streams[0] = clCreateBuffer(context, CL_MEM_COPY_HOST_PTR, bufferASize,
+                                inDataA.data(), NULL);
     if( streams[0] == NULL )
     {
         log_error("ERROR: Creating input array A failed!\n");
         return -1;
     }
-    streams[1] = clCreateBuffer(
-        context, CL_MEM_COPY_HOST_PTR,
-        get_explicit_type_size(vecBType) * vecSize * TEST_SIZE, &inDataB, NULL);
+    streams[1] = clCreateBuffer(context, CL_MEM_COPY_HOST_PTR, bufferBSize,
+                                inDataB.data(), NULL);
     if( streams[1] == NULL )
     {
         log_error("ERROR: Creating input array B failed!\n");
         return -1;
     }
-    streams[2] = clCreateBuffer(
-        context, CL_MEM_READ_WRITE,
-        get_explicit_type_size(vecAType) * vecSize * TEST_SIZE, NULL, NULL);
+    streams[2] = clCreateBuffer(context, CL_MEM_READ_WRITE, bufferASize, NULL,
+                                NULL);
     if( streams[2] == NULL )
     {
         log_error("ERROR: Creating output array failed!\n");
@@ -708,7 +784,7 @@ int test_two_param_integer_kernel(cl_command_queue queue, cl_context context, co
     test_error( error, "Unable to set indexed kernel arguments" );
 
     /* Run the kernel */
-    threads[0] = TEST_SIZE;
+    threads[0] = count / vecSize;
 
     error = get_max_common_work_group_size( context, kernel, threads[0], &localThreads[0] );
     test_error( error, "Unable to get work group size to use" );
@@ -716,19 +792,18 @@ int test_two_param_integer_kernel(cl_command_queue queue, cl_context context, co
     error = clEnqueueNDRangeKernel( queue, kernel, 1, NULL, threads, localThreads, 0, NULL, NULL );
     test_error( error, "Unable to execute test kernel" );
 
-    memset(outData, 0xFF, get_explicit_type_size( vecAType ) * TEST_SIZE * vecSize);
+    memset(outData.data(), 0xFF, bufferASize);
 
     /* Now get the results */
-    error = clEnqueueReadBuffer( queue, streams[2], CL_TRUE, 0,
-                                 get_explicit_type_size( vecAType ) * TEST_SIZE * vecSize, outData, 0,
-                                 NULL, NULL );
+    error = clEnqueueReadBuffer(queue, streams[2], CL_TRUE, 0, bufferASize,
+                                outData.data(), 0, NULL, NULL);
     test_error( error, "Unable to read output array!" );
 
     /* And verify! */
-    char *inA = (char *)inDataA;
-    char *inB = (char *)inDataB;
-    char *out = (char *)outData;
-    for( i = 0; i < (int)TEST_SIZE; i++ )
+    char *inA = (char *)inDataA.data();
+    char *inB = (char *)inDataB.data();
+    char *out = (char *)outData.data();
+    for (i = 0; i < (int)(count / vecSize); i++)
     {
         for( size_t j = 0; j < vecSize; j++ )
         {
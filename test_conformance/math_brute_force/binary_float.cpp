@@ -16,6 +16,8 @@
 
 #include "common.h"
 #include "function_list.h"
+#include "reference_math.h"
+#include "shard.h"
 #include "test_functions.h"
 #include "utility.h"
 
@@ -227,7 +229,7 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
         }
     }
 
-    cl_event e[VECTOR_SIZE_COUNT];
+    clEventWrapper mapped;
     cl_uint *out[VECTOR_SIZE_COUNT];
     if (gHostFill)
     {
@@ -236,7 +238,7 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
         {
             out[j] = (cl_uint *)clEnqueueMapBuffer(
                 tinfo->tQueue, tinfo->outBuf[j], CL_FALSE, CL_MAP_WRITE, 0,
-                buffer_size, 0, NULL, e + j, &error);
+                buffer_size, 0, NULL, NULL, &error);
             if (error || NULL == out[j])
             {
                 vlog_error("Error: clEnqueueMapBuffer %d failed! err: %d\n", j,
@@ -245,6 +247,14 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
             }
         }
 
+        // One event for all the maps rather than one each
+        if ((error = enqueue_chain_end(tinfo->tQueue, &mapped)))
+        {
+            vlog_error("Error: clEnqueueMarkerWithWaitList failed! err: %d\n",
+                       error);
+            return error;
+        }
+
         // Get that moving
         if ((error = clFlush(tinfo->tQueue))) vlog("clFlush failed\n");
     }
@@ -280,22 +290,33 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
         }
     }
 
-    // Init any remaining values
-    for (; idx < buffer_elements; idx++)
+    // Init any remaining values, with device random input from the streams
+    // of the job, of which the device generates its own copy
+    cl_ulong index = 2 * (cl_ulong)job_id * buffer_elements;
+    cl_ulong index2 = index + buffer_elements;
+    if (device_random_enabled())
     {
-        p[idx] = genrand_int32(d);
-        p2[idx] = genrand_int32(d);
+        fill_random_input(p, idx, buffer_elements, index);
+        fill_random_input(p2, idx, buffer_elements, index2);
+    }
+    else
+    {
+        for (; idx < buffer_elements; idx++)
+        {
+            p[idx] = genrand_int32(d);
+            p2[idx] = genrand_int32(d);
+        }
     }
 
-    if ((error = clEnqueueWriteBuffer(tinfo->tQueue, tinfo->inBuf, CL_FALSE, 0,
-                                      buffer_size, p, 0, NULL, NULL)))
+    if ((error = write_random_input(tinfo->tQueue, tinfo->inBuf, p, idx,
+                                    buffer_elements, index)))
     {
         vlog_error("Error: clEnqueueWriteBuffer failed! err: %d\n", error);
         return error;
     }
 
-    if ((error = clEnqueueWriteBuffer(tinfo->tQueue, tinfo->inBuf2, CL_FALSE, 0,
-                                      buffer_size, p2, 0, NULL, NULL)))
+    if ((error = write_random_input(tinfo->tQueue, tinfo->inBuf2, p2, idx,
+                                    buffer_elements, index2)))
     {
         vlog_error("Error: clEnqueueWriteBuffer failed! err: %d\n", error);
         return error;
@@ -303,19 +324,14 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
 
     for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
     {
-        if (gHostFill)
+        if (gHostFill && j == gMinVectorSizeIndex)
         {
-            // Wait for the map to finish
-            if ((error = clWaitForEvents(1, e + j)))
+            // Wait for the maps to finish
+            if ((error = clWaitForEvents(1, &mapped)))
             {
                 vlog_error("Error: clWaitForEvents failed! err: %d\n", error);
                 return error;
             }
-            if ((error = clReleaseEvent(e[j])))
-            {
-                vlog_error("Error: clReleaseEvent failed! err: %d\n", error);
-                return error;
-            }
         }
 
         // Fill the result buffer with garbage, so that old results don't carry
@@ -391,43 +407,45 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
         return CL_SUCCESS;
     }
 
-    FPU_mode_type oldMode;
+    // Set the rounding mode to match the device
     oldRoundMode = kRoundToNearestEven;
-    if (isFDim)
-    {
-        // Calculate the correctly rounded reference result
-        memset(&oldMode, 0, sizeof(oldMode));
-        if (ftz || relaxedMode) ForceFTZ(&oldMode);
-
-        // Set the rounding mode to match the device
-        if (gIsInRTZMode) oldRoundMode = set_round(kRoundTowardZero, kfloat);
-    }
+    if (isFDim && gIsInRTZMode)
+        oldRoundMode = set_round(kRoundTowardZero, kfloat);
 
     if (!strcmp(name, "copysign")) copysign_test = 1;
 
 #define ref_func(s, s2) (copysign_test ? func.f_ff_f(s, s2) : func.f_ff(s, s2))
 
-    // Calculate the correctly rounded reference result
+    // Calculate the correctly rounded reference result, for fdim in FTZ mode
+    // if the device flushes
     r = (float *)gOut_Ref + thread_id * buffer_elements;
     s = (float *)gIn + thread_id * buffer_elements;
     s2 = (float *)gIn2 + thread_id * buffer_elements;
-    if (skipNanInf)
     {
-        for (size_t j = 0; j < buffer_elements; j++)
+        FPStateGuard ftzGuard(isFDim && (ftz || relaxedMode) ? kForceFTZ
+                                                             : kKeepFTZ);
+        if (skipNanInf)
         {
-            feclearexcept(FE_OVERFLOW);
-            r[j] = (float)ref_func(s[j], s2[j]);
-            overflow[j] =
-                FE_OVERFLOW == (FE_OVERFLOW & fetestexcept(FE_OVERFLOW));
+            for (size_t j = 0; j < buffer_elements; j++)
+            {
+                feclearexcept(FE_OVERFLOW);
+                r[j] = (float)ref_func(s[j], s2[j]);
+                overflow[j] =
+                    FE_OVERFLOW == (FE_OVERFLOW & fetestexcept(FE_OVERFLOW));
+            }
+        }
+        else
+        {
+            BatchReference_f_ff batchRef = copysign_test
+                ? GetBatchReference(func.f_ff_f)
+                : GetBatchReference(func.f_ff);
+            if (batchRef)
+                batchRef(r, s, s2, buffer_elements);
+            else
+                for (size_t j = 0; j < buffer_elements; j++)
+                    r[j] = (float)ref_func(s[j], s2[j]);
         }
     }
-    else
-    {
-        for (size_t j = 0; j < buffer_elements; j++)
-            r[j] = (float)ref_func(s[j], s2[j]);
-    }
-
-    if (isFDim && ftz) RestoreFPState(&oldMode);
 
     // Read the data back -- no need to wait for the first N-1 buffers but wait
     // for the last buffer. This is an in order queue.
@@ -451,6 +469,11 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
         t = (cl_uint *)r;
         for (size_t j = 0; j < buffer_elements; j++)
         {
+            // Skip the elements that match for every vector size, NaNs of
+            // any kind matching
+            j = FindFirstFloatMismatch(t, out, j, buffer_elements);
+            if (j == buffer_elements) break;
+
             for (auto k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++)
             {
                 cl_uint *q = out[k];
@@ -754,7 +777,7 @@ int TestFunc_Float_Float_Float(const Func *f, MTdata d, bool relaxedMode)
 
     // Init test_info
     test_info.threadCount = GetThreadCount();
-    test_info.subBufferSize = BUFFER_SIZE
+    test_info.subBufferSize = gBufferSize
         / (sizeof(cl_float) * RoundUpToNextPowerOfTwo(test_info.threadCount));
     test_info.scale = getTestScale(sizeof(cl_float));
 
@@ -842,7 +865,8 @@ int TestFunc_Float_Float_Float(const Func *f, MTdata d, bool relaxedMode)
     // Run the kernels
     if (!gSkipCorrectnessTesting)
     {
-        error = ThreadPool_Do(Test, test_info.jobCount, &test_info);
+        error = ThreadPool_DoShard(Test, test_info.jobCount, &test_info,
+                                   test_info.subBufferSize);
         if (error) return error;
 
         // Accumulate the arithmetic errors
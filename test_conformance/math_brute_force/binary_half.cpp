@@ -18,6 +18,7 @@
 
 #include "common.h"
 #include "function_list.h"
+#include "shard.h"
 #include "test_functions.h"
 #include "utility.h"
 #include "reference_math.h"
@@ -136,7 +137,7 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
     cl_int copysign_test = 0;
 
     // start the map of the output arrays
-    cl_event e[VECTOR_SIZE_COUNT];
+    clEventWrapper mapped;
     cl_ushort *out[VECTOR_SIZE_COUNT];
 
     if (gHostFill)
@@ -146,7 +147,7 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
         {
             out[j] = (cl_ushort *)clEnqueueMapBuffer(
                 tinfo->tQueue, tinfo->outBuf[j], CL_FALSE, CL_MAP_WRITE, 0,
-                buffer_size, 0, NULL, e + j, &error);
+                buffer_size, 0, NULL, NULL, &error);
             if (error || NULL == out[j])
             {
                 vlog_error("Error: clEnqueueMapBuffer %d failed! err: %d\n", j,
@@ -155,6 +156,14 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
             }
         }
 
+        // One event for all the maps rather than one each
+        if ((error = enqueue_chain_end(tinfo->tQueue, &mapped)))
+        {
+            vlog_error("Error: clEnqueueMarkerWithWaitList failed! err: %d\n",
+                       error);
+            return error;
+        }
+
         // Get that moving
         if ((error = clFlush(tinfo->tQueue))) vlog("clFlush failed\n");
     }
@@ -194,14 +203,14 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
         p2[j] = (cl_ushort)genrand_int32(d);
     }
 
-    if ((error = clEnqueueWriteBuffer(tinfo->tQueue, tinfo->inBuf, CL_FALSE, 0,
+    if ((error = enqueue_write_staged(tinfo->tQueue, tinfo->inBuf, CL_FALSE, 0,
                                       buffer_size, p, 0, NULL, NULL)))
     {
         vlog_error("Error: clEnqueueWriteBuffer failed! err: %d\n", error);
         return error;
     }
 
-    if ((error = clEnqueueWriteBuffer(tinfo->tQueue, tinfo->inBuf2, CL_FALSE, 0,
+    if ((error = enqueue_write_staged(tinfo->tQueue, tinfo->inBuf2, CL_FALSE, 0,
                                       buffer_size, p2, 0, NULL, NULL)))
     {
         vlog_error("Error: clEnqueueWriteBuffer failed! err: %d\n", error);
@@ -210,19 +219,14 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
 
     for (j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
     {
-        if (gHostFill)
+        if (gHostFill && j == gMinVectorSizeIndex)
         {
-            // Wait for the map to finish
-            if ((error = clWaitForEvents(1, e + j)))
+            // Wait for the maps to finish
+            if ((error = clWaitForEvents(1, &mapped)))
             {
                 vlog_error("Error: clWaitForEvents failed! err: %d\n", error);
                 return error;
             }
-            if ((error = clReleaseEvent(e[j])))
-            {
-                vlog_error("Error: clReleaseEvent failed! err: %d\n", error);
-                return error;
-            }
         }
 
         // Fill the result buffer with garbage, so that old results don't carry
@@ -285,39 +289,35 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
         return CL_SUCCESS;
     }
 
-    FPU_mode_type oldMode;
+    // Set the rounding mode to match the device
     oldRoundMode = kRoundToNearestEven;
-    if (isFDim)
-    {
-        // Calculate the correctly rounded reference result
-        memset(&oldMode, 0, sizeof(oldMode));
-        if (ftz) ForceFTZ(&oldMode);
-
-        // Set the rounding mode to match the device
-        if (gIsInRTZMode) oldRoundMode = set_round(kRoundTowardZero, kfloat);
-    }
+    if (isFDim && gIsInRTZMode)
+        oldRoundMode = set_round(kRoundTowardZero, kfloat);
 
     if (!strcmp(name, "copysign")) copysign_test = 1;
 
 #define ref_func(s, s2) (copysign_test ? func.f_ff_f(s, s2) : func.f_ff(s, s2))
 
-    // Calculate the correctly rounded reference result
+    // Calculate the correctly rounded reference result, for fdim in FTZ mode
+    // if the device flushes
     r = (cl_half *)gOut_Ref + thread_id * buffer_elements;
     t = (cl_ushort *)r;
     s.resize(buffer_elements);
     s2.resize(buffer_elements);
-    for (j = 0; j < buffer_elements; j++)
     {
-        s[j] = cl_half_to_float(p[j]);
-        s2[j] = cl_half_to_float(p2[j]);
-        if (isNextafter)
-            r[j] = cl_half_from_float(reference_nextafterh(s[j], s2[j]),
-                                      CL_HALF_RTE);
-        else
-            r[j] = cl_half_from_float(ref_func(s[j], s2[j]), CL_HALF_RTE);
+        FPStateGuard ftzGuard(isFDim && ftz ? kForceFTZ : kKeepFTZ);
+        for (j = 0; j < buffer_elements; j++)
+        {
+            s[j] = cl_half_to_float(p[j]);
+            s2[j] = cl_half_to_float(p2[j]);
+            if (isNextafter)
+                r[j] = cl_half_from_float(reference_nextafterh(s[j], s2[j]),
+                                          CL_HALF_RTE);
+            else
+                r[j] = cl_half_from_float(ref_func(s[j], s2[j]), CL_HALF_RTE);
+        }
     }
 
-    if (isFDim && ftz) RestoreFPState(&oldMode);
     // Read the data back -- no need to wait for the first N-1 buffers. This is
     // an in order queue.
     for (j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
@@ -658,7 +658,7 @@ int TestFunc_Half_Half_Half_common(const Func *f, MTdata d, int isNextafter,
     TestInfo test_info(test_info_base);
 
     test_info.threadCount = GetThreadCount();
-    test_info.subBufferSize = BUFFER_SIZE
+    test_info.subBufferSize = gBufferSize
         / (sizeof(cl_half) * RoundUpToNextPowerOfTwo(test_info.threadCount));
     test_info.scale = getTestScale(sizeof(cl_half));
 
@@ -745,7 +745,8 @@ int TestFunc_Half_Half_Half_common(const Func *f, MTdata d, int isNextafter,
     }
     if (!gSkipCorrectnessTesting)
     {
-        error = ThreadPool_Do(TestHalf, test_info.jobCount, &test_info);
+        error = ThreadPool_DoShard(TestHalf, test_info.jobCount, &test_info,
+                                   test_info.subBufferSize);
 
         // Accumulate the arithmetic errors
         for (cl_uint i = 0; i < test_info.threadCount; i++)
@@ -16,6 +16,7 @@
 
 #include "common.h"
 #include "function_list.h"
+#include "shard.h"
 #include "test_functions.h"
 #include "utility.h"
 
@@ -216,7 +217,7 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
     cl_float *s = 0;
     cl_int *s2 = 0;
 
-    cl_event e[VECTOR_SIZE_COUNT];
+    clEventWrapper mapped;
     cl_uint *out[VECTOR_SIZE_COUNT];
     if (gHostFill)
     {
@@ -225,7 +226,7 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
         {
             out[j] = (cl_uint *)clEnqueueMapBuffer(
                 tinfo->tQueue, tinfo->outBuf[j], CL_FALSE, CL_MAP_WRITE, 0,
-                buffer_size, 0, NULL, e + j, &error);
+                buffer_size, 0, NULL, NULL, &error);
             if (error || NULL == out[j])
             {
                 vlog_error("Error: clEnqueueMapBuffer %d failed! err: %d\n", j,
@@ -234,6 +235,14 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
             }
         }
 
+        // One event for all the maps rather than one each
+        if ((error = enqueue_chain_end(tinfo->tQueue, &mapped)))
+        {
+            vlog_error("Error: clEnqueueMarkerWithWaitList failed! err: %d\n",
+                       error);
+            return error;
+        }
+
         // Get that moving
         if ((error = clFlush(tinfo->tQueue))) vlog("clFlush failed\n");
     }
@@ -275,14 +284,14 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
         p2[idx] = genrand_int32(d);
     }
 
-    if ((error = clEnqueueWriteBuffer(tinfo->tQueue, tinfo->inBuf, CL_FALSE, 0,
+    if ((error = enqueue_write_staged(tinfo->tQueue, tinfo->inBuf, CL_FALSE, 0,
                                       buffer_size, p, 0, NULL, NULL)))
     {
         vlog_error("Error: clEnqueueWriteBuffer failed! err: %d\n", error);
         return error;
     }
 
-    if ((error = clEnqueueWriteBuffer(tinfo->tQueue, tinfo->inBuf2, CL_FALSE, 0,
+    if ((error = enqueue_write_staged(tinfo->tQueue, tinfo->inBuf2, CL_FALSE, 0,
                                       buffer_size, p2, 0, NULL, NULL)))
     {
         vlog_error("Error: clEnqueueWriteBuffer failed! err: %d\n", error);
@@ -291,19 +300,14 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
 
     for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
     {
-        if (gHostFill)
+        if (gHostFill && j == gMinVectorSizeIndex)
         {
-            // Wait for the map to finish
-            if ((error = clWaitForEvents(1, e + j)))
+            // Wait for the maps to finish
+            if ((error = clWaitForEvents(1, &mapped)))
             {
                 vlog_error("Error: clWaitForEvents failed! err: %d\n", error);
                 return error;
             }
-            if ((error = clReleaseEvent(e[j])))
-            {
-                vlog_error("Error: clReleaseEvent failed! err: %d\n", error);
-                return error;
-            }
         }
 
         // Fill the result buffer with garbage, so that old results don't carry
@@ -398,6 +402,10 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
     t = (cl_uint *)r;
     for (size_t j = 0; j < buffer_elements; j++)
     {
+        // Skip the elements that match for every vector size
+        j = FindFirstMismatch(t, out, j, buffer_elements);
+        if (j == buffer_elements) break;
+
         for (auto k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++)
         {
             cl_uint *q = out[k];
@@ -511,7 +519,7 @@ int TestFunc_Float_Float_Int(const Func *f, MTdata d, bool relaxedMode)
 
     // Init test_info
     test_info.threadCount = GetThreadCount();
-    test_info.subBufferSize = BUFFER_SIZE
+    test_info.subBufferSize = gBufferSize
         / (sizeof(cl_float) * RoundUpToNextPowerOfTwo(test_info.threadCount));
     test_info.scale = getTestScale(sizeof(cl_float));
 
@@ -599,7 +607,8 @@ int TestFunc_Float_Float_Int(const Func *f, MTdata d, bool relaxedMode)
     // Run the kernels
     if (!gSkipCorrectnessTesting)
     {
-        error = ThreadPool_Do(Test, test_info.jobCount, &test_info);
+        error = ThreadPool_DoShard(Test, test_info.jobCount, &test_info,
+                                   test_info.subBufferSize);
         if (error) return error;
 
         // Accumulate the arithmetic errors
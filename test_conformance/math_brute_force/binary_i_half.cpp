@@ -16,6 +16,7 @@
 
 #include "common.h"
 #include "function_list.h"
+#include "shard.h"
 #include "test_functions.h"
 #include "utility.h"
 
@@ -126,7 +127,7 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
     cl_int *s2;
 
     // start the map of the output arrays
-    cl_event e[VECTOR_SIZE_COUNT];
+    clEventWrapper mapped;
     cl_ushort *out[VECTOR_SIZE_COUNT];
 
     if (gHostFill)
@@ -136,7 +137,7 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
         {
             out[j] = (cl_ushort *)clEnqueueMapBuffer(
                 tinfo->tQueue, tinfo->outBuf[j], CL_FALSE, CL_MAP_WRITE, 0,
-                buffer_elements * sizeof(cl_ushort), 0, NULL, e + j, &error);
+                buffer_elements * sizeof(cl_ushort), 0, NULL, NULL, &error);
             if (error || NULL == out[j])
             {
                 vlog_error("Error: clEnqueueMapBuffer %d failed! err: %d\n", j,
@@ -145,6 +146,14 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
             }
         }
 
+        // One event for all the maps rather than one each
+        if ((error = enqueue_chain_end(tinfo->tQueue, &mapped)))
+        {
+            vlog_error("Error: clEnqueueMarkerWithWaitList failed! err: %d\n",
+                       error);
+            return error;
+        }
+
         // Get that moving
         if ((error = clFlush(tinfo->tQueue))) vlog("clFlush failed\n");
     }
@@ -183,7 +192,7 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
         p2[j] = genrand_int32(d);
     }
 
-    if ((error = clEnqueueWriteBuffer(tinfo->tQueue, tinfo->inBuf, CL_FALSE, 0,
+    if ((error = enqueue_write_staged(tinfo->tQueue, tinfo->inBuf, CL_FALSE, 0,
                                       buffer_elements * sizeof(cl_half), p, 0,
                                       NULL, NULL)))
     {
@@ -191,7 +200,7 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
         return error;
     }
 
-    if ((error = clEnqueueWriteBuffer(tinfo->tQueue, tinfo->inBuf2, CL_FALSE, 0,
+    if ((error = enqueue_write_staged(tinfo->tQueue, tinfo->inBuf2, CL_FALSE, 0,
                                       buffer_elements * sizeof(cl_int), p2, 0,
                                       NULL, NULL)))
     {
@@ -201,19 +210,14 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
 
     for (j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
     {
-        if (gHostFill)
+        if (gHostFill && j == gMinVectorSizeIndex)
         {
-            // Wait for the map to finish
-            if ((error = clWaitForEvents(1, e + j)))
+            // Wait for the maps to finish
+            if ((error = clWaitForEvents(1, &mapped)))
             {
                 vlog_error("Error: clWaitForEvents failed! err: %d\n", error);
                 return error;
             }
-            if ((error = clReleaseEvent(e[j])))
-            {
-                vlog_error("Error: clReleaseEvent failed! err: %d\n", error);
-                return error;
-            }
         }
 
         // Fill the result buffer with garbage, so that old results don't carry
@@ -429,7 +433,7 @@ int TestFunc_Half_Half_Int(const Func *f, MTdata d, bool relaxedMode)
     TestInfo test_info(test_info_base);
 
     test_info.threadCount = GetThreadCount();
-    test_info.subBufferSize = BUFFER_SIZE
+    test_info.subBufferSize = gBufferSize
         / (sizeof(cl_int) * RoundUpToNextPowerOfTwo(test_info.threadCount));
     test_info.scale = getTestScale(sizeof(cl_half));
     test_info.step = (cl_uint)test_info.subBufferSize * test_info.scale;
@@ -516,7 +520,8 @@ int TestFunc_Half_Half_Int(const Func *f, MTdata d, bool relaxedMode)
 
     // Run the kernels
     if (!gSkipCorrectnessTesting)
-        error = ThreadPool_Do(TestHalf, test_info.jobCount, &test_info);
+        error = ThreadPool_DoShard(TestHalf, test_info.jobCount, &test_info,
+                                   test_info.subBufferSize);
 
 
     // Accumulate the arithmetic errors
@@ -16,6 +16,8 @@
 
 #include "common.h"
 #include "function_list.h"
+#include "reference_math.h"
+#include "shard.h"
 #include "test_functions.h"
 #include "utility.h"
 
@@ -213,7 +215,7 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
         func = job->f->rfunc;
     }
 
-    cl_event e[VECTOR_SIZE_COUNT];
+    clEventWrapper mapped;
     cl_uint *out[VECTOR_SIZE_COUNT];
     if (gHostFill)
     {
@@ -222,7 +224,7 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
         {
             out[j] = (cl_uint *)clEnqueueMapBuffer(
                 tinfo->tQueue, tinfo->outBuf[j], CL_FALSE, CL_MAP_WRITE, 0,
-                buffer_size, 0, NULL, e + j, &error);
+                buffer_size, 0, NULL, NULL, &error);
             if (error || NULL == out[j])
             {
                 vlog_error("Error: clEnqueueMapBuffer %d failed! err: %d\n", j,
@@ -231,6 +233,14 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
             }
         }
 
+        // One event for all the maps rather than one each
+        if ((error = enqueue_chain_end(tinfo->tQueue, &mapped)))
+        {
+            vlog_error("Error: clEnqueueMarkerWithWaitList failed! err: %d\n",
+                       error);
+            return error;
+        }
+
         // Get that moving
         if ((error = clFlush(tinfo->tQueue))) vlog("clFlush failed\n");
     }
@@ -288,14 +298,14 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
         }
     }
 
-    if ((error = clEnqueueWriteBuffer(tinfo->tQueue, tinfo->inBuf, CL_FALSE, 0,
+    if ((error = enqueue_write_staged(tinfo->tQueue, tinfo->inBuf, CL_FALSE, 0,
                                       buffer_size, p, 0, NULL, NULL)))
     {
         vlog_error("Error: clEnqueueWriteBuffer failed! err: %d\n", error);
         return error;
     }
 
-    if ((error = clEnqueueWriteBuffer(tinfo->tQueue, tinfo->inBuf2, CL_FALSE, 0,
+    if ((error = enqueue_write_staged(tinfo->tQueue, tinfo->inBuf2, CL_FALSE, 0,
                                       buffer_size, p2, 0, NULL, NULL)))
     {
         vlog_error("Error: clEnqueueWriteBuffer failed! err: %d\n", error);
@@ -304,19 +314,14 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
 
     for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
     {
-        if (gHostFill)
+        if (gHostFill && j == gMinVectorSizeIndex)
         {
-            // Wait for the map to finish
-            if ((error = clWaitForEvents(1, e + j)))
+            // Wait for the maps to finish
+            if ((error = clWaitForEvents(1, &mapped)))
             {
                 vlog_error("Error: clWaitForEvents failed! err: %d\n", error);
                 return error;
             }
-            if ((error = clReleaseEvent(e[j])))
-            {
-                vlog_error("Error: clReleaseEvent failed! err: %d\n", error);
-                return error;
-            }
         }
 
         // Fill the result buffer with garbage, so that old results don't carry
@@ -387,39 +392,40 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
         return CL_SUCCESS;
     }
 
-    // Calculate the correctly rounded reference result
-    FPU_mode_type oldMode;
-    memset(&oldMode, 0, sizeof(oldMode));
-    if (ftz || relaxedMode) ForceFTZ(&oldMode);
-
     // Set the rounding mode to match the device
     oldRoundMode = kRoundToNearestEven;
     if (gIsInRTZMode) oldRoundMode = set_round(kRoundTowardZero, kfloat);
 
-    // Calculate the correctly rounded reference result
+    // Calculate the correctly rounded reference result, in FTZ mode if the
+    // device flushes
     r = (float *)gOut_Ref + thread_id * buffer_elements;
     s = (float *)gIn + thread_id * buffer_elements;
     s2 = (float *)gIn2 + thread_id * buffer_elements;
-    if (gInfNanSupport)
     {
-        for (size_t j = 0; j < buffer_elements; j++)
-            r[j] = (float)func.f_ff(s[j], s2[j]);
-    }
-    else
-    {
-        for (size_t j = 0; j < buffer_elements; j++)
+        FPStateGuard ftzGuard(ftz || relaxedMode ? kForceFTZ : kKeepFTZ);
+        if (gInfNanSupport)
+        {
+            BatchReference_f_ff batchRef = GetBatchReference(func.f_ff);
+            if (batchRef)
+                batchRef(r, s, s2, buffer_elements);
+            else
+                for (size_t j = 0; j < buffer_elements; j++)
+                    r[j] = (float)func.f_ff(s[j], s2[j]);
+        }
+        else
         {
-            feclearexcept(FE_OVERFLOW);
-            r[j] = (float)func.f_ff(s[j], s2[j]);
-            overflow[j] =
-                FE_OVERFLOW == (FE_OVERFLOW & fetestexcept(FE_OVERFLOW));
+            for (size_t j = 0; j < buffer_elements; j++)
+            {
+                feclearexcept(FE_OVERFLOW);
+                r[j] = (float)func.f_ff(s[j], s2[j]);
+                overflow[j] =
+                    FE_OVERFLOW == (FE_OVERFLOW & fetestexcept(FE_OVERFLOW));
+            }
         }
     }
 
     if (gIsInRTZMode) (void)set_round(oldRoundMode, kfloat);
 
-    if (ftz || relaxedMode) RestoreFPState(&oldMode);
-
     // Read the data back -- no need to wait for the first N-1 buffers but wait
     // for the last buffer. This is an in order queue.
     for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
@@ -440,6 +446,11 @@ cl_int Test(cl_uint job_id, cl_uint thread_id, void *data)
     t = (cl_uint *)r;
     for (size_t j = 0; j < buffer_elements; j++)
     {
+        // Skip the elements that match for every vector size, NaNs of any kind
+        // matching
+        j = FindFirstFloatMismatch(t, out, j, buffer_elements);
+        if (j == buffer_elements) break;
+
         for (auto k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++)
         {
             cl_uint *q = out[k];
@@ -692,7 +703,7 @@ int TestFunc_Float_Float_Float_Operator(const Func *f, MTdata d,
 
     // Init test_info
     test_info.threadCount = GetThreadCount();
-    test_info.subBufferSize = BUFFER_SIZE
+    test_info.subBufferSize = gBufferSize
         / (sizeof(cl_float) * RoundUpToNextPowerOfTwo(test_info.threadCount));
     test_info.scale = getTestScale(sizeof(cl_float));
 
@@ -777,7 +788,8 @@ int TestFunc_Float_Float_Float_Operator(const Func *f, MTdata d,
     // Run the kernels
     if (!gSkipCorrectnessTesting)
     {
-        error = ThreadPool_Do(Test, test_info.jobCount, &test_info);
+        error = ThreadPool_DoShard(Test, test_info.jobCount, &test_info,
+                                   test_info.subBufferSize);
         if (error) return error;
 
         // Accumulate the arithmetic errors
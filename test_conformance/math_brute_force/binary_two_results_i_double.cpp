@@ -16,6 +16,7 @@
 
 #include "common.h"
 #include "function_list.h"
+#include "shard.h"
 #include "test_functions.h"
 #include "utility.h"
 
@@ -84,7 +85,7 @@ int TestFunc_DoubleI_Double_Double(const Func *f, MTdata d, bool relaxedMode)
     int ftz = f->ftz || gForceFTZ;
     double maxErrorVal = 0.0f;
     double maxErrorVal2 = 0.0f;
-    uint64_t step = getTestStep(sizeof(double), BUFFER_SIZE);
+    uint64_t step = getTestStep(sizeof(double), gBufferSize);
 
     logFunctionInfo(f->name, sizeof(cl_double), relaxedMode);
 
@@ -102,26 +103,28 @@ int TestFunc_DoubleI_Double_Double(const Func *f, MTdata d, bool relaxedMode)
                                &build_info)))
         return error;
 
-    for (uint64_t i = 0; i < (1ULL << 32); i += step)
+    uint64_t begin, end;
+    GetShardRange(1ULL << 32, step, &begin, &end);
+    for (uint64_t i = begin; i < end; i += step)
     {
         // Init input array
         double *p = (double *)gIn;
         double *p2 = (double *)gIn2;
-        for (size_t j = 0; j < BUFFER_SIZE / sizeof(double); j++)
+        for (size_t j = 0; j < gBufferSize / sizeof(double); j++)
         {
             p[j] = DoubleFromUInt32(genrand_int32(d));
             p2[j] = DoubleFromUInt32(genrand_int32(d));
         }
 
-        if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer, CL_FALSE, 0,
-                                          BUFFER_SIZE, gIn, 0, NULL, NULL)))
+        if ((error = enqueue_write_staged(gQueue, gInBuffer, CL_FALSE, 0,
+                                          gBufferSize, gIn, 0, NULL, NULL)))
         {
             vlog_error("\n*** Error %d in clEnqueueWriteBuffer ***\n", error);
             return error;
         }
 
-        if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer2, CL_FALSE, 0,
-                                          BUFFER_SIZE, gIn2, 0, NULL, NULL)))
+        if ((error = enqueue_write_staged(gQueue, gInBuffer2, CL_FALSE, 0,
+                                          gBufferSize, gIn2, 0, NULL, NULL)))
         {
             vlog_error("\n*** Error %d in clEnqueueWriteBuffer2 ***\n", error);
             return error;
@@ -133,9 +136,9 @@ int TestFunc_DoubleI_Double_Double(const Func *f, MTdata d, bool relaxedMode)
             uint32_t pattern = 0xffffdead;
             if (gHostFill)
             {
-                memset_pattern4(gOut[j], &pattern, BUFFER_SIZE);
-                if ((error = clEnqueueWriteBuffer(gQueue, gOutBuffer[j],
-                                                  CL_FALSE, 0, BUFFER_SIZE,
+                memset_pattern4(gOut[j], &pattern, gBufferSize);
+                if ((error = enqueue_write_staged(gQueue, gOutBuffer[j],
+                                                  CL_FALSE, 0, gBufferSize,
                                                   gOut[j], 0, NULL, NULL)))
                 {
                     vlog_error(
@@ -144,9 +147,9 @@ int TestFunc_DoubleI_Double_Double(const Func *f, MTdata d, bool relaxedMode)
                     return error;
                 }
 
-                memset_pattern4(gOut2[j], &pattern, BUFFER_SIZE);
-                if ((error = clEnqueueWriteBuffer(gQueue, gOutBuffer2[j],
-                                                  CL_FALSE, 0, BUFFER_SIZE,
+                memset_pattern4(gOut2[j], &pattern, gBufferSize);
+                if ((error = enqueue_write_staged(gQueue, gOutBuffer2[j],
+                                                  CL_FALSE, 0, gBufferSize,
                                                   gOut2[j], 0, NULL, NULL)))
                 {
                     vlog_error(
@@ -159,7 +162,7 @@ int TestFunc_DoubleI_Double_Double(const Func *f, MTdata d, bool relaxedMode)
             {
                 if ((error = clEnqueueFillBuffer(gQueue, gOutBuffer[j],
                                                  &pattern, sizeof(pattern), 0,
-                                                 BUFFER_SIZE, 0, NULL, NULL)))
+                                                 gBufferSize, 0, NULL, NULL)))
                 {
                     vlog_error("Error: clEnqueueFillBuffer 1 failed! err: %d\n",
                                error);
@@ -168,7 +171,7 @@ int TestFunc_DoubleI_Double_Double(const Func *f, MTdata d, bool relaxedMode)
 
                 if ((error = clEnqueueFillBuffer(gQueue, gOutBuffer2[j],
                                                  &pattern, sizeof(pattern), 0,
-                                                 BUFFER_SIZE, 0, NULL, NULL)))
+                                                 gBufferSize, 0, NULL, NULL)))
                 {
                     vlog_error("Error: clEnqueueFillBuffer 2 failed! err: %d\n",
                                error);
@@ -181,8 +184,8 @@ int TestFunc_DoubleI_Double_Double(const Func *f, MTdata d, bool relaxedMode)
         for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
         {
             size_t vectorSize = sizeof(cl_double) * sizeValues[j];
-            size_t localCount = (BUFFER_SIZE + vectorSize - 1)
-                / vectorSize; // BUFFER_SIZE / vectorSize  rounded up
+            size_t localCount = (gBufferSize + vectorSize - 1)
+                / vectorSize; // gBufferSize / vectorSize  rounded up
             if ((error = clSetKernelArg(kernels[j][thread_id], 0,
                                         sizeof(gOutBuffer[j]), &gOutBuffer[j])))
             {
@@ -233,7 +236,7 @@ int TestFunc_DoubleI_Double_Double(const Func *f, MTdata d, bool relaxedMode)
             cri.r = (double *)gOut_Ref;
             cri.i = (int *)gOut_Ref2;
             cri.f_ffpI = f->dfunc.f_ffpI;
-            cri.lim = BUFFER_SIZE / sizeof(double);
+            cri.lim = gBufferSize / sizeof(double);
             cri.count = (cri.lim + threadCount - 1) / threadCount;
             ThreadPool_Do(ReferenceD, threadCount, &cri);
         }
@@ -241,7 +244,7 @@ int TestFunc_DoubleI_Double_Double(const Func *f, MTdata d, bool relaxedMode)
         {
             double *r = (double *)gOut_Ref;
             int *r2 = (int *)gOut_Ref2;
-            for (size_t j = 0; j < BUFFER_SIZE / sizeof(double); j++)
+            for (size_t j = 0; j < gBufferSize / sizeof(double); j++)
                 r[j] = (double)f->dfunc.f_ffpI(s[j], s2[j], r2 + j);
         }
 
@@ -249,15 +252,15 @@ int TestFunc_DoubleI_Double_Double(const Func *f, MTdata d, bool relaxedMode)
         for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
         {
             if ((error =
-                     clEnqueueReadBuffer(gQueue, gOutBuffer[j], CL_TRUE, 0,
-                                         BUFFER_SIZE, gOut[j], 0, NULL, NULL)))
+                     enqueue_read_staged(gQueue, gOutBuffer[j], CL_TRUE, 0,
+                                         gBufferSize, gOut[j], 0, NULL, NULL)))
             {
                 vlog_error("ReadArray failed %d\n", error);
                 return error;
             }
             if ((error =
-                     clEnqueueReadBuffer(gQueue, gOutBuffer2[j], CL_TRUE, 0,
-                                         BUFFER_SIZE, gOut2[j], 0, NULL, NULL)))
+                     enqueue_read_staged(gQueue, gOutBuffer2[j], CL_TRUE, 0,
+                                         gBufferSize, gOut2[j], 0, NULL, NULL)))
             {
                 vlog_error("ReadArray2 failed %d\n", error);
                 return error;
@@ -269,7 +272,7 @@ int TestFunc_DoubleI_Double_Double(const Func *f, MTdata d, bool relaxedMode)
         // Verify data
         uint64_t *t = (uint64_t *)gOut_Ref;
         int32_t *t2 = (int32_t *)gOut_Ref2;
-        for (size_t j = 0; j < BUFFER_SIZE / sizeof(double); j++)
+        for (size_t j = 0; j < gBufferSize / sizeof(double); j++)
         {
             for (auto k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++)
             {
@@ -480,8 +483,8 @@ int TestFunc_DoubleI_Double_Double(const Func *f, MTdata d, bool relaxedMode)
             if (gVerboseBruteForce)
             {
                 vlog("base:%14" PRIu64 " step:%10" PRIu64
-                     "  bufferSize:%10d \n",
-                     i, step, BUFFER_SIZE);
+                     "  bufferSize:%10zu \n",
+                     i, step, gBufferSize);
             }
             else
             {
@@ -16,6 +16,7 @@
 
 #include "common.h"
 #include "function_list.h"
+#include "shard.h"
 #include "test_functions.h"
 #include "utility.h"
 
@@ -84,7 +85,7 @@ int TestFunc_FloatI_Float_Float(const Func *f, MTdata d, bool relaxedMode)
     int64_t maxError2 = 0;
     float maxErrorVal = 0.0f;
     float maxErrorVal2 = 0.0f;
-    uint64_t step = getTestStep(sizeof(float), BUFFER_SIZE);
+    uint64_t step = getTestStep(sizeof(float), gBufferSize);
 
     cl_uint threadCount = GetThreadCount();
 
@@ -104,26 +105,28 @@ int TestFunc_FloatI_Float_Float(const Func *f, MTdata d, bool relaxedMode)
                                &build_info)))
         return error;
 
-    for (uint64_t i = 0; i < (1ULL << 32); i += step)
+    uint64_t begin, end;
+    GetShardRange(1ULL << 32, step, &begin, &end);
+    for (uint64_t i = begin; i < end; i += step)
     {
         // Init input array
         cl_uint *p = (cl_uint *)gIn;
         cl_uint *p2 = (cl_uint *)gIn2;
-        for (size_t j = 0; j < BUFFER_SIZE / sizeof(float); j++)
+        for (size_t j = 0; j < gBufferSize / sizeof(float); j++)
         {
             p[j] = genrand_int32(d);
             p2[j] = genrand_int32(d);
         }
 
-        if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer, CL_FALSE, 0,
-                                          BUFFER_SIZE, gIn, 0, NULL, NULL)))
+        if ((error = enqueue_write_staged(gQueue, gInBuffer, CL_FALSE, 0,
+                                          gBufferSize, gIn, 0, NULL, NULL)))
         {
             vlog_error("\n*** Error %d in clEnqueueWriteBuffer ***\n", error);
             return error;
         }
 
-        if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer2, CL_FALSE, 0,
-                                          BUFFER_SIZE, gIn2, 0, NULL, NULL)))
+        if ((error = enqueue_write_staged(gQueue, gInBuffer2, CL_FALSE, 0,
+                                          gBufferSize, gIn2, 0, NULL, NULL)))
         {
             vlog_error("\n*** Error %d in clEnqueueWriteBuffer2 ***\n", error);
             return error;
@@ -135,9 +138,9 @@ int TestFunc_FloatI_Float_Float(const Func *f, MTdata d, bool relaxedMode)
             uint32_t pattern = 0xffffdead;
             if (gHostFill)
             {
-                memset_pattern4(gOut[j], &pattern, BUFFER_SIZE);
-                if ((error = clEnqueueWriteBuffer(gQueue, gOutBuffer[j],
-                                                  CL_FALSE, 0, BUFFER_SIZE,
+                memset_pattern4(gOut[j], &pattern, gBufferSize);
+                if ((error = enqueue_write_staged(gQueue, gOutBuffer[j],
+                                                  CL_FALSE, 0, gBufferSize,
                                                   gOut[j], 0, NULL, NULL)))
                 {
                     vlog_error(
@@ -146,9 +149,9 @@ int TestFunc_FloatI_Float_Float(const Func *f, MTdata d, bool relaxedMode)
                     return error;
                 }
 
-                memset_pattern4(gOut2[j], &pattern, BUFFER_SIZE);
-                if ((error = clEnqueueWriteBuffer(gQueue, gOutBuffer2[j],
-                                                  CL_FALSE, 0, BUFFER_SIZE,
+                memset_pattern4(gOut2[j], &pattern, gBufferSize);
+                if ((error = enqueue_write_staged(gQueue, gOutBuffer2[j],
+                                                  CL_FALSE, 0, gBufferSize,
                                                   gOut2[j], 0, NULL, NULL)))
                 {
                     vlog_error(
@@ -161,7 +164,7 @@ int TestFunc_FloatI_Float_Float(const Func *f, MTdata d, bool relaxedMode)
             {
                 if ((error = clEnqueueFillBuffer(gQueue, gOutBuffer[j],
                                                  &pattern, sizeof(pattern), 0,
-                                                 BUFFER_SIZE, 0, NULL, NULL)))
+                                                 gBufferSize, 0, NULL, NULL)))
                 {
                     vlog_error("Error: clEnqueueFillBuffer 1 failed! err: %d\n",
                                error);
@@ -170,7 +173,7 @@ int TestFunc_FloatI_Float_Float(const Func *f, MTdata d, bool relaxedMode)
 
                 if ((error = clEnqueueFillBuffer(gQueue, gOutBuffer2[j],
                                                  &pattern, sizeof(pattern), 0,
-                                                 BUFFER_SIZE, 0, NULL, NULL)))
+                                                 gBufferSize, 0, NULL, NULL)))
                 {
                     vlog_error("Error: clEnqueueFillBuffer 2 failed! err: %d\n",
                                error);
@@ -183,8 +186,8 @@ int TestFunc_FloatI_Float_Float(const Func *f, MTdata d, bool relaxedMode)
         for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
         {
             size_t vectorSize = sizeof(cl_float) * sizeValues[j];
-            size_t localCount = (BUFFER_SIZE + vectorSize - 1)
-                / vectorSize; // BUFFER_SIZE / vectorSize  rounded up
+            size_t localCount = (gBufferSize + vectorSize - 1)
+                / vectorSize; // gBufferSize / vectorSize  rounded up
             if ((error = clSetKernelArg(kernels[j][thread_id], 0,
                                         sizeof(gOutBuffer[j]), &gOutBuffer[j])))
             {
@@ -235,7 +238,7 @@ int TestFunc_FloatI_Float_Float(const Func *f, MTdata d, bool relaxedMode)
             cri.r = (float *)gOut_Ref;
             cri.i = (int *)gOut_Ref2;
             cri.f_ffpI = f->func.f_ffpI;
-            cri.lim = BUFFER_SIZE / sizeof(float);
+            cri.lim = gBufferSize / sizeof(float);
             cri.count = (cri.lim + threadCount - 1) / threadCount;
             ThreadPool_Do(ReferenceF, threadCount, &cri);
         }
@@ -243,7 +246,7 @@ int TestFunc_FloatI_Float_Float(const Func *f, MTdata d, bool relaxedMode)
         {
             float *r = (float *)gOut_Ref;
             int *r2 = (int *)gOut_Ref2;
-            for (size_t j = 0; j < BUFFER_SIZE / sizeof(float); j++)
+            for (size_t j = 0; j < gBufferSize / sizeof(float); j++)
                 r[j] = (float)f->func.f_ffpI(s[j], s2[j], r2 + j);
         }
 
@@ -251,15 +254,15 @@ int TestFunc_FloatI_Float_Float(const Func *f, MTdata d, bool relaxedMode)
         for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
         {
             if ((error =
-                     clEnqueueReadBuffer(gQueue, gOutBuffer[j], CL_TRUE, 0,
-                                         BUFFER_SIZE, gOut[j], 0, NULL, NULL)))
+                     enqueue_read_staged(gQueue, gOutBuffer[j], CL_TRUE, 0,
+                                         gBufferSize, gOut[j], 0, NULL, NULL)))
             {
                 vlog_error("ReadArray failed %d\n", error);
                 return error;
             }
             if ((error =
-                     clEnqueueReadBuffer(gQueue, gOutBuffer2[j], CL_TRUE, 0,
-                                         BUFFER_SIZE, gOut2[j], 0, NULL, NULL)))
+                     enqueue_read_staged(gQueue, gOutBuffer2[j], CL_TRUE, 0,
+                                         gBufferSize, gOut2[j], 0, NULL, NULL)))
             {
                 vlog_error("ReadArray2 failed %d\n", error);
                 return error;
@@ -271,7 +274,7 @@ int TestFunc_FloatI_Float_Float(const Func *f, MTdata d, bool relaxedMode)
         // Verify data
         uint32_t *t = (uint32_t *)gOut_Ref;
         int32_t *t2 = (int32_t *)gOut_Ref2;
-        for (size_t j = 0; j < BUFFER_SIZE / sizeof(float); j++)
+        for (size_t j = 0; j < gBufferSize / sizeof(float); j++)
         {
             for (auto k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++)
             {
@@ -464,8 +467,8 @@ int TestFunc_FloatI_Float_Float(const Func *f, MTdata d, bool relaxedMode)
             if (gVerboseBruteForce)
             {
                 vlog("base:%14" PRIu64 " step:%10" PRIu64
-                     "  bufferSize:%10d \n",
-                     i, step, BUFFER_SIZE);
+                     "  bufferSize:%10zu \n",
+                     i, step, gBufferSize);
             }
             else
             {
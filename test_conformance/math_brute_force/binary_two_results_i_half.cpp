@@ -16,6 +16,7 @@
 
 #include "common.h"
 #include "function_list.h"
+#include "shard.h"
 #include "test_functions.h"
 #include "utility.h"
 
@@ -84,10 +85,10 @@ int TestFunc_HalfI_Half_Half(const Func *f, MTdata d, bool relaxedMode)
     int64_t maxError2 = 0;
     float maxErrorVal = 0.0f;
     float maxErrorVal2 = 0.0f;
-    uint64_t step = getTestStep(sizeof(cl_half), BUFFER_SIZE);
+    uint64_t step = getTestStep(sizeof(cl_half), gBufferSize);
 
     // use larger type of output data to prevent overflowing buffer size
-    constexpr size_t buffer_size = BUFFER_SIZE / sizeof(int32_t);
+    const size_t buffer_size = gBufferSize / sizeof(int32_t);
 
     cl_uint threadCount = GetThreadCount();
 
@@ -102,7 +103,9 @@ int TestFunc_HalfI_Half_Half(const Func *f, MTdata d, bool relaxedMode)
                                &build_info)))
         return error;
 
-    for (uint64_t i = 0; i < (1ULL << 32); i += step)
+    uint64_t begin, end;
+    GetShardRange(1ULL << 32, step, &begin, &end);
+    for (uint64_t i = begin; i < end; i += step)
     {
         // Init input array
         cl_half *p = (cl_half *)gIn;
@@ -113,7 +116,7 @@ int TestFunc_HalfI_Half_Half(const Func *f, MTdata d, bool relaxedMode)
             p2[j] = (cl_half)genrand_int32(d);
         }
 
-        if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer, CL_FALSE, 0,
+        if ((error = enqueue_write_staged(gQueue, gInBuffer, CL_FALSE, 0,
                                           buffer_size * sizeof(cl_half), gIn, 0,
                                           NULL, NULL)))
         {
@@ -121,7 +124,7 @@ int TestFunc_HalfI_Half_Half(const Func *f, MTdata d, bool relaxedMode)
             return error;
         }
 
-        if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer2, CL_FALSE, 0,
+        if ((error = enqueue_write_staged(gQueue, gInBuffer2, CL_FALSE, 0,
                                           buffer_size * sizeof(cl_half), gIn2,
                                           0, NULL, NULL)))
         {
@@ -135,9 +138,9 @@ int TestFunc_HalfI_Half_Half(const Func *f, MTdata d, bool relaxedMode)
             uint32_t pattern = 0xacdcacdc;
             if (gHostFill)
             {
-                memset_pattern4(gOut[j], &pattern, BUFFER_SIZE);
-                if ((error = clEnqueueWriteBuffer(gQueue, gOutBuffer[j],
-                                                  CL_FALSE, 0, BUFFER_SIZE,
+                memset_pattern4(gOut[j], &pattern, gBufferSize);
+                if ((error = enqueue_write_staged(gQueue, gOutBuffer[j],
+                                                  CL_FALSE, 0, gBufferSize,
                                                   gOut[j], 0, NULL, NULL)))
                 {
                     vlog_error(
@@ -146,9 +149,9 @@ int TestFunc_HalfI_Half_Half(const Func *f, MTdata d, bool relaxedMode)
                     return error;
                 }
 
-                memset_pattern4(gOut2[j], &pattern, BUFFER_SIZE);
-                if ((error = clEnqueueWriteBuffer(gQueue, gOutBuffer2[j],
-                                                  CL_FALSE, 0, BUFFER_SIZE,
+                memset_pattern4(gOut2[j], &pattern, gBufferSize);
+                if ((error = enqueue_write_staged(gQueue, gOutBuffer2[j],
+                                                  CL_FALSE, 0, gBufferSize,
                                                   gOut2[j], 0, NULL, NULL)))
                 {
                     vlog_error(
@@ -160,12 +163,12 @@ int TestFunc_HalfI_Half_Half(const Func *f, MTdata d, bool relaxedMode)
             else
             {
                 error = clEnqueueFillBuffer(gQueue, gOutBuffer[j], &pattern,
-                                            sizeof(pattern), 0, BUFFER_SIZE, 0,
+                                            sizeof(pattern), 0, gBufferSize, 0,
                                             NULL, NULL);
                 test_error(error, "clEnqueueFillBuffer 1 failed!\n");
 
                 error = clEnqueueFillBuffer(gQueue, gOutBuffer2[j], &pattern,
-                                            sizeof(pattern), 0, BUFFER_SIZE, 0,
+                                            sizeof(pattern), 0, gBufferSize, 0,
                                             NULL, NULL);
                 test_error(error, "clEnqueueFillBuffer 2 failed!\n");
             }
@@ -176,7 +179,7 @@ int TestFunc_HalfI_Half_Half(const Func *f, MTdata d, bool relaxedMode)
         {
             // align working group size with the bigger output type
             size_t vectorSize = sizeValues[j] * sizeof(int32_t);
-            size_t localCount = (BUFFER_SIZE + vectorSize - 1) / vectorSize;
+            size_t localCount = (gBufferSize + vectorSize - 1) / vectorSize;
             if ((error = clSetKernelArg(kernels[j][thread_id], 0,
                                         sizeof(gOutBuffer[j]), &gOutBuffer[j])))
             {
@@ -242,15 +245,15 @@ int TestFunc_HalfI_Half_Half(const Func *f, MTdata d, bool relaxedMode)
             cl_bool blocking =
                 (j + 1 < gMaxVectorSizeIndex) ? CL_FALSE : CL_TRUE;
             if ((error =
-                     clEnqueueReadBuffer(gQueue, gOutBuffer[j], blocking, 0,
-                                         BUFFER_SIZE, gOut[j], 0, NULL, NULL)))
+                     enqueue_read_staged(gQueue, gOutBuffer[j], blocking, 0,
+                                         gBufferSize, gOut[j], 0, NULL, NULL)))
             {
                 vlog_error("ReadArray failed %d\n", error);
                 return error;
             }
             if ((error =
-                     clEnqueueReadBuffer(gQueue, gOutBuffer2[j], blocking, 0,
-                                         BUFFER_SIZE, gOut2[j], 0, NULL, NULL)))
+                     enqueue_read_staged(gQueue, gOutBuffer2[j], blocking, 0,
+                                         gBufferSize, gOut2[j], 0, NULL, NULL)))
             {
                 vlog_error("ReadArray2 failed %d\n", error);
                 return error;
@@ -449,8 +452,8 @@ int TestFunc_HalfI_Half_Half(const Func *f, MTdata d, bool relaxedMode)
             if (gVerboseBruteForce)
             {
                 vlog("base:%14" PRIu64 " step:%10" PRIu64
-                     "  bufferSize:%10d \n",
-                     i, step, BUFFER_SIZE);
+                     "  bufferSize:%10zu \n",
+                     i, step, gBufferSize);
             }
             else
             {
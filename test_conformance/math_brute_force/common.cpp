@@ -18,8 +18,16 @@
 
 #include "utility.h" // for sizeNames and sizeValues.
 
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <tuple>
 
 namespace {
 
@@ -124,6 +132,154 @@ std::string GetBuildOptions(bool relaxed_mode)
     return options.str();
 }
 
+// A program shared by all vector sizes of one test, built by whichever build
+// job gets to it first.
+struct CachedProgram
+{
+    std::mutex mutex;
+    bool built = false;
+    cl_int error = CL_SUCCESS;
+    clProgramWrapper program;
+};
+
+// Process-wide cache of merged programs, keyed by context, device, build
+// options and source. The cache is cleared when it grows past
+// kMaxCachedPrograms, programs still in use are kept alive by their users.
+const size_t kMaxCachedPrograms = 64;
+std::mutex gProgramCacheMutex;
+std::map<std::string, std::shared_ptr<CachedProgram>> gProgramCache;
+
+// Return the sources for all tested vector sizes as a single program. Macros
+// defined by one vector size are undefined before the next one.
+std::string GetMergedSource(const char *nameInCode, SourceGenerator generator)
+{
+    std::ostringstream merged;
+    for (auto i = gMinVectorSizeIndex; i < gMaxVectorSizeIndex; i++)
+    {
+        auto source = generator(GetKernelName(i), nameInCode, i);
+        merged << source << '\n';
+
+        std::istringstream lines(source);
+        std::string line;
+        while (std::getline(lines, line))
+        {
+            if (line.compare(0, 8, "#define ") != 0) continue;
+            auto end = line.find_first_of(" (", 8);
+            merged << "#undef " << line.substr(8, end - 8) << '\n';
+        }
+    }
+    return merged.str();
+}
+
+// Find the cache entry for source built with options, adding one that isn't
+// built yet if there is none.
+std::shared_ptr<CachedProgram> FindCachedProgram(const std::string &source,
+                                                 const std::string &options)
+{
+    std::ostringstream key;
+    key << gContext << ' ' << gDevice << ' ' << options << '\n' << source;
+
+    std::lock_guard<std::mutex> lock(gProgramCacheMutex);
+    auto it = gProgramCache.find(key.str());
+    if (it == gProgramCache.end())
+    {
+        if (gProgramCache.size() >= kMaxCachedPrograms) gProgramCache.clear();
+        it = gProgramCache
+                 .emplace(key.str(), std::make_shared<CachedProgram>())
+                 .first;
+    }
+    return it->second;
+}
+
+// Build entry unless someone already has.
+cl_int BuildCachedProgram(CachedProgram &entry, const std::string &source,
+                          const std::string &options)
+{
+    // Jobs for the other vector sizes, and a test whose program is being
+    // built ahead, wait here while the first one builds.
+    std::lock_guard<std::mutex> lock(entry.mutex);
+    if (!entry.built)
+    {
+        std::array<const char *, 1> sources{ source.c_str() };
+        entry.error = create_single_kernel_helper(
+            gContext, &entry.program, nullptr, sources.size(), sources.data(),
+            nullptr, options.c_str());
+        entry.built = true;
+    }
+    return entry.error;
+}
+
+// Build, or find in the cache, the program holding the kernels for all tested
+// vector sizes.
+cl_int GetMergedProgram(BuildKernelInfo &info, SourceGenerator generator,
+                        clProgramWrapper &program)
+{
+    auto source = GetMergedSource(info.nameInCode, generator);
+    auto options = GetBuildOptions(info.relaxedMode);
+    auto entry = FindCachedProgram(source, options);
+    cl_int error = BuildCachedProgram(*entry, source, options);
+    // Written before the entry was unlocked, and never again
+    program = entry->program;
+    return error;
+}
+
+// Builds of programs that tests further down the run will need, done on a
+// thread of their own while the tests before them run. The generator of a
+// test function is only known once it has built something, which covers the
+// many functions that share the test functions of a vtbl.
+struct BuildAheadJob
+{
+    const char *nameInCode;
+    SourceGenerator generator;
+    bool relaxedMode;
+};
+
+// Enough for the next couple of functions in every precision, so the
+// programs built ahead stay a small part of the cache
+const size_t kMaxBuildAheadJobs = 8;
+
+std::mutex gBuildAheadMutex;
+std::condition_variable gBuildAheadReady;
+std::deque<BuildAheadJob> gBuildAheadJobs;
+bool gBuildAheadStopping = false;
+// Never destroyed while running, so that exit() doesn't terminate on it
+std::thread *gBuildAheadThread = NULL;
+
+TestFuncPtr gBuildingTest = NULL;
+std::map<TestFuncPtr, SourceGenerator> gTestGenerators;
+// Every build queued so far, which BuildAhead is asked for more than once
+std::set<std::tuple<const char *, SourceGenerator, bool>> gBuildsQueued;
+
+void RememberGenerator(SourceGenerator generator)
+{
+    std::lock_guard<std::mutex> lock(gBuildAheadMutex);
+    if (gBuildingTest != NULL) gTestGenerators[gBuildingTest] = generator;
+}
+
+void BuildAheadWorker()
+{
+    std::unique_lock<std::mutex> lock(gBuildAheadMutex);
+    for (;;)
+    {
+        gBuildAheadReady.wait(lock, [] {
+            return gBuildAheadStopping || !gBuildAheadJobs.empty();
+        });
+        if (gBuildAheadStopping) return;
+        BuildAheadJob job = gBuildAheadJobs.front();
+        gBuildAheadJobs.pop_front();
+        lock.unlock();
+
+        // A failure is left in the cache, for the test to fall back to
+        // building each vector size on its own as it would have anyway.
+        auto source = GetMergedSource(job.nameInCode, job.generator);
+        auto options = GetBuildOptions(job.relaxedMode);
+        auto entry = FindCachedProgram(source, options);
+        BuildCachedProgram(*entry, source, options);
+
+        lock.lock();
+    }
+}
+
 } // anonymous namespace
 
 std::string GetKernelName(int vector_size_index)
@@ -167,7 +323,7 @@ __kernel void )", kernel_name.c_str(), R"((__global RETTYPE_SCALAR* out,
     else
     {
         // Figure out how many elements are left over after
-        // BUFFER_SIZE % (3 * sizeof(type)).
+        // gBufferSize % (3 * sizeof(type)).
         // Assume power of two buffer size.
         size_t parity = i & 1;
         TYPE1 a = (TYPE1)(UNDEF1, UNDEF1, UNDEF1);
@@ -247,7 +403,7 @@ __kernel void )", kernel_name.c_str(), R"((__global RETTYPE1_SCALAR* out1,
     else
     {
         // Figure out how many elements are left over after
-        // BUFFER_SIZE % (3 * sizeof(type)).
+        // gBufferSize % (3 * sizeof(type)).
         // Assume power of two buffer size.
         size_t parity = i & 1;
         TYPE1 a = (TYPE1)(UNDEF1, UNDEF1, UNDEF1);
@@ -346,7 +502,7 @@ __kernel void )", kernel_name.c_str(), R"((__global RETTYPE_SCALAR* out,
     else
     {
         // Figure out how many elements are left over after
-        // BUFFER_SIZE % (3 * sizeof(type)).
+        // gBufferSize % (3 * sizeof(type)).
         // Assume power of two buffer size.
         size_t parity = i & 1;
         TYPE1 a = (TYPE1)(UNDEF1, UNDEF1, UNDEF1);
@@ -435,7 +591,7 @@ __kernel void )", kernel_name.c_str(), R"((__global RETTYPE1_SCALAR* out1,
     else
     {
         // Figure out how many elements are left over after
-        // BUFFER_SIZE % (3 * sizeof(type)).
+        // gBufferSize % (3 * sizeof(type)).
         // Assume power of two buffer size.
         size_t parity = i & 1;
         TYPE1 a = (TYPE1)(UNDEF1, UNDEF1, UNDEF1);
@@ -526,7 +682,7 @@ __kernel void )", kernel_name.c_str(), R"((__global RETTYPE_SCALAR* out,
     else
     {
         // Figure out how many elements are left over after
-        // BUFFER_SIZE % (3 * sizeof(type)).
+        // gBufferSize % (3 * sizeof(type)).
         // Assume power of two buffer size.
         size_t parity = i & 1;
         TYPE1 a = (TYPE1)(UNDEF1, UNDEF1, UNDEF1);
@@ -573,22 +729,38 @@ __kernel void )", kernel_name.c_str(), R"((__global RETTYPE_SCALAR* out,
 cl_int BuildKernels(BuildKernelInfo &info, cl_uint job_id,
                     SourceGenerator generator)
 {
-    // Generate the kernel code.
     cl_uint vector_size_index = gMinVectorSizeIndex + job_id;
     auto kernel_name = GetKernelName(vector_size_index);
-    auto source = generator(kernel_name, info.nameInCode, vector_size_index);
-    std::array<const char *, 1> sources{ source.c_str() };
-
-    // Create the program.
     clProgramWrapper &program = info.programs[vector_size_index];
-    auto options = GetBuildOptions(info.relaxedMode);
-    int error =
-        create_single_kernel_helper(gContext, &program, nullptr, sources.size(),
-                                    sources.data(), nullptr, options.c_str());
+    RememberGenerator(generator);
+
+    // Compile all vector sizes at once. If that fails, build this vector size
+    // on its own so that the failure is reported for the right kernel.
+    int error = GetMergedProgram(info, generator, program);
     if (error != CL_SUCCESS)
     {
-        vlog_error("\t\tFAILED -- Failed to create program. (%d)\n", error);
-        return error;
+        if (gVerboseBruteForce)
+            vlog("\t\tMerged program build failed (%d), building vector "
+                 "sizes separately\n",
+                 error);
+
+        // Generate the kernel code.
+        auto source =
+            generator(kernel_name, info.nameInCode, vector_size_index);
+        std::array<const char *, 1> sources{ source.c_str() };
+
+        // Create the program.
+        program = nullptr;
+        auto options = GetBuildOptions(info.relaxedMode);
+        error = create_single_kernel_helper(gContext, &program, nullptr,
+                                            sources.size(), sources.data(),
+                                            nullptr, options.c_str());
+        if (error != CL_SUCCESS)
+        {
+            vlog_error("\t\tFAILED -- Failed to create program. (%d)\n",
+                       error);
+            return error;
+        }
     }
 
     // Create a kernel for each thread. cl_kernels aren't thread safe, so make
@@ -608,3 +780,41 @@ cl_int BuildKernels(BuildKernelInfo &info, cl_uint job_id,
 
     return CL_SUCCESS;
 }
+
+void SetBuildingTest(TestFuncPtr test)
+{
+    std::lock_guard<std::mutex> lock(gBuildAheadMutex);
+    gBuildingTest = test;
+}
+
+void BuildAhead(const Func *f, TestFuncPtr test, bool relaxedMode)
+{
+    std::lock_guard<std::mutex> lock(gBuildAheadMutex);
+    auto it = gTestGenerators.find(test);
+    if (it == gTestGenerators.end() || gBuildAheadStopping
+        || gBuildAheadJobs.size() >= kMaxBuildAheadJobs)
+        return;
+
+    if (!gBuildsQueued.emplace(f->nameInCode, it->second, relaxedMode).second)
+        return;
+    gBuildAheadJobs.push_back({ f->nameInCode, it->second, relaxedMode });
+    if (gBuildAheadThread == NULL)
+        gBuildAheadThread = new std::thread(BuildAheadWorker);
+    gBuildAheadReady.notify_one();
+}
+
+void StopBuildAhead()
+{
+    {
+        std::lock_guard<std::mutex> lock(gBuildAheadMutex);
+        gBuildAheadStopping = true;
+        gBuildAheadJobs.clear();
+    }
+    gBuildAheadReady.notify_one();
+    if (gBuildAheadThread != NULL)
+    {
+        gBuildAheadThread->join();
+        delete gBuildAheadThread;
+        gBuildAheadThread = NULL;
+    }
+}
@@ -16,6 +16,7 @@
 #ifndef COMMON_H
 #define COMMON_H
 
+#include "function_list.h"
 #include "harness/typeWrappers.h"
 #include "utility.h"
 
@@ -91,7 +92,29 @@ using SourceGenerator = std::string (*)(const std::string &kernel_name,
                                         cl_uint vector_size_index);
 
 /// Build kernels for all threads in "info" for the given job_id.
+///
+/// The kernels for all tested vector sizes come from a single program, built
+/// once by whichever job gets there first and kept in a process-wide cache
+/// keyed by the source and build options.
 cl_int BuildKernels(BuildKernelInfo &info, cl_uint job_id,
                     SourceGenerator generator);
 
+/// A test function of a vtbl.
+using TestFuncPtr = int (*)(const Func *, MTdata, bool);
+
+/// Note that the kernels built from now on are for test, so that BuildAhead
+/// can build the programs of later functions with the same generator.
+void SetBuildingTest(TestFuncPtr test);
+
+/// Queue a build of the merged program that test will build for f, on a
+/// thread of its own. The program goes into the cache BuildKernels uses, so
+/// for functions that are quick to test the build overlaps with the tests
+/// before them instead of holding up their own. Does nothing until test has
+/// built something, or if enough builds are queued already.
+void BuildAhead(const Func *f, TestFuncPtr test, bool relaxedMode);
+
+/// Drop the builds still queued and wait for the one in progress. Called
+/// before gContext is released.
+void StopBuildAhead();
+
 #endif /* COMMON_H */
@@ -16,6 +16,8 @@
 
 #include "common.h"
 #include "function_list.h"
+#include "sampling.h"
+#include "shard.h"
 #include "test_functions.h"
 #include "utility.h"
 
@@ -44,9 +46,9 @@ int TestFunc_Int_Double(const Func *f, MTdata d, bool relaxedMode)
     const unsigned thread_id = 0; // Test is currently not multithreaded.
     KernelMatrix kernels;
     int ftz = f->ftz || gForceFTZ;
-    uint64_t step = getTestStep(sizeof(cl_double), BUFFER_SIZE);
+    uint64_t step = getTestStep(sizeof(cl_double), gBufferSize);
     int scale =
-        (int)((1ULL << 32) / (16 * BUFFER_SIZE / sizeof(cl_double)) + 1);
+        (int)((1ULL << 32) / (16 * gBufferSize / sizeof(cl_double)) + 1);
 
     logFunctionInfo(f->name, sizeof(cl_double), relaxedMode);
 
@@ -62,23 +64,28 @@ int TestFunc_Int_Double(const Func *f, MTdata d, bool relaxedMode)
             return error;
     }
 
-    for (uint64_t i = 0; i < (1ULL << 32); i += step)
+    uint64_t begin, end;
+    GetShardRange(1ULL << 32, step, &begin, &end);
+    for (uint64_t i = begin; i < end; i += step)
     {
         // Init input array
         double *p = (double *)gIn;
         if (gWimpyMode)
         {
-            for (size_t j = 0; j < BUFFER_SIZE / sizeof(cl_double); j++)
-                p[j] = DoubleFromUInt32((uint32_t)i + j * scale);
+            size_t n = gBufferSize / sizeof(cl_double);
+            uint64_t count = WimpySampleCount(step, n);
+            for (size_t j = 0; j < n; j++)
+                p[j] = SampleDoubleInput((uint32_t)i + j * scale,
+                                         i / step * n + j, count);
         }
         else
         {
-            for (size_t j = 0; j < BUFFER_SIZE / sizeof(cl_double); j++)
+            for (size_t j = 0; j < gBufferSize / sizeof(cl_double); j++)
                 p[j] = DoubleFromUInt32((uint32_t)i + j);
         }
 
-        if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer, CL_FALSE, 0,
-                                          BUFFER_SIZE, gIn, 0, NULL, NULL)))
+        if ((error = enqueue_write_staged(gQueue, gInBuffer, CL_FALSE, 0,
+                                          gBufferSize, gIn, 0, NULL, NULL)))
         {
             vlog_error("\n*** Error %d in clEnqueueWriteBuffer ***\n", error);
             return error;
@@ -90,9 +97,9 @@ int TestFunc_Int_Double(const Func *f, MTdata d, bool relaxedMode)
             uint32_t pattern = 0xffffdead;
             if (gHostFill)
             {
-                memset_pattern4(gOut[j], &pattern, BUFFER_SIZE);
-                if ((error = clEnqueueWriteBuffer(gQueue, gOutBuffer[j],
-                                                  CL_FALSE, 0, BUFFER_SIZE,
+                memset_pattern4(gOut[j], &pattern, gBufferSize);
+                if ((error = enqueue_write_staged(gQueue, gOutBuffer[j],
+                                                  CL_FALSE, 0, gBufferSize,
                                                   gOut[j], 0, NULL, NULL)))
                 {
                     vlog_error(
@@ -105,7 +112,7 @@ int TestFunc_Int_Double(const Func *f, MTdata d, bool relaxedMode)
             {
                 if ((error = clEnqueueFillBuffer(gQueue, gOutBuffer[j],
                                                  &pattern, sizeof(pattern), 0,
-                                                 BUFFER_SIZE, 0, NULL, NULL)))
+                                                 gBufferSize, 0, NULL, NULL)))
                 {
                     vlog_error("Error: clEnqueueFillBuffer failed! err: %d\n",
                                error);
@@ -118,8 +125,8 @@ int TestFunc_Int_Double(const Func *f, MTdata d, bool relaxedMode)
         for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
         {
             size_t vectorSize = sizeValues[j] * sizeof(cl_double);
-            size_t localCount = (BUFFER_SIZE + vectorSize - 1)
-                / vectorSize; // BUFFER_SIZE / vectorSize  rounded up
+            size_t localCount = (gBufferSize + vectorSize - 1)
+                / vectorSize; // gBufferSize / vectorSize  rounded up
             if ((error = clSetKernelArg(kernels[j][thread_id], 0,
                                         sizeof(gOutBuffer[j]), &gOutBuffer[j])))
             {
@@ -148,15 +155,15 @@ int TestFunc_Int_Double(const Func *f, MTdata d, bool relaxedMode)
         // Calculate the correctly rounded reference result
         int *r = (int *)gOut_Ref;
         double *s = (double *)gIn;
-        for (size_t j = 0; j < BUFFER_SIZE / sizeof(cl_double); j++)
+        for (size_t j = 0; j < gBufferSize / sizeof(cl_double); j++)
             r[j] = f->dfunc.i_f(s[j]);
 
         // Read the data back
         for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
         {
             if ((error =
-                     clEnqueueReadBuffer(gQueue, gOutBuffer[j], CL_TRUE, 0,
-                                         BUFFER_SIZE, gOut[j], 0, NULL, NULL)))
+                     enqueue_read_staged(gQueue, gOutBuffer[j], CL_TRUE, 0,
+                                         gBufferSize, gOut[j], 0, NULL, NULL)))
             {
                 vlog_error("ReadArray failed %d\n", error);
                 goto exit;
@@ -167,8 +174,12 @@ int TestFunc_Int_Double(const Func *f, MTdata d, bool relaxedMode)
 
         // Verify data
         uint32_t *t = (uint32_t *)gOut_Ref;
-        for (size_t j = 0; j < BUFFER_SIZE / sizeof(cl_double); j++)
+        for (size_t j = 0; j < gBufferSize / sizeof(cl_double); j++)
         {
+            // Skip the elements that match for every vector size
+            j = FindFirstMismatch(t, gOut, j, gBufferSize / sizeof(cl_double));
+            if (j == gBufferSize / sizeof(cl_double)) break;
+
             for (auto k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++)
             {
                 uint32_t *q = (uint32_t *)(gOut[k]);
@@ -199,8 +210,8 @@ int TestFunc_Int_Double(const Func *f, MTdata d, bool relaxedMode)
             if (gVerboseBruteForce)
             {
                 vlog("base:%14" PRIu64 " step:%10" PRIu64
-                     "  bufferSize:%10d \n",
-                     i, step, BUFFER_SIZE);
+                     "  bufferSize:%10zu \n",
+                     i, step, gBufferSize);
             }
             else
             {
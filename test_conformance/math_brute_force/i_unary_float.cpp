@@ -16,6 +16,8 @@
 
 #include "common.h"
 #include "function_list.h"
+#include "sampling.h"
+#include "shard.h"
 #include "test_functions.h"
 #include "utility.h"
 
@@ -44,8 +46,8 @@ int TestFunc_Int_Float(const Func *f, MTdata d, bool relaxedMode)
     const unsigned thread_id = 0; // Test is currently not multithreaded.
     KernelMatrix kernels;
     int ftz = f->ftz || gForceFTZ || 0 == (CL_FP_DENORM & gFloatCapabilities);
-    uint64_t step = getTestStep(sizeof(float), BUFFER_SIZE);
-    int scale = (int)((1ULL << 32) / (16 * BUFFER_SIZE / sizeof(float)) + 1);
+    uint64_t step = getTestStep(sizeof(float), gBufferSize);
+    int scale = (int)((1ULL << 32) / (16 * gBufferSize / sizeof(float)) + 1);
 
     logFunctionInfo(f->name, sizeof(cl_float), relaxedMode);
 
@@ -61,23 +63,28 @@ int TestFunc_Int_Float(const Func *f, MTdata d, bool relaxedMode)
             return error;
     }
 
-    for (uint64_t i = 0; i < (1ULL << 32); i += step)
+    uint64_t begin, end;
+    GetShardRange(1ULL << 32, step, &begin, &end);
+    for (uint64_t i = begin; i < end; i += step)
     {
         // Init input array
         cl_uint *p = (cl_uint *)gIn;
         if (gWimpyMode)
         {
-            for (size_t j = 0; j < BUFFER_SIZE / sizeof(float); j++)
-                p[j] = (cl_uint)i + j * scale;
+            size_t n = gBufferSize / sizeof(float);
+            uint64_t count = WimpySampleCount(step, n);
+            for (size_t j = 0; j < n; j++)
+                p[j] = SampleFloatInput((cl_uint)i + j * scale,
+                                        i / step * n + j, count);
         }
         else
         {
-            for (size_t j = 0; j < BUFFER_SIZE / sizeof(float); j++)
+            for (size_t j = 0; j < gBufferSize / sizeof(float); j++)
                 p[j] = (uint32_t)i + j;
         }
 
-        if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer, CL_FALSE, 0,
-                                          BUFFER_SIZE, gIn, 0, NULL, NULL)))
+        if ((error = enqueue_write_staged(gQueue, gInBuffer, CL_FALSE, 0,
+                                          gBufferSize, gIn, 0, NULL, NULL)))
         {
             vlog_error("\n*** Error %d in clEnqueueWriteBuffer ***\n", error);
             return error;
@@ -89,9 +96,9 @@ int TestFunc_Int_Float(const Func *f, MTdata d, bool relaxedMode)
             uint32_t pattern = 0xffffdead;
             if (gHostFill)
             {
-                memset_pattern4(gOut[j], &pattern, BUFFER_SIZE);
-                if ((error = clEnqueueWriteBuffer(gQueue, gOutBuffer[j],
-                                                  CL_FALSE, 0, BUFFER_SIZE,
+                memset_pattern4(gOut[j], &pattern, gBufferSize);
+                if ((error = enqueue_write_staged(gQueue, gOutBuffer[j],
+                                                  CL_FALSE, 0, gBufferSize,
                                                   gOut[j], 0, NULL, NULL)))
                 {
                     vlog_error(
@@ -104,7 +111,7 @@ int TestFunc_Int_Float(const Func *f, MTdata d, bool relaxedMode)
             {
                 if ((error = clEnqueueFillBuffer(gQueue, gOutBuffer[j],
                                                  &pattern, sizeof(pattern), 0,
-                                                 BUFFER_SIZE, 0, NULL, NULL)))
+                                                 gBufferSize, 0, NULL, NULL)))
                 {
                     vlog_error("Error: clEnqueueFillBuffer failed! err: %d\n",
                                error);
@@ -117,8 +124,8 @@ int TestFunc_Int_Float(const Func *f, MTdata d, bool relaxedMode)
         for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
         {
             size_t vectorSize = sizeValues[j] * sizeof(cl_float);
-            size_t localCount = (BUFFER_SIZE + vectorSize - 1)
-                / vectorSize; // BUFFER_SIZE / vectorSize  rounded up
+            size_t localCount = (gBufferSize + vectorSize - 1)
+                / vectorSize; // gBufferSize / vectorSize  rounded up
             if ((error = clSetKernelArg(kernels[j][thread_id], 0,
                                         sizeof(gOutBuffer[j]), &gOutBuffer[j])))
             {
@@ -147,15 +154,15 @@ int TestFunc_Int_Float(const Func *f, MTdata d, bool relaxedMode)
         // Calculate the correctly rounded reference result
         int *r = (int *)gOut_Ref;
         float *s = (float *)gIn;
-        for (size_t j = 0; j < BUFFER_SIZE / sizeof(float); j++)
+        for (size_t j = 0; j < gBufferSize / sizeof(float); j++)
             r[j] = f->func.i_f(s[j]);
 
         // Read the data back
         for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
         {
             if ((error =
-                     clEnqueueReadBuffer(gQueue, gOutBuffer[j], CL_TRUE, 0,
-                                         BUFFER_SIZE, gOut[j], 0, NULL, NULL)))
+                     enqueue_read_staged(gQueue, gOutBuffer[j], CL_TRUE, 0,
+                                         gBufferSize, gOut[j], 0, NULL, NULL)))
             {
                 vlog_error("ReadArray failed %d\n", error);
                 goto exit;
@@ -166,8 +173,12 @@ int TestFunc_Int_Float(const Func *f, MTdata d, bool relaxedMode)
 
         // Verify data
         uint32_t *t = (uint32_t *)gOut_Ref;
-        for (size_t j = 0; j < BUFFER_SIZE / sizeof(float); j++)
+        for (size_t j = 0; j < gBufferSize / sizeof(float); j++)
         {
+            // Skip the elements that match for every vector size
+            j = FindFirstMismatch(t, gOut, j, gBufferSize / sizeof(float));
+            if (j == gBufferSize / sizeof(float)) break;
+
             for (auto k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++)
             {
                 uint32_t *q = (uint32_t *)(gOut[k]);
@@ -198,8 +209,8 @@ int TestFunc_Int_Float(const Func *f, MTdata d, bool relaxedMode)
             if (gVerboseBruteForce)
             {
                 vlog("base:%14" PRIu64 " step:%10" PRIu64
-                     "  bufferSize:%10d \n",
-                     i, step, BUFFER_SIZE);
+                     "  bufferSize:%10zu \n",
+                     i, step, gBufferSize);
             }
             else
             {
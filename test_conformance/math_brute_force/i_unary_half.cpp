@@ -16,6 +16,7 @@
 
 #include "common.h"
 #include "function_list.h"
+#include "shard.h"
 #include "test_functions.h"
 #include "utility.h"
 
@@ -47,8 +48,8 @@ int TestFunc_Int_Half(const Func *f, MTdata d, bool relaxedMode)
     KernelMatrix kernels;
     const unsigned thread_id = 0; // Test is currently not multithreaded.
     int ftz = f->ftz || 0 == (gHalfCapabilities & CL_FP_DENORM) || gForceFTZ;
-    uint64_t step = getTestStep(sizeof(cl_half), BUFFER_SIZE);
-    size_t bufferElements = std::min(BUFFER_SIZE / sizeof(cl_int),
+    uint64_t step = getTestStep(sizeof(cl_half), gBufferSize);
+    size_t bufferElements = std::min(gBufferSize / sizeof(cl_int),
                                      size_t(1ULL << (sizeof(cl_half) * 8)));
     size_t bufferSizeIn = bufferElements * sizeof(cl_half);
     size_t bufferSizeOut = bufferElements * sizeof(cl_int);
@@ -56,10 +57,7 @@ int TestFunc_Int_Half(const Func *f, MTdata d, bool relaxedMode)
     logFunctionInfo(f->name, sizeof(cl_half), relaxedMode);
     // This test is not using ThreadPool so we need to disable FTZ here
     // for reference computations
-    FPU_mode_type oldMode;
-    DisableFTZ(&oldMode);
-    std::shared_ptr<int> at_scope_exit(
-        nullptr, [&oldMode](int *) { RestoreFPState(&oldMode); });
+    FPStateGuard ftzGuard(kDisableFTZ);
 
     // Init the kernels
     {
@@ -71,14 +69,16 @@ int TestFunc_Int_Half(const Func *f, MTdata d, bool relaxedMode)
     }
     std::vector<float> s(bufferElements);
 
-    for (uint64_t i = 0; i < (1ULL << 16); i += step)
+    uint64_t begin, end;
+    GetShardRange(1ULL << 16, step, &begin, &end);
+    for (uint64_t i = begin; i < end; i += step)
     {
         // Init input array
         cl_ushort *p = (cl_ushort *)gIn;
 
         for (size_t j = 0; j < bufferElements; j++) p[j] = (cl_ushort)i + j;
 
-        if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer, CL_FALSE, 0,
+        if ((error = enqueue_write_staged(gQueue, gInBuffer, CL_FALSE, 0,
                                           bufferSizeIn, gIn, 0, NULL, NULL)))
         {
             vlog_error("\n*** Error %d in clEnqueueWriteBuffer ***\n", error);
@@ -92,7 +92,7 @@ int TestFunc_Int_Half(const Func *f, MTdata d, bool relaxedMode)
             if (gHostFill)
             {
                 memset_pattern4(gOut[j], &pattern, bufferSizeOut);
-                if ((error = clEnqueueWriteBuffer(gQueue, gOutBuffer[j],
+                if ((error = enqueue_write_staged(gQueue, gOutBuffer[j],
                                                   CL_FALSE, 0, bufferSizeOut,
                                                   gOut[j], 0, NULL, NULL)))
                 {
@@ -151,7 +151,7 @@ int TestFunc_Int_Half(const Func *f, MTdata d, bool relaxedMode)
         // Read the data back
         for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
         {
-            if ((error = clEnqueueReadBuffer(gQueue, gOutBuffer[j], CL_TRUE, 0,
+            if ((error = enqueue_read_staged(gQueue, gOutBuffer[j], CL_TRUE, 0,
                                              bufferSizeOut, gOut[j], 0, NULL,
                                              NULL)))
             {
@@ -16,6 +16,8 @@
 
 #include "common.h"
 #include "function_list.h"
+#include "sampling.h"
+#include "shard.h"
 #include "test_functions.h"
 #include "utility.h"
 
@@ -90,7 +92,7 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
 #define ref_func(s) (signbit_test ? func.i_f_f(s) : func.i_f(s))
 
     // start the map of the output arrays
-    cl_event e[VECTOR_SIZE_COUNT];
+    clEventWrapper mapped;
     cl_short *out[VECTOR_SIZE_COUNT];
 
     if (gHostFill)
@@ -100,7 +102,7 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
         {
             out[j] = (cl_short *)clEnqueueMapBuffer(
                 tinfo->tQueue, tinfo->outBuf[j], CL_FALSE, CL_MAP_WRITE, 0,
-                buffer_size, 0, NULL, e + j, &error);
+                buffer_size, 0, NULL, NULL, &error);
             if (error || NULL == out[j])
             {
                 vlog_error("Error: clEnqueueMapBuffer %d failed! err: %d\n", j,
@@ -109,15 +111,24 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
             }
         }
 
+        // One event for all the maps rather than one each
+        if ((error = enqueue_chain_end(tinfo->tQueue, &mapped)))
+        {
+            vlog_error("Error: clEnqueueMarkerWithWaitList failed! err: %d\n",
+                       error);
+            return error;
+        }
+
         // Get that moving
         if ((error = clFlush(tinfo->tQueue))) vlog("clFlush failed\n");
     }
 
     // Write the new values to the input array
     cl_ushort *p = (cl_ushort *)gIn + thread_id * buffer_elements;
-    for (j = 0; j < buffer_elements; j++) p[j] = base + j * scale;
+    for (j = 0; j < buffer_elements; j++)
+        p[j] = SampleHalfInput(base + j * scale, scale);
 
-    if ((error = clEnqueueWriteBuffer(tinfo->tQueue, tinfo->inBuf, CL_FALSE, 0,
+    if ((error = enqueue_write_staged(tinfo->tQueue, tinfo->inBuf, CL_FALSE, 0,
                                       buffer_size, p, 0, NULL, NULL)))
     {
         vlog_error("Error: clEnqueueWriteBuffer failed! err: %d\n", error);
@@ -126,19 +137,14 @@ cl_int TestHalf(cl_uint job_id, cl_uint thread_id, void *data)
 
     for (j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
     {
-        if (gHostFill)
+        if (gHostFill && j == gMinVectorSizeIndex)
         {
-            // Wait for the map to finish
-            if ((error = clWaitForEvents(1, e + j)))
+            // Wait for the maps to finish
+            if ((error = clWaitForEvents(1, &mapped)))
             {
                 vlog_error("Error: clWaitForEvents failed! err: %d\n", error);
                 return error;
             }
-            if ((error = clReleaseEvent(e[j])))
-            {
-                vlog_error("Error: clReleaseEvent failed! err: %d\n", error);
-                return error;
-            }
         }
 
         // Fill the result buffer with garbage, so that old results don't carry
@@ -338,7 +344,7 @@ int TestMacro_Int_Half(const Func *f, MTdata d, bool relaxedMode)
     TestInfo test_info(test_info_base);
 
     test_info.threadCount = GetThreadCount();
-    test_info.subBufferSize = BUFFER_SIZE
+    test_info.subBufferSize = gBufferSize
         / (sizeof(cl_half) * RoundUpToNextPowerOfTwo(test_info.threadCount));
     test_info.scale = getTestScale(sizeof(cl_half));
 
@@ -411,7 +417,8 @@ int TestMacro_Int_Half(const Func *f, MTdata d, bool relaxedMode)
 
     if (!gSkipCorrectnessTesting)
     {
-        error = ThreadPool_Do(TestHalf, test_info.jobCount, &test_info);
+        error = ThreadPool_DoShard(TestHalf, test_info.jobCount, &test_info,
+                                   test_info.subBufferSize);
 
         test_error(error, "ThreadPool_Do: TestHalf failed\n");
 
@@ -14,7 +14,11 @@
 // limitations under the License.
 //
 
+#include "common.h"
 #include "function_list.h"
+#include "reference_cache.h"
+#include "sampling.h"
+#include "shard.h"
 #include "sleep.h"
 #include "utility.h"
 
@@ -25,7 +29,11 @@
 #include <string>
 #include <vector>
 
+#include "harness/bufferSizing.h"
+#include "harness/deviceInfo.h"
+#include "harness/durationHistory.h"
 #include "harness/errorHelpers.h"
+#include "harness/hostAlloc.h"
 #include "harness/kernelHelpers.h"
 #include "harness/parseParameters.h"
 #include "harness/typeWrappers.h"
@@ -68,6 +76,7 @@ static bool gSkipRestOfTests;
 int gForceFTZ = 0;
 int gWimpyMode = 0;
 int gHostFill = 0;
+cl_uint gPipelineStages = 2;
 static int gHasDouble = 0;
 static int gTestFloat = 1;
 // This flag should be 'ON' by default and it can be changed through the command
@@ -106,6 +115,7 @@ cl_mem gOutBuffer2[VECTOR_SIZE_COUNT] = { NULL, NULL, NULL, NULL, NULL, NULL };
 static MTdataHolder gMTdata;
 cl_device_fp_config gFloatCapabilities = 0;
 int gWimpyReductionFactor = 32;
+size_t gBufferSize = DEFAULT_BUFFER_SIZE;
 int gVerboseBruteForce = 0;
 
 cl_half_rounding_mode gHalfRoundingMode = CL_HALF_RTE;
@@ -114,11 +124,13 @@ static int ParseArgs(int argc, const char **argv);
 static void PrintUsage(void);
 static void PrintFunctions(void);
 static test_status InitCL(cl_device_id device);
+static void ApplyTimeBudget(cl_device_id device);
 static void ReleaseCL(void);
 static int InitILogbConstants(void);
 static int IsTininessDetectedBeforeRounding(void);
 static int
 IsInRTZMode(void); // expensive. Please check gIsInRTZMode global instead.
+static void BuildAheadOf(const Func *current);
 
 static int doTest(const char *name)
 {
@@ -161,6 +173,8 @@ static int doTest(const char *name)
         return 0;
     }
 
+    BuildAheadOf(func_data);
+
     // if correctly rounded divide & sqrt are supported by the implementation
     // then test it; otherwise skip the test
     if (strcmp(func_data->name, "sqrt_cr") == 0
@@ -186,8 +200,14 @@ static int doTest(const char *name)
                 gTestCount++;
                 vlog("%3d: ", gTestCount);
                 // Test with relaxed requirements here.
-                if (func_data->vtbl_ptr->TestFunc(func_data, gMTdata,
-                                                  true /* relaxed mode */))
+                SetCurrentTest(func_data->name, "float", true);
+                SetBuildingTest(func_data->vtbl_ptr->TestFunc);
+                int failed = func_data->vtbl_ptr->TestFunc(
+                    func_data, gMTdata, true /* relaxed mode */);
+                ReportThroughput();
+                BuildAheadOf(func_data);
+                RecordShardResult(failed);
+                if (failed)
                 {
                     gFailCount++;
                     error++;
@@ -210,8 +230,14 @@ static int doTest(const char *name)
             gTestCount++;
             vlog("%3d: ", gTestCount);
             // Don't test with relaxed requirements.
-            if (func_data->vtbl_ptr->TestFunc(func_data, gMTdata,
-                                              false /* relaxed mode */))
+            SetCurrentTest(func_data->name, "float", false);
+            SetBuildingTest(func_data->vtbl_ptr->TestFunc);
+            int failed = func_data->vtbl_ptr->TestFunc(
+                func_data, gMTdata, false /* relaxed mode */);
+            ReportThroughput();
+            BuildAheadOf(func_data);
+            RecordShardResult(failed);
+            if (failed)
             {
                 gFailCount++;
                 error++;
@@ -229,8 +255,14 @@ static int doTest(const char *name)
             gTestCount++;
             vlog("%3d: ", gTestCount);
             // Don't test with relaxed requirements.
-            if (func_data->vtbl_ptr->DoubleTestFunc(func_data, gMTdata,
-                                                    false /* relaxed mode*/))
+            SetCurrentTest(func_data->name, "double", false);
+            SetBuildingTest(func_data->vtbl_ptr->DoubleTestFunc);
+            int failed = func_data->vtbl_ptr->DoubleTestFunc(
+                func_data, gMTdata, false /* relaxed mode*/);
+            ReportThroughput();
+            BuildAheadOf(func_data);
+            RecordShardResult(failed);
+            if (failed)
             {
                 gFailCount++;
                 error++;
@@ -246,8 +278,14 @@ static int doTest(const char *name)
         {
             gTestCount++;
             vlog("%3d: ", gTestCount);
-            if (func_data->vtbl_ptr->HalfTestFunc(func_data, gMTdata,
-                                                  false /* relaxed mode*/))
+            SetCurrentTest(func_data->name, "half", false);
+            SetBuildingTest(func_data->vtbl_ptr->HalfTestFunc);
+            int failed = func_data->vtbl_ptr->HalfTestFunc(
+                func_data, gMTdata, false /* relaxed mode*/);
+            ReportThroughput();
+            BuildAheadOf(func_data);
+            RecordShardResult(failed);
+            if (failed)
             {
                 gFailCount++;
                 error++;
@@ -318,6 +356,65 @@ static test_definition test_list[] = {
 
 static const int test_num = ARRAY_SIZE(test_list);
 
+// How many of the functions after the one being tested to build the programs
+// of ahead of time, from CL_TEST_BUILD_AHEAD
+static size_t BuildAheadDepth()
+{
+    static const size_t depth = [] {
+        const char *env = getenv("CL_TEST_BUILD_AHEAD");
+        return env != NULL ? (size_t)strtoul(env, NULL, 0) : (size_t)2;
+    }();
+    return depth;
+}
+
+// Queue the builds of the programs that f will be tested with, in the
+// precisions and modes doTest tests it in
+static void BuildAheadFunction(const Func *f)
+{
+    static const bool relaxedSupported =
+        get_device_cl_version(gDevice) > Version(1, 2);
+    const vtbl *v = f->vtbl_ptr;
+    if (gTestFastRelaxed && f->relaxed && relaxedSupported)
+        BuildAhead(f, v->TestFunc, true);
+    if (gTestFloat) BuildAhead(f, v->TestFunc, false);
+    if (gHasDouble && v->DoubleTestFunc != NULL && f->dfunc.p != NULL)
+        BuildAhead(f, v->DoubleTestFunc, false);
+    if (gHasHalf && v->HalfTestFunc != NULL)
+        BuildAhead(f, v->HalfTestFunc, false);
+}
+
+// Start building the programs of the functions that come after current in
+// this run. The tests themselves still run one after the other, so their
+// reports keep their order, and at most BuildAheadDepth() functions are
+// built ahead. Called again after each test of current, as its generators
+// become known.
+static void BuildAheadOf(const Func *current)
+{
+    static std::vector<const Func *> order;
+    if (BuildAheadDepth() == 0) return;
+    if (order.empty())
+    {
+        std::vector<const char *> names(gTestNames.begin() + 1,
+                                        gTestNames.end());
+        if (names.empty())
+            for (int i = 0; i < test_num; i++)
+                names.push_back(test_list[i].name);
+        for (const char *name : names)
+            for (size_t i = 0; i < functionListCount; i++)
+                if (strcmp(functionList[i].name, name) == 0
+                    && functionList[i].func.p != NULL
+                    && !(gStartTestNumber != ~0u && i < gStartTestNumber)
+                    && i <= gEndTestNumber)
+                    order.push_back(functionList + i);
+    }
+
+    auto it = std::find(order.begin(), order.end(), current);
+    if (it == order.end()) return;
+    size_t next = it - order.begin() + 1;
+    size_t end = std::min(order.size(), next + BuildAheadDepth());
+    for (size_t i = next; i < end; i++) BuildAheadFunction(order[i]);
+}
+
 #pragma mark -
 
 int main(int argc, const char *argv[])
@@ -349,7 +446,8 @@ int main(int argc, const char *argv[])
     vlog("\n-------------------------------------------------------------------"
          "----------------------------------------\n");
 
-    gMTdata = MTdataHolder(gRandomSeed);
+    // Give each shard its own random inputs for the tests that use them
+    gMTdata = MTdataHolder(gRandomSeed + gShardIndex);
 
     FPU_mode_type oldMode;
     DisableFTZ(&oldMode);
@@ -448,6 +546,10 @@ static int ParseArgs(int argc, const char **argv)
 
                     case 'b': gHostFill ^= 1; break;
 
+                    case 'o':
+                        gPipelineStages = (1 == gPipelineStages) ? 2 : 1;
+                        break;
+
                     case 'z': gForceFTZ ^= 1; break;
 
                     case '1':
@@ -528,6 +630,31 @@ static int ParseArgs(int argc, const char **argv)
         vlog("*** Detected CL_WIMPY_MODE env                          ***\n");
         gWimpyMode = 1;
     }
+    if (getenv("CL_MATH_WIMPY_STRIDED")) gWimpyStrided = true;
+
+    // Check for a directory to cache reference results in
+    gReferenceCacheDir = getenv("CL_MATH_REFERENCE_CACHE");
+    if (gReferenceCacheDir && '\0' == gReferenceCacheDir[0])
+        gReferenceCacheDir = NULL;
+    if (gReferenceCacheDir)
+        vlog("\nCaching reference results in %s\n", gReferenceCacheDir);
+
+    // Check whether this process only runs part of each function
+    const char *shard = getenv("CL_MATH_SHARD");
+    if (shard && '\0' != shard[0])
+    {
+        if (!ParseShard(shard))
+        {
+            vlog_error("\nInvalid CL_MATH_SHARD \"%s\", expected "
+                       "\"index/count\"\n",
+                       shard);
+            return -1;
+        }
+        vlog("\nRunning shard %u of %u\n", gShardIndex, gShardCount);
+    }
+    gShardResultsFile = getenv("CL_MATH_SHARD_RESULTS");
+    if (gShardResultsFile && '\0' == gShardResultsFile[0])
+        gShardResultsFile = NULL;
 
     PrintArch();
 
@@ -580,6 +707,8 @@ static void PrintUsage(void)
          "1-10, default factor(%u)\n",
          gWimpyReductionFactor);
     vlog("\t\t-b\tFill buffers on host instead of device. (Default: off)\n");
+    vlog("\t\t-o\tToggle overlap of device execution with host verification "
+         "in pipelined tests. (Default: on)\n");
     vlog("\t\t-z\tToggle FTZ mode (Section 6.5.3) for all functions. (Set by "
          "device capabilities by default.)\n");
     vlog("\t\t-v\tToggle Verbosity (Default: off)\n ");
@@ -597,6 +726,21 @@ static void PrintUsage(void)
          "will be run.\n");
     vlog("\tYou may pass CL_DEVICE_TYPE_CPU/GPU/ACCELERATOR to select the "
          "device.\n");
+    vlog("\tSet CL_MATH_REFERENCE_CACHE to a directory to keep reference "
+         "results\n");
+    vlog("\tthere across runs. Each exhaustively tested function needs up "
+         "to 16GB.\n");
+    vlog("\tSet CL_MATH_SHARD to \"i/N\" to run only the i-th of N parts of "
+         "each\n");
+    vlog("\tfunction, counting from 0. Set CL_MATH_SHARD_RESULTS to a file "
+         "to record\n");
+    vlog("\tthe verdicts in, then combine the files of all shards with\n");
+    vlog("\tmerge_math_brute_force_shards.py.\n");
+    vlog("\tIn wimpy mode the unary functions test special values, binade "
+         "boundaries\n");
+    vlog("\tand stratified samples of every binade. Set "
+         "CL_MATH_WIMPY_STRIDED to test\n");
+    vlog("\tevenly strided inputs instead.\n");
     vlog("\n");
 }
 
@@ -745,6 +889,13 @@ test_status InitCL(cl_device_id device)
         return TEST_FAIL;
     }
 
+    // There are three inputs and two outputs per vector size on the device.
+    // Verification streams through up to three inputs, the reference and the
+    // output for one vector size at a time.
+    gBufferSize = ChooseBufferSize(
+        gContext, gQueue, gDevice, DEFAULT_BUFFER_SIZE,
+        3 + 2 * (gMaxVectorSizeIndex - gMinVectorSizeIndex), 5);
+
     // Allocate buffers
     cl_uint min_alignment = 0;
     error = clGetDeviceInfo(gDevice, CL_DEVICE_MEM_BASE_ADDR_ALIGN,
@@ -756,24 +907,25 @@ test_status InitCL(cl_device_id device)
     }
     min_alignment >>= 3; // convert bits to bytes
 
-    gIn = align_malloc(BUFFER_SIZE, min_alignment);
+    gIn = host_buffer_alloc(gBufferSize, min_alignment);
     if (NULL == gIn) return TEST_FAIL;
-    gIn2 = align_malloc(BUFFER_SIZE, min_alignment);
+    gIn2 = host_buffer_alloc(gBufferSize, min_alignment);
     if (NULL == gIn2) return TEST_FAIL;
-    gIn3 = align_malloc(BUFFER_SIZE, min_alignment);
+    gIn3 = host_buffer_alloc(gBufferSize, min_alignment);
     if (NULL == gIn3) return TEST_FAIL;
-    gOut_Ref = align_malloc(BUFFER_SIZE, min_alignment);
+    gOut_Ref = host_buffer_alloc(gBufferSize, min_alignment);
     if (NULL == gOut_Ref) return TEST_FAIL;
-    gOut_Ref2 = align_malloc(BUFFER_SIZE, min_alignment);
+    gOut_Ref2 = host_buffer_alloc(gBufferSize, min_alignment);
     if (NULL == gOut_Ref2) return TEST_FAIL;
 
     for (i = gMinVectorSizeIndex; i < gMaxVectorSizeIndex; i++)
     {
-        gOut[i] = align_malloc(BUFFER_SIZE, min_alignment);
+        gOut[i] = host_buffer_alloc(gBufferSize, min_alignment);
         if (NULL == gOut[i]) return TEST_FAIL;
-        gOut2[i] = align_malloc(BUFFER_SIZE, min_alignment);
+        gOut2[i] = host_buffer_alloc(gBufferSize, min_alignment);
         if (NULL == gOut2[i]) return TEST_FAIL;
     }
+    host_buffer_log_policy();
 
     cl_mem_flags device_flags = CL_MEM_READ_ONLY;
     // save a copy on the host device to make this go faster
@@ -784,7 +936,7 @@ test_status InitCL(cl_device_id device)
 
     // setup input buffers
     gInBuffer =
-        clCreateBuffer(gContext, device_flags, BUFFER_SIZE, gIn, &error);
+        clCreateBuffer(gContext, device_flags, gBufferSize, gIn, &error);
     if (gInBuffer == NULL || error)
     {
         vlog_error("clCreateBuffer1 failed for input (%d)\n", error);
@@ -792,7 +944,7 @@ test_status InitCL(cl_device_id device)
     }
 
     gInBuffer2 =
-        clCreateBuffer(gContext, device_flags, BUFFER_SIZE, gIn2, &error);
+        clCreateBuffer(gContext, device_flags, gBufferSize, gIn2, &error);
     if (gInBuffer2 == NULL || error)
     {
         vlog_error("clCreateBuffer2 failed for input (%d)\n", error);
@@ -800,7 +952,7 @@ test_status InitCL(cl_device_id device)
     }
 
     gInBuffer3 =
-        clCreateBuffer(gContext, device_flags, BUFFER_SIZE, gIn3, &error);
+        clCreateBuffer(gContext, device_flags, gBufferSize, gIn3, &error);
     if (gInBuffer3 == NULL || error)
     {
         vlog_error("clCreateBuffer3 failed for input (%d)\n", error);
@@ -817,14 +969,14 @@ test_status InitCL(cl_device_id device)
         device_flags |= CL_MEM_COPY_HOST_PTR;
     for (i = gMinVectorSizeIndex; i < gMaxVectorSizeIndex; i++)
     {
-        gOutBuffer[i] = clCreateBuffer(gContext, device_flags, BUFFER_SIZE,
+        gOutBuffer[i] = clCreateBuffer(gContext, device_flags, gBufferSize,
                                        gOut[i], &error);
         if (gOutBuffer[i] == NULL || error)
         {
             vlog_error("clCreateBuffer failed for output (%d)\n", error);
             return TEST_FAIL;
         }
-        gOutBuffer2[i] = clCreateBuffer(gContext, device_flags, BUFFER_SIZE,
+        gOutBuffer2[i] = clCreateBuffer(gContext, device_flags, gBufferSize,
                                         gOut2[i], &error);
         if (gOutBuffer2[i] == NULL || error)
         {
@@ -934,12 +1086,89 @@ test_status InitCL(cl_device_id device)
         }
     }
 
+    ApplyTimeBudget(device);
+
     return TEST_PASS;
 }
 
+// The fraction of each input domain tested, going by the float scale of
+// getTestScale
+static double MathCoverage(bool wimpyMode, int reductionFactor)
+{
+    if (wimpyMode) return 1.0 / (sizeof(float) * 2 * reductionFactor);
+    if (gIsEmbedded) return 1.0 / EMBEDDED_REDUCTION_FACTOR;
+    return 1.0;
+}
+
+// Record the durations of this run under the options that change how much
+// work the functions do, and with --time-budget pick the largest coverage
+// that earlier runs say will fit
+static void ApplyTimeBudget(cl_device_id device)
+{
+    const char *suite = strrchr(appName, '/');
+    suite = suite ? suite + 1 : appName;
+
+    std::string mode;
+    if (gTestFloat) mode += "float ";
+    if (gHasDouble) mode += "double ";
+    if (gHasHalf) mode += "half ";
+    if (gTestFastRelaxed) mode += "relaxed ";
+    if (gSkipCorrectnessTesting) mode += "link ";
+    mode += "vec" + std::to_string(sizeValues[gMinVectorSizeIndex]) + "-"
+        + std::to_string(sizeValues[gMaxVectorSizeIndex - 1]);
+
+    if (gTimeBudgetSeconds > 0)
+    {
+        const char *fileName = getenv("CL_CONFORMANCE_DURATION_DB");
+        std::vector<std::string> tests(gTestNames.begin() + 1,
+                                       gTestNames.end());
+        if (tests.empty())
+            for (int i = 0; i < test_num; i++)
+                tests.push_back(test_list[i].name);
+
+        DurationHistory history;
+        WimpyChoice choice;
+        std::string deviceName = get_device_name(device);
+        if (fileName == NULL || !history.Load(fileName))
+        {
+            vlog("\nIgnoring --time-budget as CL_CONFORMANCE_DURATION_DB "
+                 "isn't set.\n");
+        }
+        else if (!choose_wimpy_for_budget(history, deviceName, suite, mode,
+                                          tests, gTimeBudgetSeconds,
+                                          MathCoverage, 1024, choice)
+                 && choice.unknownTests == tests.size())
+        {
+            vlog("\nIgnoring --time-budget as no function has run on this "
+                 "device in this mode before.\n");
+        }
+        else
+        {
+            gWimpyMode = choice.wimpyMode;
+            gWimpyReductionFactor = choice.reductionFactor;
+            vlog("\nTime budget of %.0f s: %s, expected to take %.0f s",
+                 gTimeBudgetSeconds,
+                 gWimpyMode ? "wimpy mode" : "full testing", choice.seconds);
+            if (gWimpyMode)
+                vlog(" with a reduction factor of %d", gWimpyReductionFactor);
+            if (choice.unknownTests)
+                vlog(" plus %zu functions without a history",
+                     choice.unknownTests);
+            vlog(".\n");
+            if (choice.seconds > gTimeBudgetSeconds)
+                vlog("*** WARNING: Even the smallest coverage takes longer "
+                     "than the time budget! ***\n");
+        }
+    }
+
+    set_duration_key(suite, mode,
+                     MathCoverage(gWimpyMode, gWimpyReductionFactor));
+}
+
 static void ReleaseCL(void)
 {
     uint32_t i;
+    StopBuildAhead();
     clReleaseMemObject(gInBuffer);
     clReleaseMemObject(gInBuffer2);
     clReleaseMemObject(gInBuffer3);
@@ -948,19 +1177,21 @@ static void ReleaseCL(void)
         clReleaseMemObject(gOutBuffer[i]);
         clReleaseMemObject(gOutBuffer2[i]);
     }
+    release_staging_buffers(gContext);
+    release_device_random(gContext);
     clReleaseCommandQueue(gQueue);
     clReleaseContext(gContext);
 
-    align_free(gIn);
-    align_free(gIn2);
-    align_free(gIn3);
-    align_free(gOut_Ref);
-    align_free(gOut_Ref2);
+    host_buffer_free(gIn);
+    host_buffer_free(gIn2);
+    host_buffer_free(gIn3);
+    host_buffer_free(gOut_Ref);
+    host_buffer_free(gOut_Ref2);
 
     for (i = gMinVectorSizeIndex; i < gMaxVectorSizeIndex; i++)
     {
-        align_free(gOut[i]);
-        align_free(gOut2[i]);
+        host_buffer_free(gOut[i]);
+        host_buffer_free(gOut2[i]);
     }
 }
 
@@ -1023,7 +1254,7 @@ int InitILogbConstants(void)
     {
         cl_int ilogb0, ilogbnan;
     } data;
-    if ((error = clEnqueueReadBuffer(gQueue, gOutBuffer[gMinVectorSizeIndex],
+    if ((error = enqueue_read_staged(gQueue, gOutBuffer[gMinVectorSizeIndex],
                                      CL_TRUE, 0, sizeof(data), &data, 0, NULL,
                                      NULL)))
     {
@@ -1087,7 +1318,7 @@ int IsTininessDetectedBeforeRounding(void)
     {
         cl_uint f;
     } data;
-    if ((error = clEnqueueReadBuffer(gQueue, gOutBuffer[gMinVectorSizeIndex],
+    if ((error = enqueue_read_staged(gQueue, gOutBuffer[gMinVectorSizeIndex],
                                      CL_TRUE, 0, sizeof(data), &data, 0, NULL,
                                      NULL)))
     {
@@ -1149,7 +1380,7 @@ static int IsInRTZMode(void)
     {
         cl_int isRTZ;
     } data;
-    if ((error = clEnqueueReadBuffer(gQueue, gOutBuffer[gMinVectorSizeIndex],
+    if ((error = enqueue_read_staged(gQueue, gOutBuffer[gMinVectorSizeIndex],
                                      CL_TRUE, 0, sizeof(data), &data, 0, NULL,
                                      NULL)))
     {
@@ -0,0 +1,61 @@
+#!/usr/bin/env python3
+
+#  //  OpenCL Conformance Tests
+#  //
+#  //  Copyright (c) 2026 The Khronos Group Inc.
+#  //
+
+# Combine the CL_MATH_SHARD_RESULTS files written by the shards of a
+# math_brute_force run into a single verdict. A function only passes if
+# every one of its shards ran and passed.
+#
+# usage: merge_math_brute_force_shards.py results_file [results_file ...]
+
+import sys
+
+
+def main(paths):
+    # (name, type, mode) -> {shard count -> {shard index -> passed}}
+    results = {}
+    for path in paths:
+        with open(path) as f:
+            for number, line in enumerate(f, 1):
+                fields = line.split()
+                if len(fields) != 5:
+                    print("%s:%d: malformed line" % (path, number))
+                    return 1
+                shard, name, type, mode, verdict = fields
+                index, count = (int(x) for x in shard.split("/"))
+                shards = results.setdefault((name, type, mode), {})
+                runs = shards.setdefault(count, {})
+                passed = verdict == "pass"
+                runs[index] = runs.get(index, True) and passed
+
+    failures = 0
+    for key in sorted(results):
+        shards = results[key]
+        problems = []
+        if len(shards) > 1:
+            problems.append("mixed shard counts %s" % sorted(shards))
+        for count, runs in sorted(shards.items()):
+            missing = [i for i in range(count) if i not in runs]
+            failed = [i for i in sorted(runs) if not runs[i]]
+            if missing:
+                problems.append("missing shards %s of %d" % (missing, count))
+            if failed:
+                problems.append("failed shards %s of %d" % (failed, count))
+        verdict = "FAILED (" + "; ".join(problems) + ")" if problems else \
+            "passed"
+        print("%-20s %-7s %-8s %s" % (key + (verdict,)))
+        if problems:
+            failures += 1
+
+    print("\n%d of %d tests failed" % (failures, len(results)))
+    return 1 if failures or not results else 0
+
+
+if __name__ == "__main__":
+    if len(sys.argv) < 2:
+        print("usage: %s results_file [results_file ...]" % sys.argv[0])
+        sys.exit(2)
+    sys.exit(main(sys.argv[1:]))
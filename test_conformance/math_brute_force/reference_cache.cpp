@@ -0,0 +1,195 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "reference_cache.h"
+
+#include <atomic>
+#include <cstring>
+#include <string>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+const char *gReferenceCacheDir = NULL;
+
+namespace {
+
+// Bump the version whenever a reference function changes its results.
+const cl_uint kCacheVersion = 1;
+const char kCacheMagic[8] = { 'C', 'L', 'M', 'A', 'T', 'H', 'R', 'C' };
+const size_t kPageSize = 4096;
+
+struct CacheHeader
+{
+    char magic[8];
+    cl_uint version;
+    cl_uint elementSize;
+    cl_ulong elementCount;
+};
+
+size_t RoundUpToPage(cl_ulong size)
+{
+    return (size_t)((size + kPageSize - 1) & ~(cl_ulong)(kPageSize - 1));
+}
+
+cl_ulong BlockCount(cl_ulong elementCount)
+{
+    return (elementCount + ReferenceCache::kBlockElements - 1)
+        / ReferenceCache::kBlockElements;
+}
+
+} // anonymous namespace
+
+ReferenceCache::ReferenceCache(void *map, size_t mapSize, size_t elementSize,
+                               cl_ulong elementCount)
+    : map(map), mapSize(mapSize), elementSize(elementSize),
+      elementCount(elementCount)
+{
+    filled = (cl_uchar *)map + kPageSize;
+    data = (cl_uchar *)map + kPageSize
+        + RoundUpToPage(BlockCount(elementCount));
+}
+
+#if defined(_WIN32)
+
+std::unique_ptr<ReferenceCache>
+ReferenceCache::Open(const char *name, const char *type, bool ftz, bool rtz,
+                     bool relaxed, size_t elementSize, cl_ulong elementCount)
+{
+    if (gReferenceCacheDir)
+        vlog("\tReference caching is not supported on this platform\n");
+    return nullptr;
+}
+
+ReferenceCache::~ReferenceCache() {}
+
+#else
+
+std::unique_ptr<ReferenceCache>
+ReferenceCache::Open(const char *name, const char *type, bool ftz, bool rtz,
+                     bool relaxed, size_t elementSize, cl_ulong elementCount)
+{
+    if (NULL == gReferenceCacheDir) return nullptr;
+
+    std::string path = std::string(gReferenceCacheDir) + "/" + name + "_"
+        + type + (rtz ? "_rtz" : "_rte") + (ftz ? "_ftz" : "")
+        + (relaxed ? "_relaxed" : "") + ".bin";
+
+    cl_ulong fileSize = kPageSize + RoundUpToPage(BlockCount(elementCount))
+        + (cl_ulong)elementSize * elementCount;
+    if (fileSize != (size_t)fileSize)
+    {
+        vlog_error("\tReference cache %s is too large for this host\n",
+                   path.c_str());
+        return nullptr;
+    }
+
+    int fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0)
+    {
+        vlog_error("\tUnable to open reference cache %s\n", path.c_str());
+        return nullptr;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) || (0 == st.st_size && ftruncate(fd, (off_t)fileSize)))
+    {
+        vlog_error("\tUnable to size reference cache %s\n", path.c_str());
+        close(fd);
+        return nullptr;
+    }
+    if (0 != st.st_size && (off_t)fileSize != st.st_size)
+    {
+        vlog_error("\tReference cache %s is stale or corrupt, delete it to "
+                   "rebuild it\n",
+                   path.c_str());
+        close(fd);
+        return nullptr;
+    }
+
+    // The file is sparse, only the blocks written so far use disk space.
+    void *map = mmap(NULL, (size_t)fileSize, PROT_READ | PROT_WRITE,
+                     MAP_SHARED, fd, 0);
+    close(fd);
+    if (MAP_FAILED == map)
+    {
+        vlog_error("\tUnable to map reference cache %s\n", path.c_str());
+        return nullptr;
+    }
+
+    // A new file is all zeros. Concurrent runs write identical headers.
+    CacheHeader expected = {};
+    memcpy(expected.magic, kCacheMagic, sizeof(kCacheMagic));
+    expected.version = kCacheVersion;
+    expected.elementSize = (cl_uint)elementSize;
+    expected.elementCount = elementCount;
+
+    CacheHeader *header = (CacheHeader *)map;
+    CacheHeader empty = {};
+    if (0 == memcmp(header, &empty, sizeof(empty)))
+        memcpy(header, &expected, sizeof(expected));
+
+    if (memcmp(header, &expected, sizeof(expected)))
+    {
+        vlog_error("\tReference cache %s is stale or corrupt, delete it to "
+                   "rebuild it\n",
+                   path.c_str());
+        munmap(map, (size_t)fileSize);
+        return nullptr;
+    }
+
+    return std::unique_ptr<ReferenceCache>(new ReferenceCache(
+        map, (size_t)fileSize, elementSize, elementCount));
+}
+
+ReferenceCache::~ReferenceCache() { munmap(map, mapSize); }
+
+#endif
+
+bool ReferenceCache::Read(cl_ulong index, void *out, size_t count) const
+{
+    if (0 == count) return true;
+    if (index + count > elementCount) return false;
+
+    cl_ulong first = index / kBlockElements;
+    cl_ulong last = (index + count - 1) / kBlockElements;
+    for (cl_ulong b = first; b <= last; b++)
+        if (!filled[b]) return false;
+
+    // Pairs with the release fence in Write
+    std::atomic_thread_fence(std::memory_order_acquire);
+    memcpy(out, data + index * elementSize, count * elementSize);
+    return true;
+}
+
+void ReferenceCache::Write(cl_ulong index, const void *in, size_t count)
+{
+    if (0 == count || index + count > elementCount) return;
+
+    memcpy(data + index * elementSize, in, count * elementSize);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    // Only mark the blocks that are completely covered
+    cl_ulong end = index + count;
+    cl_ulong first = (index + kBlockElements - 1) / kBlockElements;
+    cl_ulong last = end == elementCount ? BlockCount(elementCount)
+                                        : end / kBlockElements;
+    for (cl_ulong b = first; b < last; b++) filled[b] = 1;
+}
@@ -0,0 +1,70 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef REFERENCE_CACHE_H
+#define REFERENCE_CACHE_H
+
+#include "utility.h"
+
+#include <memory>
+
+// Directory holding the reference caches, taken from the
+// CL_MATH_REFERENCE_CACHE environment variable. NULL if caching is disabled.
+extern const char *gReferenceCacheDir;
+
+// Memory mapped store of reference results for one function over its whole
+// input domain, indexed by the bit pattern of the input. The first run fills
+// the store and later runs, on any device, read the results back instead of
+// recomputing them.
+//
+// Results are tracked in blocks of kBlockElements, a block reads back only
+// once a single Write covered all of it. Writes from several threads, or
+// several processes sharing the directory, are fine as long as they store the
+// same results.
+class ReferenceCache {
+public:
+    static const size_t kBlockElements = 1024;
+
+    // Return the store for the function and mode described by the arguments,
+    // creating it as needed. Return nullptr if caching is disabled or the
+    // store can not be opened.
+    static std::unique_ptr<ReferenceCache>
+    Open(const char *name, const char *type, bool ftz, bool rtz, bool relaxed,
+         size_t elementSize, cl_ulong elementCount);
+
+    ~ReferenceCache();
+
+    // Copy count results starting at index into out. Return false without
+    // touching out if any of them is not in the store yet.
+    bool Read(cl_ulong index, void *out, size_t count) const;
+
+    // Store count results starting at index.
+    void Write(cl_ulong index, const void *in, size_t count);
+
+private:
+    ReferenceCache(void *map, size_t mapSize, size_t elementSize,
+                   cl_ulong elementCount);
+    ReferenceCache(const ReferenceCache &) = delete;
+    ReferenceCache &operator=(const ReferenceCache &) = delete;
+
+    void *map;
+    size_t mapSize;
+    size_t elementSize;
+    cl_ulong elementCount;
+    volatile cl_uchar *filled; // one flag per block
+    cl_uchar *data;
+};
+
+#endif /* REFERENCE_CACHE_H */
@@ -484,23 +484,21 @@ float reference_fma(float a, float b, float c, int shouldFlush)
         0 == (ub.u & ~kMSB) || // b == 0, defeat host FTZ behavior
         0 == (uc.u & ~kMSB)) // c == 0, defeat host FTZ behavior
     {
-        FPU_mode_type oldMode;
         RoundingMode oldRoundMode = kRoundToNearestEven;
         if (isinf(c) && !isinf(a) && !isinf(b)) return (c + a) + b;
 
         if (gIsInRTZMode) oldRoundMode = set_round(kRoundTowardZero, kfloat);
 
-        memset(&oldMode, 0, sizeof(oldMode));
-        if (shouldFlush) ForceFTZ(&oldMode);
-
-        a = (float)reference_multiply(
-            a, b); // some risk that the compiler will insert a non-compliant
-                   // fma here on some platforms.
-        a = (float)reference_add(
-            a,
-            c); // We use STDC FP_CONTRACT OFF above to attempt to defeat that.
-
-        if (shouldFlush) RestoreFPState(&oldMode);
+        {
+            // Costs no write when the caller already is in FTZ mode
+            FPStateGuard ftzGuard(shouldFlush ? kForceFTZ : kKeepFTZ);
+
+            a = (float)reference_multiply(
+                a, b); // some risk that the compiler will insert a
+                       // non-compliant fma here on some platforms.
+            a = (float)reference_add(a, c); // We use STDC FP_CONTRACT OFF
+                                            // above to attempt to defeat that.
+        }
 
         if (gIsInRTZMode) set_round(oldRoundMode, kfloat);
         return a;
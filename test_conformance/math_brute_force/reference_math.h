@@ -236,4 +236,36 @@ long double reference_ldexpl(long double x, int n);
 long double reference_assignmentl(long double x);
 int reference_notl(long double x);
 
+// -- batched float references, see reference_math_simd.cpp --
+
+// Each of these computes out[i] = (float)ref(in[i]) for count elements, giving
+// exactly the same results as calling the scalar reference in a loop.
+typedef void (*BatchReference_f_f)(float* out, const float* in, size_t count);
+typedef void (*BatchReference_f_ff)(float* out, const float* x, const float* y,
+                                    size_t count);
+typedef void (*BatchReference_fma)(float* out, const float* a, const float* b,
+                                   const float* c, size_t count);
+
+// Return NULL when there is no batched version of ref on this host.
+BatchReference_f_f GetBatchReference(double (*ref)(double));
+BatchReference_f_ff GetBatchReference(double (*ref)(double, double));
+BatchReference_f_ff GetBatchReference(float (*ref)(float, float));
+BatchReference_fma GetBatchReference(float (*ref)(float, float, float, int));
+
+// The double precision versions compute out[i] = (double)ref(in[i]) with the
+// same results as the scalar long double references.
+typedef void (*BatchReference_d_d)(double* out, const double* in, size_t count);
+typedef void (*BatchReference_d_dd)(double* out, const double* x,
+                                    const double* y, size_t count);
+typedef void (*BatchReference_d_ddd)(double* out, const double* a,
+                                     const double* b, const double* c,
+                                     size_t count);
+
+BatchReference_d_d GetBatchReference(long double (*ref)(long double));
+BatchReference_d_dd GetBatchReference(long double (*ref)(long double,
+                                                         long double));
+BatchReference_d_ddd GetBatchReference(long double (*ref)(long double,
+                                                          long double,
+                                                          long double));
+
 #endif
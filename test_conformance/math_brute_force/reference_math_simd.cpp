@@ -0,0 +1,1522 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Vectorized batch versions of the hottest single and double precision
+// references.
+//
+// Each batch function computes out[i] = (float)ref(in[i]) and must give the
+// same bits as the scalar reference. sqrt, divide and fma repeat the exact
+// operations of the scalar references on several lanes at once. exp, log, sin
+// and cos are evaluated with polynomials accurate to a few double ulps; a lane
+// whose result, widened by a generous error bound, does not round to a single
+// float (or which falls outside the domain handled by the polynomial) is
+// recomputed with the scalar reference.
+//
+// fabs, copysign, fmin, fmax, floor, ceil, trunc, rint and sqrt are exact in
+// single precision, so they work on float lanes directly, most with integer
+// and bitwise operations. Lanes with a NaN or denormal input, whose handling
+// depends on how the host treats them, and NaN results use the scalar
+// references. FirstFloatMismatch is the matching comparison of results.
+//
+// The double precision batches match the long double references instead.
+// add, subtract, multiply, divide, sqrt, fmin, fmax and fma (where the host
+// has one) are exact double operations. exp and log are evaluated in
+// double-double arithmetic with table driven reductions to about 2^-67 and,
+// like the single precision polynomials, fall back to the scalar reference
+// on lanes whose result is too close to half way between two doubles.
+//
+// The kernels are written once with GCC/Clang vector extensions and compiled
+// for SSE2 and AVX2 (NEON on aarch64), AVX2 is picked at runtime when the host
+// supports it. Other compilers and architectures simply use the scalar
+// references.
+
+#include "reference_math.h"
+#include "utility.h"
+
+#include <cstring>
+#include <fenv.h>
+
+#if (defined(__GNUC__) || defined(__clang__))                                 \
+    && (defined(__x86_64__) || defined(__aarch64__))
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#else
+#include <arm_neon.h>
+#endif
+
+// The kernels below are plain inline templates, the entry point for each
+// target pulls all of them in with the flatten attribute so that they are
+// compiled for that target. The warning about the ABI of wide vector
+// arguments only concerns those helpers.
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+namespace {
+
+template <int W> struct SimdTypes
+{
+    typedef double vd __attribute__((vector_size(sizeof(double) * W)));
+    typedef float vf __attribute__((vector_size(sizeof(float) * W)));
+    typedef int64_t vi __attribute__((vector_size(sizeof(int64_t) * W)));
+    typedef int32_t vfi __attribute__((vector_size(sizeof(int32_t) * W)));
+};
+
+// Relative error bound used to decide whether a polynomial result is certain
+// to round to the same float as the scalar reference. Both the polynomials
+// below and the scalar references are accurate to better than 2^-46.
+static const double kErrorBound = 0x1.0p-40;
+
+static const int64_t kExponentMask = 0x7ff0000000000000LL;
+static const int64_t kMantissaMask = 0x000fffffffffffffLL;
+static const int64_t kOneBits = 0x3ff0000000000000LL;
+static const int64_t kMagicBits = 0x4338000000000000LL;
+static const double kMagic = 0x1.8p52;
+
+template <typename vd> inline vd Abs(vd x)
+{
+    typedef decltype(x < x) vi;
+    return (vd)((vi)x & 0x7fffffffffffffffLL);
+}
+
+// True when every lane of the comparison result m is set.
+template <typename vi> inline bool AllSet(vi m)
+{
+    long long all = -1;
+    for (size_t l = 0; l < sizeof(m) / sizeof(m[0]); l++) all &= m[l];
+    return all != 0;
+}
+
+// Splits x into k and x - k, with k the nearest integer to x. Only valid for
+// |x| < 2^51.
+template <typename vd, typename vi> inline vd Round(vd x, vi *k)
+{
+    vd m = x + kMagic;
+    *k = (vi)m - kMagicBits;
+    return m - kMagic;
+}
+
+// exp(x), valid when the result is a normal float.
+struct Exp
+{
+    template <typename vd, typename vi>
+    static inline vd Eval(vd x, vi *valid)
+    {
+        const double ln2Hi = 0x1.62e42fee00000p-1;
+        const double ln2Lo = 0x1.a39ef35793c76p-33;
+
+        *valid = (x >= -87.0) & (x <= 88.0);
+
+        vi k;
+        vd kd = Round(x * 0x1.71547652b82fep0, &k);
+        vd r = (x - kd * ln2Hi) - kd * ln2Lo;
+
+        // Taylor series, |r| <= 0.35
+        vd p = r * (1.0 / 6227020800.0) + (1.0 / 479001600.0);
+        p = p * r + (1.0 / 39916800.0);
+        p = p * r + (1.0 / 3628800.0);
+        p = p * r + (1.0 / 362880.0);
+        p = p * r + (1.0 / 40320.0);
+        p = p * r + (1.0 / 5040.0);
+        p = p * r + (1.0 / 720.0);
+        p = p * r + (1.0 / 120.0);
+        p = p * r + (1.0 / 24.0);
+        p = p * r + (1.0 / 6.0);
+        p = p * r + 0.5;
+        p = p * r + 1.0;
+        p = p * r + 1.0;
+
+        // p is in [0.7, 1.5] and k in [-126, 128], so this can not overflow
+        return (vd)((vi)p + (k << 52));
+    }
+};
+
+// log(x), valid for positive normal floats.
+struct Log
+{
+    template <typename vd, typename vi>
+    static inline vd Eval(vd x, vi *valid)
+    {
+        const double ln2Hi = 0x1.62e42fee00000p-1;
+        const double ln2Lo = 0x1.a39ef35793c76p-33;
+
+        *valid = (x >= 0x1.0p-126) & (x <= 0x1.fffffep127);
+
+        vi bits = (vi)x;
+        vi e = ((bits & kExponentMask) >> 52) - 1023;
+        vd m = (vd)((bits & kMantissaMask) | kOneBits);
+
+        // Bring m into [sqrt(0.5), sqrt(2))
+        vi big = m > 0x1.6a09e667f3bcdp0;
+        m = big ? m * 0.5 : m;
+        e -= big;
+        vd ed = (vd)(e + kMagicBits) - kMagic;
+
+        // log(m) = 2 atanh(f), |f| <= 0.172
+        vd f = (m - 1.0) / (m + 1.0);
+        vd s = f * f;
+        vd p = s * (1.0 / 23.0) + (1.0 / 21.0);
+        p = p * s + (1.0 / 19.0);
+        p = p * s + (1.0 / 17.0);
+        p = p * s + (1.0 / 15.0);
+        p = p * s + (1.0 / 13.0);
+        p = p * s + (1.0 / 11.0);
+        p = p * s + (1.0 / 9.0);
+        p = p * s + (1.0 / 7.0);
+        p = p * s + (1.0 / 5.0);
+        p = p * s + (1.0 / 3.0);
+        vd logm = 2.0 * f + 2.0 * f * s * p;
+
+        return ed * ln2Hi + (logm + ed * ln2Lo);
+    }
+};
+
+// sin(r) and cos(r) for |r| <= pi/4, Taylor series.
+template <typename vd> inline vd SinPoly(vd r)
+{
+    vd s = r * r;
+    vd p = s * (1.0 / 355687428096000.0) - (1.0 / 1307674368000.0);
+    p = p * s + (1.0 / 6227020800.0);
+    p = p * s - (1.0 / 39916800.0);
+    p = p * s + (1.0 / 362880.0);
+    p = p * s - (1.0 / 5040.0);
+    p = p * s + (1.0 / 120.0);
+    p = p * s - (1.0 / 6.0);
+    return r + r * s * p;
+}
+
+template <typename vd> inline vd CosPoly(vd r)
+{
+    vd s = r * r;
+    vd p = s * (1.0 / 6402373705728000.0) - (1.0 / 20922789888000.0);
+    p = p * s + (1.0 / 87178291200.0);
+    p = p * s - (1.0 / 479001600.0);
+    p = p * s + (1.0 / 3628800.0);
+    p = p * s - (1.0 / 40320.0);
+    p = p * s + (1.0 / 720.0);
+    p = p * s - (1.0 / 24.0);
+    p = p * s + 0.5;
+    return 1.0 - s * p;
+}
+
+// Reduces x by pi/2, valid for |x| <= 2048. pi/2 is split into three parts of
+// 33 bits, so that k * part is exact for the 11 bit k. Returns r and the
+// quadrant in k.
+template <typename vd, typename vi> inline vd ReducePiOver2(vd x, vi *k)
+{
+    const double pio2_1 = 0x1.921fb544p0;
+    const double pio2_2 = 0x1.0b4611a6p-34;
+    const double pio2_3 = 0x1.3198a2e037073p-69;
+
+    vd kd = Round(x * 0x1.45f306dc9c883p-1, k);
+    return ((x - kd * pio2_1) - kd * pio2_2) - kd * pio2_3;
+}
+
+template <bool IsCos> struct SinCos
+{
+    template <typename vd, typename vi>
+    static inline vd Eval(vd x, vi *valid)
+    {
+        *valid = Abs(x) <= 2048.0;
+
+        vi k;
+        vd r = ReducePiOver2(x, &k);
+        if (IsCos) k += 1;
+        vd sinr = SinPoly(r);
+        vd cosr = CosPoly(r);
+        vd v = (k & 1) ? cosr : sinr;
+        vi sign = (k & 2) << 62;
+        return (vd)((vi)v ^ sign);
+    }
+};
+
+template <int W, typename Approx>
+inline void UnaryKernel(float *out, const float *in, size_t count,
+                        double (*ref)(double))
+{
+    typedef typename SimdTypes<W>::vd vd;
+    typedef typename SimdTypes<W>::vf vf;
+    typedef typename SimdTypes<W>::vi vi;
+    typedef typename SimdTypes<W>::vfi vfi;
+
+    size_t i = 0;
+    for (; i + W <= count; i += W)
+    {
+        vf xf;
+        memcpy(&xf, in + i, sizeof(xf));
+        vd x = __builtin_convertvector(xf, vd);
+
+        vi valid;
+        vd v = Approx::Eval(x, &valid);
+        vd err = Abs(v) * kErrorBound;
+
+        // The result must be a normal float, and the error bounds must round
+        // to the same float as the approximation.
+        valid &= (Abs(v) >= 0x1.0p-126) & (Abs(v) <= 0x1.fffffep127);
+        vf lo = __builtin_convertvector(v - err, vf);
+        vf hi = __builtin_convertvector(v + err, vf);
+        valid &= __builtin_convertvector((vfi)lo == (vfi)hi, vi);
+
+        vf r = __builtin_convertvector(v, vf);
+        memcpy(out + i, &r, sizeof(r));
+        if (!AllSet(valid))
+            for (int l = 0; l < W; l++)
+                if (!valid[l]) out[i + l] = (float)ref(in[i + l]);
+    }
+    for (; i < count; i++) out[i] = (float)ref(in[i]);
+}
+
+template <int W>
+inline void DivideKernel(float *out, const float *x, const float *y,
+                         size_t count)
+{
+    typedef typename SimdTypes<W>::vd vd;
+    typedef typename SimdTypes<W>::vf vf;
+
+    size_t i = 0;
+    for (; i + W <= count; i += W)
+    {
+        vf xf, yf;
+        memcpy(&xf, x + i, sizeof(xf));
+        memcpy(&yf, y + i, sizeof(yf));
+        vf r = __builtin_convertvector(__builtin_convertvector(xf, vd)
+                                           / __builtin_convertvector(yf, vd),
+                                       vf);
+        memcpy(out + i, &r, sizeof(r));
+        if (!AllSet(r == r))
+            for (int l = 0; l < W; l++)
+                if (r[l] != r[l])
+                    out[i + l] = (float)reference_divide(x[i + l], y[i + l]);
+    }
+    for (; i < count; i++) out[i] = (float)reference_divide(x[i], y[i]);
+}
+
+// a * b is exact in double, so a * b + c is only rounded twice. That gives the
+// correctly rounded float unless the double sum lies exactly half way between
+// two floats. Those, zeros, infinities, NaNs and results outside of the normal
+// float range use the scalar reference.
+template <int W>
+inline void FmaKernel(float *out, const float *a, const float *b,
+                      const float *c, size_t count)
+{
+    typedef typename SimdTypes<W>::vd vd;
+    typedef typename SimdTypes<W>::vf vf;
+    typedef typename SimdTypes<W>::vi vi;
+
+    size_t i = 0;
+    for (; i + W <= count; i += W)
+    {
+        vf af, bf, cf;
+        memcpy(&af, a + i, sizeof(af));
+        memcpy(&bf, b + i, sizeof(bf));
+        memcpy(&cf, c + i, sizeof(cf));
+        vd ad = __builtin_convertvector(af, vd);
+        vd bd = __builtin_convertvector(bf, vd);
+        vd cd = __builtin_convertvector(cf, vd);
+        vd product = ad * bd;
+        vd d = product + cd;
+
+        vi valid = (Abs(ad) >= 0x1.0p-149) & (Abs(ad) <= 0x1.fffffep127)
+            & (Abs(bd) >= 0x1.0p-149) & (Abs(bd) <= 0x1.fffffep127)
+            & (Abs(cd) >= 0x1.0p-149) & (Abs(cd) <= 0x1.fffffep127)
+            & (Abs(d) >= 0x1.0p-126) & (Abs(d) <= 0x1.fffffep127)
+            & (((vi)d & 0x1fffffffLL) != 0x10000000LL);
+
+        vf r = __builtin_convertvector(d, vf);
+        memcpy(out + i, &r, sizeof(r));
+        if (!AllSet(valid))
+            for (int l = 0; l < W; l++)
+                if (!valid[l])
+                    out[i + l] = reference_fma(a[i + l], b[i + l], c[i + l], 0);
+    }
+    for (; i < count; i++) out[i] = reference_fma(a[i], b[i], c[i], 0);
+}
+
+typedef SimdTypes<4>::vf vf4;
+#if defined(__x86_64__)
+typedef SimdTypes<8>::vf vf8;
+#endif
+
+struct Sqrt
+{
+#if defined(__x86_64__)
+    static inline vf4 Eval(vf4 x) { return (vf4)_mm_sqrt_ps((__m128)x); }
+    __attribute__((target("avx2"))) static inline vf8 Eval(vf8 x)
+    {
+        return (vf8)_mm256_sqrt_ps((__m256)x);
+    }
+#else
+    static inline vf4 Eval(vf4 x) { return (vf4)vsqrtq_f32((float32x4_t)x); }
+#endif
+};
+
+static const int32_t kSignBit = INT32_MIN;
+
+// Whether each lane of the float bits x holds a zero, a normal number or an
+// infinity, which every host treats the same way.
+template <typename vfi> inline vfi Ordinary(vfi x)
+{
+    vfi exponent = x & 0x7f800000;
+    vfi mantissa = x & 0x007fffff;
+    return ((exponent != 0) | (mantissa == 0))
+        & ((exponent != 0x7f800000) | (mantissa == 0));
+}
+
+// Op works on the bits of F floats at a time. The result has the same bits as
+// the scalar reference in every lane whose inputs and result are Ordinary,
+// the other lanes are recomputed.
+template <int F, typename Op>
+inline void FloatUnaryKernel(float *out, const float *in, size_t count,
+                             double (*ref)(double))
+{
+    typedef typename SimdTypes<F>::vfi vfi;
+
+    size_t i = 0;
+    for (; i + F <= count; i += F)
+    {
+        vfi x;
+        memcpy(&x, in + i, sizeof(x));
+        vfi r = Op::template Eval<F>(x);
+        memcpy(out + i, &r, sizeof(r));
+        vfi valid = Ordinary(x) & Ordinary(r);
+        if (!AllSet(valid))
+            for (int l = 0; l < F; l++)
+                if (!valid[l]) out[i + l] = (float)ref(in[i + l]);
+    }
+    for (; i < count; i++) out[i] = (float)ref(in[i]);
+}
+
+template <int F, typename Op, typename Ref>
+inline void FloatBinaryKernel(float *out, const float *x, const float *y,
+                              size_t count, Ref ref)
+{
+    typedef typename SimdTypes<F>::vfi vfi;
+
+    size_t i = 0;
+    for (; i + F <= count; i += F)
+    {
+        vfi a, b;
+        memcpy(&a, x + i, sizeof(a));
+        memcpy(&b, y + i, sizeof(b));
+        vfi r = Op::template Eval<F>(a, b);
+        memcpy(out + i, &r, sizeof(r));
+        vfi valid = Ordinary(a) & Ordinary(b) & Ordinary(r);
+        if (!AllSet(valid))
+            for (int l = 0; l < F; l++)
+                if (!valid[l]) out[i + l] = (float)ref(x[i + l], y[i + l]);
+    }
+    for (; i < count; i++) out[i] = (float)ref(x[i], y[i]);
+}
+
+struct Fabs
+{
+    template <int F>
+    static inline typename SimdTypes<F>::vfi
+    Eval(typename SimdTypes<F>::vfi x)
+    {
+        return x & 0x7fffffff;
+    }
+};
+
+// Only floats below 2^23 in magnitude can have a fractional part, the others
+// are their own result. The sign is put back so that zeros keep theirs.
+struct Trunc
+{
+    template <int F>
+    static inline typename SimdTypes<F>::vfi
+    Eval(typename SimdTypes<F>::vfi x)
+    {
+        typedef typename SimdTypes<F>::vf vf;
+        typedef typename SimdTypes<F>::vfi vfi;
+        vf t = __builtin_convertvector(__builtin_convertvector((vf)x, vfi), vf);
+        vfi r = (vfi)t | (x & kSignBit);
+        return (x & 0x7fffffff) < 0x4b000000 ? r : x;
+    }
+};
+
+struct Floor
+{
+    template <int F>
+    static inline typename SimdTypes<F>::vfi
+    Eval(typename SimdTypes<F>::vfi x)
+    {
+        typedef typename SimdTypes<F>::vf vf;
+        vf t = (vf)Trunc::template Eval<F>(x);
+        return (typename SimdTypes<F>::vfi)(t > (vf)x ? t - 1.0f : t);
+    }
+};
+
+struct Ceil
+{
+    template <int F>
+    static inline typename SimdTypes<F>::vfi
+    Eval(typename SimdTypes<F>::vfi x)
+    {
+        typedef typename SimdTypes<F>::vf vf;
+        vf t = (vf)Trunc::template Eval<F>(x);
+        return (typename SimdTypes<F>::vfi)(t < (vf)x ? t + 1.0f : t);
+    }
+};
+
+// Adding and taking away 2^23 rounds to an integer in the current rounding
+// mode, as the scalar reference does with 2^52.
+struct Rint
+{
+    template <int F>
+    static inline typename SimdTypes<F>::vfi
+    Eval(typename SimdTypes<F>::vfi x)
+    {
+        typedef typename SimdTypes<F>::vf vf;
+        typedef typename SimdTypes<F>::vfi vfi;
+        vfi sign = x & kSignBit;
+        vf magic = (vf)(sign | 0x4b000000);
+        vf rounded = ((vf)x + magic) - magic;
+        vfi r = ((vfi)rounded & 0x7fffffff) | sign;
+        return (x & 0x7fffffff) < 0x4b000000 ? r : x;
+    }
+};
+
+struct SqrtFloat
+{
+    template <int F>
+    static inline typename SimdTypes<F>::vfi
+    Eval(typename SimdTypes<F>::vfi x)
+    {
+        typedef typename SimdTypes<F>::vf vf;
+        return (typename SimdTypes<F>::vfi)Sqrt::Eval((vf)x);
+    }
+};
+
+// NaNs are left to the scalar references, which pick the other argument
+struct Fmax
+{
+    template <int F>
+    static inline typename SimdTypes<F>::vfi
+    Eval(typename SimdTypes<F>::vfi x, typename SimdTypes<F>::vfi y)
+    {
+        typedef typename SimdTypes<F>::vf vf;
+        return (vf)x >= (vf)y ? x : y;
+    }
+};
+
+struct Fmin
+{
+    template <int F>
+    static inline typename SimdTypes<F>::vfi
+    Eval(typename SimdTypes<F>::vfi x, typename SimdTypes<F>::vfi y)
+    {
+        typedef typename SimdTypes<F>::vf vf;
+        return (vf)x <= (vf)y ? x : y;
+    }
+};
+
+struct Copysign
+{
+    template <int F>
+    static inline typename SimdTypes<F>::vfi
+    Eval(typename SimdTypes<F>::vfi x, typename SimdTypes<F>::vfi y)
+    {
+        return (x & 0x7fffffff) | (y & kSignBit);
+    }
+};
+
+// Any two NaNs match, whatever their sign and payload.
+template <int F>
+inline size_t FloatMismatchKernel(const uint32_t *ref, const uint32_t *test,
+                                  size_t start, size_t count)
+{
+    typedef typename SimdTypes<F>::vfi vfi;
+
+    size_t i = start;
+    for (; i + F <= count; i += F)
+    {
+        vfi a, b;
+        memcpy(&a, ref + i, sizeof(a));
+        memcpy(&b, test + i, sizeof(b));
+        vfi nans = ((a & 0x7fffffff) > 0x7f800000)
+            & ((b & 0x7fffffff) > 0x7f800000);
+        if (!AllSet((a == b) | nans)) break;
+    }
+    for (; i < count; i++)
+        if (ref[i] != test[i]
+            && !((ref[i] & 0x7fffffff) > 0x7f800000
+                 && (test[i] & 0x7fffffff) > 0x7f800000))
+            return i;
+    return count;
+}
+
+// The polynomials assume round to nearest, other rounding modes use the
+// scalar references.
+template <int W, typename Approx>
+inline void ApproxUnary(float *out, const float *in, size_t count,
+                        double (*ref)(double))
+{
+    if (fegetround() != FE_TONEAREST)
+    {
+        for (size_t i = 0; i < count; i++) out[i] = (float)ref(in[i]);
+        return;
+    }
+    UnaryKernel<W, Approx>(out, in, count, ref);
+}
+
+// reference_fma has its own rounding logic in RTZ mode
+template <int W>
+inline void Fma(float *out, const float *a, const float *b, const float *c,
+                size_t count)
+{
+    if (gIsInRTZMode || fegetround() != FE_TONEAREST)
+    {
+        for (size_t i = 0; i < count; i++)
+            out[i] = reference_fma(a[i], b[i], c[i], 0);
+        return;
+    }
+    FmaKernel<W>(out, a, b, c, count);
+}
+
+// -- double precision --
+
+// An unevaluated sum hi + lo with |lo| <= ulp(hi) / 2, which carries 106 bits.
+template <typename vd> struct DoubleDouble
+{
+    vd hi;
+    vd lo;
+};
+
+template <typename vd> inline DoubleDouble<vd> TwoSum(vd a, vd b)
+{
+    vd s = a + b;
+    vd bb = s - a;
+    DoubleDouble<vd> r = { s, (a - (s - bb)) + (b - bb) };
+    return r;
+}
+
+// Only valid for |a| >= |b|.
+template <typename vd> inline DoubleDouble<vd> FastTwoSum(vd a, vd b)
+{
+    vd s = a + b;
+    DoubleDouble<vd> r = { s, b - (s - a) };
+    return r;
+}
+
+#if defined(__x86_64__)
+// Dekker's product. The x86 targets don't enable FMA, so the compiler can't
+// contract the splits into something that isn't exact.
+template <typename vd> inline void Split(vd a, vd *hi, vd *lo)
+{
+    vd t = a * 134217729.0;
+    *hi = t - (t - a);
+    *lo = a - *hi;
+}
+
+template <typename vd> inline DoubleDouble<vd> TwoProd(vd a, vd b)
+{
+    vd ah, al, bh, bl;
+    Split(a, &ah, &al);
+    Split(b, &bh, &bl);
+    vd p = a * b;
+    DoubleDouble<vd> r = { p,
+                           ((ah * bh - p) + ah * bl + al * bh) + al * bl };
+    return r;
+}
+#else
+template <typename vd> inline DoubleDouble<vd> TwoProd(vd a, vd b)
+{
+    vd p = a * b;
+    DoubleDouble<vd> r = { p,
+                           (vd)vfmaq_f64((float64x2_t)-p, (float64x2_t)a,
+                                         (float64x2_t)b) };
+    return r;
+}
+#endif
+
+template <typename vd>
+inline DoubleDouble<vd> Add(DoubleDouble<vd> x, DoubleDouble<vd> y)
+{
+    DoubleDouble<vd> s = TwoSum(x.hi, y.hi);
+    DoubleDouble<vd> t = TwoSum(x.lo, y.lo);
+    s = FastTwoSum(s.hi, s.lo + t.hi);
+    return FastTwoSum(s.hi, s.lo + t.lo);
+}
+
+template <typename vd>
+inline DoubleDouble<vd> Mul(DoubleDouble<vd> x, DoubleDouble<vd> y)
+{
+    DoubleDouble<vd> p = TwoProd(x.hi, y.hi);
+    return FastTwoSum(p.hi, p.lo + (x.hi * y.lo + x.lo * y.hi));
+}
+
+// table[index[l]][column] in each lane l
+template <typename vd, typename vi, size_t N>
+inline vd Gather(const double (*table)[N], vi index, size_t column)
+{
+    double lanes[sizeof(vd) / sizeof(double)];
+    for (size_t l = 0; l < sizeof(vd) / sizeof(double); l++)
+        lanes[l] = table[index[l]][column];
+    vd r;
+    memcpy(&r, lanes, sizeof(r));
+    return r;
+}
+
+// 2^(j / 64) as double-doubles
+static const double kExp2Table[64][2] = {
+    { 0x1.0000000000000p+0, 0.0 },
+    { 0x1.02c9a3e778061p+0, -0x1.19083535b085dp-56 },
+    { 0x1.059b0d3158574p+0, 0x1.d73e2a475b465p-55 },
+    { 0x1.0874518759bc8p+0, 0x1.186be4bb284ffp-57 },
+    { 0x1.0b5586cf9890fp+0, 0x1.8a62e4adc610bp-54 },
+    { 0x1.0e3ec32d3d1a2p+0, 0x1.03a1727c57b53p-59 },
+    { 0x1.11301d0125b51p+0, -0x1.6c51039449b3ap-54 },
+    { 0x1.1429aaea92de0p+0, -0x1.32fbf9af1369ep-54 },
+    { 0x1.172b83c7d517bp+0, -0x1.19041b9d78a76p-55 },
+    { 0x1.1a35beb6fcb75p+0, 0x1.e5b4c7b4968e4p-55 },
+    { 0x1.1d4873168b9aap+0, 0x1.e016e00a2643cp-54 },
+    { 0x1.2063b88628cd6p+0, 0x1.dc775814a8495p-55 },
+    { 0x1.2387a6e756238p+0, 0x1.9b07eb6c70573p-54 },
+    { 0x1.26b4565e27cddp+0, 0x1.2bd339940e9d9p-55 },
+    { 0x1.29e9df51fdee1p+0, 0x1.612e8afad1255p-55 },
+    { 0x1.2d285a6e4030bp+0, 0x1.0024754db41d5p-54 },
+    { 0x1.306fe0a31b715p+0, 0x1.6f46ad23182e4p-55 },
+    { 0x1.33c08b26416ffp+0, 0x1.32721843659a6p-54 },
+    { 0x1.371a7373aa9cbp+0, -0x1.63aeabf42eae2p-54 },
+    { 0x1.3a7db34e59ff7p+0, -0x1.5e436d661f5e3p-56 },
+    { 0x1.3dea64c123422p+0, 0x1.ada0911f09ebcp-55 },
+    { 0x1.4160a21f72e2ap+0, -0x1.ef3691c309278p-58 },
+    { 0x1.44e086061892dp+0, 0x1.89b7a04ef80d0p-59 },
+    { 0x1.486a2b5c13cd0p+0, 0x1.3c1a3b69062f0p-56 },
+    { 0x1.4bfdad5362a27p+0, 0x1.d4397afec42e2p-56 },
+    { 0x1.4f9b2769d2ca7p+0, -0x1.4b309d25957e3p-54 },
+    { 0x1.5342b569d4f82p+0, -0x1.07abe1db13cadp-55 },
+    { 0x1.56f4736b527dap+0, 0x1.9bb2c011d93adp-54 },
+    { 0x1.5ab07dd485429p+0, 0x1.6324c054647adp-54 },
+    { 0x1.5e76f15ad2148p+0, 0x1.ba6f93080e65ep-54 },
+    { 0x1.6247eb03a5585p+0, -0x1.383c17e40b497p-54 },
+    { 0x1.6623882552225p+0, -0x1.bb60987591c34p-54 },
+    { 0x1.6a09e667f3bcdp+0, -0x1.bdd3413b26456p-54 },
+    { 0x1.6dfb23c651a2fp+0, -0x1.bbe3a683c88abp-57 },
+    { 0x1.71f75e8ec5f74p+0, -0x1.16e4786887a99p-55 },
+    { 0x1.75feb564267c9p+0, -0x1.0245957316dd3p-54 },
+    { 0x1.7a11473eb0187p+0, -0x1.41577ee04992fp-55 },
+    { 0x1.7e2f336cf4e62p+0, 0x1.05d02ba15797ep-56 },
+    { 0x1.82589994cce13p+0, -0x1.d4c1dd41532d8p-54 },
+    { 0x1.868d99b4492edp+0, -0x1.fc6f89bd4f6bap-54 },
+    { 0x1.8ace5422aa0dbp+0, 0x1.6e9f156864b27p-54 },
+    { 0x1.8f1ae99157736p+0, 0x1.5cc13a2e3976cp-55 },
+    { 0x1.93737b0cdc5e5p+0, -0x1.75fc781b57ebcp-57 },
+    { 0x1.97d829fde4e50p+0, -0x1.d185b7c1b85d1p-54 },
+    { 0x1.9c49182a3f090p+0, 0x1.c7c46b071f2bep-56 },
+    { 0x1.a0c667b5de565p+0, -0x1.359495d1cd533p-54 },
+    { 0x1.a5503b23e255dp+0, -0x1.d2f6edb8d41e1p-54 },
+    { 0x1.a9e6b5579fdbfp+0, 0x1.0fac90ef7fd31p-54 },
+    { 0x1.ae89f995ad3adp+0, 0x1.7a1cd345dcc81p-54 },
+    { 0x1.b33a2b84f15fbp+0, -0x1.2805e3084d708p-57 },
+    { 0x1.b7f76f2fb5e47p+0, -0x1.5584f7e54ac3bp-56 },
+    { 0x1.bcc1e904bc1d2p+0, 0x1.23dd07a2d9e84p-55 },
+    { 0x1.c199bdd85529cp+0, 0x1.11065895048ddp-55 },
+    { 0x1.c67f12e57d14bp+0, 0x1.2884dff483cadp-54 },
+    { 0x1.cb720dcef9069p+0, 0x1.503cbd1e949dbp-56 },
+    { 0x1.d072d4a07897cp+0, -0x1.cbc3743797a9cp-54 },
+    { 0x1.d5818dcfba487p+0, 0x1.2ed02d75b3707p-55 },
+    { 0x1.da9e603db3285p+0, 0x1.c2300696db532p-54 },
+    { 0x1.dfc97337b9b5fp+0, -0x1.1a5cd4f184b5cp-54 },
+    { 0x1.e502ee78b3ff6p+0, 0x1.39e8980a9cc8fp-55 },
+    { 0x1.ea4afa2a490dap+0, -0x1.e9c23179c2893p-54 },
+    { 0x1.efa1bee615a27p+0, 0x1.dc7f486a4b6b0p-54 },
+    { 0x1.f50765b6e4540p+0, 0x1.9d3e12dd8a18bp-54 },
+    { 0x1.fa7c1819e90d8p+0, 0x1.74853f3a5931ep-55 },
+};
+
+// 1 / c and -log(1 / c) as a double-double, for c near the middle of
+// [1 + j / 128, 1 + (j + 1) / 128). The first and last entries use c = 1 and
+// c = 2 instead, so that log(x) for x close to 1 comes out without any
+// cancellation and is accurate relative to the result.
+static const double kLogTable[128][3] = {
+    { 0x1.0000000000000p+0, 0.0, 0.0 },
+    { 0x1.fa11caa01fa12p-1, 0x1.7dc475f810a69p-7, 0x1.74944bc161072p-61 },
+    { 0x1.f6310aca0dbb5p-1, 0x1.3cea44346a584p-6, -0x1.865ad48159d00p-61 },
+    { 0x1.f25f644230ab5p-1, 0x1.b9fc027af919ap-6, -0x1.90ae69229dc86p-60 },
+    { 0x1.ee9c7f8458e02p-1, 0x1.1b0d98923d97fp-5, -0x1.74d7444dd6241p-59 },
+    { 0x1.eae807aba01ebp-1, 0x1.58a5bafc8e4d3p-5, -0x1.cab8569c56e40p-64 },
+    { 0x1.e741aa59750e4p-1, 0x1.95c830ec8e3f2p-5, 0x1.eb41d00a417e9p-60 },
+    { 0x1.e3a9179dc1a73p-1, 0x1.d276b8adb0b56p-5, 0x1.078f14c95ff53p-59 },
+    { 0x1.e01e01e01e01ep-1, 0x1.075983598e471p-4, 0x1.006d2999e22dcp-58 },
+    { 0x1.dca01dca01dcap-1, 0x1.253f62f0a1417p-4, 0x1.1f6d34e01d981p-61 },
+    { 0x1.d92f2231e7f8ap-1, 0x1.42edcbea646eep-4, -0x1.511583653349bp-58 },
+    { 0x1.d5cac807572b2p-1, 0x1.60658a93750c4p-4, -0x1.f108b1d8436d3p-59 },
+    { 0x1.d272ca3fc5b1ap-1, 0x1.7da766d7b12d0p-4, 0x1.a2240644d7da2p-59 },
+    { 0x1.cf26e5c44bfc6p-1, 0x1.9ab42462033aep-4, -0x1.a099e1c184e8ep-59 },
+    { 0x1.cbe6d9601cbe7p-1, 0x1.b78c82bb0eda0p-4, -0x1.3ef0e61f9b03cp-58 },
+    { 0x1.c8b265afb8a42p-1, 0x1.d4313d66cb35dp-4, 0x1.b90dd951d90fap-58 },
+    { 0x1.c5894d10d4986p-1, 0x1.f0a30c01162a4p-4, 0x1.8be64b8b7759bp-59 },
+    { 0x1.c26b5392ea01cp-1, 0x1.0671512ca596fp-3, -0x1.2f39b81479b67p-58 },
+    { 0x1.bf583ee868d8bp-1, 0x1.14785846742acp-3, 0x1.94409f1d3f83ap-60 },
+    { 0x1.bc4fd65883e7bp-1, 0x1.2266f190a5acdp-3, -0x1.dab840e7f6177p-57 },
+    { 0x1.b951e2b18ff23p-1, 0x1.303d718e47fd5p-3, -0x1.b5ae71f658247p-57 },
+    { 0x1.b65e2e3beee05p-1, 0x1.3dfc2b0ecc62ap-3, 0x1.ba62b8c13f7f4p-57 },
+    { 0x1.b37484ad806cep-1, 0x1.4ba36f39a55e5p-3, -0x1.f767e433c98aap-57 },
+    { 0x1.b094b31d922a4p-1, 0x1.59338d9982085p-3, 0x1.8d16eaaba9419p-57 },
+    { 0x1.adbe87f94905ep-1, 0x1.66acd4272ad51p-3, -0x1.9201c9c3d5165p-59 },
+    { 0x1.aaf1d2f87ebfdp-1, 0x1.740f8f54037a3p-3, 0x1.6d9bf9d57b326p-58 },
+    { 0x1.a82e65130e159p-1, 0x1.815c0a14357e9p-3, 0x1.141b7f8c5fa9ep-58 },
+    { 0x1.a574107688a4ap-1, 0x1.8e928de886d41p-3, 0x1.2589eb96a6240p-59 },
+    { 0x1.a2c2a87c51ca0p-1, 0x1.9bb362e7dfb85p-3, -0x1.51439c1ff83e7p-58 },
+    { 0x1.a01a01a01a01ap-1, 0x1.a8becfc882f19p-3, -0x1.a8c37918c39ebp-58 },
+    { 0x1.9d79f176b682dp-1, 0x1.b5b519e8fb5a6p-3, -0x1.d5d8023e61e5fp-57 },
+    { 0x1.9ae24ea5510dap-1, 0x1.c2968558c18c2p-3, 0x1.6108e3ae024acp-60 },
+    { 0x1.9852f0d8ec0ffp-1, 0x1.cf6354e09c5ddp-3, 0x1.339a07d55b696p-57 },
+    { 0x1.95cbb0be377aep-1, 0x1.dc1bca0abec7bp-3, 0x1.c698a33316dfbp-58 },
+    { 0x1.934c67f9b2ce6p-1, 0x1.e8c0252aa5a60p-3, -0x1.dc074737f9135p-60 },
+    { 0x1.90d4f120190d5p-1, 0x1.f550a564b7b37p-3, -0x1.13a09202fe73dp-57 },
+    { 0x1.8e6527af1373fp-1, 0x1.00e6c45ad501dp-2, -0x1.3b9568ff6feadp-57 },
+    { 0x1.8bfce8062ff3ap-1, 0x1.071b85fcd590dp-2, 0x1.08b83fcbdef40p-57 },
+    { 0x1.899c0f601899cp-1, 0x1.0d46b579ab74bp-2, 0x1.21f640e1e5ec9p-56 },
+    { 0x1.87427bcc092b9p-1, 0x1.136870293a8b0p-2, 0x1.86cc531dba494p-57 },
+    { 0x1.84f00c2780614p-1, 0x1.1980d2dd4236fp-2, -0x1.02c2e4f1b2eb9p-56 },
+    { 0x1.82a4a0182a4a0p-1, 0x1.1f8ff9e48a2f3p-2, -0x1.93fbf3418960dp-57 },
+    { 0x1.8060180601806p-1, 0x1.2596010df763ap-2, -0x1.9eed8ae0ebd3cp-59 },
+    { 0x1.7e225515a4f1dp-1, 0x1.2b9303ab89d25p-2, -0x1.85ad7f614ab51p-58 },
+    { 0x1.7beb3922e017cp-1, 0x1.31871c9544185p-2, -0x1.ea3598981366fp-57 },
+    { 0x1.79baa6bb6398bp-1, 0x1.3772662bfd85cp-2, 0x1.02a7589fba088p-57 },
+    { 0x1.77908119ac60dp-1, 0x1.3d54fa5c1f710p-2, 0x1.53668e578d9cdp-58 },
+    { 0x1.756cac201756dp-1, 0x1.432ef2a04e813p-2, -0x1.83262e2b59206p-57 },
+    { 0x1.734f0c541fe8dp-1, 0x1.49006804009d0p-2, -0x1.bff0d07c5df6dp-59 },
+    { 0x1.713786d9c7c09p-1, 0x1.4ec9732600269p-2, -0x1.1aa87d977dc5ep-56 },
+    { 0x1.6f26016f26017p-1, 0x1.548a2c3add263p-2, -0x1.58ce7bf1846eep-56 },
+    { 0x1.6d1a62681c861p-1, 0x1.5a42ab0f4cfe2p-2, -0x1.c6bcb7dee9a3dp-56 },
+    { 0x1.6b1490aa31a3dp-1, 0x1.5ff3070a793d4p-2, -0x1.063077d7e37b7p-56 },
+    { 0x1.691473a88d0c0p-1, 0x1.659b57303e1f2p-2, 0x1.db0af8efb83c7p-62 },
+    { 0x1.6719f3601671ap-1, 0x1.6b3bb2235943dp-2, 0x1.957a93326784dp-56 },
+    { 0x1.6524f853b4aa3p-1, 0x1.70d42e2789236p-2, 0x1.ee99bf7143954p-56 },
+    { 0x1.63356b88ac0dep-1, 0x1.7664e1239dbcfp-2, -0x1.d6d5d64f5daf8p-57 },
+    { 0x1.614b36831ae94p-1, 0x1.7bede0a37afbfp-2, -0x1.6783cb9801a5bp-56 },
+    { 0x1.5f66434292dfcp-1, 0x1.816f41da0d495p-2, 0x1.76dc35fb48fe4p-56 },
+    { 0x1.5d867c3ece2a5p-1, 0x1.86e919a330ba1p-2, -0x1.700c9d2029045p-56 },
+    { 0x1.5babcc647fa91p-1, 0x1.8c5b7c858b48bp-2, 0x1.d754b0205fa6cp-56 },
+    { 0x1.59d61f123ccaap-1, 0x1.91c67eb45a83ep-2, 0x1.5e3ea3b96a3dfp-57 },
+    { 0x1.5805601580560p-1, 0x1.972a341135159p-2, -0x1.5a3f62db48f27p-56 },
+    { 0x1.56397ba7c52e2p-1, 0x1.9c86b02dc0862p-2, 0x1.7e81149622bdfp-56 },
+    { 0x1.54725e6bb82fep-1, 0x1.a1dc064d5b995p-2, 0x1.a0128698ba0b8p-56 },
+    { 0x1.52aff56a8054bp-1, 0x1.a72a4966bd9e9p-2, 0x1.529dac69f61f1p-56 },
+    { 0x1.50f22e111c4c5p-1, 0x1.ac718c258b0e5p-2, 0x1.682c7ade8dee3p-56 },
+    { 0x1.4f38f62dd4c9bp-1, 0x1.b1b1e0ebdfc5ap-2, -0x1.0ee1a7dd74ea6p-58 },
+    { 0x1.4d843bedc2c4cp-1, 0x1.b6eb59d3cf35cp-2, 0x1.1524332cd95c4p-56 },
+    { 0x1.4bd3edda68fe1p-1, 0x1.bc1e08b0dad0ap-2, -0x1.385e3e3ea99a8p-58 },
+    { 0x1.4a27fad76014ap-1, 0x1.c149ff115f027p-2, 0x1.46868de7f39f6p-57 },
+    { 0x1.4880522014880p-1, 0x1.c66f4e3ff6ff9p-2, -0x1.82947258b6889p-58 },
+    { 0x1.46dce34596066p-1, 0x1.cb8e0744d7acap-2, 0x1.c5bbc32ef5aebp-56 },
+    { 0x1.453d9e2c776cap-1, 0x1.d0a63ae721e64p-2, 0x1.4acce112c40f2p-57 },
+    { 0x1.43a2730abee4dp-1, 0x1.d5b7f9ae2c684p-2, 0x1.4841807b53f96p-57 },
+    { 0x1.420b5265e5951p-1, 0x1.dac353e2c5955p-2, -0x1.abc65a3f2f204p-56 },
+    { 0x1.40782d10e6566p-1, 0x1.dfc859906d5b5p-2, 0x1.51e1399f96398p-56 },
+    { 0x1.3ee8f42a5af07p-1, 0x1.e4c71a8687704p-2, -0x1.34c36e0f052b9p-56 },
+    { 0x1.3d5d991aa75c6p-1, 0x1.e9bfa659861f5p-2, -0x1.de45038241ecfp-56 },
+    { 0x1.3bd60d9232955p-1, 0x1.eeb20c640ddf3p-2, -0x1.81e47141b8404p-56 },
+    { 0x1.3a524387ac822p-1, 0x1.f39e5bc811e5dp-2, 0x1.200e221139873p-59 },
+    { 0x1.38d22d366088ep-1, 0x1.f884a36fe9ec1p-2, 0x1.618ae4f008400p-56 },
+    { 0x1.3755bd1c945eep-1, 0x1.fd64f20f61571p-2, -0x1.b615859d5a349p-62 },
+    { 0x1.35dce5f9f2af8p-1, 0x1.011fab125ff8ap-1, 0x1.4043750211778p-55 },
+    { 0x1.34679ace01346p-1, 0x1.0389eefce633cp-1, 0x1.8aae29a41ba4ap-59 },
+    { 0x1.32f5ced6a1dfap-1, 0x1.05f14bd26459cp-1, 0x1.935b8ee4f9efep-58 },
+    { 0x1.3187758e9ebb6p-1, 0x1.0855c884b450ep-1, 0x1.785826e49f318p-55 },
+    { 0x1.301c82ac40260p-1, 0x1.0ab76bece14d2p-1, 0x1.02936cabac09ap-56 },
+    { 0x1.2eb4ea1fed14bp-1, 0x1.0d163ccb9d6b8p-1, 0x1.6119595d0f3c3p-59 },
+    { 0x1.2d50a012d50a0p-1, 0x1.0f7241c9b497dp-1, 0x1.ba8443b9db19dp-55 },
+    { 0x1.2bef98e5a3711p-1, 0x1.11cb81787ccf8p-1, 0x1.dc70f563f9920p-56 },
+    { 0x1.2a91c92f3c105p-1, 0x1.1422025243d45p-1, 0x1.7e5e3b6a496ecp-55 },
+    { 0x1.293725bb804a5p-1, 0x1.1675cababa60ep-1, -0x1.cb19c15477c8ep-56 },
+    { 0x1.27dfa38a1ce4dp-1, 0x1.18c6e0ff5cf07p-1, -0x1.9a6baf4f4e637p-56 },
+    { 0x1.268b37cd60127p-1, 0x1.1b154b57da29ep-1, 0x1.2770a5c124ab5p-56 },
+    { 0x1.2539d7e9177b2p-1, 0x1.1d610fe677003p-1, 0x1.d27563647963dp-56 },
+    { 0x1.23eb79717605bp-1, 0x1.1faa34b87094cp-1, 0x1.c42f71ef43276p-55 },
+    { 0x1.22a0122a0122ap-1, 0x1.21f0bfc65beecp-1, -0x1.c24f0c9187c92p-57 },
+    { 0x1.21579804855e6p-1, 0x1.2434b6f483934p-1, -0x1.bebb8cf0f6d11p-57 },
+    { 0x1.2012012012012p-1, 0x1.26762013430e0p-1, -0x1.86a95781c6727p-56 },
+    { 0x1.1ecf43c7fb84cp-1, 0x1.28b500df60783p-1, 0x1.813f3f4aaa9a3p-60 },
+    { 0x1.1d8f5672e4abdp-1, 0x1.2af15f02640acp-1, 0x1.ed8322925675ap-56 },
+    { 0x1.1c522fc1ce059p-1, 0x1.2d2b4012edc9dp-1, 0x1.9ae9d3664e355p-55 },
+    { 0x1.1b17c67f2bae3p-1, 0x1.2f62a99509546p-1, -0x1.7dcbcc6300133p-55 },
+    { 0x1.19e0119e0119ep-1, 0x1.3197a0fa7fe6ap-1, 0x1.f6348fb97128fp-57 },
+    { 0x1.18ab083902bdbp-1, 0x1.33ca2ba328994p-1, 0x1.1c6ba66fd0910p-55 },
+    { 0x1.1778a191bd684p-1, 0x1.35fa4edd36ea0p-1, 0x1.727d468096436p-56 },
+    { 0x1.1648d50fc3201p-1, 0x1.38280fe58797fp-1, -0x1.756f4d8a9b974p-57 },
+    { 0x1.151b9a3fdd5c9p-1, 0x1.3a5373e7ebdf9p-1, 0x1.5ce11148e1124p-56 },
+    { 0x1.13f0e8d344724p-1, 0x1.3c7c7fff73206p-1, -0x1.e80db7025bed1p-60 },
+    { 0x1.12c8b89edc0acp-1, 0x1.3ea33936b2f5bp-1, 0x1.f66e975ec9f52p-59 },
+    { 0x1.11a3019a74826p-1, 0x1.40c7a4880dceap-1, 0x1.13c8b79ff2789p-58 },
+    { 0x1.107fbbe011080p-1, 0x1.42e9c6ddf80bfp-1, -0x1.4d411c2cd7cf1p-55 },
+    { 0x1.0f5edfab325a2p-1, 0x1.4509a5133bb0ap-1, -0x1.5701d7ad284a5p-55 },
+    { 0x1.0e40655826011p-1, 0x1.472743f33aaadp-1, -0x1.a930fed5d6b7ep-60 },
+    { 0x1.0d24456359e3ap-1, 0x1.4942a83a2fc07p-1, 0x1.2a18a88ca56b5p-56 },
+    { 0x1.0c0a7868b4171p-1, 0x1.4b5bd6956e273p-1, -0x1.2c7a06beea772p-55 },
+    { 0x1.0af2f722eecb5p-1, 0x1.4d72d3a39fd01p-1, 0x1.01a9a829c011bp-56 },
+    { 0x1.09ddba6af8360p-1, 0x1.4f87a3f5026e9p-1, -0x1.68ca8b1bcea9dp-55 },
+    { 0x1.08cabb37565e2p-1, 0x1.519a4c0ba3446p-1, 0x1.a332128e4a77fp-55 },
+    { 0x1.07b9f29b8eae2p-1, 0x1.53aad05b99b7cp-1, -0x1.7722c14b894e2p-57 },
+    { 0x1.06ab59c7912fbp-1, 0x1.55b9354b40bcep-1, -0x1.1f342e541a63dp-59 },
+    { 0x1.059eea0727586p-1, 0x1.57c57f336f191p-1, 0x1.1eac5c4377e6ep-55 },
+    { 0x1.04949cc1664c5p-1, 0x1.59cfb25fae87fp-1, -0x1.bb94822ace357p-57 },
+    { 0x1.038c6b78247fcp-1, 0x1.5bd7d30e71c73p-1, -0x1.c9649352e8e44p-67 },
+    { 0x1.02864fc7729e9p-1, 0x1.5ddde57149923p-1, 0x1.0fa37d75ef285p-59 },
+    { 0x1.0182436517a37p-1, 0x1.5fe1edad18919p-1, 0x1.92e93de3ce483p-56 },
+    { 0x1.0000000000000p-1, 0x1.62e42fefa39efp-1, 0x1.abc9e3b39803fp-56 },
+};
+
+// exp(x), valid when the result is a double at least 2^-980. x = (64 n + j)
+// ln(2) / 64 + r with |r| <= ln(2) / 128, and exp(x) = 2^n 2^(j / 64) exp(r).
+struct ExpDouble
+{
+    template <typename vd, typename vi>
+    static inline DoubleDouble<vd> Eval(vd x, vi *valid)
+    {
+        // ln(2) / 64 in three parts, the first two of 36 bits so that k times
+        // them is exact
+        const double ln2_1 = 0x1.62e42fefa0000p-7;
+        const double ln2_2 = 0x1.cf79abc9e0000p-46;
+        const double ln2_3 = 0x1.d9cc01f97b57ap-85;
+
+        *valid = (x >= -680.0) & (x <= 709.0);
+
+        vi k;
+        vd kd = Round(x * 0x1.71547652b82fep6, &k);
+        DoubleDouble<vd> r = TwoSum(x - kd * ln2_1, -kd * ln2_2);
+        r.lo -= kd * ln2_3;
+
+        // expm1(r) = r + r^2 / 2 + r^3 q(r). |r| <= 2^-7.5, so the terms from
+        // r^3 on are below 2^-17 of the result and only need double
+        // precision.
+        vd q = r.hi * (1.0 / 40320.0) + (1.0 / 5040.0);
+        q = q * r.hi + (1.0 / 720.0);
+        q = q * r.hi + (1.0 / 120.0);
+        q = q * r.hi + (1.0 / 24.0);
+        q = q * r.hi + (1.0 / 6.0);
+        DoubleDouble<vd> square = TwoProd(r.hi, r.hi);
+        square.lo += 2.0 * r.hi * r.lo;
+        DoubleDouble<vd> half = { 0.5 * square.hi, 0.5 * square.lo };
+        DoubleDouble<vd> p = Add(r, half);
+        p = FastTwoSum(p.hi, p.lo + r.hi * square.hi * q);
+
+        vi j = k & 63;
+        DoubleDouble<vd> t = { Gather<vd>(kExp2Table, j, 0),
+                               Gather<vd>(kExp2Table, j, 1) };
+        DoubleDouble<vd> v = Add(t, Mul(t, p));
+
+        // n is in [-982, 1022]
+        vd scale = (vd)(((k >> 6) + 1023) << 52);
+        DoubleDouble<vd> result = { v.hi * scale, v.lo * scale };
+        return result;
+    }
+
+    // The lanes whose result is certain to round to infinity or zero
+    template <typename vd, typename vi>
+    static inline vd Saturate(vd x, vi *saturated)
+    {
+        vd zero = {};
+        *saturated = (x >= 710.0) | (x <= -746.0);
+        return x > 0.0 ? zero + INFINITY : zero;
+    }
+};
+
+// log(x), valid for positive normal doubles. x = 2^e m with m in [1, 2), and
+// log(x) = e log(2) - log(1 / c) + log1p(r) with r = m / c - 1, which the
+// exact product m (1 / c) gives without a division.
+struct LogDouble
+{
+    template <typename vd, typename vi>
+    static inline DoubleDouble<vd> Eval(vd x, vi *valid)
+    {
+        const double ln2Hi = 0x1.62e42fefa39efp-1;
+        const double ln2Lo = 0x1.abc9e3b39803fp-56;
+
+        *valid = (x >= 0x1.0p-1022) & (x <= 0x1.fffffffffffffp1023);
+
+        vi bits = (vi)x;
+        vi e = ((bits & kExponentMask) >> 52) - 1023;
+        vd m = (vd)((bits & kMantissaMask) | kOneBits);
+        vd ed = (vd)(e + kMagicBits) - kMagic;
+        vi j = (bits >> 45) & 127;
+
+        vd inv = Gather<vd>(kLogTable, j, 0);
+        DoubleDouble<vd> logc = { Gather<vd>(kLogTable, j, 1),
+                                  Gather<vd>(kLogTable, j, 2) };
+
+        // m (1 / c) is within 2^-7 of 1, so subtracting 1 is exact
+        DoubleDouble<vd> product = TwoProd(m, inv);
+        DoubleDouble<vd> r = TwoSum(product.hi - 1.0, product.lo);
+
+        // log1p(r) = r - r^2 / 2 + r^3 q(r), the terms from r^3 on are below
+        // 2^-15 of the result
+        vd q = r.hi * (-1.0 / 11.0) + (1.0 / 10.0);
+        q = q * r.hi - (1.0 / 9.0);
+        q = q * r.hi + (1.0 / 8.0);
+        q = q * r.hi - (1.0 / 7.0);
+        q = q * r.hi + (1.0 / 6.0);
+        q = q * r.hi - (1.0 / 5.0);
+        q = q * r.hi + (1.0 / 4.0);
+        q = q * r.hi - (1.0 / 3.0);
+        DoubleDouble<vd> square = TwoProd(r.hi, r.hi);
+        square.lo += 2.0 * r.hi * r.lo;
+        DoubleDouble<vd> half = { -0.5 * square.hi, -0.5 * square.lo };
+        DoubleDouble<vd> p = Add(r, half);
+        p = FastTwoSum(p.hi, p.lo - r.hi * square.hi * q);
+
+        // For x just below 1, e log(2) and log(1 / c) cancel exactly
+        vd zero = {};
+        DoubleDouble<vd> eln2 = TwoProd(ed, zero + ln2Hi);
+        eln2.lo += ed * ln2Lo;
+        return Add(Add(eln2, logc), p);
+    }
+
+    template <typename vd, typename vi>
+    static inline vd Saturate(vd x, vi *saturated)
+    {
+        vd zero = {};
+        *saturated = (x == 0.0) | (x == INFINITY);
+        return x > 0.0 ? zero + INFINITY : zero - INFINITY;
+    }
+};
+
+// Relative error bound used to decide whether a double-double result is
+// certain to round to the same double as the scalar long double reference.
+// The double-double functions above are accurate to about 2^-67, the x87
+// long double references to about 2^-62.
+static const double kDoubleErrorBound = 0x1.0p-60;
+
+// Whether each lane of the double bits x holds a zero, a normal number or an
+// infinity.
+template <typename vi> inline vi OrdinaryDouble(vi x)
+{
+    vi exponent = x & kExponentMask;
+    vi mantissa = x & kMantissaMask;
+    return ((exponent != 0) | (mantissa == 0))
+        & ((exponent != kExponentMask) | (mantissa == 0));
+}
+
+template <int W, typename Approx>
+inline void DoubleUnaryKernel(double *out, const double *in, size_t count,
+                              long double (*ref)(long double))
+{
+    typedef typename SimdTypes<W>::vd vd;
+    typedef typename SimdTypes<W>::vi vi;
+
+    size_t i = 0;
+    for (; i + W <= count; i += W)
+    {
+        vd x;
+        memcpy(&x, in + i, sizeof(x));
+
+        vi valid;
+        DoubleDouble<vd> v = Approx::Eval(x, &valid);
+        vd err = Abs(v.hi) * kDoubleErrorBound;
+
+        // Both ends of the error bounds must round to the same double
+        vd lo = v.hi + (v.lo - err);
+        vd hi = v.hi + (v.lo + err);
+        valid &= (vi)lo == (vi)hi;
+
+        vi saturated;
+        vd limit = Approx::Saturate(x, &saturated);
+        lo = saturated ? limit : lo;
+        valid |= saturated;
+
+        memcpy(out + i, &lo, sizeof(lo));
+        if (!AllSet(valid))
+            for (int l = 0; l < W; l++)
+                if (!valid[l]) out[i + l] = (double)ref(in[i + l]);
+    }
+    for (; i < count; i++) out[i] = (double)ref(in[i]);
+}
+
+template <int W, typename Approx>
+inline void ApproxDoubleUnary(double *out, const double *in, size_t count,
+                              long double (*ref)(long double))
+{
+    if (fegetround() != FE_TONEAREST)
+    {
+        for (size_t i = 0; i < count; i++) out[i] = (double)ref(in[i]);
+        return;
+    }
+    DoubleUnaryKernel<W, Approx>(out, in, count, ref);
+}
+
+// The exact double operations are the packed forms of the instructions the
+// scalar references use, so they round the same way in every mode and give
+// the same default NaNs. Lanes with NaN or denormal inputs, which the long
+// double arguments of the references may change, use the scalar references.
+template <int W, typename Op>
+inline void ExactDoubleUnaryKernel(double *out, const double *in, size_t count,
+                                   long double (*ref)(long double))
+{
+    typedef typename SimdTypes<W>::vd vd;
+    typedef typename SimdTypes<W>::vi vi;
+
+    size_t i = 0;
+    for (; i + W <= count; i += W)
+    {
+        vd x;
+        memcpy(&x, in + i, sizeof(x));
+        vd r = Op::Eval(x);
+        memcpy(out + i, &r, sizeof(r));
+        vi valid = OrdinaryDouble((vi)x);
+        if (!AllSet(valid))
+            for (int l = 0; l < W; l++)
+                if (!valid[l]) out[i + l] = (double)ref(in[i + l]);
+    }
+    for (; i < count; i++) out[i] = (double)ref(in[i]);
+}
+
+template <int W, typename Op>
+inline void ExactDoubleBinaryKernel(double *out, const double *x,
+                                    const double *y, size_t count,
+                                    long double (*ref)(long double,
+                                                       long double))
+{
+    typedef typename SimdTypes<W>::vd vd;
+    typedef typename SimdTypes<W>::vi vi;
+
+    size_t i = 0;
+    for (; i + W <= count; i += W)
+    {
+        vd a, b;
+        memcpy(&a, x + i, sizeof(a));
+        memcpy(&b, y + i, sizeof(b));
+        vd r = Op::Eval(a, b);
+        memcpy(out + i, &r, sizeof(r));
+        vi valid = OrdinaryDouble((vi)a) & OrdinaryDouble((vi)b);
+        if (!AllSet(valid))
+            for (int l = 0; l < W; l++)
+                if (!valid[l]) out[i + l] = (double)ref(x[i + l], y[i + l]);
+    }
+    for (; i < count; i++) out[i] = (double)ref(x[i], y[i]);
+}
+
+// The hardware fma is correctly rounded like reference_fmal, which does its
+// own rounding in RTZ mode.
+template <int W, typename Op>
+inline void DoubleFmaKernel(double *out, const double *a, const double *b,
+                            const double *c, size_t count)
+{
+    typedef typename SimdTypes<W>::vd vd;
+    typedef typename SimdTypes<W>::vi vi;
+
+    size_t vectorCount =
+        gIsInRTZMode || fegetround() != FE_TONEAREST ? 0 : count;
+    size_t i = 0;
+    for (; i + W <= vectorCount; i += W)
+    {
+        vd x, y, z;
+        memcpy(&x, a + i, sizeof(x));
+        memcpy(&y, b + i, sizeof(y));
+        memcpy(&z, c + i, sizeof(z));
+        vd r = Op::Eval(x, y, z);
+        memcpy(out + i, &r, sizeof(r));
+        vi valid = OrdinaryDouble((vi)x) & OrdinaryDouble((vi)y)
+            & OrdinaryDouble((vi)z) & OrdinaryDouble((vi)r);
+        if (!AllSet(valid))
+            for (int l = 0; l < W; l++)
+                if (!valid[l])
+                    out[i + l] =
+                        (double)reference_fmal(a[i + l], b[i + l], c[i + l]);
+    }
+    for (; i < count; i++) out[i] = (double)reference_fmal(a[i], b[i], c[i]);
+}
+
+typedef SimdTypes<2>::vd vd2;
+#if defined(__x86_64__)
+typedef SimdTypes<4>::vd vd4;
+#endif
+
+struct SqrtDouble
+{
+#if defined(__x86_64__)
+    static inline vd2 Eval(vd2 x) { return (vd2)_mm_sqrt_pd((__m128d)x); }
+    __attribute__((target("avx2"))) static inline vd4 Eval(vd4 x)
+    {
+        return (vd4)_mm256_sqrt_pd((__m256d)x);
+    }
+#else
+    static inline vd2 Eval(vd2 x) { return (vd2)vsqrtq_f64((float64x2_t)x); }
+#endif
+};
+
+struct FmaDouble
+{
+#if defined(__x86_64__)
+    __attribute__((target("avx2,fma"))) static inline vd4 Eval(vd4 a, vd4 b,
+                                                               vd4 c)
+    {
+        return (vd4)_mm256_fmadd_pd((__m256d)a, (__m256d)b, (__m256d)c);
+    }
+#else
+    static inline vd2 Eval(vd2 a, vd2 b, vd2 c)
+    {
+        return (vd2)vfmaq_f64((float64x2_t)c, (float64x2_t)a, (float64x2_t)b);
+    }
+#endif
+};
+
+struct AddDouble
+{
+    template <typename vd> static inline vd Eval(vd x, vd y) { return x + y; }
+};
+
+struct SubtractDouble
+{
+    template <typename vd> static inline vd Eval(vd x, vd y) { return x - y; }
+};
+
+struct MultiplyDouble
+{
+    template <typename vd> static inline vd Eval(vd x, vd y) { return x * y; }
+};
+
+struct DivideDouble
+{
+    template <typename vd> static inline vd Eval(vd x, vd y) { return x / y; }
+};
+
+struct FmaxDouble
+{
+    template <typename vd> static inline vd Eval(vd x, vd y)
+    {
+        return x >= y ? x : y;
+    }
+};
+
+struct FminDouble
+{
+    template <typename vd> static inline vd Eval(vd x, vd y)
+    {
+        return x <= y ? x : y;
+    }
+};
+
+struct DoubleBatchTable
+{
+    BatchReference_d_d exp;
+    BatchReference_d_d log;
+    BatchReference_d_d sqrt;
+    BatchReference_d_dd add;
+    BatchReference_d_dd subtract;
+    BatchReference_d_dd multiply;
+    BatchReference_d_dd divide;
+    BatchReference_d_dd fmax;
+    BatchReference_d_dd fmin;
+};
+
+#define DEFINE_DOUBLE_BINARY(NAME, W, ATTR, OP, REF)                           \
+    ATTR __attribute__((flatten)) void NAME##OP(                               \
+        double *out, const double *x, const double *y, size_t count)           \
+    {                                                                          \
+        ExactDoubleBinaryKernel<W, OP>(out, x, y, count, REF);                 \
+    }
+
+#define DEFINE_DOUBLE_BATCH_TABLE(NAME, W, ATTR)                               \
+    ATTR __attribute__((flatten)) void NAME##ExpDouble(                        \
+        double *out, const double *in, size_t count)                           \
+    {                                                                          \
+        ApproxDoubleUnary<W, ExpDouble>(out, in, count, reference_expl);       \
+    }                                                                          \
+    ATTR __attribute__((flatten)) void NAME##LogDouble(                        \
+        double *out, const double *in, size_t count)                           \
+    {                                                                          \
+        ApproxDoubleUnary<W, LogDouble>(out, in, count, reference_logl);       \
+    }                                                                          \
+    ATTR __attribute__((flatten)) void NAME##SqrtDouble(                       \
+        double *out, const double *in, size_t count)                           \
+    {                                                                          \
+        ExactDoubleUnaryKernel<W, SqrtDouble>(out, in, count,                  \
+                                              reference_sqrtl);                \
+    }                                                                          \
+    DEFINE_DOUBLE_BINARY(NAME, W, ATTR, AddDouble, reference_addl)             \
+    DEFINE_DOUBLE_BINARY(NAME, W, ATTR, SubtractDouble, reference_subtractl)   \
+    DEFINE_DOUBLE_BINARY(NAME, W, ATTR, MultiplyDouble, reference_multiplyl)   \
+    DEFINE_DOUBLE_BINARY(NAME, W, ATTR, DivideDouble, reference_dividel)       \
+    DEFINE_DOUBLE_BINARY(NAME, W, ATTR, FmaxDouble, reference_fmaxl)           \
+    DEFINE_DOUBLE_BINARY(NAME, W, ATTR, FminDouble, reference_fminl)           \
+    const DoubleBatchTable NAME##DoubleTable = {                               \
+        NAME##ExpDouble,      NAME##LogDouble,      NAME##SqrtDouble,          \
+        NAME##AddDouble,      NAME##SubtractDouble, NAME##MultiplyDouble,      \
+        NAME##DivideDouble,   NAME##FmaxDouble,     NAME##FminDouble           \
+    };
+
+struct BatchTable
+{
+    BatchReference_f_f exp;
+    BatchReference_f_f log;
+    BatchReference_f_f sin;
+    BatchReference_f_f cos;
+    BatchReference_f_f sqrt;
+    BatchReference_f_ff divide;
+    BatchReference_fma fma;
+    BatchReference_f_f fabs;
+    BatchReference_f_f floor;
+    BatchReference_f_f ceil;
+    BatchReference_f_f trunc;
+    BatchReference_f_f rint;
+    BatchReference_f_ff fmax;
+    BatchReference_f_ff fmin;
+    BatchReference_f_ff copysign;
+    size_t (*firstMismatch)(const uint32_t *, const uint32_t *, size_t,
+                            size_t);
+};
+
+// The float lane kernels take twice as many lanes as the double ones
+#define DEFINE_FLOAT_UNARY(NAME, W, ATTR, OP, REF)                             \
+    ATTR __attribute__((flatten)) void NAME##OP(float *out, const float *in,   \
+                                                size_t count)                  \
+    {                                                                          \
+        FloatUnaryKernel<2 * W, OP>(out, in, count, REF);                      \
+    }
+#define DEFINE_FLOAT_BINARY(NAME, W, ATTR, OP, REF)                            \
+    ATTR __attribute__((flatten)) void NAME##OP(                               \
+        float *out, const float *x, const float *y, size_t count)              \
+    {                                                                          \
+        FloatBinaryKernel<2 * W, OP>(out, x, y, count, REF);                   \
+    }
+
+#define DEFINE_BATCH_TABLE(NAME, W, ATTR)                                      \
+    ATTR __attribute__((flatten)) void NAME##Exp(float *out, const float *in,  \
+                                                 size_t count)                 \
+    {                                                                          \
+        ApproxUnary<W, Exp>(out, in, count, reference_exp);                    \
+    }                                                                          \
+    ATTR __attribute__((flatten)) void NAME##Log(float *out, const float *in,  \
+                                                 size_t count)                 \
+    {                                                                          \
+        ApproxUnary<W, Log>(out, in, count, reference_log);                    \
+    }                                                                          \
+    ATTR __attribute__((flatten)) void NAME##Sin(float *out, const float *in,  \
+                                                 size_t count)                 \
+    {                                                                          \
+        ApproxUnary<W, SinCos<false> >(out, in, count, reference_sin);         \
+    }                                                                          \
+    ATTR __attribute__((flatten)) void NAME##Cos(float *out, const float *in,  \
+                                                 size_t count)                 \
+    {                                                                          \
+        ApproxUnary<W, SinCos<true> >(out, in, count, reference_cos);          \
+    }                                                                          \
+    ATTR __attribute__((flatten)) void NAME##Sqrt(float *out, const float *in, \
+                                                  size_t count)                \
+    {                                                                          \
+        FloatUnaryKernel<2 * W, SqrtFloat>(out, in, count, reference_sqrt);    \
+    }                                                                          \
+    ATTR __attribute__((flatten)) void NAME##Divide(                           \
+        float *out, const float *x, const float *y, size_t count)              \
+    {                                                                          \
+        DivideKernel<W>(out, x, y, count);                                     \
+    }                                                                          \
+    ATTR __attribute__((flatten)) void NAME##Fma(                              \
+        float *out, const float *a, const float *b, const float *c,            \
+        size_t count)                                                          \
+    {                                                                          \
+        Fma<W>(out, a, b, c, count);                                           \
+    }                                                                          \
+    DEFINE_FLOAT_UNARY(NAME, W, ATTR, Fabs, reference_fabs)                    \
+    DEFINE_FLOAT_UNARY(NAME, W, ATTR, Floor, reference_floor)                  \
+    DEFINE_FLOAT_UNARY(NAME, W, ATTR, Ceil, reference_ceil)                    \
+    DEFINE_FLOAT_UNARY(NAME, W, ATTR, Trunc, reference_trunc)                  \
+    DEFINE_FLOAT_UNARY(NAME, W, ATTR, Rint, reference_rint)                    \
+    DEFINE_FLOAT_BINARY(NAME, W, ATTR, Fmax, reference_fmax)                   \
+    DEFINE_FLOAT_BINARY(NAME, W, ATTR, Fmin, reference_fmin)                   \
+    DEFINE_FLOAT_BINARY(NAME, W, ATTR, Copysign, reference_copysignf)          \
+    ATTR __attribute__((flatten)) size_t NAME##FirstMismatch(                  \
+        const uint32_t *ref, const uint32_t *test, size_t start, size_t count) \
+    {                                                                          \
+        return FloatMismatchKernel<2 * W>(ref, test, start, count);            \
+    }                                                                          \
+    const BatchTable NAME##Table = {                                           \
+        NAME##Exp,   NAME##Log,      NAME##Sin,     NAME##Cos,                 \
+        NAME##Sqrt,  NAME##Divide,   NAME##Fma,     NAME##Fabs,                \
+        NAME##Floor, NAME##Ceil,     NAME##Trunc,   NAME##Rint,                \
+        NAME##Fmax,  NAME##Fmin,     NAME##Copysign, NAME##FirstMismatch       \
+    };
+
+#if defined(__x86_64__)
+DEFINE_BATCH_TABLE(SSE2, 2, )
+DEFINE_BATCH_TABLE(AVX2, 4, __attribute__((target("avx2"))))
+DEFINE_DOUBLE_BATCH_TABLE(SSE2, 2, )
+DEFINE_DOUBLE_BATCH_TABLE(AVX2, 4, __attribute__((target("avx2"))))
+
+__attribute__((target("avx2,fma"), flatten)) void
+FMAFmaDouble(double *out, const double *a, const double *b, const double *c,
+             size_t count)
+{
+    DoubleFmaKernel<4, FmaDouble>(out, a, b, c, count);
+}
+
+const BatchTable &GetBatchTable()
+{
+    static const BatchTable &table =
+        __builtin_cpu_supports("avx2") ? AVX2Table : SSE2Table;
+    return table;
+}
+
+const DoubleBatchTable &GetDoubleBatchTable()
+{
+    static const DoubleBatchTable &table =
+        __builtin_cpu_supports("avx2") ? AVX2DoubleTable : SSE2DoubleTable;
+    return table;
+}
+
+// SSE2 has no fma, so reference_fmal stays scalar there
+BatchReference_d_ddd GetFmaDouble()
+{
+    static const BatchReference_d_ddd fma =
+        __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")
+        ? FMAFmaDouble
+        : NULL;
+    return fma;
+}
+#else
+DEFINE_BATCH_TABLE(NEON, 2, )
+DEFINE_DOUBLE_BATCH_TABLE(NEON, 2, )
+
+__attribute__((flatten)) void NEONFmaDouble(double *out, const double *a,
+                                            const double *b, const double *c,
+                                            size_t count)
+{
+    DoubleFmaKernel<2, FmaDouble>(out, a, b, c, count);
+}
+
+const BatchTable &GetBatchTable() { return NEONTable; }
+
+const DoubleBatchTable &GetDoubleBatchTable() { return NEONDoubleTable; }
+
+BatchReference_d_ddd GetFmaDouble() { return NEONFmaDouble; }
+#endif
+
+} // anonymous namespace
+
+BatchReference_f_f GetBatchReference(double (*ref)(double))
+{
+    const BatchTable &table = GetBatchTable();
+    if (ref == reference_exp) return table.exp;
+    if (ref == reference_log) return table.log;
+    if (ref == reference_sin) return table.sin;
+    if (ref == reference_cos) return table.cos;
+    if (ref == reference_sqrt) return table.sqrt;
+    if (ref == reference_fabs) return table.fabs;
+    if (ref == reference_floor) return table.floor;
+    if (ref == reference_ceil) return table.ceil;
+    if (ref == reference_trunc) return table.trunc;
+    if (ref == reference_rint) return table.rint;
+    return NULL;
+}
+
+BatchReference_f_ff GetBatchReference(double (*ref)(double, double))
+{
+    const BatchTable &table = GetBatchTable();
+    if (ref == reference_divide) return table.divide;
+    if (ref == reference_fmax) return table.fmax;
+    if (ref == reference_fmin) return table.fmin;
+    return NULL;
+}
+
+BatchReference_f_ff GetBatchReference(float (*ref)(float, float))
+{
+    if (ref == reference_copysignf) return GetBatchTable().copysign;
+    return NULL;
+}
+
+BatchReference_fma GetBatchReference(float (*ref)(float, float, float, int))
+{
+    if (ref == reference_fma) return GetBatchTable().fma;
+    return NULL;
+}
+
+BatchReference_d_d GetBatchReference(long double (*ref)(long double))
+{
+    const DoubleBatchTable &table = GetDoubleBatchTable();
+    if (ref == reference_expl) return table.exp;
+    if (ref == reference_logl) return table.log;
+    if (ref == reference_sqrtl) return table.sqrt;
+    return NULL;
+}
+
+BatchReference_d_dd GetBatchReference(long double (*ref)(long double,
+                                                         long double))
+{
+    const DoubleBatchTable &table = GetDoubleBatchTable();
+    if (ref == reference_addl) return table.add;
+    if (ref == reference_subtractl) return table.subtract;
+    if (ref == reference_multiplyl) return table.multiply;
+    if (ref == reference_dividel) return table.divide;
+    if (ref == reference_fmaxl) return table.fmax;
+    if (ref == reference_fminl) return table.fmin;
+    return NULL;
+}
+
+BatchReference_d_ddd GetBatchReference(long double (*ref)(long double,
+                                                          long double,
+                                                          long double))
+{
+    if (ref == reference_fmal) return GetFmaDouble();
+    return NULL;
+}
+
+size_t FirstFloatMismatch(const uint32_t *ref, const uint32_t *test,
+                          size_t start, size_t count)
+{
+    return GetBatchTable().firstMismatch(ref, test, start, count);
+}
+
+#else
+
+BatchReference_f_f GetBatchReference(double (*ref)(double)) { return NULL; }
+
+BatchReference_f_ff GetBatchReference(double (*ref)(double, double))
+{
+    return NULL;
+}
+
+BatchReference_f_ff GetBatchReference(float (*ref)(float, float))
+{
+    return NULL;
+}
+
+BatchReference_fma GetBatchReference(float (*ref)(float, float, float, int))
+{
+    return NULL;
+}
+
+BatchReference_d_d GetBatchReference(long double (*ref)(long double))
+{
+    return NULL;
+}
+
+BatchReference_d_dd GetBatchReference(long double (*ref)(long double,
+                                                         long double))
+{
+    return NULL;
+}
+
+BatchReference_d_ddd GetBatchReference(long double (*ref)(long double,
+                                                          long double,
+                                                          long double))
+{
+    return NULL;
+}
+
+size_t FirstFloatMismatch(const uint32_t *ref, const uint32_t *test,
+                          size_t start, size_t count)
+{
+    for (size_t i = start; i < count; i++)
+        if (ref[i] != test[i]
+            && !((ref[i] & 0x7fffffff) > 0x7f800000
+                 && (test[i] & 0x7fffffff) > 0x7f800000))
+            return i;
+    return count;
+}
+
+#endif
@@ -0,0 +1,112 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "sampling.h"
+
+#include <cmath>
+
+bool gWimpyStrided = false;
+
+namespace {
+
+// splitmix64, for the jitter of the stratified samples
+uint64_t Mix(uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+} // anonymous namespace
+
+uint64_t WimpySampleBits(int exponentBits, int mantissaBits, uint64_t index,
+                         uint64_t count)
+{
+    const uint64_t mantissaMask = (1ULL << mantissaBits) - 1;
+    const uint64_t maxExponent = (1ULL << exponentBits) - 1;
+    const uint64_t bias = maxExponent >> 1;
+    const uint64_t one = bias << mantissaBits;
+    const uint64_t infinity = maxExponent << mantissaBits;
+    const uint64_t signBit = 1ULL << (exponentBits + mantissaBits);
+
+    // Special values, each with both signs
+    const uint64_t specials[] = {
+        0,
+        1,
+        mantissaMask,
+        mantissaMask + 1,
+        one - (1ULL << mantissaBits),
+        one - 1,
+        one,
+        one + 1,
+        one + (1ULL << mantissaBits),
+        // The smallest value whose ulp is 1
+        one + ((uint64_t)mantissaBits << mantissaBits),
+        infinity - 1,
+        infinity,
+        infinity | (1ULL << (mantissaBits - 1)),
+        infinity | 1,
+    };
+    const uint64_t specialCount = 2 * sizeof(specials) / sizeof(specials[0]);
+    if (index < specialCount)
+        return specials[index >> 1] | ((index & 1) ? signBit : 0);
+    index -= specialCount;
+    uint64_t remaining = count - specialCount;
+
+    // Boundaries: the leading bits of the denormals, then the start of every
+    // binade including the denormal to normal one and infinity. width
+    // patterns on either sign of each, nearest first.
+    const uint64_t boundaries = mantissaBits + maxExponent;
+    uint64_t width = remaining / 4 / (2 * boundaries);
+    if (width == 0) width = 1;
+    if (index < 2 * boundaries * width)
+    {
+        uint64_t sign = (index & 1) ? signBit : 0;
+        uint64_t boundary = (index >> 1) % boundaries;
+        uint64_t k = (index >> 1) / boundaries;
+        uint64_t center = boundary < (uint64_t)mantissaBits
+            ? 1ULL << boundary
+            : (boundary - mantissaBits + 1) << mantissaBits;
+
+        // Alternate above and below the boundary, only below infinity
+        uint64_t bits;
+        if (center == infinity)
+            bits = infinity - 1 - k;
+        else if (k & 1)
+            bits = center > k / 2 ? center - 1 - k / 2 : center + k;
+        else
+            bits = center + k / 2;
+        return bits | sign;
+    }
+    index -= 2 * boundaries * width;
+    remaining -= 2 * boundaries * width;
+
+    // Stratified samples: the buckets are the signs and exponents other than
+    // that of infinity and NaN, taken in turn. The k-th of the n samples of a
+    // bucket lies in the k-th of n equal parts of its mantissas.
+    const uint64_t buckets = 2 * maxExponent;
+    uint64_t bucket = index % buckets;
+    uint64_t k = index / buckets;
+    uint64_t n = (remaining - bucket + buckets - 1) / buckets;
+    double jitter = (double)(Mix(index) >> 11) * 0x1.0p-53;
+    double part = ldexp(1.0, mantissaBits) / (double)n;
+    uint64_t mantissa = (uint64_t)(((double)k + jitter) * part);
+    if (mantissa > mantissaMask) mantissa = mantissaMask;
+
+    return ((bucket & 1) ? signBit : 0) | ((bucket >> 1) << mantissaBits)
+        | mantissa;
+}
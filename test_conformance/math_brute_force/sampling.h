@@ -0,0 +1,101 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef SAMPLING_H
+#define SAMPLING_H
+
+#include "utility.h"
+
+#include <cstring>
+
+// In wimpy mode the tests that walk their input bit patterns with a stride of
+// scale test count = domain / scale inputs. Rather than every scale-th
+// pattern, which spends almost all of them on the middle of binades, the
+// same count is spent on:
+//
+// - special values: zeros, infinities, NaNs, the smallest and largest
+//   denormals and normals, and the values around 0.5, 1 and 2,
+// - the neighbourhoods of every binade boundary, of the boundary between
+//   denormals and normals and of the leading bits of the denormals, which
+//   take a quarter of the inputs between them,
+// - jittered samples stratified over the mantissas of every sign and
+//   exponent, which take the rest.
+//
+// The inputs are a fixed function of their index, so reruns and shards test
+// the same ones. Setting CL_MATH_WIMPY_STRIDED brings back the strided walk.
+extern bool gWimpyStrided;
+
+// Bits of the index-th of count sampled inputs of a format with the given
+// number of exponent and explicit mantissa bits.
+uint64_t WimpySampleBits(int exponentBits, int mantissaBits, uint64_t index,
+                         uint64_t count);
+
+inline bool UseWimpySampling() { return gWimpyMode && !gWimpyStrided; }
+
+// The input that replaces the strided value bits, the index-th of count, in
+// wimpy mode; bits itself otherwise.
+inline cl_uint SampleFloatInput(cl_uint bits, uint64_t index, uint64_t count)
+{
+    if (!UseWimpySampling()) return bits;
+    return (cl_uint)WimpySampleBits(8, 23, index, count);
+}
+
+// Replaces DoubleFromUInt32(bits), which spreads the 2^32 strided values over
+// the doubles.
+inline double SampleDoubleInput(cl_uint bits, uint64_t index, uint64_t count)
+{
+    if (!UseWimpySampling()) return DoubleFromUInt32(bits);
+    uint64_t u = WimpySampleBits(11, 52, index, count);
+    double d;
+    memcpy(&d, &u, sizeof(d));
+    return d;
+}
+
+inline cl_ushort SampleHalfInput(cl_ushort bits, uint64_t index,
+                                 uint64_t count)
+{
+    if (!UseWimpySampling()) return bits;
+    return (cl_ushort)WimpySampleBits(5, 10, index, count);
+}
+
+// For the tests that walk the values bits = k * scale in order.
+inline cl_uint SampleFloatInput(cl_uint bits, cl_uint scale)
+{
+    if (scale <= 1) return bits;
+    return SampleFloatInput(bits, bits / scale, (1ULL << 32) / scale);
+}
+
+inline double SampleDoubleInput(cl_uint bits, cl_uint scale)
+{
+    if (scale <= 1) return DoubleFromUInt32(bits);
+    return SampleDoubleInput(bits, bits / scale, (1ULL << 32) / scale);
+}
+
+inline cl_ushort SampleHalfInput(cl_ushort bits, cl_uint scale)
+{
+    uint64_t count = (1U << 16) / scale;
+    if (scale <= 1 || count == 0) return bits;
+    return SampleHalfInput(bits, bits / scale, count);
+}
+
+// For the tests that fill all n elements of the buffer for every step of the
+// 2^32 values: the number of inputs they test. The j-th input of step i is
+// then the (i / step * n + j)-th.
+inline uint64_t WimpySampleCount(uint64_t step, size_t n)
+{
+    return ((1ULL << 32) + step - 1) / step * n;
+}
+
+#endif /* SAMPLING_H */
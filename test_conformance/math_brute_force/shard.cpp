@@ -0,0 +1,154 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "shard.h"
+
+#include "harness/checkpoint.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+cl_uint gShardIndex = 0;
+cl_uint gShardCount = 1;
+const char *gShardResultsFile = NULL;
+
+namespace {
+
+const char *gCurrentName = "";
+const char *gCurrentType = "";
+bool gCurrentRelaxed = false;
+std::chrono::steady_clock::time_point gCurrentStart;
+std::atomic<uint64_t> gValuesTested{ 0 };
+
+struct ShardJobs
+{
+    TPFuncPtr func;
+    void *userInfo;
+    cl_uint first;
+    size_t valuesPerJob;
+};
+
+cl_int ShardJob(cl_uint job_id, cl_uint thread_id, void *p)
+{
+    ShardJobs *jobs = (ShardJobs *)p;
+    cl_int error = jobs->func(jobs->first + job_id, thread_id, jobs->userInfo);
+    if (CL_SUCCESS == error) gValuesTested += jobs->valuesPerJob;
+    return error;
+}
+
+// First job of shard index when count jobs are split into gShardCount parts
+uint64_t ShardBoundary(uint64_t count, cl_uint index)
+{
+    // count is at most 2^32 here, so this can't overflow
+    return count * index / gShardCount;
+}
+
+// Name of the checkpoint for the jobs of the current test in this shard
+std::string CheckpointName()
+{
+    std::string name = std::string(gCurrentName) + "_" + gCurrentType
+        + (gCurrentRelaxed ? "_relaxed" : "") + (gForceFTZ ? "_ftz" : "")
+        + "_v" + std::to_string(gMinVectorSizeIndex) + "-"
+        + std::to_string(gMaxVectorSizeIndex);
+    if (gShardCount > 1)
+        name += "_shard" + std::to_string(gShardIndex) + "of"
+            + std::to_string(gShardCount);
+    return name;
+}
+
+} // anonymous namespace
+
+bool ParseShard(const char *text)
+{
+    char *end = NULL;
+    unsigned long index = strtoul(text, &end, 10);
+    if (end == text || '/' != *end) return false;
+
+    const char *countText = end + 1;
+    unsigned long count = strtoul(countText, &end, 10);
+    if (end == countText || '\0' != *end) return false;
+    if (0 == count || count > 0xffff || index >= count) return false;
+
+    gShardIndex = (cl_uint)index;
+    gShardCount = (cl_uint)count;
+    return true;
+}
+
+void SetCurrentTest(const char *name, const char *type, bool relaxedMode)
+{
+    gCurrentName = name;
+    gCurrentType = type;
+    gCurrentRelaxed = relaxedMode;
+    gCurrentStart = std::chrono::steady_clock::now();
+    gValuesTested = 0;
+}
+
+void ReportThroughput()
+{
+    std::chrono::duration<double> seconds =
+        std::chrono::steady_clock::now() - gCurrentStart;
+    if (gValuesTested && seconds.count() > 0.0)
+        vlog("\t%.1f s, %.2f Mvalues/s\n", seconds.count(),
+             gValuesTested / seconds.count() * 1e-6);
+    else
+        vlog("\t%.1f s\n", seconds.count());
+}
+
+cl_int ThreadPool_DoShard(TPFuncPtr func_ptr, cl_uint count, void *userInfo,
+                          size_t valuesPerJob)
+{
+    cl_uint first = (cl_uint)ShardBoundary(count, gShardIndex);
+    cl_uint last = (cl_uint)ShardBoundary(count, gShardIndex + 1);
+    if (first == last) return CL_SUCCESS;
+
+    std::unique_ptr<JobCheckpoint> checkpoint =
+        JobCheckpoint::Open(CheckpointName(), last - first);
+    ShardJobs jobs = { func_ptr, userInfo, first, valuesPerJob };
+    return ThreadPool_DoCheckpointed(checkpoint.get(), ShardJob, last - first,
+                                     &jobs);
+}
+
+void GetShardRange(uint64_t count, uint64_t step, uint64_t *begin,
+                   uint64_t *end)
+{
+    // Split whole iterations so every shard sees the same loop counter
+    // values as an unsharded run.
+    uint64_t iterations = (count + step - 1) / step;
+    *begin = ShardBoundary(iterations, gShardIndex) * step;
+    *end = ShardBoundary(iterations, gShardIndex + 1) * step;
+    if (*end > count) *end = count;
+}
+
+void RecordShardResult(bool failed)
+{
+    if (NULL == gShardResultsFile) return;
+
+    FILE *file = fopen(gShardResultsFile, "a");
+    if (NULL == file)
+    {
+        vlog_error("Unable to open shard results file %s\n",
+                   gShardResultsFile);
+        return;
+    }
+
+    fprintf(file, "%u/%u %s %s %s %s\n", gShardIndex, gShardCount,
+            gCurrentName, gCurrentType,
+            gCurrentRelaxed ? "relaxed" : "precise", failed ? "fail" : "pass");
+    fclose(file);
+}
@@ -0,0 +1,61 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef SHARD_H
+#define SHARD_H
+
+#include "utility.h"
+
+// Splitting of each function's input domain across several processes, taken
+// from the CL_MATH_SHARD environment variable as "index/count" with a zero
+// based index. Every process runs the same functions, but only its share of
+// the jobs of each one. With no sharding gShardIndex is 0 and gShardCount 1.
+extern cl_uint gShardIndex;
+extern cl_uint gShardCount;
+
+// File that each shard appends one line per tested function, type and mode
+// to, taken from CL_MATH_SHARD_RESULTS. NULL if no results are recorded.
+// merge_math_brute_force_shards.py combines the files of all shards.
+extern const char *gShardResultsFile;
+
+// Parse the value of CL_MATH_SHARD. Return false if it is malformed.
+bool ParseShard(const char *text);
+
+// Name the function, type and mode that the following TestFunc call tests,
+// for the checkpoints and the results file, and start timing it.
+void SetCurrentTest(const char *name, const char *type, bool relaxedMode);
+
+// Log how long the current test took, and how many input values per second
+// it tested if it ran through ThreadPool_DoShard.
+void ReportThroughput();
+
+// Like ThreadPool_Do, but only run this shard's part of the count jobs. The
+// jobs keep their original job_id, so they test exactly the inputs they
+// would in an unsharded run. With --checkpoint-path the completed jobs are
+// recorded, and with --resume those an earlier run completed are skipped.
+// Each job tests valuesPerJob input values, for ReportThroughput.
+cl_int ThreadPool_DoShard(TPFuncPtr func_ptr, cl_uint count, void *userInfo,
+                          size_t valuesPerJob);
+
+// For tests that walk their domain in a serial loop from 0 to count in
+// increments of step, return the first value of the loop counter in this
+// shard and the value it stops at.
+void GetShardRange(uint64_t count, uint64_t step, uint64_t *begin,
+                   uint64_t *end);
+
+// Append the verdict of the current test to gShardResultsFile.
+void RecordShardResult(bool failed);
+
+#endif /* SHARD_H */
@@ -16,6 +16,8 @@
 
 #include "common.h"
 #include "function_list.h"
+#include "reference_math.h"
+#include "shard.h"
 #include "test_functions.h"
 #include "utility.h"
 
@@ -125,7 +127,8 @@ int TestFunc_Double_Double_Double_Double(const Func *f, MTdata d,
     double maxErrorVal = 0.0f;
     double maxErrorVal2 = 0.0f;
     double maxErrorVal3 = 0.0f;
-    uint64_t step = getTestStep(sizeof(double), BUFFER_SIZE);
+    uint64_t step = getTestStep(sizeof(double), gBufferSize);
+    BatchReference_d_ddd batchRef = GetBatchReference(f->dfunc.f_fff);
 
     logFunctionInfo(f->name, sizeof(cl_double), relaxedMode);
 
@@ -139,7 +142,9 @@ int TestFunc_Double_Double_Double_Double(const Func *f, MTdata d,
                                &build_info)))
         return error;
 
-    for (uint64_t i = 0; i < (1ULL << 32); i += step)
+    uint64_t begin, end;
+    GetShardRange(1ULL << 32, step, &begin, &end);
+    for (uint64_t i = begin; i < end; i += step)
     {
         // Init input array
         double *p = (double *)gIn;
@@ -151,7 +156,7 @@ int TestFunc_Double_Double_Double_Double(const Func *f, MTdata d,
         { // test edge cases
             uint32_t x, y, z;
             x = y = z = 0;
-            for (; idx < BUFFER_SIZE / sizeof(double); idx++)
+            for (; idx < gBufferSize / sizeof(double); idx++)
             {
                 p[idx] = specialValues[x];
                 p2[idx] = specialValues[y];
@@ -166,33 +171,33 @@ int TestFunc_Double_Double_Double_Double(const Func *f, MTdata d,
                     }
                 }
             }
-            if (idx == BUFFER_SIZE / sizeof(double))
+            if (idx == gBufferSize / sizeof(double))
                 vlog_error("Test Error: not all special cases tested!\n");
         }
 
-        for (; idx < BUFFER_SIZE / sizeof(double); idx++)
+        for (; idx < gBufferSize / sizeof(double); idx++)
         {
             p[idx] = DoubleFromUInt32(genrand_int32(d));
             p2[idx] = DoubleFromUInt32(genrand_int32(d));
             p3[idx] = DoubleFromUInt32(genrand_int32(d));
         }
 
-        if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer, CL_FALSE, 0,
-                                          BUFFER_SIZE, gIn, 0, NULL, NULL)))
+        if ((error = enqueue_write_staged(gQueue, gInBuffer, CL_FALSE, 0,
+                                          gBufferSize, gIn, 0, NULL, NULL)))
         {
             vlog_error("\n*** Error %d in clEnqueueWriteBuffer ***\n", error);
             return error;
         }
 
-        if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer2, CL_FALSE, 0,
-                                          BUFFER_SIZE, gIn2, 0, NULL, NULL)))
+        if ((error = enqueue_write_staged(gQueue, gInBuffer2, CL_FALSE, 0,
+                                          gBufferSize, gIn2, 0, NULL, NULL)))
         {
             vlog_error("\n*** Error %d in clEnqueueWriteBuffer2 ***\n", error);
             return error;
         }
 
-        if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer3, CL_FALSE, 0,
-                                          BUFFER_SIZE, gIn3, 0, NULL, NULL)))
+        if ((error = enqueue_write_staged(gQueue, gInBuffer3, CL_FALSE, 0,
+                                          gBufferSize, gIn3, 0, NULL, NULL)))
         {
             vlog_error("\n*** Error %d in clEnqueueWriteBuffer3 ***\n", error);
             return error;
@@ -204,9 +209,9 @@ int TestFunc_Double_Double_Double_Double(const Func *f, MTdata d,
             uint32_t pattern = 0xffffdead;
             if (gHostFill)
             {
-                memset_pattern4(gOut[j], &pattern, BUFFER_SIZE);
-                if ((error = clEnqueueWriteBuffer(gQueue, gOutBuffer[j],
-                                                  CL_FALSE, 0, BUFFER_SIZE,
+                memset_pattern4(gOut[j], &pattern, gBufferSize);
+                if ((error = enqueue_write_staged(gQueue, gOutBuffer[j],
+                                                  CL_FALSE, 0, gBufferSize,
                                                   gOut[j], 0, NULL, NULL)))
                 {
                     vlog_error(
@@ -219,7 +224,7 @@ int TestFunc_Double_Double_Double_Double(const Func *f, MTdata d,
             {
                 if ((error = clEnqueueFillBuffer(gQueue, gOutBuffer[j],
                                                  &pattern, sizeof(pattern), 0,
-                                                 BUFFER_SIZE, 0, NULL, NULL)))
+                                                 gBufferSize, 0, NULL, NULL)))
                 {
                     vlog_error("Error: clEnqueueFillBuffer failed! err: %d\n",
                                error);
@@ -232,8 +237,8 @@ int TestFunc_Double_Double_Double_Double(const Func *f, MTdata d,
         for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
         {
             size_t vectorSize = sizeof(cl_double) * sizeValues[j];
-            size_t localCount = (BUFFER_SIZE + vectorSize - 1)
-                / vectorSize; // BUFFER_SIZE / vectorSize  rounded up
+            size_t localCount = (gBufferSize + vectorSize - 1)
+                / vectorSize; // gBufferSize / vectorSize  rounded up
             if ((error = clSetKernelArg(kernels[j][thread_id], 0,
                                         sizeof(gOutBuffer[j]), &gOutBuffer[j])))
             {
@@ -276,15 +281,18 @@ int TestFunc_Double_Double_Double_Double(const Func *f, MTdata d,
         double *s = (double *)gIn;
         double *s2 = (double *)gIn2;
         double *s3 = (double *)gIn3;
-        for (size_t j = 0; j < BUFFER_SIZE / sizeof(double); j++)
-            r[j] = (double)f->dfunc.f_fff(s[j], s2[j], s3[j]);
+        if (batchRef)
+            batchRef(r, s, s2, s3, gBufferSize / sizeof(double));
+        else
+            for (size_t j = 0; j < gBufferSize / sizeof(double); j++)
+                r[j] = (double)f->dfunc.f_fff(s[j], s2[j], s3[j]);
 
         // Read the data back
         for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
         {
             if ((error =
-                     clEnqueueReadBuffer(gQueue, gOutBuffer[j], CL_TRUE, 0,
-                                         BUFFER_SIZE, gOut[j], 0, NULL, NULL)))
+                     enqueue_read_staged(gQueue, gOutBuffer[j], CL_TRUE, 0,
+                                         gBufferSize, gOut[j], 0, NULL, NULL)))
             {
                 vlog_error("ReadArray failed %d\n", error);
                 return error;
@@ -295,8 +303,12 @@ int TestFunc_Double_Double_Double_Double(const Func *f, MTdata d,
 
         // Verify data
         uint64_t *t = (uint64_t *)gOut_Ref;
-        for (size_t j = 0; j < BUFFER_SIZE / sizeof(double); j++)
+        for (size_t j = 0; j < gBufferSize / sizeof(double); j++)
         {
+            // Skip the elements that match for every vector size
+            j = FindFirstMismatch(t, gOut, j, gBufferSize / sizeof(double));
+            if (j == gBufferSize / sizeof(double)) break;
+
             for (auto k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++)
             {
                 uint64_t *q = (uint64_t *)(gOut[k]);
@@ -626,8 +638,8 @@ int TestFunc_Double_Double_Double_Double(const Func *f, MTdata d,
             if (gVerboseBruteForce)
             {
                 vlog("base:%14" PRIu64 " step:%10" PRIu64
-                     "  bufferSize:%10d \n",
-                     i, step, BUFFER_SIZE);
+                     "  bufferSize:%10zu \n",
+                     i, step, gBufferSize);
             }
             else
             {
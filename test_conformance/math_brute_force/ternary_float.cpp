@@ -16,6 +16,8 @@
 
 #include "common.h"
 #include "function_list.h"
+#include "reference_math.h"
+#include "shard.h"
 #include "test_functions.h"
 #include "utility.h"
 
@@ -137,9 +139,9 @@ int TestFunc_Float_Float_Float_Float(const Func *f, MTdata d, bool relaxedMode)
     float maxErrorVal = 0.0f;
     float maxErrorVal2 = 0.0f;
     float maxErrorVal3 = 0.0f;
-    uint64_t step = getTestStep(sizeof(float), BUFFER_SIZE);
+    uint64_t step = getTestStep(sizeof(float), gBufferSize);
 
-    cl_uchar overflow[BUFFER_SIZE / sizeof(float)];
+    std::vector<cl_uchar> overflow(gBufferSize / sizeof(float));
 
     float float_ulps;
     if (gIsEmbedded)
@@ -157,7 +159,9 @@ int TestFunc_Float_Float_Float_Float(const Func *f, MTdata d, bool relaxedMode)
                                &build_info)))
         return error;
 
-    for (uint64_t i = 0; i < (1ULL << 32); i += step)
+    uint64_t begin, end;
+    GetShardRange(1ULL << 32, step, &begin, &end);
+    for (uint64_t i = begin; i < end; i += step)
     {
         // Init input array
         cl_uint *p = (cl_uint *)gIn;
@@ -172,7 +176,7 @@ int TestFunc_Float_Float_Float_Float(const Func *f, MTdata d, bool relaxedMode)
             float *fp3 = (float *)gIn3;
             uint32_t x, y, z;
             x = y = z = 0;
-            for (; idx < BUFFER_SIZE / sizeof(float); idx++)
+            for (; idx < gBufferSize / sizeof(float); idx++)
             {
                 fp[idx] = specialValues[x];
                 fp2[idx] = specialValues[y];
@@ -188,33 +192,33 @@ int TestFunc_Float_Float_Float_Float(const Func *f, MTdata d, bool relaxedMode)
                     }
                 }
             }
-            if (idx == BUFFER_SIZE / sizeof(float))
+            if (idx == gBufferSize / sizeof(float))
                 vlog_error("Test Error: not all special cases tested!\n");
         }
 
-        for (; idx < BUFFER_SIZE / sizeof(float); idx++)
+        for (; idx < gBufferSize / sizeof(float); idx++)
         {
             p[idx] = genrand_int32(d);
             p2[idx] = genrand_int32(d);
             p3[idx] = genrand_int32(d);
         }
 
-        if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer, CL_FALSE, 0,
-                                          BUFFER_SIZE, gIn, 0, NULL, NULL)))
+        if ((error = enqueue_write_staged(gQueue, gInBuffer, CL_FALSE, 0,
+                                          gBufferSize, gIn, 0, NULL, NULL)))
         {
             vlog_error("\n*** Error %d in clEnqueueWriteBuffer ***\n", error);
             return error;
         }
 
-        if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer2, CL_FALSE, 0,
-                                          BUFFER_SIZE, gIn2, 0, NULL, NULL)))
+        if ((error = enqueue_write_staged(gQueue, gInBuffer2, CL_FALSE, 0,
+                                          gBufferSize, gIn2, 0, NULL, NULL)))
         {
             vlog_error("\n*** Error %d in clEnqueueWriteBuffer2 ***\n", error);
             return error;
         }
 
-        if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer3, CL_FALSE, 0,
-                                          BUFFER_SIZE, gIn3, 0, NULL, NULL)))
+        if ((error = enqueue_write_staged(gQueue, gInBuffer3, CL_FALSE, 0,
+                                          gBufferSize, gIn3, 0, NULL, NULL)))
         {
             vlog_error("\n*** Error %d in clEnqueueWriteBuffer3 ***\n", error);
             return error;
@@ -226,9 +230,9 @@ int TestFunc_Float_Float_Float_Float(const Func *f, MTdata d, bool relaxedMode)
             uint32_t pattern = 0xffffdead;
             if (gHostFill)
             {
-                memset_pattern4(gOut[j], &pattern, BUFFER_SIZE);
-                if ((error = clEnqueueWriteBuffer(gQueue, gOutBuffer[j],
-                                                  CL_FALSE, 0, BUFFER_SIZE,
+                memset_pattern4(gOut[j], &pattern, gBufferSize);
+                if ((error = enqueue_write_staged(gQueue, gOutBuffer[j],
+                                                  CL_FALSE, 0, gBufferSize,
                                                   gOut[j], 0, NULL, NULL)))
                 {
                     vlog_error(
@@ -241,7 +245,7 @@ int TestFunc_Float_Float_Float_Float(const Func *f, MTdata d, bool relaxedMode)
             {
                 if ((error = clEnqueueFillBuffer(gQueue, gOutBuffer[j],
                                                  &pattern, sizeof(pattern), 0,
-                                                 BUFFER_SIZE, 0, NULL, NULL)))
+                                                 gBufferSize, 0, NULL, NULL)))
                 {
                     vlog_error("Error: clEnqueueFillBuffer failed! err: %d\n",
                                error);
@@ -254,8 +258,8 @@ int TestFunc_Float_Float_Float_Float(const Func *f, MTdata d, bool relaxedMode)
         for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
         {
             size_t vectorSize = sizeof(cl_float) * sizeValues[j];
-            size_t localCount = (BUFFER_SIZE + vectorSize - 1)
-                / vectorSize; // BUFFER_SIZE / vectorSize  rounded up
+            size_t localCount = (gBufferSize + vectorSize - 1)
+                / vectorSize; // gBufferSize / vectorSize  rounded up
             if ((error = clSetKernelArg(kernels[j][thread_id], 0,
                                         sizeof(gOutBuffer[j]), &gOutBuffer[j])))
             {
@@ -300,7 +304,7 @@ int TestFunc_Float_Float_Float_Float(const Func *f, MTdata d, bool relaxedMode)
         float *s3 = (float *)gIn3;
         if (skipNanInf)
         {
-            for (size_t j = 0; j < BUFFER_SIZE / sizeof(float); j++)
+            for (size_t j = 0; j < gBufferSize / sizeof(float); j++)
             {
                 feclearexcept(FE_OVERFLOW);
                 r[j] =
@@ -311,17 +315,21 @@ int TestFunc_Float_Float_Float_Float(const Func *f, MTdata d, bool relaxedMode)
         }
         else
         {
-            for (size_t j = 0; j < BUFFER_SIZE / sizeof(float); j++)
-                r[j] =
-                    (float)f->func.f_fma(s[j], s2[j], s3[j], CORRECTLY_ROUNDED);
+            BatchReference_fma batchRef = GetBatchReference(f->func.f_fma);
+            if (batchRef)
+                batchRef(r, s, s2, s3, gBufferSize / sizeof(float));
+            else
+                for (size_t j = 0; j < gBufferSize / sizeof(float); j++)
+                    r[j] = (float)f->func.f_fma(s[j], s2[j], s3[j],
+                                                CORRECTLY_ROUNDED);
         }
 
         // Read the data back
         for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
         {
             if ((error =
-                     clEnqueueReadBuffer(gQueue, gOutBuffer[j], CL_TRUE, 0,
-                                         BUFFER_SIZE, gOut[j], 0, NULL, NULL)))
+                     enqueue_read_staged(gQueue, gOutBuffer[j], CL_TRUE, 0,
+                                         gBufferSize, gOut[j], 0, NULL, NULL)))
             {
                 vlog_error("ReadArray failed %d\n", error);
                 return error;
@@ -332,8 +340,12 @@ int TestFunc_Float_Float_Float_Float(const Func *f, MTdata d, bool relaxedMode)
 
         // Verify data
         uint32_t *t = (uint32_t *)gOut_Ref;
-        for (size_t j = 0; j < BUFFER_SIZE / sizeof(float); j++)
+        for (size_t j = 0; j < gBufferSize / sizeof(float); j++)
         {
+            // Skip the elements that match for every vector size
+            j = FindFirstMismatch(t, gOut, j, gBufferSize / sizeof(float));
+            if (j == gBufferSize / sizeof(float)) break;
+
             for (auto k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++)
             {
                 uint32_t *q = (uint32_t *)(gOut[k]);
@@ -762,8 +774,9 @@ int TestFunc_Float_Float_Float_Float(const Func *f, MTdata d, bool relaxedMode)
         {
             if (gVerboseBruteForce)
             {
-                vlog("base:%14" PRIu64 " step:%10" PRIu64 " bufferSize:%10d \n",
-                     i, step, BUFFER_SIZE);
+                vlog("base:%14" PRIu64 " step:%10" PRIu64
+                     " bufferSize:%10zu \n",
+                     i, step, gBufferSize);
             }
             else
             {
@@ -16,6 +16,8 @@
 
 #include "common.h"
 #include "function_list.h"
+#include "sampling.h"
+#include "shard.h"
 #include "test_functions.h"
 #include "utility.h"
 
@@ -49,9 +51,9 @@ int TestFunc_Float2_Float(const Func *f, MTdata d, bool relaxedMode)
     int ftz = f->ftz || gForceFTZ || 0 == (CL_FP_DENORM & gFloatCapabilities);
     float maxErrorVal0 = 0.0f;
     float maxErrorVal1 = 0.0f;
-    uint64_t step = getTestStep(sizeof(float), BUFFER_SIZE);
-    int scale = (int)((1ULL << 32) / (16 * BUFFER_SIZE / sizeof(float)) + 1);
-    cl_uchar overflow[BUFFER_SIZE / sizeof(float)];
+    uint64_t step = getTestStep(sizeof(float), gBufferSize);
+    int scale = (int)((1ULL << 32) / (16 * gBufferSize / sizeof(float)) + 1);
+    std::vector<cl_uchar> overflow(gBufferSize / sizeof(float));
     int isFract = 0 == strcmp("fract", f->nameInCode);
     int skipNanInf = isFract && !gInfNanSupport;
 
@@ -66,15 +68,20 @@ int TestFunc_Float2_Float(const Func *f, MTdata d, bool relaxedMode)
                                &build_info)))
         return error;
 
-    for (uint64_t i = 0; i < (1ULL << 32); i += step)
+    uint64_t begin, end;
+    GetShardRange(1ULL << 32, step, &begin, &end);
+    for (uint64_t i = begin; i < end; i += step)
     {
         // Init input array
         uint32_t *p = (uint32_t *)gIn;
         if (gWimpyMode)
         {
-            for (size_t j = 0; j < BUFFER_SIZE / sizeof(float); j++)
+            size_t n = gBufferSize / sizeof(float);
+            uint64_t count = WimpySampleCount(step, n);
+            for (size_t j = 0; j < n; j++)
             {
-                p[j] = (uint32_t)i + j * scale;
+                p[j] = SampleFloatInput((uint32_t)i + j * scale,
+                                        i / step * n + j, count);
                 if (relaxedMode && strcmp(f->name, "sincos") == 0)
                 {
                     float pj = *(float *)&p[j];
@@ -84,7 +91,7 @@ int TestFunc_Float2_Float(const Func *f, MTdata d, bool relaxedMode)
         }
         else
         {
-            for (size_t j = 0; j < BUFFER_SIZE / sizeof(float); j++)
+            for (size_t j = 0; j < gBufferSize / sizeof(float); j++)
             {
                 p[j] = (uint32_t)i + j;
                 if (relaxedMode && strcmp(f->name, "sincos") == 0)
@@ -95,8 +102,8 @@ int TestFunc_Float2_Float(const Func *f, MTdata d, bool relaxedMode)
             }
         }
 
-        if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer, CL_FALSE, 0,
-                                          BUFFER_SIZE, gIn, 0, NULL, NULL)))
+        if ((error = enqueue_write_staged(gQueue, gInBuffer, CL_FALSE, 0,
+                                          gBufferSize, gIn, 0, NULL, NULL)))
         {
             vlog_error("\n*** Error %d in clEnqueueWriteBuffer ***\n", error);
             return error;
@@ -108,9 +115,9 @@ int TestFunc_Float2_Float(const Func *f, MTdata d, bool relaxedMode)
             uint32_t pattern = 0xffffdead;
             if (gHostFill)
             {
-                memset_pattern4(gOut[j], &pattern, BUFFER_SIZE);
-                if ((error = clEnqueueWriteBuffer(gQueue, gOutBuffer[j],
-                                                  CL_FALSE, 0, BUFFER_SIZE,
+                memset_pattern4(gOut[j], &pattern, gBufferSize);
+                if ((error = enqueue_write_staged(gQueue, gOutBuffer[j],
+                                                  CL_FALSE, 0, gBufferSize,
                                                   gOut[j], 0, NULL, NULL)))
                 {
                     vlog_error(
@@ -119,9 +126,9 @@ int TestFunc_Float2_Float(const Func *f, MTdata d, bool relaxedMode)
                     return error;
                 }
 
-                memset_pattern4(gOut2[j], &pattern, BUFFER_SIZE);
-                if ((error = clEnqueueWriteBuffer(gQueue, gOutBuffer2[j],
-                                                  CL_FALSE, 0, BUFFER_SIZE,
+                memset_pattern4(gOut2[j], &pattern, gBufferSize);
+                if ((error = enqueue_write_staged(gQueue, gOutBuffer2[j],
+                                                  CL_FALSE, 0, gBufferSize,
                                                   gOut2[j], 0, NULL, NULL)))
                 {
                     vlog_error(
@@ -134,7 +141,7 @@ int TestFunc_Float2_Float(const Func *f, MTdata d, bool relaxedMode)
             {
                 if ((error = clEnqueueFillBuffer(gQueue, gOutBuffer[j],
                                                  &pattern, sizeof(pattern), 0,
-                                                 BUFFER_SIZE, 0, NULL, NULL)))
+                                                 gBufferSize, 0, NULL, NULL)))
                 {
                     vlog_error("Error: clEnqueueFillBuffer 1 failed! err: %d\n",
                                error);
@@ -143,7 +150,7 @@ int TestFunc_Float2_Float(const Func *f, MTdata d, bool relaxedMode)
 
                 if ((error = clEnqueueFillBuffer(gQueue, gOutBuffer[j],
                                                  &pattern, sizeof(pattern), 0,
-                                                 BUFFER_SIZE, 0, NULL, NULL)))
+                                                 gBufferSize, 0, NULL, NULL)))
                 {
                     vlog_error("Error: clEnqueueFillBuffer 2 failed! err: %d\n",
                                error);
@@ -156,7 +163,7 @@ int TestFunc_Float2_Float(const Func *f, MTdata d, bool relaxedMode)
         for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
         {
             size_t vectorSize = sizeValues[j] * sizeof(cl_float);
-            size_t localCount = (BUFFER_SIZE + vectorSize - 1) / vectorSize;
+            size_t localCount = (gBufferSize + vectorSize - 1) / vectorSize;
             if ((error = clSetKernelArg(kernels[j][thread_id], 0,
                                         sizeof(gOutBuffer[j]), &gOutBuffer[j])))
             {
@@ -189,69 +196,65 @@ int TestFunc_Float2_Float(const Func *f, MTdata d, bool relaxedMode)
         // Get that moving
         if ((error = clFlush(gQueue))) vlog("clFlush failed\n");
 
-        FPU_mode_type oldMode = 0;
+        // Set the rounding mode to match the device
         RoundingMode oldRoundMode = kRoundToNearestEven;
-        if (isFract)
-        {
-            // Calculate the correctly rounded reference result
-            if (ftz || relaxedMode) ForceFTZ(&oldMode);
-
-            // Set the rounding mode to match the device
-            if (gIsInRTZMode)
-                oldRoundMode = set_round(kRoundTowardZero, kfloat);
-        }
+        if (isFract && gIsInRTZMode)
+            oldRoundMode = set_round(kRoundTowardZero, kfloat);
 
-        // Calculate the correctly rounded reference result
+        // Calculate the correctly rounded reference result, for fract in FTZ
+        // mode if the device flushes
         float *r = (float *)gOut_Ref;
         float *r2 = (float *)gOut_Ref2;
         float *s = (float *)gIn;
 
-        if (skipNanInf)
         {
-            for (size_t j = 0; j < BUFFER_SIZE / sizeof(float); j++)
+            FPStateGuard ftzGuard(isFract && (ftz || relaxedMode) ? kForceFTZ
+                                                                  : kKeepFTZ);
+            if (skipNanInf)
             {
-                double dd;
-                feclearexcept(FE_OVERFLOW);
+                for (size_t j = 0; j < gBufferSize / sizeof(float); j++)
+                {
+                    double dd;
+                    feclearexcept(FE_OVERFLOW);
 
-                if (relaxedMode)
-                    r[j] = (float)f->rfunc.f_fpf(s[j], &dd);
-                else
-                    r[j] = (float)f->func.f_fpf(s[j], &dd);
+                    if (relaxedMode)
+                        r[j] = (float)f->rfunc.f_fpf(s[j], &dd);
+                    else
+                        r[j] = (float)f->func.f_fpf(s[j], &dd);
 
-                r2[j] = (float)dd;
-                overflow[j] =
-                    FE_OVERFLOW == (FE_OVERFLOW & fetestexcept(FE_OVERFLOW));
+                    r2[j] = (float)dd;
+                    overflow[j] = FE_OVERFLOW
+                        == (FE_OVERFLOW & fetestexcept(FE_OVERFLOW));
+                }
             }
-        }
-        else
-        {
-            for (size_t j = 0; j < BUFFER_SIZE / sizeof(float); j++)
+            else
             {
-                double dd;
-                if (relaxedMode)
-                    r[j] = (float)f->rfunc.f_fpf(s[j], &dd);
-                else
-                    r[j] = (float)f->func.f_fpf(s[j], &dd);
+                for (size_t j = 0; j < gBufferSize / sizeof(float); j++)
+                {
+                    double dd;
+                    if (relaxedMode)
+                        r[j] = (float)f->rfunc.f_fpf(s[j], &dd);
+                    else
+                        r[j] = (float)f->func.f_fpf(s[j], &dd);
 
-                r2[j] = (float)dd;
+                    r2[j] = (float)dd;
+                }
             }
         }
 
-        if (isFract && ftz) RestoreFPState(&oldMode);
-
         // Read the data back
         for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
         {
             if ((error =
-                     clEnqueueReadBuffer(gQueue, gOutBuffer[j], CL_TRUE, 0,
-                                         BUFFER_SIZE, gOut[j], 0, NULL, NULL)))
+                     enqueue_read_staged(gQueue, gOutBuffer[j], CL_TRUE, 0,
+                                         gBufferSize, gOut[j], 0, NULL, NULL)))
             {
                 vlog_error("ReadArray failed %d\n", error);
                 return error;
             }
             if ((error =
-                     clEnqueueReadBuffer(gQueue, gOutBuffer2[j], CL_TRUE, 0,
-                                         BUFFER_SIZE, gOut2[j], 0, NULL, NULL)))
+                     enqueue_read_staged(gQueue, gOutBuffer2[j], CL_TRUE, 0,
+                                         gBufferSize, gOut2[j], 0, NULL, NULL)))
             {
                 vlog_error("ReadArray2 failed %d\n", error);
                 return error;
@@ -267,7 +270,7 @@ int TestFunc_Float2_Float(const Func *f, MTdata d, bool relaxedMode)
         // Verify data
         uint32_t *t = (uint32_t *)gOut_Ref;
         uint32_t *t2 = (uint32_t *)gOut_Ref2;
-        for (size_t j = 0; j < BUFFER_SIZE / sizeof(float); j++)
+        for (size_t j = 0; j < gBufferSize / sizeof(float); j++)
         {
             for (auto k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++)
             {
@@ -482,8 +485,8 @@ int TestFunc_Float2_Float(const Func *f, MTdata d, bool relaxedMode)
             if (gVerboseBruteForce)
             {
                 vlog("base:%14" PRIu64 " step:%10" PRIu64
-                     "  bufferSize:%10d \n",
-                     i, step, BUFFER_SIZE);
+                     "  bufferSize:%10zu \n",
+                     i, step, gBufferSize);
             }
             else
             {
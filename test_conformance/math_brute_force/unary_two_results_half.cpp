@@ -16,6 +16,7 @@
 
 #include "common.h"
 #include "function_list.h"
+#include "shard.h"
 #include "test_functions.h"
 #include "utility.h"
 
@@ -49,9 +50,9 @@ int TestFunc_Half2_Half(const Func *f, MTdata d, bool relaxedMode)
     int ftz = f->ftz || gForceFTZ || 0 == (CL_FP_DENORM & gHalfCapabilities);
     float maxErrorVal0 = 0.0f;
     float maxErrorVal1 = 0.0f;
-    uint64_t step = getTestStep(sizeof(cl_half), BUFFER_SIZE);
+    uint64_t step = getTestStep(sizeof(cl_half), gBufferSize);
 
-    size_t bufferElements = std::min(BUFFER_SIZE / sizeof(cl_half),
+    size_t bufferElements = std::min(gBufferSize / sizeof(cl_half),
                                      size_t(1ULL << (sizeof(cl_half) * 8)));
     size_t bufferSize = bufferElements * sizeof(cl_half);
 
@@ -70,13 +71,15 @@ int TestFunc_Half2_Half(const Func *f, MTdata d, bool relaxedMode)
                                &build_info)))
         return error;
 
-    for (uint64_t i = 0; i < (1ULL << 16); i += step)
+    uint64_t begin, end;
+    GetShardRange(1ULL << 16, step, &begin, &end);
+    for (uint64_t i = begin; i < end; i += step)
     {
         // Init input array
         cl_half *pIn = (cl_half *)gIn;
         for (size_t j = 0; j < bufferElements; j++) pIn[j] = (cl_ushort)i + j;
 
-        if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer, CL_FALSE, 0,
+        if ((error = enqueue_write_staged(gQueue, gInBuffer, CL_FALSE, 0,
                                           bufferSize, gIn, 0, NULL, NULL)))
         {
             vlog_error("\n*** Error %d in clEnqueueWriteBuffer ***\n", error);
@@ -90,7 +93,7 @@ int TestFunc_Half2_Half(const Func *f, MTdata d, bool relaxedMode)
             if (gHostFill)
             {
                 memset_pattern4(gOut[j], &pattern, bufferSize);
-                if ((error = clEnqueueWriteBuffer(gQueue, gOutBuffer[j],
+                if ((error = enqueue_write_staged(gQueue, gOutBuffer[j],
                                                   CL_FALSE, 0, bufferSize,
                                                   gOut[j], 0, NULL, NULL)))
                 {
@@ -101,7 +104,7 @@ int TestFunc_Half2_Half(const Func *f, MTdata d, bool relaxedMode)
                 }
 
                 memset_pattern4(gOut2[j], &pattern, bufferSize);
-                if ((error = clEnqueueWriteBuffer(gQueue, gOutBuffer2[j],
+                if ((error = enqueue_write_staged(gQueue, gOutBuffer2[j],
                                                   CL_FALSE, 0, bufferSize,
                                                   gOut2[j], 0, NULL, NULL)))
                 {
@@ -166,64 +169,58 @@ int TestFunc_Half2_Half(const Func *f, MTdata d, bool relaxedMode)
             return error;
         }
 
-        FPU_mode_type oldMode;
+        // Set the rounding mode to match the device
         RoundingMode oldRoundMode = kRoundToNearestEven;
-        if (isFract)
-        {
-            // Calculate the correctly rounded reference result
-            memset(&oldMode, 0, sizeof(oldMode));
-            if (ftz) ForceFTZ(&oldMode);
-
-            // Set the rounding mode to match the device
-            if (gIsInRTZMode)
-                oldRoundMode = set_round(kRoundTowardZero, kfloat);
-        }
+        if (isFract && gIsInRTZMode)
+            oldRoundMode = set_round(kRoundTowardZero, kfloat);
 
-        // Calculate the correctly rounded reference result
+        // Calculate the correctly rounded reference result, for fract in FTZ
+        // mode if the device flushes
         cl_half *ref1 = (cl_half *)gOut_Ref;
         cl_half *ref2 = (cl_half *)gOut_Ref2;
 
-        if (skipNanInf)
         {
-            for (size_t j = 0; j < bufferElements; j++)
+            FPStateGuard ftzGuard(isFract && ftz ? kForceFTZ : kKeepFTZ);
+            if (skipNanInf)
             {
-                double dd;
-                feclearexcept(FE_OVERFLOW);
+                for (size_t j = 0; j < bufferElements; j++)
+                {
+                    double dd;
+                    feclearexcept(FE_OVERFLOW);
 
-                ref1[j] = HFF((float)f->func.f_fpf(HTF(pIn[j]), &dd));
-                ref2[j] = HFF((float)dd);
+                    ref1[j] = HFF((float)f->func.f_fpf(HTF(pIn[j]), &dd));
+                    ref2[j] = HFF((float)dd);
 
-                // ensure correct rounding of fract result is not reaching 1
-                if (isFract && HTF(ref1[j]) >= 1.f) ref1[j] = 0x3bff;
+                    // ensure the rounded fract result does not reach 1
+                    if (isFract && HTF(ref1[j]) >= 1.f) ref1[j] = 0x3bff;
 
-                overflow[j] =
-                    FE_OVERFLOW == (FE_OVERFLOW & fetestexcept(FE_OVERFLOW));
+                    overflow[j] = FE_OVERFLOW
+                        == (FE_OVERFLOW & fetestexcept(FE_OVERFLOW));
+                }
             }
-        }
-        else
-        {
-            for (size_t j = 0; j < bufferElements; j++)
+            else
             {
-                double dd;
-                ref1[j] = HFF((float)f->func.f_fpf(HTF(pIn[j]), &dd));
-                ref2[j] = HFF((float)dd);
+                for (size_t j = 0; j < bufferElements; j++)
+                {
+                    double dd;
+                    ref1[j] = HFF((float)f->func.f_fpf(HTF(pIn[j]), &dd));
+                    ref2[j] = HFF((float)dd);
+                }
             }
         }
 
-        if (isFract && ftz) RestoreFPState(&oldMode);
-
         // Read the data back
         for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
         {
             if ((error =
-                     clEnqueueReadBuffer(gQueue, gOutBuffer[j], CL_TRUE, 0,
+                     enqueue_read_staged(gQueue, gOutBuffer[j], CL_TRUE, 0,
                                          bufferSize, gOut[j], 0, NULL, NULL)))
             {
                 vlog_error("ReadArray failed %d\n", error);
                 return error;
             }
             if ((error =
-                     clEnqueueReadBuffer(gQueue, gOutBuffer2[j], CL_TRUE, 0,
+                     enqueue_read_staged(gQueue, gOutBuffer2[j], CL_TRUE, 0,
                                          bufferSize, gOut2[j], 0, NULL, NULL)))
             {
                 vlog_error("ReadArray2 failed %d\n", error);
@@ -16,6 +16,7 @@
 
 #include "common.h"
 #include "function_list.h"
+#include "shard.h"
 #include "test_functions.h"
 #include "utility.h"
 
@@ -56,12 +57,12 @@ int TestFunc_HalfI_Half(const Func *f, MTdata d, bool relaxedMode)
     int ftz = f->ftz || gForceFTZ || 0 == (CL_FP_DENORM & gHalfCapabilities);
     float maxErrorVal = 0.0f;
     float maxErrorVal2 = 0.0f;
-    uint64_t step = getTestStep(sizeof(cl_half), BUFFER_SIZE);
+    uint64_t step = getTestStep(sizeof(cl_half), gBufferSize);
 
     // sizeof(cl_half) < sizeof (int32_t)
     // to prevent overflowing gOut_Ref2 it is necessary to use
     // bigger type as denominator for buffer size calculation
-    size_t bufferElements = std::min(BUFFER_SIZE / sizeof(cl_int),
+    size_t bufferElements = std::min(gBufferSize / sizeof(cl_int),
                                      size_t(1ULL << (sizeof(cl_half) * 8)));
 
     size_t bufferSizeLo = bufferElements * sizeof(cl_half);
@@ -82,13 +83,15 @@ int TestFunc_HalfI_Half(const Func *f, MTdata d, bool relaxedMode)
                                &build_info)))
         return error;
 
-    for (uint64_t i = 0; i < (1ULL << 16); i += step)
+    uint64_t begin, end;
+    GetShardRange(1ULL << 16, step, &begin, &end);
+    for (uint64_t i = begin; i < end; i += step)
     {
         // Init input array
         cl_half *pIn = (cl_half *)gIn;
         for (size_t j = 0; j < bufferElements; j++) pIn[j] = (cl_ushort)i + j;
 
-        if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer, CL_FALSE, 0,
+        if ((error = enqueue_write_staged(gQueue, gInBuffer, CL_FALSE, 0,
                                           bufferSizeLo, gIn, 0, NULL, NULL)))
         {
             vlog_error("\n*** Error %d in clEnqueueWriteBuffer ***\n", error);
@@ -102,7 +105,7 @@ int TestFunc_HalfI_Half(const Func *f, MTdata d, bool relaxedMode)
             if (gHostFill)
             {
                 memset_pattern4(gOut[j], &pattern, bufferSizeLo);
-                if ((error = clEnqueueWriteBuffer(gQueue, gOutBuffer[j],
+                if ((error = enqueue_write_staged(gQueue, gOutBuffer[j],
                                                   CL_FALSE, 0, bufferSizeLo,
                                                   gOut[j], 0, NULL, NULL)))
                 {
@@ -113,7 +116,7 @@ int TestFunc_HalfI_Half(const Func *f, MTdata d, bool relaxedMode)
                 }
 
                 memset_pattern4(gOut2[j], &pattern, bufferSizeHi);
-                if ((error = clEnqueueWriteBuffer(gQueue, gOutBuffer2[j],
+                if ((error = enqueue_write_staged(gQueue, gOutBuffer2[j],
                                                   CL_FALSE, 0, bufferSizeHi,
                                                   gOut2[j], 0, NULL, NULL)))
                 {
@@ -191,13 +194,13 @@ int TestFunc_HalfI_Half(const Func *f, MTdata d, bool relaxedMode)
             cl_bool blocking =
                 (j + 1 < gMaxVectorSizeIndex) ? CL_FALSE : CL_TRUE;
             if ((error =
-                     clEnqueueReadBuffer(gQueue, gOutBuffer[j], blocking, 0,
+                     enqueue_read_staged(gQueue, gOutBuffer[j], blocking, 0,
                                          bufferSizeLo, gOut[j], 0, NULL, NULL)))
             {
                 vlog_error("ReadArray failed %d\n", error);
                 return error;
             }
-            if ((error = clEnqueueReadBuffer(gQueue, gOutBuffer2[j], blocking,
+            if ((error = enqueue_read_staged(gQueue, gOutBuffer2[j], blocking,
                                              0, bufferSizeHi, gOut2[j], 0, NULL,
                                              NULL)))
             {
@@ -16,6 +16,7 @@
 
 #include "common.h"
 #include "function_list.h"
+#include "shard.h"
 #include "test_functions.h"
 #include "utility.h"
 #include "reference_math.h"
@@ -48,8 +49,8 @@ int TestFunc_Half_UShort(const Func *f, MTdata d, bool relaxedMode)
     float maxError = 0.0f;
     int ftz = f->ftz || gForceFTZ || 0 == (CL_FP_DENORM & gHalfCapabilities);
     float maxErrorVal = 0.0f;
-    uint64_t step = getTestStep(sizeof(cl_half), BUFFER_SIZE);
-    size_t bufferElements = std::min(BUFFER_SIZE / sizeof(cl_half),
+    uint64_t step = getTestStep(sizeof(cl_half), gBufferSize);
+    size_t bufferElements = std::min(gBufferSize / sizeof(cl_half),
                                      size_t(1ULL << (sizeof(cl_half) * 8)));
     size_t bufferSize = bufferElements * sizeof(cl_half);
     logFunctionInfo(f->name, sizeof(cl_half), relaxedMode);
@@ -65,13 +66,15 @@ int TestFunc_Half_UShort(const Func *f, MTdata d, bool relaxedMode)
         return error;
     }
 
-    for (uint64_t i = 0; i < (1ULL << 32); i += step)
+    uint64_t begin, end;
+    GetShardRange(1ULL << 32, step, &begin, &end);
+    for (uint64_t i = begin; i < end; i += step)
     {
         // Init input array
         cl_ushort *p = (cl_ushort *)gIn;
         for (size_t j = 0; j < bufferElements; j++) p[j] = (uint16_t)i + j;
 
-        if ((error = clEnqueueWriteBuffer(gQueue, gInBuffer, CL_FALSE, 0,
+        if ((error = enqueue_write_staged(gQueue, gInBuffer, CL_FALSE, 0,
                                           bufferSize, gIn, 0, NULL, NULL)))
         {
             vlog_error("\n*** Error %d in clEnqueueWriteBuffer ***\n", error);
@@ -85,7 +88,7 @@ int TestFunc_Half_UShort(const Func *f, MTdata d, bool relaxedMode)
             if (gHostFill)
             {
                 memset_pattern4(gOut[j], &pattern, bufferSize);
-                if ((error = clEnqueueWriteBuffer(gQueue, gOutBuffer[j],
+                if ((error = enqueue_write_staged(gQueue, gOutBuffer[j],
                                                   CL_FALSE, 0, bufferSize,
                                                   gOut[j], 0, NULL, NULL)))
                 {
@@ -147,7 +150,7 @@ int TestFunc_Half_UShort(const Func *f, MTdata d, bool relaxedMode)
         for (auto j = gMinVectorSizeIndex; j < gMaxVectorSizeIndex; j++)
         {
             if ((error =
-                     clEnqueueReadBuffer(gQueue, gOutBuffer[j], CL_TRUE, 0,
+                     enqueue_read_staged(gQueue, gOutBuffer[j], CL_TRUE, 0,
                                          bufferSize, gOut[j], 0, NULL, NULL)))
             {
                 vlog_error("ReadArray failed %d\n", error);
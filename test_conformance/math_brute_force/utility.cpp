@@ -143,6 +143,33 @@ inline int compareDoubles(double x, double y)
     return a.l < b.l ? -1 : 1;
 }
 
+void fill_random_input(cl_uint *p, size_t fixed, size_t count, cl_ulong index)
+{
+    if (fixed >= count) return;
+    MTdataHolder stream(init_genrand_counter(gRandomSeed, index + fixed));
+    genrand_fill(stream, p + fixed, count - fixed);
+}
+
+cl_int write_random_input(cl_command_queue queue, cl_mem buffer,
+                          const cl_uint *p, size_t fixed, size_t count,
+                          cl_ulong index)
+{
+    if (!device_random_enabled())
+        return enqueue_write_staged(queue, buffer, CL_FALSE, 0,
+                                    count * sizeof(cl_uint), p, 0, NULL, NULL);
+
+    fixed = std::min(fixed, count);
+    cl_int error = CL_SUCCESS;
+    if (fixed)
+        error = enqueue_write_staged(queue, buffer, CL_FALSE, 0,
+                                     fixed * sizeof(cl_uint), p, 0, NULL, NULL);
+    if (error == CL_SUCCESS && fixed < count)
+        error = enqueue_write_random_words(
+            queue, buffer, CL_FALSE, fixed * sizeof(cl_uint), count - fixed,
+            gRandomSeed, index + fixed, p + fixed, 0, NULL, NULL);
+    return error;
+}
+
 void logFunctionInfo(const char *fname, unsigned int float_size,
                      unsigned int isFastRelaxed)
 {
@@ -22,9 +22,17 @@
 #include "harness/testHarness.h"
 #include "harness/ThreadPool.h"
 #include "harness/conversions.h"
+#include "harness/eventHelpers.h"
+#include "harness/stagingPool.h"
+#include "harness/deviceRandom.h"
+#include "harness/mt19937.h"
 #include "CL/cl_half.h"
 
-#define BUFFER_SIZE (1024 * 1024 * 2)
+#include <algorithm>
+#include <cstring>
+
+// Default size in bytes of each input and output buffer
+#define DEFAULT_BUFFER_SIZE (1024 * 1024 * 2)
 #define EMBEDDED_REDUCTION_FACTOR (64)
 
 #if defined(__GNUC__)
@@ -36,6 +44,9 @@
 struct Func;
 
 extern int gWimpyReductionFactor;
+// Size in bytes of each input and output buffer, a power of two picked for the
+// device at startup
+extern size_t gBufferSize;
 
 #define VECTOR_SIZE_COUNT 6
 extern const char *sizeNames[VECTOR_SIZE_COUNT];
@@ -61,6 +72,10 @@ extern int gForceFTZ;
 extern int gFastRelaxedDerived;
 extern int gWimpyMode;
 extern int gHostFill;
+// Number of stages each job's buffers are split into by the pipelined tests.
+// The stages are queued back to back so that the device works on the next
+// stage while the host verifies the current one.
+extern cl_uint gPipelineStages;
 extern int gIsInRTZMode;
 extern int gHasHalf;
 extern int gInfNanSupport;
@@ -234,6 +249,21 @@ inline void Force64BitFPUPrecision(void)
 
 void memset_pattern4(void *dest, const void *src_pattern, size_t bytes);
 
+// Random input from the counter-based stream of gRandomSeed, word i of p
+// being word index + i of the stream, which the device can generate for
+// itself (see harness/deviceRandom.h). The first fixed words of p are left to
+// the caller.
+void fill_random_input(cl_uint *p, size_t fixed, size_t count,
+                       cl_ulong index);
+
+// Write the count words of p to buffer without blocking. With
+// device_random_enabled(), the words after the first fixed, which must come
+// from fill_random_input with the same index, are generated on the device
+// instead.
+cl_int write_random_input(cl_command_queue queue, cl_mem buffer,
+                          const cl_uint *p, size_t fixed, size_t count,
+                          cl_ulong index);
+
 union int32f_t {
     int32_t i;
     float f;
@@ -283,7 +313,7 @@ inline uint64_t getTestStep(size_t typeSize, size_t bufferSize)
     }
     else if (gIsEmbedded)
     {
-        return (BUFFER_SIZE / typeSize) * EMBEDDED_REDUCTION_FACTOR;
+        return (gBufferSize / typeSize) * EMBEDDED_REDUCTION_FACTOR;
     }
     else
     {
@@ -291,4 +321,49 @@ inline uint64_t getTestStep(size_t typeSize, size_t bufferSize)
     }
 }
 
+// Return the first index in [start, count) at which the result for any tested
+// vector size differs bitwise from the reference t, or count if none does.
+// Matching blocks are skipped with memcmp, which the C library vectorizes, so
+// the scalar checks in the callers only run near mismatches.
+template <typename T, typename Out>
+inline size_t FindFirstMismatch(const T *t, const Out &out, size_t start,
+                                size_t count)
+{
+    const size_t blockSize = 64;
+    while (start < count)
+    {
+        size_t n = std::min(blockSize, count - start);
+        bool match = true;
+        for (auto k = gMinVectorSizeIndex; match && k < gMaxVectorSizeIndex;
+             k++)
+            match = 0 == memcmp(t + start, (const T *)out[k] + start,
+                                n * sizeof(T));
+        if (!match) break;
+        start += n;
+    }
+
+    for (; start < count; start++)
+        for (auto k = gMinVectorSizeIndex; k < gMaxVectorSizeIndex; k++)
+            if (t[start] != ((const T *)out[k])[start]) return start;
+    return count;
+}
+
+// Return the first index in [start, count) at which the float bits test differ
+// from ref, where two NaNs always match. Implemented with the batched
+// references in reference_math_simd.cpp.
+size_t FirstFloatMismatch(const uint32_t *ref, const uint32_t *test,
+                          size_t start, size_t count);
+
+// FindFirstMismatch for float results, which does not stop at NaNs whose sign
+// or payload differs from the reference, as the ulp checks accept those.
+template <typename Out>
+inline size_t FindFirstFloatMismatch(const uint32_t *t, const Out &out,
+                                     size_t start, size_t count)
+{
+    for (auto k = gMinVectorSizeIndex; start < count && k < gMaxVectorSizeIndex;
+         k++)
+        count = FirstFloatMismatch(t, (const uint32_t *)out[k], start, count);
+    return count;
+}
+
 #endif /* UTILITY_H */
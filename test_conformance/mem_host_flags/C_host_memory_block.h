@@ -48,6 +48,12 @@ public:
 
     bool Equal_rect_from_orig(T *another_pdata, size_t *soffset, size_t *region,
                               size_t host_row_pitch, size_t host_slice_pitch);
+
+private:
+    // The blocks hold integer elements, whose == is a bitwise compare, so
+    // rows are compared with memcmp, which stops at the first difference
+    bool Equal_rows(const T *another_pdata, size_t orig, size_t another_orig,
+                    size_t *region, size_t row_pitch, size_t slice_pitch);
 };
 
 template <class T> C_host_memory_block<T>::C_host_memory_block()
@@ -106,14 +112,7 @@ template <class T> bool C_host_memory_block<T>::Equal_to(T &val)
 template <class T>
 bool C_host_memory_block<T>::Equal(C_host_memory_block<T> &another)
 {
-    size_t count = 0;
-
-    for (size_t i = 0; i < num_elements; i++)
-    {
-        if (pData[i] == another.pData[i]) count++;
-    }
-
-    return (count == num_elements);
+    return memcmp(pData, another.pData, num_elements * sizeof(T)) == 0;
 }
 
 template <class T>
@@ -121,14 +120,7 @@ bool C_host_memory_block<T>::Equal(T *pIn_Data, size_t Innum_elements)
 {
     if (this->num_elements != Innum_elements) return false;
 
-    size_t count = 0;
-
-    for (size_t i = 0; i < num_elements; i++)
-    {
-        if (pData[i] == pIn_Data[i]) count++;
-    }
-
-    return (count == num_elements);
+    return memcmp(pData, pIn_Data, num_elements * sizeof(T)) == 0;
 }
 
 template <class T> size_t C_host_memory_block<T>::Count(T &val)
@@ -151,22 +143,10 @@ bool C_host_memory_block<T>::Equal_rect(C_host_memory_block<T> &another,
     size_t row_pitch = host_row_pitch ? host_row_pitch : region[0];
     size_t slice_pitch = host_slice_pitch ? host_row_pitch : region[1];
 
-    size_t count = 0;
-
-    size_t total = region[0] * region[1] * region[2];
-
-    size_t x, y, z;
     size_t orig = (size_t)(soffset[0] + row_pitch * soffset[1]
                            + slice_pitch * soffset[2]);
-    for (z = 0; z < region[2]; z++)
-        for (y = 0; y < region[1]; y++)
-            for (x = 0; x < region[0]; x++)
-            {
-                int p1 = (int)(x + row_pitch * y + slice_pitch * z + orig);
-                if (pData[p1] == another.pData[p1]) count++;
-            }
-
-    return (count == total);
+    return Equal_rows(another.pData, orig, orig, region, row_pitch,
+                      slice_pitch);
 }
 
 template <class T>
@@ -177,23 +157,9 @@ bool C_host_memory_block<T>::Equal_rect_from_orig(
     size_t row_pitch = host_row_pitch ? host_row_pitch : region[0];
     size_t slice_pitch = host_slice_pitch ? host_row_pitch : region[1];
 
-    size_t count = 0;
-
-    size_t total = region[0] * region[1] * region[2];
-
-    size_t x, y, z;
     size_t orig =
         soffset[0] + row_pitch * soffset[1] + slice_pitch * soffset[2];
-    for (z = 0; z < region[2]; z++)
-        for (y = 0; y < region[1]; y++)
-            for (x = 0; x < region[0]; x++)
-            {
-                size_t p1 = x + (row_pitch * y) + (slice_pitch * z);
-                size_t p2 = p1 + orig;
-                if (pData[p2] == another.pData[p1]) count++;
-            }
-
-    return (count == total);
+    return Equal_rows(another.pData, orig, 0, region, row_pitch, slice_pitch);
 }
 
 template <class T>
@@ -206,23 +172,27 @@ bool C_host_memory_block<T>::Equal_rect_from_orig(T *another_pdata,
     size_t row_pitch = host_row_pitch ? host_row_pitch : region[0];
     size_t slice_pitch = host_slice_pitch ? host_row_pitch : region[1];
 
-    size_t count = 0;
-
-    size_t total = region[0] * region[1] * region[2];
-
-    size_t x, y, z;
     size_t orig =
         soffset[0] + row_pitch * soffset[1] + slice_pitch * soffset[2];
-    for (z = 0; z < region[2]; z++)
-        for (y = 0; y < region[1]; y++)
-            for (x = 0; x < region[0]; x++)
-            {
-                size_t p1 = x + (row_pitch * y) + (slice_pitch * z);
-                size_t p2 = p1 + orig;
-                if (pData[p2] == another_pdata[p1]) count++;
-            }
-
-    return (count == total);
+    return Equal_rows(another_pdata, orig, 0, region, row_pitch, slice_pitch);
+}
+
+template <class T>
+bool C_host_memory_block<T>::Equal_rows(const T *another_pdata, size_t orig,
+                                        size_t another_orig, size_t *region,
+                                        size_t row_pitch, size_t slice_pitch)
+{
+    for (size_t z = 0; z < region[2]; z++)
+        for (size_t y = 0; y < region[1]; y++)
+        {
+            size_t row = row_pitch * y + slice_pitch * z;
+            if (memcmp(pData + orig + row, another_pdata + another_orig + row,
+                       region[0] * sizeof(T))
+                != 0)
+                return false;
+        }
+
+    return true;
 }
 
 #endif
@@ -0,0 +1,50 @@
+# Partially link the objects INPUTS of a suite into OUTPUT for test_all,
+# renaming main() to ENTRY and making every other symbol the suite defines
+# local, so that suites defining the same names can be linked together.
+#
+# COMDAT groups are resolved first, as a group can't be left with local
+# symbols for the final link to discard. The function-local statics of
+# inline functions, GNU unique symbols, stay global but become weak, so
+# that the suite keeps sharing them with the harness.
+
+execute_process(
+    COMMAND ${LINKER} -r --force-group-allocation -o ${OUTPUT}.partial
+        ${INPUTS}
+    RESULT_VARIABLE result)
+if(result)
+    message(FATAL_ERROR "Partial link of ${OUTPUT} failed")
+endif()
+
+execute_process(
+    COMMAND ${NM} --defined-only ${OUTPUT}.partial
+    OUTPUT_VARIABLE symbols
+    RESULT_VARIABLE result)
+if(result)
+    message(FATAL_ERROR "Listing the symbols of ${OUTPUT} failed")
+endif()
+
+set(has_main FALSE)
+set(unique "")
+string(REGEX MATCHALL "[^\n]+" lines "${symbols}")
+foreach(line IN LISTS lines)
+    if(line MATCHES "^[0-9a-fA-F]* T main$")
+        set(has_main TRUE)
+    elseif(line MATCHES "^[0-9a-fA-F]* u (.+)$")
+        string(APPEND unique "${CMAKE_MATCH_1}\n")
+    endif()
+endforeach()
+if(NOT has_main)
+    message(FATAL_ERROR "${OUTPUT} has no main()")
+endif()
+
+file(WRITE ${OUTPUT}.unique "${unique}")
+file(WRITE ${OUTPUT}.keep "${ENTRY}\n${unique}")
+execute_process(
+    COMMAND ${OBJCOPY} --redefine-sym main=${ENTRY}
+        --keep-global-symbols=${OUTPUT}.keep
+        --weaken-symbols=${OUTPUT}.unique
+        ${OUTPUT}.partial ${OUTPUT}
+    RESULT_VARIABLE result)
+if(result)
+    message(FATAL_ERROR "Localizing the symbols of ${OUTPUT} failed")
+endif()
@@ -0,0 +1,185 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "harness/contextPool.h"
+#include "harness/testHarness.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+// Runs suites linked in with CL_CTS_BUILD_TEST_ALL one after the other in
+// this process, so that the ICD loader, the platform and the context pool
+// are set up once for all of them.
+//
+// An argument naming a suite runs it, and one of the form suite/argument
+// also passes the argument to it: basic/hostptr runs that test of basic,
+// and bruteforce/-w passes -w to math_brute_force. The other arguments are
+// common options passed to every suite. Output files named in the
+// environment get the name of each suite before their extension, so that
+// the suites don't overwrite each other's.
+
+#define TEST_ALL_SUITE(name, binary)                                           \
+    extern "C" int cts_suite_main_##name(int argc, const char *argv[]);
+#include "suites.inc"
+#undef TEST_ALL_SUITE
+
+namespace {
+
+struct Suite
+{
+    const char *name;
+    const char *binary;
+    int (*main)(int argc, const char *argv[]);
+};
+
+#define TEST_ALL_SUITE(name, binary) { #name, binary, cts_suite_main_##name },
+const Suite kSuites[] = {
+#include "suites.inc"
+    { nullptr, nullptr, nullptr },
+};
+#undef TEST_ALL_SUITE
+
+const char *kPerSuiteFiles[] = {
+    "CL_CONFORMANCE_RESULTS_FILENAME",
+    "CL_CONFORMANCE_METRICS_FILENAME",
+    "CL_CONFORMANCE_PERF_BASELINE",
+    "CL_CONFORMANCE_TRACE_FILENAME",
+};
+
+struct SuiteRun
+{
+    const Suite *suite;
+    std::vector<std::string> args;
+};
+
+const Suite *find_suite(const std::string &name)
+{
+    for (const Suite *suite = kSuites; suite->name; suite++)
+        if (name == suite->name) return suite;
+    return nullptr;
+}
+
+// fileName with _suite inserted before its extension
+std::string suite_file_name(const std::string &fileName, const char *suite)
+{
+    size_t slash = fileName.find_last_of("/\\");
+    size_t dot = fileName.find_last_of('.');
+    if (dot == std::string::npos
+        || (slash != std::string::npos && dot < slash))
+        dot = fileName.size();
+    return fileName.substr(0, dot) + "_" + suite + fileName.substr(dot);
+}
+
+void print_usage(const char *name)
+{
+    printf("Usage: %s [options] <suite>[/<argument>]...\n"
+           "\n"
+           "Runs each suite named, passing it the arguments given as "
+           "suite/argument,\n"
+           "such as basic/hostptr, and every other argument.\n"
+           "\n"
+           "Suites:\n",
+           name);
+    for (const Suite *suite = kSuites; suite->name; suite++)
+        printf("    %s\n", suite->name);
+}
+
+} // anonymous namespace
+
+int main(int argc, const char *argv[])
+{
+    std::vector<SuiteRun> runs;
+    std::vector<std::string> common;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help")
+        {
+            print_usage(argv[0]);
+            return EXIT_SUCCESS;
+        }
+
+        size_t slash = arg.find('/');
+        const Suite *suite = find_suite(arg.substr(0, slash));
+        if (suite == nullptr)
+        {
+            common.push_back(arg);
+            continue;
+        }
+
+        SuiteRun *run = nullptr;
+        for (SuiteRun &existing : runs)
+            if (existing.suite == suite) run = &existing;
+        if (run == nullptr)
+        {
+            runs.push_back(SuiteRun{ suite, std::vector<std::string>() });
+            run = &runs.back();
+        }
+        if (slash != std::string::npos)
+            run->args.push_back(arg.substr(slash + 1));
+    }
+
+    if (runs.empty())
+    {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::vector<std::string> files;
+    for (const char *variable : kPerSuiteFiles)
+    {
+        const char *value = getenv(variable);
+        files.push_back(value ? value : "");
+    }
+
+    gMultiSuiteRun = true;
+    std::vector<const char *> failed;
+    for (const SuiteRun &run : runs)
+    {
+        for (size_t i = 0; i < files.size(); i++)
+            if (!files[i].empty())
+                setenv(kPerSuiteFiles[i],
+                       suite_file_name(files[i], run.suite->name).c_str(), 1);
+
+        // The suites edit their arguments in place
+        std::vector<std::string> args(1, run.suite->binary);
+        args.insert(args.end(), common.begin(), common.end());
+        args.insert(args.end(), run.args.begin(), run.args.end());
+        std::vector<const char *> suiteArgv;
+        for (const std::string &arg : args) suiteArgv.push_back(arg.c_str());
+        suiteArgv.push_back(nullptr);
+
+        printf("\n===== %s =====\n", run.suite->name);
+        fflush(stdout);
+        reset_suite_state();
+        if (run.suite->main((int)args.size(), suiteArgv.data()) != EXIT_SUCCESS)
+            failed.push_back(run.suite->name);
+    }
+    release_context_pool();
+
+    if (failed.empty())
+    {
+        printf("\nPASSED %zu of %zu suites.\n", runs.size(), runs.size());
+        return EXIT_SUCCESS;
+    }
+    printf("\nFAILED %zu of %zu suites:", failed.size(), runs.size());
+    for (const char *name : failed) printf(" %s", name);
+    printf("\n");
+    return EXIT_FAILURE;
+}
@@ -35,6 +35,8 @@ test_definition test_list[] = {
     ADD_TEST( max_devices ),
 
     ADD_TEST( hundred_queues ),
+
+    ADD_BENCHMARK( device_scaling ),
 };
 
 const int test_num = ARRAY_SIZE( test_list );
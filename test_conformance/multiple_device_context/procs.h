@@ -17,6 +17,7 @@
 #include "harness/kernelHelpers.h"
 #include "harness/typeWrappers.h"
 #include "harness/mt19937.h"
+#include "harness/parseParameters.h"
 
 extern int        test_context_multiple_contexts_same_device(cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements);
 extern int        test_context_two_contexts_same_device(cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements);
@@ -28,4 +29,6 @@ extern int        test_max_devices(cl_device_id deviceID, cl_context context, cl
 
 extern int        test_hundred_queues(cl_device_id device, cl_context context, cl_command_queue queue, int num_elements);
 
+extern int        test_device_scaling(cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements);
+
 
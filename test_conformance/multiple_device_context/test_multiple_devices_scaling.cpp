@@ -0,0 +1,418 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "testBase.h"
+#include "harness/typeWrappers.h"
+#include "harness/testHarness.h"
+#include "harness/benchmark.h"
+#include "harness/perfMetrics.h"
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Splits one embarrassingly parallel kernel across every device of the
+// platform and times the whole trip from host input to host results:
+//  - single:   the first device does all of the work on its own
+//  - implicit: one context, each device works on its own sub-buffers of the
+//              shared buffers and the driver moves the data where it is used
+//  - explicit: as implicit, but the sub-buffers are moved to their device
+//              with clEnqueueMigrateMemObjects first and back to the host
+//              afterwards, with the inbound migration timed on its own
+//  - contexts: one context per device, each with its own copy of its slice
+// Every run is spot-checked on the host. A benchmark, so it only runs when
+// named.
+
+static const char *scaling_kernel[] = {
+    "__kernel void spin(__global const uint *src, __global uint *dst,\n"
+    "                   uint iterations)\n"
+    "{\n"
+    "    size_t gid = get_global_id(0);\n"
+    "    uint x = src[gid];\n"
+    "    for (uint i = 0; i < iterations; i++)\n"
+    "        x = x * 1664525u + 1013904223u;\n"
+    "    dst[gid] = x;\n"
+    "}\n"
+};
+
+#define MAX_SCALING_DEVICES 32
+
+static const cl_uint kScalingIterations = 1024;
+static const size_t kMinScalingElements = 1 << 22;
+static const size_t kScalingVerifyStride = 97;
+
+namespace {
+
+struct ScalingBench
+{
+    std::vector<cl_device_id> devices;
+    std::vector<cl_uint> input;
+    std::vector<cl_uint> output;
+    // Start and length of each device's slice, in elements
+    std::vector<size_t> sliceStart;
+    std::vector<size_t> sliceLength;
+
+    // Shared context state
+    clContextWrapper context;
+    clProgramWrapper program;
+    clKernelWrapper kernel;
+    std::vector<clCommandQueueWrapper> queues;
+    clMemWrapper src;
+    clMemWrapper dst;
+    std::vector<clMemWrapper> srcSlices;
+    std::vector<clMemWrapper> dstSlices;
+
+    size_t elements() const { return input.size(); }
+
+    int Init(const std::vector<cl_device_id> &device_list, size_t count)
+    {
+        int error;
+        devices = device_list;
+        size_t n = devices.size();
+
+        // Slices start on the strictest base address alignment of any device
+        cl_uint align_bits = 0;
+        for (size_t i = 0; i < n; i++)
+        {
+            cl_uint bits;
+            error = clGetDeviceInfo(devices[i], CL_DEVICE_MEM_BASE_ADDR_ALIGN,
+                                    sizeof(bits), &bits, NULL);
+            test_error(error, "Unable to get CL_DEVICE_MEM_BASE_ADDR_ALIGN");
+            align_bits = std::max(align_bits, bits);
+        }
+        size_t align = std::max<size_t>(align_bits / 8 / sizeof(cl_uint), 1);
+        size_t slice = ((count + n - 1) / n + align - 1) / align * align;
+        for (size_t i = 0, start = 0; i < n && start < count; i++)
+        {
+            sliceStart.push_back(start);
+            sliceLength.push_back(std::min(slice, count - start));
+            start += slice;
+        }
+
+        RandomSeed seed(gRandomSeed);
+        input.resize(count);
+        for (size_t i = 0; i < count; i++) input[i] = genrand_int32(seed);
+        output.resize(count);
+
+        context = clCreateContext(NULL, (cl_uint)n, devices.data(),
+                                  notify_callback, NULL, &error);
+        test_error(error, "Unable to create testing context");
+        error = create_single_kernel_helper(context, &program, &kernel, 1,
+                                            scaling_kernel, "spin");
+        test_error(error, "Unable to create the spin kernel");
+        queues.resize(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            queues[i] = clCreateCommandQueueWithProperties(context, devices[i],
+                                                           0, &error);
+            test_error(error, "Unable to create command queue");
+        }
+
+        size_t bytes = sizeof(cl_uint) * count;
+        src = clCreateBuffer(context, CL_MEM_READ_ONLY, bytes, NULL, &error);
+        test_error(error, "Unable to create input buffer");
+        dst = clCreateBuffer(context, CL_MEM_WRITE_ONLY, bytes, NULL, &error);
+        test_error(error, "Unable to create output buffer");
+        srcSlices.resize(sliceStart.size());
+        dstSlices.resize(sliceStart.size());
+        for (size_t i = 0; i < sliceStart.size(); i++)
+        {
+            cl_buffer_region region = { sizeof(cl_uint) * sliceStart[i],
+                                        sizeof(cl_uint) * sliceLength[i] };
+            srcSlices[i] =
+                clCreateSubBuffer(src, CL_MEM_READ_ONLY,
+                                  CL_BUFFER_CREATE_TYPE_REGION, &region,
+                                  &error);
+            test_error(error, "Unable to create input sub-buffer");
+            dstSlices[i] =
+                clCreateSubBuffer(dst, CL_MEM_WRITE_ONLY,
+                                  CL_BUFFER_CREATE_TYPE_REGION, &region,
+                                  &error);
+            test_error(error, "Unable to create output sub-buffer");
+        }
+        return 0;
+    }
+
+    int Launch(cl_command_queue queue, cl_kernel k, cl_mem in, cl_mem out,
+               size_t count)
+    {
+        int error = clSetKernelArg(k, 0, sizeof(cl_mem), &in);
+        error |= clSetKernelArg(k, 1, sizeof(cl_mem), &out);
+        error |= clSetKernelArg(k, 2, sizeof(kScalingIterations),
+                                &kScalingIterations);
+        test_error(error, "Unable to set kernel arguments");
+        error = clEnqueueNDRangeKernel(queue, k, 1, NULL, &count, NULL, 0,
+                                       NULL, NULL);
+        test_error(error, "Kernel execution failed");
+        error = clFlush(queue);
+        test_error(error, "clFlush failed");
+        return 0;
+    }
+
+    int FinishAll()
+    {
+        for (size_t i = 0; i < queues.size(); i++)
+        {
+            int error = clFinish(queues[i]);
+            test_error(error, "clFinish failed");
+        }
+        return 0;
+    }
+
+    int WriteInput()
+    {
+        int error = clEnqueueWriteBuffer(queues[0], src, CL_TRUE, 0,
+                                         sizeof(cl_uint) * elements(),
+                                         input.data(), 0, NULL, NULL);
+        test_error(error, "Unable to write input data");
+        return 0;
+    }
+
+    int ReadOutput()
+    {
+        int error = clEnqueueReadBuffer(queues[0], dst, CL_TRUE, 0,
+                                        sizeof(cl_uint) * elements(),
+                                        output.data(), 0, NULL, NULL);
+        test_error(error, "Unable to read output data");
+        return 0;
+    }
+
+    int RunSingle(double &ms)
+    {
+        HostTimer timer;
+        int error = WriteInput();
+        if (!error) error = Launch(queues[0], kernel, src, dst, elements());
+        if (!error) error = ReadOutput();
+        ms = timer.elapsed_ms();
+        return error;
+    }
+
+    // Runs every slice on its device through the shared context. With
+    // migrate set the slices are moved explicitly and migrate_ms gets the
+    // time taken to move them to the devices.
+    int RunShared(bool migrate, double &ms, double &migrate_ms)
+    {
+        int error;
+        HostTimer timer;
+        error = WriteInput();
+        if (error) return error;
+
+        migrate_ms = 0;
+        if (migrate)
+        {
+            for (size_t i = 0; i < sliceStart.size(); i++)
+            {
+                error = clEnqueueMigrateMemObjects(queues[i], 1, &srcSlices[i],
+                                                   0, 0, NULL, NULL);
+                error |= clEnqueueMigrateMemObjects(
+                    queues[i], 1, &dstSlices[i],
+                    CL_MIGRATE_MEM_OBJECT_CONTENT_UNDEFINED, 0, NULL, NULL);
+                test_error(error, "clEnqueueMigrateMemObjects failed");
+            }
+            error = FinishAll();
+            if (error) return error;
+            migrate_ms = timer.elapsed_ms();
+        }
+
+        for (size_t i = 0; i < sliceStart.size(); i++)
+        {
+            error = Launch(queues[i], kernel, srcSlices[i], dstSlices[i],
+                           sliceLength[i]);
+            if (error) return error;
+            if (migrate)
+            {
+                error = clEnqueueMigrateMemObjects(queues[i], 1, &dstSlices[i],
+                                                   CL_MIGRATE_MEM_OBJECT_HOST,
+                                                   0, NULL, NULL);
+                test_error(error, "clEnqueueMigrateMemObjects failed");
+            }
+        }
+        error = FinishAll();
+        if (!error) error = ReadOutput();
+        ms = timer.elapsed_ms();
+        return error;
+    }
+
+    // Runs every slice in a context of its own, with buffers holding just
+    // that slice
+    int RunContexts(double &ms)
+    {
+        int error;
+        size_t n = sliceStart.size();
+        std::vector<clContextWrapper> contexts(n);
+        std::vector<clProgramWrapper> programs(n);
+        std::vector<clKernelWrapper> kernels(n);
+        std::vector<clCommandQueueWrapper> ctxQueues(n);
+        std::vector<clMemWrapper> ins(n), outs(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            contexts[i] = clCreateContext(NULL, 1, &devices[i], notify_callback,
+                                          NULL, &error);
+            test_error(error, "Unable to create per-device context");
+            error = create_single_kernel_helper(contexts[i], &programs[i],
+                                                &kernels[i], 1, scaling_kernel,
+                                                "spin");
+            test_error(error, "Unable to create the spin kernel");
+            ctxQueues[i] = clCreateCommandQueueWithProperties(
+                contexts[i], devices[i], 0, &error);
+            test_error(error, "Unable to create command queue");
+            size_t bytes = sizeof(cl_uint) * sliceLength[i];
+            ins[i] = clCreateBuffer(contexts[i], CL_MEM_READ_ONLY, bytes, NULL,
+                                    &error);
+            test_error(error, "Unable to create input buffer");
+            outs[i] = clCreateBuffer(contexts[i], CL_MEM_WRITE_ONLY, bytes,
+                                     NULL, &error);
+            test_error(error, "Unable to create output buffer");
+        }
+
+        HostTimer timer;
+        for (size_t i = 0; i < n; i++)
+        {
+            size_t bytes = sizeof(cl_uint) * sliceLength[i];
+            error = clEnqueueWriteBuffer(ctxQueues[i], ins[i], CL_FALSE, 0,
+                                         bytes, &input[sliceStart[i]], 0, NULL,
+                                         NULL);
+            test_error(error, "Unable to write input data");
+            error = Launch(ctxQueues[i], kernels[i], ins[i], outs[i],
+                           sliceLength[i]);
+            if (error) return error;
+            error = clEnqueueReadBuffer(ctxQueues[i], outs[i], CL_FALSE, 0,
+                                        bytes, &output[sliceStart[i]], 0, NULL,
+                                        NULL);
+            test_error(error, "Unable to read output data");
+            error = clFlush(ctxQueues[i]);
+            test_error(error, "clFlush failed");
+        }
+        for (size_t i = 0; i < n; i++)
+        {
+            error = clFinish(ctxQueues[i]);
+            test_error(error, "clFinish failed");
+        }
+        ms = timer.elapsed_ms();
+        return 0;
+    }
+
+    // Spot-checks the results of the last run, then clears them so that
+    // the next run can't pass on stale data
+    int Verify(const char *mode)
+    {
+        for (size_t i = 0; i < elements(); i += kScalingVerifyStride)
+        {
+            cl_uint x = input[i];
+            for (cl_uint n = 0; n < kScalingIterations; n++)
+                x = x * 1664525u + 1013904223u;
+            if (output[i] != x)
+            {
+                log_error("ERROR: %s run, element %zu is 0x%x, expected 0x%x\n",
+                          mode, i, output[i], x);
+                return -1;
+            }
+        }
+        std::fill(output.begin(), output.end(), 0);
+        return 0;
+    }
+};
+
+} // anonymous namespace
+
+int test_device_scaling(cl_device_id deviceID, cl_context context,
+                        cl_command_queue queue, int num_elements)
+{
+    cl_platform_id platform;
+    int error = clGetDeviceInfo(deviceID, CL_DEVICE_PLATFORM, sizeof(platform),
+                                &platform, NULL);
+    test_error(error, "Unable to get platform");
+    cl_device_id device_list[MAX_SCALING_DEVICES];
+    cl_uint deviceCount;
+    error = clGetDeviceIDs(platform, CL_DEVICE_TYPE_ALL, MAX_SCALING_DEVICES,
+                           device_list, &deviceCount);
+    test_error(error, "Unable to get devices");
+    deviceCount = std::min(deviceCount, (cl_uint)MAX_SCALING_DEVICES);
+
+    for (cl_uint i = 0; i < deviceCount; i++)
+    {
+        char deviceName[4096] = "";
+        error = clGetDeviceInfo(device_list[i], CL_DEVICE_NAME,
+                                sizeof(deviceName), deviceName, NULL);
+        test_error(error, "clGetDeviceInfo CL_DEVICE_NAME failed");
+        log_info("Device %u is \"%s\".\n", i, deviceName);
+    }
+
+    ScalingBench bench;
+    error = bench.Init(
+        std::vector<cl_device_id>(device_list, device_list + deviceCount),
+        std::max((size_t)num_elements, kMinScalingElements));
+    if (error) return error;
+
+    // Each mode with the time of its run, and whether it splits the work.
+    // The migrate row is the inbound migration of the explicit mode alone.
+    double unused_ms;
+    const struct
+    {
+        const char *name;
+        std::function<int(double &)> run;
+        bool split;
+    } modes[] = {
+        { "single", [&](double &ms) { return bench.RunSingle(ms); }, false },
+        { "implicit",
+          [&](double &ms) { return bench.RunShared(false, ms, unused_ms); },
+          true },
+        { "explicit",
+          [&](double &ms) { return bench.RunShared(true, ms, unused_ms); },
+          true },
+        { "contexts", [&](double &ms) { return bench.RunContexts(ms); }, true },
+        { "migrate",
+          [&](double &ms) { return bench.RunShared(true, unused_ms, ms); },
+          false },
+    };
+    BenchmarkOptions options;
+    options.warmup = 1;
+    options.minSamples = 3;
+    options.maxSeconds = 5.0;
+
+    size_t slices = bench.sliceStart.size();
+    log_info("Splitting %zu elements across %zu devices\n", bench.elements(),
+             slices);
+    log_benchmark_header("device_scaling", "devices/mode");
+    BenchmarkStats stats[ARRAY_SIZE(modes)];
+    for (size_t m = 0; m < ARRAY_SIZE(modes); m++)
+    {
+        error = run_benchmark(
+            options,
+            [&](double *ms) {
+                int error = modes[m].run(*ms);
+                return error ? error : bench.Verify(modes[m].name);
+            },
+            &stats[m]);
+        if (error) return error;
+
+        size_t used = m == 0 ? 1 : slices;
+        std::string label = std::to_string(used) + "/" + modes[m].name;
+        log_benchmark_stats("device_scaling", label.c_str(), "ms", false,
+                            stats[m]);
+        if (modes[m].split && stats[m].median > 0)
+        {
+            double speedup = stats[0].median / stats[m].median;
+            record_perf_metric("device_scaling_speedup." + label, speedup,
+                               "ratio", true);
+            record_perf_metric("device_scaling_efficiency." + label,
+                               100.0 * speedup / used, "%", true);
+        }
+    }
+    log_info("Implicit coherence cost %.2f ms more than explicit migration\n",
+             stats[1].median - stats[2].median);
+    return 0;
+}
@@ -18,6 +18,9 @@
 #include <sstream>
 #define NL "\n"
 
+// How many subtests run from one read back
+#define SUBTESTS_PER_BATCH 16
+
 size_t TestNonUniformWorkGroup::_maxLocalWorkgroupSize = 0;
 bool TestNonUniformWorkGroup::_strictMode = false;
 
@@ -511,7 +514,7 @@ void TestNonUniformWorkGroup::enableStrictMode(bool state) {
   TestNonUniformWorkGroup::_strictMode = state;
 }
 
-int TestNonUniformWorkGroup::prepareDevice () {
+int TestNonUniformWorkGroup::prepareDevice (KernelCache *cache) {
   int err;
   cl_uint device_max_dimensions;
   cl_uint i;
@@ -557,6 +560,16 @@ int TestNonUniformWorkGroup::prepareDevice () {
   if (_testRange & Range::BARRIERS)
     buildOptions += " -D TESTBARRIERS";
 
+  // Subtests with the same build options share one program
+  if (cache) {
+    KernelCache::iterator it = cache->find(buildOptions);
+    if (it != cache->end()) {
+      _program = it->second.first;
+      _testKernel = it->second.second;
+      return 0;
+    }
+  }
+
   err = create_single_kernel_helper_with_build_options (_context, &_program, &_testKernel, 1,
     &KERNEL_FUNCTION, "testKernel", buildOptions.c_str());
   if (err)
@@ -565,6 +578,9 @@ int TestNonUniformWorkGroup::prepareDevice () {
     return -1;
   }
 
+  if (cache)
+    (*cache)[buildOptions] = std::make_pair(_program, _testKernel);
+
   return 0;
 }
 
@@ -712,20 +728,16 @@ size_t TestNonUniformWorkGroup::adjustGlobalBufferSize(size_t globalBufferSize)
   return adjustedGlobalBufferSize;
 }
 
-int TestNonUniformWorkGroup::runKernel () {
+int TestNonUniformWorkGroup::enqueueKernel (cl_command_queue queue, cl_mem results, cl_mem errors,
+  cl_mem globalAtomic, cl_event *event) {
   int err;
 
-  // TEST INFO
-  showTestInfo();
-
   size_t localArraySize = (_localSize_IsNull)?TestNonUniformWorkGroup::getMaxLocalWorkgroupSize(_device):(_enqueuedLocalSize[0]*_enqueuedLocalSize[1]*_enqueuedLocalSize[2]);
-  clMemWrapper resultsRegionArray = clCreateBuffer(_context, CL_MEM_READ_WRITE | CL_MEM_USE_HOST_PTR, _resultsRegionArray.size() * sizeof(DataContainerAttrib), &_resultsRegionArray.front(), &err);
-  test_error(err, "clCreateBuffer failed");
 
   size_t *localSizePtr = (_localSize_IsNull)?NULL:_enqueuedLocalSize;
   size_t *globalWorkOffsetPtr = (_globalWorkOffset_IsNull)?NULL:_globalWorkOffset;
 
-  err = clSetKernelArg(_testKernel, 0, sizeof(resultsRegionArray), &resultsRegionArray);
+  err = clSetKernelArg(_testKernel, 0, sizeof(results), &results);
   test_error(err, "clSetKernelArg failed");
 
   //creating local buffer
@@ -733,6 +745,7 @@ int TestNonUniformWorkGroup::runKernel () {
   err = clSetKernelArg(_testKernel, 1, localArraySize, NULL);
   test_error(err, "clSetKernelArg failed");
 
+  // Released here, but kept by the runtime until the kernel is done with it
   size_t globalBufferSize = adjustGlobalBufferSize(_numOfGlobalWorkItems*sizeof(cl_uint));
   clMemWrapper testGlobalArray = clCreateBuffer(_context, CL_MEM_READ_WRITE, globalBufferSize, NULL, &err);
   test_error(err, "clCreateBuffer failed");
@@ -740,40 +753,33 @@ int TestNonUniformWorkGroup::runKernel () {
   err = clSetKernelArg(_testKernel, 2, sizeof(testGlobalArray), &testGlobalArray);
   test_error(err, "clSetKernelArg failed");
 
-  _globalAtomicTestValue = 0;
-  clMemWrapper globalAtomicTestVariable = clCreateBuffer(_context, (CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR), sizeof(_globalAtomicTestValue), &_globalAtomicTestValue, &err);
-  test_error(err, "clCreateBuffer failed");
-
-  err = clSetKernelArg(_testKernel, 3, sizeof(globalAtomicTestVariable), &globalAtomicTestVariable);
+  err = clSetKernelArg(_testKernel, 3, sizeof(globalAtomic), &globalAtomic);
   test_error(err, "clSetKernelArg failed");
 
-  clMemWrapper errorArray = clCreateBuffer(_context, CL_MEM_READ_WRITE | CL_MEM_USE_HOST_PTR, _err.errorArrayCounterSize(), _err.errorArrayCounter(), &err);
-  test_error(err, "clCreateBuffer failed");
-
-  err = clSetKernelArg(_testKernel, 4, sizeof(errorArray), &errorArray);
+  err = clSetKernelArg(_testKernel, 4, sizeof(errors), &errors);
   test_error(err, "clSetKernelArg failed");
 
-  err = clEnqueueNDRangeKernel(_queue, _testKernel, _dims, globalWorkOffsetPtr, _globalSize,
-    localSizePtr, 0, NULL, NULL);
+  err = clEnqueueNDRangeKernel(queue, _testKernel, _dims, globalWorkOffsetPtr, _globalSize,
+    localSizePtr, 0, NULL, event);
   test_error(err, "clEnqueueNDRangeKernel failed");
 
+  return 0;
+}
 
-  err = clFinish(_queue);
-  test_error(err, "clFinish failed");
+int TestNonUniformWorkGroup::collectResults (const DataContainerAttrib *results,
+  const cl_uint *errors, cl_uint globalAtomic) {
+  // TEST INFO
+  showTestInfo();
 
-  err = clEnqueueReadBuffer(_queue, globalAtomicTestVariable, CL_TRUE, 0, sizeof(unsigned int), &_globalAtomicTestValue, 0, NULL, NULL);
-  test_error(err, "clEnqueueReadBuffer failed");
+  _globalAtomicTestValue = globalAtomic;
 
   if (_err.checkError()) {
     return -1;
   }
 
-  // synchronization of main buffer
-  err = clEnqueueReadBuffer(_queue, resultsRegionArray, CL_TRUE, 0, _resultsRegionArray.size() * sizeof(DataContainerAttrib), &_resultsRegionArray.front(), 0, NULL, NULL);
-  test_error(err, "clEnqueueReadBuffer failed");
+  memcpy(&_resultsRegionArray.front(), results, _resultsRegionArray.size() * sizeof(DataContainerAttrib));
 
-  err = clEnqueueReadBuffer(_queue, errorArray, CL_TRUE, 0, _err.errorArrayCounterSize(), _err.errorArrayCounter(), 0, NULL, NULL);
-  test_error(err, "clEnqueueReadBuffer failed");
+  memcpy(_err.errorArrayCounter(), errors, _err.errorArrayCounterSize());
   // Synchronization of errors occurred in kernel into general error stats
   _err.synchronizeStatsMap();
 
@@ -792,16 +798,14 @@ void SubTestExecutor::runTestNonUniformWorkGroup(
     const cl_uint dims, size_t *globalSize, const size_t *localSize,
     const size_t *globalWorkOffset, const size_t *reqdWorkGroupSize, int range)
 {
-
-
     int err;
     ++_overallCounter;
-    TestNonUniformWorkGroup test(_device, _context, _queue, dims, globalSize,
-                                 localSize, NULL, globalWorkOffset,
-                                 reqdWorkGroupSize);
+    std::unique_ptr<TestNonUniformWorkGroup> test(new TestNonUniformWorkGroup(
+        _device, _context, _queue, dims, globalSize, localSize, NULL,
+        globalWorkOffset, reqdWorkGroupSize));
 
-    test.setTestRange(range);
-    err = test.prepareDevice();
+    test->setTestRange(range);
+    err = test->prepareDevice(&_kernels);
     if (err)
     {
         log_error("Error: prepare device\n");
@@ -809,21 +813,174 @@ void SubTestExecutor::runTestNonUniformWorkGroup(
         return;
     }
 
-    err = test.runKernel();
+    // Every subtest of a batch has its own global barrier buffer, so bound
+    // what a batch allocates as well as how many subtests it holds
+    if (!_pending.empty()
+        && (_pending.size() == SUBTESTS_PER_BATCH
+            || (_pendingGlobalItems + test->numOfGlobalWorkItems())
+                    * sizeof(cl_uint)
+                > MAX_SIZE_OF_ALLOCATED_MEMORY))
+    {
+        runPending();
+    }
+    _pendingGlobalItems += test->numOfGlobalWorkItems();
+    _pending.push_back(std::move(test));
+}
+
+int SubTestExecutor::createBatchQueue()
+{
+    if (_batchQueue) return 0;
+
+    cl_command_queue_properties properties = 0;
+    int err = clGetDeviceInfo(_device, CL_DEVICE_QUEUE_ON_HOST_PROPERTIES,
+                              sizeof(properties), &properties, NULL);
+    test_error(err, "clGetDeviceInfo failed");
+
+    // The subtests of a batch are independent, let the device overlap them
+    if (properties & CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE)
+    {
+        cl_queue_properties queueProperties[] = {
+            CL_QUEUE_PROPERTIES, CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE, 0
+        };
+        _batchQueue = clCreateCommandQueueWithProperties(
+            _context, _device, queueProperties, &err);
+        test_error(err, "clCreateCommandQueueWithProperties failed");
+    }
+    else
+    {
+        _batchQueue = _queue;
+        err = clRetainCommandQueue(_queue);
+        test_error(err, "clRetainCommandQueue failed");
+    }
+    return 0;
+}
+
+static size_t alignUp(size_t size, size_t alignment)
+{
+    return alignment ? (size + alignment - 1) / alignment * alignment : size;
+}
+
+void SubTestExecutor::runPending()
+{
+    std::vector<std::unique_ptr<TestNonUniformWorkGroup> > batch;
+    batch.swap(_pending);
+    _pendingGlobalItems = 0;
+    if (batch.empty()) return;
+
+    int err = createBatchQueue();
+    if (err)
+    {
+        _failCounter += batch.size();
+        return;
+    }
+
+    cl_uint alignBits = 0;
+    err = clGetDeviceInfo(_device, CL_DEVICE_MEM_BASE_ADDR_ALIGN,
+                          sizeof(alignBits), &alignBits, NULL);
     if (err)
     {
-        log_error("Error: run kernel\n");
-        ++_failCounter;
+        print_error(err, "clGetDeviceInfo failed");
+        _failCounter += batch.size();
         return;
     }
 
-    err = test.verifyResults();
+    // Each subtest's slot holds its regions, its error counters and its
+    // global atomic, each at an offset a sub-buffer can start at
+    size_t align = alignBits / 8;
+    size_t resultsSize = NUMBER_OF_REGIONS * sizeof(DataContainerAttrib);
+    size_t errorsSize = Error::_LAST_ELEM * sizeof(cl_uint);
+    size_t resultsOffset = 0;
+    size_t errorsOffset = resultsOffset + alignUp(resultsSize, align);
+    size_t atomicOffset = errorsOffset + alignUp(errorsSize, align);
+    size_t slotSize = atomicOffset + alignUp(sizeof(cl_uint), align);
+
+    std::vector<cl_uchar> slots(batch.size() * slotSize, 0);
+    clMemWrapper batchBuffer =
+        clCreateBuffer(_context, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR,
+                       slots.size(), slots.data(), &err);
     if (err)
     {
-        log_error("Error: verify results\n");
-        ++_failCounter;
+        print_error(err, "clCreateBuffer failed");
+        _failCounter += batch.size();
         return;
     }
+
+    std::vector<clMemWrapper> subBuffers;
+    std::vector<cl_event> events;
+    std::vector<bool> enqueued(batch.size(), false);
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+        cl_mem slot[3];
+        size_t offsets[3] = { resultsOffset, errorsOffset, atomicOffset };
+        size_t sizes[3] = { resultsSize, errorsSize, sizeof(cl_uint) };
+        for (int part = 0; part < 3; ++part)
+        {
+            cl_buffer_region region = { i * slotSize + offsets[part],
+                                        sizes[part] };
+            subBuffers.push_back(clCreateSubBuffer(
+                batchBuffer, CL_MEM_READ_WRITE, CL_BUFFER_CREATE_TYPE_REGION,
+                &region, &err));
+            if (err) break;
+            slot[part] = subBuffers.back();
+        }
+        if (err)
+        {
+            print_error(err, "clCreateSubBuffer failed");
+            continue;
+        }
+
+        cl_event event = NULL;
+        err = batch[i]->enqueueKernel(_batchQueue, slot[0], slot[1], slot[2],
+                                      &event);
+        if (err) continue;
+        events.push_back(event);
+        enqueued[i] = true;
+    }
+
+    if (!events.empty())
+    {
+        err = clEnqueueReadBuffer(_batchQueue, batchBuffer, CL_TRUE, 0,
+                                  slots.size(), slots.data(), events.size(),
+                                  events.data(), NULL);
+        if (err)
+        {
+            print_error(err, "clEnqueueReadBuffer failed");
+            std::fill(enqueued.begin(), enqueued.end(), false);
+        }
+    }
+    for (size_t i = 0; i < events.size(); ++i) clReleaseEvent(events[i]);
+
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+        if (!enqueued[i])
+        {
+            log_error("Error: run kernel\n");
+            ++_failCounter;
+            continue;
+        }
+
+        const cl_uchar *slot = &slots[i * slotSize];
+        cl_uint globalAtomic;
+        memcpy(&globalAtomic, slot + atomicOffset, sizeof(globalAtomic));
+        err = batch[i]->collectResults(
+            reinterpret_cast<const DataContainerAttrib *>(slot + resultsOffset),
+            reinterpret_cast<const cl_uint *>(slot + errorsOffset),
+            globalAtomic);
+        if (err)
+        {
+            log_error("Error: run kernel\n");
+            ++_failCounter;
+            continue;
+        }
+
+        err = batch[i]->verifyResults();
+        if (err)
+        {
+            log_error("Error: verify results\n");
+            ++_failCounter;
+            continue;
+        }
+    }
 }
 
 int SubTestExecutor::calculateWorkGroupSize(size_t &maxWgSize, int testRange) {
@@ -857,6 +1014,7 @@ int SubTestExecutor::calculateWorkGroupSize(size_t &maxWgSize, int testRange) {
 }
 
 int SubTestExecutor::status() {
+  runPending();
 
   if (_failCounter>0) {
     log_error ("%d subtest(s) (of %d) failed\n", _failCounter, _overallCounter);
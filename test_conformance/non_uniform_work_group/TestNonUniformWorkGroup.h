@@ -20,6 +20,8 @@
 #include <vector>
 #include "tools.h"
 #include <algorithm>
+#include <memory>
+#include <utility>
 
 #define MAX_SIZE_OF_ALLOCATED_MEMORY (400*1024*1024)
 
@@ -57,6 +59,10 @@ namespace Range {
 
 std::string showArray (const size_t *arr, cl_uint dims);
 
+// Programs built for the subtests of one test, by their build options
+typedef std::map<std::string, std::pair<clProgramWrapper, clKernelWrapper> >
+    KernelCache;
+
 // Main class responsible for testing
 class TestNonUniformWorkGroup {
 public:
@@ -78,9 +84,13 @@ public:
   static void enableStrictMode (bool state);
 
   void setTestRange (int range) {_testRange = range;}
-  int prepareDevice ();
+  int prepareDevice (KernelCache *cache = NULL);
   int verifyResults ();
-  int runKernel ();
+  int enqueueKernel (cl_command_queue queue, cl_mem results, cl_mem errors,
+                     cl_mem globalAtomic, cl_event *event);
+  int collectResults (const DataContainerAttrib *results,
+                      const cl_uint *errors, cl_uint globalAtomic);
+  size_t numOfGlobalWorkItems () const {return _numOfGlobalWorkItems;}
 
 private:
   size_t _globalSize[MAX_DIMS];
@@ -121,11 +131,16 @@ private:
   size_t adjustGlobalBufferSize(size_t globalBufferSize);
 };
 
-// Class responsible for running subtest scenarios in test function
+// Class responsible for running subtest scenarios in test function.
+// Subtests are queued and run in batches: every subtest of a batch gets its
+// own slots of one results buffer, their kernels are all enqueued on an
+// out-of-order queue where the device has one, and the whole batch is read
+// back at once. status() runs whatever is still queued.
 class SubTestExecutor {
 public:
   SubTestExecutor(const cl_device_id &device, const cl_context &context, const cl_command_queue &queue)
-    : _device (device), _context (context), _queue (queue), _failCounter (0), _overallCounter (0) {}
+    : _device (device), _context (context), _queue (queue), _failCounter (0), _overallCounter (0),
+      _pendingGlobalItems (0) {}
 
   void runTestNonUniformWorkGroup(const cl_uint dims, size_t *globalSize,
                                   const size_t *localSize, int range);
@@ -145,6 +160,14 @@ private:
   const cl_command_queue _queue;
   unsigned int _failCounter;
   unsigned int _overallCounter;
+
+  KernelCache _kernels;
+  clCommandQueueWrapper _batchQueue;
+  std::vector<std::unique_ptr<TestNonUniformWorkGroup> > _pending;
+  size_t _pendingGlobalItems;
+
+  int createBatchQueue();
+  void runPending();
 };
 
 #endif // TESTNONUNIFORMWORKGROUP_H
@@ -34,6 +34,8 @@ test_definition test_list[] = {
     ADD_TEST( non_uniform_other_basic ),
     ADD_TEST( non_uniform_other_atomics ),
     ADD_TEST( non_uniform_other_barriers ),
+
+    ADD_BENCHMARK( non_uniform_remainder_bench ),
 };
 
 const int test_num = ARRAY_SIZE( test_list );
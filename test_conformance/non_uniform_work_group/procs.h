@@ -14,6 +14,7 @@
 // limitations under the License.
 //
 #include "harness/typeWrappers.h"
+#include "harness/parseParameters.h"
 
 extern int test_non_uniform_1d_basic(cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements);
 extern int test_non_uniform_1d_atomics(cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements);
@@ -30,3 +31,5 @@ extern int test_non_uniform_3d_barriers(cl_device_id deviceID, cl_context contex
 extern int test_non_uniform_other_basic(cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements);
 extern int test_non_uniform_other_atomics(cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements);
 extern int test_non_uniform_other_barriers(cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements);
+
+extern int test_non_uniform_remainder_bench(cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements);
@@ -0,0 +1,237 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "harness/compat.h"
+#include "harness/testHarness.h"
+#include "harness/benchmark.h"
+#include "harness/perfMetrics.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "procs.h"
+
+// Cost of the remainder work-groups of a non-uniform NDRange against the
+// usual alternative of padding the global size up to a multiple of the
+// local size and bounds checking in the kernel. Both launches of a shape run
+// the same kernel over the same work-items; the non-uniform one is simply
+// not given the padding work-items. Shapes are whole groups plus a remainder
+// of 1, half a group and a group less one, in 1D and 2D. A benchmark, so it
+// only runs when named.
+
+static const char *remainder_bench_kernel[] = {
+    "__kernel void remainder_bench(__global uint *dst, uint width,\n"
+    "                              uint height)\n"
+    "{\n"
+    "    size_t x = get_global_id(0);\n"
+    "    size_t y = get_global_id(1);\n"
+    "    if (x >= width || y >= height) return;\n"
+    "    size_t i = y * width + x;\n"
+    "    dst[i] = (uint)i * 3u + 1u;\n"
+    "}\n"
+};
+
+namespace {
+
+const cl_uint kUntouched = 0xdeadbeef;
+
+// Whole groups in each dimension before the remainder is added
+const size_t kGroups1D = 1024;
+const size_t kGroups2D = 32;
+
+struct RemainderBench
+{
+    cl_command_queue queue;
+    cl_kernel kernel;
+    clMemWrapper dst;
+    std::vector<cl_uint> results;
+    BenchmarkOptions options;
+
+    // Device time of the runs in microseconds of a launch over global
+    // work-items that writes the width by height items it covers
+    int Time(cl_uint dims, const size_t *global, const size_t *local,
+             cl_uint width, cl_uint height, BenchmarkStats &stats)
+    {
+        int error = clSetKernelArg(kernel, 0, sizeof(cl_mem), &dst);
+        error |= clSetKernelArg(kernel, 1, sizeof(width), &width);
+        error |= clSetKernelArg(kernel, 2, sizeof(height), &height);
+        test_error(error, "clSetKernelArg failed");
+
+        error = clEnqueueFillBuffer(queue, dst, &kUntouched,
+                                    sizeof(kUntouched), 0,
+                                    results.size() * sizeof(cl_uint), 0, NULL,
+                                    NULL);
+        test_error(error, "clEnqueueFillBuffer failed");
+
+        error = run_benchmark(
+            options,
+            [&](double *us) {
+                clEventWrapper event;
+                cl_int err = clEnqueueNDRangeKernel(
+                    queue, kernel, dims, NULL, global, local, 0, NULL, &event);
+                test_error(err, "clEnqueueNDRangeKernel failed");
+                err = clWaitForEvents(1, &event);
+                test_error(err, "clWaitForEvents failed");
+                double ns;
+                err = get_event_duration_ns(event, &ns);
+                *us = ns / 1e3;
+                return err;
+            },
+            &stats);
+        if (error != CL_SUCCESS) return TEST_FAIL;
+
+        return Check((size_t)width * height);
+    }
+
+    // The covered items hold their own index times three plus one, and the
+    // rest of the buffer is untouched
+    int Check(size_t items)
+    {
+        int error = clEnqueueReadBuffer(queue, dst, CL_TRUE, 0,
+                                        results.size() * sizeof(cl_uint),
+                                        results.data(), 0, NULL, NULL);
+        test_error(error, "clEnqueueReadBuffer failed");
+
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            cl_uint expected = i < items ? (cl_uint)i * 3u + 1u : kUntouched;
+            if (results[i] != expected)
+            {
+                log_error("ERROR: work-item %zu of %zu wrote 0x%x, expected "
+                          "0x%x\n",
+                          i, items, results[i], expected);
+                return TEST_FAIL;
+            }
+        }
+        return CL_SUCCESS;
+    }
+};
+
+size_t round_up(size_t value, size_t multiple)
+{
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+} // anonymous namespace
+
+int test_non_uniform_remainder_bench(cl_device_id device, cl_context context,
+                                     cl_command_queue queue, int num_elements)
+{
+    int error;
+    if (get_device_cl_version(device) >= Version(3, 0))
+    {
+        cl_bool non_uniform = CL_FALSE;
+        error = clGetDeviceInfo(device,
+                                CL_DEVICE_NON_UNIFORM_WORK_GROUP_SUPPORT,
+                                sizeof(non_uniform), &non_uniform, NULL);
+        test_error(error,
+                   "Unable to get CL_DEVICE_NON_UNIFORM_WORK_GROUP_SUPPORT");
+        if (!non_uniform)
+        {
+            log_info("The device has no non-uniform work-groups, skipping "
+                     "the remainder measurements\n");
+            return TEST_SKIPPED_ITSELF;
+        }
+    }
+
+    clProgramWrapper program;
+    clKernelWrapper kernel;
+    error = create_single_kernel_helper(context, &program, &kernel, 1,
+                                        remainder_bench_kernel,
+                                        "remainder_bench");
+    test_error(error, "Unable to create the remainder kernel");
+
+    size_t max_local;
+    error = clGetKernelWorkGroupInfo(kernel, device, CL_KERNEL_WORK_GROUP_SIZE,
+                                     sizeof(max_local), &max_local, NULL);
+    test_error(error, "clGetKernelWorkGroupInfo failed");
+    size_t max_item_sizes[3];
+    error = clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_ITEM_SIZES,
+                            sizeof(max_item_sizes), max_item_sizes, NULL);
+    test_error(error, "Unable to get CL_DEVICE_MAX_WORK_ITEM_SIZES");
+
+    // The largest power of two local size in 1D, and the largest square
+    // power of two in 2D
+    size_t local_1d = 1;
+    while (local_1d * 2 <= std::min(max_local, max_item_sizes[0]))
+        local_1d *= 2;
+    size_t side = 1;
+    while ((side * 2) * (side * 2) <= max_local
+           && side * 2 <= std::min(max_item_sizes[0], max_item_sizes[1]))
+        side *= 2;
+
+    RemainderBench bench;
+    clCommandQueueWrapper profiling_queue = clCreateCommandQueue(
+        context, device, CL_QUEUE_PROFILING_ENABLE, &error);
+    test_error(error, "Unable to create profiling queue");
+    bench.queue = profiling_queue;
+    bench.kernel = kernel;
+    bench.options.warmup = 1;
+    bench.options.maxSeconds = 1.0;
+
+    size_t max_items = std::max(kGroups1D * local_1d + local_1d,
+                                (kGroups2D + 1) * side * (kGroups2D + 1)
+                                    * side);
+    bench.results.resize(max_items);
+    bench.dst = clCreateBuffer(context, CL_MEM_READ_WRITE,
+                               bench.results.size() * sizeof(cl_uint), NULL,
+                               &error);
+    test_error(error, "clCreateBuffer failed");
+
+    // Each shape is the launch without padding and the padded one, and the
+    // ratio of their medians
+    log_benchmark_header("remainder", "launch/dims/local/global");
+    for (cl_uint dims = 1; dims <= 2; dims++)
+    {
+        size_t group = dims == 1 ? local_1d : side;
+        size_t whole = (dims == 1 ? kGroups1D : kGroups2D) * group;
+        size_t remainders[] = { 1, group / 2, group - 1 };
+        for (size_t r = 0; r < ARRAY_SIZE(remainders); r++)
+        {
+            // A remainder of zero is a uniform launch, nothing to compare
+            if (remainders[r] == 0) continue;
+
+            size_t extent = whole + remainders[r];
+            size_t global[2] = { extent, dims == 1 ? 1 : extent };
+            size_t padded[2] = { round_up(extent, group),
+                                 dims == 1 ? 1 : round_up(extent, group) };
+            size_t local[2] = { group, dims == 1 ? 1 : group };
+            cl_uint width = (cl_uint)global[0];
+            cl_uint height = (cl_uint)global[1];
+
+            BenchmarkStats non_uniform, padding;
+            error = bench.Time(dims, global, local, width, height,
+                               non_uniform);
+            if (error != CL_SUCCESS) return TEST_FAIL;
+            error = bench.Time(dims, padded, local, width, height, padding);
+            if (error != CL_SUCCESS) return TEST_FAIL;
+
+            std::string label = std::to_string(dims) + "/"
+                + std::to_string(group) + "/"
+                + std::to_string(global[0] * global[1]);
+            log_benchmark_stats("remainder", ("non_uniform/" + label).c_str(),
+                                "us", false, non_uniform);
+            log_benchmark_stats("remainder", ("padded/" + label).c_str(), "us",
+                                false, padding);
+            if (padding.median > 0)
+                record_perf_metric("non_uniform_over_padded." + label,
+                                   non_uniform.median / padding.median,
+                                   "ratio", false);
+        }
+    }
+
+    return 0;
+}
@@ -104,6 +104,7 @@ test_definition test_list[] = {
     ADD_TEST(pipe_query_functions),
     ADD_TEST(pipe_readwrite_errors),
     ADD_TEST(pipe_subgroups_divergence),
+    ADD_BENCHMARK(pipe_throughput),
 };
 
 const int test_num = ARRAY_SIZE(test_list);
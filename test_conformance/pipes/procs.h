@@ -22,6 +22,7 @@
 #include "harness/typeWrappers.h"
 #include "harness/mt19937.h"
 #include "harness/conversions.h"
+#include "harness/parseParameters.h"
 
 #ifndef __APPLE__
 #include <CL/cl.h>
@@ -86,6 +87,8 @@ extern int        test_pipe_max_active_reservations(cl_device_id deviceID, cl_co
 extern int        test_pipe_query_functions(cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements);
 extern int        test_pipe_readwrite_errors(cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements);
 extern int        test_pipe_subgroups_divergence(cl_device_id deviceID, cl_context context, cl_command_queue queue, int num_elements);
+extern int test_pipe_throughput(cl_device_id deviceID, cl_context context,
+                                cl_command_queue queue, int num_elements);
 
 
 #endif    // #ifndef __PROCS_H__
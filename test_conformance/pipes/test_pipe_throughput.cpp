@@ -0,0 +1,434 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "harness/compat.h"
+#include "harness/benchmark.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "procs.h"
+
+// Packets per second through a pipe with the producer and the consumer
+// kernels enqueued on separate queues so they can run at the same time, for
+// read_pipe/write_pipe per work-item and for work-group and sub-group
+// reservations, over packet sizes and pipe depths. Every work-item makes a
+// fixed number of attempts and counts the ones that succeed, so the kernels
+// finish whether or not the device overlaps them; the log says whether it
+// did. Also gives the latency of handing a single packet from one
+// kernel to the other. A benchmark, so it only runs when named.
+
+static const char *kPacketTypes[] = { "uint", "uint4", "uint16" };
+static const size_t kPacketSizes[] = { 4, 16, 64 };
+static const cl_uint kPipeDepths[] = { 64, 1024, 16384 };
+static const size_t kLocalSize = 64;
+static const size_t kGroups = 64;
+static const int kAttempts = 256;
+
+enum PipeMode
+{
+    kItem,
+    kWorkGroup,
+    kSubGroup,
+    kModeCount
+};
+
+static const char *kModeNames[kModeCount] = { "item", "work_group",
+                                              "sub_group" };
+
+static const char *pipe_throughput_kernels = R"(
+    #define PRODUCER(name, RESERVE, COMMIT, SIZE, INDEX)                   \
+    __kernel void name(__write_only pipe T out_pipe,                       \
+                       __global uint *counts, int attempts)                \
+    {                                                                      \
+        uint written = 0;                                                  \
+        T value = (T)((uint)get_global_id(0));                             \
+        for (int i = 0; i < attempts; i++)                                 \
+        {                                                                  \
+            reserve_id_t id = RESERVE(out_pipe, SIZE);                     \
+            if (is_valid_reserve_id(id))                                   \
+            {                                                              \
+                write_pipe(out_pipe, id, INDEX, &value);                   \
+                COMMIT(out_pipe, id);                                      \
+                written++;                                                 \
+                value += (T)1;                                             \
+            }                                                              \
+        }                                                                  \
+        counts[get_global_id(0)] = written;                                \
+    }
+
+    #define CONSUMER(name, RESERVE, COMMIT, SIZE, INDEX)                   \
+    __kernel void name(__read_only pipe T in_pipe, __global uint *counts,  \
+                       __global T *sums, int attempts)                     \
+    {                                                                      \
+        uint received = 0;                                                 \
+        T value, sum = (T)0;                                               \
+        for (int i = 0; i < attempts; i++)                                 \
+        {                                                                  \
+            reserve_id_t id = RESERVE(in_pipe, SIZE);                      \
+            if (is_valid_reserve_id(id))                                   \
+            {                                                              \
+                read_pipe(in_pipe, id, INDEX, &value);                     \
+                COMMIT(in_pipe, id);                                       \
+                received++;                                                \
+                sum += value;                                              \
+            }                                                              \
+        }                                                                  \
+        counts[get_global_id(0)] = received;                               \
+        sums[get_global_id(0)] = sum;                                      \
+    }
+
+    __kernel void producer_item(__write_only pipe T out_pipe,
+                                __global uint *counts, int attempts)
+    {
+        uint written = 0;
+        T value = (T)((uint)get_global_id(0));
+        for (int i = 0; i < attempts; i++)
+        {
+            if (write_pipe(out_pipe, &value) == 0)
+            {
+                written++;
+                value += (T)1;
+            }
+        }
+        counts[get_global_id(0)] = written;
+    }
+
+    __kernel void consumer_item(__read_only pipe T in_pipe,
+                                __global uint *counts, __global T *sums,
+                                int attempts)
+    {
+        uint received = 0;
+        T value, sum = (T)0;
+        for (int i = 0; i < attempts; i++)
+        {
+            if (read_pipe(in_pipe, &value) == 0)
+            {
+                received++;
+                sum += value;
+            }
+        }
+        counts[get_global_id(0)] = received;
+        sums[get_global_id(0)] = sum;
+    }
+
+    PRODUCER(producer_work_group, work_group_reserve_write_pipe,
+             work_group_commit_write_pipe, get_local_size(0),
+             get_local_id(0))
+    CONSUMER(consumer_work_group, work_group_reserve_read_pipe,
+             work_group_commit_read_pipe, get_local_size(0),
+             get_local_id(0))
+
+    #ifdef SUB_GROUPS
+    #pragma OPENCL EXTENSION cl_khr_subgroups : enable
+    PRODUCER(producer_sub_group, sub_group_reserve_write_pipe,
+             sub_group_commit_write_pipe, get_sub_group_size(),
+             get_sub_group_local_id())
+    CONSUMER(consumer_sub_group, sub_group_reserve_read_pipe,
+             sub_group_commit_read_pipe, get_sub_group_size(),
+             get_sub_group_local_id())
+    #endif
+)";
+
+namespace {
+
+struct PipeBench
+{
+    cl_context context;
+    cl_command_queue producer_queue;
+    cl_command_queue consumer_queue;
+    clMemWrapper producer_counts;
+    clMemWrapper consumer_counts;
+    clMemWrapper sums;
+
+    // One producer and consumer run on a new pipe of depth packets. Gives
+    // the packets the consumer read, the time from the first kernel starting
+    // to the last one ending and whether the two kernels overlapped.
+    int Run(cl_kernel producer, cl_kernel consumer, size_t packet_size,
+            cl_uint depth, size_t global, size_t local, int attempts,
+            cl_ulong &packets, cl_ulong &ns, bool &overlapped)
+    {
+        cl_int error;
+        clMemWrapper pipe = clCreatePipe(context, CL_MEM_HOST_NO_ACCESS,
+                                         (cl_uint)packet_size, depth, NULL,
+                                         &error);
+        test_error(error, "clCreatePipe failed");
+
+        error = clSetKernelArg(producer, 0, sizeof(cl_mem), &pipe);
+        error |= clSetKernelArg(producer, 1, sizeof(cl_mem), &producer_counts);
+        error |= clSetKernelArg(producer, 2, sizeof(int), &attempts);
+        error |= clSetKernelArg(consumer, 0, sizeof(cl_mem), &pipe);
+        error |= clSetKernelArg(consumer, 1, sizeof(cl_mem), &consumer_counts);
+        error |= clSetKernelArg(consumer, 2, sizeof(cl_mem), &sums);
+        error |= clSetKernelArg(consumer, 3, sizeof(int), &attempts);
+        test_error(error, "clSetKernelArg failed");
+
+        clEventWrapper events[2];
+        error = clEnqueueNDRangeKernel(producer_queue, producer, 1, NULL,
+                                       &global, &local, 0, NULL, &events[0]);
+        test_error(error, "clEnqueueNDRangeKernel failed");
+        error = clEnqueueNDRangeKernel(consumer_queue, consumer, 1, NULL,
+                                       &global, &local, 0, NULL, &events[1]);
+        test_error(error, "clEnqueueNDRangeKernel failed");
+        error = clFlush(producer_queue);
+        test_error(error, "clFlush failed");
+        error = clFlush(consumer_queue);
+        test_error(error, "clFlush failed");
+        error = clWaitForEvents(2, &events[0]);
+        test_error(error, "clWaitForEvents failed");
+
+        cl_ulong start[2], end[2];
+        for (int i = 0; i < 2; i++)
+        {
+            error = clGetEventProfilingInfo(events[i],
+                                            CL_PROFILING_COMMAND_START,
+                                            sizeof(start[i]), &start[i], NULL);
+            test_error(error, "clGetEventProfilingInfo failed");
+            error = clGetEventProfilingInfo(events[i], CL_PROFILING_COMMAND_END,
+                                            sizeof(end[i]), &end[i], NULL);
+            test_error(error, "clGetEventProfilingInfo failed");
+        }
+        ns = std::max(end[0], end[1]) - std::min(start[0], start[1]);
+        overlapped = start[0] < end[1] && start[1] < end[0];
+
+        std::vector<cl_uint> counts(global);
+        error = clEnqueueReadBuffer(consumer_queue, consumer_counts, CL_TRUE,
+                                    0, global * sizeof(cl_uint), counts.data(),
+                                    0, NULL, NULL);
+        test_error(error, "clEnqueueReadBuffer failed");
+        packets = 0;
+        for (cl_uint count : counts) packets += count;
+        return CL_SUCCESS;
+    }
+
+    // Time of handing one packet from a single work-item producer to a
+    // single work-item consumer that waits for it on the other queue, from
+    // the producer starting to the consumer ending
+    int Handoff(cl_kernel producer, cl_kernel consumer, size_t packet_size,
+                double *us)
+    {
+        cl_int error;
+        clMemWrapper pipe = clCreatePipe(context, CL_MEM_HOST_NO_ACCESS,
+                                         (cl_uint)packet_size, 1, NULL,
+                                         &error);
+        test_error(error, "clCreatePipe failed");
+
+        int attempts = 1;
+        error = clSetKernelArg(producer, 0, sizeof(cl_mem), &pipe);
+        error |= clSetKernelArg(producer, 1, sizeof(cl_mem), &producer_counts);
+        error |= clSetKernelArg(producer, 2, sizeof(int), &attempts);
+        error |= clSetKernelArg(consumer, 0, sizeof(cl_mem), &pipe);
+        error |= clSetKernelArg(consumer, 1, sizeof(cl_mem), &consumer_counts);
+        error |= clSetKernelArg(consumer, 2, sizeof(cl_mem), &sums);
+        error |= clSetKernelArg(consumer, 3, sizeof(int), &attempts);
+        test_error(error, "clSetKernelArg failed");
+
+        size_t one = 1;
+        clEventWrapper events[2];
+        error = clEnqueueNDRangeKernel(producer_queue, producer, 1, NULL, &one,
+                                       &one, 0, NULL, &events[0]);
+        test_error(error, "clEnqueueNDRangeKernel failed");
+        error = clEnqueueNDRangeKernel(consumer_queue, consumer, 1, NULL, &one,
+                                       &one, 1, &events[0], &events[1]);
+        test_error(error, "clEnqueueNDRangeKernel failed");
+        error = clFlush(producer_queue);
+        test_error(error, "clFlush failed");
+        error = clWaitForEvents(1, &events[1]);
+        test_error(error, "clWaitForEvents failed");
+
+        cl_ulong start, end;
+        error = clGetEventProfilingInfo(events[0], CL_PROFILING_COMMAND_START,
+                                        sizeof(start), &start, NULL);
+        test_error(error, "clGetEventProfilingInfo failed");
+        error = clGetEventProfilingInfo(events[1], CL_PROFILING_COMMAND_END,
+                                        sizeof(end), &end, NULL);
+        test_error(error, "clGetEventProfilingInfo failed");
+
+        cl_uint read;
+        error = clEnqueueReadBuffer(consumer_queue, consumer_counts, CL_TRUE,
+                                    0, sizeof(read), &read, 0, NULL, NULL);
+        test_error(error, "clEnqueueReadBuffer failed");
+        if (read != 1)
+        {
+            log_error("ERROR: The consumer read %u packets instead of 1\n",
+                      read);
+            return TEST_FAIL;
+        }
+        *us = end > start ? (end - start) / 1000.0 : 0.0;
+        return CL_SUCCESS;
+    }
+};
+
+} // anonymous namespace
+
+int test_pipe_throughput(cl_device_id deviceID, cl_context context,
+                         cl_command_queue queue, int num_elements)
+{
+    cl_uint max_packet_size;
+    cl_int error = clGetDeviceInfo(deviceID, CL_DEVICE_PIPE_MAX_PACKET_SIZE,
+                                   sizeof(max_packet_size), &max_packet_size,
+                                   NULL);
+    test_error(error, "Unable to get CL_DEVICE_PIPE_MAX_PACKET_SIZE");
+    bool sub_groups = is_extension_available(deviceID, "cl_khr_subgroups");
+    if (!sub_groups)
+        log_info("cl_khr_subgroups is not supported, skipping the sub-group "
+                 "reservations.\n");
+
+    PipeBench bench;
+    bench.context = context;
+    clCommandQueueWrapper producer_queue = clCreateCommandQueue(
+        context, deviceID, CL_QUEUE_PROFILING_ENABLE, &error);
+    test_error(error, "Unable to create the producer queue");
+    clCommandQueueWrapper consumer_queue = clCreateCommandQueue(
+        context, deviceID, CL_QUEUE_PROFILING_ENABLE, &error);
+    test_error(error, "Unable to create the consumer queue");
+    bench.producer_queue = producer_queue;
+    bench.consumer_queue = consumer_queue;
+
+    size_t max_items = kLocalSize * kGroups;
+    size_t max_packet = kPacketSizes[ARRAY_SIZE(kPacketSizes) - 1];
+    bench.producer_counts = clCreateBuffer(
+        context, CL_MEM_READ_WRITE, max_items * sizeof(cl_uint), NULL, &error);
+    test_error(error, "clCreateBuffer failed");
+    bench.consumer_counts = clCreateBuffer(
+        context, CL_MEM_READ_WRITE, max_items * sizeof(cl_uint), NULL, &error);
+    test_error(error, "clCreateBuffer failed");
+    bench.sums = clCreateBuffer(context, CL_MEM_READ_WRITE,
+                                max_items * max_packet, NULL, &error);
+    test_error(error, "clCreateBuffer failed");
+
+    BenchmarkOptions bench_options;
+    bench_options.warmup = 1;
+    bench_options.maxSeconds = 1.0;
+
+    log_benchmark_header("pipe_throughput", "mode/type/packet_bytes/depth");
+    log_benchmark_header("pipe_handoff", "type/packet_bytes");
+
+    for (size_t t = 0; t < ARRAY_SIZE(kPacketTypes); t++)
+    {
+        size_t packet_size = kPacketSizes[t];
+        if (packet_size > max_packet_size)
+        {
+            log_info("Packets of %zu bytes are larger than "
+                     "CL_DEVICE_PIPE_MAX_PACKET_SIZE, skipping.\n",
+                     packet_size);
+            continue;
+        }
+
+        std::string options = std::string("-DT=") + kPacketTypes[t];
+        if (sub_groups) options += " -DSUB_GROUPS";
+        clProgramWrapper program;
+        clKernelWrapper kernels[kModeCount][2];
+        error = create_single_kernel_helper(context, &program, &kernels[0][0],
+                                            1, &pipe_throughput_kernels,
+                                            "producer_item", options.c_str());
+        test_error(error, "Unable to create the pipe throughput kernels");
+
+        int modes = sub_groups ? kModeCount : kSubGroup;
+        size_t local = kLocalSize;
+        for (int m = 0; m < modes; m++)
+        {
+            std::string producer = std::string("producer_") + kModeNames[m];
+            std::string consumer = std::string("consumer_") + kModeNames[m];
+            if (m != kItem)
+            {
+                kernels[m][0] =
+                    clCreateKernel(program, producer.c_str(), &error);
+                test_error(error, "clCreateKernel failed");
+            }
+            kernels[m][1] = clCreateKernel(program, consumer.c_str(), &error);
+            test_error(error, "clCreateKernel failed");
+
+            for (int k = 0; k < 2; k++)
+            {
+                size_t kernel_wg_size;
+                error = clGetKernelWorkGroupInfo(
+                    kernels[m][k], deviceID, CL_KERNEL_WORK_GROUP_SIZE,
+                    sizeof(kernel_wg_size), &kernel_wg_size, NULL);
+                test_error(error, "clGetKernelWorkGroupInfo failed");
+                local = std::min(local, kernel_wg_size);
+            }
+        }
+        size_t global = local * kGroups;
+
+        for (int m = 0; m < modes; m++)
+        {
+            for (cl_uint depth : kPipeDepths)
+            {
+                cl_ulong packets = 0;
+                bool overlapped = true;
+                BenchmarkStats stats;
+                error = run_benchmark(
+                    bench_options,
+                    [&](double *rate) {
+                        cl_ulong run_packets, ns;
+                        bool run_overlapped;
+                        int err = bench.Run(kernels[m][0], kernels[m][1],
+                                            packet_size, depth, global, local,
+                                            kAttempts, run_packets, ns,
+                                            run_overlapped);
+                        // Packets per microsecond is Mpackets/s
+                        *rate = ns ? 1e3 * run_packets / ns : 0.0;
+                        packets = std::max(packets, run_packets);
+                        overlapped = overlapped && run_overlapped;
+                        return (cl_int)err;
+                    },
+                    &stats);
+                if (error != CL_SUCCESS)
+                {
+                    log_error("ERROR: Unable to measure %s pipes of %s\n",
+                              kModeNames[m], kPacketTypes[t]);
+                    return TEST_FAIL;
+                }
+
+                std::string label = std::string(kModeNames[m]) + "/"
+                    + kPacketTypes[t] + "/" + std::to_string(packet_size) + "/"
+                    + std::to_string(depth);
+                log_benchmark_stats("pipe_throughput", label.c_str(),
+                                    "Mpackets/s", true, stats);
+                log_info("%s: at most %llu packets a run, %.3f GB/s, the "
+                         "kernels %s\n",
+                         label.c_str(), (unsigned long long)packets,
+                         stats.median * packet_size / 1e3,
+                         overlapped ? "overlapped" : "did not overlap");
+            }
+        }
+
+        BenchmarkStats stats;
+        error = run_benchmark(
+            bench_options,
+            [&](double *us) {
+                return (cl_int)bench.Handoff(kernels[kItem][0],
+                                             kernels[kItem][1], packet_size,
+                                             us);
+            },
+            &stats);
+        if (error != CL_SUCCESS)
+        {
+            log_error("ERROR: Unable to measure the handoff of %s packets\n",
+                      kPacketTypes[t]);
+            return TEST_FAIL;
+        }
+        std::string label =
+            std::string(kPacketTypes[t]) + "/" + std::to_string(packet_size);
+        log_benchmark_stats("pipe_handoff", label.c_str(), "us", false, stats);
+    }
+
+    return 0;
+}
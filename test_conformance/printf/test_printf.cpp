@@ -16,10 +16,14 @@
 #include "harness/os_helpers.h"
 #include "harness/typeWrappers.h"
 
+#include <algorithm>
 #include <cstdarg>
 #include <string.h>
 #include <errno.h>
+#include <functional>
 #include <memory>
+#include <string>
+#include <thread>
 
 #if ! defined( _WIN32)
 #if defined(__APPLE__)
@@ -28,6 +32,7 @@
 #include <unistd.h>
 #define streamDup(fd1) dup(fd1)
 #define streamDup2(fd1,fd2) dup2(fd1,fd2)
+#define streamPipe(fds) pipe(fds)
 #endif
 #include <limits.h>
 #include <time.h>
@@ -35,14 +40,17 @@
 
 #if defined(_WIN32)
 #include <io.h>
+#include <fcntl.h>
 #define streamDup(fd1) _dup(fd1)
 #define streamDup2(fd1,fd2) _dup2(fd1,fd2)
+#define streamPipe(fds) _pipe(fds, 4096, _O_BINARY)
 #endif
 
 #include "harness/testHarness.h"
 #include "harness/errorHelpers.h"
 #include "harness/kernelHelpers.h"
 #include "harness/parseParameters.h"
+#include "harness/benchmark.h"
 
 #include <CL/cl_ext.h>
 
@@ -59,11 +67,13 @@ static void printUsage( void );
 
 //Stream helper functions
 
-//Associate stdout stream with the file(gFileName):i.e redirect stdout stream to the specific files (gFileName)
-static int acquireOutputStream(int* error);
+// Redirect stdout into a pipe that is drained by a reader thread. If onLine is
+// set, it is called on that thread for each complete line as it arrives.
+static int acquireOutputStream(
+    std::function<void(const char*, size_t)> onLine = nullptr);
 
-//Close the file(gFileName) associated with the stdout stream and disassociates it.
-static void releaseOutputStream(int fd);
+// Restore stdout and wait for the reader thread to drain the pipe.
+static void releaseOutputStream();
 
 //Get analysis buffer to verify the correctess of printed data
 static void getAnalysisBuffer(char* analysisBuffer);
@@ -90,6 +100,12 @@ makePrintfProgram(cl_kernel* kernel_ptr, const cl_context context,
 static int doTest(cl_command_queue queue, cl_context context,
                   const unsigned int testId, cl_device_id device);
 
+// Times a passing subtest's kernel over many work-items, checking each line
+static int benchPrintf(cl_command_queue queue, cl_kernel kernel,
+                       cl_device_id device, const unsigned int testId,
+                       const unsigned int testNum,
+                       const unsigned int formatNum);
+
 // Check if device supports long
 static bool isLongSupported(cl_device_id  device_id);
 
@@ -114,9 +130,86 @@ int s_test_skip = 0;
 
 static cl_context        gContext;
 static cl_command_queue  gQueue;
-static int               gFd;
 
-static char gFileName[256];
+//-----------------------------------------
+// OutputCapture
+//-----------------------------------------
+class OutputCapture {
+public:
+    int start(std::function<void(const char*, size_t)> onLine)
+    {
+        int fds[2];
+        fflush(stdout);
+        if (streamPipe(fds)) return -1;
+
+        _savedFd = streamDup(fileno(stdout));
+        if (_savedFd < 0 || streamDup2(fds[1], fileno(stdout)) < 0)
+        {
+            if (_savedFd >= 0) close(_savedFd);
+            close(fds[0]);
+            close(fds[1]);
+            return -1;
+        }
+        close(fds[1]);
+
+        _readFd = fds[0];
+        _text.clear();
+        _onLine = onLine;
+        _reader = std::thread(&OutputCapture::drain, this);
+        return 0;
+    }
+
+    void stop()
+    {
+        // Closing the last write end lets the reader see the end of the pipe
+        fflush(stdout);
+        streamDup2(_savedFd, fileno(stdout));
+        close(_savedFd);
+        _reader.join();
+        close(_readFd);
+    }
+
+    // Everything captured, when no line callback was given
+    const std::string& text() const { return _text; }
+
+private:
+    void drain()
+    {
+        char buf[4096];
+        std::string pending;
+        for (;;)
+        {
+            int n = (int)read(_readFd, buf, sizeof(buf));
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break;
+
+            if (!_onLine)
+            {
+                _text.append(buf, n);
+                continue;
+            }
+
+            pending.append(buf, n);
+            size_t begin = 0, end;
+            while ((end = pending.find('\n', begin)) != std::string::npos)
+            {
+                _onLine(pending.data() + begin, end + 1 - begin);
+                begin = end + 1;
+            }
+            pending.erase(0, begin);
+        }
+        if (_onLine && !pending.empty())
+            _onLine(pending.data(), pending.size());
+    }
+
+    int _savedFd = -1;
+    int _readFd = -1;
+    std::thread _reader;
+    std::string _text;
+    std::function<void(const char*, size_t)> _onLine;
+};
+
+static OutputCapture gCapture;
 
 //-----------------------------------------
 // Static helper functions definition
@@ -125,27 +218,16 @@ static char gFileName[256];
 //-----------------------------------------
 // acquireOutputStream
 //-----------------------------------------
-static int acquireOutputStream(int* error)
+static int acquireOutputStream(
+    std::function<void(const char*, size_t)> onLine)
 {
-    int fd = streamDup(fileno(stdout));
-    *error = 0;
-    if (!freopen(gFileName, "w", stdout))
-    {
-        releaseOutputStream(fd);
-        *error = -1;
-    }
-    return fd;
+    return gCapture.start(onLine);
 }
 
 //-----------------------------------------
 // releaseOutputStream
 //-----------------------------------------
-static void releaseOutputStream(int fd)
-{
-    fflush(stdout);
-    streamDup2(fd,fileno(stdout));
-    close(fd);
-}
+static void releaseOutputStream() { gCapture.stop(); }
 
 //-----------------------------------------
 // printfCallBack
@@ -160,18 +242,14 @@ static void CL_CALLBACK printfCallBack(const char *printf_data, size_t len, size
 //-----------------------------------------
 static void getAnalysisBuffer(char* analysisBuffer)
 {
-    FILE *fp;
+    const std::string& text = gCapture.text();
     memset(analysisBuffer,0,ANALYSIS_BUFFER_SIZE);
 
-    fp = fopen(gFileName, "r");
-    if (NULL == fp)
-        log_error("Failed to open analysis buffer ('%s')\n", strerror(errno));
-    else if (0
-             == std::fread(analysisBuffer, sizeof(analysisBuffer[0]),
-                           ANALYSIS_BUFFER_SIZE, fp))
+    if (text.empty())
         log_error("No data read from analysis buffer\n");
-
-    fclose(fp);
+    else
+        memcpy(analysisBuffer, text.data(),
+               std::min(text.size(), (size_t)ANALYSIS_BUFFER_SIZE - 1));
 }
 
 //-----------------------------------------
@@ -590,7 +668,6 @@ static int doTest(cl_command_queue queue, cl_context context,
             char _analysisBuffer[ANALYSIS_BUFFER_SIZE];
             cl_uint out32 = 0;
             cl_ulong out64 = 0;
-            int fd = -1;
 
             // Define an index space (global work size) of threads for
             // execution.
@@ -645,7 +722,7 @@ static int doTest(cl_command_queue queue, cl_context context,
                 }
             }
 
-            fd = acquireOutputStream(&err);
+            err = acquireOutputStream();
             if (err != 0)
             {
                 subtest_fail("Error while redirection stdout to file");
@@ -657,7 +734,7 @@ static int doTest(cl_command_queue queue, cl_context context,
                                          NULL, 0, NULL, &ndrEvt);
             if (err != CL_SUCCESS)
             {
-                releaseOutputStream(fd);
+                releaseOutputStream();
                 subtest_fail("\n clEnqueueNDRangeKernel failed errcode:%d\n",
                              err);
                 continue;
@@ -667,7 +744,7 @@ static int doTest(cl_command_queue queue, cl_context context,
             err = clFlush(queue);
             if (err != CL_SUCCESS)
             {
-                releaseOutputStream(fd);
+                releaseOutputStream();
                 subtest_fail("clFlush failed : %d\n", err);
                 continue;
             }
@@ -675,7 +752,7 @@ static int doTest(cl_command_queue queue, cl_context context,
             // printed from the kernel is immediately printed
             err = waitForEvent(&ndrEvt);
 
-            releaseOutputStream(fd);
+            releaseOutputStream();
 
             if (err != CL_SUCCESS)
             {
@@ -726,6 +803,15 @@ static int doTest(cl_command_queue queue, cl_context context,
                     continue;
                 }
             }
+
+            if (gBench && allTestCase[testId]->_type != TYPE_ADDRESS_SPACE
+                && 0
+                    != benchPrintf(queue, kernel, device, testId, testNum,
+                                   formatNum))
+            {
+                subtest_fail("benchPrintf failed\n");
+                continue;
+            }
         }
         ++s_test_cnt;
     }
@@ -736,6 +822,86 @@ static int doTest(cl_command_queue queue, cl_context context,
     return s_test_fail - fail_count;
 }
 
+//-----------------------------------------
+// benchPrintf
+//-----------------------------------------
+extern test_definition test_list[];
+
+static int benchPrintf(cl_command_queue queue, cl_kernel kernel,
+                       cl_device_id device, const unsigned int testId,
+                       const unsigned int testNum,
+                       const unsigned int formatNum)
+{
+    const printDataGenParameters& params =
+        allTestCase[testId]->_genParameters[testNum];
+    size_t printfBufferSize = 0;
+    cl_int err;
+
+    err = clGetDeviceInfo(device, CL_DEVICE_PRINTF_BUFFER_SIZE,
+                          sizeof(printfBufferSize), &printfBufferSize, NULL);
+    checkErr(err, "clGetDeviceInfo");
+
+    // Keep the output well within the printf buffer
+    size_t globalWorkSize[1] = { std::min(
+        (size_t)4096,
+        std::max((size_t)1, printfBufferSize / (2 * ANALYSIS_BUFFER_SIZE))) };
+
+    BenchmarkOptions options;
+    options.warmup = 1;
+    options.maxSeconds = 1.0;
+    BenchmarkStats stats;
+    err = run_benchmark(
+        options,
+        [&](double* us) {
+            // Lines are checked on the reader thread while the kernel runs
+            size_t lines = 0, mismatches = 0;
+            cl_int error = acquireOutputStream([&](const char* line,
+                                                   size_t len) {
+                char analysisBuffer[ANALYSIS_BUFFER_SIZE] = { 0 };
+                memcpy(analysisBuffer, line,
+                       std::min(len, (size_t)ANALYSIS_BUFFER_SIZE - 1));
+                ++lines;
+                if (verifyOutputBuffer(analysisBuffer, allTestCase[testId],
+                                       testNum))
+                    ++mismatches;
+            });
+            if (error != 0)
+            {
+                log_error("Error while redirection stdout to file");
+                return -1;
+            }
+
+            HostTimer timer;
+            cl_event ndrEvt;
+            error = clEnqueueNDRangeKernel(queue, kernel, 1, NULL,
+                                           globalWorkSize, NULL, 0, NULL,
+                                           &ndrEvt);
+            if (error == CL_SUCCESS) error = waitForEvent(&ndrEvt);
+            releaseOutputStream();
+            *us = timer.elapsed_us();
+            test_error(error, "clEnqueueNDRangeKernel failed");
+
+            if (lines != globalWorkSize[0] || mismatches != 0)
+            {
+                log_error("printf benchmark: %zu of %zu lines, %zu wrong\n",
+                          lines, globalWorkSize[0], mismatches);
+                return -1;
+            }
+            return CL_SUCCESS;
+        },
+        &stats);
+    if (err != CL_SUCCESS) return -1;
+
+    std::string format = allTestCase[testId]->_type == TYPE_VECTOR
+        ? std::string(params.vectorFormatFlag) + "v" + params.vectorSize
+            + params.vectorFormatSpecifier
+        : params.genericFormats[formatNum];
+    std::string label = std::string(test_list[testId].name) + "/" + format
+        + "/" + std::to_string(globalWorkSize[0]);
+    log_benchmark_stats("printf", label.c_str(), "us", false, stats);
+    return 0;
+}
+
 int test_int(cl_device_id deviceID, cl_context context, cl_command_queue queue,
              int num_elements)
 {
@@ -899,19 +1065,8 @@ int main(int argc, const char* argv[])
         }
     }
 
-    char* pcTempFname = get_temp_filename();
-    if (pcTempFname != nullptr)
-    {
-        strncpy(gFileName, pcTempFname, sizeof(gFileName));
-    }
-
-    free(pcTempFname);
-
-    if (strlen(gFileName) == 0)
-    {
-        log_error("get_temp_filename failed\n");
-        return -1;
-    }
+    if (gBench)
+        log_benchmark_header("printf", "test/format/lines");
 
     int err = runTestHarnessWithCheck( argCount, argList, test_num, test_list, true, 0, InitCL );
 
@@ -930,7 +1085,6 @@ int main(int argc, const char* argv[])
 
 
     free(argList);
-    remove(gFileName);
     return err;
 }
 
@@ -939,8 +1093,9 @@ int main(int argc, const char* argv[])
 //-----------------------------------------
 static void printUsage( void )
 {
-    log_info("test_printf: <optional: testnames> \n");
+    log_info("test_printf: <optional: -bench> <optional: testnames> \n");
     log_info("\tdefault is to run the full test on the default device\n");
+    log_info("\t-bench\tAlso time each passing subtest with many work-items\n");
     log_info("\n");
     for( int i = 0; i < test_num; i++ )
     {
@@ -954,7 +1109,7 @@ test_status InitCL( cl_device_id device )
     uint32_t compute_devices = 0;
 
     int err;
-    gFd = acquireOutputStream(&err);
+    err = acquireOutputStream();
     if (err != 0)
     {
         log_error("Error while redirection stdout to file");
@@ -971,7 +1126,7 @@ test_status InitCL( cl_device_id device )
     if((err = clGetDeviceInfo(device, CL_DEVICE_MAX_CLOCK_FREQUENCY, config_size, &device_frequency, NULL )))
         device_frequency = 1;
 
-    releaseOutputStream(gFd);
+    releaseOutputStream();
 
     log_info( "\nCompute Device info:\n" );
     log_info( "\tProcessing with %d devices\n", compute_devices );
@@ -991,7 +1146,7 @@ test_status InitCL( cl_device_id device )
         return TEST_SKIP;
     }
 
-    gFd = acquireOutputStream(&err);
+    err = acquireOutputStream();
     if (err != 0)
     {
         log_error("Error while redirection stdout to file");
@@ -1015,7 +1170,7 @@ test_status InitCL( cl_device_id device )
     gQueue = clCreateCommandQueue(gContext, device, 0, NULL);
     checkNull(gQueue, "clCreateCommandQueue");
 
-    releaseOutputStream(gFd);
+    releaseOutputStream();
 
     if (is_extension_available(device, "cl_khr_fp16"))
     {
@@ -225,6 +225,14 @@ static int copy_size( cl_device_id device, cl_context context, cl_command_queue
         err = 0;
     }
 
+    std::string label = "copy_" + std::to_string(num_elements);
+    if (sample_stage_latencies(label, [&](cl_event *event) {
+            return clEnqueueCopyBuffer(queue, streams[0], streams[1], 0, 0,
+                                       sizeof(cl_int) * num_elements, 0, NULL,
+                                       event);
+        }))
+        err = -1;
+
     // cleanup
     clReleaseEvent(copyEvent);
     clReleaseMemObject( streams[0] );
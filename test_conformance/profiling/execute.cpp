@@ -312,6 +312,21 @@ static int kernelFilter( cl_device_id device, cl_context context, cl_command_que
         return -1;
     }
 
+    // Run the kernel again to see how long it spends in each stage
+    err = sample_stage_latencies("execute", [&](cl_event *event) {
+        return clEnqueueNDRangeKernel(queue, kernel[0], 2, NULL, threads, NULL,
+                                      0, NULL, event);
+    });
+    if( err != CL_SUCCESS ){
+    clReleaseEvent( executeEvent );
+        clReleaseKernel( kernel[0] );
+        clReleaseProgram( program[0] );
+        clReleaseMemObject( memobjs[2] );
+        clReleaseMemObject( memobjs[1] );
+        clReleaseMemObject( memobjs[0] );
+        return -1;
+    }
+
     // read output image
     size_t origin[3] = { 0, 0, 0 };
     size_t region[3] = { w, h, 1 };
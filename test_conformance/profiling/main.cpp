@@ -18,8 +18,12 @@
 #include <stdio.h>
 #include <string.h>
 #include <cinttypes>
+#include <algorithm>
+#include <vector>
 #include "procs.h"
+#include "harness/perfMetrics.h"
 #include "harness/testHarness.h"
+#include "harness/typeWrappers.h"
 
 // FIXME: To use certain functions in harness/imageHelpers.h
 // (for example, generate_random_image_data()), the tests are required to declare
@@ -130,9 +134,100 @@ int check_times(cl_ulong queueStart, cl_ulong commandSubmit, cl_ulong commandSta
   return err;
 }
 
+int gLatencySamples = 0;
+
+int sample_stage_latencies(const std::string &label,
+                           const std::function<cl_int(cl_event *)> &enqueue)
+{
+    if (gLatencySamples <= 0) return 0;
+
+    static const char *stageNames[] = { "queued_to_submit", "submit_to_start",
+                                        "start_to_end", "end_to_complete" };
+    const cl_profiling_info params[] = {
+        CL_PROFILING_COMMAND_QUEUED, CL_PROFILING_COMMAND_SUBMIT,
+        CL_PROFILING_COMMAND_START, CL_PROFILING_COMMAND_END,
+        CL_PROFILING_COMMAND_COMPLETE
+    };
+    static const char *paramNames[] = {
+        "CL_PROFILING_COMMAND_QUEUED", "CL_PROFILING_COMMAND_SUBMIT",
+        "CL_PROFILING_COMMAND_START", "CL_PROFILING_COMMAND_END",
+        "CL_PROFILING_COMMAND_COMPLETE"
+    };
+    std::vector<cl_ulong> deltas[4];
+    // CL_PROFILING_COMMAND_COMPLETE is new in OpenCL 2.0
+    bool haveComplete = true;
+
+    for (int sample = 0; sample < gLatencySamples; sample++)
+    {
+        clEventWrapper event;
+        cl_int err = enqueue(&event);
+        test_error(err, "Unable to enqueue the command to sample");
+        err = clWaitForEvents(1, &event);
+        test_error(err, "clWaitForEvents failed");
+
+        cl_ulong times[5];
+        for (int i = 0; i < 4; i++)
+        {
+            err = clGetEventProfilingInfo(event, params[i], sizeof(cl_ulong),
+                                          &times[i], NULL);
+            test_error(err, "clGetEventProfilingInfo failed");
+        }
+        haveComplete = haveComplete
+            && clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_COMPLETE,
+                                       sizeof(cl_ulong), &times[4], NULL)
+                == CL_SUCCESS;
+
+        int stages = haveComplete ? 4 : 3;
+        for (int i = 0; i < stages; i++)
+        {
+            if (times[i + 1] < times[i])
+            {
+                log_error("%s > %s in sample %d of %s.\n", paramNames[i],
+                          paramNames[i + 1], sample, label.c_str());
+                return -1;
+            }
+            deltas[i].push_back(times[i + 1] - times[i]);
+        }
+    }
+
+    log_info("%s profiling stage latencies over %d samples (ns):\n",
+             label.c_str(), gLatencySamples);
+    int stages = haveComplete ? 4 : 3;
+    for (int i = 0; i < stages; i++)
+    {
+        std::vector<cl_ulong> &d = deltas[i];
+        std::sort(d.begin(), d.end());
+        const int percentiles[] = { 50, 95, 99 };
+        double values[3];
+        for (int p = 0; p < 3; p++)
+        {
+            // Nearest rank
+            size_t rank = (d.size() * percentiles[p] + 99) / 100;
+            values[p] = (double)d[rank > 0 ? rank - 1 : 0];
+            record_perf_metric(label + "_" + stageNames[i] + "_p"
+                                   + std::to_string(percentiles[p]),
+                               values[p], "ns", false);
+        }
+        log_info("\t%-16s p50 %.0f p95 %.0f p99 %.0f\n", stageNames[i],
+                 values[0], values[1], values[2]);
+    }
+    return 0;
+}
+
 int main( int argc, const char *argv[] )
 {
-    return runTestHarness(argc, argv, test_num, test_list, false,
-                          CL_QUEUE_PROFILING_ENABLE);
+    std::vector<const char *> argList;
+    for (int i = 0; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-latency") == 0 && i + 1 < argc)
+        {
+            gLatencySamples = atoi(argv[++i]);
+            continue;
+        }
+        argList.push_back(argv[i]);
+    }
+
+    return runTestHarness((int)argList.size(), argList.data(), test_num,
+                          test_list, false, CL_QUEUE_PROFILING_ENABLE);
 }
 
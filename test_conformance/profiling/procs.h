@@ -21,9 +21,25 @@
 #include "harness/imageHelpers.h"
 #include "harness/mt19937.h"
 
+#include <functional>
+#include <string>
+
 
 extern int check_times(cl_ulong queueStart, cl_ulong submitStart, cl_ulong commandStart, cl_ulong commandEnd, cl_device_id device);
 
+// Number of times sample_stage_latencies repeats a command, set with
+// -latency <n>. No samples are taken by default.
+extern int gLatencySamples;
+
+// Run the command enqueue gives the event of gLatencySamples times, check
+// the order of its profiling times each time, and record the 50th, 95th and
+// 99th percentiles of the time spent from queued to submit, submit to start,
+// start to end and, where the device reports it, end to complete as the
+// metrics label_<stage>_p<n>.
+extern int
+sample_stage_latencies(const std::string &label,
+                       const std::function<cl_int(cl_event *)> &enqueue);
+
 extern int        test_read_array_int( cl_device_id device, cl_context context, cl_command_queue queue, int num_elements );
 extern int        test_read_array_uint( cl_device_id device, cl_context context, cl_command_queue queue, int num_elements );
 extern int        test_read_array_long( cl_device_id device, cl_context context, cl_command_queue queue, int num_elements );
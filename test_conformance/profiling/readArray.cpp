@@ -745,6 +745,15 @@ int test_stream_read( cl_device_id device, cl_context context, cl_command_queue
     if (check_times(queueStart, submitStart, readStart, readEnd, device))
       err_count++;
 
+        std::string label =
+            std::string("read_") + type + std::to_string(1 << i);
+        if (sample_stage_latencies(label, [&](cl_event *event) {
+                return clEnqueueReadBuffer(queue, streams[i], false, 0,
+                                           ptrSizes[i] * num_elements,
+                                           outptr[i], 0, NULL, event);
+            }))
+            err_count++;
+
         // cleanup
         clReleaseEvent(readEvent);
         clReleaseKernel( kernel[i] );
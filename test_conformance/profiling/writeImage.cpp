@@ -619,6 +619,12 @@ int write_image( cl_device_id device, cl_context context, cl_command_queue queue
         log_info( "Image verified.\n" );
     }
 
+    if (sample_stage_latencies("write_image", [&](cl_event *event) {
+            return clEnqueueWriteImage(queue, memobjs[0], false, origin,
+                                       region, 0, 0, inptr, 0, NULL, event);
+        }))
+        err = -1;
+
     // cleanup
   clReleaseEvent(writeEvent);
     clReleaseKernel( kernel[0] );
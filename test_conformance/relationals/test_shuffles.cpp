@@ -15,6 +15,8 @@
 //
 
 #include <iomanip>
+#include <string>
+#include <vector>
 
 #include "testBase.h"
 #include "harness/conversions.h"
@@ -26,6 +28,8 @@
 #define NUM_TESTS 32
 // The number of times to run each combination of shuffles
 #define NUM_ITERATIONS_PER_TEST 2
+// The number of shuffles to run through a runtime mask per combination
+#define NUM_RUNTIME_MASK_TESTS 1024
 #define MAX_PROGRAM_SIZE NUM_TESTS*1024
 #define PRINT_SHUFFLE_KERNEL_SOURCE 0
 #define SPEW_ORDER_DETAILS 0
@@ -838,6 +842,189 @@ protected:
 };
 
 
+// The built-in shuffle functions take their mask at runtime, so one program
+// per type holds a kernel for every pair of vector sizes, and each work item
+// shuffles its own source with its own mask read from a buffer.
+static const char *shuffleRuntimeMaskPattern =
+    "__kernel void shuffle_mask_%d_%d( __global %s%d *source, %s"
+    "__global %s%s%d *mask, __global %s%d *dest )\n"
+    "{\n"
+    "    size_t i = get_global_id(0);\n"
+    "    dest[i] = %s;\n"
+    "}\n";
+
+static const unsigned int runtimeMaskVecSizes[] = { 2, 4, 8, 16, 0 };
+
+static int create_runtime_mask_program(cl_context context,
+                                       cl_program *outProgram,
+                                       ExplicitType vecType,
+                                       ShuffleMode shuffleMode)
+{
+    const char *typeName = get_explicit_type_name(vecType);
+    ExplicitType maskType = vecType;
+    if (maskType == kFloat) maskType = kUInt;
+    if (maskType == kDouble) maskType = kULong;
+    const char *maskTypeName = get_explicit_type_name(maskType);
+    const char *maskPrefix = (maskTypeName[0] == 'u') ? "" : "u";
+    bool dual = (shuffleMode == kBuiltInDualInputFnMode);
+
+    std::string source;
+    if (vecType == kDouble)
+        source += "#pragma OPENCL EXTENSION cl_khr_fp64 : enable\n";
+
+    for (const unsigned int *in = runtimeMaskVecSizes; *in != 0; in++)
+    {
+        for (const unsigned int *out = runtimeMaskVecSizes; *out != 0; out++)
+        {
+            char secondParam[64] = "";
+            if (dual)
+                sprintf(secondParam, "__global %s%d *secondSource, ",
+                        typeName, *in);
+
+            char kernel[1024];
+            sprintf(kernel, shuffleRuntimeMaskPattern, *in, *out, typeName,
+                    *in, secondParam, maskPrefix, maskTypeName, *out,
+                    typeName, *out,
+                    dual ? "shuffle2( source[i], secondSource[i], mask[i] )"
+                         : "shuffle( source[i], mask[i] )");
+            source += kernel;
+        }
+    }
+
+    if (PRINT_SHUFFLE_KERNEL_SOURCE)
+        log_info("Kernel:%s\n", source.c_str());
+
+    const char *programPtr = source.c_str();
+    int error = create_single_kernel_helper_create_program(context, outProgram,
+                                                           1, &programPtr);
+    test_error(error, "Unable to create runtime mask program");
+
+    error = clBuildProgram(*outProgram, 0, NULL, NULL, NULL, NULL);
+    test_error(error, "Unable to build runtime mask program");
+    return CL_SUCCESS;
+}
+
+static void store_mask_element(unsigned char *mask, size_t index,
+                               size_t typeSize, unsigned char value)
+{
+    switch (typeSize)
+    {
+        case 1: ((cl_uchar *)mask)[index] = value; break;
+        case 2: ((cl_ushort *)mask)[index] = value; break;
+        case 4: ((cl_uint *)mask)[index] = value; break;
+        case 8: ((cl_ulong *)mask)[index] = value; break;
+    }
+}
+
+int test_shuffle_runtime_mask(cl_context context, cl_command_queue queue,
+                              cl_program program, ExplicitType vecType,
+                              size_t inVecSize, size_t outVecSize,
+                              size_t numOrders, ShuffleOrder *orders,
+                              MTdata d, ShuffleMode shuffleMode)
+{
+    clKernelWrapper kernel;
+    clMemWrapper streams[4];
+    int error;
+    bool dual = (shuffleMode == kBuiltInDualInputFnMode);
+    size_t typeSize = get_explicit_type_size(vecType);
+
+    char kernelName[64];
+    sprintf(kernelName, "shuffle_mask_%d_%d", (int)inVecSize,
+            (int)outVecSize);
+    kernel = clCreateKernel(program, kernelName, &error);
+    test_error(error, "Unable to create runtime mask kernel");
+
+    std::vector<unsigned char> inData(typeSize * inVecSize * numOrders);
+    std::vector<unsigned char> inSecondData(inData.size());
+    std::vector<unsigned char> maskData(typeSize * outVecSize * numOrders);
+    std::vector<unsigned char> outData(maskData.size());
+
+    generate_random_data(vecType, numOrders * inVecSize, d, inData.data());
+    if (dual)
+        generate_random_data(vecType, numOrders * inVecSize, d,
+                             inSecondData.data());
+    for (size_t i = 0; i < numOrders; i++)
+        for (size_t j = 0; j < outVecSize; j++)
+            store_mask_element(maskData.data(), i * outVecSize + j, typeSize,
+                               orders[i][j]);
+
+    streams[0] = clCreateBuffer(context, CL_MEM_COPY_HOST_PTR, inData.size(),
+                                inData.data(), &error);
+    test_error(error, "Unable to create input stream");
+    streams[1] = clCreateBuffer(context, CL_MEM_COPY_HOST_PTR, maskData.size(),
+                                maskData.data(), &error);
+    test_error(error, "Unable to create mask stream");
+    streams[2] = clCreateBuffer(context, CL_MEM_WRITE_ONLY, outData.size(),
+                                NULL, &error);
+    test_error(error, "Unable to create output stream");
+
+    int argIndex = 0;
+    error = clSetKernelArg(kernel, argIndex++, sizeof(streams[0]), &streams[0]);
+    test_error(error, "Unable to set kernel argument");
+    if (dual)
+    {
+        streams[3] =
+            clCreateBuffer(context, CL_MEM_COPY_HOST_PTR, inSecondData.size(),
+                           inSecondData.data(), &error);
+        test_error(error, "Unable to create second input stream");
+
+        error = clSetKernelArg(kernel, argIndex++, sizeof(streams[3]),
+                               &streams[3]);
+        test_error(error, "Unable to set kernel argument");
+    }
+    error = clSetKernelArg(kernel, argIndex++, sizeof(streams[1]), &streams[1]);
+    test_error(error, "Unable to set kernel argument");
+    error = clSetKernelArg(kernel, argIndex++, sizeof(streams[2]), &streams[2]);
+    test_error(error, "Unable to set kernel argument");
+
+    size_t threads[1] = { numOrders };
+    error = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, threads, NULL, 0,
+                                   NULL, NULL);
+    test_error(error, "Unable to execute test kernel");
+
+    error = clEnqueueReadBuffer(queue, streams[2], CL_TRUE, 0, outData.size(),
+                                outData.data(), 0, NULL, NULL);
+    test_error(error, "Unable to read results");
+
+    int ret = 0;
+    for (size_t i = 0; i < numOrders; i++)
+    {
+        unsigned char *inDataPtr = &inData[i * inVecSize * typeSize];
+        unsigned char *inSecondDataPtr =
+            &inSecondData[i * inVecSize * typeSize];
+        unsigned char *outDataPtr = &outData[i * outVecSize * typeSize];
+        unsigned char expected[1024];
+        if (dual)
+            shuffleVectorDual(inDataPtr, inSecondDataPtr, expected, orders[i],
+                              inVecSize, typeSize, (cl_uint)outVecSize);
+        else
+            shuffleVector(inDataPtr, expected, orders[i], outVecSize,
+                          typeSize, (cl_uint)outVecSize);
+
+        if (memcmp(expected, outDataPtr, outVecSize * typeSize) != 0)
+        {
+            char maskString[1024];
+            generate_shuffle_mask(maskString, outVecSize, &orders[i]);
+            log_error(" ERROR: Runtime mask shuffle test %d FAILED for "
+                      "%s%d -> %s%d (memory hex dump follows)\n",
+                      (int)i, get_explicit_type_name(vecType), (int)inVecSize,
+                      get_explicit_type_name(vecType), (int)outVecSize);
+            print_hex_mem_dump(inDataPtr, dual ? inSecondDataPtr : NULL,
+                               expected, outDataPtr, inVecSize, outVecSize,
+                               typeSize);
+            log_error("        Mask:  %s\n", maskString);
+
+            if (++ret > MAX_ERRORS_TO_PRINT)
+            {
+                log_info("Further errors suppressed.\n");
+                return ret;
+            }
+        }
+    }
+
+    return ret;
+}
+
 int test_shuffle_random(cl_device_id device, cl_context context, cl_command_queue queue, ShuffleMode shuffleMode, MTdata d )
 {
     ExplicitType vecType[] = { kChar, kUChar, kShort, kUShort, kInt, kUInt, kLong, kULong, kFloat, kDouble };
@@ -864,6 +1051,22 @@ int test_shuffle_random(cl_device_id device, cl_context context, cl_command_queu
             continue;
         }
 
+        bool builtIn = (shuffleMode == kBuiltInFnMode)
+            || (shuffleMode == kBuiltInDualInputFnMode);
+        clProgramWrapper maskProgram;
+        if (builtIn)
+        {
+            error = create_runtime_mask_program(
+                context, &maskProgram, vecType[typeIndex], shuffleMode);
+            if (error)
+            {
+                log_error("Unable to build runtime mask shuffles for %s\n",
+                          get_explicit_type_name(vecType[typeIndex]));
+                totalError++;
+                continue;
+            }
+        }
+
         error = 0;
         for( srcIdx = 0; vecSizes[ srcIdx ] != 0 /*&& error == 0*/; srcIdx++ )
         {
@@ -879,7 +1082,10 @@ int test_shuffle_random(cl_device_id device, cl_context context, cl_command_queu
                 log_info("Testing [%s%d to %s%d]... ", get_explicit_type_name( vecType[ typeIndex ] ) , vecSizes[srcIdx], get_explicit_type_name( vecType[ typeIndex ] ) , vecSizes[dstIdx]);
                 shuffleBuffer buffer( context, queue, vecType[ typeIndex ], vecSizes[ srcIdx ], vecSizes[ dstIdx ], shuffleMode );
 
-                int numTests = NUM_TESTS*NUM_ITERATIONS_PER_TEST;
+                // Built-in shuffles only need one batch of constant masks;
+                // the rest of their orders go through the runtime mask
+                // kernels below, which need no build of their own.
+                int numTests = builtIn ? NUM_TESTS : NUM_TESTS*NUM_ITERATIONS_PER_TEST;
                 for( int i = 0; i < numTests /*&& error == 0*/; i++ )
                 {
                     ShuffleOrder src{ 0 };
@@ -906,6 +1112,23 @@ int test_shuffle_random(cl_device_id device, cl_context context, cl_command_queu
                 if (test_error)
                     totalError++;
 
+                if (builtIn)
+                {
+                    std::vector<ShuffleOrder> orders(NUM_RUNTIME_MASK_TESTS);
+                    unsigned int range = vecSizes[srcIdx];
+                    if (shuffleMode == kBuiltInDualInputFnMode) range *= 2;
+                    for (size_t i = 0; i < orders.size(); i++)
+                        build_random_shuffle_order(orders[i], vecSizes[dstIdx],
+                                                   range, true, d);
+
+                    test_error = test_shuffle_runtime_mask(
+                        context, queue, maskProgram, vecType[typeIndex],
+                        vecSizes[srcIdx], vecSizes[dstIdx], orders.size(),
+                        orders.data(), seed, shuffleMode);
+                    if (test_error)
+                        totalError++;
+                }
+
                 if (totalError == prevTotalError)
                     log_info("\tPassed.\n");
                 else
@@ -0,0 +1,771 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "harness/stringHelpers.h"
+
+#include "process.h"
+#include "suites.h"
+
+#include <ctype.h>
+#include <limits.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Runs the suite binaries of a CSV list like run_conformance.py, but several
+// at once. Each suite holds host cores, a share of the device and host
+// memory while it runs, and a suite starts as soon as what it needs is
+// free, the longest expected first from the wall times of earlier runs.
+// Each suite writes its output to its own log and its results JSON through
+// CL_CONFORMANCE_RESULTS_FILENAME; the report that merges them is rewritten
+// as each suite finishes, and the logs are merged in list order at the end.
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const char *kDeviceTypes[] = {
+    "CL_DEVICE_TYPE_DEFAULT", "CL_DEVICE_TYPE_CPU", "CL_DEVICE_TYPE_GPU",
+    "CL_DEVICE_TYPE_ACCELERATOR", "CL_DEVICE_TYPE_ALL",
+};
+
+// Suites without a history are assumed to take this long when sharding
+const double kUnknownSeconds = 600;
+const size_t kDefaultSuiteMemoryMb = 1024;
+const unsigned kDefaultDeviceSlots = 1;
+// A waiting suite stops later suites from starting once this many have
+// gone ahead of it, so that a suite that needs the whole device or host
+// isn't held back for ever
+const unsigned kMaxOvertakes = 8;
+const auto kPollInterval = std::chrono::milliseconds(50);
+
+volatile sig_atomic_t gInterrupted = 0;
+
+void on_interrupt(int) { gInterrupted = 1; }
+
+struct Options
+{
+    std::string listFile;
+    std::vector<std::string> deviceTypes;
+    std::vector<std::string> patterns;
+    unsigned jobs = 0;
+    unsigned deviceSlots = kDefaultDeviceSlots;
+    size_t memoryMb = 0;
+    unsigned shardIndex = 0;
+    unsigned shardCount = 1;
+    double timeoutSeconds = 0;
+    unsigned retries = 0;
+    std::string historyFile = "run_conformance_history.tsv";
+    // Set by --history, which shards then split by time
+    bool historyGiven = false;
+    std::string durationFile;
+    std::string reportFile;
+    std::string logDirectory = ".";
+};
+
+struct Resources
+{
+    unsigned cores;
+    unsigned deviceSlots;
+    size_t memoryMb;
+};
+
+struct Outcome
+{
+    std::string deviceType;
+    const Suite *suite;
+    // pass, fail, crash, timeout, missing or interrupted
+    std::string status;
+    int exitCode;
+    unsigned attempts;
+    double seconds;
+    size_t maxRssKb;
+    size_t failedLines;
+    std::string logFile;
+    // The results JSON the suite wrote, empty if none
+    std::string results;
+};
+
+struct Job
+{
+    const Suite *suite;
+    unsigned attempts;
+    unsigned overtakes;
+};
+
+struct RunningJob
+{
+    Job job;
+    Resources held;
+    std::unique_ptr<SuiteProcess> process;
+    Clock::time_point start;
+    std::string logFile;
+    std::string resultsFile;
+};
+
+void write_help_info()
+{
+    printf("run_conformance test_list [CL_DEVICE_TYPE(s) to test] "
+           "[partial-test-names, ...] [options]\n"
+           " test_list - the .csv file containing the test names and "
+           "commands to run the tests.\n"
+           " [partial-test-names, ...] - optional partial strings to select "
+           "a subset of the tests to run.\n"
+           " [CL_DEVICE_TYPE(s) to test] - list of CL device types to test, "
+           "default is CL_DEVICE_TYPE_DEFAULT.\n"
+           " --jobs N - host cores to keep busy, default all of them.\n"
+           " --device-slots N - suites that may share the device at once, "
+           "default %u, more\n"
+           "   lets suites that don't need the whole device run "
+           "together.\n"
+           " --memory MB - host memory the running suites may use, default "
+           "three quarters of it.\n"
+           " --shard I/N - run the I-th of N shards, every N-th suite of "
+           "the list, or with\n"
+           "   --history shards of about the same expected time, which "
+           "needs every shard to\n"
+           "   be given the same history file.\n"
+           " --timeout S - kill a suite that runs for longer than S "
+           "seconds.\n"
+           " --retries N - run a failing suite up to N more times.\n"
+           " --history FILE - wall times of earlier runs, default "
+           "run_conformance_history.tsv.\n"
+           " --duration-db FILE - the test durations the suites record, "
+           "used for suites\n"
+           "   without a history, default CL_CONFORMANCE_DURATION_DB.\n"
+           " --report FILE - the merged JSON report, default next to the "
+           "log.\n"
+           " --log DIR (or log=DIR) - where the logs go, default the "
+           "current directory.\n",
+           kDefaultDeviceSlots);
+}
+
+std::string get_time()
+{
+    char buffer[64];
+    time_t now = time(NULL);
+    strftime(buffer, sizeof(buffer), "%d-%b %H:%M:%S", localtime(&now));
+    return buffer;
+}
+
+size_t host_memory_mb()
+{
+    long pages = sysconf(_SC_PHYS_PAGES);
+    long pageSize = sysconf(_SC_PAGE_SIZE);
+    if (pages <= 0 || pageSize <= 0) return 4096;
+    return (size_t)((double)pages * pageSize / (1024 * 1024));
+}
+
+// Accepts both --name value and --name=value
+bool option_value(int argc, const char *argv[], int &i, const char *name,
+                  std::string &value)
+{
+    size_t length = strlen(name);
+    if (strncmp(argv[i], name, length) != 0) return false;
+    if (argv[i][length] == '=')
+    {
+        value = argv[i] + length + 1;
+        return true;
+    }
+    if (argv[i][length] != '\0' || i + 1 >= argc) return false;
+    value = argv[++i];
+    return true;
+}
+
+bool parse_options(int argc, const char *argv[], Options &options)
+{
+    if (argc < 2 || strcmp(argv[1], "--help") == 0
+        || strcmp(argv[1], "-h") == 0)
+        return false;
+    options.listFile = argv[1];
+    for (int i = 2; i < argc; i++)
+    {
+        std::string value;
+        if (option_value(argc, argv, i, "--jobs", value))
+            options.jobs = (unsigned)atoi(value.c_str());
+        else if (option_value(argc, argv, i, "--device-slots", value))
+            options.deviceSlots = (unsigned)atoi(value.c_str());
+        else if (option_value(argc, argv, i, "--memory", value))
+            options.memoryMb = (size_t)atoll(value.c_str());
+        else if (option_value(argc, argv, i, "--shard", value))
+        {
+            unsigned index, count;
+            if (sscanf(value.c_str(), "%u/%u", &index, &count) != 2
+                || index < 1 || index > count)
+            {
+                fprintf(stderr, "Bad shard %s, expected I/N with 1 <= I <= "
+                        "N.\n",
+                        value.c_str());
+                return false;
+            }
+            options.shardIndex = index - 1;
+            options.shardCount = count;
+        }
+        else if (option_value(argc, argv, i, "--timeout", value))
+            options.timeoutSeconds = atof(value.c_str());
+        else if (option_value(argc, argv, i, "--retries", value))
+            options.retries = (unsigned)atoi(value.c_str());
+        else if (option_value(argc, argv, i, "--history", value))
+        {
+            options.historyFile = value;
+            options.historyGiven = true;
+        }
+        else if (option_value(argc, argv, i, "--duration-db", value))
+            options.durationFile = value;
+        else if (option_value(argc, argv, i, "--report", value))
+            options.reportFile = value;
+        else if (option_value(argc, argv, i, "--log", value))
+            options.logDirectory = value;
+        else if (strncmp(argv[i], "log=", 4) == 0)
+            options.logDirectory = argv[i] + 4;
+        else if (strncmp(argv[i], "--", 2) == 0)
+        {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return false;
+        }
+        else if (std::find(std::begin(kDeviceTypes), std::end(kDeviceTypes),
+                           std::string(argv[i]))
+                 != std::end(kDeviceTypes))
+            options.deviceTypes.push_back(argv[i]);
+        else
+            options.patterns.push_back(argv[i]);
+    }
+
+    while (options.logDirectory.size() > 1
+           && options.logDirectory.back() == '/')
+        options.logDirectory.pop_back();
+    if (options.deviceTypes.empty())
+        options.deviceTypes.push_back("CL_DEVICE_TYPE_DEFAULT");
+    if (options.jobs == 0)
+        options.jobs = std::max(1u, std::thread::hardware_concurrency());
+    if (options.deviceSlots == 0) options.deviceSlots = 1;
+    if (options.memoryMb == 0) options.memoryMb = host_memory_mb() * 3 / 4;
+    const char *durationFile = getenv("CL_CONFORMANCE_DURATION_DB");
+    if (options.durationFile.empty() && durationFile)
+        options.durationFile = durationFile;
+    return true;
+}
+
+// The suites matching any of the patterns, in list order, or all of them
+bool select_suites(std::vector<Suite> &suites,
+                   const std::vector<std::string> &patterns)
+{
+    if (patterns.empty()) return true;
+
+    std::vector<bool> selected(suites.size(), false);
+    for (const std::string &pattern : patterns)
+    {
+        bool found = false;
+        for (size_t i = 0; i < suites.size(); i++)
+            if (suites[i].name.find(pattern) != std::string::npos
+                || suites[i].command.find(pattern) != std::string::npos)
+                selected[i] = found = true;
+        if (!found)
+            printf("Failed to find a test matching %s\n", pattern.c_str());
+    }
+
+    std::vector<Suite> kept;
+    for (size_t i = 0; i < suites.size(); i++)
+        if (selected[i]) kept.push_back(suites[i]);
+    suites.swap(kept);
+    return !suites.empty();
+}
+
+std::string safe_file_name(const std::string &name)
+{
+    std::string result;
+    for (char c : name)
+        result += isalnum((unsigned char)c) ? c : '_';
+    return result;
+}
+
+std::string read_file(const std::string &fileName)
+{
+    std::ifstream file(fileName);
+    return std::string(std::istreambuf_iterator<char>(file),
+                       std::istreambuf_iterator<char>());
+}
+
+// Echo the failures in the log of a finished suite and count its FAILED
+// lines, as run_conformance.py does
+size_t scan_log(const std::string &logFile)
+{
+    std::ifstream file(logFile);
+    std::string line;
+    size_t failed = 0;
+    while (std::getline(file, line))
+    {
+        if (line.find("FAILED") != std::string::npos) failed++;
+        if (line.find("FAILED") != std::string::npos
+            || line.find("ERROR") != std::string::npos)
+            printf("           ==> %s\n", line.c_str());
+    }
+    return failed;
+}
+
+bool write_report(const std::string &fileName, const Options &options,
+                  const std::vector<Outcome> &outcomes)
+{
+    std::string temporary = fileName + ".tmp";
+    FILE *file = fopen(temporary.c_str(), "w");
+    if (file == NULL) return false;
+
+    size_t failures = 0;
+    for (const Outcome &outcome : outcomes)
+        if (outcome.status != "pass") failures++;
+
+    fprintf(file, "{\n\t\"test_list\": \"%s\",\n",
+            json_escape(options.listFile).c_str());
+    fprintf(file, "\t\"shard\": \"%u/%u\",\n", options.shardIndex + 1,
+            options.shardCount);
+    fprintf(file, "\t\"failures\": %zu,\n\t\"suites\": [", failures);
+    for (size_t i = 0; i < outcomes.size(); i++)
+    {
+        const Outcome &outcome = outcomes[i];
+        fprintf(file,
+                "%s\n\t\t{ \"device_type\": \"%s\", \"name\": \"%s\", "
+                "\"command\": \"%s\", \"status\": \"%s\", \"exit_code\": %d, "
+                "\"attempts\": %u, \"seconds\": %.3f, \"max_rss_kb\": %zu, "
+                "\"failed_lines\": %zu, \"log\": \"%s\", \"results\": %s }",
+                i ? "," : "", outcome.deviceType.c_str(),
+                json_escape(outcome.suite->name).c_str(),
+                json_escape(outcome.suite->command).c_str(),
+                outcome.status.c_str(), outcome.exitCode, outcome.attempts,
+                outcome.seconds, outcome.maxRssKb, outcome.failedLines,
+                json_escape(outcome.logFile).c_str(),
+                outcome.results.empty() ? "null" : outcome.results.c_str());
+    }
+    fprintf(file, "\n\t]\n}\n");
+    if (fclose(file) != 0) return false;
+    return rename(temporary.c_str(), fileName.c_str()) == 0;
+}
+
+// Concatenate the logs of the suites in list order under the headers that
+// run_conformance.py writes
+void merge_logs(const std::string &fileName, const std::vector<Suite> &suites,
+                const std::vector<Outcome> &outcomes)
+{
+    FILE *file = fopen(fileName.c_str(), "w");
+    if (file == NULL)
+    {
+        fprintf(stderr, "Could not open log file %s\n", fileName.c_str());
+        return;
+    }
+    for (const Suite &suite : suites)
+        for (const Outcome &outcome : outcomes)
+        {
+            if (outcome.suite->name != suite.name) continue;
+            fprintf(file,
+                    "=================================================="
+                    "======================================\n"
+                    "(%s)     Running Tests: %s on %s\n",
+                    get_time().c_str(), suite.command.c_str(),
+                    outcome.deviceType.c_str());
+            std::ifstream log(outcome.logFile);
+            std::string line;
+            while (std::getline(log, line))
+                fprintf(file, "     %s\n", line.c_str());
+            if (outcome.status == "pass")
+                fprintf(file, "     Test %s passed in %.3fs\n",
+                        suite.name.c_str(), outcome.seconds);
+            else
+                fprintf(file, "  *  Test %s ==> %s: %d after %u attempts\n",
+                        suite.name.c_str(), outcome.status.c_str(),
+                        outcome.exitCode, outcome.attempts);
+            fprintf(file, "\n");
+        }
+    fclose(file);
+}
+
+class Scheduler {
+public:
+    Scheduler(const Options &options, const std::string &logPrefix,
+              const std::string &currentDirectory, SuiteHistory &history)
+        : m_options(options), m_logPrefix(logPrefix),
+          m_currentDirectory(currentDirectory), m_history(history)
+    {}
+
+    // Run the suites on deviceType, adding what happened to outcomes
+    void Run(const std::string &deviceType, const std::vector<Suite> &suites,
+             std::vector<Outcome> &outcomes, const std::string &reportFile)
+    {
+        m_free.cores = m_options.jobs;
+        m_free.deviceSlots = m_options.deviceSlots;
+        m_free.memoryMb = m_options.memoryMb;
+
+        std::deque<Job> waiting;
+        for (size_t i = 0; i < suites.size(); i++)
+            waiting.push_back({ &suites[i], 0, 0 });
+        std::vector<RunningJob> running;
+        size_t finished = 0;
+
+        while (!waiting.empty() || !running.empty())
+        {
+            if (gInterrupted)
+            {
+                for (RunningJob &job : running)
+                {
+                    job.process->Kill();
+                    outcomes.push_back(
+                        MakeOutcome(deviceType, job, "interrupted", -SIGINT,
+                                    0, 0));
+                }
+                write_report(reportFile, m_options, outcomes);
+                return;
+            }
+
+            StartWaiting(deviceType, waiting, running, outcomes, finished,
+                         suites.size());
+
+            bool progressed = false;
+            for (size_t i = 0; i < running.size();)
+            {
+                int exitCode;
+                size_t maxRssKb;
+                RunningJob &job = running[i];
+                double seconds = Elapsed(job.start);
+                bool timedOut = m_options.timeoutSeconds > 0
+                    && seconds > m_options.timeoutSeconds;
+                if (timedOut) job.process->Kill();
+                if (!timedOut && !job.process->Poll(exitCode, maxRssKb))
+                {
+                    i++;
+                    continue;
+                }
+                if (timedOut)
+                {
+                    exitCode = -SIGKILL;
+                    maxRssKb = 0;
+                }
+
+                Release(job.held);
+                Finish(deviceType, job, timedOut, exitCode, maxRssKb, seconds,
+                       waiting, outcomes, finished, suites.size());
+                running.erase(running.begin() + i);
+                write_report(reportFile, m_options, outcomes);
+                progressed = true;
+            }
+            if (!progressed) std::this_thread::sleep_for(kPollInterval);
+        }
+    }
+
+private:
+    static double Elapsed(Clock::time_point start)
+    {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    Resources Needs(const Suite &suite) const
+    {
+        Resources needs;
+        needs.cores = suite.cores == 0
+            ? m_options.jobs
+            : std::min(suite.cores, m_options.jobs);
+        needs.deviceSlots = suite.deviceExclusive ? m_options.deviceSlots : 1;
+        needs.memoryMb = std::min(suite.memoryMb, m_options.memoryMb);
+        return needs;
+    }
+
+    bool Fits(const Resources &needs) const
+    {
+        return needs.cores <= m_free.cores
+            && needs.deviceSlots <= m_free.deviceSlots
+            && needs.memoryMb <= m_free.memoryMb;
+    }
+
+    void Hold(const Resources &needs)
+    {
+        m_free.cores -= needs.cores;
+        m_free.deviceSlots -= needs.deviceSlots;
+        m_free.memoryMb -= needs.memoryMb;
+    }
+
+    void Release(const Resources &held)
+    {
+        m_free.cores += held.cores;
+        m_free.deviceSlots += held.deviceSlots;
+        m_free.memoryMb += held.memoryMb;
+    }
+
+    void StartWaiting(const std::string &deviceType, std::deque<Job> &waiting,
+                      std::vector<RunningJob> &running,
+                      std::vector<Outcome> &outcomes, size_t &finished,
+                      size_t total)
+    {
+        for (size_t i = 0; i < waiting.size();)
+        {
+            Job &job = waiting[i];
+            Resources needs = Needs(*job.suite);
+            if (!Fits(needs))
+            {
+                if (job.overtakes >= kMaxOvertakes) return;
+                i++;
+                continue;
+            }
+
+            for (size_t j = 0; j < i; j++) waiting[j].overtakes++;
+            Job started = job;
+            waiting.erase(waiting.begin() + i);
+            started.attempts++;
+
+            RunningJob run;
+            run.job = started;
+            run.held = needs;
+            if (!Launch(deviceType, run))
+            {
+                Outcome outcome =
+                    MakeOutcome(deviceType, run, "missing", -1, 0, 0);
+                outcomes.push_back(outcome);
+                finished++;
+                PrintFinish(outcome, finished, total);
+                continue;
+            }
+            Hold(needs);
+            printf("(%s)     BEGIN  %-40s: %s\n", get_time().c_str(),
+                   started.suite->name.c_str(), deviceType.c_str());
+            fflush(stdout);
+            running.push_back(std::move(run));
+        }
+    }
+
+    bool Launch(const std::string &deviceType, RunningJob &run)
+    {
+        const Suite &suite = *run.job.suite;
+        std::string program =
+            suite.command.substr(0, suite.command.find_first_of(" \t"));
+        std::string path = m_currentDirectory + "/" + program;
+        std::string base = m_logPrefix + "_"
+            + safe_file_name(deviceType + "_" + suite.name);
+        run.logFile = base + ".log";
+        run.resultsFile = base + ".json";
+        if (access(path.c_str(), X_OK) != 0)
+        {
+            printf("           ==> ERROR: test file (%s) does not exist.  "
+                   "Failing test.\n",
+                   path.c_str());
+            return false;
+        }
+
+        remove(run.resultsFile.c_str());
+        SuiteProcess::Environment environment = {
+            { "CL_DEVICE_TYPE", deviceType },
+            { "CL_CONFORMANCE_RESULTS_FILENAME", run.resultsFile },
+        };
+        if (!m_options.durationFile.empty())
+            environment.push_back(
+                { "CL_CONFORMANCE_DURATION_DB", m_options.durationFile });
+        std::string directory = path.substr(0, path.find_last_of('/'));
+        run.process.reset(new SuiteProcess());
+        run.start = Clock::now();
+        return run.process->Start(directory,
+                                  m_currentDirectory + "/" + suite.command,
+                                  environment, run.logFile);
+    }
+
+    Outcome MakeOutcome(const std::string &deviceType, const RunningJob &run,
+                        const char *status, int exitCode, size_t maxRssKb,
+                        size_t failedLines) const
+    {
+        Outcome outcome;
+        outcome.deviceType = deviceType;
+        outcome.suite = run.job.suite;
+        outcome.status = status;
+        outcome.exitCode = exitCode;
+        outcome.attempts = run.job.attempts;
+        outcome.seconds = run.process ? Elapsed(run.start) : 0;
+        outcome.maxRssKb = maxRssKb;
+        outcome.failedLines = failedLines;
+        outcome.logFile = run.logFile;
+        return outcome;
+    }
+
+    void Finish(const std::string &deviceType, RunningJob &job, bool timedOut,
+                int exitCode, size_t maxRssKb, double seconds,
+                std::deque<Job> &waiting, std::vector<Outcome> &outcomes,
+                size_t &finished, size_t total)
+    {
+        size_t failedLines = scan_log(job.logFile);
+        const char *status = "pass";
+        if (timedOut)
+            status = "timeout";
+        else if (exitCode < 0)
+            status = "crash";
+        else if (exitCode != 0 || failedLines > 0)
+            status = "fail";
+
+        // A suite that timed out didn't show how long it takes
+        if (!timedOut) m_history.Record(job.job.suite->name, seconds, maxRssKb);
+
+        if (strcmp(status, "pass") != 0
+            && job.job.attempts <= m_options.retries)
+        {
+            printf("(%s)     RETRY  %-40s: %s after %.0fs, attempt %u of "
+                   "%u\n",
+                   get_time().c_str(), job.job.suite->name.c_str(), status,
+                   seconds, job.job.attempts, m_options.retries + 1);
+            Job retry = job.job;
+            retry.overtakes = 0;
+            waiting.push_front(retry);
+            return;
+        }
+
+        Outcome outcome = MakeOutcome(deviceType, job, status, exitCode,
+                                      maxRssKb, failedLines);
+        outcome.seconds = seconds;
+        std::string results = read_file(job.resultsFile);
+        if (results.find('{') != std::string::npos) outcome.results = results;
+        outcomes.push_back(outcome);
+        finished++;
+        PrintFinish(outcome, finished, total);
+    }
+
+    static void PrintFinish(const Outcome &outcome, size_t finished,
+                            size_t total)
+    {
+        printf("(%s)     %s %-40s: (%3.0fs, test %3zu/%zu)\n",
+               get_time().c_str(),
+               outcome.status == "pass" ? "PASSED" : "FAILED",
+               outcome.suite->name.c_str(), outcome.seconds, finished, total);
+        fflush(stdout);
+    }
+
+    const Options &m_options;
+    std::string m_logPrefix;
+    std::string m_currentDirectory;
+    SuiteHistory &m_history;
+    Resources m_free;
+};
+
+} // anonymous namespace
+
+int main(int argc, const char *argv[])
+{
+    Options options;
+    if (!parse_options(argc, argv, options))
+    {
+        write_help_info();
+        return EXIT_FAILURE;
+    }
+
+    char currentDirectory[PATH_MAX];
+    if (getcwd(currentDirectory, sizeof(currentDirectory)) == NULL)
+    {
+        perror("getcwd");
+        return EXIT_FAILURE;
+    }
+
+    char stamp[64];
+    time_t now = time(NULL);
+    strftime(stamp, sizeof(stamp), "%Y-%m-%d_%H-%M", localtime(&now));
+    // The suites run in their own directories, so the files they are
+    // given have to be absolute
+    std::string logDirectory = options.logDirectory;
+    if (logDirectory == ".")
+        logDirectory = currentDirectory;
+    else if (logDirectory[0] != '/')
+        logDirectory = std::string(currentDirectory) + "/" + logDirectory;
+    std::string logPrefix =
+        logDirectory + "/opencl_conformance_results_" + stamp;
+    if (options.reportFile.empty()) options.reportFile = logPrefix + ".json";
+    if (!options.durationFile.empty() && options.durationFile[0] != '/')
+        options.durationFile =
+            std::string(currentDirectory) + "/" + options.durationFile;
+
+    std::vector<Suite> suites;
+    if (!load_suites(options.listFile, options.deviceTypes, suites))
+    {
+        printf("FAILED: test_list \"%s\" does not exist.\n\n",
+               options.listFile.c_str());
+        write_help_info();
+        return EXIT_FAILURE;
+    }
+    if (!select_suites(suites, options.patterns))
+    {
+        printf("FAILED: Failed to find any tests matching the given "
+               "command-line options.\n\n");
+        write_help_info();
+        return EXIT_FAILURE;
+    }
+
+    SuiteHistory history;
+    history.Load(options.historyFile);
+    DurationHistory durations;
+    if (!options.durationFile.empty()) durations.Load(options.durationFile);
+    for (Suite &suite : suites)
+    {
+        estimate_resources(suite, kDefaultSuiteMemoryMb);
+        history.Apply(suite);
+    }
+    // Only the history shared through --history may decide the split, not
+    // the local duration database
+    select_shard(suites, options.shardIndex, options.shardCount,
+                 options.historyGiven, kUnknownSeconds);
+    for (Suite &suite : suites) estimate_seconds(suite, durations);
+    // The merged log keeps the list order
+    std::vector<Suite> listOrder = suites;
+    order_longest_first(suites);
+
+    printf("Testing on:");
+    for (const std::string &deviceType : options.deviceTypes)
+        printf(" %s", deviceType.c_str());
+    printf("\nRunning %zu tests of %s (shard %u/%u) with %u cores, %u device "
+           "slots and %zu MB\n",
+           suites.size(), options.listFile.c_str(), options.shardIndex + 1,
+           options.shardCount, options.jobs, options.deviceSlots,
+           options.memoryMb);
+    for (const Suite &suite : suites)
+        printf("%-50s (%s)\n", suite.name.c_str(), suite.command.c_str());
+
+    signal(SIGINT, on_interrupt);
+    signal(SIGTERM, on_interrupt);
+
+    std::vector<Outcome> outcomes;
+    Scheduler scheduler(options, logPrefix, currentDirectory, history);
+    for (const std::string &deviceType : options.deviceTypes)
+    {
+        printf("Setting CL_DEVICE_TYPE to %s\n", deviceType.c_str());
+        scheduler.Run(deviceType, suites, outcomes, options.reportFile);
+        if (gInterrupted) break;
+    }
+
+    merge_logs(logPrefix + ".log", listOrder, outcomes);
+    bool reportSaved = write_report(options.reportFile, options, outcomes);
+    if (!history.Save(options.historyFile))
+        fprintf(stderr, "Could not save the history to %s\n",
+                options.historyFile.c_str());
+
+    size_t failures = 0;
+    for (const Outcome &outcome : outcomes)
+        if (outcome.status != "pass") failures++;
+    printf("(%s) Testing complete.  %zu failures for %zu tests.\n",
+           get_time().c_str(), failures, outcomes.size());
+    printf("Merged log %s.log, report %s%s\n", logPrefix.c_str(),
+           options.reportFile.c_str(), reportSaved ? "" : " (not saved)");
+
+    if (gInterrupted) return EXIT_FAILURE;
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,115 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "process.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+bool SuiteProcess::Start(const std::string &directory,
+                         const std::string &command,
+                         const Environment &environment,
+                         const std::string &outputFile)
+{
+    int output = open(outputFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (output < 0)
+    {
+        fprintf(stderr, "Could not open %s: %s\n", outputFile.c_str(),
+                strerror(errno));
+        return false;
+    }
+
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        fprintf(stderr, "Could not fork: %s\n", strerror(errno));
+        close(output);
+        return false;
+    }
+
+    if (pid == 0)
+    {
+        setpgid(0, 0);
+        dup2(output, STDOUT_FILENO);
+        dup2(output, STDERR_FILENO);
+        close(output);
+        if (chdir(directory.c_str()) != 0)
+        {
+            fprintf(stderr, "Could not change to %s: %s\n", directory.c_str(),
+                    strerror(errno));
+            _exit(127);
+        }
+        for (const auto &variable : environment)
+            setenv(variable.first.c_str(), variable.second.c_str(), 1);
+        execl("/bin/sh", "sh", "-c", command.c_str(), (char *)NULL);
+        fprintf(stderr, "Could not run /bin/sh: %s\n", strerror(errno));
+        _exit(127);
+    }
+
+    // Set the group here too, so that a kill right after the fork still
+    // finds it
+    setpgid(pid, pid);
+    close(output);
+    m_pid = pid;
+    return true;
+}
+
+bool SuiteProcess::Poll(int &exitCode, size_t &maxRssKb)
+{
+    if (m_pid < 0) return true;
+
+    int status;
+    struct rusage usage;
+    pid_t pid = wait4(m_pid, &status, WNOHANG, &usage);
+    if (pid == 0) return false;
+    if (pid < 0)
+    {
+        fprintf(stderr, "Could not wait for process %d: %s\n", (int)m_pid,
+                strerror(errno));
+        exitCode = -SIGABRT;
+        maxRssKb = 0;
+        m_pid = -1;
+        return true;
+    }
+
+    if (WIFEXITED(status))
+        exitCode = WEXITSTATUS(status);
+    else
+        exitCode = WIFSIGNALED(status) ? -WTERMSIG(status) : -SIGABRT;
+    // ru_maxrss is in bytes on macOS and in KB elsewhere
+#if defined(__APPLE__)
+    maxRssKb = (size_t)usage.ru_maxrss / 1024;
+#else
+    maxRssKb = (size_t)usage.ru_maxrss;
+#endif
+    m_pid = -1;
+    return true;
+}
+
+void SuiteProcess::Kill()
+{
+    if (m_pid < 0) return;
+    kill(-m_pid, SIGKILL);
+    int status;
+    waitpid(m_pid, &status, 0);
+    m_pid = -1;
+}
@@ -0,0 +1,54 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef RUNNER_PROCESS_H_
+#define RUNNER_PROCESS_H_
+
+#include <stddef.h>
+#include <sys/types.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+// A suite binary run through the shell, as run_conformance.py does, in its
+// own process group so that a timeout can kill whatever it started
+class SuiteProcess {
+public:
+    typedef std::vector<std::pair<std::string, std::string>> Environment;
+
+    SuiteProcess(): m_pid(-1) {}
+    ~SuiteProcess() { Kill(); }
+
+    // Run command in directory with the variables of environment added,
+    // writing its stdout and stderr to outputFile
+    bool Start(const std::string &directory, const std::string &command,
+               const Environment &environment, const std::string &outputFile);
+
+    // Whether it has exited, giving the exit code, or minus the signal that
+    // ended it, and the peak resident memory in KB
+    bool Poll(int &exitCode, size_t &maxRssKb);
+
+    // Kill the process group and reap it
+    void Kill();
+
+private:
+    SuiteProcess(const SuiteProcess &) = delete;
+    SuiteProcess &operator=(const SuiteProcess &) = delete;
+
+    pid_t m_pid;
+};
+
+#endif // RUNNER_PROCESS_H_
@@ -0,0 +1,225 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "suites.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <fstream>
+
+namespace {
+
+// Suites that spread their work over a ThreadPool of every host core
+const char *kAllCoreBinaries[] = {
+    "test_bruteforce", "test_conversions", "test_image_streams",
+    "test_integer_ops", "test_half",
+};
+
+// Suites that time the device or allocate as much device memory as it
+// allows, so that sharing the device would change their results
+const char *kDeviceExclusiveBinaries[] = {
+    "test_allocations",
+    "test_profiling",
+    "test_device_timer",
+};
+const char *kDeviceExclusiveArguments[] = {
+    "max_images",
+    "-bench",
+};
+
+std::string trim(const std::string &s)
+{
+    size_t begin = s.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) return "";
+    size_t end = s.find_last_not_of(" \t\r\n");
+    return s.substr(begin, end - begin + 1);
+}
+
+std::string binary_name(const std::string &command)
+{
+    std::string binary = command.substr(0, command.find_first_of(" \t"));
+    size_t slash = binary.find_last_of('/');
+    return slash == std::string::npos ? binary : binary.substr(slash + 1);
+}
+
+} // anonymous namespace
+
+bool load_suites(const std::string &fileName,
+                 const std::vector<std::string> &deviceTypes,
+                 std::vector<Suite> &suites)
+{
+    std::ifstream file(fileName);
+    if (!file) return false;
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.empty() || line[0] == '#') continue;
+        size_t first = line.find(',');
+        if (first == std::string::npos) continue;
+        size_t second = line.find(',', first + 1);
+
+        Suite suite = {};
+        suite.expectedSeconds = -1;
+        if (second != std::string::npos)
+        {
+            std::string deviceType = trim(line.substr(0, first));
+            suite.name = trim(line.substr(first + 1, second - first - 1));
+            suite.command = trim(line.substr(second + 1));
+            if (std::find(deviceTypes.begin(), deviceTypes.end(), deviceType)
+                == deviceTypes.end())
+            {
+                printf("Skipping %s because %s is not in the list of devices "
+                       "to test.\n",
+                       suite.name.c_str(), deviceType.c_str());
+                continue;
+            }
+        }
+        else
+        {
+            suite.name = trim(line.substr(0, first));
+            suite.command = trim(line.substr(first + 1));
+        }
+        if (suite.name.empty() || suite.command.empty()) continue;
+        suites.push_back(suite);
+    }
+    return true;
+}
+
+void estimate_resources(Suite &suite, size_t defaultMemoryMb)
+{
+    std::string binary = binary_name(suite.command);
+    suite.cores = 1;
+    for (const char *name : kAllCoreBinaries)
+        if (binary == name) suite.cores = 0;
+
+    suite.deviceExclusive = false;
+    for (const char *name : kDeviceExclusiveBinaries)
+        if (binary == name) suite.deviceExclusive = true;
+    for (const char *argument : kDeviceExclusiveArguments)
+        if (suite.command.find(argument) != std::string::npos)
+            suite.deviceExclusive = true;
+
+    if (suite.memoryMb == 0) suite.memoryMb = defaultMemoryMb;
+}
+
+void estimate_seconds(Suite &suite, const DurationHistory &durations)
+{
+    if (suite.expectedSeconds >= 0) return;
+    double seconds = durations.SuiteSeconds(binary_name(suite.command));
+    if (seconds >= 0) suite.expectedSeconds = seconds;
+}
+
+bool SuiteHistory::Load(const std::string &fileName)
+{
+    std::ifstream file(fileName);
+    if (!file) return true;
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        size_t first = line.find('\t');
+        size_t second = line.find('\t', first + 1);
+        if (first == std::string::npos || second == std::string::npos)
+        {
+            fprintf(stderr, "Ignoring bad history line in %s: %s\n",
+                    fileName.c_str(), line.c_str());
+            continue;
+        }
+        Entry entry;
+        entry.seconds = strtod(line.c_str() + first + 1, NULL);
+        entry.maxRssKb = (size_t)strtoull(line.c_str() + second + 1, NULL, 10);
+        m_entries[line.substr(0, first)] = entry;
+    }
+    return true;
+}
+
+bool SuiteHistory::Save(const std::string &fileName) const
+{
+    FILE *file = fopen(fileName.c_str(), "w");
+    if (file == NULL) return false;
+    for (const auto &entry : m_entries)
+        fprintf(file, "%s\t%.3f\t%zu\n", entry.first.c_str(),
+                entry.second.seconds, entry.second.maxRssKb);
+    return fclose(file) == 0;
+}
+
+void SuiteHistory::Apply(Suite &suite) const
+{
+    auto it = m_entries.find(suite.name);
+    if (it == m_entries.end()) return;
+    suite.expectedSeconds = it->second.seconds;
+    if (it->second.maxRssKb)
+        suite.memoryMb = (it->second.maxRssKb + 1023) / 1024;
+}
+
+void SuiteHistory::Record(const std::string &name, double seconds,
+                          size_t maxRssKb)
+{
+    Entry entry = { seconds, maxRssKb };
+    m_entries[name] = entry;
+}
+
+void order_longest_first(std::vector<Suite> &suites)
+{
+    std::stable_sort(suites.begin(), suites.end(),
+                     [](const Suite &a, const Suite &b) {
+                         bool aKnown = a.expectedSeconds >= 0;
+                         bool bKnown = b.expectedSeconds >= 0;
+                         if (aKnown != bKnown) return !aKnown;
+                         return a.expectedSeconds > b.expectedSeconds;
+                     });
+}
+
+void select_shard(std::vector<Suite> &suites, unsigned index, unsigned count,
+                  bool byTime, double unknownSeconds)
+{
+    if (count <= 1) return;
+
+    std::vector<Suite> kept;
+    if (!byTime)
+    {
+        for (size_t i = index; i < suites.size(); i += count)
+            kept.push_back(suites[i]);
+        suites.swap(kept);
+        return;
+    }
+
+    auto seconds = [=](const Suite &suite) {
+        return suite.expectedSeconds >= 0 ? suite.expectedSeconds
+                                          : unknownSeconds;
+    };
+    // Ties are broken by name so that every shard makes the same split
+    std::vector<Suite> sorted = suites;
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [&](const Suite &a, const Suite &b) {
+                         if (seconds(a) != seconds(b))
+                             return seconds(a) > seconds(b);
+                         return a.name < b.name;
+                     });
+
+    std::vector<double> totals(count, 0.0);
+    for (const Suite &suite : sorted)
+    {
+        unsigned shard = (unsigned)(std::min_element(totals.begin(),
+                                                     totals.end())
+                                    - totals.begin());
+        totals[shard] += seconds(suite);
+        if (shard == index) kept.push_back(suite);
+    }
+    suites.swap(kept);
+}
@@ -0,0 +1,98 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#ifndef RUNNER_SUITES_H_
+#define RUNNER_SUITES_H_
+
+#include <stddef.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "harness/durationHistory.h"
+
+// A suite binary listed in one of the opencl_conformance_tests_*.csv files,
+// with what it needs while it runs
+struct Suite
+{
+    std::string name;
+    // The binary, relative to the directory the lists are run from, and its
+    // arguments
+    std::string command;
+
+    // Host cores it keeps busy, 0 for all of them
+    unsigned cores;
+    // Whether nothing else may use the device while it runs, for suites
+    // that time the device or allocate most of its memory
+    bool deviceExclusive;
+    // Peak resident memory
+    size_t memoryMb;
+    // Wall time of its last run, negative if it hasn't run before
+    double expectedSeconds;
+};
+
+// Load the suites of a CSV list the way run_conformance.py does: lines of
+// name,command, and lines of device type,name,command that are only kept
+// if their device type is one of deviceTypes. Gives false if the list
+// can't be read.
+bool load_suites(const std::string &fileName,
+                 const std::vector<std::string> &deviceTypes,
+                 std::vector<Suite> &suites);
+
+// Fill in the resources a suite needs from what is known about the suite
+// binaries, with defaultMemoryMb for the memory of suites that haven't run
+void estimate_resources(Suite &suite, size_t defaultMemoryMb);
+
+// Fill in the expected time of a suite that hasn't run under the runner
+// from the last times of its tests in the harness duration database
+void estimate_seconds(Suite &suite, const DurationHistory &durations);
+
+// Wall times and peak memory of earlier runs, kept as lines of
+// name<TAB>seconds<TAB>max_rss_kb
+class SuiteHistory {
+public:
+    // A missing file is an empty history
+    bool Load(const std::string &fileName);
+    bool Save(const std::string &fileName) const;
+
+    // Apply the recorded run of suite, if any
+    void Apply(Suite &suite) const;
+    void Record(const std::string &name, double seconds, size_t maxRssKb);
+
+private:
+    struct Entry
+    {
+        double seconds;
+        size_t maxRssKb;
+    };
+    std::map<std::string, Entry> m_entries;
+};
+
+// Longest expected first, with the suites that haven't run before at the
+// front in list order as their time is unknown
+void order_longest_first(std::vector<Suite> &suites);
+
+// Split the suites, in list order, into count shards and keep shard index,
+// counting from 0. By default suite i of the list goes to shard i % count, so
+// that every machine makes the same split from the same list. With byTime the
+// shards instead get about the same expected time, with the longest first
+// into the shard with the least time so far and suites without a history
+// counting as unknownSeconds, which only agrees between machines that share
+// the history.
+void select_shard(std::vector<Suite> &suites, unsigned index, unsigned count,
+                  bool byTime, double unknownSeconds);
+
+#endif // RUNNER_SUITES_H_
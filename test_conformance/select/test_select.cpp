@@ -14,6 +14,7 @@
 // limitations under the License.
 //
 #include "harness/compat.h"
+#include "harness/alloc.h"
 #include "harness/typeWrappers.h"
 
 #include <assert.h>
@@ -117,11 +118,7 @@ int int_log2(size_t value) {
 
 static void initSrcBuffer(void* src1, Type stype, MTdata d)
 {
-    unsigned int* s1 = (unsigned int *)src1;
-    size_t i;
-
-    for ( i=0 ; i < BUFFER_SIZE/sizeof(cl_int); i++)
-        s1[i]   = genrand_int32(d);
+    genrand_fill(d, (cl_uint *)src1, BUFFER_SIZE / sizeof(cl_int));
 }
 
 static void initCmpBuffer(void *cmp, Type cmptype, uint64_t start,
@@ -315,7 +312,10 @@ static int doTest(cl_command_queue queue, cl_context context, Type stype, Type c
     int err = CL_SUCCESS;
     MTdataHolder d(gRandomSeed);
     const size_t element_count[VECTOR_SIZE_COUNT] = { 1, 2, 3, 4, 8, 16 };
-    clMemWrapper src1, src2, cmp, dest;
+    clMemWrapper src1, src2, cmp;
+    // Each vector size writes its own dest so that all of them can be in
+    // flight at once for a block
+    clMemWrapper dest[VECTOR_SIZE_COUNT];
 
     cl_ulong blocks = type_size[stype] * 0x100000000ULL / BUFFER_SIZE;
     const size_t block_elements = BUFFER_SIZE / type_size[stype];
@@ -361,8 +361,12 @@ static int doTest(cl_command_queue queue, cl_context context, Type stype, Type c
     test_error_count(err, "Error: could not allocate src2 buffer\n");
     cmp = clCreateBuffer( context, CL_MEM_READ_ONLY, BUFFER_SIZE, NULL, &err );
     test_error_count(err, "Error: could not allocate cmp buffer\n");
-    dest = clCreateBuffer( context, CL_MEM_WRITE_ONLY, BUFFER_SIZE, NULL, &err );
-    test_error_count(err, "Error: could not allocate dest buffer\n");
+    for (size_t vecsize = 0; vecsize < VECTOR_SIZE_COUNT; ++vecsize)
+    {
+        dest[vecsize] = clCreateBuffer(context, CL_MEM_WRITE_ONLY, BUFFER_SIZE,
+                                       NULL, &err);
+        test_error_count(err, "Error: could not allocate dest buffer\n");
+    }
 
     programs[0] = makeSelectProgram(&kernels[0], context, stype, cmptype,
                                     element_count[0]);
@@ -384,7 +388,8 @@ static int doTest(cl_command_queue queue, cl_context context, Type stype, Type c
             return -1;
         }
 
-        err = clSetKernelArg(kernels[vecsize], 0, sizeof dest, &dest);
+        err = clSetKernelArg(kernels[vecsize], 0, sizeof dest[vecsize],
+                             &dest[vecsize]);
         test_error_count(err, "Error: Cannot set kernel arg dest!\n");
         err = clSetKernelArg(kernels[vecsize], 1, sizeof src1, &src1);
         test_error_count(err, "Error: Cannot set kernel arg dest!\n");
@@ -394,12 +399,12 @@ static int doTest(cl_command_queue queue, cl_context context, Type stype, Type c
         test_error_count(err, "Error: Cannot set kernel arg dest!\n");
     }
 
-    std::vector<char> ref(BUFFER_SIZE);
-    std::vector<char> sref(BUFFER_SIZE);
-    std::vector<char> src1_host(BUFFER_SIZE);
-    std::vector<char> src2_host(BUFFER_SIZE);
-    std::vector<char> cmp_host(BUFFER_SIZE);
-    std::vector<char> dest_host(BUFFER_SIZE);
+    ScratchArray<char> ref(BUFFER_SIZE);
+    ScratchArray<char> sref(BUFFER_SIZE);
+    ScratchArray<char> src1_host(BUFFER_SIZE);
+    ScratchArray<char> src2_host(BUFFER_SIZE);
+    ScratchArray<char> cmp_host(BUFFER_SIZE);
+    ScratchArray<char> dest_host(BUFFER_SIZE * VECTOR_SIZE_COUNT);
 
     // We block the test as we are running over the range of compare values
     // "block the test" means "break the test into blocks"
@@ -411,54 +416,69 @@ static int doTest(cl_command_queue queue, cl_context context, Type stype, Type c
     log_info("Testing...");
     uint64_t i;
 
+    // The sources are the same for every block, so they only go over once
     initSrcBuffer(src1_host.data(), stype, d);
     initSrcBuffer(src2_host.data(), stype, d);
+    err = clEnqueueWriteBuffer(queue, src1, CL_FALSE, 0, BUFFER_SIZE,
+                               src1_host.data(), 0, NULL, NULL);
+    test_error_count(err, "Error: Could not write src1");
+
+    err = clEnqueueWriteBuffer(queue, src2, CL_FALSE, 0, BUFFER_SIZE,
+                               src2_host.data(), 0, NULL, NULL);
+    test_error_count(err, "Error: Could not write src2");
+
     for (i=0; i < blocks; i+=step)
     {
         initCmpBuffer(cmp_host.data(), cmptype, i * cmp_stride, block_elements);
 
-        err = clEnqueueWriteBuffer(queue, src1, CL_FALSE, 0, BUFFER_SIZE,
-                                   src1_host.data(), 0, NULL, NULL);
-        test_error_count(err, "Error: Could not write src1");
-
-        err = clEnqueueWriteBuffer(queue, src2, CL_FALSE, 0, BUFFER_SIZE,
-                                   src2_host.data(), 0, NULL, NULL);
-        test_error_count(err, "Error: Could not write src2");
-
+        // The write has to land before cmp_host is refilled for the next
+        // block; the clFinish at the end of this one guarantees that.
         err = clEnqueueWriteBuffer(queue, cmp, CL_FALSE, 0, BUFFER_SIZE,
                                    cmp_host.data(), 0, NULL, NULL);
         test_error_count(err, "Error: Could not write cmp");
 
-        Select sfunc = (cmptype == ctype[stype][0]) ? vrefSelects[stype][0]
-                                                    : vrefSelects[stype][1];
-        (*sfunc)(ref.data(), src1_host.data(), src2_host.data(),
-                 cmp_host.data(), block_elements);
-
-        sfunc = (cmptype == ctype[stype][0]) ? refSelects[stype][0]
-                                             : refSelects[stype][1];
-        (*sfunc)(sref.data(), src1_host.data(), src2_host.data(),
-                 cmp_host.data(), block_elements);
-
+        // Queue every vector size for this block up front, so the device
+        // works through them while the references are computed below
         for (int vecsize = 0; vecsize < VECTOR_SIZE_COUNT; ++vecsize)
         {
             size_t vector_size = element_count[vecsize] * type_size[stype];
             size_t vector_count =  (BUFFER_SIZE + vector_size - 1) / vector_size;
 
             const cl_int pattern = -1;
-            err = clEnqueueFillBuffer(queue, dest, &pattern, sizeof(cl_int), 0,
-                                      BUFFER_SIZE, 0, nullptr, nullptr);
+            err = clEnqueueFillBuffer(queue, dest[vecsize], &pattern,
+                                      sizeof(cl_int), 0, BUFFER_SIZE, 0,
+                                      nullptr, nullptr);
             test_error_count(err, "clEnqueueFillBuffer failed");
 
-
             err = clEnqueueNDRangeKernel(queue, kernels[vecsize], 1, NULL, &vector_count, NULL, 0, NULL, NULL);
             test_error_count(err, "clEnqueueNDRangeKernel failed errcode\n");
 
-            err = clEnqueueReadBuffer(queue, dest, CL_TRUE, 0, BUFFER_SIZE,
-                                      dest_host.data(), 0, NULL, NULL);
+            err = clEnqueueReadBuffer(queue, dest[vecsize], CL_FALSE, 0,
+                                      BUFFER_SIZE,
+                                      dest_host.data() + vecsize * BUFFER_SIZE,
+                                      0, NULL, NULL);
             test_error_count(
                 err, "Error: Reading buffer from dest to dest_host failed\n");
+        }
+        err = clFlush(queue);
+        test_error_count(err, "clFlush failed");
+
+        Select sfunc = (cmptype == ctype[stype][0]) ? vrefSelects[stype][0]
+                                                    : vrefSelects[stype][1];
+        (*sfunc)(ref.data(), src1_host.data(), src2_host.data(),
+                 cmp_host.data(), block_elements);
 
-            if ((*checkResults[stype])(dest_host.data(),
+        sfunc = (cmptype == ctype[stype][0]) ? refSelects[stype][0]
+                                             : refSelects[stype][1];
+        (*sfunc)(sref.data(), src1_host.data(), src2_host.data(),
+                 cmp_host.data(), block_elements);
+
+        err = clFinish(queue);
+        test_error_count(err, "clFinish failed");
+
+        for (int vecsize = 0; vecsize < VECTOR_SIZE_COUNT; ++vecsize)
+        {
+            if ((*checkResults[stype])(dest_host.data() + vecsize * BUFFER_SIZE,
                                        vecsize == 0 ? sref.data() : ref.data(),
                                        block_elements, element_count[vecsize])
                 != 0)
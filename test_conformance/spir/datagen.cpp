@@ -19,6 +19,68 @@
 
 RandomGenerator gRG;
 
+const size_t RandomGenerator::kFillBatch;
+
+void RandomGenerator::fillValues(cl_float* out, size_t n, cl_float low, cl_float high)
+{
+    FillJob<cl_float> job = { NULL, NULL, 0, 0, low, high };
+    for (size_t done = 0; done < n; done += job.count)
+    {
+        job.out = out + done;
+        job.count = std::min(n - done, kFillBatch);
+        job.words = drawWords(job.count);
+        job.jobs = fillJobs(job.count);
+        runFillJobs(fillFloatJob, job.jobs, &job);
+    }
+}
+
+void RandomGenerator::fillValues(cl_double* out, size_t n, cl_double low, cl_double high)
+{
+    // get_random_double draws its two words within one expression, so the
+    // order they are used in is up to the compiler and only it can draw them
+    for (size_t i = 0; i < n; ++i)
+    {
+        out[i] = getNext<cl_double>(low, high);
+    }
+}
+
+cl_int RandomGenerator::fillFloatJob(cl_uint job_id, cl_uint thread_id, void* userInfo)
+{
+    const FillJob<cl_float>* job = (const FillJob<cl_float>*)userInfo;
+    size_t begin = job->count * job_id / job->jobs;
+    size_t end = job->count * (job_id + 1) / job->jobs;
+    for (size_t i = begin; i < end; ++i)
+    {
+        job->out[i] = get_random_float_from_word(job->low, job->high, job->words[i]);
+    }
+    return CL_SUCCESS;
+}
+
+const cl_uint* RandomGenerator::drawWords(size_t count)
+{
+    m_words.resize(count);
+    genrand_fill(m_d, m_words.data(), count);
+    return m_words.data();
+}
+
+cl_uint RandomGenerator::fillJobs(size_t count)
+{
+    // Below this many values per job the pool costs more than it saves
+    const size_t minValuesPerJob = 1 << 16;
+    size_t jobs = std::min<size_t>(GetThreadCount(), count / minValuesPerJob);
+    return jobs ? (cl_uint)jobs : 1;
+}
+
+void RandomGenerator::runFillJobs(cl_int (*job)(cl_uint, cl_uint, void*), cl_uint jobs, void* userInfo)
+{
+    cl_int error = jobs > 1 ? ThreadPool_Do(job, jobs, userInfo)
+                            : job(0, 0, userInfo);
+    if (error != CL_SUCCESS)
+    {
+        throw Exceptions::TestError("Unable to generate random kernel argument data\n", error);
+    }
+}
+
 size_t WorkSizeInfo::getGlobalWorkSize() const
 {
     switch( work_dim )
@@ -28,6 +28,7 @@
 #include <algorithm>
 
 #include "harness/mt19937.h"
+#include "harness/ThreadPool.h"
 
 #include "exceptions.h"
 #include "kernelargs.h"
@@ -75,6 +76,8 @@
 double get_random_double(double low, double high, MTdata d);
 float get_random_float(float low, float high, MTdata d);
 size_t get_random_size_t(size_t low, size_t high, MTdata d);
+float get_random_float_from_word(float low, float high, cl_uint word);
+size_t get_random_size_t_from_words(size_t low, size_t high, const cl_uint *words);
 
 /**
  Simple container for the work size information
@@ -121,6 +124,78 @@ public:
         return T();
     }
 
+    /**
+     Fills out with the n values n calls to getNext would return. The words
+     are drawn from the generator in bulk and, for large fills, turned into
+     values on the thread pool.
+     */
+    template<class T> void fill(T* out, size_t n, T low, T high)
+    {
+        fillValues(out, n, low, high);
+    }
+
+private:
+    // Values converted from the words of one batch by the thread pool
+    template<class T> struct FillJob
+    {
+        T* out;
+        const cl_uint* words;
+        size_t count;
+        cl_uint jobs;
+        T low;
+        T high;
+    };
+
+    // The integer types, which getNext makes with get_random_size_t
+    template<class T> void fillValues(T* out, size_t n, T low, T high)
+    {
+        const size_t wordsPerValue = sizeof(size_t) / sizeof(cl_uint);
+        FillJob<T> job = { NULL, NULL, 0, 0, low, high };
+        for (size_t done = 0; done < n; done += job.count)
+        {
+            job.out = out + done;
+            job.count = std::min(n - done, kFillBatch);
+            job.words = drawWords(job.count * wordsPerValue);
+            job.jobs = fillJobs(job.count);
+            runFillJobs(fillSizeTJob<T>, job.jobs, &job);
+        }
+    }
+
+    void fillValues(cl_float* out, size_t n, cl_float low, cl_float high);
+    void fillValues(cl_double* out, size_t n, cl_double low, cl_double high);
+
+    template<class T> static cl_int fillSizeTJob(cl_uint job_id, cl_uint thread_id, void* userInfo)
+    {
+        const size_t wordsPerValue = sizeof(size_t) / sizeof(cl_uint);
+        const FillJob<T>* job = (const FillJob<T>*)userInfo;
+        size_t begin = job->count * job_id / job->jobs;
+        size_t end = job->count * (job_id + 1) / job->jobs;
+        for (size_t i = begin; i < end; ++i)
+        {
+            job->out[i] = (T)get_random_size_t_from_words((size_t)job->low, (size_t)job->high,
+                                                          job->words + i * wordsPerValue);
+        }
+        return CL_SUCCESS;
+    }
+
+    static cl_int fillFloatJob(cl_uint job_id, cl_uint thread_id, void* userInfo);
+
+    // The next count words of the generator, valid until the next call
+    const cl_uint* drawWords(size_t count);
+    // Jobs to split the conversion of count values across
+    static cl_uint fillJobs(size_t count);
+    static void runFillJobs(cl_int (*job)(cl_uint, cl_uint, void*), cl_uint jobs, void* userInfo);
+
+    // Values drawn and converted at a time, which bounds the words held
+    static const size_t kFillBatch = 1 << 20;
+
+    std::vector<cl_uint> m_words;
+
+#ifndef ESINNS
+    // for the specializations of getNext that follow in the class
+public:
+#endif
+
 #ifdef ESINNS
 
 private:
@@ -352,10 +427,7 @@ protected:
 
     void fillBuffer( cl_char * ptr, size_t nelem)
     {
-        for( size_t i = 0; i < nelem; ++i )
-        {
-            ptr[i]  = gRG.getNext<cl_char>(m_minValue, m_maxValue);
-        }
+        gRG.fill<cl_char>(ptr, nelem, m_minValue, m_maxValue);
     }
 
 protected:
@@ -914,10 +986,7 @@ public:
 private:
     void fillBuffer( T* buffer, size_t nelem)
     {
-        for( size_t i = 0; i < nelem; ++i )
-        {
-            buffer[i]  = gRG.getNext<T>(m_minValue, m_maxValue);
-        }
+        gRG.fill<T>(buffer, nelem, m_minValue, m_maxValue);
     }
 
 private:
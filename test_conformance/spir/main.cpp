@@ -193,11 +193,9 @@ static void printError(const std::string& S){
   std::cerr << S << std::endl;
 }
 
-// Extracts suite with the given name, and saves it to disk.
+// Loads the archive of the suite with the given name into memory.
 static void extract_suite(const char *suiteName)
 {
-  mz_zip_archive zip_archive;
-
   // Composing the name of the archive.
   char* dir = get_exe_dir();
   std::string archiveName(dir);
@@ -206,70 +204,7 @@ static void extract_suite(const char *suiteName)
   archiveName.append(".zip");
   free(dir);
 
-#if defined(_WIN32)
-      _mkdir(suiteName);
-#else
-      mkdir(suiteName, S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
-#endif
-
-  memset(&zip_archive, 0, sizeof(zip_archive));
-  if (!mz_zip_reader_init_file(&zip_archive, archiveName.c_str(), 0))
-      throw Exceptions::ArchiveError(MZ_DATA_ERROR);
-
-  // Get and print information about each file in the archive.
-  for (size_t i = 0; i < mz_zip_reader_get_num_files(&zip_archive); i++)
-  {
-      mz_zip_archive_file_stat fileStat;
-      size_t fileSize = 0;
-
-      if (!mz_zip_reader_file_stat(&zip_archive, i, &fileStat))
-      {
-          mz_zip_reader_end(&zip_archive);
-          throw Exceptions::ArchiveError(MZ_DATA_ERROR);
-      }
-      const std::string fileName = fileStat.m_filename;
-
-      // If the file is a directory, skip it. We create suite folder at the beggining.
-      if (mz_zip_reader_is_file_a_directory(&zip_archive, fileStat.m_file_index))
-      {
-          continue;
-      }
-
-      // Extracting the file.
-      void *p = mz_zip_reader_extract_file_to_heap(&zip_archive,
-                                                   fileName.c_str(),
-                                                   &fileSize, 0);
-      if (!p)
-      {
-          mz_zip_reader_end(&zip_archive);
-          throw std::runtime_error("mz_zip_reader_extract_file_to_heap() failed!\n");
-      }
-
-      // Writing the file back to the disk
-      std::fstream file(fileName.c_str(),
-                        std::ios_base::trunc | std::ios_base::in |
-                        std::ios_base::out | std::ios_base::binary);
-      if (!file.is_open())
-      {
-          std::string msg = "Failed to open ";
-          msg.append(fileName);
-          throw Exceptions::TestError(msg);
-      }
-
-      file.write((const char*)p, fileSize);
-      if (file.bad())
-      {
-          std::string msg("Failed to write into ");
-          msg.append(fileName);
-          throw Exceptions::TestError(msg);
-      }
-
-      // Cleanup.
-      file.flush();
-      file.close();
-      free(p);
-  }
-  mz_zip_reader_end(&zip_archive);
+  load_suite_archive(archiveName);
 }
 
 //
@@ -300,18 +235,34 @@ bool test_suite(cl_device_id device, cl_uint size_t_width, const char *folder,
     unsigned int tests_passed = 0;
     CounterEventHandler SuccE(tests_passed, number_of_tests);
     std::list<std::string> ErrList;
+    bool extensionMissing = (strlen(extension) != 0)
+        && (!is_extension_available(device, extension));
+
+    // The programs of the next test are built while the current one runs.
+    // The kernels themselves run one test at a time, as the data generator
+    // is shared by all of them.
+    std::unique_ptr<ProgramBuild> nextBuild;
+    if (!extensionMissing && number_of_tests > 0)
+        nextBuild.reset(new ProgramBuild(device, deviceCapabilities, folder,
+                                         test_name[0], size_t_width));
     for (unsigned int i = 0; i < number_of_tests; ++i)
     {
         AccumulatorEventHandler FailE(ErrList, test_name[i]);
-        if((strlen(extension) != 0) && (!is_extension_available(device, extension)))
+        if(extensionMissing)
         {
             (SuccE)(test_name[i], "");
             std::cout << test_name[i] << "... Skipped. (Cannot run on device due to missing extension: " << extension << " )." << std::endl;
             continue;
         }
+        std::unique_ptr<ProgramBuild> build(std::move(nextBuild));
+        if (i + 1 < number_of_tests)
+            nextBuild.reset(new ProgramBuild(device, deviceCapabilities,
+                                             folder, test_name[i + 1],
+                                             size_t_width));
         TestRunner testRunner(&SuccE, &FailE, deviceCapabilities);
-        testRunner.runBuildTest(device, folder, test_name[i], size_t_width);
+        testRunner.runBuildTest(*build);
     }
+    release_device_contexts();
 
     std::cout << std::endl;
     std::cout << "PASSED " << tests_passed << " of " << number_of_tests << " tests.\n" << std::endl;
@@ -6950,6 +6901,7 @@ int main (int argc, const char* argv[])
                 try_extract(folder.c_str());
                 if (!runner.runBuildTest(device, folder.c_str(), test_file_name.c_str(), size_t_width))
                     failed++;
+                release_device_contexts();
             }
         }
         else
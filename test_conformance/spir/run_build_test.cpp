@@ -25,6 +25,7 @@
 #include <fstream>
 #include <assert.h>
 #include <functional>
+#include <map>
 #include <memory>
 
 #include "harness/errorHelpers.h"
@@ -336,18 +337,58 @@ static float get_max_ulps(const char *test_name)
     return ulps;
 }
 
-TestRunner::TestRunner(EventHandler *success, EventHandler *failure,
-                       const OclExtensions& devExt):
-    m_successHandler(success), m_failureHandler(failure), m_devExt(&devExt) {}
+//
+// Device contexts
+//
+namespace {
+struct DeviceContext {
+    clContextWrapper      context;
+    clCommandQueueWrapper queue;
+};
+}
 
 /**
- Based on the test name build the cl file name, the bc file name and execute
- the kernel for both modes (cl and bc).
+ Contexts and queues shared by the tests run on each device, so a context is
+ not created for every test file.
  */
-bool TestRunner::runBuildTest(cl_device_id device, const char *folder,
-                              const char *test_name, cl_uint size_t_width)
+static std::map<cl_device_id, DeviceContext> s_device_contexts;
+
+static void get_device_context(cl_device_id device, clContextWrapper& context,
+                               clCommandQueueWrapper& queue)
+{
+    DeviceContext& entry = s_device_contexts[device];
+    if (!entry.queue)
+    {
+        entry.context.reset();
+        create_context_and_queue(device, &entry.context, &entry.queue);
+    }
+    context = entry.context;
+    queue = entry.queue;
+}
+
+/**
+ A failing test may leave its queue in an error state, so the tests after it
+ get a fresh context.
+ */
+static void drop_device_context(cl_device_id device)
+{
+    s_device_contexts.erase(device);
+}
+
+void release_device_contexts()
+{
+    s_device_contexts.clear();
+}
+
+//
+// ProgramBuild
+//
+ProgramBuild::ProgramBuild(cl_device_id device, const OclExtensions& devExt,
+                           const char *folder, const char *test_name,
+                           cl_uint size_t_width):
+    m_device(device), m_folder(folder), m_testName(test_name),
+    m_sizeTWidth(size_t_width), m_built(false)
 {
-    int failures = 0;
     // Composing the name of the CSV file.
     char* dir = get_exe_dir();
     std::string csvName(dir);
@@ -355,57 +396,35 @@ bool TestRunner::runBuildTest(cl_device_id device, const char *folder,
     csvName.append("khr.csv");
     free(dir);
 
-    log_info("%s...\n", test_name);
-
-    float ulps = get_max_ulps(test_name);
-
     // Figure out whether the test can run on the device. If not, we skip it.
     const KhrSupport& khrDb = *KhrSupport::get(csvName);
     cl_bool images = khrDb.isImagesRequired(folder, test_name);
     cl_bool images3D = khrDb.isImages3DRequired(folder, test_name);
 
-    char deviceProfile[64];
-    clGetDeviceInfo(device, CL_DEVICE_PROFILE, sizeof(deviceProfile), &deviceProfile, NULL);
-    std::string device_profile(deviceProfile, 64);
-
     if(images == CL_TRUE && checkForImageSupport(device) != 0)
     {
-        (*m_successHandler)(test_name, "");
-        std::cout << "Skipped. (Cannot run on device due to Images is not supported)." << std::endl;
-        return true;
+        m_skipReason = "Cannot run on device due to Images is not supported";
+        return;
     }
 
     if(images3D == CL_TRUE && checkFor3DImageSupport(device) != 0)
     {
-        (*m_successHandler)(test_name, "");
-        std::cout << "Skipped. (Cannot run on device as 3D images are not supported)." << std::endl;
-        return true;
+        m_skipReason = "Cannot run on device as 3D images are not supported";
+        return;
     }
 
     OclExtensions requiredExt = khrDb.getRequiredExtensions(folder, test_name);
-    if(!m_devExt->supports(requiredExt))
+    if(!devExt.supports(requiredExt))
     {
-        (*m_successHandler)(test_name, "");
-        std::cout << "Skipped. (Cannot run on device due to missing extensions: " << m_devExt->get_missing(requiredExt) << " )." << std::endl;
-        return true;
+        std::ostringstream reason;
+        reason << "Cannot run on device due to missing extensions: "
+               << devExt.get_missing(requiredExt) << " ";
+        m_skipReason = reason.str();
+        return;
     }
 
-    std::string cl_file_path, bc_file;
-    // Build cl file name based on the test name
-    get_cl_file_path(folder, test_name, cl_file_path);
-    // Build bc file name based on the test name
-    get_bc_file_path(folder, test_name, bc_file, size_t_width);
-    gRG.init(1);
-    //
-    // Processing each kernel in the program separately
-    //
-    clContextWrapper context;
-    clCommandQueueWrapper queue;
-    create_context_and_queue(device, &context, &queue);
-    clProgramWrapper clprog = create_program_from_cl(context, cl_file_path);
-    clProgramWrapper bcprog = create_program_from_bc(context, bc_file);
-    std::string bcoptions = "-x spir -spir-std=1.2 -cl-kernel-arg-info";
-    std::string cloptions = "-cl-kernel-arg-info";
+    m_bcoptions = "-x spir -spir-std=1.2 -cl-kernel-arg-info";
+    m_cloptions = "-cl-kernel-arg-info";
 
     cl_device_fp_config gFloatCapabilities = 0;
     cl_int err;
@@ -416,28 +435,147 @@ bool TestRunner::runBuildTest(cl_device_id device, const char *folder,
 
     if (strstr(test_name, "div_cr") || strstr(test_name, "sqrt_cr")) {
         if ((gFloatCapabilities & CL_FP_CORRECTLY_ROUNDED_DIVIDE_SQRT) == 0) {
-            (*m_successHandler)(test_name, "");
-            std::cout << "Skipped. (Cannot run on device due to missing CL_FP_CORRECTLY_ROUNDED_DIVIDE_SQRT property.)" << std::endl;
-            return true;
+            m_skipReason = "Cannot run on device due to missing CL_FP_CORRECTLY_ROUNDED_DIVIDE_SQRT property";
+            return;
         } else {
-            bcoptions += " -cl-fp32-correctly-rounded-divide-sqrt";
-            cloptions += " -cl-fp32-correctly-rounded-divide-sqrt";
+            m_bcoptions += " -cl-fp32-correctly-rounded-divide-sqrt";
+            m_cloptions += " -cl-fp32-correctly-rounded-divide-sqrt";
         }
     }
 
-    // Building the programs.
-    BuildTask clBuild(clprog, device, cloptions.c_str());
-    if (!clBuild.execute()) {
-        std::cerr << clBuild.getErrorLog() << std::endl;
-        return false;
+    get_device_context(device, m_context, m_queue);
+    m_thread = std::thread(&ProgramBuild::build, this);
+}
+
+ProgramBuild::~ProgramBuild()
+{
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+/**
+ Runs on the build thread, so it doesn't log: errors are kept until wait().
+ */
+void ProgramBuild::build()
+{
+    try
+    {
+        std::string cl_file_path, bc_file;
+        // Build cl file name based on the test name
+        get_cl_file_path(m_folder.c_str(), m_testName.c_str(), cl_file_path);
+        // Build bc file name based on the test name
+        get_bc_file_path(m_folder.c_str(), m_testName.c_str(), bc_file,
+                         m_sizeTWidth);
+
+        m_clprog = create_program_from_cl(m_context, cl_file_path);
+        m_bcprog = create_program_from_bc(m_context, bc_file);
+
+        // Building the programs.
+        BuildTask clBuild(m_clprog, m_device, m_cloptions.c_str());
+        if (!clBuild.execute()) {
+            m_log = clBuild.getErrorLog();
+            return;
+        }
+
+        SpirBuildTask bcBuild(m_bcprog, m_device, m_bcoptions.c_str());
+        if (!bcBuild.execute()) {
+            m_log = bcBuild.getErrorLog();
+            return;
+        }
+        m_built = true;
+    }
+    catch (...)
+    {
+        m_error = std::current_exception();
+    }
+}
+
+const std::string& ProgramBuild::getSkipReason() const {
+    return m_skipReason;
+}
+
+bool ProgramBuild::wait() {
+    if (m_thread.joinable())
+        m_thread.join();
+    if (m_error)
+        std::rethrow_exception(m_error);
+    return m_built;
+}
+
+const char* ProgramBuild::getErrorLog() const {
+    return m_log.c_str();
+}
+
+const char* ProgramBuild::getTestName() const {
+    return m_testName.c_str();
+}
+
+cl_device_id ProgramBuild::getDevice() const {
+    return m_device;
+}
+
+cl_context ProgramBuild::getContext() const {
+    return m_context;
+}
+
+cl_command_queue ProgramBuild::getQueue() const {
+    return m_queue;
+}
+
+cl_program ProgramBuild::getClProgram() const {
+    return m_clprog;
+}
+
+cl_program ProgramBuild::getBcProgram() const {
+    return m_bcprog;
+}
+
+TestRunner::TestRunner(EventHandler *success, EventHandler *failure,
+                       const OclExtensions& devExt):
+    m_successHandler(success), m_failureHandler(failure), m_devExt(&devExt) {}
+
+/**
+ Based on the test name build the cl file name, the bc file name and execute
+ the kernel for both modes (cl and bc).
+ */
+bool TestRunner::runBuildTest(cl_device_id device, const char *folder,
+                              const char *test_name, cl_uint size_t_width)
+{
+    ProgramBuild build(device, *m_devExt, folder, test_name, size_t_width);
+    return runBuildTest(build);
+}
+
+bool TestRunner::runBuildTest(ProgramBuild& build)
+{
+    int failures = 0;
+    const char *test_name = build.getTestName();
+
+    log_info("%s...\n", test_name);
+
+    float ulps = get_max_ulps(test_name);
+
+    if (!build.getSkipReason().empty())
+    {
+        (*m_successHandler)(test_name, "");
+        std::cout << "Skipped. (" << build.getSkipReason() << ")." << std::endl;
+        return true;
     }
 
-    SpirBuildTask bcBuild(bcprog, device, bcoptions.c_str());
-    if (!bcBuild.execute()) {
-        std::cerr << bcBuild.getErrorLog() << std::endl;
+    if (!build.wait()) {
+        std::cerr << build.getErrorLog() << std::endl;
         return false;
     }
 
+    gRG.init(1);
+    //
+    // Processing each kernel in the program separately
+    //
+    cl_device_id device = build.getDevice();
+    cl_context context = build.getContext();
+    cl_command_queue queue = build.getQueue();
+    cl_program clprog = build.getClProgram();
+    cl_program bcprog = build.getBcProgram();
+
     KernelEnumerator clkernel_enumerator(clprog),
                      bckernel_enumerator(bcprog);
     if (clkernel_enumerator.size() != bckernel_enumerator.size()) {
@@ -473,7 +611,9 @@ bool TestRunner::runBuildTest(cl_device_id device, const char *folder,
         }
     }
 
+    if (failures)
+        drop_device_context(device);
+
     log_info("%s %s\n", test_name, failures ? "FAILED" : "passed.");
     return failures == 0;
 }
-
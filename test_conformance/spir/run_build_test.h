@@ -20,6 +20,10 @@
 #include <list>
 #include <vector>
 #include <utility>
+#include <exception>
+#include <thread>
+
+#include "harness/typeWrappers.h"
 
 class OclExtensions;
 
@@ -114,6 +118,63 @@ private:
     cl_context   m_context;
 };
 
+/*
+ * Builds the CL and SPIR programs of a single test. The programs are created
+ * in the context shared by all the tests run on the device, and are built on
+ * a separate thread so that the build can overlap with the previous test.
+ */
+class ProgramBuild{
+public:
+    ProgramBuild(cl_device_id device, const OclExtensions& devExt,
+                 const char *folder, const char *test_name,
+                 cl_uint size_t_width);
+
+    ~ProgramBuild();
+
+    // Reason the test can't run on the device, empty if it can.
+    const std::string& getSkipReason() const;
+
+    // Waits for the build to finish. Returns false if one of the programs
+    // failed to build, and rethrows errors raised while creating them.
+    bool wait();
+
+    const char* getErrorLog() const;
+
+    const char* getTestName() const;
+    cl_device_id getDevice() const;
+    cl_context getContext() const;
+    cl_command_queue getQueue() const;
+    cl_program getClProgram() const;
+    cl_program getBcProgram() const;
+
+private:
+    ProgramBuild(const ProgramBuild&);
+    ProgramBuild& operator=(const ProgramBuild&);
+
+    void build();
+
+    cl_device_id          m_device;
+    std::string           m_folder;
+    std::string           m_testName;
+    cl_uint               m_sizeTWidth;
+    std::string           m_skipReason;
+    std::string           m_cloptions;
+    std::string           m_bcoptions;
+    clContextWrapper      m_context;
+    clCommandQueueWrapper m_queue;
+    clProgramWrapper      m_clprog;
+    clProgramWrapper      m_bcprog;
+    std::thread           m_thread;
+    std::exception_ptr    m_error;
+    std::string           m_log;
+    bool                  m_built;
+};
+
+/*
+ * Releases the contexts shared by the tests run on each device.
+ */
+void release_device_contexts();
+
 class TestRunner{
     EventHandler*const m_successHandler, *const m_failureHandler;
     const OclExtensions *m_devExt;
@@ -124,6 +185,9 @@ public:
 
     bool runBuildTest(cl_device_id device, const char *folder,
                       const char *test_name, cl_uint size_t_width);
+
+    // Runs the kernels of a test whose programs were built by the given build.
+    bool runBuildTest(ProgramBuild& build);
 };
 
 //
@@ -21,14 +21,19 @@
 #include <CL/cl.h>
 #endif
 
+#include <algorithm>
 #include <assert.h>
 #include <string>
 #include <fstream>
 #include <iterator>
+#include <map>
 #include <memory>
+#include <set>
 #include <sstream>
 #include <vector>
 
+#include "harness/ThreadPool.h"
+
 #include "exceptions.h"
 #include "datagen.h"
 #include "run_services.h"
@@ -123,11 +128,115 @@ void create_context_and_queue(cl_device_id device, cl_context *out_context, cl_c
     }
 }
 
+/**
+ Files decompressed from the suite archives, by their path in the archive.
+ Entries are shared by every sub-suite that uses the same folder.
+ */
+static std::map<std::string, std::vector<char> > s_archive_files;
+static std::set<std::string> s_loaded_archives;
+
+struct ArchiveLoadInfo
+{
+    std::vector<char> archive;
+    std::vector<mz_uint> indices;
+    std::vector<std::vector<char>*> outputs;
+    cl_uint jobs;
+};
+
+static cl_int decompress_archive_entries(cl_uint job_id, cl_uint thread_id,
+                                         void *userInfo)
+{
+    ArchiveLoadInfo *info = (ArchiveLoadInfo *)userInfo;
+
+    // Each job reads through its own archive state, as miniz readers may not
+    // be shared between threads.
+    mz_zip_archive zip_archive;
+    memset(&zip_archive, 0, sizeof(zip_archive));
+    if (!mz_zip_reader_init_mem(&zip_archive, info->archive.data(),
+                                info->archive.size(), 0))
+        return MZ_DATA_ERROR;
+
+    cl_int result = CL_SUCCESS;
+    for (size_t i = job_id; i < info->indices.size(); i += info->jobs)
+    {
+        size_t size = 0;
+        void *p = mz_zip_reader_extract_to_heap(&zip_archive, info->indices[i],
+                                                &size, 0);
+        if (!p)
+        {
+            result = MZ_DATA_ERROR;
+            break;
+        }
+        info->outputs[i]->assign((const char *)p, (const char *)p + size);
+        mz_free(p);
+    }
+
+    mz_zip_reader_end(&zip_archive);
+    return result;
+}
+
+/**
+ Decompresses every file of the given archive into memory, in parallel
+ */
+void load_suite_archive(const std::string& archive_name)
+{
+    if (s_loaded_archives.count(archive_name)) return;
+
+    ArchiveLoadInfo info;
+    {
+        std::ifstream file(archive_name.c_str(), std::ios::binary);
+        if (!file.good()) throw Exceptions::ArchiveError(MZ_DATA_ERROR);
+        info.archive.assign(std::istreambuf_iterator<char>(file),
+                            std::istreambuf_iterator<char>());
+    }
+
+    mz_zip_archive zip_archive;
+    memset(&zip_archive, 0, sizeof(zip_archive));
+    if (!mz_zip_reader_init_mem(&zip_archive, info.archive.data(),
+                                info.archive.size(), 0))
+        throw Exceptions::ArchiveError(MZ_DATA_ERROR);
+
+    for (mz_uint i = 0; i < mz_zip_reader_get_num_files(&zip_archive); i++)
+    {
+        mz_zip_archive_file_stat fileStat;
+        if (!mz_zip_reader_file_stat(&zip_archive, i, &fileStat))
+        {
+            mz_zip_reader_end(&zip_archive);
+            throw Exceptions::ArchiveError(MZ_DATA_ERROR);
+        }
+        if (mz_zip_reader_is_file_a_directory(&zip_archive, i)) continue;
+
+        info.indices.push_back(i);
+        info.outputs.push_back(&s_archive_files[fileStat.m_filename]);
+    }
+    mz_zip_reader_end(&zip_archive);
+
+    info.jobs = (cl_uint)std::min<size_t>(info.indices.size(),
+                                          GetThreadCount());
+    if (info.jobs == 0) return;
+
+    cl_int error = info.jobs > 1
+        ? ThreadPool_Do(decompress_archive_entries, info.jobs, &info)
+        : decompress_archive_entries(0, 0, &info);
+    if (error != CL_SUCCESS) throw Exceptions::ArchiveError(MZ_DATA_ERROR);
+
+    s_loaded_archives.insert(archive_name);
+}
+
+static const std::vector<char>* find_archive_file(const std::string& file_name)
+{
+    auto it = s_archive_files.find(file_name);
+    return it == s_archive_files.end() ? NULL : &it->second;
+}
+
 /**
  Loads the kernel text from the given text file
  */
 std::string load_file_cl( const std::string& file_name)
 {
+    if (const std::vector<char>* data = find_archive_file(file_name))
+        return std::string(data->begin(), data->end());
+
     std::ifstream ifs(file_name.c_str());
     if( !ifs.good() )
         throw Exceptions::TestError("Can't load the cl File " + file_name, 1);
@@ -142,6 +251,14 @@ void* load_file_bc( const std::string& file_name, size_t *binary_size)
 {
     assert(binary_size && "binary_size arg should be valid");
 
+    if (const std::vector<char>* data = find_archive_file(file_name))
+    {
+        *binary_size = data->size();
+        void* buffer = malloc(*binary_size);
+        memcpy(buffer, data->data(), *binary_size);
+        return buffer;
+    }
+
     std::ifstream file(file_name.c_str(), std::ios::binary);
 
     if( !file.good() )
@@ -533,10 +650,35 @@ void KhrSupport::parseCSV(std::fstream& f)
     while (!f.getline(line, sizeof(line)).eof())
     {
         DataRow *dr = parseLine(std::string(line));
+        m_index[std::make_pair((*dr)[SUITE_INDEX], (*dr)[TEST_INDEX])]
+            .push_back(m_dt.getNumRows());
         m_dt.addTableRow(dr);
     }
 }
 
+void KhrSupport::findRows(const char* suite, const char* test,
+                          std::vector<size_t>& rows) const
+{
+    const std::string strSuite(suite), strTest(test);
+    rows.clear();
+
+    // Rows naming the test itself, and the rows that apply to the whole suite.
+    RowIndex::const_iterator it =
+        m_index.find(std::make_pair(strSuite, strTest));
+    if (it != m_index.end())
+        rows.insert(rows.end(), it->second.begin(), it->second.end());
+
+    if (strTest != "*")
+    {
+        it = m_index.find(std::make_pair(strSuite, std::string("*")));
+        if (it != m_index.end())
+            rows.insert(rows.end(), it->second.begin(), it->second.end());
+    }
+
+    // Keep the order of the file, the first matching row wins.
+    std::sort(rows.begin(), rows.end());
+}
+
 DataRow* KhrSupport::parseLine(const std::string& line)
 {
     const char DELIM = ',';
@@ -573,18 +715,12 @@ OclExtensions KhrSupport::getRequiredExtensions(const char* suite, const char* t
 {
     OclExtensions ret = OclExtensions::empty();
 
-    const std::string strSuite(suite), strTest(test);
-    // Iterating on the DataTable, searching whether the row with th requested
-    // row exists.
-    for(size_t rowIndex = 0; rowIndex < m_dt.getNumRows(); rowIndex++)
+    std::vector<size_t> rows;
+    findRows(suite, test, rows);
+    for (size_t i = 0; i < rows.size(); i++)
     {
-        const DataRow& dr = m_dt[rowIndex];
-        const std::string csvSuite = dr[SUITE_INDEX], csvTest = dr[TEST_INDEX];
-        bool sameSuite = (csvSuite == strSuite), sameTest = (csvTest == strTest)||(csvTest == "*");
-        if (sameTest && sameSuite)
-        {
-            ret = ret | OclExtensions::fromString(dr[EXT_INDEX]);
-        }
+        const DataRow& dr = m_dt[rows[i]];
+        ret = ret | OclExtensions::fromString(dr[EXT_INDEX]);
     }
 
     return ret;
@@ -593,20 +729,13 @@ OclExtensions KhrSupport::getRequiredExtensions(const char* suite, const char* t
 cl_bool KhrSupport::isImagesRequired(const char* suite, const char* test) const
 {
     cl_bool ret = CL_FALSE;
-    const std::string strSuite(suite), strTest(test);
 
-    // Iterating on the DataTable, searching whether the row with th requested
-    // row exists.
-    for(size_t rowIndex = 0; rowIndex < m_dt.getNumRows(); rowIndex++)
+    std::vector<size_t> rows;
+    findRows(suite, test, rows);
+    if (!rows.empty())
     {
-        const DataRow& dr = m_dt[rowIndex];
-        const std::string csvSuite = dr[SUITE_INDEX], csvTest = dr[TEST_INDEX];
-        bool sameSuite = (csvSuite == strSuite), sameTest = (csvTest == strTest)||(csvTest == "*");
-        if (sameTest && sameSuite)
-        {
-            ret = (dr[IMAGES_INDEX] == "CL_TRUE") ? CL_TRUE : CL_FALSE;
-            break;
-        }
+        const DataRow& dr = m_dt[rows[0]];
+        ret = (dr[IMAGES_INDEX] == "CL_TRUE") ? CL_TRUE : CL_FALSE;
     }
 
     return ret;
@@ -615,20 +744,13 @@ cl_bool KhrSupport::isImagesRequired(const char* suite, const char* test) const
 cl_bool KhrSupport::isImages3DRequired(const char* suite, const char* test) const
 {
     cl_bool ret = CL_FALSE;
-    const std::string strSuite(suite), strTest(test);
 
-    // Iterating on the DataTable, searching whether the row with th requested
-    // row exists.
-    for(size_t rowIndex = 0; rowIndex < m_dt.getNumRows(); rowIndex++)
+    std::vector<size_t> rows;
+    findRows(suite, test, rows);
+    if (!rows.empty())
     {
-        const DataRow& dr = m_dt[rowIndex];
-        const std::string csvSuite = dr[SUITE_INDEX], csvTest = dr[TEST_INDEX];
-        bool sameSuite = (csvSuite == strSuite), sameTest = (csvTest == strTest)||(csvTest == "*");
-        if (sameTest && sameSuite)
-        {
-            ret = (dr[IMAGES_3D_INDEX] == "CL_TRUE") ? CL_TRUE : CL_FALSE;
-            break;
-        }
+        const DataRow& dr = m_dt[rows[0]];
+        ret = (dr[IMAGES_3D_INDEX] == "CL_TRUE") ? CL_TRUE : CL_FALSE;
     }
 
     return ret;
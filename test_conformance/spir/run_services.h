@@ -20,12 +20,21 @@
 #include "kernelargs.h"
 #include "datagen.h"
 #include <list>
+#include <map>
+#include <utility>
+#include <vector>
 
 void get_cl_file_path(const char *folder, const char *str, std::string &cl_file_path);
 void get_bc_file_path(const char *folder, const char *str, std::string &bc_file_path, cl_uint size_t_width);
 void get_h_file_path(const char *folder, const char *str, std::string &h_file_path);
 void get_kernel_name(const char *test_name, std::string &kernel_name);
 
+/**
+ Decompresses a suite archive into memory. load_file_cl and load_file_bc look
+ there before reading from the disk.
+ */
+void load_suite_archive(const std::string& archive_name);
+
 cl_device_id get_context_device(cl_context context);
 
 void create_context_and_queue(cl_device_id device, cl_context *out_context, cl_command_queue *out_queue);
@@ -180,8 +189,16 @@ private:
   static const int IMAGES_3D_INDEX = 4;
 
   void parseCSV(std::fstream&);
+  void findRows(const char* suite, const char* test,
+                std::vector<size_t>& rows) const;
+
+  // Row numbers in m_dt by suite and test name, so that the lookups done
+  // for every test don't scan the whole table.
+  typedef std::map<std::pair<std::string, std::string>, std::vector<size_t> >
+      RowIndex;
 
   DataTable m_dt;
+  RowIndex  m_index;
   static KhrSupport* m_instance;
 };
 
@@ -26,6 +26,7 @@
 import argparse
 import glob
 import os
+import struct
 import subprocess
 import sys
 from textwrap import wrap
@@ -107,6 +108,50 @@ def validate_spirv(bin_dir, spirv_val, spirv_env, verbose):
               'See above for validation output.')
 
 
+def pack_spirv(bin_dir, pack_file, verbose):
+    """Packs the SPIR-V binaries of every environment into one corpus file
+       that spirv_new maps with --spirv-corpus.  See spirv_corpus.h for
+       the layout.
+    """
+
+    names = []
+    for subdir in spirv_envs:
+        for bin_file_path in sorted(glob.glob(
+                os.path.join(bin_dir, subdir, '*.spv*'))):
+            if os.path.isfile(bin_file_path):
+                names.append(os.path.relpath(bin_file_path, bin_dir).replace(
+                    os.sep, '/'))
+
+    header_size = 16
+    entry_size = 24
+    encoded_names = [name.encode('utf-8') for name in names]
+    name_offset = header_size + entry_size * len(names)
+    data_offset = name_offset + sum(len(name) for name in encoded_names)
+
+    index = b''
+    string_table = b''
+    data = b''
+    for name, encoded_name in zip(names, encoded_names):
+        # Modules start on 8 byte boundaries
+        data += b'\0' * (-(data_offset + len(data)) % 8)
+        with open(os.path.join(bin_dir, name), 'rb') as bin_file:
+            module = bin_file.read()
+        if verbose:
+            print(' Packing {}'.format(name))
+        index += struct.pack('<QQII', data_offset + len(data), len(module),
+                             name_offset + len(string_table),
+                             len(encoded_name))
+        string_table += encoded_name
+        data += module
+
+    with open(pack_file, 'wb') as corpus:
+        corpus.write(b'CLSPVPAK' + struct.pack('<II', 1, len(names)))
+        corpus.write(index)
+        corpus.write(string_table)
+        corpus.write(data)
+    print('Packed {} SPIR-V binaries into {}.'.format(len(names), pack_file))
+
+
 def parse_args():
     """Parse the command-line arguments."""
 
@@ -139,6 +184,10 @@ def parse_args():
     parser.add_argument('-k', '--skip-validation', action='store_true',
                         default=False,
                         help='skips validation of the genareted SPIR-V')
+    parser.add_argument('-p', '--pack', metavar='FILE',
+                        help='''also packs all of the binaries into FILE,
+                                for the --spirv-corpus option of
+                                spirv_new''')
     parser.add_argument('-v', '--verbose', action='store_true', default=False,
                         help='''enable verbose output (i.e. prints the
                                 name of each SPIR-V assembly file or
@@ -173,6 +222,10 @@ def main():
             print('All SPIR-V binaries validated successfully.')
         print()
 
+    if args.pack:
+        pack_spirv(args.output_dir, args.pack, args.verbose)
+        print()
+
     print('Done.')
 
 
@@ -17,12 +17,15 @@
 #include <stdio.h>
 #include <string.h>
 #include "procs.h"
+#include "spirv_corpus.h"
 #if !defined(_WIN32)
 #include <unistd.h>
 #endif
 
 #include <iostream>
 #include <fstream>
+#include <map>
+#include <mutex>
 #include <string>
 #include <sstream>
 
@@ -38,6 +41,7 @@ std::string gAddrWidth = "";
 std::string spvBinariesPath = "spirv_bin";
 
 const std::string spvBinariesPathArg = "--spirv-binaries-path";
+const std::string spvCorpusArg = "--spirv-corpus";
 const std::string spvVersionSkipArg = "--skip-spirv-version-check";
 
 std::vector<unsigned char> readBinary(const char *file_name)
@@ -46,28 +50,53 @@ std::vector<unsigned char> readBinary(const char *file_name)
 
     ifstream file(file_name, ios::in | ios::binary | ios::ate);
 
-    std::vector<char> tmpBuffer(0);
+    std::vector<unsigned char> result;
 
     if (file.is_open()) {
         size_t size = file.tellg();
-        tmpBuffer.resize(size);
+        result.resize(size);
         file.seekg(0, ios::beg);
-        file.read(&tmpBuffer[0], size);
+        if (size) file.read((char *)&result[0], size);
         file.close();
     } else {
         log_error("File %s not found\n", file_name);
     }
 
-    std::vector<unsigned char> result(tmpBuffer.begin(), tmpBuffer.end());
-
     return result;
 }
 
 
 std::vector<unsigned char> readSPIRV(const char *file_name)
 {
+    // Modules are read once and kept for the rest of the run, as several
+    // tests and test variants build the same module.
+    static std::map<std::string, std::vector<unsigned char>> cache;
+    static std::mutex cacheMutex;
+
+    if (gSpirvCorpus.isOpen())
+    {
+        // The corpus holds the modules of both widths, only the pages of
+        // the one asked for are read
+        size_t size = 0;
+        std::string name = std::string(file_name) + spvExt + gAddrWidth;
+        const unsigned char *module = gSpirvCorpus.find(name, size);
+        if (module == nullptr)
+        {
+            log_error("Module %s not found in the SPIR-V corpus\n", name.c_str());
+            return std::vector<unsigned char>();
+        }
+        return std::vector<unsigned char>(module, module + size);
+    }
+
     std::string full_name_str = spvBinariesPath + slash + file_name + spvExt + gAddrWidth;
-    return readBinary(full_name_str.c_str());
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto it = cache.find(full_name_str);
+    if (it != cache.end()) return it->second;
+
+    std::vector<unsigned char> result = readBinary(full_name_str.c_str());
+    if (!result.empty()) cache[full_name_str] = result;
+    return result;
 }
 
 test_definition *spirvTestsRegistry::getTestDefinitions()
@@ -81,7 +110,7 @@ size_t spirvTestsRegistry::getNumTests()
 }
 
 void spirvTestsRegistry::addTestClass(baseTestClass *test, const char *testName,
-                                      Version version)
+                                      Version version, bool benchmark)
 {
 
     testClasses.push_back(test);
@@ -89,6 +118,8 @@ void spirvTestsRegistry::addTestClass(baseTestClass *test, const char *testName,
     testDef.func = test->getFunction();
     testDef.name = testName;
     testDef.min_version = version;
+    testDef.serial_only = benchmark;
+    testDef.benchmark = benchmark;
     testDefinitions.push_back(testDef);
 }
 
@@ -232,8 +263,13 @@ void printUsage() {
     log_info("Reading SPIR-V files from default '%s' path.\n", spvBinariesPath.c_str());
     log_info("In case you want to set other directory use '%s' argument.\n",
              spvBinariesPathArg.c_str());
+    log_info("To read them from a corpus packed by assemble_spirv.py --pack "
+             "use the '%s' argument instead.\n",
+             spvCorpusArg.c_str());
     log_info("To skip the SPIR-V version check use the '%s' argument.\n",
              spvVersionSkipArg.c_str());
+    log_info("program_load_time and il_source_parity are benchmarks and "
+             "only run when named.\n");
 }
 
 int main(int argc, const char *argv[])
@@ -252,6 +288,20 @@ int main(int argc, const char *argv[])
                 modifiedSpvBinariesPath = true;
             }
         }
+        if (argv[i] == spvCorpusArg)
+        {
+            if (i + 1 == argc)
+            {
+                log_error("Missing value for '%s' argument.\n",
+                          spvCorpusArg.c_str());
+                return TEST_FAIL;
+            }
+            if (!gSpirvCorpus.open(argv[i + 1])) return TEST_FAIL;
+            log_info("Read the index of %zu SPIR-V modules from %s.\n",
+                     gSpirvCorpus.moduleCount(), argv[i + 1]);
+            argsRemoveNum += 2;
+            modifiedSpvBinariesPath = true;
+        }
         if (argv[i] == spvVersionSkipArg)
         {
             gVersionSkip = true;
@@ -56,19 +56,20 @@ public:
     size_t getNumTests();
 
     void addTestClass(baseTestClass *test, const char *testName,
-                      Version version);
+                      Version version, bool benchmark);
     spirvTestsRegistry() {}
 };
 
-template <typename T> T *createAndRegister(const char *name, Version version)
+template <typename T>
+T *createAndRegister(const char *name, Version version, bool benchmark)
 {
     T *testClass = new T();
     spirvTestsRegistry::getInstance().addTestClass((baseTestClass *)testClass,
-                                                   name, version);
+                                                   name, version, benchmark);
     return testClass;
 }
 
-#define TEST_SPIRV_FUNC_VERSION(name, version)                                 \
+#define TEST_SPIRV_REGISTER(name, version, benchmark)                          \
     extern int test_##name(cl_device_id deviceID, cl_context context,          \
                            cl_command_queue queue, int num_elements);          \
     class test_##name##_class : public baseTestClass {                         \
@@ -80,12 +81,19 @@ template <typename T> T *createAndRegister(const char *name, Version version)
         test_function_pointer getFunction() { return fn; }                     \
     };                                                                         \
     test_##name##_class *var_##name =                                          \
-        createAndRegister<test_##name##_class>(#name, version);                \
+        createAndRegister<test_##name##_class>(#name, version, benchmark);     \
     int test_##name(cl_device_id deviceID, cl_context context,                 \
                     cl_command_queue queue, int num_elements)
 
+#define TEST_SPIRV_FUNC_VERSION(name, version)                                 \
+    TEST_SPIRV_REGISTER(name, version, false)
+
 #define TEST_SPIRV_FUNC(name) TEST_SPIRV_FUNC_VERSION(name, Version(1, 2))
 
+// A benchmark, see benchmark.h. Benchmarks always run serially.
+#define TEST_SPIRV_BENCHMARK(name)                                             \
+    TEST_SPIRV_REGISTER(name, Version(1, 2), true)
+
 struct spec_const
 {
     spec_const(cl_int id = 0, size_t sizet = 0, const void *value = NULL)
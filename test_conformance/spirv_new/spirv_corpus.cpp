@@ -0,0 +1,171 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "spirv_corpus.h"
+#include "harness/errorHelpers.h"
+
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+SpirvCorpus gSpirvCorpus;
+
+static const char corpusMagic[8] = { 'C', 'L', 'S', 'P', 'V', 'P', 'A', 'K' };
+static const unsigned corpusVersion = 1;
+static const size_t corpusHeaderSize = 16;
+static const size_t corpusEntrySize = 24;
+
+static unsigned long long readLE(const unsigned char *p, int bytes)
+{
+    unsigned long long value = 0;
+    for (int i = bytes - 1; i >= 0; i--) value = (value << 8) | p[i];
+    return value;
+}
+
+// "/basic.spv64" and "spv1.3\\basic.spv64" name the same modules as
+// "basic.spv64" and "spv1.3/basic.spv64"
+static std::string normalizeName(const std::string &name)
+{
+    std::string result;
+    for (char c : name)
+    {
+        if (c == '\\') c = '/';
+        if (c == '/' && (result.empty() || result.back() == '/')) continue;
+        result += c;
+    }
+    return result;
+}
+
+SpirvCorpus::~SpirvCorpus() { close(); }
+
+void SpirvCorpus::close()
+{
+    index.clear();
+    if (data == nullptr) return;
+#if defined(_WIN32)
+    UnmapViewOfFile(data);
+#else
+    munmap(const_cast<unsigned char *>(data), length);
+#endif
+    data = nullptr;
+    length = 0;
+}
+
+bool SpirvCorpus::open(const std::string &path)
+{
+    close();
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                              NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        log_error("Unable to open SPIR-V corpus %s\n", path.c_str());
+        return false;
+    }
+    LARGE_INTEGER size;
+    HANDLE mapping = NULL;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    // The view keeps the file mapped once the handles are closed
+    void *view =
+        mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (mapping) CloseHandle(mapping);
+    CloseHandle(file);
+    if (view == NULL)
+    {
+        log_error("Unable to map SPIR-V corpus %s\n", path.c_str());
+        return false;
+    }
+    data = static_cast<const unsigned char *>(view);
+    length = (size_t)size.QuadPart;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        log_error("Unable to open SPIR-V corpus %s\n", path.c_str());
+        return false;
+    }
+    struct stat st;
+    void *view = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+        view = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED)
+    {
+        log_error("Unable to map SPIR-V corpus %s\n", path.c_str());
+        return false;
+    }
+    data = static_cast<const unsigned char *>(view);
+    length = (size_t)st.st_size;
+#endif
+
+    if (length < corpusHeaderSize
+        || memcmp(data, corpusMagic, sizeof(corpusMagic)) != 0
+        || readLE(data + 8, 4) != corpusVersion)
+    {
+        log_error("%s is not a version %u SPIR-V corpus\n", path.c_str(),
+                  corpusVersion);
+        close();
+        return false;
+    }
+
+    size_t count = (size_t)readLE(data + 12, 4);
+    if (count > (length - corpusHeaderSize) / corpusEntrySize)
+    {
+        log_error("SPIR-V corpus %s is truncated\n", path.c_str());
+        close();
+        return false;
+    }
+
+    index.reserve(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        const unsigned char *entry =
+            data + corpusHeaderSize + i * corpusEntrySize;
+        unsigned long long offset = readLE(entry, 8);
+        unsigned long long size = readLE(entry + 8, 8);
+        unsigned long long nameOffset = readLE(entry + 16, 4);
+        unsigned long long nameSize = readLE(entry + 20, 4);
+        if (offset > length || size > length - offset || nameOffset > length
+            || nameSize > length - nameOffset)
+        {
+            log_error("SPIR-V corpus %s has a bad index entry %zu\n",
+                      path.c_str(), i);
+            close();
+            return false;
+        }
+        std::string name((const char *)data + nameOffset, (size_t)nameSize);
+        index[normalizeName(name)] =
+            std::make_pair((size_t)offset, (size_t)size);
+    }
+    return true;
+}
+
+const unsigned char *SpirvCorpus::find(const std::string &name,
+                                       size_t &size) const
+{
+    auto it = index.find(normalizeName(name));
+    if (it == index.end()) return nullptr;
+    size = it->second.second;
+    return data + it->second.first;
+}
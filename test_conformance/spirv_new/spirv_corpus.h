@@ -0,0 +1,62 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#pragma once
+
+#include <stddef.h>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+// The SPIR-V modules packed into one file by assemble_spirv.py --pack. The
+// file is mapped into memory once and its index read into a hash map, so a
+// module is found by name without touching the filesystem, and the pages of
+// the modules of the other address width are never read.
+//
+// The file is little-endian: the magic "CLSPVPAK", a uint32 version (1) and
+// a uint32 module count, then per module a uint64 offset, a uint64 size, a
+// uint32 name offset and a uint32 name size, all from the start of the file.
+// Names are the paths of the binaries relative to spirv_bin with '/'
+// separators, such as "spv1.3/basic.spv64", and modules start on 8 byte
+// boundaries.
+class SpirvCorpus {
+public:
+    SpirvCorpus() = default;
+    ~SpirvCorpus();
+
+    // Maps the corpus at path and reads its index. Returns false, with the
+    // reason logged, if it can't be read or isn't a valid corpus.
+    bool open(const std::string &path);
+    void close();
+
+    bool isOpen() const { return data != nullptr; }
+    size_t moduleCount() const { return index.size(); }
+
+    // The module stored as name, with any leading or repeated separators
+    // ignored, or nullptr if there is none
+    const unsigned char *find(const std::string &name, size_t &size) const;
+
+private:
+    SpirvCorpus(const SpirvCorpus &) = delete;
+    SpirvCorpus &operator=(const SpirvCorpus &) = delete;
+
+    const unsigned char *data = nullptr;
+    size_t length = 0;
+    std::unordered_map<std::string, std::pair<size_t, size_t>> index;
+};
+
+// Set up by --spirv-corpus
+extern SpirvCorpus gSpirvCorpus;
@@ -0,0 +1,358 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "testBase.h"
+#include "harness/mt19937.h"
+#include "harness/perfMetrics.h"
+#include "harness/benchmark.h"
+
+#include <string>
+#include <vector>
+
+// Whether a kernel runs as fast when loaded from SPIR-V as when built from
+// the OpenCL C it is equivalent to. Each module of the corpus below is paired
+// with the OpenCL C source the functional tests check it against; the builds
+// of both and their runs on a profiling queue are sampled, and the median
+// times are compared. The two results must match each other and, for the
+// integer kernels, the host reference. A benchmark, so it only runs when
+// named.
+
+namespace {
+
+const size_t kItems = 1 << 20;
+// Values each work-item of the loop kernels sums
+const cl_int kLoopReps = 16;
+
+struct ParityCase
+{
+    const char *module;
+    const char *spvKernel;
+    const char *source;
+    const char *clKernel;
+    // Words per work-item of the output and of up to two inputs, 0 for none
+    size_t outWords;
+    size_t inWords[2];
+    bool floatInputs;
+    // Whether the kernel also takes the repetitions and item count
+    bool loopArgs;
+    // Output word of item i, or NULL to only compare the two paths
+    cl_uint (*reference)(const std::vector<cl_uint> *in, size_t i);
+};
+
+cl_uint loop_reference(const std::vector<cl_uint> *in, size_t i)
+{
+    cl_uint acc = 0;
+    for (cl_int r = 0; r < kLoopReps; r++) acc += in[0][i + r * kItems];
+    return acc;
+}
+
+cl_uint switch_reference(const std::vector<cl_uint> *in, size_t i)
+{
+    return (in[0][i] + in[1][i]) % 4;
+}
+
+const char *loop_source =
+    "__kernel void loop_cl(__global uint *res, __global const uint *in,\n"
+    "                      int rep, int num)\n"
+    "{\n"
+    "    int id = get_global_id(0);\n"
+    "    uint acc = 0;\n"
+    "    for (int i = 0; i < rep; i++) acc += in[id + i * num];\n"
+    "    res[id] = acc;\n"
+    "}\n";
+
+const char *switch_source =
+    "__kernel void switch_cl(__global uint *res, __global const uint *lhs,\n"
+    "                        __global const uint *rhs)\n"
+    "{\n"
+    "    int id = get_global_id(0);\n"
+    "    uint value;\n"
+    "    switch ((lhs[id] + rhs[id]) % 4)\n"
+    "    {\n"
+    "        case 1: value = 1; break;\n"
+    "        case 2: value = 2; break;\n"
+    "        case 3: value = 3; break;\n"
+    "        default: value = 0; break;\n"
+    "    }\n"
+    "    res[id] = value;\n"
+    "}\n";
+
+const char *fadd_source =
+    "__kernel void fadd_cl(__global float4 *out, const __global float4 *lhs,\n"
+    "                      const __global float4 *rhs)\n"
+    "{\n"
+    "    int id = get_global_id(0);\n"
+    "    out[id] = lhs[id] + rhs[id];\n"
+    "}\n";
+
+const char *fdiv_source =
+    "__kernel void fdiv_cl(__global float4 *out, const __global float4 *lhs,\n"
+    "                      const __global float4 *rhs)\n"
+    "{\n"
+    "    int id = get_global_id(0);\n"
+    "    out[id] = lhs[id] / rhs[id];\n"
+    "}\n";
+
+const char *times_scalar_source =
+    "__kernel void times_scalar_cl(__global float4 *out,\n"
+    "                              const __global float4 *lhs,\n"
+    "                              const __global float *rhs)\n"
+    "{\n"
+    "    int id = get_global_id(0);\n"
+    "    out[id] = lhs[id] * rhs[id];\n"
+    "}\n";
+
+const ParityCase kParityCases[] = {
+    { "loop_merge_branch_none", "loop_merge_branch_none", loop_source,
+      "loop_cl", 1, { (size_t)kLoopReps, 0 }, false, true, loop_reference },
+    { "select_switch_none", "select_switch_none", switch_source, "switch_cl",
+      1, { 1, 1 }, false, false, switch_reference },
+    { "fadd_float4", "fmath_spv", fadd_source, "fadd_cl", 4, { 4, 4 }, true,
+      false, NULL },
+    { "fdiv_float4", "fmath_spv", fdiv_source, "fdiv_cl", 4, { 4, 4 }, true,
+      false, NULL },
+    { "vector_times_scalar_float", "vector_times_scalar", times_scalar_source,
+      "times_scalar_cl", 4, { 4, 1 }, true, false, NULL },
+};
+
+struct ParityTimes
+{
+    BenchmarkStats build_ms;
+    BenchmarkStats run_us;
+};
+
+struct ParityBench
+{
+    cl_device_id device;
+    cl_context context;
+    cl_command_queue queue;
+    clCreateProgramWithILKHR_fn createProgramWithILKHR;
+
+    cl_int Create(const ParityCase &parity,
+                  const std::vector<unsigned char> *il,
+                  clProgramWrapper &program)
+    {
+        cl_int err;
+        if (il == NULL)
+            program = clCreateProgramWithSource(context, 1, &parity.source,
+                                                NULL, &err);
+        else if (gCoreILProgram)
+            program =
+                clCreateProgramWithIL(context, il->data(), il->size(), &err);
+        else
+            program =
+                createProgramWithILKHR(context, il->data(), il->size(), &err);
+        SPIRV_CHECK_ERROR(err, "Failed to create %s program for %s",
+                          il ? "IL" : "source", parity.module);
+        err = clBuildProgram(program, 1, &device, NULL, NULL, NULL);
+        SPIRV_CHECK_ERROR(err, "Failed to build %s program for %s",
+                          il ? "IL" : "source", parity.module);
+        return CL_SUCCESS;
+    }
+
+    // Builds the kernel from il, or from source if il is NULL, and runs it
+    // over the inputs into out
+    cl_int Time(const ParityCase &parity, const std::vector<unsigned char> *il,
+                const std::vector<clMemWrapper> &inputs, cl_mem out,
+                ParityTimes &times)
+    {
+        BenchmarkOptions options;
+        options.warmup = 0;
+        options.minSamples = 5;
+        options.maxSeconds = 1.0;
+
+        clProgramWrapper program;
+        cl_int err = run_benchmark(
+            options,
+            [&](double *ms) {
+                HostTimer timer;
+                cl_int err = Create(parity, il, program);
+                *ms = timer.elapsed_ms();
+                return err;
+            },
+            &times.build_ms);
+        if (err != CL_SUCCESS) return err;
+
+        clKernelWrapper kernel = clCreateKernel(
+            program, il ? parity.spvKernel : parity.clKernel, &err);
+        SPIRV_CHECK_ERROR(err, "Failed to create kernel for %s",
+                          parity.module);
+        cl_uint arg = 0;
+        err = clSetKernelArg(kernel, arg++, sizeof(cl_mem), &out);
+        for (size_t i = 0; i < inputs.size(); i++)
+            err |= clSetKernelArg(kernel, arg++, sizeof(cl_mem), &inputs[i]);
+        if (parity.loopArgs)
+        {
+            cl_int rep = kLoopReps, num = (cl_int)kItems;
+            err |= clSetKernelArg(kernel, arg++, sizeof(rep), &rep);
+            err |= clSetKernelArg(kernel, arg++, sizeof(num), &num);
+        }
+        SPIRV_CHECK_ERROR(err, "Failed to set kernel arguments for %s",
+                          parity.module);
+
+        options.warmup = 1;
+        return run_benchmark(
+            options,
+            [&](double *us) {
+                size_t global = kItems;
+                clEventWrapper event;
+                cl_int err = clEnqueueNDRangeKernel(
+                    queue, kernel, 1, NULL, &global, NULL, 0, NULL, &event);
+                SPIRV_CHECK_ERROR(err, "Failed to enqueue kernel for %s",
+                                  parity.module);
+                err = clWaitForEvents(1, &event);
+                SPIRV_CHECK_ERROR(err, "Failed to wait for kernel for %s",
+                                  parity.module);
+                double ns;
+                err = get_event_duration_ns(event, &ns);
+                SPIRV_CHECK_ERROR(err, "Failed to get profiling info");
+                *us = ns / 1000.0;
+                return CL_SUCCESS;
+            },
+            &times.run_us);
+    }
+
+    int Compare(const ParityCase &parity, const std::vector<cl_uint> *host,
+                cl_mem sourceOut, cl_mem ilOut)
+    {
+        size_t words = parity.outWords * kItems;
+        std::vector<cl_uint> sourceResult(words), ilResult(words);
+        cl_int err = clEnqueueReadBuffer(queue, sourceOut, CL_TRUE, 0,
+                                         words * sizeof(cl_uint),
+                                         sourceResult.data(), 0, NULL, NULL);
+        err |= clEnqueueReadBuffer(queue, ilOut, CL_TRUE, 0,
+                                   words * sizeof(cl_uint), ilResult.data(), 0,
+                                   NULL, NULL);
+        SPIRV_CHECK_ERROR(err, "Failed to read results");
+
+        for (size_t i = 0; i < words; i++)
+        {
+            if (sourceResult[i] != ilResult[i])
+            {
+                log_error("ERROR: %s word %zu is 0x%08x from source and "
+                          "0x%08x from SPIR-V\n",
+                          parity.module, i, sourceResult[i], ilResult[i]);
+                return -1;
+            }
+            if (parity.reference && ilResult[i] != parity.reference(host, i))
+            {
+                log_error("ERROR: %s word %zu is %u, expected %u\n",
+                          parity.module, i, ilResult[i],
+                          parity.reference(host, i));
+                return -1;
+            }
+        }
+        return 0;
+    }
+};
+
+} // anonymous namespace
+
+TEST_SPIRV_BENCHMARK(il_source_parity)
+{
+    cl_int err;
+    clCommandQueueWrapper profilingQueue = clCreateCommandQueue(
+        context, deviceID, CL_QUEUE_PROFILING_ENABLE, &err);
+    SPIRV_CHECK_ERROR(err, "Failed to create profiling queue");
+
+    ParityBench bench;
+    bench.device = deviceID;
+    bench.context = context;
+    bench.queue = profilingQueue;
+    bench.createProgramWithILKHR = NULL;
+    if (!gCoreILProgram)
+    {
+        cl_platform_id platform;
+        err = clGetDeviceInfo(deviceID, CL_DEVICE_PLATFORM, sizeof(platform),
+                              &platform, NULL);
+        SPIRV_CHECK_ERROR(err, "Failed to get the device's platform");
+        bench.createProgramWithILKHR = (clCreateProgramWithILKHR_fn)
+            clGetExtensionFunctionAddressForPlatform(
+                platform, "clCreateProgramWithILKHR");
+        if (bench.createProgramWithILKHR == NULL)
+        {
+            log_error("ERROR: clGetExtensionFunctionAddressForPlatform "
+                      "failed\n");
+            return -1;
+        }
+    }
+
+    MTdataHolder d(gRandomSeed);
+    log_benchmark_header("il_source_parity", "module/phase/path");
+    for (const ParityCase &parity : kParityCases)
+    {
+        std::vector<unsigned char> il = readSPIRV(parity.module);
+        if (il.empty()) return -1;
+
+        std::vector<cl_uint> host[2];
+        std::vector<clMemWrapper> inputs;
+        for (int in = 0; in < 2 && parity.inWords[in]; in++)
+        {
+            host[in].resize(parity.inWords[in] * kItems);
+            for (cl_uint &word : host[in])
+            {
+                // Floats in [1, 2), so that nothing divides by zero
+                word = parity.floatInputs
+                    ? 0x3f800000 | (genrand_int32(d) & 0x007fffff)
+                    : genrand_int32(d);
+            }
+            size_t bytes = host[in].size() * sizeof(cl_uint);
+            inputs.push_back(clCreateBuffer(context,
+                                            CL_MEM_READ_ONLY
+                                                | CL_MEM_COPY_HOST_PTR,
+                                            bytes, host[in].data(), &err));
+            SPIRV_CHECK_ERROR(err, "Failed to create input buffer");
+        }
+
+        size_t outBytes = parity.outWords * kItems * sizeof(cl_uint);
+        clMemWrapper sourceOut = clCreateBuffer(context, CL_MEM_WRITE_ONLY,
+                                                outBytes, NULL, &err);
+        SPIRV_CHECK_ERROR(err, "Failed to create output buffer");
+        clMemWrapper ilOut = clCreateBuffer(context, CL_MEM_WRITE_ONLY,
+                                            outBytes, NULL, &err);
+        SPIRV_CHECK_ERROR(err, "Failed to create output buffer");
+
+        ParityTimes source, spirv;
+        err = bench.Time(parity, NULL, inputs, sourceOut, source);
+        if (err != CL_SUCCESS) return err;
+        err = bench.Time(parity, &il, inputs, ilOut, spirv);
+        if (err != CL_SUCCESS) return err;
+        if (bench.Compare(parity, host, sourceOut, ilOut) != 0) return -1;
+
+        std::string label = parity.module;
+        const char *name = "il_source_parity";
+        log_benchmark_stats(name, (label + "/build/source").c_str(), "ms",
+                            false, source.build_ms);
+        log_benchmark_stats(name, (label + "/build/spirv").c_str(), "ms",
+                            false, spirv.build_ms);
+        log_benchmark_stats(name, (label + "/run/source").c_str(), "us", false,
+                            source.run_us);
+        log_benchmark_stats(name, (label + "/run/spirv").c_str(), "us", false,
+                            spirv.run_us);
+
+        double buildRatio = source.build_ms.median > 0
+            ? spirv.build_ms.median / source.build_ms.median
+            : 0;
+        double runRatio = source.run_us.median > 0
+            ? spirv.run_us.median / source.run_us.median
+            : 0;
+        std::string metric = std::string("il_parity_") + parity.module;
+        record_perf_metric(metric + "_build_ratio", buildRatio, "ratio",
+                           false);
+        record_perf_metric(metric + "_run_ratio", runRatio, "ratio", false);
+    }
+
+    return 0;
+}
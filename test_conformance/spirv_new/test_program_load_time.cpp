@@ -0,0 +1,372 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "testBase.h"
+#include "harness/benchmark.h"
+#include "harness/perfMetrics.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+// Time to get a ready-to-run program, per kernel and per way of loading it:
+// built from OpenCL C source, built from the SPIR-V modules in the binaries
+// path, compiled and linked separately, linked through a library, and
+// created with clCreateProgramWithBinary from the binary an earlier build
+// returned. The first load of each kernel in the process is reported as
+// cold and the loads after it as warm, which shows both what a driver's own
+// cache does and what an application binary cache saves. A benchmark, so it
+// only runs when named.
+
+struct SourceKernel
+{
+    const char *name;
+    const char *source;
+};
+
+static const SourceKernel source_corpus[] = {
+    { "copy",
+      "__kernel void copy(__global const int *src, __global int *dst)\n"
+      "{\n"
+      "    dst[get_global_id(0)] = src[get_global_id(0)];\n"
+      "}\n" },
+    { "float4_arith",
+      "__kernel void float4_arith(__global const float4 *a,\n"
+      "                           __global const float4 *b,\n"
+      "                           __global float4 *dst)\n"
+      "{\n"
+      "    size_t i = get_global_id(0);\n"
+      "    dst[i] = a[i] * b[i] + (a[i] - b[i]) / (b[i] + 1.0f);\n"
+      "}\n" },
+    { "loop_branch",
+      "__kernel void loop_branch(__global const int *src, __global int *dst)\n"
+      "{\n"
+      "    int x = src[get_global_id(0)], acc = 0;\n"
+      "    for (int i = 0; i < 64; i++)\n"
+      "        acc += (x + i) & 1 ? x * i : x - i;\n"
+      "    dst[get_global_id(0)] = acc;\n"
+      "}\n" },
+    { "math_builtins",
+      "__kernel void math_builtins(__global const float *src,\n"
+      "                            __global float *dst)\n"
+      "{\n"
+      "    float x = src[get_global_id(0)];\n"
+      "    dst[get_global_id(0)] = sin(x) * cos(x) + exp(-x) + sqrt(x);\n"
+      "}\n" },
+    { "struct_switch",
+      "typedef struct { int tag; float value; } item;\n"
+      "__kernel void struct_switch(__global const item *src,\n"
+      "                            __global float *dst)\n"
+      "{\n"
+      "    item it = src[get_global_id(0)];\n"
+      "    switch (it.tag & 3)\n"
+      "    {\n"
+      "        case 0: dst[get_global_id(0)] = it.value; break;\n"
+      "        case 1: dst[get_global_id(0)] = -it.value; break;\n"
+      "        case 2: dst[get_global_id(0)] = it.value * 2.0f; break;\n"
+      "        default: dst[get_global_id(0)] = 0.0f; break;\n"
+      "    }\n"
+      "}\n" },
+};
+
+// Modules that only need the core SPIR-V capabilities
+static const char *il_corpus[] = {
+    "basic",
+    "branch_conditional",
+    "composite_construct_struct",
+    "fadd_float4",
+    "loop_merge_branch_none",
+    "op_function_none",
+    "phi_4",
+    "select_switch_none",
+    "vector_float4_extract",
+    "vector_times_scalar_float",
+};
+
+namespace {
+
+typedef std::function<cl_int(clProgramWrapper &)> ProgramLoader;
+
+struct LoadTimes
+{
+    double cold_ms;
+    BenchmarkStats warm;
+};
+
+struct LoadBench
+{
+    cl_device_id device;
+    cl_context context;
+    clCreateProgramWithILKHR_fn createProgramWithILKHR;
+    // Warm load totals per method, for the summary
+    double source_ms, il_ms, binary_ms;
+
+    // Loads once, checking that the program has kernels
+    cl_int Load(const ProgramLoader &load, double *ms)
+    {
+        clProgramWrapper program;
+        HostTimer timer;
+        cl_int err = load(program);
+        *ms = timer.elapsed_ms();
+        if (err != CL_SUCCESS) return err;
+
+        cl_uint kernels = 0;
+        err = clCreateKernelsInProgram(program, 0, NULL, &kernels);
+        SPIRV_CHECK_ERROR(err, "Failed to query the program's kernels");
+        if (kernels == 0)
+        {
+            log_error("ERROR: loaded program has no kernels\n");
+            return -1;
+        }
+        return CL_SUCCESS;
+    }
+
+    // Loads once cold and then samples the warm loads
+    cl_int Time(const ProgramLoader &load, LoadTimes &times)
+    {
+        cl_int err = Load(load, &times.cold_ms);
+        if (err != CL_SUCCESS) return err;
+
+        BenchmarkOptions options;
+        options.warmup = 0;
+        options.minSamples = 5;
+        options.maxSeconds = 1.0;
+        return run_benchmark(
+            options, [&](double *ms) { return Load(load, ms); }, &times.warm);
+    }
+
+    // Logs the warm loads and records the cold one
+    void Report(const std::string &label, const LoadTimes &times)
+    {
+        log_benchmark_stats("program_load", label.c_str(), "ms", false,
+                            times.warm);
+        record_perf_metric("program_load_cold." + label, times.cold_ms, "ms",
+                           false);
+    }
+
+    cl_int CreateFromIL(const std::vector<unsigned char> &il,
+                        clProgramWrapper &program)
+    {
+        cl_int err;
+        if (gCoreILProgram)
+            program =
+                clCreateProgramWithIL(context, il.data(), il.size(), &err);
+        else
+            program =
+                createProgramWithILKHR(context, il.data(), il.size(), &err);
+        SPIRV_CHECK_ERROR(err, "Failed to create program with IL");
+        return CL_SUCCESS;
+    }
+
+    cl_int CreateFromSource(const char *source, clProgramWrapper &program)
+    {
+        cl_int err;
+        program = clCreateProgramWithSource(context, 1, &source, NULL, &err);
+        SPIRV_CHECK_ERROR(err, "Failed to create program with source");
+        return CL_SUCCESS;
+    }
+
+    cl_int Build(clProgramWrapper &program)
+    {
+        cl_int err = clBuildProgram(program, 1, &device, NULL, NULL, NULL);
+        SPIRV_CHECK_ERROR(err, "Failed to build program");
+        return CL_SUCCESS;
+    }
+
+    cl_int CompileAndLink(clProgramWrapper &program)
+    {
+        cl_int err = clCompileProgram(program, 1, &device, NULL, 0, NULL, NULL,
+                                      NULL, NULL);
+        SPIRV_CHECK_ERROR(err, "Failed to compile program");
+        cl_program object = program;
+        program = clLinkProgram(context, 1, &device, NULL, 1, &object, NULL,
+                                NULL, &err);
+        SPIRV_CHECK_ERROR(err, "Failed to link program");
+        return CL_SUCCESS;
+    }
+
+    cl_int GetBinary(cl_program program, std::vector<unsigned char> &binary)
+    {
+        size_t size = 0;
+        cl_int err = clGetProgramInfo(program, CL_PROGRAM_BINARY_SIZES,
+                                      sizeof(size), &size, NULL);
+        SPIRV_CHECK_ERROR(err, "Failed to get the program binary size");
+        binary.resize(size);
+        unsigned char *data = binary.data();
+        err = clGetProgramInfo(program, CL_PROGRAM_BINARIES, sizeof(data),
+                               &data, NULL);
+        SPIRV_CHECK_ERROR(err, "Failed to get the program binary");
+        return CL_SUCCESS;
+    }
+
+    cl_int CreateFromBinary(const std::vector<unsigned char> &binary,
+                            clProgramWrapper &program)
+    {
+        size_t size = binary.size();
+        const unsigned char *data = binary.data();
+        cl_int status, err;
+        program = clCreateProgramWithBinary(context, 1, &device, &size, &data,
+                                            &status, &err);
+        SPIRV_CHECK_ERROR(err, "Failed to create program with binary");
+        SPIRV_CHECK_ERROR(status, "Program binary was rejected");
+        return CL_SUCCESS;
+    }
+
+    // Times building, compiling and linking, and loading the binary of the
+    // program create makes
+    cl_int TimeKernel(const char *corpus, const char *name,
+                      const ProgramLoader &create, double &build_total)
+    {
+        LoadTimes build, link, binary;
+        cl_int err = Time(
+            [&](clProgramWrapper &program) {
+                cl_int err = create(program);
+                return err != CL_SUCCESS ? err : Build(program);
+            },
+            build);
+        if (err != CL_SUCCESS) return err;
+        err = Time(
+            [&](clProgramWrapper &program) {
+                cl_int err = create(program);
+                return err != CL_SUCCESS ? err : CompileAndLink(program);
+            },
+            link);
+        if (err != CL_SUCCESS) return err;
+
+        clProgramWrapper built;
+        std::vector<unsigned char> bytes;
+        err = create(built);
+        if (err == CL_SUCCESS) err = Build(built);
+        if (err == CL_SUCCESS) err = GetBinary(built, bytes);
+        if (err != CL_SUCCESS) return err;
+        err = Time(
+            [&](clProgramWrapper &program) {
+                cl_int err = CreateFromBinary(bytes, program);
+                return err != CL_SUCCESS ? err : Build(program);
+            },
+            binary);
+        if (err != CL_SUCCESS) return err;
+
+        std::string label = std::string(corpus) + "/" + name;
+        Report(label + "/build", build);
+        Report(label + "/compile+link", link);
+        Report(label + "/binary", binary);
+        log_info("The %s binary is %zu bytes\n", label.c_str(), bytes.size());
+        build_total += build.warm.median;
+        binary_ms += binary.warm.median;
+        return CL_SUCCESS;
+    }
+};
+
+} // anonymous namespace
+
+TEST_SPIRV_BENCHMARK(program_load_time)
+{
+    LoadBench bench;
+    bench.device = deviceID;
+    bench.context = context;
+    bench.createProgramWithILKHR = NULL;
+    bench.source_ms = bench.il_ms = 0;
+    if (!gCoreILProgram)
+    {
+        cl_platform_id platform;
+        cl_int err = clGetDeviceInfo(deviceID, CL_DEVICE_PLATFORM,
+                                     sizeof(platform), &platform, NULL);
+        SPIRV_CHECK_ERROR(err, "Failed to get the device's platform");
+        bench.createProgramWithILKHR = (clCreateProgramWithILKHR_fn)
+            clGetExtensionFunctionAddressForPlatform(
+                platform, "clCreateProgramWithILKHR");
+        if (bench.createProgramWithILKHR == NULL)
+        {
+            log_error("ERROR: clGetExtensionFunctionAddressForPlatform "
+                      "failed\n");
+            return -1;
+        }
+    }
+
+    log_benchmark_header("program_load", "corpus/kernel/method");
+
+    // Warm binary loads against warm builds from source, then from SPIR-V
+    bench.binary_ms = 0;
+    for (size_t i = 0; i < ARRAY_SIZE(source_corpus); i++)
+    {
+        const char *source = source_corpus[i].source;
+        cl_int err = bench.TimeKernel(
+            "source", source_corpus[i].name,
+            [&](clProgramWrapper &program) {
+                return bench.CreateFromSource(source, program);
+            },
+            bench.source_ms);
+        if (err != CL_SUCCESS) return err;
+    }
+    double source_binary_ms = bench.binary_ms;
+
+    bench.binary_ms = 0;
+    for (size_t i = 0; i < ARRAY_SIZE(il_corpus); i++)
+    {
+        std::vector<unsigned char> il = readSPIRV(il_corpus[i]);
+        if (il.empty()) return -1;
+        cl_int err = bench.TimeKernel(
+            "spir-v", il_corpus[i],
+            [&](clProgramWrapper &program) {
+                return bench.CreateFromIL(il, program);
+            },
+            bench.il_ms);
+        if (err != CL_SUCCESS) return err;
+    }
+    double il_binary_ms = bench.binary_ms;
+
+    // Two modules compiled separately and linked through a library
+    std::vector<unsigned char> exportIL = readSPIRV("linkage_export");
+    std::vector<unsigned char> importIL = readSPIRV("linkage_import");
+    if (exportIL.empty() || importIL.empty()) return -1;
+    LoadTimes library;
+    cl_int err = bench.Time(
+        [&](clProgramWrapper &program) {
+            clProgramWrapper objects[2];
+            cl_int err = bench.CreateFromIL(exportIL, objects[0]);
+            if (err == CL_SUCCESS)
+                err = bench.CreateFromIL(importIL, objects[1]);
+            for (int i = 0; err == CL_SUCCESS && i < 2; i++)
+                err = clCompileProgram(objects[i], 1, &deviceID, NULL, 0, NULL,
+                                       NULL, NULL, NULL);
+            SPIRV_CHECK_ERROR(err, "Failed to compile the linkage modules");
+            cl_program programs[] = { objects[0], objects[1] };
+            clProgramWrapper lib =
+                clLinkProgram(context, 1, &deviceID, "-create-library", 2,
+                              programs, NULL, NULL, &err);
+            SPIRV_CHECK_ERROR(err, "Failed to create the library");
+            cl_program libProgram = lib;
+            program = clLinkProgram(context, 1, &deviceID, NULL, 1,
+                                    &libProgram, NULL, NULL, &err);
+            SPIRV_CHECK_ERROR(err, "Failed to link the library");
+            return CL_SUCCESS;
+        },
+        library);
+    if (err != CL_SUCCESS) return err;
+    bench.Report("spir-v/linkage/library_link", library);
+
+    log_info("Warm loads over the corpus: source %.2f ms, binary %.2f ms "
+             "(%.0f%% saved); SPIR-V %.2f ms, binary %.2f ms (%.0f%% "
+             "saved)\n",
+             bench.source_ms, source_binary_ms,
+             bench.source_ms > 0
+                 ? 100.0 * (1.0 - source_binary_ms / bench.source_ms)
+                 : 0.0,
+             bench.il_ms, il_binary_ms,
+             bench.il_ms > 0 ? 100.0 * (1.0 - il_binary_ms / bench.il_ms)
+                             : 0.0);
+    return 0;
+}
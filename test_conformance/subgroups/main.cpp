@@ -18,7 +18,9 @@
 #include <stdio.h>
 #include <string.h>
 #include "procs.h"
+#include "harness/benchmark.h"
 #include "harness/testHarness.h"
+#include "harness/parseParameters.h"
 #include "CL/cl_half.h"
 
 MTdata gMTdata;
@@ -85,6 +87,12 @@ static test_status InitCL(cl_device_id device)
     {
         assert(false && "Unreachable");
     }
+
+    if (gBench)
+    {
+        log_benchmark_header("sub_group",
+                             "function/type/local_size/global_size");
+    }
     return ret;
 }
 
@@ -229,3 +229,46 @@ void fill_and_shuffle_safe_values(std::vector<cl_ulong> &safe_values,
     std::shuffle(safe_values.begin(), safe_values.end(),
                  mersenne_twister_engine);
 }
+
+void KernelBatch::add(const std::string &header, const std::string &kernel_name,
+                      const std::string &src)
+{
+    Kernels &batch = kernels[header];
+    if (std::find(batch.names.begin(), batch.names.end(), kernel_name)
+        != batch.names.end())
+        return;
+    batch.names.push_back(kernel_name);
+    batch.source += src;
+}
+
+void KernelBatch::build(cl_context context)
+{
+    for (auto &it : kernels)
+    {
+        Kernels &batch = it.second;
+        if (batch.names.size() < 2) continue;
+
+        const std::string source = it.first + batch.source;
+        const char *kernel_src = source.c_str();
+        clKernelWrapper kernel;
+        if (create_single_kernel_helper(context, &batch.program, &kernel, 1,
+                                        &kernel_src, batch.names[0].c_str()))
+        {
+            log_info("Batched build failed, building %zu kernels "
+                     "separately\n",
+                     batch.names.size());
+            batch.program.reset();
+        }
+    }
+}
+
+cl_program KernelBatch::find(const std::string &header,
+                             const std::string &kernel_name)
+{
+    auto it = kernels.find(header);
+    if (it == kernels.end() || !it->second.program) return NULL;
+    const std::vector<std::string> &names = it->second.names;
+    if (std::find(names.begin(), names.end(), kernel_name) == names.end())
+        return NULL;
+    return it->second.program;
+}
@@ -17,11 +17,14 @@
 #define SUBHELPERS_H
 
 #include "testHarness.h"
+#include "benchmark.h"
 #include "kernelHelpers.h"
 #include "typeWrappers.h"
 #include "imageHelpers.h"
+#include "parseParameters.h"
 
 #include <limits>
+#include <memory>
 #include <vector>
 #include <type_traits>
 #include <bitset>
@@ -1302,6 +1305,7 @@ public:
     {
         has_status = false;
         run_failed = false;
+        bench_stats = nullptr;
     }
     cl_context context;
     cl_command_queue queue;
@@ -1318,6 +1322,8 @@ public:
     size_t osize;
     size_t tsize;
     bool run_failed;
+    // When set, run() also samples the kernel's device time into it
+    BenchmarkStats *bench_stats;
 
 private:
     bool has_status;
@@ -1387,6 +1393,25 @@ public:
         error = clFinish(queue);
         test_error(error, "clFinish failed");
 
+        if (bench_stats)
+        {
+            // Time it here while the buffers are still bound to the kernel
+            cl_device_id device;
+            error = clGetCommandQueueInfo(queue, CL_QUEUE_DEVICE,
+                                          sizeof(device), &device, NULL);
+            test_error(error, "clGetCommandQueueInfo failed");
+            clCommandQueueWrapper profilingQueue = clCreateCommandQueue(
+                context, device, CL_QUEUE_PROFILING_ENABLE, &error);
+            test_error(error, "Unable to create profiling queue");
+
+            BenchmarkOptions options;
+            options.warmup = 1;
+            options.maxSeconds = 1.0;
+            error = benchmark_1d_kernel(profilingQueue, kernel, global, local,
+                                        options, bench_stats);
+            test_error(error, "Unable to time kernel");
+        }
+
         return error;
     }
 
@@ -1446,13 +1471,58 @@ public:
     }
 };
 
+// Extensions, macros and typedef put in front of every kernel testing Ty
+template <typename Ty>
+std::string kernel_header(const WorkGroupParams &test_params)
+{
+    std::stringstream kernel_sstr;
+    if (strstr(TypeManager<Ty>::name(), "double"))
+    {
+        kernel_sstr << "#pragma OPENCL EXTENSION cl_khr_fp64: enable\n";
+    }
+    else if (strstr(TypeManager<Ty>::name(), "half"))
+    {
+        kernel_sstr << "#pragma OPENCL EXTENSION cl_khr_fp16: enable\n";
+    }
+    if (test_params.use_core_subgroups)
+    {
+        kernel_sstr << "#pragma OPENCL EXTENSION cl_khr_subgroups : enable\n";
+    }
+    kernel_sstr << "#define XY(M,I) M[I].x = get_sub_group_local_id(); "
+                   "M[I].y = get_sub_group_id();\n";
+    kernel_sstr << TypeManager<Ty>::add_typedef();
+    return kernel_sstr.str();
+}
+
+// Kernels collected from several built-ins, built as one program for each
+// kernel header instead of one program per built-in
+struct KernelBatch
+{
+    bool collecting = false;
+    void add(const std::string &header, const std::string &kernel_name,
+             const std::string &src);
+    void build(cl_context context);
+    // Returns the program containing kernel_name, or NULL if it wasn't batched
+    cl_program find(const std::string &header, const std::string &kernel_name);
+
+private:
+    struct Kernels
+    {
+        std::vector<std::string> names;
+        std::string source;
+        clProgramWrapper program;
+    };
+    std::map<std::string, Kernels> kernels;
+};
+
 // Driver for testing a single built in function
 template <typename Ty, typename Fns, size_t TSIZE = 0> struct test
 {
     static test_status run(cl_device_id device, cl_context context,
                            cl_command_queue queue, int num_elements,
                            const char *kname, const char *src,
-                           WorkGroupParams test_params)
+                           WorkGroupParams test_params,
+                           cl_program batched_program = NULL)
     {
         size_t tmp;
         cl_int error;
@@ -1468,7 +1538,6 @@ template <typename Ty, typename Fns, size_t TSIZE = 0> struct test
         mapin.resize(local);
         std::vector<Ty> mapout;
         mapout.resize(local);
-        std::stringstream kernel_sstr;
 
         Fns::log_test(test_params, "");
 
@@ -1479,33 +1548,25 @@ template <typename Ty, typename Fns, size_t TSIZE = 0> struct test
             return TEST_SKIPPED_ITSELF;
         }
 
-        if (strstr(TypeManager<Ty>::name(), "double"))
-        {
-            kernel_sstr << "#pragma OPENCL EXTENSION cl_khr_fp64: enable\n";
-        }
-        else if (strstr(TypeManager<Ty>::name(), "half"))
-        {
-            kernel_sstr << "#pragma OPENCL EXTENSION cl_khr_fp16: enable\n";
-        }
-
         error = clGetDeviceInfo(device, CL_DEVICE_PLATFORM, sizeof(platform),
                                 (void *)&platform, NULL);
         test_error_fail(error, "clGetDeviceInfo failed for CL_DEVICE_PLATFORM");
-        if (test_params.use_core_subgroups)
+
+        if (batched_program)
         {
-            kernel_sstr
-                << "#pragma OPENCL EXTENSION cl_khr_subgroups : enable\n";
+            kernel = clCreateKernel(batched_program, kname, &error);
+            test_error_fail(error, "clCreateKernel failed");
         }
-        kernel_sstr << "#define XY(M,I) M[I].x = get_sub_group_local_id(); "
-                       "M[I].y = get_sub_group_id();\n";
-        kernel_sstr << TypeManager<Ty>::add_typedef();
-        kernel_sstr << src;
-        const std::string &kernel_str = kernel_sstr.str();
-        const char *kernel_src = kernel_str.c_str();
+        else
+        {
+            const std::string kernel_str =
+                kernel_header<Ty>(test_params) + src;
+            const char *kernel_src = kernel_str.c_str();
 
-        error = create_single_kernel_helper(context, &program, &kernel, 1,
-                                            &kernel_src, kname);
-        if (error != CL_SUCCESS) return TEST_FAIL;
+            error = create_single_kernel_helper(context, &program, &kernel, 1,
+                                                &kernel_src, kname);
+            if (error != CL_SUCCESS) return TEST_FAIL;
+        }
 
         // Determine some local dimensions to use for the test.
         error = get_max_common_work_group_size(
@@ -1636,6 +1697,19 @@ template <typename Ty, typename Fns, size_t TSIZE = 0> struct test
         if (status == TEST_PASS)
         {
             Fns::log_test(test_params, " passed");
+
+            if (gBench)
+            {
+                BenchmarkStats stats;
+                executor.bench_stats = &stats;
+                error = executor.run();
+                test_error_fail(error, "Unable to benchmark kernel");
+                std::string label = std::string(kname) + "/"
+                    + TypeManager<Ty>::name() + "/" + std::to_string(local)
+                    + "/" + std::to_string(global);
+                log_benchmark_stats("sub_group", label.c_str(), "ns", false,
+                                    stats);
+            }
         }
         else if (!executor.run_failed && status == TEST_FAIL)
         {
@@ -1688,9 +1762,18 @@ struct RunTestForType
             std::regex_replace(test_params_.get_kernel_source(function_name),
                                std::regex("\\%s"), function_name);
         std::string kernel_name = "test_" + function_name;
-        error =
-            test<T, U>::run(device_, context_, queue_, num_elements_,
-                            kernel_name.c_str(), source.c_str(), test_params_);
+        std::string header = kernel_header<T>(test_params_);
+        if (batch_ && batch_->collecting)
+        {
+            if (TypeManager<T>::type_supported(device_))
+                batch_->add(header, kernel_name, source);
+            return TEST_PASS;
+        }
+        error = test<T, U>::run(device_, context_, queue_, num_elements_,
+                                kernel_name.c_str(), source.c_str(),
+                                test_params_,
+                                batch_ ? batch_->find(header, kernel_name)
+                                       : NULL);
 
         // If we return TEST_SKIPPED_ITSELF here, then an entire suite may be
         // reported as having been skipped even if some tests within it
@@ -1698,12 +1781,28 @@ struct RunTestForType
         return error == TEST_FAIL ? TEST_FAIL : TEST_PASS;
     }
 
+    // Runs fn twice. The first pass only collects the kernels of the
+    // built-ins it tests, which are then built as one program for each data
+    // type. The second pass runs the tests, taking kernels from those
+    // programs.
+    int run_batched(int (*fn)(RunTestForType))
+    {
+        RunTestForType batched(*this);
+        batched.batch_ = std::make_shared<KernelBatch>();
+        batched.batch_->collecting = true;
+        fn(batched);
+        batched.batch_->collecting = false;
+        batched.batch_->build(context_);
+        return fn(batched);
+    }
+
 private:
     cl_device_id device_;
     cl_context context_;
     cl_command_queue queue_;
     int num_elements_;
     WorkGroupParams test_params_;
+    std::shared_ptr<KernelBatch> batch_;
 };
 
 #endif
@@ -178,13 +178,14 @@ int test_subgroup_functions(cl_device_id device, cl_context context,
     int error =
         rft.run_impl<cl_int, AA<NonUniformVoteOp::any>>("sub_group_any");
     error |= rft.run_impl<cl_int, AA<NonUniformVoteOp::all>>("sub_group_all");
-    error |= run_broadcast_scan_reduction_for_type<cl_int>(rft);
-    error |= run_broadcast_scan_reduction_for_type<cl_uint>(rft);
-    error |= run_broadcast_scan_reduction_for_type<cl_long>(rft);
-    error |= run_broadcast_scan_reduction_for_type<cl_ulong>(rft);
-    error |= run_broadcast_scan_reduction_for_type<cl_float>(rft);
-    error |= run_broadcast_scan_reduction_for_type<cl_double>(rft);
-    error |= run_broadcast_scan_reduction_for_type<subgroups::cl_half>(rft);
+    error |= rft.run_batched(run_broadcast_scan_reduction_for_type<cl_int>);
+    error |= rft.run_batched(run_broadcast_scan_reduction_for_type<cl_uint>);
+    error |= rft.run_batched(run_broadcast_scan_reduction_for_type<cl_long>);
+    error |= rft.run_batched(run_broadcast_scan_reduction_for_type<cl_ulong>);
+    error |= rft.run_batched(run_broadcast_scan_reduction_for_type<cl_float>);
+    error |= rft.run_batched(run_broadcast_scan_reduction_for_type<cl_double>);
+    error |= rft.run_batched(
+        run_broadcast_scan_reduction_for_type<subgroups::cl_half>);
     return error;
 }
 
@@ -140,9 +140,9 @@ int test_subgroup_functions_extended_types(cl_device_id device,
     error |= run_broadcast_for_extended_type<subgroups::cl_half8>(rft);
     error |= run_broadcast_for_extended_type<subgroups::cl_half16>(rft);
 
-    error |= run_scan_reduction_for_type<cl_uchar>(rft);
-    error |= run_scan_reduction_for_type<cl_char>(rft);
-    error |= run_scan_reduction_for_type<cl_ushort>(rft);
-    error |= run_scan_reduction_for_type<cl_short>(rft);
+    error |= rft.run_batched(run_scan_reduction_for_type<cl_uchar>);
+    error |= rft.run_batched(run_scan_reduction_for_type<cl_char>);
+    error |= rft.run_batched(run_scan_reduction_for_type<cl_ushort>);
+    error |= rft.run_batched(run_scan_reduction_for_type<cl_short>);
     return error;
 }
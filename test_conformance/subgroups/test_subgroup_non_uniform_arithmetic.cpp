@@ -140,27 +140,28 @@ int test_subgroup_functions_non_uniform_arithmetic(cl_device_id device,
     test_params.save_kernel_source(sub_group_non_uniform_arithmetic_source);
     RunTestForType rft(device, context, queue, num_elements, test_params);
 
-    int error = run_functions_add_mul_max_min_for_type<cl_int>(rft);
-    error |= run_functions_add_mul_max_min_for_type<cl_uint>(rft);
-    error |= run_functions_add_mul_max_min_for_type<cl_long>(rft);
-    error |= run_functions_add_mul_max_min_for_type<cl_ulong>(rft);
-    error |= run_functions_add_mul_max_min_for_type<cl_short>(rft);
-    error |= run_functions_add_mul_max_min_for_type<cl_ushort>(rft);
-    error |= run_functions_add_mul_max_min_for_type<cl_char>(rft);
-    error |= run_functions_add_mul_max_min_for_type<cl_uchar>(rft);
-    error |= run_functions_add_mul_max_min_for_type<cl_float>(rft);
-    error |= run_functions_add_mul_max_min_for_type<cl_double>(rft);
-    error |= run_functions_add_mul_max_min_for_type<subgroups::cl_half>(rft);
+    int error = rft.run_batched(run_functions_add_mul_max_min_for_type<cl_int>);
+    error |= rft.run_batched(run_functions_add_mul_max_min_for_type<cl_uint>);
+    error |= rft.run_batched(run_functions_add_mul_max_min_for_type<cl_long>);
+    error |= rft.run_batched(run_functions_add_mul_max_min_for_type<cl_ulong>);
+    error |= rft.run_batched(run_functions_add_mul_max_min_for_type<cl_short>);
+    error |= rft.run_batched(run_functions_add_mul_max_min_for_type<cl_ushort>);
+    error |= rft.run_batched(run_functions_add_mul_max_min_for_type<cl_char>);
+    error |= rft.run_batched(run_functions_add_mul_max_min_for_type<cl_uchar>);
+    error |= rft.run_batched(run_functions_add_mul_max_min_for_type<cl_float>);
+    error |= rft.run_batched(run_functions_add_mul_max_min_for_type<cl_double>);
+    error |= rft.run_batched(
+        run_functions_add_mul_max_min_for_type<subgroups::cl_half>);
 
-    error |= run_functions_and_or_xor_for_type<cl_int>(rft);
-    error |= run_functions_and_or_xor_for_type<cl_uint>(rft);
-    error |= run_functions_and_or_xor_for_type<cl_long>(rft);
-    error |= run_functions_and_or_xor_for_type<cl_ulong>(rft);
-    error |= run_functions_and_or_xor_for_type<cl_short>(rft);
-    error |= run_functions_and_or_xor_for_type<cl_ushort>(rft);
-    error |= run_functions_and_or_xor_for_type<cl_char>(rft);
-    error |= run_functions_and_or_xor_for_type<cl_uchar>(rft);
+    error |= rft.run_batched(run_functions_and_or_xor_for_type<cl_int>);
+    error |= rft.run_batched(run_functions_and_or_xor_for_type<cl_uint>);
+    error |= rft.run_batched(run_functions_and_or_xor_for_type<cl_long>);
+    error |= rft.run_batched(run_functions_and_or_xor_for_type<cl_ulong>);
+    error |= rft.run_batched(run_functions_and_or_xor_for_type<cl_short>);
+    error |= rft.run_batched(run_functions_and_or_xor_for_type<cl_ushort>);
+    error |= rft.run_batched(run_functions_and_or_xor_for_type<cl_char>);
+    error |= rft.run_batched(run_functions_and_or_xor_for_type<cl_uchar>);
 
-    error |= run_functions_logical_and_or_xor_for_type<cl_int>(rft);
+    error |= rft.run_batched(run_functions_logical_and_or_xor_for_type<cl_int>);
     return error;
 }
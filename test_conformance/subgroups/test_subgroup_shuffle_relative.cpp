@@ -51,17 +51,17 @@ int test_subgroup_functions_shuffle_relative(cl_device_id device,
     test_params.save_kernel_source(sub_group_generic_source);
     RunTestForType rft(device, context, queue, num_elements, test_params);
 
-    int error = run_shuffle_relative_for_type<cl_int>(rft);
-    error |= run_shuffle_relative_for_type<cl_uint>(rft);
-    error |= run_shuffle_relative_for_type<cl_long>(rft);
-    error |= run_shuffle_relative_for_type<cl_ulong>(rft);
-    error |= run_shuffle_relative_for_type<cl_short>(rft);
-    error |= run_shuffle_relative_for_type<cl_ushort>(rft);
-    error |= run_shuffle_relative_for_type<cl_char>(rft);
-    error |= run_shuffle_relative_for_type<cl_uchar>(rft);
-    error |= run_shuffle_relative_for_type<cl_float>(rft);
-    error |= run_shuffle_relative_for_type<cl_double>(rft);
-    error |= run_shuffle_relative_for_type<subgroups::cl_half>(rft);
+    int error = rft.run_batched(run_shuffle_relative_for_type<cl_int>);
+    error |= rft.run_batched(run_shuffle_relative_for_type<cl_uint>);
+    error |= rft.run_batched(run_shuffle_relative_for_type<cl_long>);
+    error |= rft.run_batched(run_shuffle_relative_for_type<cl_ulong>);
+    error |= rft.run_batched(run_shuffle_relative_for_type<cl_short>);
+    error |= rft.run_batched(run_shuffle_relative_for_type<cl_ushort>);
+    error |= rft.run_batched(run_shuffle_relative_for_type<cl_char>);
+    error |= rft.run_batched(run_shuffle_relative_for_type<cl_uchar>);
+    error |= rft.run_batched(run_shuffle_relative_for_type<cl_float>);
+    error |= rft.run_batched(run_shuffle_relative_for_type<cl_double>);
+    error |= rft.run_batched(run_shuffle_relative_for_type<subgroups::cl_half>);
 
     return error;
 }
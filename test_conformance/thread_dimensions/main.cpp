@@ -31,6 +31,7 @@ test_definition test_list[] = {
     ADD_TEST(full_1d_explicit_local),  ADD_TEST(full_2d_explicit_local),
     ADD_TEST(full_3d_explicit_local),  ADD_TEST(full_1d_implicit_local),
     ADD_TEST(full_2d_implicit_local),  ADD_TEST(full_3d_implicit_local),
+    ADD_BENCHMARK(launch_rate),        ADD_BENCHMARK(tiny_enqueue_latency),
 };
 
 const int test_num = ARRAY_SIZE(test_list);
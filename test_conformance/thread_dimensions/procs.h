@@ -18,6 +18,7 @@
 #include "harness/errorHelpers.h"
 #include "harness/conversions.h"
 #include "harness/mt19937.h"
+#include "harness/parseParameters.h"
 
 extern const int kVectorSizeCount;
 
@@ -70,3 +71,8 @@ extern int test_full_3d_implicit_local(cl_device_id deviceID,
                                        cl_context context,
                                        cl_command_queue queue,
                                        int num_elements);
+
+extern int test_launch_rate(cl_device_id deviceID, cl_context context,
+                            cl_command_queue queue, int num_elements);
+extern int test_tiny_enqueue_latency(cl_device_id deviceID, cl_context context,
+                                     cl_command_queue queue, int num_elements);
@@ -0,0 +1,330 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "harness/compat.h"
+#include "harness/typeWrappers.h"
+#include "harness/benchmark.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "procs.h"
+#include <CL/cl_ext.h>
+
+// Launch rate of a kernel that does next to nothing per work-item, over 1D,
+// 2D and 3D global sizes from one work-item up. Every shape is launched with
+// the implementation's choice of local size, with a global offset, with the
+// size from clGetKernelSuggestedLocalWorkSizeKHR, with every power-of-two
+// local size that fits, and with a non-uniform last work-group. Each row
+// gives the time per launch; the best explicit local size of each shape and
+// the global size at which launches stop being bound by their fixed
+// overhead close the output. A benchmark, so it only runs when named.
+
+static const char *launch_rate_kernel[] = {
+    "__kernel void launch_rate(__global uint *dst, uint marker)\n"
+    "{\n"
+    "    size_t x = get_global_id(0) - get_global_offset(0);\n"
+    "    size_t y = get_global_id(1) - get_global_offset(1);\n"
+    "    size_t z = get_global_id(2) - get_global_offset(2);\n"
+    "    dst[(z * get_global_size(1) + y) * get_global_size(0) + x] = marker;\n"
+    "}\n"
+};
+
+static const cl_uint kMaxLog2Items = 24;
+static const cl_uint kLog2ItemsStep = 2;
+static const size_t kItemsPerConfig = (size_t)1 << 28;
+static const size_t kMaxLaunches = 256;
+static const size_t kMinLaunches = 16;
+// A launch is bound by its fixed overhead until it takes this much longer
+// than launching a single work-item
+static const double kOverheadBoundRatio = 2.0;
+
+namespace {
+
+struct LaunchShape
+{
+    cl_uint dims;
+    size_t global[3];
+    size_t local[3];
+
+    size_t items() const { return global[0] * global[1] * global[2]; }
+};
+
+std::string shape_string(const size_t *sizes, cl_uint dims)
+{
+    std::string s = std::to_string(sizes[0]);
+    for (cl_uint d = 1; d < dims; d++) s += "x" + std::to_string(sizes[d]);
+    return s;
+}
+
+struct LaunchBench
+{
+    cl_command_queue queue;
+    cl_kernel kernel;
+    clMemWrapper buffer;
+    cl_uint marker;
+    std::vector<cl_uint> results;
+    BenchmarkOptions options;
+
+    // Samples the time per launch of shape, launching it enough times per
+    // sample to amortise the final clFinish, then checks that every
+    // work-item of the last launch ran
+    int Time(const LaunchShape &shape, const size_t *offset, bool useLocal,
+             BenchmarkStats &stats)
+    {
+        marker++;
+        int error = clSetKernelArg(kernel, 0, sizeof(cl_mem), &buffer);
+        error |= clSetKernelArg(kernel, 1, sizeof(marker), &marker);
+        test_error(error, "Unable to set kernel arguments");
+
+        const size_t *local = useLocal ? shape.local : NULL;
+        size_t launches = std::min(
+            std::max(kItemsPerConfig / shape.items(), kMinLaunches),
+            kMaxLaunches);
+
+        // The warm-up covers the first launch of a shape paying for setting
+        // it up
+        error = run_benchmark(
+            options,
+            [&](double *us) {
+                HostTimer timer;
+                for (size_t i = 0; i < launches; i++)
+                {
+                    cl_int err = clEnqueueNDRangeKernel(
+                        queue, kernel, shape.dims, offset, shape.global, local,
+                        0, NULL, NULL);
+                    test_error(err, "Kernel execution failed");
+                }
+                cl_int err = clFinish(queue);
+                test_error(err, "clFinish failed");
+                *us = timer.elapsed_us() / launches;
+                return CL_SUCCESS;
+            },
+            &stats);
+        if (error != CL_SUCCESS) return error;
+
+        error = clEnqueueReadBuffer(queue, buffer, CL_TRUE, 0,
+                                    sizeof(cl_uint) * shape.items(),
+                                    results.data(), 0, NULL, NULL);
+        test_error(error, "Unable to read results");
+        for (size_t i = 0; i < shape.items(); i++)
+        {
+            if (results[i] != marker)
+            {
+                log_error("ERROR: work-item %zu of global size %s did not run "
+                          "(found 0x%x, expected 0x%x)\n",
+                          i, shape_string(shape.global, shape.dims).c_str(),
+                          results[i], marker);
+                return -1;
+            }
+        }
+        return 0;
+    }
+
+    void Report(const LaunchShape &shape, bool useLocal, const char *mode,
+                const BenchmarkStats &stats)
+    {
+        std::string label = std::to_string(shape.dims) + "/"
+            + shape_string(shape.global, shape.dims) + "/"
+            + (useLocal ? shape_string(shape.local, shape.dims) : "NULL") + "/"
+            + mode;
+        log_benchmark_stats("launch_rate", label.c_str(), "us", false, stats);
+    }
+};
+
+} // anonymous namespace
+
+int test_launch_rate(cl_device_id deviceID, cl_context context,
+                     cl_command_queue queue, int num_elements)
+{
+    int error;
+    clProgramWrapper program;
+    clKernelWrapper kernel;
+    error = create_single_kernel_helper(context, &program, &kernel, 1,
+                                        launch_rate_kernel, "launch_rate");
+    test_error(error, "Unable to create the launch rate kernel");
+
+    size_t max_wg_size, kernel_wg_size;
+    size_t max_item_sizes[3];
+    cl_ulong max_alloc;
+    error = clGetDeviceInfo(deviceID, CL_DEVICE_MAX_WORK_GROUP_SIZE,
+                            sizeof(max_wg_size), &max_wg_size, NULL);
+    test_error(error, "clGetDeviceInfo failed");
+    error = clGetDeviceInfo(deviceID, CL_DEVICE_MAX_WORK_ITEM_SIZES,
+                            sizeof(max_item_sizes), max_item_sizes, NULL);
+    test_error(error, "clGetDeviceInfo failed");
+    error = clGetDeviceInfo(deviceID, CL_DEVICE_MAX_MEM_ALLOC_SIZE,
+                            sizeof(max_alloc), &max_alloc, NULL);
+    test_error(error, "clGetDeviceInfo failed");
+    error = clGetKernelWorkGroupInfo(kernel, deviceID,
+                                     CL_KERNEL_WORK_GROUP_SIZE,
+                                     sizeof(kernel_wg_size), &kernel_wg_size,
+                                     NULL);
+    test_error(error, "clGetKernelWorkGroupInfo failed");
+    max_wg_size = std::min(max_wg_size, kernel_wg_size);
+
+    // Non-uniform work-groups are core in 2.x and optional from 3.0 on
+    cl_bool non_uniform = CL_FALSE;
+    Version version = get_device_cl_version(deviceID);
+    if (version >= Version(3, 0))
+    {
+        error = clGetDeviceInfo(deviceID,
+                                CL_DEVICE_NON_UNIFORM_WORK_GROUP_SUPPORT,
+                                sizeof(non_uniform), &non_uniform, NULL);
+        test_error(error, "clGetDeviceInfo failed");
+    }
+    else if (version >= Version(2, 0))
+    {
+        non_uniform = CL_TRUE;
+    }
+
+    clGetKernelSuggestedLocalWorkSizeKHR_fn getSuggestedLocalWorkSize = NULL;
+    if (is_extension_available(deviceID, "cl_khr_suggested_local_work_size"))
+    {
+        cl_platform_id platform;
+        error = clGetDeviceInfo(deviceID, CL_DEVICE_PLATFORM, sizeof(platform),
+                                &platform, NULL);
+        test_error(error, "clGetDeviceInfo failed");
+        getSuggestedLocalWorkSize = (clGetKernelSuggestedLocalWorkSizeKHR_fn)
+            clGetExtensionFunctionAddressForPlatform(
+                platform, "clGetKernelSuggestedLocalWorkSizeKHR");
+    }
+
+    // The non-uniform launches add a column to shapes at least two wide, so
+    // they need up to half as many work-items again
+    cl_uint max_log2_items = kMaxLog2Items;
+    while (max_log2_items > 0
+           && sizeof(cl_uint) * ((cl_ulong)3 << max_log2_items) / 2
+               > max_alloc)
+        max_log2_items--;
+
+    LaunchBench bench;
+    bench.queue = queue;
+    bench.kernel = kernel;
+    bench.marker = 0;
+    // Every shape is swept over many local sizes, so each gets a short run
+    bench.options.warmup = 1;
+    bench.options.minSamples = 5;
+    bench.options.maxSeconds = 0.25;
+    bench.results.resize(((size_t)3 << max_log2_items) / 2);
+    bench.buffer =
+        clCreateBuffer(context, CL_MEM_WRITE_ONLY,
+                       sizeof(cl_uint) * bench.results.size(), NULL, &error);
+    test_error(error, "Unable to create output buffer");
+
+    log_benchmark_header("launch_rate", "dims/global/local/mode");
+
+    std::vector<std::string> summary;
+    for (cl_uint dims = 1; dims <= 3; dims++)
+    {
+        double single_item_us = 0;
+        size_t overhead_bound_until = 0;
+        for (cl_uint log2_items = 0; log2_items <= max_log2_items;
+             log2_items += kLog2ItemsStep)
+        {
+            // Spread the work-items as evenly as powers of two allow
+            LaunchShape shape = { dims, { 1, 1, 1 }, { 1, 1, 1 } };
+            for (cl_uint d = 0; d < dims; d++)
+            {
+                cl_uint bits = log2_items / dims
+                    + (d < log2_items % dims ? 1 : 0);
+                shape.global[d] = (size_t)1 << bits;
+            }
+
+            BenchmarkStats stats;
+            error = bench.Time(shape, NULL, false, stats);
+            if (error) return error;
+            bench.Report(shape, false, "default", stats);
+            if (log2_items == 0) single_item_us = stats.median;
+            if (!overhead_bound_until
+                && stats.median > kOverheadBoundRatio * single_item_us)
+                overhead_bound_until = shape.items();
+
+            size_t offset[3] = { 3, 5, 7 };
+            error = bench.Time(shape, offset, false, stats);
+            if (error) return error;
+            bench.Report(shape, false, "offset", stats);
+
+            if (getSuggestedLocalWorkSize)
+            {
+                error = getSuggestedLocalWorkSize(queue, kernel, dims, NULL,
+                                                  shape.global, shape.local);
+                test_error(error,
+                           "clGetKernelSuggestedLocalWorkSizeKHR failed");
+                error = bench.Time(shape, NULL, true, stats);
+                if (error) return error;
+                bench.Report(shape, true, "suggested", stats);
+            }
+
+            // Every power-of-two work-group size, filling the lowest
+            // dimension first. Powers of two always divide the global size.
+            LaunchShape best = shape;
+            double best_us = 0;
+            for (size_t wg_size = 1; wg_size <= max_wg_size; wg_size *= 2)
+            {
+                size_t remaining = wg_size;
+                for (cl_uint d = 0; d < dims; d++)
+                {
+                    size_t limit =
+                        std::min(shape.global[d], max_item_sizes[d]);
+                    shape.local[d] = 1;
+                    while (shape.local[d] * 2 <= std::min(remaining, limit))
+                        shape.local[d] *= 2;
+                    remaining /= shape.local[d];
+                }
+                if (remaining != 1) break;
+
+                error = bench.Time(shape, NULL, true, stats);
+                if (error) return error;
+                bench.Report(shape, true, "explicit", stats);
+                if (best_us == 0 || stats.median < best_us)
+                {
+                    best = shape;
+                    best_us = stats.median;
+                }
+            }
+            summary.push_back(
+                std::to_string(dims) + "\t"
+                + shape_string(best.global, dims) + "\t"
+                + shape_string(best.local, dims) + "\t"
+                + std::to_string(best_us));
+
+            // The best work-group size with the last work-group cut short
+            if (non_uniform && best.local[0] > 1)
+            {
+                best.global[0]++;
+                error = bench.Time(best, NULL, true, stats);
+                if (error) return error;
+                bench.Report(best, true, "non-uniform", stats);
+            }
+        }
+
+        if (overhead_bound_until)
+            log_info("%uD launches are bound by launch overhead below %zu "
+                     "work-items\n",
+                     dims, overhead_bound_until);
+        else
+            log_info("%uD launches are bound by launch overhead up to %zu "
+                     "work-items\n",
+                     dims, (size_t)1 << max_log2_items);
+    }
+
+    log_info("BENCH\tbest\tdims\tglobal\tlocal\tus/launch\n");
+    for (size_t i = 0; i < summary.size(); i++)
+        log_info("BENCH\tbest\t%s\n", summary[i].c_str());
+
+    return 0;
+}
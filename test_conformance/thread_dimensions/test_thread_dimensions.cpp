@@ -20,6 +20,9 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 
+#include <vector>
+
+#include "harness/typeWrappers.h"
 #include "procs.h"
 
 #define ITERATIONS 4
@@ -245,6 +248,58 @@ static const char *thread_dimension_kernel_code_not_atomic_not_long =
     "\n"
     "}\n";
 
+// Summarizes a launch in four counters instead of a word per work-item: how
+// many work-items ran, the sums of their linear addresses and of the squares
+// of those addresses, both modulo 2^32, and the error bits of work-items
+// outside the final sizes. Each work-group sums in local memory first so
+// that only one work-item per group touches the launch's counters.
+static const char *thread_dimension_kernel_code_summary =
+    "\n"
+    "__kernel void test_thread_dimension_summary(__global uint *summaries,\n"
+    "          uint final_x_size,   uint final_y_size,   uint final_z_size,\n"
+    "          uint slot)\n"
+    "{\n"
+    "    __local uint group_summary[4];\n"
+    "    int first = get_local_id(0) == 0 && get_local_id(1) == 0\n"
+    "        && get_local_id(2) == 0;\n"
+    "    if (first)\n"
+    "    {\n"
+    "        group_summary[0] = 0;\n"
+    "        group_summary[1] = 0;\n"
+    "        group_summary[2] = 0;\n"
+    "        group_summary[3] = 0;\n"
+    "    }\n"
+    "    barrier(CLK_LOCAL_MEM_FENCE);\n"
+    "\n"
+    "    uint error = 0;\n"
+    "    if (get_global_id(0) >= final_x_size)\n"
+    "        error = 64;\n"
+    "    if (get_global_id(1) >= final_y_size)\n"
+    "        error = 128;\n"
+    "    if (get_global_id(2) >= final_z_size)\n"
+    "        error = 256;\n"
+    "\n"
+    "    uint t_address = (uint)((ADDRESS_TYPE)get_global_id(2)\n"
+    "            * (ADDRESS_TYPE)final_y_size * (ADDRESS_TYPE)final_x_size\n"
+    "        + (ADDRESS_TYPE)get_global_id(1) * (ADDRESS_TYPE)final_x_size\n"
+    "        + (ADDRESS_TYPE)get_global_id(0));\n"
+    "    atomic_inc(&group_summary[0]);\n"
+    "    atomic_add(&group_summary[1], t_address);\n"
+    "    atomic_add(&group_summary[2], t_address * t_address);\n"
+    "    if (error)\n"
+    "        atomic_or(&group_summary[3], error);\n"
+    "    barrier(CLK_LOCAL_MEM_FENCE);\n"
+    "\n"
+    "    if (first)\n"
+    "    {\n"
+    "        __global uint *summary = summaries + 4 * slot;\n"
+    "        atomic_add(&summary[0], group_summary[0]);\n"
+    "        atomic_add(&summary[1], group_summary[1]);\n"
+    "        atomic_add(&summary[2], group_summary[2]);\n"
+    "        atomic_or(&summary[3], group_summary[3]);\n"
+    "    }\n"
+    "}\n";
+
 char dim_str[128];
 char *print_dimensions(size_t x, size_t y, size_t z, cl_uint dim)
 {
@@ -496,6 +551,164 @@ static void set_min(cl_uint *x, cl_uint *y, cl_uint *z)
 }
 
 
+// Launches checked from one read of their summaries
+#define SUMMARIES_PER_SYNC 256
+
+// Sum of the linear addresses 0..total-1 and of their squares, modulo 2^32
+// like the kernel's, dividing the factors exactly before wrapping
+static void expected_summary(cl_ulong total, cl_uint summary[4])
+{
+    cl_ulong n = total, n_minus_1 = total - 1, two_n_minus_1 = 2 * total - 1;
+
+    cl_ulong sum = (n % 2 == 0) ? (n / 2) * n_minus_1 : n * (n_minus_1 / 2);
+
+    if (n % 2 == 0)
+        n /= 2;
+    else
+        n_minus_1 /= 2;
+    if (n % 3 == 0)
+        n /= 3;
+    else if (n_minus_1 % 3 == 0)
+        n_minus_1 /= 3;
+    else
+        two_n_minus_1 /= 3;
+    cl_ulong sum_of_squares = n * n_minus_1 * two_n_minus_1;
+
+    summary[0] = (cl_uint)total;
+    summary[1] = (cl_uint)sum;
+    summary[2] = (cl_uint)sum_of_squares;
+    summary[3] = 0;
+}
+
+typedef struct
+{
+    cl_uint global[3];
+    cl_uint local[3];
+} summary_launch;
+
+/*
+ Enqueues launches of the summary kernel without waiting on them, each
+ accumulating into its own slot of a small buffer, and checks up to
+ SUMMARIES_PER_SYNC of them with one read. Launches whose summary is wrong are
+ run again through run_test for the per-work-item details.
+ */
+typedef struct
+{
+    cl_command_queue queue;
+    cl_kernel kernel;
+    clMemWrapper summaries;
+    cl_uint dimensions;
+    int explicit_local;
+    std::vector<summary_launch> launches;
+} summary_batch;
+
+static int enqueue_summary_launch(summary_batch *batch, cl_uint final_x_size,
+                                  cl_uint final_y_size, cl_uint final_z_size,
+                                  cl_uint local_x_size, cl_uint local_y_size,
+                                  cl_uint local_z_size)
+{
+    int err;
+    cl_uint slot = (cl_uint)batch->launches.size();
+    if (slot == 0)
+    {
+        const cl_uint zero = 0;
+        err = clEnqueueFillBuffer(batch->queue, batch->summaries, &zero,
+                                  sizeof(zero), 0,
+                                  SUMMARIES_PER_SYNC * 4 * sizeof(cl_uint), 0,
+                                  NULL, NULL);
+        if (err != CL_SUCCESS)
+        {
+            print_error(err, "Failed to clear summaries.");
+            return -3;
+        }
+    }
+
+    err = clSetKernelArg(batch->kernel, 0, sizeof(cl_mem), &batch->summaries);
+    err |= clSetKernelArg(batch->kernel, 1, sizeof(final_x_size),
+                          &final_x_size);
+    err |= clSetKernelArg(batch->kernel, 2, sizeof(final_y_size),
+                          &final_y_size);
+    err |= clSetKernelArg(batch->kernel, 3, sizeof(final_z_size),
+                          &final_z_size);
+    err |= clSetKernelArg(batch->kernel, 4, sizeof(slot), &slot);
+    if (err != CL_SUCCESS)
+    {
+        print_error(err, "Failed to set arguments.");
+        return -3;
+    }
+
+    summary_launch launch = { { final_x_size, final_y_size, final_z_size },
+                              { local_x_size, local_y_size, local_z_size } };
+    size_t global_size[3] = { final_x_size, final_y_size, final_z_size };
+    size_t local_size[3] = { local_x_size, local_y_size, local_z_size };
+    err = clEnqueueNDRangeKernel(batch->queue, batch->kernel,
+                                 batch->dimensions, NULL, global_size,
+                                 batch->explicit_local ? local_size : NULL, 0,
+                                 NULL, NULL);
+    if (err == CL_OUT_OF_RESOURCES)
+    {
+        log_info("WARNING: kernel reported CL_OUT_OF_RESOURCES, indicating the "
+                 "global dimensions are too large. Skipping this size.\n");
+        return 0;
+    }
+    if (err != CL_SUCCESS)
+    {
+        print_error(err, "Failed to execute kernel\n");
+        return -3;
+    }
+
+    batch->launches.push_back(launch);
+    return 0;
+}
+
+static int check_summary_launches(summary_batch *batch, cl_context context,
+                                  cl_kernel kernel, cl_mem array,
+                                  cl_uint memory_size)
+{
+    if (batch->launches.empty()) return 0;
+
+    std::vector<cl_uint> summaries(batch->launches.size() * 4);
+    int err = clEnqueueReadBuffer(batch->queue, batch->summaries, CL_TRUE, 0,
+                                  summaries.size() * sizeof(cl_uint),
+                                  &summaries.front(), 0, NULL, NULL);
+    if (err != CL_SUCCESS)
+    {
+        print_error(err, "Failed to read summaries\n");
+        return -4;
+    }
+
+    int failed = 0;
+    for (size_t i = 0; i < batch->launches.size(); i++)
+    {
+        const summary_launch &launch = batch->launches[i];
+        const cl_uint *summary = &summaries[i * 4];
+        cl_uint expected[4];
+        expected_summary((cl_ulong)launch.global[0] * launch.global[1]
+                             * launch.global[2],
+                         expected);
+        if (memcmp(summary, expected, sizeof(expected)) == 0) continue;
+
+        log_error("Test global %s local %s failed: %u work-items ran, "
+                  "expected %u (address sums 0x%x, 0x%x, expected 0x%x, 0x%x, "
+                  "error bits 0x%x).\n",
+                  print_dimensions(launch.global[0], launch.global[1],
+                                   launch.global[2], batch->dimensions),
+                  print_dimensions2(launch.local[0], launch.local[1],
+                                    launch.local[2], batch->dimensions),
+                  summary[0], expected[0], summary[1], summary[2],
+                  expected[1], expected[2], summary[3]);
+        log_info("\tRechecking every work-item...\n");
+        run_test(context, batch->queue, kernel, array, memory_size,
+                 batch->dimensions, launch.global[0], launch.global[1],
+                 launch.global[2], launch.local[0], launch.local[1],
+                 launch.local[2], batch->explicit_local);
+        failed = 1;
+    }
+
+    batch->launches.clear();
+    return failed ? -1 : 0;
+}
+
 int test_thread_dimensions(cl_device_id device, cl_context context,
                            cl_command_queue queue, cl_uint dimensions,
                            cl_uint min_dim, cl_uint max_dim, cl_uint quick_test,
@@ -588,6 +801,31 @@ int test_thread_dimensions(cl_device_id device, cl_context context,
     }
     test_error(err, "Unable to create testing kernel");
 
+    // With atomics, launches are checked through their summaries, many at a
+    // time, and only the failing ones with the per-work-item kernel
+    clProgramWrapper summary_program;
+    clKernelWrapper summary_kernel;
+    summary_batch batch;
+    if (use_atomics)
+    {
+        err = create_single_kernel_helper(
+            context, &summary_program, &summary_kernel, 1,
+            &thread_dimension_kernel_code_summary,
+            "test_thread_dimension_summary",
+            gHasLong ? "-DADDRESS_TYPE=ulong" : "-DADDRESS_TYPE=uint");
+        test_error(err, "Unable to create summary kernel");
+
+        batch.queue = queue;
+        batch.kernel = summary_kernel;
+        batch.dimensions = dimensions;
+        batch.explicit_local = explicit_local;
+        batch.summaries = clCreateBuffer(context, CL_MEM_READ_WRITE,
+                                         SUMMARIES_PER_SYNC * 4
+                                             * sizeof(cl_uint),
+                                         NULL, &err);
+        test_error(err, "Unable to create summary buffer");
+    }
+
     err = clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_ITEM_SIZES,
                           sizeof(max_local_workgroup_size),
                           max_local_workgroup_size, NULL);
@@ -1032,11 +1270,27 @@ int test_thread_dimensions(cl_device_id device, cl_context context,
                             }
                         }
 
-                        err =
-                            run_test(context, queue, kernel, array, memory_size,
-                                     dimensions, final_x_size, final_y_size,
-                                     final_z_size, local_x_size, local_y_size,
-                                     local_z_size, explicit_local);
+                        if (use_atomics)
+                        {
+                            err = enqueue_summary_launch(
+                                &batch, final_x_size, final_y_size,
+                                final_z_size, local_x_size, local_y_size,
+                                local_z_size);
+                            if (!err
+                                && batch.launches.size() == SUMMARIES_PER_SYNC)
+                                err = check_summary_launches(
+                                    &batch, context, kernel, array,
+                                    memory_size);
+                        }
+                        else
+                        {
+                            err = run_test(context, queue, kernel, array,
+                                           memory_size, dimensions,
+                                           final_x_size, final_y_size,
+                                           final_z_size, local_x_size,
+                                           local_y_size, local_z_size,
+                                           explicit_local);
+                        }
 
                         // If we failed to execute, then return so we don't
                         // crash.
@@ -1091,6 +1345,9 @@ int test_thread_dimensions(cl_device_id device, cl_context context,
         if (z_size > max_z_size) z_size = max_z_size;
     } // z_size
 
+    if (use_atomics
+        && check_summary_launches(&batch, context, kernel, array, memory_size))
+        errors++;
 
     free_mtdata(d);
     clReleaseMemObject(array);
@@ -0,0 +1,248 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+#include "harness/compat.h"
+#include "harness/benchmark.h"
+#include "harness/typeWrappers.h"
+
+#include <string>
+
+#include "procs.h"
+
+// Fixed per-command cost of commands that do next to no work: a marker, a
+// zero-sized NDRange, a single work-item NDRange, and 1-byte copies and
+// writes. Each command is timed both pipelined, many back to back with one
+// clFinish at the end, and round trip, enqueued and waited on one at a
+// time. The pipelined time is the submission cost a stream of tiny commands
+// pays per command; the round trip adds the cost of getting a completion
+// back to the host. Complements launch_rate, whose smallest launches are
+// bound by the same overhead. A benchmark, so it only runs when named.
+
+static const char *tiny_enqueue_kernel[] = {
+    "__kernel void tiny_enqueue(__global uint *dst, uint marker)\n"
+    "{\n"
+    "    dst[get_global_id(0)] = marker;\n"
+    "}\n"
+};
+
+// Commands per pipelined sample
+static const size_t kPipelinedCommands = 4096;
+static const cl_uint kUntouched = 0xdeadbeef;
+
+namespace {
+
+enum TinyCommand
+{
+    kMarker,
+    kZeroSizedNDRange,
+    kSingleItemNDRange,
+    kCopyByte,
+    kWriteByte,
+    kTinyCommandCount
+};
+
+const char *kTinyCommandNames[kTinyCommandCount] = {
+    "marker", "ndrange_zero_sized", "ndrange_1_item", "copy_1_byte",
+    "write_1_byte",
+};
+
+struct TinyBench
+{
+    cl_command_queue queue;
+    cl_kernel kernel;
+    clMemWrapper dst;
+    clMemWrapper src;
+    cl_uint marker;
+    cl_uchar byte;
+    BenchmarkOptions options;
+
+    cl_int Enqueue(TinyCommand command)
+    {
+        size_t zero = 0, one = 1;
+        switch (command)
+        {
+            case kMarker:
+                return clEnqueueMarkerWithWaitList(queue, 0, NULL, NULL);
+            case kZeroSizedNDRange:
+                return clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &zero,
+                                              NULL, 0, NULL, NULL);
+            case kSingleItemNDRange:
+                return clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &one,
+                                              NULL, 0, NULL, NULL);
+            case kCopyByte:
+                return clEnqueueCopyBuffer(queue, src, dst, 0, 0, 1, 0, NULL,
+                                           NULL);
+            case kWriteByte:
+                return clEnqueueWriteBuffer(queue, dst, CL_FALSE, 0, 1, &byte,
+                                            0, NULL, NULL);
+            default: return CL_INVALID_VALUE;
+        }
+    }
+
+    // Resets dst and the arguments so that Check can tell whether the
+    // commands since ran
+    int Prepare(TinyCommand command)
+    {
+        marker++;
+        cl_int error = clSetKernelArg(kernel, 0, sizeof(cl_mem), &dst);
+        error |= clSetKernelArg(kernel, 1, sizeof(marker), &marker);
+        test_error(error, "Unable to set kernel arguments");
+
+        error = clEnqueueWriteBuffer(queue, dst, CL_TRUE, 0, sizeof(kUntouched),
+                                     &kUntouched, 0, NULL, NULL);
+        test_error(error, "Unable to reset the destination buffer");
+
+        // Both byte commands store the low byte of the marker
+        byte = (cl_uchar)marker;
+        if (command == kCopyByte)
+        {
+            error = clEnqueueWriteBuffer(queue, src, CL_TRUE, 0, 1, &byte, 0,
+                                         NULL, NULL);
+            test_error(error, "Unable to fill the source buffer");
+        }
+        return 0;
+    }
+
+    int Check(TinyCommand command)
+    {
+        cl_uint value;
+        cl_int error = clEnqueueReadBuffer(queue, dst, CL_TRUE, 0,
+                                           sizeof(value), &value, 0, NULL,
+                                           NULL);
+        test_error(error, "Unable to read the destination buffer");
+
+        cl_uint expected = kUntouched;
+        if (command == kSingleItemNDRange)
+            expected = marker;
+        else if (command == kCopyByte || command == kWriteByte)
+        {
+            cl_uchar *bytes = (cl_uchar *)&expected;
+            bytes[0] = byte;
+        }
+        if (value != expected)
+        {
+            log_error("ERROR: %s left 0x%x in the destination buffer, "
+                      "expected 0x%x\n",
+                      kTinyCommandNames[command], value, expected);
+            return -1;
+        }
+        return 0;
+    }
+
+    // Samples the time per command of kPipelinedCommands back to back
+    int TimePipelined(TinyCommand command, BenchmarkStats &stats)
+    {
+        int error = Prepare(command);
+        if (error) return error;
+
+        // The warm-up covers the first command of a kind paying for setting
+        // it up
+        error = run_benchmark(
+            options,
+            [&](double *us) {
+                HostTimer timer;
+                for (size_t i = 0; i < kPipelinedCommands; i++)
+                {
+                    cl_int err = Enqueue(command);
+                    test_error(err, "Unable to enqueue command");
+                }
+                cl_int err = clFinish(queue);
+                test_error(err, "clFinish failed");
+                *us = timer.elapsed_us() / kPipelinedCommands;
+                return CL_SUCCESS;
+            },
+            &stats);
+        if (error != CL_SUCCESS) return error;
+
+        return Check(command);
+    }
+
+    // Samples the time to enqueue one command and wait for it
+    int TimeRoundTrip(TinyCommand command, BenchmarkStats &stats)
+    {
+        int error = Prepare(command);
+        if (error) return error;
+
+        error = run_benchmark(
+            options,
+            [&](double *us) {
+                HostTimer timer;
+                cl_int err = Enqueue(command);
+                test_error(err, "Unable to enqueue command");
+                err = clFinish(queue);
+                test_error(err, "clFinish failed");
+                *us = timer.elapsed_us();
+                return CL_SUCCESS;
+            },
+            &stats);
+        if (error != CL_SUCCESS) return error;
+
+        return Check(command);
+    }
+};
+
+} // anonymous namespace
+
+int test_tiny_enqueue_latency(cl_device_id deviceID, cl_context context,
+                              cl_command_queue queue, int num_elements)
+{
+    int error;
+    clProgramWrapper program;
+    clKernelWrapper kernel;
+    error = create_single_kernel_helper(context, &program, &kernel, 1,
+                                        tiny_enqueue_kernel, "tiny_enqueue");
+    test_error(error, "Unable to create the tiny enqueue kernel");
+
+    TinyBench bench;
+    bench.queue = queue;
+    bench.kernel = kernel;
+    bench.marker = 0;
+    bench.byte = 0;
+    bench.options.warmup = 1;
+    bench.options.maxSeconds = 1.0;
+    bench.dst = clCreateBuffer(context, CL_MEM_READ_WRITE, sizeof(cl_uint),
+                               NULL, &error);
+    test_error(error, "Unable to create destination buffer");
+    bench.src = clCreateBuffer(context, CL_MEM_READ_WRITE, sizeof(cl_uint),
+                               NULL, &error);
+    test_error(error, "Unable to create source buffer");
+
+    // Zero-sized NDRanges are only legal from OpenCL 2.1 on
+    bool zero_sized = get_device_cl_version(deviceID) >= Version(2, 1);
+
+    log_benchmark_header("tiny_enqueue", "command/mode");
+    for (int c = 0; c < kTinyCommandCount; c++)
+    {
+        TinyCommand command = (TinyCommand)c;
+        if (command == kZeroSizedNDRange && !zero_sized)
+        {
+            log_info("Zero-sized NDRanges need OpenCL 2.1, skipping them\n");
+            continue;
+        }
+
+        std::string name = kTinyCommandNames[command];
+        BenchmarkStats pipelined, round_trip;
+        error = bench.TimePipelined(command, pipelined);
+        if (error) return error;
+        log_benchmark_stats("tiny_enqueue", (name + "/pipelined").c_str(), "us",
+                            false, pipelined);
+        error = bench.TimeRoundTrip(command, round_trip);
+        if (error) return error;
+        log_benchmark_stats("tiny_enqueue", (name + "/round_trip").c_str(),
+                            "us", false, round_trip);
+    }
+
+    return 0;
+}
@@ -75,6 +75,27 @@ int clStateMakeProgram(clState *pState, const char *prog,
     return err;
 }
 
+int clStateMakeKernel(clState *pState, const char *kernelName)
+{
+    int err;
+    if (pState->m_kernel != NULL)
+    {
+        clReleaseKernel(pState->m_kernel);
+    }
+    pState->m_kernel = clCreateKernel(pState->m_program, kernelName, &err);
+    if (pState->m_kernel == NULL)
+    {
+        log_error("clCreateKernel failed for %s (%d)\n", kernelName, err);
+        return -1;
+    }
+    return 0;
+}
+
+std::string vecSizeSuffix(int vecSizeIdx)
+{
+    return "_" + std::to_string(g_arrVecSizes[vecSizeIdx]);
+}
+
 int runKernel(clState *pState, size_t numThreads)
 {
     int err;
@@ -19,6 +19,8 @@
 #include "harness/conversions.h"
 #include "harness/typeWrappers.h"
 
+#include <string>
+
 typedef struct _clState
 {
     cl_device_id m_device;
@@ -36,6 +38,12 @@ clState* destroyClState(clState* pState);
 
 int clStateMakeProgram(clState* pState, const char* prog,
                        const char* kernelName);
+// Replace the kernel with another one of the same program, for programs that
+// hold the variants of a test for every vector size
+int clStateMakeKernel(clState* pState, const char* kernelName);
+// What the kernel and type names of the variant for the vector size at
+// vecSizeIdx end in, taking the place of .ID. in a kernel pattern
+std::string vecSizeSuffix(int vecSizeIdx);
 void clStateDestroyProgramAndKernel(clState* pState);
 
 int runKernel(clState* pState, size_t numThreads);
@@ -87,13 +87,19 @@ int test_step_internal(cl_device_id deviceID, cl_context context,
                             ? "#pragma OPENCL EXTENSION cl_khr_fp64 : enable"
                             : "");
 
+        // Every vector size of a type goes into one program, with its kernel
+        // named after the size, so that each type is built only once
+        std::string source;
         for (vecSizeIdx = 0; vecSizeIdx < NUM_VECTOR_SIZES; ++vecSizeIdx)
         {
             doReplace(srcBuffer, 2048, tempBuffer, ".TYPE.",
                       g_arrTypeNames[typeIdx], ".NUM.",
                       g_arrVecSizeNames[vecSizeIdx]);
+            char variantBuffer[2048];
+            doSingleReplace(variantBuffer, 2048, srcBuffer, ".ID.",
+                            vecSizeSuffix(vecSizeIdx).c_str());
 
-            if (srcBuffer[0] == '\0')
+            if (srcBuffer[0] == '\0' || variantBuffer[0] == '\0')
             {
                 vlog_error("%s: failed to fill source buf for type %s%s\n",
                            testName, g_arrTypeNames[typeIdx],
@@ -102,15 +108,35 @@ int test_step_internal(cl_device_id deviceID, cl_context context,
                 destroyClState(pClState);
                 return -1;
             }
+            source += variantBuffer;
+        }
+
+        err = clStateMakeProgram(pClState, source.c_str(),
+                                 (testName + vecSizeSuffix(0)).c_str());
+        if (err)
+        {
+            vlog_error("%s: Error compiling \"\n%s\n\"", testName,
+                       source.c_str());
+            destroyBufferStruct(pBuffers, pClState);
+            destroyClState(pClState);
+            return -1;
+        }
 
-            err = clStateMakeProgram(pClState, srcBuffer, testName);
-            if (err)
+        for (vecSizeIdx = 0; vecSizeIdx < NUM_VECTOR_SIZES; ++vecSizeIdx)
+        {
+            if (vecSizeIdx != 0)
             {
-                vlog_error("%s: Error compiling \"\n%s\n\"", testName,
-                           srcBuffer);
-                destroyBufferStruct(pBuffers, pClState);
-                destroyClState(pClState);
-                return -1;
+                err = clStateMakeKernel(
+                    pClState, (testName + vecSizeSuffix(vecSizeIdx)).c_str());
+                if (err != 0)
+                {
+                    vlog_error("%s: failed to create kernel %s%s\n",
+                               testName, g_arrTypeNames[typeIdx],
+                               g_arrVecSizeNames[vecSizeIdx]);
+                    destroyBufferStruct(pBuffers, pClState);
+                    destroyClState(pClState);
+                    return -1;
+                }
             }
 
             err = pushArgs(pBuffers, pClState);
@@ -156,14 +182,15 @@ int test_step_internal(cl_device_id deviceID, cl_context context,
                 vlog_error("%s: incorrect results %s%s\n", testName,
                            g_arrTypeNames[typeIdx],
                            g_arrVecSizeNames[vecSizeIdx]);
-                vlog_error("%s: Source was \"\n%s\n\"", testName, srcBuffer);
+                vlog_error("%s: Source was \"\n%s\n\"", testName,
+                           source.c_str());
                 destroyBufferStruct(pBuffers, pClState);
                 destroyClState(pClState);
                 return -1;
             }
-
-            clStateDestroyProgramAndKernel(pClState);
         }
+
+        clStateDestroyProgramAndKernel(pClState);
     }
 
     destroyBufferStruct(pBuffers, pClState);
@@ -177,8 +204,8 @@ int test_step_internal(cl_device_id deviceID, cl_context context,
 
 static const char* patterns[] = {
     ".EXTENSIONS.\n"
-    "__kernel void test_step_type(__global .TYPE..NUM. *source, __global int "
-    "*dest)\n"
+    "__kernel void test_step_type.ID.(__global .TYPE..NUM. *source, "
+    "__global int *dest)\n"
     "{\n"
     "    int  tid = get_global_id(0);\n"
     "    dest[tid] = vec_step(.TYPE..NUM.);\n"
@@ -186,8 +213,8 @@ static const char* patterns[] = {
     "}\n",
 
     ".EXTENSIONS.\n"
-    "__kernel void test_step_var(__global .TYPE..NUM. *source, __global int "
-    "*dest)\n"
+    "__kernel void test_step_var.ID.(__global .TYPE..NUM. *source, "
+    "__global int *dest)\n"
     "{\n"
     "    int  tid = get_global_id(0);\n"
     "    dest[tid] = vec_step(source[tid]);\n"
@@ -195,19 +222,19 @@ static const char* patterns[] = {
     "}\n",
 
     ".EXTENSIONS.\n"
-    " typedef .TYPE..NUM. TypeToTest;\n"
-    "__kernel void test_step_typedef_type(__global TypeToTest *source, "
-    "__global int *dest)\n"
+    " typedef .TYPE..NUM. TypeToTest.ID.;\n"
+    "__kernel void test_step_typedef_type.ID.(__global TypeToTest.ID. "
+    "*source, __global int *dest)\n"
     "{\n"
     "    int  tid = get_global_id(0);\n"
-    "    dest[tid] = vec_step(TypeToTest);\n"
+    "    dest[tid] = vec_step(TypeToTest.ID.);\n"
     "\n"
     "}\n",
 
     ".EXTENSIONS.\n"
-    " typedef .TYPE..NUM. TypeToTest;\n"
-    "__kernel void test_step_typedef_var(__global TypeToTest *source, __global "
-    "int *dest)\n"
+    " typedef .TYPE..NUM. TypeToTest.ID.;\n"
+    "__kernel void test_step_typedef_var.ID.(__global TypeToTest.ID. "
+    "*source, __global int *dest)\n"
     "{\n"
     "    int  tid = get_global_id(0);\n"
     "    dest[tid] = vec_step(source[tid]);\n"
@@ -131,17 +131,19 @@ int test_vec_internal(cl_device_id deviceID, cl_context context,
         postSizeBytes = postSize + typeSize * typeMultiplePostSize;
 
 
+        // Every vector size of a type goes into one program, with its kernel
+        // and struct named after the size, so that each type is built once
+        std::string source;
         for (vecSizeIdx = 1; vecSizeIdx < NUM_VECTOR_SIZES; ++vecSizeIdx)
         {
-
-            totSize = preSizeBytes + postSizeBytes
-                + typeSize * get_align(g_arrVecSizes[vecSizeIdx]);
-
             doReplace(srcBuffer, 2048, tmpBuffer, ".TYPE.",
                       g_arrTypeNames[typeIdx], ".NUM.",
                       g_arrVecSizeNames[vecSizeIdx]);
+            char variantBuffer[2048];
+            doSingleReplace(variantBuffer, 2048, srcBuffer, ".ID.",
+                            vecSizeSuffix(vecSizeIdx).c_str());
 
-            if (srcBuffer[0] == '\0')
+            if (srcBuffer[0] == '\0' || variantBuffer[0] == '\0')
             {
                 vlog_error("%s: failed to fill source buf for type %s%s\n",
                            testName, g_arrTypeNames[typeIdx],
@@ -150,18 +152,42 @@ int test_vec_internal(cl_device_id deviceID, cl_context context,
                 destroyClState(pClState);
                 return -1;
             }
+            source += variantBuffer;
+        }
+
+        // log_info("Buffer is \"\n%s\n\"\n", source.c_str());
+        // fflush(stdout);
 
-            // log_info("Buffer is \"\n%s\n\"\n", srcBuffer);
-            // fflush(stdout);
+        err = clStateMakeProgram(pClState, source.c_str(),
+                                 (testName + vecSizeSuffix(1)).c_str());
+        if (err)
+        {
+            vlog_error("%s: Error compiling \"\n%s\n\"", testName,
+                       source.c_str());
+            destroyBufferStruct(pBuffers, pClState);
+            destroyClState(pClState);
+            return -1;
+        }
+
+        for (vecSizeIdx = 1; vecSizeIdx < NUM_VECTOR_SIZES; ++vecSizeIdx)
+        {
 
-            err = clStateMakeProgram(pClState, srcBuffer, testName);
-            if (err)
+            totSize = preSizeBytes + postSizeBytes
+                + typeSize * get_align(g_arrVecSizes[vecSizeIdx]);
+
+            if (vecSizeIdx != 1)
             {
-                vlog_error("%s: Error compiling \"\n%s\n\"", testName,
-                           srcBuffer);
-                destroyBufferStruct(pBuffers, pClState);
-                destroyClState(pClState);
-                return -1;
+                err = clStateMakeKernel(
+                    pClState, (testName + vecSizeSuffix(vecSizeIdx)).c_str());
+                if (err != 0)
+                {
+                    vlog_error("%s: failed to create kernel %s%s\n",
+                               testName, g_arrTypeNames[typeIdx],
+                               g_arrVecSizeNames[vecSizeIdx]);
+                    destroyBufferStruct(pBuffers, pClState);
+                    destroyClState(pClState);
+                    return -1;
+                }
             }
 
             err = pushArgs(pBuffers, pClState);
@@ -223,14 +249,15 @@ int test_vec_internal(cl_device_id deviceID, cl_context context,
                 vlog_error("%s: incorrect results %s%s\n", testName,
                            g_arrTypeNames[typeIdx],
                            g_arrVecSizeNames[vecSizeIdx]);
-                vlog_error("%s: Source was \"\n%s\n\"", testName, srcBuffer);
+                vlog_error("%s: Source was \"\n%s\n\"", testName,
+                           source.c_str());
                 destroyBufferStruct(pBuffers, pClState);
                 destroyClState(pClState);
                 return -1;
             }
-
-            clStateDestroyProgramAndKernel(pClState);
         }
+
+        clStateDestroyProgramAndKernel(pClState);
     }
 
     destroyBufferStruct(pBuffers, pClState);
@@ -245,59 +272,59 @@ int test_vec_internal(cl_device_id deviceID, cl_context context,
 
 static const char* patterns[] = {
     ".PRAGMA..STATE.\n"
-    "__kernel void test_vec_align_array(.SRC_SCOPE. .TYPE..NUM. *source, "
-    ".DST_SCOPE. uint *dest)\n"
+    "__kernel void test_vec_align_array.ID.(.SRC_SCOPE. .TYPE..NUM. "
+    "*source, .DST_SCOPE. uint *dest)\n"
     "{\n"
     "    int  tid = get_global_id(0);\n"
     "    dest[tid] = (uint)((.SRC_SCOPE. uchar *)(source+tid));\n"
     "}\n",
     ".PRAGMA..STATE.\n"
-    "typedef struct myUnpackedStruct { \n"
+    "typedef struct myUnpackedStruct.ID. { \n"
     ".PRE."
     "    .TYPE..NUM. vec;\n"
     ".POST."
-    "} testStruct;\n"
-    "__kernel void test_vec_align_struct(__constant .TYPE..NUM. *source, "
-    ".DST_SCOPE. uint *dest)\n"
+    "} testStruct.ID.;\n"
+    "__kernel void test_vec_align_struct.ID.(__constant .TYPE..NUM. "
+    "*source, .DST_SCOPE. uint *dest)\n"
     "{\n"
-    "    .SRC_SCOPE. testStruct test;\n"
+    "    .SRC_SCOPE. testStruct.ID. test;\n"
     "    int  tid = get_global_id(0);\n"
     "    dest[tid] = (uint)((.SRC_SCOPE. uchar *)&(test.vec));\n"
     "}\n",
     ".PRAGMA..STATE.\n"
-    "typedef struct __attribute__ ((packed)) myPackedStruct { \n"
+    "typedef struct __attribute__ ((packed)) myPackedStruct.ID. { \n"
     ".PRE."
     "    .TYPE..NUM. vec;\n"
     ".POST."
-    "} testStruct;\n"
-    "__kernel void test_vec_align_packed_struct(__constant .TYPE..NUM. "
+    "} testStruct.ID.;\n"
+    "__kernel void test_vec_align_packed_struct.ID.(__constant .TYPE..NUM. "
     "*source, .DST_SCOPE. uint *dest)\n"
     "{\n"
-    "    .SRC_SCOPE. testStruct test;\n"
+    "    .SRC_SCOPE. testStruct.ID. test;\n"
     "    int  tid = get_global_id(0);\n"
     "    dest[tid] = (uint)((.SRC_SCOPE. uchar *)&(test.vec) - (.SRC_SCOPE. "
     "uchar *)&test);\n"
     "}\n",
     ".PRAGMA..STATE.\n"
-    "typedef struct myStruct { \n"
+    "typedef struct myStruct.ID. { \n"
     ".PRE."
     "    .TYPE..NUM. vec;\n"
     ".POST."
-    "} testStruct;\n"
-    "__kernel void test_vec_align_struct_arr(.SRC_SCOPE. testStruct *source, "
-    ".DST_SCOPE. uint *dest)\n"
+    "} testStruct.ID.;\n"
+    "__kernel void test_vec_align_struct_arr.ID.(.SRC_SCOPE. testStruct.ID. "
+    "*source, .DST_SCOPE. uint *dest)\n"
     "{\n"
     "    int  tid = get_global_id(0);\n"
     "    dest[tid] = (uint)((.SRC_SCOPE. uchar *)&(source[tid].vec));\n"
     "}\n",
     ".PRAGMA..STATE.\n"
-    "typedef struct __attribute__ ((packed)) myPackedStruct { \n"
+    "typedef struct __attribute__ ((packed)) myPackedStruct.ID. { \n"
     ".PRE."
     "    .TYPE..NUM. vec;\n"
     ".POST."
-    "} testStruct;\n"
-    "__kernel void test_vec_align_packed_struct_arr(.SRC_SCOPE.  testStruct "
-    "*source, .DST_SCOPE. uint *dest)\n"
+    "} testStruct.ID.;\n"
+    "__kernel void test_vec_align_packed_struct_arr.ID.(.SRC_SCOPE. "
+    "testStruct.ID. *source, .DST_SCOPE. uint *dest)\n"
     "{\n"
     "    int  tid = get_global_id(0);\n"
     "    dest[tid] = (uint)((.SRC_SCOPE. uchar *)&(source[tid].vec) - "
@@ -47,6 +47,7 @@
 static void params_reset()
 {
     numCQ = 1;
+    numInFlight = 1;
     multiImport = false;
     multiCtx = false;
 }
@@ -136,6 +137,17 @@ int test_image_single_queue(cl_device_id device_, cl_context context_,
     log_info("RUNNING TEST WITH ONE QUEUE...... \n\n");
     return test_image_common(device_, context_, queue_, numElements_);
 }
+int test_image_single_queue_pipelined(cl_device_id device_,
+                                      cl_context context_,
+                                      cl_command_queue queue_,
+                                      int numElements_)
+{
+    params_reset();
+    numInFlight = 3;
+    log_info("RUNNING TEST WITH ONE QUEUE AND %u IMAGES IN FLIGHT...... \n\n",
+             numInFlight);
+    return test_image_common(device_, context_, queue_, numElements_);
+}
 int test_image_multiple_queue(cl_device_id device_, cl_context context_,
                               cl_command_queue queue_, int numElements_)
 {
@@ -154,6 +166,7 @@ test_definition test_list[] = { ADD_TEST(buffer_single_queue),
                                 ADD_TEST(buffer_multiImport_sameCtx_fence),
                                 ADD_TEST(buffer_multiImport_diffCtx_fence),
                                 ADD_TEST(image_single_queue),
+                                ADD_TEST(image_single_queue_pipelined),
                                 ADD_TEST(image_multiple_queue),
                                 ADD_TEST(consistency_external_buffer),
                                 ADD_TEST(consistency_external_image),
@@ -161,7 +174,8 @@ test_definition test_list[] = { ADD_TEST(buffer_single_queue),
                                 ADD_TEST(consistency_external_for_1dimage),
                                 ADD_TEST(consistency_external_semaphore),
                                 ADD_TEST(platform_info),
-                                ADD_TEST(device_info) };
+                                ADD_TEST(device_info),
+                                ADD_BENCHMARK(interop_benchmark) };
 
 const int test_num = ARRAY_SIZE(test_list);
 
@@ -180,6 +194,7 @@ const size_t bufsize = BUFFERSIZE;
 char buf[BUFFERSIZE];
 cl_uchar uuid[CL_UUID_SIZE_KHR];
 unsigned int numCQ;
+unsigned int numInFlight;
 bool multiImport;
 bool multiCtx;
 bool debug_trace = false;
@@ -187,6 +202,7 @@ bool useSingleImageKernel = false;
 bool useDeviceLocal = false;
 bool disableNTHandleType = false;
 bool enableOffset = false;
+bool useMemoryPool = false;
 
 static void printUsage(const char *execName)
 {
@@ -203,6 +219,9 @@ static void printUsage(const char *execName)
     log_info("Options:\n");
     log_info("\t--debug_trace - Enables additional debug info logging\n");
     log_info("\t--non_dedicated - Choose dedicated Vs. non_dedicated \n");
+    log_info("\t--useMemoryPool - Place the buffers of the buffer tests in "
+             "one pooled\n\t\tallocation each, imported once and used "
+             "through sub-buffers\n");
 }
 
 size_t parseParams(int argc, const char *argv[], const char **argList)
@@ -229,6 +248,10 @@ size_t parseParams(int argc, const char *argv[], const char **argList)
             {
                 disableNTHandleType = true;
             }
+            if (!strcmp(argv[i], "--useMemoryPool"))
+            {
+                useMemoryPool = true;
+            }
             if (strcmp(argv[i], "-h") == 0)
             {
                 printUsage(argv[0]);
@@ -285,6 +308,13 @@ int main(int argc, const char *argv[])
     }
     gDeviceType = CL_DEVICE_TYPE_GPU;
 
+    // The harness options, such as -bench, apply here as in the other suites
+    argc = parseCustomParam(argc, argv);
+    if (argc == -1)
+    {
+        return -1;
+    }
+
     const char **argList = (const char **)calloc(argc, sizeof(char *));
     size_t argCount = parseParams(argc, argv, argList);
     if (argCount == 0) return 0;
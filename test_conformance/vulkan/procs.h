@@ -44,3 +44,5 @@ extern int test_platform_info(cl_device_id device, cl_context context,
                               cl_command_queue queue, int num_elements);
 extern int test_device_info(cl_device_id device, cl_context context,
                             cl_command_queue queue, int num_elements);
+extern int test_interop_benchmark(cl_device_id device, cl_context context,
+                                  cl_command_queue queue, int num_elements);
@@ -0,0 +1,480 @@
+//
+// Copyright (c) 2026 The Khronos Group Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <vulkan_interop_common.hpp>
+#include <opencl_vulkan_wrapper.hpp>
+#include <vulkan_wrapper.hpp>
+#if !defined(__APPLE__)
+#include <CL/cl.h>
+#include <CL/cl_ext.h>
+#else
+#include <OpenCL/cl.h>
+#include <OpenCL/cl_ext.h>
+#endif
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+#include "harness/testHarness.h"
+#include "harness/typeWrappers.h"
+#include "harness/benchmark.h"
+#include "harness/perfMetrics.h"
+
+// Costs of handing buffers between a Vulkan compute queue and an OpenCL
+// queue, measured by a benchmark, so only when it is named:
+// - the round trip of a Vulkan -> OpenCL -> Vulkan semaphore hand-off with
+//   no work on either side, against the same hand-off through a host wait
+// - clEnqueueAcquireExternalMemObjectsKHR and its release on their own
+// - frames per second of a ping-pong pipeline in which every frame runs a
+//   Vulkan dispatch and then an OpenCL kernel on one of N buffers in flight
+
+#define MAX_BUFFERS 5
+
+namespace {
+
+// Matches the parameter block of buffer.comp
+struct Params
+{
+    uint32_t numBuffers;
+    uint32_t bufferSize;
+    uint32_t interBufferOffset;
+};
+
+const char *kernel_text_update = " \
+__kernel void clUpdateBuffer(int bufferSize, __global unsigned char *a) {  \n\
+    int gid = get_global_id(0); \n\
+    if (gid < bufferSize) { \n\
+        a[gid]++; \n\
+    } \n\
+}";
+
+const uint32_t kFrameBufferSize = 1024 * 1024;
+const uint32_t kMaxInFlight = 4;
+// Frames a sample of the ping-pong pipeline runs, so that it reaches its
+// steady state
+const uint32_t kFramesPerSample = 32;
+
+BenchmarkOptions bench_options()
+{
+    BenchmarkOptions options;
+    options.warmup = 1;
+    options.maxSeconds = 1.0;
+    return options;
+}
+
+// A semaphore pair between the two APIs, signalled by Vulkan and waited on
+// by OpenCL and the other way around.
+struct InteropSemaphores
+{
+    VulkanSemaphore vk2cl;
+    VulkanSemaphore cl2vk;
+    std::unique_ptr<clExternalSemaphore> clVk2CL;
+    std::unique_ptr<clExternalSemaphore> clCl2Vk;
+
+    InteropSemaphores(VulkanDevice &vkDevice, cl_context context,
+                      cl_device_id device,
+                      VulkanExternalSemaphoreHandleType handleType)
+        : vk2cl(vkDevice, handleType), cl2vk(vkDevice, handleType)
+    {
+        clExternalSemaphore *semaphore = NULL;
+        CREATE_OPENCL_SEMAPHORE(semaphore, vk2cl, context, handleType, device,
+                                false);
+        clVk2CL.reset(semaphore);
+        CREATE_OPENCL_SEMAPHORE(semaphore, cl2vk, context, handleType, device,
+                                true);
+        clCl2Vk.reset(semaphore);
+    }
+};
+
+// A Vulkan buffer imported into OpenCL, with a recorded dispatch of
+// buffer.spv that increments it.
+struct InteropFrame
+{
+    VulkanBuffer vkBuffer;
+    VulkanDeviceMemory vkMemory;
+    clExternalMemory clMemory;
+    VulkanDescriptorPool vkDescriptorPool;
+    VulkanDescriptorSet vkDescriptorSet;
+    VulkanCommandBuffer vkCommandBuffer;
+    InteropSemaphores semaphores;
+
+    InteropFrame(VulkanDevice &vkDevice, cl_context context,
+                 cl_device_id device,
+                 VulkanExternalMemoryHandleType memoryHandleType,
+                 VulkanExternalSemaphoreHandleType semaphoreHandleType,
+                 const VulkanMemoryType &memoryType,
+                 const VulkanDescriptorSetLayoutBindingList &bindings,
+                 const VulkanDescriptorSetLayout &layout,
+                 const VulkanPipelineLayout &pipelineLayout,
+                 const VulkanComputePipeline &pipeline,
+                 const VulkanCommandPool &commandPool,
+                 const VulkanBuffer &params)
+        : vkBuffer(vkDevice, kFrameBufferSize, memoryHandleType),
+          vkMemory(vkDevice, vkBuffer, memoryType, memoryHandleType),
+          clMemory(&vkMemory, memoryHandleType, kFrameBufferSize, context,
+                   device),
+          vkDescriptorPool(vkDevice, bindings),
+          vkDescriptorSet(vkDevice, vkDescriptorPool, layout),
+          vkCommandBuffer(vkDevice, commandPool),
+          semaphores(vkDevice, context, device, semaphoreHandleType)
+    {
+        vkMemory.bindBuffer(vkBuffer, 0);
+        vkDescriptorSet.update(0, params);
+        vkDescriptorSet.update(1, vkBuffer);
+
+        vkCommandBuffer.begin();
+        vkCommandBuffer.bindPipeline(pipeline);
+        vkCommandBuffer.bindDescriptorSets(pipeline, pipelineLayout,
+                                           vkDescriptorSet);
+        vkCommandBuffer.dispatch(512, 1, 1);
+        vkCommandBuffer.end();
+    }
+
+    cl_mem buffer() { return clMemory.getExternalMemoryBuffer(); }
+};
+
+// Round trips of an empty Vulkan submission handed to OpenCL and back
+int bench_semaphore_latency(VulkanDevice &vkDevice, cl_context context,
+                            cl_command_queue queue, cl_device_id device,
+                            VulkanExternalSemaphoreHandleType handleType)
+{
+    VulkanQueue &vkQueue = vkDevice.getQueue();
+    VulkanCommandPool vkCommandPool(vkDevice);
+    VulkanCommandBuffer vkEmpty(vkDevice, vkCommandPool);
+    vkEmpty.begin();
+    vkEmpty.end();
+
+    InteropSemaphores semaphores(vkDevice, context, device, handleType);
+
+    log_benchmark_header("vulkan_round_trip", "sync");
+    // Every sample after the first waits for the signal the one before left
+    // for Vulkan
+    bool first = true;
+    BenchmarkStats semaphore;
+    cl_int err = run_benchmark(
+        bench_options(),
+        [&](double *us) {
+            HostTimer timer;
+            if (first)
+                vkQueue.submit(vkEmpty, semaphores.vk2cl);
+            else
+                vkQueue.submit(semaphores.cl2vk, vkEmpty, semaphores.vk2cl);
+            first = false;
+            int err = semaphores.clVk2CL->wait(queue);
+            test_error(err, "Failed to wait on CL external semaphore");
+            err = semaphores.clCl2Vk->signal(queue);
+            test_error(err, "Failed to signal CL external semaphore");
+            err = clFinish(queue);
+            test_error(err, "clFinish failed");
+            *us = timer.elapsed_us();
+            return CL_SUCCESS;
+        },
+        &semaphore);
+    if (err != CL_SUCCESS) return err;
+    // Consume the last signal, so that both semaphores end up unsignalled
+    vkQueue.submit(semaphores.cl2vk, vkEmpty, semaphores.vk2cl);
+    err = semaphores.clVk2CL->wait(queue);
+    test_error(err, "Failed to wait on CL external semaphore");
+    err = clFinish(queue);
+    test_error(err, "clFinish failed");
+    vkQueue.waitIdle();
+    log_benchmark_stats("vulkan_round_trip", "semaphore", "us", false,
+                        semaphore);
+
+    std::shared_ptr<VulkanFence> fence =
+        std::make_shared<VulkanFence>(vkDevice);
+    BenchmarkStats hostWait;
+    err = run_benchmark(
+        bench_options(),
+        [&](double *us) {
+            HostTimer timer;
+            fence->reset();
+            vkQueue.submit(vkEmpty, fence);
+            fence->wait();
+
+            cl_int err = clEnqueueMarkerWithWaitList(queue, 0, NULL, NULL);
+            test_error(err, "clEnqueueMarkerWithWaitList failed");
+            err = clFinish(queue);
+            test_error(err, "clFinish failed");
+            *us = timer.elapsed_us();
+            return CL_SUCCESS;
+        },
+        &hostWait);
+    if (err != CL_SUCCESS) return err;
+    log_benchmark_stats("vulkan_round_trip", "host_wait", "us", false,
+                        hostWait);
+    return CL_SUCCESS;
+}
+
+// Times of one acquire and release, in microseconds
+struct AcquireReleaseTimes
+{
+    double acquire;
+    double release;
+    double enqueue;
+};
+
+// Acquire and release of buffers with nothing between, timed on the device
+// and, for the enqueues of both, on the host
+cl_int time_acquire_release(cl_command_queue queue,
+                            const std::vector<cl_mem> &buffers,
+                            AcquireReleaseTimes *times)
+{
+    clEventWrapper acquire_event, release_event;
+    cl_uint count = (cl_uint)buffers.size();
+    HostTimer timer;
+    cl_int err = clEnqueueAcquireExternalMemObjectsKHRptr(
+        queue, count, buffers.data(), 0, NULL, &acquire_event);
+    test_error(err, "Failed to acquire buffers");
+    err = clEnqueueReleaseExternalMemObjectsKHRptr(
+        queue, count, buffers.data(), 0, NULL, &release_event);
+    test_error(err, "Failed to release buffers");
+    times->enqueue = timer.elapsed_us();
+
+    err = clFinish(queue);
+    test_error(err, "clFinish failed");
+
+    double ns;
+    err = get_event_duration_ns(acquire_event, &ns);
+    if (err != CL_SUCCESS) return err;
+    times->acquire = ns / 1e3;
+    err = get_event_duration_ns(release_event, &ns);
+    if (err != CL_SUCCESS) return err;
+    times->release = ns / 1e3;
+    return CL_SUCCESS;
+}
+
+// Acquire and release of the first count frame buffers with nothing between
+int bench_acquire_release(cl_command_queue queue,
+                          std::vector<std::unique_ptr<InteropFrame>> &frames,
+                          cl_uint count)
+{
+    static const struct
+    {
+        const char *name;
+        double AcquireReleaseTimes::*us;
+    } phases[] = {
+        { "acquire", &AcquireReleaseTimes::acquire },
+        { "release", &AcquireReleaseTimes::release },
+        { "enqueue", &AcquireReleaseTimes::enqueue },
+    };
+
+    std::vector<cl_mem> buffers;
+    for (cl_uint i = 0; i < count; i++)
+        buffers.push_back(frames[i]->buffer());
+
+    for (const auto &phase : phases)
+    {
+        BenchmarkStats stats;
+        cl_int err = run_benchmark(
+            bench_options(),
+            [&](double *us) {
+                AcquireReleaseTimes times;
+                cl_int err = time_acquire_release(queue, buffers, &times);
+                *us = times.*phase.us;
+                return err;
+            },
+            &stats);
+        if (err != CL_SUCCESS) return err;
+
+        std::string label = std::to_string(count) + "/" + phase.name;
+        log_benchmark_stats("vulkan_acquire_release", label.c_str(), "us",
+                            false, stats);
+    }
+    return CL_SUCCESS;
+}
+
+// Runs kFramesPerSample ping-pong frames over the first in_flight frame
+// buffers, from an empty pipeline, and returns the time per frame
+cl_int time_frames(VulkanQueue &vkQueue, cl_command_queue queue,
+                   cl_kernel kernel,
+                   std::vector<std::unique_ptr<InteropFrame>> &frames,
+                   uint32_t in_flight, double *us)
+{
+    const uint32_t numFrames = std::max(kFramesPerSample, in_flight);
+    size_t global_work_size = kFrameBufferSize;
+
+    HostTimer timer;
+    for (uint32_t f = 0; f < numFrames; f++)
+    {
+        InteropFrame &frame = *frames[f % in_flight];
+        InteropSemaphores &semaphores = frame.semaphores;
+
+        // The last frame that used this buffer has to be done with it on the
+        // OpenCL side before Vulkan may touch it again
+        if (f < in_flight)
+            vkQueue.submit(frame.vkCommandBuffer, semaphores.vk2cl);
+        else
+            vkQueue.submit(semaphores.cl2vk, frame.vkCommandBuffer,
+                           semaphores.vk2cl);
+
+        cl_int err = semaphores.clVk2CL->wait(queue);
+        test_error(err, "Failed to wait on CL external semaphore");
+
+        cl_mem buffer = frame.buffer();
+        err = clEnqueueAcquireExternalMemObjectsKHRptr(queue, 1, &buffer, 0,
+                                                       NULL, NULL);
+        test_error(err, "Failed to acquire buffers");
+        err = clSetKernelArg(kernel, 1, sizeof(buffer), &buffer);
+        test_error(err, "Failed to set kernel arg");
+        err = clEnqueueNDRangeKernel(queue, kernel, 1, NULL,
+                                     &global_work_size, NULL, 0, NULL, NULL);
+        test_error(err, "Failed to launch update_buffer_kernel");
+        err = clEnqueueReleaseExternalMemObjectsKHRptr(queue, 1, &buffer, 0,
+                                                       NULL, NULL);
+        test_error(err, "Failed to release buffers");
+
+        if (f + in_flight < numFrames)
+        {
+            err = semaphores.clCl2Vk->signal(queue);
+            test_error(err, "Failed to signal CL external semaphore");
+        }
+        err = clFlush(queue);
+        test_error(err, "clFlush failed");
+    }
+    cl_int err = clFinish(queue);
+    test_error(err, "clFinish failed");
+    vkQueue.waitIdle();
+
+    *us = timer.elapsed_us() / numFrames;
+    return CL_SUCCESS;
+}
+
+// Ping-pong frames over the first in_flight frame buffers
+int bench_frames(VulkanDevice &vkDevice, cl_command_queue queue,
+                 cl_kernel kernel,
+                 std::vector<std::unique_ptr<InteropFrame>> &frames,
+                 uint32_t in_flight)
+{
+    VulkanQueue &vkQueue = vkDevice.getQueue();
+    cl_int err =
+        clSetKernelArg(kernel, 0, sizeof(kFrameBufferSize), &kFrameBufferSize);
+    test_error(err, "Failed to set kernel arg");
+
+    BenchmarkStats stats;
+    err = run_benchmark(
+        bench_options(),
+        [&](double *us) {
+            return time_frames(vkQueue, queue, kernel, frames, in_flight, us);
+        },
+        &stats);
+    if (err != CL_SUCCESS) return err;
+
+    std::string label = std::to_string(in_flight);
+    log_benchmark_stats("vulkan_frames", label.c_str(), "us", false, stats);
+    if (stats.median > 0)
+        record_perf_metric("vulkan_frames_fps." + label, 1e6 / stats.median,
+                           "fps", true);
+    return CL_SUCCESS;
+}
+
+} // anonymous namespace
+
+int test_interop_benchmark(cl_device_id device, cl_context _context,
+                           cl_command_queue _queue, int num_elements)
+{
+    VulkanDevice vkDevice;
+    std::vector<VulkanExternalSemaphoreHandleType> semaphoreTypes =
+        getSupportedInteropExternalSemaphoreHandleTypes(device, vkDevice);
+    const std::vector<VulkanExternalMemoryHandleType> memoryTypes =
+        getSupportedVulkanExternalMemoryHandleTypeList();
+    if (semaphoreTypes.empty() || memoryTypes.empty())
+    {
+        log_info("No external semaphore or memory handle type is supported "
+                 "by both APIs, skipping.\n");
+        return TEST_SKIPPED_ITSELF;
+    }
+    VulkanExternalSemaphoreHandleType semaphoreType = semaphoreTypes[0];
+    VulkanExternalMemoryHandleType memoryType = memoryTypes[0];
+    log_info("External memory handle type: %d\n", memoryType);
+    log_info("External semaphore handle type: %d\n", semaphoreType);
+
+    cl_int err;
+    clContextWrapper context =
+        clCreateContext(NULL, 1, &device, NULL, NULL, &err);
+    test_error(err, "clCreateContext failed");
+
+    cl_queue_properties props[] = { CL_QUEUE_PROPERTIES,
+                                    CL_QUEUE_PROFILING_ENABLE, 0 };
+    clCommandQueueWrapper queue =
+        clCreateCommandQueueWithProperties(context, device, props, &err);
+    test_error(err, "clCreateCommandQueueWithProperties failed");
+
+    clProgramWrapper program;
+    clKernelWrapper kernel;
+    err = create_single_kernel_helper(context, &program, &kernel, 1,
+                                      &kernel_text_update, "clUpdateBuffer");
+    test_error(err, "Failed to create the update kernel");
+
+    err = bench_semaphore_latency(vkDevice, context, queue, device,
+                                  semaphoreType);
+    if (err != CL_SUCCESS) return err;
+
+    std::vector<char> vkBufferShader = readFile("buffer.spv");
+    VulkanShaderModule vkBufferShaderModule(vkDevice, vkBufferShader);
+    VulkanDescriptorSetLayoutBindingList vkBindings;
+    vkBindings.addBinding(0, VULKAN_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1);
+    vkBindings.addBinding(1, VULKAN_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                          MAX_BUFFERS);
+    VulkanDescriptorSetLayout vkDescriptorSetLayout(vkDevice, vkBindings);
+    VulkanPipelineLayout vkPipelineLayout(vkDevice, vkDescriptorSetLayout);
+    VulkanComputePipeline vkComputePipeline(vkDevice, vkPipelineLayout,
+                                            vkBufferShaderModule);
+    VulkanCommandPool vkCommandPool(vkDevice);
+
+    VulkanBuffer vkParamsBuffer(vkDevice, sizeof(Params));
+    VulkanDeviceMemory vkParamsDeviceMemory(
+        vkDevice, vkParamsBuffer.getSize(),
+        getVulkanMemoryType(vkDevice,
+                            VULKAN_MEMORY_TYPE_PROPERTY_HOST_VISIBLE_COHERENT));
+    vkParamsDeviceMemory.bindBuffer(vkParamsBuffer);
+    Params *params = (Params *)vkParamsDeviceMemory.map();
+    params->numBuffers = 1;
+    params->bufferSize = kFrameBufferSize;
+    params->interBufferOffset = 0;
+    vkParamsDeviceMemory.unmap();
+
+    VulkanBuffer vkDummyBuffer(vkDevice, 4 * 1024, memoryType);
+    const VulkanMemoryType &vkMemoryType =
+        vkDummyBuffer.getMemoryTypeList()[0];
+    log_info("Memory type index: %d\n", (uint32_t)vkMemoryType);
+
+    std::vector<std::unique_ptr<InteropFrame>> frames;
+    for (uint32_t i = 0; i < kMaxInFlight; i++)
+    {
+        frames.emplace_back(new InteropFrame(
+            vkDevice, context, device, memoryType, semaphoreType,
+            vkMemoryType, vkBindings, vkDescriptorSetLayout, vkPipelineLayout,
+            vkComputePipeline, vkCommandPool, vkParamsBuffer));
+    }
+
+    log_benchmark_header("vulkan_acquire_release", "buffers/phase");
+    for (cl_uint count = 1; count <= kMaxInFlight; count *= 2)
+    {
+        err = bench_acquire_release(queue, frames, count);
+        if (err != CL_SUCCESS) return err;
+    }
+
+    log_benchmark_header("vulkan_frames", "in_flight");
+    for (uint32_t in_flight = 1; in_flight <= kMaxInFlight; in_flight++)
+    {
+        err = bench_frames(vkDevice, queue, kernel, frames, in_flight);
+        if (err != CL_SUCCESS) return err;
+    }
+
+    return CL_SUCCESS;
+}
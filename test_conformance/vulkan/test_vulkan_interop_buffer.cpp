@@ -38,6 +38,88 @@ struct Params
     uint32_t bufferSize;
     uint32_t interBufferOffset;
 };
+
+// Memory bound to a list of buffers and the OpenCL buffers imported from it.
+// Each buffer gets memory and an import of its own, or with --useMemoryPool
+// a range of one pooled block, imported once, and a sub-buffer of the import.
+class InteropBufferMemory {
+    std::vector<std::unique_ptr<VulkanDeviceMemory>> m_memory;
+    std::vector<std::unique_ptr<clExternalMemory>> m_externalMemory;
+    std::unique_ptr<VulkanDeviceMemoryPool> m_pool;
+    std::unique_ptr<clExternalMemoryPool> m_externalPool;
+    std::vector<cl_mem> m_buffers;
+    std::vector<cl_mem> m_subBuffers;
+    std::vector<cl_mem> m_acquireList;
+
+public:
+    InteropBufferMemory(const VulkanDevice &vkDevice,
+                        VulkanBufferList &vkBufferList, uint64_t bufferSize,
+                        const VulkanMemoryType &memoryType,
+                        VulkanExternalMemoryHandleType handleType,
+                        cl_context context, cl_device_id device)
+    {
+        if (!useMemoryPool)
+        {
+            for (size_t bIdx = 0; bIdx < vkBufferList.size(); bIdx++)
+            {
+                const VulkanBuffer &buffer = vkBufferList[bIdx];
+                m_memory.emplace_back(new VulkanDeviceMemory(
+                    vkDevice, buffer, memoryType, handleType));
+                m_externalMemory.emplace_back(
+                    new clExternalMemory(m_memory.back().get(), handleType,
+                                         bufferSize, context, device));
+                m_memory.back()->bindBuffer(buffer, 0);
+                m_buffers.push_back(
+                    m_externalMemory.back()->getExternalMemoryBuffer());
+            }
+            m_acquireList = m_buffers;
+            return;
+        }
+
+        // One block that holds all of the buffers at the alignment both APIs
+        // need
+        uint64_t alignment = getCLSubBufferAlignment(device);
+        uint64_t blockSize = 0;
+        for (size_t bIdx = 0; bIdx < vkBufferList.size(); bIdx++)
+            blockSize += vkBufferList[bIdx].getSize()
+                + std::max(alignment, vkBufferList[bIdx].getAlignment());
+        m_pool.reset(new VulkanDeviceMemoryPool(vkDevice, memoryType,
+                                                handleType, blockSize,
+                                                alignment));
+        std::vector<VulkanSubAllocation> allocations;
+        for (size_t bIdx = 0; bIdx < vkBufferList.size(); bIdx++)
+            allocations.push_back(m_pool->bindBuffer(vkBufferList[bIdx]));
+
+        m_externalPool.reset(
+            new clExternalMemoryPool(*m_pool, context, device));
+        for (VulkanSubAllocation &allocation : allocations)
+        {
+            allocation.size = bufferSize;
+            cl_int err = CL_SUCCESS;
+            cl_mem subBuffer = m_externalPool->createSubBuffer(
+                allocation, CL_MEM_READ_WRITE, &err);
+            if (err != CL_SUCCESS)
+            {
+                log_error("clCreateSubBuffer failed with %d\n", err);
+                throw std::runtime_error("clCreateSubBuffer failed ");
+            }
+            m_subBuffers.push_back(subBuffer);
+        }
+        m_buffers = m_subBuffers;
+        m_acquireList = m_externalPool->getBlockBuffers();
+    }
+
+    ~InteropBufferMemory()
+    {
+        for (cl_mem subBuffer : m_subBuffers) clReleaseMemObject(subBuffer);
+    }
+
+    cl_mem getBuffer(size_t bIdx) const { return m_buffers[bIdx]; }
+
+    // The memory objects to acquire and release for OpenCL to use the buffers
+    cl_uint getNumAcquire() const { return (cl_uint)m_acquireList.size(); }
+    const cl_mem *getAcquireList() const { return m_acquireList.data(); }
+};
 }
 
 const char *kernel_text_numbuffer_1 = " \
@@ -158,8 +240,6 @@ int run_test_with_two_queue(
         getVulkanMemoryType(vkDevice,
                             VULKAN_MEMORY_TYPE_PROPERTY_HOST_VISIBLE_COHERENT));
     vkParamsDeviceMemory.bindBuffer(vkParamsBuffer);
-    std::vector<VulkanDeviceMemory *> vkBufferListDeviceMemory;
-    std::vector<clExternalMemory *> externalMemory;
 
     for (size_t emhtIdx = 0; emhtIdx < vkExternalMemoryHandleTypeList.size();
          emhtIdx++)
@@ -185,15 +265,9 @@ int run_test_with_two_queue(
             VulkanBufferList vkBufferList(numBuffers, vkDevice, bufferSize,
                                           vkExternalMemoryHandleType);
 
-            for (size_t bIdx = 0; bIdx < numBuffers; bIdx++)
-            {
-                vkBufferListDeviceMemory.push_back(new VulkanDeviceMemory(
-                    vkDevice, vkBufferList[bIdx], memoryType,
-                    vkExternalMemoryHandleType));
-                externalMemory.push_back(new clExternalMemory(
-                    vkBufferListDeviceMemory[bIdx], vkExternalMemoryHandleType,
-                    bufferSize, context, deviceId));
-            }
+            InteropBufferMemory bufferMemory(
+                vkDevice, vkBufferList, bufferSize, memoryType,
+                vkExternalMemoryHandleType, context, deviceId);
             cl_mem buffers[MAX_BUFFERS];
             clFinish(cmd_queue1);
             Params *params = (Params *)vkParamsDeviceMemory.map();
@@ -204,10 +278,7 @@ int run_test_with_two_queue(
             vkDescriptorSet.update(0, vkParamsBuffer);
             for (size_t bIdx = 0; bIdx < vkBufferList.size(); bIdx++)
             {
-                size_t buffer_size = vkBufferList[bIdx].getSize();
-                vkBufferListDeviceMemory[bIdx]->bindBuffer(vkBufferList[bIdx],
-                                                           0);
-                buffers[bIdx] = externalMemory[bIdx]->getExternalMemoryBuffer();
+                buffers[bIdx] = bufferMemory.getBuffer(bIdx);
             }
             vkDescriptorSet.updateArray(1, numBuffers, vkBufferList);
             vkCommandBuffer.begin();
@@ -285,7 +356,8 @@ int run_test_with_two_queue(
 
                 cl_event acquire_event = nullptr;
                 err = clEnqueueAcquireExternalMemObjectsKHRptr(
-                    cmd_queue1, vkBufferList.size(), buffers, 0, nullptr,
+                    cmd_queue1, bufferMemory.getNumAcquire(),
+                    bufferMemory.getAcquireList(), 0, nullptr,
                     &acquire_event);
                 test_error_and_cleanup(err, CLEANUP,
                                        "Failed to acquire buffers");
@@ -307,7 +379,8 @@ int run_test_with_two_queue(
                     "error\n");
 
                 err = clEnqueueReleaseExternalMemObjectsKHRptr(
-                    cmd_queue2, vkBufferList.size(), buffers, 0, nullptr,
+                    cmd_queue2, bufferMemory.getNumAcquire(),
+                    bufferMemory.getAcquireList(), 0, nullptr,
                     nullptr);
                 test_error_and_cleanup(err, CLEANUP,
                                        "Failed to release buffers");
@@ -385,30 +458,9 @@ int run_test_with_two_queue(
                         "&&&& vulkan_opencl_buffer test FAILED\n");
                 }
             }
-            for (size_t i = 0; i < vkBufferList.size(); i++)
-            {
-                delete vkBufferListDeviceMemory[i];
-                delete externalMemory[i];
-            }
-            vkBufferListDeviceMemory.erase(vkBufferListDeviceMemory.begin(),
-                                           vkBufferListDeviceMemory.begin()
-                                               + numBuffers);
-            externalMemory.erase(externalMemory.begin(),
-                                 externalMemory.begin() + numBuffers);
         }
     }
 CLEANUP:
-    for (size_t i = 0; i < vkBufferListDeviceMemory.size(); i++)
-    {
-        if (vkBufferListDeviceMemory[i])
-        {
-            delete vkBufferListDeviceMemory[i];
-        }
-        if (externalMemory[i])
-        {
-            delete externalMemory[i];
-        }
-    }
     if (program) clReleaseProgram(program);
     if (kernel_cq) clReleaseKernel(kernel_cq);
     if (!use_fence)
@@ -489,8 +541,6 @@ int run_test_with_one_queue(
         getVulkanMemoryType(vkDevice,
                             VULKAN_MEMORY_TYPE_PROPERTY_HOST_VISIBLE_COHERENT));
     vkParamsDeviceMemory.bindBuffer(vkParamsBuffer);
-    std::vector<VulkanDeviceMemory *> vkBufferListDeviceMemory;
-    std::vector<clExternalMemory *> externalMemory;
 
     for (size_t emhtIdx = 0; emhtIdx < vkExternalMemoryHandleTypeList.size();
          emhtIdx++)
@@ -516,15 +566,9 @@ int run_test_with_one_queue(
             VulkanBufferList vkBufferList(numBuffers, vkDevice, bufferSize,
                                           vkExternalMemoryHandleType);
 
-            for (size_t bIdx = 0; bIdx < numBuffers; bIdx++)
-            {
-                vkBufferListDeviceMemory.push_back(new VulkanDeviceMemory(
-                    vkDevice, vkBufferList[bIdx], memoryType,
-                    vkExternalMemoryHandleType));
-                externalMemory.push_back(new clExternalMemory(
-                    vkBufferListDeviceMemory[bIdx], vkExternalMemoryHandleType,
-                    bufferSize, context, deviceId));
-            }
+            InteropBufferMemory bufferMemory(
+                vkDevice, vkBufferList, bufferSize, memoryType,
+                vkExternalMemoryHandleType, context, deviceId);
             cl_mem buffers[4];
             clFinish(cmd_queue1);
             Params *params = (Params *)vkParamsDeviceMemory.map();
@@ -535,10 +579,7 @@ int run_test_with_one_queue(
             vkDescriptorSet.update(0, vkParamsBuffer);
             for (size_t bIdx = 0; bIdx < vkBufferList.size(); bIdx++)
             {
-                size_t buffer_size = vkBufferList[bIdx].getSize();
-                vkBufferListDeviceMemory[bIdx]->bindBuffer(vkBufferList[bIdx],
-                                                           0);
-                buffers[bIdx] = externalMemory[bIdx]->getExternalMemoryBuffer();
+                buffers[bIdx] = bufferMemory.getBuffer(bIdx);
             }
             vkDescriptorSet.updateArray(1, vkBufferList.size(), vkBufferList);
 
@@ -606,7 +647,8 @@ int run_test_with_one_queue(
                     "Error: Failed to set arg values for kernel\n");
 
                 err = clEnqueueAcquireExternalMemObjectsKHRptr(
-                    cmd_queue1, vkBufferList.size(), buffers, 0, nullptr,
+                    cmd_queue1, bufferMemory.getNumAcquire(),
+                    bufferMemory.getAcquireList(), 0, nullptr,
                     nullptr);
                 test_error_and_cleanup(err, CLEANUP,
                                        "Failed to acquire buffers");
@@ -620,7 +662,8 @@ int run_test_with_one_queue(
                     " error\n");
 
                 err = clEnqueueReleaseExternalMemObjectsKHRptr(
-                    cmd_queue1, vkBufferList.size(), buffers, 0, nullptr,
+                    cmd_queue1, bufferMemory.getNumAcquire(),
+                    bufferMemory.getAcquireList(), 0, nullptr,
                     nullptr);
                 test_error_and_cleanup(err, CLEANUP,
                                        "Failed to release buffers");
@@ -688,30 +731,9 @@ int run_test_with_one_queue(
                         "&&&& vulkan_opencl_buffer test FAILED\n");
                 }
             }
-            for (size_t i = 0; i < vkBufferList.size(); i++)
-            {
-                delete vkBufferListDeviceMemory[i];
-                delete externalMemory[i];
-            }
-            vkBufferListDeviceMemory.erase(vkBufferListDeviceMemory.begin(),
-                                           vkBufferListDeviceMemory.begin()
-                                               + numBuffers);
-            externalMemory.erase(externalMemory.begin(),
-                                 externalMemory.begin() + numBuffers);
         }
     }
 CLEANUP:
-    for (size_t i = 0; i < vkBufferListDeviceMemory.size(); i++)
-    {
-        if (vkBufferListDeviceMemory[i])
-        {
-            delete vkBufferListDeviceMemory[i];
-        }
-        if (externalMemory[i])
-        {
-            delete externalMemory[i];
-        }
-    }
 
     if (!use_fence)
     {
@@ -18,7 +18,9 @@
 #include <string>
 #include "harness/errorHelpers.h"
 #include <algorithm>
+#include <memory>
 #include "deviceInfo.h"
+#include "harness/ThreadPool.h"
 
 #define MAX_2D_IMAGES 5
 #define MAX_2D_IMAGE_WIDTH 1024
@@ -1351,6 +1353,441 @@ CLEANUP:
     return err;
 }
 
+namespace {
+// One frame in flight through the pipelined test: Vulkan copies the source
+// into srcImage and flips it in place, OpenCL flips it back into dstImage and
+// reads that back into one of two host buffers, so that one round of frames
+// can be checked on the host while the next is in flight.
+struct PipelinedFrame
+{
+    VulkanImage2DList srcImage;
+    VulkanImage2DList dstImage;
+    std::unique_ptr<VulkanDeviceMemory> srcMemory;
+    std::unique_ptr<VulkanDeviceMemory> dstMemory;
+    std::unique_ptr<clExternalMemoryImage> clSrcImage;
+    std::unique_ptr<clExternalMemoryImage> clDstImage;
+    VulkanImageViewList srcView;
+    VulkanDescriptorPool descriptorPool;
+    VulkanDescriptorSet descriptorSet;
+    VulkanCommandBuffer copyCommandBuffer;
+    VulkanCommandBuffer shaderCommandBuffer;
+    VulkanSemaphore vk2cl;
+    VulkanSemaphore cl2vk;
+    std::unique_ptr<clExternalSemaphore> clVk2CL;
+    std::unique_ptr<clExternalSemaphore> clCl2Vk;
+    std::vector<char> readback[2];
+    cl_event readEvent[2];
+
+    PipelinedFrame(VulkanDevice &vkDevice, cl_context context,
+                   VulkanFormat format, uint32_t width, uint32_t height,
+                   VulkanImageTiling tiling,
+                   VulkanExternalMemoryHandleType memoryHandleType,
+                   const VulkanMemoryType &memoryType,
+                   size_t totalImageMemSize,
+                   VulkanExternalSemaphoreHandleType semaphoreHandleType,
+                   const VulkanDescriptorSetLayoutBindingList &bindings,
+                   const VulkanDescriptorSetLayout &layout,
+                   const VulkanCommandPool &commandPool, size_t readbackSize)
+        : srcImage(1, vkDevice, format, width, height, tiling, 1,
+                   memoryHandleType),
+          dstImage(1, vkDevice, format, width, height, tiling, 1,
+                   memoryHandleType),
+          srcMemory(new VulkanDeviceMemory(vkDevice, srcImage[0], memoryType,
+                                           memoryHandleType)),
+          dstMemory(new VulkanDeviceMemory(vkDevice, dstImage[0], memoryType,
+                                           memoryHandleType)),
+          srcView(vkDevice, srcImage), descriptorPool(vkDevice, bindings),
+          descriptorSet(vkDevice, descriptorPool, layout),
+          copyCommandBuffer(vkDevice, commandPool),
+          shaderCommandBuffer(vkDevice, commandPool),
+          vk2cl(vkDevice, semaphoreHandleType),
+          cl2vk(vkDevice, semaphoreHandleType)
+    {
+        srcMemory->bindImage(srcImage[0], 0);
+        dstMemory->bindImage(dstImage[0], 0);
+        clSrcImage.reset(new clExternalMemoryImage(
+            *srcMemory, memoryHandleType, context, totalImageMemSize, width,
+            height, 0, srcImage[0], deviceId));
+        clDstImage.reset(new clExternalMemoryImage(
+            *dstMemory, memoryHandleType, context, totalImageMemSize, width,
+            height, 0, dstImage[0], deviceId));
+
+        clExternalSemaphore *semaphore = NULL;
+        CREATE_OPENCL_SEMAPHORE(semaphore, vk2cl, context, semaphoreHandleType,
+                                deviceId, false);
+        clVk2CL.reset(semaphore);
+        CREATE_OPENCL_SEMAPHORE(semaphore, cl2vk, context, semaphoreHandleType,
+                                deviceId, true);
+        clCl2Vk.reset(semaphore);
+
+        for (int i = 0; i < 2; i++)
+        {
+            readback[i].resize(readbackSize);
+            readEvent[i] = NULL;
+        }
+    }
+
+    ~PipelinedFrame()
+    {
+        for (int i = 0; i < 2; i++)
+            if (readEvent[i]) clReleaseEvent(readEvent[i]);
+    }
+};
+
+struct PipelinedVerifyJob
+{
+    const char *expected;
+    size_t size;
+    std::vector<const char *> results;
+    std::vector<char> mismatch;
+};
+
+cl_int verify_pipelined_frame(cl_uint job_id, cl_uint thread_id,
+                              void *userInfo)
+{
+    PipelinedVerifyJob *job = (PipelinedVerifyJob *)userInfo;
+    job->mismatch[job_id] =
+        memcmp(job->expected, job->results[job_id], job->size) != 0;
+    return CL_SUCCESS;
+}
+
+// Waits for the readbacks of one round of frames and compares them with the
+// source on the thread pool.
+int verify_pipelined_round(
+    std::vector<std::unique_ptr<PipelinedFrame>> &frames, int parity,
+    const char *expected, size_t size)
+{
+    PipelinedVerifyJob job;
+    job.expected = expected;
+    job.size = size;
+    for (auto &frame : frames)
+    {
+        cl_int err = clWaitForEvents(1, &frame->readEvent[parity]);
+        test_error(err, "clWaitForEvents failed");
+        clReleaseEvent(frame->readEvent[parity]);
+        frame->readEvent[parity] = NULL;
+        job.results.push_back(frame->readback[parity].data());
+    }
+    job.mismatch.assign(frames.size(), 0);
+
+    cl_uint jobs = (cl_uint)frames.size();
+    if (!(jobs > 1 && GetThreadCount() > 1
+          && CL_SUCCESS == ThreadPool_Do(verify_pipelined_frame, jobs, &job)))
+    {
+        for (cl_uint i = 0; i < jobs; i++) verify_pipelined_frame(i, 0, &job);
+    }
+
+    for (size_t i = 0; i < frames.size(); i++)
+    {
+        if (job.mismatch[i])
+        {
+            log_error("Source and destination buffers don't match for frame "
+                      "%zu in flight\n",
+                      i);
+            return -1;
+        }
+    }
+    return CL_SUCCESS;
+}
+} // anonymous namespace
+
+// Keeps numInFlight frames of one image each in flight at once. Every frame
+// has its own pair of images and semaphores, so Vulkan can copy and flip the
+// next frames while OpenCL is still working on the earlier ones.
+int run_test_pipelined(
+    cl_context &context, cl_command_queue &cmd_queue1,
+    cl_kernel *kernel_unsigned, cl_kernel *kernel_signed,
+    cl_kernel *kernel_float, VulkanDevice &vkDevice,
+    VulkanExternalSemaphoreHandleType vkExternalSemaphoreHandleType)
+{
+    cl_int err = CL_SUCCESS;
+    size_t origin[3] = { 0, 0, 0 };
+    size_t region[3] = { 1, 1, 1 };
+    std::vector<VulkanFormat> vkFormatList = getSupportedVulkanFormatList();
+    const std::vector<VulkanExternalMemoryHandleType>
+        vkExternalMemoryHandleTypeList =
+            getSupportedVulkanExternalMemoryHandleTypeList();
+    char magicValue = 0;
+    uint32_t numMipLevels = 1;
+    uint32_t num2DImages = 1;
+
+    VulkanBuffer vkParamsBuffer(vkDevice, sizeof(Params));
+    VulkanDeviceMemory vkParamsDeviceMemory(
+        vkDevice, vkParamsBuffer.getSize(),
+        getVulkanMemoryType(vkDevice,
+                            VULKAN_MEMORY_TYPE_PROPERTY_HOST_VISIBLE_COHERENT));
+    vkParamsDeviceMemory.bindBuffer(vkParamsBuffer);
+    Params *params = (Params *)vkParamsDeviceMemory.map();
+    params->numImage2DDescriptors = num2DImages * numMipLevels;
+    vkParamsDeviceMemory.unmap();
+
+    uint64_t maxImage2DSize =
+        max_width * max_height * MAX_2D_IMAGE_ELEMENT_SIZE * 2;
+    VulkanBuffer vkSrcBuffer(vkDevice, maxImage2DSize);
+    VulkanDeviceMemory vkSrcBufferDeviceMemory(
+        vkDevice, vkSrcBuffer.getSize(),
+        getVulkanMemoryType(vkDevice,
+                            VULKAN_MEMORY_TYPE_PROPERTY_HOST_VISIBLE_COHERENT));
+    vkSrcBufferDeviceMemory.bindBuffer(vkSrcBuffer);
+    std::vector<char> srcBuffer(maxImage2DSize);
+
+    VulkanDescriptorSetLayoutBindingList vkDescriptorSetLayoutBindingList;
+    vkDescriptorSetLayoutBindingList.addBinding(
+        0, VULKAN_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1);
+    vkDescriptorSetLayoutBindingList.addBinding(
+        1, VULKAN_DESCRIPTOR_TYPE_STORAGE_IMAGE, MAX_2D_IMAGE_DESCRIPTORS);
+    VulkanDescriptorSetLayout vkDescriptorSetLayout(
+        vkDevice, vkDescriptorSetLayoutBindingList);
+    VulkanPipelineLayout vkPipelineLayout(vkDevice, vkDescriptorSetLayout);
+
+    VulkanCommandPool vkCommandPool(vkDevice);
+    VulkanQueue &vkQueue = vkDevice.getQueue();
+
+    for (size_t fIdx = 0; fIdx < vkFormatList.size(); fIdx++)
+    {
+        VulkanFormat vkFormat = vkFormatList[fIdx];
+        log_info("Format: %d\n", vkFormat);
+        uint32_t elementSize = getVulkanFormatElementSize(vkFormat);
+        ASSERT_LEQ(elementSize, (uint32_t)MAX_2D_IMAGE_ELEMENT_SIZE);
+
+        std::string fileName = "image2D_"
+            + std::string(getVulkanFormatGLSLFormat(vkFormat)) + ".spv";
+        std::vector<char> vkImage2DShader = readFile(fileName);
+        VulkanShaderModule vkImage2DShaderModule(vkDevice, vkImage2DShader);
+        VulkanComputePipeline vkComputePipeline(vkDevice, vkPipelineLayout,
+                                                vkImage2DShaderModule);
+        cl_kernel updateKernel = getKernelType(
+            vkFormat, kernel_float[0], kernel_signed[0], kernel_unsigned[0]);
+
+        for (size_t wIdx = 0; wIdx < ARRAY_SIZE(widthList); wIdx++)
+        {
+            uint32_t width = widthList[wIdx];
+            if (width > max_width) continue;
+            region[0] = width;
+            for (size_t hIdx = 0; hIdx < ARRAY_SIZE(heightList); hIdx++)
+            {
+                uint32_t height = heightList[hIdx];
+                if (height > max_height) continue;
+                region[1] = height;
+                log_info("Width: %d Height: %d\n", width, height);
+
+                magicValue++;
+                char *vkSrcBufferDeviceMemoryPtr =
+                    (char *)vkSrcBufferDeviceMemory.map();
+                size_t imageBytes = 0;
+                for (uint32_t row = 0; row < height; row++)
+                {
+                    for (uint32_t col = 0; col < width; col++)
+                    {
+                        for (uint32_t elementByte = 0;
+                             elementByte < elementSize; elementByte++)
+                        {
+                            vkSrcBufferDeviceMemoryPtr[imageBytes] =
+                                (char)(magicValue + row + col);
+                            srcBuffer[imageBytes] =
+                                (char)(magicValue + row + col);
+                            imageBytes++;
+                        }
+                    }
+                }
+                vkSrcBufferDeviceMemory.unmap();
+
+                for (size_t emhtIdx = 0;
+                     emhtIdx < vkExternalMemoryHandleTypeList.size(); emhtIdx++)
+                {
+                    VulkanExternalMemoryHandleType vkExternalMemoryHandleType =
+                        vkExternalMemoryHandleTypeList[emhtIdx];
+                    if ((true == disableNTHandleType)
+                        && (VULKAN_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_WIN32_NT
+                            == vkExternalMemoryHandleType))
+                    {
+                        // Skip running for WIN32 NT handle.
+                        continue;
+                    }
+
+                    VulkanImageTiling vulkanImageTiling =
+                        vkClExternalMemoryHandleTilingAssumption(
+                            deviceId, vkExternalMemoryHandleType, &err);
+                    test_error(err, "Failed to query OpenCL tiling mode");
+
+                    VulkanImage2D vkDummyImage2D(
+                        vkDevice, vkFormatList[0], widthList[0], heightList[0],
+                        vulkanImageTiling, 1, vkExternalMemoryHandleType);
+                    const VulkanMemoryTypeList &memoryTypeList =
+                        vkDummyImage2D.getMemoryTypeList();
+
+                    for (size_t mtIdx = 0; mtIdx < memoryTypeList.size();
+                         mtIdx++)
+                    {
+                        const VulkanMemoryType &memoryType =
+                            memoryTypeList[mtIdx];
+                        if (!useDeviceLocal
+                            && VULKAN_MEMORY_TYPE_PROPERTY_DEVICE_LOCAL
+                                == memoryType.getMemoryTypeProperty())
+                        {
+                            continue;
+                        }
+
+                        size_t totalImageMemSize = 0;
+                        {
+                            VulkanImage2D vkImage2D(
+                                vkDevice, vkFormat, width, height,
+                                vulkanImageTiling, numMipLevels,
+                                vkExternalMemoryHandleType);
+                            totalImageMemSize = ROUND_UP(
+                                vkImage2D.getSize(), vkImage2D.getAlignment());
+                        }
+
+                        std::vector<std::unique_ptr<PipelinedFrame>> frames;
+                        for (uint32_t k = 0; k < numInFlight; k++)
+                        {
+                            frames.emplace_back(new PipelinedFrame(
+                                vkDevice, context, vkFormat, width, height,
+                                vulkanImageTiling, vkExternalMemoryHandleType,
+                                memoryType, totalImageMemSize,
+                                vkExternalSemaphoreHandleType,
+                                vkDescriptorSetLayoutBindingList,
+                                vkDescriptorSetLayout, vkCommandPool,
+                                imageBytes));
+                            PipelinedFrame &frame = *frames.back();
+
+                            frame.descriptorSet.update(0, vkParamsBuffer);
+                            frame.descriptorSet.updateArray(1, frame.srcView);
+                            frame.copyCommandBuffer.begin();
+                            frame.copyCommandBuffer.pipelineBarrier(
+                                frame.srcImage, VULKAN_IMAGE_LAYOUT_UNDEFINED,
+                                VULKAN_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+                            frame.copyCommandBuffer.copyBufferToImage(
+                                vkSrcBuffer, frame.srcImage[0],
+                                VULKAN_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+                            frame.copyCommandBuffer.pipelineBarrier(
+                                frame.srcImage,
+                                VULKAN_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                VULKAN_IMAGE_LAYOUT_GENERAL);
+                            frame.copyCommandBuffer.end();
+
+                            frame.shaderCommandBuffer.begin();
+                            frame.shaderCommandBuffer.bindPipeline(
+                                vkComputePipeline);
+                            frame.shaderCommandBuffer.bindDescriptorSets(
+                                vkComputePipeline, vkPipelineLayout,
+                                frame.descriptorSet);
+                            frame.shaderCommandBuffer.dispatch(
+                                NUM_BLOCKS(width, NUM_THREADS_PER_GROUP_X),
+                                NUM_BLOCKS(height, NUM_THREADS_PER_GROUP_Y / 2),
+                                1);
+                            frame.shaderCommandBuffer.end();
+                        }
+
+                        size_t global_work_size[3] = { width, height, 1 };
+                        for (uint32_t round = 0; round < innerIterations;
+                             round++)
+                        {
+                            int parity = round % 2;
+                            for (auto &frame : frames)
+                            {
+                                // Vulkan may only overwrite the images once
+                                // OpenCL is done with the last round
+                                const PipelinedFrame &vkFrame = *frame;
+                                VulkanSemaphoreList waitList;
+                                if (round > 0) waitList.add(vkFrame.cl2vk);
+                                VulkanCommandBufferList commandBuffers;
+                                commandBuffers.add(vkFrame.copyCommandBuffer);
+                                commandBuffers.add(vkFrame.shaderCommandBuffer);
+                                VulkanSemaphoreList signalList;
+                                signalList.add(vkFrame.vk2cl);
+                                vkQueue.submit(waitList, commandBuffers,
+                                               signalList);
+
+                                err = frame->clVk2CL->wait(cmd_queue1);
+                                test_error(err,
+                                           "Error: failed to wait on CL "
+                                           "external semaphore\n");
+
+                                cl_mem images[2] = {
+                                    frame->clSrcImage->getExternalMemoryImage(),
+                                    frame->clDstImage->getExternalMemoryImage()
+                                };
+                                err = clSetKernelArg(updateKernel, 0,
+                                                     sizeof(cl_mem),
+                                                     &images[0]);
+                                err |= clSetKernelArg(updateKernel, 1,
+                                                      sizeof(cl_mem),
+                                                      &images[1]);
+                                err |= clSetKernelArg(updateKernel, 2,
+                                                      sizeof(unsigned int),
+                                                      &num2DImages);
+                                err |= clSetKernelArg(updateKernel, 3,
+                                                      sizeof(unsigned int),
+                                                      &width);
+                                err |= clSetKernelArg(updateKernel, 4,
+                                                      sizeof(unsigned int),
+                                                      &height);
+                                err |= clSetKernelArg(updateKernel, 5,
+                                                      sizeof(unsigned int),
+                                                      &numMipLevels);
+                                test_error(err,
+                                           "Error: Failed to set arg values "
+                                           "for kernel-1\n");
+
+                                err = clEnqueueAcquireExternalMemObjectsKHRptr(
+                                    cmd_queue1, 2, images, 0, nullptr, nullptr);
+                                test_error(err, "Failed to acquire images");
+
+                                err = clEnqueueNDRangeKernel(
+                                    cmd_queue1, updateKernel, 2, NULL,
+                                    global_work_size, NULL, 0, NULL, NULL);
+                                test_error(err,
+                                           "Failed to enqueue updateKernel\n");
+
+                                err = clEnqueueReleaseExternalMemObjectsKHRptr(
+                                    cmd_queue1, 2, images, 0, nullptr, nullptr);
+                                test_error(err, "Failed to release images");
+
+                                if (round + 1 < innerIterations)
+                                {
+                                    err = frame->clCl2Vk->signal(cmd_queue1);
+                                    test_error(
+                                        err, "Failed to signal CL semaphore\n");
+                                }
+
+                                err = clEnqueueReadImage(
+                                    cmd_queue1, images[1], CL_FALSE, origin,
+                                    region, 0, 0,
+                                    frame->readback[parity].data(), 0, NULL,
+                                    &frame->readEvent[parity]);
+                                test_error(err, "clEnqueueReadImage failed\n");
+                            }
+                            err = clFlush(cmd_queue1);
+                            test_error(err, "clFlush failed\n");
+
+                            // Check the previous round while this one runs
+                            if (round > 0)
+                            {
+                                err = verify_pipelined_round(
+                                    frames, 1 - parity, srcBuffer.data(),
+                                    imageBytes);
+                                if (err != CL_SUCCESS) return err;
+                            }
+                        }
+                        if (innerIterations > 0)
+                        {
+                            err = verify_pipelined_round(
+                                frames, (innerIterations - 1) % 2,
+                                srcBuffer.data(), imageBytes);
+                            if (err != CL_SUCCESS) return err;
+                        }
+                        err = clFinish(cmd_queue1);
+                        test_error(err, "clFinish failed\n");
+                        vkQueue.waitIdle();
+                    }
+                }
+            }
+        }
+    }
+    return err;
+}
+
 int test_image_common(cl_device_id device_, cl_context context_,
                       cl_command_queue queue_, int numElements_)
 {
@@ -1565,7 +2002,13 @@ int test_image_common(cl_device_id device_, cl_context context_,
     for (VulkanExternalSemaphoreHandleType externalSemaphoreType :
          supportedSemaphoreTypes)
     {
-        if (numCQ == 2)
+        if (numInFlight > 1)
+        {
+            err = run_test_pipelined(context, cmd_queue1, kernel_unsigned,
+                                     kernel_signed, kernel_float, vkDevice,
+                                     externalSemaphoreType);
+        }
+        else if (numCQ == 2)
         {
             err = run_test_with_two_queue(
                 context, cmd_queue1, cmd_queue2, kernel_unsigned, kernel_signed,
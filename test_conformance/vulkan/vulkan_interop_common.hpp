@@ -33,6 +33,8 @@ extern unsigned int stressIterations;
 extern size_t cpuThreadsPerGpu;
 // Number of command queues (default value 1)
 extern unsigned int numCQ;
+// Number of images kept in flight by the pipelined image test (default value 1)
+extern unsigned int numInFlight;
 // Enable Multi-import of vulkan device memory
 extern bool multiImport;
 // Enable Multi-import of vulkan device memory under different context
@@ -43,5 +45,7 @@ extern bool debug_trace;
 extern bool useSingleImageKernel;
 extern bool useDeviceLocal;
 extern bool disableNTHandleType;
+// Pool the memory of the buffers in the buffer tests
+extern bool useMemoryPool;
 
 #endif // _vulkan_interop_common_hpp_
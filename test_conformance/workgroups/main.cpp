@@ -15,10 +15,12 @@
 //
 #include "harness/compat.h"
 
+#include "harness/benchmark.h"
 #include "harness/testHarness.h"
 #include "procs.h"
 #include <stdio.h>
 #include <string.h>
+#include <string>
 #if !defined(_WIN32)
 #include <unistd.h>
 #endif
@@ -73,9 +75,50 @@ test_status InitCL(cl_device_id device) {
         }
     }
 
+    if (gBench)
+    {
+        log_benchmark_header("work_group",
+                             "function/type/local_size/global_size");
+    }
+
   return TEST_PASS;
 }
 
+int bench_1d_collective(cl_device_id device, cl_context context,
+                        cl_kernel kernel, const char *function,
+                        const char *type, size_t n_elems, size_t max_wg_size)
+{
+    int error;
+    clCommandQueueWrapper queue = clCreateCommandQueue(
+        context, device, CL_QUEUE_PROFILING_ENABLE, &error);
+    test_error(error, "Unable to create profiling queue");
+
+    BenchmarkOptions options;
+    options.warmup = 1;
+    options.maxSeconds = 1.0;
+
+    // Powers of two up to the maximum, then the maximum itself. The global
+    // size is trimmed to whole work-groups so every launch is uniform.
+    for (size_t local = 1; local <= max_wg_size;
+         local = (local * 2 > max_wg_size && local < max_wg_size)
+             ? max_wg_size
+             : local * 2)
+    {
+        size_t global = n_elems / local * local;
+        if (global == 0) break;
+
+        BenchmarkStats stats;
+        error =
+            benchmark_1d_kernel(queue, kernel, global, local, options, &stats);
+        test_error(error, "Unable to time kernel");
+
+        std::string label = std::string(function) + "/" + type + "/"
+            + std::to_string(local) + "/" + std::to_string(global);
+        log_benchmark_stats("work_group", label.c_str(), "ns", false, stats);
+    }
+    return CL_SUCCESS;
+}
+
 int main(int argc, const char *argv[]) {
   return runTestHarnessWithCheck(argc, argv, test_num, test_list, false, 0, InitCL);
 }
@@ -19,6 +19,12 @@
 #include "harness/typeWrappers.h"
 #include "harness/conversions.h"
 #include "harness/mt19937.h"
+#include "harness/parseParameters.h"
+
+extern int bench_1d_collective(cl_device_id device, cl_context context,
+                               cl_kernel kernel, const char *function,
+                               const char *type, size_t n_elems,
+                               size_t max_wg_size);
 
 extern int create_program_and_kernel(const char *source,
                                      const char *kernel_name,
@@ -260,6 +260,11 @@ test_work_group_broadcast_1D(cl_device_id device, cl_context context, cl_command
     }
     log_info("work_group_broadcast_1D test passed\n");
 
+    if (gBench)
+        err = bench_1d_collective(device, context, kernel,
+                                  "work_group_broadcast", "float",
+                                  num_elements, wg_size[0]);
+
     clReleaseMemObject(streams[0]);
     clReleaseMemObject(streams[1]);
     clReleaseKernel(kernel);
@@ -269,6 +269,15 @@ static int run_test(cl_device_id device, cl_context context,
 
     log_info("%s_%s %s passed\n", TestInfo::testName, TestInfo::testOpName,
              TestInfo::deviceTypeName);
+
+    if (gBench)
+    {
+        err = bench_1d_collective(device, context, kernel, funcName.c_str(),
+                                  TestInfo::deviceTypeName, n_elems,
+                                  wg_size[0]);
+        test_error(err, "Unable to benchmark test kernel");
+    }
+
     return TEST_PASS;
 }
 